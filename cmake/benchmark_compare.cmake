@@ -0,0 +1,39 @@
+# Runs benchmark and compares its json results with baseline, script of
+# tests registered by addbenchmark_guard:
+#   cmake -DBENCHMARK=<binary> -DCOMPARE=<benchmark_compare> -DBASELINE=<json>
+#       -DOUTPUT=<json> -DTIME_THRESHOLD=<percent>
+#       -DTHROUGHPUT_THRESHOLD=<percent> [-DFILTER=<regex>]
+#       [-DREPETITIONS=<count>] [-DARGS=<arg>|<arg>...]
+#       -P benchmark_compare.cmake
+
+string(REPLACE "|" ";" args "${ARGS}")
+list(APPEND args --benchmark_out=${OUTPUT} --benchmark_out_format=json)
+if (FILTER)
+  list(APPEND args --benchmark_filter=${FILTER})
+endif ()
+if (REPETITIONS GREATER 1)
+  # comparison uses medians of repetitions
+  list(APPEND args
+      --benchmark_repetitions=${REPETITIONS}
+      --benchmark_report_aggregates_only=true)
+endif ()
+
+execute_process(
+    COMMAND ${BENCHMARK} ${args}
+    RESULT_VARIABLE result
+    OUTPUT_QUIET
+)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "Benchmark ${BENCHMARK} failed: ${result}")
+endif ()
+
+execute_process(
+    COMMAND ${COMPARE}
+    --time-threshold ${TIME_THRESHOLD}
+    --throughput-threshold ${THROUGHPUT_THRESHOLD}
+    ${BASELINE} ${OUTPUT}
+    RESULT_VARIABLE result
+)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "Benchmark ${BENCHMARK} regressed, see report above")
+endif ()
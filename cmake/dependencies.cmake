@@ -6,6 +6,12 @@ hunter_add_package(GTest)
 find_package(GTest CONFIG REQUIRED)
 find_package(GMock CONFIG REQUIRED)
 
+# https://docs.hunter.sh/en/latest/packages/pkg/benchmark.html
+if (BENCHMARKS)
+  hunter_add_package(benchmark)
+  find_package(benchmark CONFIG REQUIRED)
+endif ()
+
 # https://docs.hunter.sh/en/latest/packages/pkg/Boost.html
 hunter_add_package(Boost COMPONENTS date_time filesystem random)
 find_package(Boost CONFIG REQUIRED date_time filesystem random)
@@ -46,6 +52,18 @@ find_package(Boost.DI CONFIG REQUIRED)
 hunter_add_package(leveldb)
 find_package(leveldb CONFIG REQUIRED)
 
+if (ROCKSDB)
+  # https://docs.hunter.sh/en/latest/packages/pkg/rocksdb.html
+  hunter_add_package(rocksdb)
+  find_package(RocksDB CONFIG REQUIRED)
+endif ()
+
+if (ZSTD)
+  # https://hunter.readthedocs.io/en/latest/packages/pkg/zstd.html
+  hunter_add_package(zstd)
+  find_package(zstd CONFIG REQUIRED)
+endif ()
+
 # https://github.com/soramitsu/libp2p
 hunter_add_package(libp2p)
 find_package(libp2p CONFIG REQUIRED)
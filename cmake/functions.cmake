@@ -26,6 +26,90 @@ function(addtest test_name)
   disable_clang_tidy(${test_name})
 endfunction()
 
+function(addbenchmark benchmark_name)
+  add_executable(${benchmark_name} ${ARGN})
+  target_link_libraries(${benchmark_name}
+      benchmark::benchmark
+      )
+  set_target_properties(${benchmark_name} PROPERTIES
+      RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}/benchmark_bin
+      )
+  disable_clang_tidy(${benchmark_name})
+  # "benchmarks" target runs all benchmarks, writing json results to compare
+  # across releases
+  set(json_output ${CMAKE_BINARY_DIR}/benchmark_results/${benchmark_name}.json)
+  file(MAKE_DIRECTORY ${CMAKE_BINARY_DIR}/benchmark_results)
+  add_custom_target(run_${benchmark_name}
+      COMMAND $<TARGET_FILE:${benchmark_name}>
+      --benchmark_out=${json_output} --benchmark_out_format=json
+      DEPENDS ${benchmark_name}
+      # console pool runs benchmarks one by one
+      USES_TERMINAL
+      )
+  if (NOT TARGET benchmarks)
+    add_custom_target(benchmarks)
+  endif ()
+  add_dependencies(benchmarks run_${benchmark_name})
+endfunction()
+
+# Registers ctest test "benchmark_compare_<name>", labeled "benchmark", it
+# runs benchmark and fails with report when time per iteration grew or
+# items/bytes per second dropped beyond thresholds, in percents, against
+# baseline ${BENCHMARK_BASELINE_DIR}/${BENCHMARK_MACHINE_CLASS}/<name>.json.
+# Baseline is json written by run_<name> target on machine of that class.
+# Benchmarks without baseline are not guarded.
+#   addbenchmark_guard(<name> [TIME_THRESHOLD <percent>]
+#       [THROUGHPUT_THRESHOLD <percent>] [FILTER <regex>]
+#       [REPETITIONS <count>] [ARGS <benchmark arguments>...])
+function(addbenchmark_guard benchmark_name)
+  cmake_parse_arguments(GUARD ""
+      "TIME_THRESHOLD;THROUGHPUT_THRESHOLD;FILTER;REPETITIONS" "ARGS" ${ARGN})
+  set(baseline
+      ${BENCHMARK_BASELINE_DIR}/${BENCHMARK_MACHINE_CLASS}/${benchmark_name}.json)
+  if (NOT EXISTS ${baseline})
+    message(STATUS "No baseline for ${benchmark_name}: ${baseline}")
+    return()
+  endif ()
+  foreach (threshold TIME_THRESHOLD THROUGHPUT_THRESHOLD)
+    if (NOT GUARD_${threshold})
+      set(GUARD_${threshold} ${BENCHMARK_${threshold}})
+    endif ()
+  endforeach ()
+  if (NOT GUARD_REPETITIONS)
+    set(GUARD_REPETITIONS 1)
+  endif ()
+  # list separator would split -D argument
+  string(REPLACE ";" "|" args "${GUARD_ARGS}")
+  add_test(
+      NAME benchmark_compare_${benchmark_name}
+      COMMAND ${CMAKE_COMMAND}
+      -DBENCHMARK=$<TARGET_FILE:${benchmark_name}>
+      -DCOMPARE=$<TARGET_FILE:benchmark_compare>
+      -DBASELINE=${baseline}
+      -DOUTPUT=${CMAKE_BINARY_DIR}/benchmark_results/${benchmark_name}.compare.json
+      -DTIME_THRESHOLD=${GUARD_TIME_THRESHOLD}
+      -DTHROUGHPUT_THRESHOLD=${GUARD_THROUGHPUT_THRESHOLD}
+      -DFILTER=${GUARD_FILTER}
+      -DREPETITIONS=${GUARD_REPETITIONS}
+      -DARGS=${args}
+      -P ${PROJECT_SOURCE_DIR}/cmake/benchmark_compare.cmake
+  )
+  # benchmarks measure time, parallel tests would skew it
+  set_tests_properties(benchmark_compare_${benchmark_name} PROPERTIES
+      LABELS benchmark
+      RUN_SERIAL TRUE
+      )
+  # "benchmark-compare" target builds and runs guarded benchmarks only
+  if (NOT TARGET benchmark-compare)
+    add_custom_target(benchmark-compare
+        COMMAND ${CMAKE_CTEST_COMMAND} -L benchmark --output-on-failure
+        WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+        USES_TERMINAL
+        )
+  endif ()
+  add_dependencies(benchmark-compare ${benchmark_name} benchmark_compare)
+endfunction()
+
 function(addtest_part test_name)
   if (POLICY CMP0076)
     cmake_policy(SET CMP0076 NEW)
@@ -10,7 +10,8 @@
 
 namespace fc::adt {
   std::string AddressKeyer::encode(const Key &key) {
-    auto bytes = primitives::address::encode(key);
+    // id address keys fit in small string, no allocation at all
+    auto bytes = primitives::address::AddressBytes{key}.view();
     return {bytes.begin(), bytes.end()};
   }
 
@@ -16,6 +16,12 @@ namespace fc::adt {
   struct Array {
     using Key = uint64_t;
     using Visitor = std::function<outcome::result<void>(Key, const Value &)>;
+    /// Visitor returning false to stop
+    using WhileVisitor =
+        std::function<outcome::result<bool>(Key, const Value &)>;
+    /// Called with changed key and its values before and after, null if absent
+    using DiffVisitor =
+        std::function<outcome::result<void>(Key, const Value *, const Value *)>;
 
     Array(IpldPtr ipld = nullptr) : amt{ipld} {}
 
@@ -40,6 +46,26 @@ namespace fc::adt {
       return amt.getCbor<Value>(key);
     }
 
+    /// Get values of keys in same order, loading shared paths once
+    outcome::result<std::vector<Value>> getMany(gsl::span<const Key> keys) {
+      OUTCOME_TRY(items, amt.getMany(keys));
+      std::vector<Value> values;
+      values.reserve(items.size());
+      for (auto &item : items) {
+        if (!item) {
+          return storage::amt::AmtError::NOT_FOUND;
+        }
+        OUTCOME_TRY(value, amt.ipld->decode<Value>(*item));
+        values.push_back(std::move(value));
+      }
+      return std::move(values);
+    }
+
+    /// Load nodes on paths of keys ahead of reads of them
+    outcome::result<void> prefetch(gsl::span<const Key> keys) {
+      return amt.prefetch(keys);
+    }
+
     outcome::result<void> set(Key key, const Value &value) {
       return amt.setCbor(key, value);
     }
@@ -48,11 +74,36 @@ namespace fc::adt {
       return amt.remove(key);
     }
 
+    /// Replace contents with values keyed from 0, built in one pass
+    outcome::result<void> assign(gsl::span<const Value> values) {
+      std::vector<std::pair<Key, storage::amt::Value>> items;
+      items.reserve(values.size());
+      for (auto &value : values) {
+        OUTCOME_TRY(bytes, Ipld::encode(value));
+        items.emplace_back(items.size(), std::move(bytes));
+      }
+      return amt.assign(std::move(items));
+    }
+
     outcome::result<void> append(const Value &value) {
       OUTCOME_TRY(count, amt.count());
       return set(count, value);
     }
 
+    /**
+     * Visit entries in key order from key until visitor returns false
+     * @return false if visitor stopped
+     */
+    outcome::result<bool> visitWhile(const WhileVisitor &visitor,
+                                     Key from = 0) {
+      return amt.visitWhile(
+          [&](auto key, auto &value) -> outcome::result<bool> {
+            OUTCOME_TRY(value2, amt.ipld->decode<Value>(value));
+            return visitor(key, value2);
+          },
+          from);
+    }
+
     outcome::result<void> visit(const Visitor &visitor) {
       return amt.visit([&](auto key, auto &value) -> outcome::result<void> {
         OUTCOME_TRY(value2, amt.ipld->decode<Value>(value));
@@ -60,6 +111,42 @@ namespace fc::adt {
       });
     }
 
+    /**
+     * Read-only scan, subtrees are loaded and decoded concurrently
+     * @param ordered - call visitor on calling thread in key order
+     */
+    outcome::result<void> visitParallel(
+        const Visitor &visitor,
+        bool ordered = false,
+        size_t threads = storage::ipld::kVisitThreads) {
+      return amt.visitParallel(
+          [&](auto key, auto &value) -> outcome::result<void> {
+            OUTCOME_TRY(value2, amt.ipld->decode<Value>(value));
+            return visitor(key, value2);
+          },
+          ordered,
+          threads);
+    }
+
+    /// Visit entries added, removed or changed since before in key order
+    outcome::result<void> diff(Array &before, const DiffVisitor &visitor) {
+      return amt.diff(
+          before.amt,
+          [&](auto key, auto before_value, auto value)
+              -> outcome::result<void> {
+            boost::optional<Value> before_value2, value2;
+            if (before_value) {
+              OUTCOME_TRY(decoded, amt.ipld->decode<Value>(*before_value));
+              before_value2 = std::move(decoded);
+            }
+            if (value) {
+              OUTCOME_TRY(decoded, amt.ipld->decode<Value>(*value));
+              value2 = std::move(decoded);
+            }
+            return visitor(key, before_value2.get_ptr(), value2.get_ptr());
+          });
+    }
+
     outcome::result<std::vector<Value>> values() {
       std::vector<Value> values;
       OUTCOME_TRY(visit([&](auto, auto &value) {
@@ -15,27 +15,35 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::adt, BalanceTableError, e) {
 
 namespace fc::adt {
   outcome::result<void> BalanceTable::add(const Key &key, TokenAmount amount) {
-    OUTCOME_TRY(value, get(key));
-    value += amount;
-    OUTCOME_TRY(set(key, value));
-    return outcome::success();
+    return update(key, [&](auto value) -> outcome::result<TokenAmount> {
+      if (!value) {
+        return storage::hamt::HamtError::NOT_FOUND;
+      }
+      return *value + amount;
+    });
   }
 
   outcome::result<void> BalanceTable::addCreate(const Key &key, TokenAmount amount) {
-    OUTCOME_TRY(value, tryGet(key));
-    if (value) {
-      amount += *value;
-    }
-    return set(key, amount);
+    return update(key, [&](auto value) -> outcome::result<TokenAmount> {
+      if (value) {
+        return *value + amount;
+      }
+      return amount;
+    });
   }
 
   outcome::result<TokenAmount> BalanceTable::subtractWithMin(const Key &key,
                                                              TokenAmount amount,
                                                              TokenAmount min) {
-    OUTCOME_TRY(value, get(key));
-    TokenAmount subtracted =
-        std::min(amount, std::max(TokenAmount{value - min}, TokenAmount{0}));
-    OUTCOME_TRY(set(key, value - subtracted));
+    TokenAmount subtracted;
+    OUTCOME_TRY(update(key, [&](auto value) -> outcome::result<TokenAmount> {
+      if (!value) {
+        return storage::hamt::HamtError::NOT_FOUND;
+      }
+      subtracted =
+          std::min(amount, std::max(TokenAmount{*value - min}, TokenAmount{0}));
+      return *value - subtracted;
+    }));
     return subtracted;
   }
 
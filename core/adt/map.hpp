@@ -10,6 +10,7 @@
 
 namespace fc::adt {
   using storage::hamt::Hamt;
+  using storage::hamt::HamtKey;
   using storage::hamt::kDefaultBitWidth;
 
   struct StringKeyer {
@@ -32,30 +33,109 @@ namespace fc::adt {
     using Key = typename Keyer::Key;
     using Visitor =
         std::function<outcome::result<void>(const Key &, const Value &)>;
+    /// Visitor returning false to stop
+    using WhileVisitor =
+        std::function<outcome::result<bool>(const Key &, const Value &)>;
+    /// Called with changed key and its values before and after, null if absent
+    using DiffVisitor = std::function<outcome::result<void>(
+        const Key &, const Value *, const Value *)>;
+    /// Called with current value, none if absent, returns value to set
+    using Updater =
+        std::function<outcome::result<Value>(boost::optional<Value>)>;
 
     Map(IpldPtr ipld = nullptr) : hamt{ipld, bit_width} {}
 
     Map(const CID &root, IpldPtr ipld = nullptr)
         : hamt{ipld, root, bit_width} {}
 
+    /// Encoded key with its hash, to reuse for operations on same key
+    static HamtKey hamtKey(const Key &key) {
+      return Keyer::encode(key);
+    }
+
     outcome::result<boost::optional<Value>> tryGet(const Key &key) {
-      return hamt.tryGetCbor<Value>(Keyer::encode(key));
+      return tryGet(hamtKey(key));
+    }
+
+    outcome::result<boost::optional<Value>> tryGet(const HamtKey &key) {
+      return hamt.tryGetCbor<Value>(key);
     }
 
     outcome::result<bool> has(const Key &key) {
-      return hamt.contains(Keyer::encode(key));
+      return has(hamtKey(key));
+    }
+
+    outcome::result<bool> has(const HamtKey &key) {
+      return hamt.contains(key);
     }
 
     outcome::result<Value> get(const Key &key) {
-      return hamt.getCbor<Value>(Keyer::encode(key));
+      return get(hamtKey(key));
+    }
+
+    outcome::result<Value> get(const HamtKey &key) {
+      return hamt.getCbor<Value>(key);
     }
 
     outcome::result<void> set(const Key &key, const Value &value) {
-      return hamt.setCbor(Keyer::encode(key), value);
+      return set(hamtKey(key), value);
+    }
+
+    outcome::result<void> set(const HamtKey &key, const Value &value) {
+      return hamt.setCbor(key, value);
+    }
+
+    /**
+     * Set value computed from current one, walking hamt once, so
+     * read-modify-write hashes key and loads its path once
+     */
+    outcome::result<void> update(const HamtKey &key, const Updater &updater) {
+      return hamt.update(
+          key, [&](auto bytes) -> outcome::result<storage::hamt::Value> {
+            boost::optional<Value> value;
+            if (bytes) {
+              OUTCOME_TRY(decoded, hamt.ipld->decode<Value>(*bytes));
+              value = std::move(decoded);
+            }
+            OUTCOME_TRY(value2, updater(std::move(value)));
+            return Ipld::encode(value2);
+          });
+    }
+
+    outcome::result<void> update(const Key &key, const Updater &updater) {
+      return update(hamtKey(key), updater);
+    }
+
+    /// Get value, setting one made by make if absent, key is hashed once
+    template <typename Make>
+    outcome::result<Value> getOrInsert(const HamtKey &key, const Make &make) {
+      OUTCOME_TRY(value, tryGet(key));
+      if (value) {
+        return std::move(*value);
+      }
+      OUTCOME_TRY(value2, make());
+      OUTCOME_TRY(set(key, value2));
+      return std::move(value2);
+    }
+
+    /// Replace contents with entries, built in one pass
+    outcome::result<void> assign(
+        const std::vector<std::pair<Key, Value>> &entries) {
+      std::vector<std::pair<std::string, storage::hamt::Value>> items;
+      items.reserve(entries.size());
+      for (auto &[key, value] : entries) {
+        OUTCOME_TRY(bytes, Ipld::encode(value));
+        items.emplace_back(Keyer::encode(key), std::move(bytes));
+      }
+      return hamt.assign(std::move(items));
     }
 
     outcome::result<void> remove(const Key &key) {
-      return hamt.remove(Keyer::encode(key));
+      return remove(hamtKey(key));
+    }
+
+    outcome::result<void> remove(const HamtKey &key) {
+      return hamt.remove(key);
     }
 
     outcome::result<void> visit(const Visitor &visitor) {
@@ -66,6 +146,60 @@ namespace fc::adt {
       });
     }
 
+    /**
+     * Visit entries in hamt order until visitor returns false
+     * @param after - key to resume after, e.g. last key of previous page
+     * @return false if visitor stopped
+     */
+    outcome::result<bool> visitWhile(
+        const WhileVisitor &visitor,
+        const boost::optional<Key> &after = boost::none) {
+      return hamt.visitWhile(
+          [&](auto &key, auto &value) -> outcome::result<bool> {
+            OUTCOME_TRY(key2, Keyer::decode(key));
+            OUTCOME_TRY(value2, hamt.ipld->decode<Value>(value));
+            return visitor(key2, value2);
+          },
+          encodeKey(after));
+    }
+
+    /// @return up to limit keys in hamt order after key
+    outcome::result<std::vector<Key>> keysPage(
+        const boost::optional<Key> &after, size_t limit) {
+      std::vector<Key> keys;
+      if (limit == 0) {
+        return keys;
+      }
+      OUTCOME_TRY(hamt.visitWhile(
+          [&](auto &key, auto &) -> outcome::result<bool> {
+            OUTCOME_TRY(key2, Keyer::decode(key));
+            keys.push_back(std::move(key2));
+            return keys.size() < limit;
+          },
+          encodeKey(after)));
+      return std::move(keys);
+    }
+
+    /// Visit entries added, removed or changed since before
+    outcome::result<void> diff(const Map &before, const DiffVisitor &visitor) {
+      return hamt.diff(
+          before.hamt,
+          [&](auto &key, auto before_value, auto value)
+              -> outcome::result<void> {
+            OUTCOME_TRY(key2, Keyer::decode(key));
+            boost::optional<Value> before_value2, value2;
+            if (before_value) {
+              OUTCOME_TRY(decoded, hamt.ipld->decode<Value>(*before_value));
+              before_value2 = std::move(decoded);
+            }
+            if (value) {
+              OUTCOME_TRY(decoded, hamt.ipld->decode<Value>(*value));
+              value2 = std::move(decoded);
+            }
+            return visitor(key2, before_value2.get_ptr(), value2.get_ptr());
+          });
+    }
+
     outcome::result<std::vector<Key>> keys() {
       std::vector<Key> keys;
       OUTCOME_TRY(hamt.visit([&](auto &key, auto &) -> outcome::result<void> {
@@ -77,6 +211,15 @@ namespace fc::adt {
     }
 
     Hamt hamt;
+
+   private:
+    static boost::optional<std::string> encodeKey(
+        const boost::optional<Key> &key) {
+      if (key) {
+        return Keyer::encode(*key);
+      }
+      return boost::none;
+    }
   };
 
   /// Cbor encode map
@@ -7,6 +7,7 @@
 #define CPP_FILECOIN_CORE_API_API_HPP
 
 #include <future>
+#include <mutex>
 
 #include <libp2p/peer/peer_info.hpp>
 
@@ -29,7 +30,9 @@
 #include "vm/actor/builtin/miner/types.hpp"
 #include "vm/actor/builtin/payment_channel/payment_channel_actor_state.hpp"
 #include "vm/actor/builtin/storage_power/storage_power_actor_state.hpp"
+#include "vm/runtime/profiler.hpp"
 #include "vm/runtime/runtime_types.hpp"
+#include "vm/state/state_analyzer.hpp"
 
 #define API_METHOD(_name, _result, ...)                                    \
   struct _##_name : std::function<outcome::result<_result>(__VA_ARGS__)> { \
@@ -82,7 +85,11 @@ namespace fc::api {
   using vm::message::SignedMessage;
   using vm::message::UnsignedMessage;
   using vm::runtime::ExecutionResult;
+  using vm::runtime::ExecutionTrace;
   using vm::runtime::MessageReceipt;
+  using vm::runtime::MethodProfile;
+  using vm::state::StateShape;
+  using vm::state::StateShapeDiff;
 
   template <typename... T>
   using ParamsTuple =
@@ -136,6 +143,48 @@ namespace fc::api {
   template <typename T>
   struct is_wait<Wait<T>> : std::true_type {};
 
+  /**
+   * Result shared by calls, e.g. kept by cache. Json transport encodes it
+   * on first call and writes same json for later calls of same result.
+   */
+  template <typename T>
+  struct Shared {
+    using Type = T;
+
+    struct Encoded {
+      std::once_flag once;
+      std::shared_ptr<const std::string> json;
+    };
+
+    std::shared_ptr<const T> value;
+    std::shared_ptr<Encoded> encoded{std::make_shared<Encoded>()};
+  };
+
+  template <typename T>
+  struct is_shared : std::false_type {};
+
+  template <typename T>
+  struct is_shared<Shared<T>> : std::true_type {};
+
+  template <typename T,
+            typename Stream,
+            typename = std::enable_if_t<
+                std::remove_reference_t<Stream>::is_cbor_encoder_stream>>
+  Stream &operator<<(Stream &&s, const Shared<T> &v) {
+    return s << *v.value;
+  }
+
+  template <typename T,
+            typename Stream,
+            typename = std::enable_if_t<
+                std::remove_reference_t<Stream>::is_cbor_decoder_stream>>
+  Stream &operator>>(Stream &&s, Shared<T> &v) {
+    T value;
+    s >> value;
+    v.value = std::make_shared<const T>(std::move(value));
+    return s;
+  }
+
   struct None {};
 
   struct InvocResult {
@@ -143,6 +192,7 @@ namespace fc::api {
     MessageReceipt receipt;
     std::vector<ExecutionResult> internal_executions;
     std::string error;
+    ExecutionTrace execution_trace;
   };
 
   using MarketDealMap = std::map<std::string, StorageDeal>;
@@ -183,6 +233,13 @@ namespace fc::api {
     uint64_t block_delay;
   };
 
+  struct VmProfileReport {
+    /// Sorted by self time, slowest first
+    std::vector<MethodProfile> methods;
+    /// Call stacks in flamegraph folded format
+    std::string folded;
+  };
+
   struct MiningBaseInfo {
     StoragePower miner_power;
     StoragePower network_power;
@@ -198,6 +255,19 @@ namespace fc::api {
     IpldObject state;
   };
 
+  /// Page of addresses listed in hamt order
+  struct AddressPage {
+    std::vector<Address> addresses;
+    /// Opaque token of next page, empty after last page
+    Buffer next;
+  };
+
+  struct SectorPage {
+    std::vector<ChainSectorInfo> sectors;
+    /// First sector number of next page, none after last page
+    boost::optional<SectorNumber> next;
+  };
+
   struct StartDealParams {
     DataRef data;
     Address wallet;
@@ -253,8 +323,17 @@ namespace fc::api {
     API_METHOD(ChainGetGenesis, Tipset)
     API_METHOD(ChainGetNode, IpldObject, const std::string &)
     API_METHOD(ChainGetMessage, UnsignedMessage, const CID &)
-    API_METHOD(ChainGetParentMessages, std::vector<CidMessage>, const CID &)
-    API_METHOD(ChainGetParentReceipts, std::vector<MessageReceipt>, const CID &)
+    /**
+     * Deduplicated messages of parent tipset of block, kept by cache, so
+     * polling of new heads does not load them again
+     */
+    API_METHOD(ChainGetParentMessages,
+               Shared<std::vector<CidMessage>>,
+               const CID &)
+    /// Receipts of parent messages of block, cached as parent messages
+    API_METHOD(ChainGetParentReceipts,
+               Shared<std::vector<MessageReceipt>>,
+               const CID &)
     API_METHOD(ChainGetRandomness, Randomness, const TipsetKey &, int64_t)
     API_METHOD(ChainGetTipSet, Tipset, const TipsetKey &)
     API_METHOD(ChainGetTipSetByHeight, Tipset, ChainEpoch, const TipsetKey &)
@@ -278,6 +357,17 @@ namespace fc::api {
                const FileRef &)
     API_METHOD(ClientStartDeal, Wait<CID>, const StartDealParams &)
 
+    /// Tags of loggers, accepted by LogSetLevel
+    API_METHOD(LogList, std::vector<std::string>)
+
+    /**
+     * Changes level of logger without restart
+     * @param tag - logger tag, or "*" for all loggers
+     * @param level - "trace", "debug", "info", "warning", "error",
+     * "critical" or "off"
+     */
+    API_METHOD(LogSetLevel, void, const std::string &, const std::string &)
+
     /**
      * Ensures that a storage market participant has a certain amount of
      * available funds. If additional funds are needed, they will be sent from
@@ -302,7 +392,11 @@ namespace fc::api {
                ChainEpoch,
                const TipsetKey &)
 
+    /// Next nonce of sender, counting its messages in pool
+    API_METHOD(MpoolGetNonce, uint64_t, const Address &)
     API_METHOD(MpoolPending, std::vector<SignedMessage>, const TipsetKey &)
+    /// Adds message signed by caller, e.g. with locally assigned nonce
+    API_METHOD(MpoolPush, CID, const SignedMessage &)
     API_METHOD(MpoolPushMessage, SignedMessage, const UnsignedMessage &)
     API_METHOD(MpoolSub, Chan<MpoolUpdate>)
 
@@ -327,9 +421,49 @@ namespace fc::api {
                ChainEpoch)
     API_METHOD(StateGetActor, Actor, const Address &, const TipsetKey &)
     API_METHOD(StateReadState, ActorState, const Actor &, const TipsetKey &)
+
+    /**
+     * Execute messages of tipset up to message with tracing
+     * @param tipset key of tipset including message
+     * @param message cid
+     * @return execution trace of message
+     */
+    API_METHOD(StateReplay, InvocResult, const TipsetKey &, const CID &)
+
     API_METHOD(StateGetReceipt, MessageReceipt, const CID &, const TipsetKey &)
     API_METHOD(StateListMiners, std::vector<Address>, const TipsetKey &)
     API_METHOD(StateListActors, std::vector<Address>, const TipsetKey &)
+    /**
+     * List miners page by page, so whole list is not held at once
+     * @param token - next token of previous page, empty for first page
+     * @param limit - max addresses in page, 0 for default
+     */
+    API_METHOD(StateListMinersPage,
+               AddressPage,
+               const TipsetKey &,
+               const Buffer &,
+               uint64_t)
+    /// List actors page by page, same as StateListMinersPage
+    API_METHOD(StateListActorsPage,
+               AddressPage,
+               const TipsetKey &,
+               const Buffer &,
+               uint64_t)
+    /// Actors new or changed in second state root, keyed by address
+    API_METHOD(StateChangedActors,
+               std::map<std::string, Actor>,
+               const CID &,
+               const CID &)
+    /**
+     * Size and shape of parent state of tipset: actors hamt, every actor
+     * state dag and hamts and amts embedded in it
+     */
+    API_METHOD(StateAnalyze, StateShape, const TipsetKey &)
+    /// Actor state blocks added and removed between parent states of tipsets
+    API_METHOD(StateAnalyzeDiff,
+               StateShapeDiff,
+               const TipsetKey &,
+               const TipsetKey &)
     API_METHOD(StateMarketBalance,
                MarketBalance,
                const Address &,
@@ -344,16 +478,31 @@ namespace fc::api {
     API_METHOD(StateMinerFaults, RleBitset, const Address &, const TipsetKey &)
     API_METHOD(StateMinerInfo, MinerInfo, const Address &, const TipsetKey &)
     API_METHOD(StateMinerPower, MinerPower, const Address &, const TipsetKey &)
+    /// Sectors without faults and recoveries, shared by calls at same state
     API_METHOD(StateMinerProvingSet,
-               std::vector<ChainSectorInfo>,
+               Shared<std::vector<ChainSectorInfo>>,
                const Address &,
                const TipsetKey &)
+    /// All sectors, shared by calls at same miner state
     API_METHOD(StateMinerSectors,
-               std::vector<ChainSectorInfo>,
+               Shared<std::vector<ChainSectorInfo>>,
                const Address &,
                void *,
                bool,
                const TipsetKey &)
+    /**
+     * List sectors page by page, so large miner is not loaded at once
+     * @param proving - only sectors of proving set
+     * @param from - first sector number, next of previous page
+     * @param limit - max sectors in page, 0 for default
+     */
+    API_METHOD(StateMinerSectorsPage,
+               SectorPage,
+               const Address &,
+               bool,
+               SectorNumber,
+               uint64_t,
+               const TipsetKey &)
     API_METHOD(StateMinerSectorSize,
                SectorSize,
                const Address &,
@@ -366,6 +515,13 @@ namespace fc::api {
 
     API_METHOD(Version, VersionResult)
 
+    /**
+     * Actor methods recorded by VM profiler since start or last reset, empty
+     * if profiling is disabled
+     * @param reset - clear recorded methods after report
+     */
+    API_METHOD(VmProfile, VmProfileReport, bool)
+
     API_METHOD(WalletBalance, TokenAmount, const Address &)
     API_METHOD(WalletDefaultAddress, Address)
     API_METHOD(WalletHas, bool, const Address &)
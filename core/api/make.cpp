@@ -5,10 +5,17 @@
 
 #include "api/make.hpp"
 
+#include <algorithm>
+#include <list>
+#include <mutex>
+
 #include <boost/algorithm/string.hpp>
 #include <libp2p/peer/peer_id.hpp>
 
 #include "blockchain/production/block_producer.hpp"
+#include "common/logger.hpp"
+#include "primitives/address/address_codec.hpp"
+#include "primitives/cid/cb_cid.hpp"
 #include "storage/hamt/hamt.hpp"
 #include "vm/actor/builtin/account/account_actor.hpp"
 #include "vm/actor/builtin/init/init_actor.hpp"
@@ -30,7 +37,8 @@ namespace fc::api {
   using vm::actor::builtin::init::InitActorState;
   using vm::actor::builtin::market::DealState;
   using vm::actor::builtin::miner::MinerActorState;
-  using vm::actor::builtin::storage_power::StoragePowerActorState;
+  namespace market_lazy = vm::actor::builtin::market::lazy;
+  namespace power_lazy = vm::actor::builtin::storage_power::lazy;
   using InterpreterResult = vm::interpreter::Result;
   using vm::state::StateTreeImpl;
   using MarketActorState = vm::actor::builtin::market::State;
@@ -38,6 +46,7 @@ namespace fc::api {
   using crypto::signature::BlsSignature;
   using libp2p::peer::PeerId;
   using primitives::block::MsgMeta;
+  using primitives::tipset::MessageVisitor;
   using vm::isVMExitCode;
   using vm::normalizeVMExitCode;
   using vm::VMExitCode;
@@ -45,32 +54,272 @@ namespace fc::api {
   using vm::runtime::Env;
   using connection_t = boost::signals2::connection;
 
+  /// Number of recently queried tipsets kept with their decoded states
+  constexpr size_t kTipsetContextCacheSize{16};
+
+  /// Actor states decoded at tipset, shared by queries of it
+  struct TipsetStates {
+    std::mutex mutex;
+    boost::optional<MarketActorState> market;
+    boost::optional<InitActorState> init;
+    std::map<Address, MinerActorState> miners;
+    std::map<Address, Address> account_keys;
+  };
+
+  /// Max addresses in page of listing methods
+  constexpr uint64_t kMaxAddressPage{1000};
+
+  /// Lists page of map keys after address encoded in token
+  template <typename Map>
+  outcome::result<AddressPage> addressPage(Map &map,
+                                           const Buffer &token,
+                                           uint64_t limit) {
+    boost::optional<Address> after;
+    if (!token.empty()) {
+      OUTCOME_TRYA(after, primitives::address::decode(token));
+    }
+    if (limit == 0 || limit > kMaxAddressPage) {
+      limit = kMaxAddressPage;
+    }
+    AddressPage page;
+    OUTCOME_TRYA(page.addresses, map.keysPage(after, limit));
+    if (page.addresses.size() == limit) {
+      page.next = Buffer{primitives::address::encode(page.addresses.back())};
+    }
+    return page;
+  }
+
   struct TipsetContext {
     Tipset tipset;
     StateTreeImpl state_tree;
     boost::optional<InterpreterResult> interpreted;
+    std::shared_ptr<TipsetStates> states{std::make_shared<TipsetStates>()};
 
     auto marketState() {
-      return state_tree.state<MarketActorState>(kStorageMarketAddress);
+      return cached(states->market, [&] {
+        return state_tree.state<MarketActorState>(kStorageMarketAddress);
+      });
     }
 
     auto minerState(const Address &address) {
-      return state_tree.state<MinerActorState>(address);
+      return cached(states->miners, address, [&] {
+        return state_tree.state<MinerActorState>(address);
+      });
+    }
+
+    /// Power actor state with fields decoded on access
+    auto lazyPowerState() {
+      return state_tree.lazyState(kStoragePowerAddress);
     }
 
-    auto powerState() {
-      return state_tree.state<StoragePowerActorState>(kStoragePowerAddress);
+    auto lazyMarketState() {
+      return state_tree.lazyState(kStorageMarketAddress);
     }
 
     auto initState() {
-      return state_tree.state<InitActorState>(kInitAddress);
+      return cached(states->init, [&] {
+        return state_tree.state<InitActorState>(kInitAddress);
+      });
     }
 
     outcome::result<Address> accountKey(const Address &id) {
-      // TODO(turuslan): error if not account
-      OUTCOME_TRY(state, state_tree.state<AccountActorState>(id));
-      return state.address;
+      return cached(
+          states->account_keys, id, [&]() -> outcome::result<Address> {
+            // TODO(turuslan): error if not account
+            OUTCOME_TRY(state, state_tree.state<AccountActorState>(id));
+            return state.address;
+          });
+    }
+
+   private:
+    /// Returns decoded value, decodes it on first access
+    template <typename T, typename F>
+    outcome::result<T> cached(boost::optional<T> &value, const F &load) {
+      {
+        std::lock_guard lock{states->mutex};
+        if (value) {
+          return *value;
+        }
+      }
+      OUTCOME_TRY(loaded, load());
+      std::lock_guard lock{states->mutex};
+      value = loaded;
+      return std::move(loaded);
     }
+
+    template <typename T, typename F>
+    outcome::result<T> cached(std::map<Address, T> &values,
+                              const Address &key,
+                              const F &load) {
+      {
+        std::lock_guard lock{states->mutex};
+        auto it{values.find(key)};
+        if (it != values.end()) {
+          return it->second;
+        }
+      }
+      OUTCOME_TRY(loaded, load());
+      std::lock_guard lock{states->mutex};
+      values.emplace(key, loaded);
+      return std::move(loaded);
+    }
+  };
+
+  /**
+   * Recently queried tipsets with their state roots and decoded actor
+   * states. Each query gets own state tree, so queries do not share mutable
+   * tree, only decoded states.
+   */
+  class TipsetContextCache {
+   public:
+    struct Entry {
+      std::vector<CID> key;
+      bool interpret;
+      Tipset tipset;
+      CID state_root;
+      boost::optional<InterpreterResult> interpreted;
+      std::shared_ptr<TipsetStates> states;
+    };
+
+    boost::optional<Entry> find(const std::vector<CID> &key, bool interpret) {
+      std::lock_guard lock{mutex_};
+      auto it{std::find_if(entries_.begin(), entries_.end(), [&](auto &e) {
+        return e.interpret == interpret && e.key == key;
+      })};
+      if (it == entries_.end()) {
+        return boost::none;
+      }
+      entries_.splice(entries_.begin(), entries_, it);
+      return *it;
+    }
+
+    /// Inserts entry unless concurrent query inserted it, returns cached one
+    Entry insert(Entry entry) {
+      std::lock_guard lock{mutex_};
+      auto it{std::find_if(entries_.begin(), entries_.end(), [&](auto &e) {
+        return e.interpret == entry.interpret && e.key == entry.key;
+      })};
+      if (it != entries_.end()) {
+        return *it;
+      }
+      entries_.push_front(std::move(entry));
+      if (entries_.size() > kTipsetContextCacheSize) {
+        entries_.pop_back();
+      }
+      return entries_.front();
+    }
+
+   private:
+    std::mutex mutex_;
+    /// Most recently used first
+    std::list<Entry> entries_;
+  };
+
+  /// Number of recently queried parent tipsets kept with their messages
+  constexpr size_t kParentMessagesCacheSize{16};
+
+  /**
+   * Deduplicated messages and receipts of recently queried parent tipsets.
+   * Results are shared by queries, so their json is encoded once.
+   */
+  class ParentMessagesCache {
+   public:
+    struct Entry {
+      std::vector<CID> key;
+      CID receipts_root;
+      Shared<std::vector<CidMessage>> messages;
+      Shared<std::vector<MessageReceipt>> receipts;
+    };
+
+    boost::optional<Entry> find(const std::vector<CID> &key,
+                                const CID &receipts_root) {
+      std::lock_guard lock{mutex_};
+      auto it{std::find_if(entries_.begin(), entries_.end(), [&](auto &e) {
+        return e.key == key && e.receipts_root == receipts_root;
+      })};
+      if (it == entries_.end()) {
+        return boost::none;
+      }
+      entries_.splice(entries_.begin(), entries_, it);
+      return *it;
+    }
+
+    /// Inserts entry unless concurrent query inserted it, returns cached one
+    Entry insert(Entry entry) {
+      std::lock_guard lock{mutex_};
+      auto it{std::find_if(entries_.begin(), entries_.end(), [&](auto &e) {
+        return e.key == entry.key && e.receipts_root == entry.receipts_root;
+      })};
+      if (it != entries_.end()) {
+        return *it;
+      }
+      entries_.push_front(std::move(entry));
+      if (entries_.size() > kParentMessagesCacheSize) {
+        entries_.pop_back();
+      }
+      return entries_.front();
+    }
+
+   private:
+    std::mutex mutex_;
+    /// Most recently used first
+    std::list<Entry> entries_;
+  };
+
+  /// Number of miner sector query results kept
+  constexpr size_t kSectorQueryCacheSize{16};
+
+  /// Max sectors in page of sector listing
+  constexpr uint64_t kMaxSectorPage{1000};
+
+  /**
+   * Results of sector queries keyed by miner actor head and query, so
+   * queries at tipsets with same miner state share decoded sectors and
+   * their json
+   */
+  class SectorQueryCache {
+   public:
+    using Sectors = Shared<std::vector<ChainSectorInfo>>;
+
+    struct Entry {
+      CID head;
+      /// Only sectors of proving set
+      bool proving;
+      Sectors sectors;
+    };
+
+    boost::optional<Sectors> find(const CID &head, bool proving) {
+      std::lock_guard lock{mutex_};
+      auto it{std::find_if(entries_.begin(), entries_.end(), [&](auto &e) {
+        return e.head == head && e.proving == proving;
+      })};
+      if (it == entries_.end()) {
+        return boost::none;
+      }
+      entries_.splice(entries_.begin(), entries_, it);
+      return it->sectors;
+    }
+
+    /// Inserts entry unless concurrent query inserted it, returns cached one
+    Sectors insert(Entry entry) {
+      std::lock_guard lock{mutex_};
+      auto it{std::find_if(entries_.begin(), entries_.end(), [&](auto &e) {
+        return e.head == entry.head && e.proving == entry.proving;
+      })};
+      if (it != entries_.end()) {
+        return it->sectors;
+      }
+      entries_.push_front(std::move(entry));
+      if (entries_.size() > kSectorQueryCacheSize) {
+        entries_.pop_back();
+      }
+      return entries_.front().sectors;
+    }
+
+   private:
+    std::mutex mutex_;
+    /// Most recently used first
+    std::list<Entry> entries_;
   };
 
   Api makeImpl(std::shared_ptr<ChainStore> chain_store,
@@ -80,24 +329,126 @@ namespace fc::api {
                std::shared_ptr<Mpool> mpool,
                std::shared_ptr<Interpreter> interpreter,
                std::shared_ptr<MsgWaiter> msg_waiter,
-               std::shared_ptr<KeyStore> key_store) {
+               std::shared_ptr<KeyStore> key_store,
+               std::shared_ptr<vm::runtime::Profiler> profiler,
+               std::shared_ptr<MessageCache> message_cache) {
     auto chain_randomness = chain_store->createRandomnessProvider();
+    auto context_cache{std::make_shared<TipsetContextCache>()};
+    auto parent_messages_cache{std::make_shared<ParentMessagesCache>()};
+    auto sector_cache{std::make_shared<SectorQueryCache>()};
+    // whole sectors amt is read by parallel visit, decoded in key order
+    auto minerSectors = [=](TipsetContext &context,
+                            const Address &address,
+                            bool proving)
+        -> outcome::result<SectorQueryCache::Sectors> {
+      OUTCOME_TRY(actor, context.state_tree.get(address));
+      if (auto cached{sector_cache->find(actor.head, proving)}) {
+        return std::move(*cached);
+      }
+      OUTCOME_TRY(state, context.minerState(address));
+      std::vector<ChainSectorInfo> sectors;
+      OUTCOME_TRY(state.sectors.visitParallel(
+          [&](auto id, auto &info) -> outcome::result<void> {
+            if (!proving
+                || (state.fault_set.find(id) == state.fault_set.end()
+                    && state.recoveries.find(id) == state.recoveries.end())) {
+              sectors.push_back({info, id});
+            }
+            return outcome::success();
+          },
+          true));
+      SectorQueryCache::Sectors shared;
+      shared.value = std::make_shared<const std::vector<ChainSectorInfo>>(
+          std::move(sectors));
+      return sector_cache->insert({actor.head, proving, std::move(shared)});
+    };
+    // messages are taken from interpreter if it applied parent recently,
+    // otherwise they are loaded once and deduplicated as by interpreter
+    auto parentMessages = [=](const BlockHeader &block)
+        -> outcome::result<ParentMessagesCache::Entry> {
+      if (auto cached{parent_messages_cache->find(
+              block.parents, block.parent_message_receipts)}) {
+        return std::move(*cached);
+      }
+      std::vector<CidMessage> messages;
+      std::vector<MessageReceipt> receipts;
+      auto interpreted{message_cache ? message_cache->get(block.parents)
+                                     : nullptr};
+      if (interpreted
+          && interpreted->receipts_root == block.parent_message_receipts) {
+        messages.reserve(interpreted->cids.size());
+        for (size_t i = 0; i < interpreted->cids.size(); ++i) {
+          messages.push_back(
+              {interpreted->cids[i], interpreted->messages[i]});
+        }
+        receipts = interpreted->receipts;
+      } else {
+        MessageVisitor message_visitor{ipld};
+        for (auto &parent_cid : block.parents) {
+          OUTCOME_TRY(parent, ipld->getCbor<BlockHeader>(parent_cid));
+          OUTCOME_TRY(message_visitor.visit(
+              parent,
+              [&](auto, auto bls, auto &cid) -> outcome::result<void> {
+                if (bls) {
+                  OUTCOME_TRY(message, ipld->getCbor<UnsignedMessage>(cid));
+                  messages.push_back({cid, std::move(message)});
+                } else {
+                  OUTCOME_TRY(message, ipld->getCbor<SignedMessage>(cid));
+                  messages.push_back({cid, std::move(message.message)});
+                }
+                return outcome::success();
+              }));
+        }
+        OUTCOME_TRYA(receipts,
+                     adt::Array<MessageReceipt>{block.parent_message_receipts,
+                                                ipld}
+                         .values());
+      }
+      ParentMessagesCache::Entry entry{block.parents,
+                                       block.parent_message_receipts};
+      entry.messages.value =
+          std::make_shared<const std::vector<CidMessage>>(std::move(messages));
+      entry.receipts.value =
+          std::make_shared<const std::vector<MessageReceipt>>(
+              std::move(receipts));
+      return parent_messages_cache->insert(std::move(entry));
+    };
     auto tipsetContext = [=](const TipsetKey &tipset_key,
                              bool interpret =
                                  false) -> outcome::result<TipsetContext> {
-      Tipset tipset;
-      if (tipset_key.cids.empty()) {
-        OUTCOME_TRYA(tipset, chain_store->heaviestTipset());
-      } else {
-        OUTCOME_TRYA(tipset, chain_store->loadTipset(tipset_key));
+      auto key{tipset_key.cids};
+      boost::optional<Tipset> heaviest;
+      if (key.empty()) {
+        OUTCOME_TRY(tipset, chain_store->heaviestTipset());
+        key = tipset.cids;
+        heaviest = std::move(tipset);
       }
-      TipsetContext context{tipset, {ipld, tipset.getParentStateRoot()}, {}};
-      if (interpret) {
-        OUTCOME_TRY(result, interpreter->interpret(ipld, tipset));
-        context.state_tree = {ipld, result.state_root};
-        context.interpreted = result;
+      auto entry{context_cache->find(key, interpret)};
+      if (!entry) {
+        Tipset tipset;
+        if (heaviest) {
+          tipset = std::move(*heaviest);
+        } else {
+          OUTCOME_TRYA(tipset, chain_store->loadTipset(tipset_key));
+        }
+        auto state_root{tipset.getParentStateRoot()};
+        boost::optional<InterpreterResult> interpreted;
+        if (interpret) {
+          OUTCOME_TRY(result, interpreter->interpret(ipld, tipset));
+          state_root = result.state_root;
+          interpreted = std::move(result);
+        }
+        entry = context_cache->insert({std::move(key),
+                                       interpret,
+                                       std::move(tipset),
+                                       std::move(state_root),
+                                       std::move(interpreted),
+                                       std::make_shared<TipsetStates>()});
       }
-      return context;
+      return TipsetContext{entry->tipset,
+                           {ipld, entry->state_root},
+                           entry->interpreted,
+                           entry->states};
     };
     return {
         .AuthNew = {[](auto) {
@@ -146,36 +497,20 @@ namespace fc::api {
 
           return chain_store->getCbor<UnsignedMessage>(cid);
         }},
-        .ChainGetParentMessages =
-            {[=](auto &block_cid) -> outcome::result<std::vector<CidMessage>> {
-              std::vector<CidMessage> messages;
-              OUTCOME_TRY(block, ipld->getCbor<BlockHeader>(block_cid));
-              for (auto &parent_cid : block.parents) {
-                OUTCOME_TRY(parent, ipld->getCbor<BlockHeader>(parent_cid));
-                OUTCOME_TRY(meta, ipld->getCbor<MsgMeta>(parent.messages));
-                OUTCOME_TRY(meta.bls_messages.visit(
-                    [&](auto, auto &cid) -> outcome::result<void> {
-                      OUTCOME_TRY(message, ipld->getCbor<UnsignedMessage>(cid));
-                      messages.push_back({cid, std::move(message)});
-                      return outcome::success();
-                    }));
-                OUTCOME_TRY(meta.secp_messages.visit(
-                    [&](auto, auto &cid) -> outcome::result<void> {
-                      OUTCOME_TRY(message, ipld->getCbor<SignedMessage>(cid));
-                      messages.push_back({cid, std::move(message.message)});
-                      return outcome::success();
-                    }));
-              }
-              return messages;
-            }},
-        .ChainGetParentReceipts =
-            {[=](auto &block_cid)
-                 -> outcome::result<std::vector<MessageReceipt>> {
-              OUTCOME_TRY(block, ipld->getCbor<BlockHeader>(block_cid));
-              return adt::Array<MessageReceipt>{block.parent_message_receipts,
-                                                ipld}
-                  .values();
-            }},
+        .ChainGetParentMessages = {[=](auto &block_cid)
+                                       -> outcome::result<
+                                           Shared<std::vector<CidMessage>>> {
+          OUTCOME_TRY(block, ipld->getCbor<BlockHeader>(block_cid));
+          OUTCOME_TRY(entry, parentMessages(block));
+          return std::move(entry.messages);
+        }},
+        .ChainGetParentReceipts = {[=](auto &block_cid)
+                                       -> outcome::result<Shared<
+                                           std::vector<MessageReceipt>>> {
+          OUTCOME_TRY(block, ipld->getCbor<BlockHeader>(block_cid));
+          OUTCOME_TRY(entry, parentMessages(block));
+          return std::move(entry.receipts);
+        }},
         .ChainGetRandomness = {[=](auto &tipset_key, auto round) {
           return chain_randomness->sampleRandomness(tipset_key.cids, round);
         }},
@@ -184,16 +519,19 @@ namespace fc::api {
         }},
         .ChainGetTipSetByHeight = {[=](auto height2, auto &tipset_key)
                                        -> outcome::result<Tipset> {
-          // TODO(turuslan): use height index from chain store
-          // TODO(turuslan): return genesis if height is zero
           auto height = static_cast<uint64_t>(height2);
-          OUTCOME_TRY(tipset,
-                      tipset_key.cids.empty()
-                          ? chain_store->heaviestTipset()
-                          : chain_store->loadTipset(tipset_key));
+          if (tipset_key.cids.empty()) {
+            return chain_store->loadTipsetByHeight(height);
+          }
+          OUTCOME_TRY(tipset, chain_store->loadTipset(tipset_key));
           if (tipset.height < height) {
             return TodoError::ERROR;
           }
+          // height index covers only heaviest chain
+          auto canonical = chain_store->loadTipsetByHeight(tipset.height);
+          if (canonical && canonical.value() == tipset) {
+            return chain_store->loadTipsetByHeight(height);
+          }
           while (tipset.height > height) {
             OUTCOME_TRY(parent, tipset.loadParent(*ipld));
             if (parent.height < height) {
@@ -207,8 +545,9 @@ namespace fc::api {
         .ChainNotify = {[=]() {
           auto channel = std::make_shared<Channel<std::vector<HeadChange>>>();
           auto cnn = std::make_shared<connection_t>();
-          *cnn = chain_store->subscribeHeadChanges([=](auto &change) {
-            if (!channel->write({change})) {
+          // one message per head switch, as lotus sends
+          *cnn = chain_store->subscribeHeadChangeBatches([=](auto &changes) {
+            if (!channel->write(changes)) {
               assert(cnn->connected());
               cnn->disconnect();
             }
@@ -237,6 +576,10 @@ namespace fc::api {
         .ClientRetrieve = {},
         // TODO(turuslan): FIL-165 implement method
         .ClientStartDeal = {},
+        .LogList = {[]() { return common::loggerTags(); }},
+        .LogSetLevel = {[](auto &tag, auto &level) {
+          return common::setLogLevel(tag, level);
+        }},
         // TODO(turuslan): FIL-165 implement method
         .MarketEnsureAvailable = {},
         .MinerCreateBlock = {[=](auto &t) -> outcome::result<BlockMsg> {
@@ -267,15 +610,25 @@ namespace fc::api {
                                  -> outcome::result<MiningBaseInfo> {
           OUTCOME_TRY(context, tipsetContext(tipset_key, true));
           OUTCOME_TRY(state, context.minerState(miner));
-          OUTCOME_TRY(power_state, context.powerState());
+          OUTCOME_TRY(power_state, context.lazyPowerState());
+          OUTCOME_TRY(claims, power_state.get(power_lazy::kClaims));
           MiningBaseInfo info;
-          OUTCOME_TRY(claim, power_state.claims.get(miner));
+          OUTCOME_TRY(claim, claims.get(miner));
           info.miner_power = claim.qa_power;
-          info.network_power = power_state.total_qa_power;
+          OUTCOME_TRYA(info.network_power,
+                       power_state.get(power_lazy::kTotalQaPower));
           OUTCOME_TRYA(info.worker, context.accountKey(state.info.worker));
           info.sector_size = state.info.sector_size;
           return info;
         }},
+        .MpoolGetNonce = {[=](auto &address) -> outcome::result<uint64_t> {
+          auto from{address};
+          if (from.isId()) {
+            OUTCOME_TRY(context, tipsetContext({}));
+            OUTCOME_TRYA(from, context.accountKey(from));
+          }
+          return mpool->nonce(from);
+        }},
         .MpoolPending = {[=](auto &tipset_key)
                              -> outcome::result<std::vector<SignedMessage>> {
           OUTCOME_TRY(context, tipsetContext(tipset_key));
@@ -286,6 +639,10 @@ namespace fc::api {
           }
           return mpool->pending();
         }},
+        .MpoolPush = {[=](auto &signed_message) -> outcome::result<CID> {
+          OUTCOME_TRY(mpool->add(signed_message));
+          return signed_message.getCid();
+        }},
         .MpoolPushMessage = {[=](auto message)
                                  -> outcome::result<SignedMessage> {
           OUTCOME_TRY(context, tipsetContext({}));
@@ -332,6 +689,7 @@ namespace fc::api {
               std::make_shared<StateTreeImpl>(context.state_tree),
               std::make_shared<InvokerImpl>(),
               static_cast<ChainEpoch>(context.tipset.height));
+          env->tracing = true;
           InvocResult result;
           result.message = message;
           auto maybe_result = env->applyImplicitMessage(message);
@@ -348,6 +706,7 @@ namespace fc::api {
               return maybe_result.error();
             }
           }
+          result.execution_trace = env->takeTrace(message, result.receipt);
           return result;
         }},
         .StateListMessages = {[=](auto &match, auto &tipset_key, auto to_height)
@@ -372,10 +731,10 @@ namespace fc::api {
           std::vector<CID> result;
 
           while (static_cast<int64_t>(context.tipset.height) >= to_height) {
-            std::set<CID> visited_cid;
+            CidSet visited_cid;
 
             auto isDuplicateMessage = [&](const CID &cid) -> bool {
-              return !visited_cid.insert(cid).second;
+              return !visited_cid.insert(cid);
             };
 
             for (const BlockHeader &block : context.tipset.blks) {
@@ -427,14 +786,26 @@ namespace fc::api {
               .state = IpldObject{std::move(cid), std::move(raw)},
           };
         }},
+        .StateReplay = {[=](auto &tipset_key,
+                            auto &message) -> outcome::result<InvocResult> {
+          OUTCOME_TRY(context, tipsetContext(tipset_key));
+          OUTCOME_TRY(trace,
+                      interpreter->replay(ipld, context.tipset, message));
+          InvocResult result;
+          result.message = trace.message;
+          result.receipt = trace.receipt;
+          result.error = trace.error;
+          result.execution_trace = std::move(trace);
+          return result;
+        }},
         .StateGetReceipt = {[=](auto &cid, auto &tipset_key)
                                 -> outcome::result<MessageReceipt> {
           OUTCOME_TRY(context, tipsetContext(tipset_key));
-          auto result{msg_waiter->results.find(cid)};
-          if (result != msg_waiter->results.end()) {
-            OUTCOME_TRY(ts, Tipset::load(*ipld, result->second.second.cids));
+          OUTCOME_TRY(result, msg_waiter->find(cid));
+          if (result) {
+            OUTCOME_TRY(ts, Tipset::load(*ipld, result->second.cids));
             if (context.tipset.height <= ts.height) {
-              return result->second.first;
+              return result->first;
             }
           }
           return TodoError::ERROR;
@@ -442,8 +813,9 @@ namespace fc::api {
         .StateListMiners = {[=](auto &tipset_key)
                                 -> outcome::result<std::vector<Address>> {
           OUTCOME_TRY(context, tipsetContext(tipset_key));
-          OUTCOME_TRY(power_state, context.powerState());
-          return power_state.claims.keys();
+          OUTCOME_TRY(power_state, context.lazyPowerState());
+          OUTCOME_TRY(claims, power_state.get(power_lazy::kClaims));
+          return claims.keys();
         }},
         .StateListActors = {[=](auto &tipset_key)
                                 -> outcome::result<std::vector<Address>> {
@@ -453,13 +825,61 @@ namespace fc::api {
 
           return actors.keys();
         }},
+        .StateListMinersPage = {[=](auto &tipset_key, auto &token, auto limit)
+                                    -> outcome::result<AddressPage> {
+          OUTCOME_TRY(context, tipsetContext(tipset_key));
+          OUTCOME_TRY(power_state, context.lazyPowerState());
+          OUTCOME_TRY(claims, power_state.get(power_lazy::kClaims));
+          return addressPage(claims, token, limit);
+        }},
+        .StateListActorsPage = {[=](auto &tipset_key, auto &token, auto limit)
+                                    -> outcome::result<AddressPage> {
+          OUTCOME_TRY(context, tipsetContext(tipset_key));
+          adt::Map<Actor, adt::AddressKeyer> actors{
+              context.tipset.getParentStateRoot(), ipld};
+          return addressPage(actors, token, limit);
+        }},
+        .StateChangedActors = {[=](auto &old_root, auto &new_root)
+                                   -> outcome::result<
+                                       std::map<std::string, Actor>> {
+          adt::Map<Actor, adt::AddressKeyer> before{old_root, ipld};
+          adt::Map<Actor, adt::AddressKeyer> after{new_root, ipld};
+          std::map<std::string, Actor> changed;
+          OUTCOME_TRY(after.diff(
+              before,
+              [&](auto &address, auto, auto actor) -> outcome::result<void> {
+                if (actor) {
+                  changed.emplace(
+                      primitives::address::encodeToString(address), *actor);
+                }
+                return outcome::success();
+              }));
+          return changed;
+        }},
+        .StateAnalyze = {[=](auto &tipset_key)
+                             -> outcome::result<StateShape> {
+          OUTCOME_TRY(context, tipsetContext(tipset_key));
+          return vm::state::analyzeState(ipld,
+                                         context.tipset.getParentStateRoot());
+        }},
+        .StateAnalyzeDiff = {[=](auto &before_key, auto &after_key)
+                                 -> outcome::result<StateShapeDiff> {
+          OUTCOME_TRY(before, tipsetContext(before_key));
+          OUTCOME_TRY(after, tipsetContext(after_key));
+          return vm::state::diffStateShape(
+              ipld,
+              before.tipset.getParentStateRoot(),
+              after.tipset.getParentStateRoot());
+        }},
         .StateMarketBalance = {[=](auto &address, auto &tipset_key)
                                    -> outcome::result<MarketBalance> {
           OUTCOME_TRY(context, tipsetContext(tipset_key));
-          OUTCOME_TRY(state, context.marketState());
+          OUTCOME_TRY(state, context.lazyMarketState());
+          OUTCOME_TRY(escrow_table, state.get(market_lazy::kEscrowTable));
+          OUTCOME_TRY(locked_table, state.get(market_lazy::kLockedTable));
           OUTCOME_TRY(id_address, context.state_tree.lookupId(address));
-          OUTCOME_TRY(escrow, state.escrow_table.tryGet(id_address));
-          OUTCOME_TRY(locked, state.locked_table.tryGet(id_address));
+          OUTCOME_TRY(escrow, escrow_table.tryGet(id_address));
+          OUTCOME_TRY(locked, locked_table.tryGet(id_address));
           if (!escrow) {
             escrow = 0;
           }
@@ -520,56 +940,78 @@ namespace fc::api {
         .StateMinerPower = {[=](auto &address, auto &tipset_key)
                                 -> outcome::result<MinerPower> {
           OUTCOME_TRY(context, tipsetContext(tipset_key));
-          OUTCOME_TRY(power_state, context.powerState());
-          OUTCOME_TRY(miner_power, power_state.claims.get(address));
-          return MinerPower{
-              miner_power,
-              {power_state.total_raw_power, power_state.total_qa_power},
-          };
+          OUTCOME_TRY(power_state, context.lazyPowerState());
+          OUTCOME_TRY(claims, power_state.get(power_lazy::kClaims));
+          OUTCOME_TRY(miner_power, claims.get(address));
+          OUTCOME_TRY(total_raw, power_state.get(power_lazy::kTotalRawPower));
+          OUTCOME_TRY(total_qa, power_state.get(power_lazy::kTotalQaPower));
+          return MinerPower{miner_power, {total_raw, total_qa}};
         }},
-        .StateMinerProvingSet =
-            {[=](auto address, auto tipset_key)
-                 -> outcome::result<std::vector<ChainSectorInfo>> {
-              OUTCOME_TRY(context, tipsetContext(tipset_key));
-              OUTCOME_TRY(state, context.minerState(address));
-              std::vector<ChainSectorInfo> sectors;
-              OUTCOME_TRY(state.sectors.visit([&](auto id, auto &info) {
-                if (state.fault_set.find(id) == state.fault_set.end()
-                    && state.recoveries.find(id) == state.recoveries.end()) {
-                  sectors.emplace_back(ChainSectorInfo{info, id});
+        .StateMinerProvingSet = {[=](auto address, auto tipset_key)
+                                     -> outcome::result<
+                                         Shared<std::vector<ChainSectorInfo>>> {
+          OUTCOME_TRY(context, tipsetContext(tipset_key));
+          return minerSectors(context, address, true);
+        }},
+        // TODO(artyom-yurin): implement filter
+        .StateMinerSectors = {[=](auto address,
+                                  auto filter,
+                                  auto filter_out,
+                                  auto tipset_key)
+                                  -> outcome::result<
+                                      Shared<std::vector<ChainSectorInfo>>> {
+          OUTCOME_TRY(context, tipsetContext(tipset_key));
+          return minerSectors(context, address, false);
+        }},
+        .StateMinerSectorsPage = {[=](auto &address,
+                                      auto proving,
+                                      auto from,
+                                      auto limit,
+                                      auto &tipset_key)
+                                      -> outcome::result<SectorPage> {
+          OUTCOME_TRY(context, tipsetContext(tipset_key));
+          if (limit == 0 || limit > kMaxSectorPage) {
+            limit = kMaxSectorPage;
+          }
+          SectorPage page;
+          OUTCOME_TRY(actor, context.state_tree.get(address));
+          // page of cached result is copied, otherwise only amt nodes from
+          // first sector of page are loaded
+          if (auto cached{sector_cache->find(actor.head, proving)}) {
+            auto &sectors{*cached->value};
+            auto it{std::lower_bound(sectors.begin(),
+                                     sectors.end(),
+                                     from,
+                                     [](auto &sector, auto id) {
+                                       return sector.id < id;
+                                     })};
+            for (; it != sectors.end(); ++it) {
+              if (page.sectors.size() == limit) {
+                page.next = it->id;
+                break;
+              }
+              page.sectors.push_back(*it);
+            }
+            return page;
+          }
+          OUTCOME_TRY(state, context.minerState(address));
+          OUTCOME_TRY(state.sectors.visitWhile(
+              [&](auto id, auto &info) -> outcome::result<bool> {
+                if (page.sectors.size() == limit) {
+                  page.next = id;
+                  return false;
                 }
-                return outcome::success();
-              }));
-              return sectors;
-            }},
-        .StateMinerSectors =
-            {[=](auto address, auto filter, auto filter_out, auto tipset_key)
-                 -> outcome::result<std::vector<ChainSectorInfo>> {
-              OUTCOME_TRY(context, tipsetContext(tipset_key));
-              OUTCOME_TRY(state, context.minerState(address));
-
-              std::vector<ChainSectorInfo> res = {};
-
-              auto visitor =
-                  [&](uint64_t i,
-                      const SectorOnChainInfo &info) -> outcome::result<void> {
-                if (filter != nullptr) {
-                  // TODO(artyom-yurin): implement filter
-                };
-
-                ChainSectorInfo sector_info{
-                    .info = info,
-                    .id = i,
-                };
-
-                res.push_back(sector_info);
-                return outcome::success();
-              };
-
-              OUTCOME_TRY(state.sectors.visit(visitor));
-
-              return res;
-            }},
+                if (!proving
+                    || (state.fault_set.find(id) == state.fault_set.end()
+                        && state.recoveries.find(id)
+                               == state.recoveries.end())) {
+                  page.sectors.push_back({info, id});
+                }
+                return true;
+              },
+              from));
+          return page;
+        }},
         .StateMinerSectorSize = {[=](auto address, auto tipset_key)
                                      -> outcome::result<SectorSize> {
           OUTCOME_TRY(context, tipsetContext(tipset_key));
@@ -603,12 +1045,8 @@ namespace fc::api {
           // TODO(turuslan): chain store must validate blocks before adding
           MsgMeta meta;
           ipld->load(meta);
-          for (auto &cid : block.bls_messages) {
-            OUTCOME_TRY(meta.bls_messages.append(cid));
-          }
-          for (auto &cid : block.secp_messages) {
-            OUTCOME_TRY(meta.secp_messages.append(cid));
-          }
+          OUTCOME_TRY(meta.bls_messages.assign(block.bls_messages));
+          OUTCOME_TRY(meta.secp_messages.assign(block.secp_messages));
           OUTCOME_TRY(messages, ipld->setCbor(meta));
           if (block.header.messages != messages) {
             return TodoError::ERROR;
@@ -619,6 +1057,17 @@ namespace fc::api {
         .Version = {[]() {
           return VersionResult{"fuhon", 0x000200, 5};
         }},
+        .VmProfile = {[=](auto reset) {
+          VmProfileReport report;
+          if (profiler) {
+            report.methods = profiler->methods();
+            report.folded = profiler->folded();
+            if (reset) {
+              profiler->reset();
+            }
+          }
+          return report;
+        }},
         .WalletBalance = {[=](auto &address) -> outcome::result<TokenAmount> {
           OUTCOME_TRY(context, tipsetContext({}));
           OUTCOME_TRY(actor, context.state_tree.get(address));
@@ -15,6 +15,7 @@
 #include "storage/keystore/keystore.hpp"
 #include "storage/mpool/mpool.hpp"
 #include "vm/interpreter/interpreter.hpp"
+#include "vm/interpreter/message_cache.hpp"
 
 namespace fc::api {
   using blockchain::weight::WeightCalculator;
@@ -24,12 +25,23 @@ namespace fc::api {
   using storage::keystore::KeyStore;
   using storage::mpool::Mpool;
   using vm::interpreter::Interpreter;
+  using vm::interpreter::MessageCache;
   using Logger = common::Logger;
 
   outcome::result<IpldObject> getNode(std::shared_ptr<Ipld> ipld,
                                       const CID &root,
                                       gsl::span<const std::string> parts);
 
+  /**
+   * Makes node api, whose methods may be called concurrently, e.g. by rpc
+   * worker threads. Methods only read chain, state and key store, or go
+   * through components which lock their state: chain store (head, height
+   * index, SyncSubmitBlock head changes), mpool (MpoolPush, MpoolPending,
+   * MpoolGetNonce), msg waiter (StateWaitMsg, StateGetReceipt) and
+   * interpreter cache. ChainNotify and MpoolSub channels are written from
+   * head change threads. Chain store must be thread-safe, as ChainStoreImpl
+   * is.
+   */
   Api makeImpl(std::shared_ptr<ChainStore> chain_store,
                std::shared_ptr<WeightCalculator> weight_calculator,
                std::shared_ptr<Ipld> ipld,
@@ -37,7 +49,9 @@ namespace fc::api {
                std::shared_ptr<Mpool> mpool,
                std::shared_ptr<Interpreter> interpreter,
                std::shared_ptr<MsgWaiter> msg_waiter,
-               std::shared_ptr<KeyStore> key_store);
+               std::shared_ptr<KeyStore> key_store,
+               std::shared_ptr<vm::runtime::Profiler> profiler = nullptr,
+               std::shared_ptr<MessageCache> message_cache = nullptr);
 }  // namespace fc::api
 
 #endif  // CPP_FILECOIN_CORE_API_MAKE_HPP
@@ -0,0 +1,162 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_API_RPC_CBOR_HPP
+#define CPP_FILECOIN_CORE_API_RPC_CBOR_HPP
+
+#include "api/rpc/rpc.hpp"
+#include "codec/cbor/cbor.hpp"
+
+/**
+ * Binary rpc transport. Websocket client requesting kCborProtocol
+ * subprotocol may send binary messages, which carry cbor requests and
+ * responses. Params and results are encoded with cbor codecs of their
+ * types, text messages of same connection are still json.
+ */
+namespace fc::api {
+  template <typename T>
+  struct Shared;
+}  // namespace fc::api
+
+namespace fc::api::rpc {
+  using codec::cbor::CborDecodeStream;
+  using codec::cbor::CborEncodeStream;
+  using common::Buffer;
+
+  /// Websocket subprotocol of binary transport
+  constexpr auto kCborProtocol = "fuhon-cbor";
+
+  /// Cbor request [id, method, params], params is list of method params
+  struct CborRequest {
+    uint64_t id{};
+    std::string method;
+    Buffer params;
+  };
+
+  /// Cbor response [id, error, result], error is [code, message] or null
+  struct CborResponse {
+    uint64_t id{};
+    boost::optional<Response::Error> error;
+    /// Encoded result, null for void method or error
+    Buffer result;
+  };
+
+  CBOR_ENCODE(CborRequest, v) {
+    return s << (s.list() << v.id << v.method
+                          << CborEncodeStream::wrap(v.params, 1));
+  }
+
+  CBOR_DECODE(CborRequest, v) {
+    auto l{s.list()};
+    l >> v.id >> v.method;
+    v.params = Buffer{l.raw()};
+    return s;
+  }
+
+  CBOR_ENCODE(CborResponse, v) {
+    auto l{s.list()};
+    l << v.id;
+    if (v.error) {
+      l << (s.list() << v.error->code << v.error->message);
+    } else {
+      l << nullptr;
+    }
+    if (v.result.empty()) {
+      l << nullptr;
+    } else {
+      l << CborEncodeStream::wrap(v.result, 1);
+    }
+    return s << l;
+  }
+
+  CBOR_DECODE(CborResponse, v) {
+    auto l{s.list()};
+    l >> v.id;
+    if (l.isNull()) {
+      v.error = boost::none;
+      l.next();
+    } else {
+      Response::Error error;
+      l.list() >> error.code >> error.message;
+      v.error = std::move(error);
+    }
+    if (l.isNull()) {
+      v.result = {};
+      l.next();
+    } else {
+      v.result = Buffer{l.raw()};
+    }
+    return s;
+  }
+
+  template <typename T, typename = void>
+  struct has_cbor : std::false_type {};
+
+  template <typename T>
+  struct has_cbor<
+      T,
+      std::void_t<decltype(std::declval<CborEncodeStream &>()
+                           << std::declval<const T &>()),
+                  decltype(std::declval<CborDecodeStream &>()
+                           >> std::declval<T &>())>> : std::true_type {};
+
+  /// Checks whether type has cbor codec, containers are checked by elements
+  template <typename T>
+  struct is_cbor : has_cbor<T> {};
+
+  template <>
+  struct is_cbor<void> : std::true_type {};
+
+  template <>
+  struct is_cbor<std::vector<uint8_t>> : std::true_type {};
+
+  template <typename T>
+  struct is_cbor<std::vector<T>> : is_cbor<T> {};
+
+  template <typename T>
+  struct is_cbor<boost::optional<T>> : is_cbor<T> {};
+
+  template <typename T>
+  struct is_cbor<Shared<T>> : is_cbor<T> {};
+
+  template <typename T>
+  struct is_cbor<std::map<std::string, T>> : is_cbor<T> {};
+
+  template <typename... T>
+  struct is_cbor<std::tuple<T...>> : std::conjunction<is_cbor<T>...> {};
+
+  /// Encodes params as list
+  template <typename... T>
+  outcome::result<Buffer> encodeParams(const std::tuple<T...> &params) {
+    try {
+      CborEncodeStream s;
+      auto l{s.list()};
+      std::apply([&](auto &... param) { (l << ... << param); }, params);
+      s << l;
+      return Buffer{s.data()};
+    } catch (std::system_error &e) {
+      return outcome::failure(e.code());
+    }
+  }
+
+  /// Decodes params from list of exactly their count
+  template <typename... T>
+  outcome::result<void> decodeParams(gsl::span<const uint8_t> input,
+                                     std::tuple<T...> &params) {
+    try {
+      auto s{CborDecodeStream::borrow(input)};
+      if (!s.isList() || s.listLength() != sizeof...(T)) {
+        return codec::cbor::CborDecodeError::WRONG_SIZE;
+      }
+      auto l{s.list()};
+      std::apply([&](auto &... param) { (l >> ... >> param); }, params);
+      return outcome::success();
+    } catch (std::system_error &e) {
+      return outcome::failure(e.code());
+    }
+  }
+}  // namespace fc::api::rpc
+
+#endif  // CPP_FILECOIN_CORE_API_RPC_CBOR_HPP
@@ -0,0 +1,230 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "api/rpc/client.hpp"
+
+#include <rapidjson/writer.h>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+
+namespace fc::api::rpc {
+  namespace net = boost::asio;
+  namespace http = boost::beast::http;
+  namespace websocket = boost::beast::websocket;
+  using tcp = boost::asio::ip::tcp;
+
+  Client::Client()
+      : work_{net::make_work_guard(io_)},
+        socket_{io_},
+        thread_{[this] { io_.run(); }},
+        logger_{common::createLogger("rpc client")} {}
+
+  Client::~Client() {
+    net::post(io_, [this] {
+      boost::system::error_code ec;
+      socket_.next_layer().close(ec);
+      close();
+    });
+    work_.reset();
+    thread_.join();
+  }
+
+  outcome::result<void> Client::connect(const std::string &host,
+                                        unsigned short port,
+                                        const std::string &target,
+                                        bool cbor) {
+    boost::system::error_code ec;
+    tcp::resolver resolver{io_};
+    auto endpoints = resolver.resolve(host, std::to_string(port), ec);
+    if (!ec) {
+      net::connect(socket_.next_layer(), endpoints, ec);
+    }
+    if (cbor) {
+      socket_.set_option(websocket::stream_base::decorator(
+          [](websocket::request_type &request) {
+            request.set(http::field::sec_websocket_protocol, kCborProtocol);
+          }));
+    }
+    websocket::response_type response;
+    if (!ec) {
+      socket_.handshake(
+          response, host + ":" + std::to_string(port), target, ec);
+    }
+    if (ec) {
+      logger_->error("connect to {}:{}: {}", host, port, ec.message());
+      return ClientError::CONNECTION_FAILED;
+    }
+    {
+      std::lock_guard lock{mutex_};
+      cbor_ = cbor
+              && response[http::field::sec_websocket_protocol]
+                     == kCborProtocol;
+      connected_ = true;
+    }
+    net::post(io_, [this] { doRead(); });
+    return outcome::success();
+  }
+
+  outcome::result<Document> Client::call(const std::string &method,
+                                         Document params) {
+    std::future<outcome::result<Document>> future;
+    rapidjson::StringBuffer buffer;
+    {
+      std::lock_guard lock{mutex_};
+      if (!connected_) {
+        return ClientError::NOT_CONNECTED;
+      }
+      auto id = next_id_++;
+      Request request{id, method, std::move(params)};
+      rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+      write(writer, request);
+      future = pending_[id].get_future();
+    }
+    net::post(io_,
+              [this, message{std::string{buffer.GetString(),
+                                         buffer.GetSize()}}]() mutable {
+                write(std::move(message), false);
+              });
+    return future.get();
+  }
+
+  outcome::result<Buffer> Client::callCbor(const std::string &method,
+                                           Buffer params) {
+    std::future<outcome::result<Buffer>> future;
+    std::string message;
+    {
+      std::lock_guard lock{mutex_};
+      if (!connected_) {
+        return ClientError::NOT_CONNECTED;
+      }
+      auto id = next_id_++;
+      OUTCOME_TRY(request,
+                  codec::cbor::encode(
+                      CborRequest{id, method, std::move(params)}));
+      message.assign(request.begin(), request.end());
+      future = pending_cbor_[id].get_future();
+    }
+    net::post(io_, [this, message{std::move(message)}]() mutable {
+      write(std::move(message), true);
+    });
+    return future.get();
+  }
+
+  void Client::write(std::string message, bool binary) {
+    writes_.emplace(std::move(message), binary);
+    flush();
+  }
+
+  void Client::doRead() {
+    socket_.async_read(buffer_, [this](auto ec, auto) {
+      if (ec) {
+        return close();
+      }
+      onRead();
+      doRead();
+    });
+  }
+
+  void Client::onRead() {
+    if (!socket_.got_text()) {
+      return onReadCbor();
+    }
+    rapidjson::Document j_response;
+    j_response.Parse(static_cast<const char *>(buffer_.cdata().data()),
+                     buffer_.cdata().size());
+    buffer_.clear();
+    if (j_response.HasParseError()) {
+      return;
+    }
+    // requests of server, for example channel values, are ignored
+    auto maybe_response = decode<Response>(j_response);
+    if (!maybe_response || !maybe_response.value().id) {
+      return;
+    }
+    auto &response = maybe_response.value();
+    std::lock_guard lock{mutex_};
+    auto it = pending_.find(*response.id);
+    if (it == pending_.end()) {
+      return;
+    }
+    if (auto error = boost::get<Response::Error>(&response.result)) {
+      logger_->warn("remote error {}: {}", error->code, error->message);
+      it->second.set_value(ClientError::REMOTE_ERROR);
+    } else {
+      it->second.set_value(
+          std::move(boost::get<Document>(response.result)));
+    }
+    pending_.erase(it);
+  }
+
+  void Client::onReadCbor() {
+    auto data{buffer_.cdata()};
+    auto maybe_response{codec::cbor::decode<CborResponse>(
+        {static_cast<const uint8_t *>(data.data()), data.size()})};
+    buffer_.clear();
+    if (!maybe_response) {
+      return;
+    }
+    auto &response = maybe_response.value();
+    std::lock_guard lock{mutex_};
+    auto it = pending_cbor_.find(response.id);
+    if (it == pending_cbor_.end()) {
+      return;
+    }
+    if (response.error) {
+      logger_->warn(
+          "remote error {}: {}", response.error->code, response.error->message);
+      it->second.set_value(ClientError::REMOTE_ERROR);
+    } else {
+      it->second.set_value(std::move(response.result));
+    }
+    pending_cbor_.erase(it);
+  }
+
+  void Client::flush() {
+    if (writing_ || writes_.empty()) {
+      return;
+    }
+    writing_ = true;
+    socket_.binary(writes_.front().second);
+    socket_.async_write(net::buffer(writes_.front().first),
+                        [this](auto ec, auto) {
+                          writing_ = false;
+                          writes_.pop();
+                          if (ec) {
+                            return close();
+                          }
+                          flush();
+                        });
+  }
+
+  void Client::close() {
+    std::lock_guard lock{mutex_};
+    connected_ = false;
+    for (auto &call : pending_) {
+      call.second.set_value(ClientError::CONNECTION_CLOSED);
+    }
+    pending_.clear();
+    for (auto &call : pending_cbor_) {
+      call.second.set_value(ClientError::CONNECTION_CLOSED);
+    }
+    pending_cbor_.clear();
+  }
+}  // namespace fc::api::rpc
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::api::rpc, ClientError, e) {
+  using E = fc::api::rpc::ClientError;
+  switch (e) {
+    case E::NOT_CONNECTED:
+      return "not connected";
+    case E::CONNECTION_FAILED:
+      return "connection failed";
+    case E::CONNECTION_CLOSED:
+      return "connection closed";
+    case E::REMOTE_ERROR:
+      return "remote method failed";
+  }
+  return "unknown ClientError error code";
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_API_RPC_CLIENT_HPP
+#define CPP_FILECOIN_CORE_API_RPC_CLIENT_HPP
+
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include "api/rpc/cbor.hpp"
+#include "api/rpc/json.hpp"
+
+namespace fc::api::rpc {
+  enum class ClientError {
+    NOT_CONNECTED = 1,
+    CONNECTION_FAILED,
+    CONNECTION_CLOSED,
+    REMOTE_ERROR,
+  };
+}  // namespace fc::api::rpc
+
+OUTCOME_HPP_DECLARE_ERROR(fc::api::rpc, ClientError);
+
+namespace fc::api::rpc {
+  /**
+   * Websocket json rpc client. Messages are sent and received on own io
+   * thread, calls from several threads wait for their responses concurrently.
+   * Channel results are not supported. Methods with cbor codecs are called
+   * over binary transport if it was negotiated on connect.
+   */
+  class Client {
+   public:
+    Client();
+
+    /// Fails pending calls and stops io thread
+    ~Client();
+
+    /// @param cbor - request binary cbor transport, json is used if server
+    /// does not accept it
+    outcome::result<void> connect(const std::string &host,
+                                  unsigned short port,
+                                  const std::string &target = "/rpc/v0",
+                                  bool cbor = false);
+
+    /**
+     * @brief sends request, waits for response
+     * @return result of method, REMOTE_ERROR if method failed
+     */
+    outcome::result<Document> call(const std::string &method, Document params);
+
+    /// Sends cbor request, waits for cbor result
+    outcome::result<Buffer> callCbor(const std::string &method, Buffer params);
+
+    /// Makes method call remote method
+    template <typename M>
+    void setup(M &method) {
+      using Result = typename M::Result;
+      method = {[this](auto &&... params) -> outcome::result<Result> {
+        if constexpr (is_cbor<typename M::Params>{} && is_cbor<Result>{}) {
+          if (cbor_) {
+            OUTCOME_TRY(cbor_params, encodeParams(std::make_tuple(params...)));
+            OUTCOME_TRY(result, callCbor(M::name, std::move(cbor_params)));
+            if constexpr (std::is_same_v<Result, void>) {
+              return outcome::success();
+            } else {
+              return codec::cbor::decode<Result>(result);
+            }
+          }
+        }
+        OUTCOME_TRY(result, call(M::name, encode(std::make_tuple(params...))));
+        if constexpr (std::is_same_v<Result, void>) {
+          return outcome::success();
+        } else {
+          return decode<Result>(result);
+        }
+      }};
+    }
+
+   private:
+    /// Queues message, called on io thread
+    void write(std::string message, bool binary);
+
+    void doRead();
+
+    void onRead();
+
+    void onReadCbor();
+
+    void flush();
+
+    /// Fails pending calls, called on io thread
+    void close();
+
+    boost::asio::io_context io_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+        work_;
+    boost::beast::websocket::stream<boost::asio::ip::tcp::socket> socket_;
+    boost::beast::flat_buffer buffer_;
+    std::thread thread_;
+
+    std::mutex mutex_;
+    bool connected_{false};
+    uint64_t next_id_{};
+    std::map<uint64_t, std::promise<outcome::result<Document>>> pending_;
+    std::map<uint64_t, std::promise<outcome::result<Buffer>>> pending_cbor_;
+    /// Server accepted cbor transport, set by connect before calls
+    bool cbor_{false};
+    /// Written on io thread only, messages with binary flag
+    std::queue<std::pair<std::string, bool>> writes_;
+    bool writing_{false};
+    common::Logger logger_;
+  };
+}  // namespace fc::api::rpc
+
+#endif  // CPP_FILECOIN_CORE_API_RPC_CLIENT_HPP
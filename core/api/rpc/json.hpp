@@ -15,6 +15,7 @@
 #include "common/enum.hpp"
 #include "primitives/address/address_codec.hpp"
 #include "primitives/cid/cid_of_cbor.hpp"
+#include "sector_storage/worker.hpp"
 
 #define COMMA ,
 
@@ -35,13 +36,21 @@ namespace fc::api {
   using primitives::block::ElectionProof;
   using primitives::cid::getCidOfCbor;
   using primitives::sector::PoStProof;
+  using primitives::piece::PaddedPieceSize;
+  using primitives::piece::PieceInfo;
   using primitives::sector::RegisteredProof;
+  using primitives::sector::SectorId;
+  using primitives::sector_file::SectorFileType;
+  using proofs::SealedAndUnsealedCID;
   using primitives::ticket::EPostProof;
   using primitives::ticket::EPostTicket;
   using primitives::ticket::Ticket;
   using primitives::tipset::HeadChangeType;
   using rapidjson::Document;
   using rapidjson::Value;
+  using sector_storage::TaskType;
+  using sector_storage::WorkerInfo;
+  using sector_storage::WorkerResources;
   using vm::actor::builtin::miner::SectorPreCommitInfo;
   using vm::actor::builtin::payment_channel::Merge;
   using vm::actor::builtin::payment_channel::ModularVerificationParameter;
@@ -120,6 +129,11 @@ namespace fc::api {
           [&](const Response::Error &error) { Set(j, "error", error); },
           [&](const Document &result) {
             Set(j, "result", Value{result, allocator});
+          },
+          [&](const EncodedJson &result) {
+            Document document;
+            document.Parse(result->data(), result->size());
+            Set(j, "result", Value{document, allocator});
           });
       return j;
     }
@@ -197,7 +211,12 @@ namespace fc::api {
     }
 
     ENCODE(gsl::span<const uint8_t>) {
-      return encode(base64::encode(v.data(), v.size()));
+      // encoded into allocator memory, without intermediate string
+      auto size = base64::encoded_size(v.size());
+      auto chars = static_cast<char *>(allocator.Malloc(size));
+      base64::encode(chars, size, v.data(), v.size());
+      return Value{rapidjson::StringRef(
+          chars, static_cast<rapidjson::SizeType>(size))};
     }
 
     template <size_t N>
@@ -800,6 +819,7 @@ namespace fc::api {
       Set(j, "MsgRct", v.receipt);
       Set(j, "InternalExecutions", v.internal_executions);
       Set(j, "Error", v.error);
+      Set(j, "ExecutionTrace", v.execution_trace);
       return j;
     }
 
@@ -808,6 +828,7 @@ namespace fc::api {
       decode(v.receipt, Get(j, "MsgRct"));
       decode(v.internal_executions, Get(j, "InternalExecutions"));
       v.error = AsString(Get(j, "Error"));
+      decode(v.execution_trace, Get(j, "ExecutionTrace"));
     }
 
     ENCODE(ExecutionResult) {
@@ -824,6 +845,22 @@ namespace fc::api {
       v.error = AsString(Get(j, "Error"));
     }
 
+    ENCODE(ExecutionTrace) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Msg", v.message);
+      Set(j, "MsgRct", v.receipt);
+      Set(j, "Error", v.error);
+      Set(j, "Subcalls", v.subcalls);
+      return j;
+    }
+
+    DECODE(ExecutionTrace) {
+      decode(v.message, Get(j, "Msg"));
+      decode(v.receipt, Get(j, "MsgRct"));
+      v.error = AsString(Get(j, "Error"));
+      decode(v.subcalls, Get(j, "Subcalls"));
+    }
+
     template <typename T>
     Value encodeAs(CborDecodeStream &s) {
       T v;
@@ -888,6 +925,30 @@ namespace fc::api {
       outcome::raise(JsonError::WRONG_TYPE);
     }
 
+    ENCODE(AddressPage) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Addresses", v.addresses);
+      Set(j, "Next", v.next);
+      return j;
+    }
+
+    DECODE(AddressPage) {
+      decode(v.addresses, Get(j, "Addresses"));
+      decode(v.next, Get(j, "Next"));
+    }
+
+    ENCODE(SectorPage) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Sectors", v.sectors);
+      Set(j, "Next", v.next);
+      return j;
+    }
+
+    DECODE(SectorPage) {
+      decode(v.sectors, Get(j, "Sectors"));
+      decode(v.next, Get(j, "Next"));
+    }
+
     ENCODE(VersionResult) {
       Value j{rapidjson::kObjectType};
       Set(j, "Version", v.version);
@@ -896,6 +957,89 @@ namespace fc::api {
       return j;
     }
 
+    ENCODE(MethodProfile) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Actor", vm::runtime::Profiler::codeName(v.code));
+      Set(j, "Method", v.method.method_number);
+      Set(j, "Calls", v.calls);
+      Set(j, "TotalTime", static_cast<int64_t>(v.total_time.count()));
+      Set(j, "SelfTime", static_cast<int64_t>(v.self_time.count()));
+      Set(j, "Gas", v.gas);
+      Set(j, "IpldReads", v.ipld.reads);
+      Set(j, "IpldReadBytes", v.ipld.read_bytes);
+      Set(j, "IpldWrites", v.ipld.writes);
+      Set(j, "IpldWriteBytes", v.ipld.write_bytes);
+      Set(j, "IpldCacheHits", v.ipld.cache_hits);
+      return j;
+    }
+
+    ENCODE(VmProfileReport) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Methods", v.methods);
+      Set(j, "Folded", v.folded);
+      return j;
+    }
+
+    ENCODE(vm::state::DagShape) {
+      using vm::state::DagKind;
+      Value j{rapidjson::kObjectType};
+      Set(j,
+          "Kind",
+          v.kind == DagKind::HAMT  ? "hamt"
+          : v.kind == DagKind::AMT ? "amt"
+                                   : "dag");
+      Set(j, "Blocks", v.blocks);
+      Set(j, "Bytes", v.bytes);
+      Set(j, "Depth", v.depth);
+      Set(j, "Fanout", v.fanout);
+      Set(j, "Entries", v.entries);
+      Set(j, "Capacity", v.capacity);
+      return j;
+    }
+
+    ENCODE(vm::state::EmbeddedShape) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Root", v.root);
+      Set(j, "Shape", v.shape);
+      return j;
+    }
+
+    ENCODE(vm::state::ActorShape) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Address", v.address);
+      Set(j, "Actor", v.actor);
+      Set(j, "State", v.state);
+      Set(j, "Embedded", v.embedded);
+      return j;
+    }
+
+    ENCODE(StateShape) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Root", v.root);
+      Set(j, "ActorsHamt", v.actors_hamt);
+      Set(j, "Actors", v.actors);
+      return j;
+    }
+
+    ENCODE(vm::state::ActorShapeDiff) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Address", v.address);
+      Set(j, "BlocksAdded", v.blocks_added);
+      Set(j, "BytesAdded", v.bytes_added);
+      Set(j, "BlocksRemoved", v.blocks_removed);
+      Set(j, "BytesRemoved", v.bytes_removed);
+      return j;
+    }
+
+    ENCODE(StateShapeDiff) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "ActorsAdded", v.actors_added);
+      Set(j, "ActorsRemoved", v.actors_removed);
+      Set(j, "ActorsChanged", v.actors_changed);
+      Set(j, "Actors", v.actors);
+      return j;
+    }
+
     ENCODE(MiningBaseInfo) {
       Value j{rapidjson::kObjectType};
       Set(j, "MinerPower", v.miner_power);
@@ -1028,6 +1172,88 @@ namespace fc::api {
       decode(v.can_store, Get(j, "CanStore"));
     }
 
+    ENCODE(SectorId) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Miner", v.miner);
+      Set(j, "Number", v.sector);
+      return j;
+    }
+
+    DECODE(SectorId) {
+      decode(v.miner, Get(j, "Miner"));
+      decode(v.sector, Get(j, "Number"));
+    }
+
+    ENCODE(SectorFileType) {
+      return encode(static_cast<int64_t>(v));
+    }
+
+    DECODE(SectorFileType) {
+      v = static_cast<SectorFileType>(decode<int64_t>(j));
+    }
+
+    ENCODE(PieceInfo) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Size", static_cast<uint64_t>(v.size));
+      Set(j, "PieceCID", v.cid);
+      return j;
+    }
+
+    DECODE(PieceInfo) {
+      v.size = PaddedPieceSize{decode<uint64_t>(Get(j, "Size"))};
+      decode(v.cid, Get(j, "PieceCID"));
+    }
+
+    ENCODE(SealedAndUnsealedCID) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Sealed", v.sealed_cid);
+      Set(j, "Unsealed", v.unsealed_cid);
+      return j;
+    }
+
+    DECODE(SealedAndUnsealedCID) {
+      decode(v.sealed_cid, Get(j, "Sealed"));
+      decode(v.unsealed_cid, Get(j, "Unsealed"));
+    }
+
+    ENCODE(TaskType) {
+      return encode(static_cast<int64_t>(v));
+    }
+
+    DECODE(TaskType) {
+      v = static_cast<TaskType>(decode<int64_t>(j));
+    }
+
+    ENCODE(WorkerResources) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "MemPhysical", v.physical_memory);
+      Set(j, "MemSwap", v.swap_memory);
+      Set(j, "MemReserved", v.reserved_memory);
+      Set(j, "CPUs", v.cpus);
+      Set(j, "GPUs", v.gpus);
+      return j;
+    }
+
+    DECODE(WorkerResources) {
+      decode(v.physical_memory, Get(j, "MemPhysical"));
+      decode(v.swap_memory, Get(j, "MemSwap"));
+      decode(v.reserved_memory, Get(j, "MemReserved"));
+      decode(v.cpus, Get(j, "CPUs"));
+      decode(v.gpus, Get(j, "GPUs"));
+    }
+
+    ENCODE(WorkerInfo) {
+      Value j{rapidjson::kObjectType};
+      Set(j, "Hostname", v.hostname);
+      Set(j, "Resources", v.resources);
+      return j;
+    }
+
+    DECODE(WorkerInfo) {
+      decode(v.hostname, Get(j, "Hostname"));
+      decode(v.resources, Get(j, "Resources"));
+    }
+
     template <typename T>
     ENCODE(boost::optional<T>) {
       if (v) {
@@ -1036,6 +1262,16 @@ namespace fc::api {
       return {};
     }
 
+    template <typename T>
+    ENCODE(Shared<T>) {
+      return encode(*v.value);
+    }
+
+    template <typename T>
+    DECODE(Shared<T>) {
+      v.value = std::make_shared<const T>(decode<T>(j));
+    }
+
     template <typename T>
     DECODE(boost::optional<T>) {
       if (!j.IsNull()) {
@@ -1130,6 +1366,51 @@ namespace fc::api {
     return document;
   }
 
+  /// Writes request, params are written without copying
+  template <typename Writer>
+  void write(Writer &writer, const Request &v) {
+    writer.StartObject();
+    writer.Key("jsonrpc");
+    writer.String("2.0");
+    writer.Key("id");
+    writer.Uint64(v.id);
+    writer.Key("method");
+    writer.String(v.method.data(),
+                  static_cast<rapidjson::SizeType>(v.method.size()));
+    writer.Key("params");
+    v.params.Accept(writer);
+    writer.EndObject();
+  }
+
+  /// Writes response, result is written without copying
+  template <typename Writer>
+  void write(Writer &writer, const Response &v) {
+    writer.StartObject();
+    writer.Key("jsonrpc");
+    writer.String("2.0");
+    writer.Key("id");
+    if (v.id) {
+      writer.Uint64(*v.id);
+    } else {
+      writer.Null();
+    }
+    visit_in_place(
+        v.result,
+        [&](const Response::Error &error) {
+          writer.Key("error");
+          encode(error).Accept(writer);
+        },
+        [&](const Document &result) {
+          writer.Key("result");
+          result.Accept(writer);
+        },
+        [&](const EncodedJson &result) {
+          writer.Key("result");
+          writer.RawValue(result->data(), result->size(), rapidjson::kNullType);
+        });
+    writer.EndObject();
+  }
+
   template <typename T>
   outcome::result<T> decode(const Value &j) {
     try {
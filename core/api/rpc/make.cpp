@@ -4,18 +4,130 @@
  */
 
 #include "api/rpc/make.hpp"
+
+#include <mutex>
+
+#include <rapidjson/writer.h>
+
+#include "api/rpc/cbor.hpp"
 #include "api/rpc/json.hpp"
 
 namespace fc::api {
+  template <typename T, typename = void>
+  struct is_comparable : std::false_type {};
+
+  template <typename T>
+  struct is_comparable<T,
+                       std::void_t<decltype(std::declval<const T &>()
+                                            == std::declval<const T &>())>>
+      : std::true_type {};
+
+  /**
+   * Encodes channel values of method. Subscribers of one method receive
+   * equal values one after another, so last value json is reused instead of
+   * encoding it for each subscriber.
+   */
+  template <typename T>
+  struct ChanEncoder {
+    std::shared_ptr<const std::string> encode(const T &value) {
+      if constexpr (is_comparable<T>{}) {
+        std::lock_guard lock{mutex};
+        if (!last || !(*last == value)) {
+          last = value;
+          json = toJson(value);
+        }
+        return json;
+      } else {
+        return toJson(value);
+      }
+    }
+
+    static std::shared_ptr<const std::string> toJson(const T &value) {
+      rapidjson::StringBuffer buffer;
+      rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+      api::encode(value).Accept(writer);
+      return std::make_shared<const std::string>(buffer.GetString(),
+                                                 buffer.GetSize());
+    }
+
+    std::mutex mutex;
+    boost::optional<T> last;
+    std::shared_ptr<const std::string> json;
+  };
+
+  /// Encodes result of cbor method call
+  template <typename T>
+  boost::variant<Response::Error, Buffer> cborResult(
+      const outcome::result<T> &result) {
+    if (!result) {
+      return Response::Error{kInternalError, result.error().message()};
+    }
+    if constexpr (std::is_same_v<T, void>) {
+      return Buffer{};
+    } else {
+      auto encoded{codec::cbor::encode(result.value())};
+      if (!encoded) {
+        return Response::Error{kInternalError, encoded.error().message()};
+      }
+      return std::move(encoded.value());
+    }
+  }
+
+  template <typename T>
+  struct WaitType {
+    using Type = T;
+  };
+
+  template <typename T>
+  struct WaitType<Wait<T>> {
+    using Type = T;
+  };
+
+  /// Sets up method for cbor transport if its types have cbor codecs
+  template <typename M>
+  void setupCbor(Rpc &rpc, const M &method) {
+    using Result = typename M::Result;
+    using Params = typename M::Params;
+    if constexpr (!is_chan<Result>{} && rpc::is_cbor<Params>{}
+                  && rpc::is_cbor<typename WaitType<Result>::Type>{}) {
+      rpc.setupCbor(M::name, [&](auto cbor_params, rpc::CborRespond respond) {
+        Params params;
+        auto decoded{rpc::decodeParams(cbor_params, params)};
+        if (!decoded) {
+          return respond(
+              Response::Error{kInvalidParams, decoded.error().message()});
+        }
+        auto maybe_result = std::apply(method, params);
+        if constexpr (is_wait<Result>{}) {
+          if (!maybe_result) {
+            return respond(Response::Error{kInternalError,
+                                           maybe_result.error().message()});
+          }
+          maybe_result.value().wait(
+              [respond{std::move(respond)}](auto maybe_result) {
+                respond(cborResult(maybe_result));
+              });
+        } else {
+          respond(cborResult(maybe_result));
+        }
+      });
+    }
+  }
+
   template <typename M>
   void setup(Rpc &rpc, const M &method) {
     using Result = typename M::Result;
+    // shared by sessions, rpc table is set up once per server
+    std::shared_ptr<void> encoder;
+    if constexpr (is_chan<Result>{}) {
+      encoder = std::make_shared<ChanEncoder<typename Result::Type>>();
+    }
     rpc.setup(
         M::name,
-        [&](auto &jparams,
-            rpc::Respond respond,
-            rpc::MakeChan make_chan,
-            rpc::Send send) {
+        [&, encoder](auto &jparams,
+                     rpc::Respond respond,
+                     rpc::MakeChan make_chan,
+                     rpc::Send send) {
           auto maybe_params = decode<typename M::Params>(jparams);
           if (!maybe_params) {
             return respond(Response::Error{kInvalidParams,
@@ -41,22 +153,33 @@ namespace fc::api {
                 }
               });
               return;
+            } else if constexpr (is_shared<Result>{}) {
+              auto &encoded{*result.encoded};
+              std::call_once(encoded.once, [&] {
+                encoded.json =
+                    ChanEncoder<typename Result::Type>::toJson(*result.value);
+              });
+              respond(encoded.json);
             } else {
               respond(api::encode(result));
             }
             if constexpr (is_chan<Result>{}) {
+              auto values{std::static_pointer_cast<
+                  ChanEncoder<typename Result::Type>>(encoder)};
               result.channel->read([send{std::move(send)},
-                                    chan{result}](auto opt) {
+                                    chan{result},
+                                    values](auto opt) {
                 if (opt) {
+                  // lagging subscriber is closed by session write limit
                   send("xrpc.ch.val",
-                       encode(std::make_tuple(chan.id, std::move(*opt))),
+                       {chan.id, values->encode(*opt)},
                        [chan](auto ok) {
                          if (!ok) {
                            chan.channel->closeRead();
                          }
                        });
                 } else {
-                  send("xrpc.ch.close", encode(std::make_tuple(chan.id)), {});
+                  send("xrpc.ch.close", {chan.id, nullptr}, {});
                 }
                 return true;
               });
@@ -65,6 +188,7 @@ namespace fc::api {
           }
           respond(Document{});
         });
+    setupCbor(rpc, method);
   }
 
   void setupRpc(Rpc &rpc, const Api &api) {
@@ -91,10 +215,14 @@ namespace fc::api {
     setup(rpc, api.ClientQueryAsk);
     setup(rpc, api.ClientRetrieve);
     setup(rpc, api.ClientStartDeal);
+    setup(rpc, api.LogList);
+    setup(rpc, api.LogSetLevel);
     setup(rpc, api.MarketEnsureAvailable);
     setup(rpc, api.MinerCreateBlock);
     setup(rpc, api.MinerGetBaseInfo);
+    setup(rpc, api.MpoolGetNonce);
     setup(rpc, api.MpoolPending);
+    setup(rpc, api.MpoolPush);
     setup(rpc, api.MpoolPushMessage);
     setup(rpc, api.MpoolSub);
     setup(rpc, api.NetAddrsListen);
@@ -107,6 +235,11 @@ namespace fc::api {
     setup(rpc, api.StateGetReceipt);
     setup(rpc, api.StateListMiners);
     setup(rpc, api.StateListActors);
+    setup(rpc, api.StateListMinersPage);
+    setup(rpc, api.StateListActorsPage);
+    setup(rpc, api.StateAnalyze);
+    setup(rpc, api.StateAnalyzeDiff);
+    setup(rpc, api.StateChangedActors);
     setup(rpc, api.StateMarketBalance);
     setup(rpc, api.StateMarketDeals);
     setup(rpc, api.StateLookupID);
@@ -116,6 +249,7 @@ namespace fc::api {
     setup(rpc, api.StateMinerPower);
     setup(rpc, api.StateMinerProvingSet);
     setup(rpc, api.StateMinerSectors);
+    setup(rpc, api.StateMinerSectorsPage);
     setup(rpc, api.StateMinerSectorSize);
     setup(rpc, api.StateMinerWorker);
     setup(rpc, api.StateNetworkName);
@@ -127,4 +261,15 @@ namespace fc::api {
     setup(rpc, api.WalletHas);
     setup(rpc, api.WalletSign);
   }
+
+  void setupRpc(Rpc &rpc, const WorkerApi &api) {
+    setup(rpc, api.Info);
+    setup(rpc, api.TaskTypes);
+    setup(rpc, api.SealPreCommit1);
+    setup(rpc, api.SealPreCommit2);
+    setup(rpc, api.SealCommit1);
+    setup(rpc, api.SealCommit2);
+    setup(rpc, api.FinalizeSector);
+    setup(rpc, api.MoveStorage);
+  }
 }  // namespace fc::api
@@ -8,11 +8,14 @@
 
 #include "api/api.hpp"
 #include "api/rpc/rpc.hpp"
+#include "api/worker_api.hpp"
 
 namespace fc::api {
   using rpc::Rpc;
 
   void setupRpc(Rpc &rpc, const Api &api);
+
+  void setupRpc(Rpc &rpc, const WorkerApi &api);
 }  // namespace fc::api
 
 #endif  // CPP_FILECOIN_CORE_API_RPC_MAKE_HPP
@@ -6,15 +6,22 @@
 #ifndef CPP_FILECOIN_CORE_API_RPC_RPC_HPP
 #define CPP_FILECOIN_CORE_API_RPC_RPC_HPP
 
+#include <algorithm>
 #include <map>
+#include <string_view>
+#include <vector>
 
 #include <rapidjson/document.h>
 
+#include "common/buffer.hpp"
 #include "common/outcome.hpp"
 
 namespace fc::api {
   using rapidjson::Document;
 
+  /// Result json encoded in advance, written without copying
+  using EncodedJson = std::shared_ptr<const std::string>;
+
   struct Request {
     uint64_t id;
     std::string method;
@@ -28,7 +35,7 @@ namespace fc::api {
     };
 
     boost::optional<uint64_t> id;
-    boost::variant<Error, Document> result;
+    boost::variant<Error, Document, EncodedJson> result;
   };
 
   constexpr auto kInvalidParams = INT64_C(-32602);
@@ -39,18 +46,78 @@ namespace fc::api::rpc {
   using rapidjson::Value;
 
   using OkCb = std::function<void(bool)>;
-  using Respond =
-      std::function<void(boost::variant<Response::Error, Document>)>;
-  using Send = std::function<void(std::string, Document, OkCb)>;
+  using Respond = std::function<void(
+      boost::variant<Response::Error, Document, EncodedJson>)>;
+  /// Params of channel message, value json is encoded once and shared by
+  /// subscribers, none for close
+  struct ChanParams {
+    uint64_t chan;
+    std::shared_ptr<const std::string> value;
+  };
+  using Send = std::function<void(std::string, ChanParams, OkCb)>;
   using MakeChan = std::function<uint64_t()>;
 
   using Method = std::function<void(const Value &, Respond, MakeChan, Send)>;
 
+  /// Result of method called over cbor transport, encoded result or error
+  using CborRespond =
+      std::function<void(boost::variant<Response::Error, common::Buffer>)>;
+  using CborMethod =
+      std::function<void(gsl::span<const uint8_t>, CborRespond)>;
+
+  /// Method table, built once and shared by sessions
   struct Rpc {
-    std::map<std::string, Method> ms;
+    /// Methods sorted by name after freeze
+    std::vector<std::pair<std::string, Method>> ms;
+    /// Methods with cbor codecs of params and result, except channels
+    std::vector<std::pair<std::string, CborMethod>> cbor_ms;
 
     inline void setup(const std::string &name, Method &&method) {
-      ms.emplace(name, std::move(method));
+      ms.emplace_back(name, std::move(method));
+    }
+
+    inline void setupCbor(const std::string &name, CborMethod &&method) {
+      cbor_ms.emplace_back(name, std::move(method));
+    }
+
+    /// Sorts methods for lookup, first method setup with name is kept
+    inline void freeze() {
+      sort(ms);
+      sort(cbor_ms);
+    }
+
+    /// Finds method of frozen table by binary search
+    inline const Method *find(std::string_view name) const {
+      return find(ms, name);
+    }
+
+    inline const CborMethod *findCbor(std::string_view name) const {
+      return find(cbor_ms, name);
+    }
+
+   private:
+    template <typename M>
+    static void sort(std::vector<std::pair<std::string, M>> &ms) {
+      std::stable_sort(ms.begin(), ms.end(), [](auto &l, auto &r) {
+        return l.first < r.first;
+      });
+      ms.erase(std::unique(ms.begin(),
+                           ms.end(),
+                           [](auto &l, auto &r) { return l.first == r.first; }),
+               ms.end());
+    }
+
+    template <typename M>
+    static const M *find(const std::vector<std::pair<std::string, M>> &ms,
+                         std::string_view name) {
+      auto it{std::lower_bound(
+          ms.begin(), ms.end(), name, [](auto &method, auto name) {
+            return method.first < name;
+          })};
+      if (it == ms.end() || it->first != name || !it->second) {
+        return nullptr;
+      }
+      return &it->second;
     }
   };
 }  // namespace fc::api::rpc
@@ -5,16 +5,27 @@
 
 #include "api/rpc/ws.hpp"
 
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <queue>
+#include <thread>
 
 #include <rapidjson/writer.h>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
 #include <boost/beast/websocket.hpp>
 
+#include "api/rpc/cbor.hpp"
 #include "api/rpc/json.hpp"
 #include "api/rpc/make.hpp"
+#include "common/memory_domain.hpp"
+#include "common/metrics.hpp"
+#include "common/tracing.hpp"
 
 namespace fc::api {
   namespace beast = boost::beast;
@@ -23,6 +34,8 @@ namespace fc::api {
   namespace net = boost::asio;
   using tcp = boost::asio::ip::tcp;
   using rapidjson::StringBuffer;
+  using common::Buffer;
+  using common::LatencyHistogram;
   using rpc::OkCb;
 
   constexpr auto kParseError = INT64_C(-32700);
@@ -31,14 +44,299 @@ namespace fc::api {
 
   const auto kChanCloseDelay{boost::posix_time::milliseconds(100)};
 
-  struct ServerSession : std::enable_shared_from_this<ServerSession> {
-    ServerSession(tcp::socket &&socket, const Api &api)
-        : socket{std::move(socket)}, timer{this->socket.get_executor()} {
-      setupRpc(rpc, api);
+  /// Bytes queued for websocket session, channel values over it are dropped
+  /// and their channels closed, so lagging subscriber does not grow queue
+  constexpr size_t kMaxPendingBytes{32 << 20};
+
+  /// Http get of metrics in prometheus format, on same port as rpc
+  constexpr auto kMetricsTarget{"/metrics"};
+  constexpr auto kMetricsContentType{"text/plain; version=0.0.4"};
+
+  /// Http get of recorded tracing spans, in chrome trace and otlp json
+  constexpr auto kTraceTarget{"/debug/trace"};
+  constexpr auto kOtlpTraceTarget{"/debug/trace/otlp"};
+  /// Http get of heap profile by memory domains
+  constexpr auto kHeapTarget{"/debug/heap"};
+
+  /// Runs method calls on worker threads, limiting calls of each method
+  struct Executor {
+    using Call = std::function<void()>;
+
+    /// Last owner may be call on worker, pool is joined from other thread
+    static std::shared_ptr<Executor> make(RpcServerConfig config) {
+      return {new Executor{std::move(config)}, [](Executor *executor) {
+                if (executor->pool.get_executor().running_in_this_thread()) {
+                  std::thread{[executor] { delete executor; }}.detach();
+                } else {
+                  delete executor;
+                }
+              }};
     }
 
-    void run() {
-      socket.async_accept([self{shared_from_this()}](auto ec) {
+    explicit Executor(RpcServerConfig config)
+        : config{std::move(config)},
+          pool{std::max<size_t>(this->config.threads, 1)} {}
+
+    /// Runs call now or after running calls of method finish
+    void run(const std::string &method, Call call) {
+      if (common::tracing::enabled()) {
+        // continues request span on worker, gap between them is queue wait
+        call = [method,
+                parent{common::tracing::Span::current()},
+                call{std::move(call)}] {
+          common::tracing::Span span{"rpc.call", method, parent};
+          call();
+        };
+      }
+      std::unique_lock lock{mutex};
+      auto &slot{slots[method]};
+      if (!slot.latency) {
+        slot.latency = &common::metrics::registry().histogram(
+            "fc_rpc_call_seconds",
+            "Time of rpc method call on worker",
+            {{"method", method}});
+      }
+      if (slot.running >= limit(method)) {
+        slot.waiting.push(std::move(call));
+        return;
+      }
+      ++slot.running;
+      auto &latency{*slot.latency};
+      lock.unlock();
+      post(method, latency, std::move(call));
+    }
+
+    size_t limit(const std::string &method) const {
+      auto it{config.method_limits.find(method)};
+      return std::max<size_t>(
+          it == config.method_limits.end() ? config.method_calls : it->second,
+          1);
+    }
+
+    /// Runs call on worker and starts next waiting call of method
+    void post(const std::string &method,
+              LatencyHistogram &latency,
+              Call call) {
+      net::post(pool, [this, method, &latency, call{std::move(call)}] {
+        {
+          common::metrics::Timer timer{latency};
+          call();
+        }
+        Call next;
+        {
+          std::lock_guard lock{mutex};
+          auto &slot{slots[method]};
+          if (slot.waiting.empty()) {
+            --slot.running;
+            return;
+          }
+          next = std::move(slot.waiting.front());
+          slot.waiting.pop();
+        }
+        post(method, latency, std::move(next));
+      });
+    }
+
+    struct Slot {
+      size_t running{};
+      std::queue<Call> waiting;
+      /// Call time metric of method, registered on first call
+      LatencyHistogram *latency{};
+    };
+
+    RpcServerConfig config;
+    std::mutex mutex;
+    std::map<std::string, Slot> slots;
+    net::thread_pool pool;
+  };
+
+  template <typename T>
+  StringBuffer serialize(const T &v) {
+    StringBuffer buffer;
+    rapidjson::Writer<StringBuffer> writer{buffer};
+    write(writer, v);
+    return buffer;
+  }
+
+  /// Batch responses are written as one array
+  StringBuffer serialize(const std::vector<Response> &responses) {
+    StringBuffer buffer;
+    rapidjson::Writer<StringBuffer> writer{buffer};
+    writer.StartArray();
+    for (auto &response : responses) {
+      write(writer, response);
+    }
+    writer.EndArray();
+    return buffer;
+  }
+
+  /// Cbor responses are encoded by codecs which do not fail
+  Buffer serialize(const rpc::CborResponse &response) {
+    return codec::cbor::encode(response).value();
+  }
+
+  /// Calls methods of received messages, common to websocket and http
+  struct Session : std::enable_shared_from_this<Session> {
+    using Io = tcp::socket::executor_type;
+    /// Called on io context when call is finished
+    using Done = std::function<void(Response)>;
+    /// Called on io context with encoded cbor response
+    using CborDone = std::function<void(Buffer)>;
+
+    Session(Io io,
+            std::shared_ptr<const Rpc> rpc,
+            std::shared_ptr<Executor> executor)
+        : io{std::move(io)},
+          rpc{std::move(rpc)},
+          executor{std::move(executor)} {}
+
+    virtual ~Session() = default;
+
+    /// Writes reply to received message, called on io context
+    virtual void reply(StringBuffer buffer) = 0;
+
+    /// Sends channel request to client, called on io context
+    virtual void send(const std::string &method,
+                      rpc::ChanParams params,
+                      OkCb cb) = 0;
+
+    /// Handles received message, single request or batch array
+    void onMessage(std::string_view s_req) {
+      Document j_req;
+      j_req.Parse(s_req.data(), s_req.size());
+      if (j_req.HasParseError()) {
+        return reply(serialize(
+            Response{{}, Response::Error{kParseError, "Parse error"}}));
+      }
+      if (!j_req.IsArray()) {
+        return call(j_req, [self{shared_from_this()}](Response response) {
+          self->reply(serialize(response));
+        });
+      }
+      if (j_req.Empty()) {
+        return reply(serialize(Response{
+            {}, Response::Error{kInvalidRequest, "Invalid request"}}));
+      }
+      // batch calls run concurrently, reply is written when last finishes
+      struct Batch {
+        std::vector<Response> responses;
+        size_t left;
+      };
+      auto batch{std::make_shared<Batch>()};
+      batch->responses.resize(j_req.Size());
+      batch->left = j_req.Size();
+      for (size_t i = 0; i < j_req.Size(); ++i) {
+        call(j_req[i],
+             [self{shared_from_this()}, batch, i](Response response) {
+               batch->responses[i] = std::move(response);
+               if (--batch->left == 0) {
+                 self->reply(serialize(batch->responses));
+               }
+             });
+      }
+    }
+
+    /// Calls method of request on executor
+    void call(const Value &j_req, Done done) {
+      auto maybe_req = decode<Request>(j_req);
+      if (!maybe_req) {
+        return done(
+            Response{{}, Response::Error{kInvalidRequest, "Invalid request"}});
+      }
+      auto req{std::make_shared<Request>(std::move(maybe_req.value()))};
+      common::tracing::Span span{"rpc.request", req->method};
+      // callbacks may be called on worker threads, results are posted back
+      auto respond = [id{req->id}, self{shared_from_this()}, done](auto res) {
+        net::post(self->io, [done, id, res{std::move(res)}]() mutable {
+          done(Response{id, std::move(res)});
+        });
+      };
+      auto method = rpc->find(req->method);
+      if (!method) {
+        return respond(Response::Error{kMethodNotFound, "Method not found"});
+      }
+      executor->run(
+          req->method,
+          [self{shared_from_this()}, req, method, respond] {
+            (*method)(
+                req->params,
+                respond,
+                [self]() { return self->next_channel++; },
+                [self](auto method, rpc::ChanParams params, auto cb) {
+                  net::post(self->io,
+                            [self,
+                             method{std::move(method)},
+                             params{std::move(params)},
+                             cb{std::move(cb)}]() mutable {
+                              self->send(
+                                  method, std::move(params), std::move(cb));
+                            });
+                });
+          });
+    }
+
+    /// Calls method of cbor request on executor
+    void callCbor(gsl::span<const uint8_t> input, CborDone done) {
+      auto maybe_req{codec::cbor::decode<rpc::CborRequest>(input)};
+      if (!maybe_req) {
+        return done(serialize(rpc::CborResponse{
+            {}, Response::Error{kParseError, "Parse error"}, {}}));
+      }
+      auto req{
+          std::make_shared<rpc::CborRequest>(std::move(maybe_req.value()))};
+      common::tracing::Span span{"rpc.request", req->method};
+      rpc::CborRespond respond = [id{req->id},
+                                  self{shared_from_this()},
+                                  done](auto res) {
+        net::post(self->io, [done, id, res{std::move(res)}]() mutable {
+          rpc::CborResponse response{id, {}, {}};
+          if (auto error{boost::get<Response::Error>(&res)}) {
+            response.error = std::move(*error);
+          } else {
+            response.result = std::move(boost::get<Buffer>(res));
+          }
+          done(serialize(response));
+        });
+      };
+      auto method{rpc->findCbor(req->method)};
+      if (!method) {
+        return respond(Response::Error{kMethodNotFound, "Method not found"});
+      }
+      executor->run(req->method, [req, method, respond] {
+        (*method)(req->params, respond);
+      });
+    }
+
+    Io io;
+    std::atomic<uint64_t> next_channel{};
+    std::shared_ptr<const Rpc> rpc;
+    std::shared_ptr<Executor> executor;
+  };
+
+  struct ServerSession : Session {
+    ServerSession(tcp::socket &&socket,
+                  std::shared_ptr<const Rpc> rpc,
+                  std::shared_ptr<Executor> executor,
+                  bool cbor)
+        : Session{socket.get_executor(), std::move(rpc), std::move(executor)},
+          cbor{cbor},
+          socket{std::move(socket)},
+          timer{this->socket.get_executor()} {}
+
+    auto self() {
+      return std::static_pointer_cast<ServerSession>(shared_from_this());
+    }
+
+    /// Accepts websocket upgrade request read by http session
+    void run(const http::request<http::string_body> &request) {
+      if (cbor) {
+        socket.set_option(websocket::stream_base::decorator(
+            [](websocket::response_type &response) {
+              response.set(http::field::sec_websocket_protocol,
+                           rpc::kCborProtocol);
+            }));
+      }
+      socket.async_accept(request, [self{self()}](auto ec) {
         if (ec) {
           return;
         }
@@ -47,100 +345,242 @@ namespace fc::api {
     }
 
     void doRead() {
-      socket.async_read(buffer, [self{shared_from_this()}](auto ec, auto) {
+      socket.async_read(buffer, [self{self()}](auto ec, auto) {
         if (ec) {
           return;
         }
-        self->onRead();
+        auto data{self->buffer.cdata()};
+        if (self->cbor && !self->socket.got_text()) {
+          self->callCbor(
+              {static_cast<const uint8_t *>(data.data()), data.size()},
+              [self](Buffer response) {
+                self->_write({{}, nullptr, {}, {}, std::move(response)});
+              });
+        } else {
+          self->onMessage(
+              {static_cast<const char *>(data.data()), data.size()});
+        }
+        self->buffer.clear();
         self->doRead();
       });
     }
 
-    void onRead() {
-      std::string_view s_req{static_cast<const char *>(buffer.cdata().data()),
-                             buffer.cdata().size()};
-      rapidjson::Document j_req;
-      j_req.Parse(s_req.data(), s_req.size());
-      buffer.clear();
-      if (j_req.HasParseError()) {
-        return _write(Response{{}, Response::Error{kParseError, "Parse error"}},
-                      {});
+    /// Message written as head, shared value and tail
+    struct PendingWrite {
+      StringBuffer head;
+      std::shared_ptr<const std::string> value;
+      OkCb cb;
+
+      /// Closes params array and request of channel message
+      std::string_view tail;
+      /// Cbor response, written as binary message
+      Buffer binary;
+
+      size_t size() const {
+        return head.GetSize() + (value ? value->size() : 0) + tail.size()
+               + binary.size();
       }
-      auto maybe_req = decode<Request>(j_req);
-      if (!maybe_req) {
-        return _write(
-            Response{{}, Response::Error{kInvalidRequest, "Invalid request"}},
-            {});
+    };
+
+    void reply(StringBuffer buffer) override {
+      _write({std::move(buffer), nullptr, {}, {}});
+    }
+
+    void send(const std::string &method,
+              rpc::ChanParams params,
+              OkCb cb) override {
+      if (params.value && pending_bytes > kMaxPendingBytes) {
+        if (cb) {
+          cb(false);
+        }
+        return;
       }
-      auto &req = maybe_req.value();
-      auto respond = [id{req.id}, self{shared_from_this()}](auto res) {
-        self->_write(Response{id, std::move(res)}, {});
-      };
-      auto it = rpc.ms.find(req.method);
-      if (it == rpc.ms.end() || !it->second) {
-        return respond(Response::Error{kMethodNotFound, "Method not found"});
+      // request is written around shared value json, which is not copied
+      StringBuffer head;
+      rapidjson::Writer<StringBuffer> writer{head};
+      writer.StartObject();
+      writer.Key("jsonrpc");
+      writer.String("2.0");
+      writer.Key("id");
+      writer.Uint64(next_request++);
+      writer.Key("method");
+      writer.String(method.data(), method.size());
+      writer.Key("params");
+      writer.StartArray();
+      writer.Uint64(params.chan);
+      if (params.value) {
+        head.Put(',');
       }
-      it->second(
-          req.params,
-          std::move(respond),
-          [&]() { return next_channel++; },
-          [self{shared_from_this()}](auto method, auto params, auto cb) {
-            Request req{self->next_request++, method, std::move(params)};
-            if (method == "xrpc.ch.close") {
-              self->timer.expires_from_now(kChanCloseDelay);
-              self->timer.async_wait(
-                  [self, req{std::move(req)}, cb{std::move(cb)}](auto) {
-                    self->_write(req, std::move(cb));
-                  });
-              return;
-            }
-            self->_write(req, std::move(cb));
-          });
+      PendingWrite pending{
+          std::move(head), std::move(params.value), cb, "]}"};
+      if (method == "xrpc.ch.close") {
+        timer.expires_from_now(kChanCloseDelay);
+        timer.async_wait([self{self()},
+                          pending{std::make_shared<PendingWrite>(
+                              std::move(pending))}](auto) {
+          self->_write(std::move(*pending));
+        });
+        return;
+      }
+      _write(std::move(pending));
     }
 
-    template <typename T>
-    void _write(const T &v, OkCb cb) {
-      StringBuffer buffer;
-      rapidjson::Writer<StringBuffer> writer{buffer};
-      encode(v).Accept(writer);
-      pending_writes.emplace(std::move(buffer), std::move(cb));
+    void _write(PendingWrite pending) {
+      pending_bytes += pending.size();
+      pending_writes.push(std::move(pending));
       _flush();
     }
 
     void _flush() {
       if (!writing && !pending_writes.empty()) {
-        auto &[buffer, cb] = pending_writes.front();
+        auto &pending = pending_writes.front();
         writing = true;
-        socket.async_write(
-            net::buffer(buffer.GetString(), buffer.GetSize()),
-            [self{shared_from_this()}, cb{std::move(cb)}](auto e, auto) {
-              self->writing = false;
-              auto ok = !e;
-              if (!ok) {
-                self->pending_writes = {};
-              } else {
-                self->pending_writes.pop();
-                self->_flush();
-              }
-              if (cb) {
-                cb(ok);
-              }
-            });
-      }
-    }
-
-    std::queue<std::pair<StringBuffer, OkCb>> pending_writes;
+        auto &tail = pending.tail;
+        std::array<net::const_buffer, 4> buffers{
+            net::buffer(pending.head.GetString(), pending.head.GetSize()),
+            pending.value ? net::buffer(*pending.value) : net::const_buffer{},
+            net::buffer(tail.data(), tail.size()),
+            net::buffer(pending.binary.data(), pending.binary.size())};
+        socket.binary(!pending.binary.empty());
+        socket.async_write(buffers, [self{self()}](auto e, auto) {
+          self->writing = false;
+          auto ok = !e;
+          auto cb = std::move(self->pending_writes.front().cb);
+          if (!ok) {
+            self->pending_writes = {};
+            self->pending_bytes = 0;
+          } else {
+            self->pending_bytes -= self->pending_writes.front().size();
+            self->pending_writes.pop();
+            self->_flush();
+          }
+          if (cb) {
+            cb(ok);
+          }
+        });
+      }
+    }
+
+    /// Client negotiated binary cbor transport
+    bool cbor;
+    std::queue<PendingWrite> pending_writes;
+    size_t pending_bytes{};
     bool writing{false};
-    uint64_t next_channel{}, next_request{};
+    uint64_t next_request{};
     websocket::stream<tcp::socket> socket;
     net::deadline_timer timer;
     beast::flat_buffer buffer;
-    Rpc rpc;
+  };
+
+  /// Serves json rpc over http post with keep-alive, upgrades to websocket
+  struct HttpSession : Session {
+    HttpSession(tcp::socket &&socket,
+                std::shared_ptr<const Rpc> rpc,
+                std::shared_ptr<Executor> executor)
+        : Session{socket.get_executor(), std::move(rpc), std::move(executor)},
+          socket{std::move(socket)} {}
+
+    auto self() {
+      return std::static_pointer_cast<HttpSession>(shared_from_this());
+    }
+
+    void doRead() {
+      request = {};
+      http::async_read(
+          socket, buffer, request, [self{self()}](auto ec, auto) {
+            if (ec) {
+              return;
+            }
+            if (websocket::is_upgrade(self->request)) {
+              auto protocols{
+                  self->request[http::field::sec_websocket_protocol]};
+              auto cbor{protocols.find(rpc::kCborProtocol)
+                        != boost::string_view::npos};
+              std::make_shared<ServerSession>(
+                  std::move(self->socket), self->rpc, self->executor, cbor)
+                  ->run(self->request);
+              return;
+            }
+            if (self->request.method() == http::verb::get
+                && self->request.target() == kMetricsTarget) {
+              return self->reply(http::status::ok,
+                                 common::metrics::registry().prometheus(),
+                                 kMetricsContentType);
+            }
+            if (self->request.method() == http::verb::get
+                && self->request.target() == kTraceTarget) {
+              return self->reply(
+                  http::status::ok,
+                  common::tracing::chromeTrace(common::tracing::collect()));
+            }
+            if (self->request.method() == http::verb::get
+                && self->request.target() == kOtlpTraceTarget) {
+              return self->reply(
+                  http::status::ok,
+                  common::tracing::otlpJson(common::tracing::collect()));
+            }
+            if (self->request.method() == http::verb::get
+                && self->request.target() == kHeapTarget) {
+              return self->reply(
+                  http::status::ok, common::heapProfile(), "text/plain");
+            }
+            if (self->request.method() != http::verb::post) {
+              return self->reply(http::status::method_not_allowed, {});
+            }
+            self->onMessage(self->request.body());
+          });
+    }
+
+    void reply(StringBuffer buffer) override {
+      reply(http::status::ok, {buffer.GetString(), buffer.GetSize()});
+    }
+
+    void reply(http::status status,
+               std::string body,
+               boost::string_view content_type = "application/json") {
+      auto response{std::make_shared<http::response<http::string_body>>(
+          status, request.version())};
+      response->set(http::field::content_type, content_type);
+      response->keep_alive(request.keep_alive());
+      response->body() = std::move(body);
+      response->prepare_payload();
+      http::async_write(
+          socket, *response, [self{self()}, response](auto ec, auto) {
+            if (ec) {
+              return;
+            }
+            if (response->keep_alive()) {
+              return self->doRead();
+            }
+            self->socket.shutdown(tcp::socket::shutdown_send, ec);
+          });
+    }
+
+    /// Channels are not supported over http
+    void send(const std::string &, rpc::ChanParams, OkCb cb) override {
+      if (cb) {
+        cb(false);
+      }
+    }
+
+    tcp::socket socket;
+    beast::flat_buffer buffer;
+    http::request<http::string_body> request;
   };
 
   struct Server : std::enable_shared_from_this<Server> {
-    Server(tcp::acceptor &&acceptor, Api api)
-        : acceptor{std::move(acceptor)}, api{api} {}
+    Server(tcp::acceptor &&acceptor,
+           RpcSetup setup,
+           const RpcServerConfig &config)
+        : acceptor{std::move(acceptor)},
+          setup{std::move(setup)},
+          executor{Executor::make(config)} {
+      // methods are set up once, sessions share immutable table
+      auto methods{std::make_shared<Rpc>()};
+      this->setup(*methods);
+      methods->freeze();
+      rpc = std::move(methods);
+    }
 
     void run() {
       doAccept();
@@ -151,21 +591,60 @@ namespace fc::api {
         if (ec) {
           return;
         }
-        std::make_shared<ServerSession>(std::move(socket), self->api)->run();
+        // first request decides between websocket and http post
+        std::make_shared<HttpSession>(
+            std::move(socket), self->rpc, self->executor)
+            ->doRead();
         self->doAccept();
       });
     }
 
     tcp::acceptor acceptor;
-    Api api;
+    /// Keeps objects referenced by methods alive
+    RpcSetup setup;
+    std::shared_ptr<const Rpc> rpc;
+    std::shared_ptr<Executor> executor;
   };
 
-  void serve(Api api,
+  void serve(RpcSetup setup,
              boost::asio::io_context &ioc,
              std::string_view ip,
-             unsigned short port) {
+             unsigned short port,
+             const RpcServerConfig &config) {
     std::make_shared<Server>(
-        tcp::acceptor{ioc, {net::ip::make_address(ip), port}}, std::move(api))
+        tcp::acceptor{ioc, {net::ip::make_address(ip), port}},
+        std::move(setup),
+        config)
         ->run();
   }
+
+  void serve(Api api,
+             boost::asio::io_context &ioc,
+             std::string_view ip,
+             unsigned short port,
+             const RpcServerConfig &config) {
+    serve(
+        [api{std::make_shared<Api>(std::move(api))}](auto &rpc) {
+          setupRpc(rpc, *api);
+        },
+        ioc,
+        ip,
+        port,
+        config);
+  }
+
+  void serve(WorkerApi api,
+             boost::asio::io_context &ioc,
+             std::string_view ip,
+             unsigned short port,
+             const RpcServerConfig &config) {
+    serve(
+        [api{std::make_shared<WorkerApi>(std::move(api))}](auto &rpc) {
+          setupRpc(rpc, *api);
+        },
+        ioc,
+        ip,
+        port,
+        config);
+  }
 }  // namespace fc::api
@@ -7,16 +7,57 @@
 #define CPP_FILECOIN_CORE_API_RPC_WS_HPP
 
 #include "api/api.hpp"
+#include "api/rpc/rpc.hpp"
+#include "api/worker_api.hpp"
 
 namespace boost::asio {
   class io_context;
 }  // namespace boost::asio
 
 namespace fc::api {
+  /// Sets up methods shared by sessions, called once per server
+  using RpcSetup = std::function<void(rpc::Rpc &)>;
+
+  /// Executor limits of rpc server
+  struct RpcServerConfig {
+    /// Worker threads running method calls
+    size_t threads{4};
+    /// Calls of one method running at once, others wait in order
+    size_t method_calls{4};
+    /// Limits of methods differing from method_calls
+    std::map<std::string, size_t> method_limits;
+  };
+
+  /**
+   * Serves websocket json rpc, methods are set up by setup. Requests are
+   * parsed on io context and called on worker threads, so slow call does not
+   * block other requests. Responses are written as calls finish, possibly out
+   * of request order. Batch arrays are called concurrently and answered with
+   * one array. Same port serves json rpc over http post with keep-alive,
+   * channels are available over websocket only, and metrics registry in
+   * prometheus format on http get of "/metrics". Spans recorded while
+   * tracing is enabled are served on "/debug/trace" in chrome trace format
+   * and on "/debug/trace/otlp" in otlp json. Heap profile by memory domains
+   * is served on "/debug/heap".
+   */
+  void serve(RpcSetup setup,
+             boost::asio::io_context &ioc,
+             std::string_view ip,
+             unsigned short port,
+             const RpcServerConfig &config = {});
+
+  /// Serves node api, its methods are called concurrently, see makeImpl
   void serve(Api api,
              boost::asio::io_context &ioc,
              std::string_view ip,
-             unsigned short port);
+             unsigned short port,
+             const RpcServerConfig &config = {});
+
+  void serve(WorkerApi api,
+             boost::asio::io_context &ioc,
+             std::string_view ip,
+             unsigned short port,
+             const RpcServerConfig &config = {});
 }  // namespace fc::api
 
 #endif  // CPP_FILECOIN_CORE_API_RPC_WS_HPP
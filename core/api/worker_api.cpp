@@ -0,0 +1,40 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "api/worker_api.hpp"
+
+namespace fc::api {
+  WorkerApi makeWorkerApi(std::shared_ptr<sector_storage::Worker> worker) {
+    WorkerApi api;
+    api.Info = {[=]() { return worker->getInfo(); }};
+    api.TaskTypes = {[=]() -> outcome::result<std::vector<TaskType>> {
+      OUTCOME_TRY(tasks, worker->getSupportedTask());
+      return std::vector<TaskType>{tasks.begin(), tasks.end()};
+    }};
+    api.SealPreCommit1 = {[=](auto &sector, auto &ticket, auto &pieces) {
+      return worker->sealPreCommit1(sector, ticket, pieces);
+    }};
+    api.SealPreCommit2 = {[=](auto &sector, auto &pc1o) {
+      return worker->sealPreCommit2(sector, pc1o);
+    }};
+    api.SealCommit1 = {[=](auto &sector,
+                           auto &ticket,
+                           auto &seed,
+                           auto &pieces,
+                           auto &cids) {
+      return worker->sealCommit1(sector, ticket, seed, pieces, cids);
+    }};
+    api.SealCommit2 = {[=](auto &sector, auto &c1o) {
+      return worker->sealCommit2(sector, c1o);
+    }};
+    api.FinalizeSector = {[=](auto &sector) {
+      return worker->finalizeSector(sector);
+    }};
+    api.MoveStorage = {[=](auto &sector, auto &types) {
+      return worker->moveStorage(sector, types);
+    }};
+    return api;
+  }
+}  // namespace fc::api
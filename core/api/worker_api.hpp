@@ -0,0 +1,61 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_API_WORKER_API_HPP
+#define CPP_FILECOIN_CORE_API_WORKER_API_HPP
+
+#include "api/api.hpp"
+#include "sector_storage/worker.hpp"
+
+namespace fc::api {
+  using primitives::piece::PieceInfo;
+  using primitives::sector::InteractiveRandomness;
+  using primitives::sector::Proof;
+  using primitives::sector::SealRandomness;
+  using primitives::sector::SectorId;
+  using primitives::sector_file::SectorFileType;
+  using proofs::Phase1Output;
+  using proofs::SealedAndUnsealedCID;
+  using sector_storage::TaskType;
+  using sector_storage::WorkerInfo;
+
+  /// Api of remote sealing worker, served by worker process
+  struct WorkerApi {
+    API_METHOD(Info, WorkerInfo)
+
+    API_METHOD(TaskTypes, std::vector<TaskType>)
+
+    API_METHOD(SealPreCommit1,
+               Phase1Output,
+               const SectorId &,
+               const SealRandomness &,
+               const std::vector<PieceInfo> &)
+
+    API_METHOD(SealPreCommit2,
+               SealedAndUnsealedCID,
+               const SectorId &,
+               const Phase1Output &)
+
+    API_METHOD(SealCommit1,
+               Phase1Output,
+               const SectorId &,
+               const SealRandomness &,
+               const InteractiveRandomness &,
+               const std::vector<PieceInfo> &,
+               const SealedAndUnsealedCID &)
+
+    API_METHOD(SealCommit2, Proof, const SectorId &, const Phase1Output &)
+
+    API_METHOD(FinalizeSector, void, const SectorId &)
+
+    /// Moves sector files to long term storage of worker
+    API_METHOD(MoveStorage, void, const SectorId &, const SectorFileType &)
+  };
+
+  /// Serves worker through api
+  WorkerApi makeWorkerApi(std::shared_ptr<sector_storage::Worker> worker);
+}  // namespace fc::api
+
+#endif  // CPP_FILECOIN_CORE_API_WORKER_API_HPP
@@ -30,6 +30,21 @@ namespace fc::blockchain::block_validator {
      */
     virtual outcome::result<void> validateBlock(const BlockHeader &header,
                                                 scenarios::Scenario scenario) const = 0;
+
+    /**
+     * @brief Validate blocks of one tipset
+     * @param headers - headers to validate
+     * @param scenario - required validation stages
+     * @return validation result, first error in blocks order
+     */
+    virtual outcome::result<void> validateBlocks(
+        const std::vector<BlockHeader> &headers,
+        scenarios::Scenario scenario) const {
+      for (const auto &header : headers) {
+        OUTCOME_TRY(validateBlock(header, scenario));
+      }
+      return outcome::success();
+    }
   };
 
 }  // namespace fc::blockchain::block_validator
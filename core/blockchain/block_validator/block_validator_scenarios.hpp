@@ -34,6 +34,12 @@ namespace fc::blockchain::block_validator::scenarios {
                                  Stage::MESSAGE_SIGNATURE_BV4,
                                  Stage::STATE_TREE_BV5};
 
+  /**
+   * Validation of historical headers without their parent states, e.g.
+   * headers below trusted checkpoint
+   */
+  const Scenario kHeaderValidation{Stage::SYNTAX_BV0};
+
 }  // namespace fc::blockchain::block_validator::scenarios
 
 #endif
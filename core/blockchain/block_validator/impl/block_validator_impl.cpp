@@ -5,14 +5,26 @@
 
 #include "blockchain/block_validator/impl/block_validator_impl.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+
+#include <boost/asio/post.hpp>
+
 #include "blockchain/block_validator/impl/consensus_rules.hpp"
 #include "blockchain/block_validator/impl/syntax_rules.hpp"
 #include "codec/cbor/cbor.hpp"
+#include "common/tracing.hpp"
+#include "primitives/cid/cid_of_cbor.hpp"
 #include "storage/amt/amt.hpp"
-#include "storage/ipld/ipld_block.hpp"
+#include "vm/actor/builtin/account/account_actor.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
 
 namespace fc::blockchain::block_validator {
+  using primitives::address::Address;
   using primitives::address::Protocol;
+  using primitives::block::MsgMeta;
+  using vm::actor::builtin::account::AccountActorState;
   using storage::amt::Amt;
   using SignedMessage = vm::message::SignedMessage;
   using UnsignedMessage = vm::message::UnsignedMessage;
@@ -20,7 +32,6 @@ namespace fc::blockchain::block_validator {
   using BlsCryptoPubKey = crypto::bls::PublicKey;
   using SecpCryptoSignature = crypto::secp256k1::Signature;
   using SecpCryptoPubKey = crypto::secp256k1::PublicKey;
-  using IPLDBlock = storage::ipld::IPLDBlock;
 
   const std::map<scenarios::Stage, BlockValidatorImpl::StageExecutor>
       BlockValidatorImpl::stage_executors_{
@@ -31,22 +42,227 @@ namespace fc::blockchain::block_validator {
           {Stage::MESSAGE_SIGNATURE_BV4, &BlockValidatorImpl::messageSign},
           {Stage::STATE_TREE_BV5, &BlockValidatorImpl::stateTree}};
 
+  const std::map<scenarios::Stage, std::vector<scenarios::Stage>>
+      BlockValidatorImpl::stage_dependencies_{
+          {Stage::CONSENSUS_BV1, {Stage::SYNTAX_BV0}},
+          {Stage::BLOCK_SIGNATURE_BV2, {Stage::SYNTAX_BV0}},
+          {Stage::ELECTION_POST_BV3, {Stage::SYNTAX_BV0}},
+          {Stage::MESSAGE_SIGNATURE_BV4, {Stage::SYNTAX_BV0}},
+          {Stage::STATE_TREE_BV5,
+           {Stage::CONSENSUS_BV1,
+            Stage::BLOCK_SIGNATURE_BV2,
+            Stage::ELECTION_POST_BV3,
+            Stage::MESSAGE_SIGNATURE_BV4}}};
+
+  namespace {
+    /// Waits until given number of tasks finish
+    class Latch {
+     public:
+      explicit Latch(size_t count) : count_{count} {}
+
+      void countDown() {
+        std::lock_guard lock{mutex_};
+        if (--count_ == 0) {
+          cv_.notify_all();
+        }
+      }
+
+      void wait() {
+        std::unique_lock lock{mutex_};
+        cv_.wait(lock, [this] { return count_ == 0; });
+      }
+
+     private:
+      std::mutex mutex_;
+      std::condition_variable cv_;
+      size_t count_;
+    };
+
+    /// Span name of stage
+    const char *stageSpan(scenarios::Stage stage) {
+      using scenarios::Stage;
+      switch (stage) {
+        case Stage::SYNTAX_BV0:
+          return "block_validator.syntax";
+        case Stage::CONSENSUS_BV1:
+          return "block_validator.consensus";
+        case Stage::BLOCK_SIGNATURE_BV2:
+          return "block_validator.block_signature";
+        case Stage::ELECTION_POST_BV3:
+          return "block_validator.election_post";
+        case Stage::MESSAGE_SIGNATURE_BV4:
+          return "block_validator.message_signature";
+        case Stage::STATE_TREE_BV5:
+          return "block_validator.state_tree";
+      }
+      return "block_validator.stage";
+    }
+
+    /// Error is decided by block alone, not by missing data or io failure
+    bool isVerdict(const std::error_code &error) {
+      return error.category() == make_error_code(ValidatorError{}).category()
+             || error.category() == make_error_code(SyntaxError{}).category();
+    }
+  }  // namespace
+
+  BlockValidatorImpl::BlockValidatorImpl(
+      std::shared_ptr<IpfsDatastore> ipfs_store,
+      std::shared_ptr<UTCClock> utc_clock,
+      std::shared_ptr<EpochClock> epoch_clock,
+      std::shared_ptr<WeightCalculator> weight_calculator,
+      std::shared_ptr<PowerTable> power_table,
+      std::shared_ptr<BlsProvider> bls_crypto_provider,
+      std::shared_ptr<SecpProvider> secp_crypto_provider,
+      std::shared_ptr<Interpreter> vm_interpreter,
+      std::shared_ptr<SecpMessageVerifier> secp_verifier,
+      std::shared_ptr<VerifiedHeaderCache> verified_cache,
+      size_t threads)
+      : pool_{std::max<size_t>(threads, 1)},
+        datastore_{std::move(ipfs_store)},
+        clock_{std::move(utc_clock)},
+        epoch_clock_{std::move(epoch_clock)},
+        weight_calculator_{std::move(weight_calculator)},
+        power_table_{std::move(power_table)},
+        bls_provider_{std::move(bls_crypto_provider)},
+        secp_provider_{std::move(secp_crypto_provider)},
+        vm_interpreter_{std::move(vm_interpreter)},
+        secp_verifier_{std::move(secp_verifier)},
+        verified_cache_{std::move(verified_cache)} {
+    if (!secp_verifier_) {
+      secp_verifier_ = std::make_shared<SecpMessageVerifier>(
+          secp_provider_, SecpMessageVerifier::kDefaultCapacity);
+    }
+    if (!verified_cache_) {
+      verified_cache_ = std::make_shared<VerifiedHeaderCache>();
+    }
+    for (auto &stage : stage_executors_) {
+      stage_latency_[stage.first];
+    }
+  }
+
   outcome::result<void> BlockValidatorImpl::validateBlock(
       const BlockHeader &block, scenarios::Scenario scenario) const {
-    for (const auto &stage : scenario) {
-      auto executor = stage_executors_.find(stage);
-      if (executor != stage_executors_.end()) {
-        auto result = std::invoke(executor->second, this, block);
-        if (result.has_error()) {
-          return result;
+    return validateBlocks({block}, scenario);
+  }
+
+  outcome::result<void> BlockValidatorImpl::validateBlocks(
+      const std::vector<BlockHeader> &blocks,
+      scenarios::Scenario scenario) const {
+    common::tracing::Span span{"block_validator.validate"};
+    std::vector<Stage> stages{scenario};
+    for (auto &stage : stages) {
+      if (stage_executors_.count(stage) == 0) {
+        return ValidatorError::UNKNOWN_STAGE;
+      }
+    }
+    // dependencies precede stage in enum order
+    std::sort(stages.begin(), stages.end());
+    stages.erase(std::unique(stages.begin(), stages.end()), stages.end());
+    std::map<Stage, size_t> stage_level;
+    std::vector<std::vector<Stage>> levels;
+    for (auto &stage : stages) {
+      size_t level{0};
+      auto dependencies = stage_dependencies_.find(stage);
+      if (dependencies != stage_dependencies_.end()) {
+        for (auto &dependency : dependencies->second) {
+          auto it = stage_level.find(dependency);
+          if (it != stage_level.end()) {
+            level = std::max(level, it->second + 1);
+          }
+        }
+      }
+      stage_level[stage] = level;
+      if (levels.size() <= level) {
+        levels.resize(level + 1);
+      }
+      levels[level].push_back(stage);
+    }
+
+    // looked up before running, so same blocks of one call all run
+    std::vector<boost::optional<CID>> cids;
+    std::vector<VerifiedHeaderCache::Stages> passed;
+    cids.reserve(blocks.size());
+    passed.reserve(blocks.size());
+    for (auto &block : blocks) {
+      auto cid = primitives::cid::getCidOfCbor(block);
+      if (cid) {
+        // known bad block is rejected without validation
+        if (auto error = verified_cache_->failed(cid.value())) {
+          return error;
+        }
+      }
+      passed.push_back(cid ? verified_cache_->passed(cid.value()) : 0);
+      cids.push_back(cid ? boost::make_optional(std::move(cid.value()))
+                         : boost::none);
+    }
+
+    // errors by block and stage, every task of failed level runs, so
+    // reported error doesn't depend on timing
+    std::vector<std::error_code> errors(blocks.size() * stages.size());
+    std::atomic_bool failed{false};
+    auto run = [&](size_t block, Stage stage) {
+      if ((passed[block] & VerifiedHeaderCache::bit(stage)) != 0) {
+        return;
+      }
+      // stages run on pool threads
+      common::tracing::Span stage_span{stageSpan(stage), {}, span.context()};
+      auto start = common::LatencyHistogram::Clock::now();
+      auto result =
+          std::invoke(stage_executors_.at(stage), this, blocks[block]);
+      stage_latency_.at(stage).record(common::LatencyHistogram::Clock::now()
+                                      - start);
+      if (!result) {
+        auto index = std::lower_bound(stages.begin(), stages.end(), stage)
+                     - stages.begin();
+        errors[block * stages.size() + index] = result.error();
+        failed = true;
+        if (cids[block] && isVerdict(result.error())) {
+          verified_cache_->fail(*cids[block], stage, result.error());
         }
+      } else if (cids[block]) {
+        verified_cache_->pass(*cids[block], stage);
+      }
+    };
+
+    for (auto &level : levels) {
+      auto tasks = blocks.size() * level.size();
+      if (tasks == 1) {
+        run(0, level[0]);
       } else {
-        return ValidatorError::UNKNOWN_STAGE;
+        Latch latch{tasks};
+        for (size_t block = 0; block < blocks.size(); ++block) {
+          for (auto stage : level) {
+            boost::asio::post(pool_, [&, block, stage] {
+              run(block, stage);
+              latch.countDown();
+            });
+          }
+        }
+        latch.wait();
+      }
+      // next level depends on failed stages
+      if (failed) {
+        break;
+      }
+    }
+
+    for (auto &error : errors) {
+      if (error) {
+        return error;
       }
     }
     return outcome::success();
   }
 
+  common::LatencyHistogram::Snapshot BlockValidatorImpl::stageLatency(
+      Stage stage) const {
+    auto it = stage_latency_.find(stage);
+    if (it == stage_latency_.end()) {
+      return {};
+    }
+    return it->second.snapshot();
+  }
+
   outcome::result<void> BlockValidatorImpl::syntax(
       const BlockHeader &block) const {
     OUTCOME_TRY(SyntaxRules::parentsCount(block));
@@ -64,7 +280,7 @@ namespace fc::blockchain::block_validator {
     OUTCOME_TRY(ConsensusRules::activeMiner(block, power_table_));
     OUTCOME_TRY(parent_tipset, getParentTipset(block));
     OUTCOME_TRY(ConsensusRules::parentWeight(
-        block, parent_tipset.get(), weight_calculator_));
+        block, parent_tipset, weight_calculator_));
     OUTCOME_TRY(chain_epoch, epoch_clock_->epochAtTime(clock_->nowUTC()));
     OUTCOME_TRY(ConsensusRules::epoch(block, chain_epoch));
     return outcome::success();
@@ -134,6 +350,63 @@ namespace fc::blockchain::block_validator {
 
   outcome::result<void> BlockValidatorImpl::messageSign(
       const BlockHeader &block) const {
+    using BlsPubKey = primitives::address::BLSPublicKeyHash;
+    OUTCOME_TRY(meta, datastore_->getCbor<MsgMeta>(block.messages));
+    vm::state::StateTreeImpl state_tree{datastore_, block.parent_state_root};
+    auto key_address = [&](Address address) -> outcome::result<Address> {
+      if (address.isId()) {
+        OUTCOME_TRY(account, state_tree.state<AccountActorState>(address));
+        return account.address;
+      }
+      return address;
+    };
+
+    std::vector<SignedMessage> secp_messages;
+    OUTCOME_TRY(meta.secp_messages.visit(
+        [&](auto, auto &cid) -> outcome::result<void> {
+          OUTCOME_TRY(message, datastore_->getCbor<SignedMessage>(cid));
+          secp_messages.push_back(std::move(message));
+          return outcome::success();
+        }));
+    // signers are usually cached when messages were added to mempool
+    auto secp_keys = secp_verifier_->recoverPublicKeys(secp_messages);
+    for (size_t i = 0; i < secp_messages.size(); ++i) {
+      OUTCOME_TRY(from, key_address(secp_messages[i].message.from));
+      if (!secp_keys[i] || !from.verifySyntax(secp_keys[i].value())) {
+        return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+      }
+    }
+
+    std::vector<std::vector<uint8_t>> messages;
+    std::vector<BlsCryptoPubKey> keys;
+    OUTCOME_TRY(meta.bls_messages.visit(
+        [&](auto, auto &cid) -> outcome::result<void> {
+          OUTCOME_TRY(message, datastore_->getCbor<UnsignedMessage>(cid));
+          OUTCOME_TRY(from, key_address(message.from));
+          auto public_key = boost::get<BlsPubKey>(&from.data);
+          if (public_key == nullptr) {
+            return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+          }
+          OUTCOME_TRY(cid_bytes, cid.toBytes());
+          messages.push_back(std::move(cid_bytes));
+          auto &key = keys.emplace_back();
+          std::copy_n(public_key->begin(), key.size(), key.begin());
+          return outcome::success();
+        }));
+    if (messages.empty()) {
+      return outcome::success();
+    }
+    if (!block.bls_aggregate || !block.bls_aggregate->isBls()) {
+      return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+    }
+    OUTCOME_TRY(valid,
+                bls_provider_->verifyAggregateSignature(
+                    messages,
+                    keys,
+                    boost::get<BlsCryptoSignature>(*block.bls_aggregate)));
+    if (!valid) {
+      return ValidatorError::INVALID_MESSAGE_SIGNATURE;
+    }
     return outcome::success();
   }
 
@@ -148,12 +421,14 @@ namespace fc::blockchain::block_validator {
     return ValidatorError::INVALID_PARENT_STATE;
   }
 
-  outcome::result<std::reference_wrapper<BlockValidatorImpl::Tipset>>
+  outcome::result<BlockValidatorImpl::Tipset>
   BlockValidatorImpl::getParentTipset(const BlockHeader &block) const {
-    IPLDBlock ipld_block = IPLDBlock::create(block);
-    if (parent_tipset_cache_
-        && parent_tipset_cache_.value().first == ipld_block.cid) {
-      return parent_tipset_cache_.value().second;
+    {
+      std::lock_guard lock{parent_tipset_mutex_};
+      if (parent_tipset_cache_
+          && parent_tipset_cache_.value().first == block.parents) {
+        return parent_tipset_cache_.value().second;
+      }
     }
     std::vector<BlockHeader> parent_blocks;
     for (const CID &parent_block_cid : block.parents) {
@@ -171,9 +446,9 @@ namespace fc::blockchain::block_validator {
       }
     }
     OUTCOME_TRY(tipset, Tipset::create(parent_blocks));
-    parent_tipset_cache_ =
-        std::make_pair(std::move(ipld_block.cid), std::move(tipset));
-    return parent_tipset_cache_.value().second;
+    std::lock_guard lock{parent_tipset_mutex_};
+    parent_tipset_cache_ = std::make_pair(block.parents, tipset);
+    return std::move(tipset);
   }
 
 }  // namespace fc::blockchain::block_validator
@@ -193,6 +468,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::block_validator,
       return "Block validation: invalid miner public key";
     case ValidatorError::INVALID_PARENT_STATE:
       return "Block validation: invalid parent state";
+    case ValidatorError::INVALID_MESSAGE_SIGNATURE:
+      return "Block validation: invalid message signature";
   }
   return "Block validation: unknown error";
 }
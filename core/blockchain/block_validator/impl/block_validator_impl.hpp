@@ -9,17 +9,23 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 
+#include <boost/asio/thread_pool.hpp>
 #include <boost/optional.hpp>
 #include <libp2p/crypto/secp256k1_provider.hpp>
 #include "blockchain/block_validator/block_validator.hpp"
+#include "blockchain/block_validator/verified_header_cache.hpp"
 #include "blockchain/weight_calculator.hpp"
 #include "clock/chain_epoch_clock.hpp"
 #include "clock/utc_clock.hpp"
+#include "common/histogram.hpp"
 #include "crypto/bls/bls_provider.hpp"
 #include "power/power_table.hpp"
 #include "storage/ipfs/datastore.hpp"
 #include "vm/interpreter/interpreter.hpp"
+#include "vm/message/secp_message_verifier.hpp"
 
 namespace fc::blockchain::block_validator {
 
@@ -35,6 +41,7 @@ namespace fc::blockchain::block_validator {
     using SecpProvider = crypto::secp256k1::Secp256k1ProviderDefault;
     using Interpreter = vm::interpreter::Interpreter;
     using Tipset = primitives::tipset::Tipset;
+    using SecpMessageVerifier = vm::message::SecpMessageVerifier;
 
    public:
     using StageExecutor = outcome::result<void> (BlockValidatorImpl::*)(
@@ -47,22 +54,45 @@ namespace fc::blockchain::block_validator {
                        std::shared_ptr<PowerTable> power_table,
                        std::shared_ptr<BlsProvider> bls_crypto_provider,
                        std::shared_ptr<SecpProvider> secp_crypto_provider,
-                       std::shared_ptr<Interpreter> vm_interpreter)
-        : datastore_{std::move(ipfs_store)},
-          clock_{std::move(utc_clock)},
-          epoch_clock_{std::move(epoch_clock)},
-          weight_calculator_{std::move(weight_calculator)},
-          power_table_{std::move(power_table)},
-          bls_provider_{std::move(bls_crypto_provider)},
-          secp_provider_{std::move(secp_crypto_provider)},
-          vm_interpreter_{std::move(vm_interpreter)} {}
+                       std::shared_ptr<Interpreter> vm_interpreter,
+                       std::shared_ptr<SecpMessageVerifier> secp_verifier =
+                           nullptr,
+                       std::shared_ptr<VerifiedHeaderCache> verified_cache =
+                           nullptr,
+                       size_t threads = std::thread::hardware_concurrency());
 
     outcome::result<void> validateBlock(
         const BlockHeader &header, scenarios::Scenario scenario) const override;
 
+    /**
+     * Stages of all blocks run on thread pool as dependency graph, next
+     * stages start only after cheaper ones succeeded for all blocks.
+     * Stages which already passed for block are skipped.
+     */
+    outcome::result<void> validateBlocks(
+        const std::vector<BlockHeader> &headers,
+        scenarios::Scenario scenario) const override;
+
+    /**
+     * @brief Get stage execution time distribution
+     * @param stage - validation stage
+     * @return histogram snapshot
+     */
+    common::LatencyHistogram::Snapshot stageLatency(Stage stage) const;
+
    private:
     const static std::map<scenarios::Stage, StageExecutor> stage_executors_;
 
+    /**
+     * Stages which must succeed before given one starts,
+     * ignored if not in scenario
+     */
+    const static std::map<scenarios::Stage, std::vector<scenarios::Stage>>
+        stage_dependencies_;
+
+    mutable boost::asio::thread_pool pool_;
+    mutable std::map<Stage, common::LatencyHistogram> stage_latency_;
+
     std::shared_ptr<IpfsDatastore> datastore_;
     std::shared_ptr<UTCClock> clock_;
     std::shared_ptr<EpochClock> epoch_clock_;
@@ -71,13 +101,16 @@ namespace fc::blockchain::block_validator {
     std::shared_ptr<BlsProvider> bls_provider_;
     std::shared_ptr<SecpProvider> secp_provider_;
     std::shared_ptr<Interpreter> vm_interpreter_;
+    std::shared_ptr<SecpMessageVerifier> secp_verifier_;
+    std::shared_ptr<VerifiedHeaderCache> verified_cache_;
 
     /**
-     * BlockHeader CID -> Parent tipset
-     * Assuming that block validation executes sequentially,
-     * so for several blocks parent tipset will be the same
+     * Parent block CIDs -> Parent tipset
+     * Blocks of one tipset have the same parent tipset
      */
-    mutable boost::optional<std::pair<CID, Tipset>> parent_tipset_cache_;
+    mutable boost::optional<std::pair<std::vector<CID>, Tipset>>
+        parent_tipset_cache_;
+    mutable std::mutex parent_tipset_mutex_;
 
     /**
      * @brief Check block syntax
@@ -133,8 +166,7 @@ namespace fc::blockchain::block_validator {
      * @param header - selected block
      * @return operation result
      */
-    outcome::result<std::reference_wrapper<Tipset>> getParentTipset(
-        const BlockHeader &header) const;
+    outcome::result<Tipset> getParentTipset(const BlockHeader &header) const;
   };
 
   enum class ValidatorError {
@@ -143,6 +175,7 @@ namespace fc::blockchain::block_validator {
     INVALID_BLOCK_SIGNATURE,
     INVALID_MINER_PUBLIC_KEY,
     INVALID_PARENT_STATE,
+    INVALID_MESSAGE_SIGNATURE,
   };
 
 }  // namespace fc::blockchain::block_validator
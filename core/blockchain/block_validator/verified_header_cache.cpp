@@ -0,0 +1,88 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/block_validator/verified_header_cache.hpp"
+
+namespace fc::blockchain::block_validator {
+  VerifiedHeaderCache::VerifiedHeaderCache(size_t capacity)
+      : capacity_{capacity} {}
+
+  bool VerifiedHeaderCache::cacheable(Stage stage) {
+    // consensus depends on current time and power table
+    return stage != Stage::CONSENSUS_BV1;
+  }
+
+  VerifiedHeaderCache::Stages VerifiedHeaderCache::bit(Stage stage) {
+    return Stages{1} << static_cast<int>(stage);
+  }
+
+  VerifiedHeaderCache::Stages VerifiedHeaderCache::passed(
+      const CID &block) const {
+    std::lock_guard lock{mutex_};
+    auto it = index_.find(block);
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return 0;
+    }
+    ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second.passed;
+  }
+
+  void VerifiedHeaderCache::pass(const CID &block, Stage stage) {
+    if (!cacheable(stage)) {
+      return;
+    }
+    std::lock_guard lock{mutex_};
+    if (capacity_ == 0) {
+      return;
+    }
+    entry(block).passed |= bit(stage);
+  }
+
+  std::error_code VerifiedHeaderCache::failed(const CID &block) const {
+    std::lock_guard lock{mutex_};
+    auto it = index_.find(block);
+    if (it == index_.end()) {
+      return {};
+    }
+    return it->second->second.error;
+  }
+
+  void VerifiedHeaderCache::fail(const CID &block,
+                                 Stage stage,
+                                 std::error_code error) {
+    if (!cacheable(stage) || !error) {
+      return;
+    }
+    std::lock_guard lock{mutex_};
+    if (capacity_ == 0) {
+      return;
+    }
+    entry(block).error = error;
+  }
+
+  VerifiedHeaderCache::Entry &VerifiedHeaderCache::entry(const CID &block) {
+    auto it = index_.find(block);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->second;
+    }
+    lru_.emplace_front(block, Entry{});
+    index_.emplace(block, lru_.begin());
+    if (lru_.size() > capacity_) {
+      index_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+    return lru_.front().second;
+  }
+
+  VerifiedHeaderCache::Stats VerifiedHeaderCache::stats() const {
+    std::lock_guard lock{mutex_};
+    auto stats = stats_;
+    stats.entries = lru_.size();
+    return stats;
+  }
+}  // namespace fc::blockchain::block_validator
@@ -0,0 +1,86 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_BLOCK_VALIDATOR_VERIFIED_HEADER_CACHE_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_BLOCK_VALIDATOR_VERIFIED_HEADER_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+
+#include "blockchain/block_validator/block_validator_scenarios.hpp"
+#include "primitives/cid/cid.hpp"
+
+namespace fc::blockchain::block_validator {
+  using scenarios::Stage;
+
+  /**
+   * @class VerifiedHeaderCache remembers validation stages which passed for
+   * block headers in bounded LRU cache. Same header comes from gossip, sync
+   * and chain store, and again on reorg, so one instance should be shared by
+   * validators. Key is block CID, which covers all header fields, so only
+   * stages depending on header alone are remembered. Blocks which failed
+   * such stage are remembered too, so known bad block is rejected again
+   * without validation.
+   */
+  class VerifiedHeaderCache {
+   public:
+    /// Set of stages, bit of stage is its enum value
+    using Stages = uint32_t;
+
+    /// Cache counters
+    struct Stats {
+      uint64_t hits{};
+      uint64_t misses{};
+      uint64_t entries{};
+    };
+
+    /// Default number of cached headers
+    static constexpr size_t kDefaultCapacity{8192};
+
+    explicit VerifiedHeaderCache(size_t capacity = kDefaultCapacity);
+
+    /// Whether result of stage depends only on header, e.g. not on time
+    static bool cacheable(Stage stage);
+
+    static Stages bit(Stage stage);
+
+    /// Stages passed by block, counts hit if any
+    Stages passed(const CID &block) const;
+
+    /// Remember that block passed stage, ignored if stage isn't cacheable
+    void pass(const CID &block, Stage stage);
+
+    /// Error of stage which block failed, empty if block isn't known bad
+    std::error_code failed(const CID &block) const;
+
+    /**
+     * Remember that block failed stage, ignored if stage isn't cacheable.
+     * Error must not depend on state of node, e.g. missing parent.
+     */
+    void fail(const CID &block, Stage stage, std::error_code error);
+
+    Stats stats() const;
+
+   private:
+    struct Entry {
+      Stages passed{};
+      std::error_code error;
+    };
+    using Lru = std::list<std::pair<CID, Entry>>;
+
+    /// Entry of block marked as recently used, inserted if missing
+    Entry &entry(const CID &block);
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    mutable Lru lru_;
+    std::unordered_map<CID, Lru::iterator> index_;
+    mutable Stats stats_;
+  };
+}  // namespace fc::blockchain::block_validator
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_BLOCK_VALIDATOR_VERIFIED_HEADER_CACHE_HPP
@@ -0,0 +1,251 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/chain_exchange/chain_exchange_server.hpp"
+
+#include "codec/cbor/cbor.hpp"
+#include "primitives/block/block.hpp"
+
+namespace fc::blockchain::chain_exchange {
+  using codec::cbor::CborEncodeStream;
+  using primitives::block::MsgMeta;
+
+  ChainExchangeServer::ChainExchangeServer(
+      std::shared_ptr<libp2p::Host> host,
+      std::shared_ptr<ChainStore> chain_store,
+      IpldPtr ipld,
+      ChainExchangeConfig config)
+      : host_{std::move(host)},
+        chain_store_{std::move(chain_store)},
+        ipld_{std::move(ipld)},
+        config_{config},
+        logger_{common::createLogger("chain_exchange")} {}
+
+  void ChainExchangeServer::start() {
+    host_->setProtocolHandler(
+        kProtocolId,
+        [weak{weak_from_this()}](std::shared_ptr<CborStream::Stream> stream) {
+          auto self{weak.lock()};
+          if (!self) {
+            return stream->reset();
+          }
+          auto peer{stream->remotePeerId()};
+          if (!peer) {
+            return stream->reset();
+          }
+          auto cbor{std::make_shared<CborStream>(stream)};
+          cbor->respondEncoded<Request>(
+              [self, peer{std::move(peer.value())}](auto &request) {
+                return self->serve(peer, request);
+              },
+              [self, stream](auto result) {
+                if (!result) {
+                  self->logger_->debug("serve: {}", result.error().message());
+                }
+                stream->close([](auto) {});
+              });
+        });
+  }
+
+  outcome::result<ChainExchangeServer::Encoded> ChainExchangeServer::serve(
+      const PeerId &peer, const Request &request) {
+    auto options{request.options & (kBlocks | kMessages)};
+    if (request.start.empty() || request.length == 0 || options == 0) {
+      return encodeResponse({}, options, ResponseStatus::BAD_REQUEST, {});
+    }
+    auto length{std::min(request.length, config_.max_length)};
+    if (!take(peer, length)) {
+      return encodeResponse({}, options, ResponseStatus::GO_AWAY, {});
+    }
+    OUTCOME_TRY(head, chain_store_->heaviestTipset());
+    auto tipset{chain_store_->loadSharedTipset(TipsetKey{request.start})};
+    if (!tipset) {
+      return encodeResponse({}, options, ResponseStatus::NOT_FOUND, {});
+    }
+    std::vector<Segment> chain;
+    chain.reserve(length);
+    auto status{length < request.length ? ResponseStatus::PARTIAL
+                                        : ResponseStatus::OK};
+    std::string message;
+    while (true) {
+      auto recent{tipset.value()->height + config_.recent_epochs
+                  >= head.height};
+      auto segment{this->segment(tipset.value(), options, recent)};
+      if (!segment) {
+        message = segment.error().message();
+        break;
+      }
+      chain.push_back(std::move(segment.value()));
+      if (chain.size() == length || tipset.value()->height == 0) {
+        break;
+      }
+      auto parents{tipset.value()->getParents()};
+      if (!parents) {
+        message = parents.error().message();
+        break;
+      }
+      tipset = chain_store_->loadSharedTipset(parents.value());
+      if (!tipset) {
+        message = tipset.error().message();
+        break;
+      }
+    }
+    if (!message.empty()) {
+      status = chain.empty() ? ResponseStatus::INTERNAL_ERROR
+                             : ResponseStatus::PARTIAL;
+    }
+    return encodeResponse(chain, options, status, message);
+  }
+
+  bool ChainExchangeServer::take(const PeerId &peer, uint64_t tipsets) {
+    auto now{std::chrono::steady_clock::now()};
+    std::lock_guard lock{buckets_mutex_};
+    auto refill{[&](const Bucket &bucket) {
+      std::chrono::duration<double> elapsed{now - bucket.updated};
+      return std::min(config_.peer_burst,
+                      bucket.tokens + elapsed.count() * config_.peer_rate);
+    }};
+    auto it{buckets_.find(peer)};
+    if (it == buckets_.end()) {
+      if (buckets_.size() >= kMaxBuckets) {
+        // idle peers are not distinguishable from new ones
+        for (auto idle{buckets_.begin()}; idle != buckets_.end();) {
+          idle = refill(idle->second) == config_.peer_burst
+                     ? buckets_.erase(idle)
+                     : std::next(idle);
+        }
+      }
+      it = buckets_.emplace(peer, Bucket{config_.peer_burst, now}).first;
+    }
+    auto &bucket{it->second};
+    bucket.tokens = refill(bucket);
+    bucket.updated = now;
+    if (bucket.tokens < tipsets) {
+      return false;
+    }
+    bucket.tokens -= tipsets;
+    return true;
+  }
+
+  outcome::result<ChainExchangeServer::Segment> ChainExchangeServer::segment(
+      const TipsetCPtr &tipset, uint64_t options, bool recent) {
+    auto complete{[&](const Segment &segment) {
+      return (!(options & kBlocks) || segment.blocks)
+             && (!(options & kMessages) || segment.messages);
+    }};
+    OUTCOME_TRY(key, tipset->makeKey());
+    Segment segment;
+    if (recent) {
+      std::lock_guard lock{cache_mutex_};
+      auto it{cache_.find(key)};
+      if (it != cache_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        segment = it->second->second;
+      }
+    }
+    if (complete(segment)) {
+      return segment;
+    }
+    if ((options & kBlocks) && !segment.blocks) {
+      OUTCOME_TRYA(segment.blocks, encodeBlocks(tipset));
+    }
+    if ((options & kMessages) && !segment.messages) {
+      OUTCOME_TRYA(segment.messages, encodeMessages(tipset));
+    }
+    if (recent) {
+      std::lock_guard lock{cache_mutex_};
+      auto it{cache_.find(key)};
+      if (it != cache_.end()) {
+        auto &cached{it->second->second};
+        if (!cached.blocks) {
+          cached.blocks = segment.blocks;
+        }
+        if (!cached.messages) {
+          cached.messages = segment.messages;
+        }
+      } else {
+        lru_.emplace_front(key, segment);
+        cache_.emplace(std::move(key), lru_.begin());
+        if (lru_.size() > config_.cache_size) {
+          cache_.erase(lru_.back().first);
+          lru_.pop_back();
+        }
+      }
+    }
+    return segment;
+  }
+
+  outcome::result<ChainExchangeServer::Encoded>
+  ChainExchangeServer::encodeBlocks(const TipsetCPtr &tipset) const {
+    auto s{CborEncodeStream::list()};
+    for (auto &cid : tipset->cids) {
+      OUTCOME_TRY(bytes, ipld_->get(cid));
+      s << CborEncodeStream::wrap(bytes, 1);
+    }
+    return std::make_shared<const std::vector<uint8_t>>(s.data());
+  }
+
+  outcome::result<ChainExchangeServer::Encoded>
+  ChainExchangeServer::encodeMessages(const TipsetCPtr &tipset) const {
+    // messages included by several blocks are written once
+    struct Messages {
+      CborEncodeStream list{CborEncodeStream::list()};
+      std::map<CID, uint64_t> indices;
+      std::vector<std::vector<uint64_t>> includes;
+
+      outcome::result<void> add(Ipld &ipld, const CID &cid) {
+        auto it{indices.find(cid)};
+        if (it == indices.end()) {
+          OUTCOME_TRY(bytes, ipld.get(cid));
+          list << CborEncodeStream::wrap(bytes, 1);
+          it = indices.emplace(cid, indices.size()).first;
+        }
+        includes.back().push_back(it->second);
+        return outcome::success();
+      }
+    };
+    Messages bls, secp;
+    for (auto &block : tipset->blks) {
+      OUTCOME_TRY(meta, ipld_->getCbor<MsgMeta>(block.messages));
+      bls.includes.emplace_back();
+      OUTCOME_TRY(meta.bls_messages.visit([&](auto, auto &cid) {
+        return bls.add(*ipld_, cid);
+      }));
+      secp.includes.emplace_back();
+      OUTCOME_TRY(meta.secp_messages.visit([&](auto, auto &cid) {
+        return secp.add(*ipld_, cid);
+      }));
+    }
+    CborEncodeStream s;
+    s << bls.list << bls.includes << secp.list << secp.includes;
+    return std::make_shared<const std::vector<uint8_t>>(s.data());
+  }
+
+  ChainExchangeServer::Encoded ChainExchangeServer::encodeResponse(
+      const std::vector<Segment> &chain,
+      uint64_t options,
+      ResponseStatus status,
+      const std::string &message) {
+    auto empty{CborEncodeStream::list()};
+    auto s{CborEncodeStream::list()};
+    auto l_chain{CborEncodeStream::list()};
+    for (auto &segment : chain) {
+      auto bundle{CborEncodeStream::list()};
+      if ((options & kBlocks) && segment.blocks) {
+        bundle << CborEncodeStream::wrap(*segment.blocks, 1);
+      } else {
+        bundle << empty;
+      }
+      if ((options & kMessages) && segment.messages) {
+        bundle << CborEncodeStream::wrap(*segment.messages, 4);
+      } else {
+        bundle << empty << empty << empty << empty;
+      }
+      l_chain << bundle;
+    }
+    s << l_chain << static_cast<uint64_t>(status) << message;
+    return std::make_shared<const std::vector<uint8_t>>(s.data());
+  }
+}  // namespace fc::blockchain::chain_exchange
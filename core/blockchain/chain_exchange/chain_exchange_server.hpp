@@ -0,0 +1,113 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_CHAIN_EXCHANGE_CHAIN_EXCHANGE_SERVER_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_CHAIN_EXCHANGE_CHAIN_EXCHANGE_SERVER_HPP
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <libp2p/host/host.hpp>
+
+#include "blockchain/chain_exchange/protocol.hpp"
+#include "common/libp2p/cbor_stream.hpp"
+#include "common/logger.hpp"
+#include "storage/chain/chain_store.hpp"
+
+namespace fc::blockchain::chain_exchange {
+  using common::libp2p::CborStream;
+  using libp2p::peer::PeerId;
+  using primitives::tipset::TipsetCPtr;
+  using primitives::tipset::TipsetKey;
+  using storage::blockchain::ChainStore;
+
+  struct ChainExchangeConfig {
+    /// Longer requests are served partially
+    uint64_t max_length{800};
+    /// Number of tipsets with cached encoded headers and messages
+    size_t cache_size{2000};
+    /// Only tipsets so many epochs below head are cached
+    uint64_t recent_epochs{900};
+    /// Tipsets per second served to one peer
+    double peer_rate{200};
+    /// Tipsets one peer may request at once after idle time
+    double peer_burst{2000};
+  };
+
+  /**
+   * Serves chain exchange requests of peers.
+   * Headers and messages of tipsets are written from bytes stored in ipld,
+   * they are not decoded and encoded again. Encoded headers and messages
+   * of recent tipsets are cached, so peers syncing to head get segments
+   * by copy of cached bytes. Each peer has token bucket of tipsets, peer
+   * exceeding its rate gets GO_AWAY.
+   */
+  class ChainExchangeServer
+      : public std::enable_shared_from_this<ChainExchangeServer> {
+   public:
+    using Encoded = CborStream::Encoded;
+
+    /// Refilled buckets are dropped when there are so many peers
+    static constexpr size_t kMaxBuckets{1024};
+
+    ChainExchangeServer(std::shared_ptr<libp2p::Host> host,
+                        std::shared_ptr<ChainStore> chain_store,
+                        IpldPtr ipld,
+                        ChainExchangeConfig config = {});
+
+    /// Sets protocol handler on host
+    void start();
+
+    /// Encoded response to request of peer
+    outcome::result<Encoded> serve(const PeerId &peer,
+                                   const Request &request);
+
+   private:
+    /// Encoded parts of tipset bundle
+    struct Segment {
+      /// List of block headers
+      Encoded blocks;
+      /// Bls messages, bls includes, secp messages and secp includes
+      Encoded messages;
+    };
+
+    struct Bucket {
+      double tokens;
+      std::chrono::steady_clock::time_point updated;
+    };
+
+    using Lru = std::list<std::pair<TipsetKey, Segment>>;
+
+    /// Takes tokens of peer, false if peer exceeded rate
+    bool take(const PeerId &peer, uint64_t tipsets);
+
+    /// Encoded bundle parts of tipset, from cache if tipset is recent
+    outcome::result<Segment> segment(const TipsetCPtr &tipset,
+                                     uint64_t options,
+                                     bool recent);
+    outcome::result<Encoded> encodeBlocks(const TipsetCPtr &tipset) const;
+    outcome::result<Encoded> encodeMessages(const TipsetCPtr &tipset) const;
+
+    static Encoded encodeResponse(const std::vector<Segment> &chain,
+                                  uint64_t options,
+                                  ResponseStatus status,
+                                  const std::string &message);
+
+    std::shared_ptr<libp2p::Host> host_;
+    std::shared_ptr<ChainStore> chain_store_;
+    IpldPtr ipld_;
+    ChainExchangeConfig config_;
+    std::mutex cache_mutex_;
+    /// Most recently used first
+    Lru lru_;
+    std::unordered_map<TipsetKey, Lru::iterator> cache_;
+    std::mutex buckets_mutex_;
+    std::unordered_map<PeerId, Bucket> buckets_;
+    common::Logger logger_;
+  };
+}  // namespace fc::blockchain::chain_exchange
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_CHAIN_EXCHANGE_CHAIN_EXCHANGE_SERVER_HPP
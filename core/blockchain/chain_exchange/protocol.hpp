@@ -0,0 +1,60 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_CHAIN_EXCHANGE_PROTOCOL_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_CHAIN_EXCHANGE_PROTOCOL_HPP
+
+#include <libp2p/peer/protocol.hpp>
+
+#include "codec/cbor/streams_annotation.hpp"
+#include "primitives/cid/cid.hpp"
+
+namespace fc::blockchain::chain_exchange {
+  /**
+   * Chain exchange protocol, peers request chain segment of some tipsets
+   * back from tipset key, with headers and/or messages.
+   * Implemented according to
+   * https://github.com/filecoin-project/lotus/blob/master/chain/blocksync/protocol.go
+   */
+  const libp2p::peer::Protocol kProtocolId = "/fil/sync/blk/0.0.1";
+
+  /// Bits of request options
+  enum Options : uint64_t {
+    kBlocks = 1,
+    kMessages = 2,
+  };
+
+  struct Request {
+    /// Tipset key to start from, segment goes to parents
+    std::vector<CID> start;
+    /// Number of tipsets
+    uint64_t length{};
+    uint64_t options{};
+  };
+  CBOR_TUPLE(Request, start, length, options)
+
+  enum class ResponseStatus : uint64_t {
+    OK = 0,
+    /// Segment is shorter than requested
+    PARTIAL = 101,
+    NOT_FOUND = 201,
+    /// Peer exceeded request rate
+    GO_AWAY = 202,
+    INTERNAL_ERROR = 203,
+    BAD_REQUEST = 204,
+  };
+
+  /**
+   * Response is tuple of chain, status and message, chain is list of tipset
+   * bundles.
+   * Bundle is tuple of block headers, bls messages, bls includes, secp
+   * messages and secp includes. Messages of tipset are deduplicated,
+   * includes of i-th block are indices of its messages in tipset lists.
+   * Server writes bundles from pre-encoded bytes, so there are no structs
+   * for them.
+   */
+}  // namespace fc::blockchain::chain_exchange
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_CHAIN_EXCHANGE_PROTOCOL_HPP
@@ -0,0 +1,177 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/impl/checkpoint_sync.hpp"
+
+#include <algorithm>
+
+#include "primitives/cid/cid_of_cbor.hpp"
+
+namespace fc::blockchain::sync_manager {
+  namespace scenarios = block_validator::scenarios;
+
+  CheckpointSync::CheckpointSync(IpldPtr ipld,
+                                 std::shared_ptr<ChainStore> chain_store,
+                                 std::shared_ptr<BlockValidator> validator,
+                                 Checkpoint checkpoint)
+      : ipld_{std::move(ipld)},
+        chain_store_{std::move(chain_store)},
+        validator_{std::move(validator)},
+        checkpoint_{std::move(checkpoint)},
+        logger_{common::createLogger("checkpoint_sync")} {}
+
+  outcome::result<void> CheckpointSync::import(
+      std::istream &car, const storage::car::LoadCarOptions &options) {
+    OUTCOME_TRY(roots, storage::car::loadCar(*ipld_, car, options));
+    if (roots != checkpoint_.key.cids) {
+      return CheckpointSyncError::ROOTS_MISMATCH;
+    }
+    OUTCOME_TRY(tipset, Tipset::load(*ipld_, roots));
+    for (auto &block : tipset.blks) {
+      if (block.parent_state_root != checkpoint_.state_root) {
+        return CheckpointSyncError::STATE_ROOT_MISMATCH;
+      }
+    }
+    OUTCOME_TRY(has_state, ipld_->contains(checkpoint_.state_root));
+    if (!has_state) {
+      return CheckpointSyncError::STATE_NOT_FOUND;
+    }
+    logger_->info("imported checkpoint at height {}, validating headers",
+                  tipset.height);
+    OUTCOME_TRY(validateHeaders(tipset));
+    for (auto &block : tipset.blks) {
+      OUTCOME_TRY(chain_store_->addBlock(block));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<bool> CheckpointSync::resume() {
+    for (auto &cid : checkpoint_.key.cids) {
+      OUTCOME_TRY(has_block, ipld_->contains(cid));
+      if (!has_block) {
+        logger_->warn("checkpoint is not imported");
+        return false;
+      }
+    }
+    OUTCOME_TRY(has_state, ipld_->contains(checkpoint_.state_root));
+    if (!has_state) {
+      logger_->warn("checkpoint state is not imported");
+      return false;
+    }
+    OUTCOME_TRY(tipset, Tipset::load(*ipld_, checkpoint_.key.cids));
+    for (auto &block : tipset.blks) {
+      if (block.parent_state_root != checkpoint_.state_root) {
+        return CheckpointSyncError::STATE_ROOT_MISMATCH;
+      }
+    }
+    for (auto &block : tipset.blks) {
+      OUTCOME_TRY(chain_store_->addBlock(block));
+    }
+    logger_->info("starting from checkpoint at height {}", tipset.height);
+    return true;
+  }
+
+  outcome::result<bool> CheckpointSync::known(const TipsetKey &key) const {
+    if (key == checkpoint_.key) {
+      return true;
+    }
+    // not found is reported as error
+    auto contains{chain_store_->containsTipset(key)};
+    return contains && contains.value();
+  }
+
+  outcome::result<void> CheckpointSync::apply(const Tipset &tipset) const {
+    OUTCOME_TRY(checkpoint, chain_store_->loadSharedTipset(checkpoint_.key));
+    if (tipset.height <= checkpoint->height) {
+      // trusted checkpoint, no forks below it
+      return CheckpointSyncError::BEFORE_CHECKPOINT;
+    }
+    OUTCOME_TRY(checkDescent(tipset, *checkpoint));
+    OUTCOME_TRY(
+        validator_->validateBlocks(tipset.blks, scenarios::kFullValidation));
+    for (auto &block : tipset.blks) {
+      OUTCOME_TRY(chain_store_->addBlock(block));
+    }
+    OUTCOME_TRY(key, tipset.makeKey());
+    std::lock_guard lock{descendants_mutex_};
+    descendants_[tipset.height].push_back(std::move(key));
+    while (descendants_.begin()->first + kDescendantsWindow
+           < descendants_.rbegin()->first) {
+      descendants_.erase(descendants_.begin());
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> CheckpointSync::checkDescent(
+      const Tipset &tipset, const Tipset &checkpoint) const {
+    OUTCOME_TRY(key, tipset.getParents());
+    while (true) {
+      if (key == checkpoint_.key) {
+        return outcome::success();
+      }
+      {
+        std::lock_guard lock{descendants_mutex_};
+        for (auto &[height, keys] : descendants_) {
+          if (std::find(keys.begin(), keys.end(), key) != keys.end()) {
+            return outcome::success();
+          }
+        }
+      }
+      OUTCOME_TRY(parent, chain_store_->loadSharedTipset(key));
+      if (parent->height <= checkpoint.height) {
+        return CheckpointSyncError::NOT_DESCENDANT;
+      }
+      // deep fork, walked down to checkpoint
+      OUTCOME_TRYA(key, parent->getParents());
+    }
+  }
+
+  outcome::result<void> CheckpointSync::validateHeaders(Tipset tipset) const {
+    using scenarios::kHeaderValidation;
+    while (true) {
+      OUTCOME_TRY(validator_->validateBlocks(tipset.blks, kHeaderValidation));
+      if (tipset.height == 0) {
+        break;
+      }
+      OUTCOME_TRY(parent, tipset.loadParent(*ipld_));
+      if (parent.height >= tipset.height) {
+        return CheckpointSyncError::UNLINKED_HEADERS;
+      }
+      tipset = std::move(parent);
+      if (tipset.height % 10000 == 0) {
+        logger_->info("validated headers down to height {}", tipset.height);
+      }
+    }
+    OUTCOME_TRY(genesis, chain_store_->getGenesis());
+    OUTCOME_TRY(genesis_cid, primitives::cid::getCidOfCbor(genesis));
+    if (tipset.cids != std::vector<CID>{genesis_cid}) {
+      return CheckpointSyncError::GENESIS_MISMATCH;
+    }
+    return outcome::success();
+  }
+}  // namespace fc::blockchain::sync_manager
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::sync_manager,
+                            CheckpointSyncError,
+                            e) {
+  using fc::blockchain::sync_manager::CheckpointSyncError;
+  switch (e) {
+    case CheckpointSyncError::ROOTS_MISMATCH:
+      return "CheckpointSyncError: snapshot roots are not checkpoint key";
+    case CheckpointSyncError::STATE_ROOT_MISMATCH:
+      return "CheckpointSyncError: checkpoint has other parent state";
+    case CheckpointSyncError::STATE_NOT_FOUND:
+      return "CheckpointSyncError: snapshot has no checkpoint state";
+    case CheckpointSyncError::UNLINKED_HEADERS:
+      return "CheckpointSyncError: parent is not below child";
+    case CheckpointSyncError::GENESIS_MISMATCH:
+      return "CheckpointSyncError: headers lead to other genesis";
+    case CheckpointSyncError::BEFORE_CHECKPOINT:
+      return "CheckpointSyncError: tipset is not above checkpoint";
+    case CheckpointSyncError::NOT_DESCENDANT:
+      return "CheckpointSyncError: tipset doesn't descend from checkpoint";
+  }
+  return "CheckpointSyncError: unknown error";
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_CHECKPOINT_SYNC_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_CHECKPOINT_SYNC_HPP
+
+#include <map>
+#include <mutex>
+
+#include "blockchain/block_validator/block_validator.hpp"
+#include "common/logger.hpp"
+#include "storage/car/car.hpp"
+#include "storage/chain/chain_store.hpp"
+
+namespace fc::blockchain::sync_manager {
+  using block_validator::BlockValidator;
+  using primitives::tipset::Tipset;
+  using primitives::tipset::TipsetKey;
+  using storage::blockchain::ChainStore;
+
+  enum class CheckpointSyncError {
+    ROOTS_MISMATCH = 1,
+    STATE_ROOT_MISMATCH,
+    STATE_NOT_FOUND,
+    UNLINKED_HEADERS,
+    GENESIS_MISMATCH,
+    BEFORE_CHECKPOINT,
+    NOT_DESCENDANT,
+  };
+
+  /// Trusted tipset and its parent state
+  struct Checkpoint {
+    TipsetKey key;
+    /// Parent state root of checkpoint blocks
+    CID state_root;
+  };
+
+  /**
+   * Bootstraps node from trusted checkpoint instead of genesis.
+   * Snapshot CAR with checkpoint headers, their ancestors and checkpoint
+   * parent state is imported by streaming. Headers below checkpoint are
+   * checked for links and syntax only, their messages are not executed.
+   * Tipsets above checkpoint are fully validated, which interprets
+   * checkpoint first. Known and apply functions are used with SyncPipeline,
+   * so chain is fetched back to checkpoint and executed forward from it.
+   * Only descendants of checkpoint are applied.
+   */
+  class CheckpointSync {
+   public:
+    /// Applied tipsets are remembered so many epochs, to check descent
+    static constexpr primitives::ChainEpoch kDescendantsWindow{900};
+
+    CheckpointSync(IpldPtr ipld,
+                   std::shared_ptr<ChainStore> chain_store,
+                   std::shared_ptr<BlockValidator> validator,
+                   Checkpoint checkpoint);
+
+    /**
+     * Imports snapshot, validates headers down to genesis and adds
+     * checkpoint blocks to chain store
+     * @param car - snapshot with checkpoint key as roots
+     */
+    outcome::result<void> import(std::istream &car,
+                                 const storage::car::LoadCarOptions &options
+                                 = {});
+
+    /**
+     * Starts from checkpoint imported before, adds checkpoint blocks to
+     * chain store
+     * @return false if checkpoint headers or state are missing, node falls
+     * back to sync from genesis
+     */
+    outcome::result<bool> resume();
+
+    /**
+     * Checkpoint and stored tipsets are known, so fetch stops there,
+     * SyncPipeline known function
+     */
+    outcome::result<bool> known(const TipsetKey &key) const;
+
+    /**
+     * Validates tipset above checkpoint and adds it to chain store,
+     * SyncPipeline apply function
+     */
+    outcome::result<void> apply(const Tipset &tipset) const;
+
+   private:
+    /// Validates syntax and links of headers from tipset down to genesis
+    outcome::result<void> validateHeaders(Tipset tipset) const;
+
+    /// Checks that tipset checkpoint is ancestor of tipset
+    outcome::result<void> checkDescent(const Tipset &tipset,
+                                       const Tipset &checkpoint) const;
+
+    IpldPtr ipld_;
+    std::shared_ptr<ChainStore> chain_store_;
+    std::shared_ptr<BlockValidator> validator_;
+    Checkpoint checkpoint_;
+    mutable std::mutex descendants_mutex_;
+    /// Recently applied descendants of checkpoint by height
+    mutable std::map<primitives::ChainEpoch, std::vector<TipsetKey>>
+        descendants_;
+    common::Logger logger_;
+  };
+}  // namespace fc::blockchain::sync_manager
+
+OUTCOME_HPP_DECLARE_ERROR(fc::blockchain::sync_manager, CheckpointSyncError);
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_CHECKPOINT_SYNC_HPP
@@ -5,6 +5,8 @@
 
 #include "blockchain/impl/sync_bucket_set.hpp"
 
+#include <algorithm>
+
 namespace fc::blockchain::sync_manager {
   using Tipset = primitives::tipset::Tipset;
 
@@ -13,110 +15,178 @@ namespace fc::blockchain::sync_manager {
       return;
     }
 
-    SyncTargetBucket b;
-    b.tipsets.resize(tipsets.size());
-    for (auto &t : tipsets) {
-      b.tipsets.push_back(t);
-    }
-    buckets_.push_back(std::move(b));
+    append(SyncTargetBucket{{tipsets.begin(), tipsets.end()}});
   }
 
   SyncBucketSet::SyncBucketSet(std::vector<Tipset> tipsets) {
     if (!tipsets.empty()) {
-      buckets_.emplace_back(SyncTargetBucket{std::move(tipsets)});
+      append(SyncTargetBucket{std::move(tipsets)});
     }
   }
 
-  outcome::result<bool> SyncBucketSet::isRelatedToAny(const Tipset &ts) const {
-    for (auto &b : buckets_) {
-      OUTCOME_TRY(res, b.isSameChain(ts));
-      if (res) {
-        return true;
-      }
+  outcome::result<boost::optional<size_t>> SyncBucketSet::findRelated(
+      const Tipset &ts) const {
+    OUTCOME_TRY(key, ts.makeKey());
+    auto it = by_key_.find(key);
+    if (it != by_key_.end()) {
+      return it->second;
     }
-
-    return false;
+    auto child = by_parents_.find(key);
+    if (child != by_parents_.end()) {
+      return child->second;
+    }
+    OUTCOME_TRY(parents, ts.getParents());
+    it = by_key_.find(parents);
+    if (it != by_key_.end()) {
+      return it->second;
+    }
+    return boost::none;
   }
 
-  void SyncBucketSet::insert(Tipset ts) {
-    for (auto &b : buckets_)
-      if (b.isSameChain(ts)) {
-        return b.addTipset(ts);
+  outcome::result<void> SyncBucketSet::index(const Tipset &ts,
+                                             size_t bucket) {
+    OUTCOME_TRY(key, ts.makeKey());
+    OUTCOME_TRY(parents, ts.getParents());
+    by_key_.emplace(std::move(key), bucket);
+    by_parents_.emplace(std::move(parents), bucket);
+    auto weight = ts.getParentWeight();
+    auto &current = weights_[bucket];
+    if (!current || weight > *current) {
+      if (current) {
+        by_weight_.erase({*current, bucket});
       }
-
-    buckets_.emplace_back(SyncTargetBucket{{ts}});
+      by_weight_.emplace(weight, bucket);
+      current = std::move(weight);
+    }
+    return outcome::success();
   }
 
-  void SyncBucketSet::append(SyncTargetBucket bucket) {
-    buckets_.push_back(std::move(bucket));
+  outcome::result<void> SyncBucketSet::erase(size_t bucket) {
+    for (auto &ts : buckets_[bucket].tipsets) {
+      OUTCOME_TRY(key, ts.makeKey());
+      OUTCOME_TRY(parents, ts.getParents());
+      auto it = by_key_.find(key);
+      if (it != by_key_.end() && it->second == bucket) {
+        by_key_.erase(it);
+      }
+      auto range = by_parents_.equal_range(parents);
+      for (auto child = range.first; child != range.second;) {
+        child = child->second == bucket ? by_parents_.erase(child)
+                                        : std::next(child);
+      }
+    }
+    if (weights_[bucket]) {
+      by_weight_.erase({*weights_[bucket], bucket});
+    }
+    auto last = buckets_.size() - 1;
+    if (bucket != last) {
+      OUTCOME_TRY(reindex(last, bucket));
+      buckets_[bucket] = std::move(buckets_[last]);
+      weights_[bucket] = std::move(weights_[last]);
+    }
+    buckets_.pop_back();
+    weights_.pop_back();
+    return outcome::success();
   }
 
-  boost::optional<SyncTargetBucket> SyncBucketSet::pop() {
-    boost::optional<SyncTargetBucket> best_bucket;
-    boost::optional<Tipset> best_tipset;
-    for (auto &b : buckets_) {
-      auto heaviest = b.getHeaviestTipset();
-      if (boost::none == heaviest) {
-        continue;
+  outcome::result<void> SyncBucketSet::reindex(size_t from, size_t to) {
+    for (auto &ts : buckets_[from].tipsets) {
+      OUTCOME_TRY(key, ts.makeKey());
+      OUTCOME_TRY(parents, ts.getParents());
+      auto it = by_key_.find(key);
+      if (it != by_key_.end() && it->second == from) {
+        it->second = to;
       }
-
-      if (!best_bucket.is_initialized()
-          || best_tipset->getParentWeight()
-                 < heaviest->getParentWeight()) {
-        best_bucket = b;
-        best_tipset = heaviest;
+      auto range = by_parents_.equal_range(parents);
+      for (auto child = range.first; child != range.second; ++child) {
+        if (child->second == from) {
+          child->second = to;
+        }
       }
     }
-
-    if (boost::none != best_bucket) {
-      removeBucket(*best_bucket);
+    if (weights_[from]) {
+      by_weight_.erase({*weights_[from], from});
+      by_weight_.emplace(*weights_[from], to);
     }
-
-    return best_bucket;
+    return outcome::success();
   }
 
-  void SyncBucketSet::removeBucket(const SyncTargetBucket &b) {
-    auto end = std::remove_if(buckets_.begin(),
-                              buckets_.end(),
-                              [&](const auto &item) { return item == b; });
-    buckets_.erase(end, buckets_.end());
+  outcome::result<bool> SyncBucketSet::isRelatedToAny(const Tipset &ts) const {
+    OUTCOME_TRY(bucket, findRelated(ts));
+    return bucket.has_value();
   }
 
-  outcome::result<boost::optional<SyncTargetBucket>> SyncBucketSet::popRelated(
-      const Tipset &ts) {
-    for (auto &b : buckets_) {
-      OUTCOME_TRY(res, b.isSameChain(ts));
-      if (!res) {
-        continue;
+  void SyncBucketSet::insert(Tipset ts) {
+    auto related = findRelated(ts);
+    if (related && related.value()) {
+      auto &bucket = buckets_[*related.value()];
+      auto size = bucket.getSize();
+      bucket.addTipset(ts);
+      if (bucket.getSize() != size) {
+        std::ignore = index(bucket.tipsets.back(), *related.value());
       }
+      return;
+    }
 
-      auto bucket = b;
-      removeBucket(b);
+    buckets_.emplace_back(SyncTargetBucket{{std::move(ts)}});
+    weights_.emplace_back();
+    std::ignore = index(buckets_.back().tipsets[0], buckets_.size() - 1);
+  }
 
-      return bucket;
+  void SyncBucketSet::append(SyncTargetBucket bucket) {
+    buckets_.push_back(std::move(bucket));
+    weights_.emplace_back();
+    for (auto &ts : buckets_.back().tipsets) {
+      std::ignore = index(ts, buckets_.size() - 1);
     }
+  }
 
-    return boost::none;
+  boost::optional<SyncTargetBucket> SyncBucketSet::pop() {
+    if (by_weight_.empty()) {
+      return boost::none;
+    }
+    auto index = by_weight_.begin()->second;
+    auto bucket = std::move(buckets_[index]);
+    std::ignore = erase(index);
+    return bucket;
   }
 
-  outcome::result<Tipset> SyncBucketSet::getHeaviestTipset() const {
-    boost::optional<Tipset> heaviest;
-    for (auto &b : buckets_) {
-      auto ts = b.getHeaviestTipset();
-      if (boost::none == ts) {
-        continue;
+  void SyncBucketSet::removeBucket(const SyncTargetBucket &b) {
+    boost::optional<size_t> index;
+    if (!b.tipsets.empty()) {
+      if (auto key = b.tipsets[0].makeKey()) {
+        auto it = by_key_.find(key.value());
+        if (it != by_key_.end() && buckets_[it->second] == b) {
+          index = it->second;
+        }
       }
-
-      if (heaviest == boost::none
-          || ts->getParentWeight() > heaviest->getParentWeight())
-        heaviest = ts;
     }
+    if (!index) {
+      auto it = std::find(buckets_.begin(), buckets_.end(), b);
+      if (it == buckets_.end()) {
+        return;
+      }
+      index = it - buckets_.begin();
+    }
+    std::ignore = erase(*index);
+  }
 
-    if (heaviest) {
-      return *heaviest;
+  outcome::result<boost::optional<SyncTargetBucket>> SyncBucketSet::popRelated(
+      const Tipset &ts) {
+    OUTCOME_TRY(related, findRelated(ts));
+    if (!related) {
+      return boost::none;
     }
+    auto bucket = std::move(buckets_[*related]);
+    OUTCOME_TRY(erase(*related));
+    return std::move(bucket);
+  }
 
-    return SyncBucketSetError::BUCKET_NOT_FOUND;
+  outcome::result<Tipset> SyncBucketSet::getHeaviestTipset() const {
+    if (by_weight_.empty()) {
+      return SyncBucketSetError::BUCKET_NOT_FOUND;
+    }
+    return *buckets_[by_weight_.begin()->second].getHeaviestTipset();
   }
 
   bool SyncBucketSet::isEmpty() const {
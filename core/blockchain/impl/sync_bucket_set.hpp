@@ -9,14 +9,24 @@
 #include "blockchain/impl/sync_target_bucket.hpp"
 #include "common/outcome.hpp"
 
+#include <set>
+#include <unordered_map>
+
 namespace fc::blockchain::sync_manager {
 
   enum class SyncBucketSetError { BUCKET_NOT_FOUND = 1 };
 
-  /** @brief keeps and updates set of chains */
+  /**
+   * @brief keeps and updates set of chains.
+   * Buckets are indexed by keys and parent keys of their tipsets, so
+   * related bucket is found without scanning all tipsets, and ordered by
+   * weight of their heaviest tipsets.
+   */
   class SyncBucketSet {
    public:
+    using BigInt = primitives::BigInt;
     using Tipset = primitives::tipset::Tipset;
+    using TipsetKey = primitives::tipset::TipsetKey;
 
     /** @brief constructors */
     explicit SyncBucketSet(gsl::span<const Tipset> tipsets);
@@ -52,6 +62,36 @@ namespace fc::blockchain::sync_manager {
 
    protected:
     std::vector<SyncTargetBucket> buckets_;
+
+   private:
+    /// Heavier first, earlier bucket first among equal
+    struct HeavierFirst {
+      bool operator()(const std::pair<BigInt, size_t> &l,
+                      const std::pair<BigInt, size_t> &r) const {
+        return l.first != r.first ? l.first > r.first : l.second < r.second;
+      }
+    };
+
+    /// Finds bucket with equal tipset, its parent or child
+    outcome::result<boost::optional<size_t>> findRelated(
+        const Tipset &ts) const;
+
+    /// Indexes tipset added to bucket, updates bucket weight
+    outcome::result<void> index(const Tipset &ts, size_t bucket);
+
+    /// Removes bucket from indexes, last bucket takes its place
+    outcome::result<void> erase(size_t bucket);
+
+    /// Moves bucket to other index within indexes
+    outcome::result<void> reindex(size_t from, size_t to);
+
+    /// Bucket of tipset key
+    std::unordered_map<TipsetKey, size_t> by_key_;
+    /// Buckets with tipsets which have parent key
+    std::unordered_multimap<TipsetKey, size_t> by_parents_;
+    /// Weight of heaviest tipset of non-empty buckets
+    std::vector<boost::optional<BigInt>> weights_;
+    std::set<std::pair<BigInt, size_t>, HeavierFirst> by_weight_;
   };
 }  // namespace fc::blockchain::sync_manager
 
@@ -41,7 +41,7 @@ namespace fc::blockchain::sync_manager {
   size_t SyncManagerImpl::syncedPeerCount() const {
     size_t count = 0;
     for (auto &[_, ts] : peer_heads_) {
-      if (ts.height > 0) ++count;
+      if (ts->height > 0) ++count;
     }
 
     return count;
@@ -51,7 +51,7 @@ namespace fc::blockchain::sync_manager {
     SyncBucketSet buckets(std::vector<Tipset>{});
     std::vector<Tipset> peer_heads;
     for (auto &[_, ts] : peer_heads_) {
-      peer_heads.push_back(ts);
+      peer_heads.push_back(*ts);
     }
 
     std::sort(peer_heads.begin(),
@@ -77,10 +77,10 @@ namespace fc::blockchain::sync_manager {
       setBootstrapState(BootstrapState::STATE_COMPLETE);
     }
 
-    OUTCOME_TRY(key, result.tipset.makeKey());
+    OUTCOME_TRY(key, result.tipset->makeKey());
     active_syncs_.erase(key);
 
-    OUTCOME_TRY(related_bucket, active_sync_tips_.popRelated(result.tipset));
+    OUTCOME_TRY(related_bucket, active_sync_tips_.popRelated(*result.tipset));
     if (related_bucket != boost::none) {
       if (result.success) {
         if (boost::none == next_sync_target_) {
@@ -89,7 +89,8 @@ namespace fc::blockchain::sync_manager {
           if (boost::none == heaviest_tipset) {
             return SyncTargetBucketError::BUCKET_IS_EMPTY;
           }
-          OUTCOME_TRY(processSyncTargets(*heaviest_tipset));
+          OUTCOME_TRY(processSyncTargets(
+              std::make_shared<const Tipset>(std::move(*heaviest_tipset))));
         } else {
           sync_queue_.append(*related_bucket);
         }
@@ -110,7 +111,8 @@ namespace fc::blockchain::sync_manager {
         if (boost::none == heaviest_tipset) {
           return SyncTargetBucketError::BUCKET_IS_EMPTY;
         }
-        OUTCOME_TRY(processSyncTargets(*heaviest_tipset));
+        OUTCOME_TRY(processSyncTargets(
+            std::make_shared<const Tipset>(std::move(*heaviest_tipset))));
       }
     }
 
@@ -118,20 +120,20 @@ namespace fc::blockchain::sync_manager {
   }
 
   outcome::result<void> SyncManagerImpl::processIncomingTipset(
-      const Tipset &tipset) {
+      const TipsetCPtr &tipset_ptr) {
+    auto &tipset{*tipset_ptr};
     OUTCOME_TRY(cids_json, codec::json::encodeCidVector(tipset.cids));
     logger_->info("scheduling incoming tipset sync %s", cids_json);
 
     if (getBootstrapState() == BootstrapState::STATE_SELECTED) {
       setBootstrapState(BootstrapState::STATE_SCHEDULED);
-      sync_targets_.push_back(tipset);
+      sync_targets_.push_back(tipset_ptr);
     }
 
     bool is_related_to_active_sync = false;
-    for (auto &[_, acts] : active_syncs_) {
-      if (tipset == acts) break;
+    for (auto &[key, acts] : active_syncs_) {
+      if (tipset_ptr == acts || tipset == *acts) break;
       OUTCOME_TRY(parents, tipset.getParents());
-      OUTCOME_TRY(key, acts.makeKey());
       if (parents == key) {
         is_related_to_active_sync = true;
         break;
@@ -160,7 +162,8 @@ namespace fc::blockchain::sync_manager {
         if (boost::none == heaviest_tipset) {
           return SyncTargetBucketError::BUCKET_IS_EMPTY;
         }
-        OUTCOME_TRY(processSyncTargets(*heaviest_tipset));
+        OUTCOME_TRY(processSyncTargets(
+            std::make_shared<const Tipset>(std::move(*heaviest_tipset))));
       }
     }
 
@@ -172,7 +175,7 @@ namespace fc::blockchain::sync_manager {
       auto &&ts = std::move(sync_targets_.front());
       sync_targets_.pop_front();
       // do external sync
-      auto &&res = sync_function_(ts);
+      auto &&res = sync_function_(*ts);
       if (!res) {
         logger_->error("sync error %s", res.error().message());
       }
@@ -187,9 +190,9 @@ namespace fc::blockchain::sync_manager {
   }
 
   // worker
-  outcome::result<void> SyncManagerImpl::processSyncTargets(Tipset ts) {
+  outcome::result<void> SyncManagerImpl::processSyncTargets(TipsetCPtr ts) {
     // schedule work sent
-    OUTCOME_TRY(key, ts.makeKey());
+    OUTCOME_TRY(key, ts->makeKey());
     active_syncs_[key] = ts;
     if (!sync_queue_.isEmpty()) {
       next_sync_target_ = sync_queue_.pop();
@@ -203,7 +206,8 @@ namespace fc::blockchain::sync_manager {
 
   outcome::result<void> SyncManagerImpl::setPeerHead(PeerId peer_id,
                                                      const Tipset &tipset) {
-    peer_heads_[peer_id] = tipset;
+    auto shared{std::make_shared<const Tipset>(tipset)};
+    peer_heads_[peer_id] = shared;
     auto state = state_;
     switch (state) {
       case BootstrapState::STATE_INIT: {
@@ -216,7 +220,8 @@ namespace fc::blockchain::sync_manager {
             return target.error();
           }
           state_ = BootstrapState::STATE_SELECTED;
-          return processIncomingTipset(target.value());
+          return processIncomingTipset(
+              std::make_shared<const Tipset>(std::move(target.value())));
         }
         logger_->info("sync bootstrap has %d peers", synced_count);
         return outcome::success();
@@ -224,7 +229,7 @@ namespace fc::blockchain::sync_manager {
       case BootstrapState::STATE_SELECTED:
       case BootstrapState::STATE_SCHEDULED:
       case BootstrapState::STATE_COMPLETE:
-        return processIncomingTipset(tipset);
+        return processIncomingTipset(shared);
     }
   }
 
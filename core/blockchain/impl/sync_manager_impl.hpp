@@ -26,7 +26,7 @@ namespace fc::blockchain::sync_manager {
   enum class SyncManagerError { SHUTTING_DOWN = 1, NO_SYNC_TARGET };
 
   struct SyncResult {
-    primitives::tipset::Tipset tipset;
+    primitives::tipset::TipsetCPtr tipset;
     outcome::result<void> success;
   };
 
@@ -35,6 +35,7 @@ namespace fc::blockchain::sync_manager {
    public:
     const static size_t kBootstrapThresholdDefault = 1;
 
+    using TipsetCPtr = primitives::tipset::TipsetCPtr;
     using TipsetKey = primitives::tipset::TipsetKey;
 
     SyncManagerImpl(boost::asio::io_context &context,
@@ -54,22 +55,23 @@ namespace fc::blockchain::sync_manager {
     bool isBootstrapped() const;
 
    private:
-    outcome::result<void> processIncomingTipset(const Tipset &tipset);
+    outcome::result<void> processIncomingTipset(const TipsetCPtr &tipset);
 
     outcome::result<Tipset> selectSyncTarget();
 
-    outcome::result<void> processSyncTargets(Tipset ts);
+    outcome::result<void> processSyncTargets(TipsetCPtr ts);
 
     outcome::result<void> doSync();
 
     outcome::result<void> processResult(const SyncResult &result);
-    std::unordered_map<PeerId, Tipset> peer_heads_;
+    /// Tipsets are shared, peers with same head keep one copy of blocks
+    std::unordered_map<PeerId, TipsetCPtr> peer_heads_;
     BootstrapState state_;
     const uint64_t bootstrap_threshold_{kBootstrapThresholdDefault};
-    std::deque<Tipset> sync_targets_;
+    std::deque<TipsetCPtr> sync_targets_;
     std::deque<SyncResult> sync_results_;
-    std::deque<Tipset> incoming_tipsets_;
-    std::unordered_map<TipsetKey, Tipset> active_syncs_;
+    std::deque<TipsetCPtr> incoming_tipsets_;
+    std::unordered_map<TipsetKey, TipsetCPtr> active_syncs_;
     boost::optional<SyncTargetBucket> next_sync_target_;
     SyncBucketSet sync_queue_{gsl::span<Tipset>{}};
     SyncBucketSet active_sync_tips_{gsl::span<Tipset>{}};
@@ -0,0 +1,369 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/impl/sync_pipeline.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+
+#include <boost/asio/post.hpp>
+#include <boost/optional.hpp>
+
+namespace fc::blockchain::sync_manager {
+  namespace {
+    /**
+     * Checks that tipsets go from head to parents
+     */
+    outcome::result<void> checkLinked(const std::vector<Tipset> &tipsets,
+                                      const TipsetKey &head) {
+      if (tipsets.empty()) {
+        return SyncPipelineError::EMPTY_RESPONSE;
+      }
+      auto expected = head;
+      for (auto &tipset : tipsets) {
+        if (tipset.blks.empty() || tipset.cids != expected.cids) {
+          return SyncPipelineError::UNLINKED_HEADERS;
+        }
+        OUTCOME_TRYA(expected, tipset.getParents());
+      }
+      return outcome::success();
+    }
+
+    /**
+     * Commits pushed tipsets on pool, one batch at a time. Tipsets pushed
+     * while batch is committed form next batch.
+     */
+    class Committer {
+     public:
+      Committer(boost::asio::thread_pool &pool,
+                const SyncPipeline::CommitFunction &commit,
+                size_t max_batch)
+          : pool_{pool}, commit_{commit}, max_batch_{max_batch} {}
+
+      /// Waits for running batch, tasks must not outlive committer
+      ~Committer() {
+        std::unique_lock lock{mutex_};
+        idle_.wait(lock, [&] { return !running_; });
+      }
+
+      void push(const Tipset &tipset) {
+        std::lock_guard lock{mutex_};
+        queue_.push_back(tipset);
+        if (!running_) {
+          running_ = true;
+          boost::asio::post(pool_, [this] { run(); });
+        }
+      }
+
+      bool failed() const {
+        std::lock_guard lock{mutex_};
+        return result_.has_error();
+      }
+
+      /// Waits until queue is committed, returns first error
+      outcome::result<void> finish() {
+        std::unique_lock lock{mutex_};
+        idle_.wait(lock, [&] { return !running_; });
+        return result_;
+      }
+
+     private:
+      void run() {
+        while (true) {
+          std::vector<Tipset> batch;
+          {
+            std::lock_guard lock{mutex_};
+            if (queue_.empty() || result_.has_error()) {
+              queue_.clear();
+              running_ = false;
+              idle_.notify_all();
+              return;
+            }
+            auto size{std::min(queue_.size(), max_batch_)};
+            batch.assign(std::make_move_iterator(queue_.begin()),
+                         std::make_move_iterator(queue_.begin() + size));
+            queue_.erase(queue_.begin(), queue_.begin() + size);
+          }
+          auto committed{commit_(batch)};
+          if (!committed) {
+            std::lock_guard lock{mutex_};
+            result_ = committed.error();
+          }
+        }
+      }
+
+      boost::asio::thread_pool &pool_;
+      const SyncPipeline::CommitFunction &commit_;
+      size_t max_batch_;
+      mutable std::mutex mutex_;
+      std::condition_variable idle_;
+      std::deque<Tipset> queue_;
+      bool running_{false};
+      outcome::result<void> result_{outcome::success()};
+    };
+  }  // namespace
+
+  SyncPipeline::SyncPipeline(std::shared_ptr<ChainFetcher> fetcher,
+                             KnownFunction known,
+                             ApplyFunction apply,
+                             SyncPipelineConfig config)
+      : SyncPipeline{std::move(fetcher),
+                     std::move(known),
+                     Stages{{}, std::move(apply), {}},
+                     config} {}
+
+  SyncPipeline::SyncPipeline(std::shared_ptr<ChainFetcher> fetcher,
+                             KnownFunction known,
+                             Stages stages,
+                             SyncPipelineConfig config)
+      : fetcher_{std::move(fetcher)},
+        known_{std::move(known)},
+        stages_{std::move(stages)},
+        config_{config},
+        pool_{std::max<size_t>(config.threads, 1)},
+        logger_{common::createLogger("SyncPipeline")} {
+    config_.header_window = std::max<size_t>(config_.header_window, 1);
+    config_.header_fanout = std::max<size_t>(config_.header_fanout, 1);
+    config_.message_window = std::max<size_t>(config_.message_window, 1);
+    config_.commit_batch = std::max<size_t>(config_.commit_batch, 1);
+  }
+
+  SyncPipeline::~SyncPipeline() {
+    pool_.join();
+  }
+
+  void SyncPipeline::addPeer(const PeerId &peer) {
+    std::lock_guard lock{peers_mutex_};
+    if (std::find(peers_.begin(), peers_.end(), peer) == peers_.end()) {
+      peers_.push_back(peer);
+    }
+  }
+
+  void SyncPipeline::removePeer(const PeerId &peer) {
+    std::lock_guard lock{peers_mutex_};
+    auto it = std::find(peers_.begin(), peers_.end(), peer);
+    if (it != peers_.end()) {
+      peers_.erase(it);
+    }
+  }
+
+  outcome::result<void> SyncPipeline::sync(const Tipset &target) {
+    Peers peers;
+    {
+      std::lock_guard lock{peers_mutex_};
+      peers = peers_;
+    }
+    if (peers.empty()) {
+      return SyncPipelineError::NO_PEERS;
+    }
+
+    // descending by height, starting with target
+    std::vector<Tipset> headers{target};
+    // message windows, each covers headers[begin, begin + size)
+    std::vector<std::pair<size_t, std::future<outcome::result<void>>>>
+        windows;
+    size_t next_peer{0};
+    size_t scheduled{0};
+    auto schedule = [&] {
+      while (scheduled < headers.size()) {
+        auto end =
+            std::min(headers.size(), scheduled + config_.message_window);
+        std::vector<Tipset> tipsets{headers.begin() + scheduled,
+                                    headers.begin() + end};
+        windows.emplace_back(
+            scheduled, fetchMessages(peers, next_peer++, std::move(tipsets)));
+        scheduled = end;
+      }
+    };
+
+    OUTCOME_TRY(cursor, target.getParents());
+    while (true) {
+      OUTCOME_TRY(known, known_(cursor));
+      if (known || headers.back().height == 0) {
+        break;
+      }
+      OUTCOME_TRY(window, fetchHeaders(peers, next_peer, cursor));
+      next_peer += config_.header_fanout;
+      auto reached_known{false};
+      for (auto &tipset : window) {
+        if (&tipset != &window.front()) {
+          OUTCOME_TRY(key, tipset.makeKey());
+          OUTCOME_TRYA(reached_known, known_(key));
+          if (reached_known) {
+            break;
+          }
+        }
+        headers.push_back(std::move(tipset));
+      }
+      // messages are fetched while next headers are requested
+      schedule();
+      if (reached_known) {
+        break;
+      }
+      OUTCOME_TRYA(cursor, headers.back().getParents());
+    }
+    schedule();
+    logger_->info("fetched {} headers down to height {}",
+                  headers.size(),
+                  headers.back().height);
+
+    return process(headers, windows);
+  }
+
+  outcome::result<void> SyncPipeline::process(
+      const std::vector<Tipset> &headers,
+      std::vector<std::pair<size_t, std::future<outcome::result<void>>>>
+          &windows) {
+    outcome::result<void> result{outcome::success()};
+    Committer committer{pool_, stages_.commit, config_.commit_batch};
+    // header indices with validation results, ascending by height
+    std::deque<std::pair<size_t, std::future<outcome::result<void>>>>
+        validating;
+    auto validate = [&](size_t i) {
+      std::packaged_task<outcome::result<void>()> task{
+          [this, &tipset{headers[i]}]() -> outcome::result<void> {
+            if (stages_.validate) {
+              return stages_.validate(tipset);
+            }
+            return outcome::success();
+          }};
+      auto future = task.get_future();
+      boost::asio::post(pool_, std::move(task));
+      validating.emplace_back(i, std::move(future));
+    };
+    auto execute = [&] {
+      auto [i, validated] = std::move(validating.front());
+      validating.pop_front();
+      auto valid = validated.get();
+      if (!result) {
+        return;
+      }
+      if (!valid) {
+        result = valid.error();
+        return;
+      }
+      if (committer.failed()) {
+        result = committer.finish();
+        return;
+      }
+      if (auto executed = stages_.execute(headers[i]); !executed) {
+        result = executed.error();
+        return;
+      }
+      if (stages_.commit) {
+        committer.push(headers[i]);
+      }
+    };
+
+    // process from the lowest window up, as soon as its messages arrive
+    for (auto window = windows.rbegin(); window != windows.rend(); ++window) {
+      // validated tipsets are executed while messages are fetched
+      while (!validating.empty()
+             && window->second.wait_for(std::chrono::seconds{0})
+                    != std::future_status::ready) {
+        execute();
+      }
+      auto fetched = window->second.get();
+      if (!result) {
+        continue;
+      }
+      if (!fetched) {
+        result = fetched.error();
+        continue;
+      }
+      auto begin = window->first;
+      auto end = std::min(headers.size(), begin + config_.message_window);
+      for (auto i = end; i != begin && result; --i) {
+        validate(i - 1);
+        if (validating.size() > config_.validate_ahead) {
+          execute();
+        }
+      }
+    }
+    while (!validating.empty()) {
+      execute();
+    }
+    auto committed = committer.finish();
+    if (result && !committed) {
+      result = committed.error();
+    }
+    return result;
+  }
+
+  outcome::result<std::vector<Tipset>> SyncPipeline::fetchHeaders(
+      const Peers &peers, size_t first_peer, const TipsetKey &head) {
+    struct Race {
+      std::mutex mutex;
+      std::condition_variable done;
+      size_t pending;
+      boost::optional<outcome::result<std::vector<Tipset>>> result;
+    };
+    auto fanout = std::min(config_.header_fanout, peers.size());
+    auto race = std::make_shared<Race>();
+    race->pending = fanout;
+    auto fetch = [race, fetcher{fetcher_}, head, count{config_.header_window}](
+                     const PeerId &peer) {
+      auto fetched = fetcher->fetchHeaders(peer, head, count);
+      if (fetched) {
+        auto linked = checkLinked(fetched.value(), head);
+        if (!linked) {
+          fetched = linked.error();
+        }
+      }
+      std::lock_guard lock{race->mutex};
+      --race->pending;
+      if (!race->result && (fetched || race->pending == 0)) {
+        race->result = std::move(fetched);
+      }
+      race->done.notify_all();
+    };
+    for (size_t i = 0; i < fanout; ++i) {
+      boost::asio::post(
+          pool_,
+          [fetch, peer{peers[(first_peer + i) % peers.size()]}] {
+            fetch(peer);
+          });
+    }
+    std::unique_lock lock{race->mutex};
+    race->done.wait(lock, [&] { return race->result.has_value(); });
+    return std::move(*race->result);
+  }
+
+  std::future<outcome::result<void>> SyncPipeline::fetchMessages(
+      const Peers &peers, size_t first_peer, std::vector<Tipset> tipsets) {
+    std::packaged_task<outcome::result<void>()> task{
+        [fetcher{fetcher_}, peers, first_peer, tipsets{std::move(tipsets)}]()
+            -> outcome::result<void> {
+          outcome::result<void> result{SyncPipelineError::NO_PEERS};
+          for (size_t i = 0; i < peers.size(); ++i) {
+            result = fetcher->fetchMessages(
+                peers[(first_peer + i) % peers.size()], tipsets);
+            if (result) {
+              break;
+            }
+          }
+          return result;
+        }};
+    auto future = task.get_future();
+    boost::asio::post(pool_, std::move(task));
+    return future;
+  }
+}  // namespace fc::blockchain::sync_manager
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::sync_manager,
+                            SyncPipelineError,
+                            e) {
+  using fc::blockchain::sync_manager::SyncPipelineError;
+  switch (e) {
+    case SyncPipelineError::NO_PEERS:
+      return "SyncPipelineError: no peers to sync from";
+    case SyncPipelineError::EMPTY_RESPONSE:
+      return "SyncPipelineError: peer returned no tipsets";
+    case SyncPipelineError::UNLINKED_HEADERS:
+      return "SyncPipelineError: peer returned unlinked tipsets";
+  }
+  return "unknown error";
+}
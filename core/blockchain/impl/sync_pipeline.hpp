@@ -0,0 +1,167 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_SYNC_PIPELINE_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_SYNC_PIPELINE_HPP
+
+#include <functional>
+#include <future>
+#include <mutex>
+
+#include <boost/asio/thread_pool.hpp>
+#include <libp2p/peer/peer_id.hpp>
+#include "common/logger.hpp"
+#include "common/outcome.hpp"
+#include "primitives/tipset/tipset.hpp"
+
+namespace fc::blockchain::sync_manager {
+  using libp2p::peer::PeerId;
+  using primitives::tipset::Tipset;
+  using primitives::tipset::TipsetKey;
+
+  enum class SyncPipelineError {
+    NO_PEERS = 1,
+    EMPTY_RESPONSE,
+    UNLINKED_HEADERS,
+  };
+
+  /**
+   * Network side of chain sync
+   */
+  class ChainFetcher {
+   public:
+    virtual ~ChainFetcher() = default;
+
+    /**
+     * Fetch tipset headers going back from head
+     * @param peer - peer to request
+     * @param head - key of the first tipset
+     * @param count - max number of tipsets
+     * @return head tipset followed by its ancestors
+     */
+    virtual outcome::result<std::vector<Tipset>> fetchHeaders(
+        const PeerId &peer, const TipsetKey &head, size_t count) = 0;
+
+    /**
+     * Fetch and store messages of tipsets
+     * @param peer - peer to request
+     * @param tipsets - tipsets to fetch messages of
+     */
+    virtual outcome::result<void> fetchMessages(
+        const PeerId &peer, gsl::span<const Tipset> tipsets) = 0;
+  };
+
+  struct SyncPipelineConfig {
+    /// Tipsets requested in one header request
+    size_t header_window{500};
+    /// Peers asked for the same header window, the first response wins
+    size_t header_fanout{2};
+    /// Tipsets requested in one message request
+    size_t message_window{50};
+    /// Concurrent requests
+    size_t threads{8};
+    /// Tipsets validated ahead of the one being executed
+    size_t validate_ahead{2};
+    /// Max tipsets committed at once
+    size_t commit_batch{16};
+  };
+
+  /**
+   * Syncs chain to target tipset. Headers are fetched back from the target
+   * until known tipset, each window is requested from several peers at
+   * once. Messages of fetched windows are requested from peers in parallel
+   * while earlier headers are still being fetched. Tipsets are processed in
+   * ascending order as their messages arrive, by three overlapping stages:
+   * validation of next tipsets runs on pool while tipset is executed, and
+   * executed tipsets are committed in batches while later ones execute.
+   * Throughput is bound by slowest stage instead of sum of stages.
+   */
+  class SyncPipeline {
+   public:
+    /// Checks whether tipset is already synced
+    using KnownFunction =
+        std::function<outcome::result<bool>(const TipsetKey &)>;
+    /// Validates and interprets tipset with fetched messages
+    using ApplyFunction = std::function<outcome::result<void>(const Tipset &)>;
+    /// Persists executed tipsets, ascending
+    using CommitFunction =
+        std::function<outcome::result<void>(gsl::span<const Tipset>)>;
+
+    struct Stages {
+      /**
+       * Checks not depending on parent state, e.g. syntax and signatures,
+       * runs on pool up to validate_ahead tipsets before execution, may be
+       * empty
+       */
+      ApplyFunction validate;
+      /// Interprets validated tipset after its parent was executed
+      ApplyFunction execute;
+      /**
+       * Commits executed tipsets in order, one batch at a time, may be
+       * empty. Execution doesn't wait for commit, so executed state must
+       * be readable before it is committed
+       */
+      CommitFunction commit;
+    };
+
+    /// Pipeline calling apply sequentially, without stages
+    SyncPipeline(std::shared_ptr<ChainFetcher> fetcher,
+                 KnownFunction known,
+                 ApplyFunction apply,
+                 SyncPipelineConfig config);
+
+    SyncPipeline(std::shared_ptr<ChainFetcher> fetcher,
+                 KnownFunction known,
+                 Stages stages,
+                 SyncPipelineConfig config);
+
+    ~SyncPipeline();
+
+    void addPeer(const PeerId &peer);
+
+    void removePeer(const PeerId &peer);
+
+    /**
+     * Sync chain to target, may be used as SyncFunction
+     * @param target - tipset to sync to
+     */
+    outcome::result<void> sync(const Tipset &target);
+
+   private:
+    using Peers = std::vector<PeerId>;
+
+    /**
+     * Fetch header window from several peers, take first linked response
+     */
+    outcome::result<std::vector<Tipset>> fetchHeaders(const Peers &peers,
+                                                      size_t first_peer,
+                                                      const TipsetKey &head);
+
+    /**
+     * Schedule messages fetch, other peers are tried on failure
+     */
+    std::future<outcome::result<void>> fetchMessages(
+        const Peers &peers, size_t first_peer, std::vector<Tipset> tipsets);
+
+    /// Validates, executes and commits tipsets ascending
+    outcome::result<void> process(
+        const std::vector<Tipset> &headers,
+        std::vector<std::pair<size_t, std::future<outcome::result<void>>>>
+            &windows);
+
+    std::shared_ptr<ChainFetcher> fetcher_;
+    KnownFunction known_;
+    Stages stages_;
+    SyncPipelineConfig config_;
+    mutable std::mutex peers_mutex_;
+    Peers peers_;
+    boost::asio::thread_pool pool_;
+    common::Logger logger_;
+  };
+}  // namespace fc::blockchain::sync_manager
+
+OUTCOME_HPP_DECLARE_ERROR(fc::blockchain::sync_manager, SyncPipelineError);
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_IMPL_SYNC_PIPELINE_HPP
@@ -13,7 +13,7 @@ namespace fc::blockchain::sync_manager {
       OUTCOME_TRY(ts_key, ts.makeKey());
       OUTCOME_TRY(t_key, t.makeKey());
       OUTCOME_TRY(t_parents_key, t.getParents());
-      OUTCOME_TRY(ts_parents_key, t.getParents());
+      OUTCOME_TRY(ts_parents_key, ts.getParents());
 
       if (t == ts) {
         return true;
@@ -5,7 +5,7 @@
 
 #include "blockchain/impl/weight_calculator_impl.hpp"
 
-#include "vm/actor/builtin/storage_power/storage_power_actor_state.hpp"
+#include "vm/actor/actor.hpp"
 #include "vm/state/impl/state_tree_impl.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::weight, WeightCalculatorError, e) {
@@ -19,22 +19,30 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::weight, WeightCalculatorError, e) {
 namespace fc::blockchain::weight {
   using primitives::BigInt;
   using vm::actor::kStoragePowerAddress;
-  using vm::actor::builtin::storage_power::StoragePowerActorState;
   using vm::state::StateTreeImpl;
 
   constexpr uint64_t kWRatioNum{1};
   constexpr uint64_t kWRatioDen{2};
   constexpr uint64_t kBlocksPerEpoch{5};
 
-  WeightCalculatorImpl::WeightCalculatorImpl(std::shared_ptr<Ipld> ipld)
-      : ipld_{std::move(ipld)} {}
+  namespace {
+    /// Leading fields of power actor state, rest is not decoded
+    struct PowerTotals {
+      StoragePower total_raw_power, total_qa_power;
+    };
+    CBOR_DECODE(PowerTotals, totals) {
+      s.list() >> totals.total_raw_power >> totals.total_qa_power;
+      return s;
+    }
+  }  // namespace
+
+  WeightCalculatorImpl::WeightCalculatorImpl(std::shared_ptr<Ipld> ipld,
+                                             size_t cache_capacity)
+      : ipld_{std::move(ipld)}, power_cache_{cache_capacity} {}
 
   outcome::result<BigInt> WeightCalculatorImpl::calculateWeight(
       const Tipset &tipset) {
-    OUTCOME_TRY(state,
-                StateTreeImpl{ipld_, tipset.getParentStateRoot()}
-                    .state<StoragePowerActorState>(kStoragePowerAddress));
-    auto network_power = state.total_qa_power;
+    OUTCOME_TRY(network_power, networkPower(tipset.getParentStateRoot()));
     if (network_power <= 0) {
       return outcome::failure(WeightCalculatorError::NO_NETWORK_POWER);
     }
@@ -44,4 +52,17 @@ namespace fc::blockchain::weight {
                  / (kBlocksPerEpoch * kWRatioDen);
   }
 
+  outcome::result<StoragePower> WeightCalculatorImpl::networkPower(
+      const CID &state_root) {
+    if (auto cached = power_cache_.get(state_root)) {
+      return *cached;
+    }
+    OUTCOME_TRY(actor,
+                StateTreeImpl{ipld_, state_root}.get(kStoragePowerAddress));
+    OUTCOME_TRY(totals, ipld_->getCbor<PowerTotals>(actor.head));
+    power_cache_.put(
+        state_root, std::make_shared<const StoragePower>(totals.total_qa_power));
+    return totals.total_qa_power;
+  }
+
 }  // namespace fc::blockchain::weight
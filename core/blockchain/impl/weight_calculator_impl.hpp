@@ -8,21 +8,35 @@
 
 #include "blockchain/weight_calculator.hpp"
 
+#include "primitives/types.hpp"
 #include "storage/ipfs/datastore.hpp"
+#include "storage/ipld/node_cache.hpp"
 
 namespace fc::blockchain::weight {
+  using primitives::StoragePower;
+
   enum class WeightCalculatorError { NO_NETWORK_POWER = 1 };
 
+  /// Number of parent state roots with network power kept by calculator
+  constexpr size_t kWeightCacheCapacity{1024};
+
   class WeightCalculatorImpl : public WeightCalculator {
    public:
-    explicit WeightCalculatorImpl(std::shared_ptr<Ipld> ipld);
+    explicit WeightCalculatorImpl(
+        std::shared_ptr<Ipld> ipld,
+        size_t cache_capacity = kWeightCacheCapacity);
 
     ~WeightCalculatorImpl() override = default;
 
     outcome::result<BigInt> calculateWeight(const Tipset &tipset) override;
 
    private:
+    /// Network power at state root, decodes only head of power actor state
+    outcome::result<StoragePower> networkPower(const CID &state_root);
+
     std::shared_ptr<Ipld> ipld_;
+    /// Fork choice weighs same parents repeatedly
+    storage::ipld::NodeCache<StoragePower> power_cache_;
   };
 
 }  // namespace fc::blockchain::weight
@@ -5,28 +5,175 @@
 
 #include "blockchain/message_pool/impl/gas_price_scored_message_storage.hpp"
 
+#include <algorithm>
+#include <mutex>
+#include <queue>
+
 #include "blockchain/message_pool/message_pool_error.hpp"
 
 using fc::blockchain::message_pool::GasPriceScoredMessageStorage;
 using fc::blockchain::message_pool::MessagePoolError;
 using fc::vm::message::SignedMessage;
 
+GasPriceScoredMessageStorage::GasPriceScoredMessageStorage(size_t capacity)
+    : capacity_{capacity},
+      size_metric_{fc::common::metrics::registry().gauge(
+          "fc_mpool_messages", "Pending messages in message pool")} {}
+
+bool GasPriceScoredMessageStorage::ScoreLess::operator()(
+    const Score &lhs, const Score &rhs) const {
+  if (lhs.gas_price != rhs.gas_price) {
+    return lhs.gas_price > rhs.gas_price;
+  }
+  if (lhs.from != rhs.from) {
+    return lhs.from < rhs.from;
+  }
+  return lhs.nonce < rhs.nonce;
+}
+
+GasPriceScoredMessageStorage::Score GasPriceScoredMessageStorage::score(
+    const SignedMessage &message) {
+  return {
+      message.message.gasPrice, message.message.from, message.message.nonce};
+}
+
 fc::outcome::result<void> GasPriceScoredMessageStorage::put(
     const SignedMessage &message) {
-  auto res = messages_.insert(message);
-  if (!res.second) return MessagePoolError::MESSAGE_ALREADY_IN_POOL;
+  std::unique_lock lock{mutex_};
+  auto chain = chains_.find(message.message.from);
+  if (chain != chains_.end()
+      && chain->second.count(message.message.nonce) != 0) {
+    return MessagePoolError::MESSAGE_ALREADY_IN_POOL;
+  }
+  // message after nonce gap left by eviction can not be selected
+  auto gap = evicted_.find(message.message.from);
+  if (gap != evicted_.end() && message.message.nonce > gap->second) {
+    return MessagePoolError::MESSAGE_POOL_FULL;
+  }
+  if (scores_.size() >= capacity_) {
+    if (scores_.empty()
+        || message.message.gasPrice <= scores_.rbegin()->gas_price) {
+      return MessagePoolError::MESSAGE_POOL_FULL;
+    }
+    // later messages of sender can not be selected without evicted one
+    auto cheapest = *scores_.rbegin();
+    if (cheapest.from == message.message.from
+        && cheapest.nonce < message.message.nonce) {
+      return MessagePoolError::MESSAGE_POOL_FULL;
+    }
+    auto &evicted = chains_.at(cheapest.from);
+    std::vector<Score> suffix;
+    for (auto it = evicted.find(cheapest.nonce); it != evicted.end(); ++it) {
+      suffix.push_back(score(it->second));
+    }
+    for (auto &entry : suffix) {
+      erase(entry);
+    }
+    auto [marker, inserted] = evicted_.emplace(cheapest.from, cheapest.nonce);
+    if (!inserted) {
+      marker->second = std::min(marker->second, cheapest.nonce);
+    } else if (evicted_.size() > capacity_) {
+      evicted_.erase(marker == evicted_.begin() ? std::next(marker)
+                                                : evicted_.begin());
+    }
+  }
+  chains_[message.message.from].emplace(message.message.nonce, message);
+  scores_.insert(score(message));
+  // resubmitted evicted message closes the gap
+  gap = evicted_.find(message.message.from);
+  if (gap != evicted_.end() && message.message.nonce == gap->second) {
+    evicted_.erase(gap);
+  }
+  size_metric_.set(scores_.size());
   return fc::outcome::success();
 }
 
 void GasPriceScoredMessageStorage::remove(const SignedMessage &message) {
-  messages_.erase(message);
+  std::unique_lock lock{mutex_};
+  // evicted message was included, later nonces are selectable again
+  auto gap = evicted_.find(message.message.from);
+  if (gap != evicted_.end() && message.message.nonce >= gap->second) {
+    evicted_.erase(gap);
+  }
+  auto chain = chains_.find(message.message.from);
+  if (chain == chains_.end()) {
+    return;
+  }
+  auto stored = chain->second.find(message.message.nonce);
+  if (stored == chain->second.end()) {
+    return;
+  }
+  erase(score(stored->second));
+  size_metric_.set(scores_.size());
 }
 
 std::vector<SignedMessage> GasPriceScoredMessageStorage::getTopScored(
     size_t n) const {
-  std::set<SignedMessage, decltype(compareGasFunctor)> score(
-      messages_.begin(), messages_.end(), compareGasFunctor);
-  return std::vector<SignedMessage>(
-      score.begin(),
-      (n < score.size()) ? std::next(score.begin(), n) : score.end());
+  std::shared_lock lock{mutex_};
+  std::vector<SignedMessage> top;
+  top.reserve(std::min(n, scores_.size()));
+  for (auto it = scores_.begin(); it != scores_.end() && top.size() < n;
+       ++it) {
+    top.push_back(chains_.at(it->from).at(it->nonce));
+  }
+  return top;
+}
+
+std::vector<SignedMessage> GasPriceScoredMessageStorage::selectMessages(
+    size_t n) const {
+  std::vector<SignedMessage> selected;
+  if (n == 0) {
+    return selected;
+  }
+  visitSelection([&](auto &message) {
+    selected.push_back(message);
+    return selected.size() < n ? SelectionStep::NEXT : SelectionStep::STOP;
+  });
+  return selected;
+}
+
+void GasPriceScoredMessageStorage::visitSelection(
+    const SelectionVisitor &visitor) const {
+  using Cursor = std::pair<Chain::const_iterator, Chain::const_iterator>;
+  auto cheaper = [](const Cursor &lhs, const Cursor &rhs) {
+    return ScoreLess{}(score(rhs.first->second), score(lhs.first->second));
+  };
+
+  std::shared_lock lock{mutex_};
+  // heads of sender chains, next message of sender becomes selectable only
+  // after previous one is selected
+  std::priority_queue<Cursor, std::vector<Cursor>, decltype(cheaper)> heads{
+      cheaper};
+  for (auto &chain : chains_) {
+    heads.emplace(chain.second.begin(), chain.second.end());
+  }
+  while (!heads.empty()) {
+    auto [it, end] = heads.top();
+    heads.pop();
+    auto step = visitor(it->second);
+    if (step == SelectionStep::STOP) {
+      break;
+    }
+    if (step == SelectionStep::SKIP_SENDER) {
+      continue;
+    }
+    auto next = std::next(it);
+    if (next != end && next->first == it->first + 1) {
+      heads.emplace(next, end);
+    }
+  }
+}
+
+size_t GasPriceScoredMessageStorage::size() const {
+  std::shared_lock lock{mutex_};
+  return scores_.size();
+}
+
+void GasPriceScoredMessageStorage::erase(const Score &entry) {
+  auto chain = chains_.find(entry.from);
+  chain->second.erase(entry.nonce);
+  if (chain->second.empty()) {
+    chains_.erase(chain);
+  }
+  scores_.erase(entry);
 }
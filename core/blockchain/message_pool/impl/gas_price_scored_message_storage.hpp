@@ -6,41 +6,48 @@
 #ifndef CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_GAS_PRICE_SCORED_MESSAGE_STORAGE_HPP
 #define CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_GAS_PRICE_SCORED_MESSAGE_STORAGE_HPP
 
+#include <map>
+#include <set>
+#include <shared_mutex>
+
 #include "blockchain/message_pool/message_storage.hpp"
+#include "common/metrics.hpp"
 
 namespace fc::blockchain::message_pool {
 
+  using primitives::BigInt;
   using primitives::address::Address;
   using vm::message::SignedMessage;
 
-  /**
-   * Compare messages by sender address and nonce
-   */
-  auto compareMessagesFunctor = [](const SignedMessage &lhs,
-                                   const SignedMessage &rhs) {
-    return (lhs.message.from < rhs.message.from)
-           || ((lhs.message.from == rhs.message.from)
-               && (lhs.message.nonce < rhs.message.nonce));
-  };
-
-  /**
-   * Comparator based on gas price for scoring
-   */
-  auto compareGasFunctor = [](const SignedMessage &lhs,
-                              const SignedMessage &rhs) {
-    return (lhs.message.gasPrice > rhs.message.gasPrice)
-           || ((lhs.message.gasPrice == rhs.message.gasPrice)
-               && (compareMessagesFunctor(lhs, rhs)));
-  };
-
   /**
    * Caches pending messages and order by gas price.
+   * Messages are kept in per-sender chains ordered by nonce, and indexed by
+   * gas price over all senders. When capacity is reached the cheapest
+   * message is evicted together with later messages of its sender, and
+   * sender messages past evicted nonce are rejected until it is resubmitted
+   * or removed, so stored messages stay selectable.
+   * Safe for concurrent use.
    */
   class GasPriceScoredMessageStorage : public MessageStorage {
    public:
+    /// Default max number of stored messages
+    static constexpr size_t kDefaultCapacity{1 << 16};
+
+    /**
+     * @param capacity - max number of stored messages
+     */
+    explicit GasPriceScoredMessageStorage(size_t capacity = kDefaultCapacity);
+
     ~GasPriceScoredMessageStorage() override = default;
 
-    /** \copydoc MessageStorage::put() */
+    /**
+     * Add message, evicts the cheapest messages if storage is full
+     * @param message - message to add
+     * @return MESSAGE_ALREADY_IN_POOL if sender already has message with
+     * same nonce, MESSAGE_POOL_FULL if storage is full and message is not
+     * more expensive than the cheapest one, or if message nonce is past
+     * evicted message of sender
+     */
     outcome::result<void> put(const SignedMessage &message) override;
 
     /** \copydoc MessageStorage::remove() */
@@ -49,9 +56,52 @@ namespace fc::blockchain::message_pool {
     /** \copydoc MessageStorage::getTopScored() */
     std::vector<SignedMessage> getTopScored(size_t n) const override;
 
+    /** \copydoc MessageStorage::selectMessages() */
+    std::vector<SignedMessage> selectMessages(size_t n) const override;
+
+    /** \copydoc MessageStorage::visitSelection() */
+    void visitSelection(const SelectionVisitor &visitor) const override;
+
+    /**
+     * Number of stored messages
+     */
+    size_t size() const;
+
    private:
-    std::set<SignedMessage, decltype(compareMessagesFunctor)> messages_{
-        compareMessagesFunctor};
+    /// Sender messages by nonce
+    using Chain = std::map<uint64_t, SignedMessage>;
+
+    /**
+     * Gas price index entry
+     */
+    struct Score {
+      BigInt gas_price;
+      Address from;
+      uint64_t nonce;
+    };
+
+    /**
+     * Orders by gas price descending, then by sender and nonce
+     */
+    struct ScoreLess {
+      bool operator()(const Score &lhs, const Score &rhs) const;
+    };
+
+    static Score score(const SignedMessage &message);
+
+    /**
+     * Remove message by index entry, requires exclusive lock
+     */
+    void erase(const Score &entry);
+
+    size_t capacity_;
+    std::map<Address, Chain> chains_;
+    std::set<Score, ScoreLess> scores_;
+    /// Lowest evicted nonce by sender, at most capacity entries
+    std::map<Address, uint64_t> evicted_;
+    mutable std::shared_mutex mutex_;
+    /// Number of stored messages, set after each change
+    common::metrics::Gauge &size_metric_;
   };
 
 }  // namespace fc::blockchain::message_pool
@@ -11,6 +11,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::blockchain::message_pool, MessagePoolError, e) {
   switch (e) {
     case MessagePoolError::MESSAGE_ALREADY_IN_POOL:
       return "MessagePoolError: message is already in pool";
+    case MessagePoolError::MESSAGE_POOL_FULL:
+      return "MessagePoolError: pool is full of more expensive messages";
   }
 
   return "unknown error";
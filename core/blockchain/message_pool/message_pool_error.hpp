@@ -15,6 +15,7 @@ namespace fc::blockchain::message_pool {
    */
   enum class MessagePoolError {
     MESSAGE_ALREADY_IN_POOL = 1,
+    MESSAGE_POOL_FULL,
   };
 
 }  // namespace fc::blockchain::message_pool
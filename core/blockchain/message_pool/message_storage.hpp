@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_STORAGE_HPP
 #define CPP_FILECOIN_BLOCKCHAIN_MESSAGE_POOL_MESSAGE_STORAGE_HPP
 
+#include <functional>
+
 #include "common/outcome.hpp"
 #include "primitives/address/address.hpp"
 #include "vm/message/message.hpp"
@@ -15,6 +17,15 @@ namespace fc::blockchain::message_pool {
   using primitives::address::Address;
   using vm::message::SignedMessage;
 
+  /**
+   * Visitor decision on selected message
+   */
+  enum class SelectionStep {
+    NEXT,         ///< take message, continue with next one
+    SKIP_SENDER,  ///< skip message and later messages of its sender
+    STOP,         ///< stop selection
+  };
+
   /**
    * Caches pending messages.
    */
@@ -42,6 +53,23 @@ namespace fc::blockchain::message_pool {
      * @return no more than N top scored messages present in cache
      */
     virtual std::vector<SignedMessage> getTopScored(size_t n) const = 0;
+
+    /**
+     * Select N messages for block, messages of each sender are taken in
+     * nonce order without gaps
+     * @param n - how many messages return
+     * @return no more than N top scored nonce-consistent messages
+     */
+    virtual std::vector<SignedMessage> selectMessages(size_t n) const = 0;
+
+    using SelectionVisitor = std::function<SelectionStep(const SignedMessage &)>;
+
+    /**
+     * Visit messages in selection order of selectMessages, storage must not
+     * be modified by visitor
+     * @param visitor - decides whether to take message
+     */
+    virtual void visitSelection(const SelectionVisitor &visitor) const = 0;
   };
 
 }  // namespace fc::blockchain::message_pool
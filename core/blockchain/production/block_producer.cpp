@@ -5,43 +5,66 @@
 
 #include "blockchain/production/block_producer.hpp"
 
+#include <future>
+#include <thread>
+
 #include "blockchain/impl/weight_calculator_impl.hpp"
 #include "crypto/bls/impl/bls_provider_impl.hpp"
+#include "vm/interpreter/impl/interpreter_impl.hpp"
 
 namespace fc::blockchain::production {
   using crypto::signature::BlsSignature;
   using crypto::signature::Secp256k1Signature;
   using primitives::block::MsgMeta;
+  using vm::interpreter::CachedInterpreter;
   using vm::message::SignedMessage;
   using vm::message::UnsignedMessage;
 
-  outcome::result<Block> generate(Interpreter &interpreter,
-                                  std::shared_ptr<Ipld> ipld,
-                                  BlockTemplate t) {
+  outcome::result<Block> generate(
+      Interpreter &interpreter,
+      std::shared_ptr<Ipld> ipld,
+      BlockTemplate t,
+      std::chrono::milliseconds parent_state_wait) {
+    std::vector<crypto::bls::Signature> bls_signatures;
+    for (auto &message : t.messages) {
+      if (auto bls = boost::get<BlsSignature>(&message.signature)) {
+        bls_signatures.push_back(*bls);
+      }
+    }
+    // aggregated while parent state is loaded and messages are stored
+    auto bls_aggregate{std::async(std::launch::async, [&] {
+      return crypto::bls::BlsProviderImpl{}.aggregateSignaturesParallel(
+          bls_signatures, std::max(1u, std::thread::hardware_concurrency()));
+    })};
     OUTCOME_TRY(parent_tipset,
                 primitives::tipset::Tipset::load(*ipld, t.parents));
-    OUTCOME_TRY(vm_result, interpreter.interpret(ipld, parent_tipset));
+    auto deadline{std::chrono::steady_clock::now() + parent_state_wait};
+    auto cached{dynamic_cast<CachedInterpreter *>(&interpreter)};
+    OUTCOME_TRY(vm_result,
+                cached ? cached->interpretBefore(ipld, parent_tipset, deadline)
+                       : interpreter.interpret(ipld, parent_tipset));
     Block b;
     MsgMeta msg_meta;
     ipld->load(msg_meta);
-    std::vector<crypto::bls::Signature> bls_signatures;
+    std::vector<CID> bls_cids, secp_cids;
     for (auto &message : t.messages) {
       OUTCOME_TRY(visit_in_place(
           message.signature,
           [&](const BlsSignature &signature) -> outcome::result<void> {
             b.bls_messages.emplace_back(message.message);
-            bls_signatures.push_back(signature);
             OUTCOME_TRY(message_cid, ipld->setCbor(message.message));
-            OUTCOME_TRY(msg_meta.bls_messages.append(message_cid));
+            bls_cids.push_back(std::move(message_cid));
             return outcome::success();
           },
           [&](const Secp256k1Signature &signature) -> outcome::result<void> {
             b.secp_messages.emplace_back(message);
             OUTCOME_TRY(message_cid, ipld->setCbor(message));
-            OUTCOME_TRY(msg_meta.secp_messages.append(message_cid));
+            secp_cids.push_back(std::move(message_cid));
             return outcome::success();
           }));
     }
+    OUTCOME_TRY(msg_meta.bls_messages.assign(bls_cids));
+    OUTCOME_TRY(msg_meta.secp_messages.assign(secp_cids));
     b.header.miner = std::move(t.miner);
     b.header.ticket = std::move(t.ticket);
     b.header.election_proof = std::move(t.election_proof);
@@ -55,9 +78,7 @@ namespace fc::blockchain::production {
     b.header.parent_state_root = std::move(vm_result.state_root);
     b.header.parent_message_receipts = std::move(vm_result.message_receipts);
     OUTCOME_TRYA(b.header.messages, ipld->setCbor(msg_meta));
-    OUTCOME_TRYA(
-        b.header.bls_aggregate,
-        crypto::bls::BlsProviderImpl{}.aggregateSignatures(bls_signatures));
+    OUTCOME_TRYA(b.header.bls_aggregate, bls_aggregate.get());
     b.header.timestamp = t.timestamp;
     // TODO: the only caller of "generate" is MinerCreateBlock, it signs block
     b.header.block_sig = {};
@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <chrono>
+
 #include "vm/interpreter/interpreter.hpp"
 
 namespace fc::blockchain::production {
@@ -12,7 +14,18 @@ namespace fc::blockchain::production {
 
   constexpr size_t kBlockMaxMessagesCount = 1000;
 
-  outcome::result<Block> generate(Interpreter &interpreter,
-                                  std::shared_ptr<Ipld> ipld,
-                                  BlockTemplate t);
+  /// Time to wait for parent state precomputed in background
+  constexpr std::chrono::seconds kParentStateWait{3};
+
+  /**
+   * @brief assembles block on parent tipset of template
+   * @param interpreter - parent state precomputed by CachedInterpreter is
+   * used if ready within parent_state_wait, otherwise parent is interpreted
+   * on calling thread
+   */
+  outcome::result<Block> generate(
+      Interpreter &interpreter,
+      std::shared_ptr<Ipld> ipld,
+      BlockTemplate t,
+      std::chrono::milliseconds parent_state_wait = kParentStateWait);
 }  // namespace fc::blockchain::production
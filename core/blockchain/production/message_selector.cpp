@@ -0,0 +1,58 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/production/message_selector.hpp"
+
+namespace fc::blockchain::production {
+  using message_pool::SelectionStep;
+
+  MessageSelector::MessageSelector(std::shared_ptr<MessageStorage> storage)
+      : storage_{std::move(storage)} {}
+
+  MessageSelector::Selection MessageSelector::select(
+      const Limits &limits) const {
+    auto start = Clock::now();
+    Selection selection;
+    if (limits.max_messages != 0 && limits.gas_limit > 0) {
+      storage_->visitSelection([&](auto &message) {
+        if (Clock::now() >= limits.deadline) {
+          selection.timed_out = true;
+          return SelectionStep::STOP;
+        }
+        auto gas = message.message.gasLimit;
+        if (gas <= 0 || gas > limits.gas_limit - selection.gas_used) {
+          return SelectionStep::SKIP_SENDER;
+        }
+        selection.messages.push_back(message);
+        selection.gas_used += gas;
+        if (selection.messages.size() >= limits.max_messages
+            || selection.gas_used == limits.gas_limit) {
+          return SelectionStep::STOP;
+        }
+        return SelectionStep::NEXT;
+      });
+    }
+    if (selection.timed_out) {
+      timeouts_.fetch_add(1, std::memory_order_relaxed);
+    }
+    latency_.record(Clock::now() - start);
+    return selection;
+  }
+
+  MessageSelector::Selection MessageSelector::select(
+      std::chrono::milliseconds timeout) const {
+    Limits limits;
+    limits.deadline = Clock::now() + timeout;
+    return select(limits);
+  }
+
+  LatencyHistogram::Snapshot MessageSelector::latency() const {
+    return latency_.snapshot();
+  }
+
+  uint64_t MessageSelector::timeouts() const {
+    return timeouts_.load(std::memory_order_relaxed);
+  }
+}  // namespace fc::blockchain::production
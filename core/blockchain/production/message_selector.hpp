@@ -0,0 +1,86 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_BLOCKCHAIN_PRODUCTION_MESSAGE_SELECTOR_HPP
+#define CPP_FILECOIN_CORE_BLOCKCHAIN_PRODUCTION_MESSAGE_SELECTOR_HPP
+
+#include <memory>
+
+#include "blockchain/message_pool/message_storage.hpp"
+#include "blockchain/production/block_producer.hpp"
+#include "common/histogram.hpp"
+#include "primitives/types.hpp"
+
+namespace fc::blockchain::production {
+  using common::LatencyHistogram;
+  using message_pool::MessageStorage;
+  using primitives::GasAmount;
+  using vm::message::SignedMessage;
+
+  /**
+   * Packs pending messages into block. Messages are taken by gas price, each
+   * sender in nonce order without gaps, while they fit into block gas limit.
+   * Message which does not fit excludes later messages of its sender.
+   */
+  class MessageSelector {
+   public:
+    using Clock = LatencyHistogram::Clock;
+
+    static constexpr GasAmount kBlockGasLimit{100000000};
+
+    /**
+     * Selection bounds
+     */
+    struct Limits {
+      GasAmount gas_limit{kBlockGasLimit};
+      size_t max_messages{kBlockMaxMessagesCount};
+      /// Best set found until deadline is returned
+      Clock::time_point deadline{Clock::time_point::max()};
+    };
+
+    /**
+     * Selection result
+     */
+    struct Selection {
+      std::vector<SignedMessage> messages;
+      GasAmount gas_used{};
+      /// Whether selection was stopped by deadline
+      bool timed_out{};
+    };
+
+    explicit MessageSelector(std::shared_ptr<MessageStorage> storage);
+
+    /**
+     * Select messages for block
+     * @param limits - selection bounds
+     * @return selected messages in inclusion order
+     */
+    Selection select(const Limits &limits) const;
+
+    /**
+     * Select messages for block within timeout
+     * @param timeout - time to search for messages
+     * @return selected messages in inclusion order
+     */
+    Selection select(std::chrono::milliseconds timeout) const;
+
+    /**
+     * @return latencies of select calls
+     */
+    LatencyHistogram::Snapshot latency() const;
+
+    /**
+     * @return number of select calls stopped by deadline
+     */
+    uint64_t timeouts() const;
+
+   private:
+    std::shared_ptr<MessageStorage> storage_;
+    mutable LatencyHistogram latency_;
+    mutable std::atomic<uint64_t> timeouts_{};
+  };
+}  // namespace fc::blockchain::production
+
+#endif  // CPP_FILECOIN_CORE_BLOCKCHAIN_PRODUCTION_MESSAGE_SELECTOR_HPP
@@ -0,0 +1,91 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "clock/epoch_scheduler.hpp"
+
+#include <algorithm>
+
+namespace fc::clock {
+  EpochScheduler::EpochScheduler(std::shared_ptr<UTCClock> utc_clock,
+                                 std::shared_ptr<ChainEpochClock> epoch_clock)
+      : utc_clock_{std::move(utc_clock)},
+        epoch_clock_{std::move(epoch_clock)},
+        wheel_{[&] {
+          auto epoch = epoch_clock_->epochAtTime(utc_clock_->nowUTC());
+          return epoch ? epoch.value() : 0;
+        }()} {}
+
+  void EpochScheduler::start(boost::asio::io_context &io) {
+    timer_ = std::make_unique<boost::asio::steady_timer>(io);
+    stopped_ = false;
+    tick();
+  }
+
+  void EpochScheduler::stop() {
+    stopped_ = true;
+    if (timer_) {
+      timer_->cancel();
+    }
+  }
+
+  EpochScheduler::TimerId EpochScheduler::schedule(ChainEpoch epoch,
+                                                   Callback callback) {
+    return wheel_.schedule(epoch, std::move(callback));
+  }
+
+  EpochScheduler::TimerId EpochScheduler::scheduleAfter(ChainEpoch epochs,
+                                                        Callback callback) {
+    return wheel_.schedule(wheel_.current() + epochs, std::move(callback));
+  }
+
+  bool EpochScheduler::cancel(TimerId id) {
+    return wheel_.cancel(id);
+  }
+
+  ChainEpoch EpochScheduler::current() const {
+    return wheel_.current();
+  }
+
+  EpochSchedulerStats EpochScheduler::stats() const {
+    return stats_;
+  }
+
+  TimerWheelStats EpochScheduler::timerStats() const {
+    return wheel_.stats();
+  }
+
+  void EpochScheduler::tick() {
+    auto now = utc_clock_->nowUTC();
+    auto maybe_epoch = epoch_clock_->epochAtTime(now);
+    if (!maybe_epoch) {
+      // before genesis
+      wait(epoch_clock_->genesisTime() - now);
+      return;
+    }
+    auto epoch = maybe_epoch.value();
+    if (epoch > wheel_.current() + 1) {
+      stats_.skipped_epochs += epoch - wheel_.current() - 1;
+    }
+    stats_.last_lateness = now - epochStart(epoch);
+    stats_.max_lateness = std::max(stats_.max_lateness, stats_.last_lateness);
+    wheel_.advance(epoch);
+    wait(epochStart(epoch + 1) - utc_clock_->nowUTC());
+  }
+
+  void EpochScheduler::wait(UnixTime delay) {
+    timer_->expires_after(std::max(delay, UnixTime{0}));
+    timer_->async_wait([weak{weak_from_this()}](auto &&ec) {
+      auto self = weak.lock();
+      if (ec || !self || self->stopped_) {
+        return;
+      }
+      self->tick();
+    });
+  }
+
+  UnixTime EpochScheduler::epochStart(ChainEpoch epoch) const {
+    return epoch_clock_->genesisTime() + epoch * kEpochDuration;
+  }
+}  // namespace fc::clock
@@ -0,0 +1,76 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_CLOCK_EPOCH_SCHEDULER_HPP
+#define CPP_FILECOIN_CORE_CLOCK_EPOCH_SCHEDULER_HPP
+
+#include <memory>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "clock/chain_epoch_clock.hpp"
+#include "clock/epoch_timer_wheel.hpp"
+#include "clock/utc_clock.hpp"
+
+namespace fc::clock {
+  /// Wall clock lateness of epoch ticks
+  struct EpochSchedulerStats {
+    /// Delay of last tick after start of its epoch
+    UnixTime last_lateness{};
+    UnixTime max_lateness{};
+    /// Epochs which started and ended between ticks, node fell behind
+    uint64_t skipped_epochs{};
+  };
+
+  /**
+   * Shared scheduler of epoch-aligned timeouts. One asio timer wakes at
+   * start of each epoch and advances timer wheel to epoch of wall clock,
+   * so many timeouts cost no timers of their own.
+   * Must be used from io thread, callbacks are called there.
+   */
+  class EpochScheduler : public std::enable_shared_from_this<EpochScheduler> {
+   public:
+    using Callback = EpochTimerWheel::Callback;
+    using TimerId = EpochTimerWheel::TimerId;
+
+    EpochScheduler(std::shared_ptr<UTCClock> utc_clock,
+                   std::shared_ptr<ChainEpochClock> epoch_clock);
+
+    /// Start ticking at epoch starts
+    void start(boost::asio::io_context &io);
+
+    void stop();
+
+    /// Schedule callback at start of epoch
+    TimerId schedule(ChainEpoch epoch, Callback callback);
+
+    /// Schedule callback epochs after current one
+    TimerId scheduleAfter(ChainEpoch epochs, Callback callback);
+
+    bool cancel(TimerId id);
+
+    /// Epoch of last tick
+    ChainEpoch current() const;
+
+    EpochSchedulerStats stats() const;
+
+    TimerWheelStats timerStats() const;
+
+   private:
+    void tick();
+    void wait(UnixTime delay);
+    UnixTime epochStart(ChainEpoch epoch) const;
+
+    std::shared_ptr<UTCClock> utc_clock_;
+    std::shared_ptr<ChainEpochClock> epoch_clock_;
+    EpochTimerWheel wheel_;
+    std::unique_ptr<boost::asio::steady_timer> timer_;
+    bool stopped_{true};
+    EpochSchedulerStats stats_;
+  };
+}  // namespace fc::clock
+
+#endif  // CPP_FILECOIN_CORE_CLOCK_EPOCH_SCHEDULER_HPP
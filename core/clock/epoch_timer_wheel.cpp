@@ -0,0 +1,114 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "clock/epoch_timer_wheel.hpp"
+
+#include <algorithm>
+
+namespace fc::clock {
+  constexpr ChainEpoch kSlotMask = kWheelSlots - 1;
+
+  EpochTimerWheel::EpochTimerWheel(ChainEpoch current) : current_{current} {}
+
+  EpochTimerWheel::TimerId EpochTimerWheel::schedule(ChainEpoch epoch,
+                                                     Callback callback) {
+    auto id = ++next_id_;
+    auto &slot = slotOf(epoch);
+    slot.push_back({id, epoch, std::move(callback)});
+    timers_.emplace(id, Location{&slot, std::prev(slot.end())});
+    return id;
+  }
+
+  bool EpochTimerWheel::cancel(TimerId id) {
+    auto it = timers_.find(id);
+    if (it == timers_.end()) {
+      return false;
+    }
+    it->second.slot->erase(it->second.it);
+    timers_.erase(it);
+    return true;
+  }
+
+  size_t EpochTimerWheel::advance(ChainEpoch epoch) {
+    auto fired = fire(due_);
+    while (current_ < epoch) {
+      if (timers_.empty()) {
+        current_ = epoch;
+        break;
+      }
+      ++current_;
+      // higher level first, its timers may move to lower slots due now
+      for (auto level = kWheelLevels; level > 0; --level) {
+        auto shift = kWheelSlotBits * level;
+        if ((current_ & ((ChainEpoch{1} << shift) - 1)) != 0) {
+          continue;
+        }
+        cascade(level == kWheelLevels
+                    ? overflow_
+                    : levels_[level][(current_ >> shift) & kSlotMask]);
+      }
+      fired += fire(due_);
+      fired += fire(levels_[0][current_ & kSlotMask]);
+    }
+    return fired;
+  }
+
+  ChainEpoch EpochTimerWheel::current() const {
+    return current_;
+  }
+
+  size_t EpochTimerWheel::size() const {
+    return timers_.size();
+  }
+
+  const TimerWheelStats &EpochTimerWheel::stats() const {
+    return stats_;
+  }
+
+  EpochTimerWheel::Slot &EpochTimerWheel::slotOf(ChainEpoch epoch) {
+    if (epoch <= current_) {
+      return due_;
+    }
+    for (size_t level = 0; level < kWheelLevels; ++level) {
+      auto shift = kWheelSlotBits * (level + 1);
+      if ((epoch >> shift) == (current_ >> shift)) {
+        return levels_[level][(epoch >> (kWheelSlotBits * level)) & kSlotMask];
+      }
+    }
+    return overflow_;
+  }
+
+  void EpochTimerWheel::cascade(Slot &slot) {
+    // entries may go back to same slot, e.g. overflow
+    Slot moving;
+    moving.splice(moving.end(), slot);
+    while (!moving.empty()) {
+      auto it = moving.begin();
+      auto &to = slotOf(it->epoch);
+      to.splice(to.end(), moving, it);
+      timers_.at(it->id).slot = &to;
+    }
+  }
+
+  size_t EpochTimerWheel::fire(Slot &slot) {
+    // timers scheduled by callbacks have greater ids and wait for next advance
+    auto last_id = next_id_;
+    size_t fired = 0;
+    while (!slot.empty() && slot.front().id <= last_id) {
+      auto entry = std::move(slot.front());
+      slot.pop_front();
+      timers_.erase(entry.id);
+      auto lateness = current_ - entry.epoch;
+      ++stats_.fired;
+      if (lateness > 0) {
+        ++stats_.late;
+        stats_.max_lateness = std::max(stats_.max_lateness, lateness);
+      }
+      ++fired;
+      entry.callback(entry.epoch, current_);
+    }
+    return fired;
+  }
+}  // namespace fc::clock
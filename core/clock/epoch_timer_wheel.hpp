@@ -0,0 +1,99 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_CLOCK_EPOCH_TIMER_WHEEL_HPP
+#define CPP_FILECOIN_CORE_CLOCK_EPOCH_TIMER_WHEEL_HPP
+
+#include <array>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include "primitives/chain_epoch/chain_epoch.hpp"
+
+namespace fc::clock {
+  using primitives::ChainEpoch;
+
+  /// Bits of epoch per wheel level
+  constexpr size_t kWheelSlotBits = 6;
+  constexpr size_t kWheelSlots = size_t{1} << kWheelSlotBits;
+  /// Levels cover 2^24 epochs ahead, later timers wait in overflow list
+  constexpr size_t kWheelLevels = 4;
+
+  /// Counters of fired timers, lateness is in epochs after scheduled one
+  struct TimerWheelStats {
+    uint64_t fired{};
+    uint64_t late{};
+    ChainEpoch max_lateness{};
+  };
+
+  /**
+   * Hierarchical timer wheel of epochs. Slot of level spans all slots of
+   * level below, timer is kept at lowest level where its epoch shares
+   * slot of current epoch, and moves down when current epoch reaches that
+   * slot. Schedule and cancel are constant time, each timer moves at most
+   * once per level. Not thread safe.
+   */
+  class EpochTimerWheel {
+   public:
+    using TimerId = uint64_t;
+    /// Called with scheduled epoch and epoch it fired at, which may be later
+    using Callback = std::function<void(ChainEpoch scheduled, ChainEpoch now)>;
+
+    explicit EpochTimerWheel(ChainEpoch current = 0);
+
+    /**
+     * Schedule callback at epoch, timer of passed or current epoch fires on
+     * next advance
+     */
+    TimerId schedule(ChainEpoch epoch, Callback callback);
+
+    /// Returns false if timer fired or was cancelled
+    bool cancel(TimerId id);
+
+    /**
+     * Move current epoch forward, firing timers of epochs up to it in order.
+     * Callbacks may schedule and cancel timers.
+     * @return number of fired timers
+     */
+    size_t advance(ChainEpoch epoch);
+
+    ChainEpoch current() const;
+
+    /// Number of pending timers
+    size_t size() const;
+
+    const TimerWheelStats &stats() const;
+
+   private:
+    struct Entry {
+      TimerId id;
+      ChainEpoch epoch;
+      Callback callback;
+    };
+    using Slot = std::list<Entry>;
+    struct Location {
+      Slot *slot;
+      Slot::iterator it;
+    };
+
+    /// Slot to keep timer of epoch relative to current epoch
+    Slot &slotOf(ChainEpoch epoch);
+    /// Move entries of slot to their slots relative to current epoch
+    void cascade(Slot &slot);
+    size_t fire(Slot &slot);
+
+    ChainEpoch current_;
+    TimerId next_id_{};
+    std::array<std::array<Slot, kWheelSlots>, kWheelLevels> levels_;
+    Slot overflow_;
+    /// Timers of passed epochs
+    Slot due_;
+    std::unordered_map<TimerId, Location> timers_;
+    TimerWheelStats stats_;
+  };
+}  // namespace fc::clock
+
+#endif  // CPP_FILECOIN_CORE_CLOCK_EPOCH_TIMER_WHEEL_HPP
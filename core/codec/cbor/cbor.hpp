@@ -42,7 +42,8 @@ namespace fc::codec::cbor {
   outcome::result<T> decode(gsl::span<const uint8_t> input) {
     try {
       T data{};
-      CborDecodeStream decoder(input);
+      // decoded values own their data, so input is not copied
+      auto decoder = CborDecodeStream::borrow(input);
       decoder >> data;
       return data;
     } catch (std::system_error &e) {
@@ -6,12 +6,36 @@
 #include "codec/cbor/cbor_decode_stream.hpp"
 
 namespace fc::codec::cbor {
+  namespace {
+    /// Size of CBOR item header with definite length
+    size_t headerSize(uint8_t initial) {
+      auto info = initial & 0x1F;
+      if (info < 24) {
+        return 1;
+      }
+      if (info <= 27) {
+        return 1 + (1 << (info - 24));
+      }
+      outcome::raise(CborDecodeError::INVALID_CBOR);
+    }
+  }  // namespace
+
   CborDecodeStream::CborDecodeStream(gsl::span<const uint8_t> data)
-      : data_(std::make_shared<std::vector<uint8_t>>(data.begin(), data.end())),
-        parser_(std::make_shared<CborParser>()) {
+      : CborDecodeStream{data, true} {}
+
+  CborDecodeStream CborDecodeStream::borrow(gsl::span<const uint8_t> data) {
+    return {data, false};
+  }
+
+  CborDecodeStream::CborDecodeStream(gsl::span<const uint8_t> data, bool copy)
+      : parser_(std::make_shared<CborParser>()) {
+    if (copy) {
+      data_ = std::make_shared<std::vector<uint8_t>>(data.begin(), data.end());
+      data = *data_;
+    }
     if (CborNoError
         != cbor_parser_init(
-            data_->data(), data_->size(), 0, parser_.get(), &value_)) {
+            data.data(), data.size(), 0, parser_.get(), &value_)) {
       outcome::raise(CborDecodeError::INVALID_CBOR);
     }
     value_.remaining = UINT32_MAX;
@@ -71,13 +95,11 @@ namespace fc::codec::cbor {
     if (!cbor_value_is_byte_string(&value_)) {
       outcome::raise(CborDecodeError::INVALID_CBOR_CID);
     }
-    std::vector<uint8_t> bytes;
-    *this >> bytes;
-    if (bytes[0] != 0) {
+    auto bytes = bytesView();
+    if (bytes.empty() || bytes[0] != 0) {
       outcome::raise(CborDecodeError::INVALID_CBOR_CID);
     }
-    bytes.erase(bytes.begin());
-    auto maybe_cid = CID::fromBytes(bytes);
+    auto maybe_cid = CID::fromBytes(bytes.subspan(1));
     if (maybe_cid.has_error()) {
       outcome::raise(CborDecodeError::INVALID_CID);
     }
@@ -168,11 +190,29 @@ namespace fc::codec::cbor {
   }
 
   std::vector<uint8_t> CborDecodeStream::raw() {
+    auto raw = rawView();
+    return {raw.begin(), raw.end()};
+  }
+
+  gsl::span<const uint8_t> CborDecodeStream::rawView() {
     auto begin = value_.ptr;
     next();
     return {begin, value_.ptr};
   }
 
+  gsl::span<const uint8_t> CborDecodeStream::bytesView() {
+    auto size = bytesLength();
+    if (!cbor_value_is_length_known(&value_)) {
+      outcome::raise(CborDecodeError::INVALID_CBOR);
+    }
+    auto begin = value_.ptr + headerSize(*value_.ptr);
+    if (static_cast<size_t>(parser_->end - begin) < size) {
+      outcome::raise(CborDecodeError::INVALID_CBOR);
+    }
+    next();
+    return {begin, size};
+  }
+
   std::map<std::string, CborDecodeStream> CborDecodeStream::map() {
     if (!cbor_value_is_map(&value_)) {
       outcome::raise(CborDecodeError::WRONG_TYPE);
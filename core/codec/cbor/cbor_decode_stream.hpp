@@ -23,6 +23,12 @@ namespace fc::codec::cbor {
 
     explicit CborDecodeStream(gsl::span<const uint8_t> data);
 
+    /**
+     * Creates stream over data without copying it, caller must keep data
+     * alive while stream, its substreams and views are used
+     */
+    static CborDecodeStream borrow(gsl::span<const uint8_t> data);
+
     /** Decodes integer or bool */
     template <
         typename T,
@@ -135,14 +141,22 @@ namespace fc::codec::cbor {
     /** Reads CBOR bytes of current element (and advances to the next element)
      */
     std::vector<uint8_t> raw();
+    /** Returns view of CBOR bytes of current element (and advances to the next
+     * element), view points into source data */
+    gsl::span<const uint8_t> rawView();
+    /// Returns view of bytestring content, view points into source data
+    gsl::span<const uint8_t> bytesView();
     /** Creates map container decode substream map */
     std::map<std::string, CborDecodeStream> map();
     /// Returns bytestring length
     size_t bytesLength() const;
 
    private:
+    CborDecodeStream(gsl::span<const uint8_t> data, bool copy);
+
     CborDecodeStream container() const;
 
+    /// Owned copy of data, null for borrowed data
     std::shared_ptr<std::vector<uint8_t>> data_;
     std::shared_ptr<CborParser> parser_;
     CborValue value_{};
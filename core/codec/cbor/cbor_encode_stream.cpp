@@ -5,7 +5,90 @@
 
 #include "codec/cbor/cbor_encode_stream.hpp"
 
+#include <algorithm>
+#include <cstring>
+
+#include <boost/container/small_vector.hpp>
+
 namespace fc::codec::cbor {
+  namespace {
+    /**
+     * Per-thread pool of encode buffers, keeps their capacity between
+     * encodings so nested streams do not allocate
+     */
+    struct BufferPool {
+      static constexpr size_t kMaxBuffers = 64;
+      static constexpr size_t kMaxCapacity = 1 << 20;
+
+      ~BufferPool();
+
+      std::vector<std::vector<uint8_t>> buffers;
+    };
+
+    /// Pool may be destroyed before streams with thread storage duration
+    thread_local bool pool_alive{true};
+    thread_local BufferPool pool;
+
+    BufferPool::~BufferPool() {
+      pool_alive = false;
+    }
+
+    std::vector<uint8_t> acquire() {
+      if (!pool_alive || pool.buffers.empty()) {
+        return {};
+      }
+      auto buffer = std::move(pool.buffers.back());
+      pool.buffers.pop_back();
+      return buffer;
+    }
+
+    void release(std::vector<uint8_t> &buffer) {
+      if (!pool_alive || buffer.capacity() == 0
+          || buffer.capacity() > BufferPool::kMaxCapacity
+          || pool.buffers.size() >= BufferPool::kMaxBuffers) {
+        return;
+      }
+      buffer.clear();
+      pool.buffers.push_back(std::move(buffer));
+    }
+  }  // namespace
+
+  CborEncodeStream::CborEncodeStream() : data_{acquire()} {}
+
+  CborEncodeStream::CborEncodeStream(const CborEncodeStream &other)
+      : is_list_{other.is_list_}, data_{acquire()}, count_{other.count_} {
+    data_.assign(other.data_.begin(), other.data_.end());
+  }
+
+  CborEncodeStream::CborEncodeStream(CborEncodeStream &&other) noexcept
+      : is_list_{other.is_list_},
+        data_{std::move(other.data_)},
+        count_{other.count_} {}
+
+  CborEncodeStream::~CborEncodeStream() {
+    release(data_);
+  }
+
+  CborEncodeStream &CborEncodeStream::operator=(const CborEncodeStream &other) {
+    if (this != &other) {
+      is_list_ = other.is_list_;
+      data_.assign(other.data_.begin(), other.data_.end());
+      count_ = other.count_;
+    }
+    return *this;
+  }
+
+  CborEncodeStream &CborEncodeStream::operator=(
+      CborEncodeStream &&other) noexcept {
+    if (this != &other) {
+      release(data_);
+      is_list_ = other.is_list_;
+      data_ = std::move(other.data_);
+      count_ = other.count_;
+    }
+    return *this;
+  }
+
   CborEncodeStream &CborEncodeStream::operator<<(
       const std::vector<uint8_t> &bytes) {
     return *this << gsl::make_span(bytes);
@@ -14,29 +97,15 @@ namespace fc::codec::cbor {
   CborEncodeStream &CborEncodeStream::operator<<(
       gsl::span<const uint8_t> bytes) {
     addCount(1);
-
-    std::vector<uint8_t> encoded(9 + bytes.size());
-    CborEncoder encoder;
-    cbor_encoder_init(&encoder, encoded.data(), encoded.size(), 0);
-    cbor_encode_byte_string(&encoder, bytes.data(), bytes.size());
-    data_.insert(data_.end(),
-                 encoded.begin(),
-                 encoded.begin()
-                     + cbor_encoder_get_buffer_size(&encoder, encoded.data()));
+    writeHead(data_, kBytes, bytes.size());
+    data_.insert(data_.end(), bytes.begin(), bytes.end());
     return *this;
   }
 
   CborEncodeStream &CborEncodeStream::operator<<(const std::string &str) {
     addCount(1);
-
-    std::vector<uint8_t> encoded(9 + str.size());
-    CborEncoder encoder;
-    cbor_encoder_init(&encoder, encoded.data(), encoded.size(), 0);
-    cbor_encode_text_string(&encoder, str.data(), str.size());
-    data_.insert(data_.end(),
-                 encoded.begin(),
-                 encoded.begin()
-                     + cbor_encoder_get_buffer_size(&encoder, encoded.data()));
+    writeHead(data_, kText, str.size());
+    data_.insert(data_.end(), str.begin(), str.end());
     return *this;
   }
 
@@ -45,65 +114,49 @@ namespace fc::codec::cbor {
     if (maybe_cid_bytes.has_error()) {
       outcome::raise(CborEncodeError::INVALID_CID);
     }
-    auto cid_bytes = maybe_cid_bytes.value();
-    cid_bytes.insert(cid_bytes.begin(), 0);
-
-    std::array<uint8_t, 9> encoded{0};
-    CborEncoder encoder;
-    cbor_encoder_init(&encoder, encoded.data(), encoded.size(), 0);
-    cbor_encode_tag(&encoder, kCidTag);
-    data_.insert(data_.end(),
-                 encoded.begin(),
-                 encoded.begin()
-                     + cbor_encoder_get_buffer_size(&encoder, encoded.data()));
-    *this << cid_bytes;
+    auto &cid_bytes = maybe_cid_bytes.value();
+    addCount(1);
+    writeHead(data_, kTag, kCidTag);
+    // multibase prefix of binary CID
+    writeHead(data_, kBytes, cid_bytes.size() + 1);
+    data_.push_back(0);
+    data_.insert(data_.end(), cid_bytes.begin(), cid_bytes.end());
     return *this;
   }
 
   CborEncodeStream &CborEncodeStream::operator<<(
       const CborEncodeStream &other) {
     addCount(other.is_list_ ? 1 : other.count_);
-    auto other_data = other.data();
-    data_.insert(data_.end(), other_data.begin(), other_data.end());
+    other.appendTo(data_);
     return *this;
   }
 
-  struct LessCborKey {
-    bool operator()(const std::vector<uint8_t> &lhs,
-                    const std::vector<uint8_t> &rhs) const {
-      ssize_t diff = lhs.size() - rhs.size();
-      if (diff != 0) {
-        return diff < 0;
-      }
-      return std::memcmp(lhs.data(), rhs.data(), lhs.size()) < 0;
-    }
-  };
-
   CborEncodeStream &CborEncodeStream::operator<<(
       const std::map<std::string, CborEncodeStream> &map) {
     addCount(1);
+    writeHead(data_, kMap, map.size());
 
-    std::array<uint8_t, 9> prefix{0};
-    CborEncoder encoder;
-    CborEncoder container;
-    cbor_encoder_init(&encoder, prefix.data(), prefix.size(), 0);
-    cbor_encoder_create_map(&encoder, &container, map.size());
-    data_.insert(data_.end(),
-                 prefix.begin(),
-                 prefix.begin()
-                     + cbor_encoder_get_buffer_size(&container, prefix.data()));
-
-    std::map<std::vector<uint8_t>, std::vector<uint8_t>, LessCborKey> sorted;
+    // canonical order of encoded keys is by length, then bytewise
+    using Item = std::pair<const std::string, CborEncodeStream>;
+    boost::container::small_vector<const Item *, 8> sorted;
     for (const auto &pair : map) {
       if (pair.second.count_ != 1) {
         outcome::raise(CborEncodeError::EXPECTED_MAP_VALUE_SINGLE);
       }
-      sorted.insert(std::make_pair((CborEncodeStream() << pair.first).data(),
-                                   pair.second.data()));
+      sorted.push_back(&pair);
     }
-    for (const auto &pair : sorted) {
-      data_.insert(data_.end(), pair.first.begin(), pair.first.end());
-      data_.insert(data_.end(), pair.second.begin(), pair.second.end());
+    std::sort(sorted.begin(), sorted.end(), [](auto lhs, auto rhs) {
+      auto &l = lhs->first;
+      auto &r = rhs->first;
+      if (l.size() != r.size()) {
+        return l.size() < r.size();
+      }
+      return std::memcmp(l.data(), r.data(), l.size()) < 0;
+    });
+    for (auto pair : sorted) {
+      writeHead(data_, kText, pair->first.size());
+      data_.insert(data_.end(), pair->first.begin(), pair->first.end());
+      pair->second.appendTo(data_);
     }
 
     return *this;
@@ -111,32 +164,14 @@ namespace fc::codec::cbor {
 
   CborEncodeStream &CborEncodeStream::operator<<(std::nullptr_t) {
     addCount(1);
-
-    std::array<uint8_t, 1> prefix{0};
-    CborEncoder encoder;
-    cbor_encoder_init(&encoder, prefix.data(), prefix.size(), 0);
-    cbor_encode_null(&encoder);
-    data_.insert(
-        data_.end(),
-        prefix.begin(),
-        prefix.begin() + cbor_encoder_get_buffer_size(&encoder, prefix.data()));
+    data_.push_back(kNull);
     return *this;
   }
 
   std::vector<uint8_t> CborEncodeStream::data() const {
-    if (!is_list_) {
-      return data_;
-    }
-    std::array<uint8_t, 9> prefix{0};
-    CborEncoder encoder;
-    CborEncoder container;
-    cbor_encoder_init(&encoder, prefix.data(), prefix.size(), 0);
-    cbor_encoder_create_array(&encoder, &container, count_);
-    std::vector<uint8_t> result(
-        prefix.begin(),
-        prefix.begin()
-            + cbor_encoder_get_buffer_size(&container, prefix.data()));
-    result.insert(result.end(), data_.begin(), data_.end());
+    std::vector<uint8_t> result;
+    result.reserve(9 + data_.size());
+    appendTo(result);
     return result;
   }
 
@@ -158,6 +193,62 @@ namespace fc::codec::cbor {
     return s;
   }
 
+  CborEncodeStream::Tuple CborEncodeStream::beginTuple() {
+    Tuple tuple{data_.size(), count_};
+    data_.push_back(kArray);
+    return tuple;
+  }
+
+  CborEncodeStream &CborEncodeStream::endTuple(const Tuple &tuple) {
+    auto fields{count_ - tuple.count};
+    if (fields < 24) {
+      data_[tuple.head] = static_cast<uint8_t>(kArray | fields);
+    } else {
+      // fields encoding several elements each, rare
+      std::vector<uint8_t> head;
+      writeHead(head, kArray, fields);
+      data_[tuple.head] = head[0];
+      data_.insert(
+          data_.begin() + tuple.head + 1, head.begin() + 1, head.end());
+    }
+    count_ = tuple.count;
+    addCount(1);
+    return *this;
+  }
+
+  void CborEncodeStream::writeHead(std::vector<uint8_t> &out,
+                                   Major major,
+                                   uint64_t arg) {
+    if (arg < 24) {
+      out.push_back(static_cast<uint8_t>(major | arg));
+      return;
+    }
+    size_t size;
+    if (arg <= 0xFF) {
+      out.push_back(major | 24);
+      size = 1;
+    } else if (arg <= 0xFFFF) {
+      out.push_back(major | 25);
+      size = 2;
+    } else if (arg <= 0xFFFFFFFF) {
+      out.push_back(major | 26);
+      size = 4;
+    } else {
+      out.push_back(major | 27);
+      size = 8;
+    }
+    for (auto i = size; i != 0; --i) {
+      out.push_back(static_cast<uint8_t>(arg >> ((i - 1) * 8)));
+    }
+  }
+
+  void CborEncodeStream::appendTo(std::vector<uint8_t> &out) const {
+    if (is_list_) {
+      writeHead(out, kArray, count_);
+    }
+    out.insert(out.end(), data_.begin(), data_.end());
+  }
+
   void CborEncodeStream::addCount(size_t count) {
     count_ += count;
   }
@@ -9,18 +9,31 @@
 #include "codec/cbor/cbor_common.hpp"
 
 #include <array>
+#include <map>
 #include <vector>
 
-#include <cbor.h>
+#include <gsl/span>
 
 #include "common/enum.hpp"
 
 namespace fc::codec::cbor {
-  /** Encodes CBOR */
+  /**
+   * Encodes CBOR.
+   * Heads are written directly into single buffer per stream, buffers of
+   * nested streams are reused through per-thread pool, so encoding performs
+   * one allocation for result in steady state.
+   */
   class CborEncodeStream {
    public:
     static constexpr auto is_cbor_encoder_stream = true;
 
+    CborEncodeStream();
+    CborEncodeStream(const CborEncodeStream &other);
+    CborEncodeStream(CborEncodeStream &&other) noexcept;
+    ~CborEncodeStream();
+    CborEncodeStream &operator=(const CborEncodeStream &other);
+    CborEncodeStream &operator=(CborEncodeStream &&other) noexcept;
+
     /** Encodes integer or bool */
     template <
         typename T,
@@ -30,20 +43,17 @@ namespace fc::codec::cbor {
         return *this << common::to_int(num);
       }
       addCount(1);
-      std::array<uint8_t, 9> buffer{0};
-      CborEncoder encoder;
-      cbor_encoder_init(&encoder, buffer.data(), buffer.size(), 0);
       if constexpr (std::is_same_v<T, bool>) {
-        cbor_encode_boolean(&encoder, num);
+        data_.push_back(num ? kTrue : kFalse);
       } else if constexpr (std::is_unsigned_v<T>) {
-        cbor_encode_uint(&encoder, static_cast<uint64_t>(num));
+        writeHead(data_, kUnsigned, static_cast<uint64_t>(num));
+      } else if (num < 0) {
+        writeHead(data_,
+                  kNegative,
+                  static_cast<uint64_t>(-(static_cast<int64_t>(num) + 1)));
       } else {
-        cbor_encode_int(&encoder, static_cast<int64_t>(num));
+        writeHead(data_, kUnsigned, static_cast<uint64_t>(num));
       }
-      data_.insert(data_.end(),
-                   buffer.begin(),
-                   buffer.begin()
-                       + cbor_encoder_get_buffer_size(&encoder, buffer.data()));
       return *this;
     }
 
@@ -114,7 +124,42 @@ namespace fc::codec::cbor {
     /** Wraps CBOR bytes */
     static CborEncodeStream wrap(gsl::span<const uint8_t> data, size_t count);
 
+    /// List head written in place by beginTuple
+    struct Tuple {
+      size_t head;
+      size_t count;
+    };
+
+    /**
+     * Starts list of tuple fields in place, fields are encoded directly into
+     * this stream, without nested stream and copy of its bytes.
+     * Head takes one byte for up to 23 fields, endTuple patches it.
+     */
+    Tuple beginTuple();
+    /// Finishes list started by beginTuple, list counts as one element
+    CborEncodeStream &endTuple(const Tuple &tuple);
+
    private:
+    /// CBOR major types shifted to initial byte
+    enum Major : uint8_t {
+      kUnsigned = 0x00,
+      kNegative = 0x20,
+      kBytes = 0x40,
+      kText = 0x60,
+      kArray = 0x80,
+      kMap = 0xA0,
+      kTag = 0xC0,
+    };
+    static constexpr uint8_t kFalse = 0xF4;
+    static constexpr uint8_t kTrue = 0xF5;
+    static constexpr uint8_t kNull = 0xF6;
+
+    /// Writes shortest head of major type with argument
+    static void writeHead(std::vector<uint8_t> &out, Major major, uint64_t arg);
+
+    /// Writes list head if needed, and encoded elements
+    void appendTo(std::vector<uint8_t> &out) const;
+
     void addCount(size_t count);
 
     bool is_list_{false};
@@ -69,9 +69,12 @@
                 _CBOR_TUPLE_1)  \
   (op, __VA_ARGS__)
 
-#define CBOR_ENCODE_TUPLE(T, ...)                        \
-  CBOR_ENCODE(T, t) {                                    \
-    return s << (s.list() _CBOR_TUPLE(<<, __VA_ARGS__)); \
+/// Fields are encoded in place after list head, see beginTuple
+#define CBOR_ENCODE_TUPLE(T, ...)   \
+  CBOR_ENCODE(T, t) {               \
+    auto tuple{s.beginTuple()};     \
+    s _CBOR_TUPLE(<<, __VA_ARGS__); \
+    return s.endTuple(tuple);       \
   }
 
 #define CBOR_TUPLE(T, ...)                 \
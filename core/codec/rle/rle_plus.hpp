@@ -27,14 +27,25 @@ namespace fc::codec::rle {
   }
 
   /**
-   * @brief RLE+ decode
-   * @tparam T - type of elements to decode
+   * @brief RLE+ encode runs
+   * @param input - sorted disjoint runs to encode
+   * @return Encoded byte-vector
+   */
+  inline std::vector<uint8_t> encode(const Runs &input) {
+    RLEPlusEncodingStream encoder;
+    encoder << input;
+    return encoder.data();
+  }
+
+  /**
+   * @brief RLE+ decode into container supported by decoding stream
+   * @tparam T - type of container
    * @param input - data to decode
    * @return Decoded data
    */
   template <typename T>
-  outcome::result<std::set<T>> decode(gsl::span<const uint8_t> input) {
-    std::set<T> data;
+  outcome::result<T> decodeAs(gsl::span<const uint8_t> input) {
+    T data;
     RLEPlusDecodingStream decoder(input);
     try {
       decoder >> data;
@@ -49,6 +60,26 @@ namespace fc::codec::rle {
     }
     return data;
   }
+
+  /**
+   * @brief RLE+ decode
+   * @tparam T - type of elements to decode
+   * @param input - data to decode
+   * @return Decoded data
+   */
+  template <typename T>
+  outcome::result<std::set<T>> decode(gsl::span<const uint8_t> input) {
+    return decodeAs<std::set<T>>(input);
+  }
+
+  /**
+   * @brief RLE+ decode runs without expanding them to values
+   * @param input - data to decode
+   * @return Decoded runs
+   */
+  inline outcome::result<Runs> decodeRuns(gsl::span<const uint8_t> input) {
+    return decodeAs<Runs>(input);
+  }
 };  // namespace fc::codec::rle
 
 #endif
@@ -0,0 +1,122 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_CODEC_RLE_RLE_PLUS_BITS_HPP
+#define CPP_FILECOIN_CORE_CODEC_RLE_RLE_PLUS_BITS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <gsl/span>
+
+#include "codec/rle/rle_plus_errors.hpp"
+
+namespace fc::codec::rle {
+  /**
+   * @brief Reads LSB-first bit stream, buffering up to 64 bits at once
+   */
+  class BitReader {
+   public:
+    explicit BitReader(gsl::span<const uint8_t> data) : data_{data} {
+      auto last = data_.size();
+      while (last != 0 && data_[last - 1] == 0) {
+        --last;
+      }
+      if (last != 0) {
+        auto byte = data_[last - 1];
+        ones_end_ = (last - 1) * 8;
+        while (byte != 0) {
+          ++ones_end_;
+          byte >>= 1;
+        }
+      }
+    }
+
+    /// Total number of bits
+    inline size_t size() const {
+      return data_.size() * 8;
+    }
+
+    /// Check if any set bit is left, trailing zero bits are padding
+    inline bool hasOnes() const {
+      return position_ < ones_end_;
+    }
+
+    /**
+     * @brief Read bits
+     * @param count - number of bits, at most 56
+     * @return Bits [position : position + count], first bit is LSB
+     */
+    inline uint64_t get(size_t count) {
+      if (buffered_ < count) {
+        refill();
+        if (buffered_ < count) {
+          throw errors::IndexOutOfBound();
+        }
+      }
+      auto value = word_ & ((uint64_t{1} << count) - 1);
+      word_ >>= count;
+      buffered_ -= count;
+      position_ += count;
+      return value;
+    }
+
+   private:
+    inline void refill() {
+      while (buffered_ <= 56 && next_ < data_.size()) {
+        word_ |= static_cast<uint64_t>(data_[next_++]) << buffered_;
+        buffered_ += 8;
+      }
+    }
+
+    gsl::span<const uint8_t> data_;
+    size_t next_{};     /**< Index of next byte to buffer */
+    uint64_t word_{};   /**< Buffered bits */
+    size_t buffered_{}; /**< Number of buffered bits */
+    size_t position_{}; /**< Index of next bit to read */
+    size_t ones_end_{}; /**< Index after last set bit */
+  };
+
+  /**
+   * @brief Writes LSB-first bit stream, flushing whole bytes
+   */
+  class BitWriter {
+   public:
+    inline bool empty() const {
+      return bytes_.empty() && buffered_ == 0;
+    }
+
+    /**
+     * @brief Write bits
+     * @param bits - value, first bit is LSB
+     * @param count - number of bits, at most 56
+     */
+    inline void put(uint64_t bits, size_t count) {
+      word_ |= bits << buffered_;
+      buffered_ += count;
+      while (buffered_ >= 8) {
+        bytes_.push_back(static_cast<uint8_t>(word_));
+        word_ >>= 8;
+        buffered_ -= 8;
+      }
+    }
+
+    /// Written bytes, last byte is padded with zero bits
+    inline std::vector<uint8_t> bytes() const {
+      auto bytes = bytes_;
+      if (buffered_ != 0) {
+        bytes.push_back(static_cast<uint8_t>(word_));
+      }
+      return bytes;
+    }
+
+   private:
+    std::vector<uint8_t> bytes_;
+    uint64_t word_{};
+    size_t buffered_{};
+  };
+}  // namespace fc::codec::rle
+
+#endif  // CPP_FILECOIN_CORE_CODEC_RLE_RLE_PLUS_BITS_HPP
@@ -0,0 +1,72 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "codec/rle/rle_plus_decoding_stream.hpp"
+
+namespace fc::codec::rle {
+  bool RLEPlusDecodingStream::next(Run &run) {
+    if (!started_) {
+      readHeader();
+      started_ = true;
+    }
+    while (reader_.hasOnes()) {
+      auto length = readPeriod();
+      auto set = magnitude_;
+      magnitude_ = !magnitude_;
+      value_ += length;
+      if (set && length != 0) {
+        run = {value_ - length, length};
+        return true;
+      }
+    }
+    return false;
+  }
+
+  RLEPlusDecodingStream &RLEPlusDecodingStream::operator>>(Runs &output) {
+    constexpr size_t max_size = OBJECT_MAX_SIZE / sizeof(Run);
+    Run run;
+    while (next(run)) {
+      if (!output.empty() && output.back().end() == run.start) {
+        output.back().length += run.length;
+        continue;
+      }
+      output.push_back(run);
+      if (output.size() > max_size) {
+        throw errors::MaxSizeExceed();
+      }
+    }
+    return *this;
+  }
+
+  void RLEPlusDecodingStream::readHeader() {
+    if ((reader_.size() < SMALL_BLOCK_LENGTH) || (reader_.get(2) != 0)) {
+      throw errors::VersionMismatch();
+    }
+    magnitude_ = reader_.get(1) == 1;
+  }
+
+  uint64_t RLEPlusDecodingStream::readPeriod() {
+    if (reader_.get(1) == 1) {
+      return 1;
+    }
+    if (reader_.get(1) == 1) {
+      return reader_.get(SMALL_BLOCK_LENGTH);
+    }
+    uint64_t value{};
+    size_t shift{};
+    constexpr size_t max_shift = sizeof(value) * BYTE_BITS_COUNT;
+    while (true) {
+      auto byte = reader_.get(BYTE_BITS_COUNT);
+      if (shift > max_shift) {
+        throw errors::UnpackBytesOverflow{};
+      }
+      if (byte < BYTE_SLICE_VALUE) {
+        return value | (byte << shift);
+      }
+      value |= (byte & UNPACK_BYTE_MASK) << shift;
+      shift += PACK_BYTE_SHIFT;
+    }
+  }
+}  // namespace fc::codec::rle
@@ -6,16 +6,75 @@
 #include "codec/rle/rle_plus_encoding_stream.hpp"
 
 namespace fc::codec::rle {
-  void RLEPlusEncodingStream::initContent() {
-    content_.clear();
-    content_.push_back(false);
-    content_.push_back(false);
+  RLEPlusEncodingStream &RLEPlusEncodingStream::operator<<(const Runs &runs) {
+    reset();
+    for (const auto &run : runs) {
+      *this << run;
+    }
+    return *this;
+  }
+
+  RLEPlusEncodingStream &RLEPlusEncodingStream::operator<<(const Run &run) {
+    if (run.length == 0) {
+      return *this;
+    }
+    if (pending_.length != 0 && run.start <= pending_.end()) {
+      if (run.end() > pending_.end()) {
+        pending_.length = run.end() - pending_.start;
+      }
+      return *this;
+    }
+    if (pending_.length != 0) {
+      writeRun(writer_, prev_, pending_);
+      prev_ = pending_.end();
+    }
+    pending_ = run;
+    return *this;
+  }
+
+  std::vector<uint8_t> RLEPlusEncodingStream::data() const {
+    auto writer = writer_;
+    if (pending_.length != 0) {
+      writeRun(writer, prev_, pending_);
+    }
+    if (writer.empty()) {
+      writer.put(0, 3);
+    }
+    return writer.bytes();
+  }
+
+  void RLEPlusEncodingStream::reset() {
+    writer_ = {};
+    prev_ = 0;
+    pending_ = {};
+  }
+
+  void RLEPlusEncodingStream::writeRun(BitWriter &writer,
+                                       uint64_t prev,
+                                       const Run &run) {
+    if (writer.empty()) {
+      // version 00, then polarity of the first block
+      writer.put(run.start == 0 ? 0b100 : 0, 3);
+    }
+    if (run.start != prev) {
+      writePeriod(writer, run.start - prev);
+    }
+    writePeriod(writer, run.length);
   }
 
-  void RLEPlusEncodingStream::pushByte(uint8_t byte) {
-    for (size_t i = 0; i < BYTE_BITS_COUNT; ++i) {
-      bool bit = static_cast<bool>((byte & (1 << i)) >> i);
-      content_.push_back(bit);
+  void RLEPlusEncodingStream::writePeriod(BitWriter &writer, uint64_t block) {
+    if (block == 1) {
+      writer.put(1, 1);
+    } else if (block < LONG_BLOCK_VALUE) {
+      writer.put(0b10 | (block << 2), 2 + SMALL_BLOCK_LENGTH);
+    } else {
+      writer.put(0, 2);
+      while (block >= BYTE_SLICE_VALUE) {
+        writer.put((block & UNPACK_BYTE_MASK) | BYTE_SLICE_VALUE,
+                   BYTE_BITS_COUNT);
+        block >>= PACK_BYTE_SHIFT;
+      }
+      writer.put(block, BYTE_BITS_COUNT);
     }
   }
 }  // namespace fc::codec::rle
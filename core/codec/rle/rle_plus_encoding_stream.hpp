@@ -6,12 +6,12 @@
 #ifndef CPP_FILECOIN_RLE_PLUS_ENCODING_STREAM_HPP
 #define CPP_FILECOIN_RLE_PLUS_ENCODING_STREAM_HPP
 
-#include <vector>
 #include <set>
+#include <vector>
 
-#include <boost/dynamic_bitset.hpp>
-
+#include "codec/rle/rle_plus_bits.hpp"
 #include "codec/rle/rle_plus_config.hpp"
+#include "codec/rle/rle_plus_run.hpp"
 
 namespace fc::codec::rle {
   /**
@@ -28,106 +28,64 @@ namespace fc::codec::rle {
      */
     template <typename T, typename A>
     RLEPlusEncodingStream &operator<<(const std::set<T, A> &input) {
-      std::vector<T> periods = this->getPeriods(input);
-      this->initContent();
-      bool flag = false;
-      if (!input.empty()) flag = *input.begin() == 0;
-      content_.push_back(flag);
-      for (const auto &value : periods) {
-        if (value == 1) {
-          content_.push_back(true);
-        } else if (value < LONG_BLOCK_VALUE) {
-          this->pushSmallBlock(value);
-        } else if (value >= LONG_BLOCK_VALUE) {
-          this->pushLongBlock(value);
+      reset();
+      Run run;
+      for (const auto &value : input) {
+        if (run.length != 0 && run.end() == value) {
+          ++run.length;
+          continue;
         }
+        *this << run;
+        run = {value, 1};
       }
-      return *this;
+      return *this << run;
     }
 
     /**
-     * @brief Get encoded stream content
-     * @return Stream content
+     * @brief Encode runs without expanding them to values
+     * @param runs - sorted disjoint runs to encode
+     * @return Encoded stream
      */
-    std::vector<uint8_t> data() const {
-      std::vector<uint8_t> data_content;
-      data_content.reserve(content_.num_blocks());
-      boost::to_block_range(content_, std::back_inserter(data_content));
-      return data_content;
-    }
-
-   private:
-    boost::dynamic_bitset<uint8_t> content_{}; /**< RLE+ encoded content */
+    RLEPlusEncodingStream &operator<<(const Runs &runs);
 
     /**
-     * @brief Write RLE+ header
+     * @brief Append run to stream, runs must be pushed in ascending order,
+     * overlapping and adjacent runs are coalesced
+     * @param run - run to append
+     * @return Encoded stream
      */
-    void initContent();
+    RLEPlusEncodingStream &operator<<(const Run &run);
 
     /**
-     * @brief Write RLE+ small block
-     * @tparam T - type of block value
-     * @param block - value to write
+     * @brief Get encoded stream content
+     * @return Stream content
      */
-    template <typename T>
-    void pushSmallBlock(const T block) {
-      content_.push_back(false);
-      content_.push_back(true);
-      for (size_t i = 0; i < SMALL_BLOCK_LENGTH; ++i) {
-        content_.push_back((block & (1 << i)) >> i);
-      }
-    }
+    std::vector<uint8_t> data() const;
+
+   private:
+    BitWriter writer_; /**< RLE+ encoded content */
+    uint64_t prev_{};  /**< End of the last written run */
+    Run pending_;      /**< Run which may be extended by next one */
 
     /**
-     * @brief Write RLE+ long block
-     * @tparam T - type of block value
-     * @param block - value to write
+     * @brief Clear stream content
      */
-    template <typename T>
-    void pushLongBlock(const T block) {
-      uint8_t byte{};
-      T slice = block;
-      content_.push_back(false);
-      content_.push_back(false);
-      while (slice >= BYTE_SLICE_VALUE) {
-        byte = slice | BYTE_SLICE_VALUE;
-        this->pushByte(byte);
-        slice >>= PACK_BYTE_SHIFT;
-      }
-      this->pushByte(static_cast<uint8_t>(slice));
-    }
+    void reset();
 
     /**
-     * @brief Write various byte
-     * @param byte - content to write
+     * @brief Write run, and header before the first one
+     * @param writer - output
+     * @param prev - end of the previous run
+     * @param run - run to write
      */
-    void pushByte(uint8_t byte);
+    static void writeRun(BitWriter &writer, uint64_t prev, const Run &run);
 
     /**
-     * @brief RLE+ logic - calculate periods of the integers
-     * @tparam T - type of the integers
-     * @tparam A - set's allocator
-     * @param data - input set of the integers
-     * @return Periods length
+     * @brief Write RLE+ single, small or long block
+     * @param writer - output
+     * @param block - block length
      */
-    template <typename T, typename A>
-    std::vector<T> getPeriods(const std::set<T, A> &data) const {
-      std::vector<T> periods{};
-      T prev = !data.empty() ? *data.begin() : 0;
-      if (prev != 0) periods.push_back(prev);
-      if (data.empty()) return periods;
-      periods.push_back(1);
-      for (auto index = ++data.begin(); index != data.end(); ++index) {
-        T diff = *index - prev;
-        if (diff == 1) periods.back()++;
-        if (diff > 1) {
-          periods.push_back(diff - 1);
-          periods.push_back(1);
-        }
-        prev = *index;
-      }
-      return periods;
-    }
+    static void writePeriod(BitWriter &writer, uint64_t block);
   };
 };  // namespace fc::codec::rle
 
@@ -0,0 +1,36 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_CODEC_RLE_RLE_PLUS_RUN_HPP
+#define CPP_FILECOIN_CORE_CODEC_RLE_RLE_PLUS_RUN_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace fc::codec::rle {
+  /**
+   * @brief Run of consecutive set values [start, start + length)
+   */
+  struct Run {
+    uint64_t start{};
+    uint64_t length{};
+
+    /// Value after the last one of run
+    inline uint64_t end() const {
+      return start + length;
+    }
+  };
+
+  inline bool operator==(const Run &lhs, const Run &rhs) {
+    return lhs.start == rhs.start && lhs.length == rhs.length;
+  }
+
+  /**
+   * @brief Sorted disjoint non-adjacent runs
+   */
+  using Runs = std::vector<Run>;
+}  // namespace fc::codec::rle
+
+#endif  // CPP_FILECOIN_CORE_CODEC_RLE_RLE_PLUS_RUN_HPP
@@ -0,0 +1,45 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/arena.hpp"
+
+#include <cstddef>
+
+namespace fc::common {
+  namespace {
+    struct ThreadArena {
+      alignas(std::max_align_t) std::byte block[Arena::kBlockBytes];
+      /// Blocks over first one come from heap, freed by release
+      std::pmr::monotonic_buffer_resource memory{
+          block, sizeof(block), std::pmr::new_delete_resource()};
+      size_t depth{};
+    };
+
+    ThreadArena &arena() {
+      // heap allocated, thread stack or tls could be too small for block
+      thread_local auto arena{std::make_unique<ThreadArena>()};
+      return *arena;
+    }
+  }  // namespace
+
+  Arena::Scope::Scope() {
+    ++arena().depth;
+  }
+
+  Arena::Scope::~Scope() {
+    auto &thread{arena()};
+    if (--thread.depth == 0) {
+      thread.memory.release();
+    }
+  }
+
+  std::pmr::memory_resource *Arena::resource() {
+    auto &thread{arena()};
+    if (thread.depth == 0) {
+      return std::pmr::new_delete_resource();
+    }
+    return &thread.memory;
+  }
+}  // namespace fc::common
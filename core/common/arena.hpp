@@ -0,0 +1,46 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_ARENA_HPP
+#define CPP_FILECOIN_CORE_COMMON_ARENA_HPP
+
+#include <memory>
+#include <memory_resource>
+
+namespace fc::common {
+  /**
+   * Monotonic memory of thread for objects living during one scope, e.g.
+   * message execution. Deallocation is no-op, memory is reused after
+   * outermost scope of thread exits, so objects must not outlive it.
+   */
+  class Arena {
+   public:
+    /// Block kept by thread between scopes
+    static constexpr size_t kBlockBytes{64 << 10};
+
+    /// Nested scopes share memory of outermost one
+    class Scope {
+     public:
+      Scope();
+      ~Scope();
+
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+    };
+
+    /// Arena of thread inside scope, heap outside of scope
+    static std::pmr::memory_resource *resource();
+
+    /// Allocates shared object and its control block in resource()
+    template <typename T, typename... Args>
+    static std::shared_ptr<T> make(Args &&... args) {
+      return std::allocate_shared<T>(
+          std::pmr::polymorphic_allocator<T>{resource()},
+          std::forward<Args>(args)...);
+    }
+  };
+}  // namespace fc::common
+
+#endif  // CPP_FILECOIN_CORE_COMMON_ARENA_HPP
@@ -82,6 +82,10 @@ namespace fc::common {
     return data_ == b.data_;
   }
 
+  bool Buffer::operator<(const Buffer &b) const noexcept {
+    return data_ < b.data_;
+  }
+
   Buffer::const_iterator Buffer::begin() const {
     return data_.begin();
   }
@@ -17,6 +17,9 @@
 
 namespace fc::common {
 
+  /// Borrowed bytes, accepted where bytes are only read
+  using BufferView = gsl::span<const uint8_t>;
+
   /**
    * @brief Class represents arbitrary (including empty) byte buffer.
    */
@@ -84,6 +87,11 @@ namespace fc::common {
      */
     bool operator==(gsl::span<const uint8_t> s) const noexcept;
 
+    /**
+     * @brief Lexicographical ordering of two buffers
+     */
+    bool operator<(const Buffer &b) const noexcept;
+
     /**
      * @brief Iterator, which points to begin of this buffer.
      */
@@ -237,9 +245,8 @@ namespace fc::common {
    * @return reference to stream
    */
   CBOR_DECODE(Buffer, buffer) {
-    std::vector<uint8_t> data;
-    s >> data;
-    buffer.put(data);
+    // decoded into storage directly, without temporary vector
+    s >> buffer.toVector();
     return s;
   }
 
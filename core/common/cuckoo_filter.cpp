@@ -0,0 +1,135 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/cuckoo_filter.hpp"
+
+#include <string_view>
+
+namespace fc::common {
+  CuckooFilter::CuckooFilter(size_t capacity) {
+    // filter fails inserts above 95% load
+    auto buckets{(capacity * 100 / 95 + kBucketSlots - 1) / kBucketSlots};
+    size_t power{1};
+    while (power < buckets) {
+      power <<= 1;
+    }
+    mask_ = power - 1;
+    slots_.resize(power * kBucketSlots);
+  }
+
+  uint64_t CuckooFilter::hash(BufferView key) {
+    return std::hash<std::string_view>{}(
+        {reinterpret_cast<const char *>(key.data()),
+         static_cast<size_t>(key.size())});
+  }
+
+  bool CuckooFilter::insert(uint64_t hash) {
+    if (victim_) {
+      return false;
+    }
+    auto fingerprint{this->fingerprint(hash)};
+    auto bucket{this->bucket(hash)};
+    ++size_;
+    if (add(bucket, fingerprint)) {
+      return true;
+    }
+    bucket = alternate(bucket, fingerprint);
+    for (size_t kick{0}; kick < kMaxKicks; ++kick) {
+      if (add(bucket, fingerprint)) {
+        return true;
+      }
+      // evict fingerprint from pseudo random slot to its other bucket
+      auto &slot{slots_[bucket * kBucketSlots + fingerprint % kBucketSlots]};
+      std::swap(slot, fingerprint);
+      bucket = alternate(bucket, fingerprint);
+    }
+    // evicted fingerprint belongs to other key, so it is kept
+    victim_.emplace(bucket, fingerprint);
+    return true;
+  }
+
+  bool CuckooFilter::contains(uint64_t hash) const {
+    auto fingerprint{this->fingerprint(hash)};
+    auto bucket{this->bucket(hash)};
+    auto other{alternate(bucket, fingerprint)};
+    if (victim_ && victim_->second == fingerprint
+        && (victim_->first == bucket || victim_->first == other)) {
+      return true;
+    }
+    return has(bucket, fingerprint) || has(other, fingerprint);
+  }
+
+  bool CuckooFilter::erase(uint64_t hash) {
+    auto fingerprint{this->fingerprint(hash)};
+    auto bucket{this->bucket(hash)};
+    auto other{alternate(bucket, fingerprint)};
+    if (victim_ && victim_->second == fingerprint
+        && (victim_->first == bucket || victim_->first == other)) {
+      victim_.reset();
+      --size_;
+      return true;
+    }
+    if (!remove(bucket, fingerprint) && !remove(other, fingerprint)) {
+      return false;
+    }
+    --size_;
+    if (victim_) {
+      auto victim{*victim_};
+      victim_.reset();
+      if (!add(victim.first, victim.second)
+          && !add(alternate(victim.first, victim.second), victim.second)) {
+        victim_ = victim;
+      }
+    }
+    return true;
+  }
+
+  CuckooFilter::Fingerprint CuckooFilter::fingerprint(uint64_t hash) const {
+    // high bits are independent of bucket index
+    Fingerprint fingerprint(hash >> 48);
+    return fingerprint == 0 ? 1 : fingerprint;
+  }
+
+  size_t CuckooFilter::bucket(uint64_t hash) const {
+    return hash & mask_;
+  }
+
+  size_t CuckooFilter::alternate(size_t bucket,
+                                 Fingerprint fingerprint) const {
+    return (bucket ^ (fingerprint * 0x5bd1e995ull)) & mask_;
+  }
+
+  bool CuckooFilter::has(size_t bucket, Fingerprint fingerprint) const {
+    auto slots{&slots_[bucket * kBucketSlots]};
+    for (size_t i{0}; i < kBucketSlots; ++i) {
+      if (slots[i] == fingerprint) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool CuckooFilter::add(size_t bucket, Fingerprint fingerprint) {
+    auto slots{&slots_[bucket * kBucketSlots]};
+    for (size_t i{0}; i < kBucketSlots; ++i) {
+      if (slots[i] == 0) {
+        slots[i] = fingerprint;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool CuckooFilter::remove(size_t bucket, Fingerprint fingerprint) {
+    auto slots{&slots_[bucket * kBucketSlots]};
+    for (size_t i{0}; i < kBucketSlots; ++i) {
+      if (slots[i] == fingerprint) {
+        slots[i] = 0;
+        return true;
+      }
+    }
+    return false;
+  }
+}  // namespace fc::common
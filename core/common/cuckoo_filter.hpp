@@ -0,0 +1,70 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_CUCKOO_FILTER_HPP
+#define CPP_FILECOIN_CORE_COMMON_CUCKOO_FILTER_HPP
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "common/buffer.hpp"
+
+namespace fc::common {
+  /**
+   * Approximate set of keys with 16 bit fingerprints in buckets of four.
+   * Contains has no false negatives and about 0.01% false positives.
+   * Unlike bloom filter, keys can be erased, but only keys which were
+   * inserted, otherwise other key may be lost. Not thread safe.
+   */
+  class CuckooFilter {
+   public:
+    static constexpr size_t kBucketSlots{4};
+    /// Relocations before filter is considered full
+    static constexpr size_t kMaxKicks{500};
+
+    /// Capacity is number of keys, filter takes 2 bytes per key
+    explicit CuckooFilter(size_t capacity);
+
+    /// Hash of key bytes
+    static uint64_t hash(BufferView key);
+
+    /// False if filter is full, key is not inserted then
+    bool insert(uint64_t hash);
+
+    bool contains(uint64_t hash) const;
+
+    /// False if key was not found
+    bool erase(uint64_t hash);
+
+    size_t size() const {
+      return size_;
+    }
+
+    size_t capacity() const {
+      return slots_.size();
+    }
+
+   private:
+    using Fingerprint = uint16_t;
+
+    Fingerprint fingerprint(uint64_t hash) const;
+    size_t bucket(uint64_t hash) const;
+    /// Other bucket of fingerprint, alternate of alternate is bucket
+    size_t alternate(size_t bucket, Fingerprint fingerprint) const;
+    bool has(size_t bucket, Fingerprint fingerprint) const;
+    bool add(size_t bucket, Fingerprint fingerprint);
+    bool remove(size_t bucket, Fingerprint fingerprint);
+
+    /// Zero is empty slot
+    std::vector<Fingerprint> slots_;
+    size_t mask_{};
+    size_t size_{};
+    /// Fingerprint left without slot by relocations, filter is full
+    boost::optional<std::pair<size_t, Fingerprint>> victim_;
+  };
+}  // namespace fc::common
+
+#endif  // CPP_FILECOIN_CORE_COMMON_CUCKOO_FILTER_HPP
@@ -0,0 +1,81 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_HISTOGRAM_HPP
+#define CPP_FILECOIN_CORE_COMMON_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace fc::common {
+
+  /**
+   * Thread-safe histogram of durations. Bucket i counts durations below 2^i
+   * microseconds, the last bucket is unbounded.
+   */
+  class LatencyHistogram {
+   public:
+    static constexpr size_t kBuckets{24};
+    using Clock = std::chrono::steady_clock;
+
+    struct Snapshot {
+      std::array<uint64_t, kBuckets> buckets{};
+      uint64_t count{};
+      uint64_t total_us{};
+
+      /**
+       * @brief upper bound of bucket containing given quantile
+       * @param quantile - from 0 to 1
+       * @return microseconds, 0 if empty
+       */
+      uint64_t quantileUs(double quantile) const {
+        if (count == 0) {
+          return 0;
+        }
+        auto rank = static_cast<uint64_t>(quantile * (count - 1)) + 1;
+        uint64_t seen{};
+        for (size_t i = 0; i < kBuckets; ++i) {
+          seen += buckets[i];
+          if (seen >= rank) {
+            return uint64_t{1} << i;
+          }
+        }
+        return uint64_t{1} << (kBuckets - 1);
+      }
+    };
+
+    void record(Clock::duration duration) {
+      auto us = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(duration)
+              .count());
+      size_t bucket{0};
+      while (bucket < kBuckets - 1 && (uint64_t{1} << bucket) <= us) {
+        ++bucket;
+      }
+      buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+      count_.fetch_add(1, std::memory_order_relaxed);
+      total_us_.fetch_add(us, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const {
+      Snapshot snapshot;
+      for (size_t i = 0; i < kBuckets; ++i) {
+        snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+      }
+      snapshot.count = count_.load(std::memory_order_relaxed);
+      snapshot.total_us = total_us_.load(std::memory_order_relaxed);
+      return snapshot;
+    }
+
+   private:
+    std::array<std::atomic_uint64_t, kBuckets> buckets_{};
+    std::atomic_uint64_t count_{0};
+    std::atomic_uint64_t total_us_{0};
+  };
+
+}  // namespace fc::common
+
+#endif  // CPP_FILECOIN_CORE_COMMON_HISTOGRAM_HPP
@@ -5,7 +5,22 @@
 
 #include "common/libp2p/cbor_stream.hpp"
 
+#include <algorithm>
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::common::libp2p, CborStream::Error, e) {
+  using E = fc::common::libp2p::CborStream::Error;
+  switch (e) {
+    case E::NOT_BYTES:
+      return "CborStream: expected byte string";
+    case E::BYTES_TOO_LONG:
+      return "CborStream: byte string is longer than output";
+  }
+  return "CborStream: unknown error";
+}
+
 namespace fc::common::libp2p {
+  using Head = CborBuffering::Head;
+
   CborStream::CborStream(std::shared_ptr<Stream> stream)
       : stream_{std::move(stream)} {}
 
@@ -15,9 +30,59 @@ namespace fc::common::libp2p {
 
   void CborStream::readRaw(ReadCallbackFunc cb) {
     buffering_.reset();
-    buffer_.erase(buffer_.begin(), buffer_.begin() + size_);
-    size_ = 0;
-    consume(buffer_, std::move(cb));
+    skip();
+    consume(gsl::make_span(buffer_).subspan(begin_, end_ - begin_),
+            std::move(cb));
+  }
+
+  void CborStream::readBytes(gsl::span<uint8_t> output,
+                             ReadBytesCallbackFunc cb) {
+    skip();
+    fill(1, [self{shared_from_this()}, output, cb{std::move(cb)}](auto r) {
+      if (!r) {
+        return cb(r.error());
+      }
+      size_t more{};
+      auto _head{Head::first(more, self->buffer_[self->begin_])};
+      if (!_head) {
+        return cb(_head.error());
+      }
+      auto head_size{1 + more};
+      self->fill(head_size, [self, output, cb, head{_head.value()}, head_size](
+                                auto r) mutable {
+        if (!r) {
+          return cb(r.error());
+        }
+        auto more{head_size - 1};
+        for (size_t i{1}; i < head_size; ++i) {
+          Head::next(more, self->buffer_[self->begin_ + i], head);
+        }
+        if (head.type != CborBuffering::Type::Bytes) {
+          return cb(Error::NOT_BYTES);
+        }
+        if (head.value > static_cast<size_t>(output.size())) {
+          return cb(Error::BYTES_TOO_LONG);
+        }
+        self->begin_ += head_size;
+        size_t size = head.value;
+        auto buffered{std::min(size, self->end_ - self->begin_)};
+        std::copy_n(self->buffer_.begin() + self->begin_,
+                    buffered,
+                    output.begin());
+        self->begin_ += buffered;
+        if (buffered == size) {
+          return cb(size);
+        }
+        // rest of payload goes to output directly
+        auto rest{output.subspan(buffered, size - buffered)};
+        self->stream_->read(rest, rest.size(), [cb, size](auto count) {
+          if (!count) {
+            return cb(count.error());
+          }
+          cb(size);
+        });
+      });
+    });
   }
 
   void CborStream::writeRaw(gsl::span<const uint8_t> input,
@@ -25,21 +90,68 @@ namespace fc::common::libp2p {
     stream_->write(input, input.size(), std::move(cb));
   }
 
+  void CborStream::skip() {
+    begin_ += size_;
+    size_ = 0;
+    if (begin_ == end_) {
+      begin_ = end_ = 0;
+    }
+  }
+
+  void CborStream::reserve(size_t bytes) {
+    if (buffer_.size() - end_ >= bytes) {
+      return;
+    }
+    auto buffered{end_ - begin_};
+    if (begin_ != 0 && buffer_.size() - buffered >= bytes) {
+      std::copy(buffer_.begin() + begin_,
+                buffer_.begin() + end_,
+                buffer_.begin());
+      begin_ = 0;
+      end_ = buffered;
+      return;
+    }
+    buffer_.resize(std::max(end_ + bytes, 2 * buffer_.size()));
+  }
+
+  void CborStream::fill(size_t bytes,
+                        std::function<void(outcome::result<void>)> cb) {
+    if (end_ - begin_ >= bytes) {
+      return cb(outcome::success());
+    }
+    reserve(kReserveBytes);
+    stream_->readSome(
+        gsl::make_span(buffer_).subspan(end_),
+        buffer_.size() - end_,
+        [cb{std::move(cb)}, self{shared_from_this()}, bytes](auto count) {
+          if (!count) {
+            return cb(count.error());
+          }
+          self->end_ += count.value();
+          self->fill(bytes, std::move(cb));
+        });
+  }
+
   void CborStream::readMore(ReadCallbackFunc cb) {
     if (buffering_.done()) {
-      return cb(gsl::make_span(buffer_).subspan(0, size_));
+      return cb(gsl::make_span(buffer_).subspan(begin_, size_));
     }
-    buffer_.resize(size_ + kReserveBytes);
+    // remaining bytes of current object are already consumed
+    assert(begin_ + size_ == end_);
+    auto bytes{
+        std::clamp(buffering_.moreBytes(), kReserveBytes, kMaxReadBytes)};
+    reserve(bytes);
     stream_->readSome(
-        gsl::make_span(buffer_).subspan(size_),
-        kReserveBytes,
+        gsl::make_span(buffer_).subspan(end_),
+        bytes,
         [cb{std::move(cb)}, self{shared_from_this()}](auto count) {
           if (!count) {
             return cb(count.error());
           }
-          self->buffer_.resize(self->size_ + count.value());
-          self->consume(gsl::make_span(self->buffer_).subspan(self->size_),
-                        std::move(cb));
+          auto input{gsl::make_span(self->buffer_)
+                         .subspan(self->end_, count.value())};
+          self->end_ += count.value();
+          self->consume(input, std::move(cb));
         });
   }
 
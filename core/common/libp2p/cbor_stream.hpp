@@ -19,18 +19,40 @@ namespace fc::common::libp2p {
     using ReadCallback = void(outcome::result<gsl::span<const uint8_t>>);
     using ReadCallbackFunc = std::function<ReadCallback>;
     using WriteCallbackFunc = Stream::WriteCallbackFunc;
+    using ReadBytesCallbackFunc = std::function<void(outcome::result<size_t>)>;
 
-    /// Max number of bytes to read at a time
+    enum class Error {
+      NOT_BYTES = 1,
+      BYTES_TOO_LONG,
+    };
+
+    /// Min number of bytes to read at a time
     static constexpr size_t kReserveBytes = 4 << 10;
+    /**
+     * Max number of bytes to read at a time, large byte strings and
+     * strings are read in chunks of remaining bytes up to this size
+     */
+    static constexpr size_t kMaxReadBytes = 1 << 20;
 
     explicit CborStream(std::shared_ptr<Stream> stream);
 
     /// Get underlying stream
     std::shared_ptr<Stream> stream() const;
 
-    /// Read bytes of cbor object
+    /**
+     * Read bytes of cbor object.
+     * Span is valid until next read, bytes of object are framed while
+     * reading, so decoding them is the only other pass.
+     */
     void readRaw(ReadCallbackFunc cb);
 
+    /**
+     * Read cbor byte string into preallocated output without buffering
+     * and decoding, for large payloads.
+     * Callback receives length of byte string written to output.
+     */
+    void readBytes(gsl::span<uint8_t> output, ReadBytesCallbackFunc cb);
+
     /// Read cbor object
     template <typename T>
     void read(std::function<void(outcome::result<T>)> cb) {
@@ -55,15 +77,125 @@ namespace fc::common::libp2p {
       writeRaw(encoded.value(), std::move(cb));
     }
 
+    /**
+     * Write request and read response, one step of request-response
+     * protocols like ask and query. Encoded request is kept by stream
+     * until written, so only one request or respond may be in progress on
+     * stream.
+     */
+    template <typename Request, typename Response>
+    void request(const Request &request,
+                 std::function<void(outcome::result<Response>)> cb) {
+      auto encoded{encodeOwned(request)};
+      if (!encoded) {
+        return cb(encoded.error());
+      }
+      writeRaw(write_buffer_,
+               [self{shared_from_this()}, cb{std::move(cb)}](auto written) {
+                 if (!written) {
+                   return cb(written.error());
+                 }
+                 self->read<Response>(std::move(cb));
+               });
+    }
+
+    /**
+     * Read request and write response of handler, provider side of
+     * request-response protocols. Callback gets error of read, handler or
+     * write.
+     */
+    template <typename Request, typename Response>
+    void respond(
+        std::function<outcome::result<Response>(const Request &)> handler,
+        std::function<void(outcome::result<void>)> cb) {
+      read<Request>([self{shared_from_this()},
+                     handler{std::move(handler)},
+                     cb{std::move(cb)}](auto request) {
+        if (!request) {
+          return cb(request.error());
+        }
+        auto response{handler(request.value())};
+        if (!response) {
+          return cb(response.error());
+        }
+        auto encoded{self->encodeOwned(response.value())};
+        if (!encoded) {
+          return cb(encoded.error());
+        }
+        self->writeRaw(self->write_buffer_, [cb](auto written) {
+          if (!written) {
+            return cb(written.error());
+          }
+          cb(outcome::success());
+        });
+      });
+    }
+
+    /// Response encoded once and shared between streams
+    using Encoded = std::shared_ptr<const std::vector<uint8_t>>;
+
+    /**
+     * Read request and write pre-encoded response of handler, for
+     * responders caching answers. Encoded bytes are kept alive by write
+     * callback, so they are not copied into write buffer.
+     */
+    template <typename Request>
+    void respondEncoded(
+        std::function<outcome::result<Encoded>(const Request &)> handler,
+        std::function<void(outcome::result<void>)> cb) {
+      read<Request>([self{shared_from_this()},
+                     handler{std::move(handler)},
+                     cb{std::move(cb)}](auto request) {
+        if (!request) {
+          return cb(request.error());
+        }
+        auto response{handler(request.value())};
+        if (!response) {
+          return cb(response.error());
+        }
+        auto encoded{std::move(response.value())};
+        self->writeRaw(*encoded, [cb, encoded](auto written) {
+          if (!written) {
+            return cb(written.error());
+          }
+          cb(outcome::success());
+        });
+      });
+    }
+
    private:
+    /// Encodes value into write buffer, which lives until write completes
+    template <typename T>
+    outcome::result<void> encodeOwned(const T &value) {
+      OUTCOME_TRY(encoded, codec::cbor::encode(value));
+      write_buffer_ = std::move(encoded.toVector());
+      return outcome::success();
+    }
+
     void readMore(ReadCallbackFunc cb);
     void consume(gsl::span<uint8_t> input, ReadCallbackFunc cb);
+    /// Drops bytes of previous object
+    void skip();
+    /// Makes space for bytes after end of buffered bytes
+    void reserve(size_t bytes);
+    /// Reads until at least bytes are buffered
+    void fill(size_t bytes, std::function<void(outcome::result<void>)> cb);
 
     std::shared_ptr<Stream> stream_;
     CborBuffering buffering_;
+    /// Reused between objects, grows geometrically
     std::vector<uint8_t> buffer_;
+    /// Start of current object in buffer
+    size_t begin_{};
+    /// Bytes of current object framed so far
     size_t size_{};
+    /// End of bytes read from stream
+    size_t end_{};
+    /// Encoded request or response being written
+    std::vector<uint8_t> write_buffer_;
   };
 }  // namespace fc::common::libp2p
 
+OUTCOME_HPP_DECLARE_ERROR(fc::common::libp2p, CborStream::Error)
+
 #endif  // CPP_FILECOIN_CORE_COMMON_LIBP2P_CBOR_STREAM_HPP
@@ -5,8 +5,22 @@
 
 #include "common/logger.hpp"
 
+#include <algorithm>
+
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+OUTCOME_CPP_DEFINE_CATEGORY(fc::common, LoggerError, e) {
+  using E = fc::common::LoggerError;
+  switch (e) {
+    case E::UNKNOWN_LOGGER:
+      return "LoggerError: unknown logger";
+    case E::UNKNOWN_LEVEL:
+      return "LoggerError: unknown log level";
+  }
+  return "LoggerError: unknown error";
+}
+
 namespace {
   void setGlobalPattern(spdlog::logger &logger) {
     logger.set_pattern("[%Y-%m-%d %H:%M:%S.%F] %n %v");
@@ -16,14 +30,34 @@ namespace {
     logger.set_pattern("[%Y-%m-%d %H:%M:%S.%F][th:%t][%l] %n %v");
   }
 
+  /// Console sink and writer thread shared by all loggers
+  struct Backend {
+    Backend() {
+      spdlog::init_thread_pool(fc::common::kLogQueueSize, 1);
+      pool = spdlog::thread_pool();
+    }
+
+    std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> sink{
+        std::make_shared<spdlog::sinks::stdout_color_sink_mt>()};
+    std::shared_ptr<spdlog::details::thread_pool> pool;
+  };
+
   std::shared_ptr<spdlog::logger> createLogger(const std::string &tag,
                                                bool debug_mode = true) {
-    auto logger = spdlog::stdout_color_mt(tag);
+    static Backend backend;
+    auto logger = std::make_shared<spdlog::async_logger>(
+        tag,
+        backend.sink,
+        backend.pool,
+        spdlog::async_overflow_policy::overrun_oldest);
     if (debug_mode) {
       setDebugPattern(*logger);
     } else {
       setGlobalPattern(*logger);
     }
+    // errors are written before crash is likely
+    logger->flush_on(spdlog::level::err);
+    spdlog::register_logger(logger);
     return logger;
   }
 }  // namespace
@@ -38,4 +72,33 @@ namespace fc::common {
     }
     return logger;
   }
+
+  std::vector<std::string> loggerTags() {
+    std::vector<std::string> tags;
+    spdlog::apply_all([&](const Logger &logger) {
+      tags.push_back(logger->name());
+    });
+    std::sort(tags.begin(), tags.end());
+    return tags;
+  }
+
+  outcome::result<void> setLogLevel(const std::string &tag,
+                                    const std::string &level) {
+    auto parsed = spdlog::level::from_str(level);
+    // unknown names parse as off
+    if (parsed == spdlog::level::off && level != "off") {
+      return LoggerError::UNKNOWN_LEVEL;
+    }
+    if (tag == "*") {
+      spdlog::apply_all(
+          [&](const Logger &logger) { logger->set_level(parsed); });
+      return outcome::success();
+    }
+    auto logger = spdlog::get(tag);
+    if (logger == nullptr) {
+      return LoggerError::UNKNOWN_LOGGER;
+    }
+    logger->set_level(parsed);
+    return outcome::success();
+  }
 }  // namespace fc::common
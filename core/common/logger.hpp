@@ -9,15 +9,45 @@
 #include <spdlog/fmt/ostr.h>
 #include <spdlog/spdlog.h>
 
+#include "common/outcome.hpp"
+
 namespace fc::common {
   using Logger = std::shared_ptr<spdlog::logger>;
 
   /**
-   * Provide logger object
+   * Messages queued for writer thread. When queue is full oldest message is
+   * dropped, so logging never blocks caller.
+   */
+  constexpr size_t kLogQueueSize{8192};
+
+  enum class LoggerError {
+    UNKNOWN_LOGGER = 1,
+    UNKNOWN_LEVEL,
+  };
+
+  /**
+   * Provide logger object. Loggers format and write messages on background
+   * thread. Trace and debug messages logged with SPDLOG_LOGGER_TRACE and
+   * SPDLOG_LOGGER_DEBUG are compiled out unless SPDLOG_ACTIVE_LEVEL allows
+   * them.
    * @param tag - tagging name for identifying logger
    * @return logger object
    */
   Logger createLogger(const std::string &tag);
+
+  /// Tags of created loggers, sorted
+  std::vector<std::string> loggerTags();
+
+  /**
+   * Changes level of logger at runtime
+   * @param tag - logger tag, or "*" for all loggers
+   * @param level - one of "trace", "debug", "info", "warning", "error",
+   * "critical" and "off"
+   */
+  outcome::result<void> setLogLevel(const std::string &tag,
+                                    const std::string &level);
 }  // namespace fc::common
 
+OUTCOME_HPP_DECLARE_ERROR(fc::common, LoggerError);
+
 #endif  // CPP_FILECOIN_LOGGER_HPP
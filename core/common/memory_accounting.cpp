@@ -0,0 +1,129 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Replacement of global operator new and delete, which tags allocations
+ * with memory domain of allocating thread. Each allocation is prefixed
+ * with header of size and domain, so it is freed from the same domain on
+ * any thread. Aligned operators are not replaced, they are not accounted.
+ * Not compatible with sanitizers replacing operator new.
+ * Hooks must not allocate, domain lookup and counters are atomics only.
+ * Linked as object files into binaries:
+ *   add_executable(node main.cpp $<TARGET_OBJECTS:memory_accounting>)
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "common/memory_domain.hpp"
+
+namespace {
+  using fc::common::MemoryDomain;
+
+  struct alignas(alignof(std::max_align_t)) Header {
+    size_t size;
+    MemoryDomain::Id domain;
+    /// Allocations made before domain was created are not accounted
+    bool accounted;
+  };
+
+  void *allocate(size_t size) noexcept {
+    auto raw{std::malloc(sizeof(Header) + size)};
+    if (raw == nullptr) {
+      return nullptr;
+    }
+    auto header{
+        new (raw) Header{size, fc::common::currentMemoryDomain(), false}};
+    if (auto domain{fc::common::findMemoryDomain(header->domain)}) {
+      domain->allocated(size);
+      header->accounted = true;
+    }
+    return header + 1;
+  }
+
+  void deallocate(void *p) noexcept {
+    if (p == nullptr) {
+      return;
+    }
+    auto header{static_cast<Header *>(p) - 1};
+    if (header->accounted) {
+      if (auto domain{fc::common::findMemoryDomain(header->domain)}) {
+        domain->freed(header->size);
+      }
+    }
+    std::free(header);
+  }
+
+  void *allocateOrThrow(size_t size) {
+    if (size == 0) {
+      size = 1;
+    }
+    while (true) {
+      if (auto p{allocate(size)}) {
+        return p;
+      }
+      auto handler{std::get_new_handler()};
+      if (handler == nullptr) {
+        throw std::bad_alloc{};
+      }
+      handler();
+    }
+  }
+
+  const struct EnableAccounting {
+    EnableAccounting() {
+      fc::common::memoryDomain("untagged");
+      fc::common::enableMemoryAccounting();
+    }
+  } enable_accounting;
+}  // namespace
+
+void *operator new(size_t size) {
+  return allocateOrThrow(size);
+}
+
+void *operator new[](size_t size) {
+  return allocateOrThrow(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return allocateOrThrow(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return allocateOrThrow(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void *p) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void *p) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  deallocate(p);
+}
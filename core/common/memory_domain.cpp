@@ -0,0 +1,164 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/memory_domain.hpp"
+
+#include <malloc.h>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace fc::common {
+  namespace {
+    // trivially constructed, may be read from allocator before main
+    thread_local MemoryDomain::Id current_domain{MemoryDomain::kUntagged};
+
+    std::atomic_bool accounting_enabled{false};
+
+    /**
+     * Zero initialized before any code runs, so allocator hooks read it
+     * without initialization of domains
+     */
+    std::array<std::atomic<MemoryDomain *>, MemoryDomain::kMaxDomains>
+        domain_by_id;
+
+    struct Domains {
+      std::mutex mutex;
+      std::map<std::string, MemoryDomain *> by_name;
+      /// Created domains are never destroyed, hooks may use them at exit
+      std::vector<std::unique_ptr<MemoryDomain>> owned;
+
+      MemoryDomain &create(const std::string &name) {
+        auto id{static_cast<MemoryDomain::Id>(owned.size())};
+        auto &domain{
+            *owned.emplace_back(std::make_unique<MemoryDomain>(id, name))};
+        by_name.emplace(name, &domain);
+        domain_by_id[id].store(&domain, std::memory_order_release);
+        return domain;
+      }
+
+      MemoryDomain &get(const std::string &name) {
+        std::lock_guard lock{mutex};
+        if (owned.empty()) {
+          create("untagged");
+        }
+        auto it{by_name.find(name)};
+        if (it != by_name.end()) {
+          return *it->second;
+        }
+        if (owned.size() == MemoryDomain::kMaxDomains) {
+          return *owned.back();
+        }
+        return create(name);
+      }
+    };
+
+    Domains &domains() {
+      static auto &domains{*new Domains{}};
+      return domains;
+    }
+  }  // namespace
+
+  MemoryDomain::MemoryDomain(Id id, std::string name)
+      : id_{id},
+        name_{std::move(name)},
+        live_{metrics::registry().gauge("fc_memory_domain_live_bytes",
+                                        "Bytes allocated and not freed",
+                                        {{"domain", name_}})},
+        allocated_{metrics::registry().counter(
+            "fc_memory_domain_allocated_bytes",
+            "Bytes allocated in total",
+            {{"domain", name_}})},
+        allocations_{metrics::registry().counter(
+            "fc_memory_domain_allocations",
+            "Allocations in total",
+            {{"domain", name_}})} {}
+
+  MemoryDomain &memoryDomain(const std::string &name) {
+    return domains().get(name);
+  }
+
+  MemoryDomain *findMemoryDomain(MemoryDomain::Id id) {
+    // called from operator new, must not allocate or lock
+    if (id >= domain_by_id.size()) {
+      return nullptr;
+    }
+    return domain_by_id[id].load(std::memory_order_acquire);
+  }
+
+  std::vector<MemoryDomain *> memoryDomains() {
+    auto &all{domains()};
+    std::lock_guard lock{all.mutex};
+    std::vector<MemoryDomain *> result;
+    for (auto &domain : all.owned) {
+      result.push_back(domain.get());
+    }
+    return result;
+  }
+
+  MemoryDomain::Id currentMemoryDomain() {
+    return current_domain;
+  }
+
+  MemoryDomainScope::MemoryDomainScope(const MemoryDomain &domain)
+      : previous_{current_domain} {
+    current_domain = domain.id();
+  }
+
+  MemoryDomainScope::MemoryDomainScope(const std::string &name)
+      : MemoryDomainScope{memoryDomain(name)} {}
+
+  MemoryDomainScope::~MemoryDomainScope() {
+    current_domain = previous_;
+  }
+
+  void *MemoryDomainResource::do_allocate(size_t bytes, size_t alignment) {
+    auto p{upstream_->allocate(bytes, alignment)};
+    domain_.allocated(bytes);
+    return p;
+  }
+
+  void MemoryDomainResource::do_deallocate(void *p,
+                                           size_t bytes,
+                                           size_t alignment) {
+    upstream_->deallocate(p, bytes, alignment);
+    domain_.freed(bytes);
+  }
+
+  bool MemoryDomainResource::do_is_equal(
+      const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+  }
+
+  bool memoryAccountingEnabled() {
+    return accounting_enabled.load(std::memory_order_relaxed);
+  }
+
+  void enableMemoryAccounting() {
+    accounting_enabled.store(true, std::memory_order_relaxed);
+  }
+
+  std::string heapProfile() {
+    std::stringstream s;
+    s << "# accounting "
+      << (memoryAccountingEnabled() ? "global allocator" : "pmr only") << "\n";
+    s << "# domain live_bytes allocated_bytes allocations\n";
+    for (auto domain : memoryDomains()) {
+      s << domain->name() << " " << domain->live() << " "
+        << domain->allocatedBytes() << " " << domain->allocations() << "\n";
+    }
+    char *xml{};
+    size_t size{};
+    if (auto file{open_memstream(&xml, &size)}) {
+      malloc_info(0, file);
+      fclose(file);
+      s << std::string_view{xml, size};
+      free(xml);
+    }
+    return s.str();
+  }
+}  // namespace fc::common
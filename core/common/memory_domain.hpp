@@ -0,0 +1,145 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_MEMORY_DOMAIN_HPP
+#define CPP_FILECOIN_CORE_COMMON_MEMORY_DOMAIN_HPP
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "common/metrics.hpp"
+
+namespace fc::common {
+  /**
+   * Subsystem which allocations are accounted together, e.g. "vm" or
+   * "graphsync". Allocations are tagged with domain of current thread,
+   * set by MemoryDomainScope, or made through MemoryDomainResource.
+   * Global allocator is accounted only in binaries linking
+   * memory_accounting, which prefixes each allocation with domain tag.
+   * Metrics, labeled with domain name:
+   *   fc_memory_domain_live_bytes - bytes allocated and not freed,
+   *   fc_memory_domain_allocated_bytes, fc_memory_domain_allocations -
+   *   totals, their rates are allocation rates.
+   */
+  class MemoryDomain {
+   public:
+    using Id = uint8_t;
+
+    /// Max number of domains, further names share last one
+    static constexpr size_t kMaxDomains{32};
+    /// Domain of allocations outside of scopes
+    static constexpr Id kUntagged{0};
+
+    MemoryDomain(Id id, std::string name);
+
+    Id id() const {
+      return id_;
+    }
+
+    const std::string &name() const {
+      return name_;
+    }
+
+    void allocated(size_t bytes) {
+      live_.add(static_cast<int64_t>(bytes));
+      allocated_.add(bytes);
+      allocations_.add();
+    }
+
+    void freed(size_t bytes) {
+      live_.add(-static_cast<int64_t>(bytes));
+    }
+
+    int64_t live() const {
+      return live_.value();
+    }
+
+    uint64_t allocatedBytes() const {
+      return allocated_.value();
+    }
+
+    uint64_t allocations() const {
+      return allocations_.value();
+    }
+
+   private:
+    Id id_;
+    std::string name_;
+    metrics::Gauge &live_;
+    metrics::Counter &allocated_;
+    metrics::Counter &allocations_;
+  };
+
+  /// Domain of name, created on first call
+  MemoryDomain &memoryDomain(const std::string &name);
+
+  /**
+   * Domain of id, lock-free, for allocator hooks.
+   * Must never allocate, it is called from replaced operator new, so
+   * allocation would recurse into it.
+   * Null if domain is not created yet.
+   */
+  MemoryDomain *findMemoryDomain(MemoryDomain::Id id);
+
+  /// Created domains, ordered by id
+  std::vector<MemoryDomain *> memoryDomains();
+
+  /// Domain of current thread allocations
+  MemoryDomain::Id currentMemoryDomain();
+
+  /**
+   * Tags allocations of current thread with domain until destroyed,
+   * scopes nest
+   */
+  class MemoryDomainScope {
+   public:
+    explicit MemoryDomainScope(const MemoryDomain &domain);
+    /// Looks domain up by name, for cold paths
+    explicit MemoryDomainScope(const std::string &name);
+    ~MemoryDomainScope();
+
+    MemoryDomainScope(const MemoryDomainScope &) = delete;
+    MemoryDomainScope &operator=(const MemoryDomainScope &) = delete;
+
+   private:
+    MemoryDomain::Id previous_;
+  };
+
+  /**
+   * Accounts allocations of pmr containers to domain regardless of global
+   * allocator, e.g. for module owned queues and caches
+   */
+  class MemoryDomainResource : public std::pmr::memory_resource {
+   public:
+    explicit MemoryDomainResource(
+        MemoryDomain &domain,
+        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+        : domain_{domain}, upstream_{upstream} {}
+
+   private:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource &other) const noexcept override;
+
+    MemoryDomain &domain_;
+    std::pmr::memory_resource *upstream_;
+  };
+
+  /// Whether global allocator is accounted, memory_accounting is linked
+  bool memoryAccountingEnabled();
+
+  /// Called by memory_accounting on static initialization
+  void enableMemoryAccounting();
+
+  /**
+   * Heap profile of running node: table of domains with live and total
+   * bytes, followed by malloc_info xml of allocator arenas
+   */
+  std::string heapProfile();
+}  // namespace fc::common
+
+#endif  // CPP_FILECOIN_CORE_COMMON_MEMORY_DOMAIN_HPP
@@ -0,0 +1,133 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/memory_governor.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace fc::common {
+  namespace {
+    /// v1 reports unlimited memory as page aligned max int64
+    constexpr size_t kUnlimited{size_t{1} << 60};
+
+    boost::optional<size_t> readLimit(const std::string &path) {
+      std::ifstream file{path};
+      std::string value;
+      if (!(file >> value) || value == "max") {
+        return boost::none;
+      }
+      try {
+        auto limit{std::stoull(value)};
+        if (limit == 0 || limit >= kUnlimited) {
+          return boost::none;
+        }
+        return limit;
+      } catch (const std::exception &) {
+        return boost::none;
+      }
+    }
+  }  // namespace
+
+  boost::optional<size_t> cgroupMemoryLimit(const std::string &root) {
+    if (auto limit{readLimit(root + "/memory.max")}) {
+      return limit;
+    }
+    return readLimit(root + "/memory/memory.limit_in_bytes");
+  }
+
+  MemoryGovernor::Options MemoryGovernor::Options::load(
+      storage::config::Config &config) {
+    Options options;
+    if (auto budget{config.get<size_t>("memory.budget")}) {
+      options.budget = budget.value();
+    }
+    auto share{config.get<double>("memory.cgroup_share")};
+    if (share && share.value() > 0 && share.value() <= 1) {
+      options.cgroup_share = share.value();
+    }
+    return options;
+  }
+
+  MemoryGovernor::MemoryGovernor(Options options,
+                                 boost::optional<size_t> cgroup_limit)
+      : budget_{options.budget} {
+    if (cgroup_limit) {
+      auto share{static_cast<size_t>(*cgroup_limit * options.cgroup_share)};
+      if (budget_ == 0 || share < budget_) {
+        budget_ = share;
+      }
+    }
+    metrics::registry()
+        .gauge("fc_memory_budget_bytes", "Memory budget of caches")
+        .set(static_cast<int64_t>(budget_));
+  }
+
+  MemoryGovernor::Id MemoryGovernor::add(const std::string &name,
+                                         Cache cache) {
+    auto &gauge{metrics::registry().gauge(
+        "fc_memory_cache_bytes", "Memory used by cache", {{"cache", name}})};
+    std::lock_guard lock{mutex_};
+    auto id{++next_id_};
+    caches_.emplace(id,
+                    std::make_shared<Entry>(Entry{std::move(cache), gauge}));
+    return id;
+  }
+
+  void MemoryGovernor::remove(Id id) {
+    std::lock_guard lock{mutex_};
+    caches_.erase(id);
+  }
+
+  std::vector<std::shared_ptr<MemoryGovernor::Entry>>
+  MemoryGovernor::entries() const {
+    std::lock_guard lock{mutex_};
+    std::vector<std::shared_ptr<Entry>> entries;
+    entries.reserve(caches_.size());
+    for (auto &cache : caches_) {
+      entries.push_back(cache.second);
+    }
+    return entries;
+  }
+
+  size_t MemoryGovernor::usage() const {
+    size_t total{};
+    for (auto &entry : entries()) {
+      total += entry->cache.usage();
+    }
+    return total;
+  }
+
+  size_t MemoryGovernor::enforce() {
+    auto caches{entries()};
+    std::vector<size_t> usages;
+    usages.reserve(caches.size());
+    size_t total{};
+    for (auto &entry : caches) {
+      auto usage{entry->cache.usage()};
+      entry->gauge.set(static_cast<int64_t>(usage));
+      usages.push_back(usage);
+      total += usage;
+    }
+    if (budget_ == 0 || total <= budget_) {
+      return 0;
+    }
+    auto over{total - budget_};
+    size_t freed{};
+    for (size_t i{}; i < caches.size(); ++i) {
+      if (usages[i] == 0) {
+        continue;
+      }
+      // same share of every cache, rounded up to reach budget
+      auto share{static_cast<size_t>(
+          (static_cast<__uint128_t>(over) * usages[i] + total - 1) / total)};
+      auto evicted{caches[i]->cache.shrink(share)};
+      usages[i] -= std::min(usages[i], evicted);
+      caches[i]->gauge.set(static_cast<int64_t>(usages[i]));
+      freed += evicted;
+    }
+    return freed;
+  }
+}  // namespace fc::common
@@ -0,0 +1,102 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_MEMORY_GOVERNOR_HPP
+#define CPP_FILECOIN_CORE_COMMON_MEMORY_GOVERNOR_HPP
+
+#include <boost/optional.hpp>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "common/metrics.hpp"
+#include "storage/config/config.hpp"
+
+namespace fc::common {
+  /**
+   * Memory limit of cgroup of process, v2 "memory.max" or v1
+   * "memory/memory.limit_in_bytes" under root.
+   * None if unlimited or not in cgroup.
+   */
+  boost::optional<size_t> cgroupMemoryLimit(
+      const std::string &root = "/sys/fs/cgroup");
+
+  /**
+   * Keeps total size of registered caches within one budget, so node
+   * memory stays predictable with many caches. Caches report usage and
+   * evict on request, governor asks every cache over budget to give up
+   * same share of its usage.
+   * Metrics:
+   *   fc_memory_budget_bytes - budget of caches,
+   *   fc_memory_cache_bytes - usage labeled with cache name.
+   */
+  class MemoryGovernor {
+   public:
+    struct Options {
+      /// Total size of caches in bytes, zero is no budget
+      size_t budget{};
+      /// Share of cgroup limit given to caches, rest is left to node
+      double cgroup_share{0.5};
+
+      /**
+       * @brief reads "memory.budget" and "memory.cgroup_share" keys,
+       * missing keys keep default values
+       * @param config node configuration
+       */
+      static Options load(storage::config::Config &config);
+    };
+
+    /// Callbacks of registered cache, called without governor lock held
+    struct Cache {
+      /// Bytes held by cache
+      std::function<size_t()> usage;
+      /// Evicts at least given bytes if possible, returns evicted bytes
+      std::function<size_t(size_t)> shrink;
+    };
+
+    using Id = uint64_t;
+
+    /// Budget is limited by share of cgroup limit, if any
+    explicit MemoryGovernor(
+        Options options, boost::optional<size_t> cgroup_limit = {});
+
+    /// Zero if unlimited
+    size_t budget() const {
+      return budget_;
+    }
+
+    /// Registers cache, name labels its metrics
+    Id add(const std::string &name, Cache cache);
+
+    void remove(Id id);
+
+    /// Total usage of caches
+    size_t usage() const;
+
+    /**
+     * Shrinks caches if their total usage is over budget, called
+     * periodically by owner.
+     * @return evicted bytes
+     */
+    size_t enforce();
+
+   private:
+    struct Entry {
+      Cache cache;
+      metrics::Gauge &gauge;
+    };
+
+    /// Copy of entries, so callbacks run without lock
+    std::vector<std::shared_ptr<Entry>> entries() const;
+
+    size_t budget_;
+    mutable std::mutex mutex_;
+    Id next_id_{};
+    std::map<Id, std::shared_ptr<Entry>> caches_;
+  };
+}  // namespace fc::common
+
+#endif  // CPP_FILECOIN_CORE_COMMON_MEMORY_GOVERNOR_HPP
@@ -0,0 +1,154 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/metrics.hpp"
+
+#include <boost/assert.hpp>
+#include <iomanip>
+#include <sstream>
+
+namespace fc::common::metrics {
+  namespace {
+    /// Escapes label value as prometheus text format requires
+    std::string escape(const std::string &value) {
+      std::string escaped;
+      for (auto c : value) {
+        if (c == '\\' || c == '"') {
+          escaped += '\\';
+          escaped += c;
+        } else if (c == '\n') {
+          escaped += "\\n";
+        } else {
+          escaped += c;
+        }
+      }
+      return escaped;
+    }
+
+    /// Labels as written inside braces, sorted by name
+    std::string encodeLabels(const Labels &labels) {
+      std::string encoded;
+      for (auto &[name, value] : labels) {
+        if (!encoded.empty()) {
+          encoded += ',';
+        }
+        encoded += name + "=\"" + escape(value) + '"';
+      }
+      return encoded;
+    }
+
+    /// Name with labels and extra label, e.g. histogram bucket bound
+    std::string series(const std::string &name,
+                       const std::string &labels,
+                       const std::string &extra = {}) {
+      auto all{labels};
+      if (!extra.empty()) {
+        all += (all.empty() ? "" : ",") + extra;
+      }
+      return all.empty() ? name : name + '{' + all + '}';
+    }
+  }  // namespace
+
+  Registry::Family &Registry::family(const std::string &name,
+                                     const std::string &help,
+                                     Kind kind) {
+    auto it{families_.find(name)};
+    if (it == families_.end()) {
+      it = families_.emplace(name, Family{kind, help, {}, {}, {}}).first;
+    }
+    BOOST_ASSERT_MSG(it->second.kind == kind,
+                     "metric registered with other kind");
+    return it->second;
+  }
+
+  Counter &Registry::counter(const std::string &name,
+                             const std::string &help,
+                             const Labels &labels) {
+    std::lock_guard lock{mutex_};
+    auto &metric{family(name, help, Kind::COUNTER)
+                     .counters[encodeLabels(labels)]};
+    if (!metric) {
+      metric = std::make_unique<Counter>();
+    }
+    return *metric;
+  }
+
+  Gauge &Registry::gauge(const std::string &name,
+                         const std::string &help,
+                         const Labels &labels) {
+    std::lock_guard lock{mutex_};
+    auto &metric{
+        family(name, help, Kind::GAUGE).gauges[encodeLabels(labels)]};
+    if (!metric) {
+      metric = std::make_unique<Gauge>();
+    }
+    return *metric;
+  }
+
+  LatencyHistogram &Registry::histogram(const std::string &name,
+                                        const std::string &help,
+                                        const Labels &labels) {
+    std::lock_guard lock{mutex_};
+    auto &metric{family(name, help, Kind::HISTOGRAM)
+                     .histograms[encodeLabels(labels)]};
+    if (!metric) {
+      metric = std::make_unique<LatencyHistogram>();
+    }
+    return *metric;
+  }
+
+  std::string Registry::prometheus() const {
+    std::lock_guard lock{mutex_};
+    std::ostringstream out;
+    // seconds of microsecond durations are exact
+    out << std::setprecision(12);
+    for (auto &[name, family] : families_) {
+      out << "# HELP " << name << ' ' << family.help << '\n';
+      switch (family.kind) {
+        case Kind::COUNTER:
+          out << "# TYPE " << name << " counter\n";
+          for (auto &[labels, counter] : family.counters) {
+            out << series(name, labels) << ' ' << counter->value() << '\n';
+          }
+          break;
+        case Kind::GAUGE:
+          out << "# TYPE " << name << " gauge\n";
+          for (auto &[labels, gauge] : family.gauges) {
+            out << series(name, labels) << ' ' << gauge->value() << '\n';
+          }
+          break;
+        case Kind::HISTOGRAM:
+          out << "# TYPE " << name << " histogram\n";
+          for (auto &[labels, histogram] : family.histograms) {
+            auto snapshot{histogram->snapshot()};
+            uint64_t cumulative{0};
+            // last bucket is unbounded, it is +Inf bucket
+            for (size_t i{0}; i + 1 < LatencyHistogram::kBuckets; ++i) {
+              cumulative += snapshot.buckets[i];
+              std::ostringstream bound;
+              bound << std::setprecision(12) << "le=\""
+                    << (uint64_t{1} << i) / 1e6 << '"';
+              out << series(name + "_bucket", labels, bound.str()) << ' '
+                  << cumulative << '\n';
+            }
+            out << series(name + "_bucket", labels, "le=\"+Inf\"") << ' '
+                << snapshot.count << '\n';
+            out << series(name + "_sum", labels) << ' '
+                << snapshot.total_us / 1e6 << '\n';
+            out << series(name + "_count", labels) << ' ' << snapshot.count
+                << '\n';
+          }
+          break;
+      }
+    }
+    return out.str();
+  }
+
+  Registry &registry() {
+    // never destroyed, allocator hooks update metrics during exit
+    static auto &registry{*new Registry{}};
+    return registry;
+  }
+}  // namespace fc::common::metrics
@@ -0,0 +1,122 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_METRICS_HPP
+#define CPP_FILECOIN_CORE_COMMON_METRICS_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "common/histogram.hpp"
+
+namespace fc::common::metrics {
+  using Labels = std::map<std::string, std::string>;
+
+  /// Monotonic counter
+  class Counter {
+   public:
+    void add(uint64_t value = 1) {
+      value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const {
+      return value_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic_uint64_t value_{0};
+  };
+
+  /// Value which goes up and down, e.g. queue size
+  class Gauge {
+   public:
+    void set(int64_t value) {
+      value_.store(value, std::memory_order_relaxed);
+    }
+
+    void add(int64_t value) {
+      value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    int64_t value() const {
+      return value_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic_int64_t value_{0};
+  };
+
+  /**
+   * Named metrics with labels. Lookup locks registry, so instrumented code
+   * looks metrics up once and keeps references, updates are lock-free.
+   * Metrics live as long as registry.
+   */
+  class Registry {
+   public:
+    /**
+     * @brief returns metric of name and labels, creates it on first call
+     * @param name - prometheus metric name, e.g. "fc_datastore_get_bytes"
+     * @param help - description, first one is kept
+     * @param labels - distinguish metrics of same name
+     */
+    Counter &counter(const std::string &name,
+                     const std::string &help,
+                     const Labels &labels = {});
+
+    Gauge &gauge(const std::string &name,
+                 const std::string &help,
+                 const Labels &labels = {});
+
+    /// Histogram of durations, exported in seconds
+    LatencyHistogram &histogram(const std::string &name,
+                                const std::string &help,
+                                const Labels &labels = {});
+
+    /// Metrics in prometheus text exposition format
+    std::string prometheus() const;
+
+   private:
+    enum class Kind { COUNTER, GAUGE, HISTOGRAM };
+
+    /// Metrics of one name, by encoded labels
+    struct Family {
+      Kind kind;
+      std::string help;
+      std::map<std::string, std::unique_ptr<Counter>> counters;
+      std::map<std::string, std::unique_ptr<Gauge>> gauges;
+      std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms;
+    };
+
+    Family &family(const std::string &name, const std::string &help, Kind kind);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+  };
+
+  /// Registry of process, exported by metrics endpoint
+  Registry &registry();
+
+  /// Records time from construction to destruction in histogram
+  class Timer {
+   public:
+    explicit Timer(LatencyHistogram &histogram)
+        : histogram_{histogram}, start_{LatencyHistogram::Clock::now()} {}
+
+    ~Timer() {
+      histogram_.record(LatencyHistogram::Clock::now() - start_);
+    }
+
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+
+   private:
+    LatencyHistogram &histogram_;
+    LatencyHistogram::Clock::time_point start_;
+  };
+}  // namespace fc::common::metrics
+
+#endif  // CPP_FILECOIN_CORE_COMMON_METRICS_HPP
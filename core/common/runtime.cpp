@@ -0,0 +1,48 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/runtime.hpp"
+
+#include <thread>
+
+namespace fc::common {
+  namespace {
+    size_t cpuThreads(size_t threads) {
+      if (threads != 0) {
+        return threads;
+      }
+      return std::max(1u, std::thread::hardware_concurrency());
+    }
+  }  // namespace
+
+  Runtime::Runtime(size_t cpu_threads, size_t blocking_threads)
+      : cpu_threads_{cpuThreads(cpu_threads)},
+        cpu_{cpu_threads_},
+        blocking_{std::max<size_t>(blocking_threads, 1)} {}
+
+  Runtime::~Runtime() {
+    stop();
+    cpu_.join();
+    blocking_.join();
+  }
+
+  Runtime::Strand Runtime::strand(const std::string &domain) {
+    std::lock_guard lock{mutex_};
+    auto it{strands_.find(domain)};
+    if (it == strands_.end()) {
+      it = strands_.emplace(domain, newStrand()).first;
+    }
+    return it->second;
+  }
+
+  Runtime::Strand Runtime::newStrand() {
+    return Strand{cpu_.get_executor()};
+  }
+
+  void Runtime::stop() {
+    cpu_.stop();
+    blocking_.stop();
+  }
+}  // namespace fc::common
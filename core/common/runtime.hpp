@@ -0,0 +1,72 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_RUNTIME_HPP
+#define CPP_FILECOIN_CORE_COMMON_RUNTIME_HPP
+
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace fc::common {
+  /**
+   * Shared threads of node, so subsystems don't start own pools and
+   * oversubscribe cores:
+   *   cpu - one thread per core, for hashing, verification, encoding,
+   *   blocking - for calls waiting on disk or network, e.g. param fetch.
+   * Ordered domains, e.g. chain, mpool or one deal, run on cpu pool
+   * through strands, so their handlers don't need locks.
+   */
+  class Runtime {
+   public:
+    using Executor = boost::asio::thread_pool::executor_type;
+    using Strand = boost::asio::strand<Executor>;
+
+    /// Default number of blocking threads
+    static constexpr size_t kBlockingThreads{8};
+
+    /// Zero cpu threads means one per core
+    explicit Runtime(size_t cpu_threads = 0,
+                     size_t blocking_threads = kBlockingThreads);
+
+    /// Waits for running handlers, queued handlers are dropped
+    ~Runtime();
+
+    Runtime(const Runtime &) = delete;
+    Runtime &operator=(const Runtime &) = delete;
+
+    Executor cpu() {
+      return cpu_.get_executor();
+    }
+
+    Executor blocking() {
+      return blocking_.get_executor();
+    }
+
+    /// Strand of named domain, same strand for same name
+    Strand strand(const std::string &domain);
+
+    /// Strand of short lived domain, e.g. one deal
+    Strand newStrand();
+
+    size_t cpuThreads() const {
+      return cpu_threads_;
+    }
+
+    /// Stops pools, handlers not started yet are dropped
+    void stop();
+
+   private:
+    size_t cpu_threads_;
+    boost::asio::thread_pool cpu_;
+    boost::asio::thread_pool blocking_;
+    std::mutex mutex_;
+    std::map<std::string, Strand> strands_;
+  };
+}  // namespace fc::common
+
+#endif  // CPP_FILECOIN_CORE_COMMON_RUNTIME_HPP
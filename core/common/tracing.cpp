@@ -0,0 +1,256 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/tracing.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace fc::common::tracing {
+  namespace detail {
+    std::atomic_bool enabled{false};
+  }  // namespace detail
+
+  namespace {
+    /**
+     * Events of one thread. Mutex is taken by owner on each finished span,
+     * and by export, so it is uncontended while recording.
+     */
+    struct Ring {
+      std::mutex mutex;
+      std::vector<SpanEvent> events;
+      /// Slot overwritten by next event
+      size_t next{};
+      uint64_t thread{};
+      /// Last span id of thread
+      uint64_t spans{};
+    };
+
+    /// Rings of all threads, kept after thread exit for export
+    struct Rings {
+      std::mutex mutex;
+      std::vector<std::shared_ptr<Ring>> rings;
+      uint64_t threads{};
+    };
+
+    Rings &rings() {
+      static Rings rings;
+      return rings;
+    }
+
+    Ring &ring() {
+      thread_local auto ring{[] {
+        auto ring{std::make_shared<Ring>()};
+        auto &all{rings()};
+        std::lock_guard lock{all.mutex};
+        ring->thread = ++all.threads;
+        all.rings.push_back(ring);
+        return ring;
+      }()};
+      return *ring;
+    }
+
+    thread_local Context current_context;
+
+    uint64_t nowNs() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+    }
+
+    /// Unix nanoseconds minus steady nanoseconds, taken once
+    int64_t unixOffsetNs() {
+      static const int64_t offset{
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::system_clock::now().time_since_epoch())
+              .count()
+          - static_cast<int64_t>(nowNs())};
+      return offset;
+    }
+
+    std::string escape(std::string_view value) {
+      std::string escaped;
+      for (auto c : value) {
+        if (c == '\\' || c == '"') {
+          escaped += '\\';
+          escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+          char code[7];
+          snprintf(code, sizeof(code), "\\u%04x", c);
+          escaped += code;
+        } else {
+          escaped += c;
+        }
+      }
+      return escaped;
+    }
+
+    std::string hex(uint64_t value) {
+      char encoded[17];
+      snprintf(encoded,
+               sizeof(encoded),
+               "%016llx",
+               static_cast<unsigned long long>(value));
+      return encoded;
+    }
+
+    /// Microseconds with nanosecond fraction, as chrome trace expects
+    std::string micros(uint64_t ns) {
+      char encoded[32];
+      snprintf(encoded,
+               sizeof(encoded),
+               "%llu.%03llu",
+               static_cast<unsigned long long>(ns / 1000),
+               static_cast<unsigned long long>(ns % 1000));
+      return encoded;
+    }
+  }  // namespace
+
+  void enable(bool enabled) {
+    // take offset before spans are recorded
+    unixOffsetNs();
+    detail::enabled.store(enabled, std::memory_order_relaxed);
+  }
+
+  Context Span::current() {
+    return current_context;
+  }
+
+  void Span::start(const char *name, std::string_view detail, Context parent) {
+    auto &thread{ring()};
+    name_ = name;
+    detail_ = detail;
+    // span ids are unique without shared counter
+    context_.span = (thread.thread << 40) | ++thread.spans;
+    context_.trace = parent.trace ? parent.trace : context_.span;
+    parent_ = parent.span;
+    previous_ = current_context;
+    current_context = context_;
+    start_ns_ = nowNs();
+  }
+
+  void Span::finish() {
+    auto end_ns{nowNs()};
+    current_context = previous_;
+    auto &thread{ring()};
+    std::lock_guard lock{thread.mutex};
+    SpanEvent event{name_,
+                    std::move(detail_),
+                    thread.thread,
+                    context_.trace,
+                    context_.span,
+                    parent_,
+                    start_ns_,
+                    end_ns};
+    if (thread.events.size() < kRingEvents) {
+      thread.events.push_back(std::move(event));
+    } else {
+      thread.events[thread.next] = std::move(event);
+    }
+    thread.next = (thread.next + 1) % kRingEvents;
+  }
+
+  std::vector<SpanEvent> collect() {
+    std::vector<SpanEvent> events;
+    auto &all{rings()};
+    std::lock_guard lock{all.mutex};
+    for (auto &ring : all.rings) {
+      std::lock_guard ring_lock{ring->mutex};
+      events.insert(events.end(), ring->events.begin(), ring->events.end());
+    }
+    std::sort(events.begin(), events.end(), [](auto &l, auto &r) {
+      return l.start_ns < r.start_ns;
+    });
+    return events;
+  }
+
+  void clear() {
+    auto &all{rings()};
+    std::lock_guard lock{all.mutex};
+    for (auto &ring : all.rings) {
+      std::lock_guard ring_lock{ring->mutex};
+      ring->events.clear();
+      ring->next = 0;
+    }
+  }
+
+  std::string chromeTrace(const std::vector<SpanEvent> &events) {
+    std::map<uint64_t, uint64_t> threads;
+    for (auto &event : events) {
+      threads.emplace(event.span, event.thread);
+    }
+    std::string json{"{\"traceEvents\":["};
+    auto first{true};
+    auto add{[&](const std::string &object) {
+      if (!first) {
+        json += ',';
+      }
+      first = false;
+      json += object;
+    }};
+    for (auto &event : events) {
+      auto common{",\"cat\":\"fc\",\"pid\":1,\"tid\":"
+                  + std::to_string(event.thread)};
+      auto name{"\"name\":\"" + escape(event.name) + '"'};
+      add('{' + name + common + ",\"ph\":\"X\",\"ts\":" + micros(event.start_ns)
+          + ",\"dur\":" + micros(event.end_ns - event.start_ns)
+          + ",\"args\":{\"detail\":\"" + escape(event.detail)
+          + "\",\"span\":\"" + hex(event.span) + "\",\"parent\":\""
+          + hex(event.parent) + "\"}}");
+      auto parent{threads.find(event.parent)};
+      if (parent != threads.end() && parent->second != event.thread) {
+        auto flow{",\"id\":\"" + hex(event.span)
+                  + "\",\"ts\":" + micros(event.start_ns)};
+        add('{' + name + ",\"cat\":\"fc\",\"pid\":1,\"tid\":"
+            + std::to_string(parent->second) + ",\"ph\":\"s\"" + flow + '}');
+        add('{' + name + common + ",\"ph\":\"f\",\"bp\":\"e\"" + flow + '}');
+      }
+    }
+    json += "]}";
+    return json;
+  }
+
+  std::string otlpJson(const std::vector<SpanEvent> &events,
+                       const std::string &service) {
+    auto offset{unixOffsetNs()};
+    std::string json{
+        "{\"resourceSpans\":[{\"resource\":{\"attributes\":[{\"key\":"
+        "\"service.name\",\"value\":{\"stringValue\":\""
+        + escape(service)
+        + "\"}}]},\"scopeSpans\":[{\"scope\":{\"name\":\"fc\"},\"spans\":["};
+    auto first{true};
+    for (auto &event : events) {
+      if (!first) {
+        json += ',';
+      }
+      first = false;
+      // trace id is 16 bytes
+      json += "{\"traceId\":\"" + hex(0) + hex(event.trace)
+              + "\",\"spanId\":\"" + hex(event.span) + '"';
+      if (event.parent) {
+        json += ",\"parentSpanId\":\"" + hex(event.parent) + '"';
+      }
+      json += ",\"name\":\"" + escape(event.name)
+              + "\",\"kind\":1,\"startTimeUnixNano\":\""
+              + std::to_string(event.start_ns + offset)
+              + "\",\"endTimeUnixNano\":\""
+              + std::to_string(event.end_ns + offset)
+              + "\",\"attributes\":[{\"key\":\"thread.id\",\"value\":{"
+                "\"intValue\":\""
+              + std::to_string(event.thread) + "\"}}";
+      if (!event.detail.empty()) {
+        json += ",{\"key\":\"detail\",\"value\":{\"stringValue\":\""
+                + escape(event.detail) + "\"}}";
+      }
+      json += "]}";
+    }
+    json += "]}]}]}";
+    return json;
+  }
+}  // namespace fc::common::tracing
@@ -0,0 +1,115 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_COMMON_TRACING_HPP
+#define CPP_FILECOIN_CORE_COMMON_TRACING_HPP
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fc::common::tracing {
+  /// Events kept per thread, older events are overwritten
+  constexpr size_t kRingEvents{1 << 15};
+
+  namespace detail {
+    extern std::atomic_bool enabled;
+  }  // namespace detail
+
+  /// Starts or stops recording of spans, recorded events are kept
+  void enable(bool enabled);
+
+  inline bool enabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+  }
+
+  /// Identifies span, passed to other thread to continue trace there
+  struct Context {
+    /// Zero if there is no span
+    uint64_t trace{};
+    uint64_t span{};
+  };
+
+  /// Finished span
+  struct SpanEvent {
+    /// Static string given to span
+    const char *name{};
+    /// Optional dynamic part, e.g. rpc method
+    std::string detail;
+    uint64_t thread{};
+    uint64_t trace{};
+    uint64_t span{};
+    uint64_t parent{};
+    /// Steady clock nanoseconds
+    uint64_t start_ns{};
+    uint64_t end_ns{};
+  };
+
+  /**
+   * Records time from construction to destruction to ring of thread.
+   * Disabled span costs one relaxed load, detail is not copied then.
+   */
+  class Span {
+   public:
+    /// Child of current span of thread
+    explicit Span(const char *name, std::string_view detail = {})
+        : Span{name, detail, current()} {}
+
+    /// Child of span of other thread, or root if parent is empty
+    Span(const char *name, std::string_view detail, Context parent) {
+      if (enabled()) {
+        start(name, detail, parent);
+      }
+    }
+
+    ~Span() {
+      if (name_) {
+        finish();
+      }
+    }
+
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+    /// Context of this span, empty if disabled
+    Context context() const {
+      return context_;
+    }
+
+    /// Innermost span of thread
+    static Context current();
+
+   private:
+    void start(const char *name, std::string_view detail, Context parent);
+    void finish();
+
+    const char *name_{};
+    std::string detail_;
+    Context context_;
+    uint64_t parent_{};
+    /// Context of enclosing span, restored by destructor
+    Context previous_;
+    uint64_t start_ns_{};
+  };
+
+  /// Events of all threads, including exited ones, ordered by start
+  std::vector<SpanEvent> collect();
+
+  /// Drops recorded events
+  void clear();
+
+  /**
+   * Chrome trace event format, loaded by chrome://tracing and Perfetto.
+   * Children of other thread span are linked by flow events.
+   */
+  std::string chromeTrace(const std::vector<SpanEvent> &events);
+
+  /// OpenTelemetry protocol JSON encoding of ExportTraceServiceRequest
+  std::string otlpJson(const std::vector<SpanEvent> &events,
+                       const std::string &service = "fuhon");
+}  // namespace fc::common::tracing
+
+#endif  // CPP_FILECOIN_CORE_COMMON_TRACING_HPP
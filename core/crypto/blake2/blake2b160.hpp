@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_BLAKE2B160_HPP
 #define CPP_FILECOIN_BLAKE2B160_HPP
 
+#include <vector>
+
 #include <gsl/span>
 
 #include "common/blob.hpp"
@@ -36,6 +38,15 @@ namespace fc::crypto::blake2b {
    */
   Blake2b256Hash blake2b_256(gsl::span<const uint8_t> to_hash);
 
+  /**
+   * @brief Get blake2b-256 hashes of many inputs, small inputs are hashed
+   * four at once with AVX2 if cpu supports it
+   * @param inputs - data to hash
+   * @return hashes in order of inputs
+   */
+  std::vector<Blake2b256Hash> blake2b_256_many(
+      gsl::span<const gsl::span<const uint8_t>> inputs);
+
   Blake2b512Hash blake2b_512_from_file(std::ifstream &file_stream);
 
 }  // namespace fc::crypto::blake2b
@@ -0,0 +1,244 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "crypto/blake2/blake2b.h"
+#include "crypto/blake2/blake2b160.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FC_BLAKE2B_AVX2
+#include <immintrin.h>
+#endif
+
+namespace fc::crypto::blake2b {
+  namespace {
+    constexpr size_t kBlockSize = 128;
+
+    /// Number of compressed blocks, empty input is one zero block
+    size_t blocks(gsl::span<const uint8_t> input) {
+      return std::max<size_t>(1, (input.size() + kBlockSize - 1) / kBlockSize);
+    }
+
+    void hashOne(gsl::span<const uint8_t> input, Blake2b256Hash &hash) {
+      ::blake2b(hash.data(),
+                BLAKE2B256_HASH_LENGTH,
+                nullptr,
+                0,
+                input.data(),
+                input.size());
+    }
+
+#ifdef FC_BLAKE2B_AVX2
+#define FC_AVX2 __attribute__((target("avx2")))
+
+    constexpr size_t kLanes = 4;
+
+    constexpr uint64_t kIv[8] = {0x6A09E667F3BCC908,
+                                 0xBB67AE8584CAA73B,
+                                 0x3C6EF372FE94F82B,
+                                 0xA54FF53A5F1D36F1,
+                                 0x510E527FADE682D1,
+                                 0x9B05688C2B3E6C1F,
+                                 0x1F83D9ABFB41BD6B,
+                                 0x5BE0CD19137E2179};
+
+    constexpr uint8_t kSigma[12][16] = {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+        {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+        {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+        {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+        {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+        {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+        {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+        {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+        {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+        {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+        {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}};
+
+    FC_AVX2 inline __m256i rotr32(__m256i x) {
+      return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    FC_AVX2 inline __m256i rotr24(__m256i x) {
+      const auto mask = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2,
+                                         11, 12, 13, 14, 15, 8, 9, 10,
+                                         3, 4, 5, 6, 7, 0, 1, 2,
+                                         11, 12, 13, 14, 15, 8, 9, 10);
+      return _mm256_shuffle_epi8(x, mask);
+    }
+
+    FC_AVX2 inline __m256i rotr16(__m256i x) {
+      const auto mask = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1,
+                                         10, 11, 12, 13, 14, 15, 8, 9,
+                                         2, 3, 4, 5, 6, 7, 0, 1,
+                                         10, 11, 12, 13, 14, 15, 8, 9);
+      return _mm256_shuffle_epi8(x, mask);
+    }
+
+    FC_AVX2 inline __m256i rotr63(__m256i x) {
+      return _mm256_or_si256(_mm256_srli_epi64(x, 63), _mm256_add_epi64(x, x));
+    }
+
+    /// G mixing function of all lanes, each vector holds one word per lane
+    FC_AVX2 inline void mix(__m256i *v,
+                            int a,
+                            int b,
+                            int c,
+                            int d,
+                            __m256i x,
+                            __m256i y) {
+      v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), x);
+      v[d] = rotr32(_mm256_xor_si256(v[d], v[a]));
+      v[c] = _mm256_add_epi64(v[c], v[d]);
+      v[b] = rotr24(_mm256_xor_si256(v[b], v[c]));
+      v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), y);
+      v[d] = rotr16(_mm256_xor_si256(v[d], v[a]));
+      v[c] = _mm256_add_epi64(v[c], v[d]);
+      v[b] = rotr63(_mm256_xor_si256(v[b], v[c]));
+    }
+
+    /**
+     * Hashes up to four inputs in lanes of ymm registers. Lanes compress
+     * their blocks in lockstep, lane which has no more blocks keeps its
+     * state by masking.
+     */
+    FC_AVX2 void hashLanes(const gsl::span<const uint8_t> *inputs,
+                           size_t count,
+                           Blake2b256Hash **hashes) {
+      size_t lane_blocks[kLanes]{};
+      size_t max_blocks = 0;
+      for (size_t lane = 0; lane < count; ++lane) {
+        lane_blocks[lane] = blocks(inputs[lane]);
+        max_blocks = std::max(max_blocks, lane_blocks[lane]);
+      }
+
+      __m256i h[8];
+      for (int i = 0; i < 8; ++i) {
+        h[i] = _mm256_set1_epi64x(static_cast<int64_t>(kIv[i]));
+      }
+      // parameter block: digest length, no key, fanout and depth 1
+      h[0] = _mm256_xor_si256(
+          h[0], _mm256_set1_epi64x(0x01010000 ^ BLAKE2B256_HASH_LENGTH));
+
+      alignas(32) uint64_t words[16][kLanes];
+      alignas(32) uint64_t counter[kLanes];
+      alignas(32) uint64_t last[kLanes];
+      alignas(32) uint64_t active[kLanes];
+      uint8_t block[kBlockSize];
+      for (size_t k = 0; k < max_blocks; ++k) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+          auto on = lane < count && k < lane_blocks[lane];
+          active[lane] = on ? ~uint64_t{0} : 0;
+          last[lane] = on && k + 1 == lane_blocks[lane] ? ~uint64_t{0} : 0;
+          counter[lane] = 0;
+          std::memset(block, 0, kBlockSize);
+          if (on) {
+            auto &input = inputs[lane];
+            auto begin = k * kBlockSize;
+            auto size = std::min(kBlockSize, input.size() - begin);
+            if (size != 0) {
+              std::memcpy(block, input.data() + begin, size);
+            }
+            counter[lane] = begin + size;
+          }
+          for (int i = 0; i < 16; ++i) {
+            // x86 is little-endian, as is blake2b word order
+            std::memcpy(&words[i][lane], block + i * 8, 8);
+          }
+        }
+
+        __m256i m[16];
+        for (int i = 0; i < 16; ++i) {
+          m[i] = _mm256_load_si256(reinterpret_cast<const __m256i *>(words[i]));
+        }
+        __m256i v[16];
+        for (int i = 0; i < 8; ++i) {
+          v[i] = h[i];
+          v[i + 8] = _mm256_set1_epi64x(static_cast<int64_t>(kIv[i]));
+        }
+        // inputs are shorter than 2^64 bytes, high counter word stays zero
+        v[12] = _mm256_xor_si256(
+            v[12],
+            _mm256_load_si256(reinterpret_cast<const __m256i *>(counter)));
+        v[14] = _mm256_xor_si256(
+            v[14], _mm256_load_si256(reinterpret_cast<const __m256i *>(last)));
+
+        for (auto &s : kSigma) {
+          mix(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+          mix(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+          mix(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+          mix(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+          mix(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+          mix(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+          mix(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+          mix(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+
+        auto mask{
+            _mm256_load_si256(reinterpret_cast<const __m256i *>(active))};
+        for (int i = 0; i < 8; ++i) {
+          auto next{_mm256_xor_si256(h[i], _mm256_xor_si256(v[i], v[i + 8]))};
+          h[i] = _mm256_blendv_epi8(h[i], next, mask);
+        }
+      }
+
+      alignas(32) uint64_t out[4][kLanes];
+      for (int i = 0; i < 4; ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(out[i]), h[i]);
+      }
+      for (size_t lane = 0; lane < count; ++lane) {
+        for (int i = 0; i < 4; ++i) {
+          std::memcpy(hashes[lane]->data() + i * 8, &out[i][lane], 8);
+        }
+      }
+    }
+
+#undef FC_AVX2
+
+    bool hasAvx2() {
+      static const bool avx2{__builtin_cpu_supports("avx2") != 0};
+      return avx2;
+    }
+#endif
+  }  // namespace
+
+  std::vector<Blake2b256Hash> blake2b_256_many(
+      gsl::span<const gsl::span<const uint8_t>> inputs) {
+    std::vector<Blake2b256Hash> hashes(inputs.size());
+#ifdef FC_BLAKE2B_AVX2
+    if (inputs.size() > 1 && hasAvx2()) {
+      // inputs of similar size share lanes, so few lanes idle
+      std::vector<size_t> order(inputs.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](auto l, auto r) {
+        return blocks(inputs[l]) < blocks(inputs[r]);
+      });
+      for (size_t i = 0; i < order.size(); i += kLanes) {
+        auto count = std::min(kLanes, order.size() - i);
+        gsl::span<const uint8_t> lanes[kLanes];
+        Blake2b256Hash *outputs[kLanes];
+        for (size_t lane = 0; lane < count; ++lane) {
+          lanes[lane] = inputs[order[i + lane]];
+          outputs[lane] = &hashes[order[i + lane]];
+        }
+        if (count == 1) {
+          hashOne(lanes[0], *outputs[0]);
+        } else {
+          hashLanes(lanes, count, outputs);
+        }
+      }
+      return hashes;
+    }
+#endif
+    for (size_t i = 0; i < hashes.size(); ++i) {
+      hashOne(inputs[i], hashes[i]);
+    }
+    return hashes;
+  }
+}  // namespace fc::crypto::blake2b
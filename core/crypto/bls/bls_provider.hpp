@@ -6,6 +6,8 @@
 #ifndef CRYPTO_BLS_PROVIDER_HPP
 #define CRYPTO_BLS_PROVIDER_HPP
 
+#include <vector>
+
 #include <gsl/span>
 
 #include "crypto/bls/bls_types.hpp"
@@ -52,6 +54,19 @@ namespace fc::crypto::bls {
         const Signature &signature,
         const PublicKey &key) const = 0;
 
+    /**
+     * @brief Verify aggregated BLS signature of several messages with one
+     * pairing product instead of verifying each signature
+     * @param messages - signed data, i-th message is signed by i-th key
+     * @param keys - BLS public keys of signers
+     * @param signature - aggregated signature
+     * @return signature status or error code
+     */
+    virtual outcome::result<bool> verifyAggregateSignature(
+        gsl::span<const std::vector<uint8_t>> messages,
+        gsl::span<const PublicKey> keys,
+        const Signature &signature) const = 0;
+
     /**
      * @brief Aggregate BLS signatures
      * @param signatures - signatures to aggregate
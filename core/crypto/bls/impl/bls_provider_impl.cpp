@@ -6,6 +6,7 @@
 #include "crypto/bls/impl/bls_provider_impl.hpp"
 
 #include <filecoin-ffi/filcrypto.h>
+#include <future>
 
 #include "common/ffi.hpp"
 #include "common/span.hpp"
@@ -58,6 +59,28 @@ namespace fc::crypto::bls {
            > 0;
   }
 
+  outcome::result<bool> BlsProviderImpl::verifyAggregateSignature(
+      gsl::span<const std::vector<uint8_t>> messages,
+      gsl::span<const PublicKey> keys,
+      const Signature &signature) const {
+    if (messages.size() != keys.size() || messages.empty()) {
+      return false;
+    }
+    std::vector<Digest> digests;
+    digests.reserve(messages.size());
+    for (auto &message : messages) {
+      OUTCOME_TRY(digest, generateHash(message));
+      digests.push_back(digest);
+    }
+    auto digests_span = gsl::make_span(digests);
+    return fil_verify(signature.data(),
+                      common::span::cast<const uint8_t>(digests_span).data(),
+                      digests_span.size_bytes(),
+                      common::span::cast<const uint8_t>(keys).data(),
+                      keys.size_bytes())
+           > 0;
+  }
+
   outcome::result<Digest> BlsProviderImpl::generateHash(
       gsl::span<const uint8_t> message) {
     auto response{ffi::wrap(fil_hash(message.data(), message.size()),
@@ -79,6 +102,34 @@ namespace fc::crypto::bls {
     }
     return ffi::array(response->signature.inner);
   }
+
+  outcome::result<Signature> BlsProviderImpl::aggregateSignaturesParallel(
+      gsl::span<const Signature> signatures, size_t threads) const {
+    auto size{static_cast<size_t>(signatures.size())};
+    auto parts{
+        std::min(threads, (size + kAggregateChunk - 1) / kAggregateChunk)};
+    if (parts < 2) {
+      return aggregateSignatures(signatures);
+    }
+    std::vector<std::future<outcome::result<Signature>>> futures;
+    for (size_t part{0}; part < parts; ++part) {
+      auto begin{size * part / parts};
+      auto end{size * (part + 1) / parts};
+      futures.push_back(std::async(std::launch::async, [=] {
+        return aggregateSignatures(signatures.subspan(begin, end - begin));
+      }));
+    }
+    std::vector<Signature> partial;
+    partial.reserve(parts);
+    for (auto &future : futures) {
+      auto result{future.get()};
+      if (!result) {
+        return result.error();
+      }
+      partial.push_back(result.value());
+    }
+    return aggregateSignatures(partial);
+  }
 };  // namespace fc::crypto::bls
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::crypto::bls, Errors, e) {
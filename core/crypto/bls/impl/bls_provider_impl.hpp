@@ -23,9 +23,26 @@ namespace fc::crypto::bls {
                                           const Signature &signature,
                                           const PublicKey &key) const override;
 
+    outcome::result<bool> verifyAggregateSignature(
+        gsl::span<const std::vector<uint8_t>> messages,
+        gsl::span<const PublicKey> keys,
+        const Signature &signature) const override;
+
     outcome::result<Signature> aggregateSignatures(
         gsl::span<const Signature> signatures) const override;
 
+    /// Signatures aggregated by one thread, smaller inputs are not split
+    static constexpr size_t kAggregateChunk{64};
+
+    /**
+     * @brief aggregates parts of signatures on threads, then aggregates
+     * results of parts, equal to aggregateSignatures since aggregation is
+     * addition of points
+     * @param threads - max parts aggregated at once
+     */
+    outcome::result<Signature> aggregateSignaturesParallel(
+        gsl::span<const Signature> signatures, size_t threads) const;
+
    private:
     /**
      * @brief Generate BLS message digest
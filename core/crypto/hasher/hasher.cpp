@@ -5,18 +5,22 @@
 
 #include "hasher.hpp"
 
+#include <stdexcept>
+
 #include <libp2p/crypto/sha/sha256.hpp>
 #include "crypto/blake2/blake2b160.hpp"
 
 namespace fc::crypto {
-  std::map<Hasher::HashType, Hasher::HashMethod> Hasher::methods_{
-      {HashType::sha256, Hasher::sha2_256},
-      {HashType::blake2b_256, Hasher::blake2b_256}};
-
   Hasher::Multihash Hasher::calculate(HashType hash_type,
                                       gsl::span<const uint8_t> buffer) {
-    HashMethod hash_method = methods_.at(hash_type);
-    return std::invoke(hash_method, buffer);
+    switch (hash_type) {
+      case HashType::sha256:
+        return sha2_256(buffer);
+      case HashType::blake2b_256:
+        return blake2b_256(buffer);
+      default:
+        throw std::out_of_range{"fc::crypto::Hasher - unsupported hash type"};
+    }
   }
 
   Hasher::Multihash Hasher::sha2_256(gsl::span<const uint8_t> buffer) {
@@ -6,8 +6,6 @@
 #ifndef FILECOIN_CORE_CRYPTO_HASHER_HPP
 #define FILECOIN_CORE_CRYPTO_HASHER_HPP
 
-#include <map>
-
 #include <libp2p/multi/multihash.hpp>
 
 namespace fc::crypto {
@@ -22,9 +20,6 @@ namespace fc::crypto {
     using Multihash = libp2p::multi::Multihash;
     using HashMethod = Multihash (*)(gsl::span<const uint8_t>);
 
-   private:
-    static std::map<HashType, HashMethod> methods_;
-
    public:
     static Multihash calculate(HashType hash_type,
                                gsl::span<const uint8_t> buffer);
@@ -47,33 +47,73 @@ namespace fc::crypto::randomness {
 
   outcome::result<Randomness> ChainRandomnessProviderImpl::sampleRandomness(
       const std::vector<CID> &block_cids, uint64_t round) {
-    auto cids{block_cids};
-
-    while (true) {
-      OUTCOME_TRY(tipset_key, TipsetKey::create(cids));
-      OUTCOME_TRY(tipset, chain_store_->loadTipset(tipset_key));
-      auto &block = tipset.getMinTicketBlock();
-
-      if (tipset.height <= round) {
-        BOOST_ASSERT_MSG(block.ticket.has_value(),
-                         "min ticket block has no value, internal error");
+    MemoKey key{block_cids, round};
+    if (auto randomness{recall(key)}) {
+      return *randomness;
+    }
+    OUTCOME_TRY(tipset_key, TipsetKey::create(block_cids));
+    OUTCOME_TRY(tipset, chain_store_->loadTipset(tipset_key));
+    OUTCOME_TRYA(tipset, lookback(std::move(tipset), round));
+    auto &block = tipset.getMinTicketBlock();
+    Randomness randomness;
+    if (tipset.height <= round) {
+      BOOST_ASSERT_MSG(block.ticket.has_value(),
+                       "min ticket block has no value, internal error");
+      randomness = drawRandomness(*block.ticket, round);
+    } else {
+      // special case for lookback behind genesis block
+      // round is negative
+      auto &&negative_hash = drawRandomness(*block.ticket, round - 1);
+      // for negative lookbacks, just use the hash of the positive ticket hash
+      // value
+      randomness = Randomness{libp2p::crypto::sha256(negative_hash)};
+    }
+    remember(std::move(key), randomness);
+    return randomness;
+  }
 
-        return drawRandomness(*block.ticket, round);
+  outcome::result<Tipset> ChainRandomnessProviderImpl::lookback(
+      Tipset tipset, uint64_t round) const {
+    bool indexed{false};
+    while (tipset.height > round && tipset.getMinTicketBlock().height != 0) {
+      if (!indexed) {
+        // height index covers only heaviest chain
+        auto canonical{chain_store_->loadTipsetByHeight(tipset.height)};
+        if (canonical && canonical.value() == tipset) {
+          // index returns tipset above round if round is null
+          OUTCOME_TRYA(tipset, chain_store_->loadTipsetByHeight(round));
+          indexed = true;
+          continue;
+        }
       }
+      OUTCOME_TRY(parents, tipset.getParents());
+      OUTCOME_TRYA(tipset, chain_store_->loadTipset(parents));
+    }
+    return std::move(tipset);
+  }
 
-      // special case for lookback behind genesis block
-      if (block.height == 0) {
-        // round is negative
-        auto &&negative_hash = drawRandomness(*block.ticket, round - 1);
-        // for negative lookbacks, just use the hash of the positive ticket hash
-        // value
-        auto &&positive_hash = libp2p::crypto::sha256(negative_hash);
-        return Randomness{positive_hash};
-      }
+  boost::optional<Randomness> ChainRandomnessProviderImpl::recall(
+      const MemoKey &key) {
+    std::lock_guard lock{mutex_};
+    auto it{memo_.find(key)};
+    if (it == memo_.end()) {
+      return boost::none;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.second);
+    return it->second.first;
+  }
 
-      // TODO (yuraz) I know it's very ugly, and needs to be refactored
-      // I translated it directly from go to C++
-      cids = block.parents;
+  void ChainRandomnessProviderImpl::remember(MemoKey key,
+                                             const Randomness &randomness) {
+    std::lock_guard lock{mutex_};
+    if (memo_.count(key) != 0) {
+      return;
+    }
+    lru_.push_front(key);
+    memo_.emplace(std::move(key), std::make_pair(randomness, lru_.begin()));
+    if (memo_.size() > kRandomnessMemoSize) {
+      memo_.erase(lru_.back());
+      lru_.pop_back();
     }
   }
 
@@ -6,10 +6,24 @@
 #ifndef CPP_FILECOIN_CORE_CRYPTO_RANDOMNESS_IMPL_CHAIN_RANDOMNESS_PROVIDER_IMPL_HPP
 #define CPP_FILECOIN_CORE_CRYPTO_RANDOMNESS_IMPL_CHAIN_RANDOMNESS_PROVIDER_IMPL_HPP
 
+#include <list>
+#include <map>
+#include <mutex>
+
 #include "crypto/randomness/chain_randomness_provider.hpp"
 #include "storage/chain/chain_store.hpp"
 
 namespace fc::crypto::randomness {
+  using primitives::tipset::Tipset;
+
+  /// Number of remembered randomness draws
+  constexpr size_t kRandomnessMemoSize{1024};
+
+  /**
+   * Samples randomness from ticket of tipset at round. Ancestor of tipset on
+   * heaviest chain is found by height index of chain store, recent draws are
+   * remembered.
+   */
   class ChainRandomnessProviderImpl : public ChainRandomnessProvider {
    public:
     ~ChainRandomnessProviderImpl() override = default;
@@ -21,7 +35,22 @@ namespace fc::crypto::randomness {
         const std::vector<CID> &block_cids, uint64_t round) override;
 
    private:
+    using MemoKey = std::pair<std::vector<CID>, uint64_t>;
+
+    /// Finds ancestor of tipset with max height not greater than round
+    outcome::result<Tipset> lookback(Tipset tipset, uint64_t round) const;
+
+    boost::optional<Randomness> recall(const MemoKey &key);
+
+    void remember(MemoKey key, const Randomness &randomness);
+
     std::shared_ptr<storage::blockchain::ChainStore> chain_store_;
+
+    std::mutex mutex_;
+    std::map<MemoKey, std::pair<Randomness, std::list<MemoKey>::iterator>>
+        memo_;
+    /// Keys in order of use, most recent first
+    std::list<MemoKey> lru_;
   };
 }  // namespace fc::crypto::randomness
 
@@ -5,6 +5,7 @@
 
 #include "data_transfer/impl/graphsync/graphsync_manager.hpp"
 
+#include <cassert>
 #include <utility>
 #include "data_transfer/impl/graphsync/graphsync_receiver.hpp"
 #include "data_transfer/message.hpp"
@@ -22,10 +23,10 @@ namespace fc::data_transfer::graphsync {
   outcome::result<void> GraphSyncManager::init(
       const std::string &voucher_type,
       std::shared_ptr<RequestValidator> validator) {
-    auto receiver = std::make_shared<GraphsyncReceiver>(
+    receiver_ = std::make_shared<GraphsyncReceiver>(
         network_, std::move(graphsync_), shared_from_this(), peer_);
-    OUTCOME_TRY(receiver->registerVoucherType(voucher_type, validator));
-    return network_->setDelegate(receiver);
+    OUTCOME_TRY(receiver_->registerVoucherType(voucher_type, validator));
+    return network_->setDelegate(receiver_);
   }
 
   outcome::result<ChannelId> GraphSyncManager::openPushDataChannel(
@@ -55,6 +56,10 @@ namespace fc::data_transfer::graphsync {
         channel_id,
         createChannel(
             transfer_id, base_cid, selector, voucher.bytes, peer_, to, peer_));
+    // data flows while sender validates voucher, request is cancelled if
+    // sender rejects it
+    assert(receiver_);
+    OUTCOME_TRY(receiver_->startPull(channel_id, to, base_cid));
     return std::move(channel_id);
   }
 
@@ -120,6 +125,20 @@ namespace fc::data_transfer::graphsync {
     return found->second;
   }
 
+  void GraphSyncManager::onChannelResponse(const ChannelId &channel_id) {
+    auto found = channels_.find(channel_id);
+    if (found == channels_.end()) {
+      return;
+    }
+    auto &state = found->second;
+    if (!state.time_to_first_response) {
+      state.time_to_first_response =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - state.opened);
+    }
+    ++state.responses;
+  }
+
   outcome::result<void> GraphSyncManager::sendResponse(bool is_accepted,
                                                        const PeerInfo &to,
                                                        TransferId transfer_id) {
@@ -13,6 +13,10 @@
 #include "data_transfer/types.hpp"
 #include "storage/ipfs/graphsync/graphsync.hpp"
 
+namespace fc::data_transfer {
+  class GraphsyncReceiver;
+}  // namespace fc::data_transfer
+
 namespace fc::data_transfer::graphsync {
 
   using libp2p::Host;
@@ -55,6 +59,8 @@ namespace fc::data_transfer::graphsync {
     boost::optional<ChannelState> getChannelByIdAndSender(
         const ChannelId &channel_id, const PeerInfo &sender) override;
 
+    void onChannelResponse(const ChannelId &channel_id) override;
+
    private:
     /**
      * Encapsulates message creation and posting to the data transfer network
@@ -84,6 +90,7 @@ namespace fc::data_transfer::graphsync {
     PeerInfo peer_;
     std::shared_ptr<Libp2pDataTransferNetwork> network_;
     std::shared_ptr<Graphsync> graphsync_;
+    std::shared_ptr<GraphsyncReceiver> receiver_;
     std::map<ChannelId, ChannelState> channels_;
   };
 
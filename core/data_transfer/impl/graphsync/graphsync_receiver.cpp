@@ -12,6 +12,7 @@ namespace fc::data_transfer {
 
   using storage::ipfs::graphsync::isError;
   using storage::ipfs::graphsync::isSuccess;
+  using storage::ipfs::graphsync::isTerminal;
   using storage::ipfs::graphsync::ResponseStatusCode;
 
   GraphsyncReceiver::GraphsyncReceiver(
@@ -78,28 +79,29 @@ namespace fc::data_transfer {
     Event event{.code = EventCode::ERROR,
                 .message = "",
                 .timestamp = clock::UTCClockImpl().nowUTC()};
-    if (response.is_accepted) {
-      // if we are handling a response to a pull request then they are sending
-      // data and the initiator is us. construct a channel id for a pull request
-      // that we initiated and see if there is one in our saved channel list.
-      // otherwise we should not respond
-      ChannelId channel_id{.initiator = peer_, .id = response.transfer_id};
-      auto channel_state =
-          graphsync_manager_->getChannelByIdAndSender(channel_id, sender);
-      if (channel_state) {
-        OUTCOME_TRY(sendGraphSyncRequest(
-            peer_,
-            response.transfer_id,
-            true,
-            sender,
-            channel_state->channel.base_cid,
-            // TODO (a.chernyshov) implement selectors and serialize
-            // channel_state->channel.selector
-            {}));
-        event.code = EventCode::PROGRESS;
-        notifySubscribers(event, *channel_state);
-      }
+    // if we are handling a response to a pull request then they are sending
+    // data and the initiator is us. construct a channel id for a pull request
+    // that we initiated and see if there is one in our saved channel list.
+    // otherwise we should not respond
+    ChannelId channel_id{.initiator = peer_, .id = response.transfer_id};
+    auto channel_state =
+        graphsync_manager_->getChannelByIdAndSender(channel_id, sender);
+    if (!channel_state) {
+      return outcome::success();
+    }
+    if (!response.is_accepted) {
+      // cancels request started before response
+      requests_.erase(channel_id);
+      event.message = "data transfer request rejected";
+      notifySubscribers(event, *channel_state);
+      return outcome::success();
     }
+    if (requests_.count(channel_id) == 0) {
+      OUTCOME_TRY(
+          startPull(channel_id, sender, channel_state->channel.base_cid));
+    }
+    event.code = EventCode::PROGRESS;
+    notifySubscribers(event, *channel_state);
     return outcome::success();
   }
 
@@ -107,6 +109,18 @@ namespace fc::data_transfer {
     logger_->warn("Receive error");
   }
 
+  outcome::result<void> GraphsyncReceiver::startPull(
+      const ChannelId &channel_id, const PeerInfo &sender, const CID &root) {
+    return sendGraphSyncRequest(channel_id.initiator,
+                                channel_id.id,
+                                true,
+                                sender,
+                                root,
+                                // TODO (a.chernyshov) implement selectors and
+                                // serialize channel selector
+                                {});
+  }
+
   outcome::result<void> GraphsyncReceiver::sendResponse(
       const PeerInfo &peer, bool is_accepted, const TransferId &transfer_id) {
     DataTransferMessage response = createResponse(is_accepted, transfer_id);
@@ -139,25 +153,31 @@ namespace fc::data_transfer {
         .is_pull = is_pull};
     OUTCOME_TRY(extension, encodeDataTransferExtension(extension_data));
 
-    graphsync_->makeRequest(
+    ChannelId channel_id{.initiator = initiator, .id = transfer_id};
+    requests_[channel_id] = graphsync_->makeRequest(
         sender.id,
         boost::none,
         root,
         selector,
         {extension},
-        [this, initiator, transfer_id, sender](
-            ResponseStatusCode code, std::vector<Extension> extensions) {
-          Event event{.code = EventCode::ERROR,
+        [this, channel_id, sender](ResponseStatusCode code,
+                                   std::vector<Extension> extensions) {
+          Event event{.code = EventCode::PROGRESS,
                       .message = "",
                       .timestamp = clock::UTCClockImpl().nowUTC()};
 
-          ChannelId channel_id{.initiator = initiator, .id = transfer_id};
+          this->graphsync_manager_->onChannelResponse(channel_id);
           auto channel = this->graphsync_manager_->getChannelByIdAndSender(
               channel_id, sender);
           if (!channel) {
-            event.code = EventCode::ERROR;
-            event.message = "cannot find a matching channel for this request";
-          } else if (isError(code)) {
+            logger_->warn("cannot find a matching channel for this request");
+            // copies, erase destroys this callback
+            auto self = this;
+            auto id = channel_id;
+            self->requests_.erase(id);
+            return;
+          }
+          if (isError(code)) {
             event.code = EventCode::ERROR;
             event.message = statusCodeToString(code);
           } else if (isSuccess(code)) {
@@ -165,6 +185,12 @@ namespace fc::data_transfer {
           }
 
           this->notifySubscribers(event, *channel);
+          if (isTerminal(code)) {
+            // copies, erase destroys this callback
+            auto self = this;
+            auto id = channel_id;
+            self->requests_.erase(id);
+          }
         });
     return outcome::success();
   }
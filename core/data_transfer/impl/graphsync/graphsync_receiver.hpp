@@ -16,6 +16,7 @@
 namespace fc::data_transfer {
 
   using storage::ipfs::graphsync::Graphsync;
+  using storage::ipfs::graphsync::Subscription;
 
   class GraphsyncReceiver : public MessageReceiver {
    public:
@@ -32,6 +33,17 @@ namespace fc::data_transfer {
 
     void receiveError() override;
 
+    /**
+     * Starts graphsync request of pull channel opened by this node without
+     * waiting for response to data transfer request
+     * @param channel_id - pull channel initiated by this node
+     * @param sender - peer sending data
+     * @param root - base cid of channel
+     */
+    outcome::result<void> startPull(const ChannelId &channel_id,
+                                    const PeerInfo &sender,
+                                    const CID &root);
+
    private:
     outcome::result<void> sendResponse(const PeerInfo &peer,
                                        bool is_accepted,
@@ -43,7 +55,9 @@ namespace fc::data_transfer {
 
     /**
      * Assembles a graphsync request and determines if the transfer was
-     * completed/successful. Notifies subscribers of final request status
+     * completed/successful. Notifies subscribers of request progress and of
+     * final request status. Request is kept until final status, so channels
+     * to one peer are transferred concurrently
      * @return
      */
     outcome::result<void> sendGraphSyncRequest(
@@ -62,6 +76,8 @@ namespace fc::data_transfer {
     std::shared_ptr<Manager> graphsync_manager_;
     PeerInfo peer_;
     std::vector<std::shared_ptr<Subscriber>> subscribers_;
+    /** graphsync requests of channels in progress */
+    std::map<ChannelId, Subscription> requests_;
     common::Logger logger_ = common::createLogger("GraphsyncReceiver");
   };
 
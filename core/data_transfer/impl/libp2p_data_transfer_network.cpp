@@ -58,7 +58,7 @@ namespace fc::data_transfer {
           cbor_stream->read<DataTransferMessage>(
               [self{shared_from_this()}, remote_peer_info, stream{cbor_stream}](
                   outcome::result<DataTransferMessage> message) {
-                self->logger_->debug("New message");
+                SPDLOG_LOGGER_DEBUG(self->logger_, "New message");
                 if (message.has_error()) {
                   self->logger_->error("Read error "
                                        + message.error().message());
@@ -108,8 +108,9 @@ namespace fc::data_transfer {
                                        + written.error().message());
                   return;
                 }
-                self->logger_->debug("Message sent "
-                                     + std::to_string(written.value()));
+                SPDLOG_LOGGER_DEBUG(
+                    self->logger_,
+                    "Message sent " + std::to_string(written.value()));
                 // TODO (a.chernyshov) read response
                 // validate response voucher
               });
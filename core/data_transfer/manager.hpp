@@ -70,6 +70,11 @@ namespace fc::data_transfer {
 
     virtual boost::optional<ChannelState> getChannelByIdAndSender(
         const ChannelId &channel_id, const PeerInfo &sender) = 0;
+
+    /**
+     * Records graphsync response of channel in its metrics
+     */
+    virtual void onChannelResponse(const ChannelId &channel_id) = 0;
   };
 
 }  // namespace fc::data_transfer
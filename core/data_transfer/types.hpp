@@ -105,6 +105,16 @@ namespace fc::data_transfer {
 
     /** total bytes received by this node (0 if sender) */
     size_t received{0};
+
+    /** when channel was created */
+    std::chrono::steady_clock::time_point opened{
+        std::chrono::steady_clock::now()};
+
+    /** time from channel creation to first graphsync response */
+    boost::optional<std::chrono::milliseconds> time_to_first_response;
+
+    /** number of graphsync responses received for channel */
+    size_t responses{0};
   };
 
   /**
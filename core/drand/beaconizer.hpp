@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_CORE_DRAND_BEACONIZER_HPP
 #define CPP_FILECOIN_CORE_DRAND_BEACONIZER_HPP
 
+#include <gsl/span>
+
 #include "common/outcome.hpp"
 #include "drand/messages.hpp"
 #include "primitives/chain_epoch/chain_epoch.hpp"
@@ -25,6 +27,13 @@ namespace fc::drand {
     virtual outcome::result<void> verifyEntry(const BeaconEntry &current,
                                               const BeaconEntry &previous) = 0;
 
+    /// Verifies chain of consecutive entries following previous at once
+    virtual outcome::result<void> verifyEntries(
+        gsl::span<const BeaconEntry> entries, const BeaconEntry &previous) = 0;
+
+    /// Starts fetching entries of epochs up to given epoch in background
+    virtual void prefetch(ChainEpoch fil_epoch) = 0;
+
     /// Calculates the maximum beacon round for the given filecoin epoch
     virtual outcome::result<uint64_t> maxBeaconRoundForEpoch(
         ChainEpoch fil_epoch) = 0;
@@ -5,6 +5,9 @@
 
 #include "drand/impl/beaconizer.hpp"
 
+#include <condition_variable>
+
+#include <boost/asio/post.hpp>
 #include <boost/random.hpp>
 #include <libp2p/common/byteutil.hpp>
 #include <libp2p/crypto/sha/sha256.hpp>
@@ -33,12 +36,42 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::drand, BeaconizerImpl::Error, e) {
 }
 
 namespace fc::drand {
+  namespace {
+    /// Message signed by drand network in round
+    std::vector<uint8_t> beaconMessage(
+        uint64_t round, gsl::span<const uint8_t> previous_signature) {
+      std::vector<uint8_t> buffer;
+      buffer.reserve(previous_signature.size() + sizeof(uint64_t));
+      buffer.insert(
+          buffer.end(), previous_signature.begin(), previous_signature.end());
+      libp2p::common::putUint64BE(buffer, round);
+      auto hash = libp2p::crypto::sha256(buffer);
+      return {hash.begin(), hash.end()};
+    }
+
+    outcome::result<crypto::bls::Signature> blsSignature(
+        gsl::span<const uint8_t> signature) {
+      crypto::bls::Signature bls_sig;
+      if (bls_sig.size() != signature.size()) {
+        return BeaconizerImpl::Error::INVALID_SIGNATURE_FORMAT;
+      }
+      std::copy(signature.begin(), signature.end(), bls_sig.begin());
+      return bls_sig;
+    }
+
+    storage::Buffer storeKey(uint64_t round) {
+      auto key{"drand/" + std::to_string(round)};
+      return storage::Buffer{std::vector<uint8_t>{key.begin(), key.end()}};
+    }
+  }  // namespace
+
   outcome::result<std::unique_ptr<BeaconizerImpl>> BeaconizerImpl::create(
       uint64_t filecoin_genesis_time,
       uint64_t filecoin_round_time,
       std::vector<std::string> drand_servers,
       gsl::span<const uint8_t> network_public_key,
-      size_t max_cache_size) {
+      size_t max_cache_size,
+      std::shared_ptr<storage::PersistentBufferMap> store) {
     if (drand_servers.empty()) {
       return Error::EMPTY_SERVERS_LIST;
     }
@@ -56,38 +89,48 @@ namespace fc::drand {
                           uint64_t filecoin_round_time,
                           std::vector<std::string> drand_servers,
                           crypto::bls::PublicKey network_public_key,
-                          size_t max_cache_size)
+                          size_t max_cache_size,
+                          std::shared_ptr<storage::PersistentBufferMap> store)
           : BeaconizerImpl{filecoin_genesis_time,
                            filecoin_round_time,
                            std::move(drand_servers),
                            std::move(network_public_key),
-                           max_cache_size} {};
+                           max_cache_size,
+                           std::move(store)} {};
     };
     auto instance =
         std::make_unique<make_unique_enabler>(filecoin_genesis_time,
                                               filecoin_round_time,
                                               std::move(drand_servers),
                                               std::move(net_key),
-                                              max_cache_size);
+                                              max_cache_size,
+                                              std::move(store));
     OUTCOME_TRY(instance->init());
     return outcome::success(std::move(instance));
   }
 
-  BeaconizerImpl::BeaconizerImpl(uint64_t filecoin_genesis_time,
-                                 uint64_t filecoin_round_time,
-                                 std::vector<std::string> drand_servers,
-                                 crypto::bls::PublicKey network_public_key,
-                                 size_t max_cache_size)
+  BeaconizerImpl::BeaconizerImpl(
+      uint64_t filecoin_genesis_time,
+      uint64_t filecoin_round_time,
+      std::vector<std::string> drand_servers,
+      crypto::bls::PublicKey network_public_key,
+      size_t max_cache_size,
+      std::shared_ptr<storage::PersistentBufferMap> store)
       : fil_gen_time_{filecoin_genesis_time},
         fil_round_time_{filecoin_round_time},
         peers_{std::move(drand_servers)},
         network_key_{std::move(network_public_key)},
         cache_{max_cache_size},
+        store_{std::move(store)},
         bls_{std::make_unique<crypto::bls::BlsProviderImpl>()} {
     BOOST_ASSERT(not peers_.empty());
     BOOST_ASSERT(max_cache_size > 0);
   }
 
+  BeaconizerImpl::~BeaconizerImpl() {
+    pool_.join();
+  }
+
   outcome::result<BeaconEntry> BeaconizerImpl::entry(uint64_t round) {
     BeaconEntry entry{.round = round};
     auto bytes = lookupCache(round);
@@ -96,15 +139,22 @@ namespace fc::drand {
       return entry;
     }
 
-    auto response = client_->publicRand(round);
-    if (response) {
-      entry.data = std::move(response.value().signature);
-      return entry;
-    }
-
-    OUTCOME_TRY(init());
-    // this place looks weird in lotus too :)
-    return response.error();
+    struct Result {
+      std::mutex mutex;
+      std::condition_variable done;
+      boost::optional<outcome::result<PublicRandResponse>> response;
+    };
+    auto result{std::make_shared<Result>()};
+    race(round, [result](auto response) {
+      std::lock_guard lock{result->mutex};
+      result->response = std::move(response);
+      result->done.notify_one();
+    });
+    std::unique_lock lock{result->mutex};
+    result->done.wait(lock, [&] { return result->response.has_value(); });
+    OUTCOME_TRY(response, *result->response);
+    entry.data = std::move(response.signature);
+    return entry;
   }
 
   outcome::result<void> BeaconizerImpl::verifyEntry(
@@ -121,6 +171,61 @@ namespace fc::drand {
     return outcome::success();
   }
 
+  outcome::result<void> BeaconizerImpl::verifyEntries(
+      gsl::span<const BeaconEntry> entries, const BeaconEntry &previous) {
+    const auto *prev = &previous;
+    // same as verifyEntry, entry following genesis is not verified
+    if (!entries.empty() && 0 == previous.round) {
+      prev = &entries[0];
+      entries = entries.subspan(1);
+    }
+    if (entries.empty()) {
+      return outcome::success();
+    }
+    std::vector<std::vector<uint8_t>> messages;
+    std::vector<crypto::bls::Signature> signatures;
+    messages.reserve(entries.size());
+    signatures.reserve(entries.size());
+    for (const auto &entry : entries) {
+      messages.push_back(beaconMessage(entry.round, prev->data));
+      OUTCOME_TRY(signature, blsSignature(entry.data));
+      signatures.push_back(signature);
+      prev = &entry;
+    }
+    // all entries are signed by network key, checked with one pairing
+    OUTCOME_TRY(aggregate, bls_->aggregateSignatures(signatures));
+    std::vector<crypto::bls::PublicKey> keys(entries.size(), network_key_);
+    OUTCOME_TRY(is_valid,
+                bls_->verifyAggregateSignature(messages, keys, aggregate));
+    if (not is_valid) {
+      return Error::INVALID_BEACON;
+    }
+    for (const auto &entry : entries) {
+      cacheEntry(entry.round, entry.data);
+    }
+    return outcome::success();
+  }
+
+  void BeaconizerImpl::prefetch(ChainEpoch fil_epoch) {
+    auto max_round{maxBeaconRoundForEpoch(fil_epoch)};
+    if (!max_round) {
+      return;
+    }
+    std::lock_guard lock{prefetch_mutex_};
+    auto round{max_round.value() > kMaxPrefetchRounds
+                   ? max_round.value() - kMaxPrefetchRounds + 1
+                   : 1};
+    round = std::max(round, prefetched_ + 1);
+    for (; round <= max_round.value(); ++round) {
+      if (lookupCache(round)) {
+        continue;
+      }
+      // response is cached by race
+      race(round, [](auto) {});
+    }
+    prefetched_ = std::max(prefetched_, max_round.value());
+  }
+
   outcome::result<uint64_t> BeaconizerImpl::maxBeaconRoundForEpoch(
       ChainEpoch fil_epoch) {
     if (fil_epoch < 0) {
@@ -140,7 +245,7 @@ namespace fc::drand {
   outcome::result<void> BeaconizerImpl::init() {
     rotatePeersIndex();
     dial();
-    OUTCOME_TRY(group, client_->group());
+    OUTCOME_TRY(group, clients_[peer_index_.load()]->group());
     if (group.dist_key.empty()) {
       return Error::NO_PUBLIC_KEY;
     }
@@ -165,46 +270,98 @@ namespace fc::drand {
   boost::optional<Bytes> BeaconizerImpl::lookupCache(uint64_t round) {
     std::lock_guard<std::mutex> lock(cache_mutex_);
     auto bytes = cache_.get(round);
+    if (!bytes && store_) {
+      auto key{storeKey(round)};
+      if (store_->contains(key)) {
+        if (auto stored{store_->get(key)}) {
+          bytes = Bytes{stored.value().begin(), stored.value().end()};
+          cache_.insert(round, *bytes);
+        }
+      }
+    }
     return bytes;
   }
 
   void BeaconizerImpl::cacheEntry(uint64_t round, const Bytes &signature) {
     std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (cache_.contains(round)) {
+      return;
+    }
     cache_.insert(round, signature);
+    if (store_) {
+      // entry is fetched again on next start if it is not stored
+      std::ignore = store_->put(storeKey(round), storage::Buffer{signature});
+    }
+  }
+
+  void BeaconizerImpl::race(uint64_t round, RaceCallback callback) {
+    struct Race {
+      std::mutex mutex;
+      size_t left;
+      RaceCallback callback;
+      outcome::result<PublicRandResponse> error{Error::INVALID_BEACON};
+    };
+    auto state{std::make_shared<Race>()};
+    state->left = clients_.size();
+    state->callback = std::move(callback);
+    for (auto &client : clients_) {
+      boost::asio::post(pool_, [this, state, round, client{client.get()}] {
+        auto response{client->publicRand(round)};
+        if (response) {
+          auto &rand{response.value()};
+          auto valid{verifyBeaconData(
+              round, rand.signature, rand.previous_signature)};
+          if (rand.round != round || !valid || !valid.value()) {
+            response = Error::INVALID_BEACON;
+          }
+        }
+        RaceCallback callback;
+        {
+          std::lock_guard lock{state->mutex};
+          --state->left;
+          if (!state->callback) {
+            return;
+          }
+          if (response) {
+            cacheEntry(round, response.value().signature);
+          } else if (state->left != 0) {
+            state->error = response.error();
+            return;
+          }
+          callback = std::move(state->callback);
+          state->callback = nullptr;
+        }
+        callback(std::move(response));
+      });
+    }
   }
 
   outcome::result<bool> BeaconizerImpl::verifyBeaconData(
       uint64_t round,
       gsl::span<const uint8_t> signature,
       gsl::span<const uint8_t> previous_signature) {
-    auto message = [round, &previous_signature]() {
-      std::vector<uint8_t> buffer;
-      buffer.reserve(previous_signature.size() + sizeof(uint64_t));
-      buffer.insert(
-          buffer.end(), previous_signature.begin(), previous_signature.end());
-      libp2p::common::putUint64BE(buffer, round);
-      auto hash = libp2p::crypto::sha256(buffer);
-      return hash;
-    };
-    crypto::bls::Signature bls_sig;
-    if (bls_sig.size() != signature.size()) {
-      return Error::INVALID_SIGNATURE_FORMAT;
-    }
-    std::copy(signature.begin(), signature.end(), bls_sig.begin());
+    OUTCOME_TRY(bls_sig, blsSignature(signature));
     OUTCOME_TRY(is_valid,
-                bls_->verifySignature(message(), bls_sig, network_key_));
+                bls_->verifySignature(
+                    beaconMessage(round, previous_signature),
+                    bls_sig,
+                    network_key_));
     return is_valid;
   }
 
   void BeaconizerImpl::rotatePeersIndex() {
     boost::random::mt19937 rng;
-    boost::random::uniform_int_distribution<> generator(1, peers_.size());
+    boost::random::uniform_int_distribution<> generator(0, peers_.size() - 1);
     auto new_index = generator(rng);
     peer_index_.store(new_index);
   }
 
   void BeaconizerImpl::dial() {
-    auto address = peers_[peer_index_.load()];
-    client_ = std::make_unique<DrandSyncClientImpl>(address);
+    if (!clients_.empty()) {
+      return;
+    }
+    for (auto &address : peers_) {
+      clients_.push_back(std::make_unique<DrandSyncClientImpl>(address));
+    }
   }
 }  // namespace fc::drand
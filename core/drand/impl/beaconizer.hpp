@@ -7,25 +7,37 @@
 #define CPP_FILECOIN_CORE_DRAND_IMPL_BEACONIZER_HPP
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <boost/asio/thread_pool.hpp>
 #include <boost/compute/detail/lru_cache.hpp>
 #include <gsl/span>
 
 #include "crypto/bls/bls_types.hpp"
 #include "drand/beaconizer.hpp"
 #include "drand/client.hpp"
+#include "storage/buffer_map.hpp"
 
 namespace fc::crypto::bls {
   class BlsProvider;
 }
 
 namespace fc::drand {
-
+  /// Threads fetching entries from drand peers
+  constexpr size_t kDrandThreads{4};
+  /// Max rounds fetched ahead by prefetch
+  constexpr uint64_t kMaxPrefetchRounds{8};
+
+  /**
+   * Fetches entries from all drand peers at once and takes first valid
+   * response. Verified entries are cached and persisted to store, so they are
+   * not fetched again after restart.
+   */
   class BeaconizerImpl : public Beaconizer {
    public:
     enum class Error {
@@ -46,6 +58,7 @@ namespace fc::drand {
      * specified
      * @param network_public_key - known key for the drand network
      * @param max_cache_size - beacon entries cache limit
+     * @param store - persisted verified entries, optional
      * @return unique pointer to an instance
      */
     static outcome::result<std::unique_ptr<BeaconizerImpl>> create(
@@ -53,13 +66,22 @@ namespace fc::drand {
         uint64_t filecoin_round_time,
         std::vector<std::string> drand_servers,
         gsl::span<const uint8_t> network_public_key,
-        size_t max_cache_size);
+        size_t max_cache_size,
+        std::shared_ptr<storage::PersistentBufferMap> store = nullptr);
+
+    /// Waits for running fetches
+    ~BeaconizerImpl() override;
 
     outcome::result<BeaconEntry> entry(uint64_t round) override;
 
     outcome::result<void> verifyEntry(const BeaconEntry &current,
                                       const BeaconEntry &previous) override;
 
+    outcome::result<void> verifyEntries(gsl::span<const BeaconEntry> entries,
+                                        const BeaconEntry &previous) override;
+
+    void prefetch(ChainEpoch fil_epoch) override;
+
     outcome::result<uint64_t> maxBeaconRoundForEpoch(
         ChainEpoch fil_epoch) override;
 
@@ -68,20 +90,30 @@ namespace fc::drand {
     // METHODS
     //
 
+    /// Called with first valid response or error if no peer gave one
+    using RaceCallback =
+        std::function<void(outcome::result<PublicRandResponse>)>;
+
     BeaconizerImpl(uint64_t filecoin_genesis_time,
                    uint64_t filecoin_round_time,
                    std::vector<std::string> drand_servers,
                    crypto::bls::PublicKey network_public_key,
-                   size_t max_cache_size);
+                   size_t max_cache_size,
+                   std::shared_ptr<storage::PersistentBufferMap> store);
 
     outcome::result<void> init();
 
     outcome::result<void> verifyNetworkKey(const Bytes &key) const;
 
+    /// Looks up entry in cache, then in store
     boost::optional<Bytes> lookupCache(uint64_t round);
 
+    /// Caches and persists verified entry
     void cacheEntry(uint64_t round, const Bytes &signature);
 
+    /// Requests round from all peers on worker threads
+    void race(uint64_t round, RaceCallback callback);
+
     outcome::result<bool> verifyBeaconData(
         uint64_t round,
         gsl::span<const uint8_t> signature,
@@ -89,7 +121,7 @@ namespace fc::drand {
 
     void rotatePeersIndex();
 
-    // creates a client to the currently chosen peer
+    // creates clients to all peers
     void dial();
 
     //
@@ -106,12 +138,21 @@ namespace fc::drand {
 
     std::mutex cache_mutex_;
     boost::compute::detail::lru_cache<uint64_t, Bytes> cache_;
+    std::shared_ptr<storage::PersistentBufferMap> store_;
 
     std::unique_ptr<crypto::bls::BlsProvider> bls_;
-    std::unique_ptr<DrandSyncClient> client_;
+    /// Client of each peer
+    std::vector<std::unique_ptr<DrandSyncClient>> clients_;
 
     uint64_t drand_gen_time_;
     uint64_t drand_interval_;
+
+    std::mutex prefetch_mutex_;
+    /// Last round requested by prefetch
+    uint64_t prefetched_{};
+
+    /// Joined first on destruction, fetches use members above
+    boost::asio::thread_pool pool_{kDrandThreads};
   };
 }  // namespace fc::drand
 
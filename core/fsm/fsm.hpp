@@ -6,6 +6,7 @@
 #ifndef CPP_FILECOIN_CORE_FSM_FSM_HPP
 #define CPP_FILECOIN_CORE_FSM_FSM_HPP
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <queue>
@@ -15,9 +16,9 @@
 #include <unordered_map>
 #include <utility>
 
+#include <boost/asio/post.hpp>
 #include <boost/optional.hpp>
-#include <libp2p/protocol/common/asio/asio_scheduler.hpp>
-#include <libp2p/protocol/common/scheduler.hpp>
+#include "common/metrics.hpp"
 #include "common/outcome.hpp"
 #include "host/context/host_context.hpp"
 
@@ -30,10 +31,6 @@
  */
 namespace fc::fsm {
   using fc::common::EnumClassHash;
-  using libp2p::protocol::Scheduler;
-  using Ticks = libp2p::protocol::Scheduler::Ticks;
-
-  const Scheduler::Ticks kSlowModeDelayMs = 100;
 
   /**
    * Container for state transitions caused by an event
@@ -226,6 +223,12 @@ namespace fc::fsm {
 
   /**
    * Finite State Machine implementation
+   *
+   * Events are dispatched as soon as they are sent, by handlers posted to io
+   * context. Events of one entity are dispatched one at a time in order of
+   * sending, events of distinct entities may be dispatched concurrently when
+   * io context is run by several threads.
+   *
    * @tparam EventEnumType - enum class with list of events
    * @tparam StateEnumType - enum class with list of states
    * @tparam Entity - type of handled objects, actually std::shared_ptr<Entity>
@@ -235,7 +238,6 @@ namespace fc::fsm {
    public:
     using EntityPtr = std::shared_ptr<Entity>;
     using TransitionRule = Transition<EventEnumType, StateEnumType, Entity>;
-    using EventQueueItem = std::pair<EntityPtr, EventEnumType>;
     using HostContext = std::shared_ptr<fc::host::HostContext>;
     using ActionFunction = std::function<void(
         std::shared_ptr<Entity> /* pointer to tracked entity */,
@@ -246,23 +248,25 @@ namespace fc::fsm {
     /**
      * Creates a state machine
      * @param transition_rules - defines state transitions
-     * @param scheduler - libp2p Scheduler for async events processing
+     * @param context - io context events are dispatched on
      */
-    FSM(std::vector<TransitionRule> transition_rules,
-        HostContext context,
-        Ticks ticks = 50)
+    FSM(std::vector<TransitionRule> transition_rules, HostContext context)
         : running_{true},
-          delay_{kSlowModeDelayMs},
-          host_context_(std::move(context)) {
+          host_context_(std::move(context)),
+          guard_{std::make_shared<Guard>()} {
+      guard_->fsm = this;
       initTransitions(std::move(transition_rules));
-      scheduler_ = std::make_shared<libp2p::protocol::AsioScheduler>(
-          *host_context_->getIoContext(),
-          libp2p::protocol::SchedulerConfig{ticks});
-      scheduler_handle_ = scheduler_->schedule(1000, [this] { onTimer(); });
     }
 
+    /// Waits for running dispatch, pending handlers are ignored
     ~FSM() {
       stop();
+      std::unique_lock lock{guard_->mutex};
+      guard_->fsm = nullptr;
+      std::lock_guard queue_lock{event_queue_mutex_};
+      for (auto &[_, queue] : event_queue_) {
+        queued_events_metric_.add(-static_cast<int64_t>(queue.size()));
+      }
     }
 
     /**
@@ -288,8 +292,17 @@ namespace fc::fsm {
       if (not running_) {
         return FsmError::MACHINE_STOPPED;
       }
-      std::lock_guard lock(event_queue_mutex_);
-      event_queue_.emplace(entity_ptr, event);
+      {
+        std::lock_guard lock(event_queue_mutex_);
+        auto &queue = event_queue_[entity_ptr];
+        queue.push(event);
+        queued_events_metric_.add(1);
+        if (queue.size() != 1) {
+          // entity is being dispatched, event is posted after previous ones
+          return outcome::success();
+        }
+      }
+      post(entity_ptr);
       return outcome::success();
     }
 
@@ -328,7 +341,6 @@ namespace fc::fsm {
     /// Prevent further events processing
     void stop() {
       running_ = false;
-      scheduler_handle_.cancel();
     }
 
     /// Is events processing still enabled
@@ -363,61 +375,101 @@ namespace fc::fsm {
       }
     }
 
-    /// async events processor routine
-    void onTimer() {
-      EventQueueItem event_pair;
+    /// Posts dispatch of next event of entity
+    void post(const EntityPtr &entity_ptr) {
+      boost::asio::post(
+          *host_context_->getIoContext(),
+          [weak{std::weak_ptr<Guard>{guard_}}, entity_ptr] {
+            if (auto guard = weak.lock()) {
+              std::shared_lock lock{guard->mutex};
+              if (guard->fsm) {
+                guard->fsm->onEvent(entity_ptr);
+              }
+            }
+          });
+    }
+
+    /// Dispatches next event of entity and posts the following one
+    void onEvent(const EntityPtr &entity_ptr) {
       if (not running_) {
         return;
       }
+      EventEnumType event;
       {
+        // event stays queued while dispatched, so concurrent send does not
+        // post another dispatch of the entity
         std::lock_guard lock(event_queue_mutex_);
-        if (event_queue_.empty()) {
-          scheduler_handle_.reschedule(kSlowModeDelayMs);
-          return;
+        event = event_queue_[entity_ptr].front();
+      }
+      dispatch(entity_ptr, event);
+      bool more;
+      {
+        std::lock_guard lock(event_queue_mutex_);
+        auto queue = event_queue_.find(entity_ptr);
+        queue->second.pop();
+        queued_events_metric_.add(-1);
+        more = not queue->second.empty();
+        if (not more) {
+          event_queue_.erase(queue);
         }
-        scheduler_handle_.reschedule(0);
-        event_pair = event_queue_.front();
-        event_queue_.pop();
       }
+      // next event is posted instead of dispatched in place, so entity with
+      // many events does not delay others
+      if (more) {
+        post(entity_ptr);
+      }
+    }
 
+    /// Applies transition of event to entity
+    void dispatch(const EntityPtr &entity_ptr, EventEnumType event) {
       StateEnumType source_state;
       {
         std::shared_lock lock(states_mutex_);
-        auto current_state = states_.find(event_pair.first);
+        auto current_state = states_.find(entity_ptr);
         if (states_.end() == current_state) {
           return;  // entity is not tracked
         }
         // copy to prevent invalidation of iterator
         source_state = current_state->second;
       }
-      auto event_handler = transitions_.find(event_pair.second);
+      auto event_handler = transitions_.find(event);
       if (transitions_.end() == event_handler) {
         return;  // transition from the state by the event is not set
       }
       auto resulting_state =
-          event_handler->second.dispatch(source_state, event_pair.first);
+          event_handler->second.dispatch(source_state, entity_ptr);
       if (resulting_state) {
         {
           std::unique_lock lock(states_mutex_);
-          states_[event_pair.first] = resulting_state.get();
+          states_[entity_ptr] = resulting_state.get();
         }
         if (any_change_cb_) {
-          any_change_cb_.get()(event_pair.first,        // pointer to entity
-                               event_pair.second,       // trigger event
+          any_change_cb_.get()(entity_ptr,              // pointer to entity
+                               event,                   // trigger event
                                source_state,            // source state
                                resulting_state.get());  // destination state
         }
       }
     }
 
-    bool running_;            ///< FSM is enabled to process events
-    Scheduler::Ticks delay_;  ///< minimum async loop delay
+    /// Lets posted handlers outlive state machine
+    struct Guard {
+      /// Held shared by dispatch, exclusively by destructor
+      std::shared_mutex mutex;
+      FSM *fsm{};
+    };
+
+    std::atomic_bool running_;  ///< FSM is enabled to process events
 
     std::mutex event_queue_mutex_;
-    std::queue<EventQueueItem> event_queue_;
-    std::shared_ptr<Scheduler> scheduler_;
-    Scheduler::Handle scheduler_handle_;
+    /// Events waiting for dispatch, front one is being dispatched
+    std::unordered_map<EntityPtr, std::queue<EventEnumType>> event_queue_;
+    /// Events queued in all state machines
+    common::metrics::Gauge &queued_events_metric_{
+        common::metrics::registry().gauge("fc_fsm_queued_events",
+                                          "Events queued in state machines")};
     HostContext host_context_;
+    std::shared_ptr<Guard> guard_;
 
     /// a dispatching list of events and what to do on event
     std::unordered_map<EventEnumType, TransitionRule> transitions_;
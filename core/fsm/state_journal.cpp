@@ -0,0 +1,92 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "fsm/state_journal.hpp"
+
+#include <boost/asio/post.hpp>
+
+#include "common/todo_error.hpp"
+
+namespace fc::fsm {
+  StateJournal::StateJournal(std::shared_ptr<boost::asio::io_context> io,
+                             std::shared_ptr<PersistentBufferMap> store,
+                             Buffer prefix)
+      : io_{std::move(io)},
+        store_{std::move(store)},
+        prefix_{std::move(prefix)} {}
+
+  void StateJournal::write(const Buffer &key, Buffer value) {
+    std::unique_lock lock{mutex_};
+    pending_[Buffer{prefix_}.put(key)] = std::move(value);
+    scheduleFlush(lock);
+  }
+
+  void StateJournal::remove(const Buffer &key) {
+    std::unique_lock lock{mutex_};
+    pending_[Buffer{prefix_}.put(key)] = boost::none;
+    scheduleFlush(lock);
+  }
+
+  void StateJournal::scheduleFlush(std::unique_lock<std::mutex> &lock) {
+    if (pending_.size() >= kJournalBatchSize) {
+      lock.unlock();
+      if (auto res{flush()}; !res) {
+        logger_->error("flush: {}", res.error().message());
+      }
+      return;
+    }
+    if (pending_.size() == 1) {
+      // writes made until posted flush runs are committed together
+      boost::asio::post(*io_, [weak{weak_from_this()}] {
+        if (auto self{weak.lock()}) {
+          if (auto res{self->flush()}; !res) {
+            self->logger_->error("flush: {}", res.error().message());
+          }
+        }
+      });
+    }
+  }
+
+  outcome::result<void> StateJournal::flush() {
+    std::lock_guard flush_lock{flush_mutex_};
+    std::map<Buffer, boost::optional<Buffer>> pending;
+    {
+      std::lock_guard lock{mutex_};
+      pending.swap(pending_);
+    }
+    if (pending.empty()) {
+      return outcome::success();
+    }
+    auto batch{store_->batch()};
+    if (!batch) {
+      return TodoError::ERROR;
+    }
+    for (auto &[key, value] : pending) {
+      if (value) {
+        OUTCOME_TRY(batch->put(key, std::move(*value)));
+      } else {
+        OUTCOME_TRY(batch->remove(key));
+      }
+    }
+    return batch->commit();
+  }
+
+  outcome::result<void> StateJournal::load(const Visitor &visitor) const {
+    auto cursor{store_->cursor()};
+    if (!cursor) {
+      return TodoError::ERROR;
+    }
+    for (cursor->seek(prefix_); cursor->isValid(); cursor->next()) {
+      auto key{cursor->key()};
+      if (key.size() < prefix_.size()
+          || !std::equal(prefix_.begin(), prefix_.end(), key.begin())) {
+        break;
+      }
+      Buffer entity{gsl::make_span(key).subspan(prefix_.size())};
+      OUTCOME_TRY(visitor(entity, cursor->value()));
+    }
+    return outcome::success();
+  }
+}  // namespace fc::fsm
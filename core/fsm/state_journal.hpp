@@ -0,0 +1,76 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_FSM_STATE_JOURNAL_HPP
+#define CPP_FILECOIN_CORE_FSM_STATE_JOURNAL_HPP
+
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include <boost/asio/io_context.hpp>
+
+#include "common/logger.hpp"
+#include "storage/buffer_map.hpp"
+
+namespace fc::fsm {
+  using common::Buffer;
+  using storage::PersistentBufferMap;
+
+  /// Entities written to store with one batch at most
+  constexpr size_t kJournalBatchSize{256};
+
+  /**
+   * Persists encoded FSM entities under key prefix, so states survive
+   * restart. Writes are coalesced: entity written several times before flush
+   * is stored once, and pending writes are committed with one batch posted to
+   * io context after burst of transitions, or when batch is full. Store may
+   * sync batch commits, so one fsync covers many transitions.
+   */
+  class StateJournal : public std::enable_shared_from_this<StateJournal> {
+   public:
+    using Visitor = std::function<outcome::result<void>(const Buffer &key,
+                                                        const Buffer &value)>;
+
+    /**
+     * @param io - context flush is posted to
+     * @param store - persistent store
+     * @param prefix - prefix of journal keys in store
+     */
+    StateJournal(std::shared_ptr<boost::asio::io_context> io,
+                 std::shared_ptr<PersistentBufferMap> store,
+                 Buffer prefix);
+
+    /// Queues entity value, replaces previous pending value of the entity
+    void write(const Buffer &key, Buffer value);
+
+    /// Queues removal of entity
+    void remove(const Buffer &key);
+
+    /// Commits pending writes
+    outcome::result<void> flush();
+
+    /// Visits stored entities, used to restore states on startup
+    outcome::result<void> load(const Visitor &visitor) const;
+
+   private:
+    /// Posts flush for first pending write, flushes full batch
+    void scheduleFlush(std::unique_lock<std::mutex> &lock);
+
+    std::shared_ptr<boost::asio::io_context> io_;
+    std::shared_ptr<PersistentBufferMap> store_;
+    Buffer prefix_;
+
+    std::mutex mutex_;
+    /// Pending values by store key, none to remove
+    std::map<Buffer, boost::optional<Buffer>> pending_;
+    /// Serializes commits, so older batch is not written after newer
+    std::mutex flush_mutex_;
+
+    common::Logger logger_ = common::createLogger("StateJournal");
+  };
+}  // namespace fc::fsm
+
+#endif  // CPP_FILECOIN_CORE_FSM_STATE_JOURNAL_HPP
@@ -8,43 +8,113 @@
 #include "common/libp2p/peer/cbor_peer_info.hpp"
 
 namespace fc::markets::discovery {
+  namespace {
+    const std::string kRecordPrefix{"/markets/discovery/"};
+
+    /// Log record of peer addition
+    struct Record {
+      CID cid;
+      PeerInfo peer;
+    };
+    CBOR_TUPLE(Record, cid, peer)
+
+    uint64_t readSeq(const uint8_t *bytes) {
+      uint64_t seq{};
+      for (auto i{0}; i < 8; ++i) {
+        seq = (seq << 8) | bytes[i];
+      }
+      return seq;
+    }
+  }  // namespace
 
   Discovery::Discovery(std::shared_ptr<Datastore> datastore)
       : datastore_{std::move(datastore)} {}
 
+  Buffer Discovery::recordKey(uint64_t seq) const {
+    return Buffer{}.put(kRecordPrefix).putUint64(seq);
+  }
+
+  outcome::result<void> Discovery::load() {
+    std::unique_lock lock{mutex_};
+    auto prefix{Buffer{}.put(kRecordPrefix)};
+    auto batch{datastore_->batch()};
+    auto cursor{datastore_->cursor()};
+    for (cursor->seek(prefix); cursor->isValid(); cursor->next()) {
+      auto key{cursor->key()};
+      if (key.size() != prefix.size() + 8
+          || !std::equal(prefix.begin(), prefix.end(), key.begin())) {
+        break;
+      }
+      auto seq{readSeq(key.data() + prefix.size())};
+      OUTCOME_TRY(record, codec::cbor::decode<Record>(cursor->value()));
+      // records are in order of additions, newer ones go to front
+      auto &peers{peers_[record.cid]};
+      peers.push_front(Entry{std::move(record.peer), seq});
+      if (peers.size() > kMaxPeers) {
+        OUTCOME_TRY(batch->remove(recordKey(peers.back().seq)));
+        peers.pop_back();
+      }
+      next_seq_ = seq + 1;
+    }
+    return batch->commit();
+  }
+
   outcome::result<void> Discovery::addPeer(const CID &cid,
                                            const PeerInfo &peer) {
-    OUTCOME_TRY(cid_bytes, cid.toBytes());
-    Buffer cid_key{cid_bytes};
-    std::vector<PeerInfo> peers;
-
-    if (datastore_->contains(cid_key)) {
-      OUTCOME_TRY(stored_peers_cbored, datastore_->get(cid_key));
-      OUTCOME_TRYA(
-          peers,
-          codec::cbor::decode<std::vector<PeerInfo>>(stored_peers_cbored));
-      // if already present
-      if (std::find(peers.begin(), peers.end(), peer) != peers.end()) {
-        return outcome::success();
+    std::unique_lock lock{mutex_};
+    auto it{peers_.find(cid)};
+    boost::optional<size_t> found;
+    if (it != peers_.end()) {
+      auto &peers{it->second};
+      for (size_t i{0}; i < peers.size(); ++i) {
+        if (peers[i].peer == peer) {
+          if (i == 0) {
+            return outcome::success();
+          }
+          found = i;
+          break;
+        }
       }
     }
-    peers.push_back(peer);
-    OUTCOME_TRY(peers_cbored, codec::cbor::encode(peers));
-    OUTCOME_TRY(datastore_->put(cid_key, peers_cbored));
+    auto seq{next_seq_};
+    OUTCOME_TRY(encoded, codec::cbor::encode(Record{cid, peer}));
+    auto batch{datastore_->batch()};
+    OUTCOME_TRY(batch->put(recordKey(seq), encoded));
+    auto evict{!found && it != peers_.end()
+               && it->second.size() >= kMaxPeers};
+    if (found) {
+      OUTCOME_TRY(batch->remove(recordKey(it->second[*found].seq)));
+    } else if (evict) {
+      OUTCOME_TRY(batch->remove(recordKey(it->second.back().seq)));
+    }
+    OUTCOME_TRY(batch->commit());
+
+    ++next_seq_;
+    if (it == peers_.end()) {
+      it = peers_.emplace(cid, std::deque<Entry>{}).first;
+    }
+    auto &peers{it->second};
+    if (found) {
+      peers.erase(peers.begin() + *found);
+    } else if (evict) {
+      peers.pop_back();
+    }
+    peers.push_front(Entry{peer, seq});
     return outcome::success();
   }
 
   outcome::result<std::vector<PeerInfo>> Discovery::getPeers(
       const CID &cid) const {
-    OUTCOME_TRY(cid_bytes, cid.toBytes());
-    Buffer cid_key{cid_bytes};
-    if (!datastore_->contains(cid_key)) {
-      return std::vector<PeerInfo>{};
+    std::shared_lock lock{mutex_};
+    std::vector<PeerInfo> result;
+    auto it{peers_.find(cid)};
+    if (it != peers_.end()) {
+      result.reserve(it->second.size());
+      for (auto &entry : it->second) {
+        result.push_back(entry.peer);
+      }
     }
-    OUTCOME_TRY(peers_cbored, datastore_->get(cid_key));
-    OUTCOME_TRY(peers,
-                codec::cbor::decode<std::vector<PeerInfo>>(peers_cbored));
-    return std::move(peers);
+    return result;
   }
 
 }  // namespace fc::markets::discovery
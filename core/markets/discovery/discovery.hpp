@@ -6,6 +6,10 @@
 #ifndef CPP_FILECOIN_CORE_MARKETS_DISCOVERY_DISCOVERY_HPP
 #define CPP_FILECOIN_CORE_MARKETS_DISCOVERY_DISCOVERY_HPP
 
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+
 #include <libp2p/peer/peer_info.hpp>
 #include "common/buffer.hpp"
 #include "common/outcome.hpp"
@@ -19,31 +23,52 @@ namespace fc::markets::discovery {
   using Datastore = fc::storage::face::PersistentMap<Buffer, Buffer>;
 
   /**
-   * Deal discovery
+   * Deal discovery.
+   * Peers are indexed in memory by payload cid, most recently added first,
+   * and each list is bounded. Datastore keeps append-only log of additions
+   * keyed by sequence number, re-added or evicted peer record is removed,
+   * so log holds exactly indexed peers and is loaded in order on start.
    */
   class Discovery {
    public:
+    /// Max peers kept per cid, least recently added are evicted
+    static constexpr size_t kMaxPeers{16};
+
     explicit Discovery(std::shared_ptr<Datastore> datastore);
 
     virtual ~Discovery() = default;
 
+    /// Loads index from datastore, called once on start
+    outcome::result<void> load();
+
     /**
-     * Add peer
-     * @param cid - deal proposal cid
+     * Add peer, or make it most recent if already added
+     * @param cid - payload cid
      * @param peer - peer to add
      * @return error if happens
      */
     outcome::result<void> addPeer(const CID &cid, const PeerInfo &peer);
 
     /**
-     * Get peers by proposal cid
-     * @param cid - deal proposal cid
-     * @return vector of peers
+     * Get peers by payload cid
+     * @param cid - payload cid
+     * @return vector of peers, most recently added first
      */
     outcome::result<std::vector<PeerInfo>> getPeers(const CID &cid) const;
 
    private:
+    struct Entry {
+      PeerInfo peer;
+      /// Sequence number of log record
+      uint64_t seq;
+    };
+
+    Buffer recordKey(uint64_t seq) const;
+
     std::shared_ptr<Datastore> datastore_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<CID, std::deque<Entry>> peers_;
+    uint64_t next_seq_{};
   };
 
 }  // namespace fc::markets::discovery
@@ -6,9 +6,12 @@
 #ifndef CPP_FILECOIN_CORE_MARKETS_PIECEIO_PIECEIO_HPP
 #define CPP_FILECOIN_CORE_MARKETS_PIECEIO_PIECEIO_HPP
 
+#include <functional>
+
 #include "common/outcome.hpp"
 #include "primitives/cid/cid.hpp"
 #include "primitives/piece/piece.hpp"
+#include "primitives/piece/piece_data.hpp"
 #include "primitives/sector/sector.hpp"
 #include "storage/ipld/walker.hpp"
 
@@ -16,6 +19,8 @@ namespace fc::markets::pieceio {
 
   using common::Buffer;
   using fc::storage::ipld::walker::Selector;
+  using primitives::piece::PieceData;
+  using primitives::piece::PieceInfo;
   using primitives::piece::UnpaddedPieceSize;
   using primitives::sector::RegisteredProof;
 
@@ -31,6 +36,24 @@ namespace fc::markets::pieceio {
     virtual outcome::result<std::pair<CID, UnpaddedPieceSize>>
     generatePieceCommitment(const RegisteredProof &registered_proof,
                             const Buffer &piece) = 0;
+
+    /// Reads piece data from pipe, e.g. writes it to staged sector file
+    using PieceWriter = std::function<outcome::result<PieceInfo>(
+        const PieceData &piece_data)>;
+
+    /**
+     * Streams selective car of payload, padded with zeros to piece size, into
+     * writer. Payload blocks are read from store once and car is not kept in
+     * memory, piece commitment is computed by writer in the same pass.
+     * @param piece_size - unpadded size of piece, car must fit into it
+     * @param writer - consumes piece data, e.g. SectorStorage::addPiece
+     * @return piece info returned by writer
+     */
+    virtual outcome::result<PieceInfo> stagePiece(
+        const CID &payload_cid,
+        const Selector &selector,
+        UnpaddedPieceSize piece_size,
+        const PieceWriter &writer) = 0;
   };
 
 }  // namespace fc::markets::pieceio
@@ -14,6 +14,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::markets::pieceio, PieceIOError, e) {
       return "PieceIOError: cannot write to pipe";
     case PieceIOError::CANNOT_CLOSE_PIPE:
       return "PieceIOError: cannot close pipe";
+    case PieceIOError::PAYLOAD_TOO_LARGE:
+      return "PieceIOError: payload car does not fit into piece";
     default:
       return "Unknown error";
   }
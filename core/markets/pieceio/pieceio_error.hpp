@@ -13,7 +13,8 @@ namespace fc::markets::pieceio {
   enum class PieceIOError {
     CANNOT_CREATE_PIPE = 1,
     CANNOT_WRITE_PIPE,
-    CANNOT_CLOSE_PIPE
+    CANNOT_CLOSE_PIPE,
+    PAYLOAD_TOO_LARGE
   };
 
 }
@@ -6,16 +6,44 @@
 #include "markets/pieceio/pieceio_impl.hpp"
 
 #include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <thread>
+
 #include "markets/pieceio/pieceio_error.hpp"
+#include "primitives/piece/comm_p_hasher.hpp"
 #include "proofs/proofs.hpp"
 #include "storage/car/car.hpp"
 
 namespace fc::markets::pieceio {
 
+  using common::dataCommitmentV1ToCID;
+  using primitives::piece::CommPHasher;
   using primitives::piece::paddedSize;
   using primitives::piece::PieceData;
   using proofs::Proofs;
-  using storage::car::makeSelectiveCar;
+  using storage::car::writeSelectiveCar;
+
+  namespace {
+    /// Bytes written to pipe at once
+    constexpr size_t kPipeChunk{64 << 10};
+
+    /// Writes all bytes to fd, retrying partial writes
+    bool writeAll(int fd, const uint8_t *data, size_t size) {
+      while (size != 0) {
+        auto written = write(fd, data, size);
+        if (written < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          return false;
+        }
+        data += written;
+        size -= written;
+      }
+      return true;
+    }
+  }  // namespace
 
   PieceIOImpl::PieceIOImpl(std::shared_ptr<Ipld> ipld)
       : ipld_{std::move(ipld)} {}
@@ -24,9 +52,16 @@ namespace fc::markets::pieceio {
   PieceIOImpl::generatePieceCommitment(const RegisteredProof &registered_proof,
                                        const CID &payload_cid,
                                        const Selector &selector) {
-    OUTCOME_TRY(selective_car,
-                makeSelectiveCar(*ipld_, {{payload_cid, selector}}));
-    return generatePieceCommitment(registered_proof, selective_car);
+    // selective car is hashed as it is written, without holding it
+    CommPHasher hasher;
+    OUTCOME_TRY(writeSelectiveCar(
+        *ipld_, {{payload_cid, selector}}, [&](auto &item) {
+          hasher.write(item);
+          return outcome::success();
+        }));
+    UnpaddedPieceSize padded_size = paddedSize(hasher.size());
+    OUTCOME_TRY(comm, hasher.finish(padded_size));
+    return {dataCommitmentV1ToCID(comm), padded_size};
   }
 
   outcome::result<std::pair<CID, UnpaddedPieceSize>>
@@ -38,20 +73,98 @@ namespace fc::markets::pieceio {
     if (pipe(fds) < 0) {
       return PieceIOError::CANNOT_CREATE_PIPE;
     }
-    std::vector<uint8_t> data = piece.toVector();
-    data.resize(padded_size, 0);
-    if (write(fds[1], data.data(), padded_size) == -1) {
-      return PieceIOError::CANNOT_CREATE_PIPE;
+    // pipe is filled concurrently with reading, zero padding is generated
+    // in chunks instead of copying piece
+    bool written{false};
+    bool closed{false};
+    std::thread writer{[&] {
+      written = writeAll(fds[1], piece.data(), piece.size());
+      std::vector<uint8_t> zeros(kPipeChunk, 0);
+      for (uint64_t left = padded_size - piece.size(); written && left != 0;) {
+        auto chunk = std::min<uint64_t>(left, zeros.size());
+        written = writeAll(fds[1], zeros.data(), chunk);
+        left -= chunk;
+      }
+      // reader sees end of data or fails on short piece
+      closed = close(fds[1]) != -1;
+    }};
+    auto commitment = Proofs::generatePieceCID(
+        registered_proof, PieceData{fds[0]}, padded_size);
+    writer.join();
+
+    if (!written) {
+      return PieceIOError::CANNOT_WRITE_PIPE;
     }
-    if (close(fds[1]) == -1) {
+    if (!closed) {
       return PieceIOError::CANNOT_CLOSE_PIPE;
     }
+    OUTCOME_TRY(commitment);
+    return {commitment.value(), padded_size};
+  }
 
-    OUTCOME_TRY(commitment,
-                Proofs::generatePieceCID(
-                    registered_proof, PieceData{fds[0]}, padded_size));
+  outcome::result<PieceInfo> PieceIOImpl::stagePiece(
+      const CID &payload_cid,
+      const Selector &selector,
+      UnpaddedPieceSize piece_size,
+      const PieceWriter &writer) {
+    int fds[2];
+    if (pipe(fds) < 0) {
+      return PieceIOError::CANNOT_CREATE_PIPE;
+    }
+    PieceData piece_data{fds[0]};
+    // car is written to pipe as payload is traversed, writer reads it
+    // concurrently, so blocks are loaded once and car is never buffered
+    std::atomic_bool stop{false};
+    outcome::result<void> written{outcome::success()};
+    bool closed{false};
+    std::thread producer{[&] {
+      uint64_t size{0};
+      written = writeSelectiveCar(
+          *ipld_,
+          {{payload_cid, selector}},
+          [&](auto &item) -> outcome::result<void> {
+            size += item.size();
+            if (size > piece_size) {
+              return PieceIOError::PAYLOAD_TOO_LARGE;
+            }
+            if (stop || !writeAll(fds[1], item.data(), item.size())) {
+              return PieceIOError::CANNOT_WRITE_PIPE;
+            }
+            return outcome::success();
+          });
+      std::vector<uint8_t> zeros(kPipeChunk, 0);
+      for (uint64_t left = piece_size - size; written && left != 0;) {
+        auto chunk = std::min<uint64_t>(left, zeros.size());
+        if (stop || !writeAll(fds[1], zeros.data(), chunk)) {
+          written = PieceIOError::CANNOT_WRITE_PIPE;
+        }
+        left -= chunk;
+      }
+      closed = close(fds[1]) != -1;
+    }};
+    auto piece = writer(piece_data);
+    // writer may stop reading early, pipe is drained until producer stops,
+    // so it neither blocks nor writes to closed pipe
+    stop = true;
+    std::vector<uint8_t> sink(kPipeChunk);
+    while (true) {
+      auto n = read(piece_data.getFd(), sink.data(), sink.size());
+      if (n == 0 || (n < 0 && errno != EINTR)) {
+        break;
+      }
+    }
+    producer.join();
 
-    return {commitment, padded_size};
+    // payload errors explain writer failure on short data
+    if (!written && written.error() != PieceIOError::CANNOT_WRITE_PIPE) {
+      return written.error();
+    }
+    OUTCOME_TRY(piece);
+    OUTCOME_TRY(written);
+    if (!closed) {
+      return PieceIOError::CANNOT_CLOSE_PIPE;
+    }
+    return piece;
   }
 
 }  // namespace fc::markets::pieceio
@@ -30,6 +30,12 @@ namespace fc::markets::pieceio {
         const RegisteredProof &registered_proof,
         const Buffer &piece) override;
 
+    outcome::result<PieceInfo> stagePiece(
+        const CID &payload_cid,
+        const Selector &selector,
+        UnpaddedPieceSize piece_size,
+        const PieceWriter &writer) override;
+
    private:
     std::shared_ptr<Ipld> ipld_;
   };
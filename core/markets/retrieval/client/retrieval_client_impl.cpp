@@ -4,10 +4,16 @@
  */
 
 #include "markets/retrieval/client/retrieval_client_impl.hpp"
+
+#include <future>
+
+#include <boost/optional.hpp>
+
 #include "codec/cbor/cbor.hpp"
 #include "markets/retrieval/network/impl/network_client_impl.hpp"
 #include "markets/retrieval/network/sync_cbor_stream.hpp"
 #include "markets/retrieval/protocols/query_protocol.hpp"
+#include "markets/retrieval/protocols/retrieval_protocol.hpp"
 
 namespace fc::markets::retrieval::client {
   using PeerInfo = network::NetworkClient::PeerInfo;
@@ -42,16 +48,116 @@ namespace fc::markets::retrieval::client {
      */
   }
 
+  std::vector<RetrievalClientImpl::RankedProvider>
+  RetrievalClientImpl::rankProviders(const QueryRequest &request,
+                                     const std::vector<PeerInfo> &peers) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<std::future<boost::optional<RankedProvider>>> queries;
+    for (auto &peer : peers) {
+      queries.push_back(std::async(
+          std::launch::async,
+          [&, peer]() -> boost::optional<RankedProvider> {
+            auto start = Clock::now();
+            auto response = query(peer, request);
+            if (!response
+                || response.value()->response_status
+                       != QueryResponseStatus::QueryResponseAvailable) {
+              return boost::none;
+            }
+            return RankedProvider{
+                peer,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    Clock::now() - start),
+                std::move(response.value())};
+          }));
+    }
+    std::vector<RankedProvider> ranked;
+    for (auto &future : queries) {
+      if (auto provider = future.get()) {
+        ranked.push_back(std::move(*provider));
+      }
+    }
+    std::sort(ranked.begin(), ranked.end(), [](auto &lhs, auto &rhs) {
+      return lhs.latency < rhs.latency;
+    });
+    return ranked;
+  }
+
   outcome::result<std::vector<Block>> RetrievalClientImpl::retrieve(
       const CID &piece_cid,
       const PeerInfo &provider_peer,
       const DealProfile &deal_profile) {
     return std::vector<Block>{};
   }
+
+  outcome::result<void> RetrievalClientImpl::retrieveStream(
+      const CID &payload_cid,
+      const PeerInfo &provider_peer,
+      const DealProfile &deal_profile,
+      DealID deal_id,
+      IpldPtr ipld,
+      RetrievalProgress &progress,
+      RetrievalSink::BlockHandler on_block,
+      RetrievalSink::PaymentHandler on_payment) {
+    using retrieval::DealStatus;
+    RetrievalSink sink{std::move(ipld),
+                       deal_profile,
+                       progress,
+                       std::move(on_block),
+                       std::move(on_payment)};
+    auto result = [&]() -> outcome::result<void> {
+      OUTCOME_TRY(stream, connect(provider_peer, kRetrievalProtocolId));
+      auto sync_stream = std::make_shared<network::SyncCborStream>(stream);
+      OUTCOME_TRY(sync_stream->write(
+          DealProposal{payload_cid,
+                       deal_id,
+                       {deal_profile.price_per_byte,
+                        deal_profile.payment_interval,
+                        deal_profile.payment_interval_increase}}));
+      while (true) {
+        OUTCOME_TRY(response, sync_stream->read<DealResponse>());
+        for (auto &block : response->blocks) {
+          OUTCOME_TRY(sink.push(std::move(block)));
+        }
+        switch (response->status) {
+          case DealStatus::DealStatusRejected:
+          case DealStatus::DealStatusDealNotFound:
+            logger_->warn("deal {} rejected: {}", deal_id, response->message);
+            return RetrievalClientError::DEAL_REJECTED;
+          case DealStatus::DealStatusFailed:
+          case DealStatus::DealStatusErrored:
+            logger_->warn("deal {} failed: {}", deal_id, response->message);
+            return RetrievalClientError::DEAL_FAILED;
+          case DealStatus::DealStatusFundsNeededLastPayment:
+          case DealStatus::DealStatusBlocksComplete:
+          case DealStatus::DealStatusCompleted:
+            return sink.finish();
+          default:
+            break;
+        }
+      }
+    }();
+    // stored blocks are not requested again on resumption
+    progress = sink.progress();
+    return result;
+  }
 }  // namespace fc::markets::retrieval::client
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::markets::retrieval::client,
                             RetrievalClientError,
                             e) {
-  return "NOT IMPLEMENTED";
+  using fc::markets::retrieval::client::RetrievalClientError;
+  switch (e) {
+    case RetrievalClientError::NOT_IMPLEMENTED:
+      return "Retrieval client: not implemented";
+    case RetrievalClientError::BAD_BLOCK:
+      return "Retrieval client: block does not match its CID";
+    case RetrievalClientError::FUNDS_EXPENDED:
+      return "Retrieval client: deal funds expended";
+    case RetrievalClientError::DEAL_REJECTED:
+      return "Retrieval client: deal rejected by provider";
+    case RetrievalClientError::DEAL_FAILED:
+      return "Retrieval client: deal failed on provider";
+  }
+  return "Retrieval client: unknown error";
 }
@@ -6,6 +6,7 @@
 #ifndef CPP_FILECOIN_CORE_MARKETS_RETRIEVAL_CLIENT_IMPL_HPP
 #define CPP_FILECOIN_CORE_MARKETS_RETRIEVAL_CLIENT_IMPL_HPP
 
+#include <chrono>
 #include <memory>
 
 #include <libp2p/host/basic_host/basic_host.hpp>
@@ -35,11 +36,36 @@ namespace fc::markets::retrieval::client {
     outcome::result<QueryResponseShPtr> query(const PeerInfo &peer,
                                          const QueryRequest &request) override;
 
+    /// Provider having payload, with time of its query response
+    struct RankedProvider {
+      PeerInfo peer;
+      std::chrono::microseconds latency;
+      QueryResponseShPtr response;
+    };
+
+    /**
+     * @brief queries providers concurrently, for example to give peers to
+     * MultiPeerFetch in order of expected speed
+     * @return providers which have payload available, fastest first
+     */
+    std::vector<RankedProvider> rankProviders(
+        const QueryRequest &request, const std::vector<PeerInfo> &peers);
+
     outcome::result<std::vector<Block>> retrieve(
         const CID &piece_cid,
         const PeerInfo &provider_peer,
         const DealProfile &deal_profile) override;
 
+    outcome::result<void> retrieveStream(
+        const CID &payload_cid,
+        const PeerInfo &provider_peer,
+        const DealProfile &deal_profile,
+        DealID deal_id,
+        IpldPtr ipld,
+        RetrievalProgress &progress,
+        RetrievalSink::BlockHandler on_block,
+        RetrievalSink::PaymentHandler on_payment) override;
+
    private:
     std::shared_ptr<HostService> host_service_;
     common::Logger logger_;
@@ -0,0 +1,104 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "markets/retrieval/client/retrieval_sink.hpp"
+
+#include "crypto/hasher/hasher.hpp"
+#include "markets/retrieval/retrieval_client.hpp"
+
+namespace fc::markets::retrieval::client {
+  using crypto::Hasher;
+  using libp2p::multi::HashType;
+
+  namespace {
+    /// Blocks with hash types unknown to Hasher are not verified
+    bool verifyBlock(const Block &block) {
+      auto type = block.cid.content_address.getType();
+      if (type != HashType::sha256 && type != HashType::blake2b_256) {
+        return true;
+      }
+      return Hasher::calculate(type, block.bytes) == block.cid.content_address;
+    }
+  }  // namespace
+
+  RetrievalSink::RetrievalSink(IpldPtr ipld,
+                               DealProfile profile,
+                               RetrievalProgress progress,
+                               BlockHandler on_block,
+                               PaymentHandler on_payment)
+      : ipld_{std::move(ipld)},
+        profile_{std::move(profile)},
+        progress_{progress},
+        on_block_{std::move(on_block)},
+        on_payment_{std::move(on_payment)} {
+    if (progress_.payment_interval == 0) {
+      progress_.payment_interval = profile_.payment_interval;
+    }
+  }
+
+  outcome::result<void> RetrievalSink::push(Block block) {
+    // stored before interruption
+    if (received_++ < progress_.blocks) {
+      return outcome::success();
+    }
+    if (!verifyBlock(block)) {
+      return RetrievalClientError::BAD_BLOCK;
+    }
+    batch_bytes_ += block.bytes.size();
+    batch_.emplace_back(std::move(block.cid), std::move(block.bytes));
+    auto interval = progress_.payment_interval;
+    auto unpaid = progress_.bytes + batch_bytes_ - progress_.paid_bytes;
+    auto payment_due = interval != 0 && unpaid >= interval;
+    if (batch_.size() >= kBatchSize || payment_due) {
+      OUTCOME_TRY(flush());
+    }
+    if (payment_due) {
+      OUTCOME_TRY(pay());
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> RetrievalSink::finish() {
+    OUTCOME_TRY(flush());
+    if (progress_.bytes > progress_.paid_bytes) {
+      OUTCOME_TRY(pay());
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> RetrievalSink::flush() {
+    if (batch_.empty()) {
+      return outcome::success();
+    }
+    std::vector<std::pair<CID, uint64_t>> stored;
+    stored.reserve(batch_.size());
+    for (auto &[cid, bytes] : batch_) {
+      stored.emplace_back(cid, bytes.size());
+    }
+    OUTCOME_TRY(ipld_->setMany(std::move(batch_)));
+    batch_.clear();
+    progress_.blocks += stored.size();
+    progress_.bytes += batch_bytes_;
+    batch_bytes_ = 0;
+    if (on_block_) {
+      for (auto &[cid, size] : stored) {
+        on_block_(cid, size);
+      }
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> RetrievalSink::pay() {
+    // vouchers carry total amount, not increment
+    TokenAmount total = profile_.price_per_byte * progress_.bytes;
+    if (total > profile_.total_funds) {
+      return RetrievalClientError::FUNDS_EXPENDED;
+    }
+    OUTCOME_TRY(on_payment_(total, progress_.bytes));
+    progress_.paid_bytes = progress_.bytes;
+    progress_.payment_interval += profile_.payment_interval_increase;
+    return outcome::success();
+  }
+}  // namespace fc::markets::retrieval::client
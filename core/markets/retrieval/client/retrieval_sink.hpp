@@ -0,0 +1,96 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_MARKETS_RETRIEVAL_CLIENT_SINK_HPP
+#define CPP_FILECOIN_CORE_MARKETS_RETRIEVAL_CLIENT_SINK_HPP
+
+#include <functional>
+
+#include "codec/cbor/streams_annotation.hpp"
+#include "markets/retrieval/client/retrieval_client_types.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::markets::retrieval::client {
+  /**
+   * @struct Progress of retrieval, kept by caller to resume interrupted deal
+   */
+  struct RetrievalProgress {
+    /* Blocks received, skipped when provider sends them again */
+    uint64_t blocks{};
+
+    /* Bytes received */
+    uint64_t bytes{};
+
+    /* Bytes covered by sent payments */
+    uint64_t paid_bytes{};
+
+    /* Bytes before next payment, zero means deal payment interval */
+    uint64_t payment_interval{};
+  };
+
+  CBOR_TUPLE(RetrievalProgress, blocks, bytes, paid_bytes, payment_interval);
+
+  /**
+   * Consumes blocks of retrieval as they arrive. Each block is checked
+   * against its CID, stored in batches and reported to callback, so blocks
+   * are not kept until transfer ends. Payment is requested each time
+   * payment interval of bytes is received.
+   */
+  class RetrievalSink {
+   public:
+    /// Blocks written to datastore at once
+    static constexpr size_t kBatchSize{64};
+
+    /// Called for each stored block, its bytes are read from datastore
+    using BlockHandler = std::function<void(const CID &cid, uint64_t size)>;
+    /**
+     * Sends voucher for total amount owed since start of deal
+     * @param bytes - bytes received, covered by voucher
+     */
+    using PaymentHandler = std::function<outcome::result<void>(
+        const TokenAmount &total, uint64_t bytes)>;
+
+    /**
+     * @param progress - progress of interrupted retrieval, or empty
+     */
+    RetrievalSink(IpldPtr ipld,
+                  DealProfile profile,
+                  RetrievalProgress progress,
+                  BlockHandler on_block,
+                  PaymentHandler on_payment);
+
+    /**
+     * @brief verifies and queues block, blocks are expected in same order
+     * after resumption, as provider traverses dag deterministically
+     */
+    outcome::result<void> push(Block block);
+
+    /// Stores queued blocks and pays for remaining bytes
+    outcome::result<void> finish();
+
+    /// Stored and paid blocks, queued blocks are not included
+    const RetrievalProgress &progress() const {
+      return progress_;
+    }
+
+   private:
+    /// Writes queued blocks and reports them
+    outcome::result<void> flush();
+
+    outcome::result<void> pay();
+
+    IpldPtr ipld_;
+    DealProfile profile_;
+    RetrievalProgress progress_;
+    BlockHandler on_block_;
+    PaymentHandler on_payment_;
+    /// Blocks received since resumption, including skipped
+    uint64_t received_{};
+    Ipld::Blocks batch_;
+    uint64_t batch_bytes_{};
+  };
+}  // namespace fc::markets::retrieval::client
+
+#endif  // CPP_FILECOIN_CORE_MARKETS_RETRIEVAL_CLIENT_SINK_HPP
@@ -8,37 +8,63 @@
 
 namespace fc::markets::retrieval::provider {
   void QueryResponderImpl::onNewRequest(const CborStreamShPtr &stream) {
-    stream->read<QueryRequest>([self = shared_from_this(), stream](
-                                   outcome::result<QueryRequest> request_res) {
-      auto payment_address_res = self->api_->WalletDefaultAddress();
-      if (!payment_address_res.has_value()) {
-        self->logger_->error("Failed to determine payment address");
-        self->closeNetworkStream(stream->stream());
-        return;
-      }
-      if (!request_res.has_value()) {
-        self->logger_->debug("Received incorrect request");
-        self->closeNetworkStream(stream->stream());
-        return;
+    auto self{shared_from_this()};
+    stream->respondEncoded<QueryRequest>(
+        [self](auto &request) { return self->answer(request); },
+        [self, stream](auto result) {
+          if (!result.has_value()) {
+            SPDLOG_LOGGER_DEBUG(self->logger_,
+                                "Query failed: " + result.error().message());
+          }
+          self->closeNetworkStream(stream->stream());
+        });
+  }
+
+  void QueryResponderImpl::invalidate() {
+    std::lock_guard lock{cache_mutex_};
+    cache_.clear();
+  }
+
+  outcome::result<QueryResponderImpl::Encoded> QueryResponderImpl::answer(
+      const QueryRequest &request) {
+    std::pair key{request.payload_cid, request.params.piece_cid};
+    // read before lookups, so answer is stale if storage changes meanwhile
+    auto generation{piece_storage_->generation()};
+    {
+      std::lock_guard lock{cache_mutex_};
+      auto it{cache_.find(key)};
+      if (it != cache_.end() && it->second.generation == generation) {
+        return it->second.encoded;
       }
-      QueryResponse response;
-      response.response_status = QueryResponseStatus::QueryResponseAvailable,
-      response.item_status =
-          self->getItemStatus(request_res.value().payload_cid,
-                              request_res.value().params.piece_cid);
-      response.payment_address = payment_address_res.value();
-      response.min_price_per_byte = self->provider_config_.price_per_byte;
-      response.payment_interval = self->provider_config_.payment_interval;
-      response.interval_increase = self->provider_config_.interval_increase;
-      stream->write(
-          response,
-          [self = self->shared_from_this(), stream](outcome::result<size_t> result) {
-            if (!result.has_value()) {
-              self->logger_->debug("Failed to send response");
-            }
-            self->closeNetworkStream(stream->stream());
-          });
-    });
+    }
+    OUTCOME_TRY(response, makeResponse(request));
+    OUTCOME_TRY(encoded, codec::cbor::encode(response));
+    auto shared{
+        std::make_shared<const std::vector<uint8_t>>(encoded.toVector())};
+    std::lock_guard lock{cache_mutex_};
+    if (cache_.size() >= kMaxCachedAnswers) {
+      cache_.clear();
+    }
+    cache_.insert_or_assign(std::move(key), Cached{generation, shared});
+    return shared;
+  }
+
+  outcome::result<QueryResponse> QueryResponderImpl::makeResponse(
+      const QueryRequest &request) const {
+    auto payment_address_res = api_->WalletDefaultAddress();
+    if (!payment_address_res.has_value()) {
+      logger_->error("Failed to determine payment address");
+      return payment_address_res.error();
+    }
+    QueryResponse response;
+    response.response_status = QueryResponseStatus::QueryResponseAvailable;
+    response.item_status =
+        getItemStatus(request.payload_cid, request.params.piece_cid);
+    response.payment_address = payment_address_res.value();
+    response.min_price_per_byte = provider_config_.price_per_byte;
+    response.payment_interval = provider_config_.payment_interval;
+    response.interval_increase = provider_config_.interval_increase;
+    return response;
   }
 
   QueryItemStatus QueryResponderImpl::getItemStatus(
@@ -6,7 +6,9 @@
 #ifndef CPP_FILECOIN_MARKETS_RETRIEVAL_PROVIDER_QUERY_RESPONDER_IMPL_HPP
 #define CPP_FILECOIN_MARKETS_RETRIEVAL_PROVIDER_QUERY_RESPONDER_IMPL_HPP
 
+#include <map>
 #include <memory>
+#include <mutex>
 
 #include <libp2p/connection/stream.hpp>
 #include "api/api.hpp"
@@ -17,6 +19,14 @@
 #include "storage/piece/piece_storage.hpp"
 
 namespace fc::markets::retrieval::provider {
+  /**
+   * Answers retrieval queries.
+   * Answers are encoded once and cached by payload and piece cid, so
+   * repeated queries for popular content are written to stream without
+   * storage lookups, api calls and encoding. Cached answer is dropped when
+   * piece storage generation changes, invalidate() drops all answers after
+   * ask or default wallet change.
+   */
   class QueryResponderImpl
       : public std::enable_shared_from_this<QueryResponderImpl> {
    protected:
@@ -38,11 +48,34 @@ namespace fc::markets::retrieval::provider {
 
     void onNewRequest(const CborStreamShPtr &stream);
 
+    /// Drops cached answers, called after provider config changes
+    void invalidate();
+
+    /// Cache is cleared when it grows to this size
+    static constexpr size_t kMaxCachedAnswers{4096};
+
    private:
+    using Encoded = common::libp2p::CborStream::Encoded;
+
+    struct Cached {
+      /// Piece storage generation answer was computed for
+      uint64_t generation;
+      Encoded encoded;
+    };
+
     PieceStorageShPtr piece_storage_;
     ApiShPtr api_;
     common::Logger logger_;
     const ProviderConfig &provider_config_;
+    std::mutex cache_mutex_;
+    /// Answers by payload and piece cid
+    std::map<std::pair<CID, CID>, Cached> cache_;
+
+    /// Returns cached answer or computes and caches new one
+    outcome::result<Encoded> answer(const QueryRequest &request);
+
+    outcome::result<QueryResponse> makeResponse(
+        const QueryRequest &request) const;
 
     QueryItemStatus getItemStatus(const CID &payload_cid,
                                   const CID &piece_cid) const;
@@ -24,12 +24,14 @@ namespace fc::markets::retrieval::provider {
 
   void RetrievalProviderImpl::setPricePerByte(TokenAmount amount) {
     config_.price_per_byte = amount;
+    query_responder_->invalidate();
   }
 
   void RetrievalProviderImpl::setPaymentInterval(
       uint64_t payment_interval, uint64_t payment_interval_increase) {
     config_.payment_interval = payment_interval;
     config_.interval_increase = payment_interval_increase;
+    query_responder_->invalidate();
   }
 
 }  // namespace fc::markets::retrieval::provider
@@ -0,0 +1,131 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "markets/retrieval/provider/voucher_cache.hpp"
+
+#include "codec/cbor/cbor.hpp"
+
+namespace fc::markets::retrieval::provider {
+  VoucherCache::VoucherCache(std::shared_ptr<KeyStore> keystore)
+      : keystore_{std::move(keystore)} {}
+
+  void VoucherCache::addChannel(const Address &channel,
+                                const Address &from,
+                                const std::vector<LaneState> &lanes) {
+    Channel state{from, {}};
+    for (auto &lane : lanes) {
+      state.lanes.emplace(lane.id, Lane{lane, {}});
+    }
+    std::lock_guard lock{mutex_};
+    channels_[channel] = std::move(state);
+  }
+
+  bool VoucherCache::hasChannel(const Address &channel) const {
+    std::lock_guard lock{mutex_};
+    return channels_.count(channel) != 0;
+  }
+
+  outcome::result<TokenAmount> VoucherCache::add(
+      const Address &channel, const SignedVoucher &voucher) {
+    if (!voucher.signature) {
+      return VoucherError::NO_SIGNATURE;
+    }
+    OUTCOME_TRY(encoded, codec::cbor::encode(voucher));
+    Address from;
+    {
+      std::lock_guard lock{mutex_};
+      auto it = channels_.find(channel);
+      if (it == channels_.end()) {
+        return VoucherError::UNKNOWN_CHANNEL;
+      }
+      auto lane = it->second.lanes.find(voucher.lane);
+      if (lane != it->second.lanes.end() && lane->second.voucher == encoded) {
+        return TokenAmount{0};
+      }
+      from = it->second.from;
+    }
+
+    // verified without lock, signature check is the slow part
+    auto signable = voucher;
+    signable.signature = boost::none;
+    OUTCOME_TRY(signable_bytes, codec::cbor::encode(signable));
+    OUTCOME_TRY(verified,
+                keystore_->verify(from, signable_bytes, *voucher.signature));
+    if (!verified) {
+      return VoucherError::INVALID_SIGNATURE;
+    }
+
+    std::lock_guard lock{mutex_};
+    auto it = channels_.find(channel);
+    if (it == channels_.end() || !(it->second.from == from)) {
+      return VoucherError::UNKNOWN_CHANNEL;
+    }
+    auto &lanes = it->second.lanes;
+    LaneState empty{voucher.lane, 0, 0};
+    auto lane = lanes.find(voucher.lane);
+    auto &state = lane != lanes.end() ? lane->second.state : empty;
+    // greater nonce is required, so same voucher isn't paid twice
+    if (lane != lanes.end() && state.nonce >= voucher.nonce) {
+      return VoucherError::STALE_NONCE;
+    }
+    auto redeem = state.redeem;
+    for (auto &merge : voucher.merges) {
+      auto merged = lanes.find(merge.lane);
+      if (merge.lane == voucher.lane || merged == lanes.end()
+          || merged->second.state.nonce >= merge.nonce) {
+        return VoucherError::INVALID_MERGE;
+      }
+      redeem += merged->second.state.redeem;
+    }
+    TokenAmount added = voucher.amount - redeem;
+    if (added <= 0) {
+      return VoucherError::NOT_INCREASED;
+    }
+
+    // lanes change only after all checks passed
+    for (auto &merge : voucher.merges) {
+      lanes.at(merge.lane).state.nonce = merge.nonce;
+    }
+    auto &updated = lanes[voucher.lane];
+    updated.state = {voucher.lane, voucher.amount, voucher.nonce};
+    updated.voucher = std::move(encoded);
+    return added;
+  }
+
+  outcome::result<TokenAmount> VoucherCache::redeemable(
+      const Address &channel) const {
+    std::lock_guard lock{mutex_};
+    auto it = channels_.find(channel);
+    if (it == channels_.end()) {
+      return VoucherError::UNKNOWN_CHANNEL;
+    }
+    TokenAmount total{0};
+    for (auto &lane : it->second.lanes) {
+      total += lane.second.state.redeem;
+    }
+    return total;
+  }
+}  // namespace fc::markets::retrieval::provider
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::markets::retrieval::provider,
+                            VoucherError,
+                            e) {
+  using E = fc::markets::retrieval::provider::VoucherError;
+  switch (e) {
+    case E::UNKNOWN_CHANNEL:
+      return "VoucherCache: unknown payment channel";
+    case E::NO_SIGNATURE:
+      return "VoucherCache: voucher is not signed";
+    case E::INVALID_SIGNATURE:
+      return "VoucherCache: invalid voucher signature";
+    case E::STALE_NONCE:
+      return "VoucherCache: voucher nonce is not greater than lane nonce";
+    case E::INVALID_MERGE:
+      return "VoucherCache: invalid lane merge";
+    case E::NOT_INCREASED:
+      return "VoucherCache: voucher doesn't increase channel amount";
+  }
+  return "VoucherCache: unknown error";
+}
@@ -0,0 +1,86 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_MARKETS_RETRIEVAL_PROVIDER_VOUCHER_CACHE_HPP
+#define CPP_FILECOIN_CORE_MARKETS_RETRIEVAL_PROVIDER_VOUCHER_CACHE_HPP
+
+#include <map>
+#include <mutex>
+
+#include "storage/keystore/keystore.hpp"
+#include "vm/actor/builtin/payment_channel/payment_channel_actor_state.hpp"
+
+namespace fc::markets::retrieval::provider {
+  using common::Buffer;
+  using primitives::TokenAmount;
+  using primitives::address::Address;
+  using storage::keystore::KeyStore;
+  using vm::actor::builtin::payment_channel::LaneId;
+  using vm::actor::builtin::payment_channel::LaneState;
+  using vm::actor::builtin::payment_channel::SignedVoucher;
+
+  enum class VoucherError {
+    UNKNOWN_CHANNEL = 1,
+    NO_SIGNATURE,
+    INVALID_SIGNATURE,
+    STALE_NONCE,
+    INVALID_MERGE,
+    NOT_INCREASED,
+  };
+
+  /**
+   * Off-chain check of payment vouchers received by retrieval provider,
+   * with rules of payment channel UpdateChannelState. Lanes of channel are
+   * kept in memory, so incremental voucher is checked against them without
+   * channel state, and its signature is verified once for all merges.
+   * Voucher sent again, e.g. after reconnect, is not verified again.
+   */
+  class VoucherCache {
+   public:
+    explicit VoucherCache(std::shared_ptr<KeyStore> keystore);
+
+    /**
+     * @brief starts checking vouchers of channel, kept lanes are replaced
+     * @param channel - payment channel actor address
+     * @param from - key address of client, signer of vouchers
+     * @param lanes - lanes of channel state, empty for new channel
+     */
+    void addChannel(const Address &channel,
+                    const Address &from,
+                    const std::vector<LaneState> &lanes = {});
+
+    bool hasChannel(const Address &channel) const;
+
+    /**
+     * @brief checks voucher and updates lanes of channel
+     * @return amount voucher adds to channel, zero if it was accepted before
+     */
+    outcome::result<TokenAmount> add(const Address &channel,
+                                     const SignedVoucher &voucher);
+
+    /// Amount redeemable by best vouchers of all lanes
+    outcome::result<TokenAmount> redeemable(const Address &channel) const;
+
+   private:
+    struct Lane {
+      LaneState state;
+      /// Encoded last accepted voucher of lane
+      Buffer voucher;
+    };
+
+    struct Channel {
+      Address from;
+      std::map<LaneId, Lane> lanes;
+    };
+
+    std::shared_ptr<KeyStore> keystore_;
+    mutable std::mutex mutex_;
+    std::map<Address, Channel> channels_;
+  };
+}  // namespace fc::markets::retrieval::provider
+
+OUTCOME_HPP_DECLARE_ERROR(fc::markets::retrieval::provider, VoucherError);
+
+#endif  // CPP_FILECOIN_CORE_MARKETS_RETRIEVAL_PROVIDER_VOUCHER_CACHE_HPP
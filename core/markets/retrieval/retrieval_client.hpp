@@ -11,6 +11,7 @@
 #include <libp2p/peer/peer_info.hpp>
 #include "common/outcome.hpp"
 #include "markets/retrieval/client/retrieval_client_types.hpp"
+#include "markets/retrieval/client/retrieval_sink.hpp"
 #include "markets/retrieval/protocols/query_protocol.hpp"
 #include "markets/retrieval/protocols/retrieval_protocol.hpp"
 #include "primitives/address/address.hpp"
@@ -59,12 +60,41 @@ namespace fc::markets::retrieval::client {
         const CID &piece_cid,
         const Peer &provider_peer,
         const DealProfile &deal_profile) = 0;
+
+    /**
+     * @brief Retrieve dag from selected provider into datastore, blocks are
+     * stored as they arrive instead of being kept in memory
+     * @param payload_cid - root of the requested dag
+     * @param provider_peer - provider to make a deal
+     * @param deal_profile - deal properties
+     * @param deal_id - identifier of the deal, same to resume it
+     * @param ipld - datastore for received blocks
+     * @param progress - progress of interrupted retrieval or empty, updated
+     * as blocks are stored, also on error, so it can be resumed
+     * @param on_block - called for each stored block
+     * @param on_payment - sends payment voucher
+     */
+    virtual outcome::result<void> retrieveStream(
+        const CID &payload_cid,
+        const Peer &provider_peer,
+        const DealProfile &deal_profile,
+        DealID deal_id,
+        IpldPtr ipld,
+        RetrievalProgress &progress,
+        RetrievalSink::BlockHandler on_block,
+        RetrievalSink::PaymentHandler on_payment) = 0;
   };
 
   /**
    * @enum Retrieval client errors
    */
-  enum class RetrievalClientError { NOT_IMPLEMENTED };
+  enum class RetrievalClientError {
+    NOT_IMPLEMENTED = 1,
+    BAD_BLOCK,
+    FUNDS_EXPENDED,
+    DEAL_REJECTED,
+    DEAL_FAILED,
+  };
 }  // namespace fc::markets::retrieval::client
 
 OUTCOME_HPP_DECLARE_ERROR(fc::markets::retrieval::client, RetrievalClientError);
@@ -6,15 +6,14 @@
 #include "markets/storage/client/impl/client_state_store.hpp"
 
 namespace fc::markets::storage::client {
-  ClientFsmStateStore::ClientFsmStateStore(std::shared_ptr<ClientFSM> fsm)
-      : fsm_{std::move(fsm)} {}
+  ClientDealStateStore::ClientDealStateStore(
+      std::shared_ptr<const ClientDealIndex> deals)
+      : deals_{std::move(deals)} {}
 
-  outcome::result<ClientDeal> ClientFsmStateStore::get(
+  outcome::result<ClientDeal> ClientDealStateStore::get(
       const CID &proposal_cid) const {
-    for (const auto &it : fsm_->list()) {
-      if (it.first->proposal_cid == proposal_cid) {
-        return *it.first;
-      }
+    if (auto deal{deals_->get(proposal_cid)}) {
+      return std::move(*deal);
     }
     return ClientStateStoreError::STATE_NOT_FOUND;
   }
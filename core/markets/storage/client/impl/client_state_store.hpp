@@ -9,23 +9,25 @@
 #include "fsm/fsm.hpp"
 #include "fsm/state_store.hpp"
 #include "markets/storage/client/client_events.hpp"
-#include "markets/storage/deal_protocol.hpp"
+#include "markets/storage/deal_index.hpp"
 
 namespace fc::markets::storage::client {
   using ClientFSM = fsm::FSM<ClientEvent, StorageDealStatus, ClientDeal>;
   using ClientStateStore = fsm::StateStore<CID, ClientDeal>;
+  using ClientDealIndex = DealIndex<ClientDeal>;
 
   /**
-   * Client state store implemented over client FSM
+   * Client state store implemented over index of client deals
    */
-  class ClientFsmStateStore : public ClientStateStore {
+  class ClientDealStateStore : public ClientStateStore {
    public:
-    explicit ClientFsmStateStore(std::shared_ptr<ClientFSM> fsm);
+    explicit ClientDealStateStore(
+        std::shared_ptr<const ClientDealIndex> deals);
 
     outcome::result<ClientDeal> get(const CID &proposal_cid) const override;
 
    private:
-    std::shared_ptr<ClientFSM> fsm_;
+    std::shared_ptr<const ClientDealIndex> deals_;
   };
 
   enum class ClientStateStoreError { STATE_NOT_FOUND };
@@ -5,6 +5,7 @@
 
 #include "storage_market_client_impl.hpp"
 
+#include <boost/asio/post.hpp>
 #include <libp2p/peer/peer_id.hpp>
 #include <libp2p/protocol/common/asio/asio_scheduler.hpp>
 #include "codec/cbor/cbor.hpp"
@@ -21,7 +22,7 @@
 
 #define CALLBACK_ACTION(_action)                                          \
   [self{shared_from_this()}](auto deal, auto event, auto from, auto to) { \
-    self->logger_->debug("Client FSM " #_action);                         \
+    SPDLOG_LOGGER_DEBUG(self->logger_, "Client FSM " #_action);           \
     self->_action(deal, event, from, to);                                 \
     deal->state = to;                                                     \
   }
@@ -83,13 +84,18 @@ namespace fc::markets::storage::client {
   }
 
   outcome::result<void> StorageMarketClientImpl::init() {
+    OUTCOME_TRY(discovery_->load());
+
     // init fsm transitions
     std::shared_ptr<HostContext> fsm_context =
         std::make_shared<HostContextImpl>(context_);
     fsm_ = std::make_shared<ClientFSM>(makeFSMTransitions(), fsm_context);
+    fsm_->setAnyChangeAction([deals{deals_}](auto deal, auto, auto, auto to) {
+      deals->update(deal, to);
+    });
 
     // register request validator
-    auto state_store = std::make_shared<ClientFsmStateStore>(fsm_);
+    auto state_store = std::make_shared<ClientDealStateStore>(deals_);
     auto validator =
         std::make_shared<ClientDataTransferRequestValidator>(state_store);
     OUTCOME_TRY(datatransfer_->init(StorageDataTransferVoucherType, validator));
@@ -136,19 +142,13 @@ namespace fc::markets::storage::client {
 
   outcome::result<std::vector<ClientDeal>>
   StorageMarketClientImpl::listLocalDeals() const {
-    std::vector<ClientDeal> res;
-    for (const auto &it : fsm_->list()) {
-      res.push_back(*it.first);
-    }
-    return res;
+    return deals_->list().deals;
   }
 
   outcome::result<ClientDeal> StorageMarketClientImpl::getLocalDeal(
       const CID &proposal_cid) const {
-    for (const auto &it : fsm_->list()) {
-      if (it.first->proposal_cid == proposal_cid) {
-        return *it.first;
-      }
+    if (auto deal{deals_->get(proposal_cid)}) {
+      return std::move(*deal);
     }
     return StorageMarketClientError::LOCAL_DEAL_NOT_FOUND;
   }
@@ -169,24 +169,19 @@ namespace fc::markets::storage::client {
           }
           auto stream = std::move(stream_res.value());
           AskRequest request{.miner = info.address};
-          stream->write(request,
-                        [self, info, stream, signed_ask_handler](
-                            outcome::result<size_t> written) {
-                          if (!self->hasValue(written,
-                                              "Cannot send request",
-                                              stream,
-                                              signed_ask_handler)) {
-                            return;
-                          }
-                          stream->template read<AskResponse>(
-                              [self, info, stream, signed_ask_handler](
-                                  outcome::result<AskResponse> response) {
-                                auto validated_ask_response =
-                                    self->validateAskResponse(response, info);
-                                signed_ask_handler(validated_ask_response);
-                                self->network_->closeStreamGracefully(stream);
-                              });
-                        });
+          stream->template request<AskRequest, AskResponse>(
+              request,
+              [self, info, stream, signed_ask_handler](
+                  outcome::result<AskResponse> response) {
+                if (!response) {
+                  self->logger_->error("Ask request error "
+                                       + response.error().message());
+                }
+                auto validated_ask_response =
+                    self->validateAskResponse(response, info);
+                signed_ask_handler(validated_ask_response);
+                self->network_->closeStreamGracefully(stream);
+              });
         });
   }
 
@@ -233,6 +228,7 @@ namespace fc::markets::storage::client {
                    .publish_message = {}});
     OUTCOME_TRY(
         fsm_->begin(client_deal, StorageDealStatus::STORAGE_DEAL_UNKNOWN));
+    deals_->update(client_deal, StorageDealStatus::STORAGE_DEAL_UNKNOWN);
 
     network_->newDealStream(
         provider_info.peer_info,
@@ -243,9 +239,10 @@ namespace fc::markets::storage::client {
               "Cannot open stream to "
                   + peerInfoToPrettyString(provider_info.peer_info),
               client_deal);
-          self->logger_->debug(
+          SPDLOG_LOGGER_DEBUG(
+              self->logger_,
               "DealStream opened to "
-              + peerInfoToPrettyString(provider_info.peer_info));
+                  + peerInfoToPrettyString(provider_info.peer_info));
 
           std::lock_guard<std::mutex> lock(self->connections_mutex_);
           self->connections_.emplace(proposal_cid, stream.value());
@@ -257,6 +254,35 @@ namespace fc::markets::storage::client {
     return client_deal->proposal_cid;
   }
 
+  outcome::result<std::vector<outcome::result<CID>>>
+  StorageMarketClientImpl::proposeStorageDeals(
+      const Address &client_address,
+      const std::vector<StorageProviderInfo> &providers,
+      const DataRef &data_ref,
+      const ChainEpoch &start_epoch,
+      const ChainEpoch &end_epoch,
+      const TokenAmount &price,
+      const TokenAmount &collateral,
+      const RegisteredProof &registered_proof) {
+    // computed once here, proposals get memoized commitment
+    OUTCOME_TRY(calculateCommP(registered_proof, data_ref));
+    std::vector<outcome::result<CID>> proposals;
+    proposals.reserve(providers.size());
+    for (auto &provider : providers) {
+      // deal stream is opened asynchronously, so providers are proposed to
+      // concurrently
+      proposals.push_back(proposeStorageDeal(client_address,
+                                             provider,
+                                             data_ref,
+                                             start_epoch,
+                                             end_epoch,
+                                             price,
+                                             collateral,
+                                             registered_proof));
+    }
+    return std::move(proposals);
+  }
+
   outcome::result<StorageParticipantBalance>
   StorageMarketClientImpl::getPaymentEscrow(const Address &address) const {
     OUTCOME_TRY(chain_head, api_->ChainHead());
@@ -309,13 +335,13 @@ namespace fc::markets::storage::client {
         keystore_->verify(
             miner_key_address, ask_bytes, response.value().ask.signature));
     if (!signature_valid) {
-      logger_->debug("Ask response signature invalid");
+      SPDLOG_LOGGER_DEBUG(logger_, "Ask response signature invalid");
       return StorageMarketClientError::SIGNATURE_INVALID;
     }
     return response.value().ask;
   }
 
-  outcome::result<std::pair<CID, UnpaddedPieceSize>>
+  outcome::result<StorageMarketClientImpl::CommP>
   StorageMarketClientImpl::calculateCommP(
       const RegisteredProof &registered_proof, const DataRef &data_ref) const {
     if (data_ref.piece_cid.has_value()) {
@@ -327,8 +353,43 @@ namespace fc::markets::storage::client {
 
     // TODO (a.chernyshov) selector builder
     // https://github.com/filecoin-project/go-fil-markets/blob/master/storagemarket/impl/clientutils/clientutils.go#L31
-    return piece_io_->generatePieceCommitment(
-        registered_proof, data_ref.root, {});
+    Selector selector;
+    CommPKey key{
+        data_ref.root, Buffer{selector.encode().data()}, registered_proof};
+    auto comm_p{commPFuture(key, selector).get()};
+    if (!comm_p) {
+      std::lock_guard lock{comm_p_mutex_};
+      auto it{comm_p_.find(key)};
+      // entry may be replaced by retry already
+      if (it != comm_p_.end()
+          && it->second.wait_for(std::chrono::seconds{0})
+                 == std::future_status::ready
+          && !it->second.get()) {
+        comm_p_.erase(it);
+      }
+    }
+    return comm_p;
+  }
+
+  std::shared_future<outcome::result<StorageMarketClientImpl::CommP>>
+  StorageMarketClientImpl::commPFuture(const CommPKey &key,
+                                       const Selector &selector) const {
+    std::lock_guard lock{comm_p_mutex_};
+    auto it{comm_p_.find(key)};
+    if (it != comm_p_.end()) {
+      return it->second;
+    }
+    auto task{std::make_shared<std::packaged_task<outcome::result<CommP>()>>(
+        [piece_io{piece_io_},
+         proof{std::get<RegisteredProof>(key)},
+         root{std::get<CID>(key)},
+         selector] {
+          return piece_io->generatePieceCommitment(proof, root, selector);
+        })};
+    std::shared_future future{task->get_future()};
+    comm_p_.emplace(key, future);
+    boost::asio::post(comm_p_pool_, [task] { (*task)(); });
+    return future;
   }
 
   outcome::result<ClientDealProposal> StorageMarketClientImpl::signProposal(
@@ -373,9 +434,7 @@ namespace fc::markets::storage::client {
   }
 
   outcome::result<bool> StorageMarketClientImpl::verifyDealPublished(
-      std::shared_ptr<ClientDeal> deal) {
-    OUTCOME_TRY(msg_wait, api_->StateWaitMsg(deal->publish_message));
-    OUTCOME_TRY(msg_state, msg_wait.waitSync());
+      std::shared_ptr<ClientDeal> deal, const MsgWait &msg_state) {
     if (msg_state.receipt.exit_code != VMExitCode::Ok) {
       deal->message =
           "Publish deal exit code "
@@ -426,6 +485,37 @@ namespace fc::markets::storage::client {
     return true;
   }
 
+  void StorageMarketClientImpl::waitMessage(const CID &cid,
+                                            MsgWaitCallback callback) {
+    {
+      std::lock_guard lock{message_waits_mutex_};
+      auto &callbacks{message_waits_[cid]};
+      callbacks.push_back(std::move(callback));
+      if (callbacks.size() != 1) {
+        return;
+      }
+    }
+    auto finish{
+        [self{shared_from_this()}, cid](outcome::result<MsgWait> result) {
+          std::vector<MsgWaitCallback> callbacks;
+          {
+            std::lock_guard lock{self->message_waits_mutex_};
+            auto it{self->message_waits_.find(cid)};
+            callbacks = std::move(it->second);
+            self->message_waits_.erase(it);
+          }
+          for (auto &callback : callbacks) {
+            callback(result);
+          }
+        }};
+    auto maybe_wait{api_->StateWaitMsg(cid)};
+    if (!maybe_wait) {
+      finish(maybe_wait.error());
+      return;
+    }
+    maybe_wait.value().wait(std::move(finish));
+  }
+
   outcome::result<std::shared_ptr<CborStream>>
   StorageMarketClientImpl::getStream(const CID &proposal_cid) {
     std::lock_guard<std::mutex> lock(connections_mutex_);
@@ -512,9 +602,8 @@ namespace fc::markets::storage::client {
       ClientEvent event,
       StorageDealStatus from,
       StorageDealStatus to) {
-    auto maybe_wait = api_->StateWaitMsg(deal->add_funds_cid.get());
-    FSM_HALT_ON_ERROR(maybe_wait, "Wait for funding error", deal);
-    maybe_wait.value().wait(
+    waitMessage(
+        deal->add_funds_cid.get(),
         [self{shared_from_this()}, deal](outcome::result<MsgWait> result) {
           SELF_FSM_HALT_ON_ERROR(result, "Wait for funding error", deal);
           if (result.value().receipt.exit_code != VMExitCode::Ok) {
@@ -584,7 +673,7 @@ namespace fc::markets::storage::client {
       ClientEvent event,
       StorageDealStatus from,
       StorageDealStatus to) {
-    logger_->debug("Deal rejected");
+    SPDLOG_LOGGER_DEBUG(logger_, "Deal rejected");
     FSM_SEND(deal, ClientEvent::ClientEventFailed);
   }
 
@@ -593,13 +682,18 @@ namespace fc::markets::storage::client {
       ClientEvent event,
       StorageDealStatus from,
       StorageDealStatus to) {
-    auto verified = verifyDealPublished(deal);
-    FSM_HALT_ON_ERROR(verified, "Cannot get publish message", deal);
-    if (!verified.value()) {
-      FSM_SEND(deal, ClientEvent::ClientEventFailed);
-      return;
-    }
-    FSM_SEND(deal, ClientEvent::ClientEventDealPublished);
+    waitMessage(
+        deal->publish_message,
+        [self{shared_from_this()}, deal](outcome::result<MsgWait> result) {
+          SELF_FSM_HALT_ON_ERROR(result, "Wait for publish error", deal);
+          auto verified = self->verifyDealPublished(deal, result.value());
+          SELF_FSM_HALT_ON_ERROR(verified, "Cannot get publish message", deal);
+          if (!verified.value()) {
+            SELF_FSM_SEND(deal, ClientEvent::ClientEventFailed);
+            return;
+          }
+          SELF_FSM_SEND(deal, ClientEvent::ClientEventDealPublished);
+        });
   }
 
   void StorageMarketClientImpl::onClientEventDealPublished(
@@ -6,8 +6,12 @@
 #ifndef CPP_FILECOIN_CORE_MARKETS_STORAGE_CLIENT_IMPL_HPP
 #define CPP_FILECOIN_CORE_MARKETS_STORAGE_CLIENT_IMPL_HPP
 
-#include <libp2p/host/host.hpp>
+#include <future>
 #include <mutex>
+
+#include <boost/asio/thread_pool.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/protocol/common/scheduler.hpp>
 #include "api/api.hpp"
 #include "common/logger.hpp"
 #include "data_transfer/manager.hpp"
@@ -17,6 +21,7 @@
 #include "markets/pieceio/pieceio_impl.hpp"
 #include "markets/storage/client/client_events.hpp"
 #include "markets/storage/client/storage_market_client.hpp"
+#include "markets/storage/deal_index.hpp"
 #include "markets/storage/network/libp2p_storage_market_network.hpp"
 #include "storage/filestore/filestore.hpp"
 #include "storage/ipfs/datastore.hpp"
@@ -34,6 +39,7 @@ namespace fc::markets::storage::client {
   using libp2p::Host;
   using network::Libp2pStorageMarketNetwork;
   using pieceio::PieceIO;
+  using pieceio::Selector;
   using ClientTransition =
       fsm::Transition<ClientEvent, StorageDealStatus, ClientDeal>;
   using ClientFSM = fsm::FSM<ClientEvent, StorageDealStatus, ClientDeal>;
@@ -82,6 +88,16 @@ namespace fc::markets::storage::client {
         const TokenAmount &collateral,
         const RegisteredProof &registered_proof) override;
 
+    outcome::result<std::vector<outcome::result<CID>>> proposeStorageDeals(
+        const Address &client_address,
+        const std::vector<StorageProviderInfo> &providers,
+        const DataRef &data_ref,
+        const ChainEpoch &start_epoch,
+        const ChainEpoch &end_epoch,
+        const TokenAmount &price,
+        const TokenAmount &collateral,
+        const RegisteredProof &registered_proof) override;
+
     outcome::result<StorageParticipantBalance> getPaymentEscrow(
         const Address &address) const override;
 
@@ -93,9 +109,21 @@ namespace fc::markets::storage::client {
         const outcome::result<AskResponse> &response,
         const StorageProviderInfo &info) const;
 
-    outcome::result<std::pair<CID, UnpaddedPieceSize>> calculateCommP(
+    using CommP = std::pair<CID, UnpaddedPieceSize>;
+    /// Payload root, encoded selector and proof type
+    using CommPKey = std::tuple<CID, Buffer, RegisteredProof>;
+
+    /**
+     * Piece commitment of data, memoized so deals with many providers for
+     * same data compute it once, failed ones are computed again
+     */
+    outcome::result<CommP> calculateCommP(
         const RegisteredProof &registered_proof, const DataRef &data_ref) const;
 
+    /// Memoized commitment, its computation is started on commP thread
+    std::shared_future<outcome::result<CommP>> commPFuture(
+        const CommPKey &key, const Selector &selector) const;
+
     outcome::result<ClientDealProposal> signProposal(
         const Address &address, const DealProposal &proposal) const;
 
@@ -115,9 +143,19 @@ namespace fc::markets::storage::client {
     /**
      * Verifies if deal was published correctly
      * @param deal state with publish message cid set
+     * @param msg_state - receipt of publish message
      * @return true if published or false otherwise
      */
-    outcome::result<bool> verifyDealPublished(std::shared_ptr<ClientDeal> deal);
+    outcome::result<bool> verifyDealPublished(std::shared_ptr<ClientDeal> deal,
+                                              const MsgWait &msg_state);
+
+    using MsgWaitCallback = std::function<void(outcome::result<MsgWait>)>;
+
+    /**
+     * Waits for message without blocking fsm thread. Deals waiting for same
+     * message, e.g. deals published together, share one wait.
+     */
+    void waitMessage(const CID &cid, MsgWaitCallback callback);
 
     /**
      * Look up stream by proposal cid
@@ -291,8 +329,21 @@ namespace fc::markets::storage::client {
     std::mutex connections_mutex_;
     std::map<CID, std::shared_ptr<CborStream>> connections_;
 
+    /// Callbacks of deals by message they wait for
+    std::mutex message_waits_mutex_;
+    std::map<CID, std::vector<MsgWaitCallback>> message_waits_;
+
     /** State machine */
     std::shared_ptr<ClientFSM> fsm_;
+    /// Snapshots of deals updated on transitions, for queries
+    std::shared_ptr<DealIndex<ClientDeal>> deals_{
+        std::make_shared<DealIndex<ClientDeal>>()};
+
+    mutable std::mutex comm_p_mutex_;
+    mutable std::map<CommPKey, std::shared_future<outcome::result<CommP>>>
+        comm_p_;
+    /// Computes piece commitments in background
+    mutable boost::asio::thread_pool comm_p_pool_{1};
 
     common::Logger logger_ = common::createLogger("StorageMarketClient");
   };
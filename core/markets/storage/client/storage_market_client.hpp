@@ -85,6 +85,21 @@ namespace fc::markets::storage::client {
         const TokenAmount &collateral,
         const RegisteredProof &registered_proof) = 0;
 
+    /**
+     * Propose deals for same data to several providers. Piece commitment is
+     * computed once and streams to providers are opened concurrently
+     * @return proposal CID or error of each provider, in order of providers
+     */
+    virtual outcome::result<std::vector<outcome::result<CID>>>
+    proposeStorageDeals(const Address &client_address,
+                        const std::vector<StorageProviderInfo> &providers,
+                        const DataRef &data_ref,
+                        const ChainEpoch &start_epoch,
+                        const ChainEpoch &end_epoch,
+                        const TokenAmount &price,
+                        const TokenAmount &collateral,
+                        const RegisteredProof &registered_proof) = 0;
+
     virtual outcome::result<StorageParticipantBalance> getPaymentEscrow(
         const Address &address) const = 0;
 
@@ -0,0 +1,205 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_MARKETS_STORAGE_DEAL_INDEX_HPP
+#define CPP_FILECOIN_CORE_MARKETS_STORAGE_DEAL_INDEX_HPP
+
+#include <map>
+#include <set>
+#include <shared_mutex>
+
+#include "markets/storage/deal_protocol.hpp"
+
+namespace fc::markets::storage {
+
+  /**
+   * Local deals of client or provider indexed by state, client, provider
+   * and piece cid. Deals are stored as snapshots updated by state machine
+   * transitions, so queries copy only requested deals and don't lock state
+   * machine. Lists are ordered by proposal cid and paged, page continues
+   * after last proposal cid of previous page.
+   * @tparam Deal - ClientDeal or MinerDeal
+   */
+  template <typename Deal>
+  class DealIndex {
+   public:
+    using DealPtr = std::shared_ptr<Deal>;
+
+    struct Page {
+      std::vector<Deal> deals;
+      /// Proposal cid to continue after, none on last page
+      boost::optional<CID> next;
+    };
+
+    /**
+     * Inserts or replaces snapshot of deal, called on state machine begin
+     * and transitions
+     * @param entity - deal tracked by state machine
+     * @param state - state of deal, transitions without action don't
+     * update deal itself
+     */
+    void update(const DealPtr &entity, StorageDealStatus state) {
+      auto deal{*entity};
+      deal.state = state;
+      auto proposal_cid{deal.proposal_cid};
+      std::unique_lock lock{mutex_};
+      auto it{deals_.find(proposal_cid)};
+      if (it != deals_.end()) {
+        unindex(it->second.deal);
+        it->second = Entry{std::move(deal), entity};
+      } else {
+        it = deals_.emplace(proposal_cid, Entry{std::move(deal), entity})
+                 .first;
+      }
+      index(it->second.deal);
+    }
+
+    /// Snapshot of deal
+    boost::optional<Deal> get(const CID &proposal_cid) const {
+      std::shared_lock lock{mutex_};
+      auto it{deals_.find(proposal_cid)};
+      if (it == deals_.end()) {
+        return boost::none;
+      }
+      return it->second.deal;
+    }
+
+    /// Deal tracked by state machine, to send events to it
+    DealPtr entity(const CID &proposal_cid) const {
+      std::shared_lock lock{mutex_};
+      auto it{deals_.find(proposal_cid)};
+      if (it == deals_.end()) {
+        return nullptr;
+      }
+      return it->second.entity;
+    }
+
+    size_t size() const {
+      std::shared_lock lock{mutex_};
+      return deals_.size();
+    }
+
+    size_t count(StorageDealStatus state) const {
+      std::shared_lock lock{mutex_};
+      auto it{by_state_.find(state)};
+      return it == by_state_.end() ? 0 : it->second.size();
+    }
+
+    /// All deals, limit 0 means no limit
+    Page list(const boost::optional<CID> &after = boost::none,
+              size_t limit = 0) const {
+      std::shared_lock lock{mutex_};
+      Page page;
+      auto it{after ? deals_.upper_bound(*after) : deals_.begin()};
+      for (; it != deals_.end(); ++it) {
+        if (limit != 0 && page.deals.size() == limit) {
+          page.next = page.deals.back().proposal_cid;
+          break;
+        }
+        page.deals.push_back(it->second.deal);
+      }
+      return page;
+    }
+
+    Page byState(StorageDealStatus state,
+                 const boost::optional<CID> &after = boost::none,
+                 size_t limit = 0) const {
+      std::shared_lock lock{mutex_};
+      return lookup(by_state_, state, after, limit);
+    }
+
+    Page byClient(const Address &client,
+                  const boost::optional<CID> &after = boost::none,
+                  size_t limit = 0) const {
+      std::shared_lock lock{mutex_};
+      return lookup(by_client_, client, after, limit);
+    }
+
+    Page byProvider(const Address &provider,
+                    const boost::optional<CID> &after = boost::none,
+                    size_t limit = 0) const {
+      std::shared_lock lock{mutex_};
+      return lookup(by_provider_, provider, after, limit);
+    }
+
+    Page byPiece(const CID &piece_cid,
+                 const boost::optional<CID> &after = boost::none,
+                 size_t limit = 0) const {
+      std::shared_lock lock{mutex_};
+      return lookup(by_piece_, piece_cid, after, limit);
+    }
+
+   private:
+    struct Entry {
+      Deal deal;
+      DealPtr entity;
+    };
+
+    template <typename Key>
+    using Index = std::map<Key, std::set<CID>>;
+
+    static const DealProposal &proposal(const Deal &deal) {
+      return deal.client_deal_proposal.proposal;
+    }
+
+    void index(const Deal &deal) {
+      by_state_[deal.state].insert(deal.proposal_cid);
+      by_client_[proposal(deal).client].insert(deal.proposal_cid);
+      by_provider_[proposal(deal).provider].insert(deal.proposal_cid);
+      by_piece_[proposal(deal).piece_cid].insert(deal.proposal_cid);
+    }
+
+    void unindex(const Deal &deal) {
+      erase(by_state_, deal.state, deal.proposal_cid);
+      erase(by_client_, proposal(deal).client, deal.proposal_cid);
+      erase(by_provider_, proposal(deal).provider, deal.proposal_cid);
+      erase(by_piece_, proposal(deal).piece_cid, deal.proposal_cid);
+    }
+
+    template <typename Key>
+    static void erase(Index<Key> &index,
+                      const Key &key,
+                      const CID &proposal_cid) {
+      auto it{index.find(key)};
+      if (it != index.end()) {
+        it->second.erase(proposal_cid);
+        if (it->second.empty()) {
+          index.erase(it);
+        }
+      }
+    }
+
+    template <typename Key>
+    Page lookup(const Index<Key> &index,
+                const Key &key,
+                const boost::optional<CID> &after,
+                size_t limit) const {
+      Page page;
+      auto cids{index.find(key)};
+      if (cids == index.end()) {
+        return page;
+      }
+      auto it{after ? cids->second.upper_bound(*after)
+                    : cids->second.begin()};
+      for (; it != cids->second.end(); ++it) {
+        if (limit != 0 && page.deals.size() == limit) {
+          page.next = page.deals.back().proposal_cid;
+          break;
+        }
+        page.deals.push_back(deals_.at(*it).deal);
+      }
+      return page;
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::map<CID, Entry> deals_;
+    Index<StorageDealStatus> by_state_;
+    Index<Address> by_client_;
+    Index<Address> by_provider_;
+    Index<CID> by_piece_;
+  };
+}  // namespace fc::markets::storage
+
+#endif  // CPP_FILECOIN_CORE_MARKETS_STORAGE_DEAL_INDEX_HPP
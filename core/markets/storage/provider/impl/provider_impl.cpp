@@ -22,7 +22,7 @@
 
 #define CALLBACK_ACTION(_action)                                          \
   [self{shared_from_this()}](auto deal, auto event, auto from, auto to) { \
-    self->logger_->debug("Provider FSM " #_action);                       \
+    SPDLOG_LOGGER_DEBUG(self->logger_, "Provider FSM " #_action);         \
     self->_action(deal, event, from, to);                                 \
     deal->state = to;                                                     \
   }
@@ -81,6 +81,8 @@ namespace fc::markets::storage::provider {
         piece_io_{std::move(piece_io)},
         piece_storage_{std::make_shared<PieceStorageImpl>(datastore)},
         filestore_{filestore} {
+    journal_ = std::make_shared<fsm::StateJournal>(
+        context_, datastore, Buffer{}.put(kDealJournalPrefix));
     auto scheduler = std::make_shared<libp2p::protocol::AsioScheduler>(
         *context_, libp2p::protocol::SchedulerConfig{});
     auto graphsync =
@@ -96,8 +98,27 @@ namespace fc::markets::storage::provider {
         std::make_shared<HostContextImpl>(context_);
     fsm_ = std::make_shared<ProviderFSM>(makeFSMTransitions(), fsm_context);
 
+    // restore deals journaled before restart
+    OUTCOME_TRY(journal_->load(
+        [this](auto &, auto &value) -> outcome::result<void> {
+          OUTCOME_TRY(deal, codec::cbor::decode<MinerDeal>(value));
+          auto state = deal.state;
+          auto entity = std::make_shared<MinerDeal>(std::move(deal));
+          OUTCOME_TRY(fsm_->begin(entity, state));
+          deals_->update(entity, state);
+          return outcome::success();
+        }));
+    fsm_->setAnyChangeAction(
+        [self{weak_from_this()}, deals{deals_}](
+            auto deal, auto, auto, auto to) {
+          deals->update(deal, to);
+          if (auto provider = self.lock()) {
+            provider->journalDeal(*deal, to);
+          }
+        });
+
     // register request validator
-    auto state_store = std::make_shared<ProviderFsmStateStore>(fsm_);
+    auto state_store = std::make_shared<ProviderDealStateStore>(deals_);
     auto validator =
         std::make_shared<ProviderDataTransferRequestValidator>(state_store);
     OUTCOME_TRY(datatransfer_->init(StorageDataTransferVoucherType, validator));
@@ -109,9 +130,10 @@ namespace fc::markets::storage::provider {
     OUTCOME_TRY(network_->setDelegate(shared_from_this()));
 
     context_->post([self{shared_from_this()}] {
-      self->logger_->debug(
+      SPDLOG_LOGGER_DEBUG(
+          self->logger_,
           "Server started\nListening on: "
-          + peerInfoToPrettyString(self->host_->getPeerInfo()));
+              + peerInfoToPrettyString(self->host_->getPeerInfo()));
     });
 
     return outcome::success();
@@ -132,10 +154,8 @@ namespace fc::markets::storage::provider {
 
   outcome::result<MinerDeal> StorageProviderImpl::getDeal(
       const CID &proposal_cid) const {
-    for (const auto &it : fsm_->list()) {
-      if (it.first->proposal_cid == proposal_cid) {
-        return *it.first;
-      }
+    if (auto deal{deals_->get(proposal_cid)}) {
+      return std::move(*deal);
     }
     return StorageMarketProviderError::LOCAL_DEAL_NOT_FOUND;
   }
@@ -153,18 +173,10 @@ namespace fc::markets::storage::provider {
 
   outcome::result<void> StorageProviderImpl::importDataForDeal(
       const CID &proposal_cid, const Buffer &data) {
-    auto fsm_state_table = fsm_->list();
-    auto found_fsm_entity =
-        std::find_if(fsm_state_table.begin(),
-                     fsm_state_table.end(),
-                     [proposal_cid](const auto &it) -> bool {
-                       if (it.first->proposal_cid == proposal_cid) return true;
-                       return false;
-                     });
-    if (found_fsm_entity == fsm_state_table.end()) {
+    auto deal = deals_->entity(proposal_cid);
+    if (!deal) {
       return StorageMarketProviderError::LOCAL_DEAL_NOT_FOUND;
     }
-    auto deal = found_fsm_entity->first;
 
     OUTCOME_TRY(piece_commitment,
                 piece_io_->generatePieceCommitment(registered_proof_, data));
@@ -186,26 +198,24 @@ namespace fc::markets::storage::provider {
 
   void StorageProviderImpl::handleAskStream(
       const std::shared_ptr<CborStream> &stream) {
-    logger_->debug("New ask stream");
-    stream->read<AskRequest>([self{shared_from_this()},
-                              stream](outcome::result<AskRequest> request_res) {
-      if (!self->hasValue(request_res, "Ask request error ", stream)) return;
-      auto maybe_ask = self->stored_ask_->getAsk(request_res.value().miner);
-      if (!self->hasValue(maybe_ask, "Get stored ask error ", stream)) return;
-      AskResponse response{.ask = maybe_ask.value()};
-      stream->write(
-          response, [self, stream](outcome::result<size_t> maybe_res) {
-            if (!self->hasValue(maybe_res, "Write ask response error ", stream))
-              return;
-            self->network_->closeStreamGracefully(stream);
-            self->logger_->debug("Ask response written, connection closed");
-          });
-    });
+    SPDLOG_LOGGER_DEBUG(logger_, "New ask stream");
+    stream->respond<AskRequest, AskResponse>(
+        [self{shared_from_this()}](
+            auto &request) -> outcome::result<AskResponse> {
+          OUTCOME_TRY(ask, self->stored_ask_->getAsk(request.miner));
+          return AskResponse{.ask = std::move(ask)};
+        },
+        [self{shared_from_this()}, stream](auto written) {
+          if (!self->hasValue(written, "Ask stream error ", stream)) return;
+          self->network_->closeStreamGracefully(stream);
+          SPDLOG_LOGGER_DEBUG(self->logger_,
+                              "Ask response written, connection closed");
+        });
   }
 
   void StorageProviderImpl::handleDealStream(
       const std::shared_ptr<CborStream> &stream) {
-    logger_->debug("New deal stream");
+    SPDLOG_LOGGER_DEBUG(logger_, "New deal stream");
 
     stream->read<Proposal>(
         [self{shared_from_this()}, stream](outcome::result<Proposal> proposal) {
@@ -238,6 +248,7 @@ namespace fc::markets::storage::provider {
           self->connections_.emplace(proposal_cid, stream);
           OUTCOME_EXCEPT(
               self->fsm_->begin(deal, StorageDealStatus::STORAGE_DEAL_UNKNOWN));
+          self->deals_->update(deal, StorageDealStatus::STORAGE_DEAL_UNKNOWN);
           SELF_FSM_SEND(deal, ProviderEvent::ProviderEventOpen);
         });
   }
@@ -335,14 +346,33 @@ namespace fc::markets::storage::provider {
     return std::move(maybe_cid);
   }
 
-  outcome::result<CID> StorageProviderImpl::publishDeal(
-      std::shared_ptr<MinerDeal> deal) {
+  void StorageProviderImpl::journalDeal(MinerDeal deal,
+                                        StorageDealStatus state) {
+    // transitions without action do not update deal state
+    deal.state = state;
+    auto key = deal.proposal_cid.toBytes();
+    auto value = codec::cbor::encode(deal);
+    if (key.has_error() || value.has_error()) {
+      logger_->error("Cannot encode deal state for journal");
+      return;
+    }
+    journal_->write(Buffer{key.value()}, std::move(value.value()));
+  }
+
+  outcome::result<CID> StorageProviderImpl::publishDeals(
+      const std::vector<std::shared_ptr<MinerDeal>> &deals) {
     OUTCOME_TRY(chain_head, api_->ChainHead());
     OUTCOME_TRY(tipset_key, chain_head.makeKey());
+    // all deals are made with this provider
     OUTCOME_TRY(worker_info,
                 api_->StateMinerInfo(
-                    deal->client_deal_proposal.proposal.provider, tipset_key));
-    std::vector<ClientDealProposal> params{deal->client_deal_proposal};
+                    deals.front()->client_deal_proposal.proposal.provider,
+                    tipset_key));
+    std::vector<ClientDealProposal> params;
+    params.reserve(deals.size());
+    for (auto &deal : deals) {
+      params.push_back(deal->client_deal_proposal);
+    }
     OUTCOME_TRY(encoded_params, codec::cbor::encode(params));
     UnsignedMessage unsigned_message(kMessageVersion,
                                      vm::actor::kStorageMarketAddress,
@@ -356,10 +386,63 @@ namespace fc::markets::storage::provider {
     OUTCOME_TRY(signed_message, api_->MpoolPushMessage(unsigned_message));
     CID cid = signed_message.getCid();
     OUTCOME_TRY(str_cid, cid.toString());
-    logger_->debug("Deal published with CID = " + str_cid);
+    SPDLOG_LOGGER_DEBUG(logger_,
+                        "{} deals published with CID = {}",
+                        deals.size(),
+                        str_cid);
     return std::move(cid);
   }
 
+  void StorageProviderImpl::schedulePublish(std::shared_ptr<MinerDeal> deal) {
+    std::unique_lock lock{publish_mutex_};
+    publish_queue_.push_back(std::move(deal));
+    if (publish_queue_.size() >= kMaxDealsPerPublishMsg) {
+      lock.unlock();
+      flushPublish();
+      return;
+    }
+    if (publish_queue_.size() == 1) {
+      // first deal of batch waits for others at most publish period
+      publish_timer_.emplace(*context_, kPublishMsgPeriod);
+      publish_timer_->async_wait(
+          [weak{weak_from_this()}](const boost::system::error_code &ec) {
+            if (auto self = weak.lock(); self && !ec) {
+              self->flushPublish();
+            }
+          });
+    }
+  }
+
+  void StorageProviderImpl::flushPublish() {
+    std::vector<std::shared_ptr<MinerDeal>> deals;
+    {
+      std::lock_guard lock{publish_mutex_};
+      deals.swap(publish_queue_);
+      if (publish_timer_) {
+        publish_timer_->cancel();
+      }
+    }
+    if (deals.empty()) {
+      return;
+    }
+    auto maybe_cid = publishDeals(deals);
+    for (size_t i = 0; i < deals.size(); ++i) {
+      auto &deal = deals[i];
+      if (maybe_cid.has_error()) {
+        deal->message =
+            "Publish deal error. " + maybe_cid.error().message();
+        FSM_SEND(deal, ProviderEvent::ProviderEventFailed);
+        continue;
+      }
+      deal->publish_cid = maybe_cid.value();
+      {
+        std::lock_guard lock{publish_mutex_};
+        publish_index_[deal->proposal_cid] = i;
+      }
+      FSM_SEND(deal, ProviderEvent::ProviderEventDealPublishInitiated);
+    }
+  }
+
   outcome::result<void> StorageProviderImpl::sendSignedResponse(
       std::shared_ptr<MinerDeal> deal) {
     OUTCOME_TRY(chain_head, api_->ChainHead());
@@ -559,7 +642,7 @@ namespace fc::markets::storage::provider {
       ProviderEvent event,
       StorageDealStatus from,
       StorageDealStatus to) {
-    logger_->debug("Waiting for importDataForDeal() call");
+    SPDLOG_LOGGER_DEBUG(logger_, "Waiting for importDataForDeal() call");
   }
 
   void StorageProviderImpl::onProviderEventFundingInitiated(
@@ -588,10 +671,7 @@ namespace fc::markets::storage::provider {
       ProviderEvent event,
       StorageDealStatus from,
       StorageDealStatus to) {
-    auto maybe_cid = publishDeal(deal);
-    FSM_HALT_ON_ERROR(maybe_cid, "Publish deal error", deal);
-    deal->publish_cid = maybe_cid.value();
-    FSM_SEND(deal, ProviderEvent::ProviderEventDealPublishInitiated);
+    schedulePublish(std::move(deal));
   }
 
   void StorageProviderImpl::onProviderEventDataTransferInitiated(
@@ -656,12 +736,21 @@ namespace fc::markets::storage::provider {
           result.value().receipt.return_value);
       SELF_FSM_HALT_ON_ERROR(
           maybe_res, "Publish storage deal decode result error", deal);
-      if (maybe_res.value().deals.size() != 1) {
+      size_t index{};
+      {
+        std::lock_guard lock{self->publish_mutex_};
+        auto it{self->publish_index_.find(deal->proposal_cid)};
+        if (it != self->publish_index_.end()) {
+          index = it->second;
+          self->publish_index_.erase(it);
+        }
+      }
+      if (index >= maybe_res.value().deals.size()) {
         deal->message = "Publish storage deal result size error";
         SELF_FSM_SEND(deal, ProviderEvent::ProviderEventFailed);
         return;
       }
-      deal->deal_id = maybe_res.value().deals.front();
+      deal->deal_id = maybe_res.value().deals[index];
       deal->state = to;
       SELF_FSM_HALT_ON_ERROR(
           self->sendSignedResponse(deal), "Error when sending response", deal);
@@ -706,7 +795,7 @@ namespace fc::markets::storage::provider {
       ProviderEvent event,
       StorageDealStatus from,
       StorageDealStatus to) {
-    logger_->debug("Deal completed");
+    SPDLOG_LOGGER_DEBUG(logger_, "Deal completed");
     auto res = finalizeDeal(deal);
     if (res.has_error()) {
       logger_->error("Deal finalization error. " + res.error().message());
@@ -6,13 +6,16 @@
 #ifndef CPP_FILECOIN_MARKETS_STORAGE_PROVIDER_PROVIDER_HPP
 #define CPP_FILECOIN_MARKETS_STORAGE_PROVIDER_PROVIDER_HPP
 
+#include <boost/asio/steady_timer.hpp>
 #include <libp2p/host/host.hpp>
 #include <mutex>
 #include "api/miner_api.hpp"
 #include "common/logger.hpp"
 #include "data_transfer/manager.hpp"
 #include "fsm/fsm.hpp"
+#include "fsm/state_journal.hpp"
 #include "markets/pieceio/pieceio.hpp"
+#include "markets/storage/deal_index.hpp"
 #include "markets/storage/network/libp2p_storage_market_network.hpp"
 #include "markets/storage/provider/provider.hpp"
 #include "markets/storage/provider/provider_events.hpp"
@@ -47,8 +50,16 @@ namespace fc::markets::storage::provider {
   const GasAmount kGasLimit{1000000};
   const EpochDuration kDefaultDealAcceptanceBuffer{100};
 
+  /// Funded deals published with one PublishStorageDeals message at most
+  constexpr size_t kMaxDealsPerPublishMsg{8};
+  /// Time funded deal waits for other deals to be published with it
+  constexpr std::chrono::milliseconds kPublishMsgPeriod{1000};
+
   const Path kFilestoreTempDir = "/tmp/fuhon/storage-market/";
 
+  /// Prefix of deal states journaled in datastore
+  const std::string kDealJournalPrefix = "/storage-market/provider/deals/";
+
   class StorageProviderImpl
       : public StorageProvider,
         public StorageReceiver,
@@ -111,11 +122,29 @@ namespace fc::markets::storage::provider {
         std::shared_ptr<MinerDeal> deal);
 
     /**
-     * Publish storage deal
-     * @param deal to publish
+     * Writes deal state to journal
+     * @param deal - deal after transition
+     * @param state - destination state of transition
+     */
+    void journalDeal(MinerDeal deal, StorageDealStatus state);
+
+    /**
+     * Publish storage deals with one message
+     * @param deals to publish, deal ids are returned in the same order
      * @return CID of message sent
      */
-    outcome::result<CID> publishDeal(std::shared_ptr<MinerDeal> deal);
+    outcome::result<CID> publishDeals(
+        const std::vector<std::shared_ptr<MinerDeal>> &deals);
+
+    /**
+     * Queues funded deal for publishing, queue is published when it is full
+     * or publish period expires
+     * @param deal to publish
+     */
+    void schedulePublish(std::shared_ptr<MinerDeal> deal);
+
+    /// Publishes queued deals
+    void flushPublish();
 
     /**
      * Send signed response to storage deal proposal and close connection
@@ -357,6 +386,18 @@ namespace fc::markets::storage::provider {
 
     /** State machine */
     std::shared_ptr<ProviderFSM> fsm_;
+    /// Snapshots of deals updated on transitions, for queries
+    std::shared_ptr<DealIndex<MinerDeal>> deals_{
+        std::make_shared<DealIndex<MinerDeal>>()};
+    /// Persists deal states on transitions, restored on init
+    std::shared_ptr<fsm::StateJournal> journal_;
+
+    // deals waiting for publish message
+    std::mutex publish_mutex_;
+    std::vector<std::shared_ptr<MinerDeal>> publish_queue_;
+    boost::optional<boost::asio::steady_timer> publish_timer_;
+    /// Index of deal in publish message, by proposal cid
+    std::map<CID, size_t> publish_index_;
 
     /**
      * Closes stream and handles close result
@@ -6,15 +6,14 @@
 #include "markets/storage/provider/impl/provider_state_store.hpp"
 
 namespace fc::markets::storage::provider {
-  ProviderFsmStateStore::ProviderFsmStateStore(std::shared_ptr<ProviderFSM> fsm)
-      : fsm_{std::move(fsm)} {}
+  ProviderDealStateStore::ProviderDealStateStore(
+      std::shared_ptr<const ProviderDealIndex> deals)
+      : deals_{std::move(deals)} {}
 
-  outcome::result<MinerDeal> ProviderFsmStateStore::get(
+  outcome::result<MinerDeal> ProviderDealStateStore::get(
       const CID &proposal_cid) const {
-    for (const auto &it : fsm_->list()) {
-      if (it.first->proposal_cid == proposal_cid) {
-        return *it.first;
-      }
+    if (auto deal{deals_->get(proposal_cid)}) {
+      return std::move(*deal);
     }
     return ProviderStateStoreError::STATE_NOT_FOUND;
   }
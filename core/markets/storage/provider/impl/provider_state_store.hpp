@@ -8,24 +8,26 @@
 
 #include "fsm/fsm.hpp"
 #include "fsm/state_store.hpp"
-#include "markets/storage/deal_protocol.hpp"
+#include "markets/storage/deal_index.hpp"
 #include "markets/storage/provider/provider_events.hpp"
 
 namespace fc::markets::storage::provider {
   using ProviderFSM = fsm::FSM<ProviderEvent, StorageDealStatus, MinerDeal>;
   using ProviderStateStore = fsm::StateStore<CID, MinerDeal>;
+  using ProviderDealIndex = DealIndex<MinerDeal>;
 
   /**
-   * Provider state store implemented over provider FSM
+   * Provider state store implemented over index of provider deals
    */
-  class ProviderFsmStateStore : public ProviderStateStore {
+  class ProviderDealStateStore : public ProviderStateStore {
    public:
-    explicit ProviderFsmStateStore(std::shared_ptr<ProviderFSM> fsm);
+    explicit ProviderDealStateStore(
+        std::shared_ptr<const ProviderDealIndex> deals);
 
     outcome::result<MinerDeal> get(const CID &proposal_cid) const override;
 
    private:
-    std::shared_ptr<ProviderFSM> fsm_;
+    std::shared_ptr<const ProviderDealIndex> deals_;
   };
 
   enum class ProviderStateStoreError { STATE_NOT_FOUND };
@@ -63,6 +63,18 @@ fc::outcome::result<Power> PowerTableHamt::getMaxPower() const {
   return max;
 }
 
+fc::outcome::result<Power> PowerTableHamt::getTotalPower() const {
+  Power total = 0;
+  Hamt::Visitor total_visitor{
+      [&total](auto k, auto v) -> fc::outcome::result<void> {
+        OUTCOME_TRY(power, codec::cbor::decode<Power>(v));
+        total += power;
+        return fc::outcome::success();
+      }};
+  OUTCOME_TRY(power_table_.visit(total_visitor));
+  return total;
+}
+
 fc::outcome::result<std::vector<Address>> PowerTableHamt::getMiners() const {
   std::vector<Address> miners;
   Hamt::Visitor max_visitor{
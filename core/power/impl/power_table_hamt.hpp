@@ -41,6 +41,9 @@ namespace fc::power {
     /** @copydoc PowerTable::getMaxPower() */
     fc::outcome::result<Power> getMaxPower() const override;
 
+    /** @copydoc PowerTable::getTotalPower() */
+    fc::outcome::result<Power> getTotalPower() const override;
+
     /** @copydoc PowerTable::getMiners() */
     outcome::result<std::vector<Address>> getMiners() const override;
 
@@ -6,14 +6,12 @@
 #include "power/impl/power_table_impl.hpp"
 
 #include "power/power_table_error.hpp"
-#include "primitives/address/address_codec.hpp"
 
 namespace fc::power {
 
   outcome::result<Power> PowerTableImpl::getMinerPower(
       const primitives::address::Address &address) const {
-    auto result =
-        power_table_.find(primitives::address::encodeToString(address));
+    auto result = power_table_.find(address);
     if (result == power_table_.end()) {
       return outcome::failure(PowerTableError::NO_SUCH_MINER);
     }
@@ -24,15 +22,27 @@ namespace fc::power {
   outcome::result<void> PowerTableImpl::setMinerPower(
       const primitives::address::Address &address, Power power_amount) {
     if (power_amount < 0) return PowerTableError::NEGATIVE_POWER;
-    power_table_[primitives::address::encodeToString(address)] = power_amount;
+    auto it = power_table_.find(address);
+    if (it == power_table_.end()) {
+      it = power_table_.emplace(address, 0).first;
+    } else {
+      by_power_.erase({it->second, address});
+      total_power_ -= it->second;
+    }
+    it->second = power_amount;
+    by_power_.emplace(power_amount, address);
+    total_power_ += power_amount;
     return outcome::success();
   }
 
   outcome::result<void> PowerTableImpl::removeMiner(
       const primitives::address::Address &address) {
-    if (power_table_.erase(primitives::address::encodeToString(address)) == 0)
-      return PowerTableError::NO_SUCH_MINER;
+    auto it = power_table_.find(address);
+    if (it == power_table_.end()) return PowerTableError::NO_SUCH_MINER;
 
+    by_power_.erase({it->second, address});
+    total_power_ -= it->second;
+    power_table_.erase(it);
     return outcome::success();
   }
 
@@ -41,15 +51,13 @@ namespace fc::power {
   }
 
   fc::outcome::result<Power> PowerTableImpl::getMaxPower() const {
-    if (power_table_.empty()) return 0;
+    if (by_power_.empty()) return 0;
 
-    auto res = std::max(power_table_.cbegin(),
-                        power_table_.cend(),
-                        [&](const auto &rhs, const auto &lhs) {
-                          return rhs->second < lhs->second;
-                        });
+    return by_power_.rbegin()->first;
+  }
 
-    return res->second;
+  fc::outcome::result<Power> PowerTableImpl::getTotalPower() const {
+    return total_power_;
   }
 
   outcome::result<std::vector<primitives::address::Address>>
@@ -57,10 +65,20 @@ namespace fc::power {
     std::vector<primitives::address::Address> result;
     result.reserve(power_table_.size());
     for (const auto &elem : power_table_) {
-      OUTCOME_TRY(miner_addr,
-                  primitives::address::decodeFromString(elem.first));
-      result.push_back(miner_addr);
+      result.push_back(elem.first);
     }
     return result;
   }
+
+  outcome::result<void> PowerTableImpl::updateClaims(const Claims &before,
+                                                     Claims &after) {
+    return after.diff(
+        before,
+        [&](auto &address, auto, auto claim) -> outcome::result<void> {
+          if (!claim) {
+            return removeMiner(address);
+          }
+          return setMinerPower(address, claim->qa_power);
+        });
+  }
 }  // namespace fc::power
@@ -6,13 +6,23 @@
 #ifndef FILECOIN_CORE_STORAGE_POWER_TABLE_IMPL_HPP
 #define FILECOIN_CORE_STORAGE_POWER_TABLE_IMPL_HPP
 
-#include <unordered_map>
+#include <map>
+#include <set>
+
 #include "power/power_table.hpp"
+#include "vm/actor/builtin/storage_power/storage_power_actor_state.hpp"
 
 namespace fc::power {
+  using vm::actor::builtin::storage_power::Claim;
 
+  /**
+   * In-memory power table, keeps miners ordered by power and total power,
+   * so max and total power are read without scan
+   */
   class PowerTableImpl : public PowerTable {
    public:
+    using Claims = adt::Map<Claim, adt::AddressKeyer>;
+
     outcome::result<Power> getMinerPower(
         const primitives::address::Address &address) const override;
 
@@ -27,11 +37,23 @@ namespace fc::power {
 
     fc::outcome::result<Power> getMaxPower() const override;
 
+    fc::outcome::result<Power> getTotalPower() const override;
+
     outcome::result<std::vector<primitives::address::Address>> getMiners()
         const override;
 
+    /**
+     * @brief Update quality adjusted power of miners with claims changed
+     * between power actor states
+     * @param before - claims this table was built from
+     * @param after - new claims
+     */
+    outcome::result<void> updateClaims(const Claims &before, Claims &after);
+
    private:
-    std::unordered_map<std::string, Power> power_table_;
+    std::map<primitives::address::Address, Power> power_table_;
+    std::set<std::pair<Power, primitives::address::Address>> by_power_;
+    Power total_power_{0};
   };
 
 }  // namespace fc::power
@@ -58,6 +58,12 @@ namespace fc::power {
      */
     virtual fc::outcome::result<Power> getMaxPower() const = 0;
 
+    /**
+     * @brief Get total power of table
+     * @return sum of power of all miners
+     */
+    virtual fc::outcome::result<Power> getTotalPower() const = 0;
+
     /**
      * @brief Get list of all miners from table
      * @return list of miners
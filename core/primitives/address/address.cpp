@@ -5,6 +5,10 @@
 
 #include "primitives/address/address.hpp"
 
+#include <cstring>
+
+#include <boost/container_hash/hash.hpp>
+
 #include "common/visitor.hpp"
 #include "crypto/blake2/blake2b160.hpp"
 
@@ -114,3 +118,19 @@ namespace fc::primitives::address {
   }
 
 };  // namespace fc::primitives::address
+
+size_t std::hash<fc::primitives::address::Address>::operator()(
+    const fc::primitives::address::Address &address) const {
+  size_t seed{address.data.which()};
+  boost::hash_combine(seed, address.network);
+  fc::visit_in_place(
+      address.data,
+      [&](uint64_t id) { boost::hash_combine(seed, id); },
+      [&](const auto &hash) {
+        // payload is hash or public key, its prefix is uniform enough
+        size_t prefix;
+        memcpy(&prefix, hash.data(), sizeof(prefix));
+        boost::hash_combine(seed, prefix);
+      });
+  return seed;
+}
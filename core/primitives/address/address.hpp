@@ -124,6 +124,14 @@ struct fmt::formatter<fc::primitives::address::Address>
   }
 };
 
+namespace std {
+  /// Hash of id or payload bytes, does not encode address
+  template <>
+  struct hash<fc::primitives::address::Address> {
+    size_t operator()(const fc::primitives::address::Address &address) const;
+  };
+}  // namespace std
+
 /**
  * @brief Outcome errors declaration
  */
@@ -16,24 +16,34 @@
 
 namespace fc::primitives::address {
 
-  static const size_t kBlsPublicKeySize{
-      std::tuple_size<fc::crypto::bls::PublicKey>::value};
-
   using common::Blob;
   using base32 = cppcodec::base32_rfc4648;
   using libp2p::multi::UVarint;
 
-  std::vector<uint8_t> encode(const Address &address) noexcept {
-    std::vector<uint8_t> res{};
-    res.push_back(address.getProtocol());
-    std::vector<uint8_t> payload = visit_in_place(
+  AddressBytes::AddressBytes(const Address &address) noexcept {
+    bytes[size++] = address.getProtocol();
+    visit_in_place(
         address.data,
-        [](uint64_t v) { return UVarint{v}.toVector(); },
-        [](const auto &v) { return std::vector<uint8_t>(v.begin(), v.end()); });
-    res.insert(res.end(),
-               std::make_move_iterator(payload.begin()),
-               std::make_move_iterator(payload.end()));
-    return res;
+        [&](uint64_t v) {
+          while (v >= 0x80) {
+            bytes[size++] = static_cast<uint8_t>(v | 0x80);
+            v >>= 7;
+          }
+          bytes[size++] = static_cast<uint8_t>(v);
+        },
+        [&](const auto &v) {
+          std::copy(v.begin(), v.end(), bytes.begin() + size);
+          size += v.size();
+        });
+  }
+
+  gsl::span<const uint8_t> AddressBytes::view() const {
+    return gsl::make_span(bytes.data(), size);
+  }
+
+  std::vector<uint8_t> encode(const Address &address) noexcept {
+    auto bytes{AddressBytes{address}.view()};
+    return {bytes.begin(), bytes.end()};
   }
 
   outcome::result<Address> decode(gsl::span<const uint8_t> v) {
@@ -43,7 +53,14 @@ namespace fc::primitives::address {
     Network net{Network::TESTNET};
 
     auto p = static_cast<Protocol>(v[0]);
-    std::vector<uint8_t> payload(std::next(v.begin()), v.end());
+    auto payload = v.subspan(1);
+    auto fromPayload{[&](auto hash) -> outcome::result<Address> {
+      if (payload.size() != static_cast<ptrdiff_t>(hash.size())) {
+        return outcome::failure(AddressError::INVALID_PAYLOAD);
+      }
+      std::copy(payload.begin(), payload.end(), hash.begin());
+      return Address{net, hash};
+    }};
     switch (p) {
       case Protocol::ID: {
         boost::optional<UVarint> value = UVarint::create(payload);
@@ -52,36 +69,12 @@ namespace fc::primitives::address {
         }
         return outcome::failure(AddressError::INVALID_PAYLOAD);
       }
-      case Protocol::SECP256K1: {
-        if (payload.size() != fc::crypto::blake2b::BLAKE2B160_HASH_LENGTH) {
-          return outcome::failure(AddressError::INVALID_PAYLOAD);
-        }
-        Secp256k1PublicKeyHash hash{};
-        std::copy_n(std::make_move_iterator(payload.begin()),
-                    fc::crypto::blake2b::BLAKE2B160_HASH_LENGTH,
-                    hash.begin());
-        return Address{net, hash};
-      }
-      case Protocol::ACTOR: {
-        if (payload.size() != fc::crypto::blake2b::BLAKE2B160_HASH_LENGTH) {
-          return outcome::failure(AddressError::INVALID_PAYLOAD);
-        }
-        ActorExecHash hash{};
-        std::copy_n(std::make_move_iterator(payload.begin()),
-                    fc::crypto::blake2b::BLAKE2B160_HASH_LENGTH,
-                    hash.begin());
-        return Address{net, hash};
-      }
-      case Protocol::BLS: {
-        if (payload.size() != kBlsPublicKeySize) {
-          return outcome::failure(AddressError::INVALID_PAYLOAD);
-        }
-        BLSPublicKeyHash hash{};
-        std::copy_n(std::make_move_iterator(payload.begin()),
-                    kBlsPublicKeySize,
-                    hash.begin());
-        return Address{net, hash};
-      }
+      case Protocol::SECP256K1:
+        return fromPayload(Secp256k1PublicKeyHash{});
+      case Protocol::ACTOR:
+        return fromPayload(ActorExecHash{});
+      case Protocol::BLS:
+        return fromPayload(BLSPublicKeyHash{});
       default:
         return outcome::failure(AddressError::UNKNOWN_PROTOCOL);
     }
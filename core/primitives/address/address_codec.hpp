@@ -6,6 +6,7 @@
 #ifndef CPP_FILECOIN_CORE_PRIMITIVES_ADDRESS_CODEC_HPP
 #define CPP_FILECOIN_CORE_PRIMITIVES_ADDRESS_CODEC_HPP
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,22 @@
 
 namespace fc::primitives::address {
 
+  /// Max size of address bytes, protocol and BLS public key
+  constexpr size_t kMaxAddressBytes = 1 + BLSPublicKeyHash::size();
+
+  /**
+   * @brief Address bytes kept in fixed buffer, so encoding address for keys
+   * and cbor allocates nothing
+   */
+  struct AddressBytes {
+    explicit AddressBytes(const Address &address) noexcept;
+
+    gsl::span<const uint8_t> view() const;
+
+    std::array<uint8_t, kMaxAddressBytes> bytes;
+    size_t size{};
+  };
+
   /**
    * @brief Encodes an Address to an array of bytes
    */
@@ -37,13 +54,11 @@ namespace fc::primitives::address {
   outcome::result<Address> decodeFromString(const std::string &s);
 
   CBOR_ENCODE(Address, address) {
-    return s << encode(address);
+    return s << AddressBytes{address}.view();
   }
 
   CBOR_DECODE(Address, address) {
-    std::vector<uint8_t> data{};
-    s >> data;
-    OUTCOME_EXCEPT(decoded, decode(data));
+    OUTCOME_EXCEPT(decoded, decode(s.bytesView()));
     address = std::move(decoded);
     return s;
   }
@@ -6,27 +6,44 @@
 #ifndef CPP_FILECOIN_CORE_PRIMITIVES_BIG_INT_HPP
 #define CPP_FILECOIN_CORE_PRIMITIVES_BIG_INT_HPP
 
+#include <boost/container/small_vector.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
+#include <gsl/span>
 
 #include "codec/cbor/streams_annotation.hpp"
 
 namespace fc::primitives {
-  using BigInt = boost::multiprecision::cpp_int;
+  /// Bits of BigInt stored inline, larger values are allocated
+  constexpr unsigned kBigIntInlineBits = 256;
+
+  /**
+   * Arbitrary precision integer. Token amounts, gas costs and powers almost
+   * always fit in inline storage, so arithmetic on them does not allocate.
+   */
+  using BigInt = boost::multiprecision::number<
+      boost::multiprecision::cpp_int_backend<
+          kBigIntInlineBits,
+          0,
+          boost::multiprecision::signed_magnitude,
+          boost::multiprecision::unchecked,
+          std::allocator<boost::multiprecision::limb_type>>>;
 }  // namespace fc::primitives
 
 namespace boost::multiprecision {
-  CBOR_ENCODE(cpp_int, big_int) {
-    std::vector<uint8_t> bytes;
+  CBOR_ENCODE(fc::primitives::BigInt, big_int) {
+    // sign byte and magnitude of inline value fit on stack
+    boost::container::small_vector<uint8_t,
+                                   1 + fc::primitives::kBigIntInlineBits / 8>
+        bytes;
     if (big_int != 0) {
       bytes.push_back(big_int < 0 ? 1 : 0);
       export_bits(big_int, std::back_inserter(bytes), 8);
     }
-    return s << bytes;
+    return s << gsl::span<const uint8_t>(bytes.data(), bytes.size());
   }
 
-  CBOR_DECODE(cpp_int, big_int) {
-    std::vector<uint8_t> bytes;
-    s >> bytes;
+  CBOR_DECODE(fc::primitives::BigInt, big_int) {
+    auto bytes = s.bytesView();
     if (bytes.empty()) {
       big_int = 0;
     } else {
@@ -0,0 +1,75 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/cid/cb_cid.hpp"
+
+#include <algorithm>
+
+namespace fc {
+  using libp2p::multi::HashType;
+  using libp2p::multi::Multihash;
+
+  boost::optional<CbCid> CbCid::make(const CID &cid) {
+    if (cid.version != CID::Version::V1
+        || cid.content_type != CID::Multicodec::DAG_CBOR
+        || cid.content_address.getType() != HashType::blake2b_256) {
+      return boost::none;
+    }
+    auto digest{cid.content_address.getHash()};
+    if (digest.size() != static_cast<ptrdiff_t>(size())) {
+      return boost::none;
+    }
+    CbCid result;
+    std::copy(digest.begin(), digest.end(), result.begin());
+    return result;
+  }
+
+  boost::optional<CbCid> CbCid::fromBytes(gsl::span<const uint8_t> bytes) {
+    if (bytes.size() != static_cast<ptrdiff_t>(kBytes)
+        || !std::equal(
+            kCbCidPrefix.begin(), kCbCidPrefix.end(), bytes.begin())) {
+      return boost::none;
+    }
+    CbCid result;
+    std::copy(bytes.begin() + kCbCidPrefix.size(), bytes.end(), result.begin());
+    return result;
+  }
+
+  CID CbCid::toCid() const {
+    return CID{CID::Version::V1,
+               CID::Multicodec::DAG_CBOR,
+               Multihash::create(HashType::blake2b_256, *this).value()};
+  }
+
+  std::array<uint8_t, CbCid::kBytes> CbCid::toBytes() const {
+    std::array<uint8_t, kBytes> bytes;
+    auto it{std::copy(kCbCidPrefix.begin(), kCbCidPrefix.end(), bytes.begin())};
+    std::copy(begin(), end(), it);
+    return bytes;
+  }
+
+  bool CidSet::insert(const CID &cid) {
+    if (auto compact{CbCid::make(cid)}) {
+      return compact_.insert(*compact).second;
+    }
+    return other_.insert(cid).second;
+  }
+
+  size_t CidSet::count(const CID &cid) const {
+    if (auto compact{CbCid::make(cid)}) {
+      return compact_.count(*compact);
+    }
+    return other_.count(cid);
+  }
+
+  size_t CidSet::size() const {
+    return compact_.size() + other_.size();
+  }
+
+  void CidSet::clear() {
+    compact_.clear();
+    other_.clear();
+  }
+}  // namespace fc
@@ -0,0 +1,79 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PRIMITIVES_CID_CB_CID_HPP
+#define CPP_FILECOIN_CORE_PRIMITIVES_CID_CB_CID_HPP
+
+#include <cstring>
+#include <unordered_set>
+
+#include <boost/optional.hpp>
+
+#include "common/blob.hpp"
+#include "primitives/cid/cid.hpp"
+
+namespace fc {
+  /// Binary prefix of CIDv1 dag-cbor blake2b-256: version, codec, multihash
+  /// type and size
+  constexpr std::array<uint8_t, 6> kCbCidPrefix{
+      0x01, 0x71, 0xA0, 0xE4, 0x02, 0x20};
+
+  /**
+   * Compact CID of most blocks (CIDv1, dag-cbor, blake2b-256), it keeps only
+   * digest inline. Binary encoding is fixed prefix and digest, so it needs
+   * no allocation, hash is taken from digest bytes.
+   */
+  struct CbCid : common::Hash256 {
+    static constexpr size_t kBytes = kCbCidPrefix.size() + size();
+
+    CbCid() = default;
+
+    explicit CbCid(const common::Hash256 &digest) : Hash256{digest} {}
+
+    /// Returns compact CID if cid has common form
+    static boost::optional<CbCid> make(const CID &cid);
+
+    /// Returns compact CID if bytes are binary encoding of common form
+    static boost::optional<CbCid> fromBytes(gsl::span<const uint8_t> bytes);
+
+    CID toCid() const;
+
+    /// Binary encoding same as of CID
+    std::array<uint8_t, kBytes> toBytes() const;
+  };
+
+  /**
+   * Set of CIDs, compact CIDs are kept inline and others in fallback set.
+   */
+  class CidSet {
+   public:
+    /// Inserts cid, returns false if it was present
+    bool insert(const CID &cid);
+
+    size_t count(const CID &cid) const;
+
+    size_t size() const;
+
+    void clear();
+
+   private:
+    std::unordered_set<CbCid> compact_;
+    std::unordered_set<CID> other_;
+  };
+}  // namespace fc
+
+namespace std {
+  template <>
+  struct hash<fc::CbCid> {
+    size_t operator()(const fc::CbCid &cid) const {
+      // digest bytes are uniformly distributed
+      size_t seed;
+      memcpy(&seed, cid.data(), sizeof(seed));
+      return seed;
+    }
+  };
+}  // namespace std
+
+#endif  // CPP_FILECOIN_CORE_PRIMITIVES_CID_CB_CID_HPP
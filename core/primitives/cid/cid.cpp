@@ -5,9 +5,11 @@
 
 #include "primitives/cid/cid.hpp"
 
+#include <boost/container_hash/hash.hpp>
 #include <libp2p/multi/content_identifier_codec.hpp>
 
 #include "codec/uvarint.hpp"
+#include "primitives/cid/cb_cid.hpp"
 #include "crypto/blake2/blake2b160.hpp"
 
 using libp2p::multi::HashType;
@@ -55,6 +57,10 @@ namespace fc {
   }
 
   outcome::result<std::vector<uint8_t>> CID::toBytes() const {
+    if (auto compact{CbCid::make(*this)}) {
+      auto bytes{compact->toBytes()};
+      return std::vector<uint8_t>{bytes.begin(), bytes.end()};
+    }
     return libp2p::multi::ContentIdentifierCodec::encode(*this);
   }
 
@@ -64,6 +70,9 @@ namespace fc {
   }
 
   outcome::result<CID> CID::fromBytes(gsl::span<const uint8_t> input) {
+    if (auto compact{CbCid::fromBytes(input)}) {
+      return compact->toCid();
+    }
     OUTCOME_TRY(cid, libp2p::multi::ContentIdentifierCodec::decode(input));
     return CID{std::move(cid)};
   }
@@ -120,4 +129,22 @@ namespace fc::common {
     OUTCOME_TRY(hash, Multihash::create(HashType::blake2b_256, hash_raw));
     return CID(CID::Version::V1, CID::Multicodec::DAG_CBOR, hash);
   }
+
+  outcome::result<std::vector<CID>> getCidsOf(
+      gsl::span<const gsl::span<const uint8_t>> blocks) {
+    std::vector<CID> cids;
+    cids.reserve(blocks.size());
+    for (auto &hash_raw : crypto::blake2b::blake2b_256_many(blocks)) {
+      OUTCOME_TRY(hash, Multihash::create(HashType::blake2b_256, hash_raw));
+      cids.emplace_back(CID::Version::V1, CID::Multicodec::DAG_CBOR, hash);
+    }
+    return cids;
+  }
 }  // namespace fc::common
+
+size_t std::hash<fc::CID>::operator()(const fc::CID &cid) const {
+  auto &&digest = cid.content_address.getHash();
+  auto seed = boost::hash_range(digest.begin(), digest.end());
+  boost::hash_combine(seed, cid.content_type);
+  return seed;
+}
@@ -78,10 +78,21 @@ struct fmt::formatter<fc::CID> : formatter<std::string_view> {
   }
 };
 
+namespace std {
+  template <>
+  struct hash<fc::CID> {
+    size_t operator()(const fc::CID &cid) const;
+  };
+}  // namespace std
+
 namespace fc::common {
   /// Compute CID from bytes
   outcome::result<CID> getCidOf(gsl::span<const uint8_t> bytes);
 
+  /// Compute CIDs of many blocks at once, hashing them in parallel lanes
+  outcome::result<std::vector<CID>> getCidsOf(
+      gsl::span<const gsl::span<const uint8_t>> blocks);
+
 }  // namespace fc::common
 
 #endif  // CPP_FILECOIN_CORE_COMMON_CID_HPP
@@ -0,0 +1,81 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PRIMITIVES_PIECE_COMM_P_HASHER_HPP
+#define CPP_FILECOIN_CORE_PRIMITIVES_PIECE_COMM_P_HASHER_HPP
+
+#include <gsl/span>
+#include <boost/optional.hpp>
+
+#include "primitives/cid/comm_cid.hpp"
+#include "primitives/piece/piece.hpp"
+
+namespace fc::primitives::piece {
+  using common::Comm;
+
+  /**
+   * Computes piece commitment without proofs FFI. Written bytes are fr32
+   * padded and hashed into merkle tree of sha256 truncated to 254 bits as
+   * they arrive. Zero padding is not materialized, memory does not depend on
+   * piece size.
+   */
+  class CommPHasher {
+   public:
+    /// Bytes of fr32 padded chunk
+    static constexpr size_t kPaddedChunk{128};
+    /// Bytes of unpadded chunk
+    static constexpr size_t kUnpaddedChunk{127};
+
+    /**
+     * @brief fr32 pads whole unpadded chunks, as proofs write staged sector
+     * @param in - multiple of unpadded chunk bytes
+     * @param out - 128 bytes per 127 bytes of input
+     */
+    static void pad(gsl::span<const uint8_t> in, gsl::span<uint8_t> out);
+
+    void write(gsl::span<const uint8_t> bytes);
+
+    /**
+     * @brief appends subtree of known commitment, zero pads written bytes to
+     * alignment of subtree
+     * @param comm - commitment of subtree
+     * @param size - padded size of subtree
+     */
+    outcome::result<void> addPiece(const Comm &comm, PaddedPieceSize size);
+
+    /// Number of written bytes
+    uint64_t size() const;
+
+    /**
+     * @brief zero pads written bytes to piece size and computes commitment
+     * @param size - unpadded piece size, not less than written bytes
+     */
+    outcome::result<Comm> finish(UnpaddedPieceSize size);
+
+   private:
+    using Node = std::array<uint8_t, 32>;
+
+    /// Pads and hashes full chunk
+    void flushChunk();
+
+    /// Pads pending chunk with zeros and hashes it
+    void flushPartialChunk();
+
+    /// Adds zero subtrees until given number of leaves
+    void padLeaves(uint64_t leaves);
+
+    /// Adds root of subtree at leaf position, combining completed pairs
+    void addNode(Node node, size_t level);
+
+    std::array<uint8_t, kUnpaddedChunk> chunk_{};
+    size_t chunk_size_{};
+    uint64_t written_{};
+    uint64_t leaves_{};
+    /// Left nodes waiting for their pair, by level
+    std::vector<boost::optional<Node>> levels_;
+  };
+}  // namespace fc::primitives::piece
+
+#endif  // CPP_FILECOIN_CORE_PRIMITIVES_PIECE_COMM_P_HASHER_HPP
@@ -0,0 +1,176 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/piece/comm_p_hasher.hpp"
+
+#include <cassert>
+#include <cstring>
+
+#include <boost/endian/conversion.hpp>
+#include <libp2p/crypto/sha/sha256.hpp>
+#include "primitives/piece/piece_error.hpp"
+
+namespace fc::primitives::piece {
+  namespace {
+    using Node = std::array<uint8_t, 32>;
+
+    /// Levels of tree over 2^64 leaves
+    constexpr size_t kMaxLevels{64};
+
+    Node hashNodes(const Node &left, const Node &right) {
+      std::array<uint8_t, 64> pair;
+      std::copy(left.begin(), left.end(), pair.begin());
+      std::copy(right.begin(), right.end(), pair.begin() + left.size());
+      Node node = libp2p::crypto::sha256(pair);
+      // truncate to 254 bits
+      node[31] &= 0x3f;
+      return node;
+    }
+
+    /// Roots of zero subtrees by level
+    const std::vector<Node> &zeroNodes() {
+      static const auto zeros = [] {
+        std::vector<Node> zeros{Node{}};
+        while (zeros.size() < kMaxLevels) {
+          zeros.push_back(hashNodes(zeros.back(), zeros.back()));
+        }
+        return zeros;
+      }();
+      return zeros;
+    }
+
+    /// Loads up to 64 bits of chunk starting at bit offset
+    uint64_t loadBits(const uint8_t *in, size_t offset, size_t bits) {
+      auto byte = offset / 8;
+      auto shift = offset % 8;
+      uint64_t word{};
+      if (byte + sizeof(word) <= CommPHasher::kUnpaddedChunk) {
+        std::memcpy(&word, in + byte, sizeof(word));
+        boost::endian::little_to_native_inplace(word);
+      } else {
+        for (size_t i = 0; byte + i < CommPHasher::kUnpaddedChunk; ++i) {
+          word |= uint64_t{in[byte + i]} << (8 * i);
+        }
+      }
+      word >>= shift;
+      if (shift != 0 && shift + bits > 64) {
+        word |= uint64_t{in[byte + sizeof(word)]} << (64 - shift);
+      }
+      return bits == 64 ? word : word & ((uint64_t{1} << bits) - 1);
+    }
+
+    /**
+     * Inserts two zero bits after each 254 bits of input, word at a time
+     * @param in - 127 bytes
+     * @param out - 128 bytes
+     */
+    void fr32Pad(const uint8_t *in, uint8_t *out) {
+      for (size_t quarter = 0; quarter < 4; ++quarter) {
+        for (size_t i = 0; i < 4; ++i) {
+          auto word = loadBits(in, 254 * quarter + 64 * i, i == 3 ? 62 : 64);
+          boost::endian::native_to_little_inplace(word);
+          std::memcpy(out + 32 * quarter + 8 * i, &word, sizeof(word));
+        }
+      }
+    }
+  }  // namespace
+
+  void CommPHasher::pad(gsl::span<const uint8_t> in, gsl::span<uint8_t> out) {
+    assert(in.size() % kUnpaddedChunk == 0);
+    assert(out.size() >= in.size() / kUnpaddedChunk * kPaddedChunk);
+    for (size_t i = 0; i < in.size() / kUnpaddedChunk; ++i) {
+      fr32Pad(in.data() + i * kUnpaddedChunk, out.data() + i * kPaddedChunk);
+    }
+  }
+
+  void CommPHasher::write(gsl::span<const uint8_t> bytes) {
+    written_ += bytes.size();
+    while (!bytes.empty()) {
+      auto n = std::min<size_t>(kUnpaddedChunk - chunk_size_, bytes.size());
+      std::copy(bytes.begin(), bytes.begin() + n, chunk_.begin() + chunk_size_);
+      chunk_size_ += n;
+      bytes = bytes.subspan(n);
+      if (chunk_size_ == kUnpaddedChunk) {
+        flushChunk();
+      }
+    }
+  }
+
+  outcome::result<void> CommPHasher::addPiece(const Comm &comm,
+                                              PaddedPieceSize size) {
+    OUTCOME_TRY(size.validate());
+    auto leaves = size / sizeof(Node);
+    flushPartialChunk();
+    padLeaves((leaves_ + leaves - 1) / leaves * leaves);
+    size_t level = 0;
+    while ((uint64_t{1} << level) < leaves) {
+      ++level;
+    }
+    addNode(comm, level);
+    leaves_ += leaves;
+    written_ = leaves_ / 4 * kUnpaddedChunk;
+    return outcome::success();
+  }
+
+  uint64_t CommPHasher::size() const {
+    return written_;
+  }
+
+  outcome::result<Comm> CommPHasher::finish(UnpaddedPieceSize size) {
+    OUTCOME_TRY(size.validate());
+    if (written_ > size) {
+      return PieceError::DATA_EXCEEDS_SIZE;
+    }
+    flushPartialChunk();
+    padLeaves(size.padded() / sizeof(Node));
+    return Comm{*levels_.back()};
+  }
+
+  void CommPHasher::flushChunk() {
+    std::array<uint8_t, kPaddedChunk> padded;
+    fr32Pad(chunk_.data(), padded.data());
+    chunk_size_ = 0;
+    for (size_t i = 0; i < kPaddedChunk; i += sizeof(Node)) {
+      Node leaf;
+      std::copy(padded.begin() + i, padded.begin() + i + leaf.size(),
+                leaf.begin());
+      addNode(leaf, 0);
+      ++leaves_;
+    }
+  }
+
+  void CommPHasher::flushPartialChunk() {
+    if (chunk_size_ != 0) {
+      std::fill(chunk_.begin() + chunk_size_, chunk_.end(), 0);
+      flushChunk();
+    }
+  }
+
+  void CommPHasher::padLeaves(uint64_t leaves) {
+    // zero leaves are added as largest aligned zero subtrees
+    auto &zeros = zeroNodes();
+    while (leaves_ < leaves) {
+      size_t level = 0;
+      while (((leaves_ >> level) & 1) == 0
+             && leaves_ + (uint64_t{2} << level) <= leaves) {
+        ++level;
+      }
+      addNode(zeros[level], level);
+      leaves_ += uint64_t{1} << level;
+    }
+  }
+
+  void CommPHasher::addNode(Node node, size_t level) {
+    while (level < levels_.size() && levels_[level]) {
+      node = hashNodes(*levels_[level], node);
+      levels_[level].reset();
+      ++level;
+    }
+    if (level >= levels_.size()) {
+      levels_.resize(level + 1);
+    }
+    levels_[level] = node;
+  }
+}  // namespace fc::primitives::piece
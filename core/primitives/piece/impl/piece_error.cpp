@@ -17,6 +17,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::primitives::piece, PieceError, e) {
       return "Piece: unpadded piece size must be a power of 2 multiple of 127";
     case (PieceError::INVALID_PADDED_SIZE):
       return "Piece: padded piece size must be a power of 2";
+    case (PieceError::DATA_EXCEEDS_SIZE):
+      return "Piece: data is larger than piece size";
     default:
       return "Piece: unknown error";
   }
@@ -88,4 +88,14 @@ namespace fc::primitives::piece {
   UnpaddedPieceSize paddedSize(uint64_t size);
 
 };      // namespace fc::primitives::piece
+
+namespace fc::codec::cbor {
+  /// Default value of PieceInfo for decoders
+  template <>
+  inline primitives::piece::PieceInfo
+  kDefaultT<primitives::piece::PieceInfo>() {
+    return {primitives::piece::PaddedPieceSize{}, CID{}};
+  }
+}  // namespace fc::codec::cbor
+
 #endif  // CPP_FILECOIN_PIECE_HPP
@@ -18,6 +18,7 @@ namespace fc::primitives::piece {
     LESS_THAT_MINIMUM_PADDED_SIZE,
     INVALID_UNPADDED_SIZE,
     INVALID_PADDED_SIZE,
+    DATA_EXCEEDS_SIZE,
   };
 
 }  // namespace fc::primitives::piece
@@ -0,0 +1,229 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/rle_bitset/rle_bitset.hpp"
+
+#include <algorithm>
+
+namespace fc::primitives {
+  using codec::rle::Run;
+  using codec::rle::Runs;
+
+  namespace {
+    /// Append run to sorted runs, coalescing overlapping and adjacent runs
+    void append(Runs &runs, const Run &run) {
+      if (run.length == 0) {
+        return;
+      }
+      if (!runs.empty() && runs.back().end() >= run.start) {
+        auto &back{runs.back()};
+        back.length = std::max(back.end(), run.end()) - back.start;
+      } else {
+        runs.push_back(run);
+      }
+    }
+
+    /// First run ending after value
+    template <typename It>
+    It upper(It begin, It end, uint64_t value) {
+      return std::upper_bound(
+          begin, end, value, [](auto x, auto &run) {
+            return x < run.end();
+          });
+    }
+
+    Runs unite(const Runs &lhs, const Runs &rhs) {
+      Runs result;
+      result.reserve(lhs.size() + rhs.size());
+      auto l{lhs.begin()}, r{rhs.begin()};
+      while (l != lhs.end() || r != rhs.end()) {
+        if (r == rhs.end() || (l != lhs.end() && l->start < r->start)) {
+          append(result, *l++);
+        } else {
+          append(result, *r++);
+        }
+      }
+      return result;
+    }
+
+    Runs subtract(const Runs &lhs, const Runs &rhs) {
+      Runs result;
+      result.reserve(lhs.size());
+      auto r{rhs.begin()};
+      for (auto &run : lhs) {
+        while (r != rhs.end() && r->end() <= run.start) {
+          ++r;
+        }
+        auto start{run.start}, end{run.end()};
+        for (auto it{r}; it != rhs.end() && it->start < end; ++it) {
+          if (it->start > start) {
+            result.push_back({start, it->start - start});
+          }
+          start = std::max(start, it->end());
+        }
+        if (start < end) {
+          result.push_back({start, end - start});
+        }
+      }
+      return result;
+    }
+
+    Runs intersect(const Runs &lhs, const Runs &rhs) {
+      Runs result;
+      auto l{lhs.begin()}, r{rhs.begin()};
+      while (l != lhs.end() && r != rhs.end()) {
+        auto start{std::max(l->start, r->start)};
+        auto end{std::min(l->end(), r->end())};
+        if (start < end) {
+          result.push_back({start, end - start});
+        }
+        if (l->end() < r->end()) {
+          ++l;
+        } else {
+          ++r;
+        }
+      }
+      return result;
+    }
+  }  // namespace
+
+  RleBitset::RleBitset(Runs runs) {
+    auto less{[](auto &l, auto &r) { return l.start < r.start; }};
+    if (!std::is_sorted(runs.begin(), runs.end(), less)) {
+      std::sort(runs.begin(), runs.end(), less);
+    }
+    runs_.reserve(runs.size());
+    for (auto &run : runs) {
+      append(runs_, run);
+    }
+  }
+
+  size_t RleBitset::size() const {
+    size_t size{0};
+    for (auto &run : runs_) {
+      size += run.length;
+    }
+    return size;
+  }
+
+  RleBitset::const_iterator RleBitset::find(uint64_t value) const {
+    auto run{upper(runs_.begin(), runs_.end(), value)};
+    if (run == runs_.end() || run->start > value) {
+      return end();
+    }
+    return {&*run, runs_.data() + runs_.size(), value};
+  }
+
+  bool RleBitset::insert(uint64_t value) {
+    auto next{upper(runs_.begin(), runs_.end(), value)};
+    if (next != runs_.end() && next->start <= value) {
+      return false;
+    }
+    auto join_prev{next != runs_.begin() && std::prev(next)->end() == value};
+    auto join_next{next != runs_.end() && next->start == value + 1};
+    if (join_prev && join_next) {
+      std::prev(next)->length += 1 + next->length;
+      runs_.erase(next);
+    } else if (join_prev) {
+      ++std::prev(next)->length;
+    } else if (join_next) {
+      --next->start;
+      ++next->length;
+    } else {
+      runs_.insert(next, Run{value, 1});
+    }
+    return true;
+  }
+
+  void RleBitset::insert(const RleBitset &other) {
+    runs_ = unite(runs_, other.runs_);
+  }
+
+  size_t RleBitset::erase(uint64_t value) {
+    auto run{upper(runs_.begin(), runs_.end(), value)};
+    if (run == runs_.end() || run->start > value) {
+      return 0;
+    }
+    auto end{run->end()};
+    if (run->length == 1) {
+      runs_.erase(run);
+    } else if (value == run->start) {
+      ++run->start;
+      --run->length;
+    } else if (value == end - 1) {
+      --run->length;
+    } else {
+      run->length = value - run->start;
+      runs_.insert(std::next(run), Run{value + 1, end - value - 1});
+    }
+    return 1;
+  }
+
+  size_t RleBitset::erase(const RleBitset &other) {
+    auto before{size()};
+    runs_ = subtract(runs_, other.runs_);
+    return before - size();
+  }
+
+  RleBitset RleBitset::slice(size_t offset, size_t count) const {
+    RleBitset result;
+    for (auto &run : runs_) {
+      if (count == 0) {
+        break;
+      }
+      if (offset >= run.length) {
+        offset -= run.length;
+        continue;
+      }
+      auto length{std::min<uint64_t>(run.length - offset, count)};
+      result.runs_.push_back({run.start + offset, length});
+      offset = 0;
+      count -= length;
+    }
+    return result;
+  }
+
+  RleBitset::Slicer::Slicer(const RleBitset &set) : runs_{&set.runs_} {}
+
+  void RleBitset::Slicer::skip(size_t count) {
+    while (count != 0 && run_ < runs_->size()) {
+      auto length{std::min<uint64_t>((*runs_)[run_].length - offset_, count)};
+      offset_ += length;
+      count -= length;
+      if (offset_ == (*runs_)[run_].length) {
+        ++run_;
+        offset_ = 0;
+      }
+    }
+  }
+
+  RleBitset RleBitset::Slicer::take(size_t count) {
+    RleBitset result;
+    while (count != 0 && run_ < runs_->size()) {
+      auto &run{(*runs_)[run_]};
+      auto length{std::min<uint64_t>(run.length - offset_, count)};
+      result.runs_.push_back({run.start + offset_, length});
+      offset_ += length;
+      count -= length;
+      if (offset_ == run.length) {
+        ++run_;
+        offset_ = 0;
+      }
+    }
+    return result;
+  }
+
+  RleBitset operator|(const RleBitset &lhs, const RleBitset &rhs) {
+    return RleBitset{unite(lhs.runs(), rhs.runs())};
+  }
+
+  RleBitset operator&(const RleBitset &lhs, const RleBitset &rhs) {
+    return RleBitset{intersect(lhs.runs(), rhs.runs())};
+  }
+
+  RleBitset operator-(const RleBitset &lhs, const RleBitset &rhs) {
+    return RleBitset{subtract(lhs.runs(), rhs.runs())};
+  }
+}  // namespace fc::primitives
@@ -6,28 +6,211 @@
 #ifndef CPP_FILECOIN_CORE_PRIMITIVES_RLE_BITSET_RLE_BITSET_HPP
 #define CPP_FILECOIN_CORE_PRIMITIVES_RLE_BITSET_RLE_BITSET_HPP
 
-#include <set>
+#include <initializer_list>
+#include <iterator>
 
 #include "codec/cbor/streams_annotation.hpp"
 #include "codec/rle/rle_plus.hpp"
 #include "common/outcome.hpp"
 
 namespace fc::primitives {
-  struct RleBitset : public std::set<uint64_t> {
-    using set::set;
+  /**
+   * Set of unsigned integers stored as sorted disjoint runs.
+   * Set algebra, cardinality and RLE+ coding are linear in number of runs.
+   */
+  class RleBitset {
+   public:
+    using value_type = uint64_t;
+    using Run = codec::rle::Run;
+    using Runs = codec::rle::Runs;
 
-    inline RleBitset(set &&s) : set{s} {}
+    /// Forward iterator over values of runs
+    class const_iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = uint64_t;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const uint64_t *;
+      using reference = const uint64_t &;
+
+      const_iterator() = default;
+
+      inline const_iterator(const Run *run, const Run *end)
+          : run_{run}, end_{end}, value_{run != end ? run->start : 0} {}
+
+      inline const_iterator(const Run *run, const Run *end, uint64_t value)
+          : run_{run}, end_{end}, value_{value} {}
+
+      inline reference operator*() const {
+        return value_;
+      }
+
+      inline pointer operator->() const {
+        return &value_;
+      }
+
+      inline const_iterator &operator++() {
+        if (++value_ == run_->end()) {
+          ++run_;
+          value_ = run_ != end_ ? run_->start : 0;
+        }
+        return *this;
+      }
+
+      inline const_iterator operator++(int) {
+        auto it{*this};
+        ++*this;
+        return it;
+      }
+
+      inline bool operator==(const const_iterator &other) const {
+        return run_ == other.run_ && value_ == other.value_;
+      }
+
+      inline bool operator!=(const const_iterator &other) const {
+        return !(*this == other);
+      }
+
+     private:
+      const Run *run_{};
+      const Run *end_{};
+      uint64_t value_{};
+    };
+    using iterator = const_iterator;
+
+    RleBitset() = default;
+
+    /// Construct from runs, runs are sorted and coalesced
+    explicit RleBitset(Runs runs);
+
+    inline RleBitset(std::initializer_list<uint64_t> values) {
+      for (auto value : values) {
+        add(value);
+      }
+    }
+
+    template <typename It,
+              typename = typename std::iterator_traits<It>::iterator_category>
+    RleBitset(It first, It last) {
+      insert(first, last);
+    }
+
+    inline const Runs &runs() const {
+      return runs_;
+    }
+
+    inline const_iterator begin() const {
+      return {runs_.data(), runs_.data() + runs_.size()};
+    }
+
+    inline const_iterator end() const {
+      auto end{runs_.data() + runs_.size()};
+      return {end, end};
+    }
+
+    inline bool empty() const {
+      return runs_.empty();
+    }
+
+    /// Number of values, O(runs)
+    size_t size() const;
+
+    /// Iterator to value or end if value is absent, O(log runs)
+    const_iterator find(uint64_t value) const;
+
+    inline size_t count(uint64_t value) const {
+      return find(value) != end() ? 1 : 0;
+    }
+
+    /// Insert value, returns false if it was present
+    bool insert(uint64_t value);
+
+    template <typename It>
+    void insert(It first, It last) {
+      for (; first != last; ++first) {
+        add(*first);
+      }
+    }
+
+    /// Union with other set, O(runs)
+    void insert(const RleBitset &other);
+
+    /// Erase value, returns number of erased values
+    size_t erase(uint64_t value);
+
+    /// Difference with other set, returns number of erased values, O(runs)
+    size_t erase(const RleBitset &other);
+
+    /**
+     * Get values by position in set
+     * @param offset - position of first value
+     * @param count - max number of values
+     * @return values at positions [offset, offset + count)
+     */
+    RleBitset slice(size_t offset, size_t count) const;
+
+    /**
+     * Cursor taking consecutive slices by position, all slices of set cost
+     * O(runs) in total instead of O(runs) each
+     */
+    class Slicer {
+     public:
+      explicit Slicer(const RleBitset &set);
+
+      /// Skip up to count values
+      void skip(size_t count);
+
+      /// Take up to count values following skipped and taken ones
+      RleBitset take(size_t count);
+
+     private:
+      const Runs *runs_;
+      size_t run_{};
+      /// Position in current run
+      uint64_t offset_{};
+    };
+
+    inline bool operator==(const RleBitset &other) const {
+      return runs_ == other.runs_;
+    }
+
+    inline bool operator!=(const RleBitset &other) const {
+      return !(*this == other);
+    }
+
+   private:
+    /// Insert value, fast path for appending sorted values
+    inline void add(uint64_t value) {
+      if (!runs_.empty() && runs_.back().end() == value) {
+        ++runs_.back().length;
+      } else if (runs_.empty() || runs_.back().end() < value) {
+        runs_.push_back({value, 1});
+      } else {
+        insert(value);
+      }
+    }
+
+    Runs runs_;
   };
 
+  /// Union of sets
+  RleBitset operator|(const RleBitset &lhs, const RleBitset &rhs);
+
+  /// Intersection of sets
+  RleBitset operator&(const RleBitset &lhs, const RleBitset &rhs);
+
+  /// Difference of sets
+  RleBitset operator-(const RleBitset &lhs, const RleBitset &rhs);
+
   CBOR_ENCODE(RleBitset, set) {
-    return s << codec::rle::encode(set);
+    return s << codec::rle::encode(set.runs());
   }
 
   CBOR_DECODE(RleBitset, set) {
     std::vector<uint8_t> rle;
     s >> rle;
-    OUTCOME_EXCEPT(decoded, codec::rle::decode<RleBitset::value_type>(rle));
-    set = RleBitset{std::move(decoded)};
+    OUTCOME_EXCEPT(runs, codec::rle::decodeRuns(rle));
+    set = RleBitset{std::move(runs)};
     return s;
   }
 }  // namespace fc::primitives
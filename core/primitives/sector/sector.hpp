@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_CORE_PROOFS_SECTOR_HPP
 #define CPP_FILECOIN_CORE_PROOFS_SECTOR_HPP
 
+#include <tuple>
+
 #include "common/blob.hpp"
 #include "common/buffer.hpp"
 #include "crypto/randomness/randomness_types.hpp"
@@ -29,6 +31,10 @@ namespace fc::primitives::sector {
     return lhs.miner == rhs.miner && lhs.sector == rhs.sector;
   }
 
+  inline bool operator<(const SectorId &lhs, const SectorId &rhs) {
+    return std::tie(lhs.miner, lhs.sector) < std::tie(rhs.miner, rhs.sector);
+  }
+
   /// This ordering, defines mappings to UInt in a way which MUST never change.
   enum class RegisteredProof : int64_t {
     StackedDRG32GiBSeal = 1,
@@ -183,8 +189,23 @@ namespace fc::primitives::sector {
              sector,
              seal_rand_epoch)
 
+  CBOR_TUPLE(SealVerifyInfo,
+             sector,
+             info,
+             randomness,
+             interactive_randomness,
+             unsealed_cid)
+
   CBOR_TUPLE(PoStProof, registered_proof, proof)
 
+  CBOR_TUPLE(SectorInfo, registered_proof, sector, sealed_cid)
+
+  CBOR_TUPLE(WindowPoStVerifyInfo,
+             randomness,
+             proofs,
+             challenged_sectors,
+             prover)
+
   CBOR_TUPLE(PrivatePoStCandidateProof, registered_proof, externalized)
 
   CBOR_TUPLE(PoStCandidate,
@@ -28,7 +28,7 @@ namespace fc::primitives::tipset {
   outcome::result<void> MessageVisitor::visit(const BlockHeader &block,
                                               const Visitor &visitor) {
     auto onMessage = [&](auto bls, auto &cid) -> outcome::result<void> {
-      if (visited.insert(cid).second) {
+      if (visited.insert(cid)) {
         OUTCOME_TRY(visitor(visited.size() - 1, bls, cid));
       }
       return outcome::success();
@@ -42,6 +42,18 @@ namespace fc::primitives::tipset {
   }
 
   outcome::result<Tipset> Tipset::create(std::vector<BlockHeader> blocks) {
+    std::vector<CID> cids;
+    cids.reserve(blocks.size());
+    for (auto &block : blocks) {
+      OUTCOME_TRY(cid, fc::primitives::cid::getCidOfCbor(block));
+      cids.push_back(std::move(cid));
+    }
+    return create(std::move(blocks), std::move(cids));
+  }
+
+  outcome::result<Tipset> Tipset::create(std::vector<BlockHeader> blocks,
+                                         std::vector<CID> cids) {
+    assert(blocks.size() == cids.size());
     // required to have at least one block
     if (blocks.empty()) {
       return TipsetError::NO_BLOCKS;
@@ -62,12 +74,9 @@ namespace fc::primitives::tipset {
 
     std::vector<std::pair<block::BlockHeader, CID>> items;
     items.reserve(blocks.size());
-    for (auto &block : blocks) {
-      assert(block.ticket);
-      OUTCOME_TRY(cid, fc::primitives::cid::getCidOfCbor(block));
-      // need to ensure that all cids are calculated before sort,
-      // since it will terminate program in case of exception
-      items.emplace_back(std::make_pair(std::move(block), cid));
+    for (size_t i = 0; i < blocks.size(); ++i) {
+      assert(blocks[i].ticket);
+      items.emplace_back(std::move(blocks[i]), std::move(cids[i]));
     }
 
     // the sort function shouldn't throw exceptions
@@ -111,7 +120,8 @@ namespace fc::primitives::tipset {
       OUTCOME_TRY(block, ipld.getCbor<BlockHeader>(cid));
       blocks.emplace_back(std::move(block));
     }
-    return create(std::move(blocks));
+    // blocks are addressed by cids, they are not encoded again
+    return create(std::move(blocks), cids);
   }
 
   outcome::result<Tipset> Tipset::loadParent(Ipld &ipld) const {
@@ -162,6 +172,9 @@ namespace fc::primitives::tipset {
   }
 
   bool operator==(const Tipset &lhs, const Tipset &rhs) {
+    if (&lhs == &rhs) return true;
+    // cids are hashes of blocks
+    if (!lhs.cids.empty() && lhs.cids == rhs.cids) return true;
     if (lhs.blks.size() != rhs.blks.size()) return false;
     return std::equal(lhs.blks.begin(), lhs.blks.end(), rhs.blks.begin());
   }
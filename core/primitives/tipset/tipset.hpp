@@ -7,6 +7,7 @@
 #define CPP_FILECOIN_CORE_PRIMITIVES_TIPSET_TIPSET_HPP
 
 #include "primitives/block/block.hpp"
+#include "primitives/cid/cb_cid.hpp"
 #include "primitives/tipset/tipset_key.hpp"
 
 namespace fc::primitives::tipset {
@@ -33,7 +34,7 @@ namespace fc::primitives::tipset {
     outcome::result<void> visit(const BlockHeader &block,
                                 const Visitor &visitor);
     IpldPtr ipld;
-    std::set<CID> visited{};
+    CidSet visited;
   };
 
   /**
@@ -43,6 +44,14 @@ namespace fc::primitives::tipset {
   struct Tipset {
     static outcome::result<Tipset> create(std::vector<BlockHeader> blocks);
 
+    /**
+     * Creates tipset of blocks with known cids, e.g. blocks loaded by cids,
+     * so blocks are not encoded again to compute them
+     * @param cids - cids of blocks, in same order
+     */
+    static outcome::result<Tipset> create(std::vector<BlockHeader> blocks,
+                                          std::vector<CID> cids);
+
     static outcome::result<Tipset> load(Ipld &ipld,
                                         const std::vector<CID> &cids);
 
@@ -115,6 +124,13 @@ namespace fc::primitives::tipset {
 
   CBOR_TUPLE(Tipset, cids, blks, height)
 
+  /**
+   * Immutable shared tipset, copies share blocks. Tipsets loaded by chain
+   * store are interned in its cache, so handles of same tipset are usually
+   * equal pointers.
+   */
+  using TipsetCPtr = std::shared_ptr<const Tipset>;
+
   /**
    * @brief change type
    */
@@ -127,6 +143,10 @@ namespace fc::primitives::tipset {
     HeadChangeType type;
     Tipset value;
   };
+
+  inline bool operator==(const HeadChange &l, const HeadChange &r) {
+    return l.type == r.type && l.value == r.value;
+  }
 }  // namespace fc::primitives::tipset
 
 #endif  // CPP_FILECOIN_CORE_PRIMITIVES_TIPSET_TIPSET_HPP
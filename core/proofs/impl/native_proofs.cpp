@@ -0,0 +1,260 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/native_proofs.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "primitives/piece/comm_p_hasher.hpp"
+#include "primitives/piece/piece_error.hpp"
+#include "proofs/proofs_error.hpp"
+
+namespace fc::proofs {
+  namespace bip = boost::interprocess;
+  using common::CIDToPieceCommitmentV1;
+  using common::dataCommitmentV1ToCID;
+  using primitives::piece::CommPHasher;
+  using primitives::piece::PieceError;
+
+  namespace {
+    /// Writes all bytes at offset
+    bool writeAt(int fd, const uint8_t *data, size_t size, uint64_t offset) {
+      while (size != 0) {
+        auto written = pwrite(fd, data, size, offset);
+        if (written <= 0) {
+          return false;
+        }
+        data += written;
+        size -= written;
+        offset += written;
+      }
+      return true;
+    }
+
+    bool writeZeros(int fd, uint64_t offset, uint64_t size) {
+      static const std::vector<uint8_t> zeros(NativeProofs::kSubtreeSize);
+      while (size != 0) {
+        auto part = std::min<uint64_t>(size, zeros.size());
+        if (!writeAt(fd, zeros.data(), part, offset)) {
+          return false;
+        }
+        offset += part;
+        size -= part;
+      }
+      return true;
+    }
+
+    /// Reads until size bytes or end of input, negative on error
+    ssize_t readFull(int fd, uint8_t *data, size_t size) {
+      size_t done = 0;
+      while (done < size) {
+        auto n = read(fd, data + done, size - done);
+        if (n < 0) {
+          return n;
+        }
+        if (n == 0) {
+          break;
+        }
+        done += n;
+      }
+      return done;
+    }
+  }  // namespace
+
+  outcome::result<Comm> NativeProofs::pieceCommitment(
+      gsl::span<const uint8_t> data,
+      UnpaddedPieceSize piece_size,
+      size_t threads) {
+    OUTCOME_TRY(piece_size.validate());
+    if (data.size() > piece_size) {
+      return PieceError::DATA_EXCEEDS_SIZE;
+    }
+    PaddedPieceSize padded = piece_size.padded();
+    CommPHasher root;
+    if (threads == 0 || padded <= kSubtreeSize) {
+      root.write(data);
+      return root.finish(piece_size);
+    }
+    // subtrees over data are hashed independently, zero tail is padded by
+    // root hasher
+    auto subtree_unpadded = PaddedPieceSize{kSubtreeSize}.unpadded();
+    auto count = (data.size() + subtree_unpadded - 1) / subtree_unpadded;
+    boost::asio::thread_pool pool{std::min<size_t>(threads, count)};
+    std::vector<std::future<outcome::result<Comm>>> subtrees;
+    for (size_t i = 0; i < count; ++i) {
+      auto offset = i * subtree_unpadded;
+      auto part = data.subspan(
+          offset, std::min<size_t>(subtree_unpadded, data.size() - offset));
+      auto task = std::make_shared<std::packaged_task<outcome::result<Comm>()>>(
+          [part, subtree_unpadded] {
+            CommPHasher hasher;
+            hasher.write(part);
+            return hasher.finish(subtree_unpadded);
+          });
+      subtrees.push_back(task->get_future());
+      boost::asio::post(pool, [task] { (*task)(); });
+    }
+    for (auto &subtree : subtrees) {
+      OUTCOME_TRY(comm, subtree.get());
+      OUTCOME_TRY(root.addPiece(comm, PaddedPieceSize{kSubtreeSize}));
+    }
+    return root.finish(piece_size);
+  }
+
+  outcome::result<CID> NativeProofs::generatePieceCID(
+      gsl::span<const uint8_t> data, UnpaddedPieceSize piece_size) {
+    OUTCOME_TRY(comm,
+                pieceCommitment(
+                    data, piece_size, std::thread::hardware_concurrency()));
+    return dataCommitmentV1ToCID(comm);
+  }
+
+  outcome::result<CID> NativeProofs::generatePieceCIDFromFile(
+      const std::string &piece_file_path, UnpaddedPieceSize piece_size) {
+    boost::system::error_code ec;
+    auto file_size = boost::filesystem::file_size(piece_file_path, ec);
+    if (ec) {
+      return ProofsError::CANNOT_OPEN_FILE;
+    }
+    // like ffi, only piece size prefix of file is hashed
+    auto size = std::min<uint64_t>(file_size, piece_size);
+    if (size == 0) {
+      return generatePieceCID({}, piece_size);
+    }
+    try {
+      bip::file_mapping file{piece_file_path.c_str(), bip::read_only};
+      bip::mapped_region region{file, bip::read_only, 0, size};
+      return generatePieceCID(
+          gsl::make_span(static_cast<const uint8_t *>(region.get_address()),
+                         size),
+          piece_size);
+    } catch (const bip::interprocess_exception &) {
+      return ProofsError::CANNOT_OPEN_FILE;
+    }
+  }
+
+  outcome::result<WriteWithAlignmentResult> NativeProofs::writeWithAlignment(
+      RegisteredProof proof_type,
+      const PieceData &piece_data,
+      UnpaddedPieceSize piece_bytes,
+      const std::string &staged_sector_file_path,
+      gsl::span<const UnpaddedPieceSize> existing_piece_sizes,
+      size_t threads) {
+    OUTCOME_TRY(piece_bytes.validate());
+    if (!piece_data.isOpened()) {
+      return ProofsError::CANNOT_OPEN_FILE;
+    }
+    OUTCOME_TRY(sector_size, primitives::sector::getSectorSize(proof_type));
+    uint64_t offset = 0;
+    for (auto &size : existing_piece_sizes) {
+      offset += size.padded();
+    }
+    uint64_t padded = piece_bytes.padded();
+    // piece is aligned to its size
+    auto left = (padded - offset % padded) % padded;
+    auto piece_offset = offset + left;
+    if (piece_offset + padded > sector_size) {
+      return PieceError::DATA_EXCEEDS_SIZE;
+    }
+
+    auto fd = open(staged_sector_file_path.c_str(),
+                   O_WRONLY | O_CREAT | O_CLOEXEC,
+                   0644);
+    if (fd < 0) {
+      return ProofsError::CANNOT_OPEN_FILE;
+    }
+    std::atomic_bool failed{!writeZeros(fd, offset, left)};
+
+    const uint64_t chunk_padded = std::min<uint64_t>(padded, kSubtreeSize);
+    const uint64_t chunk_unpadded = PaddedPieceSize{chunk_padded}.unpadded();
+    const auto count = padded / chunk_padded;
+    threads = std::max<size_t>(threads, 1);
+    // chunks read ahead of padding and writes, bounds memory
+    const auto window = 2 * threads;
+    std::vector<Comm> comms(count);
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t in_flight = 0;
+    uint64_t remaining = piece_bytes;
+    {
+      boost::asio::thread_pool pool{std::min<size_t>(threads, count)};
+      for (size_t i = 0; i < count && !failed; ++i) {
+        {
+          std::unique_lock lock{mutex};
+          done.wait(lock, [&] { return in_flight < window; });
+          ++in_flight;
+        }
+        // short input is zero padded, like piece commitment of file
+        auto chunk = std::make_shared<std::vector<uint8_t>>(chunk_unpadded);
+        auto got = readFull(piece_data.getFd(),
+                            chunk->data(),
+                            std::min(remaining, chunk_unpadded));
+        if (got < 0) {
+          failed = true;
+          break;
+        }
+        remaining -= got;
+        boost::asio::post(pool, [&, i, chunk, got] {
+          CommPHasher hasher;
+          hasher.write(gsl::make_span(*chunk).first(got));
+          auto comm = hasher.finish(UnpaddedPieceSize{chunk_unpadded});
+          std::vector<uint8_t> out(chunk_padded);
+          CommPHasher::pad(*chunk, out);
+          if (!comm
+              || !writeAt(fd,
+                          out.data(),
+                          out.size(),
+                          piece_offset + i * chunk_padded)) {
+            failed = true;
+          } else {
+            comms[i] = comm.value();
+          }
+          std::lock_guard lock{mutex};
+          --in_flight;
+          done.notify_one();
+        });
+      }
+      pool.join();
+    }
+    if (close(fd) != 0 || failed) {
+      return ProofsError::UNKNOWN;
+    }
+
+    CommPHasher root;
+    for (auto &comm : comms) {
+      OUTCOME_TRY(root.addPiece(comm, PaddedPieceSize{chunk_padded}));
+    }
+    OUTCOME_TRY(comm_p, root.finish(piece_bytes));
+    OUTCOME_TRY(piece_cid, dataCommitmentV1ToCID(comm_p));
+    auto left_unpadded = PaddedPieceSize{left}.unpadded();
+    return WriteWithAlignmentResult{
+        left_unpadded, left_unpadded + piece_bytes, piece_cid};
+  }
+
+  outcome::result<CID> NativeProofs::generateUnsealedCID(
+      RegisteredProof proof_type, gsl::span<const PieceInfo> pieces) {
+    OUTCOME_TRY(sector_size, primitives::sector::getSectorSize(proof_type));
+    CommPHasher sector;
+    for (auto &piece : pieces) {
+      OUTCOME_TRY(comm, CIDToPieceCommitmentV1(piece.cid));
+      OUTCOME_TRY(sector.addPiece(comm, piece.size));
+    }
+    OUTCOME_TRY(comm_d,
+                sector.finish(PaddedPieceSize{sector_size}.unpadded()));
+    return dataCommitmentV1ToCID(comm_d);
+  }
+}  // namespace fc::proofs
@@ -0,0 +1,226 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/param_fetcher.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <condition_variable>
+#include <mutex>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include "crypto/blake2/blake2b.h"
+#include "proofs/proof_param_provider_error.hpp"
+
+namespace fc::proofs {
+  namespace fs = boost::filesystem;
+
+  namespace {
+    /// Closes descriptor on scope exit
+    struct Fd {
+      ~Fd() {
+        if (fd >= 0) {
+          close(fd);
+        }
+      }
+      int fd;
+    };
+
+    bool writeAll(int fd, gsl::span<const uint8_t> bytes, uint64_t offset) {
+      while (!bytes.empty()) {
+        auto written = pwrite(fd, bytes.data(), bytes.size(), offset);
+        if (written <= 0) {
+          return false;
+        }
+        bytes = bytes.subspan(written);
+        offset += written;
+      }
+      return true;
+    }
+
+    /// Hashes range of file
+    bool hashRange(blake2b_ctx &ctx, int fd, uint64_t offset, uint64_t size) {
+      std::vector<uint8_t> buffer(std::min<uint64_t>(size, 1 << 20));
+      while (size != 0) {
+        auto read = pread(
+            fd, buffer.data(), std::min<uint64_t>(size, buffer.size()), offset);
+        if (read <= 0) {
+          return false;
+        }
+        blake2b_update(&ctx, buffer.data(), read);
+        offset += read;
+        size -= read;
+      }
+      return true;
+    }
+  }  // namespace
+
+  ParamFetcher::ParamFetcher(FetchConfig config,
+                             SizeFunction size,
+                             RangeFunction range)
+      : config_{std::move(config)},
+        size_{std::move(size)},
+        range_{std::move(range)},
+        logger_{common::createLogger("param fetcher")} {
+    config_.connections = std::max<size_t>(config_.connections, 1);
+    config_.chunk_size = std::max<uint64_t>(config_.chunk_size, 1);
+  }
+
+  outcome::result<void> ParamFetcher::fetchChunk(const std::string &cid,
+                                                 int fd,
+                                                 uint64_t offset,
+                                                 uint64_t size) {
+    auto gateways = config_.gateways.size();
+    for (size_t attempt = 0; attempt < config_.retries * gateways; ++attempt) {
+      auto gateway = (gateway_ + attempt) % gateways;
+      auto url = config_.gateways[gateway] + cid;
+      uint64_t received{};
+      auto sink = [&](gsl::span<const uint8_t> bytes) {
+        if (received + bytes.size() > size
+            || !writeAll(fd, bytes, offset + received)) {
+          return false;
+        }
+        received += bytes.size();
+        return true;
+      };
+      auto result = range_(url, offset, size, sink);
+      if (result && received == size) {
+        gateway_ = gateway;
+        return outcome::success();
+      }
+      logger_->warn("range {}+{} of {} failed: {}",
+                    offset,
+                    size,
+                    url,
+                    result ? "incomplete" : result.error().message());
+    }
+    return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+  }
+
+  outcome::result<Blake2b512Hash> ParamFetcher::fetch(const std::string &cid,
+                                                      const std::string &path) {
+    if (config_.gateways.empty()) {
+      return ProofParamProviderError::INVALID_URL;
+    }
+
+    boost::optional<uint64_t> file_size;
+    for (size_t i = 0; i < config_.gateways.size() && !file_size; ++i) {
+      auto gateway = (gateway_ + i) % config_.gateways.size();
+      auto size = size_(config_.gateways[gateway] + cid);
+      if (size) {
+        file_size = size.value();
+        gateway_ = gateway;
+      }
+    }
+    if (!file_size) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+    auto size = *file_size;
+    auto chunk_size = config_.chunk_size;
+    auto count = (size + chunk_size - 1) / chunk_size;
+
+    auto part_path = path + ".part";
+    auto journal_path = part_path + ".journal";
+    Fd part{open(part_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)};
+    struct stat st {};
+    if (part.fd < 0 || fstat(part.fd, &st) != 0) {
+      return ProofParamProviderError::FILE_DOES_NOT_OPEN;
+    }
+    auto fresh = static_cast<uint64_t>(st.st_size) != size;
+    if (fresh && ftruncate(part.fd, size) != 0) {
+      return ProofParamProviderError::FILE_DOES_NOT_OPEN;
+    }
+    Fd journal{open(journal_path.c_str(),
+                    O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC
+                        | (fresh ? O_TRUNC : 0),
+                    0644)};
+    if (journal.fd < 0) {
+      return ProofParamProviderError::FILE_DOES_NOT_OPEN;
+    }
+
+    // char instead of bool, elements are written concurrently
+    std::vector<char> done(count);
+    uint64_t index{};
+    while (read(journal.fd, &index, sizeof(index)) == sizeof(index)) {
+      boost::endian::little_to_native_inplace(index);
+      if (index < count) {
+        done[index] = 1;
+      }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    auto failed{false};
+    boost::asio::thread_pool pool{config_.connections};
+    for (uint64_t i = 0; i < count; ++i) {
+      if (done[i]) {
+        continue;
+      }
+      boost::asio::post(pool, [&, i] {
+        {
+          std::lock_guard lock{mutex};
+          if (failed) {
+            return;
+          }
+        }
+        auto offset = i * chunk_size;
+        auto fetched = fetchChunk(
+            cid, part.fd, offset, std::min(chunk_size, size - offset));
+        auto synced = fetched && fdatasync(part.fd) == 0;
+        std::lock_guard lock{mutex};
+        auto le_index = boost::endian::native_to_little(i);
+        if (synced
+            && write(journal.fd, &le_index, sizeof(le_index))
+                   == sizeof(le_index)) {
+          done[i] = 1;
+        } else {
+          failed = true;
+        }
+        cv.notify_all();
+      });
+    }
+
+    blake2b_ctx ctx;
+    blake2b_init(&ctx, crypto::blake2b::BLAKE2B512_HASH_LENGTH, nullptr, 0);
+    for (uint64_t i = 0; i < count; ++i) {
+      {
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [&] { return done[i] || failed; });
+        if (failed) {
+          break;
+        }
+      }
+      auto offset = i * chunk_size;
+      if (!hashRange(
+              ctx, part.fd, offset, std::min(chunk_size, size - offset))) {
+        std::lock_guard lock{mutex};
+        failed = true;
+      }
+    }
+    pool.join();
+    if (failed) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+
+    Blake2b512Hash hash;
+    blake2b_final(&ctx, hash.data());
+
+    boost::system::error_code ec;
+    if (fsync(part.fd) != 0) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+    fs::rename(part_path, path, ec);
+    if (ec) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+    fs::remove(journal_path, ec);
+    return hash;
+  }
+}  // namespace fc::proofs
@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/param_manifest.hpp"
+
+#include <sys/stat.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "proofs/proof_param_provider_error.hpp"
+
+namespace fc::proofs {
+  namespace pt = boost::property_tree;
+
+  ParamManifest::ParamManifest(std::string path) : path_{std::move(path)} {
+    pt::ptree tree;
+    try {
+      pt::read_json(path_, tree);
+      for (auto &[file, entry] : tree) {
+        ParamStamp stamp;
+        stamp.size = entry.get<uint64_t>("size");
+        stamp.mtime_ns = entry.get<int64_t>("mtime_ns");
+        stamp.inode = entry.get<uint64_t>("inode");
+        stamp.digest = entry.get<std::string>("digest");
+        stamps_.emplace(file, std::move(stamp));
+      }
+    } catch (const pt::ptree_error &) {
+      // files are verified again
+      stamps_.clear();
+    }
+  }
+
+  outcome::result<ParamStamp> ParamManifest::stamp(const std::string &file,
+                                                   const std::string &digest) {
+    struct stat st {};
+    if (::stat(file.c_str(), &st) != 0) {
+      return ProofParamProviderError::FILE_DOES_NOT_OPEN;
+    }
+    ParamStamp stamp;
+    stamp.size = st.st_size;
+    stamp.mtime_ns = int64_t{st.st_mtim.tv_sec} * 1000000000
+                     + st.st_mtim.tv_nsec;
+    stamp.inode = st.st_ino;
+    stamp.digest = digest;
+    return stamp;
+  }
+
+  bool ParamManifest::verified(const std::string &file,
+                               const std::string &digest) const {
+    auto current = stamp(file, digest);
+    if (!current) {
+      return false;
+    }
+    std::lock_guard lock{mutex_};
+    auto it = stamps_.find(file);
+    return it != stamps_.end() && it->second == current.value();
+  }
+
+  void ParamManifest::add(const std::string &file, const std::string &digest) {
+    auto current = stamp(file, digest);
+    std::lock_guard lock{mutex_};
+    if (current) {
+      stamps_.insert_or_assign(file, std::move(current.value()));
+    } else {
+      stamps_.erase(file);
+    }
+  }
+
+  void ParamManifest::remove(const std::string &file) {
+    std::lock_guard lock{mutex_};
+    stamps_.erase(file);
+  }
+
+  outcome::result<void> ParamManifest::save() const {
+    pt::ptree tree;
+    {
+      std::lock_guard lock{mutex_};
+      for (auto &[file, stamp] : stamps_) {
+        pt::ptree entry;
+        entry.put("size", stamp.size);
+        entry.put("mtime_ns", stamp.mtime_ns);
+        entry.put("inode", stamp.inode);
+        entry.put("digest", stamp.digest);
+        // file paths contain dots, which are separators of default path
+        tree.push_back({file, std::move(entry)});
+      }
+    }
+    auto tmp = path_ + ".tmp";
+    try {
+      pt::write_json(tmp, tree);
+      boost::filesystem::rename(tmp, path_);
+    } catch (const std::exception &) {
+      return ProofParamProviderError::FILE_DOES_NOT_OPEN;
+    }
+    return outcome::success();
+  }
+}  // namespace fc::proofs
@@ -6,18 +6,22 @@
 #include "proofs/proof_param_provider.hpp"
 
 #include <cstdlib>
+#include <future>
 #include <iostream>
 #include <regex>
+#include <sstream>
 #include <string>
-#include <thread>
 
 #include <curl/curl.h>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
 #include "common/outcome.hpp"
 #include "crypto/blake2/blake2b160.hpp"
+#include "proofs/param_fetcher.hpp"
 #include "proofs/proof_param_provider_error.hpp"
 
 namespace fc::proofs {
@@ -25,79 +29,126 @@ namespace fc::proofs {
   common::Logger ProofParamProvider::logger_ =
       common::createLogger("proofs params");
 
-  bool ProofParamProvider::errors_ = false;
+  std::atomic_bool ProofParamProvider::errors_{false};
 
-  auto write_data(void *ptr, size_t size, size_t nmemb, void *stream) {
-    return fwrite(ptr, size, nmemb, (FILE *)stream);
-  }
-
-  auto const default_gateway = "https://ipfs.io/ipfs/";
+  const std::vector<std::string> default_gateways{
+      "https://ipfs.io/ipfs/", "https://proofs.filecoin.io/ipfs/"};
   auto const param_dir = "/var/tmp/filecoin-proof-parameters";
   auto const dir_env = "FIL_PROOFS_PARAMETER_CACHE";
-
-  outcome::result<void> ProofParamProvider::doFetch(const std::string &out,
-                                                    const ParamFile &info) {
-    try {
-      /* init the curl session */
-      auto curl_handle = curl_easy_init();
-
-      std::string gateway = default_gateway;
-      if (auto custom_gateway = std::getenv("IPFS_GATEWAY")) {
-        gateway = custom_gateway;
+  /// Files verified before, in param dir
+  auto const manifest_name = "verified-params.json";
+  /// Abort transfer slower than 1KiB/s for a minute
+  const long kLowSpeedLimit{1 << 10};
+  /// Files fetched at once, each fetch uses own connections
+  const size_t kParallelFetches{4};
+  const long kLowSpeedTime{60};
+
+  /// Gateways from comma separated IPFS_GATEWAY or default ones
+  std::vector<std::string> getGateways() {
+    std::vector<std::string> gateways;
+    if (auto custom_gateway = std::getenv("IPFS_GATEWAY")) {
+      std::stringstream list{custom_gateway};
+      std::string gateway;
+      while (std::getline(list, gateway, ',')) {
+        if (!gateway.empty()) {
+          gateways.push_back(gateway);
+        }
       }
-
+    }
+    if (gateways.empty()) {
+      gateways = default_gateways;
+    }
+    for (auto &gateway : gateways) {
       if (gateway[gateway.size() - 1] != '/') {
         gateway += "/";
       }
+    }
+    return gateways;
+  }
 
-      gateway += info.cid;
-
-      /* set URL to get here */
-      curl_easy_setopt(curl_handle, CURLOPT_URL, gateway.c_str());
-
-      /* Switch off full protocol/debug output while testing, set to 1L to
-       * enable it */
-      curl_easy_setopt(curl_handle, CURLOPT_VERBOSE, 0L);
-
-      /* enable progress meter, set to 1L to disable it */
-      curl_easy_setopt(curl_handle, CURLOPT_NOPROGRESS, 0L);
-
-      /* send all data to this function  */
-      curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, write_data);
-
-      boost::uintmax_t f_size = boost::filesystem::exists(out)
-                                    ? boost::filesystem::file_size(out)
-                                    : 0;
-
-      struct curl_slist *chunk = NULL;
-
-      std::string header = "Range: bytes=" + std::to_string(f_size) + "-";
-
-      chunk = curl_slist_append(chunk, header.c_str());
-
-      curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, chunk);
-
-      /* open the file */
-      auto pagefile = fopen(out.c_str(), "ab");
-      if (pagefile) {
-        /* write the page body to this file handle */
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, pagefile);
+  bool trustParams() {
+    // Assuming parameter files are ok. DO NOT USE IN PRODUCTION
+    char *res = std::getenv("TRUST_PARAMS");
+    return res != nullptr && std::strcmp(res, "1") == 0;
+  }
 
-        /* get it! */
-        curl_easy_perform(curl_handle);
+  CURL *curlInit(const std::string &url) {
+    auto curl_handle = curl_easy_init();
+    if (curl_handle != nullptr) {
+      curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
+      curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
+      curl_easy_setopt(curl_handle, CURLOPT_FAILONERROR, 1L);
+      curl_easy_setopt(curl_handle, CURLOPT_NOSIGNAL, 1L);
+      curl_easy_setopt(curl_handle, CURLOPT_LOW_SPEED_LIMIT, kLowSpeedLimit);
+      curl_easy_setopt(curl_handle, CURLOPT_LOW_SPEED_TIME, kLowSpeedTime);
+    }
+    return curl_handle;
+  }
 
-        /* close the header file */
-        fclose(pagefile);
-      }
+  outcome::result<uint64_t> curlSize(const std::string &url) {
+    auto curl_handle = curlInit(url);
+    if (curl_handle == nullptr) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+    curl_easy_setopt(curl_handle, CURLOPT_NOBODY, 1L);
+    curl_off_t size = -1;
+    if (curl_easy_perform(curl_handle) == CURLE_OK) {
+      curl_easy_getinfo(
+          curl_handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &size);
+    }
+    curl_easy_cleanup(curl_handle);
+    if (size < 0) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+    return size;
+  }
 
-      /* cleanup curl stuff */
-      curl_easy_cleanup(curl_handle);
+  size_t curlWrite(char *ptr, size_t size, size_t nmemb, void *sink) {
+    auto bytes = gsl::make_span(reinterpret_cast<const uint8_t *>(ptr),
+                                static_cast<ptrdiff_t>(size * nmemb));
+    // returning less than received aborts transfer
+    return (*static_cast<ParamFetcher::Sink *>(sink))(bytes) ? bytes.size()
+                                                             : 0;
+  }
 
-      curl_slist_free_all(chunk);
+  outcome::result<void> curlRange(const std::string &url,
+                                  uint64_t offset,
+                                  uint64_t size,
+                                  ParamFetcher::Sink sink) {
+    auto curl_handle = curlInit(url);
+    if (curl_handle == nullptr) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+    auto range =
+        std::to_string(offset) + "-" + std::to_string(offset + size - 1);
+    curl_easy_setopt(curl_handle, CURLOPT_RANGE, range.c_str());
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, curlWrite);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &sink);
+    auto code = curl_easy_perform(curl_handle);
+    long status{};
+    curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_cleanup(curl_handle);
+    if (code != CURLE_OK) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+    // whole file instead of range, only valid for range from start
+    if (status == 200 && offset != 0) {
+      return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+    }
+    return outcome::success();
+  }
 
-    } catch (std::exception const &e) {
-      logger_->error("Error: " + std::string(e.what()));
-      return ProofParamProviderError::FAILED_DOWNLOADING;
+  outcome::result<void> ProofParamProvider::doFetch(const std::string &out,
+                                                    const ParamFile &info) {
+    ParamFetcher fetcher{FetchConfig{getGateways()}, curlSize, curlRange};
+    OUTCOME_TRY(hash, fetcher.fetch(info.cid, out));
+    if (trustParams()) {
+      return outcome::success();
+    }
+    if (common::hex_lower(gsl::make_span(hash).subspan(0, 16))
+        != info.digest) {
+      boost::filesystem::remove(out);
+      return ProofParamProviderError::CHECKSUM_MISMATCH;
     }
     return outcome::success();
   }
@@ -119,30 +170,49 @@ namespace fc::proofs {
 
     curl_global_init(CURL_GLOBAL_ALL);
     errors_ = false;
-    std::vector<std::thread> threads;
+    ParamManifest manifest{
+        (boost::filesystem::path(getParamDir()) / manifest_name).string()};
+    std::vector<ParamFile> wanted;
     for (const auto &param_file : param_files) {
-      if (param_file.sector_size != storage_size) {
-        continue;
+      if (param_file.sector_size == storage_size) {
+        wanted.push_back(param_file);
       }
-
-      threads.emplace_back(std::thread{fetch, param_file});
     }
 
-    for (auto &th : threads) {
-      th.join();
+    if (!wanted.empty()) {
+      boost::asio::thread_pool pool{
+          std::min(wanted.size(), kParallelFetches)};
+      for (const auto &param_file : wanted) {
+        boost::asio::post(pool, [&param_file, &manifest] {
+          fetch(param_file, manifest);
+        });
+      }
+      pool.join();
     }
     curl_global_cleanup();
+    if (auto saved = manifest.save(); !saved) {
+      logger_->warn("cannot save verified params: "
+                    + saved.error().message());
+    }
 
     if (!errors_) return outcome::success();
 
     return ProofParamProviderError::FAILED_DOWNLOADING;
   }
 
+  std::shared_future<outcome::result<void>> ProofParamProvider::getParamsAsync(
+      std::vector<ParamFile> param_files, uint64_t storage_size) {
+    return std::async(std::launch::async,
+                      [param_files{std::move(param_files)},
+                       storage_size]() mutable {
+                        return getParams(param_files, storage_size);
+                      })
+        .share();
+  }
+
   outcome::result<void> checkFile(const std::string &path,
                                   const ParamFile &info) {
-    char *res = std::getenv("TRUST_PARAMS");
-    if (res != nullptr && std::strcmp(res, "1") == 0) {
-      // Assuming parameter files are ok. DO NOT USE IN PRODUCTION
+    if (trustParams()) {
       return outcome::success();
     }
 
@@ -160,40 +230,41 @@ namespace fc::proofs {
     return outcome::success();
   }
 
-  void ProofParamProvider::fetch(const ParamFile &info) {
+  void ProofParamProvider::fetch(const ParamFile &info,
+                                 ParamManifest &manifest) {
     auto path = boost::filesystem::path(getParamDir())
                 / boost::filesystem::path(info.name);
 
     logger_->info("Fetch " + info.name);
+    // unchanged file is not hashed again
+    if (manifest.verified(path.string(), info.digest)) {
+      logger_->info(info.name + " already verified");
+      return;
+    }
     auto res = checkFile(path.string(), info);
     if (!res.has_error()) {
+      if (!trustParams()) {
+        manifest.add(path.string(), info.digest);
+      }
       logger_->info(info.name + " already downloaded");
       return;
     }
+    manifest.remove(path.string());
     if (boost::filesystem::exists(path)) {
       logger_->warn(res.error().message());
     }
 
-    static std::mutex mutex;
-    std::lock_guard<std::mutex> lock(mutex);
-
+    // downloaded file is hashed while it is fetched
     auto fetch_res = doFetch(path.string(), info);
 
     if (fetch_res.has_error()) {
       errors_ = true;
-      logger_->error(res.error().message());
+      logger_->error(info.name + ": " + fetch_res.error().message());
 
       return;
     }
-
-    res = checkFile(path.string(), info);
-
-    if (res.has_error()) {
-      errors_ = true;
-      logger_->error(res.error().message());
-      boost::filesystem::remove(path);
-
-      return;
+    if (!trustParams()) {
+      manifest.add(path.string(), info.digest);
     }
 
     logger_->info(info.name + " downloaded successfully");
@@ -0,0 +1,143 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/proof_service.hpp"
+
+#include <boost/asio/post.hpp>
+
+namespace fc::proofs {
+  using common::LatencyHistogram;
+  using common::metrics::Gauge;
+  using common::metrics::registry;
+
+  bool ProofCall::cancel() {
+    auto state{state_.load()};
+    while (state == State::QUEUED || state == State::RUNNING) {
+      if (state_.compare_exchange_weak(state, State::CANCELLED)) {
+        on_cancel_();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  ProofCall::Clock::duration ProofCall::waited() const {
+    auto waited{waited_.load()};
+    if (waited < 0) {
+      return Clock::now() - queued_;
+    }
+    return Clock::duration{waited};
+  }
+
+  bool ProofCall::start() {
+    waited_ = (Clock::now() - queued_).count();
+    auto state{State::QUEUED};
+    return state_.compare_exchange_strong(state, State::RUNNING);
+  }
+
+  bool ProofCall::finish() {
+    auto state{State::RUNNING};
+    return state_.compare_exchange_strong(state, State::DONE);
+  }
+
+  struct ProofService::Queue {
+    Queue(size_t threads, const common::metrics::Labels &labels)
+        : pool{threads},
+          queued{registry().gauge("fc_proofs_queued_calls",
+                                  "Proof calls waiting for thread",
+                                  labels)},
+          wait{registry().histogram(
+              "fc_proofs_wait_seconds", "Time of proof call in queue", labels)},
+          run{registry().histogram(
+              "fc_proofs_run_seconds", "Time of proof call", labels)} {}
+
+    boost::asio::thread_pool pool;
+    Gauge &queued;
+    LatencyHistogram &wait;
+    LatencyHistogram &run;
+  };
+
+  ProofService::ProofService(const Limits &limits) {
+    for (auto operation : {ProofOperation::SEAL_PRE_COMMIT_1,
+                           ProofOperation::SEAL_PRE_COMMIT_2,
+                           ProofOperation::SEAL_COMMIT_1,
+                           ProofOperation::SEAL_COMMIT_2,
+                           ProofOperation::UNSEAL,
+                           ProofOperation::WINNING_POST,
+                           ProofOperation::WINDOW_POST,
+                           ProofOperation::VERIFY,
+                           ProofOperation::PIECE_CID}) {
+      auto limit{limits.find(operation)};
+      size_t threads{1};
+      if (limit != limits.end()) {
+        threads = std::max<size_t>(limit->second, 1);
+      }
+      queues_.emplace(operation,
+                      std::make_unique<Queue>(
+                          threads,
+                          common::metrics::Labels{
+                              {"operation", name(operation)}}));
+    }
+  }
+
+  ProofService::~ProofService() {
+    for (auto &queue : queues_) {
+      queue.second->pool.stop();
+    }
+    for (auto &queue : queues_) {
+      queue.second->pool.join();
+    }
+  }
+
+  const char *ProofService::name(ProofOperation operation) {
+    switch (operation) {
+      case ProofOperation::SEAL_PRE_COMMIT_1:
+        return "seal_pre_commit_1";
+      case ProofOperation::SEAL_PRE_COMMIT_2:
+        return "seal_pre_commit_2";
+      case ProofOperation::SEAL_COMMIT_1:
+        return "seal_commit_1";
+      case ProofOperation::SEAL_COMMIT_2:
+        return "seal_commit_2";
+      case ProofOperation::UNSEAL:
+        return "unseal";
+      case ProofOperation::WINNING_POST:
+        return "winning_post";
+      case ProofOperation::WINDOW_POST:
+        return "window_post";
+      case ProofOperation::VERIFY:
+        return "verify";
+      case ProofOperation::PIECE_CID:
+        return "piece_cid";
+    }
+    return "unknown";
+  }
+
+  void ProofService::post(ProofOperation operation,
+                          const std::shared_ptr<ProofCall> &handle,
+                          std::function<void()> run) {
+    auto &queue{*queues_.at(operation)};
+    queue.queued.add(1);
+    boost::asio::post(queue.pool,
+                      [&queue, handle, run{std::move(run)}] {
+                        queue.queued.add(-1);
+                        if (!handle->start()) {
+                          return;
+                        }
+                        queue.wait.record(handle->waited());
+                        common::metrics::Timer timer{queue.run};
+                        run();
+                      });
+  }
+}  // namespace fc::proofs
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::proofs, ProofServiceError, e) {
+  using E = fc::proofs::ProofServiceError;
+  switch (e) {
+    case E::CANCELLED:
+      return "ProofService: call was cancelled";
+  }
+  return "ProofService: unknown error";
+}
@@ -7,6 +7,8 @@
 
 #include <fcntl.h>
 #include <filecoin-ffi/filcrypto.h>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #include "common/ffi.hpp"
 #include "primitives/address/address.hpp"
@@ -426,6 +428,37 @@ namespace fc::proofs {
     return res_ptr->is_valid;
   }
 
+  namespace {
+    /// Applies verify to each of infos on up to threads threads
+    template <typename Info, typename Verify>
+    std::vector<outcome::result<bool>> verifyConcurrently(
+        gsl::span<const Info> infos, size_t threads, const Verify &verify) {
+      std::vector<outcome::result<bool>> results(infos.size(), false);
+      if (threads <= 1 || infos.size() <= 1) {
+        for (size_t i = 0; i < results.size(); ++i) {
+          results[i] = verify(infos[i]);
+        }
+        return results;
+      }
+      boost::asio::thread_pool pool{std::min<size_t>(threads, infos.size())};
+      for (size_t i = 0; i < results.size(); ++i) {
+        boost::asio::post(pool, [&, i] { results[i] = verify(infos[i]); });
+      }
+      pool.join();
+      return results;
+    }
+  }  // namespace
+
+  std::vector<outcome::result<bool>> Proofs::verifySeals(
+      gsl::span<const SealVerifyInfo> infos, size_t threads) {
+    return verifyConcurrently(infos, threads, &Proofs::verifySeal);
+  }
+
+  std::vector<outcome::result<bool>> Proofs::verifyWindowPoSts(
+      gsl::span<const WindowPoStVerifyInfo> infos, size_t threads) {
+    return verifyConcurrently(infos, threads, &Proofs::verifyWindowPoSt);
+  }
+
   // ******************
   // GENERATED FUNCTIONS
   // ******************
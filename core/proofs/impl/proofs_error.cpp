@@ -17,6 +17,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::proofs, ProofsError, e) {
       return "Proofs: No mapping to FFIRegisteredPoStProof";
     case (ProofsError::INVALID_POST_PROOF):
       return "Proofs: No mapping to RegisteredPoSt";
+    case (ProofsError::INVALID_CHALLENGE):
+      return "Proofs: challenged sector index out of range";
     default:
       return "Proofs: unknown error";
   }
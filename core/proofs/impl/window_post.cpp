@@ -0,0 +1,152 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/window_post.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <future>
+#include <map>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/filesystem/path.hpp>
+
+namespace fc::proofs {
+  using primitives::sector::getWindowPoStPartitionSectors;
+  using Clock = std::chrono::steady_clock;
+
+  namespace {
+    milliseconds since(Clock::time_point start) {
+      return std::chrono::duration_cast<milliseconds>(Clock::now() - start);
+    }
+
+    /// Opens file and reads its last byte, so unreadable media is detected
+    bool readable(const std::string &path) {
+      auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        return false;
+      }
+      struct stat st {};
+      uint8_t byte{};
+      auto ok = fstat(fd, &st) == 0 && st.st_size > 0
+                && pread(fd, &byte, 1, st.st_size - 1) == 1;
+      close(fd);
+      return ok;
+    }
+
+    /// Disk of file, unknown files share one
+    dev_t disk(const std::string &path) {
+      struct stat st {};
+      return stat(path.c_str(), &st) == 0 ? st.st_dev : 0;
+    }
+  }  // namespace
+
+  WindowPoStDriver::WindowPoStDriver(WindowPoStConfig config,
+                                     ProveFunction prove)
+      : prove_threads_{config.prove_threads},
+        prove_{prove ? std::move(prove) : Proofs::generateWindowPoSt},
+        logger_{common::createLogger("window post")} {
+    if (prove_threads_ == 0) {
+      auto devices = Proofs::getGPUDevices();
+      prove_threads_ = devices ? devices.value().size() : 0;
+    }
+    prove_threads_ = std::max<size_t>(prove_threads_, 1);
+  }
+
+  size_t WindowPoStDriver::proveThreads() const {
+    return prove_threads_;
+  }
+
+  bool WindowPoStDriver::checkSector(const PrivateSectorInfo &sector) {
+    boost::filesystem::path cache{sector.cache_dir_path};
+    return readable(sector.sealed_sector_path)
+           && readable((cache / "p_aux").string())
+           && readable((cache / "t_aux").string());
+  }
+
+  outcome::result<WindowPoStResult> WindowPoStDriver::generate(
+      ActorId miner_id,
+      gsl::span<const PrivateSectorInfo> sectors,
+      const PoStRandomness &randomness) const {
+    auto start = Clock::now();
+    WindowPoStResult result;
+    if (sectors.empty()) {
+      return result;
+    }
+    OUTCOME_TRY(partition_size,
+                getWindowPoStPartitionSectors(sectors[0].post_proof_type));
+
+    // char instead of bool, elements are written concurrently
+    std::vector<char> good(sectors.size());
+    std::map<dev_t, std::vector<size_t>> disks;
+    for (size_t i = 0; i < sectors.size(); ++i) {
+      disks[disk(sectors[i].sealed_sector_path)].push_back(i);
+    }
+    {
+      boost::asio::thread_pool pool{disks.size()};
+      for (const auto &device : disks) {
+        boost::asio::post(pool, [&, indices{&device.second}] {
+          for (auto i : *indices) {
+            good[i] = checkSector(sectors[i]);
+          }
+        });
+      }
+      pool.join();
+    }
+    result.check_time = since(start);
+
+    auto count = (sectors.size() + partition_size - 1) / partition_size;
+    result.partitions.resize(count);
+    std::vector<std::vector<PrivateSectorInfo>> proving(count);
+    for (size_t i = 0; i < sectors.size(); ++i) {
+      auto &partition = result.partitions[i / partition_size];
+      auto number = sectors[i].info.sector;
+      if (good[i]) {
+        partition.sectors.push_back(number);
+        proving[i / partition_size].push_back(sectors[i]);
+      } else {
+        logger_->warn("sector {} is faulty", number);
+        partition.faults.push_back(number);
+      }
+    }
+
+    boost::asio::thread_pool pool{std::min(prove_threads_, count)};
+    std::vector<std::future<outcome::result<void>>> proven;
+    for (size_t p = 0; p < count; ++p) {
+      if (proving[p].empty()) {
+        continue;
+      }
+      auto task = std::make_shared<std::packaged_task<outcome::result<void>()>>(
+          [&, p]() -> outcome::result<void> {
+            auto prove_start = Clock::now();
+            auto &partition = result.partitions[p];
+            OUTCOME_TRYA(partition.proofs,
+                         prove_(miner_id,
+                                Proofs::newSortedPrivateSectorInfo(proving[p]),
+                                randomness));
+            partition.prove_time = since(prove_start);
+            logger_->info("partition {} of {} sectors proven in {} ms",
+                          p,
+                          partition.sectors.size(),
+                          partition.prove_time.count());
+            return outcome::success();
+          });
+      proven.push_back(task->get_future());
+      boost::asio::post(pool, [task] { (*task)(); });
+    }
+    for (auto &partition : proven) {
+      OUTCOME_TRY(partition.get());
+    }
+
+    result.total_time = since(start);
+    logger_->info("{} partitions, checked in {} ms, done in {} ms",
+                  count,
+                  result.check_time.count(),
+                  result.total_time.count());
+    return result;
+  }
+}  // namespace fc::proofs
@@ -0,0 +1,150 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/winning_post.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+
+#include "proofs/proofs_error.hpp"
+
+namespace fc::proofs {
+  namespace fs = boost::filesystem;
+  using Clock = std::chrono::steady_clock;
+
+  namespace {
+    /// Cache files read by winning PoSt
+    bool isProvingFile(const std::string &name) {
+      return name == "p_aux" || name == "t_aux"
+             || name.find("tree-r-last") != std::string::npos;
+    }
+
+    std::vector<SectorNumber> sectorNumbers(
+        gsl::span<const PrivateSectorInfo> sectors) {
+      std::vector<SectorNumber> numbers;
+      numbers.reserve(sectors.size());
+      for (const auto &sector : sectors) {
+        numbers.push_back(sector.info.sector);
+      }
+      return numbers;
+    }
+  }  // namespace
+
+  WinningPoStDriver::WinningPoStDriver(ChallengeFunction challenge,
+                                       ProveFunction prove)
+      : challenge_{challenge ? std::move(challenge)
+                             : Proofs::generateWinningPoStSectorChallenge},
+        prove_{prove ? std::move(prove) : Proofs::generateWinningPoSt},
+        logger_{common::createLogger("winning post")} {}
+
+  uint64_t WinningPoStDriver::prefetchSector(const PrivateSectorInfo &sector) {
+    uint64_t bytes{};
+    boost::system::error_code ec;
+    for (fs::directory_iterator it{sector.cache_dir_path, ec}, end;
+         !ec && it != end;
+         it.increment(ec)) {
+      if (!isProvingFile(it->path().filename().string())) {
+        continue;
+      }
+      auto fd = open(it->path().c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        continue;
+      }
+      auto size = lseek(fd, 0, SEEK_END);
+      if (size > 0 && posix_fadvise(fd, 0, size, POSIX_FADV_WILLNEED) == 0) {
+        bytes += size;
+      }
+      close(fd);
+    }
+    return bytes;
+  }
+
+  outcome::result<WinningPoStDriver::Prepared> WinningPoStDriver::challenge(
+      ActorId miner_id,
+      gsl::span<const PrivateSectorInfo> eligible,
+      const PoStRandomness &randomness) const {
+    Prepared prepared{miner_id, randomness, sectorNumbers(eligible), {}};
+    if (eligible.empty()) {
+      return prepared;
+    }
+    OUTCOME_TRY(indices,
+                challenge_(eligible[0].post_proof_type,
+                           miner_id,
+                           randomness,
+                           eligible.size()));
+    for (auto index : indices) {
+      if (index >= static_cast<uint64_t>(eligible.size())) {
+        return ProofsError::INVALID_CHALLENGE;
+      }
+      prepared.challenged.push_back(eligible[index]);
+    }
+    return prepared;
+  }
+
+  outcome::result<void> WinningPoStDriver::prepare(
+      ActorId miner_id,
+      gsl::span<const PrivateSectorInfo> eligible,
+      const PoStRandomness &randomness) {
+    OUTCOME_TRY(prepared, challenge(miner_id, eligible, randomness));
+    uint64_t bytes{};
+    for (const auto &sector : prepared.challenged) {
+      bytes += prefetchSector(sector);
+    }
+    logger_->debug("prepared {} challenged sectors, prefetching {} bytes",
+                   prepared.challenged.size(),
+                   bytes);
+    std::lock_guard lock{mutex_};
+    prepared_ = std::move(prepared);
+    return outcome::success();
+  }
+
+  outcome::result<std::vector<PoStProof>> WinningPoStDriver::generate(
+      ActorId miner_id,
+      gsl::span<const PrivateSectorInfo> eligible,
+      const PoStRandomness &randomness) {
+    auto start = Clock::now();
+    boost::optional<Prepared> prepared;
+    {
+      std::lock_guard lock{mutex_};
+      if (prepared_ && prepared_->miner_id == miner_id
+          && prepared_->randomness == randomness
+          && prepared_->eligible == sectorNumbers(eligible)) {
+        prepared = std::move(prepared_);
+        prepared_.reset();
+      }
+    }
+    auto was_prepared = prepared.has_value();
+    if (!prepared) {
+      OUTCOME_TRYA(prepared, challenge(miner_id, eligible, randomness));
+    }
+
+    OUTCOME_TRY(proofs,
+                prove_(miner_id,
+                       Proofs::newSortedPrivateSectorInfo(prepared->challenged),
+                       randomness));
+
+    auto latency =
+        std::chrono::duration_cast<milliseconds>(Clock::now() - start);
+    logger_->info("winning PoSt generated in {} ms, challenge {}",
+                  latency.count(),
+                  was_prepared ? "prepared" : "computed");
+    std::lock_guard lock{mutex_};
+    ++stats_.proofs;
+    if (was_prepared) {
+      ++stats_.prepared;
+    }
+    stats_.last_latency = latency;
+    stats_.max_latency = std::max(stats_.max_latency, latency);
+    stats_.total_latency += latency;
+    return proofs;
+  }
+
+  WinningPoStStats WinningPoStDriver::stats() const {
+    std::lock_guard lock{mutex_};
+    return stats_;
+  }
+}  // namespace fc::proofs
@@ -0,0 +1,79 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PROOFS_NATIVE_PROOFS_HPP
+#define CPP_FILECOIN_CORE_PROOFS_NATIVE_PROOFS_HPP
+
+#include "primitives/cid/comm_cid.hpp"
+#include "primitives/piece/piece.hpp"
+#include "primitives/piece/piece_data.hpp"
+#include "primitives/sector/sector.hpp"
+#include "proofs/proofs.hpp"
+
+namespace fc::proofs {
+  using common::Comm;
+  using primitives::piece::PaddedPieceSize;
+  using primitives::piece::PieceData;
+  using primitives::piece::PieceInfo;
+  using primitives::piece::UnpaddedPieceSize;
+  using primitives::sector::RegisteredProof;
+
+  /**
+   * Piece and unsealed sector commitments computed without FFI, results are
+   * equal to Proofs ones. Subtrees of piece are hashed in parallel.
+   */
+  class NativeProofs {
+   public:
+    /// Padded bytes of subtree hashed by one task
+    static constexpr uint64_t kSubtreeSize{1 << 20};
+
+    /**
+     * @brief computes commitment of data zero padded to piece size
+     * @param data - piece bytes, not larger than piece size
+     * @param piece_size - unpadded piece size
+     * @param threads - threads hashing subtrees, zero to hash in caller
+     */
+    static outcome::result<Comm> pieceCommitment(gsl::span<const uint8_t> data,
+                                                 UnpaddedPieceSize piece_size,
+                                                 size_t threads);
+
+    /// Produces piece CID like Proofs::generatePieceCID, using all cores
+    static outcome::result<CID> generatePieceCID(
+        gsl::span<const uint8_t> data, UnpaddedPieceSize piece_size);
+
+    /**
+     * @brief produces piece CID of file prefix like
+     * Proofs::generatePieceCIDFromFile, file is mapped and not copied
+     */
+    static outcome::result<CID> generatePieceCIDFromFile(
+        const std::string &piece_file_path, UnpaddedPieceSize piece_size);
+
+    /**
+     * @brief writes piece to staged sector like Proofs::writeWithAlignment,
+     * as pipeline: piece is read in subtree chunks, chunks are fr32 padded
+     * and hashed in parallel and written at their offsets.
+     * Piece is written by positioned writes after existing pieces, so pieces
+     * of one sector with known offsets may be written concurrently.
+     * @param existing_piece_sizes - pieces before this one
+     * @param threads - threads padding and hashing chunks
+     */
+    static outcome::result<WriteWithAlignmentResult> writeWithAlignment(
+        RegisteredProof proof_type,
+        const PieceData &piece_data,
+        UnpaddedPieceSize piece_bytes,
+        const std::string &staged_sector_file_path,
+        gsl::span<const UnpaddedPieceSize> existing_piece_sizes,
+        size_t threads);
+
+    /**
+     * @brief produces unsealed CID like Proofs::generateUnsealedCID, pieces
+     * are aligned to their sizes and sector is zero padded
+     */
+    static outcome::result<CID> generateUnsealedCID(
+        RegisteredProof proof_type, gsl::span<const PieceInfo> pieces);
+  };
+}  // namespace fc::proofs
+
+#endif  // CPP_FILECOIN_CORE_PROOFS_NATIVE_PROOFS_HPP
@@ -0,0 +1,71 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PROOFS_PARAM_FETCHER_HPP
+#define CPP_FILECOIN_CORE_PROOFS_PARAM_FETCHER_HPP
+
+#include <atomic>
+#include <functional>
+
+#include "common/logger.hpp"
+#include "common/outcome.hpp"
+#include "crypto/blake2/blake2b160.hpp"
+
+namespace fc::proofs {
+  using crypto::blake2b::Blake2b512Hash;
+
+  struct FetchConfig {
+    /// Gateway urls, cid is appended, tried in order on failure
+    std::vector<std::string> gateways;
+    /// Ranges of one file downloaded at once
+    size_t connections{4};
+    uint64_t chunk_size{64 << 20};
+    /// Rounds over all gateways for one chunk
+    size_t retries{3};
+  };
+
+  /**
+   * Downloads file by ranged requests in parallel. Chunks are written into
+   * ".part" file, indices of written chunks are appended to ".part.journal",
+   * so interrupted download continues from written chunks. File is hashed
+   * while it is downloaded, chunks are hashed in order as soon as they are
+   * written.
+   */
+  class ParamFetcher {
+   public:
+    /// Receives bytes of range, returns false to abort request
+    using Sink = std::function<bool(gsl::span<const uint8_t>)>;
+    /// Returns size of file at url
+    using SizeFunction =
+        std::function<outcome::result<uint64_t>(const std::string &url)>;
+    /// Requests range of file at url, passes received bytes to sink
+    using RangeFunction = std::function<outcome::result<void>(
+        const std::string &url, uint64_t offset, uint64_t size, Sink sink)>;
+
+    ParamFetcher(FetchConfig config, SizeFunction size, RangeFunction range);
+
+    /**
+     * @brief downloads file with cid to path, resumes previous download
+     * @return blake2b-512 of file
+     */
+    outcome::result<Blake2b512Hash> fetch(const std::string &cid,
+                                          const std::string &path);
+
+   private:
+    outcome::result<void> fetchChunk(const std::string &cid,
+                                     int fd,
+                                     uint64_t offset,
+                                     uint64_t size);
+
+    FetchConfig config_;
+    SizeFunction size_;
+    RangeFunction range_;
+    /// Gateway which answered last
+    std::atomic_size_t gateway_{};
+    common::Logger logger_;
+  };
+}  // namespace fc::proofs
+
+#endif  // CPP_FILECOIN_CORE_PROOFS_PARAM_FETCHER_HPP
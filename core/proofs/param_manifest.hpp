@@ -0,0 +1,62 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PROOFS_PARAM_MANIFEST_HPP
+#define CPP_FILECOIN_CORE_PROOFS_PARAM_MANIFEST_HPP
+
+#include <map>
+#include <mutex>
+
+#include "common/outcome.hpp"
+
+namespace fc::proofs {
+  /// File metadata recorded when digest of file was verified
+  struct ParamStamp {
+    uint64_t size{};
+    int64_t mtime_ns{};
+    uint64_t inode{};
+    std::string digest;
+  };
+
+  inline bool operator==(const ParamStamp &lhs, const ParamStamp &rhs) {
+    return lhs.size == rhs.size && lhs.mtime_ns == rhs.mtime_ns
+           && lhs.inode == rhs.inode && lhs.digest == rhs.digest;
+  }
+
+  /**
+   * Verified param files, stored as json next to them. File is trusted
+   * without hashing while its size, mtime and inode are same as recorded
+   * with expected digest. Methods are thread-safe.
+   */
+  class ParamManifest {
+   public:
+    /// Loads manifest, missing or malformed manifest is empty
+    explicit ParamManifest(std::string path);
+
+    /// Metadata of file with given digest
+    static outcome::result<ParamStamp> stamp(const std::string &file,
+                                             const std::string &digest);
+
+    /// Whether file was verified with digest and is unchanged since
+    bool verified(const std::string &file, const std::string &digest) const;
+
+    /// Records file as verified with digest
+    void add(const std::string &file, const std::string &digest);
+
+    /// Forgets file, e.g. when it is removed or failed check
+    void remove(const std::string &file);
+
+    /// Writes manifest, replacing previous one atomically
+    outcome::result<void> save() const;
+
+   private:
+    std::string path_;
+    mutable std::mutex mutex_;
+    /// Stamps by file path
+    std::map<std::string, ParamStamp> stamps_;
+  };
+}  // namespace fc::proofs
+
+#endif  // CPP_FILECOIN_CORE_PROOFS_PARAM_MANIFEST_HPP
@@ -6,9 +6,13 @@
 #ifndef CPP_FILECOIN_PROOF_PARAM_PROVIDER_HPP
 #define CPP_FILECOIN_PROOF_PARAM_PROVIDER_HPP
 
+#include <atomic>
+#include <future>
+
 #include "common/logger.hpp"
 #include "common/outcome.hpp"
 #include "gsl/span"
+#include "proofs/param_manifest.hpp"
 #include "proofs/proof_param_provider_error.hpp"
 #include "proof_param_provider_error.hpp"
 
@@ -26,15 +30,23 @@ namespace fc::proofs {
     static outcome::result<void> getParams(
         const gsl::span<ParamFile> &param_files, uint64_t storage_size);
 
+    /**
+     * @brief checks and fetches params on other thread, so caller continues
+     * startup and waits for result only before it needs params
+     * @return result of getParams
+     */
+    static std::shared_future<outcome::result<void>> getParamsAsync(
+        std::vector<ParamFile> param_files, uint64_t storage_size);
+
     static outcome::result<std::vector<ParamFile>> readJson(
         const std::string &path);
 
    private:
-    static void fetch(const ParamFile &info);
+    static void fetch(const ParamFile &info, ParamManifest &manifest);
     static outcome::result<void> doFetch(const std::string &out,
                                          const ParamFile &info);
 
-    static bool errors_;
+    static std::atomic_bool errors_;
 
     static common::Logger logger_;
   };
@@ -0,0 +1,137 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PROOFS_PROOF_SERVICE_HPP
+#define CPP_FILECOIN_CORE_PROOFS_PROOF_SERVICE_HPP
+
+#include <atomic>
+#include <boost/asio/thread_pool.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+
+#include "common/metrics.hpp"
+#include "common/outcome.hpp"
+
+namespace fc::proofs {
+  /// Kinds of proof calls, each kind has own threads
+  enum class ProofOperation {
+    SEAL_PRE_COMMIT_1,
+    SEAL_PRE_COMMIT_2,
+    SEAL_COMMIT_1,
+    SEAL_COMMIT_2,
+    UNSEAL,
+    WINNING_POST,
+    WINDOW_POST,
+    VERIFY,
+    PIECE_CID,
+  };
+
+  enum class ProofServiceError { CANCELLED = 1 };
+
+  /// Handle of call queued to proof service
+  class ProofCall {
+   public:
+    using Clock = common::LatencyHistogram::Clock;
+
+    enum class State { QUEUED, RUNNING, DONE, CANCELLED };
+
+    State state() const {
+      return state_;
+    }
+
+    /**
+     * Cancels call, callback gets CANCELLED at once. Queued call doesn't
+     * start. FFI call can't be interrupted, so running call completes on
+     * its thread and its result is dropped.
+     * @return false if call was already done or cancelled
+     */
+    bool cancel();
+
+    /// Time in queue, or until now if call didn't start
+    Clock::duration waited() const;
+
+   private:
+    friend class ProofService;
+
+    /// Transition to RUNNING, false if cancelled
+    bool start();
+
+    /// Transition to DONE, false if cancelled
+    bool finish();
+
+    std::atomic<State> state_{State::QUEUED};
+    Clock::time_point queued_{Clock::now()};
+    std::atomic<Clock::rep> waited_{-1};
+    std::function<void()> on_cancel_;
+  };
+
+  /**
+   * Runs blocking proof calls, e.g. Proofs::sealPreCommitPhase1, on
+   * dedicated threads and reports results to callbacks, so callers like
+   * asio threads are not blocked for minutes. Number of concurrent calls
+   * is limited per operation kind, further calls wait in queue.
+   * Metrics, labeled with operation:
+   *   fc_proofs_queued_calls - calls waiting in queue,
+   *   fc_proofs_wait_seconds - time in queue,
+   *   fc_proofs_run_seconds - time of call.
+   */
+  class ProofService {
+   public:
+    /// Concurrent calls by operation, missing operations allow one
+    using Limits = std::map<ProofOperation, size_t>;
+
+    explicit ProofService(const Limits &limits = {});
+
+    /// Waits for running calls, callbacks of queued calls are not called
+    ~ProofService();
+
+    ProofService(const ProofService &) = delete;
+    ProofService &operator=(const ProofService &) = delete;
+
+    /**
+     * @brief queues call
+     * @param operation - kind of call, selects its threads
+     * @param call - blocking call, e.g. lambda calling Proofs
+     * @param callback - called once with result on proof thread, or with
+     * CANCELLED on thread which cancelled call
+     * @return handle to cancel call
+     */
+    template <typename T>
+    std::shared_ptr<ProofCall> run(
+        ProofOperation operation,
+        std::function<outcome::result<T>()> call,
+        std::function<void(outcome::result<T>)> callback) {
+      auto handle{std::make_shared<ProofCall>()};
+      handle->on_cancel_ = [callback] {
+        callback(ProofServiceError::CANCELLED);
+      };
+      post(operation,
+           handle,
+           [handle, call{std::move(call)}, callback{std::move(callback)}] {
+             auto result{call()};
+             if (handle->finish()) {
+               callback(std::move(result));
+             }
+           });
+      return handle;
+    }
+
+    static const char *name(ProofOperation operation);
+
+   private:
+    struct Queue;
+
+    void post(ProofOperation operation,
+              const std::shared_ptr<ProofCall> &handle,
+              std::function<void()> run);
+
+    std::map<ProofOperation, std::unique_ptr<Queue>> queues_;
+  };
+}  // namespace fc::proofs
+
+OUTCOME_HPP_DECLARE_ERROR(fc::proofs, ProofServiceError);
+
+#endif  // CPP_FILECOIN_CORE_PROOFS_PROOF_SERVICE_HPP
@@ -23,7 +23,7 @@ namespace fc::proofs {
 
   using Devices = std::vector<std::string>;
   using Phase1Output = std::vector<uint8_t>;
-  using ChallengeIndexes = std::vector<uint8_t>;
+  using ChallengeIndexes = std::vector<uint64_t>;
   using fc::primitives::sector::RegisteredProof;
   using primitives::ActorId;
   using primitives::SectorNumber;
@@ -188,12 +188,29 @@ namespace fc::proofs {
     static outcome::result<bool> verifyWindowPoSt(
         const WindowPoStVerifyInfo &info);
 
+    /**
+     * @brief verifies window PoSts concurrently, results are same as
+     * verifyWindowPoSt
+     * @param threads - proofs verified at once
+     * @return results in order of infos
+     */
+    static std::vector<outcome::result<bool>> verifyWindowPoSts(
+        gsl::span<const WindowPoStVerifyInfo> infos, size_t threads);
+
     /**
      * VerifySeal returns true if the sealing operation from which its inputs
      * were derived was valid, and false if not.
      */
     static outcome::result<bool> verifySeal(const SealVerifyInfo &info);
 
+    /**
+     * @brief verifies seals concurrently, results are same as verifySeal
+     * @param threads - seals verified at once
+     * @return results in order of infos
+     */
+    static std::vector<outcome::result<bool>> verifySeals(
+        gsl::span<const SealVerifyInfo> infos, size_t threads);
+
     /**
      * Unseals sector
      */
@@ -18,6 +18,7 @@ namespace fc::proofs {
     NO_SUCH_SEAL_PROOF,
     NO_SUCH_POST_PROOF,
     INVALID_POST_PROOF,
+    INVALID_CHALLENGE,
     UNKNOWN = 1000
   };
 
@@ -0,0 +1,82 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PROOFS_WINDOW_POST_HPP
+#define CPP_FILECOIN_CORE_PROOFS_WINDOW_POST_HPP
+
+#include <chrono>
+#include <functional>
+
+#include "proofs/proofs.hpp"
+
+namespace fc::proofs {
+  using std::chrono::milliseconds;
+
+  struct WindowPoStConfig {
+    /// Partitions proven at once, zero for number of GPUs
+    size_t prove_threads{0};
+  };
+
+  /// Window PoSt of one partition
+  struct PartitionPoSt {
+    /// Sectors proven
+    std::vector<SectorNumber> sectors;
+    /// Sectors skipped because their files are missing or unreadable
+    std::vector<SectorNumber> faults;
+    /// Empty if all sectors are faulty
+    std::vector<PoStProof> proofs;
+    milliseconds prove_time{};
+  };
+
+  struct WindowPoStResult {
+    std::vector<PartitionPoSt> partitions;
+    /// Time spent checking sector files
+    milliseconds check_time{};
+    milliseconds total_time{};
+  };
+
+  /**
+   * Generates window PoSt partition by partition instead of one FFI call over
+   * whole proving set. Sector files are checked concurrently, one thread per
+   * disk, faulty sectors are skipped instead of failing whole proof.
+   * Partitions are proven concurrently, GPU access is arbitrated by proofs
+   * library.
+   */
+  class WindowPoStDriver {
+   public:
+    using ProveFunction = std::function<outcome::result<std::vector<PoStProof>>(
+        ActorId, const SortedPrivateSectorInfo &, const PoStRandomness &)>;
+
+    /**
+     * @param config - proving concurrency
+     * @param prove - proves one partition, Proofs::generateWindowPoSt by
+     * default
+     */
+    explicit WindowPoStDriver(WindowPoStConfig config = {},
+                              ProveFunction prove = {});
+
+    /**
+     * @brief generates proofs of sectors split into partitions of
+     * getWindowPoStPartitionSectors size in given order
+     * @param sectors - sectors of deadline, same PoSt proof type
+     */
+    outcome::result<WindowPoStResult> generate(
+        ActorId miner_id,
+        gsl::span<const PrivateSectorInfo> sectors,
+        const PoStRandomness &randomness) const;
+
+    /// Checks sealed sector and its cache are readable
+    static bool checkSector(const PrivateSectorInfo &sector);
+
+    size_t proveThreads() const;
+
+   private:
+    size_t prove_threads_;
+    ProveFunction prove_;
+    common::Logger logger_;
+  };
+}  // namespace fc::proofs
+
+#endif  // CPP_FILECOIN_CORE_PROOFS_WINDOW_POST_HPP
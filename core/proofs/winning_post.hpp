@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_PROOFS_WINNING_POST_HPP
+#define CPP_FILECOIN_CORE_PROOFS_WINNING_POST_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+#include <boost/optional.hpp>
+
+#include "proofs/proofs.hpp"
+
+namespace fc::proofs {
+  using std::chrono::milliseconds;
+
+  /// Winning PoSt latency counters
+  struct WinningPoStStats {
+    uint64_t proofs{};
+    /// Proofs which used challenge prepared ahead
+    uint64_t prepared{};
+    /// Time from generate call to proof
+    milliseconds last_latency{};
+    milliseconds max_latency{};
+    milliseconds total_latency{};
+  };
+
+  /**
+   * Winning PoSt with challenge computed ahead. Challenge only depends on
+   * randomness, so it is computed and challenged sector files are read into
+   * page cache as soon as randomness is known, before election result. After
+   * winning only proof is generated.
+   */
+  class WinningPoStDriver {
+   public:
+    using ChallengeFunction = std::function<outcome::result<ChallengeIndexes>(
+        RegisteredProof, ActorId, const PoStRandomness &, uint64_t)>;
+    using ProveFunction = std::function<outcome::result<std::vector<PoStProof>>(
+        ActorId, const SortedPrivateSectorInfo &, const PoStRandomness &)>;
+
+    /**
+     * @param challenge - Proofs::generateWinningPoStSectorChallenge by default
+     * @param prove - Proofs::generateWinningPoSt by default
+     */
+    explicit WinningPoStDriver(ChallengeFunction challenge = {},
+                               ProveFunction prove = {});
+
+    /**
+     * @brief computes challenge and prefetches challenged sectors, replaces
+     * previously prepared challenge
+     * @param eligible - sorted sectors eligible for proving
+     */
+    outcome::result<void> prepare(ActorId miner_id,
+                                  gsl::span<const PrivateSectorInfo> eligible,
+                                  const PoStRandomness &randomness);
+
+    /**
+     * @brief generates proof of challenged sectors, uses prepared challenge
+     * if it was prepared for same miner, sectors and randomness
+     */
+    outcome::result<std::vector<PoStProof>> generate(
+        ActorId miner_id,
+        gsl::span<const PrivateSectorInfo> eligible,
+        const PoStRandomness &randomness);
+
+    WinningPoStStats stats() const;
+
+    /**
+     * @brief asks kernel to read p_aux, t_aux and tree_r_last files of sector
+     * cache, does not wait for read
+     * @return bytes prefetched
+     */
+    static uint64_t prefetchSector(const PrivateSectorInfo &sector);
+
+   private:
+    struct Prepared {
+      ActorId miner_id;
+      PoStRandomness randomness;
+      std::vector<SectorNumber> eligible;
+      std::vector<PrivateSectorInfo> challenged;
+    };
+
+    outcome::result<Prepared> challenge(
+        ActorId miner_id,
+        gsl::span<const PrivateSectorInfo> eligible,
+        const PoStRandomness &randomness) const;
+
+    ChallengeFunction challenge_;
+    ProveFunction prove_;
+    mutable std::mutex mutex_;
+    boost::optional<Prepared> prepared_;
+    WinningPoStStats stats_;
+    common::Logger logger_;
+  };
+}  // namespace fc::proofs
+
+#endif  // CPP_FILECOIN_CORE_PROOFS_WINNING_POST_HPP
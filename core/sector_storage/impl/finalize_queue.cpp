@@ -0,0 +1,154 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/finalize_queue.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <boost/asio/post.hpp>
+#include <boost/filesystem.hpp>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+namespace fc::sector_storage {
+  namespace fs = boost::filesystem;
+  using Clock = std::chrono::steady_clock;
+
+  namespace {
+    /// Bytes of files in directory, 0 if it is missing
+    uint64_t directorySize(const std::string &path) {
+      uint64_t size = 0;
+      boost::system::error_code ec;
+      for (fs::recursive_directory_iterator it{path, ec}, end; !ec && it != end;
+           it.increment(ec)) {
+        if (fs::is_regular_file(it->status())) {
+          auto file_size = fs::file_size(it->path(), ec);
+          if (!ec) {
+            size += file_size;
+          }
+        }
+      }
+      return size;
+    }
+  }  // namespace
+
+  FinalizeQueue::FinalizeQueue(FinalizeQueueConfig config,
+                               ReclaimedFn on_reclaimed)
+      : config_{config},
+        on_reclaimed_{std::move(on_reclaimed)},
+        queued_metric_{common::metrics::registry().gauge(
+            "fc_finalize_queued_sectors",
+            "Sectors waiting or being finalized")},
+        reclaimed_metric_{common::metrics::registry().counter(
+            "fc_finalize_reclaimed_bytes",
+            "Bytes freed in cache directories of finalized sectors")},
+        logger_{common::createLogger("finalize_queue")},
+        pool_{std::max<size_t>(config.threads, 1)} {
+    if (config_.trim_chunk == 0) {
+      config_.trim_chunk = FinalizeQueueConfig{}.trim_chunk;
+    }
+  }
+
+  FinalizeQueue::~FinalizeQueue() {
+    pool_.join();
+  }
+
+  void FinalizeQueue::push(const SectorId &sector,
+                           std::string cache,
+                           Job job,
+                           Callback callback) {
+    ++queued_;
+    queued_metric_.add(1);
+    boost::asio::post(pool_,
+                      [this,
+                       sector,
+                       cache{std::move(cache)},
+                       job{std::move(job)},
+                       callback{std::move(callback)}] {
+                        auto before = directorySize(cache);
+                        trimLayers(cache);
+                        auto result = job();
+                        --queued_;
+                        queued_metric_.add(-1);
+                        if (!result) {
+                          logger_->error("finalize sector {}: {}",
+                                         sector.sector,
+                                         result.error().message());
+                          if (callback) {
+                            callback(result.error());
+                          }
+                          return;
+                        }
+                        auto after = directorySize(cache);
+                        auto reclaimed = before > after ? before - after : 0;
+                        reclaimed_metric_.add(reclaimed);
+                        if (on_reclaimed_) {
+                          on_reclaimed_(reclaimed);
+                        }
+                        if (callback) {
+                          callback(reclaimed);
+                        }
+                      });
+  }
+
+  size_t FinalizeQueue::queued() const {
+    return queued_;
+  }
+
+  void FinalizeQueue::trimLayers(const std::string &cache) {
+    auto dir = open(cache.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir < 0) {
+      // missing cache is reported by job
+      return;
+    }
+    boost::system::error_code ec;
+    for (fs::directory_iterator it{cache, ec}, end; !ec && it != end;
+         it.increment(ec)) {
+      auto name = it->path().filename().string();
+      if (name.rfind(kLayerPrefix, 0) != 0) {
+        continue;
+      }
+      auto fd = openat(dir, name.c_str(), O_WRONLY);
+      if (fd < 0) {
+        continue;
+      }
+      struct stat stat {};
+      if (fstat(fd, &stat) == 0 && S_ISREG(stat.st_mode)) {
+        for (uint64_t size = stat.st_size; size != 0;) {
+          auto step = std::min(size, config_.trim_chunk);
+          pace(step);
+          size -= step;
+          if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            logger_->warn("trim {}/{}: {}", cache, name, strerror(errno));
+            break;
+          }
+        }
+      }
+      close(fd);
+    }
+    close(dir);
+  }
+
+  void FinalizeQueue::pace(uint64_t bytes) {
+    if (config_.trim_bytes_per_second == 0) {
+      return;
+    }
+    Clock::time_point slot;
+    {
+      std::lock_guard lock{pace_mutex_};
+      // unused budget of idle queue is not saved up
+      slot = std::max(next_trim_, Clock::now());
+      next_trim_ = slot
+                   + std::chrono::duration_cast<Clock::duration>(
+                       std::chrono::duration<double>(
+                           static_cast<double>(bytes)
+                           / config_.trim_bytes_per_second));
+    }
+    std::this_thread::sleep_until(slot);
+  }
+}  // namespace fc::sector_storage
@@ -0,0 +1,101 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_FINALIZE_QUEUE_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_FINALIZE_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include "common/logger.hpp"
+#include "common/metrics.hpp"
+#include "primitives/sector/sector.hpp"
+
+namespace fc::sector_storage {
+  using primitives::sector::SectorId;
+
+  struct FinalizeQueueConfig {
+    /// Sectors finalized at once
+    size_t threads{1};
+    /// Bytes of cache layers freed per second by trimming, 0 is unlimited
+    uint64_t trim_bytes_per_second{uint64_t{1} << 30};
+    /// Layers are truncated by this step, so one syscall frees bounded
+    /// number of extents
+    uint64_t trim_chunk{uint64_t{256} << 20};
+  };
+
+  /**
+   * Finalizes sectors on own threads after sealing, so caller and sealing
+   * worker are not held while tens of GiB of cache layers are deleted and
+   * sector files are moved. Layer files are trimmed before finalize job
+   * removes them: truncated step by step at configured rate, opened
+   * relative to cache directory, so filesystem frees extents gradually and
+   * unlink of layer is cheap. Reclaimed space is difference of cache sizes
+   * before and after job, reported to callback and to index through
+   * on_reclaimed, e.g. storage heartbeat.
+   * Metrics:
+   *   fc_finalize_queued_sectors - sectors waiting or being finalized,
+   *   fc_finalize_reclaimed_bytes - bytes freed in cache directories.
+   */
+  class FinalizeQueue {
+   public:
+    /// Finalizes sector, e.g. clears cache and moves files to storage
+    using Job = std::function<outcome::result<void>()>;
+    /// Called on queue thread with reclaimed bytes or error of job
+    using Callback = std::function<void(outcome::result<uint64_t>)>;
+    /// Called after each finalized sector, e.g. to report storage health
+    using ReclaimedFn = std::function<void(uint64_t reclaimed)>;
+
+    /// Prefix of cache layer files, layers are deleted by finalize
+    static constexpr auto kLayerPrefix{"sc-02-data-layer-"};
+
+    explicit FinalizeQueue(FinalizeQueueConfig config = {},
+                           ReclaimedFn on_reclaimed = {});
+
+    /// Finishes queued sectors
+    ~FinalizeQueue();
+
+    FinalizeQueue(const FinalizeQueue &) = delete;
+    FinalizeQueue &operator=(const FinalizeQueue &) = delete;
+
+    /**
+     * @brief queues finalize of sector and returns
+     * @param cache - cache directory of sector, its layers are trimmed
+     * before job
+     * @param callback - optional, called when sector is finalized
+     */
+    void push(const SectorId &sector,
+              std::string cache,
+              Job job,
+              Callback callback = {});
+
+    /// Sectors waiting or being finalized
+    size_t queued() const;
+
+   private:
+    /// Truncates layers of cache directory within rate
+    void trimLayers(const std::string &cache);
+
+    /// Waits until trimmed bytes fit into rate
+    void pace(uint64_t bytes);
+
+    FinalizeQueueConfig config_;
+    ReclaimedFn on_reclaimed_;
+    std::atomic<size_t> queued_{};
+    /// Rate is shared by threads, time when next step may be trimmed
+    std::mutex pace_mutex_;
+    std::chrono::steady_clock::time_point next_trim_;
+    common::metrics::Gauge &queued_metric_;
+    common::metrics::Counter &reclaimed_metric_;
+    common::Logger logger_;
+    boost::asio::thread_pool pool_;
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_FINALIZE_QUEUE_HPP
@@ -0,0 +1,174 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/local_worker.hpp"
+
+#include <boost/asio/ip/host_name.hpp>
+
+#include "sector_storage/sector_storage_error.hpp"
+
+namespace fc::sector_storage {
+  using primitives::piece::PaddedPieceSize;
+  using primitives::sector::getSectorSize;
+  using proofs = fc::proofs::Proofs;
+  namespace fs = boost::filesystem;
+
+  LocalWorker::LocalWorker(const std::string &root_path,
+                           RegisteredProof seal_proof,
+                           std::set<TaskType> tasks,
+                           std::shared_ptr<stores::Store> store)
+      : root_{root_path},
+        seal_proof_{seal_proof},
+        size_{0},
+        tasks_{std::move(tasks)},
+        store_{std::move(store)} {
+    auto size = getSectorSize(seal_proof);
+    if (size.has_value()) {
+      size_ = size.value();
+    }
+  }
+
+  outcome::result<SectorPaths> LocalWorker::acquireSector(
+      SectorId id, SectorFileType sector_type) {
+    SectorPaths result{
+        .id = id,
+    };
+
+    for (const auto &type : primitives::sector_file::kSectorFileTypes) {
+      if ((sector_type & type) == 0) {
+        continue;
+      }
+
+      auto dir_path = root_ / fs::path(toString(type));
+      if (!(fs::exists(dir_path) || fs::create_directory(dir_path))) {
+        return SectorStorageError::CANNOT_CREATE_DIR;
+      }
+
+      fs::path file(primitives::sector_file::sectorName(id));
+
+      result.setPathByType(type, (dir_path / file).c_str());
+    }
+
+    return result;
+  }
+
+  outcome::result<std::set<TaskType>> LocalWorker::getSupportedTask() {
+    return tasks_;
+  }
+
+  outcome::result<WorkerInfo> LocalWorker::getInfo() {
+    WorkerInfo info{boost::asio::ip::host_name(), localWorkerResources()};
+    auto gpus = proofs::getGPUDevices();
+    if (gpus.has_value()) {
+      info.resources.gpus = std::move(gpus.value());
+    }
+    return info;
+  }
+
+  outcome::result<PreCommit1Output> LocalWorker::sealPreCommit1(
+      const SectorId &sector,
+      const SealRandomness &ticket,
+      gsl::span<const PieceInfo> pieces) {
+    OUTCOME_TRY(paths,
+                acquireSector(
+                    sector,
+                    static_cast<SectorFileType>(SectorFileType::FTSealed
+                                                | SectorFileType::FTCache
+                                                | SectorFileType::FTUnsealed)));
+
+    if (!fs::exists(paths.sealed)) {
+      fs::ofstream sealed_file(paths.sealed);
+      if (!sealed_file.is_open()) {
+        return SectorStorageError::UNABLE_ACCESS_SEALED_FILE;
+      }
+      sealed_file.close();
+    }
+
+    if (!fs::create_directory(paths.cache)) {
+      if (fs::exists(paths.cache)) {
+        if (!fs::remove_all(paths.cache)) {
+          return SectorStorageError::CANNOT_REMOVE_DIR;
+        }
+        if (!fs::create_directory(paths.cache)) {
+          return SectorStorageError::CANNOT_CREATE_DIR;
+        }
+      } else {
+        return SectorStorageError::CANNOT_CREATE_DIR;
+      }
+    }
+
+    UnpaddedPieceSize sum;
+    for (const auto &piece : pieces) {
+      sum += piece.size.unpadded();
+    }
+
+    if (sum != PaddedPieceSize(size_).unpadded()) {
+      return SectorStorageError::DONOT_MATCH_SIZES;
+    }
+
+    return proofs::sealPreCommitPhase1(seal_proof_,
+                                       paths.cache,
+                                       paths.unsealed,
+                                       paths.sealed,
+                                       sector.sector,
+                                       sector.miner,
+                                       ticket,
+                                       pieces);
+  }
+
+  outcome::result<SectorCids> LocalWorker::sealPreCommit2(
+      const SectorId &sector, const PreCommit1Output &pc1o) {
+    OUTCOME_TRY(
+        paths,
+        acquireSector(sector,
+                      static_cast<SectorFileType>(SectorFileType::FTSealed
+                                                  | SectorFileType::FTCache)));
+
+    return proofs::sealPreCommitPhase2(pc1o, paths.cache, paths.sealed);
+  }
+
+  outcome::result<Commit1Output> LocalWorker::sealCommit1(
+      const SectorId &sector,
+      const SealRandomness &ticket,
+      const InteractiveRandomness &seed,
+      gsl::span<const PieceInfo> pieces,
+      const SectorCids &cids) {
+    OUTCOME_TRY(
+        paths,
+        acquireSector(sector,
+                      static_cast<SectorFileType>(SectorFileType::FTSealed
+                                                  | SectorFileType::FTCache)));
+
+    return proofs::sealCommitPhase1(seal_proof_,
+                                    cids.sealed_cid,
+                                    cids.unsealed_cid,
+                                    paths.cache,
+                                    paths.sealed,
+                                    sector.sector,
+                                    sector.miner,
+                                    ticket,
+                                    seed,
+                                    pieces);
+  }
+
+  outcome::result<Proof> LocalWorker::sealCommit2(const SectorId &sector,
+                                                  const Commit1Output &c1o) {
+    return proofs::sealCommitPhase2(c1o, sector.sector, sector.miner);
+  }
+
+  outcome::result<void> LocalWorker::finalizeSector(const SectorId &sector) {
+    OUTCOME_TRY(paths, acquireSector(sector, SectorFileType::FTCache));
+
+    return proofs::clearCache(size_, paths.cache);
+  }
+
+  outcome::result<void> LocalWorker::moveStorage(const SectorId &sector,
+                                                 SectorFileType types) {
+    if (!store_) {
+      return outcome::success();
+    }
+    return store_->moveStorage(sector, seal_proof_, types);
+  }
+}  // namespace fc::sector_storage
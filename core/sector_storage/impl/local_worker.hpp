@@ -0,0 +1,71 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_IMPL_LOCAL_WORKER_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_IMPL_LOCAL_WORKER_HPP
+
+#include <boost/filesystem.hpp>
+
+#include "sector_storage/stores/store.hpp"
+#include "sector_storage/worker.hpp"
+
+namespace fc::sector_storage {
+  using primitives::SectorSize;
+
+  /// Worker sealing sectors with proofs of this process
+  class LocalWorker : public Worker {
+   public:
+    /**
+     * @param root_path - directory of sector files
+     * @param tasks - tasks performed by worker
+     * @param store - long term storage of sector files, nullptr if sector
+     * files stay in root path
+     */
+    LocalWorker(const std::string &root_path,
+                RegisteredProof seal_proof,
+                std::set<TaskType> tasks,
+                std::shared_ptr<stores::Store> store = nullptr);
+
+    outcome::result<SectorPaths> acquireSector(SectorId id,
+                                               SectorFileType sector_type);
+
+    outcome::result<std::set<TaskType>> getSupportedTask() override;
+
+    /// Resources of this machine
+    outcome::result<WorkerInfo> getInfo() override;
+
+    outcome::result<PreCommit1Output> sealPreCommit1(
+        const SectorId &sector,
+        const SealRandomness &ticket,
+        gsl::span<const PieceInfo> pieces) override;
+
+    outcome::result<SectorCids> sealPreCommit2(
+        const SectorId &sector, const PreCommit1Output &pc1o) override;
+
+    outcome::result<Commit1Output> sealCommit1(
+        const SectorId &sector,
+        const SealRandomness &ticket,
+        const InteractiveRandomness &seed,
+        gsl::span<const PieceInfo> pieces,
+        const SectorCids &cids) override;
+
+    outcome::result<Proof> sealCommit2(const SectorId &sector,
+                                       const Commit1Output &c1o) override;
+
+    outcome::result<void> finalizeSector(const SectorId &sector) override;
+
+    outcome::result<void> moveStorage(const SectorId &sector,
+                                      SectorFileType types) override;
+
+   private:
+    boost::filesystem::path root_;
+    RegisteredProof seal_proof_;
+    SectorSize size_;
+    std::set<TaskType> tasks_;
+    std::shared_ptr<stores::Store> store_;
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_IMPL_LOCAL_WORKER_HPP
@@ -0,0 +1,127 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/message_batcher.hpp"
+
+#include <boost/asio/post.hpp>
+
+#include "vm/message/message_util.hpp"
+
+namespace fc::sector_storage {
+  using vm::message::SignedMessage;
+
+  MessageBatcher::MessageBatcher(std::shared_ptr<Api> api,
+                                 std::shared_ptr<MsgWaiter> msg_waiter,
+                                 boost::asio::executor executor,
+                                 MessageBatcherConfig config)
+      : api_{std::move(api)},
+        msg_waiter_{std::move(msg_waiter)},
+        executor_{executor},
+        config_{config},
+        timer_{std::move(executor)},
+        queued_{common::metrics::registry().gauge(
+            "fc_sealing_queued_messages",
+            "Sealing messages waiting for batch")},
+        sent_messages_{common::metrics::registry().counter(
+            "fc_sealing_sent_messages", "Sealing messages pushed to pool")},
+        sent_batches_{common::metrics::registry().counter(
+            "fc_sealing_sent_batches", "Batches of sealing messages pushed")},
+        logger_{common::createLogger("message_batcher")} {}
+
+  std::shared_ptr<MessageBatcher> MessageBatcher::create(
+      std::shared_ptr<Api> api,
+      std::shared_ptr<MsgWaiter> msg_waiter,
+      boost::asio::executor executor,
+      MessageBatcherConfig config) {
+    return std::shared_ptr<MessageBatcher>{new MessageBatcher{
+        std::move(api), std::move(msg_waiter), std::move(executor), config}};
+  }
+
+  void MessageBatcher::push(UnsignedMessage message, Callback callback) {
+    Queued queued{std::move(message), std::move(callback)};
+    boost::asio::post(executor_,
+                      [self{shared_from_this()},
+                       queued{std::move(queued)}]() mutable {
+                        self->queue(std::move(queued));
+                      });
+  }
+
+  void MessageBatcher::flush() {
+    boost::asio::post(executor_, [self{shared_from_this()}] { self->send(); });
+  }
+
+  void MessageBatcher::queue(Queued queued) {
+    if (!queue_.empty()
+        && queue_gas_ + queued.message.gasLimit > config_.max_gas) {
+      send();
+    }
+    queue_gas_ += queued.message.gasLimit;
+    queue_.push_back(std::move(queued));
+    queued_.add(1);
+    if (queue_.size() >= config_.max_messages
+        || queue_gas_ >= config_.max_gas) {
+      send();
+      return;
+    }
+    if (queue_.size() == 1) {
+      timer_.expires_after(config_.max_delay);
+      timer_.async_wait(
+          [weak{weak_from_this()}](const boost::system::error_code &ec) {
+            if (ec) {
+              return;
+            }
+            if (auto self{weak.lock()}) {
+              self->send();
+            }
+          });
+    }
+  }
+
+  void MessageBatcher::send() {
+    timer_.cancel();
+    if (queue_.empty()) {
+      return;
+    }
+    auto batch{std::move(queue_)};
+    queue_.clear();
+    queue_gas_ = 0;
+    queued_.add(-static_cast<int64_t>(batch.size()));
+    sent_batches_.add();
+    for (auto &queued : batch) {
+      auto cid{sendMessage(queued.message)};
+      if (!cid) {
+        logger_->error("push sealing message from {}: {}",
+                       primitives::address::encodeToString(
+                           queued.message.from),
+                       cid.error().message());
+        // nonce is unknown after failure, pool assigns it again
+        nonces_.erase(queued.message.from);
+        queued.callback(cid.error());
+        continue;
+      }
+      sent_messages_.add();
+      msg_waiter_->wait(cid.value(),
+                        [callback{std::move(queued.callback)}](auto &result) {
+                          callback(result);
+                        });
+    }
+  }
+
+  outcome::result<CID> MessageBatcher::sendMessage(UnsignedMessage &message) {
+    auto nonce{nonces_.find(message.from)};
+    if (nonce == nonces_.end()) {
+      OUTCOME_TRY(next, api_->MpoolGetNonce(message.from));
+      nonce = nonces_.emplace(message.from, next).first;
+    }
+    message.nonce = nonce->second;
+    OUTCOME_TRY(cid, vm::message::cid(message));
+    OUTCOME_TRY(cid_bytes, cid.toBytes());
+    OUTCOME_TRY(signature,
+                api_->WalletSign(message.from, common::Buffer{cid_bytes}));
+    OUTCOME_TRY(pushed, api_->MpoolPush(SignedMessage{message, signature}));
+    ++nonce->second;
+    return std::move(pushed);
+  }
+}  // namespace fc::sector_storage
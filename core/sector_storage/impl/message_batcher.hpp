@@ -0,0 +1,101 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_MESSAGE_BATCHER_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_MESSAGE_BATCHER_HPP
+
+#include <boost/asio/executor.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "api/api.hpp"
+#include "common/logger.hpp"
+#include "common/metrics.hpp"
+#include "storage/chain/msg_waiter.hpp"
+
+namespace fc::sector_storage {
+  using api::Api;
+  using primitives::GasAmount;
+  using primitives::address::Address;
+  using storage::blockchain::MsgWaiter;
+  using vm::message::UnsignedMessage;
+
+  struct MessageBatcherConfig {
+    /// Longest time message is queued before batch is sent
+    std::chrono::milliseconds max_delay{std::chrono::seconds{30}};
+    /// Batch is sent when it has so many messages
+    size_t max_messages{32};
+    /// Batch is sent before gas limit of its messages exceeds it
+    GasAmount max_gas{25000000};
+  };
+
+  /**
+   * Coalesces PreCommit and ProveCommit messages of sealing pipeline.
+   * Messages are queued until batch is full by count or gas, or oldest
+   * message waited max_delay, then batch is signed and pushed at once.
+   * Nonces are assigned locally, pool is asked once per sender and again
+   * only after failed push. Inclusions are tracked by message waiter,
+   * which follows head changes for all messages by one subscription.
+   * Metrics:
+   *   fc_sealing_queued_messages - messages waiting for batch,
+   *   fc_sealing_sent_messages, fc_sealing_sent_batches - pushed messages
+   *   and batches, their ratio is average batch size.
+   */
+  class MessageBatcher : public std::enable_shared_from_this<MessageBatcher> {
+   public:
+    using Callback = std::function<void(outcome::result<MsgWaiter::Result>)>;
+
+    /**
+     * @param executor - executor of message waiter, batcher state is used
+     * only there
+     */
+    static std::shared_ptr<MessageBatcher> create(
+        std::shared_ptr<Api> api,
+        std::shared_ptr<MsgWaiter> msg_waiter,
+        boost::asio::executor executor,
+        MessageBatcherConfig config = {});
+
+    /**
+     * @brief queues message, its nonce is assigned when batch is sent
+     * @param callback - called with receipt when message is included, or
+     * with error if message could not be signed or pushed
+     */
+    void push(UnsignedMessage message, Callback callback);
+
+    /// Sends queued messages without waiting for batch to fill
+    void flush();
+
+   private:
+    struct Queued {
+      UnsignedMessage message;
+      Callback callback;
+    };
+
+    MessageBatcher(std::shared_ptr<Api> api,
+                   std::shared_ptr<MsgWaiter> msg_waiter,
+                   boost::asio::executor executor,
+                   MessageBatcherConfig config);
+
+    void queue(Queued queued);
+    void send();
+    /// Assigns nonce, signs and pushes message
+    outcome::result<CID> sendMessage(UnsignedMessage &message);
+
+    std::shared_ptr<Api> api_;
+    std::shared_ptr<MsgWaiter> msg_waiter_;
+    boost::asio::executor executor_;
+    MessageBatcherConfig config_;
+    boost::asio::steady_timer timer_;
+    std::vector<Queued> queue_;
+    GasAmount queue_gas_{};
+    /// Next nonces of senders, forgotten after failed push
+    std::map<Address, uint64_t> nonces_;
+    common::metrics::Gauge &queued_;
+    common::metrics::Counter &sent_messages_;
+    common::metrics::Counter &sent_batches_;
+    common::Logger logger_;
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_MESSAGE_BATCHER_HPP
@@ -0,0 +1,145 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/numa.hpp"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace fc::sector_storage::numa {
+  namespace {
+    /// Memory policies of linux/mempolicy.h, libnuma is not required
+    constexpr int kPolicyDefault{0};
+    constexpr int kPolicyPreferred{1};
+
+    std::string readLine(const std::string &path) {
+      std::ifstream file{path};
+      std::string line;
+      std::getline(file, line);
+      return line;
+    }
+
+    bool setPolicy(int mode, const unsigned long *mask, size_t bits) {
+#ifdef SYS_set_mempolicy
+      return syscall(SYS_set_mempolicy, mode, mask, bits) == 0;
+#else
+      (void)mode, (void)mask, (void)bits;
+      return false;
+#endif
+    }
+  }  // namespace
+
+  std::vector<int> parseCpuList(const std::string &list) {
+    std::vector<int> cpus;
+    std::istringstream ranges{list};
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+      if (range.empty()) {
+        continue;
+      }
+      auto dash{range.find('-')};
+      try {
+        auto first{std::stoi(range.substr(0, dash))};
+        auto last{first};
+        if (dash != std::string::npos) {
+          last = std::stoi(range.substr(dash + 1));
+        }
+        for (auto cpu{first}; cpu <= last; ++cpu) {
+          cpus.push_back(cpu);
+        }
+      } catch (const std::logic_error &) {
+        return {};
+      }
+    }
+    return cpus;
+  }
+
+  const std::vector<Node> &nodes() {
+    static const auto nodes{[] {
+      std::vector<Node> nodes;
+      const std::string root{"/sys/devices/system/node/"};
+      for (auto id : parseCpuList(readLine(root + "online"))) {
+        auto cpus{parseCpuList(
+            readLine(root + "node" + std::to_string(id) + "/cpulist"))};
+        // memory only nodes have no cpus to pin
+        if (!cpus.empty()) {
+          nodes.push_back({id, std::move(cpus)});
+        }
+      }
+      if (nodes.empty()) {
+        nodes.emplace_back();
+        auto count{std::max(1u, std::thread::hardware_concurrency())};
+        for (auto cpu{0u}; cpu < count; ++cpu) {
+          nodes.back().cpus.push_back(static_cast<int>(cpu));
+        }
+      }
+      return nodes;
+    }()};
+    return nodes;
+  }
+
+  Binding::Binding(size_t node) {
+    auto &all{nodes()};
+    if (all.size() < 2 || node >= all.size()) {
+      return;
+    }
+    if (sched_getaffinity(0, sizeof(previous_), &previous_) != 0) {
+      return;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (auto cpu : all[node].cpus) {
+      CPU_SET(cpu, &cpus);
+    }
+    bound_ = sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+    if (bound_) {
+      constexpr auto kBits{sizeof(unsigned long) * 8};
+      auto id{static_cast<size_t>(all[node].id)};
+      std::vector<unsigned long> mask(id / kBits + 1);
+      mask[id / kBits] = 1ul << (id % kBits);
+      policy_ = setPolicy(kPolicyPreferred, mask.data(), mask.size() * kBits);
+    }
+  }
+
+  Binding::~Binding() {
+    if (policy_) {
+      setPolicy(kPolicyDefault, nullptr, 0);
+    }
+    if (bound_) {
+      sched_setaffinity(0, sizeof(previous_), &previous_);
+    }
+  }
+
+  HugeBuffer::HugeBuffer(size_t size)
+      : size_{(size + kHugePage - 1) / kHugePage * kHugePage} {
+    if (size_ == 0) {
+      return;
+    }
+    auto prot{PROT_READ | PROT_WRITE};
+    auto flags{MAP_PRIVATE | MAP_ANONYMOUS};
+    auto memory{mmap(nullptr, size_, prot, flags | MAP_HUGETLB, -1, 0)};
+    explicit_ = memory != MAP_FAILED;
+    if (!explicit_) {
+      memory = mmap(nullptr, size_, prot, flags, -1, 0);
+      if (memory == MAP_FAILED) {
+        size_ = 0;
+        return;
+      }
+      // advice only, buffer works with small pages too
+      madvise(memory, size_, MADV_HUGEPAGE);
+    }
+    data_ = static_cast<uint8_t *>(memory);
+  }
+
+  HugeBuffer::~HugeBuffer() {
+    if (data_) {
+      munmap(data_, size_);
+    }
+  }
+}  // namespace fc::sector_storage::numa
@@ -0,0 +1,80 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/piece_packer.hpp"
+
+#include <algorithm>
+
+namespace fc::sector_storage {
+  namespace {
+    /// Minimal padded piece size
+    constexpr uint64_t kMinPieceSize{128};
+
+    bool isPowerOfTwo(uint64_t size) {
+      return size != 0 && (size & (size - 1)) == 0;
+    }
+
+    /// Rounds offset up to multiple of power of two size
+    uint64_t align(uint64_t offset, uint64_t size) {
+      return (offset + size - 1) & ~(size - 1);
+    }
+  }  // namespace
+
+  outcome::result<std::vector<PackedSector>> packPieces(
+      uint64_t sector_size,
+      std::vector<PackedSector> open,
+      std::vector<PendingPiece> pieces) {
+    for (auto &piece : pieces) {
+      if (!isPowerOfTwo(piece.size) || piece.size < kMinPieceSize) {
+        return PiecePackerError::INVALID_PIECE_SIZE;
+      }
+      if (piece.size > sector_size) {
+        return PiecePackerError::PIECE_TOO_LARGE;
+      }
+    }
+    // stable, so deals of same size keep order of arrival
+    std::stable_sort(pieces.begin(), pieces.end(), [](auto &l, auto &r) {
+      return l.size > r.size;
+    });
+    auto sectors{std::move(open)};
+    for (auto &piece : pieces) {
+      auto sector{std::find_if(sectors.begin(), sectors.end(), [&](auto &s) {
+        return align(s.used, piece.size) + piece.size <= sector_size;
+      })};
+      if (sector == sectors.end()) {
+        sector = sectors.emplace(sectors.end());
+      }
+      auto offset{align(sector->used, piece.size)};
+      sector->pieces.push_back({piece.deal_id, offset, piece.size});
+      sector->used = offset + piece.size;
+    }
+    return sectors;
+  }
+
+  std::vector<PaddedPieceSize> paddingPieces(uint64_t offset, uint64_t next) {
+    // largest power of two pieces aligned at their offsets
+    std::vector<PaddedPieceSize> padding;
+    while (offset < next) {
+      auto size{kMinPieceSize};
+      while (offset % (size * 2) == 0 && offset + size * 2 <= next) {
+        size *= 2;
+      }
+      padding.emplace_back(size);
+      offset += size;
+    }
+    return padding;
+  }
+}  // namespace fc::sector_storage
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::sector_storage, PiecePackerError, e) {
+  using fc::sector_storage::PiecePackerError;
+  switch (e) {
+    case PiecePackerError::INVALID_PIECE_SIZE:
+      return "PiecePackerError: piece size is not padded power of two";
+    case PiecePackerError::PIECE_TOO_LARGE:
+      return "PiecePackerError: piece is larger than sector";
+  }
+  return "unknown error";
+}
@@ -0,0 +1,71 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_PIECE_PACKER_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_PIECE_PACKER_HPP
+
+#include <vector>
+
+#include "common/outcome.hpp"
+#include "primitives/piece/piece.hpp"
+#include "primitives/types.hpp"
+
+namespace fc::sector_storage {
+  using primitives::DealId;
+  using primitives::piece::PaddedPieceSize;
+
+  /// Deal piece placed into sector
+  struct PackedPiece {
+    DealId deal_id;
+    /// Padded offset of piece in sector, multiple of its size
+    uint64_t offset;
+    PaddedPieceSize size;
+  };
+
+  /// Sector being filled with pieces, pieces are written in order
+  struct PackedSector {
+    std::vector<PackedPiece> pieces;
+    /// Padded bytes used by pieces and alignment padding
+    uint64_t used{};
+  };
+
+  /// Deal piece waiting for sector
+  struct PendingPiece {
+    DealId deal_id;
+    PaddedPieceSize size;
+  };
+
+  /**
+   * Packs pieces of many deals into as few sectors as possible. Piece must
+   * start at offset aligned to its size, gap before it is filled with padding
+   * pieces when sector is written. Pieces are placed from largest to smallest
+   * into first sector they fit into, so pieces of one batch add no padding.
+   * @param sector_size - padded sector size
+   * @param open - sectors with free space left from previous batches, new
+   * sectors are appended after them
+   * @param pieces - pieces to place
+   * @return sectors with placed pieces
+   */
+  outcome::result<std::vector<PackedSector>> packPieces(
+      uint64_t sector_size,
+      std::vector<PackedSector> open,
+      std::vector<PendingPiece> pieces);
+
+  /**
+   * Sizes of padding pieces filling gap from offset to aligned offset
+   * @param offset - padded offset of gap
+   * @param next - padded offset of next piece
+   */
+  std::vector<PaddedPieceSize> paddingPieces(uint64_t offset, uint64_t next);
+
+  enum class PiecePackerError {
+    INVALID_PIECE_SIZE = 1,
+    PIECE_TOO_LARGE,
+  };
+}  // namespace fc::sector_storage
+
+OUTCOME_HPP_DECLARE_ERROR(fc::sector_storage, PiecePackerError);
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_PIECE_PACKER_HPP
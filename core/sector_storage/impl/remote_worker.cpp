@@ -0,0 +1,80 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/remote_worker.hpp"
+
+namespace fc::sector_storage {
+
+  RemoteWorker::RemoteWorker() {
+    client_.setup(api_.Info);
+    client_.setup(api_.TaskTypes);
+    client_.setup(api_.SealPreCommit1);
+    client_.setup(api_.SealPreCommit2);
+    client_.setup(api_.SealCommit1);
+    client_.setup(api_.SealCommit2);
+    client_.setup(api_.FinalizeSector);
+    client_.setup(api_.MoveStorage);
+  }
+
+  outcome::result<std::shared_ptr<RemoteWorker>> RemoteWorker::connect(
+      const std::string &host, unsigned short port) {
+    std::shared_ptr<RemoteWorker> worker{new RemoteWorker()};
+    OUTCOME_TRY(worker->client_.connect(host, port));
+    return worker;
+  }
+
+  outcome::result<std::set<TaskType>> RemoteWorker::getSupportedTask() {
+    OUTCOME_TRY(tasks, api_.TaskTypes());
+    std::set<TaskType> result{tasks.begin(), tasks.end()};
+    result.erase(TaskType::ADD_PIECE);
+    result.erase(TaskType::UNSEAL);
+    return result;
+  }
+
+  outcome::result<WorkerInfo> RemoteWorker::getInfo() {
+    return api_.Info();
+  }
+
+  outcome::result<PreCommit1Output> RemoteWorker::sealPreCommit1(
+      const SectorId &sector,
+      const SealRandomness &ticket,
+      gsl::span<const PieceInfo> pieces) {
+    return api_.SealPreCommit1(
+        sector, ticket, std::vector<PieceInfo>{pieces.begin(), pieces.end()});
+  }
+
+  outcome::result<SectorCids> RemoteWorker::sealPreCommit2(
+      const SectorId &sector, const PreCommit1Output &pc1o) {
+    return api_.SealPreCommit2(sector, pc1o);
+  }
+
+  outcome::result<Commit1Output> RemoteWorker::sealCommit1(
+      const SectorId &sector,
+      const SealRandomness &ticket,
+      const InteractiveRandomness &seed,
+      gsl::span<const PieceInfo> pieces,
+      const SectorCids &cids) {
+    return api_.SealCommit1(
+        sector,
+        ticket,
+        seed,
+        std::vector<PieceInfo>{pieces.begin(), pieces.end()},
+        cids);
+  }
+
+  outcome::result<Proof> RemoteWorker::sealCommit2(const SectorId &sector,
+                                                   const Commit1Output &c1o) {
+    return api_.SealCommit2(sector, c1o);
+  }
+
+  outcome::result<void> RemoteWorker::finalizeSector(const SectorId &sector) {
+    return api_.FinalizeSector(sector);
+  }
+
+  outcome::result<void> RemoteWorker::moveStorage(const SectorId &sector,
+                                                  SectorFileType types) {
+    return api_.MoveStorage(sector, types);
+  }
+}  // namespace fc::sector_storage
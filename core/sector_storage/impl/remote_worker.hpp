@@ -0,0 +1,60 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_IMPL_REMOTE_WORKER_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_IMPL_REMOTE_WORKER_HPP
+
+#include "api/rpc/client.hpp"
+#include "api/worker_api.hpp"
+
+namespace fc::sector_storage {
+
+  /**
+   * Worker in other process, called through worker api over websocket. Add
+   * piece and unseal read or write miner files, they are never performed by
+   * remote worker.
+   */
+  class RemoteWorker : public Worker {
+   public:
+    /// Connects to worker api served at host and port
+    static outcome::result<std::shared_ptr<RemoteWorker>> connect(
+        const std::string &host, unsigned short port);
+
+    outcome::result<std::set<TaskType>> getSupportedTask() override;
+
+    outcome::result<WorkerInfo> getInfo() override;
+
+    outcome::result<PreCommit1Output> sealPreCommit1(
+        const SectorId &sector,
+        const SealRandomness &ticket,
+        gsl::span<const PieceInfo> pieces) override;
+
+    outcome::result<SectorCids> sealPreCommit2(
+        const SectorId &sector, const PreCommit1Output &pc1o) override;
+
+    outcome::result<Commit1Output> sealCommit1(
+        const SectorId &sector,
+        const SealRandomness &ticket,
+        const InteractiveRandomness &seed,
+        gsl::span<const PieceInfo> pieces,
+        const SectorCids &cids) override;
+
+    outcome::result<Proof> sealCommit2(const SectorId &sector,
+                                       const Commit1Output &c1o) override;
+
+    outcome::result<void> finalizeSector(const SectorId &sector) override;
+
+    outcome::result<void> moveStorage(const SectorId &sector,
+                                      SectorFileType types) override;
+
+   private:
+    RemoteWorker();
+
+    api::rpc::Client client_;
+    api::WorkerApi api_;
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_IMPL_REMOTE_WORKER_HPP
@@ -0,0 +1,112 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/resources.hpp"
+
+#include <sys/sysinfo.h>
+#include <map>
+#include <thread>
+
+#include "sector_storage/sector_storage_error.hpp"
+
+namespace fc::sector_storage {
+  using primitives::SectorSize;
+
+  namespace {
+    constexpr SectorSize k2KiB{2 << 10};
+    constexpr SectorSize k8MiB{8 << 20};
+    constexpr SectorSize k512MiB{512 << 20};
+    constexpr SectorSize k32GiB{SectorSize{32} << 30};
+    constexpr uint64_t kGiB{1 << 30};
+    constexpr uint64_t kMiB{1 << 20};
+
+    /// Test sectors need about sector size of memory
+    Resources small(SectorSize size, int64_t threads, bool can_gpu) {
+      return {size, size, threads, can_gpu, size};
+    }
+
+    /// Requirements measured for lotus workers
+    using Table = std::map<TaskType, std::map<SectorSize, Resources>>;
+    const Table &table() {
+      static const Table table{
+          {TaskType::ADD_PIECE,
+           {
+               {k2KiB, small(k2KiB, 1, false)},
+               {k8MiB, small(k8MiB, 1, false)},
+               {k512MiB, {kGiB, kGiB, 1, false, kGiB}},
+               {k32GiB, {4 * kGiB, 4 * kGiB, 1, false, kGiB}},
+           }},
+          {TaskType::PRECOMMIT1,
+           {
+               {k2KiB, small(k2KiB, 1, false)},
+               {k8MiB, small(k8MiB, 1, false)},
+               {k512MiB, {768 * kMiB, 768 * kMiB, 1, false, kMiB}},
+               {k32GiB, {48 * kGiB, 64 * kGiB, 1, false, 10 * kMiB}},
+           }},
+          {TaskType::PRECOMMIT2,
+           {
+               {k2KiB, small(k2KiB, kAllThreads, true)},
+               {k8MiB, small(k8MiB, kAllThreads, true)},
+               {k512MiB, {512 * kMiB, kGiB, kAllThreads, true, 10 * kMiB}},
+               {k32GiB, {32 * kGiB, 32 * kGiB, kAllThreads, true, kGiB}},
+           }},
+          {TaskType::COMMIT1,
+           {
+               {k2KiB, small(k2KiB, 0, false)},
+               {k8MiB, small(k8MiB, 0, false)},
+               {k512MiB, {kGiB, kGiB, 0, false, kGiB}},
+               {k32GiB, {kGiB, kGiB, 0, false, kGiB}},
+           }},
+          {TaskType::COMMIT2,
+           {
+               {k2KiB, small(k2KiB, kAllThreads, true)},
+               {k8MiB, small(k8MiB, kAllThreads, true)},
+               {k512MiB,
+                {kGiB, 3 * kGiB / 2, kAllThreads, true, 10 * kGiB}},
+               {k32GiB,
+                {60 * kGiB, 150 * kGiB, kAllThreads, true, 32 * kGiB}},
+           }},
+          {TaskType::FINALIZE,
+           {
+               {k2KiB, {kMiB, kMiB, 0, false, kMiB}},
+               {k8MiB, {kMiB, kMiB, 0, false, kMiB}},
+               {k512MiB, {kMiB, kMiB, 0, false, kMiB}},
+               {k32GiB, {kMiB, kMiB, 0, false, kMiB}},
+           }},
+      };
+      return table;
+    }
+  }  // namespace
+
+  outcome::result<Resources> getResources(TaskType task,
+                                          RegisteredProof seal_proof) {
+    OUTCOME_TRY(size, primitives::sector::getSectorSize(seal_proof));
+    // unseal replicates sector like precommit1
+    auto sizes = table().find(task == TaskType::UNSEAL ? TaskType::PRECOMMIT1
+                                                        : task);
+    if (sizes == table().end()) {
+      return SectorStorageError::NO_RESOURCE_REQUIREMENTS;
+    }
+    auto resources = sizes->second.find(size);
+    if (resources == sizes->second.end()) {
+      return SectorStorageError::NO_RESOURCE_REQUIREMENTS;
+    }
+    return resources->second;
+  }
+
+  WorkerResources localWorkerResources() {
+    WorkerResources resources;
+    struct sysinfo info {};
+    if (sysinfo(&info) == 0) {
+      resources.physical_memory = uint64_t{info.totalram} * info.mem_unit;
+      resources.swap_memory = uint64_t{info.totalswap} * info.mem_unit;
+      resources.reserved_memory =
+          uint64_t{info.totalram - info.freeram - info.bufferram}
+          * info.mem_unit;
+    }
+    resources.cpus = std::max(1u, std::thread::hardware_concurrency());
+    return resources;
+  }
+}  // namespace fc::sector_storage
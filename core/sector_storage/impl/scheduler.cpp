@@ -0,0 +1,311 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/scheduler.hpp"
+
+#include <boost/asio/post.hpp>
+
+#include "common/metrics.hpp"
+#include "sector_storage/numa.hpp"
+#include "sector_storage/sector_storage_error.hpp"
+
+namespace fc::sector_storage {
+  namespace {
+    /// Time of sealing phase on worker, by task type
+    common::LatencyHistogram &taskTime(TaskType type) {
+      static const std::map<TaskType, std::string> kNames{
+          {TaskType::FINALIZE, "finalize"},
+          {TaskType::COMMIT2, "commit2"},
+          {TaskType::COMMIT1, "commit1"},
+          {TaskType::PRECOMMIT2, "precommit2"},
+          {TaskType::PRECOMMIT1, "precommit1"},
+          {TaskType::ADD_PIECE, "add_piece"},
+          {TaskType::UNSEAL, "unseal"},
+      };
+      return common::metrics::registry().histogram(
+          "fc_sealing_task_seconds",
+          "Time of sealing task on worker",
+          {{"task", kNames.at(type)}});
+    }
+  }  // namespace
+
+  Scheduler::Scheduler(RegisteredProof seal_proof, size_t threads)
+      : seal_proof_{seal_proof},
+        node_cpus_(numa::nodes().size()),
+        pool_{std::max<size_t>(threads, 1)},
+        logger_{common::createLogger("scheduler")} {}
+
+  Scheduler::~Scheduler() {
+    {
+      std::lock_guard lock{mutex_};
+      queue_.clear();
+    }
+    pool_.join();
+  }
+
+  outcome::result<Scheduler::WorkerId> Scheduler::addWorker(
+      std::shared_ptr<Worker> worker) {
+    OUTCOME_TRY(info, worker->getInfo());
+    OUTCOME_TRY(tasks, worker->getSupportedTask());
+    std::lock_guard lock{mutex_};
+    auto id = next_worker_++;
+    logger_->info("worker {} added, host {}", id, info.hostname);
+    workers_.emplace(
+        id, WorkerState{std::move(worker), std::move(info), std::move(tasks)});
+    dispatch();
+    return id;
+  }
+
+  void Scheduler::removeWorker(WorkerId id) {
+    std::lock_guard lock{mutex_};
+    workers_.erase(id);
+  }
+
+  void Scheduler::checkWorkers() {
+    std::vector<std::pair<WorkerId, std::shared_ptr<Worker>>> workers;
+    {
+      std::lock_guard lock{mutex_};
+      for (auto &[id, state] : workers_) {
+        workers.emplace_back(id, state.worker);
+      }
+    }
+    // remote calls are not made under lock
+    std::vector<std::pair<WorkerId, outcome::result<WorkerInfo>>> infos;
+    for (auto &[id, worker] : workers) {
+      infos.emplace_back(id, worker->getInfo());
+    }
+    std::lock_guard lock{mutex_};
+    for (auto &[id, info] : infos) {
+      auto it = workers_.find(id);
+      if (it == workers_.end()) {
+        continue;
+      }
+      auto &state = it->second;
+      if (!info) {
+        if (state.enabled) {
+          logger_->warn("worker {} disabled: {}", id, info.error().message());
+        }
+        state.enabled = false;
+        continue;
+      }
+      if (!state.enabled) {
+        logger_->info("worker {} enabled", id);
+      }
+      state.enabled = true;
+      state.info = std::move(info.value());
+    }
+    dispatch();
+  }
+
+  void Scheduler::setDeadline(const SectorId &sector, ChainEpoch deadline) {
+    std::lock_guard lock{mutex_};
+    deadlines_[sector] = deadline;
+  }
+
+  void Scheduler::removeDeadline(const SectorId &sector) {
+    std::lock_guard lock{mutex_};
+    deadlines_.erase(sector);
+  }
+
+  outcome::result<void> Scheduler::schedule(const SectorId &sector,
+                                            TaskType type,
+                                            Work work) {
+    OUTCOME_TRY(need, getResources(type, seal_proof_));
+    std::lock_guard lock{mutex_};
+    auto fits = std::any_of(workers_.begin(), workers_.end(), [&](auto &it) {
+      auto &state = it.second;
+      return state.tasks.count(type) != 0 && canHandle(state, need, {});
+    });
+    if (!fits) {
+      return SectorStorageError::NOT_ENOUGH_RESOURCES;
+    }
+    queue_.push_back({sector, type, need, next_seq_++, std::move(work)});
+    dispatch();
+    return outcome::success();
+  }
+
+  size_t Scheduler::queued(TaskType type) const {
+    std::lock_guard lock{mutex_};
+    return std::count_if(queue_.begin(), queue_.end(), [&](auto &task) {
+      return task.type == type;
+    });
+  }
+
+  boost::optional<ActiveResources> Scheduler::active(WorkerId id) const {
+    std::lock_guard lock{mutex_};
+    auto it = workers_.find(id);
+    if (it == workers_.end()) {
+      return boost::none;
+    }
+    return it->second.active;
+  }
+
+  bool Scheduler::isEnabled(WorkerId id) const {
+    std::lock_guard lock{mutex_};
+    auto it = workers_.find(id);
+    return it != workers_.end() && it->second.enabled;
+  }
+
+  uint64_t Scheduler::cpusOf(const WorkerState &worker,
+                             const Resources &need) {
+    return need.threads == kAllThreads ? worker.info.resources.cpus
+                                       : need.threads;
+  }
+
+  bool Scheduler::canHandle(const WorkerState &worker,
+                            const Resources &need,
+                            const ActiveResources &active) {
+    auto &resources = worker.info.resources;
+    auto min_memory = resources.reserved_memory + active.min_memory
+                      + need.min_memory + need.base_min_memory;
+    if (min_memory > resources.physical_memory) {
+      return false;
+    }
+    auto max_memory = resources.reserved_memory + active.max_memory
+                      + need.max_memory + need.base_min_memory;
+    if (max_memory > resources.physical_memory + resources.swap_memory) {
+      return false;
+    }
+    if (active.cpus + cpusOf(worker, need) > resources.cpus) {
+      return false;
+    }
+    // gpu is used by one task at once
+    return !(need.can_gpu && !resources.gpus.empty() && active.gpu_used);
+  }
+
+  void Scheduler::add(ActiveResources &active,
+                      const Resources &need,
+                      uint64_t cpus) {
+    active.min_memory += need.min_memory;
+    active.max_memory += need.max_memory;
+    active.cpus += cpus;
+    active.gpu_used = active.gpu_used || need.can_gpu;
+  }
+
+  void Scheduler::sub(ActiveResources &active,
+                      const Resources &need,
+                      uint64_t cpus) {
+    active.min_memory -= need.min_memory;
+    active.max_memory -= need.max_memory;
+    active.cpus -= cpus;
+    if (need.can_gpu) {
+      active.gpu_used = false;
+    }
+  }
+
+  boost::optional<Scheduler::WorkerId> Scheduler::selectWorker(
+      const Task &task) const {
+    auto usable = [&](const WorkerState &state) {
+      return state.enabled && state.tasks.count(task.type) != 0
+             && canHandle(state, task.need, state.active);
+    };
+    // commit2 only needs commit1 output, other tasks need sector files
+    if (task.type != TaskType::COMMIT2) {
+      auto pinned = sector_workers_.find(task.sector);
+      if (pinned != sector_workers_.end()) {
+        auto it = workers_.find(pinned->second);
+        if (it != workers_.end() && usable(it->second)) {
+          return it->first;
+        }
+        return boost::none;
+      }
+    }
+    // least loaded worker, gpu workers first for gpu tasks
+    boost::optional<WorkerId> best;
+    auto score = [&](const WorkerState &state) {
+      auto no_gpu = task.need.can_gpu && state.info.resources.gpus.empty();
+      return std::make_pair(no_gpu,
+                            static_cast<double>(state.active.cpus)
+                                / std::max<uint64_t>(
+                                    state.info.resources.cpus, 1));
+    };
+    for (auto &[id, state] : workers_) {
+      if (usable(state)
+          && (!best || score(state) < score(workers_.at(*best)))) {
+        best = id;
+      }
+    }
+    return best;
+  }
+
+  void Scheduler::dispatch() {
+    auto deadline = [&](const Task &task) {
+      auto it = deadlines_.find(task.sector);
+      return it == deadlines_.end() ? kNoDeadline : it->second;
+    };
+    std::vector<std::list<Task>::iterator> order;
+    for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+      order.push_back(it);
+    }
+    std::sort(order.begin(), order.end(), [&](auto &lhs, auto &rhs) {
+      return std::make_tuple(deadline(*lhs), lhs->type, lhs->seq)
+             < std::make_tuple(deadline(*rhs), rhs->type, rhs->seq);
+    });
+    for (auto &it : order) {
+      auto id = selectWorker(*it);
+      if (!id) {
+        continue;
+      }
+      auto &state = workers_.at(*id);
+      auto cpus = cpusOf(state, it->need);
+      add(state.active, it->need, cpus);
+      if (it->type == TaskType::PRECOMMIT1) {
+        sector_workers_[it->sector] = *id;
+      }
+      it->node = selectNode(*it, cpus);
+      if (it->node != kNoNode) {
+        node_cpus_[it->node] += cpus;
+      }
+      boost::asio::post(pool_,
+                        [this,
+                         id{*id},
+                         worker{state.worker},
+                         task{std::move(*it)},
+                         cpus]() mutable {
+                          {
+                            numa::Binding binding{task.node};
+                            common::metrics::Timer timer{taskTime(task.type)};
+                            task.work(*worker);
+                          }
+                          finish(id, task, cpus);
+                        });
+      queue_.erase(it);
+    }
+  }
+
+  size_t Scheduler::selectNode(const Task &task, uint64_t cpus) const {
+    // all threads tasks would be limited to one node
+    if (node_cpus_.size() < 2 || task.need.threads == kAllThreads) {
+      return kNoNode;
+    }
+    auto &nodes{numa::nodes()};
+    auto load = [&](size_t node) {
+      return static_cast<double>(node_cpus_[node] + cpus)
+             / nodes[node].cpus.size();
+    };
+    size_t best{0};
+    for (size_t node{1}; node < node_cpus_.size(); ++node) {
+      if (load(node) < load(best)) {
+        best = node;
+      }
+    }
+    return best;
+  }
+
+  void Scheduler::finish(WorkerId id, const Task &task, uint64_t cpus) {
+    std::lock_guard lock{mutex_};
+    if (task.node != kNoNode) {
+      node_cpus_[task.node] -= cpus;
+    }
+    auto it = workers_.find(id);
+    if (it != workers_.end()) {
+      sub(it->second.active, task.need, cpus);
+    }
+    if (task.type == TaskType::FINALIZE) {
+      sector_workers_.erase(task.sector);
+    }
+    dispatch();
+  }
+}  // namespace fc::sector_storage
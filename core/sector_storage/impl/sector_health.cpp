@@ -0,0 +1,180 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/sector_health.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <thread>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "common/metrics.hpp"
+
+namespace fc::sector_storage {
+  using primitives::sector::getSectorSize;
+  using primitives::sector_file::SectorFileType;
+  using Clock = common::LatencyHistogram::Clock;
+
+  namespace {
+    /// Cache files read by PoSt
+    const std::vector<std::string> kCacheFiles{"p_aux", "t_aux"};
+
+    uint64_t mix(uint64_t x) {
+      x += 0x9e3779b97f4a7c15;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+      return x ^ (x >> 31);
+    }
+
+    /// Size of readable file, none if it can't be opened
+    boost::optional<uint64_t> fileSize(const std::string &path) {
+      struct stat st {};
+      if (stat(path.c_str(), &st) != 0) {
+        return boost::none;
+      }
+      return st.st_size;
+    }
+
+    /// Keeps reads of one storage under rate
+    class Throttle {
+     public:
+      explicit Throttle(uint64_t rate) : rate_{rate} {}
+
+      void consume(uint64_t bytes) {
+        if (rate_ == 0) {
+          return;
+        }
+        bytes_ += bytes;
+        std::chrono::duration<double> elapsed{double(bytes_) / rate_};
+        std::this_thread::sleep_until(
+            start_ + std::chrono::duration_cast<Clock::duration>(elapsed));
+      }
+
+     private:
+      uint64_t rate_;
+      uint64_t bytes_{};
+      Clock::time_point start_{Clock::now()};
+    };
+  }  // namespace
+
+  SectorHealthChecker::SectorHealthChecker(
+      std::shared_ptr<stores::Store> store, SectorHealthConfig config)
+      : store_{std::move(store)},
+        config_{config},
+        logger_{common::createLogger("sector health")} {}
+
+  std::vector<SectorFault> SectorHealthChecker::check(
+      gsl::span<const SectorToCheck> sectors, uint64_t seed) const {
+    std::vector<SectorFault> faults;
+    std::vector<std::string> reasons(sectors.size());
+    std::vector<stores::SectorPaths> paths(sectors.size());
+    // sectors by storage of sealed file
+    std::map<std::string, std::vector<size_t>> storages;
+    for (size_t i{}; i < static_cast<size_t>(sectors.size()); ++i) {
+      auto acquired{store_->acquireSector(
+          sectors[i].id,
+          sectors[i].seal_proof,
+          static_cast<SectorFileType>(SectorFileType::FTSealed
+                                      | SectorFileType::FTCache),
+          SectorFileType::FTNone,
+          false)};
+      if (!acquired) {
+        reasons[i] = "cannot acquire: " + acquired.error().message();
+        continue;
+      }
+      if (acquired.value().paths.sealed.empty()
+          || acquired.value().paths.cache.empty()) {
+        reasons[i] = "sealed or cache file not found";
+        continue;
+      }
+      paths[i] = std::move(acquired.value().paths);
+      storages[acquired.value().stores.sealed].push_back(i);
+    }
+
+    if (!storages.empty()) {
+      boost::asio::thread_pool pool{storages.size()};
+      for (const auto &storage : storages) {
+        boost::asio::post(pool, [&, storage{&storage}] {
+          for (auto i : storage->second) {
+            reasons[i] =
+                checkFiles(sectors[i], paths[i], storage->first, seed);
+          }
+        });
+      }
+      pool.join();
+    }
+
+    for (size_t i{}; i < reasons.size(); ++i) {
+      if (!reasons[i].empty()) {
+        logger_->warn("sector {} of miner {} is faulty: {}",
+                      sectors[i].id.sector,
+                      sectors[i].id.miner,
+                      reasons[i]);
+        faults.push_back({sectors[i].id, std::move(reasons[i])});
+      }
+    }
+    return faults;
+  }
+
+  std::string SectorHealthChecker::checkFiles(const SectorToCheck &sector,
+                                              const stores::SectorPaths &paths,
+                                              const std::string &storage,
+                                              uint64_t seed) const {
+    boost::filesystem::path cache{paths.cache};
+    for (auto &name : kCacheFiles) {
+      auto size{fileSize((cache / name).string())};
+      if (!size || *size == 0) {
+        return "cache file " + name + " is missing";
+      }
+    }
+
+    auto sector_size{getSectorSize(sector.seal_proof)};
+    if (!sector_size) {
+      return "unknown seal proof";
+    }
+    auto size{fileSize(paths.sealed)};
+    if (!size) {
+      return "sealed file is missing";
+    }
+    if (*size != sector_size.value()) {
+      return "sealed file size " + std::to_string(*size) + " is not "
+             + std::to_string(sector_size.value());
+    }
+
+    auto fd{open(paths.sealed.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) {
+      return "cannot open sealed file";
+    }
+    auto &latency{common::metrics::registry().histogram(
+        "fc_sector_check_read_seconds",
+        "Latency of sector region reads by health check",
+        {{"storage", storage}})};
+    Throttle throttle{config_.storage_rate};
+    auto read_size{std::clamp<uint64_t>(config_.read_size, 1, *size)};
+    std::vector<uint8_t> buffer(read_size);
+    auto regions{*size / read_size};
+    std::string reason;
+    for (size_t r{}; r < config_.reads_per_sector && reason.empty(); ++r) {
+      auto region{mix(seed ^ mix(sector.id.miner) ^ mix(sector.id.sector)
+                      ^ mix(r))
+                  % regions};
+      auto start{Clock::now()};
+      auto read{pread(fd, buffer.data(), read_size, region * read_size)};
+      latency.record(Clock::now() - start);
+      if (read != static_cast<ssize_t>(read_size)) {
+        reason = "cannot read region " + std::to_string(region);
+      }
+      throttle.consume(read_size);
+    }
+    close(fd);
+    return reason;
+  }
+}  // namespace fc::sector_storage
@@ -0,0 +1,75 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_SECTOR_HEALTH_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_SECTOR_HEALTH_HPP
+
+#include <gsl/span>
+
+#include "common/logger.hpp"
+#include "sector_storage/stores/store.hpp"
+
+namespace fc::sector_storage {
+  using primitives::sector::RegisteredProof;
+  using primitives::sector::SectorId;
+
+  struct SectorHealthConfig {
+    /// Regions of sealed file read per sector
+    size_t reads_per_sector{16};
+    /// Size of one region, bytes
+    size_t read_size{4 << 10};
+    /// Read rate limit of one storage, bytes per second, zero is unlimited
+    uint64_t storage_rate{32 << 20};
+  };
+
+  struct SectorToCheck {
+    SectorId id;
+    RegisteredProof seal_proof;
+  };
+
+  struct SectorFault {
+    SectorId sector;
+    /// Why sector can't be proven, for logs and fault declaration
+    std::string reason;
+  };
+
+  /**
+   * Checks that sectors of upcoming PoSt deadlines are provable before the
+   * deadline opens, so bad disks are declared as faults instead of failing
+   * whole PoSt. Sealed file size, cache files and sampled regions of sealed
+   * file are read, sectors of each storage on own thread with throttled
+   * reads, so checks don't starve sealing of disk bandwidth.
+   * Metrics, labeled with storage id:
+   *   fc_sector_check_read_seconds - latency of region reads.
+   */
+  class SectorHealthChecker {
+   public:
+    SectorHealthChecker(std::shared_ptr<stores::Store> store,
+                        SectorHealthConfig config = {});
+
+    /**
+     * @brief checks sectors, blocks until all are checked
+     * @param sectors - sectors of upcoming deadlines
+     * @param seed - selects sampled regions, e.g. epoch of deadline, so
+     * repeated checks cover different regions
+     * @return faulty sectors
+     */
+    std::vector<SectorFault> check(gsl::span<const SectorToCheck> sectors,
+                                   uint64_t seed) const;
+
+   private:
+    /// Empty if sector is healthy
+    std::string checkFiles(const SectorToCheck &sector,
+                           const stores::SectorPaths &paths,
+                           const std::string &storage,
+                           uint64_t seed) const;
+
+    std::shared_ptr<stores::Store> store_;
+    SectorHealthConfig config_;
+    common::Logger logger_;
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_SECTOR_HEALTH_HPP
@@ -25,6 +25,10 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::sector_storage, SectorStorageError, e) {
       return "Sector Storage: cannot open a file";
     case (SectorStorageError::OUT_OF_FILE_SIZE):
       return "Sector Storage: requested piece is out of bound";
+    case (SectorStorageError::NO_RESOURCE_REQUIREMENTS):
+      return "Sector Storage: unknown resource requirements of task";
+    case (SectorStorageError::NOT_ENOUGH_RESOURCES):
+      return "Sector Storage: worker resources are not enough for task";
 
     default:
       return "Sector Storage: unknown error";
@@ -5,113 +5,125 @@
 
 #include "sector_storage/impl/sector_storage_impl.hpp"
 #include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <thread>
+#include "common/tracing.hpp"
+#include "proofs/native_proofs.hpp"
+#include "sector_storage/numa.hpp"
 #include "sector_storage/sector_storage_error.hpp"
 
 namespace fc::sector_storage {
 
-  using fc::primitives::piece::PaddedPieceSize;
   using fc::primitives::sector_file::SectorFileType;
   using proofs = fc::proofs::Proofs;
-  using fc::primitives::sector::getSectorSize;
 
-  SectorStorageImpl::SectorStorageImpl(const std::string &root_path,
-                                       RegisteredProof post_proof,
-                                       RegisteredProof seal_proof)
-      : root_(root_path),
-        seal_proof_type_(seal_proof),
-        post_proof_type_(post_proof) {
-    size_ = 0;
-    auto s1 = getSectorSize(seal_proof);
-    if (s1.has_value()) {
-      size_ = s1.value();
+  namespace {
+    /// Copies range through buffer, if file system doesn't support splice
+    void copyRange(int in, int out, uint64_t offset, uint64_t size) {
+      // staging buffer is placed on node of calling thread
+      numa::HugeBuffer buffer{std::min<uint64_t>(size, numa::kHugePage)};
+      if (!buffer.data()) {
+        return;
+      }
+      for (uint64_t done = 0; done < size;) {
+        auto chunk = std::min<uint64_t>(buffer.size(), size - done);
+        auto read = pread(in, buffer.data(), chunk, offset + done);
+        if (read <= 0) {
+          return;
+        }
+        for (ssize_t written = 0; written < read;) {
+          auto n = write(out, buffer.data() + written, read - written);
+          if (n <= 0) {
+            return;
+          }
+          written += n;
+        }
+        done += read;
+      }
     }
-  }
-
-  outcome::result<SectorPaths> SectorStorageImpl::acquireSector(
-      SectorId id, SectorFileType sector_type) {
-    SectorPaths result{
-        .id = id,
-    };
 
-    for (const auto &type : primitives::sector_file::kSectorFileTypes) {
-      if ((sector_type & type) == 0) {
-        continue;
+    /**
+     * Moves range of file to pipe by splice, pages are passed to pipe
+     * without copies to user space
+     */
+    void feedRange(int in, int out, uint64_t offset, uint64_t size) {
+      loff_t position = offset;
+      for (uint64_t done = 0; done < size;) {
+        auto moved = splice(
+            in, &position, out, nullptr, size - done, SPLICE_F_MOVE);
+        if (moved < 0 && done == 0 && (errno == EINVAL || errno == ENOSYS)) {
+          return copyRange(in, out, offset, size);
+        }
+        if (moved <= 0) {
+          return;
+        }
+        done += moved;
       }
-
-      auto dir_path = root_ / path(toString(type));
-      if (!(boost::filesystem::exists(dir_path)
-            || boost::filesystem::create_directory(dir_path))) {
-        return SectorStorageError::CANNOT_CREATE_DIR;
+    }
+  }  // namespace
+
+  SectorStorageImpl::SectorStorageImpl(
+      const std::string &root_path,
+      RegisteredProof post_proof,
+      RegisteredProof seal_proof,
+      std::shared_ptr<Scheduler> scheduler,
+      std::shared_ptr<UnsealedCache> unsealed_cache,
+      std::shared_ptr<FinalizeQueue> finalize_queue)
+      : seal_proof_type_(seal_proof),
+        post_proof_type_(post_proof),
+        local_{std::make_shared<LocalWorker>(
+            root_path,
+            seal_proof,
+            std::set<TaskType>{TaskType::FINALIZE,
+                               TaskType::COMMIT2,
+                               TaskType::COMMIT1,
+                               TaskType::PRECOMMIT2,
+                               TaskType::PRECOMMIT1,
+                               TaskType::ADD_PIECE,
+                               TaskType::UNSEAL})},
+        scheduler_(std::move(scheduler)),
+        unsealed_cache_(std::move(unsealed_cache)),
+        finalize_queue_(std::move(finalize_queue)) {
+    if (!unsealed_cache_) {
+      unsealed_cache_ = std::make_shared<UnsealedCache>(
+          (boost::filesystem::path{root_path} / "unsealed-cache").string(),
+          kUnsealedCacheQuota);
+    }
+    if (!scheduler_) {
+      scheduler_ = std::make_shared<Scheduler>(seal_proof);
+      auto added = scheduler_->addWorker(local_);
+      if (!added) {
+        outcome::raise(added.error());
       }
-
-      path file(primitives::sector_file::sectorName(id));
-
-      result.setPathByType(type, (dir_path / file).c_str());
     }
+  }
 
-    return result;
+  outcome::result<SectorPaths> SectorStorageImpl::acquireSector(
+      SectorId id, SectorFileType sector_type) {
+    return local_->acquireSector(id, sector_type);
   }
 
   outcome::result<PreCommit1Output> SectorStorageImpl::sealPreCommit1(
       const SectorId &sector,
       const SealRandomness &ticket,
       gsl::span<const PieceInfo> pieces) {
-    OUTCOME_TRY(paths,
-                acquireSector(
-                    sector,
-                    static_cast<SectorFileType>(SectorFileType::FTSealed
-                                                | SectorFileType::FTCache
-                                                | SectorFileType::FTUnsealed)));
-
-    if (!boost::filesystem::exists(paths.sealed)) {
-      boost::filesystem::ofstream sealed_file(paths.sealed);
-      if (!sealed_file.is_open()) {
-        return SectorStorageError::UNABLE_ACCESS_SEALED_FILE;
-      }
-      sealed_file.close();
-    }
-
-    if (!boost::filesystem::create_directory(paths.cache)) {
-      if (boost::filesystem::exists(paths.cache)) {
-        if (!boost::filesystem::remove_all(paths.cache)) {
-          return SectorStorageError::CANNOT_REMOVE_DIR;
-        }
-        if (!boost::filesystem::create_directory(paths.cache)) {
-          return SectorStorageError::CANNOT_CREATE_DIR;
-        }
-      } else {
-        return SectorStorageError::CANNOT_CREATE_DIR;
-      }
-    }
-
-    UnpaddedPieceSize sum;
-    for (const auto &piece : pieces) {
-      sum += piece.size.unpadded();
-    }
-
-    if (sum != PaddedPieceSize(size_).unpadded()) {
-      return SectorStorageError::DONOT_MATCH_SIZES;
-    }
-
-    return proofs::sealPreCommitPhase1(seal_proof_type_,
-                                       paths.cache,
-                                       paths.unsealed,
-                                       paths.sealed,
-                                       sector.sector,
-                                       sector.miner,
-                                       ticket,
-                                       pieces);
+    common::tracing::Span span{"sector_storage.precommit1",
+                               std::to_string(sector.sector)};
+    return scheduler_->run<PreCommit1Output>(
+        sector, TaskType::PRECOMMIT1, [&](Worker &worker) {
+          return worker.sealPreCommit1(sector, ticket, pieces);
+        });
   }
 
   outcome::result<SectorCids> SectorStorageImpl::sealPreCommit2(
       const SectorId &sector, const PreCommit1Output &pc1o) {
-    OUTCOME_TRY(
-        paths,
-        acquireSector(sector,
-                      static_cast<SectorFileType>(SectorFileType::FTSealed
-                                                  | SectorFileType::FTCache)));
-
-    return proofs::sealPreCommitPhase2(pc1o, paths.cache, paths.sealed);
+    common::tracing::Span span{"sector_storage.precommit2",
+                               std::to_string(sector.sector)};
+    return scheduler_->run<SectorCids>(
+        sector, TaskType::PRECOMMIT2, [&](Worker &worker) {
+          return worker.sealPreCommit2(sector, pc1o);
+        });
   }
 
   outcome::result<Commit1Output> SectorStorageImpl::sealCommit1(
@@ -119,39 +131,56 @@ namespace fc::sector_storage {
       const SealRandomness &ticket,
       const InteractiveRandomness &seed,
       gsl::span<const PieceInfo> pieces,
-      const SectorCids &cids)
-
-  {
-    OUTCOME_TRY(
-        paths,
-        acquireSector(sector,
-                      static_cast<SectorFileType>(SectorFileType::FTSealed
-                                                  | SectorFileType::FTCache)));
-
-    return proofs::sealCommitPhase1(seal_proof_type_,
-                                    cids.sealed_cid,
-                                    cids.unsealed_cid,
-                                    paths.cache,
-                                    paths.sealed,
-                                    sector.sector,
-                                    sector.miner,
-                                    ticket,
-                                    seed,
-                                    pieces);
+      const SectorCids &cids) {
+    common::tracing::Span span{"sector_storage.commit1",
+                               std::to_string(sector.sector)};
+    return scheduler_->run<Commit1Output>(
+        sector, TaskType::COMMIT1, [&](Worker &worker) {
+          return worker.sealCommit1(sector, ticket, seed, pieces, cids);
+        });
   }
 
   outcome::result<Proof> SectorStorageImpl::sealCommit2(
-      const SectorId &sector, const Commit1Output &c1o)
-
-  {
-    return proofs::sealCommitPhase2(c1o, sector.sector, sector.miner);
+      const SectorId &sector, const Commit1Output &c1o) {
+    common::tracing::Span span{"sector_storage.commit2",
+                               std::to_string(sector.sector)};
+    return scheduler_->run<Proof>(
+        sector, TaskType::COMMIT2, [&](Worker &worker) {
+          return worker.sealCommit2(sector, c1o);
+        });
   }
 
   outcome::result<void> SectorStorageImpl::finalizeSector(
       const SectorId &sector) {
-    OUTCOME_TRY(paths, acquireSector(sector, SectorFileType::FTCache));
-
-    return proofs::clearCache(size_, paths.cache);
+    common::tracing::Span span{"sector_storage.finalize",
+                               std::to_string(sector.sector)};
+    if (finalize_queue_) {
+      // sealing is done, sector doesn't hold worker while cache is deleted
+      OUTCOME_TRY(paths,
+                  local_->acquireSector(sector, SectorFileType::FTCache));
+      scheduler_->removeDeadline(sector);
+      finalize_queue_->push(
+          sector,
+          paths.cache,
+          [local{local_}, sector]() -> outcome::result<void> {
+            OUTCOME_TRY(local->finalizeSector(sector));
+            return local->moveStorage(
+                sector,
+                static_cast<SectorFileType>(SectorFileType::FTSealed
+                                            | SectorFileType::FTCache));
+          });
+      return outcome::success();
+    }
+    OUTCOME_TRY(scheduler_->run<void>(
+        sector, TaskType::FINALIZE, [&](Worker &worker) {
+          OUTCOME_TRY(worker.finalizeSector(sector));
+          return worker.moveStorage(
+              sector,
+              static_cast<SectorFileType>(SectorFileType::FTSealed
+                                          | SectorFileType::FTCache));
+        }));
+    scheduler_->removeDeadline(sector);
+    return outcome::success();
   }
 
   outcome::result<PieceInfo> SectorStorageImpl::addPiece(
@@ -174,11 +203,16 @@ namespace fc::sector_storage {
     }
 
     OUTCOME_TRY(response,
-                proofs::writeWithAlignment(seal_proof_type_,
-                                           piece_data,
-                                           new_piece_size,
-                                           staged_path.unsealed,
-                                           piece_sizes));
+                scheduler_->run<fc::proofs::WriteWithAlignmentResult>(
+                    sector, TaskType::ADD_PIECE, [&](Worker &) {
+                      return fc::proofs::NativeProofs::writeWithAlignment(
+                          seal_proof_type_,
+                          piece_data,
+                          new_piece_size,
+                          staged_path.unsealed,
+                          piece_sizes,
+                          std::max(1u, std::thread::hardware_concurrency()));
+                    }));
 
     return PieceInfo(new_piece_size.padded(), response.piece_cid);
   }
@@ -190,70 +224,60 @@ namespace fc::sector_storage {
       const SealRandomness &ticket,
       const CID &unsealedCID) {
     OUTCOME_TRY(path, acquireSector(sector, SectorFileType::FTUnsealed));
-    if (!boost::filesystem::exists(path.unsealed)) {
-      boost::filesystem::ofstream unsealed_file(path.unsealed);
-      if (!unsealed_file.is_open()) {
-        return SectorStorageError::CANNOT_CREATE_FILE;
+    if (boost::filesystem::exists(path.unsealed)) {
+      // unsealed file of sector is kept until it is finalized
+      auto file_size = boost::filesystem::file_size(path.unsealed);
+      if (offset + size > file_size) {
+        return SectorStorageError::OUT_OF_FILE_SIZE;
       }
-      unsealed_file.close();
+      return readRange(PieceData(path.unsealed), file_size, offset, size);
+    }
 
+    // only requested range is unsealed, and kept for next reads
+    auto unseal = [&](const std::string &output) -> outcome::result<void> {
       OUTCOME_TRY(sealed,
                   acquireSector(
                       sector,
                       static_cast<SectorFileType>(SectorFileType::FTSealed
                                                   | SectorFileType::FTCache)));
+      return scheduler_->run<void>(sector, TaskType::UNSEAL, [&](Worker &) {
+        return proofs::unsealRange(seal_proof_type_,
+                                   sealed.cache,
+                                   sealed.sealed,
+                                   output,
+                                   sector.sector,
+                                   sector.miner,
+                                   ticket,
+                                   unsealedCID,
+                                   offset,
+                                   size);
+      });
+    };
+    OUTCOME_TRY(piece, unsealed_cache_->get(sector, offset, size, unseal));
+    return readRange(std::move(piece.file), piece.size, piece.offset, size);
+  }
 
-      OUTCOME_TRY(proofs::unseal(seal_proof_type_,
-                                 sealed.cache,
-                                 sealed.sealed,
-                                 path.unsealed,
-                                 sector.sector,
-                                 sector.miner,
-                                 ticket,
-                                 unsealedCID));
-    }
-
-    if (offset + size > boost::filesystem::file_size(path.unsealed)) {
-      return SectorStorageError::OUT_OF_FILE_SIZE;
+  outcome::result<PieceData> SectorStorageImpl::readRange(
+      PieceData file,
+      uint64_t file_size,
+      UnpaddedByteIndex offset,
+      UnpaddedPieceSize size) {
+    if (!file.isOpened()) {
+      return SectorStorageError::CANNOT_OPEN_FILE;
     }
 
-    if (size == boost::filesystem::file_size(path.unsealed)) {
-      return PieceData(path.unsealed);
+    if (offset == 0 && size == file_size) {
+      return std::move(file);
     }
 
     int piece[2];
     if (pipe(piece) < 0) return SectorStorageError::CANNOT_CREATE_FILE;
 
-    constexpr uint64_t chunk_size = 256;
-
-    std::ifstream unsealed_file(path.unsealed, std::ifstream::binary);
-
-    if (!unsealed_file.is_open()) {
-      close(piece[0]);
-      close(piece[1]);
-      return SectorStorageError::CANNOT_OPEN_FILE;
-    }
-
-    unsealed_file.seekg(offset, unsealed_file.beg);
-
-    char *buffer = new char[chunk_size];
-
-    for (uint64_t read_size = 0; read_size < size;) {
-      uint64_t curr_read_size = std::min(chunk_size, size - read_size);
-
-      // read data as a block:
-      unsealed_file.read(buffer, curr_read_size);
-
-      write(piece[1], buffer, unsealed_file.gcount());
-
-      read_size += unsealed_file.gcount();
-    }
-
-    delete[] buffer;
-
-    close(piece[1]);
-
-    unsealed_file.close();
+    // pipe holds only 64KiB, so range is fed while reader drains pipe
+    std::thread{[file{std::move(file)}, out{piece[1]}, offset, size] {
+      feedRange(file.getFd(), out, offset, size);
+      close(out);
+    }}.detach();
 
     return PieceData(piece[0]);
   }
@@ -7,6 +7,10 @@
 #define CPP_FILECOIN_CORE_SECTOR_STORAGE_IMPL_HPP
 
 #include <boost/filesystem.hpp>
+#include "sector_storage/impl/finalize_queue.hpp"
+#include "sector_storage/impl/local_worker.hpp"
+#include "sector_storage/impl/unsealed_cache.hpp"
+#include "sector_storage/scheduler.hpp"
 #include "sector_storage/sector_storage.hpp"
 
 using boost::filesystem::path;
@@ -17,9 +21,23 @@ namespace fc::sector_storage {
 
   class SectorStorageImpl : public SectorStorage {
    public:
-    SectorStorageImpl(const std::string &root_path,
-                      RegisteredProof post_proof,
-                      RegisteredProof seal_proof);
+    /**
+     * @param scheduler - runs sealing tasks on its workers, which must share
+     * unsealed sector files with root path, nullptr to run all tasks on
+     * local worker
+     * @param unsealed_cache - pieces unsealed for reading, nullptr to keep
+     * them under root path within default quota
+     * @param finalize_queue - finalizes sectors of local worker in
+     * background, finalizeSector returns once sector is queued, nullptr to
+     * finalize on worker chosen by scheduler and wait for it
+     */
+    SectorStorageImpl(
+        const std::string &root_path,
+        RegisteredProof post_proof,
+        RegisteredProof seal_proof,
+        std::shared_ptr<Scheduler> scheduler = nullptr,
+        std::shared_ptr<UnsealedCache> unsealed_cache = nullptr,
+        std::shared_ptr<FinalizeQueue> finalize_queue = nullptr);
 
     outcome::result<SectorPaths> acquireSector(
         SectorId id, SectorFileType sector_type) override;
@@ -58,10 +76,23 @@ namespace fc::sector_storage {
         const CID &unsealedCID) override;
 
    private:
-    path root_;
+    /**
+     * Returns range of file, whole file is returned as is. Range is spliced
+     * into pipe by own thread, without copies to user space.
+     * @param file - opened file
+     * @param file_size - size of file
+     */
+    outcome::result<PieceData> readRange(PieceData file,
+                                         uint64_t file_size,
+                                         UnpaddedByteIndex offset,
+                                         UnpaddedPieceSize size);
+
     RegisteredProof seal_proof_type_;
     RegisteredProof post_proof_type_;
-    SectorSize size_;
+    std::shared_ptr<LocalWorker> local_;
+    std::shared_ptr<Scheduler> scheduler_;
+    std::shared_ptr<UnsealedCache> unsealed_cache_;
+    std::shared_ptr<FinalizeQueue> finalize_queue_;
   };
 }  // namespace fc::sector_storage
 #endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_IMPL_HPP
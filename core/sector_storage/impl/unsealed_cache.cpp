@@ -0,0 +1,114 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/unsealed_cache.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include "primitives/sector_file/sector_file.hpp"
+#include "sector_storage/sector_storage_error.hpp"
+
+namespace fc::sector_storage {
+  namespace fs = boost::filesystem;
+  using primitives::sector_file::sectorName;
+
+  UnsealedCache::UnsealedCache(std::string dir, uint64_t quota)
+      : dir_{std::move(dir)}, quota_{quota} {
+    boost::system::error_code ec;
+    fs::remove_all(dir_, ec);
+    fs::create_directories(dir_, ec);
+  }
+
+  outcome::result<UnsealedCache::Piece> UnsealedCache::get(
+      const SectorId &sector,
+      uint64_t offset,
+      uint64_t size,
+      const Unseal &unseal) {
+    Key key{sector, offset, size};
+    std::unique_lock lock{mutex_};
+    while (true) {
+      if (auto found = find(key)) {
+        auto &cached = (*found)->first;
+        return Piece{PieceData{(*found)->second.path},
+                     offset - cached.offset,
+                     cached.size};
+      }
+      if (unsealing_.count(sector) == 0) {
+        break;
+      }
+      // unsealed range may contain requested one
+      unsealed_.wait(lock);
+    }
+    unsealing_.insert(sector);
+    lock.unlock();
+
+    auto path{(fs::path{dir_}
+               / (sectorName(sector) + "-" + std::to_string(offset) + "-"
+                  + std::to_string(size)))
+                  .string()};
+    auto tmp{path + ".tmp"};
+    auto res{unseal(tmp)};
+    boost::system::error_code ec;
+    if (res) {
+      fs::rename(tmp, path, ec);
+      if (ec) {
+        res = SectorStorageError::CANNOT_CREATE_FILE;
+      }
+    }
+    if (!res) {
+      fs::remove(tmp, ec);
+    }
+
+    lock.lock();
+    unsealing_.erase(sector);
+    boost::optional<PieceData> file;
+    if (res) {
+      lru_.push_front(key);
+      entries_.emplace(key, Entry{path, lru_.begin()});
+      size_ += size;
+      file.emplace(path);
+      evict();
+    }
+    lock.unlock();
+    unsealed_.notify_all();
+
+    if (!res) {
+      return res.error();
+    }
+    return Piece{std::move(*file), 0, size};
+  }
+
+  uint64_t UnsealedCache::size() const {
+    std::lock_guard lock{mutex_};
+    return size_;
+  }
+
+  boost::optional<std::map<UnsealedCache::Key, UnsealedCache::Entry>::iterator>
+  UnsealedCache::find(const Key &key) {
+    for (auto it = entries_.lower_bound({key.sector, 0, 0});
+         it != entries_.end() && it->first.sector == key.sector
+         && it->first.offset <= key.offset;
+         ++it) {
+      auto &cached = it->first;
+      if (key.offset + key.size <= cached.offset + cached.size) {
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+        return it;
+      }
+    }
+    return boost::none;
+  }
+
+  void UnsealedCache::evict() {
+    while (size_ > quota_ && lru_.size() > 1) {
+      auto it = entries_.find(lru_.back());
+      // opened files are still readable after removal
+      boost::system::error_code ec;
+      fs::remove(it->second.path, ec);
+      size_ -= it->first.size;
+      entries_.erase(it);
+      lru_.pop_back();
+    }
+  }
+}  // namespace fc::sector_storage
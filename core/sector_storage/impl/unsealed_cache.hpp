@@ -0,0 +1,111 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_UNSEALED_CACHE_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_UNSEALED_CACHE_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+
+#include <boost/optional.hpp>
+
+#include "common/outcome.hpp"
+#include "primitives/piece/piece_data.hpp"
+#include "primitives/sector/sector.hpp"
+
+namespace fc::sector_storage {
+  using primitives::piece::PieceData;
+  using primitives::sector::SectorId;
+
+  /// Default size of unsealed pieces kept by cache, bytes
+  constexpr uint64_t kUnsealedCacheQuota = uint64_t{32} << 30;
+
+  /**
+   * Keeps pieces unsealed for retrieval in files of cache directory, so
+   * repeated reads of piece do not unseal sector again. Range of sector is
+   * served from cached range containing it. Least recently read pieces are
+   * removed when cached size exceeds quota. One unseal of sector runs at a
+   * time, concurrent reads of one piece wait for it and unseal it once.
+   */
+  class UnsealedCache {
+   public:
+    /// Writes unsealed range to output file
+    using Unseal =
+        std::function<outcome::result<void>(const std::string &output)>;
+
+    /// Cached file containing requested range, opened before it may be
+    /// evicted
+    struct Piece {
+      PieceData file;
+      /// Offset of requested range in file
+      uint64_t offset{};
+      /// Size of file
+      uint64_t size{};
+    };
+
+    /**
+     * @param dir - cache directory, files of previous run are removed
+     * @param quota - size of cached pieces, bytes
+     */
+    UnsealedCache(std::string dir, uint64_t quota);
+
+    /**
+     * Returns cached piece containing range, unseals range if it is missing
+     * @param sector - sector of piece
+     * @param offset - unpadded offset of range in sector
+     * @param size - unpadded size of range
+     * @param unseal - unseals range into given file
+     */
+    outcome::result<Piece> get(const SectorId &sector,
+                               uint64_t offset,
+                               uint64_t size,
+                               const Unseal &unseal);
+
+    /// Size of cached pieces, bytes
+    uint64_t size() const;
+
+   private:
+    struct Key {
+      SectorId sector;
+      uint64_t offset;
+      uint64_t size;
+
+      bool operator<(const Key &other) const {
+        return std::tie(sector, offset, size)
+               < std::tie(other.sector, other.offset, other.size);
+      }
+    };
+
+    struct Entry {
+      std::string path;
+      std::list<Key>::iterator lru;
+    };
+
+    /// Finds cached piece containing range and marks it used
+    boost::optional<std::map<Key, Entry>::iterator> find(const Key &key);
+
+    /// Removes least recently used pieces over quota, except most recent one
+    void evict();
+
+    std::string dir_;
+    uint64_t quota_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable unsealed_;
+    std::map<Key, Entry> entries_;
+    /// Keys in order of use, most recent first
+    std::list<Key> lru_;
+    uint64_t size_{};
+    /// Sectors being unsealed
+    std::set<SectorId> unsealing_;
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_UNSEALED_CACHE_HPP
@@ -0,0 +1,93 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_NUMA_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_NUMA_HPP
+
+#include <sched.h>
+#include <string>
+#include <vector>
+
+namespace fc::sector_storage::numa {
+  /// Size of transparent and explicit hugepage on x86-64
+  constexpr size_t kHugePage{2 << 20};
+
+  /// Cpus of "0-3,8,10-11" list, as kernel writes it in sysfs
+  std::vector<int> parseCpuList(const std::string &list);
+
+  struct Node {
+    /// Kernel node id, ids may have gaps
+    int id{};
+    std::vector<int> cpus;
+  };
+
+  /**
+   * NUMA nodes with cpus of this machine, in order of ids.
+   * One node with all cpus if kernel has no NUMA support.
+   */
+  const std::vector<Node> &nodes();
+
+  /**
+   * Pins calling thread to cpus of node and prefers memory of node for
+   * its allocations, restores previous binding on destruction.
+   * Threads started by pinned thread, e.g. inside proofs ffi, inherit it.
+   */
+  class Binding {
+   public:
+    /// Node is index in nodes()
+    explicit Binding(size_t node);
+    ~Binding();
+
+    Binding(const Binding &) = delete;
+    Binding &operator=(const Binding &) = delete;
+
+    /// Whether affinity was changed, false on one node machine
+    bool bound() const {
+      return bound_;
+    }
+
+   private:
+    bool bound_{false};
+    bool policy_{false};
+    cpu_set_t previous_{};
+  };
+
+  /**
+   * Anonymous memory backed by hugepages, to reduce TLB misses while
+   * copying sector data. Explicit hugepages are used when reserved,
+   * otherwise transparent hugepages are requested. Pages are placed on
+   * node of thread which touches them first.
+   */
+  class HugeBuffer {
+   public:
+    /// Size is rounded up to hugepage
+    explicit HugeBuffer(size_t size);
+    ~HugeBuffer();
+
+    HugeBuffer(const HugeBuffer &) = delete;
+    HugeBuffer &operator=(const HugeBuffer &) = delete;
+
+    /// Null if memory could not be mapped
+    uint8_t *data() const {
+      return data_;
+    }
+
+    size_t size() const {
+      return size_;
+    }
+
+    /// Whether explicit hugepages back buffer
+    bool explicitHuge() const {
+      return explicit_;
+    }
+
+   private:
+    uint8_t *data_{};
+    size_t size_{};
+    bool explicit_{false};
+  };
+}  // namespace fc::sector_storage::numa
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_NUMA_HPP
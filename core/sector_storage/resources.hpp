@@ -0,0 +1,65 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_RESOURCES_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_RESOURCES_HPP
+
+#include <string>
+#include <vector>
+
+#include "primitives/sector/sector.hpp"
+
+namespace fc::sector_storage {
+  using primitives::sector::RegisteredProof;
+
+  /// Sealing tasks, ordered by priority of finishing sectors in progress
+  enum class TaskType {
+    FINALIZE,
+    COMMIT2,
+    COMMIT1,
+    PRECOMMIT2,
+    PRECOMMIT1,
+    ADD_PIECE,
+    UNSEAL,
+  };
+
+  /// Resources required by task
+  struct Resources {
+    /// Memory which must be physically available
+    uint64_t min_memory{};
+    /// Memory which may be used, including swap
+    uint64_t max_memory{};
+    /// Cpu threads, kAllThreads for all threads of worker
+    int64_t threads{};
+    bool can_gpu{false};
+    /// Memory shared by tasks of same type, for example parameters
+    uint64_t base_min_memory{};
+  };
+
+  constexpr int64_t kAllThreads{-1};
+
+  /// Resources of worker
+  struct WorkerResources {
+    uint64_t physical_memory{};
+    uint64_t swap_memory{};
+    /// Memory used by other processes
+    uint64_t reserved_memory{};
+    uint64_t cpus{};
+    std::vector<std::string> gpus;
+  };
+
+  /**
+   * @brief resources required by task for seal proof
+   * @param task - sealing task
+   * @param seal_proof - seal proof type, defines sector size
+   */
+  outcome::result<Resources> getResources(TaskType task,
+                                          RegisteredProof seal_proof);
+
+  /// Memory and cpus of this machine, without gpus
+  WorkerResources localWorkerResources();
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_RESOURCES_HPP
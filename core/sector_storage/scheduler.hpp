@@ -0,0 +1,183 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_SCHEDULER_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_SCHEDULER_HPP
+
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+
+#include <boost/asio/thread_pool.hpp>
+#include <boost/optional.hpp>
+
+#include "common/logger.hpp"
+#include "common/tracing.hpp"
+#include "primitives/chain_epoch/chain_epoch.hpp"
+#include "sector_storage/worker.hpp"
+
+namespace fc::sector_storage {
+  using primitives::ChainEpoch;
+  using primitives::sector::SectorId;
+
+  /// Resources used by running tasks
+  struct ActiveResources {
+    uint64_t min_memory{};
+    uint64_t max_memory{};
+    uint64_t cpus{};
+    bool gpu_used{false};
+  };
+
+  /**
+   * Runs sealing tasks on local and remote workers within their resources.
+   * Queued tasks are started in order of sector deadline, then by task type,
+   * so sectors in progress are finished before new ones are started, then in
+   * order of scheduling. Tasks which do not fit into free resources of any
+   * worker wait for running tasks to finish. Tasks of sector after precommit1
+   * run on worker which holds sector files, until sector is finalized.
+   * Tasks which do not use all threads run pinned to least loaded NUMA node
+   * of this machine, with memory preferred from that node.
+   */
+  class Scheduler {
+   public:
+    using WorkerId = uint64_t;
+    using Work = std::function<void(Worker &)>;
+
+    /// Deadline of sectors without one
+    static constexpr ChainEpoch kNoDeadline{
+        std::numeric_limits<ChainEpoch>::max()};
+
+    /// Threads calling workers, remote calls occupy thread until finished
+    static constexpr size_t kDispatchThreads{32};
+
+    explicit Scheduler(RegisteredProof seal_proof,
+                       size_t threads = kDispatchThreads);
+
+    /// Waits for running tasks, queued tasks are dropped
+    ~Scheduler();
+
+    /// Registers worker with resources and tasks reported by it
+    outcome::result<WorkerId> addWorker(std::shared_ptr<Worker> worker);
+
+    /// Running tasks of worker are finished, queued tasks of its sectors wait
+    void removeWorker(WorkerId id);
+
+    /**
+     * @brief requests info of each worker, workers which fail are disabled
+     * until next successful check
+     */
+    void checkWorkers();
+
+    /**
+     * @brief sets epoch by which sector tasks should be finished, for
+     * example precommit expiration
+     */
+    void setDeadline(const SectorId &sector, ChainEpoch deadline);
+
+    void removeDeadline(const SectorId &sector);
+
+    /**
+     * @brief queues task
+     * @param work - called on dispatch thread with worker chosen for task
+     * @return error if task does not fit into any worker
+     */
+    outcome::result<void> schedule(const SectorId &sector,
+                                   TaskType type,
+                                   Work work);
+
+    /// Queues task and waits for its result
+    template <typename T>
+    outcome::result<T> run(
+        const SectorId &sector,
+        TaskType type,
+        const std::function<outcome::result<T>(Worker &)> &work) {
+      std::promise<outcome::result<T>> promise;
+      auto parent{common::tracing::Span::current()};
+      OUTCOME_TRY(schedule(
+          sector, type, [&promise, &work, parent](Worker &worker) {
+            // queue wait is time of caller span before this one
+            common::tracing::Span span{"scheduler.work", {}, parent};
+            promise.set_value(work(worker));
+          }));
+      return promise.get_future().get();
+    }
+
+    /// Number of queued tasks of type
+    size_t queued(TaskType type) const;
+
+    /// Resources used by tasks of worker
+    boost::optional<ActiveResources> active(WorkerId id) const;
+
+    /// Whether worker passed last health check
+    bool isEnabled(WorkerId id) const;
+
+   private:
+    static constexpr size_t kNoNode{std::numeric_limits<size_t>::max()};
+
+    struct Task {
+      SectorId sector;
+      TaskType type;
+      Resources need;
+      uint64_t seq;
+      Work work;
+      /// NUMA node of dispatch thread, kNoNode if not pinned
+      size_t node{kNoNode};
+    };
+
+    struct WorkerState {
+      std::shared_ptr<Worker> worker;
+      WorkerInfo info;
+      std::set<TaskType> tasks;
+      ActiveResources active;
+      bool enabled{true};
+    };
+
+    /// Cpus used by task while running
+    static uint64_t cpusOf(const WorkerState &worker, const Resources &need);
+
+    static bool canHandle(const WorkerState &worker,
+                          const Resources &need,
+                          const ActiveResources &active);
+
+    static void add(ActiveResources &active,
+                    const Resources &need,
+                    uint64_t cpus);
+
+    static void sub(ActiveResources &active,
+                    const Resources &need,
+                    uint64_t cpus);
+
+    /// Chooses worker for task, called under lock
+    boost::optional<WorkerId> selectWorker(const Task &task) const;
+
+    /// Starts queued tasks which fit, called under lock
+    void dispatch();
+
+    /// Least loaded NUMA node for task, called under lock
+    size_t selectNode(const Task &task, uint64_t cpus) const;
+
+    void finish(WorkerId id, const Task &task, uint64_t cpus);
+
+    RegisteredProof seal_proof_;
+
+    mutable std::mutex mutex_;
+    std::list<Task> queue_;
+    uint64_t next_seq_{};
+    std::map<WorkerId, WorkerState> workers_;
+    WorkerId next_worker_{};
+    /// Workers holding sector files
+    std::map<SectorId, WorkerId> sector_workers_;
+    std::map<SectorId, ChainEpoch> deadlines_;
+    /// Cpus used by pinned tasks, by NUMA node
+    std::vector<uint64_t> node_cpus_;
+    boost::asio::thread_pool pool_;
+    common::Logger logger_;
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_SCHEDULER_HPP
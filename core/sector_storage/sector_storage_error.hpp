@@ -21,6 +21,8 @@ namespace fc::sector_storage {
       CANNOT_CREATE_FILE,
       CANNOT_OPEN_FILE,
       OUT_OF_FILE_SIZE,
+      NO_RESOURCE_REQUIREMENTS,
+      NOT_ENOUGH_RESOURCES,
       UNKNOWN = 1000 };
 
 }  // namespace fc::sector_storage
@@ -0,0 +1,285 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/stores/impl/file_transfer.hpp"
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem.hpp>
+
+#include "sector_storage/stores/store_error.hpp"
+
+namespace fc::sector_storage::stores {
+  namespace fs = boost::filesystem;
+
+  /// Bytes copied between bandwidth checks
+  constexpr uint64_t kBlockSize{1 << 20};
+
+  namespace {
+    /// Closes descriptor on scope exit
+    struct Fd {
+      explicit Fd(int fd) : fd{fd} {}
+      Fd(const Fd &) = delete;
+      Fd &operator=(const Fd &) = delete;
+      ~Fd() {
+        if (fd >= 0) {
+          ::close(fd);
+        }
+      }
+      int fd;
+    };
+
+    std::string partPath(const path &to) {
+      return to.string() + ".part";
+    }
+
+    std::string journalPath(const path &to) {
+      return to.string() + ".part.journal";
+    }
+
+    /// Chunks recorded by interrupted transfer
+    std::set<uint64_t> readJournal(const path &to, uint64_t size) {
+      std::set<uint64_t> chunks;
+      boost::system::error_code ec;
+      if (!fs::exists(journalPath(to), ec)
+          || fs::file_size(partPath(to), ec) != size || ec) {
+        return chunks;
+      }
+      Fd journal{::open(journalPath(to).c_str(), O_RDONLY)};
+      uint64_t chunk;
+      while (::read(journal.fd, &chunk, sizeof(chunk)) == sizeof(chunk)) {
+        chunks.insert(boost::endian::little_to_native(chunk));
+      }
+      return chunks;
+    }
+  }  // namespace
+
+  FileTransfer::FileTransfer(TransferConfig config)
+      : config_{config}, next_{std::chrono::steady_clock::now()} {}
+
+  outcome::result<void> FileTransfer::move(const path &from,
+                                           const path &to,
+                                           const Progress &progress) {
+    boost::system::error_code ec;
+    fs::rename(from, to, ec);
+    if (!ec) {
+      return outcome::success();
+    }
+    if (ec != boost::system::errc::cross_device_link) {
+      return StoreErrors::CannotMoveSector;
+    }
+    OUTCOME_TRY(copy(from, to, progress));
+    fs::remove_all(from, ec);
+    if (ec) {
+      return StoreErrors::CannotRemoveSector;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> FileTransfer::copy(const path &from,
+                                           const path &to,
+                                           const Progress &progress) {
+    State state;
+    if (progress) {
+      state.progress = &progress;
+    }
+    try {
+      if (!fs::is_directory(from)) {
+        state.total = fs::file_size(from);
+        return copyFile(from, to, state);
+      }
+      std::vector<path> files;
+      fs::create_directories(to);
+      for (fs::recursive_directory_iterator it{from}, end; it != end; ++it) {
+        auto target = to / fs::relative(it->path(), from);
+        if (fs::is_directory(it->status())) {
+          fs::create_directories(target);
+        } else if (fs::is_regular_file(it->status())) {
+          state.total += fs::file_size(it->path());
+          files.push_back(it->path());
+        }
+      }
+      for (auto &file : files) {
+        OUTCOME_TRY(copyFile(file, to / fs::relative(file, from), state));
+      }
+    } catch (const fs::filesystem_error &) {
+      return StoreErrors::CannotCopyFile;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> FileTransfer::copyFile(const path &from,
+                                               const path &to,
+                                               State &state) {
+    auto size = fs::file_size(from);
+    auto report = [&](uint64_t bytes) {
+      state.done += bytes;
+      if (state.progress) {
+        (*state.progress)(state.done, state.total);
+      }
+    };
+    boost::system::error_code ec;
+    // copied by interrupted directory transfer
+    if (!fs::exists(partPath(to), ec) && fs::exists(to, ec)
+        && fs::file_size(to, ec) == size) {
+      report(size);
+      return outcome::success();
+    }
+
+    Fd in{::open(from.c_str(), O_RDONLY)};
+    auto copied = readJournal(to, size);
+    if (copied.empty()) {
+      fs::remove(journalPath(to), ec);
+    }
+    Fd out{::open(partPath(to).c_str(), O_WRONLY | O_CREAT, 0644)};
+    if (in.fd < 0 || out.fd < 0) {
+      return StoreErrors::CannotCopyFile;
+    }
+
+    auto finish = [&]() -> outcome::result<void> {
+      if (::fsync(out.fd) != 0) {
+        return StoreErrors::CannotCopyFile;
+      }
+      fs::rename(partPath(to), to, ec);
+      if (ec) {
+        return StoreErrors::CannotCopyFile;
+      }
+      fs::remove(journalPath(to), ec);
+      return outcome::success();
+    };
+
+    if (copied.empty() && ::ioctl(out.fd, FICLONE, in.fd) == 0) {
+      OUTCOME_TRY(finish());
+      report(size);
+      return outcome::success();
+    }
+
+    if (::ftruncate(out.fd, size) != 0) {
+      return StoreErrors::CannotCopyFile;
+    }
+    Fd journal{::open(
+        journalPath(to).c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644)};
+    if (journal.fd < 0) {
+      return StoreErrors::CannotCopyFile;
+    }
+
+    auto chunk_size = std::max<uint64_t>(config_.chunk_size, 1);
+    auto chunks = (size + chunk_size - 1) / chunk_size;
+    auto chunkBytes = [&](uint64_t chunk) {
+      return std::min(chunk_size, size - chunk * chunk_size);
+    };
+    {
+      std::lock_guard lock{state.mutex};
+      uint64_t resumed{};
+      for (auto chunk : copied) {
+        if (chunk < chunks) {
+          resumed += chunkBytes(chunk);
+        }
+      }
+      report(resumed);
+    }
+
+    std::atomic<uint64_t> next{0};
+    std::atomic<bool> failed{false};
+    auto worker = [&] {
+      auto fallback = false;
+      for (auto chunk = next++; chunk < chunks && !failed; chunk = next++) {
+        if (copied.count(chunk) != 0) {
+          continue;
+        }
+        auto bytes = chunkBytes(chunk);
+        if (!copyRange(in.fd, out.fd, chunk * chunk_size, bytes, fallback)
+            || ::fdatasync(out.fd) != 0) {
+          failed = true;
+          return;
+        }
+        std::lock_guard lock{state.mutex};
+        auto entry = boost::endian::native_to_little(chunk);
+        if (::write(journal.fd, &entry, sizeof(entry)) != sizeof(entry)) {
+          failed = true;
+          return;
+        }
+        report(bytes);
+      }
+    };
+    std::vector<std::thread> threads;
+    auto count = std::min<uint64_t>(std::max<size_t>(config_.threads, 1),
+                                    std::max<uint64_t>(chunks, 1));
+    for (auto i = 1u; i < count; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    if (failed) {
+      return StoreErrors::CannotCopyFile;
+    }
+    return finish();
+  }
+
+  outcome::result<void> FileTransfer::copyRange(
+      int in, int out, uint64_t offset, uint64_t size, bool &fallback) {
+    std::vector<uint8_t> buffer;
+    while (size != 0) {
+      auto block = std::min(size, kBlockSize);
+      throttle(block);
+      ssize_t n;
+      if (!fallback) {
+        loff_t in_offset = offset, out_offset = offset;
+        n = ::copy_file_range(in, &in_offset, out, &out_offset, block, 0);
+        if (n < 0 && errno != EINTR) {
+          // unsupported by kernel or filesystems
+          if (errno != EXDEV && errno != ENOSYS && errno != EINVAL
+              && errno != EOPNOTSUPP) {
+            return StoreErrors::CannotCopyFile;
+          }
+          fallback = true;
+        }
+      } else {
+        buffer.resize(block);
+        n = ::pread(in, buffer.data(), block, offset);
+        if (n > 0 && ::pwrite(out, buffer.data(), n, offset) != n) {
+          return StoreErrors::CannotCopyFile;
+        }
+        if (n < 0 && errno != EINTR) {
+          return StoreErrors::CannotCopyFile;
+        }
+      }
+      if (n == 0) {
+        // source was truncated
+        return StoreErrors::CannotCopyFile;
+      }
+      if (n > 0) {
+        offset += n;
+        size -= n;
+      }
+    }
+    return outcome::success();
+  }
+
+  void FileTransfer::throttle(uint64_t bytes) {
+    if (config_.bandwidth == 0) {
+      return;
+    }
+    std::chrono::steady_clock::time_point start;
+    {
+      std::lock_guard lock{throttle_mutex_};
+      start = std::max(std::chrono::steady_clock::now(), next_);
+      next_ = start
+              + std::chrono::nanoseconds{bytes * 1000000000
+                                         / config_.bandwidth};
+    }
+    std::this_thread::sleep_until(start);
+  }
+}  // namespace fc::sector_storage::stores
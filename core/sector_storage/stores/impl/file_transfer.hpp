@@ -0,0 +1,83 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_STORES_IMPL_FILE_TRANSFER_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_STORES_IMPL_FILE_TRANSFER_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+#include <boost/filesystem/path.hpp>
+
+#include "common/outcome.hpp"
+
+namespace fc::sector_storage::stores {
+  using boost::filesystem::path;
+
+  struct TransferConfig {
+    /// Bytes copied by one thread at once, unit of resume
+    uint64_t chunk_size{64 << 20};
+    /// Chunks of file copied concurrently
+    size_t threads{4};
+    /// Bytes per second of all transfers, zero for unlimited
+    uint64_t bandwidth{};
+  };
+
+  /**
+   * Moves sector files and directories between storage paths. Paths on same
+   * filesystem are renamed. Otherwise each file is reflinked if filesystem
+   * supports it, or copied in chunks by several threads with
+   * copy_file_range, falling back to read and write. Files are copied to
+   * ".part" files with journal of copied chunks, so interrupted transfer
+   * continues from copied chunks. Source is removed after whole destination
+   * is written.
+   */
+  class FileTransfer {
+   public:
+    /// Called with bytes copied and total bytes of transfer
+    using Progress = std::function<void(uint64_t done, uint64_t total)>;
+
+    explicit FileTransfer(TransferConfig config = {});
+
+    /// Moves file or directory
+    outcome::result<void> move(const path &from,
+                               const path &to,
+                               const Progress &progress = {});
+
+    /// Copies file or directory, existing destination files are replaced
+    outcome::result<void> copy(const path &from,
+                               const path &to,
+                               const Progress &progress = {});
+
+   private:
+    struct State {
+      uint64_t done{};
+      uint64_t total{};
+      const Progress *progress{};
+      std::mutex mutex;
+    };
+
+    outcome::result<void> copyFile(const path &from,
+                                   const path &to,
+                                   State &state);
+
+    /// Copies range of file, without changing file offsets
+    outcome::result<void> copyRange(int in,
+                                    int out,
+                                    uint64_t offset,
+                                    uint64_t size,
+                                    bool &fallback);
+
+    /// Waits until bytes fit into bandwidth
+    void throttle(uint64_t bytes);
+
+    TransferConfig config_;
+    std::mutex throttle_mutex_;
+    std::chrono::steady_clock::time_point next_;
+  };
+}  // namespace fc::sector_storage::stores
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_STORES_IMPL_FILE_TRANSFER_HPP
@@ -5,21 +5,103 @@
 
 #include "sector_storage/stores/impl/index_impl.hpp"
 
+#include <algorithm>
 #include <boost/filesystem/path.hpp>
 #include <regex>
+#include <tuple>
 #include "common/uri_parser/uri_parser.hpp"
 #include "primitives/types.hpp"
 
 namespace fc::sector_storage::stores {
 
+  using common::Buffer;
   using fc::common::HttpUri;
   using fc::primitives::TokenAmount;
   using primitives::sector_file::sectorName;
   using std::chrono::system_clock;
 
-  std::string toSectorsID(const SectorId &sector_id,
-                          const SectorFileType &file_type) {
-    return sectorName(sector_id) + "_" + toString(file_type);
+  namespace {
+    uint64_t freeSpace(const StorageEntry &entry) {
+      return entry.fs_stat.available > entry.reserved
+                 ? entry.fs_stat.available - entry.reserved
+                 : 0;
+    }
+
+    /// Points storage urls to sector file
+    outcome::result<StorageInfo> sectorStorageInfo(
+        StorageInfo store,
+        const SectorId &sector,
+        const SectorFileType &file_type) {
+      for (auto &url : store.urls) {
+        HttpUri uri;
+        try {
+          uri.parse(url);
+        } catch (const std::runtime_error &err) {
+          return IndexErrors::InvalidUrl;
+        }
+        boost::filesystem::path path = uri.path();
+        path = path / toString(file_type) / sectorName(sector);
+        uri.setPath(path.string());
+        url = uri.str();
+      }
+      return store;
+    }
+
+    /// Miner, sector number and file type, big-endian so keys sort as sectors
+    constexpr size_t kSectorKeySize{17};
+
+    /// Datastore key of sector file declared in storage, value is empty
+    Buffer declarationKey(const SectorId &sector,
+                          SectorFileType type,
+                          const StorageID &storage_id) {
+      Buffer key;
+      key.putUint64(sector.miner)
+          .putUint64(sector.sector)
+          .putUint8(type)
+          .put(storage_id);
+      return key;
+    }
+
+    uint64_t readUint64(const uint8_t *bytes) {
+      uint64_t value{};
+      for (auto i{0}; i < 8; ++i) {
+        value = (value << 8) | bytes[i];
+      }
+      return value;
+    }
+  }  // namespace
+
+  outcome::result<std::shared_ptr<SectorIndexImpl>> SectorIndexImpl::load(
+      std::shared_ptr<Datastore> datastore) {
+    auto index{std::make_shared<SectorIndexImpl>()};
+    auto cursor{datastore->cursor()};
+    for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
+      auto key{cursor->key()};
+      if (key.size() <= kSectorKeySize) {
+        return IndexErrors::InvalidRecord;
+      }
+      SectorKey sector_key{
+          .sector = {.miner = readUint64(key.data()),
+                     .sector = readUint64(key.data() + 8)},
+          .type = static_cast<SectorFileType>(key[16]),
+      };
+      index->sectors_[sector_key].emplace_back(key.begin() + kSectorKeySize,
+                                               key.end());
+    }
+    index->datastore_ = std::move(datastore);
+    return index;
+  }
+
+  bool SectorIndexImpl::SectorKeyLess::operator()(const SectorKey &lhs,
+                                                  const SectorKey &rhs) const {
+    return std::tie(lhs.sector, lhs.type) < std::tie(rhs.sector, rhs.type);
+  }
+
+  void SectorIndexImpl::updateAllocOrder(const StorageID &storage_id,
+                                         StorageEntry &entry) {
+    alloc_order_.erase({entry.alloc_weight, storage_id});
+    entry.alloc_weight = TokenAmount(freeSpace(entry)) * entry.info.weight;
+    alloc_order_.emplace(entry.alloc_weight, storage_id);
   }
 
   bool isValidUrl(const std::string &url) {
@@ -32,7 +114,7 @@ namespace fc::sector_storage::stores {
 
   outcome::result<void> SectorIndexImpl::storageAttach(
       const StorageInfo &storage_info, const FsStat &stat) {
-    std::unique_lock lock(mutex_);
+    std::unique_lock lock(stores_mutex_);
     for (const auto &new_url : storage_info.urls) {
       if (!isValidUrl(new_url)) {
         return IndexErrors::InvalidUrl;
@@ -57,18 +139,19 @@ namespace fc::sector_storage::stores {
       return outcome::success();
     }
 
-    stores_[storage_info.id] = StorageEntry{
+    auto &entry = stores_[storage_info.id] = StorageEntry{
         .info = storage_info,
         .fs_stat = stat,
         .last_heartbeat = system_clock::now(),
         .error = {},
     };
+    updateAllocOrder(storage_info.id, entry);
     return outcome::success();
   }
 
   outcome::result<StorageInfo> SectorIndexImpl::getStorageInfo(
       const StorageID &storage_id) const {
-    std::shared_lock lock(mutex_);
+    std::shared_lock lock(stores_mutex_);
     auto maybe_storage = stores_.find(storage_id);
     if (maybe_storage == stores_.end()) return IndexErrors::StorageNotFound;
     return maybe_storage->second.info;
@@ -76,13 +159,75 @@ namespace fc::sector_storage::stores {
 
   outcome::result<void> SectorIndexImpl::storageReportHealth(
       const StorageID &storage_id, const HealthReport &report) {
-    std::unique_lock lock(mutex_);
+    std::unique_lock lock(stores_mutex_);
     auto storage_iter = stores_.find(storage_id);
     if (storage_iter == stores_.end()) return IndexErrors::StorageNotFound;
 
     storage_iter->second.fs_stat = report.stat;
     storage_iter->second.error = report.error;
     storage_iter->second.last_heartbeat = system_clock::now();
+    updateAllocOrder(storage_id, storage_iter->second);
+
+    return outcome::success();
+  }
+
+  outcome::result<void> SectorIndexImpl::storageReportTransfer(
+      const StorageID &storage_id, const TransferProgress &progress) {
+    std::unique_lock lock(stores_mutex_);
+    auto storage_iter = stores_.find(storage_id);
+    if (storage_iter == stores_.end()) return IndexErrors::StorageNotFound;
+
+    auto &transfers = storage_iter->second.transfers;
+    auto transfer_iter =
+        std::find_if(transfers.begin(), transfers.end(), [&](auto &transfer) {
+          return transfer.sector == progress.sector
+                 && transfer.type == progress.type;
+        });
+    if (progress.done >= progress.total) {
+      if (transfer_iter != transfers.end()) {
+        transfers.erase(transfer_iter);
+      }
+    } else if (transfer_iter == transfers.end()) {
+      transfers.push_back(progress);
+    } else {
+      *transfer_iter = progress;
+    }
+
+    return outcome::success();
+  }
+
+  outcome::result<std::vector<TransferProgress>>
+  SectorIndexImpl::storageGetTransfers(const StorageID &storage_id) const {
+    std::shared_lock lock(stores_mutex_);
+    auto storage_iter = stores_.find(storage_id);
+    if (storage_iter == stores_.end()) return IndexErrors::StorageNotFound;
+    return storage_iter->second.transfers;
+  }
+
+  outcome::result<void> SectorIndexImpl::storageReserve(
+      const StorageID &storage_id, uint64_t size) {
+    std::unique_lock lock(stores_mutex_);
+    auto storage_iter = stores_.find(storage_id);
+    if (storage_iter == stores_.end()) return IndexErrors::StorageNotFound;
+
+    if (size > freeSpace(storage_iter->second)) {
+      return IndexErrors::NotEnoughSpace;
+    }
+    storage_iter->second.reserved += size;
+    updateAllocOrder(storage_id, storage_iter->second);
+
+    return outcome::success();
+  }
+
+  outcome::result<void> SectorIndexImpl::storageReleaseReservation(
+      const StorageID &storage_id, uint64_t size) {
+    std::unique_lock lock(stores_mutex_);
+    auto storage_iter = stores_.find(storage_id);
+    if (storage_iter == stores_.end()) return IndexErrors::StorageNotFound;
+
+    auto &reserved = storage_iter->second.reserved;
+    reserved -= std::min(reserved, size);
+    updateAllocOrder(storage_id, storage_iter->second);
 
     return outcome::success();
   }
@@ -91,28 +236,22 @@ namespace fc::sector_storage::stores {
       const StorageID &storage_id,
       const SectorId &sector,
       const SectorFileType &file_type) {
-    std::unique_lock lock(mutex_);
+    std::unique_lock lock(sectors_mutex_);
 
     for (const auto &type : primitives::sector_file::kSectorFileTypes) {
       if ((file_type & type) == 0) {
         continue;
       }
 
-      std::string sector_id = toSectorsID(sector, type);
-
-      auto sector_iter = sectors_.find(sector_id);
-      if (sector_iter == sectors_.end()) {
-        sectors_[sector_id] = {};
-        sector_iter = sectors_.find(sector_id);
-      }
-      for (const auto &s_id : sector_iter->second) {
-        if (storage_id == s_id) {
-          // already there
-          return outcome::success();
+      auto &storages = sectors_[SectorKey{sector, type}];
+      if (std::find(storages.begin(), storages.end(), storage_id)
+          == storages.end()) {
+        if (datastore_) {
+          OUTCOME_TRY(datastore_->put(declarationKey(sector, type, storage_id),
+                                      Buffer{}));
         }
+        storages.push_back(storage_id);
       }
-
-      sector_iter->second.push_back(storage_id);
     }
 
     return outcome::success();
@@ -122,107 +261,95 @@ namespace fc::sector_storage::stores {
       const StorageID &storage_id,
       const SectorId &sector,
       const fc::primitives::sector_file::SectorFileType &file_type) {
-    std::unique_lock lock(mutex_);
+    std::unique_lock lock(sectors_mutex_);
 
     for (const auto &type : primitives::sector_file::kSectorFileTypes) {
       if ((file_type & type) == 0) {
         continue;
       }
 
-      std::string sector_id = toSectorsID(sector, type);
-
-      auto sector_iter = sectors_.find(sector_id);
+      auto sector_iter = sectors_.find(SectorKey{sector, type});
       if (sector_iter == sectors_.end()) {
-        return outcome::success();
+        continue;
       }
-      std::vector<StorageID> sectors;
-      for (const auto &s_id : sector_iter->second) {
-        if (storage_id == s_id) {
-          continue;
-        }
-        sectors.push_back(s_id);
+      auto &storages = sector_iter->second;
+      auto storage_iter{
+          std::find(storages.begin(), storages.end(), storage_id)};
+      if (storage_iter == storages.end()) {
+        continue;
       }
-      if (sectors.size() == 0) {
+      if (datastore_) {
+        OUTCOME_TRY(
+            datastore_->remove(declarationKey(sector, type, storage_id)));
+      }
+      storages.erase(storage_iter);
+      if (storages.empty()) {
         sectors_.erase(sector_iter);
-        return outcome::success();
       }
-
-      sector_iter->second = sectors;
     }
 
     return outcome::success();
   }
 
+  outcome::result<std::vector<SectorDeclaration>>
+  SectorIndexImpl::storageSectors(const StorageID &storage_id) const {
+    std::shared_lock lock(sectors_mutex_);
+    std::vector<SectorDeclaration> result;
+    for (const auto &[key, storages] : sectors_) {
+      if (std::find(storages.begin(), storages.end(), storage_id)
+          != storages.end()) {
+        result.push_back(SectorDeclaration{key.sector, key.type});
+      }
+    }
+    return result;
+  }
+
   outcome::result<std::vector<StorageInfo>> SectorIndexImpl::storageFindSector(
       const SectorId &sector,
       const fc::primitives::sector_file::SectorFileType &file_type,
       bool allow_fetch) {
-    std::shared_lock lock(mutex_);
     std::unordered_map<StorageID, uint64_t> storage_ids;
+    {
+      std::shared_lock lock(sectors_mutex_);
+      for (const auto &type : primitives::sector_file::kSectorFileTypes) {
+        if ((file_type & type) == 0) {
+          continue;
+        }
 
-    for (const auto &type : primitives::sector_file::kSectorFileTypes) {
-      if ((file_type & type) == 0) {
-        continue;
-      }
-
-      std::string sector_id = toSectorsID(sector, type);
-      auto sector_iter = sectors_.find(sector_id);
-      if (sector_iter == sectors_.end()) {
-        continue;
-      }
-      for (const auto &id : sector_iter->second) {
-        ++storage_ids[id];
+        auto sector_iter = sectors_.find(SectorKey{sector, type});
+        if (sector_iter == sectors_.end()) {
+          continue;
+        }
+        for (const auto &id : sector_iter->second) {
+          ++storage_ids[id];
+        }
       }
     }
 
+    std::shared_lock lock(stores_mutex_);
     std::vector<StorageInfo> result;
     for (const auto &[id, count] : storage_ids) {
-      if (stores_.find(id) == stores_.end()) {
-        // logger
+      auto storage_iter = stores_.find(id);
+      if (storage_iter == stores_.end()) {
         continue;
       }
 
-      auto store = stores_[id].info;
-
-      for (uint64_t i = 0; i < store.urls.size(); i++) {
-        HttpUri uri;
-        try {
-          uri.parse(store.urls[i]);
-        } catch (const std::runtime_error &err) {
-          return IndexErrors::InvalidUrl;
-        }
-        boost::filesystem::path path = uri.path();
-        path = path / toString(file_type) / sectorName(sector);
-        uri.setPath(path.string());
-        store.urls[i] = uri.str();
-      }
-
+      OUTCOME_TRY(
+          store,
+          sectorStorageInfo(storage_iter->second.info, sector, file_type));
       store.weight = store.weight * count;
-      result.push_back(store);
+      result.push_back(std::move(store));
     }
 
     if (allow_fetch) {
-      for (const auto &[id, storage_info] : stores_) {
+      for (const auto &[id, storage] : stores_) {
         if (storage_ids.find(id) != storage_ids.end()) {
           continue;
         }
-        auto store = stores_[id].info;
-
-        for (uint64_t i = 0; i < store.urls.size(); i++) {
-          HttpUri uri;
-          try {
-            uri.parse(store.urls[i]);
-          } catch (const std::runtime_error &err) {
-            return IndexErrors::InvalidUrl;
-          }
-          boost::filesystem::path path = uri.path();
-          path = path / toString(file_type) / sectorName(sector);
-          uri.setPath(path.string());
-          store.urls[i] = uri.str();
-        }
 
+        OUTCOME_TRY(store, sectorStorageInfo(storage.info, sector, file_type));
         store.weight = 0;
-        result.push_back(store);
+        result.push_back(std::move(store));
       }
     }
 
@@ -233,15 +360,16 @@ namespace fc::sector_storage::stores {
       const fc::primitives::sector_file::SectorFileType &allocate,
       fc::primitives::sector::RegisteredProof seal_proof_type,
       bool sealing) {
-    std::shared_lock lock(mutex_);
-
     OUTCOME_TRY(
         req_space,
         fc::primitives::sector_file::sealSpaceUse(allocate, seal_proof_type));
 
-    std::vector<StorageEntry> candidates;
+    std::shared_lock lock(stores_mutex_);
+    auto now = system_clock::now();
+    std::vector<StorageInfo> result;
 
-    for (const auto &[id, storage] : stores_) {
+    for (const auto &entry : alloc_order_) {
+      const auto &storage = stores_.at(entry.second);
       if (sealing && !storage.info.can_seal) {
         continue;
       }
@@ -249,12 +377,11 @@ namespace fc::sector_storage::stores {
         continue;
       }
 
-      if (req_space > storage.fs_stat.available) {
+      if (req_space > freeSpace(storage)) {
         continue;
       }
 
-      if (system_clock::now() - storage.last_heartbeat
-          > kSkippedHeartbeatThreshold) {
+      if (now - storage.last_heartbeat > kSkippedHeartbeatThreshold) {
         continue;
       }
 
@@ -262,27 +389,13 @@ namespace fc::sector_storage::stores {
         continue;
       }
 
-      candidates.push_back(storage);
+      result.push_back(storage.info);
     }
 
-    if (candidates.empty()) {
+    if (result.empty()) {
       return IndexErrors::NoSuitableCandidate;
     }
 
-    std::sort(candidates.begin(),
-              candidates.end(),
-              [](const StorageEntry &lhs, const StorageEntry &rhs) {
-                auto lw = TokenAmount(lhs.fs_stat.available) * lhs.info.weight;
-                auto rw = TokenAmount(rhs.fs_stat.available) * rhs.info.weight;
-                return lw < rw;
-              });
-
-    std::vector<StorageInfo> result;
-
-    for (const auto &candidate : candidates) {
-      result.emplace_back(candidate.info);
-    }
-
     return result;
   }
 
@@ -297,6 +410,10 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::sector_storage::stores, IndexErrors, e) {
       return "Sector Index: not found a suitable storage";
     case (IndexErrors::InvalidUrl):
       return "Sector Index: failed to parse url";
+    case (IndexErrors::NotEnoughSpace):
+      return "Sector Index: not enough free space in storage";
+    case (IndexErrors::InvalidRecord):
+      return "Sector Index: invalid persisted declaration";
     default:
       return "Sector Index: unknown error";
   }
@@ -7,7 +7,10 @@
 #define CPP_FILECOIN_INDEX_IMPL_HPP
 
 #include "sector_storage/stores/index.hpp"
+#include "storage/buffer_map.hpp"
 
+#include <map>
+#include <set>
 #include <shared_mutex>
 #include <unordered_map>
 
@@ -19,10 +22,35 @@ namespace fc::sector_storage::stores {
 
     system_clock::time_point last_heartbeat;
     boost::optional<std::string> error;
+    std::vector<TransferProgress> transfers;
+    /// Space reserved by allocations in progress
+    uint64_t reserved{};
+    /// Key of storage in allocation order
+    primitives::TokenAmount alloc_weight;
   };
 
+  /**
+   * Index of storages and sectors declared in them.
+   * Sector declarations may be persisted in datastore, so restarted miner
+   * finds sectors without rescan of storages. Storages are attached again
+   * with current stat on start, declarations of unknown storage are
+   * ignored until it is attached.
+   */
   class SectorIndexImpl : public SectorIndex {
    public:
+    using Datastore = storage::PersistentBufferMap;
+
+    /// Index kept only in memory
+    SectorIndexImpl() = default;
+
+    /**
+     * @brief creates index with declarations restored from datastore,
+     * declarations are written to datastore on change
+     * @param datastore - dedicated to index
+     */
+    static outcome::result<std::shared_ptr<SectorIndexImpl>> load(
+        std::shared_ptr<Datastore> datastore);
+
     outcome::result<void> storageAttach(const StorageInfo &storage_info,
                                         const FsStat &stat) override;
 
@@ -32,6 +60,19 @@ namespace fc::sector_storage::stores {
     outcome::result<void> storageReportHealth(
         const StorageID &storage_id, const HealthReport &report) override;
 
+    outcome::result<void> storageReportTransfer(
+        const StorageID &storage_id,
+        const TransferProgress &progress) override;
+
+    outcome::result<std::vector<TransferProgress>> storageGetTransfers(
+        const StorageID &storage_id) const override;
+
+    outcome::result<void> storageReserve(const StorageID &storage_id,
+                                         uint64_t size) override;
+
+    outcome::result<void> storageReleaseReservation(
+        const StorageID &storage_id, uint64_t size) override;
+
     outcome::result<void> storageDeclareSector(
         const StorageID &storage_id,
         const SectorId &sector,
@@ -42,6 +83,9 @@ namespace fc::sector_storage::stores {
         const SectorId &sector,
         const SectorFileType &file_type) override;
 
+    outcome::result<std::vector<SectorDeclaration>> storageSectors(
+        const StorageID &storage_id) const override;
+
     outcome::result<std::vector<StorageInfo>> storageFindSector(
         const SectorId &sector,
         const SectorFileType &file_type,
@@ -53,9 +97,28 @@ namespace fc::sector_storage::stores {
         bool sealing) override;
 
    private:
-    mutable std::shared_mutex mutex_;
+    struct SectorKey {
+      SectorId sector;
+      SectorFileType type;
+    };
+
+    struct SectorKeyLess {
+      bool operator()(const SectorKey &lhs, const SectorKey &rhs) const;
+    };
+
+    /// Recomputes position of storage in allocation order
+    void updateAllocOrder(const StorageID &storage_id, StorageEntry &entry);
+
+    /// Guards stores and allocation order, never held with sectors mutex
+    mutable std::shared_mutex stores_mutex_;
     std::unordered_map<StorageID, StorageEntry> stores_;
-    std::unordered_map<std::string, std::vector<StorageID>> sectors_;
+    /// Storages ascending by free space multiplied by weight
+    std::set<std::pair<primitives::TokenAmount, StorageID>> alloc_order_;
+
+    mutable std::shared_mutex sectors_mutex_;
+    std::map<SectorKey, std::vector<StorageID>, SectorKeyLess> sectors_;
+    /// Persisted declarations, written under sectors mutex
+    std::shared_ptr<Datastore> datastore_;
   };
 }  // namespace fc::sector_storage::stores
 
@@ -9,6 +9,8 @@
 #include <boost/filesystem.hpp>
 #include <fstream>
 #include <regex>
+#include <set>
+#include <thread>
 #include <utility>
 #include "api/rpc/json.hpp"
 #include "primitives/sector_file/sector_file.hpp"
@@ -39,10 +41,12 @@ namespace fc::sector_storage::stores {
 
   LocalStore::LocalStore(std::shared_ptr<LocalStorage> storage,
                          std::shared_ptr<SectorIndex> index,
-                         gsl::span<std::string> urls)
+                         gsl::span<std::string> urls,
+                         TransferConfig transfer_config)
       : storage_(std::move(storage)),
         index_(std::move(index)),
-        urls_(urls.begin(), urls.end()) {
+        urls_(urls.begin(), urls.end()),
+        transfer_(transfer_config) {
     logger_ = common::createLogger("Local Store");
   }
 
@@ -108,61 +112,141 @@ namespace fc::sector_storage::stores {
   outcome::result<void> LocalStore::moveStorage(SectorId sector,
                                                 RegisteredProof seal_proof_type,
                                                 SectorFileType types) {
-    std::unique_lock lock(mutex_);
-    OUTCOME_TRY(
-        dest,
-        acquireSectorWithoutLock(
-            sector, seal_proof_type, SectorFileType::FTNone, types, false));
-
-    OUTCOME_TRY(
-        src,
-        acquireSectorWithoutLock(
-            sector, seal_proof_type, types, SectorFileType::FTNone, false));
+    struct Move {
+      SectorFileType type;
+      StorageID source_storage_id;
+      StorageID dest_storage_id;
+      std::string source_path;
+      std::string dest_path;
+    };
+    std::vector<Move> moves;
+    {
+      std::unique_lock lock(mutex_);
+      OUTCOME_TRY(
+          dest,
+          acquireSectorWithoutLock(
+              sector, seal_proof_type, SectorFileType::FTNone, types, false));
+
+      OUTCOME_TRY(
+          src,
+          acquireSectorWithoutLock(
+              sector, seal_proof_type, types, SectorFileType::FTNone, false));
+
+      for (const auto &type : kSectorFileTypes) {
+        if ((types & type) == 0) {
+          continue;
+        }
 
-    for (const auto &type : kSectorFileTypes) {
-      if ((types & type) == 0) {
-        continue;
-      }
+        OUTCOME_TRY(source_storage_id, src.stores.getPathByType(type));
+        OUTCOME_TRY(sst, index_->getStorageInfo(source_storage_id));
 
-      OUTCOME_TRY(source_storage_id, src.stores.getPathByType(type));
-      OUTCOME_TRY(sst, index_->getStorageInfo(source_storage_id));
+        OUTCOME_TRY(dest_storage_id, dest.stores.getPathByType(type));
+        OUTCOME_TRY(dst, index_->getStorageInfo(dest_storage_id));
 
-      OUTCOME_TRY(dest_storage_id, dest.stores.getPathByType(type));
-      OUTCOME_TRY(dst, index_->getStorageInfo(dest_storage_id));
+        if (sst.id == dst.id) {
+          continue;
+        }
 
-      if (sst.id == dst.id) {
-        continue;
-      }
+        if (sst.can_store) {
+          continue;
+        }
 
-      if (sst.can_store) {
-        continue;
+        OUTCOME_TRY(source_path, src.paths.getPathByType(type));
+        OUTCOME_TRY(dest_path, dest.paths.getPathByType(type));
+        moves.push_back(
+            {type, source_storage_id, dest_storage_id, source_path, dest_path});
       }
-      OUTCOME_TRY(index_->storageDropSector(source_storage_id, sector, type));
-
-      OUTCOME_TRY(source_path, src.paths.getPathByType(type));
-      OUTCOME_TRY(dest_path, dest.paths.getPathByType(type));
+    }
 
-      boost::system::error_code ec;
-      boost::filesystem::rename(source_path, dest_path, ec);
-      if (ec.failed()) {
+    // sector stays declared in source storage until it is copied
+    for (const auto &move : moves) {
+      auto progress = [&](uint64_t done, uint64_t total) {
+        auto reported = index_->storageReportTransfer(
+            move.dest_storage_id, {sector, move.type, done, total});
+        if (!reported) {
+          logger_->warn("Report transfer: " + reported.error().message());
+        }
+      };
+      auto moved = transfer_.move(move.source_path, move.dest_path, progress);
+      if (!moved) {
+        logger_->error("Move " + move.source_path + ": "
+                       + moved.error().message());
         return StoreErrors::CannotMoveSector;
       }
 
-      OUTCOME_TRY(index_->storageDeclareSector(dest_storage_id, sector, type));
+      OUTCOME_TRY(
+          index_->storageDropSector(move.source_storage_id, sector, move.type));
+
+      OUTCOME_TRY(index_->storageDeclareSector(
+          move.dest_storage_id, sector, move.type));
     }
 
     return outcome::success();
   }
 
   outcome::result<FsStat> LocalStore::getFsStat(fc::primitives::StorageID id) {
-    std::shared_lock lock(mutex_);
+    std::string path;
+    {
+      std::shared_lock lock(mutex_);
+      auto path_iter = paths_.find(id);
+      if (path_iter == paths_.end()) {
+        return StoreErrors::NotFoundStorage;
+      }
+      path = path_iter->second;
+    }
+    {
+      std::lock_guard lock{stats_mutex_};
+      auto stat_iter = stats_.find(id);
+      if (stat_iter != stats_.end()) {
+        return stat_iter->second;
+      }
+    }
+    return storage_->getStat(path);
+  }
 
-    auto path_iter = paths_.find(id);
-    if (path_iter == paths_.end()) {
-      return StoreErrors::NotFoundStorage;
+  void LocalStore::heartbeat() {
+    std::vector<std::pair<StorageID, std::string>> paths;
+    {
+      std::shared_lock lock(mutex_);
+      paths.assign(paths_.begin(), paths_.end());
     }
+    for (const auto &[id, path] : paths) {
+      HealthReport report;
+      auto stat = storage_->getStat(path);
+      {
+        std::lock_guard lock{stats_mutex_};
+        if (stat) {
+          stats_[id] = stat.value();
+        } else {
+          report.error = stat.error().message();
+        }
+        report.stat = stats_[id];
+      }
+      auto reported = index_->storageReportHealth(id, report);
+      if (!reported) {
+        logger_->warn("Report health of " + id + ": "
+                      + reported.error().message());
+      }
+    }
+  }
 
-    return storage_->getStat(path_iter->second);
+  void LocalStore::startHeartbeat(boost::asio::executor executor) {
+    heartbeat_timer_.emplace(std::move(executor));
+    scheduleHeartbeat();
+  }
+
+  void LocalStore::scheduleHeartbeat() {
+    heartbeat_timer_->expires_after(kHeartbeatInterval);
+    heartbeat_timer_->async_wait(
+        [weak{weak_from_this()}](const boost::system::error_code &ec) {
+          if (ec) {
+            return;
+          }
+          if (auto self = weak.lock()) {
+            self->heartbeat();
+            self->scheduleHeartbeat();
+          }
+        });
   }
 
   outcome::result<void> LocalStore::openPath(const std::string &path) {
@@ -209,31 +293,77 @@ namespace fc::sector_storage::stores {
         if (!boost::filesystem::create_directories(dir_path)) {
           return StoreErrors::CannotCreateDir;
         }
-        continue;
       }
+    }
+
+    OUTCOME_TRY(declared, index_->storageSectors(meta.id));
+    if (declared.empty()) {
+      OUTCOME_TRY(declareSectors(meta.id, path, declared));
+    } else {
+      // rescan of large storage takes long, index already knows sectors
+      std::thread{[weak{weak_from_this()},
+                   id{meta.id},
+                   path,
+                   declared{std::move(declared)}] {
+        if (auto self{weak.lock()}) {
+          auto verified{self->declareSectors(id, path, declared)};
+          if (!verified) {
+            self->logger_->error("Verify sectors of " + id + ": "
+                                 + verified.error().message());
+          }
+        }
+      }}.detach();
+    }
 
-      boost::filesystem::directory_iterator dir_iter(dir_path), end;
+    paths_[meta.id] = path;
+    {
+      std::lock_guard stats_lock{stats_mutex_};
+      stats_[meta.id] = stat;
+    }
+
+    return outcome::success();
+  }
+
+  outcome::result<void> LocalStore::declareSectors(
+      const StorageID &storage_id,
+      const std::string &path,
+      const std::vector<SectorDeclaration> &declared) const {
+    auto root = boost::filesystem::path(path);
+    std::set<std::pair<SectorId, SectorFileType>> found;
+    for (const auto &type : kSectorFileTypes) {
+      boost::filesystem::directory_iterator dir_iter(root / toString(type)),
+          end;
       while (dir_iter != end) {
         OUTCOME_TRY(sector,
                     parseSectorId(dir_iter->path().filename().string()));
 
-        OUTCOME_TRY(index_->storageDeclareSector(meta.id, sector, type));
+        OUTCOME_TRY(index_->storageDeclareSector(storage_id, sector, type));
+        found.emplace(sector, type);
 
         ++dir_iter;
       }
     }
 
-    paths_[meta.id] = path;
-
+    for (const auto &declaration : declared) {
+      if (found.count({declaration.sector, declaration.type}) == 0) {
+        logger_->warn("Sector "
+                      + primitives::sector_file::sectorName(declaration.sector)
+                      + " " + toString(declaration.type) + " is missing in "
+                      + storage_id);
+        OUTCOME_TRY(index_->storageDropSector(
+            storage_id, declaration.sector, declaration.type));
+      }
+    }
     return outcome::success();
   }
 
   outcome::result<std::shared_ptr<LocalStore>> LocalStore::newLocalStore(
       std::shared_ptr<LocalStorage> storage,
       std::shared_ptr<SectorIndex> index,
-      gsl::span<std::string> urls) {
-    std::shared_ptr<LocalStore> local(
-        new LocalStore(std::move(storage), std::move(index), urls));
+      gsl::span<std::string> urls,
+      TransferConfig transfer_config) {
+    std::shared_ptr<LocalStore> local(new LocalStore(
+        std::move(storage), std::move(index), urls, transfer_config));
 
     if (local->logger_ == nullptr) {
       return StoreErrors::CannotInitLogger;
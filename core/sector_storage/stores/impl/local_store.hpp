@@ -8,8 +8,12 @@
 
 #include "sector_storage/stores/store.hpp"
 
+#include <boost/asio/executor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <mutex>
 #include <shared_mutex>
 #include "common/logger.hpp"
+#include "sector_storage/stores/impl/file_transfer.hpp"
 #include "sector_storage/stores/index.hpp"
 
 namespace fc::sector_storage::stores {
@@ -26,13 +30,25 @@ namespace fc::sector_storage::stores {
   const std::string kMetaFileName = "sectorstore.json";
 
   // TODO(artyom-yurin): [FIL-231] Health Report for storages
-  class LocalStore : public Store {
+  class LocalStore : public Store,
+                     public std::enable_shared_from_this<LocalStore> {
    public:
+    /**
+     * @param transfer_config - pace of moving sector files between storages
+     * on different filesystems
+     */
     static outcome::result<std::shared_ptr<LocalStore>> newLocalStore(
         std::shared_ptr<LocalStorage> storage,
         std::shared_ptr<SectorIndex> index,
-        gsl::span<std::string> urls);
-
+        gsl::span<std::string> urls,
+        TransferConfig transfer_config = {});
+
+    /**
+     * @brief attaches storage and declares its sectors. Storage with
+     * declarations restored by index is usable at once, its sectors are
+     * verified on background thread: missing ones are dropped from index,
+     * unknown ones are declared.
+     */
     outcome::result<void> openPath(const std::string &path);
 
     outcome::result<AcquireSectorResponse> acquireSector(
@@ -44,16 +60,37 @@ namespace fc::sector_storage::stores {
 
     outcome::result<void> remove(SectorId sector, SectorFileType type) override;
 
+    /**
+     * @brief moves sector files to storages for long term storing, store is
+     * not locked while files are copied, progress of copy is reported to
+     * index
+     */
     outcome::result<void> moveStorage(SectorId sector,
                                       RegisteredProof seal_proof_type,
                                       SectorFileType types) override;
 
+    /// Stat of last heartbeat, so allocation doesn't wait for filesystem
     outcome::result<FsStat> getFsStat(StorageID id) override;
 
+    /**
+     * @brief refreshes stats of all storages and reports their health to
+     * index, store is not locked while filesystems are queried
+     */
+    void heartbeat();
+
+    /**
+     * @brief runs heartbeat every kHeartbeatInterval, so index keeps
+     * storages available for allocation
+     * @param executor - runs stat calls, e.g. blocking threads, as stat of
+     * network filesystem may be slow
+     */
+    void startHeartbeat(boost::asio::executor executor);
+
    private:
     LocalStore(std::shared_ptr<LocalStorage> storage,
                std::shared_ptr<SectorIndex> index,
-               gsl::span<std::string> urls);
+               gsl::span<std::string> urls,
+               TransferConfig transfer_config);
 
     outcome::result<AcquireSectorResponse> acquireSectorWithoutLock(
         SectorId sector,
@@ -62,10 +99,27 @@ namespace fc::sector_storage::stores {
         SectorFileType allocate,
         bool can_seal);
 
+    /**
+     * @brief declares sectors found in storage directories and drops
+     * declared ones which are not found
+     * @param declared - declarations of storage known by index
+     */
+    outcome::result<void> declareSectors(
+        const StorageID &storage_id,
+        const std::string &path,
+        const std::vector<SectorDeclaration> &declared) const;
+
     std::shared_ptr<LocalStorage> storage_;
     std::shared_ptr<SectorIndex> index_;
     std::vector<std::string> urls_;
+    void scheduleHeartbeat();
+
     std::unordered_map<StorageID, std::string> paths_;
+    /// Stats of storages by last heartbeat
+    std::unordered_map<StorageID, FsStat> stats_;
+    std::mutex stats_mutex_;
+    boost::optional<boost::asio::steady_timer> heartbeat_timer_;
+    FileTransfer transfer_;
     fc::common::Logger logger_;
 
     mutable std::shared_mutex mutex_;
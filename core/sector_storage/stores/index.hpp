@@ -45,6 +45,31 @@ namespace fc::sector_storage::stores {
     boost::optional<std::string> error;
   };
 
+  /// Sector file declared in storage
+  struct SectorDeclaration {
+    SectorId sector;
+    SectorFileType type;
+  };
+
+  inline bool operator==(const SectorDeclaration &lhs,
+                         const SectorDeclaration &rhs) {
+    return lhs.sector == rhs.sector && lhs.type == rhs.type;
+  }
+
+  /// Progress of sector file transfer into storage
+  struct TransferProgress {
+    SectorId sector;
+    SectorFileType type;
+    uint64_t done;
+    uint64_t total;
+  };
+
+  inline bool operator==(const TransferProgress &lhs,
+                         const TransferProgress &rhs) {
+    return lhs.sector == rhs.sector && lhs.type == rhs.type
+           && lhs.done == rhs.done && lhs.total == rhs.total;
+  }
+
   class SectorIndex {
    public:
     virtual ~SectorIndex() = default;
@@ -58,6 +83,28 @@ namespace fc::sector_storage::stores {
     virtual outcome::result<void> storageReportHealth(
         const StorageID &storage_id, const HealthReport &report) = 0;
 
+    /**
+     * @brief updates progress of transfer into storage, finished transfer is
+     * forgotten
+     */
+    virtual outcome::result<void> storageReportTransfer(
+        const StorageID &storage_id, const TransferProgress &progress) = 0;
+
+    /// Transfers into storage in progress
+    virtual outcome::result<std::vector<TransferProgress>> storageGetTransfers(
+        const StorageID &storage_id) const = 0;
+
+    /**
+     * @brief reserves space of storage for allocation in progress, reserved
+     * space is not considered available by best alloc
+     */
+    virtual outcome::result<void> storageReserve(const StorageID &storage_id,
+                                                 uint64_t size) = 0;
+
+    /// Returns space reserved by storageReserve
+    virtual outcome::result<void> storageReleaseReservation(
+        const StorageID &storage_id, uint64_t size) = 0;
+
     virtual outcome::result<void> storageDeclareSector(
         const StorageID &storage_id,
         const SectorId &sector,
@@ -68,6 +115,10 @@ namespace fc::sector_storage::stores {
         const SectorId &sector,
         const SectorFileType &file_type) = 0;
 
+    /// Sector files declared in storage, each file type separately
+    virtual outcome::result<std::vector<SectorDeclaration>> storageSectors(
+        const StorageID &storage_id) const = 0;
+
     virtual outcome::result<std::vector<StorageInfo>> storageFindSector(
         const SectorId &sector,
         const SectorFileType &file_type,
@@ -83,6 +134,8 @@ namespace fc::sector_storage::stores {
     StorageNotFound = 1,
     NoSuitableCandidate,
     InvalidUrl,
+    NotEnoughSpace,
+    InvalidRecord,
   };
 }  // namespace fc::sector_storage::stores
 
@@ -22,6 +22,7 @@ namespace fc::sector_storage::stores {
     RemoveSeveralFileTypes,
     CannotMoveSector,
     CannotInitLogger,
+    CannotCopyFile,
   };
 }  // namespace fc::sector_storage::stores
 
@@ -0,0 +1,61 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_SECTOR_STORAGE_WORKER_HPP
+#define CPP_FILECOIN_CORE_SECTOR_STORAGE_WORKER_HPP
+
+#include <set>
+
+#include "sector_storage/resources.hpp"
+#include "sector_storage/sector_storage.hpp"
+
+namespace fc::sector_storage {
+
+  struct WorkerInfo {
+    std::string hostname;
+    WorkerResources resources;
+  };
+
+  /**
+   * Performs sealing tasks of scheduler, local or remote. Sector files stay in
+   * worker store between tasks of sector, until they are moved to long term
+   * storage.
+   */
+  class Worker {
+   public:
+    virtual ~Worker() = default;
+
+    virtual outcome::result<std::set<TaskType>> getSupportedTask() = 0;
+
+    /// Also used as health check of worker
+    virtual outcome::result<WorkerInfo> getInfo() = 0;
+
+    virtual outcome::result<PreCommit1Output> sealPreCommit1(
+        const SectorId &sector,
+        const SealRandomness &ticket,
+        gsl::span<const PieceInfo> pieces) = 0;
+
+    virtual outcome::result<SectorCids> sealPreCommit2(
+        const SectorId &sector, const PreCommit1Output &pc1o) = 0;
+
+    virtual outcome::result<Commit1Output> sealCommit1(
+        const SectorId &sector,
+        const SealRandomness &ticket,
+        const InteractiveRandomness &seed,
+        gsl::span<const PieceInfo> pieces,
+        const SectorCids &cids) = 0;
+
+    virtual outcome::result<Proof> sealCommit2(const SectorId &sector,
+                                               const Commit1Output &c1o) = 0;
+
+    virtual outcome::result<void> finalizeSector(const SectorId &sector) = 0;
+
+    /// Moves sector files of types from sealing to long term storage
+    virtual outcome::result<void> moveStorage(const SectorId &sector,
+                                              SectorFileType types) = 0;
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_CORE_SECTOR_STORAGE_WORKER_HPP
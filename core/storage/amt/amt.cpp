@@ -5,7 +5,10 @@
 
 #include "storage/amt/amt.hpp"
 
+#include <algorithm>
+
 #include "common/which.hpp"
+#include "storage/ipld/encode_level.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::amt, AmtError, e) {
   using fc::storage::amt::AmtError;
@@ -18,6 +21,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::amt, AmtError, e) {
       return "Index too big";
     case AmtError::NOT_FOUND:
       return "Not found";
+    case AmtError::NOT_SORTED:
+      return "Keys are not sorted";
   }
   return "Unknown error";
 }
@@ -49,6 +54,47 @@ namespace fc::storage::amt {
     return maskAt(height + 1);
   }
 
+  /// Links of node, or none if node has values
+  const Node::Links &linksOf(const Node &node) {
+    static const Node::Links empty;
+    return which<Node::Links>(node.items) ? boost::get<Node::Links>(node.items)
+                                          : empty;
+  }
+
+  /// Values of node, or none if node has links
+  const Node::Values &valuesOf(const Node &node) {
+    static const Node::Values empty;
+    return which<Node::Values>(node.items)
+               ? boost::get<Node::Values>(node.items)
+               : empty;
+  }
+
+  /// Call removed, added or both for indices of sorted maps
+  template <typename T, typename F1, typename F2, typename F3>
+  outcome::result<void> merge(const SmallMap<T> &before,
+                              const SmallMap<T> &after,
+                              const F1 &removed,
+                              const F2 &added,
+                              const F3 &both) {
+    auto it_before = before.begin();
+    auto it = after.begin();
+    while (it_before != before.end() || it != after.end()) {
+      if (it == after.end()
+          || (it_before != before.end() && it_before->first < it->first)) {
+        OUTCOME_TRY(removed(*it_before));
+        ++it_before;
+      } else if (it_before == before.end() || it->first < it_before->first) {
+        OUTCOME_TRY(added(*it));
+        ++it;
+      } else {
+        OUTCOME_TRY(both(*it_before, *it));
+        ++it_before;
+        ++it;
+      }
+    }
+    return outcome::success();
+  }
+
   Amt::Amt(std::shared_ptr<ipfs::IpfsDatastore> store)
       : ipld(std::move(store)), root_(Root{}) {}
 
@@ -87,14 +133,15 @@ namespace fc::storage::amt {
     if (key >= maxAt(root.height)) {
       return AmtError::NOT_FOUND;
     }
-    std::reference_wrapper<Node> node = root.node;
+    const Node *node = &root.node;
+    Node::ConstPtr child;
     for (auto height = root.height; height != 0; --height) {
       auto mask = maskAt(height);
-      OUTCOME_TRY(child, loadLink(node, key / mask, false));
+      OUTCOME_TRYA(child, readLink(*node, key / mask));
       key %= mask;
-      node = *child;
+      node = child.get();
     }
-    auto &values = boost::get<Node::Values>(node.get().items);
+    auto &values = boost::get<Node::Values>(node->items);
     auto it = values.find(key);
     if (it == values.end()) {
       return AmtError::NOT_FOUND;
@@ -102,6 +149,102 @@ namespace fc::storage::amt {
     return it->second;
   }
 
+  outcome::result<std::vector<boost::optional<Value>>> Amt::getMany(
+      gsl::span<const uint64_t> keys) {
+    std::vector<boost::optional<Value>> values(keys.size());
+    OUTCOME_TRY(walkMany(
+        keys, [&](auto i, auto &value) { values[i] = value; }));
+    return std::move(values);
+  }
+
+  outcome::result<void> Amt::prefetch(gsl::span<const uint64_t> keys) {
+    return walkMany(keys, [](auto, auto &) {});
+  }
+
+  outcome::result<void> Amt::walkMany(
+      gsl::span<const uint64_t> keys,
+      const std::function<void(size_t, const Value &)> &visitor) {
+    OUTCOME_TRY(loadRoot());
+    auto &root = boost::get<Root>(root_);
+    // indices of keys which may be present, in key order
+    std::vector<size_t> order;
+    order.reserve(keys.size());
+    for (size_t i = 0; i < static_cast<size_t>(keys.size()); ++i) {
+      if (keys[i] < maxAt(root.height)) {
+        order.push_back(i);
+      }
+    }
+    std::sort(order.begin(), order.end(), [&](auto l, auto r) {
+      return keys[l] < keys[r];
+    });
+    // node with range of order under it
+    struct Path {
+      Node::ConstPtr hold;
+      const Node *node;
+      uint64_t offset;
+      size_t begin, end;
+    };
+    std::vector<Path> level{{nullptr, &root.node, 0, 0, order.size()}};
+    for (auto height = root.height; height != 0 && !level.empty(); --height) {
+      auto mask = maskAt(height);
+      std::vector<Path> next;
+      std::vector<CID> missing;
+      std::vector<size_t> missing_paths;
+      for (auto &path : level) {
+        auto &links = linksOf(*path.node);
+        auto indexOf = [&](auto i) {
+          return (keys[order[i]] - path.offset) / mask;
+        };
+        for (auto begin = path.begin; begin != path.end;) {
+          auto index = indexOf(begin);
+          auto end = begin + 1;
+          while (end != path.end && indexOf(end) == index) {
+            ++end;
+          }
+          auto it = links.find(index);
+          if (it != links.end()) {
+            Path child{
+                nullptr, nullptr, path.offset + index * mask, begin, end};
+            if (which<Node::Ptr>(it->second)) {
+              child.node = boost::get<Node::Ptr>(it->second).get();
+            } else {
+              auto &cid = boost::get<CID>(it->second);
+              child.hold = nodeCache().get(cid);
+              if (!child.hold) {
+                missing.push_back(cid);
+                missing_paths.push_back(next.size());
+              }
+              child.node = child.hold.get();
+            }
+            next.push_back(std::move(child));
+          }
+          begin = end;
+        }
+      }
+      if (!missing.empty()) {
+        OUTCOME_TRY(blocks, ipld->getMany(missing));
+        for (size_t i = 0; i < blocks.size(); ++i) {
+          OUTCOME_TRY(node, ipld->decode<Node>(blocks[i]));
+          auto &child = next[missing_paths[i]];
+          child.hold = std::make_shared<const Node>(std::move(node));
+          child.node = child.hold.get();
+          nodeCache().put(missing[i], child.hold);
+        }
+      }
+      level = std::move(next);
+    }
+    for (auto &path : level) {
+      auto &values = valuesOf(*path.node);
+      for (auto i = path.begin; i != path.end; ++i) {
+        auto it = values.find(keys[order[i]] - path.offset);
+        if (it != values.end()) {
+          visitor(order[i], it->second);
+        }
+      }
+    }
+    return outcome::success();
+  }
+
   outcome::result<void> Amt::remove(uint64_t key) {
     if (key >= kMaxIndex) {
       return AmtError::INDEX_TOO_BIG;
@@ -126,11 +269,60 @@ namespace fc::storage::amt {
     return outcome::success();
   }
 
+  outcome::result<void> Amt::assign(
+      std::vector<std::pair<uint64_t, Value>> items) {
+    Root root;
+    root.count = items.size();
+    if (items.empty()) {
+      root_ = std::move(root);
+      return outcome::success();
+    }
+    if (items.back().first >= kMaxIndex) {
+      return AmtError::INDEX_TOO_BIG;
+    }
+    // nodes of current height with their indices at that height
+    std::vector<std::pair<uint64_t, Node>> level;
+    for (size_t i = 0; i < items.size(); ++i) {
+      auto key = items[i].first;
+      if (i != 0 && key <= items[i - 1].first) {
+        return AmtError::NOT_SORTED;
+      }
+      if (level.empty() || level.back().first != key / kWidth) {
+        level.emplace_back(key / kWidth, Node{true, Node::Values{}});
+      }
+      auto &values = boost::get<Node::Values>(level.back().second.items);
+      values.emplace_hint(
+          values.end(), key % kWidth, std::move(items[i].second));
+    }
+    while (level.size() != 1 || level[0].first != 0) {
+      std::vector<std::pair<uint64_t, Node>> parents;
+      for (auto &[index, node] : level) {
+        if (parents.empty() || parents.back().first != index / kWidth) {
+          parents.emplace_back(index / kWidth, Node{true, Node::Links{}});
+        }
+        auto &links = boost::get<Node::Links>(parents.back().second.items);
+        links.emplace_hint(links.end(),
+                           index % kWidth,
+                           std::make_shared<Node>(std::move(node)));
+      }
+      level = std::move(parents);
+      ++root.height;
+    }
+    root.node = std::move(level[0].second);
+    root_ = std::move(root);
+    return outcome::success();
+  }
+
   outcome::result<CID> Amt::flush() {
     if (which<Root>(root_)) {
       auto &root = boost::get<Root>(root_);
-      OUTCOME_TRY(flush(root.node));
-      OUTCOME_TRY(root_cid, ipld->setCbor(root));
+      Ipld::Blocks blocks;
+      OUTCOME_TRY(flush(root.node, blocks));
+      OUTCOME_TRY(bytes, Ipld::encode(root));
+      OUTCOME_TRY(root_cid, common::getCidOf(bytes));
+      blocks.emplace_back(root_cid, std::move(bytes));
+      OUTCOME_TRY(ipld->setMany(std::move(blocks)));
+      rootCache().put(root_cid, std::make_shared<const Root>(std::move(root)));
       root_ = root_cid;
     }
     return cid();
@@ -141,9 +333,50 @@ namespace fc::storage::amt {
   }
 
   outcome::result<void> Amt::visit(const Visitor &visitor) {
+    OUTCOME_TRY(visitWhile([&](auto key, auto &value) -> outcome::result<bool> {
+      OUTCOME_TRY(visitor(key, value));
+      return true;
+    }));
+    return outcome::success();
+  }
+
+  outcome::result<bool> Amt::visitWhile(const WhileVisitor &visitor,
+                                        uint64_t from) {
+    OUTCOME_TRY(loadRoot());
+    auto &root = boost::get<Root>(root_);
+    return visitWhile(root.node, root.height, 0, from, visitor);
+  }
+
+  outcome::result<void> Amt::visitParallel(const Visitor &visitor,
+                                           bool ordered,
+                                           size_t threads) {
     OUTCOME_TRY(loadRoot());
     auto &root = boost::get<Root>(root_);
-    return visit(root.node, root.height, 0, visitor);
+    std::vector<uint64_t> links;
+    if (root.height != 0 && which<Node::Links>(root.node.items)) {
+      for (auto &it : boost::get<Node::Links>(root.node.items)) {
+        links.push_back(it.first);
+      }
+    }
+    if (links.empty()) {
+      return visit(visitor);
+    }
+    auto mask = maskAt(root.height);
+    return ipld::visitParallel<uint64_t, Value>(
+        links.size(),
+        threads,
+        ordered,
+        [&](size_t i, auto &on_pair) -> outcome::result<bool> {
+          OUTCOME_TRY(child, readLink(root.node, links[i]));
+          return visitWhile(*child,
+                            root.height - 1,
+                            links[i] * mask,
+                            0,
+                            [&](auto key, auto &value) {
+                              return on_pair(key, value);
+                            });
+        },
+        [&](auto &key, auto &value) { return visitor(key, value); });
   }
 
   outcome::result<bool> Amt::set(Node &node,
@@ -153,10 +386,12 @@ namespace fc::storage::amt {
     node.has_bits = true;
     if (height == 0) {
       auto &values = boost::get<Node::Values>(node.items);
-      if (values.insert(std::make_pair(key, value)).second) {
+      auto it = values.find(key);
+      if (it == values.end()) {
+        values.emplace(key, Value(value));
         return true;
       }
-      values.at(key) = Value(value);
+      it->second = Value(value);
       return false;
     }
     auto mask = maskAt(height);
@@ -198,46 +433,249 @@ namespace fc::storage::amt {
     return res.error();
   }
 
-  outcome::result<void> Amt::flush(Node &node) {
-    if (which<Node::Links>(node.items)) {
-      auto &links = boost::get<Node::Links>(node.items);
-      for (auto &pair : links) {
-        if (which<Node::Ptr>(pair.second)) {
-          auto &child = *boost::get<Node::Ptr>(pair.second);
-          OUTCOME_TRY(flush(child));
-          OUTCOME_TRY(cid, ipld->setCbor(child));
-          pair.second = cid;
+  outcome::result<void> Amt::flush(Node &node, Ipld::Blocks &blocks) {
+    return flush(std::vector<Node *>{&node}, blocks);
+  }
+
+  outcome::result<void> Amt::flush(const std::vector<Node *> &nodes,
+                                   Ipld::Blocks &blocks) {
+    // children of one level are flushed and hashed at once
+    std::vector<Node::Link *> links;
+    std::vector<Node *> children;
+    for (auto node : nodes) {
+      if (which<Node::Links>(node->items)) {
+        for (auto &pair : boost::get<Node::Links>(node->items)) {
+          if (which<Node::Ptr>(pair.second)) {
+            links.push_back(&pair.second);
+            children.push_back(boost::get<Node::Ptr>(pair.second).get());
+          }
         }
       }
     }
+    if (children.empty()) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(flush(children, blocks));
+    OUTCOME_TRY(level, ipld::encodeLevel(children));
+    auto &[encoded, cids] = level;
+    for (size_t i = 0; i < links.size(); ++i) {
+      auto &link = *links[i];
+      auto &cid = cids[i];
+      blocks.emplace_back(cid, std::move(encoded[i]));
+      // node may still be shared with copies of this amt
+      auto &ptr = boost::get<Node::Ptr>(link);
+      nodeCache().put(cid,
+                      ptr.use_count() == 1
+                          ? std::make_shared<const Node>(std::move(*ptr))
+                          : std::make_shared<const Node>(*ptr));
+      link = std::move(cid);
+    }
     return outcome::success();
   }
 
-  outcome::result<void> Amt::visit(Node &node,
-                                   uint64_t height,
-                                   uint64_t offset,
-                                   const Visitor &visitor) {
+  outcome::result<bool> Amt::visitWhile(const Node &node,
+                                        uint64_t height,
+                                        uint64_t offset,
+                                        uint64_t from,
+                                        const WhileVisitor &visitor) const {
     if (height == 0) {
       for (auto &it : boost::get<Node::Values>(node.items)) {
-        OUTCOME_TRY(visitor(offset + it.first, it.second));
+        if (offset + it.first < from) {
+          continue;
+        }
+        OUTCOME_TRY(more, visitor(offset + it.first, it.second));
+        if (!more) {
+          return false;
+        }
       }
-      return outcome::success();
+      return true;
+    }
+    if (!which<Node::Links>(node.items)) {
+      return true;
     }
     auto mask = maskAt(height);
     for (auto &it : boost::get<Node::Links>(node.items)) {
-      OUTCOME_TRY(loadLink(node, it.first, false));
-      OUTCOME_TRY(visit(*boost::get<Node::Ptr>(it.second),
-                        height - 1,
-                        offset + it.first * mask,
-                        visitor));
+      auto child_offset = offset + it.first * mask;
+      if (child_offset + mask <= from) {
+        continue;
+      }
+      OUTCOME_TRY(child, readLink(node, it.first));
+      OUTCOME_TRY(more,
+                  visitWhile(*child, height - 1, child_offset, from, visitor));
+      if (!more) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  outcome::result<void> Amt::diff(Amt &before, const DiffVisitor &visitor) {
+    OUTCOME_TRY(before.loadRoot());
+    OUTCOME_TRY(loadRoot());
+    auto &before_root = boost::get<Root>(before.root_);
+    auto &root = boost::get<Root>(root_);
+    auto removed = [&](auto key, auto &value) {
+      return visitor(key, &value, nullptr);
+    };
+    auto added = [&](auto key, auto &value) {
+      return visitor(key, nullptr, &value);
+    };
+    // higher tree holds lower one under chain of first links
+    const Node *before_node = &before_root.node;
+    const Node *node = &root.node;
+    auto before_height = before_root.height;
+    auto height = root.height;
+    Node::ConstPtr before_child, child;
+    while (before_node && node && before_height != height) {
+      if (before_height > height) {
+        OUTCOME_TRYA(before_child,
+                     before.descendFirst(*before_node, before_height, removed));
+        before_node = before_child.get();
+        --before_height;
+      } else {
+        OUTCOME_TRYA(child, descendFirst(*node, height, added));
+        node = child.get();
+        --height;
+      }
+    }
+    if (before_node && node) {
+      return diff(before, *before_node, *node, height, 0, visitor);
+    }
+    if (before_node) {
+      OUTCOME_TRY(before.visitWhile(
+          *before_node,
+          before_height,
+          0,
+          0,
+          [&](auto key, auto &value) -> outcome::result<bool> {
+            OUTCOME_TRY(removed(key, value));
+            return true;
+          }));
+    }
+    if (node) {
+      OUTCOME_TRY(visitWhile(
+          *node,
+          height,
+          0,
+          0,
+          [&](auto key, auto &value) -> outcome::result<bool> {
+            OUTCOME_TRY(added(key, value));
+            return true;
+          }));
     }
     return outcome::success();
   }
 
+  outcome::result<void> Amt::diff(const Amt &before,
+                                  const Node &before_node,
+                                  const Node &node,
+                                  uint64_t height,
+                                  uint64_t offset,
+                                  const DiffVisitor &visitor) const {
+    if (height == 0) {
+      return merge(
+          valuesOf(before_node),
+          valuesOf(node),
+          [&](auto &item) {
+            return visitor(offset + item.first, &item.second, nullptr);
+          },
+          [&](auto &item) {
+            return visitor(offset + item.first, nullptr, &item.second);
+          },
+          [&](auto &item_before, auto &item) -> outcome::result<void> {
+            if (item_before.second == item.second) {
+              return outcome::success();
+            }
+            return visitor(
+                offset + item.first, &item_before.second, &item.second);
+          });
+    }
+    auto mask = maskAt(height);
+    auto visitAll = [&](const Amt &amt,
+                        const Node &parent,
+                        size_t index,
+                        bool is_before) -> outcome::result<void> {
+      OUTCOME_TRY(child, amt.readLink(parent, index));
+      OUTCOME_TRY(amt.visitWhile(
+          *child,
+          height - 1,
+          offset + index * mask,
+          0,
+          [&](auto key, auto &value) -> outcome::result<bool> {
+            if (is_before) {
+              OUTCOME_TRY(visitor(key, &value, nullptr));
+            } else {
+              OUTCOME_TRY(visitor(key, nullptr, &value));
+            }
+            return true;
+          }));
+      return outcome::success();
+    };
+    return merge(
+        linksOf(before_node),
+        linksOf(node),
+        [&](auto &item) {
+          return visitAll(before, before_node, item.first, true);
+        },
+        [&](auto &item) { return visitAll(*this, node, item.first, false); },
+        [&](auto &item_before, auto &item) -> outcome::result<void> {
+          if (item_before.second == item.second) {
+            return outcome::success();
+          }
+          OUTCOME_TRY(before_child, before.readLink(before_node, item.first));
+          OUTCOME_TRY(child, readLink(node, item.first));
+          return diff(before,
+                      *before_child,
+                      *child,
+                      height - 1,
+                      offset + item.first * mask,
+                      visitor);
+        });
+  }
+
+  outcome::result<Node::ConstPtr> Amt::descendFirst(
+      const Node &node, uint64_t height, const Visitor &visitor) const {
+    Node::ConstPtr first;
+    auto mask = maskAt(height);
+    for (auto &item : linksOf(node)) {
+      OUTCOME_TRY(child, readLink(node, item.first));
+      if (item.first == 0) {
+        first = std::move(child);
+      } else {
+        OUTCOME_TRY(visitWhile(
+            *child,
+            height - 1,
+            item.first * mask,
+            0,
+            [&](auto key, auto &value) -> outcome::result<bool> {
+              OUTCOME_TRY(visitor(key, value));
+              return true;
+            }));
+      }
+    }
+    return std::move(first);
+  }
+
+  ipld::NodeCache<Node> &Amt::nodeCache() {
+    static ipld::NodeCache<Node> cache{kNodeCacheCapacity};
+    return cache;
+  }
+
+  ipld::NodeCache<Root> &Amt::rootCache() {
+    static ipld::NodeCache<Root> cache{kNodeCacheCapacity};
+    return cache;
+  }
+
   outcome::result<void> Amt::loadRoot() {
     if (which<CID>(root_)) {
-      OUTCOME_TRY(root, ipld->getCbor<Root>(boost::get<CID>(root_)));
-      root_ = root;
+      auto &cid = boost::get<CID>(root_);
+      auto root = rootCache().get(cid);
+      if (!root) {
+        OUTCOME_TRY(decoded, ipld->getCbor<Root>(cid));
+        root = std::make_shared<const Root>(std::move(decoded));
+        rootCache().put(cid, root);
+      }
+      root_ = *root;
     }
     return outcome::success();
   }
@@ -261,9 +699,33 @@ namespace fc::storage::amt {
     }
     auto &link = it->second;
     if (which<CID>(link)) {
-      OUTCOME_TRY(node, ipld->getCbor<Node>(boost::get<CID>(link)));
-      link = std::make_shared<Node>(std::move(node));
+      OUTCOME_TRY(node, readLink(parent, index));
+      link = std::make_shared<Node>(*node);
     }
     return boost::get<Node::Ptr>(link);
   }
+
+  outcome::result<Node::ConstPtr> Amt::readLink(const Node &parent,
+                                                uint64_t index) const {
+    if (!which<Node::Links>(parent.items)) {
+      return AmtError::NOT_FOUND;
+    }
+    auto &links = boost::get<Node::Links>(parent.items);
+    auto it = links.find(index);
+    if (it == links.end()) {
+      return AmtError::NOT_FOUND;
+    }
+    auto &link = it->second;
+    if (which<Node::Ptr>(link)) {
+      return Node::ConstPtr{boost::get<Node::Ptr>(link)};
+    }
+    auto &cid = boost::get<CID>(link);
+    if (auto cached = nodeCache().get(cid)) {
+      return cached;
+    }
+    OUTCOME_TRY(node, ipld->getCbor<Node>(cid));
+    auto shared = std::make_shared<const Node>(std::move(node));
+    nodeCache().put(cid, shared);
+    return shared;
+  }
 }  // namespace fc::storage::amt
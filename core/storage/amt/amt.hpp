@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_STORAGE_AMT_AMT_HPP
 #define CPP_FILECOIN_STORAGE_AMT_AMT_HPP
 
+#include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/variant.hpp>
 
 #include "codec/cbor/cbor.hpp"
@@ -14,6 +16,8 @@
 #include "common/which.hpp"
 #include "primitives/cid/cid.hpp"
 #include "storage/ipfs/datastore.hpp"
+#include "storage/ipld/node_cache.hpp"
+#include "storage/ipld/visit_parallel.hpp"
 
 namespace fc::storage::amt {
   enum class AmtError {
@@ -21,6 +25,7 @@ namespace fc::storage::amt {
     DECODE_WRONG,
     INDEX_TOO_BIG,
     NOT_FOUND,
+    NOT_SORTED,
   };
 }  // namespace fc::storage::amt
 
@@ -29,15 +34,26 @@ OUTCOME_HPP_DECLARE_ERROR(fc::storage::amt, AmtError);
 namespace fc::storage::amt {
   constexpr size_t kWidth = 8;
   constexpr auto kMaxIndex = 1ull << 48;
+  /// Max number of decoded nodes kept by process-wide cache
+  constexpr size_t kNodeCacheCapacity = 4096;
 
   using common::which;
   using Value = ipfs::IpfsDatastore::Value;
 
+  /// Sorted map stored inline for up to kWidth items
+  template <typename T>
+  using SmallMap = boost::container::flat_map<
+      size_t,
+      T,
+      std::less<size_t>,
+      boost::container::small_vector<std::pair<size_t, T>, kWidth>>;
+
   struct Node {
     using Ptr = std::shared_ptr<Node>;
+    using ConstPtr = std::shared_ptr<const Node>;
     using Link = boost::variant<CID, Ptr>;
-    using Links = std::map<size_t, Link>;
-    using Values = std::map<size_t, Value>;
+    using Links = SmallMap<Link>;
+    using Values = SmallMap<Value>;
     using Items = boost::variant<Values, Links>;
 
     /// github.com/filecoin-project/go-amt-ipld does not truncate zero bits
@@ -101,7 +117,7 @@ namespace fc::storage::amt {
       for (auto i = 0u; i < n_links; ++i) {
         CID link;
         l_links >> link;
-        links[indices[i]] = std::move(link);
+        links.emplace_hint(links.end(), indices[i], std::move(link));
       }
       node.items = links;
     } else {
@@ -110,7 +126,8 @@ namespace fc::storage::amt {
       }
       Node::Values values;
       for (auto i = 0u; i < n_values; ++i) {
-        values[indices[i]] = Value{l_values.raw()};
+        values.emplace_hint(
+            values.end(), indices[i], Value{l_values.rawView()});
       }
       node.items = values;
     }
@@ -129,6 +146,12 @@ namespace fc::storage::amt {
    public:
     using Visitor =
         std::function<outcome::result<void>(uint64_t, const Value &)>;
+    /// Visitor returning false to stop
+    using WhileVisitor =
+        std::function<outcome::result<bool>(uint64_t, const Value &)>;
+    /// Called with changed key and its values before and after, null if absent
+    using DiffVisitor = std::function<outcome::result<void>(
+        uint64_t, const Value *, const Value *)>;
 
     explicit Amt(std::shared_ptr<ipfs::IpfsDatastore> store);
     Amt(std::shared_ptr<ipfs::IpfsDatastore> store, const CID &root);
@@ -138,16 +161,61 @@ namespace fc::storage::amt {
     outcome::result<void> set(uint64_t key, gsl::span<const uint8_t> value);
     /// Get value by key
     outcome::result<Value> get(uint64_t key);
+    /**
+     * Get values of keys, walking paths in key order level by level, so
+     * shared path prefixes are loaded once and missing nodes of each level
+     * are read from storage with one getMany
+     * @param keys - keys in any order, may repeat
+     * @return values in order of keys, none if absent
+     */
+    outcome::result<std::vector<boost::optional<Value>>> getMany(
+        gsl::span<const uint64_t> keys);
+    /**
+     * Load nodes on paths of keys into node cache ahead of reads, same walk
+     * as getMany
+     */
+    outcome::result<void> prefetch(gsl::span<const uint64_t> keys);
     /// Remove value by key, does not write to storage
     outcome::result<void> remove(uint64_t key);
     /// Checks if key is present
     outcome::result<bool> contains(uint64_t key);
+    /**
+     * Replace contents with items, building nodes bottom-up instead of
+     * walking from root for each item, does not write to storage
+     * @param items - pairs with increasing keys
+     */
+    outcome::result<void> assign(
+        std::vector<std::pair<uint64_t, Value>> items);
     /// Write changes made by set and remove to storage
     outcome::result<CID> flush();
     /// Get root CID if flushed, throw otherwise
     const CID &cid() const;
     /// Apply visitor for key value pairs
     outcome::result<void> visit(const Visitor &visitor);
+    /**
+     * Apply visitor for key value pairs in key order until it returns false
+     * @param from - first key to visit, subtrees before it are not loaded
+     * @return false if visitor stopped
+     */
+    outcome::result<bool> visitWhile(const WhileVisitor &visitor,
+                                     uint64_t from = 0);
+    /**
+     * Read-only visit for scans, subtrees of root are read and visited by
+     * up to threads concurrently. Amt must not be modified meanwhile.
+     * @param visitor - called concurrently, unless ordered
+     * @param ordered - call visitor on calling thread in key order, as
+     * visit does, pairs are collected in memory first
+     */
+    outcome::result<void> visitParallel(
+        const Visitor &visitor,
+        bool ordered = false,
+        size_t threads = ipld::kVisitThreads);
+
+    /**
+     * Visit keys added, removed or changed since before in key order,
+     * skipping subtrees with same cid, so cost depends on size of change
+     */
+    outcome::result<void> diff(Amt &before, const DiffVisitor &visitor);
 
     /// Store CBOR encoded value by key
     template <typename T>
@@ -163,6 +231,13 @@ namespace fc::storage::amt {
       return ipld->decode<T>(bytes);
     }
 
+    /**
+     * Process-wide caches of decoded nodes and roots shared by all amts.
+     * Read operations use cached nodes as is, mutations copy them.
+     */
+    static ipld::NodeCache<Node> &nodeCache();
+    static ipld::NodeCache<Root> &rootCache();
+
     IpldPtr ipld;
 
    private:
@@ -171,15 +246,41 @@ namespace fc::storage::amt {
                               uint64_t key,
                               gsl::span<const uint8_t> value);
     outcome::result<bool> remove(Node &node, uint64_t height, uint64_t key);
-    outcome::result<void> flush(Node &node);
-    outcome::result<void> visit(Node &node,
-                                uint64_t height,
-                                uint64_t offset,
-                                const Visitor &visitor);
+    /// Walk paths of keys level by level, visitor gets index of key and value
+    outcome::result<void> walkMany(
+        gsl::span<const uint64_t> keys,
+        const std::function<void(size_t, const Value &)> &visitor);
+    outcome::result<void> flush(Node &node, Ipld::Blocks &blocks);
+    /// Flush children of nodes of one level, hashing their blocks at once
+    outcome::result<void> flush(const std::vector<Node *> &nodes,
+                                Ipld::Blocks &blocks);
+    outcome::result<bool> visitWhile(const Node &node,
+                                     uint64_t height,
+                                     uint64_t offset,
+                                     uint64_t from,
+                                     const WhileVisitor &visitor) const;
+    /// Diff nodes of same height
+    outcome::result<void> diff(const Amt &before,
+                               const Node &before_node,
+                               const Node &node,
+                               uint64_t height,
+                               uint64_t offset,
+                               const DiffVisitor &visitor) const;
+    /**
+     * Visit values under links of node except first
+     * @return child of first link, null if absent
+     */
+    outcome::result<Node::ConstPtr> descendFirst(const Node &node,
+                                                 uint64_t height,
+                                                 const Visitor &visitor) const;
     outcome::result<void> loadRoot();
+    /// Get child node for mutation, cached node is copied
     outcome::result<Node::Ptr> loadLink(Node &node,
                                         uint64_t index,
                                         bool create);
+    /// Get child node for reading
+    outcome::result<Node::ConstPtr> readLink(const Node &node,
+                                             uint64_t index) const;
 
     boost::variant<CID, Root> root_;
   };
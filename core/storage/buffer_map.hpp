@@ -23,6 +23,7 @@
 namespace fc::storage {
 
   using Buffer = common::Buffer;
+  using common::BufferView;
 
   using BufferMap = face::GenericMap<Buffer, Buffer>;
 
@@ -5,34 +5,264 @@
 
 #include "storage/car/car.hpp"
 
+#include <fstream>
+#include <future>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
 #include "codec/uvarint.hpp"
+#include "crypto/hasher/hasher.hpp"
+#include "primitives/cid/cb_cid.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::car, CarError, e) {
   using E = fc::storage::car::CarError;
   switch (e) {
     case E::DECODE_ERROR:
       return "Decode error";
+    case E::CID_MISMATCH:
+      return "Block does not match its cid";
+    case E::CANNOT_OPEN_FILE:
+      return "Cannot open file";
+    case E::WRITE_ERROR:
+      return "Write error";
+    case E::MISSING_BLOCK:
+      return "Block linked by CAR is missing in store";
   }
+  return "unknown error";
 }
 
 namespace fc::storage::car {
+  using crypto::Hasher;
   using ipld::walker::Walker;
+  using libp2p::multi::HashType;
+
+  namespace {
+    /// Threads loading blocks ahead of export
+    constexpr size_t kExportPrefetchThreads{4};
+    /// Max header or block section size, larger lengths are corrupt
+    constexpr uint64_t kMaxSectionSize{32 << 20};
+
+    /**
+     * Read uvarint from stream
+     * @return false at the end of stream
+     */
+    outcome::result<bool> readUvarint(std::istream &input, uint64_t &value) {
+      value = 0;
+      for (size_t shift = 0; shift < 64; shift += 7) {
+        auto byte = input.get();
+        if (byte == std::istream::traits_type::eof()) {
+          if (shift == 0) {
+            return false;
+          }
+          return CarError::DECODE_ERROR;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+          return true;
+        }
+      }
+      return CarError::DECODE_ERROR;
+    }
+
+    outcome::result<Buffer> readBytes(std::istream &input, uint64_t size) {
+      if (size > kMaxSectionSize) {
+        return CarError::DECODE_ERROR;
+      }
+      Buffer bytes;
+      bytes.resize(size);
+      input.read(reinterpret_cast<char *>(bytes.data()), size);
+      if (static_cast<uint64_t>(input.gcount()) != size) {
+        return CarError::DECODE_ERROR;
+      }
+      return std::move(bytes);
+    }
+
+    /// Blocks with hash types unknown to Hasher are not verified
+    bool verifyBlock(const CID &cid, Input bytes) {
+      auto type = cid.content_address.getType();
+      if (type != HashType::sha256 && type != HashType::blake2b_256) {
+        return true;
+      }
+      return Hasher::calculate(type, bytes) == cid.content_address;
+    }
+
+    /**
+     * Verify blocks on all threads of pool
+     */
+    outcome::result<void> verifyBlocks(boost::asio::thread_pool &pool,
+                                       size_t threads,
+                                       const Ipld::Blocks &blocks) {
+      std::atomic_bool valid{true};
+      std::vector<std::future<void>> done;
+      auto chunk = (blocks.size() + threads - 1) / threads;
+      for (size_t begin = 0; begin < blocks.size(); begin += chunk) {
+        std::packaged_task<void()> task{[&, begin] {
+          auto end = std::min(blocks.size(), begin + chunk);
+          for (auto i = begin; i < end && valid; ++i) {
+            if (!verifyBlock(blocks[i].first, blocks[i].second)) {
+              valid = false;
+            }
+          }
+        }};
+        done.push_back(task.get_future());
+        boost::asio::post(pool, std::move(task));
+      }
+      for (auto &future : done) {
+        future.wait();
+      }
+      if (!valid) {
+        return CarError::CID_MISMATCH;
+      }
+      return outcome::success();
+    }
+
+    /// Called with each verified batch before it is stored
+    using BatchCallback =
+        std::function<outcome::result<void>(const Ipld::Blocks &)>;
+
+    outcome::result<std::vector<CID>> loadCar(Ipld &store,
+                                              std::istream &input,
+                                              const LoadCarOptions &options,
+                                              const BatchCallback &on_batch) {
+      uint64_t size{};
+      OUTCOME_TRY(has_header, readUvarint(input, size));
+      if (!has_header) {
+        return CarError::DECODE_ERROR;
+      }
+      OUTCOME_TRY(header_bytes, readBytes(input, size));
+      OUTCOME_TRY(header, codec::cbor::decode<CarHeader>(header_bytes));
+
+      auto threads = options.verify_threads;
+      boost::asio::thread_pool pool{std::max<size_t>(threads, 1)};
+      // previous batch is verified and stored while next one is read
+      std::future<outcome::result<void>> storing;
+      auto wait = [&]() -> outcome::result<void> {
+        if (storing.valid()) {
+          return storing.get();
+        }
+        return outcome::success();
+      };
+      auto store_batch = [&](Ipld::Blocks blocks) -> outcome::result<void> {
+        OUTCOME_TRY(wait());
+        storing = std::async(
+            std::launch::async,
+            [&, blocks{std::move(blocks)}]() mutable -> outcome::result<void> {
+              if (threads != 0) {
+                OUTCOME_TRY(verifyBlocks(pool, threads, blocks));
+              }
+              if (on_batch) {
+                OUTCOME_TRY(on_batch(blocks));
+              }
+              return store.setMany(std::move(blocks));
+            });
+        return outcome::success();
+      };
+
+      Ipld::Blocks blocks;
+      size_t batch_bytes{0};
+      auto result = [&]() -> outcome::result<void> {
+        while (true) {
+          OUTCOME_TRY(has_item, readUvarint(input, size));
+          if (!has_item) {
+            break;
+          }
+          OUTCOME_TRY(node, readBytes(input, size));
+          Input bytes{node};
+          OUTCOME_TRY(cid, CID::read(bytes));
+          batch_bytes += node.size();
+          blocks.emplace_back(std::move(cid), Buffer{bytes});
+          if (batch_bytes >= options.batch_bytes) {
+            OUTCOME_TRY(store_batch(std::move(blocks)));
+            blocks.clear();
+            batch_bytes = 0;
+          }
+        }
+        if (!blocks.empty()) {
+          OUTCOME_TRY(store_batch(std::move(blocks)));
+        }
+        return outcome::success();
+      }();
+      auto stored = wait();
+      OUTCOME_TRY(result);
+      OUTCOME_TRY(stored);
+      return std::move(header.roots);
+    }
+  }  // namespace
 
   outcome::result<std::vector<CID>> loadCar(Ipld &store, Input input) {
     OUTCOME_TRY(header_bytes,
                 codec::uvarint::readBytes<CarError::DECODE_ERROR,
                                           CarError::DECODE_ERROR>(input));
     OUTCOME_TRY(header, codec::cbor::decode<CarHeader>(header_bytes));
+    Ipld::Blocks blocks;
     while (!input.empty()) {
       OUTCOME_TRY(node,
                   codec::uvarint::readBytes<CarError::DECODE_ERROR,
                                             CarError::DECODE_ERROR>(input));
       OUTCOME_TRY(cid, CID::read(node));
-      OUTCOME_TRY(store.set(cid, common::Buffer{node}));
+      blocks.emplace_back(std::move(cid), common::Buffer{node});
     }
+    OUTCOME_TRY(store.setMany(std::move(blocks)));
     return std::move(header.roots);
   }
 
+  outcome::result<std::vector<CID>> loadCar(Ipld &store,
+                                            std::istream &input,
+                                            const LoadCarOptions &options) {
+    return loadCar(store, input, options, {});
+  }
+
+  outcome::result<std::vector<CID>> loadCarFile(
+      Ipld &store, const std::string &path, const LoadCarOptions &options) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open()) {
+      return CarError::CANNOT_OPEN_FILE;
+    }
+    return loadCar(store, file, options);
+  }
+
+  outcome::result<std::vector<CID>> loadDiffCar(
+      Ipld &store, std::istream &input, const LoadCarOptions &options) {
+    // links are checked after all blocks of CAR are stored
+    CidSet imported;
+    std::vector<CID> linked;
+    OUTCOME_TRY(roots,
+                loadCar(store,
+                        input,
+                        options,
+                        [&](auto &blocks) -> outcome::result<void> {
+                          for (auto &[cid, bytes] : blocks) {
+                            imported.insert(cid);
+                            OUTCOME_TRY(links, Walker::links(cid, bytes));
+                            linked.insert(
+                                linked.end(), links.begin(), links.end());
+                          }
+                          return outcome::success();
+                        }));
+    linked.insert(linked.end(), roots.begin(), roots.end());
+    for (auto &cid : linked) {
+      if (imported.count(cid) != 0) {
+        continue;
+      }
+      OUTCOME_TRY(present, store.contains(cid));
+      if (!present) {
+        return CarError::MISSING_BLOCK;
+      }
+      imported.insert(cid);
+    }
+    return std::move(roots);
+  }
+
+  outcome::result<std::vector<CID>> loadDiffCarFile(
+      Ipld &store, const std::string &path, const LoadCarOptions &options) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open()) {
+      return CarError::CANNOT_OPEN_FILE;
+    }
+    return loadDiffCar(store, file, options);
+  }
+
   void writeUvarint(Buffer &output, uint64_t value) {
     output.put(libp2p::multi::UVarint{value}.toBytes());
   }
@@ -75,14 +305,135 @@ namespace fc::storage::car {
     return makeCar(store, roots, walker);
   }
 
-  outcome::result<Buffer> makeSelectiveCar(
-      Ipld &store, const std::vector<std::pair<CID, Selector>> &dags) {
-    Walker walker{store};
+  outcome::result<void> writeCar(Ipld &store,
+                                 const std::vector<CID> &roots,
+                                 std::ostream &output) {
+    Buffer item;
+    auto flush = [&]() -> outcome::result<void> {
+      output.write(reinterpret_cast<const char *>(item.data()), item.size());
+      item.clear();
+      if (!output.good()) {
+        return CarError::WRITE_ERROR;
+      }
+      return outcome::success();
+    };
+    writeHeader(item, roots);
+    OUTCOME_TRY(flush());
+    // blocks are written as they are walked
+    Walker walker{store, kExportPrefetchThreads};
+    Selector all;
+    for (auto &root : roots) {
+      OUTCOME_TRY(walker.select(
+          root, all, [&](auto &cid, auto &bytes) -> outcome::result<void> {
+            writeItem(item, cid, bytes);
+            return flush();
+          }));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> writeCarFile(Ipld &store,
+                                     const std::vector<CID> &roots,
+                                     const std::string &path) {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file.is_open()) {
+      return CarError::CANNOT_OPEN_FILE;
+    }
+    OUTCOME_TRY(writeCar(store, roots, file));
+    file.close();
+    if (file.fail()) {
+      return CarError::WRITE_ERROR;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> writeSelectiveCar(
+      Ipld &store,
+      const std::vector<std::pair<CID, Selector>> &dags,
+      const CarSink &sink) {
     std::vector<CID> roots;
     for (auto &dag : dags) {
-      OUTCOME_TRY(walker.select(dag.first, dag.second));
       roots.push_back(dag.first);
     }
-    return makeCar(store, roots, walker);
+    Buffer item;
+    writeHeader(item, roots);
+    OUTCOME_TRY(sink(item));
+    Walker walker{store, kExportPrefetchThreads};
+    for (auto &dag : dags) {
+      OUTCOME_TRY(walker.select(
+          dag.first, dag.second, [&](auto &cid, auto &bytes) {
+            item.clear();
+            writeItem(item, cid, bytes);
+            return sink(item);
+          }));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<Buffer> makeSelectiveCar(
+      Ipld &store, const std::vector<std::pair<CID, Selector>> &dags) {
+    Buffer output;
+    OUTCOME_TRY(writeSelectiveCar(store, dags, [&](auto &item) {
+      output += item;
+      return outcome::success();
+    }));
+    return std::move(output);
+  }
+
+  outcome::result<void> writeDiffCar(Ipld &store,
+                                     const std::vector<CID> &base,
+                                     const std::vector<CID> &roots,
+                                     const CarSink &sink) {
+    Buffer item;
+    writeHeader(item, roots);
+    OUTCOME_TRY(sink(item));
+    // blocks of dags at walked levels
+    CidSet walked;
+    CidSet walked_base;
+    auto level{roots};
+    auto base_level{base};
+    while (!level.empty()) {
+      CidSet current;
+      for (auto &cid : level) {
+        current.insert(cid);
+      }
+      // subtrees shared with dags are not walked in base
+      std::vector<CID> next_base;
+      for (auto &cid : base_level) {
+        if (!walked_base.insert(cid) || current.count(cid) != 0
+            || walked.count(cid) != 0) {
+          continue;
+        }
+        OUTCOME_TRY(bytes, store.get(cid));
+        OUTCOME_TRY(links, Walker::links(cid, bytes));
+        next_base.insert(next_base.end(), links.begin(), links.end());
+      }
+      std::vector<CID> next;
+      for (auto &cid : level) {
+        if (walked_base.count(cid) != 0 || !walked.insert(cid)) {
+          continue;
+        }
+        OUTCOME_TRY(bytes, store.get(cid));
+        item.clear();
+        writeItem(item, cid, bytes);
+        OUTCOME_TRY(sink(item));
+        OUTCOME_TRY(links, Walker::links(cid, bytes));
+        next.insert(next.end(), links.begin(), links.end());
+      }
+      level = std::move(next);
+      base_level = std::move(next_base);
+    }
+    return outcome::success();
+  }
+
+  outcome::result<Buffer> makeDiffCar(Ipld &store,
+                                      const std::vector<CID> &base,
+                                      const std::vector<CID> &roots) {
+    Buffer output;
+    OUTCOME_TRY(writeDiffCar(store, base, roots, [&](auto &item) {
+      output += item;
+      return outcome::success();
+    }));
+    return std::move(output);
   }
 }  // namespace fc::storage::car
@@ -6,6 +6,10 @@
 #ifndef CPP_FILECOIN_CORE_STORAGE_CAR_CAR_HPP
 #define CPP_FILECOIN_CORE_STORAGE_CAR_CAR_HPP
 
+#include <algorithm>
+#include <iosfwd>
+#include <thread>
+
 #include "storage/ipfs/datastore.hpp"
 #include "storage/ipld/walker.hpp"
 
@@ -15,7 +19,13 @@ namespace fc::storage::car {
   using common::Buffer;
   using ipld::walker::Selector;
 
-  enum class CarError { DECODE_ERROR = 1 };
+  enum class CarError {
+    DECODE_ERROR = 1,
+    CID_MISMATCH,
+    CANNOT_OPEN_FILE,
+    WRITE_ERROR,
+    MISSING_BLOCK,
+  };
 
   struct CarHeader {
     static constexpr uint64_t V1 = 1;
@@ -38,6 +48,62 @@ namespace fc::storage::car {
 
   outcome::result<std::vector<CID>> loadCar(Ipld &store, Input input);
 
+  /**
+   * Streaming CAR import bounds
+   */
+  struct LoadCarOptions {
+    /// Bytes of blocks read before they are verified and stored at once,
+    /// import holds at most two batches in memory
+    size_t batch_bytes{16 << 20};
+    /// Threads verifying block cids, no verification if zero
+    size_t verify_threads{std::max(1u, std::thread::hardware_concurrency())};
+  };
+
+  /**
+   * Import CAR from stream without reading it into memory
+   * @param store - destination of blocks
+   * @param input - CAR stream
+   * @param options - memory and verification bounds
+   * @return CAR roots
+   */
+  outcome::result<std::vector<CID>> loadCar(
+      Ipld &store, std::istream &input, const LoadCarOptions &options = {});
+
+  /**
+   * Import CAR file without reading it into memory
+   * @param store - destination of blocks
+   * @param path - CAR file path
+   * @param options - memory and verification bounds
+   * @return CAR roots
+   */
+  outcome::result<std::vector<CID>> loadCarFile(
+      Ipld &store,
+      const std::string &path,
+      const LoadCarOptions &options = {});
+
+  /**
+   * Import differential CAR onto store which has its base dags, blocks of
+   * CAR are stored and their links absent from CAR are checked in store
+   * @param store - destination of blocks, with blocks of base dags
+   * @param input - differential CAR stream
+   * @param options - memory and verification bounds
+   * @return CAR roots, MISSING_BLOCK if store lacks blocks of base dags
+   */
+  outcome::result<std::vector<CID>> loadDiffCar(
+      Ipld &store, std::istream &input, const LoadCarOptions &options = {});
+
+  /**
+   * Import differential CAR file onto store which has its base dags
+   * @param store - destination of blocks, with blocks of base dags
+   * @param path - differential CAR file path
+   * @param options - memory and verification bounds
+   * @return CAR roots
+   */
+  outcome::result<std::vector<CID>> loadDiffCarFile(
+      Ipld &store,
+      const std::string &path,
+      const LoadCarOptions &options = {});
+
   void writeHeader(Buffer &output, const std::vector<CID> &roots);
 
   void writeItem(Buffer &output, const CID &cid, Input bytes);
@@ -46,8 +112,62 @@ namespace fc::storage::car {
 
   outcome::result<Buffer> makeCar(Ipld &store, const std::vector<CID> &roots);
 
+  /**
+   * Export dags of roots to stream, only one block is held in memory
+   * @param store - source of blocks
+   * @param roots - dags to export
+   * @param output - CAR stream
+   */
+  outcome::result<void> writeCar(Ipld &store,
+                                 const std::vector<CID> &roots,
+                                 std::ostream &output);
+
+  /**
+   * Export dags of roots to CAR file
+   * @param store - source of blocks
+   * @param roots - dags to export
+   * @param path - CAR file path
+   */
+  outcome::result<void> writeCarFile(Ipld &store,
+                                     const std::vector<CID> &roots,
+                                     const std::string &path);
+
+  /// Receives consecutive parts of CAR
+  using CarSink = std::function<outcome::result<void>(const Buffer &)>;
+
+  /**
+   * Export selected blocks of dags to sink, only one block is held in memory
+   * @param store - source of blocks
+   * @param dags - roots with selectors
+   * @param sink - receives header and then each block item
+   */
+  outcome::result<void> writeSelectiveCar(
+      Ipld &store,
+      const std::vector<std::pair<CID, Selector>> &dags,
+      const CarSink &sink);
+
   outcome::result<Buffer> makeSelectiveCar(
       Ipld &store, const std::vector<std::pair<CID, Selector>> &dags);
+
+  /**
+   * Export blocks of dags of roots absent from dags of base roots, e.g.
+   * state changes since previous backup. Dags are walked level by level
+   * together, blocks found in both at same level are skipped with their
+   * subtrees, so only changed blocks and their links are loaded. Block
+   * moved to other depth may be exported though base has it.
+   * @param store - source of blocks of both dags
+   * @param base - roots of previously exported dags
+   * @param roots - dags to export, header of CAR
+   * @param sink - receives header and then each block item
+   */
+  outcome::result<void> writeDiffCar(Ipld &store,
+                                     const std::vector<CID> &base,
+                                     const std::vector<CID> &roots,
+                                     const CarSink &sink);
+
+  outcome::result<Buffer> makeDiffCar(Ipld &store,
+                                      const std::vector<CID> &base,
+                                      const std::vector<CID> &roots);
 }  // namespace fc::storage::car
 
 OUTCOME_HPP_DECLARE_ERROR(fc::storage::car, CarError);
@@ -0,0 +1,86 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/block_migration.hpp"
+
+#include "storage/ipld/walker.hpp"
+
+namespace fc::storage::blockchain {
+  using ipld::walker::Walker;
+
+  BlockMigration::BlockMigration(std::shared_ptr<ChainStore> chain_store,
+                                 std::shared_ptr<TieredDatastore> store,
+                                 uint64_t finality)
+      : chain_store_{std::move(chain_store)},
+        store_{std::move(store)},
+        finality_{finality} {}
+
+  outcome::result<size_t> BlockMigration::migrate() {
+    OUTCOME_TRY(head, chain_store_->heaviestTipset());
+    if (head.height < finality_) {
+      return 0;
+    }
+    auto last = head.height - finality_;
+    auto &hot = store_->hot();
+    ipfs::IpfsDatastore::Blocks blocks;
+    size_t bytes{};
+    size_t moved{};
+    while (next_height_ <= last) {
+      OUTCOME_TRY(tipset, chain_store_->loadTipsetByHeight(next_height_));
+      if (tipset.height > last) {
+        break;
+      }
+      // headers are not walked, they link parents and state
+      Walker walker{*store_};
+      for (size_t i = 0; i < tipset.blks.size(); ++i) {
+        walker.visited.insert(tipset.cids[i]);
+        walker.cids.push_back(tipset.cids[i]);
+        OUTCOME_TRY(walker.recursiveAll(tipset.blks[i].messages));
+        OUTCOME_TRY(
+            walker.recursiveAll(tipset.blks[i].parent_message_receipts));
+      }
+      for (auto &cid : walker.cids) {
+        OUTCOME_TRY(contains, hot->contains(cid));
+        if (!contains) {
+          continue;
+        }
+        OUTCOME_TRY(value, hot->get(cid));
+        bytes += value.size();
+        blocks.emplace_back(cid, std::move(value));
+      }
+      next_height_ = tipset.height + 1;
+      if (bytes >= kBatchBytes) {
+        moved += blocks.size();
+        OUTCOME_TRY(move(blocks));
+        bytes = 0;
+      }
+    }
+    moved += blocks.size();
+    OUTCOME_TRY(move(blocks));
+    return moved;
+  }
+
+  uint64_t BlockMigration::nextHeight() const {
+    return next_height_;
+  }
+
+  outcome::result<void> BlockMigration::move(
+      ipfs::IpfsDatastore::Blocks &blocks) {
+    if (blocks.empty()) {
+      return outcome::success();
+    }
+    std::vector<CID> cids;
+    cids.reserve(blocks.size());
+    for (auto &block : blocks) {
+      cids.push_back(block.first);
+    }
+    OUTCOME_TRY(store_->cold()->setMany(std::move(blocks)));
+    blocks.clear();
+    for (auto &cid : cids) {
+      OUTCOME_TRY(store_->hot()->remove(cid));
+    }
+    return outcome::success();
+  }
+}  // namespace fc::storage::blockchain
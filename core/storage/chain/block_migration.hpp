@@ -0,0 +1,57 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_BLOCK_MIGRATION_HPP
+#define CPP_FILECOIN_CORE_STORAGE_CHAIN_BLOCK_MIGRATION_HPP
+
+#include "storage/chain/chain_store.hpp"
+#include "storage/ipfs/impl/tiered_datastore.hpp"
+
+namespace fc::storage::blockchain {
+  using ipfs::TieredDatastore;
+
+  /**
+   * Moves block headers, messages and receipts of finalized tipsets from hot
+   * store to cold store. Blocks stay readable through tiered store during
+   * and after migration. State trees are not moved.
+   */
+  class BlockMigration {
+   public:
+    /// Tipsets deeper than finality are not reverted
+    static constexpr uint64_t kFinality{900};
+    /// Moved bytes written to cold store at once
+    static constexpr size_t kBatchBytes{64 << 20};
+
+    /**
+     * @param chain_store - chain to migrate
+     * @param store - tiered store, chain blocks are read from
+     * @param finality - depth from head of migrated tipsets
+     */
+    BlockMigration(std::shared_ptr<ChainStore> chain_store,
+                   std::shared_ptr<TieredDatastore> store,
+                   uint64_t finality = kFinality);
+
+    /**
+     * @brief moves blocks of tipsets since previous call up to head height
+     * minus finality, blocks already moved are skipped
+     * @return number of moved blocks
+     */
+    outcome::result<size_t> migrate();
+
+    /// Height of the first tipset not migrated yet
+    uint64_t nextHeight() const;
+
+   private:
+    /// Writes batch to cold store and removes it from hot store
+    outcome::result<void> move(ipfs::IpfsDatastore::Blocks &blocks);
+
+    std::shared_ptr<ChainStore> chain_store_;
+    std::shared_ptr<TieredDatastore> store_;
+    uint64_t finality_;
+    uint64_t next_height_{};
+  };
+}  // namespace fc::storage::blockchain
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_CHAIN_BLOCK_MIGRATION_HPP
@@ -22,6 +22,7 @@ namespace fc::storage::blockchain {
   using primitives::tipset::HeadChange;
   using primitives::tipset::HeadChangeType;
   using primitives::tipset::Tipset;
+  using primitives::tipset::TipsetCPtr;
   using primitives::tipset::TipsetKey;
   using vm::message::SignedMessage;
   using vm::message::UnsignedMessage;
@@ -53,6 +54,22 @@ namespace fc::storage::blockchain {
      */
     virtual outcome::result<Tipset> loadTipset(const TipsetKey &key) const = 0;
 
+    /**
+     * @brief loads tipset as shared immutable handle, which is cheap to keep
+     * and copy, handles of cached tipset are equal pointers
+     * @param key tipset key
+     */
+    virtual outcome::result<TipsetCPtr> loadSharedTipset(
+        const TipsetKey &key) const = 0;
+
+    /**
+     * @brief loads tipset of heaviest chain by height, if there is no tipset
+     * at height (null round) the nearest one above is returned
+     * @param height tipset height, not greater than head height
+     */
+    virtual outcome::result<Tipset> loadTipsetByHeight(
+        uint64_t height) const = 0;
+
     /** @brief adds block to storage */
     virtual outcome::result<void> addBlock(const BlockHeader &block) = 0;
 
@@ -79,6 +96,7 @@ namespace fc::storage::blockchain {
 
     using connection_t = boost::signals2::connection;
     using HeadChangeSignature = void(const HeadChange &);
+    using HeadChangesSignature = void(const std::vector<HeadChange> &);
 
     /**
      * @brief subscribes to head changes
@@ -88,6 +106,15 @@ namespace fc::storage::blockchain {
     virtual connection_t subscribeHeadChanges(
         const std::function<HeadChangeSignature> &subscriber) = 0;
 
+    /**
+     * @brief subscribes to head changes, all reverts and applies of one head
+     * switch are delivered in single call
+     * @param subscriber subscription handler
+     * @return connection handle, which can be used to cancel subscription
+     */
+    virtual connection_t subscribeHeadChangeBatches(
+        const std::function<HeadChangesSignature> &subscriber) = 0;
+
     inline auto genesisTipsetKey() const {
       OUTCOME_EXCEPT(genesis, getGenesis());
       OUTCOME_EXCEPT(genesis_cid, primitives::cid::getCidOfCbor(genesis));
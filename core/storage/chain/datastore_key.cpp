@@ -8,6 +8,8 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include "common/span.hpp"
+
 namespace fc::storage {
 
   std::string formatKeyData(std::string_view value) {
@@ -44,6 +46,32 @@ namespace fc::storage {
     return DatastoreKey{formatKeyData(value)};
   }
 
+  common::Buffer DatastoreKey::toBinary() const {
+    common::Buffer binary;
+    size_t begin{1};
+    while (begin < value.size()) {
+      auto end{value.find('/', begin)};
+      if (end == std::string::npos) {
+        end = value.size();
+      }
+      auto segment{std::string_view{value}.substr(begin, end - begin)};
+      appendKeySegment(binary, common::span::cbytes(segment));
+      begin = end + 1;
+    }
+    return binary;
+  }
+
+  common::Buffer &appendKeySegment(common::Buffer &key,
+                                   common::BufferView segment) {
+    auto size{static_cast<uint64_t>(segment.size())};
+    while (size > 0x7F) {
+      key.putUint8(static_cast<uint8_t>(size & 0x7F) | 0x80);
+      size >>= 7;
+    }
+    key.putUint8(static_cast<uint8_t>(size));
+    return key.put(segment);
+  }
+
   bool operator<(const DatastoreKey &lhs, const DatastoreKey &rhs) {
     std::vector<std::string> lhs_list;
     std::vector<std::string> rhs_list;
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "codec/cbor/streams_annotation.hpp"
+#include "common/buffer.hpp"
 #include "common/outcome.hpp"
 
 namespace fc::storage {
@@ -23,8 +24,20 @@ namespace fc::storage {
      * @param value key data
      */
     static DatastoreKey makeFromString(std::string_view value) noexcept;
+
+    /**
+     * @brief binary form for ordered key-value stores, each segment is
+     * prefixed by its varint length, so binary key of parent is byte prefix
+     * of binary keys of its children only, e.g. "/a/b" of "/a/b/c" but not
+     * of "/a/bc", and prefix cursor scans exactly subtree of key
+     */
+    common::Buffer toBinary() const;
   };
 
+  /// Appends varint length prefixed segment to binary key
+  common::Buffer &appendKeySegment(common::Buffer &key,
+                                   common::BufferView segment);
+
   enum class DatastoreKeyError {
     INVALID_DATASTORE_KEY = 1,  /// invalid data used for creating datastore key
   };
@@ -0,0 +1,39 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/gc_roots.hpp"
+
+namespace fc::storage::blockchain {
+  outcome::result<GcRoots> chainGcRoots(
+      const ChainStore &chain_store,
+      const std::shared_ptr<CachedInterpreter> &interpreter,
+      uint64_t keep_states,
+      uint64_t from_height) {
+    GcRoots roots;
+    if (interpreter) {
+      for (auto &result : interpreter->results()) {
+        roots.recursive.push_back(result.state_root);
+        roots.recursive.push_back(result.message_receipts);
+      }
+    }
+    OUTCOME_TRY(tipset, chain_store.heaviestTipset());
+    for (uint64_t depth = 0; !tipset.blks.empty(); ++depth) {
+      for (size_t i = 0; i < tipset.blks.size(); ++i) {
+        roots.direct.push_back(tipset.cids[i]);
+        roots.recursive.push_back(tipset.blks[i].messages);
+        roots.recursive.push_back(tipset.blks[i].parent_message_receipts);
+      }
+      if (depth < keep_states) {
+        roots.recursive.push_back(tipset.blks[0].parent_state_root);
+      }
+      if (tipset.height == 0 || tipset.height <= from_height) {
+        break;
+      }
+      OUTCOME_TRY(parents, tipset.getParents());
+      OUTCOME_TRYA(tipset, chain_store.loadTipset(parents));
+    }
+    return roots;
+  }
+}  // namespace fc::storage::blockchain
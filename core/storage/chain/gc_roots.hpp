@@ -0,0 +1,39 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_GC_ROOTS_HPP
+#define CPP_FILECOIN_CORE_STORAGE_CHAIN_GC_ROOTS_HPP
+
+#include "storage/chain/chain_store.hpp"
+#include "storage/ipfs/impl/gc_datastore.hpp"
+#include "vm/interpreter/impl/interpreter_impl.hpp"
+
+namespace fc::storage::blockchain {
+  using ipfs::GcRoots;
+  using vm::interpreter::CachedInterpreter;
+
+  /// Number of latest tipsets whose state is kept by collection
+  constexpr uint64_t kGcKeepStates{900};
+
+  /**
+   * @brief collects live roots of chain, headers, messages and receipts of
+   * tipsets from head down to from_height, parent states of keep_states
+   * latest tipsets, and states and receipts cached by interpreter, e.g.
+   * computed for head or precomputed for new heads. States of running
+   * interpretations are protected by collection as they are written.
+   * @param chain_store - chain to collect roots of
+   * @param interpreter - interpreter with cached results, may be null
+   * @param keep_states - number of latest tipsets with live state
+   * @param from_height - lowest height with chain blocks in hot store, lower
+   * blocks are expected to be migrated
+   */
+  outcome::result<GcRoots> chainGcRoots(
+      const ChainStore &chain_store,
+      const std::shared_ptr<CachedInterpreter> &interpreter,
+      uint64_t keep_states,
+      uint64_t from_height);
+}  // namespace fc::storage::blockchain
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_CHAIN_GC_ROOTS_HPP
@@ -0,0 +1,109 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/head_change_dispatcher.hpp"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+
+namespace fc::storage::blockchain {
+  struct HeadChangeDispatcher::Subscriber {
+    Handler handler;
+    /// Queue of subscriber, runs batches one by one
+    boost::asio::strand<boost::asio::executor> strand;
+    common::metrics::Gauge &queued;
+    common::LatencyHistogram &lag;
+    connection_t connection;
+
+    void post(std::shared_ptr<const Changes> changes,
+              Clock::time_point published,
+              const std::shared_ptr<Subscriber> &self) {
+      queued.add(1);
+      boost::asio::post(strand, [self, changes{std::move(changes)}, published] {
+        self->queued.add(-1);
+        if (!self->connection.connected()) {
+          return;
+        }
+        self->handler(*changes);
+        self->lag.record(Clock::now() - published);
+      });
+    }
+  };
+
+  HeadChangeDispatcher::HeadChangeDispatcher(size_t threads)
+      : pool_{threads} {}
+
+  HeadChangeDispatcher::~HeadChangeDispatcher() {
+    chain_store_sub_.disconnect();
+    signal_.disconnect_all_slots();
+    pool_.stop();
+    pool_.join();
+  }
+
+  std::shared_ptr<HeadChangeDispatcher> HeadChangeDispatcher::create(
+      const std::shared_ptr<ChainStore> &chain_store, size_t threads) {
+    auto dispatcher{std::make_shared<HeadChangeDispatcher>(threads)};
+    std::weak_ptr<HeadChangeDispatcher> weak{dispatcher};
+    dispatcher->chain_store_sub_ =
+        chain_store->subscribeHeadChangeBatches([weak](auto &changes) {
+          if (auto dispatcher{weak.lock()}) {
+            dispatcher->publish(changes);
+          }
+        });
+    return dispatcher;
+  }
+
+  void HeadChangeDispatcher::publish(const Changes &changes) {
+    if (changes.empty()) {
+      return;
+    }
+    auto shared{std::make_shared<const Changes>(changes)};
+    std::lock_guard lock{mutex_};
+    // batch of head switch ends with new head
+    for (auto it{changes.rbegin()}; it != changes.rend(); ++it) {
+      if (it->type != HeadChangeType::REVERT) {
+        head_ = it->value;
+        break;
+      }
+    }
+    signal_(shared, Clock::now());
+  }
+
+  HeadChangeDispatcher::connection_t HeadChangeDispatcher::subscribe(
+      const std::string &name, Handler handler) {
+    return subscribe(name, pool_.get_executor(), std::move(handler));
+  }
+
+  HeadChangeDispatcher::connection_t HeadChangeDispatcher::subscribe(
+      const std::string &name,
+      boost::asio::executor executor,
+      Handler handler) {
+    auto &registry{common::metrics::registry()};
+    auto subscriber{std::make_shared<Subscriber>(Subscriber{
+        std::move(handler),
+        boost::asio::strand<boost::asio::executor>{std::move(executor)},
+        registry.gauge("fc_head_change_queued_batches",
+                       "Head change batches queued for subscriber",
+                       {{"subscriber", name}}),
+        registry.histogram("fc_head_change_lag_seconds",
+                           "Time from head change to handling by subscriber",
+                           {{"subscriber", name}}),
+        {}})};
+    std::lock_guard lock{mutex_};
+    // slot owns subscriber, queued batches keep it alive after disconnect
+    subscriber->connection =
+        signal_.connect([subscriber](auto &changes, auto published) {
+          subscriber->post(changes, published, subscriber);
+        });
+    if (head_) {
+      subscriber->post(
+          std::make_shared<const Changes>(Changes{
+              HeadChange{.type = HeadChangeType::CURRENT, .value = *head_}}),
+          Clock::now(),
+          subscriber);
+    }
+    return subscriber->connection;
+  }
+}  // namespace fc::storage::blockchain
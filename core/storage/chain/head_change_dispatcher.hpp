@@ -0,0 +1,84 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_HEAD_CHANGE_DISPATCHER_HPP
+#define CPP_FILECOIN_CORE_STORAGE_CHAIN_HEAD_CHANGE_DISPATCHER_HPP
+
+#include <boost/asio/executor.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <mutex>
+
+#include "common/metrics.hpp"
+#include "storage/chain/chain_store.hpp"
+
+namespace fc::storage::blockchain {
+
+  /**
+   * Delivers head changes to subscribers asynchronously, so slow subscriber
+   * doesn't delay block acceptance or other subscribers. Each head switch is
+   * published as one batch of reverts and applies. Every subscriber has own
+   * queue, batches are handled one by one in order of publishing.
+   * Per subscriber metrics, labeled with subscriber name:
+   *   fc_head_change_queued_batches - batches waiting in queue,
+   *   fc_head_change_lag_seconds - time from publishing to handled batch.
+   */
+  class HeadChangeDispatcher {
+   public:
+    using Changes = std::vector<HeadChange>;
+    using Handler = std::function<void(const Changes &)>;
+    using connection_t = ChainStore::connection_t;
+
+    /// Default number of threads of subscribers without own executor
+    static constexpr size_t kDefaultThreads{2};
+
+    explicit HeadChangeDispatcher(size_t threads = kDefaultThreads);
+
+    /// Waits for handlers being run, queued batches are dropped
+    ~HeadChangeDispatcher();
+
+    HeadChangeDispatcher(const HeadChangeDispatcher &) = delete;
+    HeadChangeDispatcher &operator=(const HeadChangeDispatcher &) = delete;
+
+    /// Creates dispatcher publishing head change batches of chain store
+    static std::shared_ptr<HeadChangeDispatcher> create(
+        const std::shared_ptr<ChainStore> &chain_store,
+        size_t threads = kDefaultThreads);
+
+    /// Queues batch for all subscribers and returns, called by publisher
+    void publish(const Changes &changes);
+
+    /**
+     * @brief subscribes to batches, handler runs on dispatcher threads
+     * @param name - subscriber name, label of metrics
+     * @param handler - called with batches, first batch is current head
+     * if it was published
+     * @return connection handle, queued batches are dropped on disconnect
+     */
+    connection_t subscribe(const std::string &name, Handler handler);
+
+    /**
+     * @brief subscribes to batches, handler runs on executor, e.g. event loop
+     * which owns state of subscriber
+     */
+    connection_t subscribe(const std::string &name,
+                           boost::asio::executor executor,
+                           Handler handler);
+
+   private:
+    using Clock = common::LatencyHistogram::Clock;
+    struct Subscriber;
+
+    mutable std::mutex mutex_;
+    /// Last published head, for new subscribers
+    boost::optional<Tipset> head_;
+    boost::signals2::signal<void(const std::shared_ptr<const Changes> &,
+                                 Clock::time_point)>
+        signal_;
+    connection_t chain_store_sub_;
+    boost::asio::thread_pool pool_;
+  };
+}  // namespace fc::storage::blockchain
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_CHAIN_HEAD_CHANGE_DISPATCHER_HPP
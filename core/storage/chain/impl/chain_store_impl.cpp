@@ -5,7 +5,13 @@
 
 #include "storage/chain/impl/chain_store_impl.hpp"
 
+#include <algorithm>
+#include <array>
+
+#include "codec/cbor/cbor.hpp"
+#include "common/memory_domain.hpp"
 #include "common/outcome.hpp"
+#include "common/span.hpp"
 #include "crypto/randomness/impl/chain_randomness_provider_impl.hpp"
 #include "primitives/address/address_codec.hpp"
 #include "primitives/cid/cid_of_cbor.hpp"
@@ -13,6 +19,7 @@
 #include "primitives/tipset/tipset_key.hpp"
 #include "storage/chain/datastore_key.hpp"
 #include "storage/chain/impl/chain_data_store_impl.hpp"
+#include "storage/leveldb/leveldb_cursor.hpp"
 
 namespace fc::storage::blockchain {
   /** types */
@@ -29,17 +36,58 @@ namespace fc::storage::blockchain {
   using primitives::cid::getCidOfCbor;
 
   namespace {
+    /// head cids only, written by older versions
     const DatastoreKey kChainHeadKey{DatastoreKey::makeFromString("head")};
+    const DatastoreKey kHeadCheckpointKey{
+        DatastoreKey::makeFromString("head/checkpoint")};
     const DatastoreKey kGenesisKey{DatastoreKey::makeFromString("0")};
+
+    /**
+     * Head with its weight, so restart doesn't compute weight from parent
+     * state of head
+     */
+    struct HeadCheckpoint {
+      std::vector<CID> cids;
+      primitives::BigInt weight;
+    };
+    CBOR_TUPLE(HeadCheckpoint, cids, weight)
+
+    /** @brief key of heaviest chain checkpoint at height */
+    DatastoreKey checkpointKey(uint64_t height) {
+      return DatastoreKey::makeFromString("height/" + std::to_string(height));
+    }
+
+    /// prefix of binary checkpoint keys, followed by big-endian height
+    const common::Buffer kCheckpointPrefix{
+        DatastoreKey::makeFromString("height").toBinary()};
+
+    std::array<uint8_t, 8> encodeHeight(uint64_t height) {
+      std::array<uint8_t, 8> bytes{};
+      for (auto i{bytes.size()}; i != 0; --i) {
+        bytes[i - 1] = static_cast<uint8_t>(height);
+        height >>= 8;
+      }
+      return bytes;
+    }
+
+    uint64_t decodeHeight(common::BufferView bytes) {
+      uint64_t height{};
+      for (auto byte : bytes) {
+        height = (height << 8) | byte;
+      }
+      return height;
+    }
   }  // namespace
 
   ChainStoreImpl::ChainStoreImpl(
       std::shared_ptr<IpfsDatastore> data_store,
       std::shared_ptr<BlockValidator> block_validator,
-      std::shared_ptr<WeightCalculator> weight_calculator)
+      std::shared_ptr<WeightCalculator> weight_calculator,
+      size_t tipset_cache_capacity)
       : data_store_{std::move(data_store)},
         block_validator_{std::move(block_validator)},
-        weight_calculator_{std::move(weight_calculator)} {
+        weight_calculator_{std::move(weight_calculator)},
+        tipsets_cache_{std::make_shared<TipsetCache>(tipset_cache_capacity)} {
     chain_data_store_ = std::make_shared<ChainDataStoreImpl>(data_store_);
     logger_ = common::createLogger("chain store");
   }
@@ -47,38 +95,131 @@ namespace fc::storage::blockchain {
   outcome::result<std::shared_ptr<ChainStoreImpl>> ChainStoreImpl::create(
       std::shared_ptr<IpfsDatastore> data_store,
       std::shared_ptr<BlockValidator> block_validator,
-      std::shared_ptr<WeightCalculator> weight_calculator) {
-    ChainStoreImpl tmp(std::move(data_store),
-                       std::move(block_validator),
-                       std::move(weight_calculator));
-
-    return std::make_shared<ChainStoreImpl>(std::move(tmp));
+      std::shared_ptr<WeightCalculator> weight_calculator,
+      size_t tipset_cache_capacity) {
+    // constructor is private, so make_shared can't be used
+    return std::shared_ptr<ChainStoreImpl>{
+        new ChainStoreImpl(std::move(data_store),
+                           std::move(block_validator),
+                           std::move(weight_calculator),
+                           tipset_cache_capacity)};
   }
 
   outcome::result<Tipset> ChainStoreImpl::loadTipset(
       const TipsetKey &key) const {
+    OUTCOME_TRY(tipset, loadSharedTipset(key));
+    return *tipset;
+  }
+
+  outcome::result<TipsetCPtr> ChainStoreImpl::loadSharedTipset(
+      const TipsetKey &key) const {
     // check cache first
-    if (auto it = tipsets_cache_.find(key); it != tipsets_cache_.end()) {
-      return it->second;
+    if (auto cached = tipsets_cache_->get(key)) {
+      return cached;
     }
+    static auto &domain{common::memoryDomain("tipset_cache")};
+    common::MemoryDomainScope scope{domain};
     OUTCOME_TRY(tipset, Tipset::load(*data_store_, key.cids));
-    // save to cache
-    tipsets_cache_[key] = tipset;
+    // other thread may have loaded it meanwhile, keep one copy
+    return tipsets_cache_->put(
+        key, std::make_shared<const Tipset>(std::move(tipset)));
+  }
+
+  outcome::result<void> ChainStoreImpl::pinTipset(const TipsetKey &key) {
+    OUTCOME_TRY(tipset, loadSharedTipset(key));
+    tipsets_cache_->pin(key, std::move(tipset));
+    return outcome::success();
+  }
+
+  void ChainStoreImpl::unpinTipset(const TipsetKey &key) {
+    if (!tipsets_cache_->unpin(key)) {
+      logger_->warn("unpinned tipset {} is not pinned", key.toPrettyString());
+    }
+  }
+
+  outcome::result<Tipset> ChainStoreImpl::loadTipsetByHeight(
+      uint64_t height) const {
+    std::lock_guard lock{index_mutex_};
+    return loadTipsetByHeightLocked(height);
+  }
+
+  outcome::result<Tipset> ChainStoreImpl::loadTipsetByHeightLocked(
+      uint64_t height) const {
+    {
+      std::shared_lock head_lock{head_mutex_};
+      if (!heaviest_tipset_.has_value()) {
+        return ChainStoreError::NO_HEAVIEST_TIPSET;
+      }
+      if (height > heaviest_tipset_->height) {
+        return ChainStoreError::NO_TIPSET_AT_HEIGHT;
+      }
+      if (height == 0 && genesis_.has_value()) {
+        return Tipset::create({*genesis_});
+      }
+      if (height_index_.empty()) {
+        OUTCOME_TRY(head_key, heaviest_tipset_->makeKey());
+        height_index_.emplace(heaviest_tipset_->height, std::move(head_key));
+      }
+    }
+    auto lowest = height_index_.begin();
+    if (height >= lowest->first) {
+      return loadTipset(height_index_.lower_bound(height)->second);
+    }
 
+    // checkpoint below indexed part of chain is closer than lowest tipset
+    OUTCOME_TRY(checkpoint_cids, findCheckpoint(height, lowest->first));
+    if (checkpoint_cids) {
+      OUTCOME_TRY(key, TipsetKey::create(std::move(*checkpoint_cids)));
+      OUTCOME_TRY(tipset, loadTipset(key));
+      while (tipset.height > height) {
+        OUTCOME_TRY(parent_key, tipset.getParents());
+        OUTCOME_TRY(parent, loadTipset(parent_key));
+        if (parent.height < height) {
+          break;
+        }
+        tipset = std::move(parent);
+      }
+      return std::move(tipset);
+    }
+
+    // extend index down to height, writing missing checkpoints on the way
+    OUTCOME_TRY(tipset, loadTipset(lowest->second));
+    while (tipset.height > height) {
+      OUTCOME_TRY(parent_key, tipset.getParents());
+      OUTCOME_TRY(parent, loadTipset(parent_key));
+      OUTCOME_TRY(updateCheckpoints(tipset, parent.height, false));
+      if (parent.height < height) {
+        break;
+      }
+      height_index_.emplace(parent.height, std::move(parent_key));
+      tipset = std::move(parent);
+    }
     return std::move(tipset);
   }
 
   outcome::result<void> ChainStoreImpl::initialize() {
-    // load head tipset
-    auto &&head_key = chain_data_store_->get(kChainHeadKey);
-    if (head_key) {
+    std::lock_guard lock{write_mutex_};
+    std::unique_lock head_lock{head_mutex_};
+    // load head tipset, height index is extended on demand
+    auto checkpoint_raw = chain_data_store_->get(kHeadCheckpointKey);
+    if (checkpoint_raw) {
+      OUTCOME_TRY(checkpoint,
+                  codec::cbor::decode<HeadCheckpoint>(
+                      common::span::cbytes(checkpoint_raw.value())));
+      OUTCOME_TRY(ts_key, TipsetKey::create(std::move(checkpoint.cids)));
+      OUTCOME_TRY(tipset, loadTipset(ts_key));
+      heaviest_tipset_.reset(tipset);
+      heaviest_weight_ = std::move(checkpoint.weight);
+    } else if (auto head_key = chain_data_store_->get(kChainHeadKey)) {
       OUTCOME_TRY(cids, decodeCidVector(head_key.value()));
       OUTCOME_TRY(ts_key, TipsetKey::create(std::move(cids)));
       OUTCOME_TRY(tipset, loadTipset(ts_key));
+      OUTCOME_TRY(weight, weight_calculator_->calculateWeight(tipset));
       heaviest_tipset_.reset(tipset);
+      heaviest_weight_ = std::move(weight);
     } else {
       logger_->warn("no previous head tipset found, error = {}",
-                    head_key.error().message());
+                    checkpoint_raw.error().message());
     }
 
     // load genesis block
@@ -90,13 +231,14 @@ namespace fc::storage::blockchain {
       genesis_.reset(genesis_value);
     } else {
       logger_->warn("no previous genesis block found, error = {}",
-                    head_key.error().message());
+                    genesis_key.error().message());
     }
 
     return outcome::success();
   }
 
   outcome::result<Tipset> ChainStoreImpl::heaviestTipset() const {
+    std::shared_lock lock{head_mutex_};
     if (heaviest_tipset_.has_value()) {
       return *heaviest_tipset_;
     }
@@ -105,7 +247,7 @@ namespace fc::storage::blockchain {
 
   outcome::result<bool> ChainStoreImpl::containsTipset(
       const TipsetKey &key) const {
-    if (tipsets_cache_.count(key) > 0) {
+    if (tipsets_cache_->contains(key)) {
       return true;
     }
 
@@ -114,6 +256,7 @@ namespace fc::storage::blockchain {
   }
 
   outcome::result<BlockHeader> ChainStoreImpl::getGenesis() const {
+    std::shared_lock lock{head_mutex_};
     if (genesis_.has_value()) {
       return *genesis_;
     }
@@ -131,15 +274,35 @@ namespace fc::storage::blockchain {
   }
 
   outcome::result<void> ChainStoreImpl::writeHead(const Tipset &tipset) {
-    heaviest_tipset_.reset(tipset);
+    std::lock_guard lock{write_mutex_};
+    return writeHeadLocked(tipset);
+  }
+
+  outcome::result<void> ChainStoreImpl::writeHeadLocked(const Tipset &tipset) {
     OUTCOME_TRY(weight, weight_calculator_->calculateWeight(tipset));
-    heaviest_weight_ = weight;
-    OUTCOME_TRY(data, encodeCidVector(tipset.cids));
-    return chain_data_store_->set(kChainHeadKey, data);
+    {
+      std::unique_lock head_lock{head_mutex_};
+      heaviest_tipset_.reset(tipset);
+      heaviest_weight_ = weight;
+    }
+    OUTCOME_TRY(data,
+                codec::cbor::encode(HeadCheckpoint{tipset.cids, weight}));
+    return chain_data_store_->set(kHeadCheckpointKey,
+                                  std::string{data.begin(), data.end()});
   }
 
   outcome::result<void> ChainStoreImpl::addBlock(const BlockHeader &block) {
-    OUTCOME_TRY(data_store_->setCbor(block));
+    OUTCOME_TRY(block_cid, data_store_->setCbor(block));
+    std::lock_guard lock{write_mutex_};
+    auto &cids = tipsets_[block.height];
+    if (std::find(cids.begin(), cids.end(), block_cid) == cids.end()) {
+      cids.push_back(block_cid);
+    }
+    // blocks far below latest one can't form new tipsets
+    auto latest = tipsets_.rbegin()->first;
+    while (tipsets_.begin()->first + kTipsetsWindow < latest) {
+      tipsets_.erase(tipsets_.begin());
+    }
     OUTCOME_TRY(tipset, expandTipset(block));
     return updateHeaviestTipset(tipset);
   }
@@ -210,9 +373,10 @@ namespace fc::storage::blockchain {
           "No heaviest tipset found, using provided tipset: {}, height: {}",
           cids_json,
           tipset.height);
-      head_change_signal_(
-          HeadChange{.type = HeadChangeType::CURRENT, .value = tipset});
-      return writeHead(tipset);
+      HeadChange change{.type = HeadChangeType::CURRENT, .value = tipset};
+      head_change_signal_(change);
+      head_changes_signal_({change});
+      return writeHeadLocked(tipset);
     }
 
     if (tipset == *heaviest_tipset_) {
@@ -224,52 +388,173 @@ namespace fc::storage::blockchain {
     logger_->info(
         "New heaviest tipset {} (height={})", cids_json, tipset.height);
 
-    OUTCOME_TRY(notifyHeadChange(*heaviest_tipset_, tipset));
-    OUTCOME_TRY(writeHead(tipset));
+    ChainPath path;
+    {
+      std::lock_guard lock{index_mutex_};
+      OUTCOME_TRYA(path, findChainPath(*heaviest_tipset_, tipset));
+      OUTCOME_TRY(updateHeightIndex(path));
+    }
+    notifyHeadChange(path);
+    OUTCOME_TRY(writeHeadLocked(tipset));
 
     return outcome::success();
   }
 
-  outcome::result<void> ChainStoreImpl::notifyHeadChange(const Tipset &current,
-                                                         const Tipset &target) {
-    OUTCOME_TRY(path, findChainPath(current, target));
-
+  void ChainStoreImpl::notifyHeadChange(const ChainPath &path) {
+    std::vector<HeadChange> changes;
+    changes.reserve(path.revert_chain.size() + path.apply_chain.size());
     for (auto &revert_item : path.revert_chain) {
-      head_change_signal_(
+      changes.push_back(
           HeadChange{.type = HeadChangeType::REVERT, .value = revert_item});
+      head_change_signal_(changes.back());
     }
 
     for (auto &apply_item : path.apply_chain) {
-      head_change_signal_(
+      changes.push_back(
           HeadChange{.type = HeadChangeType::APPLY, .value = apply_item});
+      head_change_signal_(changes.back());
+    }
+    head_changes_signal_(changes);
+  }
+
+  outcome::result<void> ChainStoreImpl::updateHeightIndex(
+      const ChainPath &path) {
+    auto parent_height =
+        [&](const Tipset &tipset) -> outcome::result<uint64_t> {
+      OUTCOME_TRY(parent_key, tipset.getParents());
+      OUTCOME_TRY(parent, loadTipset(parent_key));
+      return parent.height;
+    };
+
+    for (auto &revert_item : path.revert_chain) {
+      auto it = height_index_.find(revert_item.height);
+      if (it != height_index_.end() && it->second.cids == revert_item.cids) {
+        height_index_.erase(it);
+      }
+      OUTCOME_TRY(height, parent_height(revert_item));
+      OUTCOME_TRY(updateCheckpoints(revert_item, height, true));
     }
 
+    for (auto &apply_item : path.apply_chain) {
+      OUTCOME_TRY(key, apply_item.makeKey());
+      height_index_.insert_or_assign(apply_item.height, std::move(key));
+      OUTCOME_TRY(height, parent_height(apply_item));
+      OUTCOME_TRY(updateCheckpoints(apply_item, height, false));
+    }
+
+    return outcome::success();
+  }
+
+  outcome::result<void> ChainStoreImpl::updateCheckpoints(
+      const Tipset &tipset, uint64_t parent_height, bool remove) const {
+    auto checkpoint = (parent_height / kCheckpointInterval + 1)
+                      * kCheckpointInterval;
+    if (checkpoint > tipset.height) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(cids_json, encodeCidVector(tipset.cids));
+    if (index_store_) {
+      auto key{kCheckpointPrefix};
+      auto value{common::span::cbytes(cids_json)};
+      for (; checkpoint <= tipset.height; checkpoint += kCheckpointInterval) {
+        key.resize(kCheckpointPrefix.size());
+        key.put(encodeHeight(checkpoint));
+        if (remove) {
+          OUTCOME_TRY(index_store_->remove(BufferView{key}));
+        } else {
+          OUTCOME_TRY(index_store_->put(BufferView{key}, value));
+        }
+      }
+      return outcome::success();
+    }
+    for (; checkpoint <= tipset.height; checkpoint += kCheckpointInterval) {
+      if (remove) {
+        OUTCOME_TRY(chain_data_store_->remove(checkpointKey(checkpoint)));
+      } else {
+        OUTCOME_TRY(
+            chain_data_store_->set(checkpointKey(checkpoint), cids_json));
+      }
+    }
     return outcome::success();
   }
 
+  outcome::result<boost::optional<std::vector<CID>>>
+  ChainStoreImpl::findCheckpoint(uint64_t height, uint64_t lowest) const {
+    if (index_store_) {
+      auto cursor{index_store_->prefixCursor(kCheckpointPrefix)};
+      cursor->seek(encodeHeight(height));
+      if (!cursor->isValid() || cursor->key().size() != sizeof(uint64_t)
+          || decodeHeight(cursor->key()) >= lowest) {
+        return boost::none;
+      }
+      auto value{common::span::cstring(cursor->value())};
+      OUTCOME_TRY(
+          cids, decodeCidVector(std::string_view{value.data(), value.size()}));
+      return std::move(cids);
+    }
+    auto checkpoint = (height + kCheckpointInterval - 1) / kCheckpointInterval
+                      * kCheckpointInterval;
+    if (checkpoint >= lowest) {
+      return boost::none;
+    }
+    auto cids_json = chain_data_store_->get(checkpointKey(checkpoint));
+    if (!cids_json) {
+      return boost::none;
+    }
+    OUTCOME_TRY(cids, decodeCidVector(cids_json.value()));
+    return std::move(cids);
+  }
+
   std::shared_ptr<ChainRandomnessProvider>
   ChainStoreImpl::createRandomnessProvider() {
     return std::make_shared<ChainRandomnessProviderImpl>(shared_from_this());
   }
 
+  outcome::result<bool> ChainStoreImpl::onHeaviestChain(
+      const Tipset &tipset) const {
+    if (tipset.height > heaviest_tipset_->height) {
+      return false;
+    }
+    if (height_index_.empty() || tipset.height < height_index_.begin()->first) {
+      // extends index, or returns genesis
+      OUTCOME_TRY(canonical, loadTipsetByHeightLocked(tipset.height));
+      return canonical.height == tipset.height && canonical.cids == tipset.cids;
+    }
+    auto it = height_index_.find(tipset.height);
+    return it != height_index_.end() && it->second.cids == tipset.cids;
+  }
+
   outcome::result<ChainPath> ChainStoreImpl::findChainPath(
       const Tipset &current, const Tipset &target) {
-    // need to have genesis defined
+    BOOST_ASSERT(heaviest_tipset_.has_value() && current == *heaviest_tipset_);
     ChainPath path{};
-    auto l = current;
+    // only target side is walked, fork point is first its ancestor found in
+    // height index of current chain
     auto r = target;
-    while (l != r) {
-      if (l.height > r.height) {
-        path.revert_chain.emplace_back(l);
-        OUTCOME_TRY(key, l.getParents());
-        OUTCOME_TRY(ts, loadTipset(key));
-        l = std::move(ts);
-      } else {
-        path.apply_chain.emplace_front(r);
-        OUTCOME_TRY(key, r.getParents());
-        OUTCOME_TRY(ts, loadTipset(key));
-        r = std::move(ts);
+    while (true) {
+      OUTCOME_TRY(found, onHeaviestChain(r));
+      if (found) {
+        break;
+      }
+      path.apply_chain.emplace_front(r);
+      OUTCOME_TRY(key, r.getParents());
+      OUTCOME_TRY(ts, loadTipset(key));
+      r = std::move(ts);
+    }
+    for (auto it = height_index_.upper_bound(r.height);
+         it != height_index_.end();
+         ++it) {
+      OUTCOME_TRY(ts, loadTipset(it->second));
+      path.revert_chain.emplace_front(std::move(ts));
+    }
+    // fork point found by checkpoint may be below index
+    while (!path.revert_chain.empty()) {
+      OUTCOME_TRY(key, path.revert_chain.back().getParents());
+      if (key.cids == r.cids) {
+        break;
       }
+      OUTCOME_TRY(ts, loadTipset(key));
+      path.revert_chain.emplace_back(std::move(ts));
     }
     return path;
   }
@@ -288,6 +573,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::blockchain, ChainStoreError, e) {
       return "no genesis block in storage";
     case ChainStoreError::STORE_NOT_INITIALIZED:
       return "store is not initialized properly";
+    case ChainStoreError::NO_TIPSET_AT_HEIGHT:
+      return "height is above heaviest tipset";
   }
 
   return "ChainStoreError: unknown error";
@@ -7,6 +7,8 @@
 #define CPP_FILECOIN_CORE_STORAGE_CHAIN_CHAIN_STORE_IMPL_HPP
 
 #include <map>
+#include <mutex>
+#include <shared_mutex>
 
 #include "blockchain/block_validator/block_validator.hpp"
 #include "blockchain/weight_calculator.hpp"
@@ -17,8 +19,13 @@
 #include "primitives/cid/cid.hpp"
 #include "storage/chain/chain_data_store.hpp"
 #include "storage/chain/chain_store.hpp"
+#include "storage/chain/impl/tipset_cache.hpp"
 #include "storage/ipfs/impl/ipfs_block_service.hpp"
 
+namespace fc::storage {
+  class LevelDB;
+}  // namespace fc::storage
+
 namespace fc::storage::blockchain {
 
   using ::fc::blockchain::block_validator::BlockValidator;
@@ -33,39 +40,81 @@ namespace fc::storage::blockchain {
     NO_HEAVIEST_TIPSET,
     NO_GENESIS_BLOCK,
     STORE_NOT_INITIALIZED,
+    NO_TIPSET_AT_HEIGHT,
   };
 
+  /**
+   * Chain store, thread-safe. Head changes are serialized and notified under
+   * write lock, subscribers may read store, but must not add blocks or
+   * subscribe.
+   */
   class ChainStoreImpl : public ChainStore,
                          public std::enable_shared_from_this<ChainStoreImpl> {
    public:
-    ChainStoreImpl(ChainStoreImpl &&other) = default;
+    /// distance between persistent height index checkpoints
+    static constexpr uint64_t kCheckpointInterval{100};
+    /// default number of unpinned tipsets kept in cache
+    static constexpr size_t kTipsetCacheCapacity{8192};
+    /// number of epochs below latest block to track blocks for tipsets
+    static constexpr uint64_t kTipsetsWindow{900};
 
     /* @brief creates new ChainStore instance */
     static outcome::result<std::shared_ptr<ChainStoreImpl>> create(
         std::shared_ptr<IpfsDatastore> data_store,
         std::shared_ptr<BlockValidator> block_validator,
-        std::shared_ptr<WeightCalculator> weight_calculator);
+        std::shared_ptr<WeightCalculator> weight_calculator,
+        size_t tipset_cache_capacity = kTipsetCacheCapacity);
 
     /** @brief stores head tipset */
     outcome::result<void> writeHead(const Tipset &tipset);
 
+    /**
+     * @brief keeps height checkpoints in ordered store under binary keys,
+     * so lookup below indexed part of chain seeks nearest checkpoint
+     * instead of reading one at computed height. Set before initialize.
+     */
+    void setIndexStore(std::shared_ptr<LevelDB> index_store) {
+      index_store_ = std::move(index_store);
+    }
+
     /** @brief loads data from block storage and initializes storage */
     outcome::result<void> initialize();
 
     outcome::result<Tipset> loadTipset(const TipsetKey &key) const override;
 
+    outcome::result<TipsetCPtr> loadSharedTipset(
+        const TipsetKey &key) const override;
+
+    outcome::result<Tipset> loadTipsetByHeight(
+        uint64_t height) const override;
+
     outcome::result<void> addBlock(const BlockHeader &block) override;
 
     outcome::result<Tipset> heaviestTipset() const override;
 
     outcome::result<bool> containsTipset(const TipsetKey &key) const override;
 
+    /**
+     * @brief keeps tipset in cache until unpinned, e.g. while it is used by
+     * in-flight sync, pins are counted
+     */
+    outcome::result<void> pinTipset(const TipsetKey &key);
+
+    /** @brief releases tipset pinned by pinTipset */
+    void unpinTipset(const TipsetKey &key);
+
+    /** @brief tipset cache counters */
+    TipsetCacheStats tipsetCacheStats() const {
+      return tipsets_cache_->stats();
+    }
+
     outcome::result<BlockHeader> getGenesis() const override;
 
     outcome::result<void> writeGenesis(
         const BlockHeader &block_header) override;
 
     primitives::BigInt getHeaviestWeight() const override {
+      std::shared_lock lock{head_mutex_};
       return heaviest_weight_;
     }
 
@@ -82,6 +131,15 @@ namespace fc::storage::blockchain {
       return data_store_->get(key);
     }
 
+    outcome::result<void> setMany(Blocks blocks) override {
+      return data_store_->setMany(std::move(blocks));
+    }
+
+    outcome::result<std::vector<Value>> getMany(
+        gsl::span<const CID> keys) const override {
+      return data_store_->getMany(keys);
+    }
+
     outcome::result<void> remove(const CID &key) override {
       return data_store_->remove(key);
     }
@@ -93,6 +151,8 @@ namespace fc::storage::blockchain {
     /** @brief head change subscription */
     connection_t subscribeHeadChanges(
         const std::function<HeadChangeSignature> &subscriber) override {
+      // no head change between current head and connection
+      std::lock_guard lock{write_mutex_};
       if (heaviest_tipset_.has_value()) {
         subscriber(HeadChange{.type = HeadChangeType::CURRENT,
                               .value = *heaviest_tipset_});
@@ -100,6 +160,16 @@ namespace fc::storage::blockchain {
       return head_change_signal_.connect(subscriber);
     }
 
+    connection_t subscribeHeadChangeBatches(
+        const std::function<HeadChangesSignature> &subscriber) override {
+      std::lock_guard lock{write_mutex_};
+      if (heaviest_tipset_.has_value()) {
+        subscriber({HeadChange{.type = HeadChangeType::CURRENT,
+                               .value = *heaviest_tipset_}});
+      }
+      return head_changes_signal_.connect(subscriber);
+    }
+
     IpldPtr shared() override {
       BOOST_ASSERT_MSG(false, "not implemented");
     }
@@ -107,7 +177,11 @@ namespace fc::storage::blockchain {
    private:
     ChainStoreImpl(std::shared_ptr<IpfsDatastore> data_store,
                    std::shared_ptr<BlockValidator> block_validator,
-                   std::shared_ptr<WeightCalculator> weight_calculator);
+                   std::shared_ptr<WeightCalculator> weight_calculator,
+                   size_t tipset_cache_capacity);
+
+    /// writeHead with write_mutex_ locked
+    outcome::result<void> writeHeadLocked(const Tipset &tipset);
 
     /**
      * @brief applies new heaviest tipset if better than old item
@@ -120,9 +194,19 @@ namespace fc::storage::blockchain {
 
     outcome::result<void> updateHeaviestTipset(const Tipset &tipset);
 
+    /// loadTipsetByHeight with index_mutex_ locked
+    outcome::result<Tipset> loadTipsetByHeightLocked(uint64_t height) const;
+
+    /**
+     * @brief checks whether tipset is on heaviest chain by height index,
+     * extends index if tipset is below it, index_mutex_ must be locked
+     */
+    outcome::result<bool> onHeaviestChain(const Tipset &tipset) const;
+
     /**
-     * @brief finds path from current tipset to new tipset
-     * @param current denotes current tipset
+     * @brief finds path from current tipset to new tipset, only tipsets of
+     * target branch are walked, fork point is looked up in height index
+     * @param current denotes current tipset, must be heaviest tipset
      * @param target denotes new tipset
      * @return path from current to target tipset
      */
@@ -131,27 +215,74 @@ namespace fc::storage::blockchain {
 
     /**
      * @brief notifies all head change subscribers
-     * @param current denotes current tipset
-     * @param target denotes target tipset
+     * @param path path from current to target tipset
+     */
+    void notifyHeadChange(const ChainPath &path);
+
+    /**
+     * @brief moves height index from current heaviest chain to new one,
+     * index_mutex_ must be locked
+     * @param path path from current to target tipset
+     */
+    outcome::result<void> updateHeightIndex(const ChainPath &path);
+
+    /**
+     * @brief writes or removes persistent checkpoints pointing to tipset,
+     * i.e. checkpoints at heights (parent height, tipset height]
+     * @param tipset tipset of heaviest chain
+     * @param parent_height height of tipset parent
+     * @param remove whether to remove checkpoints instead of writing
      */
-    outcome::result<void> notifyHeadChange(const Tipset &current,
-                                           const Tipset &target);
+    outcome::result<void> updateCheckpoints(const Tipset &tipset,
+                                            uint64_t parent_height,
+                                            bool remove) const;
+
+    /**
+     * @brief finds persistent checkpoint at or above height and below
+     * lowest indexed height
+     * @return cids of checkpoint tipset, none if there is no such checkpoint
+     */
+    outcome::result<boost::optional<std::vector<CID>>> findCheckpoint(
+        uint64_t height, uint64_t lowest) const;
 
     ///< main data storage
     std::shared_ptr<IpfsDatastore> data_store_;
     ///< wrapper around main data storage to store tipset keys
     std::shared_ptr<ChainDataStore> chain_data_store_;
+    ///< ordered store of checkpoints, chain_data_store_ is used if null
+    std::shared_ptr<LevelDB> index_store_;
     std::shared_ptr<BlockValidator> block_validator_;
     std::shared_ptr<WeightCalculator> weight_calculator_;
 
+    /**
+     * Serializes head changes and guards tipsets_, head changes also lock
+     * head_mutex_ exclusively, so writers read head without head_mutex_
+     */
+    mutable std::mutex write_mutex_;
+    /// Guards head and genesis read by concurrent calls
+    mutable std::shared_mutex head_mutex_;
     boost::optional<Tipset> heaviest_tipset_;  ///< current heaviest tipset
     primitives::BigInt heaviest_weight_{0};    ///< current heaviest weight
     boost::optional<BlockHeader> genesis_;     ///< genesis block
-    std::unordered_map<uint64_t, std::vector<CID>> tipsets_;
-    mutable std::unordered_map<TipsetKey, Tipset> tipsets_cache_;
+    ///< recent block cids by height, kept for kTipsetsWindow epochs
+    std::map<uint64_t, std::vector<CID>> tipsets_;
+    std::shared_ptr<TipsetCache> tipsets_cache_;
+    /**
+     * Heaviest chain tipset keys by height, contains every tipset from the
+     * lowest indexed height up to head. Lower heights are found by walking
+     * back from persistent checkpoints, written every kCheckpointInterval
+     * epochs.
+     */
+    mutable std::map<uint64_t, TipsetKey> height_index_;
+    /**
+     * Guards height_index_ and persistent checkpoints, which are extended by
+     * readers and moved by head change
+     */
+    mutable std::mutex index_mutex_;
 
     ///< when head tipset changes, need to notify all subscribers
     boost::signals2::signal<HeadChangeSignature> head_change_signal_;
+    boost::signals2::signal<HeadChangesSignature> head_changes_signal_;
 
     common::Logger logger_;
   };
@@ -0,0 +1,95 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/impl/tipset_cache.hpp"
+
+namespace fc::storage::blockchain {
+
+  TipsetCache::TipsetCache(size_t capacity) : capacity_{capacity} {}
+
+  TipsetCPtr TipsetCache::get(const TipsetKey &key) {
+    std::lock_guard lock{mutex_};
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      ++stats_.misses;
+      return nullptr;
+    }
+    ++stats_.hits;
+    auto &entry = it->second;
+    if (entry.pins == 0) {
+      lru_.splice(lru_.begin(), lru_, entry.lru);
+    }
+    return entry.tipset;
+  }
+
+  bool TipsetCache::contains(const TipsetKey &key) const {
+    std::lock_guard lock{mutex_};
+    return entries_.count(key) != 0;
+  }
+
+  TipsetCPtr TipsetCache::put(const TipsetKey &key, TipsetCPtr tipset) {
+    std::lock_guard lock{mutex_};
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      if (it->second.pins == 0) {
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+      }
+      return it->second.tipset;
+    }
+    if (capacity_ == 0) {
+      return tipset;
+    }
+    lru_.push_front(key);
+    entries_.emplace(key, Entry{tipset, 0, lru_.begin()});
+    evict();
+    return tipset;
+  }
+
+  void TipsetCache::pin(const TipsetKey &key, TipsetCPtr tipset) {
+    std::lock_guard lock{mutex_};
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      it = entries_.emplace(key, Entry{std::move(tipset), 0, lru_.end()})
+               .first;
+    } else if (it->second.pins == 0) {
+      lru_.erase(it->second.lru);
+    }
+    if (it->second.pins++ == 0) {
+      ++stats_.pinned;
+    }
+  }
+
+  bool TipsetCache::unpin(const TipsetKey &key) {
+    std::lock_guard lock{mutex_};
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.pins == 0) {
+      return false;
+    }
+    auto &entry = it->second;
+    if (--entry.pins == 0) {
+      --stats_.pinned;
+      lru_.push_front(key);
+      entry.lru = lru_.begin();
+      evict();
+    }
+    return true;
+  }
+
+  TipsetCacheStats TipsetCache::stats() const {
+    std::lock_guard lock{mutex_};
+    auto stats = stats_;
+    stats.entries = entries_.size();
+    return stats;
+  }
+
+  void TipsetCache::evict() {
+    while (lru_.size() > capacity_) {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+      ++stats_.evictions;
+    }
+  }
+
+}  // namespace fc::storage::blockchain
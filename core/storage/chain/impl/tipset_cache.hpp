@@ -0,0 +1,93 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_IMPL_TIPSET_CACHE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_CHAIN_IMPL_TIPSET_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+#include "primitives/tipset/tipset.hpp"
+
+namespace fc::storage::blockchain {
+  using primitives::tipset::Tipset;
+  using primitives::tipset::TipsetCPtr;
+  using primitives::tipset::TipsetKey;
+
+  /// Tipset cache counters and occupancy
+  struct TipsetCacheStats {
+    uint64_t hits{};
+    uint64_t misses{};
+    uint64_t evictions{};
+    uint64_t entries{};
+    uint64_t pinned{};
+  };
+
+  /**
+   * @class TipsetCache bounded LRU cache of loaded tipsets.
+   * Tipsets are shared immutable, cached tipset is returned instead of
+   * equal one put again, so users share one copy of blocks.
+   * Pinned tipsets (e.g. used by in-flight sync) are never evicted and are
+   * not counted against capacity.
+   */
+  class TipsetCache {
+   public:
+    explicit TipsetCache(size_t capacity);
+
+    /// Get tipset and mark it as recently used, null if not cached
+    TipsetCPtr get(const TipsetKey &key);
+
+    /// Check whether tipset is cached, does not affect eviction order
+    bool contains(const TipsetKey &key) const;
+
+    /**
+     * @brief insert tipset, evicting least recently used tipsets over
+     * capacity
+     * @return cached tipset if key is already cached, otherwise given one
+     */
+    TipsetCPtr put(const TipsetKey &key, TipsetCPtr tipset);
+
+    /**
+     * @brief pin tipset, inserting it if not cached, pins are counted
+     * @param key tipset key
+     * @param tipset tipset to keep in cache until unpinned
+     */
+    void pin(const TipsetKey &key, TipsetCPtr tipset);
+
+    /**
+     * @brief unpin tipset, after last unpin it is evictable again
+     * @return false if tipset was not pinned
+     */
+    bool unpin(const TipsetKey &key);
+
+    /// Get cache counters
+    TipsetCacheStats stats() const;
+
+   private:
+    using Lru = std::list<TipsetKey>;
+
+    struct Entry {
+      TipsetCPtr tipset;
+      size_t pins{};
+      /// position in lru_, valid only if not pinned
+      Lru::iterator lru;
+    };
+
+    void evict();
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    /// keys of unpinned entries, most recently used first
+    Lru lru_;
+    std::unordered_map<TipsetKey, Entry> entries_;
+    TipsetCacheStats stats_;
+  };
+
+}  // namespace fc::storage::blockchain
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_CHAIN_IMPL_TIPSET_CACHE_HPP
@@ -4,68 +4,202 @@
  */
 
 #include "storage/chain/msg_waiter.hpp"
+
 #include "adt/array.hpp"
 
 namespace fc::storage::blockchain {
   using primitives::tipset::MessageVisitor;
 
-  MsgWaiter::MsgWaiter(IpldPtr ipld) : ipld{ipld} {}
+  namespace {
+    constexpr uint8_t kMessagePrefix{'m'};
+    constexpr uint8_t kHeightPrefix{'h'};
+
+    /// Tipset with receipt of message and index of receipt
+    struct Inclusion {
+      std::vector<CID> tipset;
+      uint64_t index{};
+    };
+    CBOR_TUPLE(Inclusion, tipset, index)
+
+    outcome::result<Buffer> messageKey(const CID &cid) {
+      OUTCOME_TRY(bytes, cid.toBytes());
+      Buffer key;
+      key.putUint8(kMessagePrefix);
+      key.put(bytes);
+      return key;
+    }
+
+    Buffer heightKey(uint64_t height) {
+      Buffer key;
+      key.putUint8(kHeightPrefix);
+      key.putUint64(height);
+      return key;
+    }
+  }  // namespace
+
+  MsgWaiter::MsgWaiter(IpldPtr ipld,
+                       std::shared_ptr<PersistentBufferMap> index)
+      : ipld{ipld}, index{std::move(index)} {}
 
   std::shared_ptr<MsgWaiter> MsgWaiter::create(
-      IpldPtr ipld, std::shared_ptr<ChainStore> chain_store) {
-    auto waiter{std::make_shared<MsgWaiter>(ipld)};
-    waiter->head_sub = chain_store->subscribeHeadChanges([=](auto &change) {
-      auto res{waiter->onHeadChange(change)};
-      if (!res) {
-        spdlog::error("MsgWaiter.onHeadChange: error {} \"{}\"",
-                      res.error(),
-                      res.error().message());
-      }
-    });
+      IpldPtr ipld,
+      HeadChangeDispatcher &head_changes,
+      boost::asio::executor executor,
+      std::shared_ptr<PersistentBufferMap> index) {
+    auto waiter{std::make_shared<MsgWaiter>(ipld, index)};
+    waiter->head_sub = head_changes.subscribe(
+        "msg_waiter", std::move(executor), [=](auto &changes) {
+          for (auto &change : changes) {
+            auto res{waiter->onHeadChange(change)};
+            if (!res) {
+              spdlog::error("MsgWaiter.onHeadChange: error {} \"{}\"",
+                            res.error(),
+                            res.error().message());
+            }
+          }
+        });
     return waiter;
   }
 
   outcome::result<void> MsgWaiter::onHeadChange(const HeadChange &change) {
+    std::lock_guard lock{mutex};
     auto onTipset = [&](auto &ts, auto apply) -> outcome::result<Tipset> {
       OUTCOME_TRY(parent, ts.loadParent(*ipld));
       OUTCOME_TRY(key, ts.makeKey());
       adt::Array<MessageReceipt> receipts{ts.getParentMessageReceipts(), ipld};
+      auto batch{index ? index->batch() : nullptr};
       OUTCOME_TRY(parent.visitMessages(
           ipld, [&](auto i, auto, auto &cid) -> outcome::result<void> {
             if (apply) {
-              OUTCOME_TRY(receipt, receipts.get(i));
-              auto result{results.emplace(cid, std::make_pair(receipt, key))};
               auto callbacks{waiting.find(cid)};
+              if (index) {
+                OUTCOME_TRY(message_key, messageKey(cid));
+                OUTCOME_TRY(inclusion,
+                            codec::cbor::encode(Inclusion{key.cids, i}));
+                OUTCOME_TRY(batch->put(message_key, inclusion));
+                if (callbacks == waiting.end()) {
+                  return outcome::success();
+                }
+              }
+              OUTCOME_TRY(receipt, receipts.get(i));
+              Result result{receipt, key};
+              if (!index) {
+                results.emplace(cid, result);
+              }
               if (callbacks != waiting.end()) {
                 for (auto &callback : callbacks->second) {
-                  callback(result.first->second);
+                  callback(result);
                 }
                 waiting.erase(cid);
               }
+            } else if (index) {
+              OUTCOME_TRY(message_key, messageKey(cid));
+              OUTCOME_TRY(batch->remove(message_key));
             } else {
               results.erase(cid);
             }
             return outcome::success();
           }));
+      if (index) {
+        if (apply) {
+          OUTCOME_TRY(cids, codec::cbor::encode(ts.cids));
+          OUTCOME_TRY(batch->put(heightKey(ts.height), cids));
+        } else {
+          OUTCOME_TRY(batch->remove(heightKey(ts.height)));
+        }
+        OUTCOME_TRY(batch->commit());
+      }
       return std::move(parent);
     };
-    if (change.type == HeadChangeType::CURRENT) {
+    if (change.type != HeadChangeType::CURRENT) {
+      OUTCOME_TRY(onTipset(change.value, change.type == HeadChangeType::APPLY));
+      return outcome::success();
+    }
+    if (!index) {
       auto ts{change.value};
       while (ts.height > 0) {
         OUTCOME_TRYA(ts, onTipset(ts, true));
       }
-    } else {
-      OUTCOME_TRY(onTipset(change.value, change.type == HeadChangeType::APPLY));
+      return outcome::success();
+    }
+
+    // backfill down to latest indexed tipset, revert other fork above it
+    std::vector<Tipset> tipsets;
+    auto ts{change.value};
+    while (ts.height > 0) {
+      OUTCOME_TRY(indexed, isIndexed(ts));
+      if (indexed) {
+        break;
+      }
+      tipsets.push_back(ts);
+      OUTCOME_TRYA(ts, ts.loadParent(*ipld));
+    }
+    std::vector<std::vector<CID>> stale;
+    if (auto cursor{index->cursor()}) {
+      for (cursor->seek(heightKey(ts.height + 1));
+           cursor->isValid() && cursor->key()[0] == kHeightPrefix;
+           cursor->next()) {
+        OUTCOME_TRY(cids,
+                    codec::cbor::decode<std::vector<CID>>(cursor->value()));
+        stale.push_back(std::move(cids));
+      }
+    }
+    for (auto &cids : stale) {
+      OUTCOME_TRY(stale_ts, Tipset::load(*ipld, cids));
+      OUTCOME_TRY(onTipset(stale_ts, false));
+    }
+    for (auto it{tipsets.rbegin()}; it != tipsets.rend(); ++it) {
+      OUTCOME_TRY(onTipset(*it, true));
     }
     return outcome::success();
   }
 
   void MsgWaiter::wait(const CID &cid, const Callback &callback) {
-    auto result{results.find(cid)};
-    if (result != results.end()) {
-      callback(result->second);
+    // head change must not apply message between find and waiting
+    std::lock_guard lock{mutex};
+    auto result{findLocked(cid)};
+    if (result && result.value()) {
+      callback(*result.value());
     } else {
       waiting[cid].push_back(callback);
     }
   }
+
+  outcome::result<boost::optional<MsgWaiter::Result>> MsgWaiter::find(
+      const CID &cid) const {
+    std::lock_guard lock{mutex};
+    return findLocked(cid);
+  }
+
+  outcome::result<boost::optional<MsgWaiter::Result>> MsgWaiter::findLocked(
+      const CID &cid) const {
+    if (!index) {
+      auto result{results.find(cid)};
+      if (result == results.end()) {
+        return boost::none;
+      }
+      return result->second;
+    }
+    OUTCOME_TRY(message_key, messageKey(cid));
+    if (!index->contains(message_key)) {
+      return boost::none;
+    }
+    OUTCOME_TRY(bytes, index->get(message_key));
+    OUTCOME_TRY(inclusion, codec::cbor::decode<Inclusion>(bytes));
+    OUTCOME_TRY(ts, Tipset::load(*ipld, inclusion.tipset));
+    OUTCOME_TRY(key, ts.makeKey());
+    adt::Array<MessageReceipt> receipts{ts.getParentMessageReceipts(), ipld};
+    OUTCOME_TRY(receipt, receipts.get(inclusion.index));
+    return Result{std::move(receipt), std::move(key)};
+  }
+
+  outcome::result<bool> MsgWaiter::isIndexed(const Tipset &tipset) const {
+    auto key{heightKey(tipset.height)};
+    if (!index->contains(key)) {
+      return false;
+    }
+    OUTCOME_TRY(bytes, index->get(key));
+    OUTCOME_TRY(cids, codec::cbor::decode<std::vector<CID>>(bytes));
+    return cids == tipset.cids;
+  }
 }  // namespace fc::storage::blockchain
@@ -6,26 +6,52 @@
 #ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_MSG_WAITER_HPP
 #define CPP_FILECOIN_CORE_STORAGE_CHAIN_MSG_WAITER_HPP
 
-#include "storage/chain/chain_store.hpp"
+#include <mutex>
+
+#include "storage/buffer_map.hpp"
+#include "storage/chain/head_change_dispatcher.hpp"
 #include "vm/runtime/runtime_types.hpp"
 
 namespace fc::storage::blockchain {
   using vm::runtime::MessageReceipt;
 
+  /**
+   * Waits for message receipts. With index store, inclusions of messages
+   * are persisted as (tipset key, receipt index), so lookups of old messages
+   * are point reads and results are not kept in memory. Indexed tipsets are
+   * recorded by height, so restart only backfills tipsets not indexed yet.
+   * Thread-safe, callbacks are called with waiter locked.
+   */
   struct MsgWaiter : public std::enable_shared_from_this<MsgWaiter> {
     using Result = std::pair<MessageReceipt, TipsetKey>;
     using Callback = std::function<void(const Result &)>;
 
-    explicit MsgWaiter(IpldPtr ipld);
+    explicit MsgWaiter(IpldPtr ipld,
+                       std::shared_ptr<PersistentBufferMap> index = nullptr);
     static std::shared_ptr<MsgWaiter> create(
-        IpldPtr ipld, std::shared_ptr<ChainStore> chain_store);
+        IpldPtr ipld,
+        HeadChangeDispatcher &head_changes,
+        boost::asio::executor executor,
+        std::shared_ptr<PersistentBufferMap> index = nullptr);
     outcome::result<void> onHeadChange(const HeadChange &change);
     void wait(const CID &cid, const Callback &callback);
+    /// @return receipt of message and key of tipset with it, none if unknown
+    outcome::result<boost::optional<Result>> find(const CID &cid) const;
 
+    mutable std::mutex mutex;
     IpldPtr ipld;
     ChainStore::connection_t head_sub;
+    /// Results of messages seen since start, used without index
     std::map<CID, Result> results;
     std::map<CID, std::vector<Callback>> waiting;
+    std::shared_ptr<PersistentBufferMap> index;
+
+   private:
+    /// find with mutex locked
+    outcome::result<boost::optional<Result>> findLocked(const CID &cid) const;
+
+    /// @return true if tipset is recorded as indexed
+    outcome::result<bool> isIndexed(const Tipset &tipset) const;
   };
 }  // namespace fc::storage::blockchain
 
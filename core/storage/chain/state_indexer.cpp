@@ -0,0 +1,252 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/state_indexer.hpp"
+
+#include <boost/endian/conversion.hpp>
+
+#include "adt/address_key.hpp"
+#include "adt/map.hpp"
+#include "common/logger.hpp"
+#include "common/todo_error.hpp"
+#include "primitives/address/address_codec.hpp"
+
+namespace fc::storage::blockchain {
+  namespace {
+    constexpr uint8_t kMessagePrefix{'m'};
+    constexpr uint8_t kActorPrefix{'a'};
+    constexpr uint8_t kUndoPrefix{'u'};
+
+    /// Keys written for indexed tipset
+    struct Undo {
+      std::vector<CID> tipset;
+      std::vector<Buffer> keys;
+    };
+    CBOR_TUPLE(Undo, tipset, keys)
+
+    /// Address encoding is prefix-free, so prefix matches only its address
+    Buffer addressPrefix(uint8_t prefix, const Address &address) {
+      Buffer key;
+      key.putUint8(prefix);
+      key.put(primitives::address::encode(address));
+      return key;
+    }
+
+    Buffer undoKey(uint64_t height) {
+      Buffer key;
+      key.putUint8(kUndoPrefix);
+      key.putUint64(height);
+      return key;
+    }
+
+    /// Height written after prefix
+    uint64_t heightAt(const Buffer &key, size_t offset) {
+      return boost::endian::load_big_u64(key.data() + offset);
+    }
+  }  // namespace
+
+  StateIndexer::StateIndexer(IpldPtr ipld,
+                             std::shared_ptr<PersistentBufferMap> store)
+      : ipld_{std::move(ipld)}, store_{std::move(store)} {}
+
+  std::shared_ptr<StateIndexer> StateIndexer::create(
+      IpldPtr ipld,
+      std::shared_ptr<PersistentBufferMap> store,
+      HeadChangeDispatcher &head_changes,
+      boost::asio::executor executor) {
+    auto indexer{std::make_shared<StateIndexer>(ipld, store)};
+    indexer->head_sub_ = head_changes.subscribe(
+        "state_indexer", std::move(executor), [=](auto &changes) {
+          for (auto &change : changes) {
+            auto res{indexer->onHeadChange(change)};
+            if (!res) {
+              spdlog::error("StateIndexer.onHeadChange: error {} \"{}\"",
+                            res.error(),
+                            res.error().message());
+            }
+          }
+        });
+    return indexer;
+  }
+
+  outcome::result<void> StateIndexer::onHeadChange(const HeadChange &change) {
+    if (change.type == HeadChangeType::APPLY) {
+      return apply(change.value);
+    }
+    if (change.type == HeadChangeType::REVERT) {
+      OUTCOME_TRY(indexed, isIndexed(change.value));
+      if (indexed) {
+        OUTCOME_TRY(revert(change.value.height));
+      }
+      return outcome::success();
+    }
+    // find latest indexed ancestor, entries above it are of other fork
+    std::vector<Tipset> tipsets;
+    auto ts{change.value};
+    while (ts.height > 0) {
+      OUTCOME_TRY(indexed, isIndexed(ts));
+      if (indexed) {
+        break;
+      }
+      tipsets.push_back(ts);
+      OUTCOME_TRYA(ts, ts.loadParent(*ipld_));
+    }
+    std::vector<uint64_t> stale;
+    OUTCOME_TRY(scan(Buffer{}.putUint8(kUndoPrefix),
+                     [&](auto &key, auto &) -> outcome::result<void> {
+                       auto height{heightAt(key, 1)};
+                       if (height > ts.height) {
+                         stale.push_back(height);
+                       }
+                       return outcome::success();
+                     }));
+    for (auto height : stale) {
+      OUTCOME_TRY(revert(height));
+    }
+    for (auto it{tipsets.rbegin()}; it != tipsets.rend(); ++it) {
+      OUTCOME_TRY(apply(*it));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<std::vector<StateIndexer::MessageEntry>>
+  StateIndexer::messages(const Address &address) const {
+    std::vector<MessageEntry> entries;
+    auto prefix{addressPrefix(kMessagePrefix, address)};
+    OUTCOME_TRY(scan(prefix, [&](auto &key, auto &) -> outcome::result<void> {
+      auto epoch{heightAt(key, prefix.size())};
+      OUTCOME_TRY(
+          cid, CID::fromBytes(key.subbuffer(prefix.size() + sizeof(uint64_t))));
+      entries.push_back({static_cast<ChainEpoch>(epoch), std::move(cid)});
+      return outcome::success();
+    }));
+    return entries;
+  }
+
+  outcome::result<std::vector<StateIndexer::ActorEntry>>
+  StateIndexer::actorChanges(const Address &address) const {
+    std::vector<ActorEntry> entries;
+    auto prefix{addressPrefix(kActorPrefix, address)};
+    OUTCOME_TRY(
+        scan(prefix, [&](auto &key, auto &value) -> outcome::result<void> {
+          ActorEntry entry;
+          entry.epoch = heightAt(key, prefix.size());
+          if (!value.empty()) {
+            OUTCOME_TRY(actor, codec::cbor::decode<Actor>(value));
+            entry.actor = std::move(actor);
+          }
+          entries.push_back(std::move(entry));
+          return outcome::success();
+        }));
+    return entries;
+  }
+
+  outcome::result<void> StateIndexer::apply(const Tipset &tipset) {
+    if (tipset.height == 0) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(indexed, isIndexed(tipset));
+    if (indexed) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(revert(tipset.height));
+    OUTCOME_TRY(parent, tipset.loadParent(*ipld_));
+    auto batch{store_->batch()};
+    Undo undo{tipset.cids, {}};
+    auto put = [&](Buffer key, const Buffer &value) -> outcome::result<void> {
+      OUTCOME_TRY(batch->put(key, value));
+      undo.keys.push_back(std::move(key));
+      return outcome::success();
+    };
+
+    OUTCOME_TRY(parent.visitMessages(
+        ipld_, [&](auto, auto bls, auto &cid) -> outcome::result<void> {
+          UnsignedMessage message;
+          if (bls) {
+            OUTCOME_TRYA(message, ipld_->getCbor<UnsignedMessage>(cid));
+          } else {
+            OUTCOME_TRY(signed_message, ipld_->getCbor<SignedMessage>(cid));
+            message = std::move(signed_message.message);
+          }
+          OUTCOME_TRY(cid_bytes, cid.toBytes());
+          auto putMessage = [&](auto &address) {
+            return put(addressPrefix(kMessagePrefix, address)
+                           .putUint64(tipset.height)
+                           .put(cid_bytes),
+                       {});
+          };
+          OUTCOME_TRY(putMessage(message.from));
+          if (message.to != message.from) {
+            OUTCOME_TRY(putMessage(message.to));
+          }
+          return outcome::success();
+        }));
+
+    adt::Map<Actor, adt::AddressKeyer> before{parent.getParentStateRoot(),
+                                              ipld_};
+    adt::Map<Actor, adt::AddressKeyer> after{tipset.getParentStateRoot(),
+                                             ipld_};
+    OUTCOME_TRY(after.diff(
+        before,
+        [&](auto &address, auto, auto actor) -> outcome::result<void> {
+          Buffer value;
+          if (actor) {
+            OUTCOME_TRYA(value, codec::cbor::encode(*actor));
+          }
+          return put(
+              addressPrefix(kActorPrefix, address).putUint64(tipset.height),
+              value);
+        }));
+
+    OUTCOME_TRY(undo_bytes, codec::cbor::encode(undo));
+    OUTCOME_TRY(batch->put(undoKey(tipset.height), undo_bytes));
+    return batch->commit();
+  }
+
+  outcome::result<void> StateIndexer::revert(ChainEpoch height) {
+    auto key{undoKey(height)};
+    if (!store_->contains(key)) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(bytes, store_->get(key));
+    OUTCOME_TRY(undo, codec::cbor::decode<Undo>(bytes));
+    auto batch{store_->batch()};
+    for (auto &written : undo.keys) {
+      OUTCOME_TRY(batch->remove(written));
+    }
+    OUTCOME_TRY(batch->remove(key));
+    return batch->commit();
+  }
+
+  outcome::result<bool> StateIndexer::isIndexed(const Tipset &tipset) const {
+    auto key{undoKey(tipset.height)};
+    if (!store_->contains(key)) {
+      return false;
+    }
+    OUTCOME_TRY(bytes, store_->get(key));
+    OUTCOME_TRY(undo, codec::cbor::decode<Undo>(bytes));
+    return undo.tipset == tipset.cids;
+  }
+
+  outcome::result<void> StateIndexer::scan(
+      const Buffer &prefix,
+      const std::function<outcome::result<void>(const Buffer &key,
+                                                const Buffer &value)>
+          &visitor) const {
+    auto cursor{store_->cursor()};
+    if (!cursor) {
+      return TodoError::ERROR;
+    }
+    for (cursor->seek(prefix); cursor->isValid(); cursor->next()) {
+      auto key{cursor->key()};
+      if (key.size() < prefix.size()
+          || !std::equal(prefix.begin(), prefix.end(), key.begin())) {
+        break;
+      }
+      OUTCOME_TRY(visitor(key, cursor->value()));
+    }
+    return outcome::success();
+  }
+}  // namespace fc::storage::blockchain
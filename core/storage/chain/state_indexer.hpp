@@ -0,0 +1,81 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_CHAIN_STATE_INDEXER_HPP
+#define CPP_FILECOIN_CORE_STORAGE_CHAIN_STATE_INDEXER_HPP
+
+#include "storage/buffer_map.hpp"
+#include "storage/chain/head_change_dispatcher.hpp"
+#include "vm/actor/actor.hpp"
+
+namespace fc::storage::blockchain {
+  using primitives::ChainEpoch;
+  using primitives::address::Address;
+  using vm::actor::Actor;
+
+  /**
+   * Secondary indexes of chain, updated from head changes by diff of parent
+   * and child state roots, so cost of tipset is proportional to its changes.
+   * Indexed tipsets are recorded with written keys, which are removed when
+   * tipset is reverted.
+   *
+   * Entries are keyed by epoch of tipset whose parent state includes them,
+   * i.e. tipset with receipt of message or state after change.
+   */
+  class StateIndexer : public std::enable_shared_from_this<StateIndexer> {
+   public:
+    struct MessageEntry {
+      ChainEpoch epoch{};
+      CID cid;
+    };
+
+    struct ActorEntry {
+      ChainEpoch epoch{};
+      /// Actor after change, none if removed
+      boost::optional<Actor> actor;
+    };
+
+    StateIndexer(IpldPtr ipld, std::shared_ptr<PersistentBufferMap> store);
+
+    static std::shared_ptr<StateIndexer> create(
+        IpldPtr ipld,
+        std::shared_ptr<PersistentBufferMap> store,
+        HeadChangeDispatcher &head_changes,
+        boost::asio::executor executor);
+
+    outcome::result<void> onHeadChange(const HeadChange &change);
+
+    /// @return messages from or to address, as written in message, by epoch
+    outcome::result<std::vector<MessageEntry>> messages(
+        const Address &address) const;
+
+    /// @return changes of actor with id address, e.g. balance history
+    outcome::result<std::vector<ActorEntry>> actorChanges(
+        const Address &address) const;
+
+   private:
+    /// Index messages and state changes applied by tipset
+    outcome::result<void> apply(const Tipset &tipset);
+
+    /// Remove entries of tipset indexed at height
+    outcome::result<void> revert(ChainEpoch height);
+
+    /// @return true if tipset is indexed at its height
+    outcome::result<bool> isIndexed(const Tipset &tipset) const;
+
+    /// Visit entries with key starting with prefix in key order
+    outcome::result<void> scan(
+        const Buffer &prefix,
+        const std::function<outcome::result<void>(const Buffer &key,
+                                                  const Buffer &value)>
+            &visitor) const;
+
+    IpldPtr ipld_;
+    std::shared_ptr<PersistentBufferMap> store_;
+    ChainStore::connection_t head_sub_;
+  };
+}  // namespace fc::storage::blockchain
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_CHAIN_STATE_INDEXER_HPP
@@ -0,0 +1,74 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/config/storage_profile.hpp"
+
+namespace fc::storage::config {
+  constexpr size_t kMiB = 1 << 20;
+
+  std::string namespaceName(StorageNamespace ns) {
+    switch (ns) {
+      case StorageNamespace::STATE:
+        return "state";
+      case StorageNamespace::CHAIN:
+        return "chain";
+      case StorageNamespace::MARKETS:
+        return "markets";
+      case StorageNamespace::INDEXES:
+        return "indexes";
+    }
+    return "unknown";
+  }
+
+  const LeveldbProfile &StorageProfile::profile(StorageNamespace ns) const {
+    static const LeveldbProfile kDefault;
+    auto it = namespaces.find(ns);
+    return it == namespaces.end() ? kDefault : it->second;
+  }
+
+  StorageProfile defaultStorageProfile() {
+    StorageProfile profile;
+    profile.namespaces[StorageNamespace::STATE] = {
+        256 * kMiB, 10, 64 * kMiB, 8 * kMiB};
+    profile.namespaces[StorageNamespace::CHAIN] = {
+        64 * kMiB, 10, 16 * kMiB, 4 * kMiB};
+    profile.namespaces[StorageNamespace::MARKETS] = {
+        8 * kMiB, 10, 4 * kMiB, 2 * kMiB};
+    profile.namespaces[StorageNamespace::INDEXES] = {
+        32 * kMiB, 10, 8 * kMiB, 2 * kMiB};
+    return profile;
+  }
+
+  StorageProfile loadStorageProfile(Config &config) {
+    auto profile = defaultStorageProfile();
+    if (auto backend = config.get<std::string>("storage.backend")) {
+      if (backend.value() == "rocksdb") {
+        profile.backend = StorageBackend::ROCKSDB;
+      }
+    }
+    if (auto jobs = config.get<int>("storage.background_jobs")) {
+      profile.background_jobs = jobs.value();
+    }
+    if (auto direct_io = config.get<bool>("storage.direct_io")) {
+      profile.direct_io = direct_io.value();
+    }
+    for (auto ns : kStorageNamespaces) {
+      auto &leveldb = profile.namespaces[ns];
+      auto prefix = "storage." + namespaceName(ns) + ".";
+      auto load = [&](auto name, auto &field) {
+        using T = std::remove_reference_t<decltype(field)>;
+        if (auto value = config.get<T>(prefix + name)) {
+          field = value.value();
+        }
+      };
+      load("block_cache_bytes", leveldb.block_cache_bytes);
+      load("bloom_bits_per_key", leveldb.bloom_bits_per_key);
+      load("write_buffer_bytes", leveldb.write_buffer_bytes);
+      load("max_file_bytes", leveldb.max_file_bytes);
+      load("compress_blocks", leveldb.compress_blocks);
+    }
+    return profile;
+  }
+}  // namespace fc::storage::config
@@ -0,0 +1,74 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_CONFIG_STORAGE_PROFILE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_CONFIG_STORAGE_PROFILE_HPP
+
+#include <array>
+#include <map>
+
+#include "storage/config/config.hpp"
+
+namespace fc::storage::config {
+  /**
+   * Kinds of stored data, each may be kept in its own LevelDB instance, so
+   * it is tuned and compacted independently
+   */
+  enum class StorageNamespace { STATE, CHAIN, MARKETS, INDEXES };
+
+  constexpr std::array<StorageNamespace, 4> kStorageNamespaces{
+      StorageNamespace::STATE,
+      StorageNamespace::CHAIN,
+      StorageNamespace::MARKETS,
+      StorageNamespace::INDEXES};
+
+  /// Name of namespace, used for its directory and config keys
+  std::string namespaceName(StorageNamespace ns);
+
+  /// Key-value store used by repository
+  enum class StorageBackend { LEVELDB, ROCKSDB };
+
+  /// LevelDB tuning of one instance, RocksDB column family uses same
+  struct LeveldbProfile {
+    /// Cache of uncompressed blocks, zero keeps leveldb default
+    size_t block_cache_bytes{};
+    /// Bits of bloom filter per key, so absent keys are not read from disk,
+    /// zero disables filter
+    int bloom_bits_per_key{10};
+    size_t write_buffer_bytes{4 << 20};
+    size_t max_file_bytes{2 << 20};
+    /// Blocks of namespace go through zstd CompressedDatastore, if built
+    /// with ZSTD option
+    bool compress_blocks{false};
+  };
+
+  /// Storage tuning of namespaces
+  struct StorageProfile {
+    /// Profile of namespace, default one if not set
+    const LeveldbProfile &profile(StorageNamespace ns) const;
+
+    StorageBackend backend{StorageBackend::LEVELDB};
+    std::map<StorageNamespace, LeveldbProfile> namespaces;
+    /// RocksDB threads of flushes and compactions
+    int background_jobs{4};
+    /// RocksDB reads, flushes and compactions bypass page cache
+    bool direct_io{false};
+  };
+
+  /**
+   * Default profile, state and chain get larger caches as they are read
+   * most, with bloom filters everywhere
+   */
+  StorageProfile defaultStorageProfile();
+
+  /**
+   * Default profile with values set in config, keys are
+   * "storage.<namespace>.<field>", e.g. "storage.state.block_cache_bytes",
+   * and "storage.<field>" of others, backend is "leveldb" or "rocksdb"
+   */
+  StorageProfile loadStorageProfile(Config &config);
+}  // namespace fc::storage::config
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_CONFIG_STORAGE_PROFILE_HPP
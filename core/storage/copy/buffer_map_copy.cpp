@@ -0,0 +1,32 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/copy/buffer_map_copy.hpp"
+
+namespace fc::storage {
+
+  outcome::result<uint64_t> copyBufferMap(PersistentBufferMap &from,
+                                          PersistentBufferMap &to,
+                                          size_t batch_size) {
+    uint64_t copied{};
+    size_t pending{};
+    auto batch = to.batch();
+    auto cursor = from.cursor();
+    for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
+      OUTCOME_TRY(batch->put(cursor->key(), cursor->value()));
+      ++copied;
+      if (++pending >= batch_size) {
+        OUTCOME_TRY(batch->commit());
+        batch->clear();
+        pending = 0;
+      }
+    }
+    if (pending != 0) {
+      OUTCOME_TRY(batch->commit());
+    }
+    return copied;
+  }
+
+}  // namespace fc::storage
@@ -0,0 +1,31 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_COPY_BUFFER_MAP_COPY_HPP
+#define CPP_FILECOIN_CORE_STORAGE_COPY_BUFFER_MAP_COPY_HPP
+
+#include "storage/buffer_map.hpp"
+
+namespace fc::storage {
+
+  /// Default number of pairs written by one batch
+  constexpr size_t kCopyBatchSize{4096};
+
+  /**
+   * @brief Copies all pairs of one map to another, e.g. to migrate between
+   * backends. Source is read with cursor and destination is written with
+   * batches, so memory is bounded by batch size.
+   * @param from source map
+   * @param to destination map, existing pairs are overwritten
+   * @param batch_size pairs written by one batch
+   * @return number of copied pairs
+   */
+  outcome::result<uint64_t> copyBufferMap(PersistentBufferMap &from,
+                                          PersistentBufferMap &to,
+                                          size_t batch_size = kCopyBatchSize);
+
+}  // namespace fc::storage
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_COPY_BUFFER_MAP_COPY_HPP
@@ -5,8 +5,11 @@
 
 #include "storage/hamt/hamt.hpp"
 
+#include <algorithm>
+#include <map>
+
 #include "common/which.hpp"
-#include "crypto/murmur/murmur.hpp"
+#include "storage/ipld/encode_level.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::hamt, HamtError, e) {
   using fc::storage::hamt::HamtError;
@@ -28,6 +31,78 @@ namespace fc::storage::hamt {
     return indices.subspan(1);
   }
 
+  namespace {
+    /// Appends indices of hash path, bit_width bits each from high bits
+    template <typename Indices>
+    void hashToIndices(const crypto::murmur::Hash &hash,
+                       size_t bit_width,
+                       Indices &indices) {
+      constexpr auto byte_bits = 8;
+      auto max_bits = byte_bits * hash.size();
+      max_bits -= max_bits % bit_width;
+      for (size_t offset = 0; offset + bit_width <= max_bits;) {
+        size_t index = 0;
+        for (auto i = 0u; i < bit_width; ++i, ++offset) {
+          index <<= 1;
+          index |= 1
+                   & (hash[offset / byte_bits]
+                      >> (byte_bits - 1 - offset % byte_bits));
+        }
+        indices.push_back(index);
+      }
+    }
+
+    /// Item to assign with indices of its key
+    struct Entry {
+      std::vector<size_t> indices;
+      std::string key;
+      Value value;
+    };
+
+    /// Build node of entries sorted by indices, with same indices before
+    /// depth
+    outcome::result<Node::Ptr> buildNode(gsl::span<Entry> entries,
+                                         size_t depth) {
+      auto node = std::make_shared<Node>();
+      while (!entries.empty()) {
+        if (entries[0].indices.size() <= depth) {
+          return HamtError::MAX_DEPTH;
+        }
+        auto index = entries[0].indices[depth];
+        auto size = std::find_if(entries.begin(),
+                                 entries.end(),
+                                 [&](auto &entry) {
+                                   return entry.indices[depth] != index;
+                                 })
+                    - entries.begin();
+        auto group = entries.first(size);
+        if (group.size() <= kLeafMax) {
+          Node::Leaf leaf;
+          for (auto &entry : group) {
+            leaf.emplace(std::move(entry.key), std::move(entry.value));
+          }
+          node->items.emplace_hint(node->items.end(), index, std::move(leaf));
+        } else {
+          OUTCOME_TRY(child, buildNode(group, depth + 1));
+          node->items.emplace_hint(node->items.end(), index, std::move(child));
+        }
+        entries = entries.subspan(size);
+      }
+      return node;
+    }
+
+    /// Items with same cid or same node have same contents
+    bool sameItem(const Node::Item &left, const Node::Item &right) {
+      if (which<CID>(left) && which<CID>(right)) {
+        return boost::get<CID>(left) == boost::get<CID>(right);
+      }
+      if (which<Node::Ptr>(left) && which<Node::Ptr>(right)) {
+        return boost::get<Node::Ptr>(left) == boost::get<Node::Ptr>(right);
+      }
+      return false;
+    }
+  }  // namespace
+
   Hamt::Hamt(std::shared_ptr<ipfs::IpfsDatastore> store, size_t bit_width)
       : ipld{std::move(store)},
         root_{std::make_shared<Node>()},
@@ -43,41 +118,69 @@ namespace fc::storage::hamt {
              size_t bit_width)
       : ipld{std::move(store)}, root_{root}, bit_width_{bit_width} {}
 
+  HamtKey::HamtKey(std::string key)
+      : key_{std::move(key)},
+        hash_{crypto::murmur::hash(common::span::cbytes(key_))} {}
+
+  gsl::span<const size_t> HamtKey::indices(size_t bit_width) const {
+    if (bit_width_ != bit_width) {
+      indices_.clear();
+      hashToIndices(hash_, bit_width, indices_);
+      bit_width_ = bit_width;
+    }
+    return indices_;
+  }
+
   outcome::result<void> Hamt::set(const std::string &key,
                                   gsl::span<const uint8_t> value) {
-    OUTCOME_TRY(loadItem(root_));
-    return set(*boost::get<Node::Ptr>(root_), keyToIndices(key), key, value);
+    return set(HamtKey{key}, value);
+  }
+
+  outcome::result<void> Hamt::set(const HamtKey &key,
+                                  gsl::span<const uint8_t> value) {
+    return update(key, [&](auto) { return Value{value}; });
   }
 
   outcome::result<Value> Hamt::get(const std::string &key) {
-    OUTCOME_TRY(loadItem(root_));
-    auto node = boost::get<Node::Ptr>(root_);
-    for (auto index : keyToIndices(key)) {
+    return get(HamtKey{key});
+  }
+
+  outcome::result<Value> Hamt::get(const HamtKey &key) {
+    OUTCOME_TRY(node, readItem(root_));
+    for (auto index : key.indices(bit_width_)) {
       auto it = node->items.find(index);
       if (it == node->items.end()) {
         return HamtError::NOT_FOUND;
       }
       auto &item = it->second;
-      OUTCOME_TRY(loadItem(item));
-      if (which<Node::Ptr>(item)) {
-        node = boost::get<Node::Ptr>(item);
-      } else {
+      if (which<Node::Leaf>(item)) {
         auto &leaf = boost::get<Node::Leaf>(item);
-        if (leaf.find(key) == leaf.end()) {
+        auto it_leaf = leaf.find(key.key());
+        if (it_leaf == leaf.end()) {
           return HamtError::NOT_FOUND;
         }
-        return leaf[key];
+        return it_leaf->second;
       }
+      OUTCOME_TRYA(node, readItem(item));
     }
     return HamtError::MAX_DEPTH;
   }
 
   outcome::result<void> Hamt::remove(const std::string &key) {
+    return remove(HamtKey{key});
+  }
+
+  outcome::result<void> Hamt::remove(const HamtKey &key) {
     OUTCOME_TRY(loadItem(root_));
-    return remove(*boost::get<Node::Ptr>(root_), keyToIndices(key), key);
+    return remove(
+        *boost::get<Node::Ptr>(root_), key.indices(bit_width_), key.key());
   }
 
   outcome::result<bool> Hamt::contains(const std::string &key) {
+    return contains(HamtKey{key});
+  }
+
+  outcome::result<bool> Hamt::contains(const HamtKey &key) {
     auto res = get(key);
     if (!res) {
       if (res.error() == HamtError::NOT_FOUND) return false;
@@ -86,8 +189,45 @@ namespace fc::storage::hamt {
     return true;
   }
 
+  outcome::result<void> Hamt::update(const HamtKey &key,
+                                     const Updater &updater) {
+    OUTCOME_TRY(loadItem(root_));
+    return update(*boost::get<Node::Ptr>(root_),
+                  key.indices(bit_width_),
+                  key.key(),
+                  updater);
+  }
+
+  outcome::result<void> Hamt::assign(
+      std::vector<std::pair<std::string, Value>> items) {
+    std::vector<Entry> entries;
+    entries.reserve(items.size());
+    for (auto &[key, value] : items) {
+      std::vector<size_t> indices;
+      hashToIndices(crypto::murmur::hash(common::span::cbytes(key)),
+                    bit_width_,
+                    indices);
+      entries.push_back({std::move(indices), std::move(key), std::move(value)});
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](auto &l, auto &r) {
+      return std::tie(l.indices, l.key) < std::tie(r.indices, r.key);
+    });
+    // keep last of equal keys
+    auto last = std::unique(entries.rbegin(),
+                            entries.rend(),
+                            [](auto &l, auto &r) { return l.key == r.key; });
+    entries.erase(entries.begin(), last.base());
+    OUTCOME_TRY(root, buildNode(entries, 0));
+    root_ = std::move(root);
+    return outcome::success();
+  }
+
   outcome::result<CID> Hamt::flush() {
-    OUTCOME_TRY(flush(root_));
+    Ipld::Blocks blocks;
+    OUTCOME_TRY(flush(root_, blocks));
+    if (!blocks.empty()) {
+      OUTCOME_TRY(ipld->setMany(std::move(blocks)));
+    }
     return cid();
   }
 
@@ -95,60 +235,47 @@ namespace fc::storage::hamt {
     return boost::get<CID>(root_);
   }
 
-  std::vector<size_t> Hamt::keyToIndices(const std::string &key, int n) const {
-    std::vector<uint8_t> key_bytes(key.begin(), key.end());
-    auto hash = crypto::murmur::hash(key_bytes);
-    std::vector<size_t> indices;
-    constexpr auto byte_bits = 8;
-    auto max_bits = byte_bits * hash.size();
-    max_bits -= max_bits % bit_width_;
-    auto offset = 0;
-    if (n != -1) {
-      offset = max_bits - (n - 1) * bit_width_;
-    }
-    while (offset + bit_width_ <= max_bits) {
-      size_t index = 0;
-      for (auto i = 0u; i < bit_width_; ++i, ++offset) {
-        index <<= 1;
-        index |= 1
-                 & (hash[offset / byte_bits]
-                    >> (byte_bits - 1 - offset % byte_bits));
-      }
-      indices.push_back(index);
-    }
-    return indices;
-  }
-
-  outcome::result<void> Hamt::set(Node &node,
-                                  gsl::span<const size_t> indices,
-                                  const std::string &key,
-                                  gsl::span<const uint8_t> value) {
+  outcome::result<void> Hamt::update(Node &node,
+                                     gsl::span<const size_t> indices,
+                                     const std::string &key,
+                                     const Updater &updater) {
     if (indices.empty()) {
       return HamtError::MAX_DEPTH;
     }
     auto index = indices[0];
     auto it = node.items.find(index);
     if (it == node.items.end()) {
+      OUTCOME_TRY(value, updater(nullptr));
       Node::Leaf leaf;
-      leaf.emplace(key, std::vector<uint8_t>(value.begin(), value.end()));
-      node.items[index] = leaf;
+      leaf.emplace(key, std::move(value));
+      node.items.emplace(index, std::move(leaf));
       return outcome::success();
     }
     auto &item = it->second;
     OUTCOME_TRY(loadItem(item));
     if (which<Node::Ptr>(item)) {
-      return set(
-          *boost::get<Node::Ptr>(item), consumeIndex(indices), key, value);
+      return update(
+          *boost::get<Node::Ptr>(item), consumeIndex(indices), key, updater);
     }
     auto &leaf = boost::get<Node::Leaf>(item);
-    if (leaf.find(key) != leaf.end() || leaf.size() < kLeafMax) {
-      leaf[key] = Value(value);
+    auto it_leaf = leaf.find(key);
+    if (it_leaf != leaf.end()) {
+      OUTCOME_TRY(value, updater(&it_leaf->second));
+      it_leaf->second = std::move(value);
+    } else if (leaf.size() < kLeafMax) {
+      OUTCOME_TRY(value, updater(nullptr));
+      leaf.emplace(key, std::move(value));
     } else {
       auto child = std::make_shared<Node>();
-      OUTCOME_TRY(set(*child, consumeIndex(indices), key, value));
+      OUTCOME_TRY(update(*child, consumeIndex(indices), key, updater));
       for (auto &pair : leaf) {
-        auto indices2 = keyToIndices(pair.first, indices.size());
-        OUTCOME_TRY(set(*child, indices2, pair.first, pair.second));
+        // child level is after current, so its path is shorter by one
+        HamtKey key2{pair.first};
+        auto indices2 = key2.indices(bit_width_);
+        indices2 = indices2.last(indices.size() - 1);
+        OUTCOME_TRY(update(*child, indices2, pair.first, [&](auto) {
+          return std::move(pair.second);
+        }));
       }
       item = child;
     }
@@ -211,39 +338,217 @@ namespace fc::storage::hamt {
     return outcome::success();
   }
 
-  outcome::result<void> Hamt::flush(Node::Item &item) {
+  outcome::result<void> Hamt::flush(Node::Item &item, Ipld::Blocks &blocks) {
     if (which<Node::Ptr>(item)) {
-      auto &node = *boost::get<Node::Ptr>(item);
-      for (auto &item2 : node.items) {
-        OUTCOME_TRY(flush(item2.second));
+      OUTCOME_TRY(flush(std::vector<Node::Item *>{&item}, blocks));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> Hamt::flush(const std::vector<Node::Item *> &items,
+                                    Ipld::Blocks &blocks) {
+    // next level is flushed first, so nodes of one level are hashed at once
+    std::vector<Node::Item *> children;
+    for (auto item : items) {
+      for (auto &item2 : boost::get<Node::Ptr>(*item)->items) {
+        if (which<Node::Ptr>(item2.second)) {
+          children.push_back(&item2.second);
+        }
       }
-      OUTCOME_TRY(cid, ipld->setCbor(node));
-      item = cid;
+    }
+    if (!children.empty()) {
+      OUTCOME_TRY(flush(children, blocks));
+    }
+    std::vector<Node *> nodes;
+    nodes.reserve(items.size());
+    for (auto item : items) {
+      nodes.push_back(boost::get<Node::Ptr>(*item).get());
+    }
+    OUTCOME_TRY(level, ipld::encodeLevel(nodes));
+    auto &[encoded, cids] = level;
+    for (size_t i = 0; i < items.size(); ++i) {
+      auto &item = *items[i];
+      auto &cid = cids[i];
+      blocks.emplace_back(cid, std::move(encoded[i]));
+      // node may still be shared with copies of this hamt
+      auto &ptr = boost::get<Node::Ptr>(item);
+      nodeCache().put(cid,
+                      ptr.use_count() == 1
+                          ? std::make_shared<const Node>(std::move(*ptr))
+                          : std::make_shared<const Node>(*ptr));
+      item = std::move(cid);
     }
     return outcome::success();
   }
 
+  ipld::NodeCache<Node> &Hamt::nodeCache() {
+    static ipld::NodeCache<Node> cache{kNodeCacheCapacity};
+    return cache;
+  }
+
   outcome::result<void> Hamt::loadItem(Node::Item &item) const {
     if (which<CID>(item)) {
-      OUTCOME_TRY(child, ipld->getCbor<Node>(boost::get<CID>(item)));
-      item = std::make_shared<Node>(std::move(child));
+      OUTCOME_TRY(node, readItem(item));
+      item = std::make_shared<Node>(*node);
     }
     return outcome::success();
   }
 
+  outcome::result<Node::ConstPtr> Hamt::readItem(const Node::Item &item) const {
+    if (which<Node::Ptr>(item)) {
+      return Node::ConstPtr{boost::get<Node::Ptr>(item)};
+    }
+    auto &cid = boost::get<CID>(item);
+    if (auto cached = nodeCache().get(cid)) {
+      return cached;
+    }
+    OUTCOME_TRY(node, ipld->getCbor<Node>(cid));
+    auto shared = std::make_shared<const Node>(std::move(node));
+    nodeCache().put(cid, shared);
+    return shared;
+  }
+
   outcome::result<void> Hamt::visit(const Visitor &visitor) {
-    return visit(root_, visitor);
+    OUTCOME_TRY(visitWhile(
+        [&](auto &key, auto &value) -> outcome::result<bool> {
+          OUTCOME_TRY(visitor(key, value));
+          return true;
+        }));
+    return outcome::success();
   }
 
-  outcome::result<void> Hamt::visit(Node::Item &item, const Visitor &visitor) {
-    OUTCOME_TRY(loadItem(item));
-    if (which<Node::Ptr>(item)) {
-      for (auto &item2 : boost::get<Node::Ptr>(item)->items) {
-        OUTCOME_TRY(visit(item2.second, visitor));
+  outcome::result<bool> Hamt::visitWhile(
+      const WhileVisitor &visitor, const boost::optional<std::string> &after) {
+    if (!after) {
+      return visitWhile(root_, {}, nullptr, visitor);
+    }
+    HamtKey key{*after};
+    return visitWhile(root_, key.indices(bit_width_), &*after, visitor);
+  }
+
+  outcome::result<bool> Hamt::visitWhile(const Node::Item &item,
+                                         gsl::span<const size_t> indices,
+                                         const std::string *after,
+                                         const WhileVisitor &visitor) const {
+    if (which<Node::Leaf>(item)) {
+      auto &leaf = boost::get<Node::Leaf>(item);
+      for (auto it = after ? leaf.upper_bound(*after) : leaf.begin();
+           it != leaf.end();
+           ++it) {
+        OUTCOME_TRY(more, visitor(it->first, it->second));
+        if (!more) {
+          return false;
+        }
       }
-    } else {
-      for (auto &pair : boost::get<Node::Leaf>(item)) {
-        OUTCOME_TRY(visitor(pair.first, pair.second));
+      return true;
+    }
+    OUTCOME_TRY(node, readItem(item));
+    auto it = node->items.begin();
+    if (after && !indices.empty()) {
+      // skip items before path of key, resume inside item on path
+      it = node->items.lower_bound(indices[0]);
+      if (it != node->items.end() && it->first == indices[0]) {
+        OUTCOME_TRY(
+            more,
+            visitWhile(it->second, consumeIndex(indices), after, visitor));
+        if (!more) {
+          return false;
+        }
+        ++it;
+      }
+    }
+    for (; it != node->items.end(); ++it) {
+      OUTCOME_TRY(more, visitWhile(it->second, {}, nullptr, visitor));
+      if (!more) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  outcome::result<void> Hamt::visitParallel(const Visitor &visitor,
+                                            bool ordered,
+                                            size_t threads) const {
+    OUTCOME_TRY(root, readItem(root_));
+    std::vector<const Node::Item *> items;
+    for (auto &item : root->items) {
+      items.push_back(&item.second);
+    }
+    return ipld::visitParallel<std::string, Value>(
+        items.size(),
+        threads,
+        ordered,
+        [&](size_t i, auto &on_pair) {
+          return visitWhile(*items[i], {}, nullptr, on_pair);
+        },
+        visitor);
+  }
+
+  outcome::result<void> Hamt::diff(const Hamt &before,
+                                   const DiffVisitor &visitor) const {
+    return diff(before, &before.root_, &root_, visitor);
+  }
+
+  outcome::result<void> Hamt::diff(const Hamt &before,
+                                   const Node::Item *before_item,
+                                   const Node::Item *item,
+                                   const DiffVisitor &visitor) const {
+    if (before_item && item && sameItem(*before_item, *item)) {
+      return outcome::success();
+    }
+    if (before_item && item && !which<Node::Leaf>(*before_item)
+        && !which<Node::Leaf>(*item)) {
+      OUTCOME_TRY(before_node, before.readItem(*before_item));
+      OUTCOME_TRY(node, readItem(*item));
+      auto &before_items = before_node->items;
+      auto &items = node->items;
+      auto it_before = before_items.begin();
+      auto it = items.begin();
+      while (it_before != before_items.end() || it != items.end()) {
+        if (it == items.end()
+            || (it_before != before_items.end()
+                && it_before->first < it->first)) {
+          OUTCOME_TRY(diff(before, &it_before->second, nullptr, visitor));
+          ++it_before;
+        } else if (it_before == before_items.end()
+                   || it->first < it_before->first) {
+          OUTCOME_TRY(diff(before, nullptr, &it->second, visitor));
+          ++it;
+        } else {
+          OUTCOME_TRY(diff(before, &it_before->second, &it->second, visitor));
+          ++it_before;
+          ++it;
+        }
+      }
+      return outcome::success();
+    }
+
+    // leaf holds few pairs, so other side holds few pairs more than change
+    std::map<std::string, Value> before_pairs, pairs;
+    auto collect = [](auto &out) {
+      return [&out](auto &key, auto &value) -> outcome::result<bool> {
+        out.emplace(key, value);
+        return true;
+      };
+    };
+    if (before_item) {
+      OUTCOME_TRY(
+          before.visitWhile(*before_item, {}, nullptr, collect(before_pairs)));
+    }
+    if (item) {
+      OUTCOME_TRY(visitWhile(*item, {}, nullptr, collect(pairs)));
+    }
+    for (auto &[key, value] : before_pairs) {
+      auto it = pairs.find(key);
+      if (it == pairs.end()) {
+        OUTCOME_TRY(visitor(key, &value, nullptr));
+      } else if (it->second != value) {
+        OUTCOME_TRY(visitor(key, &value, &it->second));
+      }
+    }
+    for (auto &[key, value] : pairs) {
+      if (before_pairs.count(key) == 0) {
+        OUTCOME_TRY(visitor(key, nullptr, &value));
       }
     }
     return outcome::success();
@@ -9,7 +9,10 @@
 #include <string>
 #include <vector>
 
+#include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
+#include <boost/optional.hpp>
 #include <boost/variant.hpp>
 
 #include "codec/cbor/cbor.hpp"
@@ -17,8 +20,11 @@
 #include "common/outcome.hpp"
 #include "common/span.hpp"
 #include "common/visitor.hpp"
+#include "crypto/murmur/murmur.hpp"
 #include "primitives/cid/cid.hpp"
 #include "storage/ipfs/datastore.hpp"
+#include "storage/ipld/node_cache.hpp"
+#include "storage/ipld/visit_parallel.hpp"
 
 namespace fc::storage::hamt {
   enum class HamtError { EXPECTED_CID = 1, NOT_FOUND, MAX_DEPTH };
@@ -33,6 +39,8 @@ namespace fc::storage::hamt {
 
   constexpr size_t kLeafMax = 3;
   constexpr size_t kDefaultBitWidth = 5;
+  /// Max number of decoded nodes kept by process-wide cache
+  constexpr size_t kNodeCacheCapacity = 4096;
 
   struct Bits : cpp_int {};
 
@@ -45,8 +53,7 @@ namespace fc::storage::hamt {
   }
 
   CBOR_DECODE(Bits, bits) {
-    std::vector<uint8_t> bytes;
-    s >> bytes;
+    auto bytes = s.bytesView();
     if (bytes.empty()) {
       bits = {0};
     } else {
@@ -55,13 +62,24 @@ namespace fc::storage::hamt {
     return s;
   }
 
-  /** Hamt node representation */
+  /**
+   * Hamt node representation.
+   * Items are kept in contiguous arrays sorted by index (key for leaf), so
+   * iteration order and CBOR encoding match ordered maps.
+   */
   struct Node {
     using Ptr = std::shared_ptr<Node>;
-    using Leaf = std::map<std::string, Value>;
+    using ConstPtr = std::shared_ptr<const Node>;
+    using Leaf = boost::container::flat_map<
+        std::string,
+        Value,
+        std::less<std::string>,
+        boost::container::small_vector<std::pair<std::string, Value>,
+                                       kLeafMax>>;
     using Item = boost::variant<CID, Ptr, Leaf>;
+    using Items = boost::container::flat_map<size_t, Item>;
 
-    std::map<size_t, Item> items;
+    Items items;
   };
 
   CBOR_ENCODE(Node, node) {
@@ -95,6 +113,7 @@ namespace fc::storage::hamt {
     l_node >> bits;
     auto n_items = l_node.listLength();
     auto l_items = l_node.list();
+    node.items.reserve(n_items);
     size_t j = 0;
     for (size_t i = 0; i < n_items; ++i) {
       while (!bit_test(bits, j)) {
@@ -104,25 +123,49 @@ namespace fc::storage::hamt {
       if (m_item.find("0") != m_item.end()) {
         CID cid;
         m_item.at("0") >> cid;
-        node.items[j] = std::move(cid);
+        node.items.emplace_hint(node.items.end(), j, std::move(cid));
       } else {
         auto s_leaf = m_item.at("1");
         auto n_leaf = s_leaf.listLength();
         auto l_leaf = s_leaf.list();
         Node::Leaf leaf;
+        leaf.reserve(n_leaf);
         for (size_t j = 0; j < n_leaf; ++j) {
           auto l_pair = l_leaf.list();
-          Buffer key;
-          l_pair >> key;
-          leaf.emplace(std::string{key.begin(), key.end()}, l_pair.raw());
+          auto key = l_pair.bytesView();
+          leaf.emplace(std::string{key.begin(), key.end()},
+                       Value{l_pair.rawView()});
         }
-        node.items[j] = std::move(leaf);
+        node.items.emplace_hint(node.items.end(), j, std::move(leaf));
       }
       ++j;
     }
     return s;
   }
 
+  /**
+   * Key with its hash computed once, so operations repeated with same key,
+   * e.g. get and set of read-modify-write, do not hash it again.
+   * Indices of key path are computed on first use.
+   */
+  class HamtKey {
+   public:
+    HamtKey(std::string key);
+
+    const std::string &key() const {
+      return key_;
+    }
+
+    /// Indices of key path in hamt of bit width
+    gsl::span<const size_t> indices(size_t bit_width) const;
+
+   private:
+    std::string key_;
+    crypto::murmur::Hash hash_;
+    mutable size_t bit_width_{};
+    mutable boost::container::small_vector<size_t, 16> indices_;
+  };
+
   /**
    * Hamt map
    * https://github.com/ipld/specs/blob/c1b0d3f4dc26850071d0e4d67854408e970ed29c/data-structures/hashmap.md
@@ -131,6 +174,14 @@ namespace fc::storage::hamt {
    public:
     using Visitor = std::function<outcome::result<void>(const std::string &,
                                                         const Value &)>;
+    /// Visitor returning false to stop
+    using WhileVisitor = std::function<outcome::result<bool>(
+        const std::string &, const Value &)>;
+    /// Called with changed key and its values before and after, null if absent
+    using DiffVisitor = std::function<outcome::result<void>(
+        const std::string &, const Value *, const Value *)>;
+    /// Called with current value, null if absent, returns value to set
+    using Updater = std::function<outcome::result<Value>(const Value *)>;
 
     Hamt(std::shared_ptr<ipfs::IpfsDatastore> store,
          size_t bit_width = kDefaultBitWidth);
@@ -143,20 +194,39 @@ namespace fc::storage::hamt {
     /** Set value by key, does not write to storage */
     outcome::result<void> set(const std::string &key,
                               gsl::span<const uint8_t> value);
+    outcome::result<void> set(const HamtKey &key,
+                              gsl::span<const uint8_t> value);
 
     /** Get value by key */
     outcome::result<Value> get(const std::string &key);
+    outcome::result<Value> get(const HamtKey &key);
 
     /**
      * Remove value by key, does not write to storage.
      * Returns NOT_FOUND if element doesn't exist.
      */
     outcome::result<void> remove(const std::string &key);
+    outcome::result<void> remove(const HamtKey &key);
 
     /**
      * Checks if key is present
      */
     outcome::result<bool> contains(const std::string &key);
+    outcome::result<bool> contains(const HamtKey &key);
+
+    /**
+     * Set value computed from current one, walking path of key once,
+     * does not write to storage. Hamt is unchanged if updater fails.
+     */
+    outcome::result<void> update(const HamtKey &key, const Updater &updater);
+
+    /**
+     * Replace contents with items, building nodes bottom-up instead of
+     * walking from root for each item, does not write to storage.
+     * Later item wins if keys repeat.
+     */
+    outcome::result<void> assign(
+        std::vector<std::pair<std::string, Value>> items);
 
     /**
      * Write changes made by set and remove to storage
@@ -170,23 +240,52 @@ namespace fc::storage::hamt {
     /** Apply visitor for key value pairs */
     outcome::result<void> visit(const Visitor &visitor);
 
+    /**
+     * Apply visitor for key value pairs until it returns false.
+     * Pairs are visited in hash order, which is same for same root.
+     * @param after - key to resume after, e.g. last key of previous page
+     * @return false if visitor stopped
+     */
+    outcome::result<bool> visitWhile(
+        const WhileVisitor &visitor,
+        const boost::optional<std::string> &after = boost::none);
+
+    /**
+     * Read-only visit for scans, subtrees of root are read and visited by
+     * up to threads concurrently. Hamt must not be modified meanwhile.
+     * @param visitor - called concurrently, unless ordered
+     * @param ordered - call visitor on calling thread in hash order, as
+     * visit does, pairs are collected in memory first
+     */
+    outcome::result<void> visitParallel(
+        const Visitor &visitor,
+        bool ordered = false,
+        size_t threads = ipld::kVisitThreads) const;
+
+    /**
+     * Visit keys added, removed or changed since before, skipping subtrees
+     * with same cid, so cost depends on size of change
+     */
+    outcome::result<void> diff(const Hamt &before,
+                               const DiffVisitor &visitor) const;
+
     /// Store CBOR encoded value by key
     template <typename T>
-    outcome::result<void> setCbor(const std::string &key, const T &value) {
+    outcome::result<void> setCbor(const HamtKey &key, const T &value) {
       OUTCOME_TRY(bytes, Ipld::encode(value));
       return set(key, bytes);
     }
 
     /// Get CBOR decoded value by key
     template <typename T>
-    outcome::result<T> getCbor(const std::string &key) {
+    outcome::result<T> getCbor(const HamtKey &key) {
       OUTCOME_TRY(bytes, get(key));
       return ipld->decode<T>(bytes);
     }
 
     /// Get CBOR decoded value by key
     template <typename T>
-    outcome::result<boost::optional<T>> tryGetCbor(const std::string &key) {
+    outcome::result<boost::optional<T>> tryGetCbor(const HamtKey &key) {
       auto maybe = get(key);
       if (!maybe) {
         if (maybe.error() != HamtError::NOT_FOUND) {
@@ -198,21 +297,42 @@ namespace fc::storage::hamt {
       return std::move(value);
     }
 
+    /**
+     * Process-wide cache of decoded nodes shared by all hamts.
+     * Read operations use cached nodes as is, mutations copy them.
+     */
+    static ipld::NodeCache<Node> &nodeCache();
+
     IpldPtr ipld;
 
    private:
-    std::vector<size_t> keyToIndices(const std::string &key, int n = -1) const;
-    outcome::result<void> set(Node &node,
-                              gsl::span<const size_t> indices,
-                              const std::string &key,
-                              gsl::span<const uint8_t> value);
+    outcome::result<void> update(Node &node,
+                                 gsl::span<const size_t> indices,
+                                 const std::string &key,
+                                 const Updater &updater);
     outcome::result<void> remove(Node &node,
                                  gsl::span<const size_t> indices,
                                  const std::string &key);
     static outcome::result<void> cleanShard(Node::Item &item);
-    outcome::result<void> flush(Node::Item &item);
+    outcome::result<void> flush(Node::Item &item, Ipld::Blocks &blocks);
+    /// Flush node items of one level, hashing their blocks at once
+    outcome::result<void> flush(const std::vector<Node::Item *> &items,
+                                Ipld::Blocks &blocks);
+    /// Replace CID item with mutable copy of node
     outcome::result<void> loadItem(Node::Item &item) const;
-    outcome::result<void> visit(Node::Item &item, const Visitor &visitor);
+    /// Get node of CID or node item for reading
+    outcome::result<Node::ConstPtr> readItem(const Node::Item &item) const;
+    /// @param after - key to resume after if not null, its remaining indices
+    outcome::result<bool> visitWhile(const Node::Item &item,
+                                     gsl::span<const size_t> indices,
+                                     const std::string *after,
+                                     const WhileVisitor &visitor) const;
+
+    /// @param before_item, item - null if absent
+    outcome::result<void> diff(const Hamt &before,
+                               const Node::Item *before_item,
+                               const Node::Item *item,
+                               const DiffVisitor &visitor) const;
 
     Node::Item root_;
     size_t bit_width_;
@@ -0,0 +1,163 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/in_memory/concurrent_storage.hpp"
+
+#include <algorithm>
+#include <map>
+
+#include <boost/optional.hpp>
+
+namespace fc::storage {
+  namespace {
+    /// Cursor over snapshot sorted by key
+    class SnapshotCursor : public BufferMapCursor {
+     public:
+      explicit SnapshotCursor(ConcurrentStorage::Map::Snapshot entries)
+          : entries_{std::move(entries)}, i_{entries_.size()} {
+        std::sort(entries_.begin(),
+                  entries_.end(),
+                  [](auto &l, auto &r) { return l.first < r.first; });
+      }
+
+      void seekToFirst() override {
+        i_ = 0;
+      }
+
+      void seek(const Buffer &key) override {
+        i_ = std::lower_bound(
+                 entries_.begin(),
+                 entries_.end(),
+                 key,
+                 [](auto &entry, auto &key) { return entry.first < key; })
+             - entries_.begin();
+      }
+
+      void seekToLast() override {
+        i_ = entries_.empty() ? 0 : entries_.size() - 1;
+      }
+
+      bool isValid() const override {
+        return i_ < entries_.size();
+      }
+
+      void next() override {
+        ++i_;
+      }
+
+      void prev() override {
+        i_ = i_ == 0 ? entries_.size() : i_ - 1;
+      }
+
+      Buffer key() const override {
+        return entries_[i_].first;
+      }
+
+      Buffer value() const override {
+        return *entries_[i_].second;
+      }
+
+     private:
+      ConcurrentStorage::Map::Snapshot entries_;
+      size_t i_;
+    };
+
+    class ConcurrentBatch : public BufferBatch {
+     public:
+      explicit ConcurrentBatch(ConcurrentStorage &db) : db_{db} {}
+
+      outcome::result<void> put(const Buffer &key,
+                                const Buffer &value) override {
+        writes_[key] = value;
+        return outcome::success();
+      }
+
+      outcome::result<void> put(const Buffer &key, Buffer &&value) override {
+        writes_[key] = std::move(value);
+        return outcome::success();
+      }
+
+      outcome::result<void> remove(const Buffer &key) override {
+        writes_[key] = boost::none;
+        return outcome::success();
+      }
+
+      outcome::result<void> commit() override {
+        for (auto &[key, value] : writes_) {
+          if (value) {
+            OUTCOME_TRY(db_.put(key, *value));
+          } else {
+            OUTCOME_TRY(db_.remove(key));
+          }
+        }
+        return outcome::success();
+      }
+
+      void clear() override {
+        writes_.clear();
+      }
+
+     private:
+      ConcurrentStorage &db_;
+      std::map<Buffer, boost::optional<Buffer>> writes_;
+    };
+  }  // namespace
+
+  ConcurrentStorage::ConcurrentStorage(size_t max_bytes) : map_{max_bytes} {}
+
+  outcome::result<Buffer> ConcurrentStorage::get(const Buffer &key) const {
+    if (auto value{map_.get(key)}) {
+      return *value;
+    }
+    return ConcurrentStorageError::NOT_FOUND;
+  }
+
+  outcome::result<void> ConcurrentStorage::put(const Buffer &key,
+                                               const Buffer &value) {
+    return put(key, Buffer{value});
+  }
+
+  outcome::result<void> ConcurrentStorage::put(const Buffer &key,
+                                               Buffer &&value) {
+    auto bytes{key.size() + value.size()};
+    if (!map_.put(key, std::move(value), bytes)) {
+      return ConcurrentStorageError::MEMORY_CAP_EXCEEDED;
+    }
+    return outcome::success();
+  }
+
+  bool ConcurrentStorage::contains(const Buffer &key) const {
+    return map_.contains(key);
+  }
+
+  outcome::result<void> ConcurrentStorage::remove(const Buffer &key) {
+    map_.remove(key);
+    return outcome::success();
+  }
+
+  std::unique_ptr<BufferBatch> ConcurrentStorage::batch() {
+    return std::make_unique<ConcurrentBatch>(*this);
+  }
+
+  std::unique_ptr<BufferMapCursor> ConcurrentStorage::cursor() {
+    return std::make_unique<SnapshotCursor>(map_.snapshot());
+  }
+
+  size_t ConcurrentStorage::bytes() const {
+    return map_.bytes();
+  }
+
+}  // namespace fc::storage
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage, ConcurrentStorageError, e) {
+  using E = fc::storage::ConcurrentStorageError;
+  switch (e) {
+    case E::NOT_FOUND:
+      return "ConcurrentStorageError: not found";
+    case E::MEMORY_CAP_EXCEEDED:
+      return "ConcurrentStorageError: memory cap exceeded";
+  }
+  return "ConcurrentStorageError: unknown error";
+}
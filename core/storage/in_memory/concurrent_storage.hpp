@@ -0,0 +1,61 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IN_MEMORY_CONCURRENT_STORAGE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IN_MEMORY_CONCURRENT_STORAGE_HPP
+
+#include "storage/buffer_map.hpp"
+#include "storage/in_memory/sharded_map.hpp"
+
+namespace fc::storage {
+
+  enum class ConcurrentStorageError {
+    NOT_FOUND = 1,
+    MEMORY_CAP_EXCEEDED,
+  };
+
+  /**
+   * @class ConcurrentStorage in-memory PersistentMap which may be shared by
+   * threads without global lock, e.g. by parallel interpreters of devnet.
+   * Cursor iterates sorted snapshot taken when it is created, so writes
+   * don't invalidate it.
+   */
+  class ConcurrentStorage : public PersistentBufferMap {
+   public:
+    using Map = ShardedMap<Buffer, Buffer>;
+
+    /// @param max_bytes cap of total size of keys and values, zero is
+    /// unlimited
+    explicit ConcurrentStorage(size_t max_bytes = 0);
+
+    ~ConcurrentStorage() override = default;
+
+    outcome::result<Buffer> get(const Buffer &key) const override;
+
+    outcome::result<void> put(const Buffer &key, const Buffer &value) override;
+
+    outcome::result<void> put(const Buffer &key, Buffer &&value) override;
+
+    bool contains(const Buffer &key) const override;
+
+    outcome::result<void> remove(const Buffer &key) override;
+
+    /// Batch applies writes one by one on commit, readers may see part
+    std::unique_ptr<BufferBatch> batch() override;
+
+    std::unique_ptr<BufferMapCursor> cursor() override;
+
+    /// Total size of keys and values
+    size_t bytes() const;
+
+   private:
+    Map map_;
+  };
+
+}  // namespace fc::storage
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage, ConcurrentStorageError);
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IN_MEMORY_CONCURRENT_STORAGE_HPP
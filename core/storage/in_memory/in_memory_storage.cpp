@@ -10,6 +10,50 @@
 using fc::common::Buffer;
 
 namespace fc::storage {
+  namespace {
+    /// Cursor over hex keys, which sort same as bytes they encode
+    class InMemoryCursor : public face::MapCursor<Buffer, Buffer> {
+     public:
+      explicit InMemoryCursor(const std::map<std::string, Buffer> &storage)
+          : storage_{storage}, it_{storage.end()} {}
+
+      void seekToFirst() override {
+        it_ = storage_.begin();
+      }
+
+      void seek(const Buffer &key) override {
+        it_ = storage_.lower_bound(key.toHex());
+      }
+
+      void seekToLast() override {
+        it_ = storage_.empty() ? storage_.end() : std::prev(storage_.end());
+      }
+
+      bool isValid() const override {
+        return it_ != storage_.end();
+      }
+
+      void next() override {
+        ++it_;
+      }
+
+      void prev() override {
+        it_ = it_ == storage_.begin() ? storage_.end() : std::prev(it_);
+      }
+
+      Buffer key() const override {
+        return Buffer::fromHex(it_->first).value();
+      }
+
+      Buffer value() const override {
+        return it_->second;
+      }
+
+     private:
+      const std::map<std::string, Buffer> &storage_;
+      std::map<std::string, Buffer>::const_iterator it_;
+    };
+  }  // namespace
 
   outcome::result<Buffer> InMemoryStorage::get(const Buffer &key) const {
     if (storage.find(key.toHex()) != storage.end()) {
@@ -46,6 +90,6 @@ namespace fc::storage {
 
   std::unique_ptr<fc::storage::face::MapCursor<Buffer, Buffer>>
   InMemoryStorage::cursor() {
-    return nullptr;
+    return std::make_unique<InMemoryCursor>(storage);
   }
 }
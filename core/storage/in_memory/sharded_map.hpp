@@ -0,0 +1,183 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IN_MEMORY_SHARDED_MAP_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IN_MEMORY_SHARDED_MAP_HPP
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fc::storage {
+
+  /**
+   * @class ShardedMap hash map split into shards with own locks, so threads
+   * touching different keys don't contend. Values are immutable and shared,
+   * so readers and snapshots copy pointers under lock, not values. Total size
+   * of entries may be capped.
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>>
+  class ShardedMap {
+   public:
+    using ValuePtr = std::shared_ptr<const Value>;
+    using Snapshot = std::vector<std::pair<Key, ValuePtr>>;
+
+    static constexpr size_t kShardBits{6};
+    static constexpr size_t kShards{size_t{1} << kShardBits};
+
+    /// @param max_bytes cap of total size of entries, zero is unlimited
+    explicit ShardedMap(size_t max_bytes = 0) : max_bytes_{max_bytes} {}
+
+    bool contains(const Key &key) const {
+      auto &shard{shardOf(key)};
+      std::shared_lock lock{shard.mutex};
+      return shard.map.find(key) != shard.map.end();
+    }
+
+    /// Value of key or null
+    ValuePtr get(const Key &key) const {
+      auto &shard{shardOf(key)};
+      std::shared_lock lock{shard.mutex};
+      auto it{shard.map.find(key)};
+      return it == shard.map.end() ? nullptr : it->second.value;
+    }
+
+    /**
+     * Set value of key
+     * @param bytes size of entry counted against cap
+     * @return false if cap would be exceeded, map is unchanged then
+     */
+    bool put(const Key &key, Value value, size_t bytes) {
+      auto ptr{std::make_shared<const Value>(std::move(value))};
+      auto &shard{shardOf(key)};
+      std::unique_lock lock{shard.mutex};
+      auto &entry{shard.map[key]};
+      // replaced entry is released, so only growth is checked
+      if (!reserve(bytes, entry.bytes)) {
+        if (!entry.value) {
+          shard.map.erase(key);
+        }
+        return false;
+      }
+      if (!entry.value) {
+        ++size_;
+      }
+      entry.value = std::move(ptr);
+      entry.bytes = bytes;
+      return true;
+    }
+
+    /// @return whether key existed
+    bool remove(const Key &key) {
+      auto &shard{shardOf(key)};
+      std::unique_lock lock{shard.mutex};
+      auto it{shard.map.find(key)};
+      if (it == shard.map.end()) {
+        return false;
+      }
+      bytes_ -= it->second.bytes;
+      --size_;
+      shard.map.erase(it);
+      return true;
+    }
+
+    void clear() {
+      for (auto &shard : shards_) {
+        std::unique_lock lock{shard.mutex};
+        for (auto &[key, entry] : shard.map) {
+          bytes_ -= entry.bytes;
+        }
+        size_ -= shard.map.size();
+        shard.map.clear();
+      }
+    }
+
+    /**
+     * Consistent copy of all entries, in no particular order. All shards are
+     * locked for reading at once while pointers are copied, writers wait.
+     */
+    Snapshot snapshot() const {
+      std::vector<std::shared_lock<std::shared_mutex>> locks;
+      locks.reserve(kShards);
+      size_t count{};
+      for (auto &shard : shards_) {
+        locks.emplace_back(shard.mutex);
+        count += shard.map.size();
+      }
+      Snapshot entries;
+      entries.reserve(count);
+      for (auto &shard : shards_) {
+        for (auto &[key, entry] : shard.map) {
+          entries.emplace_back(key, entry.value);
+        }
+      }
+      return entries;
+    }
+
+    /// Number of entries
+    size_t size() const {
+      return size_;
+    }
+
+    /// Total size of entries
+    size_t bytes() const {
+      return bytes_;
+    }
+
+    size_t maxBytes() const {
+      return max_bytes_;
+    }
+
+   private:
+    struct Entry {
+      ValuePtr value;
+      size_t bytes{};
+    };
+
+    struct Shard {
+      mutable std::shared_mutex mutex;
+      std::unordered_map<Key, Entry, Hash> map;
+    };
+
+    const Shard &shardOf(const Key &key) const {
+      // fibonacci hashing takes high bits, so shard doesn't correlate with
+      // bucket inside shard
+      auto mixed{static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull};
+      return shards_[mixed >> (64 - kShardBits)];
+    }
+
+    Shard &shardOf(const Key &key) {
+      return const_cast<Shard &>(std::as_const(*this).shardOf(key));
+    }
+
+    /// Account growth from old to new size, fails if over cap
+    bool reserve(size_t bytes, size_t old_bytes) {
+      if (bytes <= old_bytes) {
+        bytes_ -= old_bytes - bytes;
+        return true;
+      }
+      auto growth{bytes - old_bytes};
+      auto current{bytes_.load()};
+      do {
+        if (max_bytes_ != 0 && current + growth > max_bytes_) {
+          return false;
+        }
+      } while (!bytes_.compare_exchange_weak(current, current + growth));
+      return true;
+    }
+
+    size_t max_bytes_;
+    std::atomic<size_t> size_{};
+    std::atomic<size_t> bytes_{};
+    std::array<Shard, kShards> shards_;
+  };
+
+}  // namespace fc::storage
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IN_MEMORY_SHARDED_MAP_HPP
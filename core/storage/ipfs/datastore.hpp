@@ -20,6 +20,7 @@ namespace fc::storage::ipfs {
   class IpfsDatastore {
    public:
     using Value = common::Buffer;
+    using Blocks = std::vector<std::pair<CID, Value>>;
 
     virtual ~IpfsDatastore() = default;
 
@@ -45,6 +46,36 @@ namespace fc::storage::ipfs {
      */
     virtual outcome::result<Value> get(const CID &key) const = 0;
 
+    /**
+     * @brief associates keys with values in data store, implementations may
+     * write all of them at once
+     * @param blocks key value pairs to store
+     * @return success if operation succeeded, error otherwise
+     */
+    virtual outcome::result<void> setMany(Blocks blocks) {
+      for (auto &block : blocks) {
+        OUTCOME_TRY(set(block.first, std::move(block.second)));
+      }
+      return outcome::success();
+    }
+
+    /**
+     * @brief searches for keys in data store
+     * @param keys keys to find
+     * @return values associated with keys in same order, or error if any key
+     * is missing
+     */
+    virtual outcome::result<std::vector<Value>> getMany(
+        gsl::span<const CID> keys) const {
+      std::vector<Value> values;
+      values.reserve(keys.size());
+      for (auto &key : keys) {
+        OUTCOME_TRY(value, get(key));
+        values.push_back(std::move(value));
+      }
+      return std::move(values);
+    }
+
     /**
      * @brief removes key from data store
      * @param key key to remove
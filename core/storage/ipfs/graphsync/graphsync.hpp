@@ -17,6 +17,10 @@
 #include "common/outcome.hpp"
 #include "storage/ipfs/graphsync/extension.hpp"
 
+namespace fc::storage::ipfs {
+  class AsyncDatastore;
+}  // namespace fc::storage::ipfs
+
 namespace fc::storage::ipfs::merkledag {
   class MerkleDagService;
 }
@@ -34,6 +38,14 @@ namespace fc::storage::ipfs::graphsync {
     static std::shared_ptr<MerkleDagBridge> create(
         std::shared_ptr<merkledag::MerkleDagService> service);
 
+    /// Creates a bridge which loads blocks asynchronously
+    /// \param service Existing MerkleDAG service
+    /// \param async Datastore of service blocks with I/O pool
+    /// \return Bridge object
+    static std::shared_ptr<MerkleDagBridge> create(
+        std::shared_ptr<merkledag::MerkleDagService> service,
+        std::shared_ptr<AsyncDatastore> async);
+
     virtual ~MerkleDagBridge() = default;
 
     /// Forwards select call to the service or other backend
@@ -47,6 +59,22 @@ namespace fc::storage::ipfs::graphsync {
         gsl::span<const uint8_t> selector,
         std::function<bool(const CID &cid, const common::Buffer &data)> handler)
         const = 0;
+
+    /// Loads data block, used to continue paused responses
+    /// \param cid CID of the block
+    /// \return Data block, raw bytes
+    virtual outcome::result<common::Buffer> getBlock(const CID &cid) const = 0;
+
+    /// Callback of async block load
+    using BlockLoaded = std::function<void(outcome::result<common::Buffer>)>;
+
+    /// Loads data block without blocking event loop if backend supports
+    /// async reads, default one loads it in place
+    /// \param cid CID of the block
+    /// \param callback Called with data block on event loop
+    virtual void getBlockAsync(const CID &cid, BlockLoaded callback) const {
+      callback(getBlock(cid));
+    }
   };
 
   /// Response status codes. Positive values are received from wire,
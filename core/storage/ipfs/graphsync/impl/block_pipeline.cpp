@@ -0,0 +1,180 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "block_pipeline.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_set>
+
+#include <boost/asio/post.hpp>
+
+#include "crypto/hasher/hasher.hpp"
+#include "storage/ipfs/graphsync/impl/common.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  BlockPipeline::BlockPipeline(std::shared_ptr<boost::asio::io_context> io,
+                               IpldPtr ipld,
+                               BlockPipelineConfig config)
+      : io_{std::move(io)},
+        ipld_{std::move(ipld)},
+        config_{config},
+        hash_pool_{std::max<size_t>(config.hash_threads, 1)} {
+    assert(io_);
+    assert(ipld_);
+  }
+
+  BlockPipeline::~BlockPipeline() {
+    hash_pool_.join();
+    writer_.join();
+  }
+
+  void BlockPipeline::push(CID prefix,
+                           common::Buffer data,
+                           Callback callback) {
+    uint64_t seq;
+    {
+      std::lock_guard lock{mutex_};
+      pending_bytes_ += data.size();
+      ++hashing_;
+      seq = next_seq_++;
+      unstored_.insert(seq);
+    }
+    auto item{std::make_shared<Item>(
+        Item{seq, std::move(prefix), std::move(data), std::move(callback)})};
+    boost::asio::post(hash_pool_, [this, item{std::move(item)}] {
+      hash(std::move(*item));
+    });
+  }
+
+  void BlockPipeline::after(Barrier callback) {
+    {
+      std::lock_guard lock{mutex_};
+      if (!unstored_.empty()) {
+        barriers_.push_back(
+            {next_seq_, outcome::success(), std::move(callback)});
+        return;
+      }
+    }
+    boost::asio::post(*io_, [callback{std::move(callback)}] {
+      callback(outcome::success());
+    });
+  }
+
+  bool BlockPipeline::whenDrained(std::function<void()> callback) {
+    std::lock_guard lock{mutex_};
+    if (pending_bytes_ <= config_.max_pending_bytes) {
+      return false;
+    }
+    drained_.push_back(std::move(callback));
+    return true;
+  }
+
+  void BlockPipeline::hash(Item item) {
+    auto &cid = item.cid;
+    cid.content_address =
+        crypto::Hasher::calculate(cid.content_address.getType(), item.data);
+    {
+      // decremented before post, so writer sees idle pipeline on last block
+      std::lock_guard lock{mutex_};
+      --hashing_;
+    }
+    boost::asio::post(writer_,
+                      [this, item{std::make_shared<Item>(std::move(item))}] {
+                        write(std::move(*item));
+                      });
+  }
+
+  void BlockPipeline::write(Item item) {
+    batch_.push_back(std::move(item));
+    bool idle;
+    {
+      std::lock_guard lock{mutex_};
+      idle = hashing_ == 0;
+    }
+    // partial batch is written when no more blocks are coming
+    if (batch_.size() >= config_.batch_size || idle) {
+      flush();
+    }
+  }
+
+  void BlockPipeline::flush() {
+    auto batch{std::make_shared<std::vector<Item>>(std::move(batch_))};
+    batch_.clear();
+
+    IpfsDatastore::Blocks blocks;
+    std::unordered_set<CID> batched;
+    std::vector<uint64_t> seqs;
+    size_t bytes = 0;
+    blocks.reserve(batch->size());
+    seqs.reserve(batch->size());
+    for (auto &item : *batch) {
+      bytes += item.data.size();
+      seqs.push_back(item.seq);
+      if (!batched.insert(item.cid).second) {
+        continue;
+      }
+      auto present{ipld_->contains(item.cid)};
+      if (present && present.value()) {
+        continue;
+      }
+      blocks.emplace_back(item.cid, item.data);
+    }
+    auto stored{ipld_->setMany(std::move(blocks))};
+    if (!stored) {
+      logger()->error("BlockPipeline: cannot store {} blocks, msg='{}'",
+                      batch->size(),
+                      stored.error().message());
+    }
+    boost::asio::post(*io_, [batch, stored] {
+      for (auto &item : *batch) {
+        item.callback(stored, std::move(item.cid), std::move(item.data));
+      }
+    });
+    release(seqs, bytes, stored);
+  }
+
+  void BlockPipeline::release(const std::vector<uint64_t> &seqs,
+                              size_t bytes,
+                              const outcome::result<void> &stored) {
+    std::vector<Waiting> ready;
+    std::vector<std::function<void()>> drained;
+    {
+      std::lock_guard lock{mutex_};
+      for (auto seq : seqs) {
+        unstored_.erase(seq);
+      }
+      if (!stored && !seqs.empty()) {
+        auto first{*std::min_element(seqs.begin(), seqs.end())};
+        for (auto &barrier : barriers_) {
+          if (barrier.seq > first) {
+            barrier.stored = stored.error();
+          }
+        }
+      }
+      while (!barriers_.empty()
+             && (unstored_.empty()
+                 || *unstored_.begin() >= barriers_.front().seq)) {
+        ready.push_back(std::move(barriers_.front()));
+        barriers_.pop_front();
+      }
+      pending_bytes_ -= bytes;
+      if (pending_bytes_ <= config_.max_pending_bytes) {
+        drained.swap(drained_);
+      }
+    }
+    // posted after block callbacks of batch
+    for (auto &barrier : ready) {
+      boost::asio::post(*io_, [barrier{std::move(barrier)}] {
+        barrier.callback(barrier.stored);
+      });
+    }
+    for (auto &callback : drained) {
+      boost::asio::post(*io_, std::move(callback));
+    }
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
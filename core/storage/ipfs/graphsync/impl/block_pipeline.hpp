@@ -0,0 +1,134 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_GRAPHSYNC_BLOCK_PIPELINE_HPP
+#define CPP_FILECOIN_GRAPHSYNC_BLOCK_PIPELINE_HPP
+
+#include <deque>
+#include <mutex>
+#include <set>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  struct BlockPipelineConfig {
+    /// Threads computing block hashes
+    size_t hash_threads{2};
+    /// Blocks written to datastore at once
+    size_t batch_size{64};
+    /// Bytes of blocks in pipeline, stream reads are paused above it
+    size_t max_pending_bytes{64 * 1024 * 1024};
+  };
+
+  /**
+   * Moves hashing and storing of received blocks off the network event
+   * loop. Blocks are hashed by worker threads, written in batches by single
+   * writer thread, and reported back on the event loop after they are
+   * stored. Producer is never blocked, but while pipeline holds too many
+   * bytes, network streams pause reading until it is drained, so memory
+   * stays bounded and reading slows down to pipeline throughput.
+   * Blocks already present in datastore, or twice in batch, e.g. sent by
+   * requests of overlapping subtrees, are reported but not written again,
+   * presence check is answered by datastore filter for absent blocks.
+   */
+  class BlockPipeline {
+   public:
+    /// Called on event loop for each block, with error if it wasn't stored
+    using Callback = std::function<void(
+        outcome::result<void> stored, CID cid, common::Buffer data)>;
+    /// Called on event loop after blocks pushed before it are stored, with
+    /// error if any of them wasn't stored
+    using Barrier = std::function<void(outcome::result<void> stored)>;
+
+    /// \param io event loop for callbacks
+    /// \param ipld datastore to write blocks to, used by writer thread
+    /// \param config pipeline limits
+    BlockPipeline(std::shared_ptr<boost::asio::io_context> io,
+                  IpldPtr ipld,
+                  BlockPipelineConfig config);
+
+    /// Waits for blocks in pipeline
+    ~BlockPipeline();
+
+    /// Enqueues received block
+    /// \param prefix CID prefix of block, its hash is computed from data
+    /// \param data block data
+    /// \param callback called on event loop when block is stored
+    void push(CID prefix, common::Buffer data, Callback callback);
+
+    /// Orders callback after blocks pushed so far, e.g. response after
+    /// blocks of its message
+    /// \param callback called on event loop when these blocks are stored
+    void after(Barrier callback);
+
+    /// Keeps callback if pipeline holds more bytes than limit
+    /// \param callback called on event loop when pipeline drains below limit
+    /// \return false if pipeline is below limit and callback is dropped
+    bool whenDrained(std::function<void()> callback);
+
+   private:
+    /// Block with its callback
+    struct Item {
+      uint64_t seq;
+      CID cid;
+      common::Buffer data;
+      Callback callback;
+    };
+
+    /// Barrier waiting for blocks pushed before it
+    struct Waiting {
+      /// Sequence number of first block pushed after barrier
+      uint64_t seq;
+      outcome::result<void> stored;
+      Barrier callback;
+    };
+
+    /// Computes CID of block on hash thread
+    void hash(Item item);
+
+    /// Adds hashed block to batch on writer thread
+    void write(Item item);
+
+    /// Stores new blocks of batch and posts callbacks
+    void flush();
+
+    /// Releases bytes of written blocks, posts ready barriers and drained
+    /// callbacks
+    void release(const std::vector<uint64_t> &seqs,
+                 size_t bytes,
+                 const outcome::result<void> &stored);
+
+    std::shared_ptr<boost::asio::io_context> io_;
+    IpldPtr ipld_;
+    BlockPipelineConfig config_;
+
+    std::mutex mutex_;
+    /// Bytes of blocks pushed but not stored yet
+    size_t pending_bytes_{};
+    /// Blocks pushed but not hashed yet
+    size_t hashing_{};
+    /// Sequence number of next pushed block
+    uint64_t next_seq_{};
+    /// Sequence numbers of blocks pushed but not stored yet
+    std::set<uint64_t> unstored_;
+    /// Barriers in order of sequence numbers
+    std::deque<Waiting> barriers_;
+    /// Callbacks waiting for pipeline to drain below limit
+    std::vector<std::function<void()>> drained_;
+
+    /// Used by writer thread only
+    std::vector<Item> batch_;
+
+    boost::asio::thread_pool hash_pool_;
+    boost::asio::thread_pool writer_{1};
+  };
+
+}  // namespace fc::storage::ipfs::graphsync
+
+#endif  // CPP_FILECOIN_GRAPHSYNC_BLOCK_PIPELINE_HPP
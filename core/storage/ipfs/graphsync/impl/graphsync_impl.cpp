@@ -7,6 +7,9 @@
 
 #include <cassert>
 
+#include "block_pipeline.hpp"
+#include "common/memory_domain.hpp"
+#include "crypto/hasher/hasher.hpp"
 #include "local_requests.hpp"
 #include "network/network.hpp"
 
@@ -16,14 +19,18 @@ namespace fc::storage::ipfs::graphsync {
 
   GraphsyncImpl::GraphsyncImpl(
       std::shared_ptr<libp2p::Host> host,
-      std::shared_ptr<libp2p::protocol::Scheduler> scheduler)
+      std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+      std::shared_ptr<BlockPipeline> pipeline,
+      std::shared_ptr<NetworkShards> shards)
       : scheduler_(scheduler),
-        network_(std::make_shared<Network>(std::move(host), scheduler)),
+        network_(std::make_shared<Network>(
+            std::move(host), scheduler, std::move(shards))),
         local_requests_(std::make_shared<LocalRequests>(
             std::move(scheduler),
             [this](RequestId request_id, SharedData body) {
               cancelLocalRequest(request_id, std::move(body));
-            })) {}
+            })),
+        pipeline_(std::move(pipeline)) {}
 
   GraphsyncImpl::~GraphsyncImpl() {
     doStop();
@@ -49,6 +56,7 @@ namespace fc::storage::ipfs::graphsync {
       started_ = false;
       block_cb_ = Graphsync::BlockCallback{};
       dag_.reset();
+      paused_responses_.clear();
       network_->stop();
       local_requests_->cancelAll();
     }
@@ -62,8 +70,9 @@ namespace fc::storage::ipfs::graphsync {
       const std::vector<Extension> &extensions,
       RequestProgressCallback callback) {
     if (!started_ || !network_->canSendRequest(peer)) {
-      logger()->trace("makeRequest: rejecting request to peer {}",
-                      peer.toBase58().substr(46));
+      SPDLOG_LOGGER_TRACE(logger(),
+                          "makeRequest: rejecting request to peer {}",
+                          peer.toBase58().substr(46));
       return local_requests_->newRejectedRequest(std::move(callback));
     }
 
@@ -72,14 +81,16 @@ namespace fc::storage::ipfs::graphsync {
     }
 
     auto newRequest = local_requests_->newRequest(
+        peer,
         root_cid, selector, extensions, std::move(callback));
 
-    if (newRequest.request_id > 0) {
+    if (newRequest.request_id > 0 && !newRequest.joined) {
       assert(newRequest.body);
       assert(!newRequest.body->empty());
 
-      logger()->trace("makeRequest: sending request to peer {}",
-                      peer.toBase58().substr(46));
+      SPDLOG_LOGGER_TRACE(logger(),
+                          "makeRequest: sending request to peer {}",
+                          peer.toBase58().substr(46));
 
       network_->makeRequest(peer,
                             std::move(address),
@@ -100,32 +111,83 @@ namespace fc::storage::ipfs::graphsync {
       return;
     }
 
+    if (pipeline_) {
+      // response is reported after blocks of its message are stored
+      pipeline_->after([wptr{weak_from_this()},
+                        request_id,
+                        status,
+                        extensions{std::move(extensions)}](
+                           outcome::result<void> stored) mutable {
+        auto self = wptr.lock();
+        if (self && self->started_) {
+          self->local_requests_->onResponse(request_id,
+                                            stored ? status : RS_INTERNAL_ERROR,
+                                            std::move(extensions));
+        }
+      });
+      return;
+    }
+
     local_requests_->onResponse(request_id, status, std::move(extensions));
   }
 
   void GraphsyncImpl::onBlock(const PeerId &from,
                               CID cid,
-                              common::Buffer data) {
+                              gsl::span<const uint8_t> data) {
     // TODO peer ratings according to status
 
     if (!started_) {
       return;
     }
 
-    block_cb_(std::move(cid), std::move(data));
+    static auto &domain{common::memoryDomain("graphsync")};
+    common::MemoryDomainScope scope{domain};
+    // the only copy of received block, made for its consumer
+    common::Buffer block{data};
+    if (pipeline_) {
+      pipeline_->push(
+          std::move(cid),
+          std::move(block),
+          [wptr{weak_from_this()}](outcome::result<void> stored,
+                                   CID cid,
+                                   common::Buffer data) {
+            auto self = wptr.lock();
+            // request of block which wasn't stored fails with its response
+            if (stored && self && self->started_) {
+              self->block_cb_(std::move(cid), std::move(data));
+            }
+          });
+      return;
+    }
+    cid.content_address =
+        crypto::Hasher::calculate(cid.content_address.getType(), block);
+    block_cb_(std::move(cid), std::move(block));
+  }
+
+  bool GraphsyncImpl::pauseReading(std::function<void()> resume) {
+    return pipeline_ && pipeline_->whenDrained(std::move(resume));
   }
 
   void GraphsyncImpl::onRemoteRequest(const PeerId &from,
                                       Message::Request request) {
-    // TODO make this asynchronous
-
+    static auto &domain{common::memoryDomain("graphsync")};
+    common::MemoryDomainScope scope{domain};
     bool send_response = true;
 
+    PausedResponse paused{
+        from, request.id, RS_REQUEST_FAILED, request.extensions, {}};
+
     auto data_handler = [&](const CID &cid,
                             const common::Buffer &data) -> bool {
       bool data_present = !data.empty();
 
       if (data_present) {
+        if (!paused.cids.empty() || network_->isResponseQueueFull(from)) {
+          // block is loaded again when peer's queue is drained, so slow
+          // peers don't keep selected data in memory
+          paused.cids.push_back(cid);
+          return true;
+        }
         if (!network_->addBlockToResponse(from, request.id, cid, data)) {
           send_response = false;
           return false;
@@ -152,9 +214,62 @@ namespace fc::storage::ipfs::graphsync {
       }
     }
 
+    if (!paused.cids.empty()) {
+      paused.status = status;
+      paused_responses_.push_back(std::move(paused));
+      return;
+    }
+
     network_->sendResponse(from, request.id, status, request.extensions);
   }
 
+  void GraphsyncImpl::onResponseQueueDrained(const PeerId &peer) {
+    if (!started_ || resuming_responses_) {
+      // outer loop checks network state for each block
+      return;
+    }
+
+    resuming_responses_ = true;
+    for (auto it = paused_responses_.begin(); it != paused_responses_.end();) {
+      if (it->peer == peer && resumeResponse(*it)) {
+        it = paused_responses_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    resuming_responses_ = false;
+  }
+
+  bool GraphsyncImpl::resumeResponse(PausedResponse &response) {
+    while (!response.cids.empty()) {
+      if (network_->isResponseQueueFull(response.peer)) {
+        return false;
+      }
+
+      auto &cid = response.cids.front();
+      auto data = dag_->getBlock(cid);
+      if (!data) {
+        logger()->error("resumeResponse: cannot load block, msg='{}'",
+                        data.error().message());
+        response.status = RS_REQUEST_FAILED;
+        break;
+      }
+
+      if (!network_->addBlockToResponse(
+              response.peer, response.request_id, cid, data.value())) {
+        // request is cancelled or peer is closed
+        return true;
+      }
+      response.cids.pop_front();
+    }
+
+    network_->sendResponse(response.peer,
+                           response.request_id,
+                           response.status,
+                           response.extensions);
+    return true;
+  }
+
   void GraphsyncImpl::cancelLocalRequest(RequestId request_id,
                                          SharedData body) {
     network_->cancelRequest(request_id, std::move(body));
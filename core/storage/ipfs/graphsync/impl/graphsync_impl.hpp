@@ -6,6 +6,7 @@
 #ifndef CPP_FILECOIN_GRAPHSYNC_IMPL_HPP
 #define CPP_FILECOIN_GRAPHSYNC_IMPL_HPP
 
+#include <deque>
 #include <set>
 
 #include <libp2p/protocol/common/scheduler.hpp>
@@ -19,8 +20,10 @@ namespace libp2p {
 
 namespace fc::storage::ipfs::graphsync {
 
+  class BlockPipeline;
   class LocalRequests;
   class Network;
+  class NetworkShards;
 
   /// Core graphsync component. The central module
   class GraphsyncImpl : public Graphsync,
@@ -30,8 +33,15 @@ namespace fc::storage::ipfs::graphsync {
     /// Ctor.
     /// \param host libp2p host object
     /// \param scheduler libp2p scheduler
+    /// \param pipeline optional pipeline verifying and storing received
+    /// blocks off the network thread, block callback is called for stored
+    /// blocks then. Otherwise blocks are verified inline
+    /// \param shards optional worker shards parsing messages of peers off
+    /// the network thread, each peer pinned to one shard
     GraphsyncImpl(std::shared_ptr<libp2p::Host> host,
-                  std::shared_ptr<libp2p::protocol::Scheduler> scheduler);
+                  std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+                  std::shared_ptr<BlockPipeline> pipeline = nullptr,
+                  std::shared_ptr<NetworkShards> shards = nullptr);
 
     ~GraphsyncImpl() override;
 
@@ -58,8 +68,29 @@ namespace fc::storage::ipfs::graphsync {
                     RequestId request_id,
                     ResponseStatusCode status,
                     std::vector<Extension> extensions) override;
-    void onBlock(const PeerId &from, CID cid, common::Buffer data) override;
+    void onBlock(const PeerId &from,
+                 CID cid,
+                 gsl::span<const uint8_t> data) override;
     void onRemoteRequest(const PeerId &from, Message::Request request) override;
+    void onResponseQueueDrained(const PeerId &peer) override;
+    bool pauseReading(std::function<void()> resume) override;
+
+    /// Response to remote request, paused while pending responses to peer
+    /// are over limit
+    struct PausedResponse {
+      PeerId peer;
+      RequestId request_id;
+      ResponseStatusCode status;
+      std::vector<Extension> extensions;
+
+      /// Selected blocks not added to response yet, loaded on resume
+      std::deque<CID> cids;
+    };
+
+    /// Adds blocks to paused response while network accepts them
+    /// \param response paused response
+    /// \return true if response is sent or dropped
+    bool resumeResponse(PausedResponse &response);
 
     /// NVI for stop()
     void doStop();
@@ -73,12 +104,21 @@ namespace fc::storage::ipfs::graphsync {
     /// Local requests handling module
     std::shared_ptr<LocalRequests> local_requests_;
 
+    /// Pipeline for received blocks, optional
+    std::shared_ptr<BlockPipeline> pipeline_;
+
     /// Interface to MerkleDAG component
     std::shared_ptr<MerkleDagBridge> dag_;
 
     /// The only subscription to blocks (at the moment)
     Graphsync::BlockCallback block_cb_;
 
+    /// Responses waiting for network to drain, in order of requests
+    std::vector<PausedResponse> paused_responses_;
+
+    /// Flag, set while paused responses are resumed
+    bool resuming_responses_ = false;
+
     /// Flag, indicates that instance is started
     bool started_ = false;
   };
@@ -17,12 +17,38 @@ namespace fc::storage::ipfs::graphsync {
     assert(cancel_fn_);
   }
 
+  uint64_t LocalRequests::ticket(RequestId request_id, uint32_t subscriber) {
+    return (static_cast<uint64_t>(subscriber) << 32)
+           | static_cast<uint32_t>(request_id);
+  }
+
   LocalRequests::NewRequest LocalRequests::newRequest(
+      const PeerId &peer,
       const CID &root_cid,
       gsl::span<const uint8_t> selector,
       const std::vector<Extension> &extensions,
       Graphsync::RequestProgressCallback callback) {
     NewRequest ctx;
+    boost::optional<Key> key;
+    if (extensions.empty()) {
+      key = Key{peer.toVector(),
+                root_cid,
+                std::vector<uint8_t>{selector.begin(), selector.end()}};
+      auto it = shared_requests_.find(*key);
+      if (it != shared_requests_.end()) {
+        auto &request = active_requests_.at(it->second);
+        auto subscriber = request.next_subscriber++;
+        request.callbacks.emplace(subscriber, std::move(callback));
+        ctx.request_id = it->second;
+        ctx.subscription =
+            Subscription(ticket(ctx.request_id, subscriber), weak_from_this());
+        ctx.joined = true;
+        SPDLOG_LOGGER_TRACE(
+            logger(), "{}: joined id={}", __FUNCTION__, ctx.request_id);
+        return ctx;
+      }
+    }
+
     ctx.request_id = nextRequestId();
     if (ctx.request_id == 0) {
       // Will likely not get here, possible iff INT_MAX simultaneous requests
@@ -44,9 +70,14 @@ namespace fc::storage::ipfs::graphsync {
 
     ctx.subscription = Subscription(ctx.request_id, weak_from_this());
     ctx.body = std::move(serialize_res.value());
-    active_requests_[ctx.request_id] = std::move(callback);
+    auto &request = active_requests_[ctx.request_id];
+    request.callbacks.emplace(0, std::move(callback));
+    if (key) {
+      shared_requests_.emplace(*key, ctx.request_id);
+      request.key = std::move(key);
+    }
 
-    logger()->trace("{}: id={}", __FUNCTION__, ctx.request_id);
+    SPDLOG_LOGGER_TRACE(logger(), "{}: id={}", __FUNCTION__, ctx.request_id);
 
     return ctx;
   }
@@ -73,14 +104,28 @@ namespace fc::storage::ipfs::graphsync {
           "{}: cannot find request, id={}", __FUNCTION__, request_id);
       return;
     }
+    std::vector<Graphsync::RequestProgressCallback> callbacks;
+    callbacks.reserve(it->second.callbacks.size());
     if (isTerminal(status)) {
-      auto cb = std::move(it->second);
+      for (auto &[_, cb] : it->second.callbacks) {
+        callbacks.push_back(std::move(cb));
+      }
+      if (it->second.key) {
+        shared_requests_.erase(*it->second.key);
+      }
       active_requests_.erase(it);
-      cb(status, std::move(extensions));
     } else {
-      // make copy, reentrancy is allowed here
-      auto cb = it->second;
-      cb(status, std::move(extensions));
+      // make copies, reentrancy is allowed here
+      for (const auto &[_, cb] : it->second.callbacks) {
+        callbacks.push_back(cb);
+      }
+    }
+    for (size_t i = 0; i < callbacks.size(); ++i) {
+      if (i + 1 == callbacks.size()) {
+        callbacks[i](status, std::move(extensions));
+      } else {
+        callbacks[i](status, extensions);
+      }
     }
   }
 
@@ -95,6 +140,19 @@ namespace fc::storage::ipfs::graphsync {
     }
   }
 
+  void LocalRequests::cancelAll(LocalRequests::ActiveMap &requests) {
+    if (requests.empty()) {
+      return;
+    }
+    ActiveMap m;
+    std::swap(m, requests);
+    for (const auto &it : m) {
+      for (const auto &[_, cb] : it.second.callbacks) {
+        cb(RS_REJECTED_LOCALLY, {});
+      }
+    }
+  }
+
   void LocalRequests::asyncNotifyRejectedRequests() {
     if (rejected_notify_scheduled_) {
       return;
@@ -113,6 +171,7 @@ namespace fc::storage::ipfs::graphsync {
   }
 
   void LocalRequests::cancelAll() {
+    shared_requests_.clear();
     cancelAll(active_requests_);
     cancelAll(rejected_requests_);
   }
@@ -130,6 +189,15 @@ namespace fc::storage::ipfs::graphsync {
     if (it == active_requests_.end()) {
       return;
     }
+    auto &callbacks = it->second.callbacks;
+    if (callbacks.erase(static_cast<uint32_t>(ticket >> 32)) == 0
+        || !callbacks.empty()) {
+      // request is still needed by other subscribers
+      return;
+    }
+    if (it->second.key) {
+      shared_requests_.erase(*it->second.key);
+    }
     active_requests_.erase(it);
 
     request_builder_.addCancelRequest(request_id);
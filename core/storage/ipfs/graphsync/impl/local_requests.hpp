@@ -7,6 +7,7 @@
 #define CPP_FILECOIN_GRAPHSYNC_LOCAL_REQUESTS_HPP
 
 #include <map>
+#include <tuple>
 
 #include <libp2p/protocol/common/scheduler.hpp>
 
@@ -14,7 +15,17 @@
 
 namespace fc::storage::ipfs::graphsync {
 
-  /// Local requests module for graphsync, manages requests made by this host
+  /**
+   * Local requests module for graphsync, manages requests made by this host.
+   * Requests without extensions for same peer, root and selector made while
+   * one is in flight are coalesced, they join it instead of being sent again.
+   * Every subscriber receives all statuses after joining, request is
+   * cancelled on the wire when last subscriber unsubscribes. Blocks are
+   * reported to single block callback anyway, so joined subscriber doesn't
+   * lose data, blocks received before it joined are already stored.
+   * Requests with extensions are never coalesced, extensions like vouchers
+   * belong to one request.
+   */
   class LocalRequests : public Subscription::Source {
    public:
     /// Context of a new request
@@ -27,6 +38,9 @@ namespace fc::storage::ipfs::graphsync {
 
       /// Serialized request body to be sent to the wire
       SharedData body;
+
+      /// Request joined one in flight, nothing to send
+      bool joined = false;
     };
 
     /// LocalRequests->Graphsync feedback interface
@@ -40,13 +54,16 @@ namespace fc::storage::ipfs::graphsync {
         CancelRequestFn cancel_fn);
 
     /// Non-network part of Graphsync's makeRequest implementation.
-    /// Creates a new request and NewRequest fields
+    /// Creates a new request and NewRequest fields, or joins same request
+    /// in flight
+    /// \param peer Peer ID, part of coalescing key
     /// \param root_cid Root CID of the request
     /// \param selector IPLD selector
     /// \param extensions - protocol extension data
     /// \param callback A callback which keeps track of request progress
     /// \return request context, including serialized body
-    NewRequest newRequest(const CID &root_cid,
+    NewRequest newRequest(const PeerId &peer,
+                          const CID &root_cid,
                           gsl::span<const uint8_t> selector,
                           const std::vector<Extension> &extensions,
                           Graphsync::RequestProgressCallback callback);
@@ -70,9 +87,30 @@ namespace fc::storage::ipfs::graphsync {
     void cancelAll();
 
    private:
-    /// Container that tracks all local requests
+    /// Container that tracks rejected requests
     using RequestMap = std::map<RequestId, Graphsync::RequestProgressCallback>;
 
+    /// Peer bytes, root and selector of request without extensions
+    using Key = std::tuple<std::vector<uint8_t>, CID, std::vector<uint8_t>>;
+
+    /// Request in flight with its subscribers
+    struct ActiveRequest {
+      /// Callbacks by subscriber index, originator of request has zero
+      std::map<uint32_t, Graphsync::RequestProgressCallback> callbacks;
+
+      /// Next subscriber index
+      uint32_t next_subscriber = 1;
+
+      /// Coalescing key, none if request is not shared
+      boost::optional<Key> key;
+    };
+
+    /// Container that tracks all local requests
+    using ActiveMap = std::map<RequestId, ActiveRequest>;
+
+    /// Subscription ticket of subscriber, request id is in low 32 bits
+    static uint64_t ticket(RequestId request_id, uint32_t subscriber);
+
     /// Subscription::Source::unsubscribe override
     void unsubscribe(uint64_t ticket) override;
 
@@ -82,6 +120,9 @@ namespace fc::storage::ipfs::graphsync {
     /// Helper fr cancelAll(), avoids reentrancy
     static void cancelAll(RequestMap &requests);
 
+    /// Helper fr cancelAll(), notifies all subscribers
+    static void cancelAll(ActiveMap &requests);
+
     /// Returns the next available request id
     RequestId nextRequestId();
 
@@ -92,7 +133,10 @@ namespace fc::storage::ipfs::graphsync {
     CancelRequestFn cancel_fn_;
 
     /// All active requests
-    RequestMap active_requests_;
+    ActiveMap active_requests_;
+
+    /// Requests which may be joined, by coalescing key
+    std::map<Key, RequestId> shared_requests_;
 
     /// All rejected requests
     RequestMap rejected_requests_;
@@ -6,7 +6,9 @@
 #include "merkledag_bridge_impl.hpp"
 
 #include <cassert>
+#include <deque>
 
+#include "storage/ipfs/impl/async_datastore.hpp"
 #include "storage/ipfs/merkledag/merkledag_service.hpp"
 
 namespace fc::storage::ipfs::graphsync {
@@ -16,9 +18,17 @@ namespace fc::storage::ipfs::graphsync {
     return std::make_shared<MerkleDagBridgeImpl>(std::move(service));
   }
 
+  std::shared_ptr<MerkleDagBridge> MerkleDagBridge::create(
+      std::shared_ptr<merkledag::MerkleDagService> service,
+      std::shared_ptr<AsyncDatastore> async) {
+    return std::make_shared<MerkleDagBridgeImpl>(std::move(service),
+                                                 std::move(async));
+  }
+
   MerkleDagBridgeImpl::MerkleDagBridgeImpl(
-      std::shared_ptr<merkledag::MerkleDagService> service)
-      : service_(std::move(service)) {
+      std::shared_ptr<merkledag::MerkleDagService> service,
+      std::shared_ptr<AsyncDatastore> async)
+      : service_(std::move(service)), async_(std::move(async)) {
     assert(service_);
   }
 
@@ -37,9 +47,67 @@ namespace fc::storage::ipfs::graphsync {
       return 1;
     }
 
+    if (async_) {
+      return selectReadAhead(root_cid, handler);
+    }
+
     // TODO(???): change MerkleDAG service to accept CID instead of bytes
     OUTCOME_TRY(cid_encoded, root_cid.toBytes());
     return service_->select(cid_encoded, selector, internal_handler);
   }
 
+  outcome::result<size_t> MerkleDagBridgeImpl::selectReadAhead(
+      const CID &root_cid,
+      const std::function<bool(const CID &, const common::Buffer &)> &handler)
+      const {
+    // same traversal as MerkleDagService::select, root and its links
+    OUTCOME_TRY(root, service_->getNode(root_cid));
+    size_t count = 1;
+    if (!handler(root->getCID(), root->getRawBytes())) {
+      return count;
+    }
+
+    auto links = root->getLinks();
+    auto next = links.begin();
+    std::deque<std::pair<CID, std::future<outcome::result<common::Buffer>>>>
+        window;
+    auto fill = [&] {
+      while (next != links.end() && window.size() < kSelectReadAhead) {
+        const auto &cid = next->get().getCID();
+        window.emplace_back(cid, async_->prefetch(cid));
+        ++next;
+      }
+    };
+
+    fill();
+    while (!window.empty()) {
+      auto data = window.front().second.get();
+      if (!data) {
+        // reads left in window finish on pool and are dropped
+        return merkledag::ServiceError::UNRESOLVED_LINK;
+      }
+      ++count;
+      if (!handler(window.front().first, data.value())) {
+        break;
+      }
+      window.pop_front();
+      fill();
+    }
+    return count;
+  }
+
+  outcome::result<common::Buffer> MerkleDagBridgeImpl::getBlock(
+      const CID &cid) const {
+    OUTCOME_TRY(node, service_->getNode(cid));
+    return node->getRawBytes();
+  }
+
+  void MerkleDagBridgeImpl::getBlockAsync(const CID &cid,
+                                          BlockLoaded callback) const {
+    if (!async_) {
+      return MerkleDagBridge::getBlockAsync(cid, std::move(callback));
+    }
+    async_->get(cid, std::move(callback));
+  }
+
 }  // namespace fc::storage::ipfs::graphsync
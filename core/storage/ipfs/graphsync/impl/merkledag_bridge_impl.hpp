@@ -10,12 +10,20 @@
 
 namespace fc::storage::ipfs::graphsync {
 
-  /// Default implementation og Graphsync->MerkleDAG bridge
+  /// Blocks read ahead of responder traversal
+  constexpr size_t kSelectReadAhead = 16;
+
+  /// Default implementation og Graphsync->MerkleDAG bridge. With async
+  /// datastore, links of selected node are read ahead on its I/O pool, at
+  /// most kSelectReadAhead at once, so response is not sent at the speed of
+  /// random reads one by one
   class MerkleDagBridgeImpl : public MerkleDagBridge {
    public:
     /// Ctor. called form  MerkleDagBridge::create(...)
+    /// \param async Optional async datastore of service blocks
     explicit MerkleDagBridgeImpl(
-        std::shared_ptr<merkledag::MerkleDagService> service);
+        std::shared_ptr<merkledag::MerkleDagService> service,
+        std::shared_ptr<AsyncDatastore> async = nullptr);
 
    private:
     // overrides MerkleDagBridge interface
@@ -25,8 +33,21 @@ namespace fc::storage::ipfs::graphsync {
         std::function<bool(const CID &cid, const common::Buffer &data)> handler)
         const override;
 
+    outcome::result<common::Buffer> getBlock(const CID &cid) const override;
+
+    void getBlockAsync(const CID &cid, BlockLoaded callback) const override;
+
+    /// Selects root and its links, reading links ahead
+    outcome::result<size_t> selectReadAhead(
+        const CID &root_cid,
+        const std::function<bool(const CID &cid, const common::Buffer &data)>
+            &handler) const;
+
     /// MerkleDAG service
     std::shared_ptr<merkledag::MerkleDagService> service_;
+
+    /// Async reads of blocks, optional
+    std::shared_ptr<AsyncDatastore> async_;
   };
 
 }  // namespace fc::storage::ipfs::graphsync
@@ -24,7 +24,8 @@ namespace fc::storage::ipfs::graphsync {
       return Error::WRITE_QUEUE_OVERFLOW;
     }
 
-    if (serialized_size + data.size() > kMaxMessageSize) {
+    if (serialized_size > 0
+        && serialized_size + data.size() > kResponseMessageTargetSize) {
       auto res = sendPartialResponse(request_id);
       if (!res) {
         return res;
@@ -56,7 +57,7 @@ namespace fc::storage::ipfs::graphsync {
 
   outcome::result<void> InboundEndpoint::sendPartialResponse(int request_id) {
     static const std::vector<Extension> dummy_extensions;
-    return sendResponse(request_id, RS_PARTIAL_CONTENT, dummy_extensions);
+    return sendResponse(request_id, RS_PARTIAL_RESPONSE, dummy_extensions);
   }
 
 }  // namespace fc::storage::ipfs::graphsync
@@ -40,8 +40,8 @@ namespace fc::storage::ipfs::graphsync {
         const std::vector<Extension> &extensions);
 
    private:
-    /// Enqueues partial response when protobuf message size exceeds protocol
-    /// limits
+    /// Enqueues partial response when protobuf message size exceeds target
+    /// size, so small blocks are coalesced and large ones are sent alone
     /// \param request_id request id
     /// \return result of queue operation
     outcome::result<void> sendPartialResponse(RequestId request_id);
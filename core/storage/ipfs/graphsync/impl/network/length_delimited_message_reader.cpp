@@ -111,7 +111,21 @@ namespace fc::storage::ipfs::graphsync {
 
     // if owner called close() during feedback then the stream is now reset
     // and no further reading is needed
-    if (stream_) {
+    if (stream_ && !paused_) {
+      continueReading();
+    }
+  }
+
+  void LengthDelimitedMessageReader::pause() {
+    paused_ = true;
+  }
+
+  void LengthDelimitedMessageReader::resume() {
+    if (!paused_) {
+      return;
+    }
+    paused_ = false;
+    if (stream_ && !reading_) {
       continueReading();
     }
   }
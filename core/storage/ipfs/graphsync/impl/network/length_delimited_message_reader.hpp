@@ -43,6 +43,12 @@ namespace fc::storage::ipfs::graphsync {
     /// wire
     void close();
 
+    /// Stops reading after current message until resume() is called
+    void pause();
+
+    /// Continues reading paused by pause()
+    void resume();
+
    private:
     /// Begins async read operation
     void continueReading();
@@ -69,6 +75,9 @@ namespace fc::storage::ipfs::graphsync {
 
     /// Internal flag, decouples shared ptr from dependent objects
     bool reading_ = false;
+
+    /// Reading is paused by owner
+    bool paused_ = false;
   };
 
 }  // namespace fc::storage::ipfs::graphsync
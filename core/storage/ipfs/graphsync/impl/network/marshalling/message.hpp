@@ -55,8 +55,12 @@ namespace fc::storage::ipfs::graphsync {
     /// The list of responses
     std::vector<Response> responses;
 
-    /// Blocks related to the responses, as cid->data pairs
-    std::vector<std::pair<CID, common::Buffer>> data;
+    /// Frame the message was parsed from, block data references it
+    SharedData frame;
+
+    /// Blocks related to the responses, as cid prefix->data pairs, valid
+    /// while frame is alive. Hash of cid is not computed from data yet
+    std::vector<std::pair<CID, gsl::span<const uint8_t>>> data;
   };
 }  // namespace fc::storage::ipfs::graphsync
 
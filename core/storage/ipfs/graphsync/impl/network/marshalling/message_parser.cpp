@@ -5,19 +5,82 @@
 
 #include "message_parser.hpp"
 
-#include "codec/cbor/cbor_decode_stream.hpp"
-#include "common/span.hpp"
-#include "crypto/hasher/hasher.hpp"
-
-#include "protobuf/message.pb.h"
+#include <google/protobuf/io/coded_stream.h>
 
 namespace fc::storage::ipfs::graphsync {
   namespace {
-    using codec::cbor::CborDecodeStream;
+    using google::protobuf::io::CodedInputStream;
+    using Input = gsl::span<const uint8_t>;
+
+    /// Protobuf wire types used by graphsync message
+    constexpr uint32_t kVarint = 0;
+    constexpr uint32_t kLengthDelimited = 2;
+
+    /// Reads protobuf fields in one pass, bytes fields reference input
+    class FieldReader {
+     public:
+      explicit FieldReader(Input input)
+          : input_{input}, cs_{input.data(), static_cast<int>(input.size())} {}
+
+      /// Reads next field tag, false at the end of input or on error
+      bool next() {
+        tag_ = cs_.ReadTag();
+        return tag_ != 0;
+      }
+
+      /// Returns true if the whole input was read
+      bool atEnd() const {
+        return static_cast<size_t>(cs_.CurrentPosition()) == input_.size();
+      }
+
+      uint32_t field() const {
+        return tag_ >> 3;
+      }
+
+      outcome::result<uint64_t> varint() {
+        uint64_t value;
+        if ((tag_ & 7) != kVarint || !cs_.ReadVarint64(&value)) {
+          return Error::MESSAGE_PARSE_ERROR;
+        }
+        return value;
+      }
+
+      outcome::result<Input> bytes() {
+        int size;
+        if ((tag_ & 7) != kLengthDelimited || !cs_.ReadVarintSizeAsInt(&size)) {
+          return Error::MESSAGE_PARSE_ERROR;
+        }
+        auto offset = cs_.CurrentPosition();
+        if (!cs_.Skip(size)) {
+          return Error::MESSAGE_PARSE_ERROR;
+        }
+        return input_.subspan(offset, size);
+      }
+
+      outcome::result<void> skip() {
+        if (!cs_.SkipField(tag_)) {
+          return Error::MESSAGE_PARSE_ERROR;
+        }
+        return outcome::success();
+      }
 
-    // Dummy protobuf helper, string->bytes
-    inline auto fromString(const std::string &src) {
-      return common::Buffer{common::span::cbytes(src)};
+     private:
+      Input input_;
+      CodedInputStream cs_;
+      uint32_t tag_ = 0;
+    };
+
+    /// Visits fields of message, fails if message is not read to the end
+    template <typename Visitor>
+    outcome::result<void> readFields(Input input, const Visitor &visitor) {
+      FieldReader reader{input};
+      while (reader.next()) {
+        OUTCOME_TRY(visitor(reader));
+      }
+      if (!reader.atEnd()) {
+        return Error::MESSAGE_PARSE_ERROR;
+      }
+      return outcome::success();
     }
 
     // Checks status code received from wire
@@ -47,105 +110,168 @@ namespace fc::storage::ipfs::graphsync {
       return Error::MESSAGE_PARSE_ERROR;
     }
 
-    // Extracts requests from protobuf message
-    outcome::result<void> parseRequests(pb::Message &pb_msg, Message &msg) {
-      auto sz = pb_msg.requests_size();
-      if (sz > 0) {
-        msg.requests.reserve(sz);
-        for (auto &src : pb_msg.requests()) {
-          auto &dst = msg.requests.emplace_back(Message::Request());
-          dst.id = src.id();
-          if (src.cancel()) {
-            dst.cancel = true;
-          } else {
-            OUTCOME_TRY(cid, CID::fromBytes(common::span::cbytes(src.root())));
-            dst.root_cid = std::move(cid);
-            dst.selector = fromString(src.selector());
-            dst.priority = src.priority();
-
-            for (const auto &[k, v] : src.extensions()) {
-              std::vector<uint8_t> data(v.begin(), v.end());
-              dst.extensions.emplace_back(Extension{k, data});
-            }
-          }
+    // Extracts map<string, bytes> entry of extensions
+    outcome::result<void> parseExtension(Input input,
+                                         std::vector<Extension> &extensions) {
+      auto &dst = extensions.emplace_back();
+      return readFields(input, [&](FieldReader &r) -> outcome::result<void> {
+        if (r.field() == 1) {
+          OUTCOME_TRY(name, r.bytes());
+          dst.name.assign(name.begin(), name.end());
+        } else if (r.field() == 2) {
+          OUTCOME_TRY(data, r.bytes());
+          dst.data.assign(data.begin(), data.end());
+        } else {
+          OUTCOME_TRY(r.skip());
         }
+        return outcome::success();
+      });
+    }
+
+    // Extracts request
+    outcome::result<void> parseRequest(Input input, Message &msg) {
+      auto &dst = msg.requests.emplace_back(Message::Request());
+      Input root;
+      OUTCOME_TRY(
+          readFields(input, [&](FieldReader &r) -> outcome::result<void> {
+            switch (r.field()) {
+              case 1: {
+                OUTCOME_TRY(id, r.varint());
+                dst.id = static_cast<RequestId>(id);
+                break;
+              }
+              case 2: {
+                OUTCOME_TRYA(root, r.bytes());
+                break;
+              }
+              case 3: {
+                OUTCOME_TRY(selector, r.bytes());
+                dst.selector = common::Buffer{selector};
+                break;
+              }
+              case 4: {
+                OUTCOME_TRY(entry, r.bytes());
+                OUTCOME_TRY(parseExtension(entry, dst.extensions));
+                break;
+              }
+              case 5: {
+                OUTCOME_TRY(priority, r.varint());
+                dst.priority = static_cast<int32_t>(priority);
+                break;
+              }
+              case 6: {
+                OUTCOME_TRY(cancel, r.varint());
+                dst.cancel = cancel != 0;
+                break;
+              }
+              default:
+                OUTCOME_TRY(r.skip());
+            }
+            return outcome::success();
+          }));
+      if (!dst.cancel) {
+        OUTCOME_TRYA(dst.root_cid, CID::fromBytes(root));
+      } else {
+        dst.selector.clear();
+        dst.extensions.clear();
       }
       return outcome::success();
     }
 
-    // Extracts responses from protobuf message
-    outcome::result<void> parseResponses(pb::Message &pb_msg, Message &msg) {
-      size_t sz = pb_msg.responses_size();
-      if (sz > 0) {
-        msg.responses.reserve(sz);
-
-        for (auto &src : pb_msg.responses()) {
-          auto &dst = msg.responses.emplace_back(Message::Response());
-          dst.id = src.id();
-          OUTCOME_TRY(status, extractStatusCode(src.status()));
-          dst.status = status;
-
-          for (const auto &[k, v] : src.extensions()) {
-            std::vector<uint8_t> data(v.begin(), v.end());
-            dst.extensions.emplace_back(Extension{k, data});
-          }
-        }
-      }
+    // Extracts response
+    outcome::result<void> parseResponse(Input input, Message &msg) {
+      auto &dst = msg.responses.emplace_back(Message::Response());
+      int status = 0;
+      OUTCOME_TRY(
+          readFields(input, [&](FieldReader &r) -> outcome::result<void> {
+            switch (r.field()) {
+              case 1: {
+                OUTCOME_TRY(id, r.varint());
+                dst.id = static_cast<RequestId>(id);
+                break;
+              }
+              case 2: {
+                OUTCOME_TRY(code, r.varint());
+                status = static_cast<int>(code);
+                break;
+              }
+              case 3: {
+                OUTCOME_TRY(entry, r.bytes());
+                OUTCOME_TRY(parseExtension(entry, dst.extensions));
+                break;
+              }
+              default:
+                OUTCOME_TRY(r.skip());
+            }
+            return outcome::success();
+          }));
+      OUTCOME_TRYA(dst.status, extractStatusCode(status));
       return outcome::success();
     }
 
-    // Extracts data blocks from protobuf message
-    outcome::result<void> parseBlocks(pb::Message &pb_msg, Message &msg) {
-      size_t sz = pb_msg.data_size();
-      if (sz > 0) {
-        msg.data.reserve(sz);
-
-        for (auto &src : pb_msg.data()) {
-          auto data = fromString(src.data());
-          auto prefix_reader = common::span::cbytes(src.prefix());
-          OUTCOME_TRY(cid, CID::read(prefix_reader, true));
-          if (!prefix_reader.empty()) {
-            return Error::MESSAGE_PARSE_ERROR;
-          }
-          cid.content_address =
-              crypto::Hasher::calculate(cid.content_address.getType(), data);
-          msg.data.emplace_back(std::move(cid), data);
-        }
+    // Extracts data block, its CID prefix is kept, hash is computed by
+    // consumer off the network thread
+    outcome::result<void> parseBlock(Input input, Message &msg) {
+      Input prefix, data;
+      OUTCOME_TRY(
+          readFields(input, [&](FieldReader &r) -> outcome::result<void> {
+            if (r.field() == 1) {
+              OUTCOME_TRYA(prefix, r.bytes());
+            } else if (r.field() == 2) {
+              OUTCOME_TRYA(data, r.bytes());
+            } else {
+              OUTCOME_TRY(r.skip());
+            }
+            return outcome::success();
+          }));
+      OUTCOME_TRY(cid, CID::read(prefix, true));
+      if (!prefix.empty()) {
+        return Error::MESSAGE_PARSE_ERROR;
       }
+      msg.data.emplace_back(std::move(cid), data);
       return outcome::success();
     }
 
   }  // namespace
 
-  outcome::result<Message> parseMessage(gsl::span<const uint8_t> bytes) {
-    pb::Message pb_msg;
-
-    if (!pb_msg.ParseFromArray(bytes.data(), bytes.size())) {
-      logger()->warn("{}: cannot parse protobuf message, size={}",
-                     __FUNCTION__,
-                     bytes.size());
-      return Error::MESSAGE_PARSE_ERROR;
-    }
-
+  outcome::result<Message> parseMessage(SharedData frame) {
     Message msg;
 
-    msg.complete_request_list = pb_msg.completerequestlist();
-
-    auto res = parseRequests(pb_msg, msg);
-    if (!res) {
-      return res.error();
-    }
-
-    res = parseResponses(pb_msg, msg);
-    if (!res) {
-      return res.error();
-    }
-
-    res = parseBlocks(pb_msg, msg);
+    auto res = readFields(*frame, [&](FieldReader &r) -> outcome::result<void> {
+      switch (r.field()) {
+        case 1: {
+          OUTCOME_TRY(complete, r.varint());
+          msg.complete_request_list = complete != 0;
+          break;
+        }
+        case 2: {
+          OUTCOME_TRY(request, r.bytes());
+          OUTCOME_TRY(parseRequest(request, msg));
+          break;
+        }
+        case 3: {
+          OUTCOME_TRY(response, r.bytes());
+          OUTCOME_TRY(parseResponse(response, msg));
+          break;
+        }
+        case 4: {
+          OUTCOME_TRY(block, r.bytes());
+          OUTCOME_TRY(parseBlock(block, msg));
+          break;
+        }
+        default:
+          OUTCOME_TRY(r.skip());
+      }
+      return outcome::success();
+    });
     if (!res) {
+      logger()->warn("{}: cannot parse protobuf message, size={}",
+                     __FUNCTION__,
+                     frame->size());
       return res.error();
     }
 
+    msg.frame = std::move(frame);
     return msg;
   }
 
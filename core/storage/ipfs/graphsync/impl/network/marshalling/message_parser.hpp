@@ -10,10 +10,11 @@
 
 namespace fc::storage::ipfs::graphsync {
 
-  /// Parses protobuf message received from wire
-  /// \param bytes Raw bytes of received message, without length prefix
+  /// Parses protobuf message received from wire in one pass. Block data
+  /// is not copied, message keeps the frame it references
+  /// \param frame Raw bytes of received message, without length prefix
   /// \return Message or error
-  outcome::result<Message> parseMessage(gsl::span<const uint8_t> bytes);
+  outcome::result<Message> parseMessage(SharedData frame);
 
 }  // namespace fc::storage::ipfs::graphsync
 
@@ -9,7 +9,27 @@
 
 #include <cassert>
 
+#include "common/metrics.hpp"
+
 namespace fc::storage::ipfs::graphsync {
+  namespace {
+    using common::metrics::Gauge;
+    using common::metrics::registry;
+
+    /// Buffers waiting for write in all queues
+    struct Metrics {
+      Gauge &bytes{registry().gauge("fc_graphsync_queue_bytes",
+                                    "Bytes waiting in graphsync queues")};
+      Gauge &messages{registry().gauge(
+          "fc_graphsync_queue_messages",
+          "Messages waiting in graphsync queues")};
+    };
+
+    Metrics &metrics() {
+      static Metrics metrics;
+      return metrics;
+    }
+  }  // namespace
 
   MessageQueue::MessageQueue(StreamPtr stream, FeedbackFn feedback)
       : feedback_(std::move(feedback)) {
@@ -21,6 +41,10 @@ namespace fc::storage::ipfs::graphsync {
     state_.active = true;
   }
 
+  MessageQueue::~MessageQueue() {
+    clear();
+  }
+
   const MessageQueue::State &MessageQueue::getState() const {
     return state_;
   }
@@ -34,6 +58,8 @@ namespace fc::storage::ipfs::graphsync {
     if (state_.writing_bytes > 0) {
       // waiting for async write completion, enqueue
       state_.pending_bytes += data->size();
+      metrics().bytes.add(data->size());
+      metrics().messages.add(1);
       pending_buffers_.emplace_back(std::move(data));
     } else {
       // begin async write
@@ -42,6 +68,8 @@ namespace fc::storage::ipfs::graphsync {
   }
 
   void MessageQueue::clear() {
+    metrics().bytes.add(-static_cast<int64_t>(state_.pending_bytes));
+    metrics().messages.add(-static_cast<int64_t>(pending_buffers_.size()));
     state_.pending_bytes = 0;
     pending_buffers_.clear();
   }
@@ -60,6 +88,8 @@ namespace fc::storage::ipfs::graphsync {
       auto buffer = std::move(pending_buffers_.front());
       pending_buffers_.pop_front();
       state_.pending_bytes -= buffer->size();
+      metrics().bytes.add(-static_cast<int64_t>(buffer->size()));
+      metrics().messages.add(-1);
       beginWrite(std::move(buffer));
     }
   }
@@ -43,6 +43,9 @@ namespace fc::storage::ipfs::graphsync {
     /// \param feedback Owner's callback
     MessageQueue(StreamPtr stream, FeedbackFn feedback);
 
+    /// Removes pending buffers from queue metrics
+    ~MessageQueue();
+
     /// Returns current state
     const State &getState() const;
 
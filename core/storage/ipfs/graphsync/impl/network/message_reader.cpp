@@ -9,13 +9,19 @@
 
 #include "length_delimited_message_reader.hpp"
 #include "marshalling/message_parser.hpp"
+#include "network_shards.hpp"
 #include "peer_context.hpp"
 
 namespace fc::storage::ipfs::graphsync {
 
   MessageReader::MessageReader(StreamPtr stream,
-                               EndpointToPeerFeedback &feedback)
-      : feedback_(feedback) {
+                               EndpointToPeerFeedback &feedback,
+                               std::shared_ptr<NetworkShards> shards,
+                               size_t shard)
+      : feedback_(feedback),
+        shards_(std::move(shards)),
+        shard_(shard),
+        self_(std::make_shared<MessageReader *>(this)) {
     assert(stream);
     assert(!stream->isClosedForRead());
 
@@ -35,13 +41,42 @@ namespace fc::storage::ipfs::graphsync {
     stream_reader_->close();
   }
 
+  void MessageReader::pause() {
+    stream_reader_->pause();
+  }
+
+  void MessageReader::resume() {
+    stream_reader_->resume();
+  }
+
   void MessageReader::onMessageRead(const StreamPtr &stream,
                                     outcome::result<ByteArray> res) {
+    if (shards_) {
+      // errors go through the shard too, not to overtake queued messages
+      shards_->offload(
+          shard_,
+          [res{std::move(res)}]() mutable -> outcome::result<Message> {
+            if (!res) {
+              return res.error();
+            }
+            return parseMessage(
+                std::make_shared<const ByteArray>(std::move(res.value())));
+          },
+          [weak{std::weak_ptr<MessageReader *>{self_}},
+           stream](outcome::result<Message> msg_res) {
+            if (auto self = weak.lock()) {
+              (*self)->feedback_.onReaderEvent(stream, std::move(msg_res));
+            }
+          });
+      return;
+    }
+
     if (!res) {
       return feedback_.onReaderEvent(stream, res.error());
     }
 
-    auto msg_res = parseMessage(res.value());
+    auto msg_res = parseMessage(
+        std::make_shared<const ByteArray>(std::move(res.value())));
 
     feedback_.onReaderEvent(stream, std::move(msg_res));
   }
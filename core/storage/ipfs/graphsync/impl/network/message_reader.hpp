@@ -11,6 +11,7 @@
 namespace fc::storage::ipfs::graphsync {
 
   class LengthDelimitedMessageReader;
+  class NetworkShards;
 
   /// Per-stream message reader, graphsync specific
   class MessageReader {
@@ -18,11 +19,21 @@ namespace fc::storage::ipfs::graphsync {
     /// Ctor.
     /// \param stream libp2p stream
     /// \param feedback Owner's feedback interface
+    /// \param shards Parses messages on shard if set, otherwise inline
+    /// \param shard Shard of peer
     MessageReader(StreamPtr stream,
-                  EndpointToPeerFeedback &feedback);
+                  EndpointToPeerFeedback &feedback,
+                  std::shared_ptr<NetworkShards> shards = nullptr,
+                  size_t shard = 0);
 
     ~MessageReader();
 
+    /// Stops reading after current message, owner applies backpressure
+    void pause();
+
+    /// Continues reading paused by pause()
+    void resume();
+
    private:
     /// Callback for async length delimited read operations
     /// \param stream
@@ -34,6 +45,16 @@ namespace fc::storage::ipfs::graphsync {
 
     /// Stream reader, not graphsync specific
     std::shared_ptr<LengthDelimitedMessageReader> stream_reader_;
+
+    /// Shards to parse messages on, optional
+    std::shared_ptr<NetworkShards> shards_;
+
+    /// Shard of peer
+    size_t shard_;
+
+    /// Weak refs of parsed messages posted back to event loop, which are
+    /// dropped after this reader is destroyed
+    std::shared_ptr<MessageReader *> self_;
   };
 
 }  // namespace fc::storage::ipfs::graphsync
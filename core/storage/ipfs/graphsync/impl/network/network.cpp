@@ -15,9 +15,11 @@
 namespace fc::storage::ipfs::graphsync {
 
   Network::Network(std::shared_ptr<libp2p::Host> host,
-                   std::shared_ptr<libp2p::protocol::Scheduler> scheduler)
+                   std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+                   std::shared_ptr<NetworkShards> shards)
       : host_(std::move(host)),
         scheduler_(std::move(scheduler)),
+        shards_(std::move(shards)),
         protocol_id_(kProtocolVersion) {
     assert(host_);
     assert(scheduler_);
@@ -73,7 +75,10 @@ namespace fc::storage::ipfs::graphsync {
     auto ctx = findContext(peer, false);
     assert(ctx);
 
-    logger()->trace("makeRequest: {} has state {}", ctx->str, ctx->getState());
+    SPDLOG_LOGGER_TRACE(logger(),
+                        "makeRequest: {} has state {}",
+                        ctx->str,
+                        ctx->getState());
 
     ctx->setOutboundAddress(std::move(address));
     if (ctx->needToConnect()) {
@@ -147,11 +152,28 @@ namespace fc::storage::ipfs::graphsync {
     ctx->sendResponse(request_id, status, extensions);
   }
 
+  bool Network::isResponseQueueFull(const PeerId &peer) {
+    if (!started_) {
+      return false;
+    }
+
+    auto ctx = findContext(peer, false);
+    if (!ctx) {
+      return false;
+    }
+
+    return ctx->isResponseQueueFull();
+  }
+
   void Network::peerClosed(const PeerId &peer, ResponseStatusCode status) {
     auto it = peers_.find(peer);
     if (it != peers_.end()) {
       peers_.erase(it);
     }
+    if (started_ && feedback_) {
+      // paused responses to peer are dropped
+      feedback_->onResponseQueueDrained(peer);
+    }
   }
 
   PeerContextPtr Network::findContext(const PeerId &peer,
@@ -170,7 +192,8 @@ namespace fc::storage::ipfs::graphsync {
     }
 
     if (!ctx && create_if_not_found) {
-      ctx = std::make_shared<PeerContext>(peer, *feedback_, *this, *scheduler_);
+      ctx = std::make_shared<PeerContext>(
+          peer, *feedback_, *this, *scheduler_, shards_);
       peers_.insert(ctx);
     }
 
@@ -180,7 +203,8 @@ namespace fc::storage::ipfs::graphsync {
   void Network::tryConnect(const PeerContextPtr &ctx) {
     libp2p::peer::PeerInfo pi = ctx->getOutboundPeerInfo();
 
-    logger()->trace(
+    SPDLOG_LOGGER_TRACE(
+        logger(),
         "connecting to {}, {}",
         ctx->str,
         pi.addresses.empty() ? "''" : pi.addresses[0].getStringAddress());
@@ -219,7 +243,7 @@ namespace fc::storage::ipfs::graphsync {
 
     auto ctx = findContext(peer_id_res.value(), true);
 
-    logger()->trace("accepted stream from peer={}", ctx->str);
+    SPDLOG_LOGGER_TRACE(logger(), "accepted stream from peer={}", ctx->str);
 
     ctx->onStreamAccepted(std::move(rstream.value()));
   }
@@ -16,6 +16,8 @@
 
 namespace fc::storage::ipfs::graphsync {
 
+  class NetworkShards;
+
   /// Network part of graphsync component
   class Network : public std::enable_shared_from_this<Network>,
                   public PeerToNetworkFeedback {
@@ -23,8 +25,11 @@ namespace fc::storage::ipfs::graphsync {
     /// Ctor.
     /// \param host libp2p host object
     /// \param scheduler libp2p scheduler
+    /// \param shards worker shards to parse messages of peers on, if not set
+    /// messages are parsed on event loop
     Network(std::shared_ptr<libp2p::Host> host,
-            std::shared_ptr<libp2p::protocol::Scheduler> scheduler);
+            std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+            std::shared_ptr<NetworkShards> shards = nullptr);
 
     ~Network() override;
 
@@ -79,6 +84,11 @@ namespace fc::storage::ipfs::graphsync {
                       ResponseStatusCode status,
                       const std::vector<Extension> &extensions);
 
+    /// Returns true if responses to peer should be paused until
+    /// PeerToGraphsyncFeedback::onResponseQueueDrained
+    /// \param peer peer ID
+    bool isResponseQueueFull(const PeerId &peer);
+
    private:
     /// Callback from peer context that it's closed
     /// \param peer peer ID
@@ -118,6 +128,9 @@ namespace fc::storage::ipfs::graphsync {
     /// libp2p scheduler object
     std::shared_ptr<libp2p::protocol::Scheduler> scheduler_;
 
+    /// Worker shards, optional
+    std::shared_ptr<NetworkShards> shards_;
+
     /// libp2p peorocol ID
     libp2p::peer::Protocol protocol_id_;
 
@@ -35,9 +35,12 @@ namespace fc::storage::ipfs::graphsync {
 
     /// Called on new block from the network
     /// \param from originating peer ID
-    /// \param cid root CID
-    /// \param data block data, raw bytes
-    virtual void onBlock(const PeerId &from, CID cid, common::Buffer data) = 0;
+    /// \param cid CID prefix of block, its hash is not computed yet
+    /// \param data block data, raw bytes, references received message and is
+    /// valid during the call only
+    virtual void onBlock(const PeerId &from,
+                         CID cid,
+                         gsl::span<const uint8_t> data) = 0;
 
     /// Called on new request from the network
     /// \param from originating peer ID
@@ -54,6 +57,17 @@ namespace fc::storage::ipfs::graphsync {
                             RequestId request_id,
                             ResponseStatusCode status,
                             std::vector<Extension> extensions) = 0;
+
+    /// Called when pending responses to peer were written below limit, or
+    /// peer was closed, so paused responses can continue
+    /// \param peer peer ID
+    virtual void onResponseQueueDrained(const PeerId &peer) = 0;
+
+    /// Called after message with blocks is handled, applies backpressure
+    /// \param resume called on event loop when reading may continue
+    /// \return true if received blocks are buffered over limit and reading
+    /// should be paused until resume is called
+    virtual bool pauseReading(std::function<void()> resume) = 0;
   };
 
   /// PeerContext->Network feedback interface
@@ -99,6 +113,12 @@ namespace fc::storage::ipfs::graphsync {
   /// Max byte size of pending message queue
   constexpr size_t kMaxPendingBytes = 64 * 1024 * 1024;
 
+  /// Response blocks are coalesced into messages of about this byte size
+  constexpr size_t kResponseMessageTargetSize = 1024 * 1024;
+
+  /// Byte size of pending responses to peer at which selection is paused
+  constexpr size_t kMaxPeerResponseBytes = 4 * 1024 * 1024;
+
   /// Cleanup delay for PeerContext, msec
   constexpr unsigned kPeerCloseDelayMsec = 30000;
 
@@ -0,0 +1,36 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "network_shards.hpp"
+
+#include <cassert>
+
+#include <boost/functional/hash.hpp>
+
+namespace fc::storage::ipfs::graphsync {
+
+  NetworkShards::NetworkShards(std::shared_ptr<boost::asio::io_context> io,
+                               size_t threads)
+      : io_{std::move(io)},
+        pool_{std::max<size_t>(threads, 1)},
+        queued_{common::metrics::registry().gauge(
+            "fc_graphsync_shard_queued_messages",
+            "Graphsync messages queued on network shards")} {
+    assert(io_);
+    for (size_t i{0}; i < std::max<size_t>(threads, 1); ++i) {
+      shards_.emplace_back(pool_.get_executor());
+    }
+  }
+
+  NetworkShards::~NetworkShards() {
+    pool_.join();
+  }
+
+  size_t NetworkShards::shardOf(const PeerId &peer) const {
+    const auto &bytes{peer.toVector()};
+    return boost::hash_range(bytes.begin(), bytes.end()) % shards_.size();
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
@@ -0,0 +1,75 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_GRAPHSYNC_NETWORK_SHARDS_HPP
+#define CPP_FILECOIN_GRAPHSYNC_NETWORK_SHARDS_HPP
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include "common/metrics.hpp"
+#include "network_fwd.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  /**
+   * Worker threads for CPU bound per-peer work of network module, i.e.
+   * parsing of received messages. Each peer is pinned to one shard, shard is
+   * a strand on shared thread pool, so work of peer runs in order and
+   * results are posted back to event loop in the same order. Streams, peer
+   * contexts, local requests table and datastore stay on event loop, only
+   * results cross threads.
+   * Metrics:
+   *   fc_graphsync_shard_queued_messages - messages queued on shards.
+   */
+  class NetworkShards {
+   public:
+    /// \param io event loop of network module
+    /// \param threads worker threads, also number of shards
+    NetworkShards(std::shared_ptr<boost::asio::io_context> io,
+                  size_t threads);
+
+    /// Waits for queued work, its results are dropped with event loop
+    ~NetworkShards();
+
+    NetworkShards(const NetworkShards &) = delete;
+    NetworkShards &operator=(const NetworkShards &) = delete;
+
+    /// Returns shard of peer, the same for all its streams
+    size_t shardOf(const PeerId &peer) const;
+
+    /// Runs work on shard, then done with its result on event loop
+    /// \param shard shard index from shardOf
+    /// \param work called on worker thread
+    /// \param done called on event loop with result of work
+    template <typename Work, typename Done>
+    void offload(size_t shard, Work work, Done done) {
+      queued_.add(1);
+      boost::asio::post(
+          shards_.at(shard),
+          [this, work{std::move(work)}, done{std::move(done)}]() mutable {
+            queued_.add(-1);
+            boost::asio::post(
+                *io_,
+                [done{std::move(done)}, result{work()}]() mutable {
+                  done(std::move(result));
+                });
+          });
+    }
+
+   private:
+    using Strand = boost::asio::strand<boost::asio::thread_pool::executor_type>;
+
+    std::shared_ptr<boost::asio::io_context> io_;
+    boost::asio::thread_pool pool_;
+    std::vector<Strand> shards_;
+    common::metrics::Gauge &queued_;
+  };
+
+}  // namespace fc::storage::ipfs::graphsync
+
+#endif  // CPP_FILECOIN_GRAPHSYNC_NETWORK_SHARDS_HPP
@@ -10,6 +10,7 @@
 #include "inbound_endpoint.hpp"
 #include "message_queue.hpp"
 #include "message_reader.hpp"
+#include "network_shards.hpp"
 #include "outbound_endpoint.hpp"
 
 namespace fc::storage::ipfs::graphsync {
@@ -31,16 +32,22 @@ namespace fc::storage::ipfs::graphsync {
   PeerContext::PeerContext(PeerId peer_id,
                            PeerToGraphsyncFeedback &graphsync_feedback,
                            PeerToNetworkFeedback &network_feedback,
-                           libp2p::protocol::Scheduler &scheduler)
+                           libp2p::protocol::Scheduler &scheduler,
+                           std::shared_ptr<NetworkShards> shards)
       : peer(std::move(peer_id)),
         str(makeStringRepr(peer)),
         graphsync_feedback_(graphsync_feedback),
         network_feedback_(network_feedback),
-        scheduler_(scheduler) {}
+        scheduler_(scheduler),
+        shards_(std::move(shards)) {
+    if (shards_) {
+      shard_ = shards_->shardOf(peer);
+    }
+  }
 
   // Need to define it here due to unique_ptrs to incomplete types in the header
   PeerContext::~PeerContext() {
-    logger()->trace("~PeerContext, {}", str);
+    SPDLOG_LOGGER_TRACE(logger(), "~PeerContext, {}", str);
     // must be closed
     if (!closed_) {
       close(RS_INTERNAL_ERROR);
@@ -118,7 +125,8 @@ namespace fc::storage::ipfs::graphsync {
     }
 
     StreamCtx stream_ctx;
-    stream_ctx.reader = std::make_unique<MessageReader>(stream, *this);
+    stream_ctx.reader =
+        std::make_unique<MessageReader>(stream, *this, shards_, shard_);
 
     if (getState() == is_connecting) {
       assert(requests_endpoint_);
@@ -147,7 +155,7 @@ namespace fc::storage::ipfs::graphsync {
       return;
     }
     if (rstream) {
-      logger()->debug("connected to peer={}", str);
+      SPDLOG_LOGGER_DEBUG(logger(), "connected to peer={}", str);
       onNewStream(std::move(rstream.value()));
     } else {
       logger()->error(
@@ -197,7 +205,8 @@ namespace fc::storage::ipfs::graphsync {
       RequestId request_id) {
     auto r_iter = remote_requests_streams_.find(request_id);
     if (r_iter == remote_requests_streams_.end()) {
-      logger()->debug(
+      SPDLOG_LOGGER_DEBUG(
+          logger(),
           "findResponseSink: remote request {} is no longer actual, peer={}",
           request_id,
           str);
@@ -252,12 +261,27 @@ namespace fc::storage::ipfs::graphsync {
     }
   }
 
+  bool PeerContext::isResponseQueueFull() {
+    size_t bytes = 0;
+    for (auto &[stream, ctx] : streams_) {
+      if (ctx.queue) {
+        auto &state = ctx.queue->getState();
+        bytes += state.writing_bytes + state.pending_bytes;
+      }
+    }
+    response_queue_full_ = bytes >= kMaxPeerResponseBytes;
+    return response_queue_full_;
+  }
+
   void PeerContext::close(ResponseStatusCode status) {
     if (closed_) {
       return;
     }
 
-    logger()->debug("close peer={} status={}", str, statusCodeToString(status));
+    SPDLOG_LOGGER_DEBUG(logger(),
+                        "close peer={} status={}",
+                        str,
+                        statusCodeToString(status));
 
     close_status_ = status;
     closed_ = true;
@@ -286,7 +310,7 @@ namespace fc::storage::ipfs::graphsync {
       return;
     }
 
-    logger()->trace("closeStream: peer={}", str);
+    SPDLOG_LOGGER_TRACE(logger(), "closeStream: peer={}", str);
 
     for (auto id : it->second.remote_request_ids) {
       remote_requests_streams_.erase(id);
@@ -298,8 +322,9 @@ namespace fc::storage::ipfs::graphsync {
       closeLocalRequests(status);
     }
 
-    stream->close(
-        [stream](outcome::result<void>) { logger()->trace("stream closed"); });
+    stream->close([stream](outcome::result<void>) {
+      SPDLOG_LOGGER_TRACE(logger(), "stream closed");
+    });
   }
 
   void PeerContext::closeLocalRequests(ResponseStatusCode status) {
@@ -339,8 +364,10 @@ namespace fc::storage::ipfs::graphsync {
     if (request.cancel) {
       ctx.remote_request_ids.erase(request.id);
       remote_requests_streams_.erase(request.id);
-      logger()->debug(
-          "onRequest: peer {} cancelled request {}", str, request.id);
+      SPDLOG_LOGGER_DEBUG(logger(),
+                          "onRequest: peer {} cancelled request {}",
+                          str,
+                          request.id);
     } else {
       createResponseEndpoint(stream, ctx);
       if (remote_requests_streams_.count(request.id)) {
@@ -348,8 +375,10 @@ namespace fc::storage::ipfs::graphsync {
       } else {
         remote_requests_streams_.emplace(request.id, stream);
         ctx.remote_request_ids.insert(request.id);
-        logger()->debug(
-            "onRequest: peer {} created request {}", str, request.id);
+        SPDLOG_LOGGER_DEBUG(logger(),
+                            "onRequest: peer {} created request {}",
+                            str,
+                            request.id);
         graphsync_feedback_.onRemoteRequest(peer, std::move(request));
       }
     }
@@ -388,7 +417,8 @@ namespace fc::storage::ipfs::graphsync {
 
     Message &msg = msg_res.value();
 
-    logger()->trace(
+    SPDLOG_LOGGER_TRACE(
+        logger(),
         "message from peer={}, {} blocks, {} requests, {} responses",
         str,
         msg.data.size(),
@@ -413,14 +443,30 @@ namespace fc::storage::ipfs::graphsync {
     }
 
     for (auto &item : msg.data) {
-      graphsync_feedback_.onBlock(
-          peer, std::move(item.first), std::move(item.second));
+      graphsync_feedback_.onBlock(peer, std::move(item.first), item.second);
     }
 
     for (auto &item : msg.responses) {
       onResponse(item);
     }
 
+    auto &reader = it->second.reader;
+    if (!msg.data.empty() && reader) {
+      auto resume = [wptr{weak_from_this()}, stream] {
+        auto self = wptr.lock();
+        if (!self || self->closed_) {
+          return;
+        }
+        auto it = self->streams_.find(stream);
+        if (it != self->streams_.end() && it->second.reader) {
+          it->second.reader->resume();
+        }
+      };
+      if (graphsync_feedback_.pauseReading(std::move(resume))) {
+        reader->pause();
+      }
+    }
+
     shiftExpireTime(it->second);
   }
 
@@ -438,6 +484,10 @@ namespace fc::storage::ipfs::graphsync {
     }
 
     shiftExpireTime(stream);
+
+    if (response_queue_full_ && !isResponseQueueFull()) {
+      graphsync_feedback_.onResponseQueueDrained(peer);
+    }
   }
 
   void PeerContext::shiftExpireTime(PeerContext::StreamCtx &ctx) {
@@ -19,6 +19,7 @@ namespace fc::storage::ipfs::graphsync {
   class InboundEndpoint;
   class MessageReader;
   class MessageQueue;
+  class NetworkShards;
 
   /// Peer context, used by Network module to communicate wit individual peer,
   /// manages peer's streams and their logic
@@ -35,10 +36,12 @@ namespace fc::storage::ipfs::graphsync {
     /// \param graphsync_feedback feedback interface of core module
     /// \param network_feedback feedback interface of network module
     /// \param scheduler libp2p scheduler
+    /// \param shards worker shards to parse messages on, optional
     PeerContext(PeerId peer_id,
                 PeerToGraphsyncFeedback &graphsync_feedback,
                 PeerToNetworkFeedback &network_feedback,
-                libp2p::protocol::Scheduler &scheduler);
+                libp2p::protocol::Scheduler &scheduler,
+                std::shared_ptr<NetworkShards> shards = nullptr);
 
     /// Dtor.
     ~PeerContext() override;
@@ -105,6 +108,10 @@ namespace fc::storage::ipfs::graphsync {
                       ResponseStatusCode status,
                       const std::vector<Extension> &extensions);
 
+    /// Returns true if pending responses to peer reached byte limit, then
+    /// graphsync is notified when they are written below the limit
+    bool isResponseQueueFull();
+
     /// Closes all streams to/from this peer
     /// \param status close reason to be forwarded to local request callback,
     /// where RS_REJECTED_LOCALLY indicates that peer was closed by the owning
@@ -117,7 +124,8 @@ namespace fc::storage::ipfs::graphsync {
     /// can be accepted from the peer, we cannot limit other implementation in
     /// this options)
     struct StreamCtx {
-      /// Message reader, exists for each connected stream. Purely RAII object
+      /// Message reader, exists for each connected stream, paused on
+      /// backpressure
       std::unique_ptr<MessageReader> reader;
 
       /// Outgoing messages queue
@@ -209,6 +217,12 @@ namespace fc::storage::ipfs::graphsync {
     /// Scheduler
     Scheduler &scheduler_;
 
+    /// Worker shards, optional
+    std::shared_ptr<NetworkShards> shards_;
+
+    /// Shard this peer is pinned to
+    size_t shard_ = 0;
+
     /// Outbound address
     boost::optional<libp2p::multi::Multiaddress> connect_to_;
 
@@ -230,6 +244,9 @@ namespace fc::storage::ipfs::graphsync {
     /// Flag, indicates that peer is closed
     bool closed_ = false;
 
+    /// Flag, indicates that responses are paused until queues are drained
+    bool response_queue_full_ = false;
+
     /// Response status code stored to be forwarded asynchronously
     /// in the next cycle
     ResponseStatusCode close_status_ = RS_INTERNAL_ERROR;
@@ -0,0 +1,325 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/multi_peer_fetch.hpp"
+
+#include "storage/ipld/selector.hpp"
+#include "storage/ipld/walker.hpp"
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::ipfs::graphsync,
+                            MultiPeerFetchError,
+                            e) {
+  using E = fc::storage::ipfs::graphsync::MultiPeerFetchError;
+  switch (e) {
+    case E::NO_PEERS:
+      return "No peers to fetch dag from";
+    case E::ALL_PEERS_FAILED:
+      return "All peers failed to send block";
+  }
+  return "Unknown error";
+}
+
+namespace fc::storage::ipfs::graphsync {
+  using ipld::Selector;
+  using ipld::walker::Walker;
+
+  namespace {
+    common::Logger logger() {
+      static common::Logger logger = common::createLogger("graphsync_fetch");
+      return logger;
+    }
+  }  // namespace
+
+  MultiPeerFetch::MultiPeerFetch(
+      std::shared_ptr<Graphsync> graphsync,
+      std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+      IpldPtr ipld,
+      const CID &root,
+      std::vector<Peer> peers,
+      Callback callback,
+      unsigned straggler_msec)
+      : graphsync_{std::move(graphsync)},
+        scheduler_{std::move(scheduler)},
+        ipld_{std::move(ipld)},
+        root_{root},
+        callback_{std::move(callback)},
+        straggler_msec_{straggler_msec} {
+    peers_.reserve(peers.size());
+    for (auto &peer : peers) {
+      peers_.push_back({std::move(peer)});
+    }
+  }
+
+  void MultiPeerFetch::start() {
+    if (peers_.empty()) {
+      return finish(MultiPeerFetchError::NO_PEERS);
+    }
+    auto res{want(root_)};
+    if (!res) {
+      return finish(res.error());
+    }
+    if (wanted_.empty()) {
+      return finish(outcome::success());
+    }
+    queue_.push_back(root_);
+    dispatch();
+  }
+
+  void MultiPeerFetch::cancel() {
+    done_ = true;
+    tasks_.clear();
+    queue_.clear();
+    // received blocks are verified, keep them for next fetch
+    std::ignore = flush();
+  }
+
+  bool MultiPeerFetch::onBlock(const CID &cid, const common::Buffer &data) {
+    if (done_ || wanted_.count(cid) == 0) {
+      return false;
+    }
+    auto res{accept(cid, data)};
+    if (!res) {
+      finish(res.error());
+    }
+    return true;
+  }
+
+  double MultiPeerFetch::throughput(const PeerState &peer) const {
+    auto time{peer.busy_time};
+    if (peer.busy) {
+      time += Clock::now() - peer.busy_since;
+    }
+    auto seconds{std::chrono::duration<double>{time}.count()};
+    return peer.bytes == 0 ? 0 : peer.bytes / std::max(seconds, 1e-6);
+  }
+
+  outcome::result<void> MultiPeerFetch::want(const CID &cid,
+                                             boost::optional<size_t> owner) {
+    std::vector<CID> stack{cid};
+    while (!stack.empty()) {
+      auto next{std::move(stack.back())};
+      stack.pop_back();
+      if (received_.count(next) != 0 || wanted_.count(next) != 0) {
+        continue;
+      }
+      OUTCOME_TRY(stored, ipld_->contains(next));
+      if (!stored) {
+        if (owner) {
+          owners_[next] = *owner;
+        }
+        wanted_.insert(std::move(next));
+        continue;
+      }
+      OUTCOME_TRY(bytes, ipld_->get(next));
+      OUTCOME_TRY(links, Walker::links(next, bytes));
+      received_.insert(std::move(next));
+      stack.insert(stack.end(), links.begin(), links.end());
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> MultiPeerFetch::accept(const CID &cid,
+                                               const common::Buffer &data) {
+    // graphsync computes cid from received data, so block content is valid
+    OUTCOME_TRY(links, Walker::links(cid, data));
+    boost::optional<size_t> owner;
+    auto it{owners_.find(cid)};
+    if (it != owners_.end()) {
+      owner = it->second;
+      peers_[*owner].bytes += data.size();
+      owners_.erase(it);
+    }
+    wanted_.erase(cid);
+    received_.insert(cid);
+    batch_.emplace_back(cid, data);
+    for (auto &link : links) {
+      OUTCOME_TRY(want(link, owner));
+    }
+    if (batch_.size() >= kFetchBatchSize) {
+      OUTCOME_TRY(flush());
+    }
+    return outcome::success();
+  }
+
+  void MultiPeerFetch::dispatch() {
+    while (!done_ && (!queue_.empty() || migrateStraggler())) {
+      auto cid{queue_.front()};
+      if (wanted_.count(cid) == 0) {
+        queue_.pop_front();
+        continue;
+      }
+      auto &failed = failed_peers_[cid];
+      if (failed.size() >= peers_.size()) {
+        return finish(MultiPeerFetchError::ALL_PEERS_FAILED);
+      }
+      // fewest failures, then fastest, then first given
+      auto score = [&](size_t i) {
+        return std::make_pair(peers_[i].failures, -throughput(peers_[i]));
+      };
+      boost::optional<size_t> best;
+      for (size_t i = 0; i < peers_.size(); ++i) {
+        if (!peers_[i].busy && failed.count(i) == 0
+            && (!best || score(i) < score(*best))) {
+          best = i;
+        }
+      }
+      if (!best) {
+        // wait for requests to end
+        return;
+      }
+      queue_.pop_front();
+
+      auto task_id = next_task_id_++;
+      auto &peer = peers_[*best];
+      peer.busy = true;
+      peer.busy_since = Clock::now();
+      owners_[cid] = *best;
+      auto &task = tasks_[task_id];
+      task.cid = cid;
+      task.peer = *best;
+      task.timer = scheduler_->schedule(
+          kFetchRequestTimeoutMsec, [wptr{weak_from_this()}, task_id]() {
+            if (auto self = wptr.lock()) {
+              self->onTimeout(task_id);
+            }
+          });
+
+      // root alone, then subtrees of its links in parallel
+      auto selector{(cid == root_ ? Selector::matcher() : Selector{})
+                        .encode()
+                        .data()};
+      auto subscription = graphsync_->makeRequest(
+          peer.info.peer,
+          peer.info.address,
+          cid,
+          selector,
+          {},
+          [wptr{weak_from_this()}, task_id](ResponseStatusCode status,
+                                            std::vector<Extension>) {
+            if (auto self = wptr.lock()) {
+              self->onProgress(task_id, status);
+            }
+          });
+      auto it = tasks_.find(task_id);
+      if (it != tasks_.end()) {
+        it->second.subscription = std::move(subscription);
+      }
+    }
+  }
+
+  void MultiPeerFetch::onProgress(uint64_t task_id,
+                                  ResponseStatusCode status) {
+    auto it = tasks_.find(task_id);
+    if (it == tasks_.end()) {
+      return;
+    }
+    if (!isTerminal(status)) {
+      it->second.timer.reschedule(kFetchRequestTimeoutMsec);
+      return;
+    }
+    onTaskEnd(task_id, !isSuccess(status));
+  }
+
+  void MultiPeerFetch::onTimeout(uint64_t task_id) {
+    auto it = tasks_.find(task_id);
+    if (it == tasks_.end()) {
+      return;
+    }
+    SPDLOG_LOGGER_DEBUG(logger(),
+                        "request of {} timed out",
+                        it->second.cid.toString().value());
+    onTaskEnd(task_id, true);
+  }
+
+  void MultiPeerFetch::onTaskEnd(uint64_t task_id, bool failed) {
+    auto it = tasks_.find(task_id);
+    // request is cancelled when task is destroyed
+    auto task{std::move(it->second)};
+    tasks_.erase(it);
+
+    auto &peer = peers_[task.peer];
+    peer.busy = false;
+    peer.busy_time += Clock::now() - peer.busy_since;
+    if (wanted_.count(task.cid) != 0) {
+      failed = true;
+      failed_peers_[task.cid].insert(task.peer);
+      queue_.push_front(task.cid);
+    }
+    if (failed) {
+      ++peer.failures;
+    }
+
+    if (tasks_.empty() && queue_.empty()) {
+      auto res{flush()};
+      if (!res) {
+        return finish(res.error());
+      }
+      if (wanted_.empty()) {
+        return finish(outcome::success());
+      }
+      // blocks missing from ended subtrees
+      queue_.insert(queue_.end(), wanted_.begin(), wanted_.end());
+    }
+    dispatch();
+  }
+
+  bool MultiPeerFetch::migrateStraggler() {
+    boost::optional<size_t> idle;
+    for (size_t i = 0; i < peers_.size(); ++i) {
+      if (!peers_[i].busy && peers_[i].failures == 0
+          && (!idle || throughput(peers_[i]) > throughput(peers_[*idle]))) {
+        idle = i;
+      }
+    }
+    if (!idle || throughput(peers_[*idle]) == 0) {
+      return false;
+    }
+    auto now{Clock::now()};
+    auto min_time{std::chrono::milliseconds{straggler_msec_}};
+    for (auto it{tasks_.begin()}; it != tasks_.end(); ++it) {
+      auto straggler{it->second.peer};
+      auto &peer{peers_[straggler]};
+      if (now - peer.busy_since < min_time
+          || throughput(peer) * kFetchStragglerRatio
+                 >= throughput(peers_[*idle])) {
+        continue;
+      }
+      SPDLOG_LOGGER_DEBUG(logger(),
+                          "moving subtree of {} from slow peer",
+                          it->second.cid.toString().value());
+      for (auto &[cid, owner] : owners_) {
+        if (owner == straggler && wanted_.count(cid) != 0) {
+          failed_peers_[cid].insert(straggler);
+          queue_.push_back(cid);
+        }
+      }
+      // request is cancelled with its subscription
+      tasks_.erase(it);
+      peer.busy = false;
+      peer.busy_time += now - peer.busy_since;
+      return !queue_.empty();
+    }
+    return false;
+  }
+
+  outcome::result<void> MultiPeerFetch::flush() {
+    if (batch_.empty()) {
+      return outcome::success();
+    }
+    auto blocks{std::move(batch_)};
+    batch_.clear();
+    return ipld_->setMany(std::move(blocks));
+  }
+
+  void MultiPeerFetch::finish(outcome::result<void> result) {
+    if (done_) {
+      return;
+    }
+    cancel();
+    auto callback{std::move(callback_)};
+    callback(std::move(result));
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
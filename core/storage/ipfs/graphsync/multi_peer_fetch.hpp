@@ -0,0 +1,177 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_GRAPHSYNC_MULTI_PEER_FETCH_HPP
+#define CPP_FILECOIN_GRAPHSYNC_MULTI_PEER_FETCH_HPP
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <libp2p/protocol/common/scheduler.hpp>
+
+#include "storage/ipfs/datastore.hpp"
+#include "storage/ipfs/graphsync/graphsync.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  enum class MultiPeerFetchError {
+    NO_PEERS = 1,
+    ALL_PEERS_FAILED,
+  };
+
+  /// Maximum time without progress of request to peer, msec
+  constexpr unsigned kFetchRequestTimeoutMsec = 30000;
+
+  /// Number of received blocks written to datastore at once
+  constexpr size_t kFetchBatchSize = 64;
+
+  /// Time of request before its peer may be considered straggler, msec
+  constexpr unsigned kFetchStragglerMsec = 5000;
+
+  /// Idle peer this many times faster takes subtree of straggler
+  constexpr double kFetchStragglerRatio = 4;
+
+  /**
+   * Fetches one dag from several peers having it. Root block is requested
+   * alone, then subtrees of its links are requested from different peers.
+   * Only blocks linked from accepted blocks are accepted, so each block is
+   * stored once whichever peer sends it. Subtree of failed or slow peer is
+   * requested from other peer, blocks still missing after all requests are
+   * requested again as subtrees. Idle peers are chosen by throughput, so
+   * peers should be given in order of expected speed, e.g. query latency.
+   * When nothing is queued, missing blocks of subtree requested from much
+   * slower peer are moved to idle faster peer.
+   *
+   * Graphsync reports blocks to single callback given to Graphsync::start,
+   * owner forwards them to onBlock of active fetches.
+   */
+  class MultiPeerFetch : public std::enable_shared_from_this<MultiPeerFetch> {
+   public:
+    /// Peer having the dag
+    struct Peer {
+      libp2p::peer::PeerId peer;
+      boost::optional<libp2p::multi::Multiaddress> address;
+    };
+
+    /// Called once, when whole dag is stored or fetch failed
+    using Callback = std::function<void(outcome::result<void>)>;
+
+    MultiPeerFetch(std::shared_ptr<Graphsync> graphsync,
+                   std::shared_ptr<libp2p::protocol::Scheduler> scheduler,
+                   IpldPtr ipld,
+                   const CID &root,
+                   std::vector<Peer> peers,
+                   Callback callback,
+                   unsigned straggler_msec = kFetchStragglerMsec);
+
+    /// Starts requests, blocks already in datastore are not requested
+    void start();
+
+    /// Stops requests without calling callback
+    void cancel();
+
+    /// Accepts block of the dag
+    /// \param cid CID of the block
+    /// \param data data block, raw bytes
+    /// \return true if block belongs to the dag and was not received yet
+    bool onBlock(const CID &cid, const common::Buffer &data);
+
+   private:
+    using Scheduler = libp2p::protocol::Scheduler;
+    using Clock = std::chrono::steady_clock;
+
+    struct PeerState {
+      Peer info;
+      bool busy{false};
+      size_t failures{};
+      /// Bytes of blocks of subtrees requested from peer
+      uint64_t bytes{};
+      /// Time of ended requests
+      Clock::duration busy_time{};
+      /// Start of running request
+      Clock::time_point busy_since;
+    };
+
+    /// Request of subtree to peer
+    struct Task {
+      CID cid;
+      size_t peer{};
+      Subscription subscription;
+      Scheduler::Handle timer;
+    };
+
+    /// Bytes per second received from peer, zero before first block
+    double throughput(const PeerState &peer) const;
+
+    /**
+     * Marks cid as missing block, or visits stored block
+     * @param owner - peer which is expected to send missing blocks
+     */
+    outcome::result<void> want(const CID &cid,
+                               boost::optional<size_t> owner = boost::none);
+
+    /// Requeues missing blocks of slow peer, for idle faster peer
+    bool migrateStraggler();
+
+    /// Records block and wants its links
+    outcome::result<void> accept(const CID &cid, const common::Buffer &data);
+
+    /// Assigns queued subtrees to idle peers
+    void dispatch();
+
+    /// Request progress callback
+    void onProgress(uint64_t task_id, ResponseStatusCode status);
+
+    /// Request made no progress in time
+    void onTimeout(uint64_t task_id);
+
+    /// Frees peer of task, requeues its subtree if root was not received
+    void onTaskEnd(uint64_t task_id, bool failed);
+
+    /// Writes received blocks to datastore
+    outcome::result<void> flush();
+
+    void finish(outcome::result<void> result);
+
+    std::shared_ptr<Graphsync> graphsync_;
+    std::shared_ptr<Scheduler> scheduler_;
+    IpldPtr ipld_;
+    CID root_;
+    std::vector<PeerState> peers_;
+    Callback callback_;
+
+    /// Blocks linked from accepted blocks, not received yet
+    std::unordered_set<CID> wanted_;
+    std::unordered_set<CID> received_;
+
+    /// Subtrees waiting for idle peer
+    std::deque<CID> queue_;
+
+    /// Peers failed to send subtree
+    std::unordered_map<CID, std::set<size_t>> failed_peers_;
+
+    /// Peers requested subtrees of wanted blocks
+    std::unordered_map<CID, size_t> owners_;
+
+    unsigned straggler_msec_;
+
+    std::map<uint64_t, Task> tasks_;
+    uint64_t next_task_id_{};
+
+    /// Received blocks not written yet
+    IpfsDatastore::Blocks batch_;
+
+    bool done_{false};
+  };
+
+}  // namespace fc::storage::ipfs::graphsync
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipfs::graphsync, MultiPeerFetchError);
+
+#endif  // CPP_FILECOIN_GRAPHSYNC_MULTI_PEER_FETCH_HPP
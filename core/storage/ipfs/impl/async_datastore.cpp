@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/async_datastore.hpp"
+
+#include <boost/asio/post.hpp>
+
+namespace fc::storage::ipfs {
+
+  AsyncDatastore::AsyncDatastore(IpldPtr ipld,
+                                 std::shared_ptr<boost::asio::io_context> io,
+                                 size_t threads)
+      : ipld_{std::move(ipld)},
+        io_{std::move(io)},
+        pool_{threads},
+        writes_{pool_.get_executor()} {
+    BOOST_ASSERT_MSG(ipld_ != nullptr, "ipld argument is nullptr");
+    BOOST_ASSERT_MSG(io_ != nullptr, "io argument is nullptr");
+  }
+
+  AsyncDatastore::~AsyncDatastore() {
+    pool_.join();
+  }
+
+  template <typename Executor, typename F, typename T>
+  void AsyncDatastore::run(Executor &executor,
+                           F f,
+                           Callback<T> callback) const {
+    boost::asio::post(
+        executor,
+        [io{io_}, f{std::move(f)}, callback{std::move(callback)}]() mutable {
+          boost::asio::post(*io,
+                            [callback{std::move(callback)},
+                             result{f()}]() mutable {
+                              callback(std::move(result));
+                            });
+        });
+  }
+
+  void AsyncDatastore::contains(const CID &key,
+                                Callback<bool> callback) const {
+    run(pool_,
+        [ipld{ipld_}, key] { return ipld->contains(key); },
+        std::move(callback));
+  }
+
+  void AsyncDatastore::get(const CID &key, Callback<Value> callback) const {
+    run(pool_,
+        [ipld{ipld_}, key] { return ipld->get(key); },
+        std::move(callback));
+  }
+
+  void AsyncDatastore::getMany(std::vector<CID> keys,
+                               Callback<std::vector<Value>> callback) const {
+    run(pool_,
+        [ipld{ipld_}, keys{std::move(keys)}] { return ipld->getMany(keys); },
+        std::move(callback));
+  }
+
+  std::future<outcome::result<AsyncDatastore::Value>> AsyncDatastore::prefetch(
+      const CID &key) const {
+    auto promise{std::make_shared<std::promise<outcome::result<Value>>>()};
+    auto future{promise->get_future()};
+    boost::asio::post(pool_, [ipld{ipld_}, key, promise{std::move(promise)}] {
+      promise->set_value(ipld->get(key));
+    });
+    return future;
+  }
+
+  void AsyncDatastore::set(const CID &key,
+                           Value value,
+                           Callback<void> callback) {
+    run(writes_,
+        [ipld{ipld_}, key, value{std::move(value)}]() mutable {
+          return ipld->set(key, std::move(value));
+        },
+        std::move(callback));
+  }
+
+  void AsyncDatastore::setMany(Blocks blocks, Callback<void> callback) {
+    run(writes_,
+        [ipld{ipld_}, blocks{std::move(blocks)}]() mutable {
+          return ipld->setMany(std::move(blocks));
+        },
+        std::move(callback));
+  }
+
+  void AsyncDatastore::remove(const CID &key, Callback<void> callback) {
+    run(writes_,
+        [ipld{ipld_}, key] { return ipld->remove(key); },
+        std::move(callback));
+  }
+
+  const IpldPtr &AsyncDatastore::ipld() const {
+    return ipld_;
+  }
+
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,83 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_ASYNC_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_ASYNC_DATASTORE_HPP
+
+#include <future>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @class AsyncDatastore runs datastore operations on dedicated I/O pool and
+   * reports results on event loop, so network and api threads don't block on
+   * disk. Reads run in parallel, writes run one by one in order of calls.
+   */
+  class AsyncDatastore {
+   public:
+    using Value = IpfsDatastore::Value;
+    using Blocks = IpfsDatastore::Blocks;
+    /// Called on event loop with result of operation
+    template <typename T>
+    using Callback = std::function<void(outcome::result<T>)>;
+
+    /// Default number of I/O threads
+    static constexpr size_t kDefaultThreads{4};
+
+    /**
+     * @param ipld datastore, used from I/O threads
+     * @param io event loop for callbacks
+     * @param threads number of I/O threads
+     */
+    AsyncDatastore(IpldPtr ipld,
+                   std::shared_ptr<boost::asio::io_context> io,
+                   size_t threads = kDefaultThreads);
+
+    /// Waits for started operations, their callbacks are still posted
+    ~AsyncDatastore();
+
+    void contains(const CID &key, Callback<bool> callback) const;
+
+    void get(const CID &key, Callback<Value> callback) const;
+
+    /// Values in order of keys, fails if any key is missing
+    void getMany(std::vector<CID> keys,
+                 Callback<std::vector<Value>> callback) const;
+
+    /**
+     * Starts read on I/O pool for caller waiting on its result, e.g. read
+     * ahead of traversal which can't return to event loop between blocks
+     */
+    std::future<outcome::result<Value>> prefetch(const CID &key) const;
+
+    void set(const CID &key, Value value, Callback<void> callback);
+
+    void setMany(Blocks blocks, Callback<void> callback);
+
+    void remove(const CID &key, Callback<void> callback);
+
+    /// Underlying datastore for synchronous access
+    const IpldPtr &ipld() const;
+
+   private:
+    /// Runs f on executor and posts its result to callback
+    template <typename Executor, typename F, typename T>
+    void run(Executor &executor, F f, Callback<T> callback) const;
+
+    IpldPtr ipld_;
+    std::shared_ptr<boost::asio::io_context> io_;
+    mutable boost::asio::thread_pool pool_;
+    boost::asio::strand<boost::asio::thread_pool::executor_type> writes_;
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_ASYNC_DATASTORE_HPP
@@ -0,0 +1,157 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/cached_datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  CachedDatastore::Options CachedDatastore::Options::load(
+      config::Config &config) {
+    Options options;
+    auto capacity = config.get<size_t>("ipfs.cache.capacity");
+    if (capacity) {
+      options.capacity = capacity.value();
+    }
+    auto shards = config.get<size_t>("ipfs.cache.shards");
+    if (shards && shards.value() != 0) {
+      options.shards = shards.value();
+    }
+    return options;
+  }
+
+  CachedDatastore::CachedDatastore(std::shared_ptr<IpfsDatastore> store,
+                                   Options options)
+      : store_{std::move(store)} {
+    BOOST_ASSERT_MSG(store_ != nullptr, "store argument is nullptr");
+    BOOST_ASSERT_MSG(options.shards != 0, "shards count is zero");
+    shard_capacity_ = options.capacity / options.shards;
+    shards_.reserve(options.shards);
+    for (size_t i = 0; i < options.shards; ++i) {
+      shards_.push_back(std::make_unique<Shard>());
+    }
+  }
+
+  outcome::result<bool> CachedDatastore::contains(const CID &key) const {
+    {
+      auto &shard = this->shard(key);
+      std::lock_guard lock{shard.mutex};
+      if (shard.index.count(key) != 0) {
+        return true;
+      }
+    }
+    return store_->contains(key);
+  }
+
+  outcome::result<void> CachedDatastore::set(const CID &key, Value value) {
+    OUTCOME_TRY(store_->set(key, value));
+    insert(key, std::move(value));
+    return outcome::success();
+  }
+
+  outcome::result<void> CachedDatastore::setMany(Blocks blocks) {
+    OUTCOME_TRY(store_->setMany(blocks));
+    for (auto &block : blocks) {
+      insert(block.first, std::move(block.second));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<CachedDatastore::Value> CachedDatastore::get(
+      const CID &key) const {
+    if (auto value = lookup(key)) {
+      ++hits_;
+      return std::move(*value);
+    }
+    ++misses_;
+    OUTCOME_TRY(value, store_->get(key));
+    insert(key, value);
+    return std::move(value);
+  }
+
+  outcome::result<void> CachedDatastore::remove(const CID &key) {
+    erase(key);
+    return store_->remove(key);
+  }
+
+  CacheStats CachedDatastore::stats() const {
+    CacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    for (auto &shard : shards_) {
+      std::lock_guard lock{shard->mutex};
+      stats.entries += shard->index.size();
+      stats.bytes += shard->bytes;
+    }
+    return stats;
+  }
+
+  size_t CachedDatastore::shrink(size_t bytes) {
+    auto per_shard{(bytes + shards_.size() - 1) / shards_.size()};
+    size_t evicted{};
+    for (auto &shard : shards_) {
+      std::lock_guard lock{shard->mutex};
+      size_t shard_evicted{};
+      while (shard_evicted < per_shard && !shard->lru.empty()) {
+        auto &last = shard->lru.back();
+        shard_evicted += last.second.size();
+        shard->bytes -= last.second.size();
+        shard->index.erase(last.first);
+        shard->lru.pop_back();
+      }
+      evicted += shard_evicted;
+    }
+    return evicted;
+  }
+
+  CachedDatastore::Shard &CachedDatastore::shard(const CID &key) const {
+    return *shards_[std::hash<CID>{}(key) % shards_.size()];
+  }
+
+  boost::optional<CachedDatastore::Value> CachedDatastore::lookup(
+      const CID &key) const {
+    auto &shard = this->shard(key);
+    std::lock_guard lock{shard.mutex};
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+      return boost::none;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return it->second->second;
+  }
+
+  void CachedDatastore::erase(const CID &key) const {
+    auto &shard = this->shard(key);
+    std::lock_guard lock{shard.mutex};
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      shard.bytes -= it->second->second.size();
+      shard.lru.erase(it->second);
+      shard.index.erase(it);
+    }
+  }
+
+  void CachedDatastore::insert(const CID &key, Value value) const {
+    if (value.size() > shard_capacity_) {
+      return;
+    }
+    auto &shard = this->shard(key);
+    std::lock_guard lock{shard.mutex};
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      return;
+    }
+    shard.bytes += value.size();
+    shard.lru.emplace_front(key, std::move(value));
+    shard.index.emplace(key, shard.lru.begin());
+    while (shard.bytes > shard_capacity_) {
+      auto &last = shard.lru.back();
+      shard.bytes -= last.second.size();
+      shard.index.erase(last.first);
+      shard.lru.pop_back();
+    }
+  }
+
+}  // namespace fc::storage::ipfs
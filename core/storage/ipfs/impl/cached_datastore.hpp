@@ -0,0 +1,111 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_CACHED_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_CACHED_DATASTORE_HPP
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+#include "storage/config/config.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  /// Cache hit/miss counters and occupancy
+  struct CacheStats {
+    uint64_t hits{};
+    uint64_t misses{};
+    uint64_t entries{};
+    uint64_t bytes{};
+  };
+
+  /**
+   * @class CachedDatastore IpfsDatastore decorator keeping recently used
+   * blocks in memory. Blocks are content-addressed and never change, so
+   * cached entries are only dropped by eviction or remove.
+   * Cache is split into independently locked LRU shards.
+   */
+  class CachedDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<CachedDatastore> {
+   public:
+    struct Options {
+      /// Total size of cached values in bytes
+      size_t capacity{256 << 20};
+      /// Number of independently locked shards
+      size_t shards{16};
+
+      /**
+       * @brief reads "ipfs.cache.capacity" and "ipfs.cache.shards" keys,
+       * missing keys keep default values
+       * @param config node configuration
+       */
+      static Options load(config::Config &config);
+    };
+
+    CachedDatastore(std::shared_ptr<IpfsDatastore> store, Options options);
+
+    ~CachedDatastore() override = default;
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    /// Get cache counters
+    CacheStats stats() const;
+
+    /**
+     * Evicts least recently used values of every shard, for memory
+     * governor
+     * @param bytes - total size to evict, spread evenly over shards
+     * @return evicted bytes
+     */
+    size_t shrink(size_t bytes);
+
+   private:
+    using Lru = std::list<std::pair<CID, Value>>;
+
+    struct Shard {
+      std::mutex mutex;
+      Lru lru;
+      std::unordered_map<CID, Lru::iterator> index;
+      size_t bytes{};
+    };
+
+    Shard &shard(const CID &key) const;
+
+    /// Find value and mark it as recently used
+    boost::optional<Value> lookup(const CID &key) const;
+
+    /// Insert value and evict least recently used values over capacity
+    void insert(const CID &key, Value value) const;
+
+    void erase(const CID &key) const;
+
+    std::shared_ptr<IpfsDatastore> store_;
+    size_t shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    mutable std::atomic_uint64_t hits_{0};
+    mutable std::atomic_uint64_t misses_{0};
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_CACHED_DATASTORE_HPP
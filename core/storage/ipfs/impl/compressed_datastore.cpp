@@ -0,0 +1,195 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/compressed_datastore.hpp"
+
+#include <zdict.h>
+#include <zstd.h>
+#include <algorithm>
+#include <array>
+
+namespace fc::storage::ipfs {
+  namespace {
+    /// First bytes of zstd frame, little-endian ZSTD_MAGICNUMBER
+    constexpr std::array<uint8_t, 4> kMagic{0x28, 0xB5, 0x2F, 0xFD};
+
+    bool isFrame(const Buffer &value) {
+      return value.size() >= kMagic.size()
+             && std::equal(kMagic.begin(), kMagic.end(), value.begin());
+    }
+
+    /// Contexts and scratch of thread, reused between blocks
+    struct Contexts {
+      Contexts() : cctx{ZSTD_createCCtx()}, dctx{ZSTD_createDCtx()} {}
+
+      ~Contexts() {
+        ZSTD_freeCCtx(cctx);
+        ZSTD_freeDCtx(dctx);
+      }
+
+      Contexts(const Contexts &) = delete;
+      Contexts &operator=(const Contexts &) = delete;
+
+      ZSTD_CCtx *cctx;
+      ZSTD_DCtx *dctx;
+      std::vector<uint8_t> scratch;
+    };
+
+    Contexts &contexts() {
+      thread_local Contexts contexts;
+      return contexts;
+    }
+  }  // namespace
+
+  outcome::result<Buffer> CompressedDatastore::trainDictionary(
+      const std::vector<Buffer> &samples, size_t max_bytes) {
+    std::vector<uint8_t> joined;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (auto &sample : samples) {
+      joined.insert(joined.end(), sample.begin(), sample.end());
+      sizes.push_back(sample.size());
+    }
+    Buffer dictionary;
+    dictionary.resize(max_bytes);
+    auto size{ZDICT_trainFromBuffer(dictionary.data(),
+                                    dictionary.size(),
+                                    joined.data(),
+                                    sizes.data(),
+                                    static_cast<unsigned>(sizes.size()))};
+    if (ZDICT_isError(size)) {
+      return CompressedDatastoreError::TRAIN_FAILED;
+    }
+    dictionary.resize(size);
+    return std::move(dictionary);
+  }
+
+  CompressedDatastore::CompressedDatastore(
+      std::shared_ptr<IpfsDatastore> store, Options options)
+      : store_{std::move(store)}, options_{std::move(options)} {
+    BOOST_ASSERT_MSG(store_ != nullptr, "store argument is nullptr");
+    if (!options_.dictionary.empty()) {
+      auto &dictionary{options_.dictionary};
+      cdict_ = ZSTD_createCDict(
+          dictionary.data(), dictionary.size(), options_.level);
+      ddict_ = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    }
+  }
+
+  CompressedDatastore::~CompressedDatastore() {
+    ZSTD_freeCDict(cdict_);
+    ZSTD_freeDDict(ddict_);
+  }
+
+  outcome::result<bool> CompressedDatastore::contains(const CID &key) const {
+    return store_->contains(key);
+  }
+
+  outcome::result<void> CompressedDatastore::set(const CID &key,
+                                                 Value value) {
+    OUTCOME_TRY(stored, compress(std::move(value)));
+    return store_->set(key, std::move(stored));
+  }
+
+  outcome::result<void> CompressedDatastore::setMany(Blocks blocks) {
+    for (auto &block : blocks) {
+      OUTCOME_TRYA(block.second, compress(std::move(block.second)));
+    }
+    return store_->setMany(std::move(blocks));
+  }
+
+  outcome::result<CompressedDatastore::Value> CompressedDatastore::get(
+      const CID &key) const {
+    OUTCOME_TRY(stored, store_->get(key));
+    return decompress(std::move(stored));
+  }
+
+  outcome::result<std::vector<CompressedDatastore::Value>>
+  CompressedDatastore::getMany(gsl::span<const CID> keys) const {
+    OUTCOME_TRY(values, store_->getMany(keys));
+    for (auto &value : values) {
+      OUTCOME_TRYA(value, decompress(std::move(value)));
+    }
+    return std::move(values);
+  }
+
+  outcome::result<void> CompressedDatastore::remove(const CID &key) {
+    return store_->remove(key);
+  }
+
+  outcome::result<CompressedDatastore::Value> CompressedDatastore::compress(
+      Value value) const {
+    // raw block looking like frame is compressed to stay unambiguous
+    if (value.size() < options_.min_bytes && !isFrame(value)) {
+      return std::move(value);
+    }
+    auto &ctx{contexts()};
+    ctx.scratch.resize(ZSTD_compressBound(value.size()));
+    auto size{cdict_ ? ZSTD_compress_usingCDict(ctx.cctx,
+                                                ctx.scratch.data(),
+                                                ctx.scratch.size(),
+                                                value.data(),
+                                                value.size(),
+                                                cdict_)
+                     : ZSTD_compressCCtx(ctx.cctx,
+                                         ctx.scratch.data(),
+                                         ctx.scratch.size(),
+                                         value.data(),
+                                         value.size(),
+                                         options_.level)};
+    if (ZSTD_isError(size)) {
+      return CompressedDatastoreError::COMPRESS_FAILED;
+    }
+    if (size >= value.size() && !isFrame(value)) {
+      return std::move(value);
+    }
+    return Value{gsl::make_span(ctx.scratch.data(), size)};
+  }
+
+  outcome::result<CompressedDatastore::Value> CompressedDatastore::decompress(
+      Value value) const {
+    if (!isFrame(value)) {
+      return std::move(value);
+    }
+    auto content{ZSTD_getFrameContentSize(value.data(), value.size())};
+    if (content == ZSTD_CONTENTSIZE_ERROR
+        || content == ZSTD_CONTENTSIZE_UNKNOWN) {
+      return CompressedDatastoreError::DECOMPRESS_FAILED;
+    }
+    // frame records content size, so block is decompressed in one pass
+    // into buffer of exact size
+    Value block;
+    block.resize(content);
+    auto &ctx{contexts()};
+    auto size{ddict_ ? ZSTD_decompress_usingDDict(ctx.dctx,
+                                                  block.data(),
+                                                  block.size(),
+                                                  value.data(),
+                                                  value.size(),
+                                                  ddict_)
+                     : ZSTD_decompressDCtx(ctx.dctx,
+                                           block.data(),
+                                           block.size(),
+                                           value.data(),
+                                           value.size())};
+    if (ZSTD_isError(size) || size != content) {
+      return CompressedDatastoreError::DECOMPRESS_FAILED;
+    }
+    return std::move(block);
+  }
+}  // namespace fc::storage::ipfs
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::ipfs, CompressedDatastoreError, e) {
+  using fc::storage::ipfs::CompressedDatastoreError;
+  switch (e) {
+    case CompressedDatastoreError::COMPRESS_FAILED:
+      return "CompressedDatastoreError: zstd compression failed";
+    case CompressedDatastoreError::DECOMPRESS_FAILED:
+      return "CompressedDatastoreError: stored block is corrupted";
+    case CompressedDatastoreError::TRAIN_FAILED:
+      return "CompressedDatastoreError: dictionary training failed";
+  }
+  return "CompressedDatastoreError: unknown error";
+}
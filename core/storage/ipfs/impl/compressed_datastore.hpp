@@ -0,0 +1,90 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_COMPRESSED_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_COMPRESSED_DATASTORE_HPP
+
+#include "storage/ipfs/datastore.hpp"
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace fc::storage::ipfs {
+
+  enum class CompressedDatastoreError {
+    COMPRESS_FAILED = 1,
+    DECOMPRESS_FAILED,
+    TRAIN_FAILED,
+  };
+
+  /**
+   * @class CompressedDatastore IpfsDatastore decorator compressing blocks
+   * with zstd, optionally with dictionary trained on dag-cbor blocks of
+   * namespace, small cbor nodes share their structure with dictionary
+   * instead of compressing alone. Values are stored as zstd frames only if
+   * smaller, so raw blocks written before compression was enabled stay
+   * readable. Compression contexts and scratch buffers are per thread and
+   * reused between blocks.
+   */
+  class CompressedDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<CompressedDatastore> {
+   public:
+    struct Options {
+      /// zstd compression level
+      int level{3};
+      /// Blocks smaller than this are stored raw
+      size_t min_bytes{64};
+      /// Trained dictionary, empty for none
+      Buffer dictionary;
+    };
+
+    /**
+     * @brief trains dictionary on sample blocks of namespace
+     * @param samples blocks, e.g. recent state nodes
+     * @param max_bytes dictionary size limit
+     */
+    static outcome::result<Buffer> trainDictionary(
+        const std::vector<Buffer> &samples, size_t max_bytes = 112 << 10);
+
+    CompressedDatastore(std::shared_ptr<IpfsDatastore> store,
+                        Options options);
+
+    ~CompressedDatastore() override;
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    outcome::result<std::vector<Value>> getMany(
+        gsl::span<const CID> keys) const override;
+
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    /// Stored form of block
+    outcome::result<Value> compress(Value value) const;
+
+    /// Block of stored form
+    outcome::result<Value> decompress(Value value) const;
+
+   private:
+    std::shared_ptr<IpfsDatastore> store_;
+    Options options_;
+    ZSTD_CDict_s *cdict_{};
+    ZSTD_DDict_s *ddict_{};
+  };
+}  // namespace fc::storage::ipfs
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipfs, CompressedDatastoreError);
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_COMPRESSED_DATASTORE_HPP
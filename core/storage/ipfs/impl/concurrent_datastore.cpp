@@ -0,0 +1,49 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/concurrent_datastore.hpp"
+
+#include "storage/in_memory/concurrent_storage.hpp"
+
+namespace fc::storage::ipfs {
+
+  ConcurrentDatastore::ConcurrentDatastore(size_t max_bytes)
+      : map_{max_bytes} {}
+
+  outcome::result<bool> ConcurrentDatastore::contains(const CID &key) const {
+    return map_.contains(key);
+  }
+
+  outcome::result<void> ConcurrentDatastore::set(const CID &key,
+                                                 Value value) {
+    auto bytes{value.size()};
+    if (!map_.put(key, std::move(value), bytes)) {
+      return ConcurrentStorageError::MEMORY_CAP_EXCEEDED;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<ConcurrentDatastore::Value> ConcurrentDatastore::get(
+      const CID &key) const {
+    if (auto value{map_.get(key)}) {
+      return *value;
+    }
+    return IpfsDatastoreError::NOT_FOUND;
+  }
+
+  outcome::result<void> ConcurrentDatastore::remove(const CID &key) {
+    map_.remove(key);
+    return outcome::success();
+  }
+
+  ConcurrentDatastore::Map::Snapshot ConcurrentDatastore::snapshot() const {
+    return map_.snapshot();
+  }
+
+  size_t ConcurrentDatastore::bytes() const {
+    return map_.bytes();
+  }
+
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,55 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_CONCURRENT_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_CONCURRENT_DATASTORE_HPP
+
+#include "storage/in_memory/sharded_map.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @class ConcurrentDatastore in-memory datastore which may be shared by
+   * threads without global lock, e.g. by parallel interpreters and graphsync
+   * sessions of devnet
+   */
+  class ConcurrentDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<ConcurrentDatastore> {
+   public:
+    using Map = ShardedMap<CID, Value>;
+
+    /// @param max_bytes cap of total size of values, zero is unlimited
+    explicit ConcurrentDatastore(size_t max_bytes = 0);
+
+    ~ConcurrentDatastore() override = default;
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    /// Fails with MEMORY_CAP_EXCEEDED if value doesn't fit
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    /// Consistent copy of all blocks, values are shared, not copied
+    Map::Snapshot snapshot() const;
+
+    /// Total size of values
+    size_t bytes() const;
+
+   private:
+    Map map_;
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_CONCURRENT_DATASTORE_HPP
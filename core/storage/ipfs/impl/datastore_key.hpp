@@ -0,0 +1,42 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_DATASTORE_KEY_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_DATASTORE_KEY_HPP
+
+#include "common/buffer.hpp"
+#include "primitives/cid/cb_cid.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @brief convenience function to encode value
+   * @param value key value to encode
+   * @return encoded value as Buffer
+   */
+  inline outcome::result<common::Buffer> encodeKey(const CID &value) {
+    OUTCOME_TRY(encoded, value.toBytes());
+    return common::Buffer(std::move(encoded));
+  }
+
+  /**
+   * @brief calls f with encoded key, common CIDs are encoded on stack
+   * @param key key value to encode
+   * @param f function of BufferView
+   */
+  template <typename F>
+  inline auto withKey(const CID &key, const F &f)
+      -> decltype(f(common::BufferView{})) {
+    if (auto compact{CbCid::make(key)}) {
+      auto bytes{compact->toBytes()};
+      return f(common::BufferView{bytes});
+    }
+    OUTCOME_TRY(encoded, key.toBytes());
+    return f(common::BufferView{encoded});
+  }
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_DATASTORE_KEY_HPP
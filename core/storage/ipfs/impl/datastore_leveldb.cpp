@@ -5,18 +5,33 @@
 
 #include "storage/ipfs/impl/datastore_leveldb.hpp"
 
+#include "common/metrics.hpp"
+#include "storage/ipfs/impl/datastore_key.hpp"
 #include "storage/leveldb/leveldb_error.hpp"
 
 namespace fc::storage::ipfs {
+  using common::BufferView;
+  using common::LatencyHistogram;
+  using common::metrics::Counter;
+  using common::metrics::registry;
+  using common::metrics::Timer;
+
   namespace {
-    /**
-     * @brief convenience function to encode value
-     * @param value key value to encode
-     * @return encoded value as Buffer
-     */
-    inline outcome::result<common::Buffer> encodeKey(const CID &value) {
-      OUTCOME_TRY(encoded, value.toBytes());
-      return common::Buffer(std::move(encoded));
+    /// Metrics shared by leveldb datastores
+    struct Metrics {
+      LatencyHistogram &get_time{registry().histogram(
+          "fc_datastore_get_seconds", "Time of leveldb datastore get")};
+      LatencyHistogram &set_time{registry().histogram(
+          "fc_datastore_set_seconds", "Time of leveldb datastore set")};
+      Counter &get_bytes{registry().counter(
+          "fc_datastore_get_bytes_total", "Bytes read by datastore get")};
+      Counter &set_bytes{registry().counter(
+          "fc_datastore_set_bytes_total", "Bytes written by datastore set")};
+    };
+
+    Metrics &metrics() {
+      static Metrics metrics;
+      return metrics;
     }
   }  // namespace
 
@@ -32,29 +47,64 @@ namespace fc::storage::ipfs {
     return std::make_shared<LeveldbDatastore>(std::move(leveldb));
   }
 
+  outcome::result<std::shared_ptr<LeveldbDatastore>> LeveldbDatastore::create(
+      std::string_view leveldb_directory,
+      const config::LeveldbProfile &profile) {
+    OUTCOME_TRY(leveldb, LevelDB::create(leveldb_directory, profile));
+    return std::make_shared<LeveldbDatastore>(std::move(leveldb));
+  }
+
   outcome::result<bool> LeveldbDatastore::contains(const CID &key) const {
-    OUTCOME_TRY(encoded_key, encodeKey(key));
-    return leveldb_->contains(encoded_key);
+    return withKey(key,
+                   [&](BufferView encoded_key) -> outcome::result<bool> {
+                     return leveldb_->contains(encoded_key);
+                   });
   }
 
   outcome::result<void> LeveldbDatastore::set(const CID &key, Value value) {
     // TODO(turuslan): FIL-117 maybe check value hash matches cid
-    OUTCOME_TRY(encoded_key, encodeKey(key));
-    return leveldb_->put(encoded_key, common::Buffer(std::move(value)));
+    Timer timer{metrics().set_time};
+    metrics().set_bytes.add(value.size());
+    return withKey(key, [&](BufferView encoded_key) {
+      return leveldb_->put(encoded_key, BufferView{value});
+    });
+  }
+
+  outcome::result<void> LeveldbDatastore::setMany(Blocks blocks) {
+    Timer timer{metrics().set_time};
+    auto batch = leveldb_->batch();
+    for (auto &block : blocks) {
+      metrics().set_bytes.add(block.second.size());
+      OUTCOME_TRY(encoded_key, encodeKey(block.first));
+      OUTCOME_TRY(batch->put(encoded_key, std::move(block.second)));
+    }
+    return batch->commit();
   }
 
   outcome::result<LeveldbDatastore::Value> LeveldbDatastore::get(
       const CID &key) const {
-    OUTCOME_TRY(encoded_key, encodeKey(key));
-    auto res = leveldb_->get(encoded_key);
-    if (res.has_error() && res.error() == fc::storage::LevelDBError::NOT_FOUND)
-      return fc::storage::ipfs::IpfsDatastoreError::NOT_FOUND;
-    return res;
+    Timer timer{metrics().get_time};
+    return withKey(
+        key, [&](BufferView encoded_key) -> outcome::result<Value> {
+          auto res = leveldb_->get(encoded_key);
+          if (res.has_error()
+              && res.error() == fc::storage::LevelDBError::NOT_FOUND)
+            return fc::storage::ipfs::IpfsDatastoreError::NOT_FOUND;
+          if (res) {
+            metrics().get_bytes.add(res.value().size());
+          }
+          return res;
+        });
   }
 
   outcome::result<void> LeveldbDatastore::remove(const CID &key) {
-    OUTCOME_TRY(encoded_key, encodeKey(key));
-    return leveldb_->remove(encoded_key);
+    return withKey(key, [&](BufferView encoded_key) {
+      return leveldb_->remove(encoded_key);
+    });
+  }
+
+  std::unique_ptr<BufferMapCursor> LeveldbDatastore::cursor() const {
+    return leveldb_->cursor();
   }
 
 }  // namespace fc::storage::ipfs
@@ -39,14 +39,30 @@ namespace fc::storage::ipfs {
     static outcome::result<std::shared_ptr<LeveldbDatastore>> create(
         std::string_view leveldb_directory, leveldb::Options options);
 
+    /**
+     * @brief creates LeveldbDatastore instance tuned by profile
+     * @param leveldb_directory path to leveldb directory
+     * @param profile cache, bloom filter and buffer sizes
+     * @return shared pointer to instance
+     */
+    static outcome::result<std::shared_ptr<LeveldbDatastore>> create(
+        std::string_view leveldb_directory,
+        const config::LeveldbProfile &profile);
+
     outcome::result<bool> contains(const CID &key) const override;
 
     outcome::result<void> set(const CID &key, Value value) override;
 
     outcome::result<Value> get(const CID &key) const override;
 
+    /// Writes all blocks with single LevelDB write batch
+    outcome::result<void> setMany(Blocks blocks) override;
+
     outcome::result<void> remove(const CID &key) override;
 
+    /// Cursor over encoded keys and values, e.g. to load key filter
+    std::unique_ptr<BufferMapCursor> cursor() const;
+
     IpldPtr shared() override {
       return shared_from_this();
     }
@@ -0,0 +1,134 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/filtered_datastore.hpp"
+
+#include "storage/ipfs/impl/datastore_key.hpp"
+
+namespace fc::storage::ipfs {
+  using common::BufferView;
+  using common::CuckooFilter;
+
+  FilteredDatastore::Options FilteredDatastore::Options::load(
+      config::Config &config) {
+    Options options;
+    auto capacity = config.get<size_t>("ipfs.filter.capacity");
+    if (capacity) {
+      options.capacity = capacity.value();
+    }
+    return options;
+  }
+
+  FilteredDatastore::FilteredDatastore(std::shared_ptr<IpfsDatastore> store,
+                                       Options options)
+      : store_{std::move(store)}, filter_{options.capacity} {
+    BOOST_ASSERT_MSG(store_ != nullptr, "store argument is nullptr");
+  }
+
+  void FilteredDatastore::load(BufferMapCursor &cursor) {
+    std::unique_lock lock{mutex_};
+    for (cursor.seekToFirst(); cursor.isValid(); cursor.next()) {
+      add(CuckooFilter::hash(cursor.key()));
+      if (saturated_) {
+        break;
+      }
+    }
+    loaded_ = true;
+  }
+
+  outcome::result<bool> FilteredDatastore::contains(const CID &key) const {
+    if (!mayContain(key)) {
+      return false;
+    }
+    OUTCOME_TRY(found, store_->contains(key));
+    if (!found) {
+      ++false_positives_;
+    }
+    return found;
+  }
+
+  outcome::result<void> FilteredDatastore::set(const CID &key, Value value) {
+    OUTCOME_TRY(hash, FilteredDatastore::hash(key));
+    // added before write, so concurrent lookup never misses written key
+    {
+      std::unique_lock lock{mutex_};
+      add(hash);
+    }
+    return store_->set(key, std::move(value));
+  }
+
+  outcome::result<void> FilteredDatastore::setMany(Blocks blocks) {
+    std::vector<uint64_t> hashes;
+    hashes.reserve(blocks.size());
+    for (auto &block : blocks) {
+      OUTCOME_TRY(hash, FilteredDatastore::hash(block.first));
+      hashes.push_back(hash);
+    }
+    {
+      std::unique_lock lock{mutex_};
+      for (auto hash : hashes) {
+        add(hash);
+      }
+    }
+    return store_->setMany(std::move(blocks));
+  }
+
+  outcome::result<FilteredDatastore::Value> FilteredDatastore::get(
+      const CID &key) const {
+    if (!mayContain(key)) {
+      return IpfsDatastoreError::NOT_FOUND;
+    }
+    auto value = store_->get(key);
+    if (!value && value.error() == IpfsDatastoreError::NOT_FOUND) {
+      ++false_positives_;
+    }
+    return value;
+  }
+
+  outcome::result<void> FilteredDatastore::remove(const CID &key) {
+    return store_->remove(key);
+  }
+
+  FilteredDatastore::Stats FilteredDatastore::stats() const {
+    Stats stats;
+    stats.negatives = negatives_;
+    stats.false_positives = false_positives_;
+    std::shared_lock lock{mutex_};
+    stats.keys = filter_.size();
+    stats.saturated = saturated_;
+    return stats;
+  }
+
+  outcome::result<uint64_t> FilteredDatastore::hash(const CID &key) {
+    // same bytes as keys of leveldb datastore, which are loaded by cursor
+    return withKey(key, [](BufferView encoded) -> outcome::result<uint64_t> {
+      return CuckooFilter::hash(encoded);
+    });
+  }
+
+  bool FilteredDatastore::mayContain(const CID &key) const {
+    auto hash = FilteredDatastore::hash(key);
+    if (!hash) {
+      return true;
+    }
+    std::shared_lock lock{mutex_};
+    if (!loaded_ || saturated_ || filter_.contains(hash.value())) {
+      return true;
+    }
+    ++negatives_;
+    return false;
+  }
+
+  void FilteredDatastore::add(uint64_t hash) {
+    // same key set again is not duplicated
+    if (saturated_ || filter_.contains(hash)) {
+      return;
+    }
+    if (!filter_.insert(hash)) {
+      saturated_ = true;
+    }
+  }
+
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_FILTERED_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_FILTERED_DATASTORE_HPP
+
+#include <atomic>
+#include <shared_mutex>
+
+#include "common/cuckoo_filter.hpp"
+#include "storage/buffer_map.hpp"
+#include "storage/config/config.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @class FilteredDatastore IpfsDatastore decorator keeping cuckoo filter
+   * of stored keys in memory, so lookups of missing blocks, e.g. announced
+   * by gossip or hello, don't touch disk. Until keys of store are loaded
+   * all lookups go to store. Removed keys stay in filter, they only cost
+   * store lookup, so filter never gives false negative.
+   */
+  class FilteredDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<FilteredDatastore> {
+   public:
+    struct Options {
+      /// Number of keys, filter takes 2 bytes per key
+      size_t capacity{size_t{1} << 24};
+
+      /**
+       * @brief reads "ipfs.filter.capacity" key, missing key keeps default
+       * @param config node configuration
+       */
+      static Options load(config::Config &config);
+    };
+
+    /// Filter counters
+    struct Stats {
+      /// Lookups answered by filter without store
+      uint64_t negatives{};
+      /// Lookups passed by filter but missing in store
+      uint64_t false_positives{};
+      uint64_t keys{};
+      /// Filter is full, all lookups go to store
+      bool saturated{};
+    };
+
+    FilteredDatastore(std::shared_ptr<IpfsDatastore> store, Options options);
+
+    ~FilteredDatastore() override = default;
+
+    /**
+     * @brief adds keys of store to filter and enables filtering, keys set
+     * meanwhile are added too
+     * @param cursor cursor over store with keys encoded as datastore keys,
+     * e.g. LeveldbDatastore::cursor, or empty cursor for new store
+     */
+    void load(BufferMapCursor &cursor);
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    Stats stats() const;
+
+   private:
+    static outcome::result<uint64_t> hash(const CID &key);
+
+    /// Whether store may have key, true if filter is not usable
+    bool mayContain(const CID &key) const;
+
+    /// Caller holds unique lock
+    void add(uint64_t hash);
+
+    std::shared_ptr<IpfsDatastore> store_;
+    mutable std::shared_mutex mutex_;
+    common::CuckooFilter filter_;
+    bool loaded_{false};
+    bool saturated_{false};
+    mutable std::atomic_uint64_t negatives_{0};
+    mutable std::atomic_uint64_t false_positives_{0};
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_FILTERED_DATASTORE_HPP
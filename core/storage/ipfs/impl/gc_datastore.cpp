@@ -0,0 +1,227 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/gc_datastore.hpp"
+
+#include "storage/ipld/node_cache.hpp"
+#include "storage/ipld/walker.hpp"
+
+namespace fc::storage::ipfs {
+  using ipld::walker::Walker;
+
+  GcDatastore::GcDatastore(std::shared_ptr<LevelDB> hot,
+                           std::shared_ptr<IpfsDatastore> cold,
+                           RootsFunction roots,
+                           GcConfig config)
+      : hot_db_{hot},
+        hot_{std::make_shared<LeveldbDatastore>(std::move(hot))},
+        cold_{std::move(cold)},
+        roots_{std::move(roots)},
+        config_{config},
+        logger_{common::createLogger("GcDatastore")} {
+    BOOST_ASSERT_MSG(roots_ != nullptr, "roots argument is nullptr");
+    config_.step_bytes = std::max<size_t>(config_.step_bytes, 1);
+  }
+
+  outcome::result<bool> GcDatastore::contains(const CID &key) const {
+    OUTCOME_TRY(hot, hot_->contains(key));
+    if (!hot && cold_) {
+      OUTCOME_TRYA(hot, cold_->contains(key));
+    }
+    if (hot) {
+      // caller may link block instead of writing it
+      protect(key);
+    }
+    return hot;
+  }
+
+  outcome::result<void> GcDatastore::set(const CID &key, Value value) {
+    protect(key);
+    return hot_->set(key, std::move(value));
+  }
+
+  outcome::result<void> GcDatastore::setMany(Blocks blocks) {
+    for (auto &block : blocks) {
+      protect(block.first);
+    }
+    return hot_->setMany(std::move(blocks));
+  }
+
+  outcome::result<GcDatastore::Value> GcDatastore::get(const CID &key) const {
+    auto value = hot_->get(key);
+    if (value || !cold_ || value.error() != IpfsDatastoreError::NOT_FOUND) {
+      return value;
+    }
+    return cold_->get(key);
+  }
+
+  outcome::result<void> GcDatastore::remove(const CID &key) {
+    return hot_->remove(key);
+  }
+
+  outcome::result<bool> GcDatastore::step() {
+    std::lock_guard lock{mutex_};
+    if (phase_ == Phase::IDLE) {
+      OUTCOME_TRY(startCycle());
+    }
+    if (phase_ == Phase::MARK) {
+      auto marked{markStep()};
+      if (!marked) {
+        // partial mark would sweep live blocks
+        phase_ = Phase::IDLE;
+        mark_stack_.clear();
+        marked_.clear();
+        live_.clear();
+        return marked.error();
+      }
+      return false;
+    }
+    OUTCOME_TRY(sweepStep());
+    return phase_ == Phase::IDLE;
+  }
+
+  void GcDatastore::start(boost::asio::io_context &io) {
+    timer_ = std::make_unique<boost::asio::steady_timer>(io);
+    stopped_ = false;
+    schedule(config_.step_interval);
+  }
+
+  void GcDatastore::stop() {
+    stopped_ = true;
+    if (timer_) {
+      timer_->cancel();
+    }
+  }
+
+  GcStats GcDatastore::stats() const {
+    std::lock_guard lock{mutex_};
+    return stats_;
+  }
+
+  void GcDatastore::protect(const CID &key) const {
+    std::lock_guard lock{mutex_};
+    protected_.insert(key);
+    if (phase_ != Phase::IDLE) {
+      live_.insert(key);
+    }
+  }
+
+  outcome::result<void> GcDatastore::startCycle() {
+    OUTCOME_TRY(roots, roots_());
+    // blocks protected during previous cycle and since its end
+    live_ = std::move(protected_);
+    protected_.clear();
+    mark_stack_ = std::move(roots.recursive);
+    for (auto &cid : roots.direct) {
+      live_.insert(cid);
+    }
+    sweep_from_ = boost::none;
+    phase_ = Phase::MARK;
+    return outcome::success();
+  }
+
+  outcome::result<void> GcDatastore::markStep() {
+    size_t bytes{};
+    while (!mark_stack_.empty() && bytes < config_.step_bytes) {
+      auto cid = std::move(mark_stack_.back());
+      mark_stack_.pop_back();
+      // protected roots are live already, but their links are not
+      if (!marked_.insert(cid).second) {
+        continue;
+      }
+      live_.insert(cid);
+      // blocks moved to cold store may link blocks still in hot store
+      auto value = get(cid);
+      if (!value) {
+        // missing block of live dag is not written yet, or lost
+        if (auto cid_str{cid.toString()}) {
+          logger_->error("cannot mark live block {}: {}",
+                         cid_str.value(),
+                         value.error().message());
+        }
+        return value.error();
+      }
+      bytes += value.value().size();
+      OUTCOME_TRY(links, Walker::links(cid, value.value()));
+      for (auto &link : links) {
+        if (marked_.count(link) == 0) {
+          mark_stack_.push_back(std::move(link));
+        }
+      }
+    }
+    if (mark_stack_.empty()) {
+      marked_.clear();
+      phase_ = Phase::SWEEP;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> GcDatastore::sweepStep() {
+    auto cursor = hot_db_->cursor();
+    if (sweep_from_) {
+      cursor->seek(*sweep_from_);
+    } else {
+      cursor->seekToFirst();
+    }
+    size_t bytes{};
+    Blocks garbage;
+    auto batch = hot_db_->batch();
+    for (; cursor->isValid() && bytes < config_.step_bytes; cursor->next()) {
+      auto key = cursor->key();
+      auto cid = CID::fromBytes(key);
+      if (!cid || live_.count(cid.value()) != 0) {
+        continue;
+      }
+      auto value = cursor->value();
+      bytes += key.size() + value.size();
+      OUTCOME_TRY(batch->remove(key));
+      garbage.emplace_back(std::move(cid.value()), std::move(value));
+    }
+    auto count = garbage.size();
+    if (cold_ && !garbage.empty()) {
+      OUTCOME_TRY(cold_->setMany(std::move(garbage)));
+    }
+    OUTCOME_TRY(batch->commit());
+    if (!cold_ && count != 0) {
+      // decoded nodes of deleted blocks must not be served from caches
+      ipld::invalidateNodeCaches();
+    }
+    (cold_ ? stats_.moved : stats_.deleted) += count;
+
+    if (cursor->isValid()) {
+      sweep_from_ = cursor->key();
+      return outcome::success();
+    }
+    ++stats_.cycles;
+    stats_.live = live_.size();
+    logger_->info("cycle {} finished, {} live blocks, {} moved, {} deleted",
+                  stats_.cycles,
+                  stats_.live,
+                  stats_.moved,
+                  stats_.deleted);
+    live_.clear();
+    phase_ = Phase::IDLE;
+    return outcome::success();
+  }
+
+  void GcDatastore::schedule(std::chrono::milliseconds delay) {
+    timer_->expires_after(delay);
+    timer_->async_wait([weak{weak_from_this()}](auto &&ec) {
+      auto self = weak.lock();
+      if (ec || !self || self->stopped_) {
+        return;
+      }
+      auto finished = self->step();
+      if (!finished) {
+        self->logger_->error("step failed: {}", finished.error().message());
+        self->schedule(self->config_.cycle_interval);
+        return;
+      }
+      self->schedule(finished.value() ? self->config_.cycle_interval
+                                      : self->config_.step_interval);
+    });
+  }
+
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,146 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_GC_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_GC_DATASTORE_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/optional.hpp>
+
+#include "common/logger.hpp"
+#include "storage/ipfs/impl/datastore_leveldb.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * Blocks which must survive collection
+   */
+  struct GcRoots {
+    /// Roots whose whole dag is live
+    std::vector<CID> recursive;
+    /// Blocks which are live, but whose links are not
+    std::vector<CID> direct;
+  };
+
+  struct GcConfig {
+    /// Bytes read, moved or deleted by one step
+    size_t step_bytes{4 << 20};
+    /// Pause between background steps
+    std::chrono::milliseconds step_interval{100};
+    /// Pause between background cycles
+    std::chrono::milliseconds cycle_interval{std::chrono::minutes{10}};
+  };
+
+  /// Collection counters
+  struct GcStats {
+    uint64_t cycles{};
+    uint64_t live{};
+    uint64_t moved{};
+    uint64_t deleted{};
+  };
+
+  /**
+   * @class GcDatastore IpfsDatastore over hot LevelDB and cold store with
+   * incremental mark and sweep collection of hot blocks. Each cycle marks
+   * blocks reachable from roots, then moves unmarked hot blocks to cold
+   * store, or deletes them if there is no cold store. Blocks written or
+   * found by contains are live during the cycle running at that time and the
+   * next one, so dags written by long computations, e.g. interpretation, are
+   * not collected before they are referenced by roots. Missing linked block
+   * fails mark and aborts cycle without sweep.
+   */
+  class GcDatastore : public IpfsDatastore,
+                      public std::enable_shared_from_this<GcDatastore> {
+   public:
+    using RootsFunction = std::function<outcome::result<GcRoots>()>;
+
+    /**
+     * @param hot - hot LevelDB, its keys are iterated by sweep
+     * @param cold - cold store for garbage, nullptr to delete garbage
+     * @param roots - roots of live blocks, called on cycle start
+     * @param config - collection pace
+     */
+    GcDatastore(std::shared_ptr<LevelDB> hot,
+                std::shared_ptr<IpfsDatastore> cold,
+                RootsFunction roots,
+                GcConfig config);
+
+    ~GcDatastore() override = default;
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    /// Removes block from hot store only
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    /**
+     * @brief performs one bounded step of collection, starts new cycle if
+     * there is none
+     * @return true if cycle was finished by this step
+     */
+    outcome::result<bool> step();
+
+    /// Runs steps on io context until stop
+    void start(boost::asio::io_context &io);
+
+    void stop();
+
+    GcStats stats() const;
+
+   private:
+    enum class Phase { IDLE, MARK, SWEEP };
+
+    /// Marks key as live in current and next cycle
+    void protect(const CID &key) const;
+
+    outcome::result<void> startCycle();
+
+    outcome::result<void> markStep();
+
+    outcome::result<void> sweepStep();
+
+    void schedule(std::chrono::milliseconds delay);
+
+    std::shared_ptr<LevelDB> hot_db_;
+    std::shared_ptr<LeveldbDatastore> hot_;
+    std::shared_ptr<IpfsDatastore> cold_;
+    RootsFunction roots_;
+    GcConfig config_;
+
+    mutable std::mutex mutex_;
+    Phase phase_{Phase::IDLE};
+    mutable std::unordered_set<CID> live_;
+    /// Keys protected since cycle start, live in next cycle
+    mutable std::unordered_set<CID> protected_;
+    std::vector<CID> mark_stack_;
+    /// Blocks visited by mark, their links are pushed to stack
+    std::unordered_set<CID> marked_;
+    /// Hot key to continue sweep from
+    boost::optional<common::Buffer> sweep_from_;
+    GcStats stats_;
+
+    std::unique_ptr<boost::asio::steady_timer> timer_;
+    bool stopped_{true};
+    common::Logger logger_;
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_GC_DATASTORE_HPP
@@ -28,6 +28,15 @@ namespace fc::storage::ipfs {
     return std::move(data);
   }
 
+  outcome::result<void> IpfsBlockService::setMany(Blocks blocks) {
+    return local_storage_->setMany(std::move(blocks));
+  }
+
+  outcome::result<std::vector<IpfsBlockService::Value>>
+  IpfsBlockService::getMany(gsl::span<const CID> keys) const {
+    return local_storage_->getMany(keys);
+  }
+
   outcome::result<void> IpfsBlockService::remove(const CID &key) {
     return local_storage_->remove(key);
   }
@@ -25,6 +25,11 @@ namespace fc::storage::ipfs {
 
     outcome::result<Value> get(const CID &key) const override;
 
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<std::vector<Value>> getMany(
+        gsl::span<const CID> keys) const override;
+
     outcome::result<void> remove(const CID &key) override;
 
     IpldPtr shared() override {
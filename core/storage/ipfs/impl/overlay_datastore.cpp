@@ -0,0 +1,89 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+
+#include <unordered_set>
+
+#include "storage/ipld/walker.hpp"
+
+namespace fc::storage::ipfs {
+  using ipld::walker::Walker;
+
+  OverlayDatastore::OverlayDatastore(IpldPtr base)
+      : base_{std::move(base)} {
+    BOOST_ASSERT_MSG(base_ != nullptr, "base argument is nullptr");
+  }
+
+  outcome::result<bool> OverlayDatastore::contains(const CID &key) const {
+    if (overlay_.contains(key)) {
+      return true;
+    }
+    return base_->contains(key);
+  }
+
+  outcome::result<void> OverlayDatastore::set(const CID &key, Value value) {
+    auto bytes{value.size()};
+    overlay_.put(key, std::move(value), bytes);
+    return outcome::success();
+  }
+
+  outcome::result<OverlayDatastore::Value> OverlayDatastore::get(
+      const CID &key) const {
+    if (auto value{overlay_.get(key)}) {
+      return *value;
+    }
+    return base_->get(key);
+  }
+
+  outcome::result<void> OverlayDatastore::remove(const CID &key) {
+    overlay_.remove(key);
+    return base_->remove(key);
+  }
+
+  outcome::result<size_t> OverlayDatastore::commit(
+      const std::vector<CID> &roots) {
+    Blocks blocks;
+    std::unordered_set<CID> visited;
+    std::vector<CID> stack{roots.rbegin(), roots.rend()};
+    while (!stack.empty()) {
+      auto cid{std::move(stack.back())};
+      stack.pop_back();
+      if (!visited.insert(cid).second) {
+        continue;
+      }
+      auto value{overlay_.get(cid)};
+      if (!value) {
+        continue;
+      }
+      OUTCOME_TRY(links, Walker::links(cid, *value));
+      stack.insert(stack.end(), links.rbegin(), links.rend());
+      blocks.emplace_back(std::move(cid), *value);
+    }
+    auto count{blocks.size()};
+    if (count != 0) {
+      OUTCOME_TRY(base_->setMany(std::move(blocks)));
+    }
+    discard();
+    return count;
+  }
+
+  void OverlayDatastore::discard() {
+    overlay_.clear();
+  }
+
+  size_t OverlayDatastore::size() const {
+    return overlay_.size();
+  }
+
+  size_t OverlayDatastore::bytes() const {
+    return overlay_.bytes();
+  }
+
+  const IpldPtr &OverlayDatastore::base() const {
+    return base_;
+  }
+
+}  // namespace fc::storage::ipfs
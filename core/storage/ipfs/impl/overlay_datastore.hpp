@@ -0,0 +1,71 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_OVERLAY_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_OVERLAY_DATASTORE_HPP
+
+#include "storage/in_memory/sharded_map.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @class OverlayDatastore buffers writes in memory on top of base
+   * datastore, reads see own writes first. Commit writes only blocks
+   * reachable from given roots in one batch, so intermediate nodes flushed
+   * during execution never reach base. Safe for concurrent use.
+   */
+  class OverlayDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<OverlayDatastore> {
+   public:
+    explicit OverlayDatastore(IpldPtr base);
+
+    ~OverlayDatastore() override = default;
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    /// Writes to overlay only
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    /// Removes from overlay and base
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    /**
+     * @brief writes buffered blocks reachable from roots to base with single
+     * setMany, then drops all buffered blocks. Walk doesn't descend into
+     * blocks missing in overlay, they and their links are in base already.
+     * Must not run concurrently with writes.
+     * @return number of written blocks
+     */
+    outcome::result<size_t> commit(const std::vector<CID> &roots);
+
+    /// Drops all buffered blocks
+    void discard();
+
+    /// Number of buffered blocks
+    size_t size() const;
+
+    /// Total size of buffered blocks
+    size_t bytes() const;
+
+    const IpldPtr &base() const;
+
+   private:
+    using Map = ShardedMap<CID, Value>;
+
+    IpldPtr base_;
+    Map overlay_;
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_OVERLAY_DATASTORE_HPP
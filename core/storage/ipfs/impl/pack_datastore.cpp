@@ -0,0 +1,322 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/pack_datastore.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include "common/logger.hpp"
+
+namespace fc::storage::ipfs {
+  namespace fs = boost::filesystem;
+  namespace bip = boost::interprocess;
+
+  namespace {
+    /// Compares bytes lexicographically
+    int compare(gsl::span<const uint8_t> lhs, gsl::span<const uint8_t> rhs) {
+      auto size = std::min(lhs.size(), rhs.size());
+      if (size != 0) {
+        if (auto result = std::memcmp(lhs.data(), rhs.data(), size)) {
+          return result;
+        }
+      }
+      if (lhs.size() == rhs.size()) {
+        return 0;
+      }
+      return lhs.size() < rhs.size() ? -1 : 1;
+    }
+
+    gsl::span<const uint8_t> bytes(const uint8_t *data, size_t size) {
+      return gsl::make_span(data, static_cast<ptrdiff_t>(size));
+    }
+
+    outcome::result<bip::mapped_region> mapFile(const std::string &path,
+                                                uint64_t offset,
+                                                size_t size) {
+      try {
+        bip::file_mapping file{path.c_str(), bip::read_only};
+        return bip::mapped_region{
+            file, bip::read_only, static_cast<bip::offset_t>(offset), size};
+      } catch (...) {
+        return PackDatastoreError::CANNOT_OPEN;
+      }
+    }
+  }  // namespace
+
+  outcome::result<std::shared_ptr<PackDatastore>> PackDatastore::open(
+      const std::string &directory) {
+    std::shared_ptr<PackDatastore> store{new PackDatastore{}};
+    store->pack_path_ = (fs::path{directory} / "blocks.pack").string();
+    store->index_path_ = (fs::path{directory} / "blocks.index").string();
+    uint64_t pack_size{};
+    bool has_index{};
+    try {
+      fs::create_directories(directory);
+      if (!fs::exists(store->pack_path_)) {
+        std::ofstream{store->pack_path_, std::ios::binary};
+      }
+      pack_size = fs::file_size(store->pack_path_);
+      has_index = fs::exists(store->index_path_);
+    } catch (...) {
+      return PackDatastoreError::CANNOT_OPEN;
+    }
+    if (has_index) {
+      OUTCOME_TRY(store->mapIndex());
+    }
+
+    uint64_t end{};
+    for (auto &entry : store->index_) {
+      end = std::max(end, entry.offset + entry.key_size + entry.value_size);
+    }
+    if (pack_size < end) {
+      return PackDatastoreError::CORRUPTED_INDEX;
+    }
+    if (pack_size > end) {
+      // blocks appended after last flush are not indexed
+      try {
+        fs::resize_file(store->pack_path_, end);
+      } catch (...) {
+        return PackDatastoreError::WRITE_ERROR;
+      }
+    }
+    store->pack_size_ = end;
+    if (end != 0) {
+      OUTCOME_TRY(region, mapFile(store->pack_path_, 0, end));
+      store->segments_.push_back({0, std::move(region)});
+    }
+    return store;
+  }
+
+  PackDatastore::~PackDatastore() {
+    auto result = flushLocked();
+    if (!result) {
+      common::createLogger("PackDatastore")
+          ->error("flush failed: {}", result.error().message());
+    }
+  }
+
+  outcome::result<bool> PackDatastore::contains(const CID &key) const {
+    OUTCOME_TRY(key_bytes, key.toBytes());
+    std::shared_lock lock{mutex_};
+    return pending_.count(key_bytes) != 0 || find(key_bytes) != nullptr;
+  }
+
+  outcome::result<void> PackDatastore::set(const CID &key, Value value) {
+    OUTCOME_TRY(key_bytes, key.toBytes());
+    std::unique_lock lock{mutex_};
+    if (pending_.count(key_bytes) != 0 || find(key_bytes) != nullptr) {
+      return outcome::success();
+    }
+    pending_bytes_ += key_bytes.size() + value.size();
+    pending_.emplace(std::move(key_bytes), std::move(value));
+    if (pending_bytes_ >= kMaxPendingBytes) {
+      return flushLocked();
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> PackDatastore::setMany(Blocks blocks) {
+    std::unique_lock lock{mutex_};
+    for (auto &block : blocks) {
+      OUTCOME_TRY(key_bytes, block.first.toBytes());
+      if (pending_.count(key_bytes) != 0 || find(key_bytes) != nullptr) {
+        continue;
+      }
+      pending_bytes_ += key_bytes.size() + block.second.size();
+      pending_.emplace(std::move(key_bytes), std::move(block.second));
+    }
+    return flushLocked();
+  }
+
+  outcome::result<PackDatastore::Value> PackDatastore::get(
+      const CID &key) const {
+    OUTCOME_TRY(key_bytes, key.toBytes());
+    std::shared_lock lock{mutex_};
+    auto it = pending_.find(key_bytes);
+    if (it != pending_.end()) {
+      return it->second;
+    }
+    auto entry = find(key_bytes);
+    if (entry == nullptr) {
+      return IpfsDatastoreError::NOT_FOUND;
+    }
+    return Value{bytes(record(*entry) + entry->key_size, entry->value_size)};
+  }
+
+  outcome::result<void> PackDatastore::remove(const CID &) {
+    return PackDatastoreError::REMOVE_NOT_SUPPORTED;
+  }
+
+  outcome::result<gsl::span<const uint8_t>> PackDatastore::view(
+      const CID &key) const {
+    OUTCOME_TRY(key_bytes, key.toBytes());
+    std::shared_lock lock{mutex_};
+    auto entry = find(key_bytes);
+    if (entry == nullptr) {
+      return outcome::failure(IpfsDatastoreError::NOT_FOUND);
+    }
+    return bytes(record(*entry) + entry->key_size, entry->value_size);
+  }
+
+  outcome::result<void> PackDatastore::flush() {
+    std::unique_lock lock{mutex_};
+    return flushLocked();
+  }
+
+  size_t PackDatastore::size() const {
+    std::shared_lock lock{mutex_};
+    return index_.size();
+  }
+
+  outcome::result<void> PackDatastore::mapIndex() {
+    uint64_t size{};
+    try {
+      size = fs::file_size(index_path_);
+    } catch (...) {
+      return PackDatastoreError::CANNOT_OPEN;
+    }
+    if (size % sizeof(Entry) != 0) {
+      return PackDatastoreError::CORRUPTED_INDEX;
+    }
+    if (size == 0) {
+      index_region_ = {};
+      index_ = {};
+      return outcome::success();
+    }
+    OUTCOME_TRY(region, mapFile(index_path_, 0, size));
+    index_region_ = std::move(region);
+    index_ = gsl::make_span(
+        static_cast<const Entry *>(index_region_.get_address()),
+        static_cast<ptrdiff_t>(size / sizeof(Entry)));
+    return outcome::success();
+  }
+
+  const uint8_t *PackDatastore::record(const Entry &entry) const {
+    auto segment = std::upper_bound(
+        segments_.begin(),
+        segments_.end(),
+        entry.offset,
+        [](uint64_t offset, const Segment &segment) {
+          return offset < segment.begin;
+        });
+    --segment;
+    return static_cast<const uint8_t *>(segment->region.get_address())
+           + (entry.offset - segment->begin);
+  }
+
+  const PackDatastore::Entry *PackDatastore::find(
+      gsl::span<const uint8_t> key) const {
+    auto it = std::lower_bound(
+        index_.begin(),
+        index_.end(),
+        key,
+        [&](const Entry &entry, gsl::span<const uint8_t> target) {
+          return compare(bytes(record(entry), entry.key_size), target)
+                 < 0;
+        });
+    if (it == index_.end()
+        || compare(bytes(record(*it), it->key_size), key) != 0) {
+      return nullptr;
+    }
+    return &*it;
+  }
+
+  outcome::result<void> PackDatastore::flushLocked() {
+    if (pending_.empty()) {
+      return outcome::success();
+    }
+
+    // pending blocks are sorted by cid bytes as index
+    std::vector<Entry> added;
+    added.reserve(pending_.size());
+    auto offset = pack_size_;
+    std::ofstream pack{pack_path_, std::ios::binary | std::ios::app};
+    for (auto &[key, value] : pending_) {
+      pack.write(reinterpret_cast<const char *>(key.data()), key.size());
+      pack.write(reinterpret_cast<const char *>(value.data()), value.size());
+      added.push_back({offset,
+                       static_cast<uint32_t>(key.size()),
+                       static_cast<uint32_t>(value.size())});
+      offset += key.size() + value.size();
+    }
+    pack.close();
+    // offsets of next flush start at pack_size_, so partial write is cut off
+    auto truncate = [&] {
+      boost::system::error_code ec;
+      fs::resize_file(pack_path_, pack_size_, ec);
+      if (ec) {
+        common::createLogger("PackDatastore")
+            ->error("cannot truncate pack: {}", ec.message());
+      }
+    };
+    if (pack.fail()) {
+      truncate();
+      return PackDatastoreError::WRITE_ERROR;
+    }
+    auto region = mapFile(pack_path_, pack_size_, offset - pack_size_);
+    if (!region) {
+      truncate();
+      return region.error();
+    }
+    segments_.push_back({pack_size_, std::move(region.value())});
+    pack_size_ = offset;
+
+    // merge sorted index with added entries into new index file
+    auto index_tmp = index_path_ + ".tmp";
+    std::ofstream index{index_tmp, std::ios::binary | std::ios::trunc};
+    auto write = [&](const Entry &entry) {
+      index.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    };
+    auto key = [&](const Entry &entry) {
+      return bytes(record(entry), entry.key_size);
+    };
+    auto old_entry = index_.begin();
+    auto new_entry = added.begin();
+    while (old_entry != index_.end() || new_entry != added.end()) {
+      if (new_entry == added.end()
+          || (old_entry != index_.end()
+              && compare(key(*old_entry), key(*new_entry)) < 0)) {
+        write(*old_entry++);
+      } else {
+        write(*new_entry++);
+      }
+    }
+    index.close();
+    if (index.fail()) {
+      return PackDatastoreError::WRITE_ERROR;
+    }
+    try {
+      fs::rename(index_tmp, index_path_);
+    } catch (...) {
+      return PackDatastoreError::WRITE_ERROR;
+    }
+    OUTCOME_TRY(mapIndex());
+
+    pending_.clear();
+    pending_bytes_ = 0;
+    return outcome::success();
+  }
+
+}  // namespace fc::storage::ipfs
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::ipfs, PackDatastoreError, e) {
+  using fc::storage::ipfs::PackDatastoreError;
+
+  switch (e) {
+    case PackDatastoreError::CANNOT_OPEN:
+      return "PackDatastoreError: cannot open pack files";
+    case PackDatastoreError::CORRUPTED_INDEX:
+      return "PackDatastoreError: index does not match pack file";
+    case PackDatastoreError::WRITE_ERROR:
+      return "PackDatastoreError: cannot write pack files";
+    case PackDatastoreError::REMOVE_NOT_SUPPORTED:
+      return "PackDatastoreError: blocks can not be removed";
+  }
+
+  return "unknown error";
+}
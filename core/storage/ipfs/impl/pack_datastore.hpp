@@ -0,0 +1,123 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_PACK_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_PACK_DATASTORE_HPP
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  enum class PackDatastoreError {
+    CANNOT_OPEN = 1,
+    CORRUPTED_INDEX,
+    WRITE_ERROR,
+    REMOVE_NOT_SUPPORTED,
+  };
+
+  /**
+   * @class PackDatastore append-only IpfsDatastore for immutable blocks.
+   * Blocks are appended to memory-mapped pack file, and found by binary
+   * search in index sorted by cid bytes. Appended blocks are kept in memory
+   * until flush, which writes them to pack file and rewrites index.
+   */
+  class PackDatastore : public IpfsDatastore,
+                        public std::enable_shared_from_this<PackDatastore> {
+   public:
+    /// Appended bytes which trigger flush
+    static constexpr size_t kMaxPendingBytes{64 << 20};
+
+    /**
+     * @brief opens or creates pack in directory, data appended after last
+     * successful flush is discarded
+     * @param directory - pack directory
+     */
+    static outcome::result<std::shared_ptr<PackDatastore>> open(
+        const std::string &directory);
+
+    ~PackDatastore() override;
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    /// Appends all blocks and flushes them
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    /// Blocks are immutable, always fails
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    /**
+     * @brief get flushed block without copy
+     * @param key - block cid
+     * @return bytes, valid while datastore is alive
+     */
+    outcome::result<gsl::span<const uint8_t>> view(const CID &key) const;
+
+    /**
+     * @brief write appended blocks to pack file and index
+     */
+    outcome::result<void> flush();
+
+    /// Number of flushed blocks
+    size_t size() const;
+
+    /**
+     * Index entry, record at offset is cid bytes followed by block bytes
+     */
+    struct Entry {
+      uint64_t offset;
+      uint32_t key_size;
+      uint32_t value_size;
+    };
+
+   private:
+    /// Mapped part of pack file
+    struct Segment {
+      uint64_t begin;
+      boost::interprocess::mapped_region region;
+    };
+
+    PackDatastore() = default;
+
+    outcome::result<void> mapIndex();
+
+    /// Record bytes of entry
+    const uint8_t *record(const Entry &entry) const;
+
+    /// Lower bound of key in index
+    const Entry *find(gsl::span<const uint8_t> key) const;
+
+    outcome::result<void> flushLocked();
+
+    std::string pack_path_;
+    std::string index_path_;
+    uint64_t pack_size_{};
+    /// Pack segments by begin offset, mapped once and never unmapped
+    std::vector<Segment> segments_;
+    boost::interprocess::mapped_region index_region_;
+    gsl::span<const Entry> index_;
+    std::map<std::vector<uint8_t>, Value> pending_;
+    size_t pending_bytes_{};
+    mutable std::shared_mutex mutex_;
+  };
+
+}  // namespace fc::storage::ipfs
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipfs, PackDatastoreError);
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_PACK_DATASTORE_HPP
@@ -0,0 +1,58 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/tiered_datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  TieredDatastore::TieredDatastore(std::shared_ptr<IpfsDatastore> hot,
+                                   std::shared_ptr<IpfsDatastore> cold)
+      : hot_{std::move(hot)}, cold_{std::move(cold)} {
+    BOOST_ASSERT_MSG(hot_ != nullptr, "hot argument is nullptr");
+    BOOST_ASSERT_MSG(cold_ != nullptr, "cold argument is nullptr");
+  }
+
+  outcome::result<bool> TieredDatastore::contains(const CID &key) const {
+    OUTCOME_TRY(hot, hot_->contains(key));
+    if (hot) {
+      return true;
+    }
+    return cold_->contains(key);
+  }
+
+  outcome::result<void> TieredDatastore::set(const CID &key, Value value) {
+    OUTCOME_TRY(cold, cold_->contains(key));
+    if (cold) {
+      return outcome::success();
+    }
+    return hot_->set(key, std::move(value));
+  }
+
+  outcome::result<void> TieredDatastore::setMany(Blocks blocks) {
+    return hot_->setMany(std::move(blocks));
+  }
+
+  outcome::result<TieredDatastore::Value> TieredDatastore::get(
+      const CID &key) const {
+    auto value = hot_->get(key);
+    if (value || value.error() != IpfsDatastoreError::NOT_FOUND) {
+      return value;
+    }
+    return cold_->get(key);
+  }
+
+  outcome::result<void> TieredDatastore::remove(const CID &key) {
+    return hot_->remove(key);
+  }
+
+  const std::shared_ptr<IpfsDatastore> &TieredDatastore::hot() const {
+    return hot_;
+  }
+
+  const std::shared_ptr<IpfsDatastore> &TieredDatastore::cold() const {
+    return cold_;
+  }
+
+}  // namespace fc::storage::ipfs
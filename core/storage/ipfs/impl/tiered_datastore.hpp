@@ -0,0 +1,53 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_TIERED_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_TIERED_DATASTORE_HPP
+
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @class TieredDatastore IpfsDatastore reading from hot store and then
+   * from cold store. New blocks are written to hot store, blocks are moved
+   * to cold store by migration.
+   */
+  class TieredDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<TieredDatastore> {
+   public:
+    TieredDatastore(std::shared_ptr<IpfsDatastore> hot,
+                    std::shared_ptr<IpfsDatastore> cold);
+
+    ~TieredDatastore() override = default;
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    /// Removes block from hot store only
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    const std::shared_ptr<IpfsDatastore> &hot() const;
+
+    const std::shared_ptr<IpfsDatastore> &cold() const;
+
+   private:
+    std::shared_ptr<IpfsDatastore> hot_;
+    std::shared_ptr<IpfsDatastore> cold_;
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPFS_IMPL_TIERED_DATASTORE_HPP
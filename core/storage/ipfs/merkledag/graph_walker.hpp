@@ -0,0 +1,91 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILECOIN_STORAGE_IPFS_MERKLEDAG_GRAPH_WALKER_HPP
+#define FILECOIN_STORAGE_IPFS_MERKLEDAG_GRAPH_WALKER_HPP
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "common/outcome.hpp"
+#include "storage/ipld/ipld_node.hpp"
+
+namespace fc::storage::ipfs::merkledag {
+  using ipld::IPLDLink;
+  using ipld::IPLDNode;
+
+  /**
+   * @class Lazy depth-first traversal of MerkleDAG.
+   * Children are loaded on demand, only nodes on path from root to current
+   * node are held, so memory is bounded by depth of graph, not its size.
+   * Content of visited node is shared, not copied.
+   */
+  class GraphWalker {
+   public:
+    using Loader = std::function<outcome::result<std::shared_ptr<IPLDNode>>(
+        const CID &cid)>;
+
+    static constexpr uint64_t kNoDepthLimit{
+        std::numeric_limits<uint64_t>::max()};
+
+    /**
+     * @brief Construct walker, root is loaded by first call of next
+     * @param loader - loads node by cid
+     * @param root - identifier of the root node
+     * @param max_depth - e.g. "1" means "Visit root node with all
+     * children, but without children of their children"
+     */
+    GraphWalker(Loader loader, CID root, uint64_t max_depth = kNoDepthLimit);
+
+    /**
+     * @brief Move to next node in depth-first order, root is first
+     * @return false when all nodes were visited,
+     *         ServiceError::UNRESOLVED_LINK if child node not found
+     */
+    outcome::result<bool> next();
+
+    /**
+     * @brief Do not visit children of current node
+     */
+    void skipChildren();
+
+    /**
+     * @brief Current node
+     */
+    const std::shared_ptr<IPLDNode> &node() const;
+
+    /**
+     * @brief Name of the link to current node, empty for root
+     */
+    std::string_view name() const;
+
+    /**
+     * @brief Depth of current node, 0 for root
+     */
+    size_t depth() const;
+
+   private:
+    struct Frame {
+      std::shared_ptr<IPLDNode> node;
+      std::vector<std::reference_wrapper<const IPLDLink>> links;
+      /// Index of next child to visit
+      size_t next_link{};
+      std::string_view name;
+    };
+
+    outcome::result<void> push(const CID &cid, std::string_view name);
+
+    Loader loader_;
+    CID root_;
+    uint64_t max_depth_;
+    bool started_{false};
+    std::vector<Frame> path_;
+  };
+}  // namespace fc::storage::ipfs::merkledag
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/merkledag/graph_walker.hpp"
+
+#include <boost/assert.hpp>
+
+#include "storage/ipfs/merkledag/merkledag_service.hpp"
+
+namespace fc::storage::ipfs::merkledag {
+  GraphWalker::GraphWalker(Loader loader, CID root, uint64_t max_depth)
+      : loader_{std::move(loader)},
+        root_{std::move(root)},
+        max_depth_{max_depth} {}
+
+  outcome::result<bool> GraphWalker::next() {
+    if (!started_) {
+      started_ = true;
+      OUTCOME_TRY(node, loader_(root_));
+      auto links = node->getLinks();
+      path_.push_back({std::move(node), std::move(links), 0, {}});
+      return true;
+    }
+    if (!path_.empty() && depth() >= max_depth_) {
+      skipChildren();
+    }
+    while (!path_.empty()) {
+      auto &frame = path_.back();
+      if (frame.next_link < frame.links.size()) {
+        const auto &link = frame.links[frame.next_link++].get();
+        OUTCOME_TRY(push(link.getCID(), link.getName()));
+        return true;
+      }
+      path_.pop_back();
+    }
+    return false;
+  }
+
+  void GraphWalker::skipChildren() {
+    BOOST_ASSERT(!path_.empty());
+    path_.back().next_link = path_.back().links.size();
+  }
+
+  const std::shared_ptr<IPLDNode> &GraphWalker::node() const {
+    BOOST_ASSERT(!path_.empty());
+    return path_.back().node;
+  }
+
+  std::string_view GraphWalker::name() const {
+    BOOST_ASSERT(!path_.empty());
+    return path_.back().name;
+  }
+
+  size_t GraphWalker::depth() const {
+    BOOST_ASSERT(!path_.empty());
+    return path_.size() - 1;
+  }
+
+  outcome::result<void> GraphWalker::push(const CID &cid,
+                                          std::string_view name) {
+    auto request = loader_(cid);
+    if (request.has_error()) {
+      return ServiceError::UNRESOLVED_LINK;
+    }
+    auto &node = request.value();
+    auto links = node->getLinks();
+    // links and names are owned by node of parent frame
+    path_.push_back({std::move(node), std::move(links), 0, name});
+    return outcome::success();
+  }
+}  // namespace fc::storage::ipfs::merkledag
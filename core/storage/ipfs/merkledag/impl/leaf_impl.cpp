@@ -7,10 +7,13 @@
 
 namespace fc::storage::ipfs::merkledag {
   LeafImpl::LeafImpl(common::Buffer data)
+      : content_{std::make_shared<const common::Buffer>(std::move(data))} {}
+
+  LeafImpl::LeafImpl(std::shared_ptr<const common::Buffer> data)
       : content_{std::move(data)} {}
 
   const common::Buffer &LeafImpl::content() const {
-    return content_;
+    return *content_;
   }
 
   size_t LeafImpl::count() const {
@@ -33,11 +36,11 @@ namespace fc::storage::ipfs::merkledag {
     return names;
   }
 
-  outcome::result<void> LeafImpl::insertSubLeaf(std::string name,
-                                                 LeafImpl children) {
+  outcome::result<std::reference_wrapper<LeafImpl>> LeafImpl::insertSubLeaf(
+      std::string name, LeafImpl children) {
     auto result = children_.emplace(std::move(name), std::move(children));
     if (result.second) {
-      return outcome::success();
+      return result.first->second;
     }
     return LeafError::DUPLICATE_LEAF;
   }
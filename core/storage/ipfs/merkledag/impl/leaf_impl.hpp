@@ -9,6 +9,7 @@
 #include "storage/ipfs/merkledag/leaf.hpp"
 
 #include <map>
+#include <memory>
 #include <string>
 
 namespace fc::storage::ipfs::merkledag {
@@ -20,6 +21,12 @@ namespace fc::storage::ipfs::merkledag {
      */
     explicit LeafImpl(common::Buffer data);
 
+    /**
+     * @brief Construct leaf sharing content with its owner, e.g. node
+     * @param data - leaf content
+     */
+    explicit LeafImpl(std::shared_ptr<const common::Buffer> data);
+
     const common::Buffer &content() const override;
 
     size_t count() const override;
@@ -33,12 +40,13 @@ namespace fc::storage::ipfs::merkledag {
      * @brief Insert children leaf
      * @param name - id of the leaf
      * @param children - leaf to insert
-     * @return operation result
+     * @return inserted leaf
      */
-    outcome::result<void> insertSubLeaf(std::string name, LeafImpl children);
+    outcome::result<std::reference_wrapper<LeafImpl>> insertSubLeaf(
+        std::string name, LeafImpl children);
 
    private:
-    common::Buffer content_;
+    std::shared_ptr<const common::Buffer> content_;
     std::map<std::string, LeafImpl, std::less<>> children_;
   };
 }  // namespace fc::storage::ipfs::merkledag
@@ -60,52 +60,51 @@ namespace fc::storage::ipfs::merkledag {
 
   outcome::result<std::shared_ptr<Leaf>> MerkleDagServiceImpl::fetchGraph(
       const CID &cid) const {
-    OUTCOME_TRY(node, getNode(cid));
-    auto root_leaf = std::make_shared<LeafImpl>(node->content());
-    auto result = buildGraph(root_leaf, node->getLinks(), false, 0, 0);
-    if (result.has_error()) return result.error();
-    return root_leaf;
+    return buildGraph(walkGraph(cid, GraphWalker::kNoDepthLimit));
   }
 
   outcome::result<std::shared_ptr<Leaf>>
   MerkleDagServiceImpl::fetchGraphOnDepth(const CID &cid,
                                           uint64_t depth) const {
-    OUTCOME_TRY(node, getNode(cid));
-    auto leaf = std::make_shared<LeafImpl>(node->content());
-    auto result = buildGraph(leaf, node->getLinks(), true, depth, 0);
-    if (result.has_error()) return result.error();
-    return leaf;
+    return buildGraph(walkGraph(cid, depth));
   }
 
-  outcome::result<void> MerkleDagServiceImpl::buildGraph(
-      const std::shared_ptr<LeafImpl> &root,
-      const std::vector<std::reference_wrapper<const IPLDLink>> &links,
-      bool depth_limit,
-      const size_t max_depth,
-      size_t current_depth) const {
-    if (depth_limit && current_depth == max_depth) {
-      return outcome::success();
-    }
-    for (const auto &link : links) {
-      auto request = getNode(link.get().getCID());
-      if (request.has_error()) return ServiceError::UNRESOLVED_LINK;
-      std::shared_ptr<IPLDNode> node = request.value();
-      auto child_leaf = std::make_shared<LeafImpl>(node->content());
-      auto build_result = buildGraph(child_leaf,
-                                     node->getLinks(),
-                                     depth_limit,
-                                     max_depth,
-                                     ++current_depth);
-      if (build_result.has_error()) {
-        return build_result;
-      }
-      auto insert_result =
-          root->insertSubLeaf(link.get().getName(), std::move(*child_leaf));
-      if (insert_result.has_error()) {
-        return insert_result;
+  GraphWalker MerkleDagServiceImpl::walkGraph(const CID &cid,
+                                              uint64_t depth) const {
+    // walker keeps block service alive, not the service itself
+    return GraphWalker{
+        [block_service{block_service_}](
+            const CID &node_cid) -> outcome::result<std::shared_ptr<IPLDNode>> {
+          OUTCOME_TRY(content, block_service->get(node_cid));
+          return IPLDNodeImpl::createFromRawBytes(content);
+        },
+        cid,
+        depth};
+  }
+
+  outcome::result<std::shared_ptr<Leaf>> MerkleDagServiceImpl::buildGraph(
+      GraphWalker walker) {
+    OUTCOME_TRY(walker.next());
+    // content is aliased to node, which stays alive as long as leaf
+    auto content = [](const std::shared_ptr<IPLDNode> &node) {
+      return std::shared_ptr<const common::Buffer>{node, &node->content()};
+    };
+    auto root = std::make_shared<LeafImpl>(content(walker.node()));
+    // leaves on path to current node, map keeps inserted leaves in place
+    std::vector<std::reference_wrapper<LeafImpl>> path{*root};
+    while (true) {
+      OUTCOME_TRY(more, walker.next());
+      if (!more) {
+        break;
       }
+      path.resize(walker.depth(), *root);
+      OUTCOME_TRY(leaf,
+                  path.back().get().insertSubLeaf(
+                      std::string{walker.name()},
+                      LeafImpl{content(walker.node())}));
+      path.push_back(leaf);
     }
-    return outcome::success();
+    return root;
   }
 }  // namespace fc::storage::ipfs::merkledag
 
@@ -14,8 +14,6 @@
 #include "storage/ipld/ipld_link.hpp"
 
 namespace fc::storage::ipfs::merkledag {
-  using ipld::IPLDLink;
-
   class MerkleDagServiceImpl : public MerkleDagService {
    public:
     /**
@@ -44,25 +42,18 @@ namespace fc::storage::ipfs::merkledag {
     outcome::result<std::shared_ptr<Leaf>> fetchGraphOnDepth(
         const CID &cid, uint64_t depth) const override;
 
+    GraphWalker walkGraph(const CID &cid, uint64_t depth) const override;
+
    private:
     std::shared_ptr<IpfsDatastore> block_service_;
 
     /**
-     * @brief Fetch graph internal recursive implementation
-     * @param root - leaf, for which we should extract child nodes
-     * @param links - links to the child nodes of this leaf
-     * @param depth_limit - status of the depth control
-     * @param max_depth - e.g. "1" means "Fetch only root node with all
-     * children, but without children of their children"
-     * @param current_depth - value of the depth during current operation
-     * @return operation result
+     * @brief Build leaf tree by walking graph, leaves share content of nodes
+     * @param walker - walker over graph to build
+     * @return root leaf
      */
-    outcome::result<void> buildGraph(
-        const std::shared_ptr<LeafImpl> &root,
-        const std::vector<std::reference_wrapper<const IPLDLink>> &links,
-        bool depth_limit,
-        size_t max_depth,
-        size_t current_depth = 0) const;
+    static outcome::result<std::shared_ptr<Leaf>> buildGraph(
+        GraphWalker walker);
   };
 }  // namespace fc::storage::ipfs::merkledag
 
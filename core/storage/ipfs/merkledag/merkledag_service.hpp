@@ -9,12 +9,11 @@
 #include <memory>
 
 #include "common/outcome.hpp"
+#include "storage/ipfs/merkledag/graph_walker.hpp"
 #include "storage/ipfs/merkledag/leaf.hpp"
 #include "storage/ipld/ipld_node.hpp"
 
 namespace fc::storage::ipfs::merkledag {
-  using ipld::IPLDNode;
-
   class MerkleDagService {
    public:
     /**
@@ -75,6 +74,16 @@ namespace fc::storage::ipfs::merkledag {
      */
     virtual outcome::result<std::shared_ptr<Leaf>> fetchGraphOnDepth(
         const CID &cid, uint64_t depth) const = 0;
+
+    /**
+     * @brief Lazily walk graph from given root node, unlike fetchGraph
+     *        nodes are loaded one by one and are not kept after visit
+     * @param cid - identifier of the root node
+     * @param depth - limit of the depth to walk
+     * @return walker, root is loaded by its first step
+     */
+    virtual GraphWalker walkGraph(
+        const CID &cid, uint64_t depth = GraphWalker::kNoDepthLimit) const = 0;
   };
 
   /**
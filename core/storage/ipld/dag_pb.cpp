@@ -0,0 +1,185 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/dag_pb.hpp"
+
+#include "codec/uvarint.hpp"
+#include "common/span.hpp"
+#include "crypto/hasher/hasher.hpp"
+
+namespace fc::storage::ipld::dag_pb {
+  using codec::uvarint::read;
+
+  // Protobuf wire types
+  constexpr uint64_t kVarint{0};
+  constexpr uint64_t kBits64{1};
+  constexpr uint64_t kLengthDelimited{2};
+  constexpr uint64_t kBits32{5};
+
+  outcome::result<boost::optional<PbField>> PbReader::next() {
+    while (!input_.empty()) {
+      OUTCOME_TRY(tag, read<DagPbError::INVALID_PB>(input_));
+      PbField field;
+      field.id = tag >> 3;
+      switch (tag & 7) {
+        case kVarint: {
+          OUTCOME_TRYA(field.value, read<DagPbError::INVALID_PB>(input_));
+          return boost::make_optional(field);
+        }
+        case kLengthDelimited: {
+          OUTCOME_TRYA(field.bytes,
+                       codec::uvarint::readBytes<DagPbError::INVALID_PB,
+                                                 DagPbError::INVALID_PB>(
+                           input_));
+          return boost::make_optional(field);
+        }
+        case kBits64:
+        case kBits32: {
+          auto size{(tag & 7) == kBits64 ? 8 : 4};
+          if (input_.size() < size) {
+            return DagPbError::INVALID_PB;
+          }
+          input_ = input_.subspan(size);
+          break;
+        }
+        default:
+          return DagPbError::INVALID_PB;
+      }
+    }
+    return boost::none;
+  }
+
+  outcome::result<Input> decode(Input input, const LinkCallback &on_link) {
+    Input data;
+    PbReader node{input};
+    while (true) {
+      OUTCOME_TRY(field, node.next());
+      if (!field) {
+        break;
+      }
+      if (field->id == static_cast<uint32_t>(PbNodeField::DATA)) {
+        data = field->bytes;
+      } else if (field->id == static_cast<uint32_t>(PbNodeField::LINKS)) {
+        PbLink link;
+        PbReader reader{field->bytes};
+        while (true) {
+          OUTCOME_TRY(link_field, reader.next());
+          if (!link_field) {
+            break;
+          }
+          switch (PbLinkField{link_field->id}) {
+            case PbLinkField::HASH:
+              link.cid = link_field->bytes;
+              break;
+            case PbLinkField::NAME:
+              link.name = {
+                  common::span::cstring(link_field->bytes).data(),
+                  static_cast<size_t>(link_field->bytes.size())};
+              break;
+            case PbLinkField::SIZE:
+              link.size = link_field->value;
+              break;
+          }
+        }
+        OUTCOME_TRY(on_link(link));
+      }
+    }
+    return data;
+  }
+
+  outcome::result<PbNode> decode(Input input) {
+    PbNode node;
+    OUTCOME_TRYA(node.data,
+                 decode(input, [&](auto &link) -> outcome::result<void> {
+                   node.links.push_back(link);
+                   return outcome::success();
+                 }));
+    return std::move(node);
+  }
+
+  outcome::result<std::vector<CID>> decodeLinks(Input input) {
+    std::vector<CID> cids;
+    OUTCOME_TRY(decode(input, [&](auto &link) -> outcome::result<void> {
+      OUTCOME_TRY(cid, CID::fromBytes(link.cid));
+      cids.push_back(std::move(cid));
+      return outcome::success();
+    }));
+    return std::move(cids);
+  }
+
+  void PbWriter::varint(uint32_t id, uint64_t value) {
+    putVarint((id << 3) | kVarint);
+    putVarint(value);
+  }
+
+  void PbWriter::bytes(uint32_t id, Input bytes) {
+    header(id, bytes.size());
+    output_.put(bytes);
+  }
+
+  void PbWriter::header(uint32_t id, size_t size) {
+    putVarint((id << 3) | kLengthDelimited);
+    putVarint(size);
+  }
+
+  size_t PbWriter::varintSize(uint64_t value) {
+    size_t size{1};
+    while (value >= 0x80) {
+      value >>= 7;
+      ++size;
+    }
+    return size;
+  }
+
+  size_t PbWriter::bytesSize(uint32_t id, size_t size) {
+    return varintSize((id << 3) | kLengthDelimited) + varintSize(size) + size;
+  }
+
+  void PbWriter::putVarint(uint64_t value) {
+    while (value >= 0x80) {
+      output_.putUint8(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    output_.putUint8(static_cast<uint8_t>(value));
+  }
+
+  void writeLink(PbWriter &writer,
+                 Input cid,
+                 std::string_view name,
+                 uint64_t size) {
+    auto hash_id{static_cast<uint32_t>(PbLinkField::HASH)};
+    auto name_id{static_cast<uint32_t>(PbLinkField::NAME)};
+    auto size_id{static_cast<uint32_t>(PbLinkField::SIZE)};
+    writer.header(static_cast<uint32_t>(PbNodeField::LINKS),
+                  PbWriter::bytesSize(hash_id, cid.size())
+                      + PbWriter::bytesSize(name_id, name.size())
+                      + PbWriter::varintSize(size_id << 3)
+                      + PbWriter::varintSize(size));
+    writer.bytes(hash_id, cid);
+    writer.bytes(name_id, common::span::cbytes(gsl::make_span(name)));
+    writer.varint(size_id, size);
+  }
+
+  void writeData(PbWriter &writer, Input data) {
+    if (!data.empty()) {
+      writer.bytes(static_cast<uint32_t>(PbNodeField::DATA), data);
+    }
+  }
+
+  CID cid(Input node) {
+    return {CID::Version::V0,
+            CID::Multicodec::DAG_PB,
+            crypto::Hasher::sha2_256(node)};
+  }
+}  // namespace fc::storage::ipld::dag_pb
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::ipld::dag_pb, DagPbError, e) {
+  using fc::storage::ipld::dag_pb::DagPbError;
+  switch (e) {
+    case DagPbError::INVALID_PB:
+      return "DagPbError: invalid protobuf";
+  }
+  return "DagPbError: unknown error";
+}
@@ -0,0 +1,127 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPLD_DAG_PB_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPLD_DAG_PB_HPP
+
+#include <functional>
+#include <string_view>
+
+#include <boost/optional.hpp>
+#include <gsl/span>
+
+#include "common/buffer.hpp"
+#include "common/outcome.hpp"
+#include "primitives/cid/cid.hpp"
+
+/**
+ * Protobuf codec of dag-pb nodes, without generated protobuf classes.
+ * Decoder returns views into input, encoder appends to reused buffer.
+ * https://github.com/ipld/specs/blob/master/block-layer/codecs/dag-pb.md
+ */
+namespace fc::storage::ipld::dag_pb {
+  using Input = gsl::span<const uint8_t>;
+
+  enum class DagPbError {
+    INVALID_PB = 1,
+  };
+
+  /// PBNode and PBLink field ids
+  enum class PbNodeField : uint32_t { DATA = 1, LINKS = 2 };
+  enum class PbLinkField : uint32_t { HASH = 1, NAME = 2, SIZE = 3 };
+
+  /// Protobuf field, value is set for varint, bytes for length-delimited
+  struct PbField {
+    uint32_t id{};
+    uint64_t value{};
+    Input bytes;
+  };
+
+  /**
+   * Reads fields of protobuf message one by one.
+   * Fixed size fields are skipped.
+   */
+  class PbReader {
+   public:
+    explicit PbReader(Input input) : input_{input} {}
+
+    /// Next field, none at end of message
+    outcome::result<boost::optional<PbField>> next();
+
+   private:
+    Input input_;
+  };
+
+  /// Link of decoded node, points into node bytes
+  struct PbLink {
+    Input cid;
+    std::string_view name;
+    uint64_t size{};
+  };
+
+  /// Data and links of node, points into node bytes
+  struct PbNode {
+    Input data;
+    std::vector<PbLink> links;
+  };
+
+  using LinkCallback = std::function<outcome::result<void>(const PbLink &)>;
+
+  /**
+   * Decodes node without copying its bytes
+   * @param on_link - called for each link in encoded order
+   * @return content of node
+   */
+  outcome::result<Input> decode(Input input, const LinkCallback &on_link);
+
+  /// Decodes node, views are valid while input is alive
+  outcome::result<PbNode> decode(Input input);
+
+  /// Cids of node links
+  outcome::result<std::vector<CID>> decodeLinks(Input input);
+
+  /// Appends protobuf fields to buffer
+  class PbWriter {
+   public:
+    explicit PbWriter(common::Buffer &output) : output_{output} {}
+
+    void varint(uint32_t id, uint64_t value);
+
+    void bytes(uint32_t id, Input bytes);
+
+    /// Header of length-delimited field, caller writes size bytes after
+    void header(uint32_t id, size_t size);
+
+    static size_t varintSize(uint64_t value);
+
+    /// Size of length-delimited field with size bytes
+    static size_t bytesSize(uint32_t id, size_t size);
+
+   private:
+    void putVarint(uint64_t value);
+
+    common::Buffer &output_;
+  };
+
+  /**
+   * Appends link of node, links go before data as go-merkledag writes them.
+   * Name is written even if empty, for same bytes as go-merkledag.
+   * @param cid - bytes of link cid
+   */
+  void writeLink(PbWriter &writer,
+                 Input cid,
+                 std::string_view name,
+                 uint64_t size);
+
+  /// Appends data of node, empty data is omitted
+  void writeData(PbWriter &writer, Input data);
+
+  /// Cid of encoded node
+  CID cid(Input node);
+}  // namespace fc::storage::ipld::dag_pb
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipld::dag_pb, DagPbError);
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPLD_DAG_PB_HPP
@@ -0,0 +1,77 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPLD_ENCODE_LEVEL_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPLD_ENCODE_LEVEL_HPP
+
+#include <future>
+
+#include "primitives/cid/cid.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipld {
+  /// Min nodes encoded and hashed by one thread of level flush
+  constexpr size_t kFlushChunk{256};
+  /// Max threads encoding and hashing one level of nodes
+  constexpr size_t kFlushThreads{4};
+
+  /// Encoded nodes of tree level and their cids, in order of nodes
+  struct EncodedLevel {
+    std::vector<ipfs::IpfsDatastore::Value> encoded;
+    std::vector<CID> cids;
+  };
+
+  /**
+   * Encodes and hashes nodes of one level of hamt or amt.
+   * Large levels, e.g. when tipset dirties many branches of state tree,
+   * are split into parts encoded and hashed concurrently.
+   * Nodes must not be modified until it returns.
+   */
+  template <typename T>
+  outcome::result<EncodedLevel> encodeLevel(const std::vector<T *> &nodes,
+                                            size_t threads = kFlushThreads) {
+    auto encode{[&](size_t begin,
+                    size_t end) -> outcome::result<EncodedLevel> {
+      EncodedLevel level;
+      level.encoded.reserve(end - begin);
+      for (auto i{begin}; i < end; ++i) {
+        OUTCOME_TRY(bytes, ipfs::IpfsDatastore::encode(*nodes[i]));
+        level.encoded.push_back(std::move(bytes));
+      }
+      std::vector<gsl::span<const uint8_t>> inputs{level.encoded.begin(),
+                                                   level.encoded.end()};
+      OUTCOME_TRYA(level.cids, common::getCidsOf(inputs));
+      return std::move(level);
+    }};
+    auto size{nodes.size()};
+    auto parts{std::min(threads, size / kFlushChunk)};
+    if (parts < 2) {
+      return encode(0, size);
+    }
+    std::vector<std::future<outcome::result<EncodedLevel>>> futures;
+    for (size_t part{0}; part < parts; ++part) {
+      futures.push_back(std::async(std::launch::async,
+                                   encode,
+                                   size * part / parts,
+                                   size * (part + 1) / parts));
+    }
+    EncodedLevel level;
+    level.encoded.reserve(size);
+    level.cids.reserve(size);
+    for (auto &future : futures) {
+      auto part{future.get()};
+      if (!part) {
+        return part.error();
+      }
+      auto &[encoded, cids] = part.value();
+      std::move(
+          encoded.begin(), encoded.end(), std::back_inserter(level.encoded));
+      std::move(cids.begin(), cids.end(), std::back_inserter(level.cids));
+    }
+    return std::move(level);
+  }
+}  // namespace fc::storage::ipld
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPLD_ENCODE_LEVEL_HPP
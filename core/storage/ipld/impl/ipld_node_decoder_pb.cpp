@@ -8,32 +8,32 @@
 namespace fc::storage::ipld {
   outcome::result<void> IPLDNodeDecoderPB::decode(
       gsl::span<const uint8_t> input) {
-    const uint8_t *raw_bytes = input.data();
-    if (pb_node_.ParseFromArray(raw_bytes, input.size())) {
-      return outcome::success();
+    auto node = dag_pb::decode(input);
+    if (!node) {
+      return IPLDNodeDecoderPBError::INVALID_RAW_BYTES;
     }
-    return IPLDNodeDecoderPBError::INVALID_RAW_BYTES;
+    pb_node_ = std::move(node.value());
+    return outcome::success();
   }
 
-  const std::string &IPLDNodeDecoderPB::getContent() const {
-    return pb_node_.data();
+  gsl::span<const uint8_t> IPLDNodeDecoderPB::getContent() const {
+    return pb_node_.data;
   }
 
   size_t IPLDNodeDecoderPB::getLinksCount() const {
-    return pb_node_.links_size();
+    return pb_node_.links.size();
   }
 
-  const std::string &IPLDNodeDecoderPB::getLinkName(size_t index) const {
-    return pb_node_.links(index).name();
+  std::string_view IPLDNodeDecoderPB::getLinkName(size_t index) const {
+    return pb_node_.links.at(index).name;
   }
 
-  const std::string &IPLDNodeDecoderPB::getLinkCID(size_t index) const {
-    return pb_node_.links(index).hash();
+  gsl::span<const uint8_t> IPLDNodeDecoderPB::getLinkCID(size_t index) const {
+    return pb_node_.links.at(index).cid;
   }
 
   size_t IPLDNodeDecoderPB::getLinkSize(size_t index) const {
-    int size = pb_node_.links(index).tsize();
-    return size < 0 ? 0 : static_cast<size_t>(size);
+    return pb_node_.links.at(index).size;
   }
 }  // namespace fc::storage::ipld
 
@@ -11,11 +11,13 @@
 #include <gsl/span>
 #include "common/buffer.hpp"
 #include "common/outcome.hpp"
-#include "storage/ipld/impl/protobuf/ipld_node.pb.h"
+#include "storage/ipld/dag_pb.hpp"
 
 namespace fc::storage::ipld {
   /**
    * @class     Protobuf Node decoder
+   * @details   Decoded parts point into input bytes, input must outlive
+   *            decoder
    */
   class IPLDNodeDecoderPB {
    public:
@@ -30,7 +32,7 @@ namespace fc::storage::ipld {
      * @brief Get Node content
      * @return content data
      */
-    const std::string &getContent() const;
+    gsl::span<const uint8_t> getContent() const;
 
     /**
      * @brief Get count of the children
@@ -43,14 +45,14 @@ namespace fc::storage::ipld {
      * @param index - id of the link
      * @return operation result
      */
-    const std::string &getLinkName(size_t index) const;
+    std::string_view getLinkName(size_t index) const;
 
     /**
      * @brief Get CID of the children
      * @param index - id of the link
      * @return CID bytes
      */
-    const std::string &getLinkCID(size_t index) const;
+    gsl::span<const uint8_t> getLinkCID(size_t index) const;
 
     /**
      * @brief Get name of the link to the children
@@ -60,14 +62,14 @@ namespace fc::storage::ipld {
     size_t getLinkSize(size_t index) const;
 
    private:
-    ::protobuf::ipld::node::PBNode pb_node_;
+    dag_pb::PbNode pb_node_;
   };
 
   /**
    * @enum Possible PBNodeDecoder errors
    */
   enum class IPLDNodeDecoderPBError { INVALID_RAW_BYTES = 1 };
-}  // namespace fc::storage::ipfs::merkledag
+}  // namespace fc::storage::ipld
 
 OUTCOME_HPP_DECLARE_ERROR(fc::storage::ipld, IPLDNodeDecoderPBError)
 
@@ -32,67 +32,20 @@ namespace fc::storage::ipld {
      * @param links - references for child Nodes
      * @return Protobuf-encoded data
      */
-    static std::vector<uint8_t> encode(const common::Buffer &content,
-                                 const std::map<std::string, IPLDLinkImpl> &links);
-
-   private:
-    using PBTag = uint8_t;
-
-    // Protobuf wire types
-    enum class PBFieldType : uint8_t {
-      VARINT = 0,
-      BITS_64,
-      LENGTH_DELEMITED,
-      START_GROUP,
-      END_GROUP,
-      BITS_32
-    };
-
-    enum class PBLinkOrder : uint8_t { HASH = 1, NAME, SIZE };
-
-    enum class PBNodeOrder : uint8_t { DATA = 1, LINKS };
-
-    // Serialized content
-    common::Buffer data_;
-
-    /**
-     * @brief Calculate length of the serialized link
-     * @param name - link name
-     * @param link - child link
-     * @return Number of bytes
-     */
-    static size_t getLinkLengthPB(const std::string &name, const IPLDLinkImpl &link);
-
-    /**
-     * @brief Calculate length of the serialized content
-     * @param content - Node's data
-     * @return Number of bytes
-     */
-    static size_t getContentLengthPB(const common::Buffer &content);
-
-    /**
-     * @brief Serialized Node's links
-     * @param links - Node's children
-     * @return Raw bytes
-     */
-    static std::vector<uint8_t> serializeLinks(
+    static std::vector<uint8_t> encode(
+        const common::Buffer &content,
         const std::map<std::string, IPLDLinkImpl> &links);
 
     /**
-     * @brief Serialized Node's content
-     * @param content - Node's data
-     * @return Raw bytes
-     */
-    static std::vector<uint8_t> serializeContent(const common::Buffer &content);
-
-    /**
-     * @brief Create Protobuf filed header
-     * @param type - field type
-     * @param order - field order
-     * @return Tag value
+     * @brief Serialize Node into reused buffer, without intermediate copies
+     * @param content - Node data
+     * @param links - references for child Nodes
+     * @param output - buffer to append encoded Node to
      */
-    static PBTag createTag(PBFieldType type, uint8_t order);
+    static void encode(const common::Buffer &content,
+                       const std::map<std::string, IPLDLinkImpl> &links,
+                       common::Buffer &output);
   };
-}  // namespace fc::storage::ipfs::merkledag
+}  // namespace fc::storage::ipld
 
 #endif
@@ -6,10 +6,6 @@
 #include "storage/ipld/impl/ipld_node_impl.hpp"
 
 #include "storage/ipld/impl/ipld_node_decoder_pb.hpp"
-#include "storage/ipld/impl/protobuf/ipld_node.pb.h"
-
-using protobuf::ipld::node::PBLink;
-using protobuf::ipld::node::PBNode;
 
 namespace fc::storage::ipld {
 
@@ -75,7 +71,9 @@ namespace fc::storage::ipld {
   }
 
   IPLDNode::Buffer IPLDNodeImpl::serialize() const {
-    return Buffer{IPLDNodeEncoderPB::encode(content_, links_)};
+    Buffer bytes;
+    IPLDNodeEncoderPB::encode(content_, links_, bytes);
+    return bytes;
   }
 
   std::shared_ptr<IPLDNode> IPLDNodeImpl::createFromString(
@@ -92,15 +90,16 @@ namespace fc::storage::ipld {
     if (auto result = decoder.decode(input); result.has_error()) {
       return result.error();
     }
-    auto node = createFromString(decoder.getContent());
+    auto node = std::make_shared<IPLDNodeImpl>();
+    node->content_ = Buffer{decoder.getContent()};
     for (size_t i = 0; i < decoder.getLinksCount(); ++i) {
-      std::vector<uint8_t> link_cid_bytes{decoder.getLinkCID(i).begin(),
-                                          decoder.getLinkCID(i).end()};
-      OUTCOME_TRY(link_cid, CID::fromBytes(link_cid_bytes));
-      IPLDLinkImpl link{
-          std::move(link_cid), decoder.getLinkName(i), decoder.getLinkSize(i)};
-      node->addLink(link);
+      OUTCOME_TRY(link_cid, CID::fromBytes(decoder.getLinkCID(i)));
+      std::string name{decoder.getLinkName(i)};
+      IPLDLinkImpl link{std::move(link_cid), name, decoder.getLinkSize(i)};
+      node->links_.emplace(std::move(name), std::move(link));
     }
+    // cid of input bytes, instead of encoding node again to hash it
+    node->ipld_block_ = IPLDBlock{dag_pb::cid(input), Buffer{input}};
     return node;
   }
 
@@ -55,7 +55,6 @@ namespace fc::storage::ipld {
    private:
     common::Buffer content_;
     std::map<std::string, IPLDLinkImpl> links_;
-    IPLDNodeEncoderPB pb_node_codec_;
     size_t child_nodes_size_{};
     mutable boost::optional<IPLDBlock> ipld_block_;
   };
@@ -0,0 +1,76 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPLD_LAZY_TUPLE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPLD_LAZY_TUPLE_HPP
+
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipld {
+  using codec::cbor::CborDecodeError;
+  using codec::cbor::CborDecodeStream;
+
+  /// Field of CBOR tuple with its type
+  template <typename T>
+  struct LazyField {
+    size_t index;
+  };
+
+  /**
+   * CBOR tuple with fields decoded on access. Keeps encoded block and
+   * positions of fields, so reading one field of large actor state does not
+   * decode other fields.
+   */
+  class LazyTuple {
+   public:
+    static outcome::result<LazyTuple> load(IpldPtr ipld, const CID &cid) {
+      OUTCOME_TRY(bytes, ipld->get(cid));
+      return create(std::move(ipld), std::move(bytes));
+    }
+
+    static outcome::result<LazyTuple> create(
+        IpldPtr ipld, ipfs::IpfsDatastore::Value encoded) {
+      LazyTuple tuple;
+      try {
+        auto s{CborDecodeStream::borrow(encoded)};
+        auto n{s.listLength()};
+        auto l{s.list()};
+        tuple.fields_.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+          auto raw{l.rawView()};
+          tuple.fields_.emplace_back(raw.data() - encoded.data(), raw.size());
+        }
+      } catch (std::system_error &e) {
+        return outcome::failure(e.code());
+      }
+      tuple.ipld_ = std::move(ipld);
+      tuple.encoded_ = std::move(encoded);
+      return tuple;
+    }
+
+    size_t size() const {
+      return fields_.size();
+    }
+
+    /// Decode field, adt handles in it are loaded with ipld
+    template <typename T>
+    outcome::result<T> get(LazyField<T> field) const {
+      if (field.index >= fields_.size()) {
+        return CborDecodeError::WRONG_SIZE;
+      }
+      const auto &[offset, size] = fields_[field.index];
+      return ipld_->decode<T>(
+          gsl::span<const uint8_t>{encoded_}.subspan(offset, size));
+    }
+
+   private:
+    IpldPtr ipld_;
+    ipfs::IpfsDatastore::Value encoded_;
+    /// Offset and size of encoded fields
+    std::vector<std::pair<size_t, size_t>> fields_;
+  };
+}  // namespace fc::storage::ipld
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPLD_LAZY_TUPLE_HPP
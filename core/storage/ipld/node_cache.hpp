@@ -0,0 +1,111 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPLD_NODE_CACHE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPLD_NODE_CACHE_HPP
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "primitives/cid/cid.hpp"
+
+namespace fc::storage::ipld {
+
+  /// Generation shared by all node caches
+  inline std::atomic<uint64_t> &nodeCacheGeneration() {
+    static std::atomic<uint64_t> generation{0};
+    return generation;
+  }
+
+  /**
+   * Drops nodes from all node caches.
+   * Must be called after blocks are deleted from store, so cached nodes don't
+   * hide missing blocks.
+   */
+  inline void invalidateNodeCaches() {
+    ++nodeCacheGeneration();
+  }
+
+  /**
+   * Bounded LRU cache of decoded immutable nodes by CID.
+   * Nodes are shared as const, users must copy node before mutation.
+   * @tparam T decoded node type
+   */
+  template <typename T>
+  class NodeCache {
+   public:
+    using Ptr = std::shared_ptr<const T>;
+
+    explicit NodeCache(size_t capacity)
+        : capacity_{capacity}, generation_{nodeCacheGeneration()} {}
+
+    /// Get node and mark it as recently used, nullptr if not cached
+    Ptr get(const CID &cid) {
+      std::lock_guard lock{mutex_};
+      sync();
+      auto it = index_.find(cid);
+      if (it == index_.end()) {
+        return nullptr;
+      }
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->second;
+    }
+
+    /// Insert node, evicting least recently used nodes over capacity
+    void put(const CID &cid, Ptr node) {
+      std::lock_guard lock{mutex_};
+      if (capacity_ == 0) {
+        return;
+      }
+      sync();
+      auto it = index_.find(cid);
+      if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+      }
+      lru_.emplace_front(cid, std::move(node));
+      index_.emplace(cid, lru_.begin());
+      while (lru_.size() > capacity_) {
+        index_.erase(lru_.back().first);
+        lru_.pop_back();
+      }
+    }
+
+    void clear() {
+      std::lock_guard lock{mutex_};
+      index_.clear();
+      lru_.clear();
+    }
+
+    size_t size() const {
+      std::lock_guard lock{mutex_};
+      return generation_ == nodeCacheGeneration() ? lru_.size() : 0;
+    }
+
+   private:
+    using Lru = std::list<std::pair<CID, Ptr>>;
+
+    /// Drops nodes cached before invalidation
+    void sync() {
+      auto generation{nodeCacheGeneration().load()};
+      if (generation_ != generation) {
+        generation_ = generation;
+        index_.clear();
+        lru_.clear();
+      }
+    }
+
+    size_t capacity_;
+    uint64_t generation_;
+    mutable std::mutex mutex_;
+    Lru lru_;
+    std::unordered_map<CID, typename Lru::iterator> index_;
+  };
+
+}  // namespace fc::storage::ipld
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPLD_NODE_CACHE_HPP
@@ -0,0 +1,204 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/selector.hpp"
+
+namespace fc::storage::ipld {
+  using codec::cbor::CborDecodeError;
+
+  namespace {
+    using Map = std::map<std::string, CborDecodeStream>;
+
+    CborDecodeStream &at(Map &map, const std::string &key) {
+      auto it = map.find(key);
+      if (it == map.end()) {
+        outcome::raise(CborDecodeError::WRONG_TYPE);
+      }
+      return it->second;
+    }
+
+    auto ptr(Selector selector) {
+      return std::make_shared<const Selector>(std::move(selector));
+    }
+  }  // namespace
+
+  Selector::Selector()
+      : Selector{exploreRecursive(boost::none,
+                                  exploreAll(exploreRecursiveEdge()))} {}
+
+  Selector::Selector(Kind kind) : kind{kind} {}
+
+  Selector Selector::matcher() {
+    return Selector{Kind::MATCHER};
+  }
+
+  Selector Selector::exploreAll(Selector next) {
+    Selector selector{Kind::EXPLORE_ALL};
+    selector.next = ptr(std::move(next));
+    return selector;
+  }
+
+  Selector Selector::exploreFields(std::map<std::string, Selector> fields) {
+    Selector selector{Kind::EXPLORE_FIELDS};
+    for (auto &field : fields) {
+      selector.fields.emplace(field.first, ptr(std::move(field.second)));
+    }
+    return selector;
+  }
+
+  Selector Selector::exploreIndex(uint64_t index, Selector next) {
+    Selector selector{Kind::EXPLORE_INDEX};
+    selector.begin = index;
+    selector.next = ptr(std::move(next));
+    return selector;
+  }
+
+  Selector Selector::exploreRange(uint64_t begin,
+                                  uint64_t end,
+                                  Selector next) {
+    Selector selector{Kind::EXPLORE_RANGE};
+    selector.begin = begin;
+    selector.end = end;
+    selector.next = ptr(std::move(next));
+    return selector;
+  }
+
+  Selector Selector::exploreRecursive(boost::optional<uint64_t> depth,
+                                      Selector sequence) {
+    Selector selector{Kind::EXPLORE_RECURSIVE};
+    selector.depth = depth;
+    selector.next = ptr(std::move(sequence));
+    return selector;
+  }
+
+  Selector Selector::exploreRecursiveEdge() {
+    return Selector{Kind::EXPLORE_RECURSIVE_EDGE};
+  }
+
+  Selector Selector::exploreUnion(std::vector<Selector> selectors) {
+    Selector selector{Kind::EXPLORE_UNION};
+    for (auto &member : selectors) {
+      selector.selectors.push_back(ptr(std::move(member)));
+    }
+    return selector;
+  }
+
+  CborEncodeStream Selector::encode() const {
+    auto body = CborEncodeStream::map();
+    auto m = CborEncodeStream::map();
+    switch (kind) {
+      case Kind::MATCHER:
+        m["."] << body;
+        break;
+      case Kind::EXPLORE_ALL:
+        body[">"] << *next;
+        m["a"] << body;
+        break;
+      case Kind::EXPLORE_FIELDS: {
+        auto fields_map = CborEncodeStream::map();
+        for (auto &field : fields) {
+          fields_map[field.first] << *field.second;
+        }
+        body["f>"] << fields_map;
+        m["f"] << body;
+        break;
+      }
+      case Kind::EXPLORE_INDEX:
+        body["i"] << begin;
+        body[">"] << *next;
+        m["i"] << body;
+        break;
+      case Kind::EXPLORE_RANGE:
+        body["^"] << begin;
+        body["$"] << end;
+        body[">"] << *next;
+        m["r"] << body;
+        break;
+      case Kind::EXPLORE_RECURSIVE: {
+        auto limit = CborEncodeStream::map();
+        if (depth) {
+          limit["depth"] << *depth;
+        } else {
+          limit["none"] << CborEncodeStream::map();
+        }
+        body["l"] << limit;
+        body[":>"] << *next;
+        m["R"] << body;
+        break;
+      }
+      case Kind::EXPLORE_RECURSIVE_EDGE:
+        m["@"] << body;
+        break;
+      case Kind::EXPLORE_UNION: {
+        auto l = CborEncodeStream::list();
+        for (auto &member : selectors) {
+          l << *member;
+        }
+        m["|"] << l;
+        break;
+      }
+    }
+    CborEncodeStream s;
+    s << m;
+    return s;
+  }
+
+  Selector Selector::decode(CborDecodeStream &s) {
+    auto m = s.map();
+    if (m.size() != 1) {
+      outcome::raise(CborDecodeError::WRONG_TYPE);
+    }
+    auto &key = m.begin()->first;
+    auto &value = m.begin()->second;
+    if (key == ".") {
+      return matcher();
+    }
+    if (key == "@") {
+      return exploreRecursiveEdge();
+    }
+    if (key == "|") {
+      std::vector<Selector> selectors;
+      auto n = value.listLength();
+      for (auto l = value.list(); n != 0; --n) {
+        selectors.push_back(decode(l));
+      }
+      return exploreUnion(std::move(selectors));
+    }
+    auto body = value.map();
+    if (key == "a") {
+      return exploreAll(decode(at(body, ">")));
+    }
+    if (key == "f") {
+      std::map<std::string, Selector> fields;
+      for (auto &field : at(body, "f>").map()) {
+        fields.emplace(field.first, decode(field.second));
+      }
+      return exploreFields(std::move(fields));
+    }
+    if (key == "i") {
+      uint64_t index;
+      at(body, "i") >> index;
+      return exploreIndex(index, decode(at(body, ">")));
+    }
+    if (key == "r") {
+      uint64_t begin, end;
+      at(body, "^") >> begin;
+      at(body, "$") >> end;
+      return exploreRange(begin, end, decode(at(body, ">")));
+    }
+    if (key == "R") {
+      auto limit = at(body, "l").map();
+      boost::optional<uint64_t> depth;
+      if (limit.count("depth") != 0) {
+        depth.emplace();
+        at(limit, "depth") >> *depth;
+      } else if (limit.count("none") == 0) {
+        outcome::raise(CborDecodeError::WRONG_TYPE);
+      }
+      return exploreRecursive(depth, decode(at(body, ":>")));
+    }
+    outcome::raise(CborDecodeError::WRONG_TYPE);
+  }
+}  // namespace fc::storage::ipld
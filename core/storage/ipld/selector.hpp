@@ -0,0 +1,105 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPLD_SELECTOR_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPLD_SELECTOR_HPP
+
+#include <map>
+#include <memory>
+
+#include <boost/optional.hpp>
+
+#include "codec/cbor/cbor_decode_stream.hpp"
+#include "codec/cbor/cbor_encode_stream.hpp"
+
+namespace fc::storage::ipld {
+  using codec::cbor::CborDecodeStream;
+  using codec::cbor::CborEncodeStream;
+
+  /**
+   * IPLD selector, subset of IPLD selector spec without conditions and
+   * recursion stop conditions. Default constructed selector explores whole
+   * dag.
+   */
+  struct Selector {
+    enum class Kind {
+      MATCHER,
+      EXPLORE_ALL,
+      EXPLORE_FIELDS,
+      EXPLORE_INDEX,
+      EXPLORE_RANGE,
+      EXPLORE_RECURSIVE,
+      EXPLORE_RECURSIVE_EDGE,
+      EXPLORE_UNION,
+    };
+    using Ptr = std::shared_ptr<const Selector>;
+
+    /// Explores whole dag recursively
+    Selector();
+
+    static Selector matcher();
+
+    /// Explores all list items and map values with next
+    static Selector exploreAll(Selector next);
+
+    /// Explores map values by keys
+    static Selector exploreFields(std::map<std::string, Selector> fields);
+
+    /// Explores list item with next
+    static Selector exploreIndex(uint64_t index, Selector next);
+
+    /// Explores list items from begin to end exclusive with next
+    static Selector exploreRange(uint64_t begin, uint64_t end, Selector next);
+
+    /**
+     * Explores node with sequence, edges of sequence repeat it
+     * @param depth - max number of edges followed, none for unlimited
+     * @param sequence - recursion body
+     */
+    static Selector exploreRecursive(boost::optional<uint64_t> depth,
+                                     Selector sequence);
+
+    /// Repeats sequence of innermost recursion
+    static Selector exploreRecursiveEdge();
+
+    /// Explores node with each selector
+    static Selector exploreUnion(std::vector<Selector> selectors);
+
+    /// Encodes selector in IPLD selector spec format
+    CborEncodeStream encode() const;
+
+    /**
+     * @brief decodes selector in IPLD selector spec format, raises
+     * CborDecodeError on unsupported selector
+     */
+    static Selector decode(CborDecodeStream &s);
+
+    Kind kind;
+    /// Next of explore all, index and range, sequence of recursion
+    Ptr next;
+    std::map<std::string, Ptr> fields;
+    std::vector<Ptr> selectors;
+    /// Index of explore index, range begin
+    uint64_t begin{};
+    /// Range end
+    uint64_t end{};
+    /// Recursion limit
+    boost::optional<uint64_t> depth;
+
+   private:
+    explicit Selector(Kind kind);
+  };
+
+  CBOR_ENCODE(Selector, selector) {
+    return s << selector.encode();
+  }
+
+  CBOR_DECODE(Selector, selector) {
+    selector = Selector::decode(s);
+    return s;
+  }
+}  // namespace fc::storage::ipld
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPLD_SELECTOR_HPP
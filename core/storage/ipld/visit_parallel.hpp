@@ -0,0 +1,94 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_IPLD_VISIT_PARALLEL_HPP
+#define CPP_FILECOIN_CORE_STORAGE_IPLD_VISIT_PARALLEL_HPP
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <vector>
+
+#include "common/outcome.hpp"
+
+namespace fc::storage::ipld {
+  /// Max threads of parallel hamt and amt visit
+  constexpr size_t kVisitThreads{8};
+
+  /**
+   * Visits independent subtrees of tree concurrently, each thread gets
+   * contiguous run of subtrees and loads their nodes itself, so reads of
+   * siblings overlap.
+   * @param subtrees - count of subtrees, in tree order
+   * @param visit_subtree - visits pairs of subtree by index until callback
+   * returns false, called concurrently
+   * @param visitor - called concurrently if not ordered, otherwise pairs are
+   * collected and visitor is called on calling thread in tree order
+   */
+  template <typename Key, typename Value>
+  outcome::result<void> visitParallel(
+      size_t subtrees,
+      size_t threads,
+      bool ordered,
+      const std::function<outcome::result<bool>(
+          size_t,
+          const std::function<outcome::result<bool>(const Key &,
+                                                    const Value &)> &)>
+          &visit_subtree,
+      const std::function<outcome::result<void>(const Key &, const Value &)>
+          &visitor) {
+    auto parts{std::max<size_t>(1, std::min(threads, subtrees))};
+    std::vector<std::vector<std::pair<Key, Value>>> pairs(ordered ? parts : 0);
+    // set by first failed thread, so others stop early
+    std::atomic_bool stop{false};
+    auto visit_part{[&](size_t part) -> outcome::result<void> {
+      auto on_pair{[&](auto &key, auto &value) -> outcome::result<bool> {
+        if (stop.load(std::memory_order_relaxed)) {
+          return false;
+        }
+        if (ordered) {
+          pairs[part].emplace_back(key, value);
+        } else {
+          OUTCOME_TRY(visitor(key, value));
+        }
+        return true;
+      }};
+      for (auto i{subtrees * part / parts}; i < subtrees * (part + 1) / parts;
+           ++i) {
+        auto more{visit_subtree(i, on_pair)};
+        if (!more) {
+          stop = true;
+          return more.error();
+        }
+        if (!more.value()) {
+          break;
+        }
+      }
+      return outcome::success();
+    }};
+    std::vector<std::future<outcome::result<void>>> futures;
+    for (size_t part{1}; part < parts; ++part) {
+      futures.push_back(std::async(std::launch::async, visit_part, part));
+    }
+    auto result{visit_part(0)};
+    for (auto &future : futures) {
+      auto part_result{future.get()};
+      if (result && !part_result) {
+        result = part_result;
+      }
+    }
+    if (!result) {
+      return result.error();
+    }
+    for (auto &part : pairs) {
+      for (auto &[key, value] : part) {
+        OUTCOME_TRY(visitor(key, value));
+      }
+    }
+    return outcome::success();
+  }
+}  // namespace fc::storage::ipld
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_IPLD_VISIT_PARALLEL_HPP
@@ -5,81 +5,235 @@
 
 #include "storage/ipld/walker.hpp"
 
-#include <google/protobuf/io/coded_stream.h>
-#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <boost/asio/post.hpp>
 
-namespace fc::storage::ipld::walker {
-  using google::protobuf::io::CodedInputStream;
-  using Input = gsl::span<const uint8_t>;
-
-  struct PbDecoder {
-    PbDecoder(Input input) : input{input}, cs(input.data(), input.size()) {}
+#include "storage/ipld/dag_pb.hpp"
 
-    Input _str(uint64_t id) {
-      if (cs.ExpectTag((id << 3) | 2)) {
-        int size;
-        if (cs.ReadVarintSizeAsInt(&size)) {
-          auto offset = cs.CurrentPosition();
-          if (cs.Skip(size)) {
-            return input.subspan(offset, size);
-          }
-        }
+namespace fc::storage::ipld::walker {
+  void cborLinks(CborDecodeStream &s, std::vector<CID> &cids) {
+    if (s.isCid()) {
+      CID cid;
+      s >> cid;
+      cids.push_back(std::move(cid));
+    } else if (s.isList()) {
+      auto n = s.listLength();
+      for (auto l = s.list(); n != 0; --n) {
+        cborLinks(l, cids);
+      }
+    } else if (s.isMap()) {
+      for (auto &p : s.map()) {
+        cborLinks(p.second, cids);
       }
-      return {};
+    } else {
+      s.next();
     }
+  }
 
-    bool empty() {
-      return cs.CurrentPosition() >= input.size();
+  Walker::Walker(Ipld &store, size_t prefetch_threads) : store{store} {
+    if (prefetch_threads != 0) {
+      pool_ = std::make_unique<boost::asio::thread_pool>(prefetch_threads);
     }
+  }
 
-    Input input;
-    CodedInputStream cs;
-  };
-
-  struct PbNodeDecoder {
-    static outcome::result<std::vector<CID>> links(
-        gsl::span<const uint8_t> input) {
-      std::vector<CID> cids;
-      PbDecoder s{input};
-      while (true) {
-        PbDecoder link{s._str(2)};
-        if (link.empty()) {
-          break;
-        }
-        auto cid_bytes = link._str(1);
-        OUTCOME_TRY(cid, CID::fromBytes(cid_bytes));
-        cids.push_back(std::move(cid));
-      }
-      return std::move(cids);
+  Walker::~Walker() {
+    if (pool_) {
+      pool_->join();
     }
-  };
+  }
 
   outcome::result<void> Walker::select(const CID &root,
                                        const Selector &selector) {
-    // TODO(turuslan): implement selectors
-    return recursiveAll(root);
+    return select(root, selector, [this](auto &cid, auto &) {
+      cids.push_back(cid);
+      return outcome::success();
+    });
+  }
+
+  outcome::result<void> Walker::select(const CID &root,
+                                       const Selector &selector,
+                                       const BlockCallback &on_block) {
+    on_block_ = &on_block;
+    auto result = visitBlock(root, selector, {});
+    on_block_ = nullptr;
+    explored_.clear();
+    return result;
   }
 
   outcome::result<void> Walker::recursiveAll(const CID &cid) {
-    if (visited.insert(cid).second) {
+    if (visited.count(cid) == 0) {
+      OUTCOME_TRY(bytes, load(cid));
       cids.push_back(cid);
-      OUTCOME_TRY(bytes, store.get(cid));
-      // TODO(turuslan): what about other types?
+      OUTCOME_TRY(children, links(cid, bytes));
+      prefetch(children);
+      for (auto &child : children) {
+        OUTCOME_TRY(recursiveAll(child));
+      }
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> Walker::visitBlock(const CID &cid,
+                                           const Selector &selector,
+                                           const Recursion &recursion) {
+    if (!explored_
+             .emplace(cid,
+                      &selector,
+                      recursion.sequence,
+                      recursion.depth.value_or(UINT64_MAX))
+             .second) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(bytes, load(cid));
+    if (selector.kind == Selector::Kind::MATCHER) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(children, links(cid, bytes));
+    prefetch(children);
+    try {
       if (cid.content_type == libp2p::multi::MulticodecType::DAG_CBOR) {
-        try {
-          CborDecodeStream s{bytes};
-          recursiveAll(s);
-        } catch (std::system_error &e) {
-          return outcome::failure(e.code());
+        visitNode(bytes, selector, recursion);
+      } else if (!children.empty()) {
+        // other blocks are explored as list of their links
+        CborEncodeStream list;
+        list << children;
+        visitNode(list.data(), selector, recursion);
+      }
+    } catch (std::system_error &e) {
+      return outcome::failure(e.code());
+    }
+    return outcome::success();
+  }
+
+  void Walker::visitNode(gsl::span<const uint8_t> node,
+                         const Selector &selector,
+                         const Recursion &recursion) {
+    using Kind = Selector::Kind;
+    if (selector.kind == Kind::EXPLORE_RECURSIVE_EDGE) {
+      // edge is resolved before link is loaded
+      if (!recursion.sequence
+          || (recursion.depth && *recursion.depth == 0)) {
+        return;
+      }
+      auto next = recursion;
+      if (next.depth) {
+        --*next.depth;
+      }
+      return visitNode(node, *recursion.sequence, next);
+    }
+    auto s = CborDecodeStream::borrow(node);
+    if (s.isCid()) {
+      CID cid;
+      s >> cid;
+      auto result = visitBlock(cid, selector, recursion);
+      if (!result) {
+        outcome::raise(result.error());
+      }
+      return;
+    }
+    switch (selector.kind) {
+      case Kind::MATCHER:
+      case Kind::EXPLORE_RECURSIVE_EDGE:
+        return;
+      case Kind::EXPLORE_RECURSIVE:
+        return visitNode(
+            node, *selector.next, {selector.next.get(), selector.depth});
+      case Kind::EXPLORE_UNION:
+        for (auto &member : selector.selectors) {
+          visitNode(node, *member, recursion);
         }
-      } else if (cid.content_type == libp2p::multi::MulticodecType::DAG_PB) {
-        OUTCOME_TRY(cids, PbNodeDecoder::links(bytes));
-        for (auto &cid : cids) {
-          OUTCOME_TRY(recursiveAll(cid));
+        return;
+      case Kind::EXPLORE_FIELDS:
+        if (s.isMap()) {
+          auto map = s.map();
+          for (auto &field : selector.fields) {
+            auto it = map.find(field.first);
+            if (it != map.end()) {
+              visitNode(it->second.rawView(), *field.second, recursion);
+            }
+          }
         }
+        return;
+      case Kind::EXPLORE_ALL:
+        if (s.isMap()) {
+          for (auto &item : s.map()) {
+            visitNode(item.second.rawView(), *selector.next, recursion);
+          }
+          return;
+        }
+        [[fallthrough]];
+      case Kind::EXPLORE_INDEX:
+      case Kind::EXPLORE_RANGE: {
+        if (!s.isList()) {
+          return;
+        }
+        uint64_t begin{0}, end{s.listLength()};
+        if (selector.kind == Kind::EXPLORE_INDEX) {
+          begin = selector.begin;
+          end = std::min(end, begin + 1);
+        } else if (selector.kind == Kind::EXPLORE_RANGE) {
+          begin = selector.begin;
+          end = std::min(end, selector.end);
+        }
+        auto l = s.list();
+        for (uint64_t i = 0; i < end; ++i) {
+          auto item = l.rawView();
+          if (i >= begin) {
+            visitNode(item, *selector.next, recursion);
+          }
+        }
+        return;
       }
     }
-    return outcome::success();
+  }
+
+  outcome::result<Buffer> Walker::load(const CID &cid) {
+    outcome::result<Buffer> bytes{outcome::success()};
+    auto it = prefetched_.find(cid);
+    if (it != prefetched_.end()) {
+      bytes = it->second.get();
+      prefetched_.erase(it);
+    } else {
+      bytes = store.get(cid);
+    }
+    if (bytes && visited.insert(cid) && on_block_) {
+      OUTCOME_TRY((*on_block_)(cid, bytes.value()));
+    }
+    return bytes;
+  }
+
+  void Walker::prefetch(const std::vector<CID> &cids) {
+    if (!pool_) {
+      return;
+    }
+    for (auto &cid : cids) {
+      if (prefetched_.size() >= kMaxPrefetch) {
+        break;
+      }
+      if (visited.count(cid) != 0 || prefetched_.count(cid) != 0) {
+        continue;
+      }
+      std::packaged_task<outcome::result<Buffer>()> task{
+          [this, cid] { return store.get(cid); }};
+      prefetched_.emplace(cid, task.get_future().share());
+      boost::asio::post(*pool_, std::move(task));
+    }
+  }
+
+  outcome::result<std::vector<CID>> Walker::links(
+      const CID &cid, gsl::span<const uint8_t> bytes) {
+    std::vector<CID> cids;
+    // TODO(turuslan): what about other types?
+    if (cid.content_type == libp2p::multi::MulticodecType::DAG_CBOR) {
+      try {
+        CborDecodeStream s{bytes};
+        cborLinks(s, cids);
+      } catch (std::system_error &e) {
+        return outcome::failure(e.code());
+      }
+    } else if (cid.content_type == libp2p::multi::MulticodecType::DAG_PB) {
+      OUTCOME_TRYA(cids, dag_pb::decodeLinks(bytes));
+    }
+    return std::move(cids);
   }
 
   void Walker::recursiveAll(CborDecodeStream &s) {
@@ -6,27 +6,102 @@
 #ifndef CPP_FILECOIN_CORE_STORAGE_IPLD_WALKER_HPP
 #define CPP_FILECOIN_CORE_STORAGE_IPLD_WALKER_HPP
 
+#include <functional>
+#include <future>
+#include <set>
+#include <unordered_map>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include "primitives/cid/cb_cid.hpp"
 #include "storage/ipfs/datastore.hpp"
+#include "storage/ipld/selector.hpp"
 
 namespace fc::storage::ipld::walker {
   using codec::cbor::CborDecodeStream;
+  using common::Buffer;
+  using ipld::Selector;
   using Ipld = ipfs::IpfsDatastore;
 
-  // TODO(turuslan): implement selectors
-  struct Selector {};
-
+  /**
+   * Traverses dags, each block is loaded and reported once, in depth-first
+   * order. Links of loaded blocks are prefetched concurrently if prefetch
+   * threads are given, traversal order does not depend on prefetch.
+   */
   struct Walker {
-    Walker(Ipld &store) : store{store} {}
+    /// Called for each loaded block as soon as it is loaded
+    using BlockCallback =
+        std::function<outcome::result<void>(const CID &, const Buffer &)>;
+
+    /// Max blocks loaded ahead of traversal
+    static constexpr size_t kMaxPrefetch{256};
 
+    /**
+     * @param store - store to load blocks from, must allow concurrent reads
+     * if prefetch_threads is not zero
+     * @param prefetch_threads - threads loading blocks ahead of traversal
+     */
+    Walker(Ipld &store, size_t prefetch_threads = 0);
+
+    ~Walker();
+
+    /**
+     * @brief walks blocks matched by selector, loaded blocks are recorded in
+     * cids
+     */
     outcome::result<void> select(const CID &root, const Selector &selector);
 
+    /**
+     * @brief walks blocks matched by selector
+     * @param on_block - called for each block loaded first time
+     */
+    outcome::result<void> select(const CID &root,
+                                 const Selector &selector,
+                                 const BlockCallback &on_block);
+
     outcome::result<void> recursiveAll(const CID &cid);
 
     void recursiveAll(CborDecodeStream &s);
 
+    /**
+     * @brief decode cids linked by block, without loading them
+     * @param cid - block cid, defines codec
+     * @param bytes - block bytes
+     */
+    static outcome::result<std::vector<CID>> links(
+        const CID &cid, gsl::span<const uint8_t> bytes);
+
     Ipld &store;
-    std::set<CID> visited;
+    CidSet visited;
     std::vector<CID> cids;
+
+   private:
+    /// Innermost recursion
+    struct Recursion {
+      const Selector *sequence{};
+      boost::optional<uint64_t> depth;
+    };
+
+    outcome::result<void> visitBlock(const CID &cid,
+                                     const Selector &selector,
+                                     const Recursion &recursion);
+
+    void visitNode(gsl::span<const uint8_t> node,
+                   const Selector &selector,
+                   const Recursion &recursion);
+
+    /// Loads block, reports it if loaded first time
+    outcome::result<Buffer> load(const CID &cid);
+
+    void prefetch(const std::vector<CID> &cids);
+
+    std::unique_ptr<boost::asio::thread_pool> pool_;
+    std::unordered_map<CID, std::shared_future<outcome::result<Buffer>>>
+        prefetched_;
+    /// Explored pairs of block and selector state
+    std::set<std::tuple<CID, const Selector *, const Selector *, uint64_t>>
+        explored_;
+    const BlockCallback *on_block_{};
   };
 }  // namespace fc::storage::ipld::walker
 
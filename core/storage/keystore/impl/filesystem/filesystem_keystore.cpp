@@ -68,6 +68,7 @@ fc::outcome::result<void> FileSystemKeyStore::remove(
   if (!found) return KeyStoreError::NOT_FOUND;
   OUTCOME_TRY(path, addressToPath(address));
   OUTCOME_TRY(filestore_->remove(path));
+  evictKey(address);
   return fc::outcome::success();
 }
 
@@ -37,6 +37,7 @@ fc::outcome::result<void> InMemoryKeyStore::remove(
   OUTCOME_TRY(found, has(address));
   if (!found) return KeyStoreError::NOT_FOUND;
   storage_.erase(address);
+  evictKey(address);
   return fc::outcome::success();
 }
 
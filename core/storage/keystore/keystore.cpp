@@ -5,6 +5,9 @@
 
 #include "keystore.hpp"
 
+#include <sys/mman.h>
+#include <mutex>
+
 #include "common/visitor.hpp"
 
 namespace fc::storage::keystore {
@@ -14,12 +17,30 @@ namespace fc::storage::keystore {
   using primitives::address::Protocol;
   using primitives::address::Secp256k1PublicKeyHash;
 
+  namespace {
+    /// Overwrites key bytes, volatile keeps compiler from dropping writes
+    void wipe(KeyStore::TPrivateKey &key) {
+      boost::apply_visitor(
+          [](auto &bytes) {
+            volatile auto *data{bytes.data()};
+            for (size_t i{0}; i < bytes.size(); ++i) {
+              data[i] = 0;
+            }
+          },
+          key);
+    }
+  }  // namespace
+
   KeyStore::KeyStore(
       std::shared_ptr<BlsProvider> blsProvider,
       std::shared_ptr<Secp256k1ProviderDefault> secp256K1Provider)
       : bls_provider_(std::move(blsProvider)),
         secp256k1_provider_(std::move(secp256K1Provider)) {}
 
+  KeyStore::~KeyStore() {
+    evictKeys();
+  }
+
   fc::outcome::result<bool> KeyStore::checkAddress(
       const Address &address, const TPrivateKey &private_key) const noexcept {
     if (!address.isKeyType()) return false;
@@ -44,9 +65,7 @@ namespace fc::storage::keystore {
 
   fc::outcome::result<Signature> KeyStore::sign(
       const Address &address, gsl::span<const uint8_t> data) noexcept {
-    OUTCOME_TRY(private_key, get(address));
-    OUTCOME_TRY(valid, checkAddress(address, private_key));
-    if (!valid) return KeyStoreError::WRONG_ADDRESS;
+    OUTCOME_TRY(private_key, cachedKey(address));
 
     if (address.getProtocol() == Protocol::BLS) {
       OUTCOME_TRY(
@@ -64,6 +83,45 @@ namespace fc::storage::keystore {
     return KeyStoreError::WRONG_ADDRESS;
   }
 
+  void KeyStore::evictKey(const Address &address) noexcept {
+    std::unique_lock lock{keys_mutex_};
+    auto it{keys_.find(address)};
+    if (it != keys_.end()) {
+      wipe(it->second);
+      keys_.erase(it);
+    }
+  }
+
+  void KeyStore::evictKeys() noexcept {
+    std::unique_lock lock{keys_mutex_};
+    for (auto &[address, key] : keys_) {
+      wipe(key);
+    }
+    keys_.clear();
+  }
+
+  outcome::result<KeyStore::TPrivateKey> KeyStore::cachedKey(
+      const Address &address) noexcept {
+    {
+      std::shared_lock lock{keys_mutex_};
+      auto it{keys_.find(address)};
+      if (it != keys_.end()) {
+        return it->second;
+      }
+    }
+    OUTCOME_TRY(private_key, get(address));
+    OUTCOME_TRY(valid, checkAddress(address, private_key));
+    if (!valid) return KeyStoreError::WRONG_ADDRESS;
+    std::unique_lock lock{keys_mutex_};
+    auto [it, inserted]{keys_.emplace(address, private_key)};
+    if (inserted) {
+      // page is not unlocked on eviction, it may hold other keys;
+      // failure over RLIMIT_MEMLOCK leaves key swappable
+      mlock(&it->second, sizeof(it->second));
+    }
+    return it->second;
+  }
+
   fc::outcome::result<bool> KeyStore::verify(const Address &address,
                                              gsl::span<const uint8_t> data,
                                              const Signature &signature) const
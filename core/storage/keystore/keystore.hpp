@@ -7,6 +7,8 @@
 #define FILECOIN_CORE_STORAGE_KEYSTORE_HPP
 
 #include <gsl/span>
+#include <map>
+#include <shared_mutex>
 
 #include <boost/variant.hpp>
 #include "common/outcome.hpp"
@@ -33,7 +35,9 @@ namespace fc::storage::keystore {
   using primitives::address::Address;
 
   /**
-   * An interface to a facility to store and use cryptographic keys
+   * An interface to a facility to store and use cryptographic keys.
+   * Keys used for signing are cached checked in memory locked from swap,
+   * so implementations read them once. Sign may be called concurrently.
    */
   class KeyStore {
    public:
@@ -42,7 +46,8 @@ namespace fc::storage::keystore {
     KeyStore(std::shared_ptr<BlsProvider> blsProvider,
              std::shared_ptr<Secp256k1ProviderDefault> secp256K1Provider);
 
-    virtual ~KeyStore() = default;
+    /// Wipes cached keys
+    virtual ~KeyStore();
 
     /**
      * @brief Whether or not key exists in the Keystore
@@ -91,6 +96,12 @@ namespace fc::storage::keystore {
                                          const Signature &signature) const
         noexcept;
 
+    /// Wipes cached key of address, it is read again by next sign
+    void evictKey(const Address &address) noexcept;
+
+    /// Wipes all cached keys
+    void evictKeys() noexcept;
+
    protected:
     /**
      * @brief Check address and key are valid
@@ -110,8 +121,14 @@ namespace fc::storage::keystore {
         noexcept = 0;
 
    private:
+    /// Checked key from cache, or from get() on first use
+    outcome::result<TPrivateKey> cachedKey(const Address &address) noexcept;
+
     std::shared_ptr<BlsProvider> bls_provider_;
     std::shared_ptr<Secp256k1ProviderDefault> secp256k1_provider_;
+    std::shared_mutex keys_mutex_;
+    /// Map nodes are not moved, so locked pages of keys stay valid
+    std::map<Address, TPrivateKey> keys_;
   };
 
 }  // namespace fc::storage::keystore
@@ -0,0 +1,65 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/keystore/signing_service.hpp"
+
+#include <boost/asio/post.hpp>
+#include <condition_variable>
+#include <mutex>
+
+namespace fc::storage::keystore {
+  SigningService::SigningService(std::shared_ptr<KeyStore> keystore,
+                                 size_t threads)
+      : keystore_{std::move(keystore)},
+        threads_{std::max<size_t>(threads, 1)},
+        pool_{threads_} {}
+
+  SigningService::~SigningService() {
+    pool_.stop();
+    pool_.join();
+  }
+
+  void SigningService::sign(const Address &address,
+                            Buffer data,
+                            Callback callback) {
+    boost::asio::post(pool_,
+                      [keystore{keystore_},
+                       address,
+                       data{std::move(data)},
+                       callback{std::move(callback)}] {
+                        callback(keystore->sign(address, data));
+                      });
+  }
+
+  std::vector<outcome::result<Signature>> SigningService::signAll(
+      const std::vector<Request> &requests) {
+    std::vector<outcome::result<Signature>> signatures(
+        requests.size(), KeyStoreError::NOT_FOUND);
+    // one task per thread, so small signatures don't pay for queueing
+    auto chunk{(requests.size() + threads_ - 1) / threads_};
+    if (chunk == 0) {
+      return signatures;
+    }
+    std::mutex mutex;
+    std::condition_variable cv;
+    auto remaining{(requests.size() + chunk - 1) / chunk};
+    for (size_t begin{0}; begin < requests.size(); begin += chunk) {
+      auto end{std::min(begin + chunk, requests.size())};
+      boost::asio::post(pool_, [&, begin, end] {
+        for (auto i{begin}; i < end; ++i) {
+          auto &request{requests[i]};
+          signatures[i] = keystore_->sign(request.address, request.data);
+        }
+        std::lock_guard lock{mutex};
+        if (--remaining == 0) {
+          cv.notify_one();
+        }
+      });
+    }
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [&] { return remaining == 0; });
+    return signatures;
+  }
+}  // namespace fc::storage::keystore
@@ -0,0 +1,56 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FILECOIN_CORE_STORAGE_KEYSTORE_SIGNING_SERVICE_HPP
+#define FILECOIN_CORE_STORAGE_KEYSTORE_SIGNING_SERVICE_HPP
+
+#include <boost/asio/thread_pool.hpp>
+
+#include "common/buffer.hpp"
+#include "storage/keystore/keystore.hpp"
+
+namespace fc::storage::keystore {
+  using common::Buffer;
+
+  /**
+   * Signs with keys of keystore on own threads, so BLS signing, which
+   * takes most of signing time, runs on all cores instead of callers.
+   */
+  class SigningService {
+   public:
+    using Callback = std::function<void(outcome::result<Signature>)>;
+
+    struct Request {
+      Address address;
+      Buffer data;
+    };
+
+    SigningService(std::shared_ptr<KeyStore> keystore, size_t threads);
+
+    /// Waits for signing in progress, queued requests are dropped
+    ~SigningService();
+
+    SigningService(const SigningService &) = delete;
+    SigningService &operator=(const SigningService &) = delete;
+
+    /// Signs on service thread, callback is called there
+    void sign(const Address &address, Buffer data, Callback callback);
+
+    /**
+     * @brief signs requests split between service threads and waits for
+     * them, must not be called from service thread
+     * @return signatures in order of requests
+     */
+    std::vector<outcome::result<Signature>> signAll(
+        const std::vector<Request> &requests);
+
+   private:
+    std::shared_ptr<KeyStore> keystore_;
+    size_t threads_;
+    boost::asio::thread_pool pool_;
+  };
+}  // namespace fc::storage::keystore
+
+#endif  // FILECOIN_CORE_STORAGE_KEYSTORE_SIGNING_SERVICE_HPP
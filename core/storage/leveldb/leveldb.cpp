@@ -7,6 +7,8 @@
 
 #include <utility>
 
+#include <leveldb/env.h>
+
 #include "storage/leveldb/leveldb_batch.hpp"
 #include "storage/leveldb/leveldb_cursor.hpp"
 #include "storage/leveldb/leveldb_util.hpp"
@@ -26,11 +28,54 @@ namespace fc::storage {
     return error_as_result<std::shared_ptr<LevelDB>>(status);
   }
 
+  outcome::result<std::shared_ptr<LevelDB>> LevelDB::create(
+      std::string_view path, const config::LeveldbProfile &profile) {
+    std::unique_ptr<leveldb::Cache> cache;
+    std::unique_ptr<const leveldb::FilterPolicy> filter;
+    leveldb::Options options;
+    options.create_if_missing = true;
+    options.write_buffer_size = profile.write_buffer_bytes;
+    options.max_file_size = profile.max_file_bytes;
+    if (profile.block_cache_bytes != 0) {
+      cache.reset(leveldb::NewLRUCache(profile.block_cache_bytes));
+      options.block_cache = cache.get();
+    }
+    if (profile.bloom_bits_per_key > 0) {
+      filter.reset(leveldb::NewBloomFilterPolicy(profile.bloom_bits_per_key));
+      options.filter_policy = filter.get();
+    }
+    OUTCOME_TRY(db, create(path, options));
+    db->cache_ = std::move(cache);
+    db->filter_ = std::move(filter);
+    return std::move(db);
+  }
+
+  outcome::result<std::map<config::StorageNamespace, std::shared_ptr<LevelDB>>>
+  LevelDB::createNamespaces(const std::string &root,
+                            const config::StorageProfile &profile) {
+    // fails if directory exists, open reports other errors
+    leveldb::Env::Default()->CreateDir(root);
+    std::map<config::StorageNamespace, std::shared_ptr<LevelDB>> dbs;
+    for (auto ns : config::kStorageNamespaces) {
+      OUTCOME_TRY(db,
+                  create(root + "/" + config::namespaceName(ns),
+                         profile.profile(ns)));
+      dbs.emplace(ns, std::move(db));
+    }
+    return std::move(dbs);
+  }
+
   std::unique_ptr<BufferMapCursor> LevelDB::cursor() {
     auto it = std::unique_ptr<leveldb::Iterator>(db_->NewIterator(ro_));
     return std::make_unique<Cursor>(std::move(it));
   }
 
+  std::unique_ptr<LevelDB::PrefixCursor> LevelDB::prefixCursor(
+      Buffer prefix) {
+    auto it = std::unique_ptr<leveldb::Iterator>(db_->NewIterator(ro_));
+    return std::make_unique<PrefixCursor>(std::move(it), std::move(prefix));
+  }
+
   std::unique_ptr<BufferBatch> LevelDB::batch() {
     return std::make_unique<Batch>(*this);
   }
@@ -44,6 +89,27 @@ namespace fc::storage {
   }
 
   outcome::result<Buffer> LevelDB::get(const Buffer &key) const {
+    return get(BufferView{key});
+  }
+
+  bool LevelDB::contains(const Buffer &key) const {
+    return contains(BufferView{key});
+  }
+
+  outcome::result<void> LevelDB::put(const Buffer &key, const Buffer &value) {
+    return put(BufferView{key}, BufferView{value});
+  }
+
+  outcome::result<void> LevelDB::put(const Buffer &key, Buffer &&value) {
+    // value is copied by leveldb anyway
+    return put(BufferView{key}, BufferView{value});
+  }
+
+  outcome::result<void> LevelDB::remove(const Buffer &key) {
+    return remove(BufferView{key});
+  }
+
+  outcome::result<Buffer> LevelDB::get(BufferView key) const {
     std::string value;
     auto status = db_->Get(ro_, make_slice(key), &value);
     if (status.ok()) {
@@ -54,13 +120,13 @@ namespace fc::storage {
     return error_as_result<Buffer>(status, logger_);
   }
 
-  bool LevelDB::contains(const Buffer &key) const {
+  bool LevelDB::contains(BufferView key) const {
     // here we interpret all kinds of errors as "not found".
     // is there a better way?
     return get(key).has_value();
   }
 
-  outcome::result<void> LevelDB::put(const Buffer &key, const Buffer &value) {
+  outcome::result<void> LevelDB::put(BufferView key, BufferView value) {
     auto status = db_->Put(wo_, make_slice(key), make_slice(value));
     if (status.ok()) {
       return outcome::success();
@@ -69,12 +135,7 @@ namespace fc::storage {
     return error_as_result<void>(status, logger_);
   }
 
-  outcome::result<void> LevelDB::put(const Buffer &key, Buffer &&value) {
-    Buffer copy(std::move(value));
-    return put(key, copy);
-  }
-
-  outcome::result<void> LevelDB::remove(const Buffer &key) {
+  outcome::result<void> LevelDB::remove(BufferView key) {
     auto status = db_->Delete(wo_, make_slice(key));
     if (status.ok()) {
       return outcome::success();
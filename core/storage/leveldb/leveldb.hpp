@@ -6,10 +6,13 @@
 #ifndef CPP_FILECOIN_LEVELDB_HPP
 #define CPP_FILECOIN_LEVELDB_HPP
 
+#include <leveldb/cache.h>
 #include <leveldb/db.h>
+#include <leveldb/filter_policy.h>
 #include <leveldb/write_batch.h>
 #include "common/logger.hpp"
 #include "storage/buffer_map.hpp"
+#include "storage/config/storage_profile.hpp"
 
 namespace fc::storage {
 
@@ -21,6 +24,7 @@ namespace fc::storage {
    public:
     class Batch;
     class Cursor;
+    class PrefixCursor;
 
     ~LevelDB() override = default;
 
@@ -33,6 +37,28 @@ namespace fc::storage {
     static outcome::result<std::shared_ptr<LevelDB>> create(
         std::string_view path, leveldb::Options options = leveldb::Options());
 
+    /**
+     * @brief Create instance tuned by profile, it owns block cache and bloom
+     * filter made for it
+     * @param path filesystem path where database is going to be
+     * @param profile cache, filter and buffer sizes
+     * @return instance of LevelDB
+     */
+    static outcome::result<std::shared_ptr<LevelDB>> create(
+        std::string_view path, const config::LeveldbProfile &profile);
+
+    /**
+     * @brief Create instance for each namespace in its directory under root,
+     * so namespaces are tuned and compacted independently
+     * @param root directory of namespace directories, created if missing
+     * @param profile profiles of namespaces
+     * @return instances by namespace
+     */
+    static outcome::result<
+        std::map<config::StorageNamespace, std::shared_ptr<LevelDB>>>
+    createNamespaces(const std::string &root,
+                     const config::StorageProfile &profile);
+
     /**
      * @brief Set read options, which are used in @see LevelDB#get
      * @param ro options
@@ -47,6 +73,13 @@ namespace fc::storage {
 
     std::unique_ptr<BufferMapCursor> cursor() override;
 
+    /**
+     * @brief Cursor over keys starting with prefix, its keys and values are
+     * slices of leveldb iterator, so scans don't allocate
+     * @param prefix common prefix of keys, e.g. binary DatastoreKey
+     */
+    std::unique_ptr<PrefixCursor> prefixCursor(Buffer prefix);
+
     std::unique_ptr<BufferBatch> batch() override;
 
     outcome::result<Buffer> get(const Buffer &key) const override;
@@ -60,7 +93,17 @@ namespace fc::storage {
 
     outcome::result<void> remove(const Buffer &key) override;
 
+    /// Same as above, but keys are borrowed, so callers may keep them on
+    /// stack instead of allocating Buffer
+    outcome::result<Buffer> get(BufferView key) const;
+    bool contains(BufferView key) const;
+    outcome::result<void> put(BufferView key, BufferView value);
+    outcome::result<void> remove(BufferView key);
+
    private:
+    // used by db_, so destroyed after it
+    std::unique_ptr<leveldb::Cache> cache_;
+    std::unique_ptr<const leveldb::FilterPolicy> filter_;
     std::unique_ptr<leveldb::DB> db_;
     leveldb::ReadOptions ro_;
     leveldb::WriteOptions wo_;
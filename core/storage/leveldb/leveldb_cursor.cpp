@@ -44,4 +44,42 @@ namespace fc::storage {
     return make_buffer(i_->value());
   }
 
+  BufferView LevelDB::Cursor::keyView() const {
+    return make_span(i_->key());
+  }
+
+  BufferView LevelDB::Cursor::valueView() const {
+    return make_span(i_->value());
+  }
+
+  LevelDB::PrefixCursor::PrefixCursor(std::unique_ptr<leveldb::Iterator> it,
+                                      Buffer prefix)
+      : i_{std::move(it)}, prefix_{std::move(prefix)} {}
+
+  void LevelDB::PrefixCursor::seekToFirst() {
+    i_->Seek(make_slice(prefix_));
+  }
+
+  void LevelDB::PrefixCursor::seek(BufferView suffix) {
+    seek_key_.clear();
+    seek_key_.put(prefix_).put(suffix);
+    i_->Seek(make_slice(seek_key_));
+  }
+
+  bool LevelDB::PrefixCursor::isValid() const {
+    return i_->Valid() && i_->key().starts_with(make_slice(prefix_));
+  }
+
+  void LevelDB::PrefixCursor::next() {
+    i_->Next();
+  }
+
+  BufferView LevelDB::PrefixCursor::key() const {
+    return make_span(i_->key()).subspan(prefix_.size());
+  }
+
+  BufferView LevelDB::PrefixCursor::value() const {
+    return make_span(i_->value());
+  }
+
 }  // namespace fc::storage
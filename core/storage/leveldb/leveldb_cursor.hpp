@@ -37,10 +37,47 @@ namespace fc::storage {
 
     Buffer value() const override;
 
+    /// Key without copy, valid until cursor moves
+    BufferView keyView() const;
+
+    /// Value without copy, valid until cursor moves
+    BufferView valueView() const;
+
    private:
     std::shared_ptr<leveldb::Iterator> i_;
   };
 
+  /**
+   * @brief Forward cursor over keys with common prefix. Keys are returned
+   * without prefix, keys and values are slices valid until cursor moves.
+   */
+  class LevelDB::PrefixCursor {
+   public:
+    PrefixCursor(std::unique_ptr<leveldb::Iterator> it, Buffer prefix);
+
+    /// Seek to first key with prefix
+    void seekToFirst();
+
+    /// Seek to first key not less than prefix followed by suffix
+    void seek(BufferView suffix);
+
+    /// Whether cursor points to key with prefix
+    bool isValid() const;
+
+    void next();
+
+    /// Key after prefix
+    BufferView key() const;
+
+    BufferView value() const;
+
+   private:
+    std::unique_ptr<leveldb::Iterator> i_;
+    Buffer prefix_;
+    /// Prefix followed by suffix of last seek, reused between seeks
+    Buffer seek_key_;
+  };
+
 }  // namespace fc::storage
 
 #endif  // CPP_FILECOIN_LEVELDB_CURSOR_HPP
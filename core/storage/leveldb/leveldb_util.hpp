@@ -47,7 +47,7 @@ namespace fc::storage {
     return error_as_result<T>(s);
   }
 
-  inline leveldb::Slice make_slice(const common::Buffer &buf) {
+  inline leveldb::Slice make_slice(common::BufferView buf) {
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
     const auto *ptr = reinterpret_cast<const char *>(buf.data());
     size_t n = buf.size();
@@ -10,25 +10,67 @@
 namespace fc::storage::mpool {
   using primitives::block::MsgMeta;
   using primitives::tipset::HeadChangeType;
+  using vm::message::MessageError;
   using vm::message::UnsignedMessage;
 
-  Mpool::Mpool(IpldPtr ipld) : ipld{ipld} {}
+  namespace {
+    constexpr uint8_t kPendingPrefix{'p'};
+    constexpr uint8_t kBlsPrefix{'b'};
+
+    Buffer pendingKey(const Address &from, uint64_t nonce) {
+      Buffer key;
+      key.putUint8(kPendingPrefix);
+      key.put(primitives::address::encode(from));
+      key.putUint64(nonce);
+      return key;
+    }
+
+    outcome::result<Buffer> blsKey(const CID &cid) {
+      OUTCOME_TRY(bytes, cid.toBytes());
+      Buffer key;
+      key.putUint8(kBlsPrefix);
+      key.put(bytes);
+      return key;
+    }
+  }  // namespace
+
+  Mpool::Mpool(IpldPtr ipld,
+               std::shared_ptr<SecpMessageVerifier> secp_verifier,
+               std::shared_ptr<PersistentBufferMap> journal)
+      : ipld{ipld},
+        secp_verifier{std::move(secp_verifier)},
+        journal{std::move(journal)} {}
 
   std::shared_ptr<Mpool> Mpool::create(
-      IpldPtr ipld, std::shared_ptr<ChainStore> chain_store) {
-    auto mpool{std::make_shared<Mpool>(ipld)};
-    mpool->head_sub = chain_store->subscribeHeadChanges([=](auto &change) {
-      auto res{mpool->onHeadChange(change)};
+      IpldPtr ipld,
+      HeadChangeDispatcher &head_changes,
+      boost::asio::executor executor,
+      std::shared_ptr<SecpMessageVerifier> secp_verifier,
+      std::shared_ptr<PersistentBufferMap> journal) {
+    auto mpool{std::make_shared<Mpool>(
+        ipld, std::move(secp_verifier), std::move(journal))};
+    if (mpool->journal) {
+      auto res{mpool->restore()};
       if (!res) {
-        spdlog::error("Mpool.onHeadChange: error {} \"{}\"",
+        spdlog::error("Mpool.restore: error {} \"{}\"",
                       res.error(),
                       res.error().message());
       }
-    });
+    }
+    mpool->head_sub = head_changes.subscribe(
+        "mpool", std::move(executor), [=](auto &changes) {
+          auto res{mpool->onHeadChanges(changes)};
+          if (!res) {
+            spdlog::error("Mpool.onHeadChanges: error {} \"{}\"",
+                          res.error(),
+                          res.error().message());
+          }
+        });
     return mpool;
   }
 
   std::vector<SignedMessage> Mpool::pending() const {
+    std::lock_guard lock{mutex};
     std::vector<SignedMessage> messages;
     for (auto &[addr, pending] : by_from) {
       for (auto &[nonce, message] : pending.by_nonce) {
@@ -39,10 +81,15 @@ namespace fc::storage::mpool {
   }
 
   outcome::result<uint64_t> Mpool::nonce(const Address &from) const {
+    std::unique_lock lock{mutex};
+    auto head_copy{head};
+    // interpretation is slow, other calls proceed meanwhile
+    lock.unlock();
     OUTCOME_TRY(interpeted,
-                vm::interpreter::InterpreterImpl{}.interpret(ipld, head));
+                vm::interpreter::InterpreterImpl{}.interpret(ipld, head_copy));
     OUTCOME_TRY(
         actor, vm::state::StateTreeImpl{ipld, interpeted.state_root}.get(from));
+    lock.lock();
     auto by_from_it{by_from.find(from)};
     if (by_from_it != by_from.end() && by_from_it->second.nonce > actor.nonce) {
       return by_from_it->second.nonce;
@@ -51,8 +98,48 @@ namespace fc::storage::mpool {
   }
 
   outcome::result<void> Mpool::add(const SignedMessage &message) {
+    std::vector<MpoolUpdate> updates;
+    {
+      std::lock_guard lock{mutex};
+      OUTCOME_TRY(addMessage(message, updates));
+      OUTCOME_TRY(writeJournal(updates));
+    }
+    for (auto &update : updates) {
+      signal(update);
+    }
+    return outcome::success();
+  }
+
+  void Mpool::remove(const Address &from, uint64_t nonce) {
+    std::vector<MpoolUpdate> updates;
+    {
+      std::lock_guard lock{mutex};
+      removeMessage(from, nonce, updates);
+      auto res{writeJournal(updates)};
+      if (!res) {
+        spdlog::error("Mpool.writeJournal: error {} \"{}\"",
+                      res.error(),
+                      res.error().message());
+      }
+    }
+    for (auto &update : updates) {
+      signal(update);
+    }
+  }
+
+  outcome::result<void> Mpool::addMessage(const SignedMessage &message,
+                                          std::vector<MpoolUpdate> &updates) {
     if (message.signature.isBls()) {
-      bls_cache.emplace(message.getCid(), message.signature);
+      auto cid{message.getCid()};
+      if (bls_cache.emplace(cid, message.signature).second && journal) {
+        bls_unjournaled.push_back(cid);
+      }
+    } else if (secp_verifier && message.message.from.isKeyType()) {
+      // reverted messages are added again, their signers are cached
+      OUTCOME_TRY(valid, secp_verifier->verify(message.message.from, message));
+      if (!valid) {
+        return MessageError::VERIFICATION_FAILURE;
+      }
     }
     OUTCOME_TRY(ipld->setCbor(message));
     OUTCOME_TRY(ipld->setCbor(message.message));
@@ -61,17 +148,19 @@ namespace fc::storage::mpool {
       pending.nonce = message.message.nonce + 1;
     }
     pending.by_nonce[message.message.nonce] = message;
-    signal({MpoolUpdate::Type::ADD, message});
+    updates.push_back({MpoolUpdate::Type::ADD, message});
     return outcome::success();
   }
 
-  void Mpool::remove(const Address &from, uint64_t nonce) {
+  void Mpool::removeMessage(const Address &from,
+                            uint64_t nonce,
+                            std::vector<MpoolUpdate> &updates) {
     auto by_from_it{by_from.find(from)};
     if (by_from_it != by_from.end()) {
       auto &pending{by_from_it->second};
       auto message{pending.by_nonce.find(nonce)};
       if (message != pending.by_nonce.end()) {
-        signal({MpoolUpdate::Type::REMOVE, message->second});
+        updates.push_back({MpoolUpdate::Type::REMOVE, message->second});
         pending.by_nonce.erase(message);
         if (pending.by_nonce.empty()) {
           by_from.erase(by_from_it);
@@ -83,38 +172,173 @@ namespace fc::storage::mpool {
   }
 
   outcome::result<void> Mpool::onHeadChange(const HeadChange &change) {
-    if (change.type == HeadChangeType::CURRENT) {
-      head = change.value;
-    } else {
+    return onHeadChanges({change});
+  }
+
+  outcome::result<void> Mpool::onHeadChanges(
+      const std::vector<HeadChange> &changes) {
+    std::vector<MpoolUpdate> updates;
+    {
+      std::lock_guard lock{mutex};
+      OUTCOME_TRY(applyHeadChanges(changes, updates));
+    }
+    for (auto &update : updates) {
+      signal(update);
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> Mpool::applyHeadChanges(
+      const std::vector<HeadChange> &changes,
+      std::vector<MpoolUpdate> &updates) {
+    // reverted messages return to pool, applied leave it, message reverted
+    // and applied again during reorg keeps its place
+    std::map<CID, std::pair<bool, int>> delta;
+    std::vector<CID> order;
+    for (auto &change : changes) {
+      if (change.type == HeadChangeType::CURRENT) {
+        head = change.value;
+        continue;
+      }
       auto apply{change.type == HeadChangeType::APPLY};
-      OUTCOME_TRY(change.value.visitMessages(
-          ipld, [&](auto, auto bls, auto &cid) -> outcome::result<void> {
-            if (bls) {
-              OUTCOME_TRY(message, ipld->getCbor<UnsignedMessage>(cid));
-              if (apply) {
-                remove(message.from, message.nonce);
-              } else {
-                auto sig{bls_cache.find(cid)};
-                if (sig != bls_cache.end()) {
-                  OUTCOME_TRY(add({message, sig->second}));
-                }
-              }
-            } else {
-              OUTCOME_TRY(message, ipld->getCbor<SignedMessage>(cid));
-              if (apply) {
-                remove(message.message.from, message.message.nonce);
-              } else {
-                OUTCOME_TRY(add(message));
-              }
-            }
-            return outcome::success();
-          }));
+      OUTCOME_TRY(messages, tipsetMessages(change.value));
+      for (auto &message : messages) {
+        auto [it, inserted]{delta.emplace(message.cid,
+                                          std::make_pair(message.bls, 0))};
+        if (inserted) {
+          order.push_back(message.cid);
+        }
+        it->second.second += apply ? -1 : 1;
+      }
       if (apply) {
         head = change.value;
       } else {
         OUTCOME_TRYA(head, change.value.loadParent(*ipld));
       }
     }
+
+    for (auto &cid : order) {
+      auto [bls, count]{delta.at(cid)};
+      if (count == 0) {
+        continue;
+      }
+      auto apply{count < 0};
+      if (bls) {
+        OUTCOME_TRY(message, ipld->getCbor<UnsignedMessage>(cid));
+        if (apply) {
+          removeMessage(message.from, message.nonce, updates);
+        } else {
+          auto sig{bls_cache.find(cid)};
+          if (sig != bls_cache.end()) {
+            OUTCOME_TRY(addMessage({message, sig->second}, updates));
+          }
+        }
+      } else {
+        OUTCOME_TRY(message, ipld->getCbor<SignedMessage>(cid));
+        if (apply) {
+          removeMessage(message.message.from, message.message.nonce, updates);
+        } else {
+          OUTCOME_TRY(addMessage(message, updates));
+        }
+      }
+    }
+
+    if (restored) {
+      restored = false;
+      OUTCOME_TRY(revalidate(updates));
+    }
+
+    if (head.height > kTipsetsWindow) {
+      tipset_messages.erase(
+          tipset_messages.begin(),
+          tipset_messages.lower_bound(head.height - kTipsetsWindow));
+    }
+    return writeJournal(updates);
+  }
+
+  outcome::result<void> Mpool::restore() {
+    auto cursor{journal->cursor()};
+    for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
+      auto key{cursor->key()};
+      if (key[0] == kPendingPrefix) {
+        OUTCOME_TRY(message,
+                    codec::cbor::decode<SignedMessage>(cursor->value()));
+        auto &pending{by_from[message.message.from]};
+        pending.nonce = std::max(pending.nonce, message.message.nonce + 1);
+        pending.by_nonce[message.message.nonce] = std::move(message);
+      } else if (key[0] == kBlsPrefix) {
+        OUTCOME_TRY(cid, CID::fromBytes(gsl::make_span(key).subspan(1)));
+        OUTCOME_TRY(signature,
+                    codec::cbor::decode<Signature>(cursor->value()));
+        bls_cache.emplace(std::move(cid), std::move(signature));
+      }
+    }
+    restored = !by_from.empty();
+    return outcome::success();
+  }
+
+  outcome::result<void> Mpool::revalidate(std::vector<MpoolUpdate> &updates) {
+    OUTCOME_TRY(interpeted,
+                vm::interpreter::InterpreterImpl{}.interpret(ipld, head));
+    vm::state::StateTreeImpl tree{ipld, interpeted.state_root};
+    std::vector<std::pair<Address, uint64_t>> included;
+    for (auto &[from, pending] : by_from) {
+      auto actor{tree.get(from)};
+      for (auto &[nonce, message] : pending.by_nonce) {
+        if (actor && nonce < actor.value().nonce) {
+          included.emplace_back(from, nonce);
+          continue;
+        }
+        // ipld of restarted node may miss message added before restart
+        OUTCOME_TRY(ipld->setCbor(message));
+        OUTCOME_TRY(ipld->setCbor(message.message));
+      }
+    }
+    for (auto &[from, nonce] : included) {
+      removeMessage(from, nonce, updates);
+    }
     return outcome::success();
   }
+
+  outcome::result<void> Mpool::writeJournal(
+      const std::vector<MpoolUpdate> &updates) {
+    if (!journal) {
+      return outcome::success();
+    }
+    auto batch{journal->batch()};
+    for (auto &update : updates) {
+      auto &message{update.message.message};
+      auto key{pendingKey(message.from, message.nonce)};
+      if (update.type == MpoolUpdate::Type::ADD) {
+        OUTCOME_TRY(encoded, codec::cbor::encode(update.message));
+        OUTCOME_TRY(batch->put(key, encoded));
+      } else {
+        OUTCOME_TRY(batch->remove(key));
+      }
+    }
+    for (auto &cid : bls_unjournaled) {
+      OUTCOME_TRY(key, blsKey(cid));
+      OUTCOME_TRY(encoded, codec::cbor::encode(bls_cache.at(cid)));
+      OUTCOME_TRY(batch->put(key, encoded));
+    }
+    bls_unjournaled.clear();
+    return batch->commit();
+  }
+
+  outcome::result<std::vector<Mpool::TipsetMessage>> Mpool::tipsetMessages(
+      const Tipset &tipset) {
+    auto &by_cids{tipset_messages[tipset.height]};
+    auto it{by_cids.find(tipset.cids)};
+    if (it != by_cids.end()) {
+      return it->second;
+    }
+    std::vector<TipsetMessage> messages;
+    OUTCOME_TRY(tipset.visitMessages(
+        ipld, [&](auto, auto bls, auto &cid) -> outcome::result<void> {
+          messages.push_back({bls, cid});
+          return outcome::success();
+        }));
+    by_cids.emplace(tipset.cids, messages);
+    return messages;
+  }
 }  // namespace fc::storage::mpool
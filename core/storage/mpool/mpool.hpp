@@ -6,10 +6,14 @@
 #ifndef CPP_FILECOIN_CORE_STORAGE_MPOOL_MPOOL_HPP
 #define CPP_FILECOIN_CORE_STORAGE_MPOOL_MPOOL_HPP
 
+#include <mutex>
+
 #include <boost/signals2.hpp>
 
-#include "storage/chain/chain_store.hpp"
+#include "storage/buffer_map.hpp"
+#include "storage/chain/head_change_dispatcher.hpp"
 #include "vm/message/message.hpp"
+#include "vm/message/secp_message_verifier.hpp"
 
 namespace fc::storage::mpool {
   using crypto::signature::Signature;
@@ -17,6 +21,8 @@ namespace fc::storage::mpool {
   using primitives::tipset::HeadChange;
   using primitives::tipset::Tipset;
   using storage::blockchain::ChainStore;
+  using storage::blockchain::HeadChangeDispatcher;
+  using vm::message::SecpMessageVerifier;
   using vm::message::SignedMessage;
   using connection_t = boost::signals2::connection;
 
@@ -27,31 +33,97 @@ namespace fc::storage::mpool {
     SignedMessage message;
   };
 
+  /**
+   * Pool of pending messages, thread-safe.
+   * Subscribers are notified after pool is unlocked, so they may call pool.
+   */
   struct Mpool : public std::enable_shared_from_this<Mpool> {
     struct Pending {
       std::map<uint64_t, SignedMessage> by_nonce;
       uint64_t nonce;
     };
+    /// Message included in tipset, BLS messages are stored unsigned
+    struct TipsetMessage {
+      bool bls;
+      CID cid;
+    };
     using Subscriber = void(const MpoolUpdate &);
 
-    explicit Mpool(IpldPtr ipld);
+    /// Epochs below head for which message cids of tipsets are kept
+    static constexpr uint64_t kTipsetsWindow{900};
+
+    /**
+     * @param secp_verifier - checks secp256k1 signatures of added messages
+     * from key addresses, unchecked if null
+     * @param journal - persists pending messages and BLS signatures, pool
+     * is kept only in memory if null
+     */
+    explicit Mpool(
+        IpldPtr ipld,
+        std::shared_ptr<SecpMessageVerifier> secp_verifier = nullptr,
+        std::shared_ptr<PersistentBufferMap> journal = nullptr);
+    /**
+     * @param executor - handles head changes, pool calls are locked, so it
+     * may differ from threads which serve pool calls
+     * @param journal - pending messages are restored from it without
+     * checks, they are revalidated against first head
+     */
     static std::shared_ptr<Mpool> create(
-        IpldPtr ipld, std::shared_ptr<ChainStore> chain_store);
+        IpldPtr ipld,
+        HeadChangeDispatcher &head_changes,
+        boost::asio::executor executor,
+        std::shared_ptr<SecpMessageVerifier> secp_verifier = nullptr,
+        std::shared_ptr<PersistentBufferMap> journal = nullptr);
     std::vector<SignedMessage> pending() const;
     outcome::result<uint64_t> nonce(const Address &from) const;
     outcome::result<void> add(const SignedMessage &message);
     void remove(const Address &from, uint64_t nonce);
     outcome::result<void> onHeadChange(const HeadChange &change);
+    /**
+     * Reconciles pool with all reverts and applies of one head switch.
+     * Messages reverted and included again are neither loaded nor reported,
+     * updates are reported after whole batch is applied.
+     */
+    outcome::result<void> onHeadChanges(const std::vector<HeadChange> &changes);
     connection_t subscribe(const std::function<Subscriber> &subscriber) {
       return signal.connect(subscriber);
     }
 
    private:
+    /// onHeadChanges with mutex locked, updates are reported by caller
+    outcome::result<void> applyHeadChanges(
+        const std::vector<HeadChange> &changes,
+        std::vector<MpoolUpdate> &updates);
+    /// Loads pending messages and BLS signatures from journal
+    outcome::result<void> restore();
+    /// Drops restored messages with nonces already used in head state
+    outcome::result<void> revalidate(std::vector<MpoolUpdate> &updates);
+    /// Writes updates and new BLS signatures to journal as one batch
+    outcome::result<void> writeJournal(const std::vector<MpoolUpdate> &updates);
+    outcome::result<std::vector<TipsetMessage>> tipsetMessages(
+        const Tipset &tipset);
+    outcome::result<void> addMessage(const SignedMessage &message,
+                                     std::vector<MpoolUpdate> &updates);
+    void removeMessage(const Address &from,
+                       uint64_t nonce,
+                       std::vector<MpoolUpdate> &updates);
+
+    /// Guards all state below, head changes and calls run on any thread
+    mutable std::mutex mutex;
     IpldPtr ipld;
+    std::shared_ptr<SecpMessageVerifier> secp_verifier;
     ChainStore::connection_t head_sub;
     Tipset head;
     std::map<Address, Pending> by_from;
     std::map<CID, Signature> bls_cache;
+    std::shared_ptr<PersistentBufferMap> journal;
+    /// BLS signatures cached since last journal write
+    std::vector<CID> bls_unjournaled;
+    /// Restored messages are not checked against head yet
+    bool restored{false};
+    /// Message cids of recent tipsets by height and tipset cids
+    std::map<uint64_t, std::map<std::vector<CID>, std::vector<TipsetMessage>>>
+        tipset_messages;
     boost::signals2::signal<Subscriber> signal;
   };
 }  // namespace fc::storage::mpool
@@ -4,6 +4,11 @@
  */
 
 #include "storage/piece/impl/piece_storage_impl.hpp"
+
+#include <algorithm>
+
+#include <boost/optional.hpp>
+
 #include "codec/cbor/cbor.hpp"
 
 namespace fc::storage::piece {
@@ -24,55 +29,112 @@ namespace fc::storage::piece {
 
   outcome::result<void> PieceStorageImpl::addPieceInfo(const CID &piece_cid,
                                                        PieceInfo piece_info) {
-    OUTCOME_TRY(key, piece_cid.toString());
+    OUTCOME_TRY(key, makeKey(PieceKey::PIECE, piece_cid));
     OUTCOME_TRY(value, codec::cbor::encode(piece_info));
-    Buffer storage_key =
-        PieceStorageImpl::convertKey(kPiecePrefix, std::move(key));
-    OUTCOME_TRY(storage_->put(storage_key, value));
+    OUTCOME_TRY(storage_->put(key, std::move(value)));
+    changed();
     return outcome::success();
   }
 
   outcome::result<PieceInfo> PieceStorageImpl::getPieceInfo(
       const CID &piece_cid) const {
-    OUTCOME_TRY(key, piece_cid.toString());
-    Buffer storage_key =
-        PieceStorageImpl::convertKey(kPiecePrefix, std::move(key));
-    OUTCOME_TRY(value, storage_->get(storage_key));
+    OUTCOME_TRY(key, makeKey(PieceKey::PIECE, piece_cid));
+    OUTCOME_TRY(value, storage_->get(key));
     OUTCOME_TRY(piece_info, codec::cbor::decode<PieceInfo>(value));
     return piece_info;
   }
 
   outcome::result<void> PieceStorageImpl::addPayloadLocations(
       const CID &parent_piece, std::map<CID, PayloadLocation> locations) {
+    OUTCOME_TRY(table_key, makeKey(PieceKey::LOCATION_TABLE, parent_piece));
+    std::vector<PayloadLocation> table;
+    if (storage_->contains(table_key)) {
+      OUTCOME_TRY(stored, getPieceLocations(parent_piece));
+      table = stored.locations();
+    }
+    table.reserve(table.size() + locations.size());
+
+    auto batch = storage_->batch();
     for (auto &&[cid, location] : locations) {
       PayloadBlockInfo payload_info{.parent_piece = parent_piece,
                                     .block_location = location};
-      OUTCOME_TRY(key, cid.toString());
+      OUTCOME_TRY(key, makeKey(PieceKey::LOCATION, cid));
       OUTCOME_TRY(value, codec::cbor::encode(payload_info));
-      Buffer storage_key =
-          PieceStorageImpl::convertKey(kLocationPrefix, std::move(key));
-      OUTCOME_TRY(storage_->put(storage_key, value));
+      OUTCOME_TRY(batch->put(key, std::move(value)));
+      table.push_back(location);
     }
+    OUTCOME_TRY(batch->put(table_key,
+                           PieceLocationTable::encode(std::move(table))));
+    OUTCOME_TRY(batch->commit());
+    changed();
     return outcome::success();
   }
 
   outcome::result<PayloadBlockInfo> PieceStorageImpl::getPayloadLocation(
       const CID &payload_cid) const {
-    OUTCOME_TRY(key, payload_cid.toString());
-    Buffer storage_key =
-        PieceStorageImpl::convertKey(kLocationPrefix, std::move(key));
-    OUTCOME_TRY(value, storage_->get(storage_key));
+    OUTCOME_TRY(key, makeKey(PieceKey::LOCATION, payload_cid));
+    OUTCOME_TRY(value, storage_->get(key));
     OUTCOME_TRY(payload_info, codec::cbor::decode<PayloadBlockInfo>(value));
     return std::move(payload_info);
   }
 
-  PieceStorageImpl::Buffer PieceStorageImpl::convertKey(std::string prefix,
-                                                        std::string key) {
-    std::vector<uint8_t> key_bytes{std::move_iterator(prefix.begin()),
-                                   std::move_iterator(prefix.end())};
-    key_bytes.insert(key_bytes.end(),
-                     std::move_iterator(key.begin()),
-                     std::move_iterator(key.end()));
-    return Buffer{std::move(key_bytes)};
+  outcome::result<PieceLocationTable> PieceStorageImpl::getPieceLocations(
+      const CID &piece_cid) const {
+    OUTCOME_TRY(key, makeKey(PieceKey::LOCATION_TABLE, piece_cid));
+    if (!storage_->contains(key)) {
+      return PieceStorageError::PIECE_NOT_FOUND;
+    }
+    OUTCOME_TRY(value, storage_->get(key));
+    return PieceLocationTable::make(std::move(value));
+  }
+
+  outcome::result<PieceStorageImpl::Buffer> PieceStorageImpl::makeKey(
+      PieceKey prefix, const CID &cid) {
+    OUTCOME_TRY(bytes, cid.toBytes());
+    Buffer key;
+    key.reserve(1 + bytes.size());
+    key.putUint8(static_cast<uint8_t>(prefix));
+    key.put(bytes);
+    return std::move(key);
+  }
+
+  outcome::result<PayloadRegion> payloadRegion(const PieceStorage &storage,
+                                               gsl::span<const CID> payload) {
+    if (payload.empty()) {
+      return PieceStorageError::PAYLOAD_NOT_FOUND;
+    }
+    boost::optional<CID> piece;
+    uint64_t begin = UINT64_MAX, end = 0;
+    for (auto &cid : payload) {
+      OUTCOME_TRY(info, storage.getPayloadLocation(cid));
+      if (!piece) {
+        piece = info.parent_piece;
+      } else if (*piece != info.parent_piece) {
+        return PieceStorageError::PAYLOAD_IN_DIFFERENT_PIECES;
+      }
+      auto &location = info.block_location;
+      begin = std::min(begin, location.relative_offset);
+      end = std::max(end, location.relative_offset + location.block_size);
+    }
+    OUTCOME_TRY(piece_info, storage.getPieceInfo(*piece));
+    return PayloadRegion{
+        *piece, piece_info.sector_id, piece_info.offset + begin, end - begin};
   }
 }  // namespace fc::storage::piece
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::piece, PieceStorageError, e) {
+  using fc::storage::piece::PieceStorageError;
+  switch (e) {
+    case PieceStorageError::STORAGE_BACKEND_ERROR:
+      return "PieceStorageError: storage backend error";
+    case PieceStorageError::PIECE_NOT_FOUND:
+      return "PieceStorageError: piece not found";
+    case PieceStorageError::PAYLOAD_NOT_FOUND:
+      return "PieceStorageError: payload not found";
+    case PieceStorageError::PAYLOAD_IN_DIFFERENT_PIECES:
+      return "PieceStorageError: payload blocks are in different pieces";
+    case PieceStorageError::INVALID_LOCATION_TABLE:
+      return "PieceStorageError: invalid payload location table";
+  }
+  return "unknown error";
+}
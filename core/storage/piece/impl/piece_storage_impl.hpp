@@ -12,11 +12,16 @@
 #include "codec/cbor/streams_annotation.hpp"
 #include "common/buffer.hpp"
 #include "storage/face/persistent_map.hpp"
+#include "storage/piece/piece_location_table.hpp"
 #include "storage/piece/piece_storage.hpp"
 
 namespace fc::storage::piece {
-  const std::string kPiecePrefix = "/storagemarket/pieces/";
-  const std::string kLocationPrefix = "/storagemarket/cid-infos/";
+  /// First byte of storage keys, followed by CID bytes
+  enum class PieceKey : uint8_t {
+    PIECE = 1,
+    LOCATION,
+    LOCATION_TABLE,
+  };
 
   class PieceStorageImpl : public PieceStorage {
    protected:
@@ -40,16 +45,19 @@ namespace fc::storage::piece {
     outcome::result<PayloadBlockInfo> getPayloadLocation(
         const CID &paload_cid) const override;
 
-   private:
-    std::shared_ptr<PersistentMap> storage_;
+    outcome::result<PieceLocationTable> getPieceLocations(
+        const CID &piece_cid) const override;
 
     /**
-     * @brief Convert string key to byte buffer
+     * @brief Make storage key of CID
      * @param prefix - key namespace
-     * @param key - data to convert
+     * @param cid - CID, its bytes follow namespace byte
      * @return byte buffer
      */
-    static Buffer convertKey(std::string prefix, std::string key);
+    static outcome::result<Buffer> makeKey(PieceKey prefix, const CID &cid);
+
+   private:
+    std::shared_ptr<PersistentMap> storage_;
   };
 
   CBOR_TUPLE(PieceInfo, deal_id, sector_id, offset, length)
@@ -0,0 +1,110 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/piece/piece_location_table.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+#include <boost/endian/conversion.hpp>
+
+namespace fc::storage::piece {
+  namespace {
+    uint64_t loadU64(const uint8_t *bytes) {
+      uint64_t value;
+      memcpy(&value, bytes, sizeof(value));
+      return boost::endian::little_to_native(value);
+    }
+
+    void storeU64(uint8_t *bytes, uint64_t value) {
+      value = boost::endian::native_to_little(value);
+      memcpy(bytes, &value, sizeof(value));
+    }
+
+    PayloadLocation record(gsl::span<const uint8_t> table, size_t i) {
+      const auto *bytes{table.data() + i * PieceLocationTable::kRecordBytes};
+      return {loadU64(bytes), loadU64(bytes + sizeof(uint64_t))};
+    }
+  }  // namespace
+
+  PieceLocationTable::PieceLocationTable(common::Buffer bytes)
+      : bytes_{std::move(bytes)} {}
+
+  outcome::result<PieceLocationTable> PieceLocationTable::make(
+      common::Buffer bytes) {
+    if (bytes.size() % kRecordBytes != 0) {
+      return PieceStorageError::INVALID_LOCATION_TABLE;
+    }
+    return PieceLocationTable{std::move(bytes)};
+  }
+
+  common::Buffer PieceLocationTable::encode(
+      std::vector<PayloadLocation> locations) {
+    auto less{[](auto &l, auto &r) {
+      return std::tie(l.relative_offset, l.block_size)
+             < std::tie(r.relative_offset, r.block_size);
+    }};
+    std::sort(locations.begin(), locations.end(), less);
+    locations.erase(std::unique(locations.begin(), locations.end()),
+                    locations.end());
+    common::Buffer bytes(locations.size() * kRecordBytes, 0);
+    auto *out{bytes.data()};
+    for (auto &location : locations) {
+      storeU64(out, location.relative_offset);
+      storeU64(out + sizeof(uint64_t), location.block_size);
+      out += kRecordBytes;
+    }
+    return bytes;
+  }
+
+  boost::optional<PayloadLocation> PieceLocationTable::find(
+      gsl::span<const uint8_t> table, uint64_t offset) {
+    // last record starting at or before offset
+    size_t begin{0}, end{table.size() / kRecordBytes};
+    while (begin < end) {
+      auto middle{begin + (end - begin) / 2};
+      if (record(table, middle).relative_offset <= offset) {
+        begin = middle + 1;
+      } else {
+        end = middle;
+      }
+    }
+    if (begin == 0) {
+      return boost::none;
+    }
+    auto location{record(table, begin - 1)};
+    if (offset - location.relative_offset >= location.block_size) {
+      return boost::none;
+    }
+    return location;
+  }
+
+  size_t PieceLocationTable::size() const {
+    return bytes_.size() / kRecordBytes;
+  }
+
+  PayloadLocation PieceLocationTable::operator[](size_t i) const {
+    return record(bytes_, i);
+  }
+
+  std::vector<PayloadLocation> PieceLocationTable::locations() const {
+    std::vector<PayloadLocation> locations;
+    locations.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+      locations.push_back((*this)[i]);
+    }
+    return locations;
+  }
+
+  boost::optional<PayloadLocation> PieceLocationTable::find(
+      uint64_t offset) const {
+    return find(bytes_, offset);
+  }
+
+  const common::Buffer &PieceLocationTable::bytes() const {
+    return bytes_;
+  }
+}  // namespace fc::storage::piece
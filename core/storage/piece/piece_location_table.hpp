@@ -0,0 +1,54 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_PIECE_PIECE_LOCATION_TABLE_HPP
+#define CPP_FILECOIN_CORE_STORAGE_PIECE_PIECE_LOCATION_TABLE_HPP
+
+#include <boost/optional.hpp>
+
+#include "common/buffer.hpp"
+#include "storage/piece/piece_storage.hpp"
+
+namespace fc::storage::piece {
+  /**
+   * @brief Locations of payload blocks of piece, sorted by offset. Encoded as
+   * array of little-endian (offset, size) pairs of fixed size, so table may
+   * be searched in place, e.g. mmapped, without decoding.
+   */
+  class PieceLocationTable {
+   public:
+    static constexpr size_t kRecordBytes{16};
+
+    PieceLocationTable() = default;
+
+    /// Checks encoded table, it must consist of whole records
+    static outcome::result<PieceLocationTable> make(common::Buffer bytes);
+
+    /// Encodes locations sorted by offset, duplicates are dropped
+    static common::Buffer encode(std::vector<PayloadLocation> locations);
+
+    /// Finds location of block containing offset in encoded table
+    static boost::optional<PayloadLocation> find(
+        gsl::span<const uint8_t> table, uint64_t offset);
+
+    size_t size() const;
+
+    PayloadLocation operator[](size_t i) const;
+
+    std::vector<PayloadLocation> locations() const;
+
+    /// Location of block containing offset
+    boost::optional<PayloadLocation> find(uint64_t offset) const;
+
+    const common::Buffer &bytes() const;
+
+   private:
+    explicit PieceLocationTable(common::Buffer bytes);
+
+    common::Buffer bytes_;
+  };
+}  // namespace fc::storage::piece
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_PIECE_PIECE_LOCATION_TABLE_HPP
@@ -6,6 +6,9 @@
 #ifndef CPP_FILECOIN_PIECE_STORAGE_HPP
 #define CPP_FILECOIN_PIECE_STORAGE_HPP
 
+#include <atomic>
+#include <gsl/span>
+
 #include "common/outcome.hpp"
 #include "primitives/cid/cid.hpp"
 
@@ -47,6 +50,8 @@ namespace fc::storage::piece {
    * of the payload block from the Piece begin and CID of the Piece, which
    * contains selected payload block;
    */
+  class PieceLocationTable;
+
   class PieceStorage {
    public:
     /**
@@ -80,6 +85,14 @@ namespace fc::storage::piece {
     virtual outcome::result<void> addPayloadLocations(
         const CID &parent_piece, std::map<CID, PayloadLocation> locations) = 0;
 
+    /**
+     * @brief Get locations of all payload blocks in the Piece
+     * @param piece_cid - id of the Piece
+     * @return locations sorted by offset
+     */
+    virtual outcome::result<PieceLocationTable> getPieceLocations(
+        const CID &piece_cid) const = 0;
+
     /**
      * @brief Get location of the payload block
      * @param paload_cid - id of the payload block
@@ -87,15 +100,53 @@ namespace fc::storage::piece {
      */
     virtual outcome::result<PayloadBlockInfo> getPayloadLocation(
         const CID &paload_cid) const = 0;
+
+    /**
+     * @brief Incremented by each change of pieces or payload locations, so
+     * caches of answers derived from storage detect they are stale
+     */
+    uint64_t generation() const {
+      return generation_.load(std::memory_order_acquire);
+    }
+
+   protected:
+    /// Called by implementation after successful change
+    void changed() {
+      generation_.fetch_add(1, std::memory_order_release);
+    }
+
+   private:
+    std::atomic<uint64_t> generation_{0};
   };
 
+  /* Region of sector holding payload blocks */
+  struct PayloadRegion {
+    CID piece;
+    uint64_t sector_id;
+    /* Offset of region from the sector begin */
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  /**
+   * @brief Finds smallest region of sector holding all given payload blocks,
+   * so only the region is unsealed to read them
+   * @param storage - piece storage with piece and payload locations
+   * @param payload - payload blocks, must be in one piece
+   * @return operation result
+   */
+  outcome::result<PayloadRegion> payloadRegion(const PieceStorage &storage,
+                                               gsl::span<const CID> payload);
+
   /**
    * @enum Piece storage errors
    */
   enum class PieceStorageError {
     STORAGE_BACKEND_ERROR,
     PIECE_NOT_FOUND,
-    PAYLOAD_NOT_FOUND
+    PAYLOAD_NOT_FOUND,
+    PAYLOAD_IN_DIFFERENT_PIECES,
+    INVALID_LOCATION_TABLE,
   };
 }  // namespace fc::storage::piece
 
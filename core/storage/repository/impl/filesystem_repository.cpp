@@ -15,9 +15,19 @@
 #include "storage/keystore/impl/filesystem/filesystem_keystore.hpp"
 #include "storage/repository/repository_error.hpp"
 
+#ifdef FILECOIN_ROCKSDB
+#include "storage/rocksdb/datastore_rocksdb.hpp"
+#endif
+
 using fc::crypto::bls::BlsProviderImpl;
 using fc::crypto::secp256k1::Secp256k1Sha256ProviderImpl;
+using fc::storage::config::loadStorageProfile;
+using fc::storage::config::StorageBackend;
+using fc::storage::config::StorageNamespace;
 using fc::storage::ipfs::LeveldbDatastore;
+#ifdef FILECOIN_ROCKSDB
+using fc::storage::ipfs::RocksdbDatastore;
+#endif
 using fc::storage::keystore::FileSystemKeyStore;
 using fc::storage::repository::FileSystemRepository;
 using fc::storage::repository::Repository;
@@ -38,6 +48,43 @@ fc::outcome::result<std::shared_ptr<Repository>> FileSystemRepository::create(
     const Path &repo_path,
     const std::string &api_address,
     const leveldb::Options &leveldb_options) {
+  return create(
+      repo_path,
+      api_address,
+      [&](auto &path,
+          auto &) -> fc::outcome::result<std::shared_ptr<IpfsDatastore>> {
+        OUTCOME_TRY(datastore, LeveldbDatastore::create(path, leveldb_options));
+        return std::shared_ptr<IpfsDatastore>{std::move(datastore)};
+      });
+}
+
+fc::outcome::result<std::shared_ptr<Repository>> FileSystemRepository::create(
+    const Path &repo_path, const std::string &api_address) {
+  return create(
+      repo_path,
+      api_address,
+      [](auto &path,
+         auto &config) -> fc::outcome::result<std::shared_ptr<IpfsDatastore>> {
+        auto profile = loadStorageProfile(config);
+        if (profile.backend == StorageBackend::ROCKSDB) {
+#ifdef FILECOIN_ROCKSDB
+          OUTCOME_TRY(datastore, RocksdbDatastore::create(path, profile));
+          return std::shared_ptr<IpfsDatastore>{std::move(datastore)};
+#else
+          return RepositoryError::UNSUPPORTED_BACKEND;
+#endif
+        }
+        OUTCOME_TRY(datastore,
+                    LeveldbDatastore::create(
+                        path, profile.profile(StorageNamespace::STATE)));
+        return std::shared_ptr<IpfsDatastore>{std::move(datastore)};
+      });
+}
+
+fc::outcome::result<std::shared_ptr<Repository>> FileSystemRepository::create(
+    const Path &repo_path,
+    const std::string &api_address,
+    const DatastoreOpener &open_datastore) {
   // check version if version file exists
   auto version_filename =
       repo_path + fc::storage::filestore::DELIMITER + kVersionFilename;
@@ -87,8 +134,7 @@ fc::outcome::result<std::shared_ptr<Repository>> FileSystemRepository::create(
   // create datastore
   auto datastore_path =
       repo_path + fc::storage::filestore::DELIMITER + kDatastore;
-  OUTCOME_TRY(ipfs_datastore,
-              LeveldbDatastore::create(datastore_path, leveldb_options));
+  OUTCOME_TRY(ipfs_datastore, open_datastore(datastore_path, *config));
 
   // create keystore
   auto keystore_path =
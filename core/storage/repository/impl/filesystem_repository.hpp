@@ -6,6 +6,7 @@
 #ifndef FILECOIN_CORE_STORAGE_IMPL_FILESYSTEM_REPOSITORY_HPP
 #define FILECOIN_CORE_STORAGE_IMPL_FILESYSTEM_REPOSITORY_HPP
 
+#include <functional>
 #include <iostream>
 
 #include "fslock/fslock.hpp"
@@ -60,9 +61,26 @@ namespace fc::storage::repository {
         const std::string &api_address,
         const leveldb::Options &leveldb_options);
 
+    /**
+     * Create repository with datastore tuned by state profile of storage
+     * profile in repository config, see loadStorageProfile. Backend is
+     * chosen by profile, RocksDB one fails unless built with ROCKSDB option
+     */
+    static outcome::result<std::shared_ptr<Repository>> create(
+        const Path &repo_path, const std::string &api_address);
+
     outcome::result<Version> getVersion() const override;
 
    private:
+    using DatastoreOpener =
+        std::function<outcome::result<std::shared_ptr<IpfsDatastore>>(
+            const std::string &path, Config &config)>;
+
+    static outcome::result<std::shared_ptr<Repository>> create(
+        const Path &repo_path,
+        const std::string &api_address,
+        const DatastoreOpener &open_datastore);
+
     Path repository_path_;
     std::unique_ptr<fslock::Locker> fs_locker_;
     inline static common::Logger logger_ = common::createLogger("repository");
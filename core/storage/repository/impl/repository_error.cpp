@@ -13,6 +13,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::repository, RepositoryError, e) {
       return "RepositoryError: wrong version";
     case RepositoryError::OPEN_FILE_ERROR:
       return "RepositoryError: cannot open file";
+    case RepositoryError::UNSUPPORTED_BACKEND:
+      return "RepositoryError: storage backend is not built";
     case RepositoryError::UNKNOWN:
       break;
   }
@@ -16,6 +16,7 @@ namespace fc::storage::repository {
   enum class RepositoryError {
     WRONG_VERSION = 1,
     OPEN_FILE_ERROR,
+    UNSUPPORTED_BACKEND,
 
     UNKNOWN
   };
@@ -0,0 +1,67 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/rocksdb/datastore_rocksdb.hpp"
+
+#include "storage/ipfs/impl/datastore_key.hpp"
+#include "storage/rocksdb/rocksdb_error.hpp"
+
+namespace fc::storage::ipfs {
+  using common::BufferView;
+
+  RocksdbDatastore::RocksdbDatastore(std::shared_ptr<RocksDB> rocksdb)
+      : rocksdb_{std::move(rocksdb)} {
+    BOOST_ASSERT_MSG(rocksdb_ != nullptr, "rocksdb argument is nullptr");
+  }
+
+  outcome::result<std::shared_ptr<RocksdbDatastore>> RocksdbDatastore::create(
+      const std::string &rocksdb_directory,
+      const config::StorageProfile &profile) {
+    OUTCOME_TRY(families, RocksDB::createFamilies(rocksdb_directory, profile));
+    return std::make_shared<RocksdbDatastore>(
+        families.at(config::StorageNamespace::STATE));
+  }
+
+  outcome::result<bool> RocksdbDatastore::contains(const CID &key) const {
+    return withKey(key,
+                   [&](BufferView encoded_key) -> outcome::result<bool> {
+                     return rocksdb_->contains(encoded_key);
+                   });
+  }
+
+  outcome::result<void> RocksdbDatastore::set(const CID &key, Value value) {
+    return withKey(key, [&](BufferView encoded_key) {
+      return rocksdb_->put(encoded_key, BufferView{value});
+    });
+  }
+
+  outcome::result<void> RocksdbDatastore::setMany(Blocks blocks) {
+    auto batch = rocksdb_->batch();
+    for (auto &block : blocks) {
+      OUTCOME_TRY(encoded_key, encodeKey(block.first));
+      OUTCOME_TRY(batch->put(encoded_key, std::move(block.second)));
+    }
+    return batch->commit();
+  }
+
+  outcome::result<RocksdbDatastore::Value> RocksdbDatastore::get(
+      const CID &key) const {
+    return withKey(
+        key, [&](BufferView encoded_key) -> outcome::result<Value> {
+          auto res = rocksdb_->get(encoded_key);
+          if (res.has_error() && res.error() == RocksDBError::NOT_FOUND) {
+            return IpfsDatastoreError::NOT_FOUND;
+          }
+          return res;
+        });
+  }
+
+  outcome::result<void> RocksdbDatastore::remove(const CID &key) {
+    return withKey(key, [&](BufferView encoded_key) {
+      return rocksdb_->remove(encoded_key);
+    });
+  }
+
+}  // namespace fc::storage::ipfs
@@ -0,0 +1,64 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_ROCKSDB_DATASTORE_ROCKSDB_HPP
+#define CPP_FILECOIN_CORE_STORAGE_ROCKSDB_DATASTORE_ROCKSDB_HPP
+
+#include <memory>
+
+#include "common/outcome.hpp"
+#include "storage/ipfs/datastore.hpp"
+#include "storage/rocksdb/rocksdb.hpp"
+
+namespace fc::storage::ipfs {
+
+  /**
+   * @class RocksdbDatastore IpfsDatastore implementation based on RocksDB
+   * column family
+   */
+  class RocksdbDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<RocksdbDatastore> {
+   public:
+    /**
+     * @brief constructor
+     * @param rocksdb shared pointer to column family
+     */
+    explicit RocksdbDatastore(std::shared_ptr<RocksDB> rocksdb);
+
+    ~RocksdbDatastore() override = default;
+
+    /**
+     * @brief creates RocksdbDatastore instance of state column family
+     * @param rocksdb_directory path to rocksdb directory
+     * @param profile threads, direct io and table options of families
+     * @return shared pointer to instance
+     */
+    static outcome::result<std::shared_ptr<RocksdbDatastore>> create(
+        const std::string &rocksdb_directory,
+        const config::StorageProfile &profile);
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    /// Writes all blocks with single RocksDB write batch
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+   private:
+    std::shared_ptr<RocksDB> rocksdb_;  ///< underlying column family
+  };
+
+}  // namespace fc::storage::ipfs
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_ROCKSDB_DATASTORE_ROCKSDB_HPP
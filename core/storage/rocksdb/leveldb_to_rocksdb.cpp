@@ -0,0 +1,66 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include "storage/copy/buffer_map_copy.hpp"
+#include "storage/leveldb/leveldb.hpp"
+#include "storage/rocksdb/rocksdb.hpp"
+
+using fc::storage::copyBufferMap;
+using fc::storage::LevelDB;
+using fc::storage::RocksDB;
+using fc::storage::config::defaultStorageProfile;
+using fc::storage::config::kStorageNamespaces;
+using fc::storage::config::namespaceName;
+using fc::storage::config::StorageNamespace;
+
+/**
+ * Copies LevelDB database to column family of RocksDB database, state one
+ * unless namespace is given, e.g. datastore of repository before switching
+ * it to "storage.backend" "rocksdb".
+ * Usage: leveldb_to_rocksdb <leveldb path> <rocksdb path> [namespace]
+ */
+int main(int argc, char **argv) {
+  if (argc != 3 && argc != 4) {
+    std::cerr << "usage: " << argv[0]
+              << " <leveldb path> <rocksdb path> [namespace]" << std::endl;
+    return 1;
+  }
+  auto ns{StorageNamespace::STATE};
+  if (argc == 4) {
+    auto it = std::find_if(
+        kStorageNamespaces.begin(), kStorageNamespaces.end(), [&](auto ns) {
+          return namespaceName(ns) == argv[3];
+        });
+    if (it == kStorageNamespaces.end()) {
+      std::cerr << "unknown namespace: " << argv[3] << std::endl;
+      return 1;
+    }
+    ns = *it;
+  }
+
+  auto from = LevelDB::create(argv[1]);
+  if (!from) {
+    std::cerr << "cannot open leveldb: " << from.error().message()
+              << std::endl;
+    return 1;
+  }
+  auto families = RocksDB::createFamilies(argv[2], defaultStorageProfile());
+  if (!families) {
+    std::cerr << "cannot open rocksdb: " << families.error().message()
+              << std::endl;
+    return 1;
+  }
+  auto copied = copyBufferMap(*from.value(), *families.value().at(ns));
+  if (!copied) {
+    std::cerr << "copy failed: " << copied.error().message() << std::endl;
+    return 1;
+  }
+  std::cout << "copied " << copied.value() << " pairs to "
+            << namespaceName(ns) << std::endl;
+  return 0;
+}
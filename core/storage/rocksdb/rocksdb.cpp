@@ -0,0 +1,170 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/rocksdb/rocksdb.hpp"
+
+#include <rocksdb/cache.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/table.h>
+
+#include "storage/rocksdb/rocksdb_batch.hpp"
+#include "storage/rocksdb/rocksdb_cursor.hpp"
+#include "storage/rocksdb/rocksdb_util.hpp"
+
+namespace fc::storage {
+  using rocks::error_as_result;
+  using rocks::make_slice;
+
+  namespace {
+    rocksdb::ColumnFamilyOptions familyOptions(
+        const config::LeveldbProfile &profile) {
+      rocksdb::ColumnFamilyOptions options;
+      options.write_buffer_size = profile.write_buffer_bytes;
+      options.target_file_size_base = profile.max_file_bytes;
+      rocksdb::BlockBasedTableOptions table;
+      if (profile.block_cache_bytes != 0) {
+        table.block_cache = rocksdb::NewLRUCache(profile.block_cache_bytes);
+      }
+      if (profile.bloom_bits_per_key > 0) {
+        table.filter_policy.reset(
+            rocksdb::NewBloomFilterPolicy(profile.bloom_bits_per_key));
+      }
+      options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table));
+      return options;
+    }
+  }  // namespace
+
+  RocksDB::Db::~Db() {
+    // handles must be released before database is closed
+    for (auto *family : families) {
+      db->DestroyColumnFamilyHandle(family);
+    }
+  }
+
+  RocksDB::RocksDB(std::shared_ptr<Db> db, rocksdb::ColumnFamilyHandle *family)
+      : db_{std::move(db)}, family_{family} {}
+
+  outcome::result<std::shared_ptr<RocksDB::Db>> RocksDB::open(
+      const std::string &path, const config::StorageProfile &profile) {
+    rocksdb::DBOptions options;
+    options.create_if_missing = true;
+    options.create_missing_column_families = true;
+    options.IncreaseParallelism(profile.background_jobs);
+    options.max_background_jobs = profile.background_jobs;
+    options.use_direct_reads = profile.direct_io;
+    options.use_direct_io_for_flush_and_compaction = profile.direct_io;
+
+    // all families are opened, as rocksdb requires
+    std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+    descriptors.emplace_back(rocksdb::kDefaultColumnFamilyName,
+                             familyOptions({}));
+    for (auto ns : config::kStorageNamespaces) {
+      descriptors.emplace_back(config::namespaceName(ns),
+                               familyOptions(profile.profile(ns)));
+    }
+
+    auto db = std::make_shared<Db>();
+    rocksdb::DB *raw = nullptr;
+    auto status = rocksdb::DB::Open(
+        options, path, descriptors, &db->families, &raw);
+    if (!status.ok()) {
+      return error_as_result<std::shared_ptr<Db>>(status);
+    }
+    db->db.reset(raw);
+    return db;
+  }
+
+  outcome::result<std::shared_ptr<RocksDB>> RocksDB::create(
+      const std::string &path, const config::StorageProfile &profile) {
+    OUTCOME_TRY(db, open(path, profile));
+    auto *family = db->families.front();
+    return std::make_shared<RocksDB>(std::move(db), family);
+  }
+
+  outcome::result<std::map<config::StorageNamespace, std::shared_ptr<RocksDB>>>
+  RocksDB::createFamilies(const std::string &path,
+                          const config::StorageProfile &profile) {
+    OUTCOME_TRY(db, open(path, profile));
+    std::map<config::StorageNamespace, std::shared_ptr<RocksDB>> dbs;
+    for (size_t i = 0; i < config::kStorageNamespaces.size(); ++i) {
+      dbs.emplace(config::kStorageNamespaces[i],
+                  std::make_shared<RocksDB>(db, db->families[i + 1]));
+    }
+    return std::move(dbs);
+  }
+
+  std::unique_ptr<BufferMapCursor> RocksDB::cursor() {
+    auto it = std::unique_ptr<rocksdb::Iterator>(
+        db_->db->NewIterator(ro_, family_));
+    return std::make_unique<Cursor>(db_, std::move(it));
+  }
+
+  std::unique_ptr<BufferBatch> RocksDB::batch() {
+    return std::make_unique<Batch>(*this);
+  }
+
+  outcome::result<Buffer> RocksDB::get(const Buffer &key) const {
+    return get(BufferView{key});
+  }
+
+  bool RocksDB::contains(const Buffer &key) const {
+    return contains(BufferView{key});
+  }
+
+  outcome::result<void> RocksDB::put(const Buffer &key, const Buffer &value) {
+    return put(BufferView{key}, BufferView{value});
+  }
+
+  outcome::result<void> RocksDB::put(const Buffer &key, Buffer &&value) {
+    // value is copied by rocksdb anyway
+    return put(BufferView{key}, BufferView{value});
+  }
+
+  outcome::result<void> RocksDB::remove(const Buffer &key) {
+    return remove(BufferView{key});
+  }
+
+  outcome::result<Buffer> RocksDB::get(BufferView key) const {
+    rocksdb::PinnableSlice value;
+    auto status = db_->db->Get(ro_, family_, make_slice(key), &value);
+    if (status.ok()) {
+      return rocks::make_buffer(value);
+    }
+    if (status.IsNotFound()) {
+      return RocksDBError::NOT_FOUND;
+    }
+
+    return error_as_result<Buffer>(status, logger_);
+  }
+
+  bool RocksDB::contains(BufferView key) const {
+    std::string value;
+    // bloom filter answers most absent keys without reading value
+    if (!db_->db->KeyMayExist(ro_, family_, make_slice(key), &value)) {
+      return false;
+    }
+    return get(key).has_value();
+  }
+
+  outcome::result<void> RocksDB::put(BufferView key, BufferView value) {
+    auto status =
+        db_->db->Put(wo_, family_, make_slice(key), make_slice(value));
+    if (status.ok()) {
+      return outcome::success();
+    }
+
+    return error_as_result<void>(status, logger_);
+  }
+
+  outcome::result<void> RocksDB::remove(BufferView key) {
+    auto status = db_->db->Delete(wo_, family_, make_slice(key));
+    if (status.ok()) {
+      return outcome::success();
+    }
+
+    return error_as_result<void>(status, logger_);
+  }
+
+}  // namespace fc::storage
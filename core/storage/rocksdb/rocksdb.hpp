@@ -0,0 +1,96 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_HPP
+#define CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_HPP
+
+#include <map>
+#include <vector>
+
+#include <rocksdb/db.h>
+#include "common/logger.hpp"
+#include "storage/buffer_map.hpp"
+#include "storage/config/storage_profile.hpp"
+
+namespace fc::storage {
+
+  /**
+   * @brief An implementation of PersistentBufferMap interface, which uses
+   * column family of RocksDB as underlying storage. Compared to LevelDB it
+   * compacts on many threads and may bypass page cache.
+   */
+  class RocksDB : public PersistentBufferMap {
+   public:
+    class Batch;
+    class Cursor;
+
+    ~RocksDB() override = default;
+
+    /**
+     * @brief Open database with default column family
+     * @param path filesystem path where database is going to be
+     * @param profile threads, direct io and table options of each family
+     * @return instance of default column family
+     */
+    static outcome::result<std::shared_ptr<RocksDB>> create(
+        const std::string &path, const config::StorageProfile &profile);
+
+    /**
+     * @brief Open database with column family for each namespace, so
+     * namespaces are tuned and compacted independently
+     * @param path filesystem path where database is going to be
+     * @param profile threads, direct io and table options of each family
+     * @return instances by namespace, sharing database
+     */
+    static outcome::result<
+        std::map<config::StorageNamespace, std::shared_ptr<RocksDB>>>
+    createFamilies(const std::string &path,
+                   const config::StorageProfile &profile);
+
+    std::unique_ptr<BufferMapCursor> cursor() override;
+
+    std::unique_ptr<BufferBatch> batch() override;
+
+    outcome::result<Buffer> get(const Buffer &key) const override;
+
+    bool contains(const Buffer &key) const override;
+
+    outcome::result<void> put(const Buffer &key, const Buffer &value) override;
+
+    outcome::result<void> put(const Buffer &key, Buffer &&value) override;
+
+    outcome::result<void> remove(const Buffer &key) override;
+
+    /// Same as above, but keys are borrowed
+    outcome::result<Buffer> get(BufferView key) const;
+    bool contains(BufferView key) const;
+    outcome::result<void> put(BufferView key, BufferView value);
+    outcome::result<void> remove(BufferView key);
+
+    /// Database and its column families, shared by instances and cursors
+    struct Db {
+      ~Db();
+
+      std::unique_ptr<rocksdb::DB> db;
+      /// Default family, then family of each namespace
+      std::vector<rocksdb::ColumnFamilyHandle *> families;
+    };
+
+    RocksDB(std::shared_ptr<Db> db, rocksdb::ColumnFamilyHandle *family);
+
+   private:
+    static outcome::result<std::shared_ptr<Db>> open(
+        const std::string &path, const config::StorageProfile &profile);
+
+    std::shared_ptr<Db> db_;
+    rocksdb::ColumnFamilyHandle *family_;
+    rocksdb::ReadOptions ro_;
+    rocksdb::WriteOptions wo_;
+    common::Logger logger_ = common::createLogger("rocksdb");
+  };
+
+}  // namespace fc::storage
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_HPP
@@ -0,0 +1,38 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_BATCH_HPP
+#define CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_BATCH_HPP
+
+#include <rocksdb/write_batch.h>
+#include "storage/rocksdb/rocksdb.hpp"
+
+namespace fc::storage {
+
+  /**
+   * @brief Class that is used to implement efficient bulk (batch) modifications
+   * of column family.
+   */
+  class RocksDB::Batch : public BufferBatch {
+   public:
+    explicit Batch(RocksDB &db);
+
+    outcome::result<void> put(const Buffer &key, const Buffer &value) override;
+    outcome::result<void> put(const Buffer &key, Buffer &&value) override;
+
+    outcome::result<void> remove(const Buffer &key) override;
+
+    outcome::result<void> commit() override;
+
+    void clear() override;
+
+   private:
+    RocksDB &db_;
+    rocksdb::WriteBatch batch_;
+  };
+
+}  // namespace fc::storage
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_BATCH_HPP
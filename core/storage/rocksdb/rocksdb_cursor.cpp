@@ -0,0 +1,49 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/rocksdb/rocksdb_cursor.hpp"
+
+#include "storage/rocksdb/rocksdb_util.hpp"
+
+namespace fc::storage {
+  using rocks::make_buffer;
+
+  RocksDB::Cursor::Cursor(std::shared_ptr<Db> db,
+                          std::unique_ptr<rocksdb::Iterator> it)
+      : db_(std::move(db)), i_(std::move(it)) {}
+
+  void RocksDB::Cursor::seekToFirst() {
+    i_->SeekToFirst();
+  }
+
+  void RocksDB::Cursor::seek(const Buffer &key) {
+    i_->Seek(rocks::make_slice(key));
+  }
+
+  void RocksDB::Cursor::seekToLast() {
+    i_->SeekToLast();
+  }
+
+  bool RocksDB::Cursor::isValid() const {
+    return i_->Valid();
+  }
+
+  void RocksDB::Cursor::next() {
+    i_->Next();
+  }
+
+  void RocksDB::Cursor::prev() {
+    i_->Prev();
+  }
+
+  Buffer RocksDB::Cursor::key() const {
+    return make_buffer(i_->key());
+  }
+
+  Buffer RocksDB::Cursor::value() const {
+    return make_buffer(i_->value());
+  }
+
+}  // namespace fc::storage
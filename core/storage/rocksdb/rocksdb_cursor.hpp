@@ -0,0 +1,49 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_CURSOR_HPP
+#define CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_CURSOR_HPP
+
+#include <rocksdb/iterator.h>
+#include "storage/rocksdb/rocksdb.hpp"
+
+namespace fc::storage {
+
+  /**
+   * @brief Instance of cursor can be used as bidirectional iterator over
+   * key-value bindings of column family.
+   */
+  class RocksDB::Cursor : public BufferMapCursor {
+   public:
+    ~Cursor() override = default;
+
+    /// Keeps database open, as iterator must be released before it
+    Cursor(std::shared_ptr<Db> db, std::unique_ptr<rocksdb::Iterator> it);
+
+    void seekToFirst() override;
+
+    void seek(const Buffer &key) override;
+
+    void seekToLast() override;
+
+    bool isValid() const override;
+
+    void next() override;
+
+    void prev() override;
+
+    Buffer key() const override;
+
+    Buffer value() const override;
+
+   private:
+    // destroyed after iterator
+    std::shared_ptr<Db> db_;
+    std::unique_ptr<rocksdb::Iterator> i_;
+  };
+
+}  // namespace fc::storage
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_CURSOR_HPP
@@ -0,0 +1,26 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/rocksdb/rocksdb_error.hpp"
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage, RocksDBError, e) {
+  using E = fc::storage::RocksDBError;
+  switch (e) {
+    case E::NOT_FOUND:
+      return "not found";
+    case E::CORRUPTION:
+      return "data corruption";
+    case E::NOT_SUPPORTED:
+      return "operation is not supported";
+    case E::INVALID_ARGUMENT:
+      return "invalid argument";
+    case E::IO_ERROR:
+      return "IO error";
+    case E::UNKNOWN:
+      break;
+  }
+
+  return "unknown error";
+}
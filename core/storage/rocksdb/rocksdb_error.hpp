@@ -0,0 +1,31 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_ERROR_HPP
+#define CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_ERROR_HPP
+
+#include "common/outcome.hpp"
+
+namespace fc::storage {
+
+  /**
+   * @brief RocksDB returns those type of errors, as described in
+   * <rocksdb/status.h>, Status::Code
+   */
+  enum class RocksDBError {
+    NOT_FOUND = 1,
+    CORRUPTION,
+    NOT_SUPPORTED,
+    INVALID_ARGUMENT,
+    IO_ERROR,
+
+    UNKNOWN = 1000
+  };
+
+}  // namespace fc::storage
+
+OUTCOME_HPP_DECLARE_ERROR(fc::storage, RocksDBError);
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_ERROR_HPP
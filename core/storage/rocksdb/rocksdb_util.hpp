@@ -0,0 +1,64 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_UTIL_HPP
+#define CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_UTIL_HPP
+
+#include <rocksdb/slice.h>
+#include <rocksdb/status.h>
+#include "common/buffer.hpp"
+#include "common/logger.hpp"
+#include "storage/rocksdb/rocksdb_error.hpp"
+
+namespace fc::storage::rocks {
+
+  template <typename T>
+  inline outcome::result<T> error_as_result(const rocksdb::Status &s) {
+    if (s.IsNotFound()) {
+      return RocksDBError::NOT_FOUND;
+    }
+
+    if (s.IsIOError()) {
+      return RocksDBError::IO_ERROR;
+    }
+
+    if (s.IsInvalidArgument()) {
+      return RocksDBError::INVALID_ARGUMENT;
+    }
+
+    if (s.IsCorruption()) {
+      return RocksDBError::CORRUPTION;
+    }
+
+    if (s.IsNotSupported()) {
+      return RocksDBError::NOT_SUPPORTED;
+    }
+
+    return RocksDBError::UNKNOWN;
+  }
+
+  template <typename T>
+  inline outcome::result<T> error_as_result(const rocksdb::Status &s,
+                                            const common::Logger &logger) {
+    logger->error(s.ToString());
+    return error_as_result<T>(s);
+  }
+
+  inline rocksdb::Slice make_slice(common::BufferView buf) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto *ptr = reinterpret_cast<const char *>(buf.data());
+    return rocksdb::Slice{ptr, static_cast<size_t>(buf.size())};
+  }
+
+  inline common::Buffer make_buffer(const rocksdb::Slice &s) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto *ptr = reinterpret_cast<const uint8_t *>(s.data());
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return common::Buffer(ptr, ptr + s.size());
+  }
+
+}  // namespace fc::storage::rocks
+
+#endif  // CPP_FILECOIN_CORE_STORAGE_ROCKSDB_ROCKSDB_UTIL_HPP
@@ -5,17 +5,19 @@
 
 #include "storage/unixfs/unixfs.hpp"
 
-#include <google/protobuf/io/coded_stream.h>
-#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <functional>
+#include <future>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 
-#include "common/span.hpp"
 #include "crypto/hasher/hasher.hpp"
+#include "storage/ipld/dag_pb.hpp"
 
 namespace fc::storage::unixfs {
   using common::Buffer;
   using crypto::Hasher;
-  using google::protobuf::io::CodedOutputStream;
-  using google::protobuf::io::StringOutputStream;
+  namespace dag_pb = ipld::dag_pb;
 
   outcome::result<CID> makeLeaf(Ipld &ipld, gsl::span<const uint8_t> data) {
     CID cid{CID::Version::V1, CID::Multicodec::RAW, Hasher::sha2_256(data)};
@@ -23,84 +25,59 @@ namespace fc::storage::unixfs {
     return cid;
   }
 
-  struct PbBuilder {
-    void _tag(uint64_t id, uint64_t value, bool str) {
-      cs.WriteTag((id << 3) | (str ? 2 : 0));
-      cs.WriteVarint64(value);
-    }
-
-    void _str(uint64_t id, gsl::span<const char> str) {
-      _tag(id, str.size(), true);
-      cs.WriteRaw(str.data(), str.size());
-    }
-
-    Buffer toBytes() {
-      cs.Trim();
-      return Buffer{common::span::cbytes(s)};
-    }
-
-    std::string toString() {
-      cs.Trim();
-      return s;
-    }
-
-    PbBuilder &operator+=(PbBuilder &other) {
-      cs.Trim();
-      s += other.toString();
-      return *this;
-    }
-
-    std::string s;
-    StringOutputStream ss{&s};
-    CodedOutputStream cs{&ss};
+  struct Tree {
+    size_t size{}, file_size{};
+    CID cid;
   };
 
-  struct PbNodeBuilder : PbBuilder {
-    void link(CID cid, size_t size) {
-      PbBuilder link;
-      OUTCOME_EXCEPT(cid_bytes, cid.toBytes());
-      link._str(1, common::span::cstring(cid_bytes));
-      link._tag(2, 0, true);
-      link._tag(3, size, false);
-      _str(2, link.toString());
-    }
+  /// Unixfs Data message fields
+  enum class PbFileField : uint32_t { TYPE = 1, FILE_SIZE = 3, BLOCK_SIZE = 4 };
+  constexpr uint64_t kFileType{2};
 
-    void content(gsl::span<const char> str) {
-      _str(1, str);
+  /// Encodes file node linking children directly into node buffer
+  Tree makeNode(gsl::span<const Tree> children, Buffer &node) {
+    Tree root;
+    for (auto &tree : children) {
+      root.size += tree.size;
+      root.file_size += tree.file_size;
     }
-  };
-
-  struct PbFileBuilder {
-    void block(size_t size) {
-      blocks._tag(4, size, false);
-      total += size;
+    Buffer file;
+    dag_pb::PbWriter pb_file{file};
+    pb_file.varint(static_cast<uint32_t>(PbFileField::TYPE), kFileType);
+    pb_file.varint(static_cast<uint32_t>(PbFileField::FILE_SIZE),
+                   root.file_size);
+    for (auto &tree : children) {
+      pb_file.varint(static_cast<uint32_t>(PbFileField::BLOCK_SIZE),
+                     tree.file_size);
     }
-
-    std::string toString() {
-      PbBuilder file;
-      file._tag(1, 2, false);
-      file._tag(3, total, false);
-      file += blocks;
-      return file.toString();
+    // cid, name and size of link take less than 64 bytes
+    node.reserve(children.size() * 64 + file.size() + 16);
+    dag_pb::PbWriter pb_node{node};
+    for (auto &tree : children) {
+      OUTCOME_EXCEPT(cid_bytes, tree.cid.toBytes());
+      dag_pb::writeLink(pb_node, cid_bytes, {}, tree.size);
     }
+    dag_pb::writeData(pb_node, file);
+    root.size += node.size();
+    root.cid = dag_pb::cid(node);
+    return root;
+  }
 
-    size_t total{};
-    PbBuilder blocks;
-  };
-
-  struct Tree {
-    size_t size{}, file_size{};
-    CID cid;
-  };
+  /// Height of balanced tree of file, 0 for single leaf
+  size_t treeHeight(uint64_t size, size_t chunk_size, size_t max_links) {
+    size_t height = 0;
+    for (uint64_t max = chunk_size; max < size; max *= max_links) {
+      ++height;
+    }
+    return height;
+  }
 
   outcome::result<Tree> makeTree(Ipld &ipld,
                                  size_t height,
                                  gsl::span<const uint8_t> &data,
                                  size_t chunk_size,
                                  size_t max_links) {
-    Tree root;
-    PbFileBuilder pb_file;
-    PbNodeBuilder pb_node;
+    std::vector<Tree> children;
     for (auto i = 0u; i < max_links && !data.empty(); ++i) {
       Tree tree;
       if (height == 1) {
@@ -112,16 +89,10 @@ namespace fc::storage::unixfs {
         OUTCOME_TRYA(tree,
                      makeTree(ipld, height - 1, data, chunk_size, max_links));
       }
-      root.size += tree.size;
-      root.file_size += tree.file_size;
-      pb_file.block(tree.file_size);
-      pb_node.link(std::move(tree.cid), tree.size);
+      children.push_back(std::move(tree));
     }
-    pb_node.content(pb_file.toString());
-    auto node = pb_node.toBytes();
-    root.size += node.size();
-    root.cid =
-        CID{CID::Version::V0, CID::Multicodec::DAG_PB, Hasher::sha2_256(node)};
+    Buffer node;
+    auto root = makeNode(children, node);
     OUTCOME_TRY(ipld.set(root.cid, node));
     return root;
   }
@@ -130,14 +101,237 @@ namespace fc::storage::unixfs {
                                 gsl::span<const uint8_t> data,
                                 size_t chunk_size,
                                 size_t max_links) {
-    size_t height = 0;
-    for (ssize_t max = chunk_size; max < data.size(); max *= max_links) {
-      ++height;
-    }
+    auto height = treeHeight(data.size(), chunk_size, max_links);
     if (height == 0) {
       return makeLeaf(ipld, data);
     }
     OUTCOME_TRY(tree, makeTree(ipld, height, data, chunk_size, max_links));
     return std::move(tree.cid);
   }
+
+  outcome::result<CID> wrapFile(Ipld &ipld,
+                                std::istream &input,
+                                size_t chunk_size,
+                                size_t max_links,
+                                size_t threads) {
+    boost::asio::thread_pool pool{std::max<size_t>(threads, 1)};
+    // unfinished nodes by height, leaves first
+    std::vector<std::vector<Tree>> levels(1);
+    Ipld::Blocks blocks;
+    uint64_t total = 0;
+
+    // replaces children at level with their node at level above
+    auto close = [&](size_t level) {
+      Buffer node;
+      auto tree = makeNode(levels[level], node);
+      levels[level].clear();
+      blocks.emplace_back(tree.cid, std::move(node));
+      if (level + 1 == levels.size()) {
+        levels.emplace_back();
+      }
+      levels[level + 1].push_back(std::move(tree));
+    };
+
+    bool eof = false;
+    while (!eof) {
+      std::vector<Buffer> chunks;
+      while (!eof && chunks.size() < kImportBatch) {
+        Buffer chunk(chunk_size, 0);
+        input.read(reinterpret_cast<char *>(chunk.data()), chunk_size);
+        if (input.bad()) {
+          return UnixfsError::READ_FILE_ERROR;
+        }
+        chunk.resize(input.gcount());
+        eof = chunk.size() < chunk_size;
+        if (!chunk.empty() || (eof && total == 0 && chunks.empty())) {
+          // empty file is single empty leaf
+          chunks.push_back(std::move(chunk));
+        }
+      }
+
+      std::vector<std::future<CID>> cids;
+      cids.reserve(chunks.size());
+      for (auto &chunk : chunks) {
+        std::packaged_task<CID()> task{[&chunk] {
+          return CID{
+              CID::Version::V1, CID::Multicodec::RAW, Hasher::sha2_256(chunk)};
+        }};
+        cids.push_back(task.get_future());
+        boost::asio::post(pool, std::move(task));
+      }
+      for (size_t i = 0; i < chunks.size(); ++i) {
+        Tree leaf;
+        leaf.cid = cids[i].get();
+        leaf.size = leaf.file_size = chunks[i].size();
+        total += leaf.file_size;
+        blocks.emplace_back(leaf.cid, std::move(chunks[i]));
+        levels[0].push_back(std::move(leaf));
+        for (size_t level = 0; levels[level].size() == max_links; ++level) {
+          close(level);
+        }
+      }
+      // only ready blocks are kept in memory
+      OUTCOME_TRY(ipld.setMany(std::move(blocks)));
+      blocks.clear();
+    }
+
+    auto height = treeHeight(total, chunk_size, max_links);
+    if (height == 0) {
+      return levels[0].front().cid;
+    }
+    // last nodes of levels below root are partial
+    for (size_t level = 0; level < height; ++level) {
+      if (!levels[level].empty()) {
+        close(level);
+      }
+    }
+    OUTCOME_TRY(ipld.setMany(std::move(blocks)));
+    return levels[height].front().cid;
+  }
+
+  /// Reads protobuf message, value is set for varint fields, bytes for
+  /// length-delimited fields
+  outcome::result<void> readPb(
+      gsl::span<const uint8_t> input,
+      const std::function<outcome::result<void>(
+          uint32_t field, uint64_t value, gsl::span<const uint8_t> bytes)>
+          &on_field) {
+    dag_pb::PbReader reader{input};
+    while (true) {
+      auto field = reader.next();
+      if (!field) {
+        return UnixfsError::INVALID_FILE_NODE;
+      }
+      if (!field.value()) {
+        break;
+      }
+      auto &[id, value, bytes] = *field.value();
+      OUTCOME_TRY(on_field(id, value, bytes));
+    }
+    return outcome::success();
+  }
+
+  /// Links of file node with sizes of file data under them
+  struct PbFileNode {
+    std::vector<CID> links;
+    std::vector<uint64_t> sizes;
+    uint64_t file_size{};
+  };
+
+  outcome::result<PbFileNode> decodeFileNode(gsl::span<const uint8_t> input) {
+    PbFileNode node;
+    auto on_link = [&](auto &link) -> outcome::result<void> {
+      OUTCOME_TRY(cid, CID::fromBytes(link.cid));
+      node.links.push_back(std::move(cid));
+      return outcome::success();
+    };
+    auto on_data = [&](auto field, auto value, auto) -> outcome::result<void> {
+      if (field == static_cast<uint32_t>(PbFileField::FILE_SIZE)) {
+        node.file_size = value;
+      } else if (field == static_cast<uint32_t>(PbFileField::BLOCK_SIZE)) {
+        node.sizes.push_back(value);
+      }
+      return outcome::success();
+    };
+    auto data = dag_pb::decode(input, on_link);
+    if (!data) {
+      return UnixfsError::INVALID_FILE_NODE;
+    }
+    OUTCOME_TRY(readPb(data.value(), on_data));
+    if (node.links.size() != node.sizes.size()) {
+      return UnixfsError::INVALID_FILE_NODE;
+    }
+    return std::move(node);
+  }
+
+  /**
+   * Selects blocks of subtree holding range
+   * @param begin - offset of subtree data in file
+   * @param size - size of raw leaf data, dag-pb nodes store their size
+   * @param offset, end - range of file
+   */
+  outcome::result<Selector> selectRange(Ipld &ipld,
+                                        const CID &cid,
+                                        uint64_t begin,
+                                        uint64_t size,
+                                        uint64_t offset,
+                                        uint64_t end,
+                                        std::vector<FileBlock> &leaves) {
+    PbFileNode node;
+    if (cid.content_type == CID::Multicodec::DAG_PB) {
+      OUTCOME_TRY(bytes, ipld.get(cid));
+      OUTCOME_TRYA(node, decodeFileNode(bytes));
+      size = node.file_size;
+    } else if (cid.content_type != CID::Multicodec::RAW) {
+      return UnixfsError::INVALID_FILE_NODE;
+    }
+    if (node.links.empty()) {
+      leaves.push_back({cid, begin, size});
+      return Selector::matcher();
+    }
+
+    std::vector<Selector> selectors;
+    // run of children inside range, selected as whole subtrees
+    boost::optional<uint64_t> full;
+    auto flush = [&](uint64_t i) {
+      if (full) {
+        selectors.push_back(Selector::exploreRange(*full, i, Selector{}));
+        full.reset();
+      }
+    };
+    for (uint64_t i = 0; i < node.links.size(); ++i) {
+      auto child_end = begin + node.sizes[i];
+      if (child_end > offset && begin < end) {
+        OUTCOME_TRY(selector,
+                    selectRange(ipld,
+                                node.links[i],
+                                begin,
+                                node.sizes[i],
+                                offset,
+                                end,
+                                leaves));
+        if (begin >= offset && child_end <= end) {
+          if (!full) {
+            full = i;
+          }
+        } else {
+          flush(i);
+          selectors.push_back(Selector::exploreIndex(i, std::move(selector)));
+        }
+      } else {
+        flush(i);
+      }
+      begin = child_end;
+    }
+    flush(node.links.size());
+    return Selector::exploreUnion(std::move(selectors));
+  }
+
+  outcome::result<FileRange> fileRange(Ipld &ipld,
+                                       const CID &root,
+                                       uint64_t offset,
+                                       uint64_t size) {
+    uint64_t root_size{};
+    if (root.content_type == CID::Multicodec::RAW) {
+      OUTCOME_TRY(bytes, ipld.get(root));
+      root_size = bytes.size();
+    }
+    auto end = size > UINT64_MAX - offset ? UINT64_MAX : offset + size;
+    FileRange range;
+    OUTCOME_TRYA(
+        range.selector,
+        selectRange(ipld, root, 0, root_size, offset, end, range.leaves));
+    return std::move(range);
+  }
 }  // namespace fc::storage::unixfs
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::unixfs, UnixfsError, e) {
+  using fc::storage::unixfs::UnixfsError;
+  switch (e) {
+    case UnixfsError::INVALID_FILE_NODE:
+      return "UnixfsError: invalid file node";
+    case UnixfsError::READ_FILE_ERROR:
+      return "UnixfsError: cannot read file";
+  }
+  return "unknown error";
+}
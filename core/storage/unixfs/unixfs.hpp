@@ -6,18 +6,72 @@
 #ifndef CPP_FILECOIN_CORE_STORAGE_UNIXFS_UNIXFS_HPP
 #define CPP_FILECOIN_CORE_STORAGE_UNIXFS_UNIXFS_HPP
 
+#include <istream>
+
 #include "storage/ipfs/datastore.hpp"
+#include "storage/ipld/selector.hpp"
 
 namespace fc::storage::unixfs {
   using Ipld = ipfs::IpfsDatastore;
+  using ipld::Selector;
+
+  enum class UnixfsError {
+    INVALID_FILE_NODE = 1,
+    READ_FILE_ERROR,
+  };
 
   constexpr size_t kMaxLinks = 1024;
   constexpr size_t kChunkSize = 1024;
 
+  /// Chunks read, hashed and written at once by streaming import
+  constexpr size_t kImportBatch = 1024;
+
   outcome::result<CID> wrapFile(Ipld &ipld,
                                 gsl::span<const uint8_t> data,
                                 size_t chunk_size = kChunkSize,
                                 size_t max_links = kMaxLinks);
+
+  /**
+   * Imports file read sequentially in batches of chunks, builds same dag as
+   * wrapFile for same data. Leaves of batch are hashed concurrently, tree
+   * nodes are built as their children are complete, so memory is bounded by
+   * batch and open nodes of each tree level.
+   * @param input - file data
+   * @param threads - threads hashing leaves
+   */
+  outcome::result<CID> wrapFile(Ipld &ipld,
+                                std::istream &input,
+                                size_t chunk_size = kChunkSize,
+                                size_t max_links = kMaxLinks,
+                                size_t threads = 4);
+
+  /// Leaf block of file and range of file data it holds
+  struct FileBlock {
+    CID cid;
+    uint64_t offset{};
+    uint64_t size{};
+  };
+
+  /// Blocks needed to read byte range of file
+  struct FileRange {
+    /// Leaves holding range, in file order
+    std::vector<FileBlock> leaves;
+    /// Selects nodes on paths from root to the leaves, and the leaves
+    Selector selector;
+  };
+
+  /**
+   * Finds blocks of file holding byte range, reads file nodes from ipld
+   * @param root - file root, raw leaf or dag-pb node
+   * @param offset - offset of range in file data
+   * @param size - size of range, clamped to file end
+   */
+  outcome::result<FileRange> fileRange(Ipld &ipld,
+                                       const CID &root,
+                                       uint64_t offset,
+                                       uint64_t size);
 }  // namespace fc::storage::unixfs
 
+OUTCOME_HPP_DECLARE_ERROR(fc::storage::unixfs, UnixfsError);
+
 #endif  // CPP_FILECOIN_CORE_STORAGE_UNIXFS_UNIXFS_HPP
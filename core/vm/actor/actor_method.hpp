@@ -28,13 +28,12 @@ namespace fc::vm::actor {
 
   /**
    * Actor method signature
-   * @param Actor - actor itself
    * @param Runtime - VM context exposed to actors during method execution
    * @param MethodParams - parameters for method call
    * @return InvocationOutput - invocation method result or error occurred
    */
-  using ActorMethod = std::function<outcome::result<InvocationOutput>(
-      Runtime &, const MethodParams &)>;
+  using ActorMethod = outcome::result<InvocationOutput> (*)(
+      Runtime &, const MethodParams &);
 
   /// Actor methods exported by number
   using ActorExports = std::map<MethodNumber, ActorMethod>;
@@ -47,17 +46,19 @@ namespace fc::vm::actor {
     static constexpr MethodNumber Number{number};
   };
 
-  /// Generate export table entry
+  /// Decode params, call method and encode result
+  template <typename M>
+  outcome::result<InvocationOutput> invokeMethod(Runtime &runtime,
+                                                 const MethodParams &params) {
+    OUTCOME_TRY(params2, decodeActorParams<typename M::Params>(params));
+    OUTCOME_TRY(result, M::call(runtime, params2));
+    return encodeActorReturn(result);
+  }
+
+  /// Generate export table entry, method is dispatched without std::function
   template <typename M>
   auto exportMethod() {
-    return std::make_pair(
-        M::Number,
-        ActorMethod{[](auto &runtime,
-                       auto &params) -> outcome::result<InvocationOutput> {
-          OUTCOME_TRY(params2, decodeActorParams<typename M::Params>(params));
-          OUTCOME_TRY(result, M::call(runtime, params2));
-          return encodeActorReturn(result);
-        }});
+    return std::make_pair(M::Number, ActorMethod{&invokeMethod<M>});
   }
 }  // namespace fc::vm::actor
 
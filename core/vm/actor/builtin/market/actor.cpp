@@ -135,18 +135,46 @@ namespace fc::vm::actor::builtin::market {
     return result;
   }
 
-  outcome::result<void> maybeLockBalance(State &state,
-                                         const Address &address,
-                                         TokenAmount amount) {
-    VM_ASSERT(amount >= 0);
-    OUTCOME_TRY(escrow, state.escrow_table.get(address));
-    OUTCOME_TRY(locked, state.locked_table.get(address));
-    if (locked + amount > escrow) {
-      return VMExitCode::MARKET_ACTOR_INSUFFICIENT_FUNDS;
+  /**
+   * Balances locked by deals of one message. Tables are read once per
+   * address and written by commit, checks are same as locking deals one by
+   * one, so message fails on same deal with same exit code.
+   */
+  struct BalanceLocks {
+    struct Balance {
+      TokenAmount escrow;
+      TokenAmount locked;
+      /// Locked by previous deals of message
+      TokenAmount added;
+    };
+
+    outcome::result<void> lock(State &state,
+                               const Address &address,
+                               TokenAmount amount) {
+      VM_ASSERT(amount >= 0);
+      auto it = balances.find(address);
+      if (it == balances.end()) {
+        OUTCOME_TRY(escrow, state.escrow_table.get(address));
+        OUTCOME_TRY(locked, state.locked_table.get(address));
+        it = balances.emplace(address, Balance{escrow, locked, 0}).first;
+      }
+      auto &balance = it->second;
+      if (balance.locked + balance.added + amount > balance.escrow) {
+        return VMExitCode::MARKET_ACTOR_INSUFFICIENT_FUNDS;
+      }
+      balance.added += amount;
+      return outcome::success();
     }
-    OUTCOME_TRY(state.locked_table.add(address, amount));
-    return outcome::success();
-  }
+
+    outcome::result<void> commit(State &state) const {
+      for (auto &[address, balance] : balances) {
+        OUTCOME_TRY(state.locked_table.add(address, balance.added));
+      }
+      return outcome::success();
+    }
+
+    std::map<Address, Balance> balances;
+  };
 
   outcome::result<void> validateDeal(Runtime &runtime,
                                      const ClientDealProposal &proposal) {
@@ -232,31 +260,48 @@ namespace fc::vm::actor::builtin::market {
     }
     std::vector<DealId> deals;
     OUTCOME_TRY(state, loadState(runtime));
+    // deals of message usually share client and start epoch, so balances,
+    // resolved clients and deal sets are updated once per message
+    BalanceLocks locks;
+    std::map<Address, Address> clients;
+    std::map<ChainEpoch, State::DealSet> deal_sets;
     for (auto &proposal : params.deals) {
       OUTCOME_TRY(validateDeal(runtime, proposal));
 
       auto deal{proposal.proposal};
       VM_ASSERT(deal.provider == provider || deal.provider == provider_raw);
 
-      OUTCOME_TRY(client, runtime.resolveAddress(deal.client));
+      auto client = clients.find(deal.client);
+      if (client == clients.end()) {
+        OUTCOME_TRY(resolved, runtime.resolveAddress(deal.client));
+        client = clients.emplace(deal.client, resolved).first;
+      }
       deal.provider = provider;
-      deal.client = client;
+      deal.client = client->second;
 
       OUTCOME_TRY(
-          maybeLockBalance(state, client, deal.clientBalanceRequirement()));
+          locks.lock(state, deal.client, deal.clientBalanceRequirement()));
       OUTCOME_TRY(
-          maybeLockBalance(state, provider, deal.providerBalanceRequirement()));
+          locks.lock(state, provider, deal.providerBalanceRequirement()));
 
       auto deal_id = state.next_deal++;
       OUTCOME_TRY(state.proposals.set(deal_id, deal));
-      OUTCOME_TRY(set, state.deals_by_epoch.tryGet(deal.start_epoch));
-      if (!set) {
-        set = State::DealSet{IpldPtr{runtime}};
+      auto set = deal_sets.find(deal.start_epoch);
+      if (set == deal_sets.end()) {
+        OUTCOME_TRY(loaded, state.deals_by_epoch.tryGet(deal.start_epoch));
+        set = deal_sets
+                  .emplace(deal.start_epoch,
+                           loaded ? std::move(*loaded)
+                                  : State::DealSet{IpldPtr{runtime}})
+                  .first;
       }
-      OUTCOME_TRY(set->set(deal_id, {}));
-      OUTCOME_TRY(state.deals_by_epoch.set(deal.start_epoch, *set));
+      OUTCOME_TRY(set->second.set(deal_id, {}));
       deals.emplace_back(deal_id);
     }
+    OUTCOME_TRY(locks.commit(state));
+    for (auto &[epoch, set] : deal_sets) {
+      OUTCOME_TRY(state.deals_by_epoch.set(epoch, set));
+    }
     OUTCOME_TRY(runtime.commitState(state));
     return Result{.deals = deals};
   }
@@ -312,6 +357,34 @@ namespace fc::vm::actor::builtin::market {
     return runtime.computeUnsealedSectorCid(params.sector_type, pieces);
   }
 
+  /**
+   * Deal sets scheduled for epochs in (from, to], ordered by epoch. Short
+   * ranges are probed epoch by epoch, longer catch-up after null rounds
+   * visits scheduled epochs once instead of probing empty ones.
+   */
+  outcome::result<std::map<ChainEpoch, State::DealSet>> dueDealSets(
+      State &state, ChainEpoch from, ChainEpoch to) {
+    std::map<ChainEpoch, State::DealSet> due;
+    if (to - from <= kCronProbeEpochs) {
+      for (auto epoch{from + 1}; epoch <= to; ++epoch) {
+        OUTCOME_TRY(set, state.deals_by_epoch.tryGet(epoch));
+        if (set) {
+          due.emplace(epoch, std::move(*set));
+        }
+      }
+    } else {
+      OUTCOME_TRY(state.deals_by_epoch.visit(
+          [&](auto key, auto &set) -> outcome::result<void> {
+            auto epoch{static_cast<ChainEpoch>(key)};
+            if (epoch > from && epoch <= to) {
+              due.emplace(epoch, set);
+            }
+            return outcome::success();
+          }));
+    }
+    return std::move(due);
+  }
+
   ACTOR_METHOD_IMPL(CronTick) {
     OUTCOME_TRY(runtime.validateImmediateCallerIs(kCronAddress));
     auto now{runtime.getCurrentEpoch()};
@@ -319,39 +392,36 @@ namespace fc::vm::actor::builtin::market {
     TokenAmount slashed_sum;
     std::map<ChainEpoch, std::vector<DealId>> next_updates;
     std::vector<DealProposal> timed_out_verified;
-    for (auto epoch{state.last_cron + 1}; epoch <= now; ++epoch) {
-      OUTCOME_TRY(set, state.deals_by_epoch.tryGet(epoch));
-      if (set) {
-        auto visitor{[&](auto deal_id, auto) -> outcome::result<void> {
-          OUTCOME_TRY(deal_state, state.states.tryGet(deal_id));
-          if (deal_state) {
-            OUTCOME_TRY(deal, state.proposals.get(deal_id));
-            if (deal_state->sector_start_epoch == kChainEpochUndefined) {
-              VM_ASSERT(now >= deal.start_epoch);
-              OUTCOME_TRY(slashed,
-                          processDealInitTimedOut(state, deal_id, deal));
-              slashed_sum += slashed;
-              if (deal.verified) {
-                timed_out_verified.push_back(deal);
-              }
-            } else {
-              OUTCOME_TRY(slashed_next,
-                          updatePendingDealState(
-                              state, deal_id, deal, *deal_state, now));
-              slashed_sum += slashed_next.first;
-              if (slashed_next.second != kChainEpochUndefined) {
-                VM_ASSERT(slashed_next.second > now);
-                deal_state->last_updated_epoch = now;
-                OUTCOME_TRY(state.states.set(deal_id, *deal_state));
-                next_updates[slashed_next.second].push_back(deal_id);
-              }
-            }
+    auto visitor{[&](auto deal_id, auto) -> outcome::result<void> {
+      OUTCOME_TRY(deal_state, state.states.tryGet(deal_id));
+      if (deal_state) {
+        OUTCOME_TRY(deal, state.proposals.get(deal_id));
+        if (deal_state->sector_start_epoch == kChainEpochUndefined) {
+          VM_ASSERT(now >= deal.start_epoch);
+          OUTCOME_TRY(slashed, processDealInitTimedOut(state, deal_id, deal));
+          slashed_sum += slashed;
+          if (deal.verified) {
+            timed_out_verified.push_back(deal);
+          }
+        } else {
+          OUTCOME_TRY(slashed_next,
+                      updatePendingDealState(
+                          state, deal_id, deal, *deal_state, now));
+          slashed_sum += slashed_next.first;
+          if (slashed_next.second != kChainEpochUndefined) {
+            VM_ASSERT(slashed_next.second > now);
+            deal_state->last_updated_epoch = now;
+            OUTCOME_TRY(state.states.set(deal_id, *deal_state));
+            next_updates[slashed_next.second].push_back(deal_id);
           }
-          return outcome::success();
-        }};
-        OUTCOME_TRY(set->visit(visitor));
-        OUTCOME_TRY(state.deals_by_epoch.remove(epoch));
+        }
       }
+      return outcome::success();
+    }};
+    OUTCOME_TRY(due, dueDealSets(state, state.last_cron, now));
+    for (auto &[epoch, set] : due) {
+      OUTCOME_TRY(set.visit(visitor));
+      OUTCOME_TRY(state.deals_by_epoch.remove(epoch));
     }
     for (auto &[next, deals] : next_updates) {
       OUTCOME_TRY(set, state.deals_by_epoch.tryGet(next));
@@ -15,6 +15,7 @@
 #include "primitives/piece/piece.hpp"
 #include "primitives/sector/sector.hpp"
 #include "primitives/types.hpp"
+#include "storage/ipld/lazy_tuple.hpp"
 #include "vm/actor/actor_method.hpp"
 
 namespace fc::vm::actor::builtin::market {
@@ -110,6 +111,13 @@ namespace fc::vm::actor::builtin::market {
              deals_by_epoch,
              last_cron)
 
+  /// Fields of State decoded by LazyTuple
+  namespace lazy {
+    using storage::ipld::LazyField;
+    constexpr LazyField<BalanceTable> kEscrowTable{2};
+    constexpr LazyField<BalanceTable> kLockedTable{3};
+  }  // namespace lazy
+
   struct ClientDealProposal {
     DealProposal proposal;
     Signature client_signature;
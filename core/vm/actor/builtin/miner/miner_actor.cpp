@@ -5,6 +5,7 @@
 
 #include "vm/actor/builtin/miner/miner_actor.hpp"
 
+#include <algorithm>
 #include <boost/endian/buffers.hpp>
 
 #include "vm/actor/builtin/account/account_actor.hpp"
@@ -166,18 +167,10 @@ namespace fc::vm::actor::builtin::miner {
   }
 
   outcome::result<void> removeFaults(State &state, const RleBitset &sectors) {
-    for (auto sector : sectors) {
-      state.fault_set.erase(sector);
-    }
+    state.fault_set.erase(sectors);
     OUTCOME_TRY(state.fault_epochs.visit(
         [&](auto epoch, auto faults) -> outcome::result<void> {
-          auto change{false};
-          for (auto sector : sectors) {
-            if (faults.erase(sector) != 0) {
-              change = true;
-            }
-          }
-          if (change) {
+          if (faults.erase(sectors) != 0) {
             OUTCOME_TRY(state.fault_epochs.set(epoch, faults));
           }
           return outcome::success();
@@ -190,12 +183,12 @@ namespace fc::vm::actor::builtin::miner {
                                                 const RleBitset &sectors) {
     for (auto sector : sectors) {
       OUTCOME_TRY(state.sectors.remove(sector));
-      state.new_sectors.erase(sector);
-      for (auto &deadline : deadlines.due) {
-        deadline.erase(sector);
-      }
-      state.recoveries.erase(sector);
     }
+    state.new_sectors.erase(sectors);
+    for (auto &deadline : deadlines.due) {
+      deadline.erase(sectors);
+    }
+    state.recoveries.erase(sectors);
     OUTCOME_TRY(removeFaults(state, sectors));
     return outcome::success();
   }
@@ -233,7 +226,7 @@ namespace fc::vm::actor::builtin::miner {
     assert(index < due.size());
     size_t first_part{0};
     for (size_t i{0};; ++i) {
-      auto [parts, sectors]{count(part_size, index)};
+      auto [parts, sectors]{count(part_size, i)};
       if (i == index) {
         return {first_part, sectors};
       }
@@ -255,13 +248,13 @@ namespace fc::vm::actor::builtin::miner {
     if (sectors.empty()) {
       return outcome::success();
     }
-    fault_set.insert(sectors.begin(), sectors.end());
+    fault_set.insert(sectors);
     VM_ASSERT(fault_set.size() <= kSectorsMax);
     OUTCOME_TRY(faults, fault_epochs.tryGet(epoch));
     if (!faults) {
       faults = RleBitset{};
     }
-    faults->insert(sectors.begin(), sectors.end());
+    faults->insert(sectors);
     OUTCOME_TRY(fault_epochs.set(epoch, *faults));
     return outcome::success();
   }
@@ -271,27 +264,31 @@ namespace fc::vm::actor::builtin::miner {
                                      size_t before_deadline) {
     std::pair<RleBitset, RleBitset> faults;
     auto part_size{state.info.window_post_partition_sectors};
+    // sectors of partitions without post, sliced by runs of partitions
+    RleBitset missed;
     size_t first_part{0};
     for (size_t deadline{0}; deadline < before_deadline; ++deadline) {
       auto [parts, sectors]{deadlines.count(part_size, deadline)};
-      auto sector{deadlines.due[deadline].begin()};
-      for (size_t part{0}; part < parts; ++part) {
-        if (state.post_submissions.find(first_part + part)
-            == state.post_submissions.end()) {
-          for (auto i{std::min(part_size, sectors - part * part_size)}; i != 0;
-               --i) {
-            if (state.fault_set.find(*sector) == state.fault_set.end()) {
-              faults.first.insert(*sector);
-            }
-            if (state.recoveries.find(*sector) != state.recoveries.end()) {
-              faults.second.insert(*sector);
-            }
-            ++sector;
-          }
+      RleBitset::Slicer slicer{deadlines.due[deadline]};
+      for (size_t part{0}; part < parts;) {
+        auto submitted{state.post_submissions.count(first_part + part) != 0};
+        auto end{part + 1};
+        while (end < parts
+               && (state.post_submissions.count(first_part + end) != 0)
+                      == submitted) {
+          ++end;
+        }
+        if (submitted) {
+          slicer.skip((end - part) * part_size);
+        } else {
+          missed.insert(slicer.take((end - part) * part_size));
         }
+        part = end;
       }
       first_part += parts;
     }
+    faults.first = missed - state.fault_set;
+    faults.second = missed & state.recoveries;
     return faults;
   }
 
@@ -299,18 +296,20 @@ namespace fc::vm::actor::builtin::miner {
       const Deadlines &deadlines,
       size_t part_size,
       size_t index,
-      const std::vector<uint64_t> parts) {
+      std::vector<uint64_t> parts) {
     RleBitset result;
     auto [first_part, sectors]{deadlines.partitions(part_size, index)};
     auto max_part{first_part + (sectors + part_size - 1) / part_size};
+    // slice partitions in order, so deadline runs are walked once
+    std::sort(parts.begin(), parts.end());
+    parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+    RleBitset::Slicer slicer{deadlines.due[index]};
+    auto next{first_part};
     for (auto part : parts) {
       VM_ASSERT(part >= first_part && part < max_part);
-      size_t offset{(part - first_part) * part_size};
-      auto begin{deadlines.due[index].begin()};
-      std::advance(begin, offset);
-      auto end{begin};
-      std::advance(end, std::min(part_size, sectors - offset));
-      result.insert(begin, end);
+      slicer.skip((part - next) * part_size);
+      result.insert(slicer.take(part_size));
+      next = part + 1;
     }
     return std::move(result);
   }
@@ -323,14 +322,8 @@ namespace fc::vm::actor::builtin::miner {
     auto [detected, recoveries] =
         computeFaultsFromMissingPoSts(state, deadlines, before_deadline);
     OUTCOME_TRY(state.addFaults(detected, period_start));
-    for (auto sector : recoveries) {
-      state.recoveries.erase(sector);
-    }
-    std::vector<SectorOnChainInfo> detected_sectors;
-    for (auto sector_num : detected) {
-      OUTCOME_TRY(sector, state.sectors.get(sector_num));
-      detected_sectors.push_back(std::move(sector));
-    }
+    state.recoveries.erase(recoveries);
+    OUTCOME_TRY(detected_sectors, state.getSectors(detected));
     // TODO(turuslan): zero penalty now, FIL-233
     TokenAmount penalty{0};
     return std::make_pair(std::move(detected_sectors), std::move(penalty));
@@ -361,9 +354,9 @@ namespace fc::vm::actor::builtin::miner {
   loadSectorInfosForProof(State &state, const RleBitset &proven) {
     std::pair<std::vector<SectorOnChainInfo>, RleBitset> result;
     result.first.resize(proven.size());
-    std::vector<size_t> faults;
+    std::vector<size_t> faults, goods;
+    std::vector<uint64_t> good_sectors;
     size_t i{0};
-    boost::optional<size_t> good;
     for (auto &s : proven) {
       auto fault{state.fault_set.count(s) != 0};
       auto recovery{fault && state.recoveries.count(s) != 0};
@@ -371,17 +364,20 @@ namespace fc::vm::actor::builtin::miner {
         result.second.insert(s);
       }
       if (!fault || recovery) {
-        if (!good) {
-          good = i;
-        }
-        OUTCOME_TRYA(result.first[i], state.sectors.get(s));
+        goods.push_back(i);
+        good_sectors.push_back(s);
       } else {
         faults.push_back(i);
       }
+      ++i;
+    }
+    VM_ASSERT(!goods.empty());
+    OUTCOME_TRY(sectors, state.sectors.getMany(good_sectors));
+    for (size_t j{0}; j < goods.size(); ++j) {
+      result.first[goods[j]] = std::move(sectors[j]);
     }
-    VM_ASSERT(good);
     for (auto i : faults) {
-      result.first[i] = result.first[*good];
+      result.first[i] = result.first[goods[0]];
     }
     return std::move(result);
   }
@@ -583,7 +579,7 @@ namespace fc::vm::actor::builtin::miner {
       // TODO: lotus stops iterations
       if (static_cast<ChainEpoch>(expiry) <= epoch) {
         expired.push_back(expiry);
-        result.insert(sectors.begin(), sectors.end());
+        result.insert(sectors);
       }
       return outcome::success();
     }));
@@ -599,7 +595,7 @@ namespace fc::vm::actor::builtin::miner {
     OUTCOME_TRY(state.fault_epochs.visit([&](auto start, auto &sectors) {
       if (static_cast<ChainEpoch>(start) <= latest) {
         expired_epochs.push_back(start);
-        expired_sectors.insert(sectors.begin(), sectors.end());
+        expired_sectors.insert(sectors);
       }
       return outcome::success();
     }));
@@ -612,26 +608,21 @@ namespace fc::vm::actor::builtin::miner {
   void assignNewSectors(Deadlines &deadlines,
                         size_t part_size,
                         const RleBitset &available) {
-    auto begin{available.begin()};
+    size_t offset{0};
+    auto total{available.size()};
+    RleBitset::Slicer slicer{available};
     auto add = [&](size_t i, size_t n) {
-      auto end{begin};
-      while (n != 0 && begin != available.end()) {
-        --n;
-        ++end;
-      }
-      deadlines.due[i].insert(begin, end);
-      begin = end;
+      deadlines.due[i].insert(slicer.take(n));
+      offset += n;
     };
-    for (size_t i{0}; i < deadlines.due.size() && begin != available.end();
-         ++i) {
+    for (size_t i{0}; i < deadlines.due.size() && offset < total; ++i) {
       auto [parts, sectors]{deadlines.count(part_size, i)};
       auto mod{sectors % part_size};
       if (mod != 0) {
         add(i, part_size - mod);
       }
     }
-    for (size_t i{0}; begin != available.end();
-         i = (i + 1) % deadlines.due.size()) {
+    for (size_t i{0}; offset < total; i = (i + 1) % deadlines.due.size()) {
       add(i, part_size);
     }
   }
@@ -644,14 +635,13 @@ namespace fc::vm::actor::builtin::miner {
       return outcome::success();
     }
     std::vector<DealId> deals;
-    std::vector<SectorOnChainInfo> all_sectors, faults;
-    for (auto sector_num : sectors) {
-      OUTCOME_TRY(sector, state.sectors.get(sector_num));
+    std::vector<SectorOnChainInfo> faults;
+    OUTCOME_TRY(all_sectors, state.getSectors(sectors));
+    for (auto &sector : all_sectors) {
       deals.insert(deals.end(),
                    sector.info.deal_ids.begin(),
                    sector.info.deal_ids.end());
-      all_sectors.push_back(sector);
-      if (state.fault_set.find(sector_num) != state.fault_set.end()) {
+      if (state.fault_set.find(sector.info.sector) != state.fault_set.end()) {
         faults.push_back(sector);
       }
     }
@@ -1048,10 +1038,11 @@ namespace fc::vm::actor::builtin::miner {
       }
     }
     OUTCOME_TRY(state.addFaults(new_faults, state.proving_period_start));
-    for (auto sector_num : new_faults) {
-      OUTCOME_TRY(sector, state.sectors.get(sector_num));
-      faults_penalty.first.push_back(std::move(sector));
-    }
+    OUTCOME_TRY(new_fault_sectors, state.getSectors(new_faults));
+    faults_penalty.first.insert(
+        faults_penalty.first.end(),
+        std::make_move_iterator(new_fault_sectors.begin()),
+        std::make_move_iterator(new_fault_sectors.end()));
     // TODO(turuslan): zero penalty now, FIL-233
     OUTCOME_TRY(runtime.commitState(state));
     OUTCOME_TRY(requestBeginFaults(
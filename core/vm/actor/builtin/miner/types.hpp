@@ -170,14 +170,11 @@ namespace fc::vm::actor::builtin::miner {
 
     DeadlineInfo deadlineInfo(ChainEpoch now) const;
     outcome::result<void> addFaults(const RleBitset &sectors, ChainEpoch epoch);
+    /// Get sectors in order of numbers, loading shared amt paths once
     template <typename C>
     outcome::result<std::vector<SectorOnChainInfo>> getSectors(const C &c) {
-      std::vector<SectorOnChainInfo> result;
-      for (auto i : c) {
-        OUTCOME_TRY(sector, sectors.get(i));
-        result.push_back(std::move(sector));
-      }
-      return std::move(result);
+      std::vector<uint64_t> numbers{c.begin(), c.end()};
+      return sectors.getMany(numbers);
     }
     auto getDeadlines(IpldPtr ipld) {
       return ipld->getCbor<Deadlines>(deadlines);
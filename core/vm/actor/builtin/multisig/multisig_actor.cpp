@@ -42,7 +42,7 @@ namespace fc::vm::actor::builtin::multisig {
   }
 
   fc::outcome::result<bool> MultiSignatureActorState::isTransactionCreator(
-      const TransactionNumber &tx_number, const Address &address) const {
+      const TransactionNumber &tx_number, const Address &address) {
     OUTCOME_TRY(pending_tx, getPendingTransaction(tx_number));
     if (pending_tx.approved.empty()) return false;
     // Check tx creator is current caller. The first signer is tx creator.
@@ -51,46 +51,30 @@ namespace fc::vm::actor::builtin::multisig {
 
   fc::outcome::result<MultiSignatureTransaction>
   MultiSignatureActorState::getPendingTransaction(
-      const TransactionNumber &tx_number) const {
-    auto pending_tx =
-        std::find_if(pending_transactions.begin(),
-                     pending_transactions.end(),
-                     [&tx_number](const MultiSignatureTransaction &tx) {
-                       return tx.transaction_number == tx_number;
-                     });
-    if (pending_tx == pending_transactions.end())
-      return VMExitCode::MULTISIG_ACTOR_NOT_FOUND;
+      const TransactionNumber &tx_number) {
+    OUTCOME_TRY(pending_tx, pending_transactions.tryGet(tx_number));
+    if (!pending_tx) return VMExitCode::MULTISIG_ACTOR_NOT_FOUND;
 
-    return *pending_tx;
+    return std::move(*pending_tx);
   }
 
   fc::outcome::result<void> MultiSignatureActorState::updatePendingTransaction(
       const MultiSignatureTransaction &transaction) {
-    auto pending_tx = std::find_if(
-        pending_transactions.begin(),
-        pending_transactions.end(),
-        [&transaction](const MultiSignatureTransaction &tx) {
-          return tx.transaction_number == transaction.transaction_number;
-        });
-    if (pending_tx == pending_transactions.end())
-      return VMExitCode::MULTISIG_ACTOR_NOT_FOUND;
+    auto key = PendingTransactions::hamtKey(transaction.transaction_number);
+    OUTCOME_TRY(found, pending_transactions.has(key));
+    if (!found) return VMExitCode::MULTISIG_ACTOR_NOT_FOUND;
 
-    *pending_tx = transaction;
+    OUTCOME_TRY(pending_transactions.set(key, transaction));
     return fc::outcome::success();
   }
 
   fc::outcome::result<void> MultiSignatureActorState::deletePendingTransaction(
       const TransactionNumber &tx_number) {
-    auto pending_tx =
-        std::find_if(pending_transactions.begin(),
-                     pending_transactions.end(),
-                     [&tx_number](const MultiSignatureTransaction &tx) {
-                       return tx.transaction_number == tx_number;
-                     });
-    if (pending_tx == pending_transactions.end())
-      return VMExitCode::MULTISIG_ACTOR_NOT_FOUND;
+    auto key = PendingTransactions::hamtKey(tx_number);
+    OUTCOME_TRY(found, pending_transactions.has(key));
+    if (!found) return VMExitCode::MULTISIG_ACTOR_NOT_FOUND;
 
-    pending_transactions.erase(pending_tx);
+    OUTCOME_TRY(pending_transactions.remove(key));
     return fc::outcome::success();
   }
 
@@ -99,7 +83,11 @@ namespace fc::vm::actor::builtin::multisig {
     Address caller = runtime.getImmediateCaller();
     if (!isSigner(caller)) return VMExitCode::MULTISIG_ACTOR_FORBIDDEN;
 
-    OUTCOME_TRY(pending_tx, getPendingTransaction(tx_number));
+    // hash key once for lookup and following update or removal
+    auto key = PendingTransactions::hamtKey(tx_number);
+    OUTCOME_TRY(found, pending_transactions.tryGet(key));
+    if (!found) return VMExitCode::MULTISIG_ACTOR_NOT_FOUND;
+    auto &pending_tx = *found;
 
     if (std::find(
             pending_tx.approved.begin(), pending_tx.approved.end(), caller)
@@ -125,9 +113,9 @@ namespace fc::vm::actor::builtin::multisig {
                    pending_tx.params,
                    pending_tx.value);
 
-      OUTCOME_TRY(deletePendingTransaction(tx_number));
+      OUTCOME_TRY(pending_transactions.remove(key));
     } else {
-      OUTCOME_TRY(updatePendingTransaction(pending_tx));
+      OUTCOME_TRY(pending_transactions.set(key, pending_tx));
     }
 
     return fc::outcome::success();
@@ -155,6 +143,7 @@ namespace fc::vm::actor::builtin::multisig {
                                    runtime.getCurrentEpoch(),
                                    params.unlock_duration,
                                    {}};
+    IpldPtr{runtime}->load(state);
 
     if (params.unlock_duration != 0) {
       state.initial_balance = runtime.getValueReceived();
@@ -175,7 +164,7 @@ namespace fc::vm::actor::builtin::multisig {
 
     MultiSignatureTransaction transaction{
         tx_number, params.to, params.value, params.method, params.params, {}};
-    state.pending_transactions.push_back(transaction);
+    OUTCOME_TRY(state.pending_transactions.set(tx_number, transaction));
 
     // approve pending tx
     OUTCOME_TRY(state.approveTransaction(runtime, tx_number));
@@ -6,6 +6,8 @@
 #ifndef CPP_FILECOIN_VM_ACTOR_BUILTIN_MULTISIG_ACTOR_HPP
 #define CPP_FILECOIN_VM_ACTOR_BUILTIN_MULTISIG_ACTOR_HPP
 
+#include "adt/map.hpp"
+#include "adt/uvarint_key.hpp"
 #include "codec/cbor/streams_annotation.hpp"
 #include "primitives/address/address.hpp"
 #include "primitives/address/address_codec.hpp"
@@ -53,6 +55,10 @@ namespace fc::vm::actor::builtin::multisig {
              params,
              approved)
 
+  /// Pending transactions by transaction number
+  using PendingTransactions =
+      adt::Map<MultiSignatureTransaction, adt::UvarintKeyer>;
+
   /**
    * State of Multisig Actor instance
    */
@@ -67,8 +73,11 @@ namespace fc::vm::actor::builtin::multisig {
     ChainEpoch start_epoch;
     EpochDuration unlock_duration;
 
-    /** List of pending transactions */
-    std::vector<MultiSignatureTransaction> pending_transactions;
+    /**
+     * Pending transactions, approval loads and rewrites only path of its
+     * transaction
+     */
+    PendingTransactions pending_transactions;
 
     /**
      * Checks if address is signer
@@ -82,13 +91,13 @@ namespace fc::vm::actor::builtin::multisig {
      * @return true if address proposed the transaction
      */
     outcome::result<bool> isTransactionCreator(
-        const TransactionNumber &tx_number, const Address &address) const;
+        const TransactionNumber &tx_number, const Address &address);
 
     /**
      * Get pending transaction
      */
     outcome::result<MultiSignatureTransaction> getPendingTransaction(
-        const TransactionNumber &tx_number) const;
+        const TransactionNumber &tx_number);
 
     /**
      * Update pending transaction by transaction_number
@@ -211,4 +220,17 @@ namespace fc::vm::actor::builtin::multisig {
 
 }  // namespace fc::vm::actor::builtin::multisig
 
+namespace fc {
+  template <>
+  struct Ipld::Visit<
+      vm::actor::builtin::multisig::MultiSignatureActorState> {
+    template <typename Visitor>
+    static void call(
+        vm::actor::builtin::multisig::MultiSignatureActorState &state,
+        const Visitor &visit) {
+      visit(state.pending_transactions);
+    }
+  };
+}  // namespace fc
+
 #endif  // CPP_FILECOIN_VM_ACTOR_BUILTIN_MULTISIG_ACTOR_HPP
@@ -18,6 +18,12 @@ namespace fc::vm::actor::builtin {
 
   using runtime::Runtime;
 
+  /**
+   * Longest cron catch-up which probes epoch keyed schedule epoch by epoch,
+   * longer ranges visit scheduled epochs instead
+   */
+  constexpr primitives::ChainEpoch kCronProbeEpochs{16};
+
   /**
    * Get worker address
    * @param runtime
@@ -5,6 +5,8 @@
 
 #include "vm/actor/builtin/storage_power/storage_power_actor_export.hpp"
 
+#include <map>
+
 #include "vm/actor/builtin/init/init_actor.hpp"
 #include "vm/actor/builtin/miner/miner_actor.hpp"
 #include "vm/actor/builtin/reward/reward_actor.hpp"
@@ -25,31 +27,60 @@ namespace fc::vm::actor::builtin::storage_power {
                                   epoch_reward);
   }
 
+  /**
+   * Cron events scheduled for epochs in (from, to], ordered by epoch.
+   * Catch-up after null rounds visits populated epochs once instead of
+   * probing each epoch of range.
+   */
+  outcome::result<std::map<ChainEpoch, adt::Array<CronEvent>>> dueCronEvents(
+      State &state, ChainEpoch from, ChainEpoch to) {
+    std::map<ChainEpoch, adt::Array<CronEvent>> due;
+    if (to - from <= kCronProbeEpochs) {
+      for (auto epoch{from + 1}; epoch <= to; ++epoch) {
+        OUTCOME_TRY(events, state.cron_event_queue.tryGet(epoch));
+        if (events) {
+          due.emplace(epoch, std::move(*events));
+        }
+      }
+    } else {
+      OUTCOME_TRY(state.cron_event_queue.visit(
+          [&](auto key, auto &events) -> outcome::result<void> {
+            auto epoch{static_cast<ChainEpoch>(key)};
+            if (epoch > from && epoch <= to) {
+              due.emplace(epoch, events);
+            }
+            return outcome::success();
+          }));
+    }
+    return std::move(due);
+  }
+
   outcome::result<void> processDeferredCronEvents(Runtime &runtime,
                                                   State &state) {
     auto now{runtime.getCurrentEpoch()};
-    for (auto epoch = state.last_epoch_tick + 1; epoch <= now; ++epoch) {
-      OUTCOME_TRY(events, state.cron_event_queue.tryGet(epoch));
-      if (events) {
-        OUTCOME_TRY(events->visit([&](auto, auto &event) {
-          auto res{runtime.send(event.miner_address,
-                                miner::OnDeferredCronEvent::Number,
-                                MethodParams{event.callback_payload},
-                                0)};
-          if (!res) {
-            spdlog::warn(
-                "PowerActor.processDeferredCronEvents: error {} \"{}\", epoch "
-                "{}, miner {}, payload {}",
-                res.error(),
-                res.error().message(),
-                now,
-                event.miner_address,
-                common::hex_lower(event.callback_payload));
-          }
-          return outcome::success();
-        }));
-        OUTCOME_TRY(state.cron_event_queue.remove(epoch));
-      }
+    OUTCOME_TRY(due, dueCronEvents(state, state.last_epoch_tick, now));
+    for (auto &due_events : due) {
+      OUTCOME_TRY(due_events.second.visit([&](auto, auto &event) {
+        auto res{runtime.send(event.miner_address,
+                              miner::OnDeferredCronEvent::Number,
+                              MethodParams{event.callback_payload},
+                              0)};
+        if (!res) {
+          spdlog::warn(
+              "PowerActor.processDeferredCronEvents: error {} \"{}\", epoch "
+              "{}, miner {}, payload {}",
+              res.error(),
+              res.error().message(),
+              now,
+              event.miner_address,
+              common::hex_lower(event.callback_payload));
+        }
+        return outcome::success();
+      }));
+    }
+    // processed epochs are removed after all events were sent
+    for (auto &due_events : due) {
+      OUTCOME_TRY(state.cron_event_queue.remove(due_events.first));
     }
     state.last_epoch_tick = now;
     return outcome::success();
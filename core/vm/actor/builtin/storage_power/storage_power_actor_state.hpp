@@ -10,6 +10,7 @@
 #include "adt/multimap.hpp"
 #include "adt/uvarint_key.hpp"
 #include "primitives/types.hpp"
+#include "storage/ipld/lazy_tuple.hpp"
 
 namespace fc::vm::actor::builtin::storage_power {
   using common::Buffer;
@@ -65,6 +66,14 @@ namespace fc::vm::actor::builtin::storage_power {
              claims,
              num_miners_meeting_min_power)
 
+  /// Fields of State decoded by LazyTuple
+  namespace lazy {
+    using storage::ipld::LazyField;
+    constexpr LazyField<StoragePower> kTotalRawPower{0};
+    constexpr LazyField<StoragePower> kTotalQaPower{1};
+    constexpr LazyField<adt::Map<Claim, adt::AddressKeyer>> kClaims{6};
+  }  // namespace lazy
+
 }  // namespace fc::vm::actor::builtin::storage_power
 
 namespace fc {
@@ -19,16 +19,41 @@ namespace fc::vm::actor {
 
   using runtime::InvocationOutput;
 
-  InvokerImpl::InvokerImpl() {
-    builtin_[kInitCodeCid] = builtin::init::exports;
-    builtin_[kRewardActorCodeID] = builtin::reward::exports;
-    builtin_[kCronCodeCid] = builtin::cron::exports;
-    builtin_[kStoragePowerCodeCid] = builtin::storage_power::exports;
-    builtin_[kStorageMarketCodeCid] = builtin::market::exports;
-    builtin_[kStorageMinerCodeCid] = builtin::miner::exports;
-    builtin_[kMultisigCodeCid] = builtin::multisig::exports;
-    builtin_[kPaymentChannelCodeCid] = builtin::payment_channel::exports;
-    builtin_[kAccountCodeCid] = builtin::account::exports;
+  namespace {
+    const std::unordered_map<CID, MethodTable> &builtinActors() {
+      static const std::unordered_map<CID, MethodTable> builtin{
+          {kInitCodeCid, InvokerImpl::makeMethodTable(builtin::init::exports)},
+          {kRewardActorCodeID,
+           InvokerImpl::makeMethodTable(builtin::reward::exports)},
+          {kCronCodeCid, InvokerImpl::makeMethodTable(builtin::cron::exports)},
+          {kStoragePowerCodeCid,
+           InvokerImpl::makeMethodTable(builtin::storage_power::exports)},
+          {kStorageMarketCodeCid,
+           InvokerImpl::makeMethodTable(builtin::market::exports)},
+          {kStorageMinerCodeCid,
+           InvokerImpl::makeMethodTable(builtin::miner::exports)},
+          {kMultisigCodeCid,
+           InvokerImpl::makeMethodTable(builtin::multisig::exports)},
+          {kPaymentChannelCodeCid,
+           InvokerImpl::makeMethodTable(builtin::payment_channel::exports)},
+          {kAccountCodeCid,
+           InvokerImpl::makeMethodTable(builtin::account::exports)},
+      };
+      return builtin;
+    }
+  }  // namespace
+
+  InvokerImpl::InvokerImpl() : builtin_{builtinActors()} {}
+
+  MethodTable InvokerImpl::makeMethodTable(const ActorExports &exports) {
+    MethodTable table;
+    if (!exports.empty()) {
+      table.resize(exports.rbegin()->first.method_number + 1);
+    }
+    for (auto &method : exports) {
+      table[method.first.method_number] = method.second;
+    }
+    return table;
   }
 
   outcome::result<InvocationOutput> InvokerImpl::invoke(
@@ -36,15 +61,15 @@ namespace fc::vm::actor {
       Runtime &runtime,
       MethodNumber method,
       const MethodParams &params) {
-    auto maybe_builtin_actor = builtin_.find(actor.code);
-    if (maybe_builtin_actor == builtin_.end()) {
+    auto builtin_actor = builtin_.find(actor.code);
+    if (builtin_actor == builtin_.end()) {
       return VMExitCode::SysErrorIllegalActor;
     }
-    auto builtin_actor = maybe_builtin_actor->second;
-    auto maybe_builtin_method = builtin_actor.find(method);
-    if (maybe_builtin_method == builtin_actor.end()) {
+    auto &table = builtin_actor->second;
+    if (method.method_number >= table.size()
+        || !table[method.method_number]) {
       return VMExitCode::SysErrInvalidMethod;
     }
-    return maybe_builtin_method->second(runtime, params);
+    return table[method.method_number](runtime, params);
   }
 }  // namespace fc::vm::actor
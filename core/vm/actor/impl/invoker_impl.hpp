@@ -8,13 +8,21 @@
 
 #include "vm/actor/invoker.hpp"
 
+#include <unordered_map>
+
 #include "vm/actor/actor_method.hpp"
 
 namespace fc::vm::actor {
 
   using runtime::InvocationOutput;
 
-  /// Finds and loads actor code, invokes actor methods
+  /// Builtin actor methods indexed by method number, null if not exported
+  using MethodTable = std::vector<ActorMethod>;
+
+  /**
+   * Finds and loads actor code, invokes actor methods. Builtin dispatch tables
+   * are built once per process and shared by all invokers.
+   */
   class InvokerImpl : public Invoker {
    public:
     InvokerImpl();
@@ -25,8 +33,11 @@ namespace fc::vm::actor {
         MethodNumber method,
         const MethodParams &params) override;
 
+    /// @return table from method exports, dense by method number
+    static MethodTable makeMethodTable(const ActorExports &exports);
+
    private:
-    std::map<CID, ActorExports> builtin_;
+    const std::unordered_map<CID, MethodTable> &builtin_;
   };
 }  // namespace fc::vm::actor
 
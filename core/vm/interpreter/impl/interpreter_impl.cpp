@@ -5,13 +5,27 @@
 
 #include "vm/interpreter/impl/interpreter_impl.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <boost/asio/post.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/optional.hpp>
+
+#include "common/memory_domain.hpp"
+#include "common/metrics.hpp"
+#include "common/tracing.hpp"
+#include "crypto/blake2/blake2b160.hpp"
 #include "crypto/randomness/randomness_provider.hpp"
+#include "storage/ipfs/impl/overlay_datastore.hpp"
 #include "vm/actor/builtin/cron/cron_actor.hpp"
 #include "vm/actor/builtin/reward/reward_actor.hpp"
 #include "vm/actor/impl/invoker_impl.hpp"
 #include "vm/runtime/gas_cost.hpp"
 #include "vm/runtime/impl/runtime_impl.hpp"
 #include "vm/state/impl/state_tree_impl.hpp"
+#include "vm/state/impl/state_tree_overlay.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::vm::interpreter, InterpreterError, e) {
   using E = fc::vm::interpreter::InterpreterError;
@@ -22,6 +36,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(fc::vm::interpreter, InterpreterError, e) {
       return "Miner submit failed";
     case E::CRON_TICK_FAILED:
       return "Cron tick failed";
+    case E::MESSAGE_NOT_FOUND:
+      return "Message not found in tipset";
   }
 }
 
@@ -36,16 +52,98 @@ namespace fc::vm::interpreter {
   using actor::builtin::reward::AwardBlockReward;
   using crypto::randomness::RandomnessProvider;
   using message::SignedMessage;
-  using message::UnsignedMessage;
+  using primitives::address::Address;
   using primitives::TokenAmount;
   using primitives::block::MsgMeta;
   using primitives::tipset::MessageVisitor;
   using runtime::Env;
   using runtime::kInfiniteGas;
   using runtime::MessageReceipt;
+  using runtime::ProofVerifier;
+  using state::StateTree;
+  using state::StateTreeOverlay;
+  using storage::ipfs::OverlayDatastore;
+
+  namespace {
+    /**
+     * Runs worker on calling thread and on threads - 1 pool threads, waits
+     * for all of them. Workers share one queue of items, so calling thread
+     * completes it alone while pool is busy
+     */
+    void runWorkers(boost::asio::thread_pool &pool,
+                    size_t threads,
+                    const std::function<void()> &worker) {
+      std::vector<std::future<void>> done;
+      for (size_t t = 1; t < threads; ++t) {
+        std::packaged_task<void()> task{worker};
+        done.push_back(task.get_future());
+        boost::asio::post(pool, std::move(task));
+      }
+      worker();
+      for (auto &future : done) {
+        future.wait();
+      }
+    }
+
+    /// Message executed on overlay of state tree
+    struct Speculation {
+      std::shared_ptr<StateTreeOverlay> overlay;
+      MessageReceipt receipt;
+      TokenAmount penalty;
+      TokenAmount gas_reward;
+    };
+
+    outcome::result<Speculation> speculate(const Env &env,
+                                           std::shared_ptr<StateTree> base,
+                                           const UnsignedMessage &message,
+                                           size_t size) {
+      Speculation speculation;
+      speculation.overlay = std::make_shared<StateTreeOverlay>(std::move(base));
+      auto overlay_env = std::make_shared<Env>(env.randomness_provider,
+                                               speculation.overlay,
+                                               env.invoker,
+                                               env.chain_epoch);
+      overlay_env->proof_verifier = env.proof_verifier;
+      overlay_env->profiler = env.profiler;
+      overlay_env->gas_reward = 0;
+      OUTCOME_TRYA(speculation.receipt,
+                   overlay_env->applyMessage(
+                       message, size, speculation.penalty));
+      speculation.gas_reward = std::move(*overlay_env->gas_reward);
+      return std::move(speculation);
+    }
+
+    /// Size of unsigned message encoded in signed message bytes
+    outcome::result<size_t> unsignedSize(
+        gsl::span<const uint8_t> signed_bytes) {
+      try {
+        auto s = codec::cbor::CborDecodeStream::borrow(signed_bytes);
+        return s.list().rawView().size();
+      } catch (std::system_error &e) {
+        return outcome::failure(e.code());
+      }
+    }
+
+    bool intersects(const std::set<Address> &reads,
+                    const std::set<Address> &changed) {
+      for (auto &address : reads) {
+        if (changed.count(address) != 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+  }  // namespace
 
   outcome::result<Result> InterpreterImpl::interpret(
       const IpldPtr &ipld, const Tipset &tipset) const {
+    static auto &tipset_time{common::metrics::registry().histogram(
+        "fc_interpreter_tipset_seconds", "Time of tipset interpretation")};
+    static auto &domain{common::memoryDomain("vm")};
+    common::MemoryDomainScope scope{domain};
+    common::metrics::Timer timer{tipset_time};
+    common::tracing::Span span{"interpreter.interpret",
+                               std::to_string(tipset.height)};
     if (tipset.height == 0) {
       return Result{
           tipset.getParentStateRoot(),
@@ -57,32 +155,94 @@ namespace fc::vm::interpreter {
       return InterpreterError::DUPLICATE_MINER;
     }
 
+    // Seals and window PoSts are assumed valid during first application and
+    // verified in parallel afterwards. If some proof is invalid, tipset is
+    // applied again with verified results, so result is same as with
+    // sequential verification.
+    auto proof_verifier = std::make_shared<ProofVerifier>();
+    // nodes flushed during execution are buffered, only ones reachable from
+    // result are stored
+    auto overlay = std::make_shared<OverlayDatastore>(ipld);
+    auto result = applyTipset(overlay, tipset, proof_verifier);
+    if (!proof_verifier->verifyRecorded()) {
+      overlay->discard();
+      result = applyTipset(overlay, tipset, proof_verifier);
+    }
+    OUTCOME_TRY(result);
+    OUTCOME_TRY(overlay->commit(
+        {result.value().state_root, result.value().message_receipts}));
+    return result;
+  }
+
+  outcome::result<ExecutionTrace> InterpreterImpl::replay(
+      const IpldPtr &ipld, const Tipset &tipset, const CID &message) const {
+    boost::optional<ExecutionTrace> found;
+    auto hook = [&](const CID &cid, ExecutionTrace trace) {
+      if (cid == message) {
+        found = std::move(trace);
+        return true;
+      }
+      return false;
+    };
+    // proofs are verified directly, tipset is not applied completely, and
+    // its blocks are never stored
+    auto overlay = std::make_shared<OverlayDatastore>(ipld);
+    OUTCOME_TRY(applyTipset(overlay, tipset, nullptr, hook));
+    if (!found) {
+      return InterpreterError::MESSAGE_NOT_FOUND;
+    }
+    return std::move(*found);
+  }
+
+  outcome::result<Result> InterpreterImpl::applyTipset(
+      const IpldPtr &ipld,
+      const Tipset &tipset,
+      std::shared_ptr<ProofVerifier> proof_verifier,
+      const TraceHook &hook) const {
     auto state_tree = std::make_shared<state::StateTreeImpl>(
         ipld, tipset.getParentStateRoot());
     // TODO(turuslan): FIL-146 randomness from tipset
     std::shared_ptr<RandomnessProvider> randomness;
     auto env = std::make_shared<Env>(
         randomness, state_tree, std::make_shared<InvokerImpl>(), tipset.height);
+    env->proof_verifier = std::move(proof_verifier);
+    env->profiler = profiler_;
+    env->tracing = static_cast<bool>(hook);
 
-    adt::Array<MessageReceipt> receipts{ipld};
-    MessageVisitor message_visitor{ipld};
-    for (auto &block : tipset.blks) {
+    // cids are needed by trace hook and message cache
+    auto with_cids{hook || message_cache_};
+    std::vector<std::vector<CID>> cids;
+    std::vector<std::vector<size_t>> sizes;
+    OUTCOME_TRY(block_messages,
+                loadMessages(ipld, tipset, sizes, with_cids ? &cids : nullptr));
+    prewarmSenders(*state_tree, block_messages);
+
+    std::vector<MessageReceipt> receipts;
+    for (size_t i = 0; i < tipset.blks.size(); ++i) {
+      auto &block = tipset.blks[i];
       AwardBlockReward::Params reward{block.miner, 0, 0, 1};
-      OUTCOME_TRY(message_visitor.visit(
-          block, [&](auto, auto bls, auto &cid) -> outcome::result<void> {
-            UnsignedMessage message;
-            if (bls) {
-              OUTCOME_TRYA(message, ipld->getCbor<UnsignedMessage>(cid));
-            } else {
-              OUTCOME_TRY(signed_message, ipld->getCbor<SignedMessage>(cid));
-              message = std::move(signed_message.message);
-            }
-            TokenAmount penalty;
-            OUTCOME_TRY(receipt, env->applyMessage(message, penalty));
-            reward.penalty += penalty;
-            OUTCOME_TRY(receipts.append(std::move(receipt)));
-            return outcome::success();
-          }));
+      if (!hook && execution_threads_ > 1
+          && block_messages[i].size() >= kMinParallelExecution) {
+        OUTCOME_TRY(applied,
+                    applyParallel(env, block_messages[i], sizes[i]));
+        for (auto &message : applied) {
+          reward.penalty += message.penalty;
+          receipts.push_back(std::move(message.receipt));
+        }
+      } else {
+        for (size_t j = 0; j < block_messages[i].size(); ++j) {
+          auto &message = block_messages[i][j];
+          TokenAmount penalty;
+          env->traces.clear();
+          OUTCOME_TRY(receipt,
+                      env->applyMessage(message, sizes[i][j], penalty));
+          if (hook && hook(cids[i][j], env->takeTrace(message, receipt))) {
+            return Result{};
+          }
+          reward.penalty += penalty;
+          receipts.push_back(std::move(receipt));
+        }
+      }
 
       OUTCOME_TRY(reward_encoded, codec::cbor::encode(reward));
       OUTCOME_TRY(env->applyImplicitMessage(UnsignedMessage{
@@ -112,17 +272,206 @@ namespace fc::vm::interpreter {
 
     OUTCOME_TRY(new_state_root, state_tree->flush());
 
-    OUTCOME_TRY(Ipld::flush(receipts));
+    adt::Array<MessageReceipt> receipts_array{ipld};
+    OUTCOME_TRY(receipts_array.assign(receipts));
+    OUTCOME_TRY(Ipld::flush(receipts_array));
+
+    // result of first application may be replaced if some proof is invalid
+    if (message_cache_ && !hook) {
+      auto messages{std::make_shared<TipsetMessages>()};
+      for (size_t i = 0; i < block_messages.size(); ++i) {
+        messages->cids.insert(
+            messages->cids.end(), cids[i].begin(), cids[i].end());
+        messages->messages.insert(messages->messages.end(),
+                                  block_messages[i].begin(),
+                                  block_messages[i].end());
+      }
+      messages->receipts = std::move(receipts);
+      messages->receipts_root = receipts_array.amt.cid();
+      message_cache_->insert(TipsetKey{tipset.cids}, std::move(messages));
+    }
 
     return Result{
         new_state_root,
-        receipts.amt.cid(),
+        receipts_array.amt.cid(),
     };
   }
 
+  InterpreterImpl::InterpreterImpl(
+      size_t prefetch_threads,
+      std::shared_ptr<runtime::Profiler> profiler,
+      size_t execution_threads,
+      std::shared_ptr<MessageCache> message_cache,
+      std::shared_ptr<boost::asio::thread_pool> pool)
+      : prefetch_threads_{prefetch_threads},
+        profiler_{std::move(profiler)},
+        execution_threads_{execution_threads},
+        message_cache_{std::move(message_cache)},
+        pool_{pool ? std::move(pool) : defaultPool()} {}
+
+  std::shared_ptr<boost::asio::thread_pool> InterpreterImpl::defaultPool() {
+    static auto pool{std::make_shared<boost::asio::thread_pool>(
+        std::max({1u,
+                  std::thread::hardware_concurrency(),
+                  static_cast<unsigned>(kDefaultPrefetchThreads)}))};
+    return pool;
+  }
+
+  outcome::result<std::vector<InterpreterImpl::Applied>>
+  InterpreterImpl::applyParallel(
+      const std::shared_ptr<Env> &env,
+      const std::vector<UnsignedMessage> &messages,
+      const std::vector<size_t> &sizes) const {
+    auto &state_tree = env->state_tree;
+    OUTCOME_TRY(root, state_tree->flush());
+    auto ipld = state_tree->getStore();
+
+    std::vector<boost::optional<Speculation>> speculations(messages.size());
+    std::atomic_size_t next{0};
+    auto threads_count = std::min(execution_threads_, messages.size());
+    auto parent = common::tracing::Span::current();
+    runWorkers(*pool_, threads_count, [&] {
+      common::tracing::Span span{"interpreter.speculate", {}, parent};
+      // loaded hamt nodes are not shared between threads
+      auto base = std::make_shared<state::StateTreeImpl>(ipld, root);
+      for (auto j = next++; j < messages.size(); j = next++) {
+        // failed speculation is repeated on current state
+        auto speculation = speculate(*env, base, messages[j], sizes[j]);
+        if (speculation) {
+          speculations[j] = std::move(speculation.value());
+        }
+      }
+    });
+
+    std::set<Address> changed;
+    std::vector<Applied> applied;
+    applied.reserve(messages.size());
+    for (size_t j = 0; j < messages.size(); ++j) {
+      auto &speculation = speculations[j];
+      if (!speculation || intersects(speculation->overlay->reads(), changed)) {
+        OUTCOME_TRYA(speculation,
+                     speculate(*env, state_tree, messages[j], sizes[j]));
+      }
+      OUTCOME_TRY(speculation->overlay->apply(*state_tree));
+      for (auto &write : speculation->overlay->writes()) {
+        changed.insert(write.first);
+      }
+      if (speculation->gas_reward != 0) {
+        OUTCOME_TRY(reward, state_tree->get(kRewardAddress));
+        reward.balance += speculation->gas_reward;
+        OUTCOME_TRY(state_tree->set(kRewardAddress, reward));
+        changed.insert(kRewardAddress);
+      }
+      applied.push_back({std::move(speculation->receipt),
+                         std::move(speculation->penalty)});
+    }
+    return std::move(applied);
+  }
+
+  outcome::result<std::vector<std::vector<UnsignedMessage>>>
+  InterpreterImpl::loadMessages(const IpldPtr &ipld,
+                                const Tipset &tipset,
+                                std::vector<std::vector<size_t>> &sizes,
+                                std::vector<std::vector<CID>> *cids) const {
+    common::tracing::Span span{"interpreter.load_messages"};
+    struct Task {
+      size_t block;
+      bool bls;
+      CID cid;
+    };
+    std::vector<Task> tasks;
+    std::vector<std::vector<UnsignedMessage>> messages(tipset.blks.size());
+    sizes.assign(tipset.blks.size(), {});
+    if (cids) {
+      cids->assign(tipset.blks.size(), {});
+    }
+    MessageVisitor message_visitor{ipld};
+    for (size_t i = 0; i < tipset.blks.size(); ++i) {
+      OUTCOME_TRY(message_visitor.visit(
+          tipset.blks[i],
+          [&](auto, auto bls, auto &cid) -> outcome::result<void> {
+            tasks.push_back({i, bls, cid});
+            messages[i].emplace_back();
+            sizes[i].emplace_back();
+            if (cids) {
+              (*cids)[i].push_back(cid);
+            }
+            return outcome::success();
+          }));
+    }
+
+    // decoded message slots, in the same order as tasks
+    std::vector<UnsignedMessage *> slots;
+    std::vector<size_t *> size_slots;
+    slots.reserve(tasks.size());
+    size_slots.reserve(tasks.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+      for (size_t j = 0; j < messages[i].size(); ++j) {
+        slots.push_back(&messages[i][j]);
+        size_slots.push_back(&sizes[i][j]);
+      }
+    }
+    std::vector<std::error_code> errors(tasks.size());
+    // encoded size for gas is taken from loaded bytes
+    auto decode = [&](size_t j) -> outcome::result<void> {
+      auto &task = tasks[j];
+      OUTCOME_TRY(bytes, ipld->get(task.cid));
+      if (task.bls) {
+        OUTCOME_TRYA(*slots[j], codec::cbor::decode<UnsignedMessage>(bytes));
+        *size_slots[j] = bytes.size();
+      } else {
+        OUTCOME_TRY(signed_message, codec::cbor::decode<SignedMessage>(bytes));
+        *slots[j] = std::move(signed_message.message);
+        OUTCOME_TRYA(*size_slots[j], unsignedSize(bytes));
+      }
+      return outcome::success();
+    };
+    auto decode_slot = [&](size_t j) {
+      auto result = decode(j);
+      if (!result) {
+        errors[j] = result.error();
+      }
+    };
+
+    auto threads_count = std::min(prefetch_threads_, tasks.size());
+    if (threads_count <= 1 || tasks.size() < kMinParallelPrefetch) {
+      for (size_t j = 0; j < tasks.size(); ++j) {
+        decode_slot(j);
+      }
+    } else {
+      std::atomic_size_t next{0};
+      runWorkers(*pool_, threads_count, [&] {
+        for (auto j = next++; j < tasks.size(); j = next++) {
+          decode_slot(j);
+        }
+      });
+    }
+
+    for (auto &error : errors) {
+      if (error) {
+        return error;
+      }
+    }
+    return std::move(messages);
+  }
+
+  void InterpreterImpl::prewarmSenders(
+      state::StateTree &state_tree,
+      const std::vector<std::vector<UnsignedMessage>> &messages) {
+    std::set<Address> senders;
+    for (auto &block : messages) {
+      for (auto &message : block) {
+        if (senders.insert(message.from).second) {
+          // errors are reported later by message execution
+          std::ignore = state_tree.get(message.from);
+        }
+      }
+    }
+  }
+
   bool InterpreterImpl::hasDuplicateMiners(
       const std::vector<BlockHeader> &blocks) const {
-    std::set<primitives::address::Address> set;
+    std::set<Address> set;
     for (auto &block : blocks) {
       if (!set.insert(block.miner).second) {
         return true;
@@ -131,22 +480,187 @@ namespace fc::vm::interpreter {
     return false;
   }
 
-  outcome::result<Result> CachedInterpreter::interpret(
-      const IpldPtr &ipld, const Tipset &tipset) const {
-    // TODO: TipsetKey from arg-gor
-    common::Buffer key;
+  outcome::result<ExecutionTrace> CachedInterpreter::replay(
+      const IpldPtr &ipld, const Tipset &tipset, const CID &message) const {
+    return interpreter_->replay(ipld, tipset, message);
+  }
+
+  CachedInterpreter::CachedInterpreter(
+      std::shared_ptr<Interpreter> interpreter,
+      std::shared_ptr<PersistentBufferMap> store,
+      Options options)
+      : interpreter_{std::move(interpreter)},
+        store_{std::move(store)},
+        options_{options} {}
+
+  CachedInterpreter::~CachedInterpreter() {
+    worker_.join();
+  }
+
+  outcome::result<Buffer> CachedInterpreter::makeKey(const Tipset &tipset) {
+    Buffer cids;
     for (auto &cid : tipset.cids) {
       OUTCOME_TRY(encoded, cid.toBytes());
-      key.put(encoded);
+      cids.put(encoded);
     }
+    Buffer key(sizeof(uint64_t), 0);
+    boost::endian::store_big_u64(key.data(), tipset.height);
+    key.put(crypto::blake2b::blake2b_256(cids));
+    return std::move(key);
+  }
 
-    if (store->contains(key)) {
-      OUTCOME_TRY(raw, store->get(key));
-      return codec::cbor::decode<Result>(raw);
+  outcome::result<Result> CachedInterpreter::interpret(
+      const IpldPtr &ipld, const Tipset &tipset) const {
+    OUTCOME_TRY(key, makeKey(tipset));
+    std::promise<outcome::result<Result>> promise;
+    {
+      std::unique_lock lock{mutex_};
+      auto cached = memory_.find(key);
+      if (cached != memory_.end()) {
+        lru_.splice(lru_.end(), lru_, cached->second.second);
+        return cached->second.first;
+      }
+      auto pending = pending_.find(key);
+      if (pending != pending_.end()) {
+        auto future = pending->second;
+        lock.unlock();
+        return future.get();
+      }
+      pending_.emplace(key, promise.get_future().share());
     }
-    OUTCOME_TRY(result, interpreter->interpret(ipld, tipset));
-    OUTCOME_TRY(raw, codec::cbor::encode(result));
-    OUTCOME_TRY(store->put(key, raw));
+
+    auto result = loadOrInterpret(ipld, tipset, key);
+    {
+      std::lock_guard lock{mutex_};
+      if (result) {
+        remember(key, result.value());
+      }
+      pending_.erase(key);
+    }
+    promise.set_value(result);
+    return result;
+  }
+
+  outcome::result<Result> CachedInterpreter::interpretBefore(
+      const IpldPtr &ipld,
+      const Tipset &tipset,
+      std::chrono::steady_clock::time_point deadline) const {
+    OUTCOME_TRY(key, makeKey(tipset));
+    Future future;
+    {
+      std::lock_guard lock{mutex_};
+      auto cached = memory_.find(key);
+      if (cached != memory_.end()) {
+        lru_.splice(lru_.end(), lru_, cached->second.second);
+        return cached->second.first;
+      }
+      auto pending = pending_.find(key);
+      if (pending != pending_.end()) {
+        future = pending->second;
+      }
+    }
+    if (!future.valid()) {
+      return interpret(ipld, tipset);
+    }
+    if (future.wait_until(deadline) == std::future_status::ready) {
+      if (auto &result = future.get()) {
+        return result;
+      }
+    }
+    // running interpretation is late or failed, interpret again here
+    auto result = loadOrInterpret(ipld, tipset, key);
+    if (result) {
+      std::lock_guard lock{mutex_};
+      remember(key, result.value());
+    }
+    return result;
+  }
+
+  outcome::result<Result> CachedInterpreter::loadOrInterpret(
+      const IpldPtr &ipld, const Tipset &tipset, const Buffer &key) const {
+    // missing key is the common case, any read error means interpret again
+    auto raw = store_->get(key);
+    if (raw) {
+      auto result = codec::cbor::decode<Result>(raw.value());
+      if (result) {
+        return result;
+      }
+    }
+    OUTCOME_TRY(result, interpreter_->interpret(ipld, tipset));
+    OUTCOME_TRY(encoded, codec::cbor::encode(result));
+    OUTCOME_TRY(store_->put(key, encoded));
     return std::move(result);
   }
+
+  void CachedInterpreter::remember(const Buffer &key,
+                                   const Result &result) const {
+    if (options_.memory_entries == 0 || memory_.count(key) != 0) {
+      return;
+    }
+    auto it = lru_.insert(lru_.end(), key);
+    memory_.emplace(key, std::make_pair(result, it));
+    if (lru_.size() > options_.memory_entries) {
+      memory_.erase(lru_.front());
+      lru_.pop_front();
+    }
+  }
+
+  void CachedInterpreter::precompute(IpldPtr ipld, Tipset tipset) {
+    boost::asio::post(worker_,
+                      [this, ipld{std::move(ipld)}, tipset{std::move(tipset)}] {
+                        std::ignore = interpret(ipld, tipset);
+                        auto height = static_cast<ChainEpoch>(tipset.height);
+                        if (height > options_.finality) {
+                          prune(height - options_.finality);
+                        }
+                      });
+  }
+
+  void CachedInterpreter::prune(ChainEpoch height) const {
+    auto below = [&](const Buffer &key) {
+      return key.size() >= sizeof(uint64_t)
+             && boost::endian::load_big_u64(key.data())
+                    < static_cast<uint64_t>(height);
+    };
+    {
+      std::lock_guard lock{mutex_};
+      while (!memory_.empty() && below(memory_.begin()->first)) {
+        lru_.erase(memory_.begin()->second.second);
+        memory_.erase(memory_.begin());
+      }
+    }
+    auto cursor = store_->cursor();
+    if (!cursor) {
+      return;
+    }
+    std::vector<Buffer> keys;
+    for (cursor->seekToFirst(); cursor->isValid() && below(cursor->key());
+         cursor->next()) {
+      keys.push_back(cursor->key());
+    }
+    for (auto &key : keys) {
+      std::ignore = store_->remove(key);
+    }
+  }
+
+  std::vector<Result> CachedInterpreter::results() const {
+    std::vector<Result> cached;
+    {
+      std::lock_guard lock{mutex_};
+      for (auto &entry : memory_) {
+        cached.push_back(entry.second.first);
+      }
+    }
+    auto cursor = store_->cursor();
+    if (!cursor) {
+      return cached;
+    }
+    for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
+      // undecodable results are interpreted again, as by loadOrInterpret
+      if (auto result = codec::cbor::decode<Result>(cursor->value())) {
+        cached.push_back(std::move(result.value()));
+      }
+    }
+    return cached;
+  }
 }  // namespace fc::vm::interpreter
@@ -6,35 +6,211 @@
 #ifndef CPP_FILECOIN_CORE_VM_INTERPRETER_INTERPRETER_IMPL_HPP
 #define CPP_FILECOIN_CORE_VM_INTERPRETER_INTERPRETER_IMPL_HPP
 
+#include <chrono>
+#include <future>
+#include <list>
+#include <mutex>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include "primitives/chain_epoch/chain_epoch.hpp"
 #include "storage/buffer_map.hpp"
 #include "vm/interpreter/interpreter.hpp"
+#include "vm/interpreter/message_cache.hpp"
+#include "vm/message/message.hpp"
+#include "vm/runtime/env.hpp"
+#include "vm/runtime/profiler.hpp"
+#include "vm/runtime/proof_verifier.hpp"
+#include "vm/state/state_tree.hpp"
 
 namespace fc::vm::interpreter {
+  using common::Buffer;
+  using message::UnsignedMessage;
+  using primitives::ChainEpoch;
+  using primitives::TokenAmount;
   using storage::PersistentBufferMap;
 
+  /// Number of threads loading and decoding tipset messages
+  constexpr size_t kDefaultPrefetchThreads = 4;
+  /// Messages count below which they are decoded on calling thread
+  constexpr size_t kMinParallelPrefetch = 16;
+  /// Block messages count below which they are executed sequentially
+  constexpr size_t kMinParallelExecution = 8;
+
   class InterpreterImpl : public Interpreter {
    public:
+    /**
+     * @param profiler - records actor methods of all tipsets if not null
+     * @param execution_threads - threads executing block messages
+     * speculatively, messages are executed sequentially if 1. Profiles
+     * include executions which were repeated
+     * @param message_cache - receives messages and receipts of interpreted
+     * tipsets if not null
+     * @param pool - threads prefetching messages and executing them
+     * speculatively, thread counts above limit their use per tipset. Process
+     * wide pool is shared if null
+     */
+    explicit InterpreterImpl(
+        size_t prefetch_threads = kDefaultPrefetchThreads,
+        std::shared_ptr<runtime::Profiler> profiler = nullptr,
+        size_t execution_threads = 1,
+        std::shared_ptr<MessageCache> message_cache = nullptr,
+        std::shared_ptr<boost::asio::thread_pool> pool = nullptr);
+
+    /// Pool shared by interpreters constructed without own pool
+    static std::shared_ptr<boost::asio::thread_pool> defaultPool();
+
     outcome::result<Result> interpret(const IpldPtr &store,
                                       const Tipset &tipset) const override;
 
+    outcome::result<ExecutionTrace> replay(const IpldPtr &store,
+                                           const Tipset &tipset,
+                                           const CID &message) const override;
+
    protected:
     using BlockHeader = primitives::block::BlockHeader;
 
    private:
+    /// Called with cid and trace after each message, returns true to stop
+    using TraceHook = std::function<bool(const CID &, ExecutionTrace)>;
+
+    /**
+     * Apply messages of tipset to parent state, verify proofs with verifier
+     * @param hook - enables tracing if set, result is empty if hook stops
+     */
+    outcome::result<Result> applyTipset(
+        const IpldPtr &ipld,
+        const Tipset &tipset,
+        std::shared_ptr<runtime::ProofVerifier> proof_verifier,
+        const TraceHook &hook = {}) const;
+
+    struct Applied {
+      runtime::MessageReceipt receipt;
+      TokenAmount penalty;
+    };
+
+    /**
+     * Execute messages of block on execution threads against state at block
+     * start, recording actors read, then apply their changes in order.
+     * Message which read actor changed by earlier message of block is
+     * executed again on current state, so receipts and state are same as
+     * with sequential execution.
+     */
+    outcome::result<std::vector<Applied>> applyParallel(
+        const std::shared_ptr<runtime::Env> &env,
+        const std::vector<UnsignedMessage> &messages,
+        const std::vector<size_t> &sizes) const;
+
     bool hasDuplicateMiners(const std::vector<BlockHeader> &blocks) const;
+
+    /**
+     * Load and decode deduplicated messages of all tipset blocks before
+     * execution
+     * @param sizes - receives encoded sizes of unsigned messages grouped same
+     * way, taken from loaded bytes
+     * @param cids - receives message cids grouped same way, if not null
+     * @return messages grouped by block, in execution order
+     */
+    outcome::result<std::vector<std::vector<UnsignedMessage>>> loadMessages(
+        const IpldPtr &ipld,
+        const Tipset &tipset,
+        std::vector<std::vector<size_t>> &sizes,
+        std::vector<std::vector<CID>> *cids = nullptr) const;
+
+    /// Load state tree entries of message senders
+    static void prewarmSenders(
+        state::StateTree &state_tree,
+        const std::vector<std::vector<UnsignedMessage>> &messages);
+
+    size_t prefetch_threads_;
+    std::shared_ptr<runtime::Profiler> profiler_;
+    size_t execution_threads_;
+    std::shared_ptr<MessageCache> message_cache_;
+    std::shared_ptr<boost::asio::thread_pool> pool_;
   };
 
+  /**
+   * Caches interpretation results in store, keyed by tipset height and hash
+   * of tipset key, and keeps recent results in memory. Concurrent requests of
+   * same tipset wait for one interpretation. Results below finality of
+   * precomputed heads are pruned.
+   */
   class CachedInterpreter : public Interpreter {
    public:
+    struct Options {
+      /// Results kept in memory
+      size_t memory_entries{64};
+      /// Results of tipsets this far below precomputed head are pruned
+      ChainEpoch finality{900};
+    };
+
+    CachedInterpreter(std::shared_ptr<Interpreter> interpreter,
+                      std::shared_ptr<PersistentBufferMap> store,
+                      Options options);
+
     CachedInterpreter(std::shared_ptr<Interpreter> interpreter,
                       std::shared_ptr<PersistentBufferMap> store)
-        : interpreter{std::move(interpreter)}, store{std::move(store)} {}
+        : CachedInterpreter{
+            std::move(interpreter), std::move(store), Options{}} {}
+
+    ~CachedInterpreter() override;
+
     outcome::result<Result> interpret(const IpldPtr &store,
                                       const Tipset &tipset) const override;
 
+    /// Replay does not use cached results, parent state is in tipset
+    outcome::result<ExecutionTrace> replay(const IpldPtr &store,
+                                           const Tipset &tipset,
+                                           const CID &message) const override;
+
+    /**
+     * @brief interprets new head on background thread, so later requests
+     * find cached result, then prunes results beyond finality
+     */
+    void precompute(IpldPtr ipld, Tipset tipset);
+
+    /**
+     * @brief result for block production, waits for cached or running
+     * interpretation of tipset until deadline, then interprets on calling
+     * thread without waiting for running one
+     */
+    outcome::result<Result> interpretBefore(
+        const IpldPtr &ipld,
+        const Tipset &tipset,
+        std::chrono::steady_clock::time_point deadline) const;
+
+    /// @brief removes results of tipsets below height
+    void prune(ChainEpoch height) const;
+
+    /**
+     * @brief cached results, including precomputed heads, their states and
+     * receipts are not referenced by chain and are garbage collection roots
+     */
+    std::vector<Result> results() const;
+
+    /// @return store key, big-endian height followed by hash of tipset cids
+    static outcome::result<Buffer> makeKey(const Tipset &tipset);
+
    private:
-    std::shared_ptr<Interpreter> interpreter;
-    std::shared_ptr<PersistentBufferMap> store;
+    using Future = std::shared_future<outcome::result<Result>>;
+    using Lru = std::list<Buffer>;
+
+    outcome::result<Result> loadOrInterpret(const IpldPtr &ipld,
+                                            const Tipset &tipset,
+                                            const Buffer &key) const;
+
+    /// Adds result to memory cache, evicts least recently used
+    void remember(const Buffer &key, const Result &result) const;
+
+    std::shared_ptr<Interpreter> interpreter_;
+    std::shared_ptr<PersistentBufferMap> store_;
+    Options options_;
+    mutable std::mutex mutex_;
+    /// Ordered by key, so by height
+    mutable std::map<Buffer, std::pair<Result, Lru::iterator>> memory_;
+    mutable Lru lru_;
+    mutable std::map<Buffer, Future> pending_;
+    boost::asio::thread_pool worker_{1};
   };
 }  // namespace fc::vm::interpreter
 
@@ -8,12 +8,16 @@
 
 #include "primitives/tipset/tipset.hpp"
 #include "storage/ipfs/datastore.hpp"
+#include "vm/runtime/runtime_types.hpp"
 
 namespace fc::vm::interpreter {
+  using runtime::ExecutionTrace;
+
   enum class InterpreterError {
     DUPLICATE_MINER,
     MINER_SUBMIT_FAILED,
     CRON_TICK_FAILED,
+    MESSAGE_NOT_FOUND,
   };
 
   struct Result {
@@ -31,6 +35,17 @@ namespace fc::vm::interpreter {
 
     virtual outcome::result<Result> interpret(const IpldPtr &store,
                                               const Tipset &tipset) const = 0;
+
+    /**
+     * Apply messages of tipset to its parent state up to message, with
+     * tracing
+     * @param message - cid of message included in tipset
+     * @return trace of message execution
+     */
+    virtual outcome::result<ExecutionTrace> replay(
+        const IpldPtr &store,
+        const Tipset &tipset,
+        const CID &message) const = 0;
   };
 
 }  // namespace fc::vm::interpreter
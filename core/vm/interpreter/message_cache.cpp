@@ -0,0 +1,37 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/interpreter/message_cache.hpp"
+
+namespace fc::vm::interpreter {
+  void MessageCache::insert(const TipsetKey &key, Ptr messages) {
+    if (capacity_ == 0) {
+      return;
+    }
+    std::lock_guard lock{mutex_};
+    auto it{entries_.find(key.cids)};
+    if (it != entries_.end()) {
+      it->second.first = std::move(messages);
+      lru_.splice(lru_.end(), lru_, it->second.second);
+      return;
+    }
+    auto lru{lru_.insert(lru_.end(), key.cids)};
+    entries_.emplace(key.cids, std::make_pair(std::move(messages), lru));
+    if (lru_.size() > capacity_) {
+      entries_.erase(lru_.front());
+      lru_.pop_front();
+    }
+  }
+
+  MessageCache::Ptr MessageCache::get(const TipsetKey &key) const {
+    std::lock_guard lock{mutex_};
+    auto it{entries_.find(key.cids)};
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    lru_.splice(lru_.end(), lru_, it->second.second);
+    return it->second.first;
+  }
+}  // namespace fc::vm::interpreter
@@ -0,0 +1,65 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_INTERPRETER_MESSAGE_CACHE_HPP
+#define CPP_FILECOIN_CORE_VM_INTERPRETER_MESSAGE_CACHE_HPP
+
+#include <list>
+#include <map>
+#include <mutex>
+
+#include "primitives/tipset/tipset_key.hpp"
+#include "vm/message/message.hpp"
+#include "vm/runtime/runtime_types.hpp"
+
+namespace fc::vm::interpreter {
+  using message::UnsignedMessage;
+  using primitives::tipset::TipsetKey;
+  using runtime::MessageReceipt;
+
+  /// Deduplicated messages of interpreted tipset, in execution order
+  struct TipsetMessages {
+    std::vector<CID> cids;
+    /// Secp messages are kept without signature
+    std::vector<UnsignedMessage> messages;
+    /// Receipt of each message
+    std::vector<MessageReceipt> receipts;
+    /// Root of receipts amt, parent receipts of child blocks
+    CID receipts_root;
+  };
+
+  /**
+   * Keeps messages and receipts of recently interpreted tipsets, so parent
+   * messages and receipts of new heads are served without loading them
+   * again. Filled by interpreter as by-product of interpretation.
+   */
+  class MessageCache {
+   public:
+    using Ptr = std::shared_ptr<const TipsetMessages>;
+
+    /// Tipsets kept by default, a few heads and their forks
+    static constexpr size_t kDefaultCapacity{32};
+
+    explicit MessageCache(size_t capacity = kDefaultCapacity)
+        : capacity_{capacity} {}
+
+    /// Adds or replaces messages of tipset, evicts least recently used
+    void insert(const TipsetKey &key, Ptr messages);
+
+    /// Messages of tipset, null if it was not interpreted recently
+    Ptr get(const TipsetKey &key) const;
+
+   private:
+    using Key = std::vector<CID>;
+    using Lru = std::list<Key>;
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::map<Key, std::pair<Ptr, Lru::iterator>> entries_;
+    mutable Lru lru_;
+  };
+}  // namespace fc::vm::interpreter
+
+#endif  // CPP_FILECOIN_CORE_VM_INTERPRETER_MESSAGE_CACHE_HPP
@@ -0,0 +1,132 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/message/secp_message_verifier.hpp"
+
+#include <future>
+
+#include <boost/asio/post.hpp>
+
+#include "vm/message/message_util.hpp"
+
+namespace fc::vm::message {
+  using crypto::secp256k1::Signature;
+
+  SecpMessageVerifier::SecpMessageVerifier(
+      std::shared_ptr<SecpProvider> provider, size_t capacity, size_t threads)
+      : provider_{std::move(provider)},
+        capacity_{capacity},
+        threads_{std::max<size_t>(threads, 1)},
+        pool_{threads_} {
+    BOOST_ASSERT_MSG(provider_ != nullptr, "provider argument is nullptr");
+  }
+
+  outcome::result<SecpPublicKey> SecpMessageVerifier::recoverPublicKey(
+      const SignedMessage &message) const {
+    OUTCOME_TRY(key, cid(message));
+    if (auto cached = lookup(key)) {
+      return *cached;
+    }
+    OUTCOME_TRY(public_key, recover(message));
+    insert(key, public_key);
+    return public_key;
+  }
+
+  outcome::result<bool> SecpMessageVerifier::verify(
+      const Address &signer, const SignedMessage &message) const {
+    OUTCOME_TRY(public_key, recoverPublicKey(message));
+    return signer.verifySyntax(public_key);
+  }
+
+  std::vector<outcome::result<SecpPublicKey>>
+  SecpMessageVerifier::recoverPublicKeys(
+      gsl::span<const SignedMessage> messages) const {
+    std::vector<outcome::result<SecpPublicKey>> results(
+        messages.size(), MessageError::VERIFICATION_FAILURE);
+    std::vector<std::pair<size_t, CID>> misses;
+    for (size_t i = 0; i < results.size(); ++i) {
+      auto key = cid(messages[i]);
+      if (!key) {
+        results[i] = key.error();
+      } else if (auto cached = lookup(key.value())) {
+        results[i] = *cached;
+      } else {
+        misses.emplace_back(i, std::move(key.value()));
+      }
+    }
+
+    auto recover_range = [&](size_t begin, size_t end) {
+      for (auto j = begin; j < end; ++j) {
+        auto &[i, key] = misses[j];
+        results[i] = this->recover(messages[i]);
+        if (results[i]) {
+          insert(key, results[i].value());
+        }
+      }
+    };
+    if (misses.size() < kMinParallelRecover) {
+      recover_range(0, misses.size());
+    } else {
+      auto chunk_size = (misses.size() + threads_ - 1) / threads_;
+      std::vector<std::future<void>> done;
+      for (size_t begin = 0; begin < misses.size(); begin += chunk_size) {
+        std::packaged_task<void()> task{[&, begin] {
+          recover_range(begin, std::min(begin + chunk_size, misses.size()));
+        }};
+        done.push_back(task.get_future());
+        boost::asio::post(pool_, std::move(task));
+      }
+      for (auto &future : done) {
+        future.wait();
+      }
+    }
+    return results;
+  }
+
+  SecpMessageVerifier::Stats SecpMessageVerifier::stats() const {
+    std::lock_guard lock{mutex_};
+    auto stats = stats_;
+    stats.entries = lru_.size();
+    return stats;
+  }
+
+  outcome::result<SecpPublicKey> SecpMessageVerifier::recover(
+      const SignedMessage &message) const {
+    auto signature = boost::get<Signature>(&message.signature);
+    if (signature == nullptr) {
+      return MessageError::VERIFICATION_FAILURE;
+    }
+    OUTCOME_TRY(unsigned_cid, cid(message.message));
+    OUTCOME_TRY(unsigned_bytes, unsigned_cid.toBytes());
+    return provider_->recoverPublicKey(unsigned_bytes, *signature);
+  }
+
+  boost::optional<SecpPublicKey> SecpMessageVerifier::lookup(
+      const CID &key) const {
+    std::lock_guard lock{mutex_};
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return boost::none;
+    }
+    ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+
+  void SecpMessageVerifier::insert(const CID &key,
+                                   const SecpPublicKey &public_key) const {
+    std::lock_guard lock{mutex_};
+    if (capacity_ == 0 || index_.count(key) != 0) {
+      return;
+    }
+    lru_.emplace_front(key, public_key);
+    index_.emplace(key, lru_.begin());
+    while (lru_.size() > capacity_) {
+      index_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+  }
+}  // namespace fc::vm::message
@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_MESSAGE_SECP_MESSAGE_VERIFIER_HPP
+#define CPP_FILECOIN_CORE_VM_MESSAGE_SECP_MESSAGE_VERIFIER_HPP
+
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <boost/asio/thread_pool.hpp>
+#include <boost/optional.hpp>
+
+#include "crypto/secp256k1/secp256k1_provider.hpp"
+#include "vm/message/message.hpp"
+
+namespace fc::vm::message {
+  using SecpPublicKey = crypto::secp256k1::PublicKey;
+
+  /**
+   * @class SecpMessageVerifier recovers signer keys of secp256k1 signed
+   * messages and remembers them in bounded LRU cache. The same message is
+   * usually checked by mempool, block validation and interpretation, so one
+   * instance should be shared. Cache key is signed message CID, which covers
+   * both message and signature.
+   */
+  class SecpMessageVerifier {
+   public:
+    using SecpProvider = crypto::secp256k1::Secp256k1ProviderDefault;
+
+    /// Cache counters
+    struct Stats {
+      uint64_t hits{};
+      uint64_t misses{};
+      uint64_t entries{};
+    };
+
+    /// Default number of cached signer keys
+    static constexpr size_t kDefaultCapacity{32768};
+
+    /// Batches smaller than this are recovered on calling thread
+    static constexpr size_t kMinParallelRecover{16};
+
+    SecpMessageVerifier(std::shared_ptr<SecpProvider> provider,
+                        size_t capacity,
+                        size_t threads = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Recover public key of message signer
+     * @param message - secp256k1 signed message
+     * @return public key or error
+     */
+    outcome::result<SecpPublicKey> recoverPublicKey(
+        const SignedMessage &message) const;
+
+    /**
+     * @brief Check that message is signed by key address
+     * @param signer - secp256k1 key address
+     * @param message - signed message
+     * @return whether signature matches signer
+     */
+    outcome::result<bool> verify(const Address &signer,
+                                 const SignedMessage &message) const;
+
+    /**
+     * @brief Recover public keys of many messages, cache misses are
+     * recovered on thread pool
+     * @param messages - secp256k1 signed messages
+     * @return public key or error for each message
+     */
+    std::vector<outcome::result<SecpPublicKey>> recoverPublicKeys(
+        gsl::span<const SignedMessage> messages) const;
+
+    Stats stats() const;
+
+   private:
+    using Lru = std::list<std::pair<CID, SecpPublicKey>>;
+
+    /// Recover without cache
+    outcome::result<SecpPublicKey> recover(const SignedMessage &message) const;
+
+    boost::optional<SecpPublicKey> lookup(const CID &key) const;
+
+    void insert(const CID &key, const SecpPublicKey &public_key) const;
+
+    std::shared_ptr<SecpProvider> provider_;
+    size_t capacity_;
+    size_t threads_;
+    mutable boost::asio::thread_pool pool_;
+    mutable std::mutex mutex_;
+    mutable Lru lru_;
+    mutable std::unordered_map<CID, Lru::iterator> index_;
+    mutable Stats stats_;
+  };
+}  // namespace fc::vm::message
+
+#endif  // CPP_FILECOIN_CORE_VM_MESSAGE_SECP_MESSAGE_VERIFIER_HPP
@@ -0,0 +1,70 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_RUNTIME_COUNTING_DATASTORE_HPP
+#define CPP_FILECOIN_CORE_VM_RUNTIME_COUNTING_DATASTORE_HPP
+
+#include <unordered_set>
+
+#include "storage/ipfs/datastore.hpp"
+#include "vm/runtime/ipld_stats.hpp"
+#include "vm/runtime/profiler.hpp"
+
+namespace fc::vm::runtime {
+  using storage::ipfs::IpfsDatastore;
+
+  /**
+   * IPLD counters of one message execution, also recorded into profiler
+   * stack if execution is profiled. Used by one thread.
+   */
+  class IpldCounter {
+   public:
+    explicit IpldCounter(std::shared_ptr<Profiler::Stack> profile = nullptr);
+
+    void read(const CID &key, uint64_t bytes);
+
+    void write(const CID &key, uint64_t bytes);
+
+    const IpldStats &stats() const;
+
+   private:
+    IpldStats stats_;
+    /// Blocks read or written by execution, in arena of execution
+    std::pmr::unordered_set<CID> seen_;
+    std::shared_ptr<Profiler::Stack> profile_;
+  };
+
+  /// IpfsDatastore decorator counting reads and writes of actor code
+  class CountingDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<CountingDatastore> {
+   public:
+    CountingDatastore(std::shared_ptr<IpfsDatastore> store,
+                      std::shared_ptr<IpldCounter> counter);
+
+    outcome::result<bool> contains(const CID &key) const override;
+
+    outcome::result<void> set(const CID &key, Value value) override;
+
+    outcome::result<void> setMany(Blocks blocks) override;
+
+    outcome::result<Value> get(const CID &key) const override;
+
+    outcome::result<std::vector<Value>> getMany(
+        gsl::span<const CID> keys) const override;
+
+    outcome::result<void> remove(const CID &key) override;
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+   private:
+    std::shared_ptr<IpfsDatastore> store_;
+    std::shared_ptr<IpldCounter> counter_;
+  };
+}  // namespace fc::vm::runtime
+
+#endif  // CPP_FILECOIN_CORE_VM_RUNTIME_COUNTING_DATASTORE_HPP
@@ -6,10 +6,15 @@
 #ifndef FILECOIN_CORE_VM_RUNTIME_ENV_HPP
 #define FILECOIN_CORE_VM_RUNTIME_ENV_HPP
 
+#include <boost/optional.hpp>
+
 #include "crypto/randomness/randomness_provider.hpp"
 #include "primitives/types.hpp"
 #include "storage/hamt/hamt.hpp"
 #include "vm/actor/invoker.hpp"
+#include "vm/runtime/counting_datastore.hpp"
+#include "vm/runtime/profiler.hpp"
+#include "vm/runtime/proof_verifier.hpp"
 #include "vm/state/state_tree.hpp"
 
 namespace fc::vm::runtime {
@@ -31,13 +36,41 @@ namespace fc::vm::runtime {
     outcome::result<MessageReceipt> applyMessage(const UnsignedMessage &message,
                                                  TokenAmount &penalty);
 
+    /**
+     * Applies message whose encoded size is known, e.g. from loaded bytes,
+     * so it is not encoded again to charge gas for size
+     * @param size - size of CBOR encoded unsigned message
+     */
+    outcome::result<MessageReceipt> applyMessage(const UnsignedMessage &message,
+                                                 size_t size,
+                                                 TokenAmount &penalty);
+
     outcome::result<InvocationOutput> applyImplicitMessage(
         UnsignedMessage message);
 
+    /**
+     * @brief takes trace of last applied message, if tracing
+     * @param receipt - receipt of message, replaces receipt of top send which
+     * excludes message base gas
+     */
+    ExecutionTrace takeTrace(const UnsignedMessage &message,
+                             const MessageReceipt &receipt);
+
     std::shared_ptr<RandomnessProvider> randomness_provider;
     std::shared_ptr<StateTree> state_tree;
     std::shared_ptr<Invoker> invoker;
     ChainEpoch chain_epoch;
+    /// Proof results shared by tipset messages, proofs are verified directly
+    /// if null
+    std::shared_ptr<ProofVerifier> proof_verifier;
+    /// Records actor methods if not null
+    std::shared_ptr<Profiler> profiler;
+    /// Record traces of top level sends into traces
+    bool tracing{false};
+    std::vector<ExecutionTrace> traces;
+    /// If set, gas paid to reward actor is added here instead of state, so
+    /// parallel executions don't all change reward actor
+    boost::optional<TokenAmount> gas_reward;
   };
 
   struct Execution : std::enable_shared_from_this<Execution> {
@@ -53,11 +86,21 @@ namespace fc::vm::runtime {
 
     outcome::result<InvocationOutput> send(const UnsignedMessage &message);
 
+    /// Send without tracing
+    outcome::result<InvocationOutput> sendUntraced(
+        const UnsignedMessage &message);
+
     std::shared_ptr<Env> env;
     std::shared_ptr<StateTree> state_tree;
     GasAmount gas_used;
     GasAmount gas_limit;
     Address origin;
+    /// Call stack of execution if env is profiled
+    std::shared_ptr<Profiler::Stack> profile;
+    /// Blocks accessed by actor code of execution
+    std::shared_ptr<IpldCounter> ipld;
+    /// Sends being traced, innermost last
+    std::vector<ExecutionTrace> trace_stack;
   };
 }  // namespace fc::vm::runtime
 
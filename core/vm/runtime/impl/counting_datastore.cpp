@@ -0,0 +1,78 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/counting_datastore.hpp"
+
+#include "common/arena.hpp"
+
+namespace fc::vm::runtime {
+
+  IpldCounter::IpldCounter(std::shared_ptr<Profiler::Stack> profile)
+      : seen_{common::Arena::resource()}, profile_{std::move(profile)} {}
+
+  void IpldCounter::read(const CID &key, uint64_t bytes) {
+    auto hit = !seen_.insert(key).second;
+    stats_.read(bytes, hit);
+    if (profile_) {
+      if (auto frame = profile_->ipld()) {
+        frame->read(bytes, hit);
+      }
+    }
+  }
+
+  void IpldCounter::write(const CID &key, uint64_t bytes) {
+    seen_.insert(key);
+    stats_.write(bytes);
+    if (profile_) {
+      if (auto frame = profile_->ipld()) {
+        frame->write(bytes);
+      }
+    }
+  }
+
+  const IpldStats &IpldCounter::stats() const {
+    return stats_;
+  }
+
+  CountingDatastore::CountingDatastore(std::shared_ptr<IpfsDatastore> store,
+                                       std::shared_ptr<IpldCounter> counter)
+      : store_{std::move(store)}, counter_{std::move(counter)} {}
+
+  outcome::result<bool> CountingDatastore::contains(const CID &key) const {
+    return store_->contains(key);
+  }
+
+  outcome::result<void> CountingDatastore::set(const CID &key, Value value) {
+    counter_->write(key, value.size());
+    return store_->set(key, std::move(value));
+  }
+
+  outcome::result<void> CountingDatastore::setMany(Blocks blocks) {
+    for (auto &block : blocks) {
+      counter_->write(block.first, block.second.size());
+    }
+    return store_->setMany(std::move(blocks));
+  }
+
+  outcome::result<CountingDatastore::Value> CountingDatastore::get(
+      const CID &key) const {
+    OUTCOME_TRY(value, store_->get(key));
+    counter_->read(key, value.size());
+    return std::move(value);
+  }
+
+  outcome::result<std::vector<CountingDatastore::Value>>
+  CountingDatastore::getMany(gsl::span<const CID> keys) const {
+    OUTCOME_TRY(values, store_->getMany(keys));
+    for (size_t i = 0; i < values.size(); ++i) {
+      counter_->read(keys[i], values[i].size());
+    }
+    return std::move(values);
+  }
+
+  outcome::result<void> CountingDatastore::remove(const CID &key) {
+    return store_->remove(key);
+  }
+}  // namespace fc::vm::runtime
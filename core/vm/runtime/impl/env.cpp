@@ -5,6 +5,11 @@
 
 #include "vm/runtime/env.hpp"
 
+#include <utility>
+
+#include "common/arena.hpp"
+#include "common/logger.hpp"
+#include "common/tracing.hpp"
 #include "vm/actor/builtin/account/account_actor.hpp"
 #include "vm/exit_code/exit_code.hpp"
 #include "vm/runtime/gas_cost.hpp"
@@ -13,14 +18,54 @@
 
 namespace fc::vm::runtime {
   using actor::kAccountCodeCid;
+  using common::Arena;
   using actor::kEmptyObjectCid;
   using actor::kRewardAddress;
   using actor::kSendMethodNumber;
   using actor::kSystemActorAddress;
   using storage::hamt::HamtError;
 
+  namespace {
+    common::Logger logger() {
+      static common::Logger logger{common::createLogger("vm")};
+      return logger;
+    }
+
+    /// Reverts snapshot of state tree on scope exit unless it was popped
+    struct SnapshotScope {
+      ~SnapshotScope() {
+        if (tree) {
+          auto res = tree->revertSnapshot();
+          if (!res) {
+            logger()->error("cannot revert snapshot: {}",
+                            res.error().message());
+          }
+        }
+      }
+
+      outcome::result<void> revert() {
+        return std::exchange(tree, nullptr)->revertSnapshot();
+      }
+
+      outcome::result<void> clear() {
+        return std::exchange(tree, nullptr)->clearSnapshot();
+      }
+
+      std::shared_ptr<state::StateTree> tree;
+    };
+  }  // namespace
+
   outcome::result<MessageReceipt> Env::applyMessage(
       const UnsignedMessage &message, TokenAmount &penalty) {
+    OUTCOME_TRY(serialized_message, codec::cbor::encode(message));
+    return applyMessage(message, serialized_message.size(), penalty);
+  }
+
+  outcome::result<MessageReceipt> Env::applyMessage(
+      const UnsignedMessage &message, size_t size, TokenAmount &penalty) {
+    common::tracing::Span span{"vm.apply_message"};
+    // execution temporaries are freed at once when message is applied
+    Arena::Scope arena;
     if (message.gasLimit <= 0) {
       return RuntimeError::UNKNOWN;
     }
@@ -29,10 +74,8 @@ namespace fc::vm::runtime {
     MessageReceipt receipt;
     receipt.gas_used = 0;
 
-    OUTCOME_TRY(serialized_message, codec::cbor::encode(message));
     GasAmount msg_gas_cost =
-        kOnChainMessageBaseGasCost
-        + serialized_message.size() * kOnChainMessagePerByteGasCharge;
+        kOnChainMessageBaseGasCost + size * kOnChainMessagePerByteGasCharge;
     penalty = msg_gas_cost * message.gasPrice;
     if (msg_gas_cost > message.gasLimit) {
       receipt.exit_code = VMExitCode::SysErrOutOfGas;
@@ -66,7 +109,9 @@ namespace fc::vm::runtime {
     ++from.nonce;
     OUTCOME_TRY(state_tree->set(message.from, from));
 
-    OUTCOME_TRY(snapshot, state_tree->flush());
+    OUTCOME_TRY(state_tree->snapshot());
+    // errors below return with snapshot popped
+    SnapshotScope snapshot{state_tree};
     OUTCOME_TRY(execution->chargeGas(msg_gas_cost));
     auto result = execution->send(message);
     auto exit_code = VMExitCode::Ok;
@@ -85,7 +130,9 @@ namespace fc::vm::runtime {
       }
     }
     if (exit_code != VMExitCode::Ok) {
-      OUTCOME_TRY(state_tree->revert(snapshot));
+      OUTCOME_TRY(snapshot.revert());
+    } else {
+      OUTCOME_TRY(snapshot.clear());
     }
 
     BOOST_ASSERT_MSG(execution->gas_used >= 0, "negative used gas");
@@ -99,27 +146,64 @@ namespace fc::vm::runtime {
       OUTCOME_TRY(state_tree->set(message.from, from));
     }
 
-    OUTCOME_TRY(reward, state_tree->get(kRewardAddress));
-    reward.balance += execution->gas_used * message.gasPrice;
-    OUTCOME_TRY(state_tree->set(kRewardAddress, reward));
+    if (gas_reward) {
+      *gas_reward += execution->gas_used * message.gasPrice;
+    } else {
+      OUTCOME_TRY(reward, state_tree->get(kRewardAddress));
+      reward.balance += execution->gas_used * message.gasPrice;
+      OUTCOME_TRY(state_tree->set(kRewardAddress, reward));
+    }
 
     auto ret_code = normalizeVMExitCode(exit_code);
     BOOST_ASSERT_MSG(ret_code, "c++ actor code returned unknown error");
     penalty = 0;
     receipt.exit_code = *ret_code;
     receipt.gas_used = execution->gas_used;
+    if (logger()->should_log(spdlog::level::debug)) {
+      auto &ipld = execution->ipld->stats();
+      logger()->debug(
+          "receipt {} to {} method {}: exit {} gas {}, ipld read {} blocks "
+          "{} bytes hit rate {:.2f}, written {} blocks {} bytes",
+          message.from,
+          message.to,
+          message.method.method_number,
+          static_cast<int64_t>(receipt.exit_code),
+          receipt.gas_used,
+          ipld.reads,
+          ipld.read_bytes,
+          ipld.hitRate(),
+          ipld.writes,
+          ipld.write_bytes);
+    }
     return receipt;
   }
 
   outcome::result<InvocationOutput> Env::applyImplicitMessage(
       UnsignedMessage message) {
+    Arena::Scope arena;
     OUTCOME_TRY(from, state_tree->get(message.from));
     message.nonce = from.nonce;
     auto execution = Execution::make(shared_from_this(), message);
     return execution->send(message);
   }
 
+  ExecutionTrace Env::takeTrace(const UnsignedMessage &message,
+                                const MessageReceipt &receipt) {
+    ExecutionTrace trace;
+    if (traces.empty()) {
+      trace.message = message;
+    } else {
+      trace = std::move(traces.back());
+      traces.clear();
+    }
+    trace.receipt = receipt;
+    return trace;
+  }
+
   outcome::result<void> Execution::chargeGas(GasAmount amount) {
+    if (profile) {
+      profile->gas(amount);
+    }
     gas_used += amount;
     if (gas_limit != kInfiniteGas && gas_used > gas_limit) {
       gas_used = gas_limit;
@@ -130,12 +214,16 @@ namespace fc::vm::runtime {
 
   std::shared_ptr<Execution> Execution::make(std::shared_ptr<Env> env,
                                              const UnsignedMessage &message) {
-    auto execution = std::make_shared<Execution>();
+    auto execution = Arena::make<Execution>();
     execution->env = env;
     execution->state_tree = env->state_tree;
     execution->gas_used = 0;
     execution->gas_limit = message.gasLimit;
     execution->origin = message.from;
+    if (env->profiler) {
+      execution->profile = Arena::make<Profiler::Stack>(env->profiler);
+    }
+    execution->ipld = Arena::make<IpldCounter>(execution->profile);
     return execution;
   }
 
@@ -166,17 +254,49 @@ namespace fc::vm::runtime {
 
   outcome::result<InvocationOutput> Execution::sendWithRevert(
       const UnsignedMessage &message) {
-    OUTCOME_TRY(snapshot, state_tree->flush());
+    OUTCOME_TRY(state_tree->snapshot());
     auto result = send(message);
     if (!result) {
-      OUTCOME_TRY(state_tree->revert(snapshot));
+      OUTCOME_TRY(state_tree->revertSnapshot());
       return result.error();
     }
+    OUTCOME_TRY(state_tree->clearSnapshot());
     return result;
   }
 
   outcome::result<InvocationOutput> Execution::send(
       const UnsignedMessage &message) {
+    if (!env->tracing) {
+      return sendUntraced(message);
+    }
+    trace_stack.push_back({message, {}, {}, {}});
+    auto gas_before = gas_used;
+    auto result = sendUntraced(message);
+    auto trace = std::move(trace_stack.back());
+    trace_stack.pop_back();
+    trace.receipt.gas_used = gas_used - gas_before;
+    if (result) {
+      trace.receipt.exit_code = VMExitCode::Ok;
+      trace.receipt.return_value = result.value();
+    } else {
+      trace.error = result.error().message();
+      if (isVMExitCode(result.error())) {
+        if (auto exit_code =
+                normalizeVMExitCode(VMExitCode{result.error().value()})) {
+          trace.receipt.exit_code = *exit_code;
+        }
+      }
+    }
+    if (trace_stack.empty()) {
+      env->traces.push_back(std::move(trace));
+    } else {
+      trace_stack.back().subcalls.push_back(std::move(trace));
+    }
+    return result;
+  }
+
+  outcome::result<InvocationOutput> Execution::sendUntraced(
+      const UnsignedMessage &message) {
     if (message.value != 0) {
       OUTCOME_TRY(chargeGas(kSendTransferFundsGasCost));
     }
@@ -211,6 +331,7 @@ namespace fc::vm::runtime {
     }
 
     if (message.method != kSendMethodNumber) {
+      Profiler::Scope profile_scope{profile, to_actor.code, message.method};
       auto result = env->invoker->invoke(
           to_actor, runtime, message.method, message.params);
       OUTCOME_TRYA(to_actor, state_tree->get(message.to));
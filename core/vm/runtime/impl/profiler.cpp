@@ -0,0 +1,132 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/profiler.hpp"
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+namespace fc::vm::runtime {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+
+  Profiler::Stack::Stack(std::shared_ptr<Profiler> profiler)
+      : profiler_{std::move(profiler)} {}
+
+  void Profiler::Stack::enter(const CodeId &code, MethodNumber method) {
+    auto &frame = frames_.emplace_back();
+    frame.self.code = code;
+    frame.self.method = method;
+    frame.self.calls = 1;
+    frame.start = steady_clock::now();
+  }
+
+  void Profiler::Stack::exit() {
+    BOOST_ASSERT(!frames_.empty());
+    auto &frame = frames_.back();
+    frame.self.total_time = steady_clock::now() - frame.start;
+    frame.self.self_time = frame.self.total_time - frame.children;
+    std::string path;
+    for (auto &parent : frames_) {
+      if (!path.empty()) {
+        path += ';';
+      }
+      path += codeName(parent.self.code) + ':'
+              + std::to_string(parent.self.method.method_number);
+    }
+    profiler_->merge(frame.self, path);
+    auto total_time = frame.self.total_time;
+    frames_.pop_back();
+    if (!frames_.empty()) {
+      frames_.back().children += total_time;
+    }
+  }
+
+  void Profiler::Stack::gas(GasAmount amount) {
+    if (!frames_.empty()) {
+      frames_.back().self.gas += amount;
+    }
+  }
+
+  IpldStats *Profiler::Stack::ipld() {
+    return frames_.empty() ? nullptr : &frames_.back().self.ipld;
+  }
+
+  Profiler::Scope::Scope(std::shared_ptr<Stack> stack,
+                         const CodeId &code,
+                         MethodNumber method)
+      : stack_{std::move(stack)} {
+    if (stack_) {
+      stack_->enter(code, method);
+    }
+  }
+
+  Profiler::Scope::~Scope() {
+    if (stack_) {
+      stack_->exit();
+    }
+  }
+
+  void Profiler::merge(const MethodProfile &self, const std::string &path) {
+    std::lock_guard lock{mutex_};
+    auto it = methods_.find({self.code, self.method});
+    if (it == methods_.end()) {
+      methods_.emplace(Key{self.code, self.method}, self);
+    } else {
+      auto &total = it->second;
+      total.calls += self.calls;
+      total.total_time += self.total_time;
+      total.self_time += self.self_time;
+      total.gas += self.gas;
+      total.ipld += self.ipld;
+    }
+    stacks_[path] += self.self_time;
+  }
+
+  std::vector<MethodProfile> Profiler::methods() const {
+    std::vector<MethodProfile> methods;
+    {
+      std::lock_guard lock{mutex_};
+      methods.reserve(methods_.size());
+      for (auto &method : methods_) {
+        methods.push_back(method.second);
+      }
+    }
+    std::stable_sort(methods.begin(), methods.end(), [](auto &l, auto &r) {
+      return l.self_time > r.self_time;
+    });
+    return methods;
+  }
+
+  std::string Profiler::folded() const {
+    std::string folded;
+    std::lock_guard lock{mutex_};
+    for (auto &stack : stacks_) {
+      folded += stack.first + ' '
+                + std::to_string(
+                    duration_cast<microseconds>(stack.second).count())
+                + '\n';
+    }
+    return folded;
+  }
+
+  void Profiler::reset() {
+    std::lock_guard lock{mutex_};
+    methods_.clear();
+    stacks_.clear();
+  }
+
+  std::string Profiler::codeName(const CodeId &code) {
+    auto &multihash = code.content_address;
+    if (multihash.getType() == libp2p::multi::HashType::identity) {
+      auto &digest = multihash.getHash();
+      return {digest.begin(), digest.end()};
+    }
+    auto str = code.toString();
+    return str ? str.value() : "unknown";
+  }
+}  // namespace fc::vm::runtime
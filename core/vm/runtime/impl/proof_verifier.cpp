@@ -0,0 +1,93 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/proof_verifier.hpp"
+
+#include <thread>
+
+#include "codec/cbor/cbor.hpp"
+#include "proofs/proofs.hpp"
+
+namespace fc::vm::runtime {
+  using proofs::Proofs;
+
+  template <typename Info>
+  outcome::result<bool> ProofVerifier::Cache<Info>::verify(const Info &info,
+                                                           bool speculating) {
+    OUTCOME_TRY(key, codec::cbor::encode(info));
+    {
+      std::lock_guard lock{mutex};
+      auto it = known.find(key);
+      if (it != known.end()) {
+        return it->second;
+      }
+      if (speculating) {
+        recorded.emplace(std::move(key), info);
+        return true;
+      }
+    }
+    // other threads may verify meanwhile
+    auto result = batch(gsl::make_span(&info, 1)).at(0);
+    std::lock_guard lock{mutex};
+    known.emplace(std::move(key), result);
+    return result;
+  }
+
+  template <typename Info>
+  bool ProofVerifier::Cache<Info>::verifyRecorded() {
+    std::lock_guard lock{mutex};
+    if (recorded.empty()) {
+      return true;
+    }
+    std::vector<Info> infos;
+    infos.reserve(recorded.size());
+    for (const auto &item : recorded) {
+      infos.push_back(item.second);
+    }
+    auto results = batch(infos);
+    auto correct{true};
+    auto result = results.begin();
+    for (auto &item : recorded) {
+      if (!*result || !result->value()) {
+        correct = false;
+      }
+      known.emplace(item.first, std::move(*result));
+      ++result;
+    }
+    recorded.clear();
+    return correct;
+  }
+
+  ProofVerifier::ProofVerifier(SealBatchFunction seals,
+                               PoStBatchFunction posts) {
+    seals_.batch = seals ? std::move(seals) : [](auto infos) {
+      return Proofs::verifySeals(infos, std::thread::hardware_concurrency());
+    };
+    posts_.batch = posts ? std::move(posts) : [](auto infos) {
+      return Proofs::verifyWindowPoSts(infos,
+                                       std::thread::hardware_concurrency());
+    };
+  }
+
+  outcome::result<bool> ProofVerifier::verifySeal(const SealVerifyInfo &info) {
+    return seals_.verify(info, speculating_);
+  }
+
+  outcome::result<bool> ProofVerifier::verifyPoSt(
+      const WindowPoStVerifyInfo &info) {
+    return posts_.verify(info, speculating_);
+  }
+
+  bool ProofVerifier::verifyRecorded() {
+    speculating_ = false;
+    auto seals = seals_.verifyRecorded();
+    auto posts = posts_.verifyRecorded();
+    return seals && posts;
+  }
+
+  bool ProofVerifier::speculating() const {
+    return speculating_;
+  }
+}  // namespace fc::vm::runtime
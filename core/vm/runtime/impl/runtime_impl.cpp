@@ -6,9 +6,11 @@
 #include "vm/runtime/impl/runtime_impl.hpp"
 
 #include "codec/cbor/cbor.hpp"
+#include "common/arena.hpp"
 #include "primitives/cid/comm_cid.hpp"
 #include "proofs/proofs.hpp"
 #include "vm/actor/builtin/account/account_actor.hpp"
+#include "vm/runtime/counting_datastore.hpp"
 #include "vm/runtime/gas_cost.hpp"
 #include "vm/runtime/impl/actor_state_handle_impl.hpp"
 #include "vm/runtime/runtime_error.hpp"
@@ -113,7 +115,11 @@ namespace fc::vm::runtime {
 
   std::shared_ptr<IpfsDatastore> RuntimeImpl::getIpfsDatastore() {
     // TODO(turuslan): FIL-131 charging store
-    return state_tree_->getStore();
+    if (!ipld_) {
+      ipld_ = common::Arena::make<CountingDatastore>(state_tree_->getStore(),
+                                                     execution_->ipld);
+    }
+    return ipld_;
   }
 
   std::reference_wrapper<const UnsignedMessage> RuntimeImpl::getMessage() {
@@ -157,11 +163,17 @@ namespace fc::vm::runtime {
       const WindowPoStVerifyInfo &info) {
     WindowPoStVerifyInfo preprocess_info = info;
     preprocess_info.randomness[31] = 0;
+    if (auto &proof_verifier = execution_->env->proof_verifier) {
+      return proof_verifier->verifyPoSt(preprocess_info);
+    }
     return proofs::Proofs::verifyWindowPoSt(preprocess_info);
   }
 
   fc::outcome::result<bool> RuntimeImpl::verifySeal(
       const SealVerifyInfo &info) {
+    if (auto &proof_verifier = execution_->env->proof_verifier) {
+      return proof_verifier->verifySeal(info);
+    }
     return proofs::Proofs::verifySeal(info);
   }
 
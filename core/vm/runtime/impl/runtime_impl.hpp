@@ -117,6 +117,8 @@ namespace fc::vm::runtime {
     UnsignedMessage message_;
     Address caller_id;
     ActorSubstateCID current_actor_state_;
+    /// Store counting accesses into execution, created on first use
+    std::shared_ptr<IpfsDatastore> ipld_;
   };
 
 }  // namespace fc::vm::runtime
@@ -0,0 +1,53 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_RUNTIME_IPLD_STATS_HPP
+#define CPP_FILECOIN_CORE_VM_RUNTIME_IPLD_STATS_HPP
+
+#include <cstdint>
+
+namespace fc::vm::runtime {
+
+  /// Counters of blocks accessed by actor code
+  struct IpldStats {
+    void read(uint64_t bytes, bool hit) {
+      ++reads;
+      read_bytes += bytes;
+      if (hit) {
+        ++cache_hits;
+      }
+    }
+
+    void write(uint64_t bytes) {
+      ++writes;
+      write_bytes += bytes;
+    }
+
+    IpldStats &operator+=(const IpldStats &other) {
+      reads += other.reads;
+      read_bytes += other.read_bytes;
+      writes += other.writes;
+      write_bytes += other.write_bytes;
+      cache_hits += other.cache_hits;
+      return *this;
+    }
+
+    /// @return part of reads which were cache hits
+    double hitRate() const {
+      return reads == 0 ? 0 : static_cast<double>(cache_hits) / reads;
+    }
+
+    uint64_t reads{};
+    uint64_t read_bytes{};
+    uint64_t writes{};
+    /// Bytes of encoded blocks written
+    uint64_t write_bytes{};
+    /// Reads of blocks already read or written by same execution, which a
+    /// per-message cache would serve
+    uint64_t cache_hits{};
+  };
+}  // namespace fc::vm::runtime
+
+#endif  // CPP_FILECOIN_CORE_VM_RUNTIME_IPLD_STATS_HPP
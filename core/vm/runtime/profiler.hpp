@@ -0,0 +1,109 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_RUNTIME_PROFILER_HPP
+#define CPP_FILECOIN_CORE_VM_RUNTIME_PROFILER_HPP
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#include "vm/actor/actor.hpp"
+#include "vm/runtime/ipld_stats.hpp"
+
+namespace fc::vm::runtime {
+  using actor::CodeId;
+  using actor::MethodNumber;
+  using primitives::GasAmount;
+
+  /// Counters of actor method aggregated over calls
+  struct MethodProfile {
+    CodeId code;
+    MethodNumber method;
+    uint64_t calls{};
+    /// Wall time including nested sends
+    std::chrono::nanoseconds total_time{};
+    /// Wall time excluding nested sends
+    std::chrono::nanoseconds self_time{};
+    /// Self values below exclude nested sends too
+    GasAmount gas{};
+    IpldStats ipld;
+  };
+
+  /**
+   * Opt-in profiler of actor methods, aggregates counters per (actor code,
+   * method number) over all executions until reset. Each execution records
+   * into own Stack without locking, counters are merged when method returns.
+   */
+  class Profiler {
+   public:
+    /// Call stack of one message execution, used by one thread
+    class Stack {
+     public:
+      explicit Stack(std::shared_ptr<Profiler> profiler);
+
+      void enter(const CodeId &code, MethodNumber method);
+
+      void exit();
+
+      /// Attributes gas to method on top of stack, if any
+      void gas(GasAmount amount);
+
+      /// @return IPLD counters of method on top of stack, null if empty
+      IpldStats *ipld();
+
+     private:
+      struct Frame {
+        MethodProfile self;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::nanoseconds children{};
+      };
+
+      std::shared_ptr<Profiler> profiler_;
+      std::vector<Frame> frames_;
+    };
+
+    /// Enters method on construction and exits on destruction, no-op if stack
+    /// is null
+    class Scope {
+     public:
+      Scope(std::shared_ptr<Stack> stack,
+            const CodeId &code,
+            MethodNumber method);
+
+      Scope(const Scope &) = delete;
+
+      ~Scope();
+
+     private:
+      std::shared_ptr<Stack> stack_;
+    };
+
+    /// @return methods sorted by self time, slowest first
+    std::vector<MethodProfile> methods() const;
+
+    /**
+     * @brief self time in microseconds of call stacks, in folded format
+     * accepted by flamegraph.pl, one "actor:method;actor:method time" per line
+     */
+    std::string folded() const;
+
+    void reset();
+
+    /// @return human readable name of builtin actor code, cid otherwise
+    static std::string codeName(const CodeId &code);
+
+   private:
+    using Key = std::pair<CodeId, MethodNumber>;
+
+    void merge(const MethodProfile &self, const std::string &path);
+
+    mutable std::mutex mutex_;
+    std::map<Key, MethodProfile> methods_;
+    std::map<std::string, std::chrono::nanoseconds> stacks_;
+  };
+}  // namespace fc::vm::runtime
+
+#endif  // CPP_FILECOIN_CORE_VM_RUNTIME_PROFILER_HPP
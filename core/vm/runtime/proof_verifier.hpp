@@ -0,0 +1,83 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_RUNTIME_PROOF_VERIFIER_HPP
+#define CPP_FILECOIN_CORE_VM_RUNTIME_PROOF_VERIFIER_HPP
+
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include "common/buffer.hpp"
+#include "primitives/sector/sector.hpp"
+
+namespace fc::vm::runtime {
+  using common::Buffer;
+  using primitives::sector::SealVerifyInfo;
+  using primitives::sector::WindowPoStVerifyInfo;
+
+  /**
+   * Seal and window PoSt verification results shared by applications of one
+   * tipset. While speculating, unknown proofs are assumed valid and recorded,
+   * then verified in parallel by verifyRecorded. If any assumption was wrong,
+   * tipset must be applied again with known results, so state and receipts
+   * are same as with sequential verification.
+   * Proofs may be verified from several threads, verifyRecorded is called
+   * after they finish.
+   */
+  class ProofVerifier {
+   public:
+    template <typename Info>
+    using BatchFunction = std::function<std::vector<outcome::result<bool>>(
+        gsl::span<const Info>)>;
+    using SealBatchFunction = BatchFunction<SealVerifyInfo>;
+    using PoStBatchFunction = BatchFunction<WindowPoStVerifyInfo>;
+
+    /**
+     * @param seals - Proofs::verifySeals on all cores by default
+     * @param posts - Proofs::verifyWindowPoSts on all cores by default
+     */
+    explicit ProofVerifier(SealBatchFunction seals = {},
+                           PoStBatchFunction posts = {});
+
+    /**
+     * @brief returns known result of seal, true for unknown seal while
+     * speculating, verifies unknown seal otherwise
+     */
+    outcome::result<bool> verifySeal(const SealVerifyInfo &info);
+
+    /// @brief same as verifySeal, for window PoSt
+    outcome::result<bool> verifyPoSt(const WindowPoStVerifyInfo &info);
+
+    /**
+     * @brief verifies proofs recorded while speculating, stops speculation
+     * @return true if all recorded proofs are valid, so results returned
+     * while speculating were correct
+     */
+    bool verifyRecorded();
+
+    bool speculating() const;
+
+   private:
+    /// Results of one kind of proofs, keyed by cbor of verify info
+    template <typename Info>
+    struct Cache {
+      outcome::result<bool> verify(const Info &info, bool speculating);
+
+      bool verifyRecorded();
+
+      BatchFunction<Info> batch;
+      std::mutex mutex;
+      std::map<Buffer, outcome::result<bool>> known;
+      std::map<Buffer, Info> recorded;
+    };
+
+    bool speculating_{true};
+    Cache<SealVerifyInfo> seals_;
+    Cache<WindowPoStVerifyInfo> posts_;
+  };
+}  // namespace fc::vm::runtime
+
+#endif  // CPP_FILECOIN_CORE_VM_RUNTIME_PROOF_VERIFIER_HPP
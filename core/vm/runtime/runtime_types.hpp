@@ -46,6 +46,14 @@ namespace fc::vm::runtime {
     std::string error;
   };
 
+  /// Send with nested sends, gas used includes nested sends
+  struct ExecutionTrace {
+    UnsignedMessage message;
+    MessageReceipt receipt;
+    std::string error;
+    std::vector<ExecutionTrace> subcalls;
+  };
+
   enum class ConsensusFaultType {
     DoubleForkMining = 1,
     ParentGrinding = 2,
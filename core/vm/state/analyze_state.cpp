@@ -0,0 +1,99 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <iostream>
+
+#include "primitives/address/address_codec.hpp"
+#include "storage/ipfs/impl/datastore_leveldb.hpp"
+#include "vm/state/state_analyzer.hpp"
+
+using fc::CID;
+using fc::primitives::address::encodeToString;
+using fc::storage::ipfs::LeveldbDatastore;
+using fc::vm::state::DagKind;
+using fc::vm::state::DagShape;
+
+void print(const std::string &name, const DagShape &shape) {
+  std::cout << name << " "
+            << (shape.kind == DagKind::HAMT  ? "hamt"
+                : shape.kind == DagKind::AMT ? "amt"
+                                             : "dag")
+            << " blocks=" << shape.blocks << " bytes=" << shape.bytes
+            << " depth=" << shape.depth;
+  if (shape.capacity != 0) {
+    std::cout << " entries=" << shape.entries << "/" << shape.capacity;
+  }
+  std::cout << " fanout=";
+  for (auto i{0u}; i < shape.fanout.size(); ++i) {
+    if (shape.fanout[i] != 0) {
+      std::cout << i << ":" << shape.fanout[i] << ",";
+    }
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * Prints size and shape of actor states of state root, largest first, or
+ * blocks added and removed by actors between two state roots.
+ * Usage: analyze_state <leveldb path> <state root> [state root after]
+ */
+int main(int argc, char **argv) {
+  if (argc != 3 && argc != 4) {
+    std::cerr << "usage: " << argv[0]
+              << " <leveldb path> <state root> [state root after]"
+              << std::endl;
+    return 1;
+  }
+  auto ipld = LeveldbDatastore::create(argv[1], leveldb::Options{});
+  if (!ipld) {
+    std::cerr << "cannot open leveldb: " << ipld.error().message()
+              << std::endl;
+    return 1;
+  }
+  auto root = CID::fromString(argv[2]);
+  if (!root) {
+    std::cerr << "invalid state root: " << argv[2] << std::endl;
+    return 1;
+  }
+
+  if (argc == 4) {
+    auto after = CID::fromString(argv[3]);
+    if (!after) {
+      std::cerr << "invalid state root: " << argv[3] << std::endl;
+      return 1;
+    }
+    auto diff = fc::vm::state::diffStateShape(
+        ipld.value(), root.value(), after.value());
+    if (!diff) {
+      std::cerr << "diff failed: " << diff.error().message() << std::endl;
+      return 1;
+    }
+    std::cout << "actors added=" << diff.value().actors_added
+              << " removed=" << diff.value().actors_removed
+              << " changed=" << diff.value().actors_changed << std::endl;
+    for (auto &actor : diff.value().actors) {
+      std::cout << encodeToString(actor.address)
+                << " blocks=+" << actor.blocks_added << "/-"
+                << actor.blocks_removed << " bytes=+" << actor.bytes_added
+                << "/-" << actor.bytes_removed << std::endl;
+    }
+    return 0;
+  }
+
+  auto state = fc::vm::state::analyzeState(ipld.value(), root.value());
+  if (!state) {
+    std::cerr << "analyze failed: " << state.error().message() << std::endl;
+    return 1;
+  }
+  print("actors", state.value().actors_hamt);
+  for (auto &actor : state.value().actors) {
+    auto address{encodeToString(actor.address)};
+    print(address, actor.state);
+    for (auto &embedded : actor.embedded) {
+      print("  " + embedded.root.toString().value(), embedded.shape);
+    }
+  }
+  return 0;
+}
@@ -7,34 +7,112 @@
 
 #include "vm/actor/builtin/init/init_actor.hpp"
 
+OUTCOME_CPP_DEFINE_CATEGORY(fc::vm::state, StateTreeError, e) {
+  using E = fc::vm::state::StateTreeError;
+  switch (e) {
+    case E::NO_SNAPSHOT:
+      return "No snapshot to revert or clear";
+    case E::NOT_SUPPORTED:
+      return "Operation not supported by state tree";
+  }
+  return "Unknown error";
+}
+
 namespace fc::vm::state {
   using actor::builtin::init::InitActorState;
 
+  boost::optional<Address> StateRootCache::id(const Address &address) const {
+    std::lock_guard lock{mutex_};
+    auto it{ids_.find(address)};
+    if (it == ids_.end()) {
+      return boost::none;
+    }
+    return it->second;
+  }
+
+  void StateRootCache::setId(const Address &address,
+                             const Address &address_id) const {
+    std::lock_guard lock{mutex_};
+    ids_.emplace(address, address_id);
+  }
+
+  boost::optional<Actor> StateRootCache::actor(
+      const Address &address_id) const {
+    std::lock_guard lock{mutex_};
+    auto it{actors_.find(address_id)};
+    if (it == actors_.end()) {
+      return boost::none;
+    }
+    return it->second;
+  }
+
+  void StateRootCache::setActor(const Address &address_id,
+                                const Actor &actor) const {
+    std::lock_guard lock{mutex_};
+    actors_.emplace(address_id, actor);
+  }
+
   StateTreeImpl::StateTreeImpl(const std::shared_ptr<IpfsDatastore> &store)
       : store_{store}, by_id{store} {}
 
   StateTreeImpl::StateTreeImpl(const std::shared_ptr<IpfsDatastore> &store,
                                const CID &root)
-      : store_{store}, by_id{root, store} {}
+      : store_{store}, by_id{root, store}, root_cache_{rootCache(root)} {}
 
   outcome::result<void> StateTreeImpl::set(const Address &address,
                                            const Actor &actor) {
     OUTCOME_TRY(address_id, lookupId(address));
-    return by_id.set(address_id, actor);
+    OUTCOME_TRY(journal(address_id));
+    OUTCOME_TRY(by_id.set(address_id, actor));
+    actors_[address_id] = actor;
+    return outcome::success();
   }
 
   outcome::result<Actor> StateTreeImpl::get(const Address &address) {
     OUTCOME_TRY(address_id, lookupId(address));
-    return by_id.get(address_id);
+    auto changed{actors_.find(address_id)};
+    if (changed != actors_.end()) {
+      if (changed->second) {
+        return *changed->second;
+      }
+      return by_id.get(address_id);
+    }
+    if (root_cache_) {
+      if (auto actor{root_cache_->actor(address_id)}) {
+        return std::move(*actor);
+      }
+    }
+    // not changed since root
+    OUTCOME_TRY(actor, by_id.get(address_id));
+    if (root_cache_) {
+      root_cache_->setActor(address_id, actor);
+    }
+    return std::move(actor);
   }
 
   outcome::result<Address> StateTreeImpl::lookupId(const Address &address) {
     if (address.isId()) {
       return address;
     }
+    auto registered{ids_.find(address)};
+    if (registered != ids_.end()) {
+      return registered->second;
+    }
+    if (root_cache_) {
+      if (auto address_id{root_cache_->id(address)}) {
+        return std::move(*address_id);
+      }
+    }
     OUTCOME_TRY(init_actor_state, state<InitActorState>(actor::kInitAddress));
     OUTCOME_TRY(id, init_actor_state.address_map.get(address));
-    return Address::makeFromId(id);
+    auto address_id{Address::makeFromId(id)};
+    if (actors_.count(actor::kInitAddress) != 0) {
+      // may be registered since root
+      ids_.emplace(address, address_id);
+    } else if (root_cache_) {
+      root_cache_->setId(address, address_id);
+    }
+    return std::move(address_id);
   }
 
   outcome::result<Address> StateTreeImpl::registerNewAddress(
@@ -45,6 +123,7 @@ namespace fc::vm::state {
     OUTCOME_TRY(address_id, init_actor_state.addActor(address));
     OUTCOME_TRYA(init_actor.head, store_->setCbor(init_actor_state));
     OUTCOME_TRY(set(actor::kInitAddress, init_actor));
+    ids_.emplace(address, address_id);
     return std::move(address_id);
   }
 
@@ -55,9 +134,75 @@ namespace fc::vm::state {
 
   outcome::result<void> StateTreeImpl::revert(const CID &root) {
     by_id = {root, store_};
+    snapshots_.clear();
+    root_cache_ = rootCache(root);
+    ids_.clear();
+    actors_.clear();
     return outcome::success();
   }
 
+  outcome::result<void> StateTreeImpl::snapshot() {
+    snapshots_.emplace_back();
+    return outcome::success();
+  }
+
+  outcome::result<void> StateTreeImpl::revertSnapshot() {
+    if (snapshots_.empty()) {
+      return StateTreeError::NO_SNAPSHOT;
+    }
+    auto journal = std::move(snapshots_.back());
+    snapshots_.pop_back();
+    for (auto &[address_id, actor] : journal) {
+      if (actor) {
+        OUTCOME_TRY(by_id.set(address_id, *actor));
+      } else {
+        OUTCOME_TRY(by_id.remove(address_id));
+      }
+      actors_[address_id] = actor;
+    }
+    if (journal.count(actor::kInitAddress) != 0) {
+      // registrations may be undone
+      ids_.clear();
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> StateTreeImpl::clearSnapshot() {
+    if (snapshots_.empty()) {
+      return StateTreeError::NO_SNAPSHOT;
+    }
+    auto journal = std::move(snapshots_.back());
+    snapshots_.pop_back();
+    if (!snapshots_.empty()) {
+      // outer checkpoint keeps its own older states
+      snapshots_.back().merge(journal);
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> StateTreeImpl::journal(const Address &address_id) {
+    if (snapshots_.empty() || snapshots_.back().count(address_id) != 0) {
+      return outcome::success();
+    }
+    OUTCOME_TRY(actor, by_id.tryGet(address_id));
+    snapshots_.back().emplace(address_id, std::move(actor));
+    return outcome::success();
+  }
+
+  std::shared_ptr<const StateRootCache> StateTreeImpl::rootCache(
+      const CID &root) {
+    static storage::ipld::NodeCache<StateRootCache> caches{
+        kStateCacheCapacity};
+    static std::mutex mutex;
+    std::lock_guard lock{mutex};
+    auto cache{caches.get(root)};
+    if (!cache) {
+      cache = std::make_shared<const StateRootCache>();
+      caches.put(root, cache);
+    }
+    return cache;
+  }
+
   std::shared_ptr<IpfsDatastore> StateTreeImpl::getStore() {
     return store_;
   }
@@ -8,10 +8,35 @@
 
 #include "vm/state/state_tree.hpp"
 
+#include <mutex>
+#include <unordered_map>
+
 #include "adt/address_key.hpp"
 #include "adt/map.hpp"
+#include "storage/ipld/node_cache.hpp"
 
 namespace fc::vm::state {
+  /// Number of state roots with cached resolutions
+  constexpr size_t kStateCacheCapacity = 64;
+
+  /**
+   * Id addresses and actors resolved at state root. State of root is
+   * immutable, so cache is shared by trees loaded from same root, e.g.
+   * interpreter threads and api contexts of tipset. Filled lazily.
+   */
+  class StateRootCache {
+   public:
+    boost::optional<Address> id(const Address &address) const;
+    void setId(const Address &address, const Address &address_id) const;
+    boost::optional<Actor> actor(const Address &address_id) const;
+    void setActor(const Address &address_id, const Actor &actor) const;
+
+   private:
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<Address, Address> ids_;
+    mutable std::unordered_map<Address, Actor> actors_;
+  };
+
   /// State tree
   class StateTreeImpl : public StateTree {
    public:
@@ -31,12 +56,34 @@ namespace fc::vm::state {
     outcome::result<CID> flush() override;
     /// Revert changes to last flushed state
     outcome::result<void> revert(const CID &root) override;
+    /// Begin nested in-memory checkpoint
+    outcome::result<void> snapshot() override;
+    /// Undo changes made since last checkpoint
+    outcome::result<void> revertSnapshot() override;
+    /// Keep changes made since last checkpoint
+    outcome::result<void> clearSnapshot() override;
     /// Get store
     std::shared_ptr<IpfsDatastore> getStore() override;
 
    private:
+    /// Actor states before first change in checkpoint, none if absent
+    using Journal = std::map<Address, boost::optional<Actor>>;
+
+    /// Record previous actor state in current checkpoint
+    outcome::result<void> journal(const Address &address_id);
+
+    /// Shared cache of state root
+    static std::shared_ptr<const StateRootCache> rootCache(const CID &root);
+
     std::shared_ptr<IpfsDatastore> store_;
     adt::Map<actor::Actor, adt::AddressKeyer> by_id;
+    std::vector<Journal> snapshots_;
+    /// Cache of root tree was loaded from, none for empty tree
+    std::shared_ptr<const StateRootCache> root_cache_;
+    /// Addresses registered since root
+    std::map<Address, Address> ids_;
+    /// Actors set since root, write-through cache of tree
+    std::map<Address, boost::optional<Actor>> actors_;
   };
 }  // namespace fc::vm::state
 
@@ -0,0 +1,166 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/state/impl/state_tree_overlay.hpp"
+
+#include "vm/actor/builtin/init/init_actor.hpp"
+
+namespace fc::vm::state {
+  using actor::builtin::init::InitActorState;
+
+  /// Datastore keeping new blocks in memory and reading others from base
+  class StateTreeOverlay::Store
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<StateTreeOverlay::Store> {
+   public:
+    explicit Store(std::shared_ptr<IpfsDatastore> base)
+        : base{std::move(base)} {}
+
+    outcome::result<bool> contains(const CID &key) const override {
+      if (blocks.count(key) != 0) {
+        return true;
+      }
+      return base->contains(key);
+    }
+
+    outcome::result<void> set(const CID &key, Value value) override {
+      blocks.emplace(key, std::move(value));
+      return outcome::success();
+    }
+
+    outcome::result<Value> get(const CID &key) const override {
+      auto it = blocks.find(key);
+      if (it != blocks.end()) {
+        return it->second;
+      }
+      return base->get(key);
+    }
+
+    /// Removes only new block, base is not modified
+    outcome::result<void> remove(const CID &key) override {
+      blocks.erase(key);
+      return outcome::success();
+    }
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    std::shared_ptr<IpfsDatastore> base;
+    std::map<CID, Value> blocks;
+  };
+
+  StateTreeOverlay::StateTreeOverlay(std::shared_ptr<StateTree> base)
+      : base_{std::move(base)},
+        store_{std::make_shared<Store>(base_->getStore())} {}
+
+  outcome::result<void> StateTreeOverlay::set(const Address &address,
+                                              const Actor &actor) {
+    OUTCOME_TRY(address_id, lookupId(address));
+    if (!snapshots_.empty() && snapshots_.back().count(address_id) == 0) {
+      auto it = writes_.find(address_id);
+      snapshots_.back().emplace(
+          address_id,
+          it == writes_.end() ? boost::none : boost::make_optional(it->second));
+    }
+    writes_[address_id] = actor;
+    return outcome::success();
+  }
+
+  outcome::result<Actor> StateTreeOverlay::get(const Address &address) {
+    OUTCOME_TRY(address_id, lookupId(address));
+    reads_.insert(address_id);
+    auto it = writes_.find(address_id);
+    if (it != writes_.end()) {
+      return it->second;
+    }
+    return base_->get(address_id);
+  }
+
+  outcome::result<Address> StateTreeOverlay::lookupId(const Address &address) {
+    if (address.isId()) {
+      return address;
+    }
+    OUTCOME_TRY(init_actor_state, state<InitActorState>(actor::kInitAddress));
+    OUTCOME_TRY(id, init_actor_state.address_map.get(address));
+    return Address::makeFromId(id);
+  }
+
+  outcome::result<Address> StateTreeOverlay::registerNewAddress(
+      const Address &address) {
+    OUTCOME_TRY(init_actor, get(actor::kInitAddress));
+    OUTCOME_TRY(init_actor_state,
+                store_->getCbor<InitActorState>(init_actor.head));
+    OUTCOME_TRY(address_id, init_actor_state.addActor(address));
+    OUTCOME_TRYA(init_actor.head, store_->setCbor(init_actor_state));
+    OUTCOME_TRY(set(actor::kInitAddress, init_actor));
+    return std::move(address_id);
+  }
+
+  outcome::result<CID> StateTreeOverlay::flush() {
+    return StateTreeError::NOT_SUPPORTED;
+  }
+
+  outcome::result<void> StateTreeOverlay::revert(const CID &root) {
+    return StateTreeError::NOT_SUPPORTED;
+  }
+
+  outcome::result<void> StateTreeOverlay::snapshot() {
+    snapshots_.emplace_back();
+    return outcome::success();
+  }
+
+  outcome::result<void> StateTreeOverlay::revertSnapshot() {
+    if (snapshots_.empty()) {
+      return StateTreeError::NO_SNAPSHOT;
+    }
+    auto journal = std::move(snapshots_.back());
+    snapshots_.pop_back();
+    for (auto &[address_id, actor] : journal) {
+      if (actor) {
+        writes_[address_id] = *actor;
+      } else {
+        writes_.erase(address_id);
+      }
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> StateTreeOverlay::clearSnapshot() {
+    if (snapshots_.empty()) {
+      return StateTreeError::NO_SNAPSHOT;
+    }
+    auto journal = std::move(snapshots_.back());
+    snapshots_.pop_back();
+    if (!snapshots_.empty()) {
+      // outer checkpoint keeps its own older entries
+      snapshots_.back().merge(journal);
+    }
+    return outcome::success();
+  }
+
+  std::shared_ptr<IpfsDatastore> StateTreeOverlay::getStore() {
+    return store_;
+  }
+
+  const std::set<Address> &StateTreeOverlay::reads() const {
+    return reads_;
+  }
+
+  const std::map<Address, Actor> &StateTreeOverlay::writes() const {
+    return writes_;
+  }
+
+  outcome::result<void> StateTreeOverlay::apply(StateTree &tree) const {
+    if (!store_->blocks.empty()) {
+      OUTCOME_TRY(tree.getStore()->setMany(IpfsDatastore::Blocks(
+          store_->blocks.begin(), store_->blocks.end())));
+    }
+    for (auto &[address_id, actor] : writes_) {
+      OUTCOME_TRY(tree.set(address_id, actor));
+    }
+    return outcome::success();
+  }
+}  // namespace fc::vm::state
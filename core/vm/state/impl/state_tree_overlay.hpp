@@ -0,0 +1,77 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_STATE_STATE_TREE_OVERLAY_HPP
+#define CPP_FILECOIN_CORE_VM_STATE_STATE_TREE_OVERLAY_HPP
+
+#include "vm/state/state_tree.hpp"
+
+#include <map>
+#include <set>
+
+#include <boost/optional.hpp>
+
+namespace fc::vm::state {
+
+  /**
+   * State tree keeping changes and new blocks in memory on top of base tree,
+   * which is not modified, and recording actors read. Used to execute
+   * message speculatively and apply its changes later, if actors it read
+   * were not changed meanwhile.
+   */
+  class StateTreeOverlay : public StateTree {
+   public:
+    explicit StateTreeOverlay(std::shared_ptr<StateTree> base);
+
+    outcome::result<void> set(const Address &address,
+                              const Actor &actor) override;
+
+    outcome::result<Actor> get(const Address &address) override;
+
+    /// Lookup reads init actor for non-id address
+    outcome::result<Address> lookupId(const Address &address) override;
+
+    outcome::result<Address> registerNewAddress(
+        const Address &address) override;
+
+    /// Not supported, changes are applied to other tree
+    outcome::result<CID> flush() override;
+
+    /// Not supported
+    outcome::result<void> revert(const CID &root) override;
+
+    outcome::result<void> snapshot() override;
+
+    outcome::result<void> revertSnapshot() override;
+
+    outcome::result<void> clearSnapshot() override;
+
+    /// Get store buffering new blocks
+    std::shared_ptr<IpfsDatastore> getStore() override;
+
+    /// Id addresses of actors read, including reverted reads
+    const std::set<Address> &reads() const;
+
+    /// Changed actors by id address
+    const std::map<Address, Actor> &writes() const;
+
+    /// @brief writes new blocks to store of tree and changed actors to tree
+    outcome::result<void> apply(StateTree &tree) const;
+
+   private:
+    class Store;
+
+    /// Overlay entries before first change in checkpoint, none if absent
+    using Journal = std::map<Address, boost::optional<Actor>>;
+
+    std::shared_ptr<StateTree> base_;
+    std::shared_ptr<Store> store_;
+    std::set<Address> reads_;
+    std::map<Address, Actor> writes_;
+    std::vector<Journal> snapshots_;
+  };
+}  // namespace fc::vm::state
+
+#endif  // CPP_FILECOIN_CORE_VM_STATE_STATE_TREE_OVERLAY_HPP
@@ -0,0 +1,294 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/state/state_analyzer.hpp"
+
+#include <map>
+#include <mutex>
+#include <set>
+
+#include "adt/address_key.hpp"
+#include "adt/map.hpp"
+#include "storage/amt/amt.hpp"
+#include "storage/hamt/hamt.hpp"
+#include "storage/ipld/walker.hpp"
+
+namespace fc::vm::state {
+  namespace {
+    namespace amt = storage::amt;
+    namespace hamt = storage::hamt;
+    using storage::ipld::walker::Walker;
+    using ActorMap = adt::Map<Actor, adt::AddressKeyer>;
+
+    /// Decodes block, adds its entries to shape and returns its links
+    using Children = std::function<outcome::result<std::vector<CID>>(
+        const CID &, gsl::span<const uint8_t>, bool, DagShape &)>;
+
+    void addFanout(DagShape &shape, size_t links) {
+      auto bucket{std::min(links, kMaxFanout)};
+      if (shape.fanout.size() <= bucket) {
+        shape.fanout.resize(bucket + 1);
+      }
+      ++shape.fanout[bucket];
+    }
+
+    DagKind detect(const CID &cid, gsl::span<const uint8_t> bytes) {
+      if (cid.content_type != libp2p::multi::MulticodecType::DAG_CBOR) {
+        return DagKind::DAG;
+      }
+      if (codec::cbor::decode<amt::Root>(bytes)) {
+        return DagKind::AMT;
+      }
+      if (codec::cbor::decode<hamt::Node>(bytes)) {
+        return DagKind::HAMT;
+      }
+      return DagKind::DAG;
+    }
+
+    outcome::result<std::vector<CID>> hamtChildren(
+        const CID &, gsl::span<const uint8_t> bytes, bool, DagShape &shape) {
+      OUTCOME_TRY(node, codec::cbor::decode<hamt::Node>(bytes));
+      std::vector<CID> links;
+      for (auto &item : node.items) {
+        if (auto cid{boost::get<CID>(&item.second)}) {
+          links.push_back(*cid);
+        } else if (auto leaf{boost::get<hamt::Node::Leaf>(&item.second)}) {
+          shape.entries += leaf->size();
+          shape.capacity += hamt::kLeafMax;
+        }
+      }
+      return links;
+    }
+
+    outcome::result<std::vector<CID>> amtChildren(
+        const CID &,
+        gsl::span<const uint8_t> bytes,
+        bool root,
+        DagShape &shape) {
+      amt::Node node;
+      if (root) {
+        OUTCOME_TRY(decoded, codec::cbor::decode<amt::Root>(bytes));
+        node = std::move(decoded.node);
+      } else {
+        OUTCOME_TRYA(node, codec::cbor::decode<amt::Node>(bytes));
+      }
+      std::vector<CID> links;
+      if (auto values{boost::get<amt::Node::Values>(&node.items)}) {
+        shape.entries += values->size();
+        shape.capacity += amt::kWidth;
+      } else {
+        for (auto &item : boost::get<amt::Node::Links>(node.items)) {
+          if (auto cid{boost::get<CID>(&item.second)}) {
+            links.push_back(*cid);
+          }
+        }
+      }
+      return links;
+    }
+
+    outcome::result<std::vector<CID>> dagChildren(
+        const CID &cid, gsl::span<const uint8_t> bytes, bool, DagShape &) {
+      return Walker::links(cid, bytes);
+    }
+
+    /// Walks dag level by level, each block once
+    outcome::result<void> walk(const Ipld &ipld,
+                               const CID &root,
+                               const Children &children,
+                               DagShape &shape) {
+      std::set<CID> visited{root};
+      std::vector<CID> level{root};
+      while (!level.empty()) {
+        std::vector<CID> next;
+        for (auto &cid : level) {
+          OUTCOME_TRY(bytes, ipld.get(cid));
+          ++shape.blocks;
+          shape.bytes += bytes.size();
+          OUTCOME_TRY(links, children(cid, bytes, shape.depth == 0, shape));
+          addFanout(shape, links.size());
+          for (auto &link : links) {
+            if (visited.insert(link).second) {
+              next.push_back(std::move(link));
+            }
+          }
+        }
+        ++shape.depth;
+        level = std::move(next);
+      }
+      return outcome::success();
+    }
+
+    outcome::result<ActorShape> analyzeActor(const Ipld &ipld,
+                                             const Address &address,
+                                             const Actor &actor) {
+      ActorShape shape{address, actor, {}, {}};
+      OUTCOME_TRYA(shape.state, analyzeDag(ipld, actor.head));
+      OUTCOME_TRY(head, ipld.get(actor.head));
+      OUTCOME_TRY(links, Walker::links(actor.head, head));
+      for (auto &link : links) {
+        OUTCOME_TRY(bytes, ipld.get(link));
+        if (detect(link, bytes) != DagKind::DAG) {
+          OUTCOME_TRY(embedded, analyzeDag(ipld, link));
+          shape.embedded.push_back({link, std::move(embedded)});
+        }
+      }
+      return shape;
+    }
+
+    struct Block {
+      size_t size;
+      std::vector<CID> links;
+    };
+    using Blocks = std::map<CID, Block>;
+
+    /**
+     * Collects blocks of dag, blocks of known dag are not loaded, they are
+     * roots of shared subtrees
+     */
+    outcome::result<void> collect(const Ipld &ipld,
+                                  const CID &root,
+                                  Blocks &blocks,
+                                  const Blocks *known = nullptr,
+                                  std::vector<CID> *shared = nullptr) {
+      std::set<CID> visited{root};
+      std::vector<CID> queue{root};
+      while (!queue.empty()) {
+        auto cid{std::move(queue.back())};
+        queue.pop_back();
+        if (known && known->count(cid) != 0) {
+          shared->push_back(std::move(cid));
+          continue;
+        }
+        OUTCOME_TRY(bytes, ipld.get(cid));
+        OUTCOME_TRY(links, Walker::links(cid, bytes));
+        for (auto &link : links) {
+          if (visited.insert(link).second) {
+            queue.push_back(link);
+          }
+        }
+        blocks.emplace(std::move(cid), Block{bytes.size(), std::move(links)});
+      }
+      return outcome::success();
+    }
+
+    outcome::result<ActorShapeDiff> diffActor(const Ipld &ipld,
+                                              const Address &address,
+                                              const Actor *before,
+                                              const Actor *after) {
+      ActorShapeDiff diff{address};
+      Blocks before_blocks, added;
+      std::vector<CID> shared;
+      if (before) {
+        OUTCOME_TRY(collect(ipld, before->head, before_blocks));
+      }
+      if (after) {
+        OUTCOME_TRY(
+            collect(ipld, after->head, added, &before_blocks, &shared));
+      }
+      for (auto &[cid, block] : added) {
+        ++diff.blocks_added;
+        diff.bytes_added += block.size;
+      }
+      // content addressed, so subtrees of shared roots are kept whole
+      std::set<CID> kept{shared.begin(), shared.end()};
+      while (!shared.empty()) {
+        auto cid{std::move(shared.back())};
+        shared.pop_back();
+        for (auto &link : before_blocks.at(cid).links) {
+          if (kept.insert(link).second) {
+            shared.push_back(link);
+          }
+        }
+      }
+      for (auto &[cid, block] : before_blocks) {
+        if (kept.count(cid) == 0) {
+          ++diff.blocks_removed;
+          diff.bytes_removed += block.size;
+        }
+      }
+      return diff;
+    }
+  }  // namespace
+
+  outcome::result<DagShape> analyzeDag(const Ipld &ipld, const CID &root) {
+    DagShape shape;
+    OUTCOME_TRY(bytes, ipld.get(root));
+    shape.kind = detect(root, bytes);
+    switch (shape.kind) {
+      case DagKind::HAMT:
+        OUTCOME_TRY(walk(ipld, root, hamtChildren, shape));
+        break;
+      case DagKind::AMT:
+        OUTCOME_TRY(walk(ipld, root, amtChildren, shape));
+        break;
+      case DagKind::DAG:
+        OUTCOME_TRY(walk(ipld, root, dagChildren, shape));
+        break;
+    }
+    return shape;
+  }
+
+  outcome::result<StateShape> analyzeState(const IpldPtr &ipld,
+                                           const CID &root,
+                                           size_t threads) {
+    StateShape state{root, {}, {}};
+    DagShape actors_hamt;
+    OUTCOME_TRY(walk(*ipld, root, hamtChildren, actors_hamt));
+    actors_hamt.kind = DagKind::HAMT;
+    state.actors_hamt = std::move(actors_hamt);
+    ActorMap actors{root, ipld};
+    std::mutex mutex;
+    OUTCOME_TRY(actors.hamt.visitParallel(
+        [&](auto &key, auto &value) -> outcome::result<void> {
+          OUTCOME_TRY(address, adt::AddressKeyer::decode(key));
+          OUTCOME_TRY(actor, codec::cbor::decode<Actor>(value));
+          OUTCOME_TRY(shape, analyzeActor(*ipld, address, actor));
+          std::lock_guard lock{mutex};
+          state.actors.push_back(std::move(shape));
+          return outcome::success();
+        },
+        false,
+        threads));
+    std::sort(state.actors.begin(),
+              state.actors.end(),
+              [](auto &lhs, auto &rhs) {
+                return lhs.state.bytes > rhs.state.bytes;
+              });
+    return state;
+  }
+
+  outcome::result<StateShapeDiff> diffStateShape(const IpldPtr &ipld,
+                                                 const CID &before,
+                                                 const CID &after) {
+    StateShapeDiff diff;
+    ActorMap before_actors{before, ipld};
+    ActorMap after_actors{after, ipld};
+    OUTCOME_TRY(after_actors.diff(
+        before_actors,
+        [&](auto &address, auto before_actor, auto after_actor)
+            -> outcome::result<void> {
+          if (!before_actor) {
+            ++diff.actors_added;
+          } else if (!after_actor) {
+            ++diff.actors_removed;
+          } else {
+            ++diff.actors_changed;
+            if (before_actor->head == after_actor->head) {
+              return outcome::success();
+            }
+          }
+          OUTCOME_TRY(actor_diff,
+                      diffActor(*ipld, address, before_actor, after_actor));
+          diff.actors.push_back(std::move(actor_diff));
+          return outcome::success();
+        }));
+    std::sort(diff.actors.begin(),
+              diff.actors.end(),
+              [](auto &lhs, auto &rhs) {
+                return lhs.bytes_added > rhs.bytes_added;
+              });
+    return diff;
+  }
+}  // namespace fc::vm::state
@@ -0,0 +1,105 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_CORE_VM_STATE_STATE_ANALYZER_HPP
+#define CPP_FILECOIN_CORE_VM_STATE_STATE_ANALYZER_HPP
+
+#include "storage/ipfs/datastore.hpp"
+#include "storage/ipld/visit_parallel.hpp"
+#include "vm/actor/actor.hpp"
+
+namespace fc::vm::state {
+  using actor::Actor;
+  using primitives::address::Address;
+
+  /// Structure of dag, detected by decoding its root
+  enum class DagKind { DAG, HAMT, AMT };
+
+  /// Nodes with more child links are counted in last fanout bucket
+  constexpr size_t kMaxFanout{64};
+
+  /// Size and shape of dag, each block is counted once
+  struct DagShape {
+    DagKind kind{DagKind::DAG};
+    uint64_t blocks{};
+    uint64_t bytes{};
+    /// Blocks on longest path from root, 1 for single block
+    uint64_t depth{};
+    /// Number of nodes by count of child links
+    std::vector<uint64_t> fanout;
+    /// Hamt bucket entries or amt leaf values, zero for plain dag
+    uint64_t entries{};
+    /// Max entries of hamt buckets or amt leaves, entries / capacity is
+    /// leaf occupancy
+    uint64_t capacity{};
+  };
+
+  /// Shape of hamt or amt linked from actor state
+  struct EmbeddedShape {
+    CID root;
+    DagShape shape;
+  };
+
+  struct ActorShape {
+    Address address;
+    Actor actor;
+    /// Whole dag of actor head
+    DagShape state;
+    /// Hamts and amts of head block, also counted in state
+    std::vector<EmbeddedShape> embedded;
+  };
+
+  struct StateShape {
+    CID root;
+    /// Hamt of actors, without actor states
+    DagShape actors_hamt;
+    /// Sorted by state bytes, largest first
+    std::vector<ActorShape> actors;
+  };
+
+  /// Blocks of actor state dag added and removed between two states
+  struct ActorShapeDiff {
+    Address address;
+    uint64_t blocks_added{};
+    uint64_t bytes_added{};
+    uint64_t blocks_removed{};
+    uint64_t bytes_removed{};
+  };
+
+  struct StateShapeDiff {
+    uint64_t actors_added{};
+    uint64_t actors_removed{};
+    uint64_t actors_changed{};
+    /// Sorted by bytes added, largest first
+    std::vector<ActorShapeDiff> actors;
+  };
+
+  /**
+   * Walks dag, as hamt or amt if its root decodes as one, otherwise by
+   * links of every block
+   */
+  outcome::result<DagShape> analyzeDag(const Ipld &ipld, const CID &root);
+
+  /**
+   * Reports size and shape of every actor state and its embedded hamts and
+   * amts. Actors are read by parallel visit, each actor dag is walked by
+   * thread which visited it.
+   */
+  outcome::result<StateShape> analyzeState(
+      const IpldPtr &ipld,
+      const CID &root,
+      size_t threads = storage::ipld::kVisitThreads);
+
+  /**
+   * Reports changed actors between two state roots, with blocks of their
+   * state dags which are not in other state. Unchanged actors are skipped
+   * by hamt diff.
+   */
+  outcome::result<StateShapeDiff> diffStateShape(const IpldPtr &ipld,
+                                                 const CID &before,
+                                                 const CID &after);
+}  // namespace fc::vm::state
+
+#endif  // CPP_FILECOIN_CORE_VM_STATE_STATE_ANALYZER_HPP
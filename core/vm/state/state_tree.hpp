@@ -7,9 +7,14 @@
 #define CPP_FILECOIN_CORE_VM_STATE_STATE_TREE_HPP
 
 #include "storage/ipfs/datastore.hpp"
+#include "storage/ipld/lazy_tuple.hpp"
 #include "vm/actor/actor.hpp"
 
 namespace fc::vm::state {
+  enum class StateTreeError {
+    NO_SNAPSHOT = 1,
+    NOT_SUPPORTED,
+  };
 
   using actor::Actor;
   using primitives::address::Address;
@@ -39,6 +44,18 @@ namespace fc::vm::state {
     /// Revert changes to last flushed state
     virtual outcome::result<void> revert(const CID &root) = 0;
 
+    /**
+     * Begin nested in-memory checkpoint.
+     * Changes made after it can be undone without flushing to storage.
+     */
+    virtual outcome::result<void> snapshot() = 0;
+
+    /// Undo changes made since last checkpoint and discard it
+    virtual outcome::result<void> revertSnapshot() = 0;
+
+    /// Keep changes made since last checkpoint and discard it
+    virtual outcome::result<void> clearSnapshot() = 0;
+
     /// Get store
     virtual std::shared_ptr<IpfsDatastore> getStore() = 0;
 
@@ -48,7 +65,16 @@ namespace fc::vm::state {
       OUTCOME_TRY(actor, get(address));
       return getStore()->template getCbor<T>(actor.head);
     }
+
+    /// Get actor state with fields decoded on access
+    outcome::result<storage::ipld::LazyTuple> lazyState(
+        const Address &address) {
+      OUTCOME_TRY(actor, get(address));
+      return storage::ipld::LazyTuple::load(getStore(), actor.head);
+    }
   };
 }  // namespace fc::vm::state
 
+OUTCOME_HPP_DECLARE_ERROR(fc::vm::state, StateTreeError);
+
 #endif  // CPP_FILECOIN_CORE_VM_STATE_STATE_TREE_HPP
@@ -0,0 +1,71 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "api/rpc/cbor.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/outcome.hpp"
+
+using fc::api::Response;
+using fc::api::rpc::Buffer;
+using fc::api::rpc::CborRequest;
+using fc::api::rpc::CborResponse;
+using fc::api::rpc::decodeParams;
+using fc::api::rpc::encodeParams;
+using fc::api::rpc::is_cbor;
+using fc::codec::cbor::decode;
+using fc::codec::cbor::encode;
+
+struct NoCodec {};
+
+static_assert(is_cbor<std::tuple<uint64_t, std::string>>{});
+static_assert(is_cbor<std::vector<Buffer>>{});
+static_assert(!is_cbor<std::vector<NoCodec>>{});
+static_assert(!is_cbor<std::tuple<uint64_t, NoCodec>>{});
+
+/// Params are encoded as list and decoded back
+TEST(ApiCborTest, Params) {
+  std::tuple<uint64_t, std::string> expected{3, "a"};
+  EXPECT_OUTCOME_TRUE(encoded, encodeParams(expected));
+  std::tuple<uint64_t, std::string> params;
+  EXPECT_OUTCOME_TRUE_1(decodeParams(encoded, params));
+  EXPECT_EQ(params, expected);
+
+  std::tuple<uint64_t> wrong;
+  EXPECT_OUTCOME_ERROR(fc::codec::cbor::CborDecodeError::WRONG_SIZE,
+                       decodeParams(encoded, wrong));
+}
+
+/// Request keeps params encoded
+TEST(ApiCborTest, Request) {
+  EXPECT_OUTCOME_TRUE(params, encodeParams(std::make_tuple(uint64_t{1})));
+  EXPECT_OUTCOME_TRUE(encoded,
+                      encode(CborRequest{7, "Filecoin.ChainHead", params}));
+  EXPECT_OUTCOME_TRUE(request, decode<CborRequest>(encoded));
+  EXPECT_EQ(request.id, 7);
+  EXPECT_EQ(request.method, "Filecoin.ChainHead");
+  EXPECT_EQ(request.params, params);
+}
+
+/// Response carries result or error
+TEST(ApiCborTest, Response) {
+  EXPECT_OUTCOME_TRUE(result, encode(std::string{"r"}));
+  EXPECT_OUTCOME_TRUE(encoded, encode(CborResponse{1, {}, result}));
+  EXPECT_OUTCOME_TRUE(response, decode<CborResponse>(encoded));
+  EXPECT_EQ(response.id, 1);
+  EXPECT_FALSE(response.error);
+  EXPECT_EQ(response.result, result);
+
+  EXPECT_OUTCOME_TRUE(
+      encoded2,
+      encode(CborResponse{2, Response::Error{-1, "failed"}, {}}));
+  EXPECT_OUTCOME_TRUE(response2, decode<CborResponse>(encoded2));
+  EXPECT_EQ(response2.id, 2);
+  ASSERT_TRUE(response2.error);
+  EXPECT_EQ(response2.error->code, -1);
+  EXPECT_EQ(response2.error->message, "failed");
+  EXPECT_TRUE(response2.result.empty());
+}
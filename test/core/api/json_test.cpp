@@ -100,6 +100,13 @@ TEST(ApiJsonTest, Address) {
              "\"t2gncvesv7no7bqckesisllfzmif4qw3hs6fyf3iy\"");
 }
 
+/// Page token is opaque bytes, empty after last page
+TEST(ApiJsonTest, AddressPage) {
+  expectJson(fc::api::AddressPage{{Address::makeFromId(1)}, Buffer{1}},
+             "{\"Addresses\":[\"t01\"],\"Next\":\"AQ==\"}");
+  expectJson(fc::api::AddressPage{}, "{\"Addresses\":[],\"Next\":\"\"}");
+}
+
 TEST(ApiJsonTest, Signature) {
   expectJson(Signature{BlsSignature{b96}}, "{\"Type\":2,\"Data\":" J96 "}");
   expectJson(Signature{Secp256k1Signature{b65}},
@@ -174,3 +181,41 @@ TEST(ApiJsonTest, MsgWait) {
       "},\"Timestamp\":8,\"BlockSig\":{\"Type\":1,\"Data\":" J65
       "},\"ForkSignaling\":9}],\"Height\":3}}");
 }
+
+TEST(ApiJsonTest, WorkerInfo) {
+  expectJson(fc::primitives::sector::SectorId{1, 2},
+             "{\"Miner\":1,\"Number\":2}");
+  fc::api::WorkerInfo info;
+  info.hostname = "worker";
+  info.resources.physical_memory = 4;
+  info.resources.swap_memory = 3;
+  info.resources.reserved_memory = 2;
+  info.resources.cpus = 1;
+  info.resources.gpus = {"gpu"};
+  expectJson(info,
+             "{\"Hostname\":\"worker\",\"Resources\":{\"MemPhysical\":4,"
+             "\"MemSwap\":3,\"MemReserved\":2,\"CPUs\":1,\"GPUs\":[\"gpu\"]}}");
+}
+
+/// Streamed rpc messages are equal to encoded ones
+TEST(ApiJsonTest, WriteMessages) {
+  auto written = [](auto &message) {
+    rapidjson::StringBuffer buffer;
+    auto writer = rapidjson::Writer<rapidjson::StringBuffer>{buffer};
+    fc::api::write(writer, message);
+    return std::string{buffer.GetString(), buffer.GetSize()};
+  };
+  fc::api::Request request{3, "Chain.Head", jsonDecode("[1,\"a\"]")};
+  EXPECT_EQ(written(request), jsonEncode(fc::api::encode(request)));
+  fc::api::Response result{UINT64_C(3), fc::api::encode(Buffer{b32})};
+  EXPECT_EQ(written(result), jsonEncode(fc::api::encode(result)));
+  EXPECT_EQ(written(result),
+            "{\"jsonrpc\":\"2.0\",\"id\":3,\"result\":" J32 "}");
+  fc::api::Response error{{}, fc::api::Response::Error{-1, "error"}};
+  EXPECT_EQ(written(error), jsonEncode(fc::api::encode(error)));
+  fc::api::Response encoded{
+      UINT64_C(3), std::make_shared<const std::string>("[1,{\"a\":2}]")};
+  EXPECT_EQ(written(encoded), jsonEncode(fc::api::encode(encoded)));
+  EXPECT_EQ(written(encoded),
+            "{\"jsonrpc\":\"2.0\",\"id\":3,\"result\":[1,{\"a\":2}]}");
+}
@@ -0,0 +1,198 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/chain_exchange/chain_exchange_server.hpp"
+
+#include <gtest/gtest.h>
+#include "storage/chain/impl/chain_store_impl.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/blockchain/block_validator/block_validator_mock.hpp"
+#include "testutil/mocks/blockchain/weight_calculator_mock.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/peer_id.hpp"
+#include "vm/message/message.hpp"
+
+namespace fc::blockchain::chain_exchange {
+  using block_validator::BlockValidatorMock;
+  using primitives::BigInt;
+  using primitives::address::Address;
+  using primitives::block::BlockHeader;
+  using primitives::block::MsgMeta;
+  using primitives::ticket::Ticket;
+  using storage::blockchain::ChainStoreImpl;
+  using storage::ipfs::InMemoryDatastore;
+  using vm::message::SignedMessage;
+  using vm::message::UnsignedMessage;
+  using weight::WeightCalculatorMock;
+
+  /// Decoded tipset bundle of response
+  struct Bundle {
+    std::vector<BlockHeader> blocks;
+    std::vector<UnsignedMessage> bls_messages;
+    std::vector<std::vector<uint64_t>> bls_includes;
+    std::vector<SignedMessage> secp_messages;
+    std::vector<std::vector<uint64_t>> secp_includes;
+  };
+  CBOR_TUPLE(
+      Bundle, blocks, bls_messages, bls_includes, secp_messages, secp_includes)
+
+  struct Response {
+    std::vector<Bundle> chain;
+    ResponseStatus status;
+    std::string message;
+  };
+  CBOR_TUPLE(Response, chain, status, message)
+
+  class ChainExchangeServerTest : public ::testing::Test {
+   public:
+    void SetUp() override {
+      EXPECT_CALL(*weight_calculator, calculateWeight(testing::_))
+          .WillRepeatedly(testing::Invoke(
+              [](auto &tipset) { return BigInt{tipset.height}; }));
+      EXPECT_OUTCOME_TRUE(
+          store,
+          ChainStoreImpl::create(ipld,
+                                 std::make_shared<BlockValidatorMock>(),
+                                 weight_calculator));
+      chain_store = store;
+      server = std::make_shared<ChainExchangeServer>(
+          nullptr, chain_store, ipld, ChainExchangeConfig{kMaxLength});
+
+      std::vector<CID> parents;
+      for (uint64_t height = 0; height < kHeight; ++height) {
+        parents = addBlock(parents, height);
+      }
+    }
+
+    /// Adds block with one bls message of nonce equal to height
+    std::vector<CID> addBlock(const std::vector<CID> &parents,
+                              uint64_t height) {
+      UnsignedMessage message;
+      message.from = Address::makeFromId(100);
+      message.to = Address::makeFromId(101);
+      message.nonce = height;
+      EXPECT_OUTCOME_TRUE(message_cid, ipld->setCbor(message));
+      MsgMeta meta;
+      ipld->load(meta);
+      EXPECT_OUTCOME_TRUE_1(meta.bls_messages.append(message_cid));
+      EXPECT_OUTCOME_TRUE(messages, ipld->setCbor(meta));
+      BlockHeader block;
+      block.miner = Address::makeFromId(1);
+      block.ticket = Ticket{};
+      block.parents = parents;
+      block.height = height;
+      block.parent_state_root = "010001020001"_cid;
+      block.parent_message_receipts = "010001020002"_cid;
+      block.messages = messages;
+      EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(block));
+      EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(block));
+      return {cid};
+    }
+
+    Response serve(const Request &request) {
+      EXPECT_OUTCOME_TRUE(encoded, server->serve(peer, request));
+      EXPECT_OUTCOME_TRUE(response, codec::cbor::decode<Response>(*encoded));
+      return response;
+    }
+
+    std::vector<CID> head() {
+      EXPECT_OUTCOME_TRUE(head, chain_store->heaviestTipset());
+      return head.cids;
+    }
+
+    static constexpr uint64_t kHeight{5};
+    static constexpr uint64_t kMaxLength{3};
+
+    std::shared_ptr<InMemoryDatastore> ipld{
+        std::make_shared<InMemoryDatastore>()};
+    std::shared_ptr<WeightCalculatorMock> weight_calculator{
+        std::make_shared<WeightCalculatorMock>()};
+    std::shared_ptr<ChainStoreImpl> chain_store;
+    std::shared_ptr<ChainExchangeServer> server;
+    PeerId peer{generatePeerId(1)};
+  };
+
+  /**
+   * @given chain of tipsets with one message each
+   * @when headers and messages of two tipsets back from head are requested
+   * @then response decodes to head and its parent, with their messages
+   */
+  TEST_F(ChainExchangeServerTest, HeadersAndMessages) {
+    auto response{serve({head(), 2, kBlocks | kMessages})};
+    EXPECT_EQ(response.status, ResponseStatus::OK);
+    ASSERT_EQ(response.chain.size(), 2);
+    for (auto i{0u}; i < response.chain.size(); ++i) {
+      auto &bundle{response.chain[i]};
+      auto height{kHeight - 1 - i};
+      ASSERT_EQ(bundle.blocks.size(), 1);
+      EXPECT_EQ(bundle.blocks[0].height, height);
+      ASSERT_EQ(bundle.bls_messages.size(), 1);
+      EXPECT_EQ(bundle.bls_messages[0].nonce, height);
+      EXPECT_EQ(bundle.bls_includes,
+                (std::vector<std::vector<uint64_t>>{{0}}));
+      EXPECT_TRUE(bundle.secp_messages.empty());
+    }
+  }
+
+  /**
+   * @given chain of tipsets
+   * @when only headers are requested
+   * @then bundles have empty message lists
+   */
+  TEST_F(ChainExchangeServerTest, HeadersOnly) {
+    auto response{serve({head(), 1, kBlocks})};
+    EXPECT_EQ(response.status, ResponseStatus::OK);
+    ASSERT_EQ(response.chain.size(), 1);
+    EXPECT_EQ(response.chain[0].blocks.size(), 1);
+    EXPECT_TRUE(response.chain[0].bls_messages.empty());
+  }
+
+  /**
+   * @given server limiting length of segments
+   * @when longer segment is requested
+   * @then segment of limit length is served as partial
+   */
+  TEST_F(ChainExchangeServerTest, RangeLimit) {
+    auto response{serve({head(), kMaxLength + 1, kBlocks})};
+    EXPECT_EQ(response.status, ResponseStatus::PARTIAL);
+    ASSERT_EQ(response.chain.size(), kMaxLength);
+    EXPECT_EQ(response.chain.back().blocks[0].height, kHeight - kMaxLength);
+  }
+
+  /**
+   * @given chain of tipsets
+   * @when segment longer than chain is requested from tipset near genesis
+   * @then segment ends at genesis
+   */
+  TEST_F(ChainExchangeServerTest, EndsAtGenesis) {
+    auto genesis_child{serve({head(), kMaxLength, kBlocks})
+                           .chain.back()
+                           .blocks[0]
+                           .parents};
+    auto response{serve({genesis_child, kMaxLength, kBlocks})};
+    EXPECT_EQ(response.status, ResponseStatus::OK);
+    ASSERT_EQ(response.chain.size(), kHeight - kMaxLength);
+    EXPECT_EQ(response.chain.back().blocks[0].height, 0);
+  }
+
+  /**
+   * @given chain of tipsets
+   * @when segment from unknown tipset or bad request is served
+   * @then response has error status and no tipsets
+   */
+  TEST_F(ChainExchangeServerTest, Errors) {
+    auto unknown{serve({{"010001020009"_cid}, 1, kBlocks})};
+    EXPECT_EQ(unknown.status, ResponseStatus::NOT_FOUND);
+    EXPECT_TRUE(unknown.chain.empty());
+
+    auto empty{serve({{}, 1, kBlocks})};
+    EXPECT_EQ(empty.status, ResponseStatus::BAD_REQUEST);
+    EXPECT_TRUE(empty.chain.empty());
+
+    auto no_options{serve({head(), 1, 0})};
+    EXPECT_EQ(no_options.status, ResponseStatus::BAD_REQUEST);
+  }
+}  // namespace fc::blockchain::chain_exchange
@@ -43,6 +43,14 @@ class GasPricedScoredMessageStorageTest : public testing::Test {
       "8e8c5263df0022d8e29cab943d57d851722c38ee1dbe7f8c29c0498156496f29"_blob32;
   SignedMessage message =
       signMessageBls(unsigned_message, bls_private_key).value();
+
+  SignedMessage makeMessage(const Address &sender,
+                            uint64_t nonce,
+                            const BigInt &gas_price) {
+    UnsignedMessage unsigned_message{
+        0, to, sender, nonce, BigInt(1), gas_price, 1, MethodNumber{0}, {}};
+    return signMessageBls(unsigned_message, bls_private_key).value();
+  }
 };
 
 /**
@@ -162,3 +170,82 @@ TEST_F(GasPricedScoredMessageStorageTest, SunnyDay) {
   ASSERT_EQ(top[1].message.gasPrice, gas_price2);
   ASSERT_EQ(top[2].message.gasPrice, gas_price1);
 }
+
+/**
+ * @given MessageStorage with expensive message after cheap one of the same
+ * sender, and message of another sender
+ * @when select messages is called
+ * @then messages of each sender are selected in nonce order
+ */
+TEST_F(GasPricedScoredMessageStorageTest, SelectMessages) {
+  Address other{Network::TESTNET, 1003};
+  EXPECT_OUTCOME_TRUE_1(message_storage.put(makeMessage(from, 0, 1)));
+  EXPECT_OUTCOME_TRUE_1(message_storage.put(makeMessage(from, 1, 5)));
+  EXPECT_OUTCOME_TRUE_1(message_storage.put(makeMessage(other, 7, 3)));
+  // gap, can not be selected
+  EXPECT_OUTCOME_TRUE_1(message_storage.put(makeMessage(other, 9, 10)));
+
+  auto selected = message_storage.selectMessages(10);
+  ASSERT_EQ(selected.size(), 3u);
+  EXPECT_EQ(selected[0].message.from, other);
+  EXPECT_EQ(selected[1].message.nonce, 0u);
+  EXPECT_EQ(selected[2].message.nonce, 1u);
+
+  EXPECT_EQ(message_storage.selectMessages(1)[0].message.from, other);
+}
+
+/**
+ * @given full MessageStorage
+ * @when cheap and expensive messages are added
+ * @then cheap message is rejected, expensive one evicts the cheapest message
+ * and later messages of its sender
+ */
+TEST_F(GasPricedScoredMessageStorageTest, EvictCheapest) {
+  GasPriceScoredMessageStorage storage{3};
+  Address other{Network::TESTNET, 1003};
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(from, 0, 2)));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(from, 1, 1)));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(from, 2, 4)));
+
+  EXPECT_OUTCOME_ERROR(MessagePoolError::MESSAGE_POOL_FULL,
+                       storage.put(makeMessage(other, 0, 1)));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(other, 0, 3)));
+
+  auto selected = storage.selectMessages(10);
+  ASSERT_EQ(selected.size(), 2u);
+  EXPECT_EQ(selected[0].message.from, other);
+  EXPECT_EQ(selected[1].message.from, from);
+  EXPECT_EQ(selected[1].message.nonce, 0u);
+  EXPECT_EQ(storage.size(), 2u);
+}
+
+/**
+ * @given MessageStorage which evicted messages of sender
+ * @when messages of sender past evicted nonce, evicted nonce and after it are
+ * added
+ * @then message past gap is rejected until evicted nonce is resubmitted, and
+ * all stored messages are selectable
+ */
+TEST_F(GasPricedScoredMessageStorageTest, RejectAfterEvictionGap) {
+  GasPriceScoredMessageStorage storage{4};
+  Address other{Network::TESTNET, 1003};
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(from, 0, 2)));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(from, 1, 1)));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(other, 0, 3)));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(other, 1, 3)));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(other, 2, 3)));
+  EXPECT_EQ(storage.size(), 4u);
+
+  EXPECT_OUTCOME_ERROR(MessagePoolError::MESSAGE_POOL_FULL,
+                       storage.put(makeMessage(from, 2, 10)));
+  EXPECT_OUTCOME_ERROR(MessagePoolError::MESSAGE_POOL_FULL,
+                       storage.put(makeMessage(from, 3, 10)));
+  EXPECT_EQ(storage.size(), 4u);
+
+  storage.remove(makeMessage(other, 1, 3));
+  storage.remove(makeMessage(other, 2, 3));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(from, 1, 5)));
+  EXPECT_OUTCOME_TRUE_1(storage.put(makeMessage(from, 2, 10)));
+  EXPECT_EQ(storage.size(), 4u);
+  EXPECT_EQ(storage.selectMessages(10).size(), 4u);
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/production/message_selector.hpp"
+
+#include <gtest/gtest.h>
+
+#include "blockchain/message_pool/impl/gas_price_scored_message_storage.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/vm/message/message_test_util.hpp"
+
+using fc::blockchain::message_pool::GasPriceScoredMessageStorage;
+using fc::blockchain::production::MessageSelector;
+using fc::primitives::BigInt;
+using fc::primitives::GasAmount;
+using fc::primitives::address::Address;
+using fc::primitives::address::Network;
+using fc::vm::message::MethodNumber;
+using fc::vm::message::SignedMessage;
+using fc::vm::message::UnsignedMessage;
+
+class MessageSelectorTest : public testing::Test {
+ public:
+  void put(const Address &from,
+           uint64_t nonce,
+           const BigInt &gas_price,
+           GasAmount gas_limit) {
+    UnsignedMessage message{
+        0, to, from, nonce, BigInt(1), gas_price, gas_limit, MethodNumber{0},
+        {}};
+    EXPECT_OUTCOME_TRUE_1(storage->put(
+        signMessageBls(message, bls_private_key).value()));
+  }
+
+  std::shared_ptr<GasPriceScoredMessageStorage> storage{
+      std::make_shared<GasPriceScoredMessageStorage>()};
+  MessageSelector selector{storage};
+
+  Address to{Network::TESTNET, 1000};
+  Address alice{Network::TESTNET, 1001};
+  Address bob{Network::TESTNET, 1002};
+  Address carol{Network::TESTNET, 1003};
+  std::array<uint8_t, 32> bls_private_key =
+      "8e8c5263df0022d8e29cab943d57d851722c38ee1dbe7f8c29c0498156496f29"_blob32;
+};
+
+/**
+ * @given messages of three senders
+ * @when messages are selected with gas limit
+ * @then sender whose message does not fit is skipped, smaller messages of
+ * other senders fill the block
+ */
+TEST_F(MessageSelectorTest, GasLimit) {
+  put(alice, 0, 5, 60);
+  put(alice, 1, 4, 10);
+  put(bob, 0, 3, 50);
+  put(bob, 1, 1, 10);
+  put(carol, 0, 2, 30);
+
+  MessageSelector::Limits limits;
+  limits.gas_limit = 100;
+  auto selection = selector.select(limits);
+  ASSERT_EQ(selection.messages.size(), 3u);
+  EXPECT_EQ(selection.messages[0].message.from, alice);
+  EXPECT_EQ(selection.messages[1].message.from, alice);
+  EXPECT_EQ(selection.messages[2].message.from, carol);
+  EXPECT_EQ(selection.gas_used, 100);
+  EXPECT_FALSE(selection.timed_out);
+  EXPECT_EQ(selector.latency().count, 1u);
+}
+
+/**
+ * @given pending messages
+ * @when messages are selected after deadline
+ * @then selection is stopped and counted as timed out
+ */
+TEST_F(MessageSelectorTest, Deadline) {
+  put(alice, 0, 1, 10);
+
+  MessageSelector::Limits limits;
+  limits.deadline = MessageSelector::Clock::now();
+  auto selection = selector.select(limits);
+  EXPECT_TRUE(selection.messages.empty());
+  EXPECT_TRUE(selection.timed_out);
+  EXPECT_EQ(selector.timeouts(), 1u);
+
+  EXPECT_EQ(selector.select(std::chrono::seconds{1}).messages.size(), 1u);
+}
@@ -0,0 +1,149 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/impl/checkpoint_sync.hpp"
+
+#include <gtest/gtest.h>
+#include "storage/chain/impl/chain_store_impl.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/blockchain/block_validator/block_validator_mock.hpp"
+#include "testutil/mocks/blockchain/weight_calculator_mock.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::blockchain::sync_manager {
+  using block_validator::BlockValidatorMock;
+  using primitives::BigInt;
+  using primitives::address::Address;
+  using primitives::block::BlockHeader;
+  using primitives::ticket::Ticket;
+  using storage::blockchain::ChainStoreImpl;
+  using storage::ipfs::InMemoryDatastore;
+  using testing::_;
+  using testing::Return;
+  using weight::WeightCalculatorMock;
+
+  class CheckpointSyncTest : public ::testing::Test {
+   public:
+    void SetUp() override {
+      EXPECT_CALL(*weight_calculator, calculateWeight(_))
+          .WillRepeatedly(testing::Invoke(
+              [](auto &tipset) { return BigInt{tipset.height}; }));
+      EXPECT_CALL(*validator, validateBlock(_, _))
+          .WillRepeatedly(Return(outcome::success()));
+      EXPECT_OUTCOME_TRUE(
+          store, ChainStoreImpl::create(ipld, validator, weight_calculator));
+      chain_store = store;
+
+      EXPECT_OUTCOME_TRUE(root, ipld->setCbor(std::string{"state"}));
+      state_root = root;
+      auto genesis{makeTipset({}, 0, 0)};
+      auto ts1{makeTipset(genesis.cids, 1, 0)};
+      checkpoint = makeTipset(ts1.cids, 2, 0);
+      // sibling of checkpoint, other fork
+      fork = makeTipset(ts1.cids, 2, 1);
+    }
+
+    /// Stores tipset of one block in ipld
+    Tipset makeTipset(const std::vector<CID> &parents,
+                      uint64_t height,
+                      uint64_t fork) {
+      BlockHeader block;
+      block.miner = Address::makeFromId(1);
+      block.ticket = Ticket{};
+      block.parents = parents;
+      block.height = height;
+      // distinguishes blocks of forks at same height
+      block.timestamp = fork;
+      block.parent_state_root = state_root;
+      block.parent_message_receipts = "010001020002"_cid;
+      block.messages = "010001020003"_cid;
+      EXPECT_OUTCOME_TRUE_1(ipld->setCbor(block));
+      EXPECT_OUTCOME_TRUE(tipset, Tipset::create({block}));
+      return tipset;
+    }
+
+    std::shared_ptr<CheckpointSync> makeSync(const Tipset &tipset) {
+      return std::make_shared<CheckpointSync>(
+          ipld,
+          chain_store,
+          validator,
+          Checkpoint{tipset.makeKey().value(), state_root});
+    }
+
+    std::shared_ptr<InMemoryDatastore> ipld{
+        std::make_shared<InMemoryDatastore>()};
+    std::shared_ptr<BlockValidatorMock> validator{
+        std::make_shared<BlockValidatorMock>()};
+    std::shared_ptr<WeightCalculatorMock> weight_calculator{
+        std::make_shared<WeightCalculatorMock>()};
+    std::shared_ptr<ChainStoreImpl> chain_store;
+    CID state_root;
+    Tipset checkpoint;
+    Tipset fork;
+  };
+
+  /**
+   * @given checkpoint headers and state imported before
+   * @when sync resumes and descendants of checkpoint are applied
+   * @then head starts at checkpoint and follows applied descendants
+   */
+  TEST_F(CheckpointSyncTest, StartsFromCheckpoint) {
+    auto sync{makeSync(checkpoint)};
+    EXPECT_OUTCOME_EQ(sync->resume(), true);
+    EXPECT_OUTCOME_TRUE(head, chain_store->heaviestTipset());
+    EXPECT_EQ(head.cids, checkpoint.cids);
+    EXPECT_OUTCOME_EQ(sync->known(checkpoint.makeKey().value()), true);
+
+    auto ts3{makeTipset(checkpoint.cids, 3, 0)};
+    auto ts4{makeTipset(ts3.cids, 4, 0)};
+    EXPECT_OUTCOME_TRUE_1(sync->apply(ts3));
+    EXPECT_OUTCOME_TRUE_1(sync->apply(ts4));
+    EXPECT_OUTCOME_TRUE(new_head, chain_store->heaviestTipset());
+    EXPECT_EQ(new_head.cids, ts4.cids);
+  }
+
+  /**
+   * @given sync resumed from checkpoint
+   * @when tipsets of fork from below checkpoint are applied
+   * @then they are rejected and head stays at checkpoint
+   */
+  TEST_F(CheckpointSyncTest, RejectsOtherFork) {
+    auto sync{makeSync(checkpoint)};
+    EXPECT_OUTCOME_EQ(sync->resume(), true);
+
+    auto fork3{makeTipset(fork.cids, 3, 1)};
+    auto fork4{makeTipset(fork3.cids, 4, 1)};
+    // fork headers are stored, as if fetched by sync
+    EXPECT_OUTCOME_ERROR(CheckpointSyncError::BEFORE_CHECKPOINT,
+                         sync->apply(fork));
+    EXPECT_OUTCOME_ERROR(CheckpointSyncError::NOT_DESCENDANT,
+                         sync->apply(fork3));
+    EXPECT_OUTCOME_ERROR(CheckpointSyncError::NOT_DESCENDANT,
+                         sync->apply(fork4));
+    EXPECT_OUTCOME_TRUE(head, chain_store->heaviestTipset());
+    EXPECT_EQ(head.cids, checkpoint.cids);
+  }
+
+  /**
+   * @given checkpoint which headers or state are not imported
+   * @when sync resumes
+   * @then it reports fallback to sync from genesis and chain store is empty
+   */
+  TEST_F(CheckpointSyncTest, FallsBackWhenMissing) {
+    Tipset missing;
+    missing.cids = {"010001020009"_cid};
+    missing.height = 2;
+    EXPECT_OUTCOME_EQ(makeSync(missing)->resume(), false);
+
+    auto sync{std::make_shared<CheckpointSync>(
+        ipld,
+        chain_store,
+        validator,
+        Checkpoint{checkpoint.makeKey().value(), "010001020008"_cid})};
+    EXPECT_OUTCOME_EQ(sync->resume(), false);
+    EXPECT_FALSE(chain_store->heaviestTipset());
+  }
+}  // namespace fc::blockchain::sync_manager
@@ -0,0 +1,414 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+#include <spdlog/fmt/fmt.h>
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "blockchain/impl/sync_pipeline.hpp"
+#include "core/storage/ipfs/graphsync/graphsync_acceptance_common.hpp"
+#include "storage/ipfs/impl/concurrent_datastore.hpp"
+#include "storage/ipld/walker.hpp"
+
+using fc::CID;
+using fc::IpldPtr;
+using fc::outcome::result;
+using fc::blockchain::sync_manager::ChainFetcher;
+using fc::blockchain::sync_manager::SyncPipeline;
+using fc::blockchain::sync_manager::SyncPipelineConfig;
+using fc::blockchain::sync_manager::SyncPipelineError;
+using fc::common::Buffer;
+using fc::crypto::signature::BlsSignature;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetKey;
+using fc::storage::ipfs::ConcurrentDatastore;
+using fc::storage::ipfs::graphsync::Graphsync;
+using fc::storage::ipfs::graphsync::MerkleDagBridge;
+using fc::storage::ipfs::graphsync::ResponseStatusCode;
+using fc::storage::ipfs::graphsync::Subscription;
+using fc::storage::ipld::Selector;
+using fc::storage::ipld::walker::Walker;
+using fc::vm::message::SignedMessage;
+using fc::vm::message::UnsignedMessage;
+using libp2p::multi::Multiaddress;
+using libp2p::peer::PeerId;
+
+namespace {
+  constexpr size_t kTipsets{1000};
+  constexpr size_t kBlocksPerTipset{2};
+  constexpr size_t kMessagesPerBlock{20};
+  /// Position of parents in BlockHeader tuple
+  constexpr uint64_t kParentsField{5};
+
+  /// Pre-generated chain served by peers
+  struct Chain {
+    std::shared_ptr<ConcurrentDatastore> ipld;
+    /// Ascending height, first is genesis
+    std::vector<Tipset> tipsets;
+  };
+
+  /// Linear chain, each block has own messages
+  result<Chain> generateChain() {
+    Chain chain;
+    chain.ipld = std::make_shared<ConcurrentDatastore>();
+    OUTCOME_TRY(empty, chain.ipld->setCbor(std::vector<CID>{}));
+    for (uint64_t height{0}; height < kTipsets; ++height) {
+      std::vector<BlockHeader> blocks;
+      for (uint64_t index{0}; index < kBlocksPerTipset; ++index) {
+        MsgMeta meta;
+        chain.ipld->load(meta);
+        for (uint64_t i{0}; i < kMessagesPerBlock; ++i) {
+          SignedMessage message{
+              UnsignedMessage{0,
+                              Address::makeFromId(1000),
+                              Address::makeFromId(100 + index),
+                              height * kMessagesPerBlock + i,
+                              1000,
+                              100,
+                              1000000,
+                              0,
+                              Buffer(64, i)},
+              BlsSignature{}};
+          OUTCOME_TRY(cid, chain.ipld->setCbor(message));
+          OUTCOME_TRY(meta.secp_messages.append(cid));
+        }
+        BlockHeader block;
+        block.miner = Address::makeFromId(100 + index);
+        block.election_proof = {Buffer(96, index)};
+        if (!chain.tipsets.empty()) {
+          block.parents = chain.tipsets.back().cids;
+        }
+        block.height = height;
+        block.parent_state_root = empty;
+        block.parent_message_receipts = empty;
+        OUTCOME_TRYA(block.messages, chain.ipld->setCbor(meta));
+        block.timestamp = height * 30;
+        block.block_sig = BlsSignature{};
+        OUTCOME_TRY(chain.ipld->setCbor(block));
+        blocks.push_back(std::move(block));
+      }
+      OUTCOME_TRY(tipset, Tipset::create(std::move(blocks)));
+      chain.tipsets.push_back(std::move(tipset));
+    }
+    return chain;
+  }
+
+  /// Peer latency and bandwidth
+  struct Shaping {
+    /// Delay before response to each request
+    std::chrono::milliseconds latency{};
+    /// Bytes of blocks sent per second, unlimited if zero
+    size_t bytes_per_second{};
+
+    void send(size_t bytes) const {
+      if (bytes_per_second != 0) {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds{bytes * 1000000 / bytes_per_second});
+      }
+    }
+  };
+
+  /**
+   * Serves blocks matched by selectors from datastore. Shaping delays event
+   * loop of serving node, so it applies to that peer only.
+   */
+  class ShapedBridge : public MerkleDagBridge {
+   public:
+    ShapedBridge(IpldPtr ipld, Shaping shaping)
+        : ipld_{std::move(ipld)}, shaping_{shaping} {}
+
+    result<size_t> select(
+        const CID &cid,
+        gsl::span<const uint8_t> selector,
+        std::function<bool(const CID &, const Buffer &)> handler)
+        const override {
+      auto decoded{Selector::matcher()};
+      if (!selector.empty()) {
+        OUTCOME_TRYA(decoded, fc::codec::cbor::decode<Selector>(selector));
+      }
+      std::this_thread::sleep_for(shaping_.latency);
+      size_t count{0};
+      Walker walker{*ipld_};
+      OUTCOME_TRY(walker.select(
+          cid, decoded, [&](auto &block, auto &bytes) -> result<void> {
+            shaping_.send(bytes.size());
+            ++count;
+            handler(block, bytes);
+            return fc::outcome::success();
+          }));
+      return count;
+    }
+
+    result<Buffer> getBlock(const CID &cid) const override {
+      OUTCOME_TRY(bytes, ipld_->get(cid));
+      shaping_.send(bytes.size());
+      return std::move(bytes);
+    }
+
+   private:
+    IpldPtr ipld_;
+    Shaping shaping_;
+  };
+
+  /// Libp2p host with graphsync, running own event loop thread
+  struct Node {
+    Node(std::shared_ptr<MerkleDagBridge> bridge,
+         Graphsync::BlockCallback on_block,
+         boost::optional<Multiaddress> listen = boost::none)
+        : io{std::make_shared<boost::asio::io_context>()},
+          work{io->get_executor()} {
+      std::tie(graphsync, host) =
+          fc::storage::ipfs::graphsync::test::createNodeObjects(io);
+      if (listen) {
+        host->listen(*listen).value();
+      }
+      graphsync->start(std::move(bridge), std::move(on_block));
+      host->start();
+      thread = std::thread{[io{io}] { io->run(); }};
+    }
+
+    ~Node() {
+      boost::asio::post(*io, [this] {
+        graphsync->stop();
+        host->stop();
+        io->stop();
+      });
+      thread.join();
+    }
+
+    std::shared_ptr<boost::asio::io_context> io;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+        work;
+    std::shared_ptr<Graphsync> graphsync;
+    std::shared_ptr<libp2p::Host> host;
+    std::thread thread;
+  };
+
+  /**
+   * Fetches headers and messages with graphsync requests of syncing node.
+   * Headers are requested with recursive selector over parents, messages
+   * with selector of whole dag.
+   */
+  class GraphsyncChainFetcher : public ChainFetcher {
+   public:
+    GraphsyncChainFetcher(Node &node,
+                          IpldPtr ipld,
+                          std::map<PeerId, Multiaddress> addresses)
+        : node_{node},
+          ipld_{std::move(ipld)},
+          addresses_{std::move(addresses)} {}
+
+    result<std::vector<Tipset>> fetchHeaders(const PeerId &peer,
+                                             const TipsetKey &head,
+                                             size_t count) override {
+      std::vector<std::future<ResponseStatusCode>> requests;
+      auto parents{Selector::exploreRecursive(
+          count - 1,
+          Selector::exploreIndex(
+              kParentsField,
+              Selector::exploreAll(Selector::exploreRecursiveEdge())))};
+      for (auto &cid : head.cids) {
+        requests.push_back(request(
+            peer, cid, cid == head.cids[0] ? parents : Selector::matcher()));
+      }
+      OUTCOME_TRY(wait(requests));
+      std::vector<Tipset> tipsets;
+      OUTCOME_TRY(tipset, Tipset::load(*ipld_, head.cids));
+      tipsets.push_back(std::move(tipset));
+      while (tipsets.size() < count && tipsets.back().height != 0) {
+        auto parent{tipsets.back().loadParent(*ipld_)};
+        if (!parent) {
+          break;
+        }
+        tipsets.push_back(std::move(parent.value()));
+      }
+      return tipsets;
+    }
+
+    result<void> fetchMessages(const PeerId &peer,
+                               gsl::span<const Tipset> tipsets) override {
+      std::vector<std::future<ResponseStatusCode>> requests;
+      for (auto &tipset : tipsets) {
+        for (auto &block : tipset.blks) {
+          requests.push_back(request(peer, block.messages, Selector{}));
+        }
+      }
+      return wait(requests);
+    }
+
+   private:
+    /// Makes request on event loop of node, future is set on completion
+    std::future<ResponseStatusCode> request(const PeerId &peer,
+                                            const CID &cid,
+                                            const Selector &selector) {
+      auto promise{std::make_shared<std::promise<ResponseStatusCode>>()};
+      auto future{promise->get_future()};
+      boost::asio::post(
+          *node_.io,
+          [this, peer, cid, promise, bytes{selector.encode().data()}] {
+            auto id{next_id_++};
+            auto it{addresses_.find(peer)};
+            auto address{it == addresses_.end()
+                             ? boost::none
+                             : boost::make_optional(it->second)};
+            subscriptions_[id] = node_.graphsync->makeRequest(
+                peer,
+                address,
+                cid,
+                bytes,
+                {},
+                [this, id, promise](ResponseStatusCode status, auto) {
+                  if (!fc::storage::ipfs::graphsync::isTerminal(status)) {
+                    return;
+                  }
+                  promise->set_value(status);
+                  // subscription can't be destroyed from its callback
+                  boost::asio::post(*node_.io,
+                                    [this, id] { subscriptions_.erase(id); });
+                });
+          });
+      return future;
+    }
+
+    static result<void> wait(
+        std::vector<std::future<ResponseStatusCode>> &requests) {
+      auto ok{true};
+      for (auto &request : requests) {
+        ok &= fc::storage::ipfs::graphsync::isSuccess(request.get());
+      }
+      if (!ok) {
+        return SyncPipelineError::EMPTY_RESPONSE;
+      }
+      return fc::outcome::success();
+    }
+
+    Node &node_;
+    IpldPtr ipld_;
+    std::map<PeerId, Multiaddress> addresses_;
+    /// Accessed on event loop only
+    std::map<uint64_t, Subscription> subscriptions_;
+    uint64_t next_id_{};
+  };
+
+  /// User and system time of process, serving peers included
+  double cpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    auto seconds{[](const timeval &time) {
+      return static_cast<double>(time.tv_sec) + time.tv_usec / 1e6;
+    }};
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+  }
+
+  /// Listen ports of serving peers, not reused by later runs
+  uint16_t next_port{42000};
+}  // namespace
+
+/**
+ * One node syncs pre-generated chain from scratch with SyncPipeline from
+ * peers on loopback. Arguments are number of peers, latency of each peer
+ * and its bandwidth in KiB/s, zero is unlimited.
+ */
+void SyncChain(benchmark::State &state) {
+  static auto chain{generateChain()};
+  if (!chain) {
+    state.SkipWithError(chain.error().message().c_str());
+    return;
+  }
+  auto &genesis{chain.value().tipsets.front()};
+  auto &head{chain.value().tipsets.back()};
+  Shaping shaping{std::chrono::milliseconds{state.range(1)},
+                  static_cast<size_t>(state.range(2)) * 1024};
+  std::vector<std::unique_ptr<Node>> peers;
+  std::map<PeerId, Multiaddress> addresses;
+  for (auto i{0}; i < state.range(0); ++i) {
+    auto address{
+        Multiaddress::create(fmt::format("/ip4/127.0.0.1/tcp/{}", next_port++))
+            .value()};
+    peers.push_back(std::make_unique<Node>(
+        std::make_shared<ShapedBridge>(chain.value().ipld, shaping),
+        [](auto, auto) {},
+        address));
+    addresses.emplace(peers.back()->host->getId(), address);
+  }
+
+  std::atomic_size_t blocks{0};
+  std::atomic_size_t bytes{0};
+  std::atomic_size_t headers{0};
+  double cpu{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto ipld{std::make_shared<ConcurrentDatastore>()};
+    auto client{std::make_unique<Node>(
+        std::make_shared<ShapedBridge>(ipld, Shaping{}),
+        [&, ipld](CID cid, Buffer data) {
+          ++blocks;
+          bytes += data.size();
+          ipld->set(cid, std::move(data)).value();
+        })};
+    auto fetcher{
+        std::make_shared<GraphsyncChainFetcher>(*client, ipld, addresses)};
+    auto pipeline{std::make_unique<SyncPipeline>(
+        fetcher,
+        [&](const TipsetKey &key) -> result<bool> {
+          return key.cids == genesis.cids;
+        },
+        [&](const Tipset &tipset) -> result<void> {
+          for (auto &block : tipset.blks) {
+            OUTCOME_TRY(has, ipld->contains(block.messages));
+            if (!has) {
+              return SyncPipelineError::EMPTY_RESPONSE;
+            }
+          }
+          headers += tipset.blks.size();
+          return fc::outcome::success();
+        },
+        SyncPipelineConfig{})};
+    for (auto &[peer, _] : addresses) {
+      pipeline->addPeer(peer);
+    }
+    auto cpu_start{cpuSeconds()};
+    state.ResumeTiming();
+
+    auto result{pipeline->sync(head)};
+
+    state.PauseTiming();
+    cpu += cpuSeconds() - cpu_start;
+    // pipeline requests use client node
+    pipeline.reset();
+    client.reset();
+    state.ResumeTiming();
+    if (!result) {
+      state.SkipWithError(result.error().message().c_str());
+      break;
+    }
+  }
+
+  using benchmark::Counter;
+  state.counters["headers_per_second"] =
+      Counter(headers.load(), Counter::kIsRate);
+  state.counters["blocks_per_second"] =
+      Counter(blocks.load(), Counter::kIsRate);
+  state.counters["bytes_per_second"] =
+      Counter(bytes.load(), Counter::kIsRate);
+  state.counters["cpu_seconds"] = Counter(cpu, Counter::kAvgIterations);
+}
+BENCHMARK(SyncChain)
+    ->ArgNames({"peers", "latency_ms", "bandwidth_kib"})
+    ->Args({1, 0, 0})
+    ->Args({4, 0, 0})
+    ->Args({4, 20, 0})
+    ->Args({4, 20, 1024})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
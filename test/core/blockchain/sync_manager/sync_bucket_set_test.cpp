@@ -45,10 +45,30 @@ struct SyncBucketSetTest : public SyncTargetBucketTest {
 
 /** check insert tipset */
 TEST_F(SyncBucketSetTest, InsertTipsetSuccess) {
-  bucket_set1->insert(tipset2);
+  auto child_block = bh1;
+  child_block.parents = tipset1.cids;
+  child_block.parent_weight = BigInt(5);
+  child_block.height = 5;
+  EXPECT_OUTCOME_TRUE(child, Tipset::create({child_block}));
+  bucket_set1->insert(child);
   auto &bs = bucket_set1->getBuckets();
   ASSERT_EQ(bs.size(), 1);
   ASSERT_EQ(bs[0].tipsets.size(), 2);
+  EXPECT_OUTCOME_TRUE(heaviest, bucket_set1->getHeaviestTipset());
+  ASSERT_EQ(heaviest, child);
+}
+
+/** tipset with same parents is other chain and gets own bucket */
+TEST_F(SyncBucketSetTest, InsertSiblingToNewBucket) {
+  bucket_set1->insert(tipset2);
+  auto &bs = bucket_set1->getBuckets();
+  ASSERT_EQ(bs.size(), 2);
+  EXPECT_OUTCOME_TRUE(heaviest, bucket_set1->getHeaviestTipset());
+  ASSERT_EQ(heaviest, tipset2);
+  EXPECT_OUTCOME_TRUE(related, bucket_set1->popRelated(tipset1));
+  ASSERT_EQ(related, bucket1);
+  ASSERT_EQ(bucket_set1->getSize(), 1);
+  EXPECT_OUTCOME_TRUE_1(bucket_set1->isRelatedToAny(tipset2));
 }
 
 TEST_F(SyncBucketSetTest, AppendTipsetSuccess) {
@@ -0,0 +1,195 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "blockchain/impl/sync_pipeline.hpp"
+
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include "testutil/outcome.hpp"
+#include "testutil/peer_id.hpp"
+
+using fc::blockchain::sync_manager::ChainFetcher;
+using fc::blockchain::sync_manager::SyncPipeline;
+using fc::blockchain::sync_manager::SyncPipelineConfig;
+using fc::blockchain::sync_manager::SyncPipelineError;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::tipset::Tipset;
+using fc::primitives::tipset::TipsetKey;
+
+/**
+ * Serves linear chain, fails requests to bad peer
+ */
+class ChainFetcherFake : public ChainFetcher {
+ public:
+  ChainFetcherFake(size_t length, PeerId bad_peer)
+      : bad_peer{std::move(bad_peer)} {
+    for (uint64_t height = 0; height < length; ++height) {
+      BlockHeader block;
+      block.height = height;
+      if (height != 0) {
+        block.parents = chain.back().cids;
+      }
+      Tipset tipset;
+      tipset.cids = {fc::common::getCidOf(Buffer(1, height)).value()};
+      tipset.blks = {block};
+      tipset.height = height;
+      chain.push_back(tipset);
+    }
+  }
+
+  fc::outcome::result<std::vector<Tipset>> fetchHeaders(
+      const PeerId &peer, const TipsetKey &head, size_t count) override {
+    if (peer == bad_peer) {
+      return SyncPipelineError::EMPTY_RESPONSE;
+    }
+    std::vector<Tipset> tipsets;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+      if (!tipsets.empty() || it->cids == head.cids) {
+        tipsets.push_back(*it);
+        if (tipsets.size() == count) {
+          break;
+        }
+      }
+    }
+    return tipsets;
+  }
+
+  fc::outcome::result<void> fetchMessages(
+      const PeerId &peer, gsl::span<const Tipset> tipsets) override {
+    if (peer == bad_peer) {
+      return SyncPipelineError::EMPTY_RESPONSE;
+    }
+    std::lock_guard lock{mutex};
+    for (auto &tipset : tipsets) {
+      fetched.insert(tipset.height);
+    }
+    return fc::outcome::success();
+  }
+
+  PeerId bad_peer;
+  std::vector<Tipset> chain;
+  std::mutex mutex;
+  std::set<uint64_t> fetched;
+};
+
+class SyncPipelineTest : public testing::Test {
+ public:
+  SyncPipelineTest() {
+    SyncPipelineConfig config;
+    config.header_window = 4;
+    config.message_window = 3;
+    config.threads = 4;
+    pipeline = std::make_unique<SyncPipeline>(
+        fetcher,
+        [this](auto &key) -> fc::outcome::result<bool> {
+          for (uint64_t height = 0; height <= kKnownHeight; ++height) {
+            if (fetcher->chain[height].cids == key.cids) {
+              return true;
+            }
+          }
+          return false;
+        },
+        [this](auto &tipset) -> fc::outcome::result<void> {
+          EXPECT_EQ(fetcher->fetched.count(tipset.height), 1u);
+          applied.push_back(tipset.height);
+          return fc::outcome::success();
+        },
+        config);
+  }
+
+  static constexpr uint64_t kLength{30};
+  static constexpr uint64_t kKnownHeight{2};
+
+  PeerId good_peer{generatePeerId(1)};
+  std::shared_ptr<ChainFetcherFake> fetcher{
+      std::make_shared<ChainFetcherFake>(kLength, generatePeerId(2))};
+  std::vector<uint64_t> applied;
+  std::unique_ptr<SyncPipeline> pipeline;
+};
+
+/**
+ * @given chain with known prefix and good and bad peers
+ * @when sync to chain head
+ * @then every unknown tipset is fetched and applied in ascending order
+ */
+TEST_F(SyncPipelineTest, Sync) {
+  pipeline->addPeer(fetcher->bad_peer);
+  pipeline->addPeer(good_peer);
+
+  EXPECT_OUTCOME_TRUE_1(pipeline->sync(fetcher->chain.back()));
+  std::vector<uint64_t> expected;
+  for (auto height = kKnownHeight + 1; height < kLength; ++height) {
+    expected.push_back(height);
+  }
+  EXPECT_EQ(applied, expected);
+}
+
+/**
+ * @given pipeline without peers
+ * @when sync is called
+ * @then NO_PEERS error is returned
+ */
+TEST_F(SyncPipelineTest, NoPeers) {
+  EXPECT_OUTCOME_ERROR(SyncPipelineError::NO_PEERS,
+                       pipeline->sync(fetcher->chain.back()));
+}
+
+/**
+ * @given pipeline with validate, execute and commit stages
+ * @when sync to chain head
+ * @then every tipset is validated before execution, executed and committed
+ * in ascending order
+ */
+TEST_F(SyncPipelineTest, Stages) {
+  std::mutex mutex;
+  std::set<uint64_t> validated;
+  std::vector<uint64_t> executed, committed;
+  SyncPipelineConfig config;
+  config.header_window = 4;
+  config.message_window = 3;
+  config.threads = 4;
+  config.commit_batch = 2;
+  SyncPipeline staged{
+      fetcher,
+      [this](auto &key) -> fc::outcome::result<bool> {
+        for (uint64_t height = 0; height <= kKnownHeight; ++height) {
+          if (fetcher->chain[height].cids == key.cids) {
+            return true;
+          }
+        }
+        return false;
+      },
+      {[&](auto &tipset) -> fc::outcome::result<void> {
+         std::lock_guard lock{mutex};
+         validated.insert(tipset.height);
+         return fc::outcome::success();
+       },
+       [&](auto &tipset) -> fc::outcome::result<void> {
+         std::lock_guard lock{mutex};
+         EXPECT_EQ(validated.count(tipset.height), 1u);
+         executed.push_back(tipset.height);
+         return fc::outcome::success();
+       },
+       [&](auto tipsets) -> fc::outcome::result<void> {
+         EXPECT_LE(tipsets.size(), 2);
+         std::lock_guard lock{mutex};
+         for (auto &tipset : tipsets) {
+           committed.push_back(tipset.height);
+         }
+         return fc::outcome::success();
+       }},
+      config};
+  staged.addPeer(good_peer);
+
+  EXPECT_OUTCOME_TRUE_1(staged.sync(fetcher->chain.back()));
+  std::vector<uint64_t> expected;
+  for (auto height = kKnownHeight + 1; height < kLength; ++height) {
+    expected.push_back(height);
+  }
+  EXPECT_EQ(executed, expected);
+  EXPECT_EQ(committed, expected);
+}
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 #include "blockchain/block_validator/impl/block_validator_impl.hpp"
+#include "blockchain/block_validator/impl/syntax_rules.hpp"
 #include "clock/impl/chain_epoch_clock_impl.hpp"
 #include "power/impl/power_table_impl.hpp"
 #include "testutil/literals.hpp"
@@ -104,3 +105,42 @@ TEST_F(BlockValidatorTest, ValidateCorrectBlock) {
       getCorrectBlockHeader(),
       {fc::blockchain::block_validator::scenarios::Stage::SYNTAX_BV0}));
 }
+
+/**
+ * @given Tipset blocks, one of them with invalid timestamp
+ * @when Validating blocks together
+ * @then Correct blocks are valid, invalid block error is reported,
+ * stage latency is recorded
+ */
+TEST_F(BlockValidatorTest, ValidateBlocks) {
+  using fc::blockchain::block_validator::SyntaxError;
+  using fc::blockchain::block_validator::scenarios::Stage;
+  std::vector<BlockHeader> blocks(3, getCorrectBlockHeader());
+  EXPECT_OUTCOME_TRUE_1(
+      validator_->validateBlocks(blocks, {Stage::SYNTAX_BV0}));
+  EXPECT_EQ(validator_->stageLatency(Stage::SYNTAX_BV0).count, 3u);
+  EXPECT_EQ(validator_->stageLatency(Stage::CONSENSUS_BV1).count, 0u);
+
+  blocks[1].timestamp = 0;
+  EXPECT_OUTCOME_ERROR(SyntaxError::INVALID_TIMESTAMP,
+                       validator_->validateBlocks(blocks, {Stage::SYNTAX_BV0}));
+}
+
+/**
+ * @given Block which passed syntax stage
+ * @when Validating it again
+ * @then Stage is skipped, validation still succeeds
+ */
+TEST_F(BlockValidatorTest, SkipsPassedStages) {
+  using fc::blockchain::block_validator::scenarios::Stage;
+  auto block = getCorrectBlockHeader();
+  EXPECT_OUTCOME_TRUE_1(validator_->validateBlock(block, {Stage::SYNTAX_BV0}));
+  EXPECT_EQ(validator_->stageLatency(Stage::SYNTAX_BV0).count, 1u);
+  EXPECT_OUTCOME_TRUE_1(validator_->validateBlock(block, {Stage::SYNTAX_BV0}));
+  EXPECT_EQ(validator_->stageLatency(Stage::SYNTAX_BV0).count, 1u);
+
+  block.timestamp = 0;
+  EXPECT_OUTCOME_ERROR(
+      fc::blockchain::block_validator::SyntaxError::INVALID_TIMESTAMP,
+      validator_->validateBlock(block, {Stage::SYNTAX_BV0}));
+}
@@ -35,8 +35,8 @@ struct Params {
   Weight expected_weight;
 };
 
-fc::outcome::result<Weight> calculateWeight(const Params &params) {
-  auto ipld = std::make_shared<InMemoryDatastore>();
+Tipset makeTipset(const std::shared_ptr<InMemoryDatastore> &ipld,
+                  const Params &params) {
   auto some_cid = "010001020001"_cid;
   StoragePowerActorState state;
   ipld->load(state);
@@ -78,8 +78,12 @@ fc::outcome::result<Weight> calculateWeight(const Params &params) {
            {},
        }},
       {}};
+  return tipset;
+}
 
-  return WeightCalculatorImpl{ipld}.calculateWeight(tipset);
+fc::outcome::result<Weight> calculateWeight(const Params &params) {
+  auto ipld = std::make_shared<InMemoryDatastore>();
+  return WeightCalculatorImpl{ipld}.calculateWeight(makeTipset(ipld, params));
 }
 
 struct WeightCalculatorTest : ::testing::TestWithParam<Params> {};
@@ -89,6 +93,25 @@ TEST_F(WeightCalculatorTest, ZeroNetworkPower) {
                        calculateWeight({{}, 0, 1, {}}));
 }
 
+/**
+ * @given weight calculated for tipset
+ * @when power actor state is no longer available
+ * @then weight of tipset with same parent state uses cached network power
+ */
+TEST_F(WeightCalculatorTest, CachedNetworkPower) {
+  auto ipld = std::make_shared<InMemoryDatastore>();
+  Params params{100, 200, 1, 2071};
+  auto tipset = makeTipset(ipld, params);
+  WeightCalculatorImpl calculator{ipld};
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(tipset), params.expected_weight);
+
+  StateTreeImpl state_tree{ipld, tipset.getParentStateRoot()};
+  EXPECT_OUTCOME_TRUE(actor, state_tree.get(kStoragePowerAddress));
+  EXPECT_OUTCOME_TRUE_1(ipld->remove(actor.head));
+  EXPECT_OUTCOME_EQ(calculator.calculateWeight(tipset), params.expected_weight);
+  EXPECT_FALSE(WeightCalculatorImpl{ipld}.calculateWeight(tipset));
+}
+
 TEST_P(WeightCalculatorTest, Success) {
   auto &params = GetParam();
   EXPECT_OUTCOME_EQ(calculateWeight(params), params.expected_weight);
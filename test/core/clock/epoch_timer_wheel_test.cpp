@@ -0,0 +1,93 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "clock/epoch_timer_wheel.hpp"
+
+#include <gtest/gtest.h>
+
+using fc::clock::ChainEpoch;
+using fc::clock::EpochTimerWheel;
+using fc::clock::kWheelSlotBits;
+
+/**
+ * @given timers at epochs of different wheel levels
+ * @when advance to last epoch
+ * @then each timer fires at its epoch, in order
+ */
+TEST(EpochTimerWheelTest, FiresAtEpoch) {
+  EpochTimerWheel wheel{10};
+  std::vector<ChainEpoch> epochs{11, 12, 73, 74, 200, 5000, 300000, 20000000};
+  std::vector<ChainEpoch> fired;
+  for (auto it = epochs.rbegin(); it != epochs.rend(); ++it) {
+    wheel.schedule(*it, [&](auto scheduled, auto now) {
+      EXPECT_EQ(scheduled, now);
+      fired.push_back(scheduled);
+    });
+  }
+  EXPECT_EQ(wheel.size(), epochs.size());
+  EXPECT_EQ(wheel.advance(epochs.back()), epochs.size());
+  EXPECT_EQ(fired, epochs);
+  EXPECT_EQ(wheel.size(), 0);
+  EXPECT_EQ(wheel.stats().fired, epochs.size());
+  EXPECT_EQ(wheel.stats().late, 0);
+}
+
+/**
+ * @given timers
+ * @when advance jumps over their epochs
+ * @then they fire late, lateness is counted
+ */
+TEST(EpochTimerWheelTest, Lateness) {
+  EpochTimerWheel wheel;
+  std::vector<std::pair<ChainEpoch, ChainEpoch>> fired;
+  for (auto epoch : {3, 100, 1000}) {
+    wheel.schedule(epoch, [&](auto scheduled, auto now) {
+      fired.emplace_back(scheduled, now);
+    });
+  }
+  EXPECT_EQ(wheel.advance(2000), 3);
+  EXPECT_EQ(fired,
+            (std::vector<std::pair<ChainEpoch, ChainEpoch>>{
+                {3, 3}, {100, 100}, {1000, 1000}}));
+  EXPECT_EQ(wheel.stats().late, 0);
+
+  // passed epoch fires on next advance
+  wheel.schedule(1500, [&](auto scheduled, auto now) {
+    fired.emplace_back(scheduled, now);
+  });
+  EXPECT_EQ(wheel.advance(2000), 1);
+  EXPECT_EQ(fired.back(), std::make_pair(ChainEpoch{1500}, ChainEpoch{2000}));
+  EXPECT_EQ(wheel.stats().late, 1);
+  EXPECT_EQ(wheel.stats().max_lateness, 500);
+}
+
+/**
+ * @given scheduled timers
+ * @when some are cancelled, also from callback
+ * @then only others fire
+ */
+TEST(EpochTimerWheelTest, Cancel) {
+  EpochTimerWheel wheel;
+  std::vector<ChainEpoch> fired;
+  auto callback = [&](auto scheduled, auto) { fired.push_back(scheduled); };
+  auto id1 = wheel.schedule(5, callback);
+  auto id2 = wheel.schedule(1 << (2 * kWheelSlotBits), callback);
+  EpochTimerWheel::TimerId id3{};
+  wheel.schedule(5, [&](auto scheduled, auto) {
+    EXPECT_TRUE(wheel.cancel(id3));
+    // scheduled by callback at current epoch, fires on next advance
+    wheel.schedule(scheduled, callback);
+  });
+  id3 = wheel.schedule(5, callback);
+  EXPECT_TRUE(wheel.cancel(id1));
+  EXPECT_FALSE(wheel.cancel(id1));
+  EXPECT_EQ(wheel.advance(5), 1);
+  EXPECT_TRUE(fired.empty());
+  EXPECT_TRUE(wheel.cancel(id2));
+  EXPECT_EQ(wheel.advance(6), 1);
+  EXPECT_EQ(fired, std::vector<ChainEpoch>{5});
+  EXPECT_EQ(wheel.advance(1 << 20), 0);
+  EXPECT_EQ(wheel.current(), 1 << 20);
+}
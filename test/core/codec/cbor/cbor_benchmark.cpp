@@ -0,0 +1,131 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "primitives/block/block.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "vm/actor/builtin/miner/policy.hpp"
+#include "vm/actor/builtin/miner/types.hpp"
+#include "vm/message/message.hpp"
+
+using fc::codec::cbor::decode;
+using fc::codec::cbor::encode;
+using fc::common::Buffer;
+using fc::crypto::signature::BlsSignature;
+using fc::primitives::RleBitset;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::message::SignedMessage;
+using fc::vm::message::UnsignedMessage;
+using MinerState = fc::vm::actor::builtin::miner::State;
+
+namespace {
+  BlockHeader blockHeader() {
+    BlockHeader block;
+    block.miner = Address::makeFromId(1000);
+    block.ticket = fc::primitives::block::Ticket{};
+    block.election_proof = {Buffer(96, 2)};
+    block.beacon_entries = {{4, Buffer(96, 3)}};
+    block.win_post_proof = {
+        {fc::primitives::sector::RegisteredProof::StackedDRG32GiBSeal,
+         Buffer(192, 4)}};
+    block.parents = {"010001020002"_cid, "010001020003"_cid};
+    block.parent_weight = 123456789;
+    block.height = 100000;
+    block.parent_state_root = "010001020005"_cid;
+    block.parent_message_receipts = "010001020006"_cid;
+    block.messages = "010001020007"_cid;
+    block.bls_aggregate = BlsSignature{};
+    block.timestamp = 1600000000;
+    block.block_sig = BlsSignature{};
+    return block;
+  }
+
+  SignedMessage signedMessage() {
+    return {UnsignedMessage{0,
+                            Address::makeFromId(1),
+                            Address::makeFromId(2),
+                            3,
+                            1000000,
+                            100,
+                            1000000,
+                            2,
+                            Buffer(64, 5)},
+            BlsSignature{}};
+  }
+
+  /// Miner state with fragmented sector sets, amts are flushed
+  MinerState minerState(std::shared_ptr<InMemoryDatastore> store) {
+    MinerState state{};
+    store->load(state);
+    state.info.owner = Address::makeFromId(1);
+    state.info.worker = Address::makeFromId(2);
+    RleBitset::Runs runs;
+    for (uint64_t i{0}; i < 1000; ++i) {
+      runs.push_back({i * 100, 90});
+    }
+    state.new_sectors = RleBitset{runs};
+    state.fault_set = state.new_sectors.slice(0, 10000);
+    state.recoveries = state.new_sectors.slice(0, 1000);
+    fc::vm::actor::builtin::miner::Deadlines deadlines;
+    deadlines.due.resize(fc::vm::actor::builtin::miner::kWPoStPeriodDeadlines,
+                         state.new_sectors);
+    state.deadlines = store->setCbor(deadlines).value();
+    // flush amts and hamts, so state encodes as is
+    store->setCbor(state).value();
+    return state;
+  }
+
+  template <typename T>
+  void encodeValue(benchmark::State &state, const T &value) {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(encode(value).value());
+    }
+  }
+
+  template <typename T>
+  void decodeValue(benchmark::State &state, const T &value) {
+    auto bytes{encode(value).value()};
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(decode<T>(bytes).value());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+  }
+}  // namespace
+
+void EncodeBlockHeader(benchmark::State &state) {
+  encodeValue(state, blockHeader());
+}
+BENCHMARK(EncodeBlockHeader);
+
+void DecodeBlockHeader(benchmark::State &state) {
+  decodeValue(state, blockHeader());
+}
+BENCHMARK(DecodeBlockHeader);
+
+void EncodeSignedMessage(benchmark::State &state) {
+  encodeValue(state, signedMessage());
+}
+BENCHMARK(EncodeSignedMessage);
+
+void DecodeSignedMessage(benchmark::State &state) {
+  decodeValue(state, signedMessage());
+}
+BENCHMARK(DecodeSignedMessage);
+
+void EncodeMinerState(benchmark::State &state) {
+  encodeValue(state, minerState(std::make_shared<InMemoryDatastore>()));
+}
+BENCHMARK(EncodeMinerState);
+
+void DecodeMinerState(benchmark::State &state) {
+  decodeValue(state, minerState(std::make_shared<InMemoryDatastore>()));
+}
+BENCHMARK(DecodeMinerState);
+
+BENCHMARK_MAIN();
@@ -63,6 +63,17 @@ TEST(Cbor, BigInt) {
   EXPECT_OUTCOME_EQ(decode<BigInt>("40"_unhex), 0);
 }
 
+/** BigInt larger than inline storage has same encoding */
+TEST(Cbor, BigIntLarge) {
+  using fc::primitives::BigInt;
+  BigInt large{BigInt{0xCAFE} << 300};
+  EXPECT_OUTCOME_TRUE(encoded, encode(-large));
+  std::vector<uint8_t> expected{1};
+  export_bits(large, std::back_inserter(expected), 8);
+  EXPECT_OUTCOME_EQ(decode<std::vector<uint8_t>>(encoded), expected);
+  EXPECT_OUTCOME_EQ(decode<BigInt>(encoded), -large);
+}
+
 /** Null CBOR encoding and decoding */
 TEST(Cbor, Null) {
   EXPECT_OUTCOME_EQ(encode(nullptr), "F6"_unhex);
@@ -114,6 +125,72 @@ TEST(CborEncoder, Integral) {
   EXPECT_OUTCOME_EQ(encode(true), "F5"_unhex);
 }
 
+/**
+ * @given Integers, bytes and lists with arguments of every head size
+ * @when Encode
+ * @then Shortest heads are written
+ */
+TEST(CborEncoder, HeadSizes) {
+  EXPECT_OUTCOME_EQ(encode(255), "18FF"_unhex);
+  EXPECT_OUTCOME_EQ(encode(256), "190100"_unhex);
+  EXPECT_OUTCOME_EQ(encode(1000000), "1A000F4240"_unhex);
+  EXPECT_OUTCOME_EQ(encode(std::numeric_limits<uint64_t>::max()),
+                    "1BFFFFFFFFFFFFFFFF"_unhex);
+  EXPECT_OUTCOME_EQ(encode(-25), "3818"_unhex);
+  EXPECT_OUTCOME_EQ(encode(std::numeric_limits<int64_t>::min()),
+                    "3B7FFFFFFFFFFFFFFF"_unhex);
+  EXPECT_OUTCOME_TRUE(bytes, encode(std::vector<uint8_t>(300)));
+  EXPECT_EQ(bytes.size(), 303u);
+  EXPECT_EQ(bytes[0], 0x59);
+  EXPECT_OUTCOME_TRUE(list, encode(std::vector<int>(30)));
+  EXPECT_EQ(list.size(), 32u);
+  EXPECT_EQ(list[0], 0x98);
+}
+
+/**
+ * @given Nested streams released to per-thread buffer pool
+ * @when Encode again with reused buffers
+ * @then Encoded as expected
+ */
+TEST(CborEncoder, ReusedBuffers) {
+  for (auto i = 0; i < 3; ++i) {
+    auto s = CborEncodeStream::list();
+    s << (s.list() << i << "CAFE"_unhex) << (s.list() << std::string("abc"));
+    auto expected = "82820042CAFE8163616263"_unhex;
+    expected[2] = static_cast<uint8_t>(i);
+    EXPECT_EQ(s.data(), expected);
+  }
+}
+
+struct CborTupleSample {
+  int64_t a;
+  std::string b;
+  CborEncodeStream c;
+};
+CBOR_ENCODE_TUPLE(CborTupleSample, a, b, c)
+
+/**
+ * @given Tuples with fields encoding one and many elements
+ * @when Encode in place
+ * @then Same bytes as nested list stream
+ */
+TEST(CborEncoder, TupleInPlace) {
+  CborTupleSample tuple{-1, "ab", CborEncodeStream::list() << 1};
+  auto s = CborEncodeStream::list();
+  s << tuple << tuple;
+  EXPECT_EQ(s.data(), "828320626162810183206261628101"_unhex);
+
+  for (auto n : {20, 21, 30}) {
+    tuple.c = {};
+    for (auto i = 0; i < n; ++i) {
+      tuple.c << i;
+    }
+    auto expected = CborEncodeStream::list();
+    expected << tuple.a << tuple.b << tuple.c;
+    EXPECT_EQ((CborEncodeStream{} << tuple).data(), expected.data());
+  }
+}
+
 /**
  * @given Sequence
  * @when Encode
@@ -444,6 +521,31 @@ TEST(CborDecoder, Misc) {
   EXPECT_EQ(CborDecodeStream("810201"_unhex).raw(), "8102"_unhex);
 }
 
+/**
+ * @given CBOR with byte strings of different header sizes
+ * @when Decode views from borrowed stream
+ * @then Views point into source data @and stream advances
+ */
+TEST(CborDecoder, BorrowedViews) {
+  std::vector<uint8_t> long_bytes(300, 7);
+  auto cbor = "8343010203"_unhex;
+  cbor.insert(cbor.end(), {0x59, 0x01, 0x2C});
+  cbor.insert(cbor.end(), long_bytes.begin(), long_bytes.end());
+  cbor.push_back(0x01);
+  auto s = CborDecodeStream::borrow(cbor).list();
+  auto short_view = s.bytesView();
+  EXPECT_EQ(short_view.data(), cbor.data() + 2);
+  EXPECT_EQ(std::vector<uint8_t>(short_view.begin(), short_view.end()),
+            "010203"_unhex);
+  auto long_view = s.bytesView();
+  EXPECT_EQ(long_view.data(), cbor.data() + 9);
+  EXPECT_EQ(std::vector<uint8_t>(long_view.begin(), long_view.end()),
+            long_bytes);
+  auto raw = s.rawView();
+  EXPECT_EQ(raw.data(), cbor.data() + cbor.size() - 1);
+  EXPECT_EQ(raw.size(), 1u);
+}
+
 struct CborResolve : testing::Test {
   fc::outcome::result<std::vector<uint8_t>> resolve(
       gsl::span<const uint8_t> node, const std::string &part) {
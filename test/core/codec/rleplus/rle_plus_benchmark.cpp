@@ -0,0 +1,147 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <boost/dynamic_bitset.hpp>
+
+#include "codec/rle/rle_plus.hpp"
+
+using fc::codec::rle::Run;
+using fc::codec::rle::Runs;
+
+namespace {
+  /**
+   * Previous bit-by-bit decoder, kept as baseline
+   */
+  std::set<uint64_t> legacyDecode(gsl::span<const uint8_t> data) {
+    boost::dynamic_bitset<uint8_t> bits{data.begin(), data.end()};
+    size_t index{};
+    auto get{[&](size_t count) {
+      uint64_t value{};
+      for (size_t i{0}; i < count; ++i, ++index) {
+        value |= static_cast<uint64_t>(bits.test(index)) << i;
+      }
+      return value;
+    }};
+    std::set<uint64_t> output;
+    get(2);
+    auto magnitude{get(1) == 1};
+    uint64_t value{};
+    while (bits.find_next(index - 1) != bits.npos) {
+      uint64_t length{1};
+      if (get(1) == 0) {
+        if (get(1) == 1) {
+          length = get(4);
+        } else {
+          length = 0;
+          uint64_t byte{};
+          size_t shift{};
+          do {
+            byte = get(8);
+            length |= (byte & 0x7F) << shift;
+            shift += 7;
+          } while ((byte & 0x80) != 0);
+        }
+      }
+      if (magnitude) {
+        for (uint64_t i{0}; i < length; ++i) {
+          output.insert(value + i);
+        }
+      }
+      value += length;
+      magnitude = !magnitude;
+    }
+    return output;
+  }
+
+  /**
+   * Miner sectors: long committed range with scattered faults
+   * @param sectors - number of sectors
+   * @param holes - number of missing sectors
+   */
+  Runs minerSectors(uint64_t sectors, uint64_t holes) {
+    std::mt19937_64 random{sectors};
+    std::set<uint64_t> missing;
+    while (missing.size() < holes) {
+      missing.insert(random() % sectors);
+    }
+    Runs runs;
+    uint64_t start{0};
+    for (auto hole : missing) {
+      if (hole != start) {
+        runs.push_back({start, hole - start});
+      }
+      start = hole + 1;
+    }
+    if (start != sectors) {
+      runs.push_back({start, sectors - start});
+    }
+    return runs;
+  }
+
+  std::set<uint64_t> expand(const Runs &runs) {
+    std::set<uint64_t> values;
+    for (auto &run : runs) {
+      for (auto value{run.start}; value != run.end(); ++value) {
+        values.insert(values.end(), value);
+      }
+    }
+    return values;
+  }
+
+  /// Sizes below decoded set limit
+  void args(benchmark::internal::Benchmark *b) {
+    b->Args({100000, 100})->Args({100000, 10000});
+  }
+}  // namespace
+
+void LegacyDecodeSet(benchmark::State &state) {
+  auto encoded{fc::codec::rle::encode(
+      minerSectors(state.range(0), state.range(1)))};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(legacyDecode(encoded));
+  }
+}
+BENCHMARK(LegacyDecodeSet)->Apply(args);
+
+void DecodeSet(benchmark::State &state) {
+  auto encoded{fc::codec::rle::encode(
+      minerSectors(state.range(0), state.range(1)))};
+  for (auto _ : state) {
+    std::set<uint64_t> values;
+    fc::codec::rle::RLEPlusDecodingStream{encoded} >> values;
+    benchmark::DoNotOptimize(values);
+  }
+}
+BENCHMARK(DecodeSet)->Apply(args);
+
+void DecodeRuns(benchmark::State &state) {
+  auto encoded{fc::codec::rle::encode(
+      minerSectors(state.range(0), state.range(1)))};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fc::codec::rle::decodeRuns(encoded));
+  }
+}
+BENCHMARK(DecodeRuns)->Apply(args)->Args({10000000, 1000});
+
+void EncodeSet(benchmark::State &state) {
+  auto values{expand(minerSectors(state.range(0), state.range(1)))};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fc::codec::rle::encode(values));
+  }
+}
+BENCHMARK(EncodeSet)->Apply(args);
+
+void EncodeRuns(benchmark::State &state) {
+  auto runs{minerSectors(state.range(0), state.range(1))};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fc::codec::rle::encode(runs));
+  }
+}
+BENCHMARK(EncodeRuns)->Apply(args)->Args({10000000, 1000});
+
+BENCHMARK_MAIN();
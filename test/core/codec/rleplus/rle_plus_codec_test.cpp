@@ -141,3 +141,42 @@ TEST(RLEPlusDecode, MaxSizeExceedFailure) {
   ASSERT_TRUE(result.has_error());
   ASSERT_EQ(result.error().value(), static_cast<int>(expected));
 }
+
+/**
+ * @given Runs of values and the same values as set
+ * @when RLE+ encode runs and following decode back to runs
+ * @then Encoded data is the same as for set @and decoded runs are the same as
+ * the given
+ */
+TEST(RLEPlusRuns, RunsEncodeDecodeSuccess) {
+  fc::codec::rle::Runs runs{{0, 1}, {2, 1}, {4, 3}, {11, 17}, {100, 1}};
+  std::set<uint64_t> data_set;
+  for (auto &run : runs) {
+    for (auto i = run.start; i < run.end(); ++i) {
+      data_set.insert(i);
+    }
+  }
+  auto encoded = encode(runs);
+  ASSERT_EQ(encoded, encode(data_set));
+  EXPECT_OUTCOME_TRUE(decoded, fc::codec::rle::decodeRuns(encoded));
+  ASSERT_EQ(decoded, runs);
+}
+
+/**
+ * @given Overlapping and adjacent runs pushed one by one
+ * @when RLE+ encode them and read runs back with stream
+ * @then Runs are coalesced @and read in ascending order
+ */
+TEST(RLEPlusRuns, StreamRunsSuccess) {
+  using fc::codec::rle::Run;
+  fc::codec::rle::RLEPlusEncodingStream encoder;
+  encoder << Run{3, 2} << Run{4, 3} << Run{7, 1} << Run{10, 0} << Run{20, 5};
+  auto encoded = encoder.data();
+  fc::codec::rle::RLEPlusDecodingStream decoder{encoded};
+  Run run;
+  ASSERT_TRUE(decoder.next(run));
+  ASSERT_EQ(run, (Run{3, 5}));
+  ASSERT_TRUE(decoder.next(run));
+  ASSERT_EQ(run, (Run{20, 5}));
+  ASSERT_FALSE(decoder.next(run));
+}
@@ -0,0 +1,56 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/arena.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using fc::common::Arena;
+
+/**
+ * @given no arena scope
+ * @when resource is requested
+ * @then heap is used
+ */
+TEST(ArenaTest, OutsideScope) {
+  EXPECT_EQ(Arena::resource(), std::pmr::new_delete_resource());
+}
+
+/**
+ * @given scope with allocations
+ * @when next scope allocates
+ * @then memory of previous scope is reused
+ */
+TEST(ArenaTest, Reuse) {
+  void *first{};
+  {
+    Arena::Scope scope;
+    EXPECT_NE(Arena::resource(), std::pmr::new_delete_resource());
+    first = Arena::make<int>(1).get();
+  }
+  Arena::Scope scope;
+  EXPECT_EQ(Arena::make<int>(2).get(), first);
+}
+
+/**
+ * @given nested scope
+ * @when inner scope exits
+ * @then memory of outer scope is kept
+ */
+TEST(ArenaTest, Nested) {
+  Arena::Scope outer;
+  auto value{Arena::make<int>(1)};
+  {
+    Arena::Scope inner;
+    Arena::make<int>(2);
+  }
+  EXPECT_NE(Arena::make<int>(3).get(), value.get());
+  EXPECT_EQ(*value, 1);
+  // pmr containers grow past first block
+  std::pmr::vector<uint64_t> big{Arena::resource()};
+  big.resize(Arena::kBlockBytes);
+  EXPECT_EQ(big.back(), 0);
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/cuckoo_filter.hpp"
+
+#include <gtest/gtest.h>
+#include <random>
+
+using fc::common::CuckooFilter;
+
+/**
+ * @given filter filled up to capacity
+ * @when inserted and other keys are checked
+ * @then all inserted keys are found and few others are
+ */
+TEST(CuckooFilterTest, NoFalseNegatives) {
+  constexpr size_t kKeys{10000};
+  CuckooFilter filter{kKeys};
+  std::mt19937_64 random{1};
+  std::vector<uint64_t> keys;
+  for (size_t i{0}; i < kKeys; ++i) {
+    keys.push_back(random());
+    EXPECT_TRUE(filter.insert(keys.back()));
+  }
+  EXPECT_EQ(filter.size(), kKeys);
+  for (auto key : keys) {
+    EXPECT_TRUE(filter.contains(key));
+  }
+  size_t positives{0};
+  for (size_t i{0}; i < kKeys; ++i) {
+    positives += filter.contains(random());
+  }
+  EXPECT_LT(positives, kKeys / 1000);
+}
+
+/**
+ * @given filter with keys
+ * @when half of keys is erased
+ * @then other half is still found
+ */
+TEST(CuckooFilterTest, Erase) {
+  CuckooFilter filter{1000};
+  std::vector<uint64_t> keys;
+  for (size_t i{0}; i < 1000; ++i) {
+    keys.push_back(CuckooFilter::hash(fc::common::BufferView{
+        reinterpret_cast<const uint8_t *>(&i), sizeof(i)}));
+    filter.insert(keys.back());
+  }
+  for (size_t i{0}; i < keys.size(); i += 2) {
+    EXPECT_TRUE(filter.erase(keys[i]));
+  }
+  for (size_t i{1}; i < keys.size(); i += 2) {
+    EXPECT_TRUE(filter.contains(keys[i]));
+  }
+  EXPECT_EQ(filter.size(), keys.size() / 2);
+}
+
+/**
+ * @given small filter
+ * @when more keys than its slots are inserted
+ * @then insert fails, but inserted keys are still found
+ */
+TEST(CuckooFilterTest, Full) {
+  CuckooFilter filter{16};
+  std::mt19937_64 random{2};
+  std::vector<uint64_t> keys;
+  for (size_t i{0}; i < 2 * filter.capacity(); ++i) {
+    auto key{random()};
+    if (filter.insert(key)) {
+      keys.push_back(key);
+    }
+  }
+  EXPECT_LT(keys.size(), 2 * filter.capacity());
+  for (auto key : keys) {
+    EXPECT_TRUE(filter.contains(key));
+  }
+}
@@ -0,0 +1,37 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/histogram.hpp"
+
+#include <gtest/gtest.h>
+
+using fc::common::LatencyHistogram;
+using std::chrono::microseconds;
+
+/**
+ * @given histogram
+ * @when record durations
+ * @then they are counted in power of two buckets
+ */
+TEST(LatencyHistogramTest, Buckets) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.snapshot().quantileUs(0.5), 0u);
+  histogram.record(microseconds{0});
+  histogram.record(microseconds{1});
+  histogram.record(microseconds{5});
+  histogram.record(microseconds{1000});
+  histogram.record(std::chrono::hours{1});
+
+  auto snapshot = histogram.snapshot();
+  EXPECT_EQ(snapshot.count, 5u);
+  EXPECT_EQ(snapshot.buckets[0], 1u);
+  EXPECT_EQ(snapshot.buckets[1], 1u);
+  EXPECT_EQ(snapshot.buckets[3], 1u);
+  EXPECT_EQ(snapshot.buckets[10], 1u);
+  EXPECT_EQ(snapshot.buckets[LatencyHistogram::kBuckets - 1], 1u);
+  EXPECT_EQ(snapshot.quantileUs(0), 1u);
+  EXPECT_EQ(snapshot.quantileUs(0.5), 8u);
+  EXPECT_EQ(snapshot.quantileUs(0.75), 1024u);
+}
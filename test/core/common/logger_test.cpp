@@ -0,0 +1,36 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/logger.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+
+using fc::common::createLogger;
+using fc::common::LoggerError;
+using fc::common::loggerTags;
+using fc::common::setLogLevel;
+
+/**
+ * @given created logger
+ * @when its level is changed by tag
+ * @then logger has new level, unknown tag and level are errors
+ */
+TEST(LoggerTest, SetLevel) {
+  auto logger{createLogger("logger_test")};
+  auto tags{loggerTags()};
+  EXPECT_NE(std::find(tags.begin(), tags.end(), "logger_test"), tags.end());
+
+  EXPECT_TRUE(setLogLevel("logger_test", "debug"));
+  EXPECT_EQ(logger->level(), spdlog::level::debug);
+  EXPECT_TRUE(setLogLevel("*", "error"));
+  EXPECT_EQ(logger->level(), spdlog::level::err);
+
+  EXPECT_EQ(setLogLevel("logger_test", "verbose").error(),
+            LoggerError::UNKNOWN_LEVEL);
+  EXPECT_EQ(setLogLevel("logger_test_missing", "info").error(),
+            LoggerError::UNKNOWN_LOGGER);
+  EXPECT_EQ(logger->level(), spdlog::level::err);
+}
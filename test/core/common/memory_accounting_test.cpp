@@ -0,0 +1,60 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/memory_domain.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using fc::common::memoryAccountingEnabled;
+using fc::common::memoryDomain;
+using fc::common::MemoryDomainScope;
+
+namespace {
+  // keeps allocations observable, not elided by optimizer
+  void *volatile sink;
+}  // namespace
+
+/**
+ * @given binary linking memory_accounting
+ * @when memory is allocated in domain scope and freed
+ * @then domain counts allocated bytes, live bytes return to previous value
+ */
+TEST(MemoryAccounting, CountsDomainBytes) {
+  EXPECT_TRUE(memoryAccountingEnabled());
+  auto &domain{memoryDomain("test_accounting")};
+  auto live{domain.live()};
+  auto allocated{domain.allocatedBytes()};
+  auto allocations{domain.allocations()};
+  {
+    MemoryDomainScope scope{domain};
+    sink = ::operator new(1000);
+  }
+  EXPECT_EQ(domain.live(), live + 1000);
+  EXPECT_EQ(domain.allocatedBytes(), allocated + 1000);
+  EXPECT_EQ(domain.allocations(), allocations + 1);
+
+  ::operator delete(sink);
+  EXPECT_EQ(domain.live(), live);
+  EXPECT_EQ(domain.allocatedBytes(), allocated + 1000);
+}
+
+/**
+ * @given memory allocated in domain scope
+ * @when it is freed on another thread outside of scopes
+ * @then it is freed from allocating domain
+ */
+TEST(MemoryAccounting, FreedFromAllocatingDomain) {
+  auto &domain{memoryDomain("test_accounting_thread")};
+  auto live{domain.live()};
+  {
+    MemoryDomainScope scope{domain};
+    sink = ::operator new(500);
+  }
+  EXPECT_EQ(domain.live(), live + 500);
+
+  std::thread{[] { ::operator delete(sink); }}.join();
+  EXPECT_EQ(domain.live(), live);
+}
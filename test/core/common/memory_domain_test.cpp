@@ -0,0 +1,57 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/memory_domain.hpp"
+
+#include <gtest/gtest.h>
+
+using fc::common::currentMemoryDomain;
+using fc::common::heapProfile;
+using fc::common::MemoryDomain;
+using fc::common::memoryDomain;
+using fc::common::MemoryDomainResource;
+using fc::common::MemoryDomainScope;
+
+/**
+ * @given two domains
+ * @when nested scopes are entered and left
+ * @then current domain follows innermost scope
+ */
+TEST(MemoryDomain, Scopes) {
+  auto &a{memoryDomain("test_a")};
+  auto &b{memoryDomain("test_b")};
+  EXPECT_NE(a.id(), b.id());
+  EXPECT_EQ(&memoryDomain("test_a"), &a);
+  EXPECT_EQ(currentMemoryDomain(), MemoryDomain::kUntagged);
+  {
+    MemoryDomainScope scope_a{a};
+    EXPECT_EQ(currentMemoryDomain(), a.id());
+    {
+      MemoryDomainScope scope_b{"test_b"};
+      EXPECT_EQ(currentMemoryDomain(), b.id());
+    }
+    EXPECT_EQ(currentMemoryDomain(), a.id());
+  }
+  EXPECT_EQ(currentMemoryDomain(), MemoryDomain::kUntagged);
+}
+
+/**
+ * @given pmr vector on domain resource
+ * @when vector grows and is destroyed
+ * @then domain accounts allocated bytes and live bytes return to zero
+ */
+TEST(MemoryDomain, Resource) {
+  auto &domain{memoryDomain("test_resource")};
+  MemoryDomainResource resource{domain};
+  {
+    std::pmr::vector<uint64_t> values{&resource};
+    values.resize(100);
+    EXPECT_GE(domain.live(), 800);
+    EXPECT_GE(domain.allocatedBytes(), 800u);
+    EXPECT_GE(domain.allocations(), 1u);
+  }
+  EXPECT_EQ(domain.live(), 0);
+  EXPECT_NE(heapProfile().find("test_resource"), std::string::npos);
+}
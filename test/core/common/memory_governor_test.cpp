@@ -0,0 +1,106 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/memory_governor.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem/fstream.hpp>
+
+#include "testutil/storage/base_fs_test.hpp"
+
+using fc::common::cgroupMemoryLimit;
+using fc::common::MemoryGovernor;
+
+/// Cache which evicts requested bytes
+struct FakeCache {
+  MemoryGovernor::Cache callbacks() {
+    return {[this] { return usage; },
+            [this](size_t bytes) {
+              auto evicted{std::min(bytes, usage)};
+              usage -= evicted;
+              requested += bytes;
+              return evicted;
+            }};
+  }
+
+  size_t usage{};
+  size_t requested{};
+};
+
+/**
+ * @given caches within budget
+ * @when enforce
+ * @then nothing is evicted
+ */
+TEST(MemoryGovernor, WithinBudget) {
+  MemoryGovernor governor{{100}};
+  FakeCache cache{60};
+  governor.add("cache", cache.callbacks());
+  EXPECT_EQ(governor.usage(), 60);
+  EXPECT_EQ(governor.enforce(), 0);
+  EXPECT_EQ(cache.requested, 0);
+}
+
+/**
+ * @given two caches over budget
+ * @when enforce
+ * @then caches are shrunk in proportion to usage down to budget
+ */
+TEST(MemoryGovernor, ShrinkProportionally) {
+  MemoryGovernor governor{{100}};
+  FakeCache large{150}, small{50};
+  governor.add("large", large.callbacks());
+  auto id{governor.add("small", small.callbacks())};
+  EXPECT_EQ(governor.enforce(), 100);
+  EXPECT_EQ(large.usage, 75);
+  EXPECT_EQ(small.usage, 25);
+  EXPECT_EQ(governor.usage(), 100);
+
+  // removed cache is not asked
+  governor.remove(id);
+  small.usage = 1000;
+  EXPECT_EQ(governor.enforce(), 0);
+}
+
+/**
+ * @given cgroup limit below configured budget
+ * @when governor is created
+ * @then budget is share of cgroup limit
+ */
+TEST(MemoryGovernor, CgroupBudget) {
+  EXPECT_EQ(MemoryGovernor({1000, 0.5}, 400).budget(), 200);
+  EXPECT_EQ(MemoryGovernor({100, 0.5}, 400).budget(), 100);
+  EXPECT_EQ(MemoryGovernor({0, 0.5}, 400).budget(), 200);
+  EXPECT_EQ(MemoryGovernor({0, 0.5}).budget(), 0);
+}
+
+class CgroupTest : public test::BaseFS_Test {
+ public:
+  CgroupTest() : test::BaseFS_Test("fc_cgroup_test") {}
+
+  void write(const std::string &file, const std::string &content) {
+    fs::create_directories((base_path / file).parent_path());
+    fs::ofstream output{base_path / file};
+    output << content;
+  }
+};
+
+/**
+ * @given cgroup v2 and v1 limit files
+ * @when limit is read
+ * @then limited values are parsed and unlimited are none
+ */
+TEST_F(CgroupTest, Limit) {
+  auto root{base_path.string()};
+  EXPECT_FALSE(cgroupMemoryLimit(root));
+  write("memory/memory.limit_in_bytes", "9223372036854771712\n");
+  EXPECT_FALSE(cgroupMemoryLimit(root));
+  write("memory/memory.limit_in_bytes", "1073741824\n");
+  EXPECT_EQ(cgroupMemoryLimit(root), size_t{1} << 30);
+  write("memory.max", "max\n");
+  EXPECT_EQ(cgroupMemoryLimit(root), size_t{1} << 30);
+  write("memory.max", "536870912\n");
+  EXPECT_EQ(cgroupMemoryLimit(root), size_t{1} << 29);
+}
@@ -0,0 +1,58 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/metrics.hpp"
+
+#include <gtest/gtest.h>
+
+using fc::common::metrics::Registry;
+using std::chrono::microseconds;
+
+/**
+ * @given registry
+ * @when metric is looked up again
+ * @then same metric is returned, labels distinguish metrics
+ */
+TEST(MetricsTest, Lookup) {
+  Registry registry;
+  auto &counter{registry.counter("fc_test_total", "test")};
+  counter.add(2);
+  EXPECT_EQ(&registry.counter("fc_test_total", "test"), &counter);
+  EXPECT_EQ(registry.counter("fc_test_total", "test").value(), 2);
+  auto &labeled{registry.counter("fc_test_total", "test", {{"a", "b"}})};
+  EXPECT_NE(&labeled, &counter);
+  EXPECT_EQ(labeled.value(), 0);
+}
+
+/**
+ * @given counter, gauge and histogram
+ * @when exported
+ * @then prometheus text format is written, histogram in seconds
+ */
+TEST(MetricsTest, Prometheus) {
+  Registry registry;
+  registry.counter("fc_calls_total", "calls", {{"method", "A\"B"}}).add(3);
+  registry.gauge("fc_queue", "queue").set(-2);
+  auto &histogram{registry.histogram("fc_call_seconds", "call time")};
+  histogram.record(microseconds{3});
+  histogram.record(microseconds{2000000});
+
+  auto text{registry.prometheus()};
+  EXPECT_NE(text.find("# TYPE fc_calls_total counter\n"
+                      "fc_calls_total{method=\"A\\\"B\"} 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("# TYPE fc_queue gauge\nfc_queue -2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("# TYPE fc_call_seconds histogram\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("fc_call_seconds_bucket{le=\"1e-06\"} 0\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("fc_call_seconds_bucket{le=\"4e-06\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("fc_call_seconds_bucket{le=\"+Inf\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("fc_call_seconds_sum 2.000003\n"), std::string::npos);
+  EXPECT_NE(text.find("fc_call_seconds_count 2\n"), std::string::npos);
+}
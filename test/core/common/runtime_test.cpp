@@ -0,0 +1,71 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/runtime.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/asio/post.hpp>
+#include <future>
+
+using fc::common::Runtime;
+
+/**
+ * @given runtime
+ * @when strand of domain is requested twice
+ * @then same strand is returned, new strands differ
+ */
+TEST(Runtime, NamedStrands) {
+  Runtime runtime{2, 1};
+  EXPECT_EQ(runtime.cpuThreads(), 2);
+  EXPECT_TRUE(runtime.strand("chain") == runtime.strand("chain"));
+  EXPECT_FALSE(runtime.strand("chain") == runtime.strand("mpool"));
+  EXPECT_FALSE(runtime.newStrand() == runtime.newStrand());
+}
+
+/**
+ * @given runtime with several cpu threads
+ * @when handlers are posted to strand
+ * @then handlers run one by one in order of posting
+ */
+TEST(Runtime, StrandOrder) {
+  Runtime runtime{4, 1};
+  auto strand{runtime.strand("chain")};
+  std::vector<int> order;
+  auto running{0}, overlaps{0};
+  std::promise<void> done;
+  constexpr auto kHandlers{100};
+  for (auto i{0}; i < kHandlers; ++i) {
+    boost::asio::post(strand, [&, i] {
+      if (++running != 1) {
+        ++overlaps;
+      }
+      order.push_back(i);
+      --running;
+      if (i == kHandlers - 1) {
+        done.set_value();
+      }
+    });
+  }
+  done.get_future().get();
+  EXPECT_EQ(overlaps, 0);
+  ASSERT_EQ(order.size(), kHandlers);
+  for (auto i{0}; i < kHandlers; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+/**
+ * @given runtime
+ * @when handler is posted to blocking pool
+ * @then it runs off cpu pool
+ */
+TEST(Runtime, Blocking) {
+  Runtime runtime{1, 1};
+  std::promise<bool> in_cpu;
+  boost::asio::post(runtime.blocking(), [&] {
+    in_cpu.set_value(runtime.cpu().running_in_this_thread());
+  });
+  EXPECT_FALSE(in_cpu.get_future().get());
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/tracing.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using fc::common::tracing::Context;
+using fc::common::tracing::Span;
+namespace tracing = fc::common::tracing;
+
+struct TracingTest : testing::Test {
+  void SetUp() override {
+    tracing::clear();
+    tracing::enable(true);
+  }
+
+  void TearDown() override {
+    tracing::enable(false);
+    tracing::clear();
+  }
+};
+
+/**
+ * @given tracing disabled
+ * @when span is opened
+ * @then nothing is recorded and span has no context
+ */
+TEST_F(TracingTest, Disabled) {
+  tracing::enable(false);
+  {
+    Span span{"disabled"};
+    EXPECT_EQ(span.context().span, 0);
+    EXPECT_EQ(Span::current().span, 0);
+  }
+  EXPECT_TRUE(tracing::collect().empty());
+}
+
+/**
+ * @given span opened inside span, and span on other thread
+ * @when spans finish
+ * @then children reference parent and share trace
+ */
+TEST_F(TracingTest, Nested) {
+  Context outer_context;
+  {
+    Span outer{"outer"};
+    outer_context = outer.context();
+    {
+      Span inner{"inner", "detail"};
+      EXPECT_EQ(Span::current().span, inner.context().span);
+    }
+    EXPECT_EQ(Span::current().span, outer_context.span);
+    std::thread{[&] { Span remote{"remote", {}, outer_context}; }}.join();
+  }
+  EXPECT_EQ(Span::current().span, 0);
+  auto events{tracing::collect()};
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_STREQ(events[0].name, "outer");
+  EXPECT_EQ(events[0].parent, 0);
+  EXPECT_EQ(events[0].trace, outer_context.span);
+  EXPECT_STREQ(events[1].name, "inner");
+  EXPECT_EQ(events[1].detail, "detail");
+  EXPECT_EQ(events[1].parent, outer_context.span);
+  EXPECT_STREQ(events[2].name, "remote");
+  EXPECT_EQ(events[2].parent, outer_context.span);
+  EXPECT_NE(events[2].thread, events[0].thread);
+  for (auto &event : events) {
+    EXPECT_EQ(event.trace, outer_context.trace);
+    EXPECT_LE(event.start_ns, event.end_ns);
+  }
+
+  auto chrome{tracing::chromeTrace(events)};
+  EXPECT_EQ(chrome.rfind("{\"traceEvents\":[", 0), 0);
+  EXPECT_NE(chrome.find("\"name\":\"inner\""), std::string::npos);
+  // remote span is linked by flow
+  EXPECT_NE(chrome.find("\"ph\":\"s\""), std::string::npos);
+  EXPECT_NE(chrome.find("\"ph\":\"f\""), std::string::npos);
+
+  auto otlp{tracing::otlpJson(events)};
+  EXPECT_NE(otlp.find("\"stringValue\":\"fuhon\""), std::string::npos);
+  EXPECT_NE(otlp.find("\"parentSpanId\""), std::string::npos);
+}
+
+/**
+ * @given more spans than ring holds
+ * @when collected
+ * @then latest spans are kept
+ */
+TEST_F(TracingTest, Ring) {
+  for (size_t i{0}; i < tracing::kRingEvents + 10; ++i) {
+    Span span{"span"};
+  }
+  auto events{tracing::collect()};
+  EXPECT_EQ(events.size(), tracing::kRingEvents);
+}
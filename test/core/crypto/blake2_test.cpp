@@ -7,6 +7,7 @@
 #include <stdio.h>
 
 #include "crypto/blake2/blake2b.h"
+#include "crypto/blake2/blake2b160.hpp"
 #include "crypto/blake2/blake2s.h"
 #include "testutil/literals.hpp"
 
@@ -123,3 +124,24 @@ TEST(Blake2s, UnkeyedInit) {
 
   EXPECT_EQ(memcmp(out1, out2, 32), 0) << "hashes are different";
 }
+
+/**
+ * @given inputs of different sizes, including empty and block aligned
+ * @when hash them at once
+ * @then every hash equals hash of single input
+ */
+TEST(Blake2b, Many) {
+  using fc::crypto::blake2b::blake2b_256;
+  using fc::crypto::blake2b::blake2b_256_many;
+  std::vector<std::vector<uint8_t>> inputs;
+  for (auto size : {0, 1, 3, 127, 128, 129, 255, 256, 300, 1000, 64, 5}) {
+    inputs.emplace_back(size);
+    selftest_seq(inputs.back().data(), size, size);
+  }
+  std::vector<gsl::span<const uint8_t>> spans{inputs.begin(), inputs.end()};
+  auto hashes = blake2b_256_many(spans);
+  ASSERT_EQ(hashes.size(), inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(hashes[i], blake2b_256(inputs[i])) << "input " << i;
+  }
+}
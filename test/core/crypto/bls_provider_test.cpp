@@ -82,3 +82,54 @@ TEST_F(BlsProviderTest, DifferentMessageVerificationFailure) {
                           different_message, signature, key_pair.public_key));
   ASSERT_FALSE(signature_status);
 }
+
+/**
+ * @given Several messages signed by different keys
+ * @when Verifying aggregated signature of all messages at once
+ * @then Signature is valid only for the same messages and keys
+ */
+TEST_F(BlsProviderTest, VerifyAggregateSignature) {
+  std::vector<std::vector<uint8_t>> messages;
+  std::vector<PublicKey> keys;
+  std::vector<Signature> signatures;
+  for (uint8_t i = 0; i < 3; ++i) {
+    EXPECT_OUTCOME_TRUE(key_pair, provider_.generateKeyPair());
+    auto message = message_;
+    message.push_back(i);
+    EXPECT_OUTCOME_TRUE(signature,
+                        provider_.sign(message, key_pair.private_key));
+    messages.push_back(message);
+    keys.push_back(key_pair.public_key);
+    signatures.push_back(signature);
+  }
+  EXPECT_OUTCOME_TRUE(aggregate, provider_.aggregateSignatures(signatures));
+  EXPECT_OUTCOME_EQ(
+      provider_.verifyAggregateSignature(messages, keys, aggregate), true);
+
+  std::swap(keys[0], keys[1]);
+  EXPECT_OUTCOME_EQ(
+      provider_.verifyAggregateSignature(messages, keys, aggregate), false);
+  keys.pop_back();
+  EXPECT_OUTCOME_EQ(
+      provider_.verifyAggregateSignature(messages, keys, aggregate), false);
+}
+
+/**
+ * @given More signatures than one aggregation part
+ * @when Aggregating parts on threads
+ * @then Result equals serial aggregation
+ */
+TEST_F(BlsProviderTest, AggregateParallel) {
+  EXPECT_OUTCOME_TRUE(key_pair, provider_.generateKeyPair());
+  std::vector<Signature> signatures;
+  for (size_t i = 0; i < 3 * BlsProviderImpl::kAggregateChunk; ++i) {
+    auto message = message_;
+    message.push_back(static_cast<uint8_t>(i));
+    EXPECT_OUTCOME_TRUE(signature,
+                        provider_.sign(message, key_pair.private_key));
+    signatures.push_back(signature);
+  }
+  EXPECT_OUTCOME_TRUE(serial, provider_.aggregateSignatures(signatures));
+  EXPECT_OUTCOME_EQ(provider_.aggregateSignaturesParallel(signatures, 4),
+                    serial);
+}
@@ -176,4 +176,35 @@ namespace fc::data_transfer {
     EXPECT_FALSE(receiver.receiveRequest(initiator, request).has_error());
   }
 
+  /**
+   * @given pull channel started before response
+   * @when sender accepts request and responds with blocks
+   * @then graphsync request is not repeated and responses are recorded
+   */
+  TEST_F(GraphsyncReceiverTest, OptimisticPull) {
+    TransferId transfer_id = 1;
+    CID base_cid = "010001020005"_cid;
+    ChannelId channel_id{.initiator = peer_info, .id = transfer_id};
+    ChannelState state{.channel = {.base_cid = base_cid}};
+    Graphsync::RequestProgressCallback callback;
+    EXPECT_CALL(*graphsync,
+                makeRequest(Eq(initiator.id), _, Eq(base_cid), _, _, _))
+        .WillOnce(::testing::Invoke(
+            [&](auto &, auto, auto &, auto, auto &, auto cb) {
+              callback = cb;
+              return Subscription{};
+            }));
+    EXPECT_CALL(*graphsync_manager, getChannelByIdAndSender(_, Eq(initiator)))
+        .WillRepeatedly(::testing::Return(state));
+
+    EXPECT_OUTCOME_TRUE_1(receiver.startPull(channel_id, initiator, base_cid));
+    EXPECT_OUTCOME_TRUE_1(receiver.receiveResponse(
+        initiator,
+        DataTransferResponse{.is_accepted = true, .transfer_id = transfer_id}));
+
+    EXPECT_CALL(*graphsync_manager, onChannelResponse(_)).Times(2);
+    callback(storage::ipfs::graphsync::RS_PARTIAL_RESPONSE, {});
+    callback(storage::ipfs::graphsync::RS_FULL_CONTENT, {});
+  }
+
 }  // namespace fc::data_transfer
@@ -5,6 +5,9 @@
 
 #include "fsm/fsm.hpp"
 
+#include <atomic>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 #include "host/context/impl/host_context_impl.hpp"
@@ -49,3 +52,52 @@ TEST(Dev, Main) {
   ASSERT_EQ(entity->x, 1);
   ASSERT_EQ(entity->content, "stopped");
 }
+
+/**
+ * @given many entities with events sent from several threads of io context
+ * @when io context runs
+ * @then events are dispatched without polling delay and in order for each
+ * entity
+ */
+TEST(Dev, EventDriven) {
+  auto context = std::make_shared<HostContext>();
+  std::atomic_int stopped{0};
+  Fsm fsm{{Transition(Events::START)
+               .from(States::READY)
+               .to(States::WORKING)
+               .action([](auto data, auto, auto, auto) { data->x = 1; }),
+           Transition(Events::STOP)
+               .from(States::WORKING)
+               .to(States::STOPPED)
+               .action([&](auto data, auto, auto, auto) {
+                 data->content = data->x == 1 ? "stopped" : "unordered";
+                 ++stopped;
+               })},
+          context};
+  std::vector<std::shared_ptr<Data>> entities;
+  for (auto i = 0; i < 1000; ++i) {
+    auto entity = std::make_shared<Data>();
+    EXPECT_OUTCOME_TRUE_1(fsm.begin(entity, States::READY))
+    EXPECT_OUTCOME_TRUE_1(fsm.send(entity, Events::START))
+    EXPECT_OUTCOME_TRUE_1(fsm.send(entity, Events::STOP))
+    entities.push_back(entity);
+  }
+  auto io = context->getIoContext();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      while (stopped != 1000 && std::chrono::steady_clock::now() < deadline) {
+        io->poll();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(stopped, 1000);
+  for (auto &entity : entities) {
+    EXPECT_EQ(entity->content, "stopped");
+    EXPECT_OUTCOME_EQ(fsm.get(entity), States::STOPPED);
+  }
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "fsm/state_journal.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::common::Buffer;
+using fc::fsm::StateJournal;
+using fc::storage::InMemoryStorage;
+
+class StateJournalTest : public ::testing::Test {
+ public:
+  /// Loads journaled entities
+  std::map<Buffer, Buffer> load(const StateJournal &journal) {
+    std::map<Buffer, Buffer> entities;
+    EXPECT_OUTCOME_TRUE_1(
+        journal.load([&](auto &key, auto &value) -> fc::outcome::result<void> {
+          entities.emplace(key, value);
+          return fc::outcome::success();
+        }));
+    return entities;
+  }
+
+  Buffer bytes(std::string_view str) {
+    return Buffer{}.put(str);
+  }
+
+  std::shared_ptr<boost::asio::io_context> io{
+      std::make_shared<boost::asio::io_context>()};
+  std::shared_ptr<InMemoryStorage> store{std::make_shared<InMemoryStorage>()};
+};
+
+/**
+ * @given journal with several writes of entities
+ * @when io context runs posted flush
+ * @then last values are stored under prefix and loaded without it
+ */
+TEST_F(StateJournalTest, CoalescesWrites) {
+  auto journal{std::make_shared<StateJournal>(io, store, bytes("/a/"))};
+  EXPECT_OUTCOME_TRUE_1(store->put(bytes("/b/x"), bytes("other")));
+  journal->write(bytes("1"), bytes("open"));
+  journal->write(bytes("2"), bytes("open"));
+  journal->write(bytes("1"), bytes("funded"));
+  EXPECT_TRUE(load(*journal).empty());
+
+  io->run();
+  EXPECT_EQ(load(*journal),
+            (std::map<Buffer, Buffer>{{bytes("1"), bytes("funded")},
+                                      {bytes("2"), bytes("open")}}));
+  EXPECT_TRUE(store->contains(bytes("/a/1")));
+
+  journal->remove(bytes("2"));
+  EXPECT_OUTCOME_TRUE_1(journal->flush());
+  EXPECT_EQ(load(*journal),
+            (std::map<Buffer, Buffer>{{bytes("1"), bytes("funded")}}));
+
+  // new journal over same store restores entities
+  StateJournal restarted{io, store, bytes("/a/")};
+  EXPECT_EQ(load(restarted).size(), 1);
+}
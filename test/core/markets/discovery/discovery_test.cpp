@@ -110,4 +110,48 @@ namespace fc::markets::discovery {
     EXPECT_TRUE(vectorHas(peers_3, retrieval_peer_3));
   }
 
+  /**
+   * @given discovery with peers
+   * @when new discovery loads the same datastore
+   * @then it has the same peers in the same order
+   */
+  TEST_F(DiscoveryTest, load) {
+    PeerInfo retrieval_peer_2{.id = peer_id_2, .addresses = {address_1}};
+    EXPECT_OUTCOME_TRUE_1(discovery.addPeer(proposal_cid_1, retrieval_peer_1));
+    EXPECT_OUTCOME_TRUE_1(discovery.addPeer(proposal_cid_1, retrieval_peer_2));
+    EXPECT_OUTCOME_TRUE_1(discovery.addPeer(proposal_cid_2, retrieval_peer_2));
+    // makes peer 1 most recent again
+    EXPECT_OUTCOME_TRUE_1(discovery.addPeer(proposal_cid_1, retrieval_peer_1));
+
+    Discovery loaded{datastore};
+    EXPECT_OUTCOME_TRUE_1(loaded.load());
+    EXPECT_OUTCOME_TRUE(peers_1, loaded.getPeers(proposal_cid_1));
+    EXPECT_EQ(peers_1,
+              (std::vector<PeerInfo>{retrieval_peer_1, retrieval_peer_2}));
+    EXPECT_OUTCOME_TRUE(peers_2, loaded.getPeers(proposal_cid_2));
+    EXPECT_EQ(peers_2, std::vector<PeerInfo>{retrieval_peer_2});
+  }
+
+  /**
+   * @given discovery with max peers for cid
+   * @when one more peer is added
+   * @then least recently added peer is evicted from memory and datastore
+   */
+  TEST_F(DiscoveryTest, bounded) {
+    std::vector<PeerInfo> added;
+    for (size_t i{0}; i <= Discovery::kMaxPeers; ++i) {
+      added.push_back({.id = generatePeerId(i + 10), .addresses = {address_1}});
+      EXPECT_OUTCOME_TRUE_1(discovery.addPeer(proposal_cid_1, added.back()));
+    }
+    EXPECT_OUTCOME_TRUE(peers, discovery.getPeers(proposal_cid_1));
+    EXPECT_EQ(peers.size(), Discovery::kMaxPeers);
+    EXPECT_EQ(peers.front(), added.back());
+    EXPECT_FALSE(vectorHas(peers, added.front()));
+
+    Discovery loaded{datastore};
+    EXPECT_OUTCOME_TRUE_1(loaded.load());
+    EXPECT_OUTCOME_TRUE(loaded_peers, loaded.getPeers(proposal_cid_1));
+    EXPECT_EQ(loaded_peers, peers);
+  }
+
 }  // namespace fc::markets::discovery
@@ -5,16 +5,24 @@
 
 #include "markets/pieceio/pieceio_impl.hpp"
 
+#include <unistd.h>
+
 #include <gmock/gmock.h>
 
+#include "markets/pieceio/pieceio_error.hpp"
+#include "storage/car/car.hpp"
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "storage/unixfs/unixfs.hpp"
 #include "testutil/outcome.hpp"
 #include "testutil/read_file.hpp"
 #include "testutil/resources/resources.hpp"
 
+using fc::markets::pieceio::PieceIOError;
 using fc::markets::pieceio::PieceIOImpl;
+using fc::primitives::piece::PieceData;
+using fc::primitives::piece::PieceInfo;
 using fc::primitives::piece::UnpaddedPieceSize;
+using fc::storage::ipld::walker::Selector;
 using fc::storage::ipfs::InMemoryDatastore;
 using fc::storage::ipfs::IpfsDatastore;
 
@@ -48,3 +56,63 @@ TEST(PieceIO, generatePieceCommitment) {
   EXPECT_OUTCOME_TRUE(commitment_cid, res.first.toString());
   EXPECT_EQ(commitment_cid_expected, commitment_cid);
 }
+
+/**
+ * @given payload in ipld
+ * @when stage piece into writer reading pipe
+ * @then writer reads selective car padded with zeros to piece size
+ */
+TEST(PieceIO, StagePiece) {
+  std::shared_ptr<IpfsDatastore> ipld = std::make_shared<InMemoryDatastore>();
+  auto input = readFile(PAYLOAD_FILE);
+  EXPECT_OUTCOME_TRUE(payload_cid, fc::storage::unixfs::wrapFile(*ipld, input));
+  EXPECT_OUTCOME_TRUE(car,
+                      fc::storage::car::makeSelectiveCar(
+                          *ipld, {{payload_cid, Selector{}}}));
+  auto piece_size = fc::primitives::piece::paddedSize(car.size());
+
+  PieceIOImpl piece_io{ipld};
+  fc::common::Buffer staged;
+  EXPECT_OUTCOME_TRUE(
+      piece,
+      piece_io.stagePiece(
+          payload_cid,
+          {},
+          piece_size,
+          [&](const PieceData &data) -> fc::outcome::result<PieceInfo> {
+            std::vector<uint8_t> chunk(4096);
+            ssize_t n;
+            while ((n = read(data.getFd(), chunk.data(), chunk.size())) > 0) {
+              staged.put(gsl::make_span(chunk).first(n));
+            }
+            return PieceInfo{piece_size.padded(), payload_cid};
+          }));
+  EXPECT_EQ(piece.cid, payload_cid);
+  ASSERT_EQ(staged.size(), piece_size);
+  EXPECT_EQ(gsl::make_span(staged).first(car.size()), gsl::make_span(car));
+  EXPECT_TRUE(std::all_of(staged.begin() + car.size(),
+                          staged.end(),
+                          [](auto byte) { return byte == 0; }));
+}
+
+/**
+ * @given payload larger than piece
+ * @when stage piece into writer which stops reading
+ * @then error is returned without blocking producer
+ */
+TEST(PieceIO, StagePieceTooLarge) {
+  std::shared_ptr<IpfsDatastore> ipld = std::make_shared<InMemoryDatastore>();
+  auto input = readFile(PAYLOAD_FILE);
+  EXPECT_OUTCOME_TRUE(payload_cid, fc::storage::unixfs::wrapFile(*ipld, input));
+
+  PieceIOImpl piece_io{ipld};
+  EXPECT_OUTCOME_ERROR(
+      PieceIOError::PAYLOAD_TOO_LARGE,
+      piece_io.stagePiece(
+          payload_cid,
+          {},
+          UnpaddedPieceSize{127},
+          [](const PieceData &) -> fc::outcome::result<PieceInfo> {
+            return PieceIOError::CANNOT_WRITE_PIPE;
+          }));
+}
@@ -0,0 +1,131 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "markets/retrieval/client/retrieval_sink.hpp"
+
+#include <gtest/gtest.h>
+
+#include "markets/retrieval/retrieval_client.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::markets::retrieval::Block;
+using fc::markets::retrieval::client::DealProfile;
+using fc::markets::retrieval::client::RetrievalClientError;
+using fc::markets::retrieval::client::RetrievalProgress;
+using fc::markets::retrieval::client::RetrievalSink;
+using fc::primitives::TokenAmount;
+using fc::storage::ipfs::InMemoryDatastore;
+
+class RetrievalSinkTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    profile.price_per_byte = 2;
+    // two blocks between payments
+    profile.payment_interval = 2 * kBlockBytes;
+    profile.payment_interval_increase = 0;
+    profile.total_funds = 1 << 20;
+    for (char i = 0; i < 5; ++i) {
+      blocks.push_back(Block::create(std::string(kBlockBytes - 2, 'a' + i)));
+    }
+  }
+
+  RetrievalSink sink(RetrievalProgress progress = {}) {
+    return RetrievalSink{
+        ipld,
+        profile,
+        progress,
+        [&](const CID &cid, uint64_t) { stored.push_back(cid); },
+        [&](const TokenAmount &total,
+            uint64_t bytes) -> fc::outcome::result<void> {
+          payments.push_back(bytes);
+          EXPECT_EQ(total, profile.price_per_byte * bytes);
+          return fc::outcome::success();
+        }};
+  }
+
+  /// Cbor string of 98 chars with 2 bytes header
+  static constexpr uint64_t kBlockBytes{100};
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  DealProfile profile;
+  std::vector<Block> blocks;
+  std::vector<CID> stored;
+  std::vector<uint64_t> payments;
+};
+
+/**
+ * @given retrieval of blocks
+ * @when all blocks are pushed
+ * @then blocks are stored and paid for each payment interval
+ */
+TEST_F(RetrievalSinkTest, StoresAndPays) {
+  auto retrieval{sink()};
+  for (auto &block : blocks) {
+    EXPECT_OUTCOME_TRUE_1(retrieval.push(block));
+  }
+  EXPECT_EQ(payments, (std::vector<uint64_t>{200, 400}));
+  EXPECT_OUTCOME_TRUE_1(retrieval.finish());
+  EXPECT_EQ(payments, (std::vector<uint64_t>{200, 400, 500}));
+  ASSERT_EQ(stored.size(), blocks.size());
+  for (auto &block : blocks) {
+    EXPECT_OUTCOME_EQ(ipld->contains(block.cid), true);
+  }
+  EXPECT_EQ(retrieval.progress().blocks, 5);
+  EXPECT_EQ(retrieval.progress().paid_bytes, 500);
+}
+
+/**
+ * @given block with bytes not matching its cid
+ * @when block is pushed
+ * @then retrieval fails
+ */
+TEST_F(RetrievalSinkTest, BadBlock) {
+  auto retrieval{sink()};
+  blocks[0].bytes[2] ^= 1;
+  EXPECT_OUTCOME_ERROR(RetrievalClientError::BAD_BLOCK,
+                       retrieval.push(blocks[0]));
+}
+
+/**
+ * @given retrieval interrupted after third block
+ * @when provider sends all blocks again
+ * @then stored blocks are skipped and not paid again
+ */
+TEST_F(RetrievalSinkTest, Resume) {
+  RetrievalProgress progress;
+  {
+    auto retrieval{sink()};
+    for (size_t i = 0; i < 3; ++i) {
+      EXPECT_OUTCOME_TRUE_1(retrieval.push(blocks[i]));
+    }
+    // third block was queued, not stored
+    progress = retrieval.progress();
+  }
+  EXPECT_EQ(progress.blocks, 2);
+  stored.clear();
+  auto retrieval{sink(progress)};
+  for (auto &block : blocks) {
+    EXPECT_OUTCOME_TRUE_1(retrieval.push(block));
+  }
+  EXPECT_OUTCOME_TRUE_1(retrieval.finish());
+  EXPECT_EQ(stored.size(), 3);
+  EXPECT_EQ(payments, (std::vector<uint64_t>{200, 400, 500}));
+}
+
+/**
+ * @given deal funds below price of data
+ * @when payment is due
+ * @then retrieval fails
+ */
+TEST_F(RetrievalSinkTest, FundsExpended) {
+  profile.total_funds = 300;
+  auto retrieval{sink()};
+  EXPECT_OUTCOME_TRUE_1(retrieval.push(blocks[0]));
+  EXPECT_OUTCOME_ERROR(RetrievalClientError::FUNDS_EXPENDED,
+                       retrieval.push(blocks[1]));
+}
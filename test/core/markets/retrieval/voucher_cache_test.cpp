@@ -0,0 +1,107 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "markets/retrieval/provider/voucher_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "codec/cbor/cbor.hpp"
+#include "crypto/bls/impl/bls_provider_impl.hpp"
+#include "crypto/secp256k1/impl/secp256k1_sha256_provider_impl.hpp"
+#include "storage/keystore/impl/in_memory/in_memory_keystore.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::markets::retrieval::provider {
+  using crypto::bls::BlsProviderImpl;
+  using crypto::secp256k1::Secp256k1Sha256ProviderImpl;
+  using storage::keystore::InMemoryKeyStore;
+  using vm::actor::builtin::payment_channel::Merge;
+
+  class VoucherCacheTest : public ::testing::Test {
+   public:
+    void SetUp() override {
+      auto secp{std::make_shared<Secp256k1Sha256ProviderImpl>()};
+      keystore = std::make_shared<InMemoryKeyStore>(
+          std::make_shared<BlsProviderImpl>(), secp);
+      auto keypair{secp->generate().value()};
+      client = Address::makeSecp256k1(keypair.public_key);
+      EXPECT_OUTCOME_TRUE_1(keystore->put(client, keypair.private_key));
+      cache = std::make_shared<VoucherCache>(keystore);
+      cache->addChannel(channel, client);
+    }
+
+    SignedVoucher sign(SignedVoucher voucher) {
+      auto bytes{codec::cbor::encode(voucher).value()};
+      voucher.signature = keystore->sign(client, bytes).value();
+      return voucher;
+    }
+
+    SignedVoucher voucher(LaneId lane, uint64_t nonce, TokenAmount amount) {
+      SignedVoucher voucher;
+      voucher.lane = lane;
+      voucher.nonce = nonce;
+      voucher.amount = amount;
+      return sign(voucher);
+    }
+
+    std::shared_ptr<KeyStore> keystore;
+    Address client;
+    Address channel{Address::makeFromId(100)};
+    std::shared_ptr<VoucherCache> cache;
+  };
+
+  /**
+   * @given channel with accepted voucher
+   * @when next vouchers of lane are added
+   * @then increments are returned, same voucher adds nothing
+   */
+  TEST_F(VoucherCacheTest, Incremental) {
+    auto first{voucher(0, 1, 10)};
+    EXPECT_OUTCOME_EQ(cache->add(channel, first), 10);
+    EXPECT_OUTCOME_EQ(cache->add(channel, first), 0);
+    EXPECT_OUTCOME_EQ(cache->add(channel, voucher(0, 2, 25)), 15);
+    EXPECT_OUTCOME_ERROR(VoucherError::STALE_NONCE,
+                         cache->add(channel, voucher(0, 2, 30)));
+    EXPECT_OUTCOME_ERROR(VoucherError::NOT_INCREASED,
+                         cache->add(channel, voucher(0, 3, 25)));
+    EXPECT_OUTCOME_EQ(cache->redeemable(channel), 25);
+  }
+
+  /**
+   * @given channel with two lanes
+   * @when voucher merges other lane
+   * @then redeemed amount of merged lane is subtracted
+   */
+  TEST_F(VoucherCacheTest, Merge) {
+    EXPECT_OUTCOME_EQ(cache->add(channel, voucher(0, 1, 10)), 10);
+    EXPECT_OUTCOME_EQ(cache->add(channel, voucher(1, 1, 5)), 5);
+    SignedVoucher merging;
+    merging.lane = 0;
+    merging.nonce = 2;
+    merging.amount = 20;
+    merging.merges = {Merge{1, 2}};
+    EXPECT_OUTCOME_EQ(cache->add(channel, sign(merging)), 5);
+    merging.nonce = 3;
+    merging.amount = 30;
+    EXPECT_OUTCOME_ERROR(VoucherError::INVALID_MERGE,
+                         cache->add(channel, sign(merging)));
+  }
+
+  /**
+   * @given voucher of channel
+   * @when signature doesn't match voucher or channel is unknown
+   * @then voucher is rejected
+   */
+  TEST_F(VoucherCacheTest, Rejected) {
+    auto forged{voucher(0, 1, 10)};
+    forged.amount = 100;
+    EXPECT_OUTCOME_ERROR(VoucherError::INVALID_SIGNATURE,
+                         cache->add(channel, forged));
+    EXPECT_OUTCOME_ERROR(
+        VoucherError::UNKNOWN_CHANNEL,
+        cache->add(Address::makeFromId(101), voucher(0, 1, 10)));
+    EXPECT_OUTCOME_EQ(cache->redeemable(channel), 0);
+  }
+}  // namespace fc::markets::retrieval::provider
@@ -0,0 +1,100 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "markets/storage/deal_index.hpp"
+
+#include <gtest/gtest.h>
+#include "testutil/literals.hpp"
+
+using fc::CID;
+using fc::markets::storage::ClientDeal;
+using fc::markets::storage::DealIndex;
+using fc::markets::storage::StorageDealStatus;
+using fc::primitives::address::Address;
+
+struct DealIndexTest : public ::testing::Test {
+  std::shared_ptr<ClientDeal> makeDeal(const CID &proposal_cid,
+                                       const CID &piece_cid,
+                                       uint64_t client) {
+    auto deal{std::make_shared<ClientDeal>()};
+    deal->proposal_cid = proposal_cid;
+    deal->client_deal_proposal.proposal.piece_cid = piece_cid;
+    deal->client_deal_proposal.proposal.client = Address::makeFromId(client);
+    deal->client_deal_proposal.proposal.provider = Address::makeFromId(100);
+    return deal;
+  }
+
+  DealIndex<ClientDeal> deals;
+  CID piece_a{"010001020001"_cid};
+  CID piece_b{"010001020002"_cid};
+  std::shared_ptr<ClientDeal> deal1{makeDeal("010001020011"_cid, piece_a, 1)};
+  std::shared_ptr<ClientDeal> deal2{makeDeal("010001020012"_cid, piece_a, 2)};
+  std::shared_ptr<ClientDeal> deal3{makeDeal("010001020013"_cid, piece_b, 1)};
+};
+
+/**
+ * @given deals in index
+ * @when deals change states
+ * @then indexes follow transitions, old state no longer lists deal
+ */
+TEST_F(DealIndexTest, Transitions) {
+  for (auto &deal : {deal1, deal2, deal3}) {
+    deals.update(deal, StorageDealStatus::STORAGE_DEAL_UNKNOWN);
+  }
+  EXPECT_EQ(deals.size(), 3);
+  EXPECT_EQ(deals.count(StorageDealStatus::STORAGE_DEAL_UNKNOWN), 3);
+
+  deals.update(deal2, StorageDealStatus::STORAGE_DEAL_PROPOSAL_ACCEPTED);
+  EXPECT_EQ(deals.size(), 3);
+  EXPECT_EQ(deals.count(StorageDealStatus::STORAGE_DEAL_UNKNOWN), 2);
+  auto accepted{
+      deals.byState(StorageDealStatus::STORAGE_DEAL_PROPOSAL_ACCEPTED)};
+  ASSERT_EQ(accepted.deals.size(), 1);
+  EXPECT_EQ(accepted.deals[0].proposal_cid, deal2->proposal_cid);
+  EXPECT_EQ(accepted.deals[0].state,
+            StorageDealStatus::STORAGE_DEAL_PROPOSAL_ACCEPTED);
+  EXPECT_EQ(deals.get(deal2->proposal_cid)->state,
+            StorageDealStatus::STORAGE_DEAL_PROPOSAL_ACCEPTED);
+  EXPECT_EQ(deals.entity(deal2->proposal_cid), deal2);
+
+  EXPECT_EQ(deals.byPiece(piece_a).deals.size(), 2);
+  EXPECT_EQ(deals.byPiece(piece_b).deals.size(), 1);
+  EXPECT_EQ(deals.byClient(Address::makeFromId(1)).deals.size(), 2);
+  EXPECT_EQ(deals.byProvider(Address::makeFromId(100)).deals.size(), 3);
+  EXPECT_TRUE(deals.byClient(Address::makeFromId(3)).deals.empty());
+  EXPECT_FALSE(deals.get("010001020099"_cid));
+}
+
+/**
+ * @given deals in index
+ * @when deals are listed by pages
+ * @then pages continue each other and cover all deals once
+ */
+TEST_F(DealIndexTest, Pages) {
+  for (auto &deal : {deal1, deal2, deal3}) {
+    deals.update(deal, StorageDealStatus::STORAGE_DEAL_UNKNOWN);
+  }
+  std::set<CID> seen;
+  boost::optional<CID> after;
+  size_t pages{};
+  do {
+    auto page{deals.list(after, 2)};
+    for (auto &deal : page.deals) {
+      EXPECT_TRUE(seen.insert(deal.proposal_cid).second);
+    }
+    after = page.next;
+    ++pages;
+  } while (after);
+  EXPECT_EQ(seen.size(), 3);
+  EXPECT_EQ(pages, 2);
+
+  auto first{deals.byPiece(piece_a, boost::none, 1)};
+  ASSERT_EQ(first.deals.size(), 1);
+  ASSERT_TRUE(first.next);
+  auto second{deals.byPiece(piece_a, first.next, 1)};
+  ASSERT_EQ(second.deals.size(), 1);
+  EXPECT_FALSE(second.next);
+  EXPECT_NE(first.deals[0].proposal_cid, second.deals[0].proposal_cid);
+}
@@ -9,6 +9,7 @@
 
 #include "power/impl/power_table_impl.hpp"
 #include "power/power_table_error.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "testutil/outcome.hpp"
 
 using fc::power::PowerTable;
@@ -16,6 +17,7 @@ using fc::power::PowerTableError;
 using fc::power::PowerTableImpl;
 using fc::primitives::address::Address;
 using fc::primitives::address::Network;
+using fc::storage::ipfs::InMemoryDatastore;
 
 class PowerTableTest : public ::testing::Test {
  public:
@@ -76,3 +78,55 @@ TEST_F(PowerTableTest, RemoveMiner_Success) {
   EXPECT_OUTCOME_ERROR(PowerTableError::NO_SUCH_MINER,
                        power_table.getMinerPower(addr));
 }
+
+/**
+ * @given table with miners
+ * @when change and remove miners
+ * @then max and total power follow changes
+ */
+TEST_F(PowerTableTest, MaxTotalPower) {
+  auto addr2 = Address::makeFromId(2);
+  EXPECT_OUTCOME_EQ(power_table.getMaxPower(), 0);
+  EXPECT_OUTCOME_TRUE_1(power_table.setMinerPower(addr, power));
+  EXPECT_OUTCOME_TRUE_1(power_table.setMinerPower(addr2, 20));
+  EXPECT_OUTCOME_EQ(power_table.getMaxPower(), 20);
+  EXPECT_OUTCOME_EQ(power_table.getTotalPower(), 30);
+
+  EXPECT_OUTCOME_TRUE_1(power_table.setMinerPower(addr, 30));
+  EXPECT_OUTCOME_EQ(power_table.getMaxPower(), 30);
+  EXPECT_OUTCOME_EQ(power_table.getTotalPower(), 50);
+
+  EXPECT_OUTCOME_TRUE_1(power_table.removeMiner(addr));
+  EXPECT_OUTCOME_EQ(power_table.getMaxPower(), 20);
+  EXPECT_OUTCOME_EQ(power_table.getTotalPower(), 20);
+  EXPECT_OUTCOME_EQ(power_table.getSize(), 1);
+}
+
+/**
+ * @given table built from claims
+ * @when claims are changed, added and removed
+ * @then table is updated from claims diff
+ */
+TEST_F(PowerTableTest, UpdateClaims) {
+  auto ipld = std::make_shared<InMemoryDatastore>();
+  auto addr2 = Address::makeFromId(2);
+  auto addr3 = Address::makeFromId(4);
+  PowerTableImpl::Claims before{ipld};
+  EXPECT_OUTCOME_TRUE_1(before.set(addr, {1, 10}));
+  EXPECT_OUTCOME_TRUE_1(before.set(addr2, {1, 20}));
+  EXPECT_OUTCOME_TRUE(root, before.hamt.flush());
+  EXPECT_OUTCOME_TRUE_1(power_table.updateClaims({ipld}, before));
+  EXPECT_OUTCOME_EQ(power_table.getTotalPower(), 30);
+
+  PowerTableImpl::Claims after{root, ipld};
+  EXPECT_OUTCOME_TRUE_1(after.set(addr, {1, 15}));
+  EXPECT_OUTCOME_TRUE_1(after.remove(addr2));
+  EXPECT_OUTCOME_TRUE_1(after.set(addr3, {1, 5}));
+  EXPECT_OUTCOME_TRUE_1(power_table.updateClaims(before, after));
+  EXPECT_OUTCOME_EQ(power_table.getMinerPower(addr), 15);
+  EXPECT_OUTCOME_EQ(power_table.getMinerPower(addr3), 5);
+  EXPECT_OUTCOME_ERROR(PowerTableError::NO_SUCH_MINER,
+                       power_table.getMinerPower(addr2));
+  EXPECT_OUTCOME_EQ(power_table.getMaxPower(), 15);
+  EXPECT_OUTCOME_EQ(power_table.getTotalPower(), 20);
+}
@@ -154,6 +154,21 @@ TEST_F(AddressCodecTest, RoundTripDecodeEncode) {
   }
 }
 
+/**
+ * @given A set of addresses encoded as bytes
+ * @when Encoding decoded addresses into fixed buffer
+ * @then Buffer bytes match the original bytes, equal addresses hash equally
+ */
+TEST_F(AddressCodecTest, AddressBytes) {
+  for (auto &[str, bytes] : knownAddresses) {
+    EXPECT_OUTCOME_TRUE(addr, decode(bytes));
+    auto view{fc::primitives::address::AddressBytes{addr}.view()};
+    EXPECT_EQ(std::vector<uint8_t>(view.begin(), view.end()), bytes);
+    EXPECT_OUTCOME_TRUE(addr2, decodeFromString(str));
+    EXPECT_EQ(std::hash<Address>{}(addr), std::hash<Address>{}(addr2));
+  }
+}
+
 // CBOR encoding/decoding to stream
 /**
  * @given An ID address and a Secp256k1 hash address
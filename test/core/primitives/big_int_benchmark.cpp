@@ -0,0 +1,86 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "codec/cbor/cbor.hpp"
+#include "primitives/big_int.hpp"
+
+using boost::multiprecision::cpp_int;
+using fc::primitives::BigInt;
+
+namespace {
+  /**
+   * Balance arithmetic of Env::applyMessage: gas cost, balance check,
+   * refund and reward
+   */
+  template <typename T>
+  void applyMessages(benchmark::State &state) {
+    T balance{"1000000000000000000000000000"};
+    T reward{0};
+    T value{"1000000000000000000"};
+    int64_t gas_limit{1000000};
+    for (auto _ : state) {
+      for (int64_t i{1}; i <= 1000; ++i) {
+        T gas_price{i * 1000};
+        T gas_cost = gas_limit * gas_price;
+        benchmark::DoNotOptimize(balance < gas_cost + value);
+        balance -= gas_cost;
+        auto gas_used{gas_limit / 2 + i};
+        balance += (gas_limit - gas_used) * gas_price;
+        reward += gas_used * gas_price;
+      }
+    }
+    benchmark::DoNotOptimize(reward);
+  }
+
+  /**
+   * Reward and power shares, products exceed 128 bits
+   */
+  template <typename T>
+  void rewardShares(benchmark::State &state) {
+    T total_reward{"36900000000000000000000000"};
+    T total_power{"1000000000000000000000"};
+    T paid{0};
+    for (auto _ : state) {
+      for (int64_t i{1}; i <= 1000; ++i) {
+        T power{T{i} << 60};
+        paid += total_reward * power / total_power;
+      }
+    }
+    benchmark::DoNotOptimize(paid);
+  }
+}  // namespace
+
+void LegacyApplyMessages(benchmark::State &state) {
+  applyMessages<cpp_int>(state);
+}
+BENCHMARK(LegacyApplyMessages);
+
+void ApplyMessages(benchmark::State &state) {
+  applyMessages<BigInt>(state);
+}
+BENCHMARK(ApplyMessages);
+
+void LegacyRewardShares(benchmark::State &state) {
+  rewardShares<cpp_int>(state);
+}
+BENCHMARK(LegacyRewardShares);
+
+void RewardShares(benchmark::State &state) {
+  rewardShares<BigInt>(state);
+}
+BENCHMARK(RewardShares);
+
+/// Encoding of actor balance
+void EncodeBalance(benchmark::State &state) {
+  BigInt balance{"1000000000000000000000000000"};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fc::codec::cbor::encode(balance));
+  }
+}
+BENCHMARK(EncodeBalance);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/cid/cb_cid.hpp"
+
+#include <gtest/gtest.h>
+#include <libp2p/multi/content_identifier_codec.hpp>
+
+#include "primitives/cid/cid_of_cbor.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CbCid;
+using fc::CID;
+using fc::CidSet;
+using fc::primitives::cid::getCidOfCbor;
+using libp2p::multi::ContentIdentifierCodec;
+using libp2p::multi::HashType;
+using libp2p::multi::Multihash;
+
+/**
+ * @given dag-cbor blake2b-256 cid
+ * @when make compact cid
+ * @then it has same binary encoding and converts back to same cid
+ */
+TEST(CbCidTest, Roundtrip) {
+  EXPECT_OUTCOME_TRUE(cid, getCidOfCbor(std::string("string1")));
+  auto compact{CbCid::make(cid)};
+  ASSERT_TRUE(compact);
+  EXPECT_EQ(compact->toCid(), cid);
+  EXPECT_OUTCOME_TRUE(expected, ContentIdentifierCodec::encode(cid));
+  auto bytes{compact->toBytes()};
+  EXPECT_EQ(std::vector<uint8_t>(bytes.begin(), bytes.end()), expected);
+  EXPECT_OUTCOME_EQ(cid.toBytes(), expected);
+  EXPECT_EQ(CbCid::fromBytes(expected), compact);
+  EXPECT_OUTCOME_EQ(CID::fromBytes(expected), cid);
+}
+
+/**
+ * @given cid of other codec
+ * @when make compact cid
+ * @then it is not compact
+ */
+TEST(CbCidTest, OtherCodec) {
+  EXPECT_OUTCOME_TRUE(cid, getCidOfCbor(std::string("string1")));
+  cid.content_type = CID::Multicodec::RAW;
+  EXPECT_FALSE(CbCid::make(cid));
+  EXPECT_OUTCOME_TRUE(bytes, cid.toBytes());
+  EXPECT_FALSE(CbCid::fromBytes(bytes));
+  EXPECT_OUTCOME_EQ(CID::fromBytes(bytes), cid);
+}
+
+/**
+ * @given set of compact and other cids
+ * @when insert cids twice
+ * @then each cid is inserted once
+ */
+TEST(CbCidTest, Set) {
+  EXPECT_OUTCOME_TRUE(cid1, getCidOfCbor(std::string("string1")));
+  EXPECT_OUTCOME_TRUE(
+      hash,
+      Multihash::create(HashType::sha256, cid1.content_address.getHash()));
+  CID cid2{CID::Version::V1, CID::Multicodec::DAG_CBOR, hash};
+  CidSet set;
+  EXPECT_TRUE(set.insert(cid1));
+  EXPECT_TRUE(set.insert(cid2));
+  EXPECT_FALSE(set.insert(cid1));
+  EXPECT_FALSE(set.insert(cid2));
+  EXPECT_EQ(set.count(cid1), 1);
+  EXPECT_EQ(set.count(cid2), 1);
+  EXPECT_EQ(set.size(), 2);
+}
@@ -0,0 +1,107 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/piece/comm_p_hasher.hpp"
+
+#include <gtest/gtest.h>
+
+#include "common/buffer.hpp"
+#include "primitives/piece/piece_error.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::common::Buffer;
+using fc::primitives::piece::CommPHasher;
+using fc::primitives::piece::PaddedPieceSize;
+using fc::primitives::piece::PieceError;
+using fc::primitives::piece::UnpaddedPieceSize;
+
+/// Non trivial bytes
+Buffer makeData(size_t size) {
+  Buffer data;
+  for (size_t i = 0; i < size; ++i) {
+    data.putUint8(i * 131 + 7);
+  }
+  return data;
+}
+
+/**
+ * @given empty hasher
+ * @when finish 2KiB piece
+ * @then commitment equals known zero piece commitment
+ */
+TEST(CommPHasherTest, ZeroPiece) {
+  CommPHasher hasher;
+  EXPECT_OUTCOME_TRUE(comm, hasher.finish(UnpaddedPieceSize{2032}));
+  EXPECT_EQ(
+      comm,
+      "fc7e928296e516faade986b28f92d44a4f24b935485223376a799027bc18f833"_blob32);
+}
+
+/**
+ * @given data written at once and in uneven chunks
+ * @when finish
+ * @then commitments are equal to reference of fr32 padded merkle tree
+ */
+TEST(CommPHasherTest, Chunks) {
+  auto data = makeData(5000);
+  CommPHasher whole;
+  whole.write(data);
+  CommPHasher chunked;
+  for (size_t offset = 0; offset < data.size(); offset += 777) {
+    chunked.write(gsl::make_span(data).subspan(
+        offset, std::min<size_t>(777, data.size() - offset)));
+  }
+  EXPECT_EQ(chunked.size(), data.size());
+  EXPECT_OUTCOME_TRUE(comm1, whole.finish(UnpaddedPieceSize{8128}));
+  EXPECT_OUTCOME_TRUE(comm2, chunked.finish(UnpaddedPieceSize{8128}));
+  EXPECT_EQ(comm1, comm2);
+  EXPECT_EQ(
+      comm1,
+      "205665cebba00a4363e70e54fc718e625b4e9c9d2f12ffacf7e944232319201c"_blob32);
+}
+
+/**
+ * @given data larger than piece
+ * @when finish
+ * @then error
+ */
+TEST(CommPHasherTest, DataExceedsSize) {
+  CommPHasher hasher;
+  hasher.write(makeData(1017));
+  EXPECT_OUTCOME_ERROR(PieceError::DATA_EXCEEDS_SIZE,
+                       hasher.finish(UnpaddedPieceSize{1016}));
+}
+
+/**
+ * @given commitments of 128 and 1024 bytes pieces
+ * @when add them to 4KiB tree
+ * @then second piece is aligned to its size and result equals commitment of
+ * zero padded layout
+ */
+TEST(CommPHasherTest, AddPiece) {
+  auto data = makeData(1016);
+  CommPHasher a;
+  a.write(gsl::make_span(data).first(127));
+  EXPECT_OUTCOME_TRUE(comm_a, a.finish(UnpaddedPieceSize{127}));
+  CommPHasher b;
+  b.write(data);
+  EXPECT_OUTCOME_TRUE(comm_b, b.finish(UnpaddedPieceSize{1016}));
+
+  CommPHasher sector;
+  EXPECT_OUTCOME_TRUE_1(sector.addPiece(comm_a, PaddedPieceSize{128}));
+  EXPECT_OUTCOME_TRUE_1(sector.addPiece(comm_b, PaddedPieceSize{1024}));
+  EXPECT_EQ(sector.size(), 2032);
+
+  CommPHasher layout;
+  layout.write(gsl::make_span(data).first(127));
+  layout.write(Buffer(1016 - 127, 0));
+  layout.write(data);
+  EXPECT_OUTCOME_TRUE(expected, layout.finish(UnpaddedPieceSize{4064}));
+  EXPECT_OUTCOME_EQ(sector.finish(UnpaddedPieceSize{4064}), expected);
+  EXPECT_EQ(
+      expected,
+      "06026598f88fcf2ef77acfc6a2e578a16551985b4faf9091c0a8392e2faabe2d"_blob32);
+}
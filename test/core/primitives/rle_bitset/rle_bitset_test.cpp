@@ -17,3 +17,77 @@ TEST(RleBitsetTest, RleBitsetCbor) {
   using fc::primitives::RleBitset;
   expectEncodeAndReencode(RleBitset{2, 7}, "43504a01"_unhex);
 }
+
+using fc::primitives::RleBitset;
+using Runs = RleBitset::Runs;
+
+/**
+ * @given rle bitset
+ * @when insert and erase values
+ * @then adjacent values are coalesced into runs @and erase splits runs
+ */
+TEST(RleBitsetTest, InsertErase) {
+  RleBitset set;
+  EXPECT_TRUE(set.insert(3));
+  EXPECT_TRUE(set.insert(1));
+  EXPECT_TRUE(set.insert(2));
+  EXPECT_FALSE(set.insert(2));
+  EXPECT_TRUE(set.insert(7));
+  EXPECT_EQ(set.runs(), (Runs{{1, 3}, {7, 1}}));
+  EXPECT_EQ(set.size(), 4u);
+  EXPECT_EQ(set.count(2), 1u);
+  EXPECT_EQ(set.count(5), 0u);
+  EXPECT_EQ(set.erase(2), 1u);
+  EXPECT_EQ(set.erase(2), 0u);
+  EXPECT_EQ(set.runs(), (Runs{{1, 1}, {3, 1}, {7, 1}}));
+  EXPECT_EQ(std::vector<uint64_t>(set.begin(), set.end()),
+            (std::vector<uint64_t>{1, 3, 7}));
+}
+
+/**
+ * @given two rle bitsets
+ * @when union, intersection and difference are computed
+ * @then results match element-wise set algebra
+ */
+TEST(RleBitsetTest, SetAlgebra) {
+  RleBitset a{RleBitset::Runs{{0, 10}, {20, 5}}};
+  RleBitset b{RleBitset::Runs{{5, 20}, {30, 1}}};
+  EXPECT_EQ((a | b).runs(), (Runs{{0, 25}, {30, 1}}));
+  EXPECT_EQ((a & b).runs(), (Runs{{5, 5}, {20, 5}}));
+  EXPECT_EQ((a - b).runs(), (Runs{{0, 5}}));
+  EXPECT_EQ((b - a).runs(), (Runs{{10, 10}, {30, 1}}));
+
+  auto c{a};
+  EXPECT_EQ(c.erase(b), 10u);
+  EXPECT_EQ(c, a - b);
+  c.insert(b);
+  EXPECT_EQ(c, a | b);
+}
+
+/**
+ * @given rle bitset
+ * @when slice by value positions
+ * @then values at given positions are returned
+ */
+TEST(RleBitsetTest, Slice) {
+  RleBitset set{RleBitset::Runs{{0, 3}, {10, 3}}};
+  EXPECT_EQ(set.slice(2, 2), (RleBitset{2, 10}));
+  EXPECT_EQ(set.slice(4, 10), (RleBitset{11, 12}));
+  EXPECT_TRUE(set.slice(6, 1).empty());
+}
+
+/**
+ * @given rle bitset
+ * @when take and skip consecutive slices with slicer
+ * @then slices are same as slices by position
+ */
+TEST(RleBitsetTest, Slicer) {
+  RleBitset set{RleBitset::Runs{{0, 3}, {10, 3}, {20, 1}}};
+  RleBitset::Slicer slicer{set};
+  EXPECT_EQ(slicer.take(2), set.slice(0, 2));
+  slicer.skip(2);
+  EXPECT_EQ(slicer.take(3), set.slice(4, 3));
+  EXPECT_TRUE(slicer.take(1).empty());
+  slicer.skip(1);
+  EXPECT_TRUE(slicer.take(1).empty());
+}
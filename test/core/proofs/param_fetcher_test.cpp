@@ -0,0 +1,129 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/param_fetcher.hpp"
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <boost/filesystem/fstream.hpp>
+
+#include "crypto/blake2/blake2b.h"
+#include "proofs/proof_param_provider_error.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+using fc::crypto::blake2b::Blake2b512Hash;
+using fc::proofs::FetchConfig;
+using fc::proofs::ParamFetcher;
+using fc::proofs::ProofParamProviderError;
+
+class ParamFetcherTest : public test::BaseFS_Test {
+ public:
+  static constexpr uint64_t kChunk{1000};
+
+  ParamFetcherTest() : test::BaseFS_Test("fc_param_fetcher_test") {
+    data.resize(5 * kChunk + 123);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = i * 7 + i / kChunk;
+    }
+  }
+
+  /// Fake gateways, "bad/" gateway fails, "good/" serves data
+  ParamFetcher fetcher() {
+    return ParamFetcher{
+        FetchConfig{{"bad/", "good/"}, 3, kChunk, 1},
+        [this](auto &url) -> fc::outcome::result<uint64_t> {
+          if (url != "good/cid") {
+            return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+          }
+          return data.size();
+        },
+        [this](auto &url, auto offset, auto size, auto sink)
+            -> fc::outcome::result<void> {
+          std::lock_guard lock{mutex};
+          if (url != "good/cid" || fail_chunks.count(offset / kChunk) != 0) {
+            return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+          }
+          fetched.insert(offset / kChunk);
+          // deliver in two parts like network
+          auto half = size / 2;
+          if (!sink(gsl::make_span(data).subspan(offset, half))
+              || !sink(gsl::make_span(data).subspan(offset + half,
+                                                    size - half))) {
+            return ProofParamProviderError::FAILED_DOWNLOADING_FILE;
+          }
+          return fc::outcome::success();
+        }};
+  }
+
+  Blake2b512Hash hash() {
+    Blake2b512Hash hash;
+    blake2b(hash.data(), hash.size(), nullptr, 0, data.data(), data.size());
+    return hash;
+  }
+
+  std::string read(const fs::path &file) {
+    fs::ifstream input{file, std::ios::binary};
+    return {std::istreambuf_iterator<char>{input}, {}};
+  }
+
+  std::vector<uint8_t> data;
+  std::mutex mutex;
+  std::set<uint64_t> fail_chunks;
+  std::set<uint64_t> fetched;
+};
+
+/**
+ * @given file of several chunks, first gateway failing
+ * @when fetch file
+ * @then file is downloaded from second gateway, hash is returned
+ */
+TEST_F(ParamFetcherTest, Fetch) {
+  auto path = (base_path / "file").string();
+  EXPECT_OUTCOME_EQ(fetcher().fetch("cid", path), hash());
+  EXPECT_EQ(read(path), std::string(data.begin(), data.end()));
+  EXPECT_EQ(fetched.size(), 6);
+  EXPECT_FALSE(fs::exists(path + ".part"));
+  EXPECT_FALSE(fs::exists(path + ".part.journal"));
+}
+
+/**
+ * @given download interrupted by failed chunk
+ * @when fetch file again
+ * @then only chunks not written before are fetched
+ */
+TEST_F(ParamFetcherTest, Resume) {
+  auto path = (base_path / "file").string();
+  fail_chunks = {2};
+  EXPECT_OUTCOME_ERROR(ProofParamProviderError::FAILED_DOWNLOADING_FILE,
+                       fetcher().fetch("cid", path));
+  EXPECT_TRUE(fs::exists(path + ".part.journal"));
+  EXPECT_FALSE(fs::exists(path));
+
+  auto before = fetched;
+  fetched.clear();
+  fail_chunks.clear();
+  EXPECT_OUTCOME_EQ(fetcher().fetch("cid", path), hash());
+  EXPECT_EQ(read(path), std::string(data.begin(), data.end()));
+  EXPECT_EQ(fetched.count(2), 1);
+  for (auto chunk : before) {
+    EXPECT_EQ(fetched.count(chunk), 0);
+  }
+  EXPECT_EQ(before.size() + fetched.size(), 6);
+}
+
+/**
+ * @given partial file of other size
+ * @when fetch file
+ * @then partial file is discarded and whole file is fetched
+ */
+TEST_F(ParamFetcherTest, SizeChanged) {
+  auto path = (base_path / "file").string();
+  fs::ofstream{path + ".part"} << "stale";
+  EXPECT_OUTCOME_EQ(fetcher().fetch("cid", path), hash());
+  EXPECT_EQ(read(path), std::string(data.begin(), data.end()));
+  EXPECT_EQ(fetched.size(), 6);
+}
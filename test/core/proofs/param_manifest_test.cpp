@@ -0,0 +1,75 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/param_manifest.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem/fstream.hpp>
+
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+using fc::proofs::ParamManifest;
+
+class ParamManifestTest : public test::BaseFS_Test {
+ public:
+  ParamManifestTest() : test::BaseFS_Test("fc_param_manifest_test") {}
+
+  void write(const std::string &content) {
+    fs::ofstream output{file, std::ios::binary | std::ios::trunc};
+    output << content;
+  }
+
+  std::string manifest_path{(base_path / "verified-params.json").string()};
+  std::string file{(base_path / "v28.params").string()};
+};
+
+/**
+ * @given file recorded as verified
+ * @when manifest is loaded again
+ * @then file is trusted with same digest only
+ */
+TEST_F(ParamManifestTest, Reload) {
+  write("params");
+  ParamManifest manifest{manifest_path};
+  EXPECT_FALSE(manifest.verified(file, "digest"));
+  manifest.add(file, "digest");
+  EXPECT_TRUE(manifest.verified(file, "digest"));
+  EXPECT_OUTCOME_TRUE_1(manifest.save());
+
+  ParamManifest loaded{manifest_path};
+  EXPECT_TRUE(loaded.verified(file, "digest"));
+  EXPECT_FALSE(loaded.verified(file, "other"));
+}
+
+/**
+ * @given file recorded as verified
+ * @when file is changed
+ * @then file is not trusted
+ */
+TEST_F(ParamManifestTest, Changed) {
+  write("params");
+  ParamManifest manifest{manifest_path};
+  manifest.add(file, "digest");
+  write("changed params");
+  EXPECT_FALSE(manifest.verified(file, "digest"));
+  fs::remove(file);
+  EXPECT_FALSE(manifest.verified(file, "digest"));
+}
+
+/**
+ * @given malformed manifest
+ * @when it is loaded
+ * @then it is empty
+ */
+TEST_F(ParamManifestTest, Malformed) {
+  write("params");
+  {
+    fs::ofstream output{fs::path{manifest_path}};
+    output << "{not json";
+  }
+  ParamManifest manifest{manifest_path};
+  EXPECT_FALSE(manifest.verified(file, "digest"));
+}
@@ -0,0 +1,114 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/proof_service.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/optional.hpp>
+#include <future>
+#include <thread>
+
+#include "testutil/outcome.hpp"
+
+using fc::outcome::result;
+using fc::proofs::ProofCall;
+using fc::proofs::ProofOperation;
+using fc::proofs::ProofService;
+using fc::proofs::ProofServiceError;
+using State = ProofCall::State;
+
+/**
+ * @given proof service
+ * @when call is run
+ * @then callback gets result of call
+ */
+TEST(ProofService, Result) {
+  ProofService service;
+  std::promise<result<int>> promise;
+  auto call{service.run<int>(
+      ProofOperation::VERIFY,
+      [] { return 42; },
+      [&](auto result) { promise.set_value(std::move(result)); })};
+  EXPECT_OUTCOME_EQ(promise.get_future().get(), 42);
+  EXPECT_EQ(call->state(), State::DONE);
+  EXPECT_FALSE(call->cancel());
+}
+
+/**
+ * @given operation limited to one call
+ * @when calls are run
+ * @then calls don't overlap
+ */
+TEST(ProofService, Limit) {
+  ProofService service{{{ProofOperation::SEAL_PRE_COMMIT_1, 1}}};
+  std::atomic_int running{0}, max_running{0};
+  std::vector<std::future<void>> done;
+  for (auto i{0}; i < 4; ++i) {
+    auto promise{std::make_shared<std::promise<void>>()};
+    done.push_back(promise->get_future());
+    service.run<int>(
+        ProofOperation::SEAL_PRE_COMMIT_1,
+        [&] {
+          auto now{++running};
+          auto max{max_running.load()};
+          while (now > max && !max_running.compare_exchange_weak(max, now)) {
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds{5});
+          --running;
+          return 0;
+        },
+        [promise](auto) { promise->set_value(); });
+  }
+  for (auto &future : done) {
+    future.get();
+  }
+  EXPECT_EQ(max_running, 1);
+}
+
+/**
+ * @given call waiting for busy thread
+ * @when call is cancelled
+ * @then callback gets CANCELLED at once and call never starts
+ */
+TEST(ProofService, CancelQueued) {
+  ProofService service;
+  std::promise<void> gate;
+  auto gate_future{gate.get_future().share()};
+  std::promise<void> first_done;
+  service.run<int>(
+      ProofOperation::UNSEAL,
+      [gate_future] {
+        gate_future.wait();
+        return 1;
+      },
+      [&](auto) { first_done.set_value(); });
+
+  auto started{false};
+  boost::optional<result<int>> second;
+  auto call{service.run<int>(
+      ProofOperation::UNSEAL,
+      [&] {
+        started = true;
+        return 2;
+      },
+      [&](auto result) { second = std::move(result); })};
+  EXPECT_EQ(call->state(), State::QUEUED);
+  EXPECT_TRUE(call->cancel());
+  EXPECT_EQ(call->state(), State::CANCELLED);
+  ASSERT_TRUE(second);
+  EXPECT_OUTCOME_ERROR(ProofServiceError::CANCELLED, *second);
+  EXPECT_FALSE(call->cancel());
+
+  gate.set_value();
+  first_done.get_future().get();
+  // one thread, second call is dequeued after first
+  std::promise<void> flushed;
+  service.run<int>(
+      ProofOperation::UNSEAL,
+      [] { return 3; },
+      [&](auto) { flushed.set_value(); });
+  flushed.get_future().get();
+  EXPECT_FALSE(started);
+}
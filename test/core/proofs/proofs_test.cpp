@@ -5,6 +5,7 @@
 
 #include "proofs/proofs.hpp"
 
+#include <fstream>
 #include <random>
 
 #include <gtest/gtest.h>
@@ -12,6 +13,7 @@
 #include "primitives/piece/piece.hpp"
 #include "primitives/piece/piece_data.hpp"
 #include "primitives/sector/sector.hpp"
+#include "proofs/native_proofs.hpp"
 #include "proofs/proof_param_provider.hpp"
 #include "storage/filestore/impl/filesystem/filesystem_file.hpp"
 #include "testutil/outcome.hpp"
@@ -32,6 +34,7 @@ using fc::primitives::sector::SectorId;
 using fc::primitives::sector::SectorInfo;
 using fc::primitives::sector::Ticket;
 using fc::proofs::ActorId;
+using fc::proofs::NativeProofs;
 using fc::proofs::PieceInfo;
 using fc::proofs::PoStCandidate;
 using fc::proofs::PrivateSectorInfo;
@@ -340,3 +343,104 @@ TEST_F(ProofsTest, Lifecycle) {
                       }));
   ASSERT_TRUE(res);
 }
+
+/**
+ * @given pieces of random data
+ * @when compute piece and unsealed CIDs natively
+ * @then CIDs are equal to ffi ones
+ */
+TEST_F(ProofsTest, NativeCommitments) {
+  using fc::primitives::sector::RegisteredProof;
+  // pieces larger than 2KiB sector are hashed with 8MiB proof type
+  auto proof_type = RegisteredProof::StackedDRG8MiBSeal;
+  auto sector_proof_type = RegisteredProof::StackedDRG2KiBSeal;
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<uint16_t> dis(0, 255);
+  auto path_model = fs::canonical(base_path).append("%%%%%");
+
+  std::vector<PieceInfo> pieces;
+  // last piece spans multiple parallel subtrees
+  for (uint64_t size : {127, 1000, 1016, 3 * 1040384 + 5}) {
+    std::vector<uint8_t> data(size);
+    for (auto &byte : data) {
+      byte = dis(gen);
+    }
+    Path path = boost::filesystem::unique_path(path_model).string();
+    std::ofstream{path, std::ios::binary}.write(
+        reinterpret_cast<const char *>(data.data()), data.size());
+    UnpaddedPieceSize piece_size{size};
+
+    EXPECT_OUTCOME_TRUE(
+        ffi_cid,
+        Proofs::generatePieceCIDFromFile(proof_type, path, piece_size));
+    EXPECT_OUTCOME_EQ(NativeProofs::generatePieceCIDFromFile(path, piece_size),
+                      ffi_cid);
+    EXPECT_OUTCOME_EQ(NativeProofs::generatePieceCID(data, piece_size),
+                      ffi_cid);
+    if (pieces.size() < 2) {
+      pieces.emplace_back(piece_size.padded(), ffi_cid);
+    }
+  }
+
+  // second piece is aligned after first one
+  for (auto n : {1, 2}) {
+    auto some = gsl::make_span(pieces).first(n);
+    EXPECT_OUTCOME_TRUE(ffi_cid,
+                        Proofs::generateUnsealedCID(sector_proof_type, some));
+    EXPECT_OUTCOME_EQ(
+        NativeProofs::generateUnsealedCID(sector_proof_type, some), ffi_cid);
+  }
+}
+
+/**
+ * @given pieces of random data
+ * @when write them to staged sector natively and by ffi
+ * @then staged sectors and results are equal
+ */
+TEST_F(ProofsTest, NativeWriteWithAlignment) {
+  using fc::primitives::sector::RegisteredProof;
+  auto proof_type = RegisteredProof::StackedDRG8MiBSeal;
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<uint16_t> dis(0, 255);
+  auto path_model = fs::canonical(base_path).append("%%%%%");
+  Path ffi_staged = boost::filesystem::unique_path(path_model).string();
+  Path native_staged = boost::filesystem::unique_path(path_model).string();
+  boost::filesystem::ofstream(ffi_staged).close();
+
+  std::vector<UnpaddedPieceSize> existing;
+  // second piece is aligned, last piece spans multiple chunks
+  for (uint64_t size : {127, 1016, 4 * 1040384}) {
+    std::vector<uint8_t> data(size);
+    for (auto &byte : data) {
+      byte = dis(gen);
+    }
+    Path path = boost::filesystem::unique_path(path_model).string();
+    std::ofstream{path, std::ios::binary}.write(
+        reinterpret_cast<const char *>(data.data()), data.size());
+    UnpaddedPieceSize piece_size{size};
+
+    EXPECT_OUTCOME_TRUE(ffi,
+                        Proofs::writeWithAlignment(proof_type,
+                                                   PieceData{path},
+                                                   piece_size,
+                                                   ffi_staged,
+                                                   existing));
+    EXPECT_OUTCOME_TRUE(native,
+                        NativeProofs::writeWithAlignment(proof_type,
+                                                         PieceData{path},
+                                                         piece_size,
+                                                         native_staged,
+                                                         existing,
+                                                         4));
+    EXPECT_EQ(native.left_alignment_unpadded, ffi.left_alignment_unpadded);
+    EXPECT_EQ(native.total_write_unpadded, ffi.total_write_unpadded);
+    EXPECT_EQ(native.piece_cid, ffi.piece_cid);
+    existing.push_back(piece_size);
+  }
+
+  auto read = [](const Path &path) {
+    std::ifstream file{path, std::ios::binary};
+    return std::string{std::istreambuf_iterator<char>{file}, {}};
+  };
+  EXPECT_EQ(read(native_staged), read(ffi_staged));
+}
@@ -0,0 +1,142 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/window_post.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <boost/filesystem/fstream.hpp>
+
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+using fc::primitives::sector::PoStProof;
+using fc::primitives::sector::RegisteredProof;
+using fc::proofs::PoStRandomness;
+using fc::proofs::PrivateSectorInfo;
+using fc::proofs::ProofsError;
+using fc::proofs::SortedPrivateSectorInfo;
+using fc::proofs::WindowPoStDriver;
+
+class WindowPoStTest : public test::BaseFS_Test {
+ public:
+  WindowPoStTest() : test::BaseFS_Test("fc_window_post_test") {}
+
+  /// Writes files of sector, cache files are omitted for faulty sector
+  PrivateSectorInfo sector(uint64_t number, bool faulty = false) {
+    auto name = std::to_string(number);
+    auto cache = base_path / ("cache-" + name);
+    fs::create_directories(cache);
+    fs::ofstream{base_path / ("sealed-" + name)} << "sealed";
+    if (!faulty) {
+      fs::ofstream{cache / "p_aux"} << "p_aux";
+      fs::ofstream{cache / "t_aux"} << "t_aux";
+    }
+    return {
+        {RegisteredProof::StackedDRG2KiBSeal,
+         number,
+         "010001020001"_cid},
+        cache.string(),
+        RegisteredProof::StackedDRG2KiBWindowPoSt,
+        (base_path / ("sealed-" + name)).string(),
+    };
+  }
+
+  /// Fake prover, proof of partition lists its sector numbers
+  WindowPoStDriver::ProveFunction prove() {
+    return [this](auto, const SortedPrivateSectorInfo &sectors, auto &)
+               -> fc::outcome::result<std::vector<PoStProof>> {
+      auto now = ++running;
+      auto max = max_running.load();
+      while (now > max && !max_running.compare_exchange_weak(max, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds{50});
+      --running;
+      if (fail) {
+        return ProofsError::UNKNOWN;
+      }
+      PoStProof proof{RegisteredProof::StackedDRG2KiBWindowPoSt, {}};
+      for (auto &sector : sectors.values) {
+        proof.proof.push_back(sector.info.sector);
+      }
+      std::sort(proof.proof.begin(), proof.proof.end());
+      return std::vector<PoStProof>{proof};
+    };
+  }
+
+  PoStRandomness randomness;
+  std::atomic_size_t running{}, max_running{};
+  bool fail{};
+};
+
+/**
+ * @given five sectors of 2KiB, two per partition, one sector without cache
+ * @when generate window PoSt
+ * @then three partitions are proven, faulty sector is skipped
+ */
+TEST_F(WindowPoStTest, Partitions) {
+  std::vector<PrivateSectorInfo> sectors{
+      sector(1), sector(2), sector(3, true), sector(4), sector(5)};
+  WindowPoStDriver driver{{1}, prove()};
+  EXPECT_OUTCOME_TRUE(result, driver.generate(1000, sectors, randomness));
+  ASSERT_EQ(result.partitions.size(), 3);
+
+  EXPECT_EQ(result.partitions[0].sectors, (std::vector<uint64_t>{1, 2}));
+  EXPECT_EQ(result.partitions[1].sectors, (std::vector<uint64_t>{4}));
+  EXPECT_EQ(result.partitions[1].faults, (std::vector<uint64_t>{3}));
+  EXPECT_EQ(result.partitions[2].sectors, (std::vector<uint64_t>{5}));
+  ASSERT_EQ(result.partitions[0].proofs.size(), 1);
+  EXPECT_EQ(result.partitions[0].proofs[0].proof,
+            (std::vector<uint8_t>{1, 2}));
+  EXPECT_EQ(result.partitions[1].proofs[0].proof, (std::vector<uint8_t>{4}));
+  EXPECT_EQ(max_running, 1);
+}
+
+/**
+ * @given partition with only faulty sector
+ * @when generate window PoSt
+ * @then partition has no proofs, prover is not called
+ */
+TEST_F(WindowPoStTest, AllFaulty) {
+  std::vector<PrivateSectorInfo> sectors{sector(1, true)};
+  WindowPoStDriver driver{{1}, prove()};
+  EXPECT_OUTCOME_TRUE(result, driver.generate(1000, sectors, randomness));
+  ASSERT_EQ(result.partitions.size(), 1);
+  EXPECT_TRUE(result.partitions[0].proofs.empty());
+  EXPECT_EQ(result.partitions[0].faults, (std::vector<uint64_t>{1}));
+  EXPECT_EQ(max_running, 0);
+}
+
+/**
+ * @given four partitions and two prove threads
+ * @when generate window PoSt
+ * @then two partitions are proven at once
+ */
+TEST_F(WindowPoStTest, Concurrent) {
+  std::vector<PrivateSectorInfo> sectors;
+  for (uint64_t i = 0; i < 8; ++i) {
+    sectors.push_back(sector(i));
+  }
+  WindowPoStDriver driver{{2}, prove()};
+  EXPECT_EQ(driver.proveThreads(), 2);
+  EXPECT_OUTCOME_TRUE(result, driver.generate(1000, sectors, randomness));
+  EXPECT_EQ(result.partitions.size(), 4);
+  EXPECT_EQ(max_running, 2);
+}
+
+/**
+ * @given prover failing
+ * @when generate window PoSt
+ * @then error is returned
+ */
+TEST_F(WindowPoStTest, ProveError) {
+  std::vector<PrivateSectorInfo> sectors{sector(1), sector(2), sector(3)};
+  fail = true;
+  WindowPoStDriver driver{{2}, prove()};
+  EXPECT_OUTCOME_ERROR(ProofsError::UNKNOWN,
+                       driver.generate(1000, sectors, randomness));
+}
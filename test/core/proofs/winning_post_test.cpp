@@ -0,0 +1,133 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "proofs/winning_post.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem/fstream.hpp>
+
+#include "proofs/proofs_error.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+using fc::primitives::sector::PoStProof;
+using fc::primitives::sector::RegisteredProof;
+using fc::proofs::ChallengeIndexes;
+using fc::proofs::PoStRandomness;
+using fc::proofs::PrivateSectorInfo;
+using fc::proofs::ProofsError;
+using fc::proofs::SortedPrivateSectorInfo;
+using fc::proofs::WinningPoStDriver;
+
+class WinningPoStTest : public test::BaseFS_Test {
+ public:
+  WinningPoStTest() : test::BaseFS_Test("fc_winning_post_test") {}
+
+  void SetUp() override {
+    BaseFS_Test::SetUp();
+    for (uint64_t i = 0; i < 3; ++i) {
+      sectors.push_back(sector(i));
+    }
+    randomness[0] = 1;
+  }
+
+  PrivateSectorInfo sector(uint64_t number) {
+    auto name = std::to_string(number);
+    auto cache = base_path / ("cache-" + name);
+    fs::create_directories(cache);
+    return {
+        {RegisteredProof::StackedDRG2KiBSeal, number, "010001020001"_cid},
+        cache.string(),
+        RegisteredProof::StackedDRG2KiBWinningPoSt,
+        (base_path / ("sealed-" + name)).string(),
+    };
+  }
+
+  /// Fake challenge, challenges sector with index of first randomness byte
+  WinningPoStDriver::ChallengeFunction challenge() {
+    return [this](auto, auto, const PoStRandomness &randomness, auto)
+               -> fc::outcome::result<ChallengeIndexes> {
+      ++challenges;
+      return ChallengeIndexes{randomness[0]};
+    };
+  }
+
+  /// Fake prover, proof lists challenged sector numbers
+  WinningPoStDriver::ProveFunction prove() {
+    return [](auto, const SortedPrivateSectorInfo &sectors, auto &)
+               -> fc::outcome::result<std::vector<PoStProof>> {
+      PoStProof proof{RegisteredProof::StackedDRG2KiBWinningPoSt, {}};
+      for (auto &sector : sectors.values) {
+        proof.proof.push_back(sector.info.sector);
+      }
+      return std::vector<PoStProof>{proof};
+    };
+  }
+
+  std::vector<PrivateSectorInfo> sectors;
+  PoStRandomness randomness{};
+  size_t challenges{};
+};
+
+/**
+ * @given challenge prepared for randomness
+ * @when generate proof with same randomness
+ * @then prepared challenge is used, latency is counted
+ */
+TEST_F(WinningPoStTest, Prepared) {
+  WinningPoStDriver driver{challenge(), prove()};
+  EXPECT_OUTCOME_TRUE_1(driver.prepare(1000, sectors, randomness));
+  EXPECT_OUTCOME_TRUE(proofs, driver.generate(1000, sectors, randomness));
+  ASSERT_EQ(proofs.size(), 1);
+  EXPECT_EQ(proofs[0].proof, (std::vector<uint8_t>{1}));
+  EXPECT_EQ(challenges, 1);
+
+  auto stats = driver.stats();
+  EXPECT_EQ(stats.proofs, 1);
+  EXPECT_EQ(stats.prepared, 1);
+  EXPECT_EQ(stats.total_latency, stats.last_latency);
+}
+
+/**
+ * @given challenge prepared for other randomness
+ * @when generate proof
+ * @then challenge is computed again
+ */
+TEST_F(WinningPoStTest, NotPrepared) {
+  WinningPoStDriver driver{challenge(), prove()};
+  EXPECT_OUTCOME_TRUE_1(driver.prepare(1000, sectors, randomness));
+  randomness[0] = 2;
+  EXPECT_OUTCOME_TRUE(proofs, driver.generate(1000, sectors, randomness));
+  EXPECT_EQ(proofs[0].proof, (std::vector<uint8_t>{2}));
+  EXPECT_EQ(challenges, 2);
+  EXPECT_EQ(driver.stats().prepared, 0);
+}
+
+/**
+ * @given challenge index out of eligible sectors
+ * @when prepare challenge
+ * @then error is returned
+ */
+TEST_F(WinningPoStTest, InvalidChallenge) {
+  WinningPoStDriver driver{challenge(), prove()};
+  randomness[0] = 3;
+  EXPECT_OUTCOME_ERROR(ProofsError::INVALID_CHALLENGE,
+                       driver.prepare(1000, sectors, randomness));
+}
+
+/**
+ * @given sector cache with proving and other files
+ * @when prefetch sector
+ * @then only proving files are prefetched
+ */
+TEST_F(WinningPoStTest, Prefetch) {
+  fs::path cache{sectors[0].cache_dir_path};
+  fs::ofstream{cache / "p_aux"} << "p_aux";
+  fs::ofstream{cache / "t_aux"} << "t_aux";
+  fs::ofstream{cache / "sc-02-data-tree-r-last.dat"} << "tree-r-last";
+  fs::ofstream{cache / "sc-02-data-tree-c.dat"} << "tree-c";
+  EXPECT_EQ(WinningPoStDriver::prefetchSector(sectors[0]), 5 + 5 + 11);
+}
@@ -0,0 +1,98 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/finalize_queue.hpp"
+
+#include <future>
+
+#include <gtest/gtest.h>
+#include <boost/filesystem/fstream.hpp>
+
+#include "sector_storage/sector_storage_error.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+namespace fc::sector_storage {
+
+  class FinalizeQueueTest : public test::BaseFS_Test {
+   public:
+    FinalizeQueueTest() : test::BaseFS_Test("fc_finalize_queue_test") {
+      cache = createDir("cache");
+    }
+
+    /// Creates sparse file of size in cache
+    void file(const std::string &name, uint64_t size) {
+      boost::filesystem::ofstream{cache / name};
+      boost::filesystem::resize_file(cache / name, size);
+    }
+
+    SectorId sector{1, 2};
+    fs::path cache;
+  };
+
+  /**
+   * @given cache with layers and aux file, queue trimming in small steps
+   * @when sector is queued
+   * @then push returns before job, job sees truncated layers, reclaimed
+   * space is reported to callback and hook
+   */
+  TEST_F(FinalizeQueueTest, TrimsLayers) {
+    constexpr uint64_t kLayer = 3 << 20;
+    file(std::string{FinalizeQueue::kLayerPrefix} + "1.dat", kLayer);
+    file(std::string{FinalizeQueue::kLayerPrefix} + "2.dat", kLayer);
+    file("p_aux", 100);
+
+    std::promise<void> started;
+    auto allow{started.get_future().share()};
+    uint64_t hook{};
+    std::promise<outcome::result<uint64_t>> done;
+    {
+      FinalizeQueue queue{{1, 0, 1 << 20},
+                          [&](uint64_t reclaimed) { hook = reclaimed; }};
+      queue.push(
+          sector,
+          cache.string(),
+          [&]() -> outcome::result<void> {
+            allow.wait();
+            for (auto i : {"1.dat", "2.dat"}) {
+              auto layer{cache
+                         / (FinalizeQueue::kLayerPrefix + std::string{i})};
+              EXPECT_EQ(fs::file_size(layer), 0);
+              fs::remove(layer);
+            }
+            return outcome::success();
+          },
+          [&](auto reclaimed) { done.set_value(reclaimed); });
+      EXPECT_EQ(queue.queued(), 1);
+      started.set_value();
+    }
+
+    EXPECT_OUTCOME_EQ(done.get_future().get(), 2 * kLayer);
+    EXPECT_EQ(hook, 2 * kLayer);
+    EXPECT_TRUE(fs::exists(cache / "p_aux"));
+  }
+
+  /**
+   * @given queue
+   * @when job fails
+   * @then error is passed to callback, nothing is reported as reclaimed
+   */
+  TEST_F(FinalizeQueueTest, JobError) {
+    bool hooked{false};
+    std::promise<outcome::result<uint64_t>> done;
+    {
+      FinalizeQueue queue{{}, [&](uint64_t) { hooked = true; }};
+      queue.push(
+          sector,
+          cache.string(),
+          []() -> outcome::result<void> {
+            return SectorStorageError::CANNOT_OPEN_FILE;
+          },
+          [&](auto result) { done.set_value(result); });
+    }
+    EXPECT_FALSE(done.get_future().get());
+    EXPECT_FALSE(hooked);
+  }
+}  // namespace fc::sector_storage
@@ -0,0 +1,121 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/message_batcher.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+
+#include "common/todo_error.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::sector_storage {
+  using crypto::signature::Signature;
+  using vm::message::SignedMessage;
+  using BlsSignature = crypto::bls::Signature;
+
+  class MessageBatcherTest : public ::testing::Test {
+   public:
+    void SetUp() override {
+      api->MpoolGetNonce = {[this](auto &) -> outcome::result<uint64_t> {
+        ++nonce_calls;
+        return 5;
+      }};
+      api->WalletSign = {
+          [](auto &, auto &) -> outcome::result<Signature> {
+            return Signature{BlsSignature{}};
+          }};
+      api->MpoolPush = {[this](auto &message) -> outcome::result<CID> {
+        if (fail_push) {
+          fail_push = false;
+          return TodoError::ERROR;
+        }
+        pushed.push_back(message.message.nonce);
+        return message.getCid();
+      }};
+    }
+
+    UnsignedMessage message(GasAmount gas) {
+      UnsignedMessage message;
+      message.from = Address::makeFromId(1000);
+      message.to = Address::makeFromId(1001);
+      message.gasLimit = gas;
+      return message;
+    }
+
+    boost::asio::io_context io;
+    std::shared_ptr<Api> api{std::make_shared<Api>()};
+    std::shared_ptr<MsgWaiter> msg_waiter{
+        std::make_shared<MsgWaiter>(nullptr)};
+    std::shared_ptr<MessageBatcher> batcher{
+        MessageBatcher::create(api,
+                               msg_waiter,
+                               io.get_executor(),
+                               {.max_delay = std::chrono::seconds{60},
+                                .max_messages = 2,
+                                .max_gas = 100})};
+    size_t nonce_calls{};
+    bool fail_push{false};
+    std::vector<uint64_t> pushed;
+  };
+
+  /**
+   * @given batcher of two messages
+   * @when three messages are pushed
+   * @then full batch is sent with local nonces, rest is sent by flush, and
+   * callbacks get receipts from message waiter
+   */
+  TEST_F(MessageBatcherTest, BatchAndNonces) {
+    size_t included{};
+    auto callback{[&](auto result) {
+      EXPECT_TRUE(result);
+      ++included;
+    }};
+    batcher->push(message(10), callback);
+    io.poll();
+    EXPECT_TRUE(pushed.empty());
+    batcher->push(message(10), callback);
+    io.poll();
+    EXPECT_EQ(pushed, (std::vector<uint64_t>{5, 6}));
+    batcher->push(message(10), callback);
+    batcher->flush();
+    io.poll();
+    EXPECT_EQ(pushed, (std::vector<uint64_t>{5, 6, 7}));
+    EXPECT_EQ(nonce_calls, 1);
+
+    EXPECT_EQ(msg_waiter->waiting.size(), 3);
+    for (auto &[cid, callbacks] : msg_waiter->waiting) {
+      for (auto &waiting : callbacks) {
+        waiting({});
+      }
+    }
+    EXPECT_EQ(included, 3);
+  }
+
+  /**
+   * @given batcher with gas window
+   * @when message doesn't fit into gas of queued batch, and push fails
+   * @then queued batch is sent first, failed message gets error, nonce is
+   * asked from pool again, message with gas of whole batch is sent alone
+   */
+  TEST_F(MessageBatcherTest, GasAndFailure) {
+    size_t failed{};
+    batcher->push(message(60), [&](auto result) {
+      EXPECT_FALSE(result);
+      ++failed;
+    });
+    io.poll();
+    EXPECT_TRUE(pushed.empty());
+    fail_push = true;
+    batcher->push(message(60), [](auto) {});
+    io.poll();
+    EXPECT_EQ(failed, 1);
+    EXPECT_TRUE(pushed.empty());
+    batcher->push(message(100), [](auto) {});
+    io.poll();
+    EXPECT_EQ(pushed, (std::vector<uint64_t>{5, 6}));
+    EXPECT_EQ(nonce_calls, 2);
+  }
+}  // namespace fc::sector_storage
@@ -0,0 +1,58 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/numa.hpp"
+
+#include <gtest/gtest.h>
+
+using fc::sector_storage::numa::Binding;
+using fc::sector_storage::numa::HugeBuffer;
+using fc::sector_storage::numa::kHugePage;
+using fc::sector_storage::numa::nodes;
+using fc::sector_storage::numa::parseCpuList;
+
+/// Ranges and single cpus of sysfs list are expanded
+TEST(NumaTest, ParseCpuList) {
+  EXPECT_EQ(parseCpuList("0-3,8,10-11"),
+            (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_EQ(parseCpuList("5"), std::vector<int>{5});
+  EXPECT_TRUE(parseCpuList("").empty());
+  EXPECT_TRUE(parseCpuList("x-1").empty());
+}
+
+/// Every cpu belongs to some node
+TEST(NumaTest, Nodes) {
+  ASSERT_FALSE(nodes().empty());
+  for (auto &node : nodes()) {
+    EXPECT_FALSE(node.cpus.empty());
+  }
+}
+
+/// Binding restores affinity of thread
+TEST(NumaTest, BindingRestores) {
+  cpu_set_t before, after;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+  {
+    Binding binding{nodes().size() - 1};
+    EXPECT_EQ(binding.bound(), nodes().size() > 1);
+  }
+  {
+    // out of range node is not bound
+    Binding binding{nodes().size()};
+    EXPECT_FALSE(binding.bound());
+  }
+  ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+  EXPECT_TRUE(CPU_EQUAL(&before, &after));
+}
+
+/// Buffer is usable without reserved hugepages
+TEST(NumaTest, HugeBuffer) {
+  HugeBuffer buffer{100};
+  ASSERT_NE(buffer.data(), nullptr);
+  EXPECT_EQ(buffer.size(), kHugePage);
+  buffer.data()[0] = 1;
+  buffer.data()[buffer.size() - 1] = 2;
+  EXPECT_EQ(HugeBuffer{0}.data(), nullptr);
+}
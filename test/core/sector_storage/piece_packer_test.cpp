@@ -0,0 +1,84 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/piece_packer.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/outcome.hpp"
+
+using fc::sector_storage::packPieces;
+using fc::sector_storage::paddingPieces;
+using fc::sector_storage::PackedSector;
+using fc::sector_storage::PaddedPieceSize;
+using fc::sector_storage::PendingPiece;
+using fc::sector_storage::PiecePackerError;
+
+constexpr uint64_t kSectorSize{2048};
+
+/**
+ * @given small pieces of several deals
+ * @when pack them into sectors
+ * @then pieces are placed largest first, aligned and without gaps
+ */
+TEST(PiecePacker, PacksDecreasing) {
+  std::vector<PendingPiece> pieces{{1, PaddedPieceSize{256}},
+                                   {2, PaddedPieceSize{1024}},
+                                   {3, PaddedPieceSize{128}},
+                                   {4, PaddedPieceSize{512}},
+                                   {5, PaddedPieceSize{128}},
+                                   {6, PaddedPieceSize{1024}}};
+  EXPECT_OUTCOME_TRUE(sectors, packPieces(kSectorSize, {}, pieces));
+  ASSERT_EQ(sectors.size(), 2);
+  std::vector<std::pair<uint64_t, uint64_t>> first, second;
+  for (auto &piece : sectors[0].pieces) {
+    first.emplace_back(piece.deal_id, piece.offset);
+  }
+  for (auto &piece : sectors[1].pieces) {
+    second.emplace_back(piece.deal_id, piece.offset);
+  }
+  EXPECT_EQ(first,
+            (std::vector<std::pair<uint64_t, uint64_t>>{{2, 0}, {6, 1024}}));
+  EXPECT_EQ(second,
+            (std::vector<std::pair<uint64_t, uint64_t>>{
+                {4, 0}, {1, 512}, {3, 768}, {5, 896}}));
+  EXPECT_EQ(sectors[0].used, kSectorSize);
+  EXPECT_EQ(sectors[1].used, 1024);
+}
+
+/**
+ * @given open sector with unaligned free space
+ * @when pack piece larger than used space
+ * @then piece is aligned to its size and gap is filled with padding pieces
+ */
+TEST(PiecePacker, AlignsToOpenSector) {
+  PackedSector open;
+  open.used = 384;
+  EXPECT_OUTCOME_TRUE(
+      sectors, packPieces(kSectorSize, {open}, {{7, PaddedPieceSize{512}}}));
+  ASSERT_EQ(sectors.size(), 1);
+  ASSERT_EQ(sectors[0].pieces.size(), 1);
+  EXPECT_EQ(sectors[0].pieces[0].offset, 512);
+  EXPECT_EQ(sectors[0].used, 1024);
+  EXPECT_EQ(paddingPieces(384, 512),
+            std::vector<PaddedPieceSize>{PaddedPieceSize{128}});
+  EXPECT_EQ(paddingPieces(0, 768),
+            (std::vector<PaddedPieceSize>{PaddedPieceSize{512},
+                                          PaddedPieceSize{256}}));
+}
+
+/**
+ * @given pieces with invalid sizes
+ * @when pack them
+ * @then error is returned
+ */
+TEST(PiecePacker, InvalidPieces) {
+  EXPECT_OUTCOME_ERROR(
+      PiecePackerError::INVALID_PIECE_SIZE,
+      packPieces(kSectorSize, {}, {{1, PaddedPieceSize{300}}}));
+  EXPECT_OUTCOME_ERROR(
+      PiecePackerError::PIECE_TOO_LARGE,
+      packPieces(kSectorSize, {}, {{1, PaddedPieceSize{4096}}}));
+}
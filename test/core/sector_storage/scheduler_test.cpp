@@ -0,0 +1,206 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include "sector_storage/sector_storage_error.hpp"
+#include "testutil/mocks/sector_storage/worker_mock.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::primitives::sector::RegisteredProof;
+using fc::primitives::sector::SectorId;
+using fc::sector_storage::Scheduler;
+using fc::sector_storage::SectorStorageError;
+using fc::sector_storage::TaskType;
+using fc::sector_storage::Worker;
+using fc::sector_storage::WorkerInfo;
+using fc::sector_storage::WorkerMock;
+using testing::Return;
+
+class SchedulerTest : public testing::Test {
+ public:
+  /// Worker fitting many 2KiB tasks in memory
+  std::shared_ptr<WorkerMock> worker(uint64_t cpus,
+                                     uint64_t memory = 1 << 20) {
+    auto worker = std::make_shared<testing::NiceMock<WorkerMock>>();
+    WorkerInfo info;
+    info.hostname = "worker";
+    info.resources.physical_memory = memory;
+    info.resources.cpus = cpus;
+    ON_CALL(*worker, getInfo()).WillByDefault(Return(info));
+    ON_CALL(*worker, getSupportedTask())
+        .WillByDefault(Return(std::set<TaskType>{TaskType::FINALIZE,
+                                                 TaskType::COMMIT2,
+                                                 TaskType::COMMIT1,
+                                                 TaskType::PRECOMMIT2,
+                                                 TaskType::PRECOMMIT1}));
+    return worker;
+  }
+
+  /// Task waiting for release and recording its sector and worker
+  Scheduler::Work work(const SectorId &sector) {
+    return [this, sector](Worker &worker) {
+      release_future.wait();
+      std::lock_guard lock{mutex};
+      order.push_back(sector.sector);
+      workers.push_back(&worker);
+    };
+  }
+
+  /// Waits until tasks are finished, then destroys scheduler
+  void finish(size_t tasks) {
+    release.set_value();
+    wait(tasks);
+    scheduler.reset();
+  }
+
+  void wait(size_t tasks) {
+    while (true) {
+      {
+        std::lock_guard lock{mutex};
+        if (order.size() >= tasks) {
+          break;
+        }
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  RegisteredProof proof{RegisteredProof::StackedDRG2KiBSeal};
+  std::unique_ptr<Scheduler> scheduler{std::make_unique<Scheduler>(proof)};
+  std::promise<void> release;
+  std::shared_future<void> release_future{release.get_future()};
+  std::mutex mutex;
+  std::vector<uint64_t> order;
+  std::vector<Worker *> workers;
+};
+
+/**
+ * @given worker with 2 cpus
+ * @when schedule 4 single thread tasks
+ * @then 2 tasks run and 2 tasks are queued until they finish
+ */
+TEST_F(SchedulerTest, CpuLimit) {
+  EXPECT_OUTCOME_TRUE(id, scheduler->addWorker(worker(2)));
+  for (uint64_t i = 0; i < 4; ++i) {
+    EXPECT_OUTCOME_TRUE_1(
+        scheduler->schedule({1, i}, TaskType::PRECOMMIT1, work({1, i})));
+  }
+  EXPECT_EQ(scheduler->active(id)->cpus, 2);
+  EXPECT_EQ(scheduler->queued(TaskType::PRECOMMIT1), 2);
+  finish(4);
+}
+
+/**
+ * @given busy worker with 1 cpu and queued tasks
+ * @when running task finishes
+ * @then task of sector with deadline runs first, then later sealing phase,
+ * then earlier phase
+ */
+TEST_F(SchedulerTest, Priority) {
+  EXPECT_OUTCOME_TRUE_1(scheduler->addWorker(worker(1)));
+  EXPECT_OUTCOME_TRUE_1(
+      scheduler->schedule({1, 1}, TaskType::PRECOMMIT1, work({1, 1})));
+  scheduler->setDeadline({1, 3}, 10);
+  EXPECT_OUTCOME_TRUE_1(
+      scheduler->schedule({1, 2}, TaskType::PRECOMMIT1, work({1, 2})));
+  EXPECT_OUTCOME_TRUE_1(
+      scheduler->schedule({1, 4}, TaskType::PRECOMMIT2, work({1, 4})));
+  EXPECT_OUTCOME_TRUE_1(
+      scheduler->schedule({1, 3}, TaskType::PRECOMMIT1, work({1, 3})));
+  finish(4);
+  EXPECT_EQ(order, (std::vector<uint64_t>{1, 3, 4, 2}));
+}
+
+/**
+ * @given workers without enough memory for task
+ * @when schedule task
+ * @then error
+ */
+TEST_F(SchedulerTest, NotEnoughResources) {
+  EXPECT_OUTCOME_ERROR(
+      SectorStorageError::NOT_ENOUGH_RESOURCES,
+      scheduler->schedule({1, 1}, TaskType::PRECOMMIT1, [](auto &) {}));
+  EXPECT_OUTCOME_TRUE_1(scheduler->addWorker(worker(1, 1 << 10)));
+  EXPECT_OUTCOME_ERROR(
+      SectorStorageError::NOT_ENOUGH_RESOURCES,
+      scheduler->schedule({1, 1}, TaskType::PRECOMMIT1, [](auto &) {}));
+}
+
+/**
+ * @given scheduler with worker
+ * @when run task
+ * @then result of task is returned
+ */
+TEST_F(SchedulerTest, Run) {
+  EXPECT_OUTCOME_TRUE_1(scheduler->addWorker(worker(1)));
+  EXPECT_OUTCOME_EQ(
+      scheduler->run<int>({1, 1},
+                          TaskType::COMMIT2,
+                          [](auto &) { return fc::outcome::success(42); }),
+      42);
+}
+
+/**
+ * @given two workers and sector precommitted on first worker
+ * @when schedule later tasks of sector while first worker is busy
+ * @then they wait for first worker, commit2 runs on idle second worker
+ */
+TEST_F(SchedulerTest, Affinity) {
+  auto worker1 = worker(1);
+  auto worker2 = worker(1);
+  EXPECT_OUTCOME_TRUE(id1, scheduler->addWorker(worker1));
+  EXPECT_OUTCOME_TRUE(id2, scheduler->addWorker(worker2));
+  EXPECT_OUTCOME_TRUE(pc1_worker,
+                      scheduler->run<Worker *>(
+                          {1, 1}, TaskType::PRECOMMIT1, [](auto &worker) {
+                            return fc::outcome::success(&worker);
+                          }));
+  EXPECT_EQ(pc1_worker, worker1.get());
+  while (scheduler->active(id1)->cpus != 0) {
+    std::this_thread::yield();
+  }
+  // occupy first worker
+  EXPECT_OUTCOME_TRUE_1(
+      scheduler->schedule({1, 2}, TaskType::PRECOMMIT1, work({1, 2})));
+  EXPECT_OUTCOME_TRUE_1(
+      scheduler->schedule({1, 1}, TaskType::PRECOMMIT2, work({1, 1})));
+  EXPECT_EQ(scheduler->queued(TaskType::PRECOMMIT2), 1);
+  EXPECT_EQ(scheduler->active(id2)->cpus, 0);
+  EXPECT_OUTCOME_TRUE_1(
+      scheduler->schedule({1, 1}, TaskType::COMMIT2, work({1, 3})));
+  EXPECT_EQ(scheduler->queued(TaskType::COMMIT2), 0);
+  finish(3);
+  for (size_t i = 0; i < order.size(); ++i) {
+    EXPECT_EQ(workers[i], order[i] == 3 ? worker2.get() : worker1.get());
+  }
+}
+
+/**
+ * @given worker failing health check
+ * @when schedule task
+ * @then task waits until worker recovers
+ */
+TEST_F(SchedulerTest, DisabledWorker) {
+  auto worker1 = worker(1);
+  EXPECT_OUTCOME_TRUE(id, scheduler->addWorker(worker1));
+  WorkerInfo info;
+  info.resources.physical_memory = 1 << 20;
+  info.resources.cpus = 1;
+  EXPECT_CALL(*worker1, getInfo())
+      .WillOnce(Return(SectorStorageError::CANNOT_CREATE_DIR))
+      .WillOnce(Return(info));
+  scheduler->checkWorkers();
+  EXPECT_FALSE(scheduler->isEnabled(id));
+  EXPECT_OUTCOME_TRUE_1(
+      scheduler->schedule({1, 1}, TaskType::PRECOMMIT1, work({1, 1})));
+  EXPECT_EQ(scheduler->queued(TaskType::PRECOMMIT1), 1);
+  scheduler->checkWorkers();
+  EXPECT_TRUE(scheduler->isEnabled(id));
+  EXPECT_EQ(scheduler->queued(TaskType::PRECOMMIT1), 0);
+  finish(1);
+}
@@ -0,0 +1,105 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/sector_health.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem/fstream.hpp>
+
+#include "sector_storage/stores/store_error.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+namespace fc::sector_storage {
+  using primitives::sector_file::SectorFileType;
+  using primitives::SectorNumber;
+  using stores::AcquireSectorResponse;
+
+  /// Store with sector files in directories named by sector number
+  class DirStore : public stores::Store {
+   public:
+    explicit DirStore(boost::filesystem::path root) : root_{std::move(root)} {}
+
+    outcome::result<AcquireSectorResponse> acquireSector(
+        SectorId sector,
+        RegisteredProof seal_proof_type,
+        SectorFileType existing,
+        SectorFileType allocate,
+        bool can_seal) override {
+      auto dir{root_ / std::to_string(sector.sector)};
+      if (!boost::filesystem::exists(dir)) {
+        return stores::StoreErrors::NotFoundSector;
+      }
+      AcquireSectorResponse response;
+      response.paths.id = sector;
+      response.paths.sealed = (dir / "sealed").string();
+      response.paths.cache = (dir / "cache").string();
+      response.stores.sealed = "storage";
+      return response;
+    }
+
+    outcome::result<void> remove(SectorId, SectorFileType) override {
+      return outcome::success();
+    }
+
+    outcome::result<void> moveStorage(SectorId,
+                                      RegisteredProof,
+                                      SectorFileType) override {
+      return outcome::success();
+    }
+
+    outcome::result<stores::FsStat> getFsStat(stores::StorageID) override {
+      return stores::FsStat{};
+    }
+
+   private:
+    boost::filesystem::path root_;
+  };
+
+  class SectorHealthTest : public test::BaseFS_Test {
+   public:
+    SectorHealthTest() : test::BaseFS_Test("fc_sector_health_test") {}
+
+    /// Creates sealed file of size and cache files of sector
+    void sector(SectorNumber number, size_t sealed_size) {
+      auto dir{base_path / std::to_string(number)};
+      boost::filesystem::create_directories(dir / "cache");
+      boost::filesystem::ofstream sealed{dir / "sealed"};
+      sealed << std::string(sealed_size, 'a');
+      for (auto name : {"p_aux", "t_aux"}) {
+        boost::filesystem::ofstream aux{dir / "cache" / name};
+        aux << "aux";
+      }
+    }
+
+    SectorToCheck toCheck(SectorNumber number) {
+      return {{1, number}, RegisteredProof::StackedDRG2KiBSeal};
+    }
+
+    SectorHealthChecker checker{std::make_shared<DirStore>(base_path),
+                                {4, 256, 0}};
+  };
+
+  /**
+   * @given healthy sector, truncated sector, sector without cache file
+   * and missing sector
+   * @when sectors are checked
+   * @then all but healthy sector are faulty
+   */
+  TEST_F(SectorHealthTest, Faults) {
+    sector(1, 2048);
+    sector(2, 1024);
+    sector(3, 2048);
+    boost::filesystem::remove(base_path / "3" / "cache" / "t_aux");
+    std::vector<SectorToCheck> sectors{
+        toCheck(1), toCheck(2), toCheck(3), toCheck(4)};
+    auto faults{checker.check(sectors, 7)};
+    std::vector<SectorNumber> numbers;
+    for (auto &fault : faults) {
+      EXPECT_FALSE(fault.reason.empty());
+      numbers.push_back(fault.sector.sector);
+    }
+    EXPECT_EQ(numbers, (std::vector<SectorNumber>{2, 3, 4}));
+  }
+}  // namespace fc::sector_storage
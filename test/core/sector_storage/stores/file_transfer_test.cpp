@@ -0,0 +1,119 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/stores/impl/file_transfer.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+using fc::sector_storage::stores::FileTransfer;
+using fc::sector_storage::stores::TransferConfig;
+
+class FileTransferTest : public test::BaseFS_Test {
+ public:
+  static constexpr uint64_t kChunk{1 << 20};
+
+  FileTransferTest() : test::BaseFS_Test("fc_file_transfer_test") {}
+
+  /// Writes file of size with bytes depending on offset
+  std::string write(const fs::path &file, uint64_t size) {
+    std::string data(size, 0);
+    for (uint64_t i = 0; i < size; ++i) {
+      data[i] = static_cast<char>(i * 7 + i / kChunk);
+    }
+    fs::ofstream{file, std::ios::binary} << data;
+    return data;
+  }
+
+  std::string read(const fs::path &file) {
+    fs::ifstream input{file, std::ios::binary};
+    return {std::istreambuf_iterator<char>{input}, {}};
+  }
+
+  TransferConfig config{kChunk, 3, 0};
+};
+
+/**
+ * @given file of several chunks and incomplete last chunk
+ * @when copy it with several threads
+ * @then copy has same content, progress reaches total
+ */
+TEST_F(FileTransferTest, CopyFile) {
+  auto data = write(base_path / "from", 5 * kChunk + 3);
+  FileTransfer transfer{config};
+  uint64_t done{}, total{};
+  EXPECT_OUTCOME_TRUE_1(transfer.copy(
+      base_path / "from", base_path / "to", [&](auto _done, auto _total) {
+        done = _done;
+        total = _total;
+      }));
+  EXPECT_EQ(read(base_path / "to"), data);
+  EXPECT_EQ(done, data.size());
+  EXPECT_EQ(total, data.size());
+  EXPECT_FALSE(fs::exists(base_path / "to.part"));
+  EXPECT_FALSE(fs::exists(base_path / "to.part.journal"));
+}
+
+/**
+ * @given interrupted transfer with first chunk recorded in journal
+ * @when copy again
+ * @then recorded chunk is not copied again, other chunks are copied
+ */
+TEST_F(FileTransferTest, Resume) {
+  auto data = write(base_path / "from", 3 * kChunk);
+  fs::ofstream{base_path / "to.part", std::ios::binary}
+      << std::string(data.size(), 'x');
+  auto chunk = boost::endian::native_to_little(uint64_t{0});
+  fs::ofstream{base_path / "to.part.journal", std::ios::binary}.write(
+      reinterpret_cast<const char *>(&chunk), sizeof(chunk));
+  FileTransfer transfer{config};
+  std::vector<uint64_t> progress;
+  EXPECT_OUTCOME_TRUE_1(transfer.copy(
+      base_path / "from", base_path / "to", [&](auto done, auto) {
+        progress.push_back(done);
+      }));
+  auto copied = read(base_path / "to");
+  EXPECT_EQ(copied.substr(0, kChunk), std::string(kChunk, 'x'));
+  EXPECT_EQ(copied.substr(kChunk), data.substr(kChunk));
+  EXPECT_EQ(progress.front(), kChunk);
+  EXPECT_EQ(progress.back(), data.size());
+}
+
+/**
+ * @given directory with nested files
+ * @when copy and move it
+ * @then tree is copied, moved source is removed
+ */
+TEST_F(FileTransferTest, Directory) {
+  fs::create_directories(base_path / "from" / "sub");
+  auto data1 = write(base_path / "from" / "a", 10);
+  auto data2 = write(base_path / "from" / "sub" / "b", kChunk + 1);
+  FileTransfer transfer{config};
+  EXPECT_OUTCOME_TRUE_1(transfer.copy(base_path / "from", base_path / "copy"));
+  EXPECT_EQ(read(base_path / "copy" / "a"), data1);
+  EXPECT_EQ(read(base_path / "copy" / "sub" / "b"), data2);
+  EXPECT_OUTCOME_TRUE_1(transfer.move(base_path / "from", base_path / "to"));
+  EXPECT_FALSE(fs::exists(base_path / "from"));
+  EXPECT_EQ(read(base_path / "to" / "sub" / "b"), data2);
+}
+
+/**
+ * @given bandwidth limit
+ * @when copy file larger than bandwidth of fraction of second
+ * @then copy takes at least that time
+ */
+TEST_F(FileTransferTest, Bandwidth) {
+  write(base_path / "from", 3 * kChunk);
+  config.bandwidth = 16 * kChunk;
+  FileTransfer transfer{config};
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_OUTCOME_TRUE_1(transfer.copy(base_path / "from", base_path / "to"));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds{100});
+}
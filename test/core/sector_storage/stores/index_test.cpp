@@ -7,15 +7,18 @@
 #include "sector_storage/stores/impl/index_impl.hpp"
 
 #include <memory>
+#include "storage/in_memory/in_memory_storage.hpp"
 #include "testutil/outcome.hpp"
 
 using fc::primitives::sector::RegisteredProof;
 using fc::primitives::sector_file::SectorFileType;
 using fc::sector_storage::stores::FsStat;
 using fc::sector_storage::stores::IndexErrors;
+using fc::sector_storage::stores::SectorDeclaration;
 using fc::sector_storage::stores::SectorIndex;
 using fc::sector_storage::stores::SectorIndexImpl;
 using fc::sector_storage::stores::StorageInfo;
+using fc::storage::InMemoryStorage;
 
 class SectorIndexTest : public testing::Test {
  public:
@@ -391,3 +394,135 @@ TEST_F(SectorIndexTest, StorageFindSectorFetch) {
   ASSERT_FALSE(store.urls.empty());
   ASSERT_EQ(store.urls[0], result_url);
 }
+
+/**
+ * @given storage with space for one cache file
+ * @when space is reserved and then released
+ * @then storage is not allocated while space is reserved, reservation over
+ * free space fails
+ */
+TEST_F(SectorIndexTest, BestAllocationReserved) {
+  std::string id = "test_id";
+  StorageInfo storage_info{
+      .id = id,
+      .urls = {},
+      .weight = 10,
+      .can_seal = false,
+      .can_store = true,
+  };
+  FsStat file_system_stat{
+      .capacity = 8 * 2048,
+      .available = 8 * 2048,
+      .used = 0,
+  };
+
+  EXPECT_OUTCOME_TRUE_1(
+      sector_index_->storageAttach(storage_info, file_system_stat));
+  EXPECT_OUTCOME_TRUE_1(sector_index_->storageReserve(id, 2 * 2048));
+  EXPECT_OUTCOME_ERROR(IndexErrors::NotEnoughSpace,
+                       sector_index_->storageReserve(id, 8 * 2048));
+  EXPECT_OUTCOME_ERROR(
+      IndexErrors::NoSuitableCandidate,
+      sector_index_->storageBestAlloc(
+          SectorFileType::FTCache, RegisteredProof::StackedDRG2KiBSeal, false));
+
+  EXPECT_OUTCOME_TRUE_1(sector_index_->storageReleaseReservation(id, 2 * 2048));
+  EXPECT_OUTCOME_TRUE(
+      candidates,
+      sector_index_->storageBestAlloc(
+          SectorFileType::FTCache, RegisteredProof::StackedDRG2KiBSeal, false));
+  ASSERT_EQ(candidates.size(), 1);
+  ASSERT_EQ(candidates.at(0).id, id);
+}
+
+/**
+ * @given sector declared only as sealed
+ * @when try to drop sector cache and sealed files
+ * @then sealed file is dropped
+ */
+TEST_F(SectorIndexTest, StorageDropSectorTypes) {
+  std::string id = "test_id";
+  StorageInfo storage_info{
+      .id = id,
+      .urls = {"http://url1.com/"},
+      .weight = 0,
+      .can_seal = false,
+      .can_store = false,
+  };
+  FsStat file_system_stat{
+      .capacity = 100,
+      .available = 100,
+      .used = 0,
+  };
+
+  SectorId sector{
+      .miner = 42,
+      .sector = 123,
+  };
+
+  EXPECT_OUTCOME_TRUE_1(
+      sector_index_->storageAttach(storage_info, file_system_stat));
+  EXPECT_OUTCOME_TRUE_1(sector_index_->storageDeclareSector(
+      id, sector, SectorFileType::FTSealed));
+  EXPECT_OUTCOME_TRUE_1(sector_index_->storageDropSector(
+      id,
+      sector,
+      static_cast<SectorFileType>(SectorFileType::FTCache
+                                  | SectorFileType::FTSealed)));
+  EXPECT_OUTCOME_TRUE(storages,
+                      sector_index_->storageFindSector(
+                          sector, SectorFileType::FTSealed, false));
+  ASSERT_TRUE(storages.empty());
+}
+
+/**
+ * @given index persisted in datastore with declared and dropped sectors
+ * @when load index from datastore and attach storage again
+ * @then only declared sectors are found
+ */
+TEST_F(SectorIndexTest, LoadPersisted) {
+  std::string id = "test_id";
+  StorageInfo storage_info{
+      .id = id,
+      .urls = {"http://url1.com/"},
+      .weight = 0,
+      .can_seal = false,
+      .can_store = false,
+  };
+  FsStat file_system_stat{
+      .capacity = 100,
+      .available = 100,
+      .used = 0,
+  };
+  SectorId sector{
+      .miner = 42,
+      .sector = 123,
+  };
+  SectorId dropped{
+      .miner = 42,
+      .sector = 124,
+  };
+  auto datastore{std::make_shared<InMemoryStorage>()};
+
+  EXPECT_OUTCOME_TRUE(index, SectorIndexImpl::load(datastore));
+  EXPECT_OUTCOME_TRUE_1(
+      index->storageDeclareSector(id, sector, SectorFileType::FTSealed));
+  EXPECT_OUTCOME_TRUE_1(
+      index->storageDeclareSector(id, dropped, SectorFileType::FTSealed));
+  EXPECT_OUTCOME_TRUE_1(
+      index->storageDropSector(id, dropped, SectorFileType::FTSealed));
+
+  EXPECT_OUTCOME_TRUE(loaded, SectorIndexImpl::load(datastore));
+  EXPECT_OUTCOME_EQ(
+      loaded->storageSectors(id),
+      (std::vector<SectorDeclaration>{{sector, SectorFileType::FTSealed}}));
+  EXPECT_OUTCOME_TRUE_1(loaded->storageAttach(storage_info, file_system_stat));
+  EXPECT_OUTCOME_TRUE(
+      storages,
+      loaded->storageFindSector(sector, SectorFileType::FTSealed, false));
+  EXPECT_EQ(storages.size(), 1);
+  EXPECT_OUTCOME_TRUE(
+      none,
+      loaded->storageFindSector(dropped, SectorFileType::FTSealed, false));
+  EXPECT_TRUE(none.empty());
+}
@@ -6,6 +6,7 @@
 #include "sector_storage/stores/store.hpp"
 
 #include <gtest/gtest.h>
+#include <future>
 #include <rapidjson/ostreamwrapper.h>
 #include <rapidjson/writer.h>
 #include "api/rpc/json.hpp"
@@ -24,6 +25,7 @@ using fc::primitives::sector_file::SectorFileType;
 using fc::sector_storage::stores::kMetaFileName;
 using fc::sector_storage::stores::LocalStorageMock;
 using fc::sector_storage::stores::LocalStore;
+using fc::sector_storage::stores::SectorDeclaration;
 using fc::sector_storage::stores::SectorIndexMock;
 using fc::sector_storage::stores::StorageInfo;
 using fc::sector_storage::stores::StoreErrors;
@@ -57,6 +59,10 @@ class LocalStoreTest : public test::BaseFS_Test {
     storage_ = std::make_shared<LocalStorageMock>();
     urls_ = {"http://url1.com", "http://url2.com"};
 
+    ON_CALL(*index_, storageSectors(testing::_))
+        .WillByDefault(testing::Return(
+            fc::outcome::success(std::vector<SectorDeclaration>{})));
+
     EXPECT_CALL(*storage_, getPaths())
         .WillOnce(testing::Return(
             fc::outcome::success(std::vector<std::string>({}))));
@@ -297,7 +303,8 @@ TEST_F(LocalStoreTest, getFSStatNotFound) {
 /**
  * @given storage
  * @when try to get stat for the storage
- * @then get stat of the storage from index
+ * @then stat taken when storage was opened is returned without querying
+ * filesystem again
  */
 TEST_F(LocalStoreTest, getFSStatSuccess) {
   auto storage_path = boost::filesystem::unique_path(
@@ -321,22 +328,50 @@ TEST_F(LocalStoreTest, getFSStatSuccess) {
 
   createStorage(storage_path, storage_meta, res_stat);
 
-  EXPECT_CALL(*storage_, getStat(storage_path))
-      .WillOnce(testing::Return(fc::outcome::success(res_stat)));
-
-  StorageInfo storage_info{
-      .id = storage_id,
-      .urls = urls_,
-      .weight = 0,
-      .can_seal = true,
-      .can_store = true,
-  };
-
-  std::vector res = {storage_info};
-
   EXPECT_OUTCOME_EQ(local_store_->getFsStat(storage_id), res_stat);
 }
 
+/**
+ * @given opened storage
+ * @when heartbeat runs, and then stat of storage fails
+ * @then fresh stat is cached and reported to index, failure is reported
+ * with last known stat
+ */
+TEST_F(LocalStoreTest, heartbeat) {
+  auto storage_path = boost::filesystem::unique_path(
+                          fs::canonical(base_path).append("%%%%%-storage"))
+                          .string();
+  StorageID storage_id = "storage_id";
+  createStorage(storage_path,
+                {.id = storage_id,
+                 .weight = 0,
+                 .can_seal = true,
+                 .can_store = true},
+                {.capacity = 100, .available = 100, .used = 0});
+
+  FsStat fresh{.capacity = 100, .available = 40, .used = 60};
+  EXPECT_CALL(*storage_, getStat(storage_path))
+      .WillOnce(testing::Return(fc::outcome::success(fresh)))
+      .WillOnce(testing::Return(StoreErrors::NotFoundStorage));
+  std::vector<fc::sector_storage::stores::HealthReport> reports;
+  EXPECT_CALL(*index_, storageReportHealth(storage_id, _))
+      .Times(2)
+      .WillRepeatedly(testing::DoAll(
+          testing::Invoke([&](auto &, auto &report) {
+            reports.push_back(report);
+          }),
+          testing::Return(fc::outcome::success())));
+
+  local_store_->heartbeat();
+  EXPECT_OUTCOME_EQ(local_store_->getFsStat(storage_id), fresh);
+  local_store_->heartbeat();
+  ASSERT_EQ(reports.size(), 2);
+  EXPECT_EQ(reports[0].stat, fresh);
+  EXPECT_FALSE(reports[0].error);
+  EXPECT_EQ(reports[1].stat, fresh);
+  EXPECT_TRUE(reports[1].error);
+}
+
 /**
  * @given storage with sector
  * @when open this storage for store
@@ -399,6 +434,64 @@ TEST_F(LocalStoreTest, openPathExistingSector) {
   EXPECT_OUTCOME_TRUE_1(local_store_->openPath(storage_path.string()));
 }
 
+/**
+ * @given storage with sector, index with declarations restored for storage
+ * @when open this storage for store
+ * @then sector is declared and missing sector is dropped in background
+ */
+TEST_F(LocalStoreTest, openPathVerifiesRestored) {
+  auto storage_path = boost::filesystem::unique_path(
+      fs::canonical(base_path).append("%%%%%-storage"));
+  SectorFileType file_type = SectorFileType::FTCache;
+  boost::filesystem::create_directories((storage_path / toString(file_type)));
+  StorageID storage_id = "storage_id";
+  createMetaFile(storage_path.string(),
+                 LocalStorageMeta{
+                     .id = storage_id,
+                     .weight = 0,
+                     .can_seal = true,
+                     .can_store = true,
+                 });
+  FsStat stat{
+      .capacity = 200,
+      .available = 200,
+      .used = 0,
+  };
+  SectorId sector{
+      .miner = 42,
+      .sector = 1,
+  };
+  SectorId missing{
+      .miner = 42,
+      .sector = 2,
+  };
+  std::ofstream((storage_path / toString(file_type)
+                 / fc::primitives::sector_file::sectorName(sector))
+                    .string())
+      .close();
+
+  EXPECT_CALL(*storage_, getStat(storage_path.string()))
+      .WillOnce(testing::Return(fc::outcome::success(stat)));
+  EXPECT_CALL(*index_, storageAttach(_, stat))
+      .WillOnce(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(*index_, storageSectors(storage_id))
+      .WillOnce(testing::Return(fc::outcome::success(
+          std::vector<SectorDeclaration>{{sector, file_type},
+                                         {missing, file_type}})));
+  EXPECT_CALL(*index_, storageDeclareSector(storage_id, sector, file_type))
+      .WillOnce(testing::Return(fc::outcome::success()));
+  std::promise<void> dropped;
+  EXPECT_CALL(*index_, storageDropSector(storage_id, missing, file_type))
+      .WillOnce(testing::Invoke([&](auto &, auto &, auto &) {
+        dropped.set_value();
+        return fc::outcome::success();
+      }));
+
+  EXPECT_OUTCOME_TRUE_1(local_store_->openPath(storage_path.string()));
+  EXPECT_EQ(dropped.get_future().wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+}
+
 /**
  * @given storage with sector with invalid name
  * @when open this storage for store
@@ -0,0 +1,70 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/unsealed_cache.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem/fstream.hpp>
+
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+namespace fc::sector_storage {
+
+  class UnsealedCacheTest : public test::BaseFS_Test {
+   public:
+    UnsealedCacheTest() : test::BaseFS_Test("fc_unsealed_cache_test") {}
+
+    /// Unseal writing size bytes, counts calls
+    UnsealedCache::Unseal unseal(uint64_t size) {
+      return [this, size](const std::string &output) -> outcome::result<void> {
+        ++unseals;
+        boost::filesystem::ofstream file{output};
+        file << std::string(size, 'a');
+        return outcome::success();
+      };
+    }
+
+    SectorId sector{1, 2};
+    size_t unseals{};
+  };
+
+  /**
+   * @given cache with unsealed range
+   * @when range within it is read
+   * @then range is served from cached file without unseal
+   */
+  TEST_F(UnsealedCacheTest, ContainedRange) {
+    UnsealedCache cache{getPathString(), 1000};
+    EXPECT_OUTCOME_TRUE(piece, cache.get(sector, 0, 100, unseal(100)));
+    EXPECT_TRUE(piece.file.isOpened());
+    EXPECT_EQ(piece.offset, 0);
+
+    EXPECT_OUTCOME_TRUE(part, cache.get(sector, 10, 20, unseal(20)));
+    EXPECT_TRUE(part.file.isOpened());
+    EXPECT_EQ(part.offset, 10);
+    EXPECT_EQ(part.size, 100);
+    EXPECT_EQ(unseals, 1);
+    EXPECT_EQ(cache.size(), 100);
+  }
+
+  /**
+   * @given cache with quota for one piece
+   * @when two pieces are read
+   * @then least recently read piece is removed
+   */
+  TEST_F(UnsealedCacheTest, Evict) {
+    UnsealedCache cache{getPathString(), 150};
+    EXPECT_OUTCOME_TRUE_1(cache.get(sector, 0, 100, unseal(100)));
+    EXPECT_OUTCOME_TRUE_1(cache.get(sector, 100, 100, unseal(100)));
+    EXPECT_EQ(cache.size(), 100);
+
+    EXPECT_OUTCOME_TRUE_1(cache.get(sector, 100, 100, unseal(100)));
+    EXPECT_EQ(unseals, 2);
+    EXPECT_OUTCOME_TRUE_1(cache.get(sector, 0, 100, unseal(100)));
+    EXPECT_EQ(unseals, 3);
+  }
+
+}  // namespace fc::sector_storage
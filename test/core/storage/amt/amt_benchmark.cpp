@@ -0,0 +1,57 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "storage/amt/amt.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+
+using fc::storage::amt::Amt;
+using fc::storage::ipfs::InMemoryDatastore;
+
+namespace {
+  auto value(int64_t i) {
+    return fc::codec::cbor::encode(i).value();
+  }
+}  // namespace
+
+/// Append values to empty amt, as miner sectors and messages are added
+void AmtAppend(benchmark::State &state) {
+  auto store{std::make_shared<InMemoryDatastore>()};
+  for (auto _ : state) {
+    Amt amt{store};
+    for (int64_t i{0}; i < state.range(0); ++i) {
+      amt.set(i, value(i)).value();
+    }
+    benchmark::DoNotOptimize(amt.flush().value());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(AmtAppend)->RangeMultiplier(10)->Range(1e3, 1e6);
+
+/// Visit all values of flushed amt
+void AmtVisit(benchmark::State &state) {
+  auto store{std::make_shared<InMemoryDatastore>()};
+  Amt amt{store};
+  for (int64_t i{0}; i < state.range(0); ++i) {
+    amt.set(i, value(i)).value();
+  }
+  auto root{amt.flush().value()};
+  for (auto _ : state) {
+    Amt loaded{store, root};
+    size_t bytes{0};
+    loaded
+        .visit([&](auto, auto &value) {
+          bytes += value.size();
+          return fc::outcome::success();
+        })
+        .value();
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(AmtVisit)->RangeMultiplier(10)->Range(1e3, 1e6);
+
+BENCHMARK_MAIN();
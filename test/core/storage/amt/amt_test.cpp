@@ -6,6 +6,8 @@
 #include "storage/amt/amt.hpp"
 
 #include <gtest/gtest.h>
+#include <mutex>
+#include <set>
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "testutil/cbor.hpp"
 
@@ -106,6 +108,25 @@ TEST_F(AmtTest, Flush) {
   EXPECT_OUTCOME_EQ(amt.get(key), value);
 }
 
+/**
+ * @given flushed AMT and another AMT loaded from same root
+ * @when modify second AMT
+ * @then AMT loaded from root again reads old values from cached nodes
+ */
+TEST_F(AmtTest, NodeCacheCopyOnWrite) {
+  auto key = 9llu;
+  auto value = Value{"07"_unhex};
+
+  EXPECT_OUTCOME_TRUE_1(amt.set(key, value));
+  EXPECT_OUTCOME_TRUE(cid, amt.flush());
+  EXPECT_TRUE(Amt::rootCache().get(cid));
+
+  Amt amt2{store, cid};
+  EXPECT_OUTCOME_TRUE_1(amt2.set(key, Value{"08"_unhex}));
+  EXPECT_OUTCOME_EQ(Amt(store, cid).get(key), value);
+  EXPECT_OUTCOME_EQ(amt2.get(key), Value{"08"_unhex});
+}
+
 class AmtVisitTest : public AmtTest {
  public:
   AmtVisitTest() : AmtTest{} {
@@ -153,3 +174,169 @@ TEST_F(AmtVisitTest, VisitError) {
                          return AmtError::INDEX_TOO_BIG;
                        }));
 }
+
+/**
+ * @given AMT with keys in different subtrees
+ * @when visit from key between them, and stop at first key
+ * @then keys before start are skipped, stopped visit returns false
+ */
+TEST_F(AmtVisitTest, VisitWhile) {
+  EXPECT_OUTCOME_TRUE_1(amt.flush());
+  std::vector<uint64_t> keys;
+  EXPECT_OUTCOME_EQ(amt.visitWhile(
+                        [&](auto key, auto &) -> fc::outcome::result<bool> {
+                          keys.push_back(key);
+                          return true;
+                        },
+                        4),
+                    true);
+  EXPECT_EQ(keys, std::vector<uint64_t>{64});
+
+  EXPECT_OUTCOME_EQ(
+      amt.visitWhile([](auto, auto &) -> fc::outcome::result<bool> {
+        return false;
+      }),
+      false);
+}
+
+/**
+ * @given sorted items, dense and sparse
+ * @when assign them to amt
+ * @then root is same as after setting them one by one
+ */
+TEST_F(AmtTest, AssignSameAsSet) {
+  for (auto keys : std::vector<std::vector<uint64_t>>{
+           {}, {0}, {0, 1, 2, 3, 4, 5, 6, 7, 8}, {3, 64, 100, 4096}}) {
+    std::vector<std::pair<uint64_t, Value>> items;
+    Amt expected{store};
+    for (auto key : keys) {
+      Value value{"0102"_unhex};
+      value.putUint64(key);
+      items.emplace_back(key, value);
+      EXPECT_OUTCOME_TRUE_1(expected.set(key, value));
+    }
+    Amt assigned{store};
+    EXPECT_OUTCOME_TRUE_1(assigned.assign(std::move(items)));
+    EXPECT_OUTCOME_EQ(assigned.count(), keys.size());
+    EXPECT_OUTCOME_TRUE(cid, expected.flush());
+    EXPECT_OUTCOME_EQ(assigned.flush(), cid);
+  }
+}
+
+/**
+ * @given items with unsorted keys
+ * @when assign them to amt
+ * @then error is returned
+ */
+TEST_F(AmtTest, AssignNotSorted) {
+  EXPECT_OUTCOME_ERROR(AmtError::NOT_SORTED,
+                       amt.assign({{2, Value{"01"_unhex}}, {1, Value{}}}));
+}
+
+/**
+ * @given flushed AMT and its copy with keys removed, changed and added
+ *   beyond its height
+ * @when diff both ways
+ * @then only changed keys are visited in key order
+ */
+TEST_F(AmtTest, Diff) {
+  for (auto key : {1, 2, 100}) {
+    EXPECT_OUTCOME_TRUE_1(amt.set(key, Value{"01"_unhex}));
+  }
+  EXPECT_OUTCOME_TRUE(root, amt.flush());
+  Amt after{store, root};
+  EXPECT_OUTCOME_TRUE_1(after.remove(2));
+  EXPECT_OUTCOME_TRUE_1(after.set(100, Value{"02"_unhex}));
+  EXPECT_OUTCOME_TRUE_1(after.set(5000, Value{"03"_unhex}));
+
+  using Change = std::tuple<uint64_t, bool, bool>;
+  auto diff = [&](Amt &left, Amt &right) {
+    std::vector<Change> changes;
+    EXPECT_OUTCOME_TRUE_1(
+        right.diff(left,
+                   [&](auto key, auto before, auto value)
+                       -> fc::outcome::result<void> {
+                     changes.emplace_back(
+                         key, before != nullptr, value != nullptr);
+                     return fc::outcome::success();
+                   }));
+    return changes;
+  };
+  EXPECT_EQ(diff(amt, after),
+            (std::vector<Change>{
+                {2, true, false}, {100, true, true}, {5000, false, true}}));
+  EXPECT_EQ(diff(after, amt),
+            (std::vector<Change>{
+                {2, false, true}, {100, true, true}, {5000, true, false}}));
+  EXPECT_TRUE(diff(amt, amt).empty());
+}
+
+/**
+ * @given AMT with keys under different subtrees, flushed and not
+ * @when get many keys in any order with repeated and absent keys
+ * @then values are returned in order of keys, none for absent
+ */
+TEST_F(AmtTest, GetMany) {
+  std::vector<uint64_t> keys{1, 9, 64, 500, 5000};
+  for (auto key : keys) {
+    EXPECT_OUTCOME_TRUE_1(amt.set(key, Value{encode(key).value()}));
+  }
+  std::vector<uint64_t> query{5000, 1, 2, 9, 1, 100000, 64};
+  auto expect = [&](Amt &amt) {
+    EXPECT_OUTCOME_TRUE(values, amt.getMany(query));
+    ASSERT_EQ(values.size(), query.size());
+    for (size_t i = 0; i < query.size(); ++i) {
+      auto present =
+          std::find(keys.begin(), keys.end(), query[i]) != keys.end();
+      ASSERT_EQ(values[i].has_value(), present);
+      if (present) {
+        EXPECT_EQ(*values[i], Value{encode(query[i]).value()});
+      }
+    }
+  };
+  expect(amt);
+  EXPECT_OUTCOME_TRUE(root, amt.flush());
+  Amt loaded{store, root};
+  expect(loaded);
+  EXPECT_OUTCOME_TRUE_1(loaded.prefetch(query));
+  EXPECT_OUTCOME_EQ(loaded.get(500), Value{encode(500).value()});
+}
+
+/**
+ * @given flushed AMT of several levels
+ * @when visit it in parallel, unordered and ordered
+ * @then same keys are visited, ordered visit is in key order,
+ *       visitor error is returned
+ */
+TEST_F(AmtTest, VisitParallel) {
+  std::vector<uint64_t> keys;
+  for (uint64_t key = 0; key < 2000; key += 7) {
+    keys.push_back(key);
+    EXPECT_OUTCOME_TRUE_1(amt.set(key, Value{"01"_unhex}));
+  }
+  EXPECT_OUTCOME_TRUE(cid, amt.flush());
+  Amt amt2{store, cid};
+
+  std::mutex mutex;
+  std::set<uint64_t> unordered;
+  EXPECT_OUTCOME_TRUE_1(amt2.visitParallel([&](uint64_t key, auto &) {
+    std::lock_guard lock{mutex};
+    unordered.insert(key);
+    return fc::outcome::success();
+  }));
+  EXPECT_EQ(unordered, std::set<uint64_t>(keys.begin(), keys.end()));
+
+  std::vector<uint64_t> ordered;
+  EXPECT_OUTCOME_TRUE_1(amt2.visitParallel(
+      [&](uint64_t key, auto &) {
+        ordered.push_back(key);
+        return fc::outcome::success();
+      },
+      true));
+  EXPECT_EQ(ordered, keys);
+
+  EXPECT_OUTCOME_ERROR(AmtError::INDEX_TOO_BIG,
+                       amt2.visitParallel([](uint64_t, auto &) {
+                         return AmtError::INDEX_TOO_BIG;
+                       }));
+}
@@ -5,6 +5,8 @@
 
 #include "storage/car/car.hpp"
 
+#include <sstream>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -14,12 +16,21 @@
 #include "testutil/outcome.hpp"
 #include "testutil/read_file.hpp"
 #include "testutil/resources/resources.hpp"
+#include "testutil/storage/base_fs_test.hpp"
 
 using fc::CID;
+using fc::common::Buffer;
 using fc::storage::car::CarError;
 using fc::storage::car::loadCar;
+using fc::storage::car::loadCarFile;
+using fc::storage::car::loadDiffCar;
+using fc::storage::car::LoadCarOptions;
 using fc::storage::car::makeCar;
+using fc::storage::car::makeDiffCar;
 using fc::storage::car::makeSelectiveCar;
+using fc::storage::car::writeCarFile;
+using fc::storage::car::writeHeader;
+using fc::storage::car::writeItem;
 using fc::storage::ipfs::InMemoryDatastore;
 
 /**
@@ -80,6 +91,116 @@ TEST(CarTest, Writer) {
   EXPECT_OUTCOME_EQ(ipld2.get(cid3), raw3);
 }
 
+struct CarFileTest : public test::BaseFS_Test {
+  CarFileTest() : test::BaseFS_Test("fc_car_file_test") {}
+};
+
+/**
+ * @given dag in store
+ * @when it is written to CAR file and streamed back in small batches
+ * @then blocks and roots are equal to original
+ */
+TEST_F(CarFileTest, StreamRoundTrip) {
+  InMemoryDatastore ipld1;
+  std::vector<CID> cids;
+  for (auto i = 0; i < 10; ++i) {
+    EXPECT_OUTCOME_TRUE(cid, ipld1.setCbor(Sample2{i}));
+    cids.push_back(cid);
+  }
+  Sample1 obj{cids, {}};
+  EXPECT_OUTCOME_TRUE(root, ipld1.setCbor(obj));
+  auto path = (base_path / "dag.car").string();
+  EXPECT_OUTCOME_TRUE_1(writeCarFile(ipld1, {root}, path));
+
+  auto car = readFile(path);
+  EXPECT_OUTCOME_EQ(makeCar(ipld1, {root}), car);
+
+  InMemoryDatastore ipld2;
+  LoadCarOptions options;
+  options.batch_bytes = 8;
+  options.verify_threads = 3;
+  EXPECT_OUTCOME_TRUE(roots, loadCarFile(ipld2, path, options));
+  EXPECT_THAT(roots, testing::ElementsAre(root));
+  cids.push_back(root);
+  for (auto &cid : cids) {
+    EXPECT_OUTCOME_TRUE(raw, ipld1.get(cid));
+    EXPECT_OUTCOME_EQ(ipld2.get(cid), raw);
+  }
+}
+
+/**
+ * @given CAR with block not matching its cid
+ * @when it is streamed into store
+ * @then CID_MISMATCH error
+ */
+TEST_F(CarFileTest, CidMismatch) {
+  InMemoryDatastore ipld;
+  EXPECT_OUTCOME_TRUE(cid, ipld.setCbor(Sample2{1}));
+  EXPECT_OUTCOME_TRUE(other, ipld.getCbor<Sample2>(cid));
+  other.i = 2;
+  EXPECT_OUTCOME_TRUE(bytes, fc::codec::cbor::encode(other));
+  Buffer car;
+  writeHeader(car, {cid});
+  writeItem(car, cid, bytes);
+
+  std::stringstream stream{std::string{car.begin(), car.end()}};
+  EXPECT_OUTCOME_ERROR(CarError::CID_MISMATCH, loadCar(ipld, stream));
+  EXPECT_OUTCOME_ERROR(CarError::CANNOT_OPEN_FILE,
+                       loadCarFile(ipld, (base_path / "none.car").string()));
+}
+
+/**
+ * @given CAR stream with section length above limit
+ * @when it is streamed into store
+ * @then DECODE_ERROR without allocating section
+ */
+TEST(CarTest, OversizedSection) {
+  InMemoryDatastore ipld;
+  // uvarint 2^40
+  Buffer car{0x80, 0x80, 0x80, 0x80, 0x80, 0x20};
+  std::stringstream stream{std::string{car.begin(), car.end()}};
+  EXPECT_OUTCOME_ERROR(CarError::DECODE_ERROR, loadCar(ipld, stream));
+}
+
+/**
+ * @given base dag exported before and new dag with one changed block
+ * @when differential CAR is made and imported onto store with base dag or
+ * onto empty store
+ * @then CAR has only new root and changed block, import onto base store
+ * completes new dag, import onto empty store reports missing blocks
+ */
+TEST(CarTest, DiffRoundTrip) {
+  InMemoryDatastore ipld1;
+  std::vector<CID> cids;
+  for (auto i = 0; i < 10; ++i) {
+    EXPECT_OUTCOME_TRUE(cid, ipld1.setCbor(Sample2{i}));
+    cids.push_back(cid);
+  }
+  EXPECT_OUTCOME_TRUE(base, ipld1.setCbor(Sample1{cids, {}}));
+  EXPECT_OUTCOME_TRUE(changed, ipld1.setCbor(Sample2{100}));
+  cids[5] = changed;
+  EXPECT_OUTCOME_TRUE(root, ipld1.setCbor(Sample1{cids, {}}));
+
+  EXPECT_OUTCOME_TRUE(diff, makeDiffCar(ipld1, {base}, {root}));
+  Buffer expected;
+  writeHeader(expected, {root});
+  EXPECT_OUTCOME_TRUE_1(writeItem(expected, ipld1, root));
+  EXPECT_OUTCOME_TRUE_1(writeItem(expected, ipld1, changed));
+  EXPECT_EQ(diff, expected);
+
+  InMemoryDatastore ipld2;
+  EXPECT_OUTCOME_TRUE(base_car, makeCar(ipld1, {base}));
+  EXPECT_OUTCOME_TRUE_1(loadCar(ipld2, base_car));
+  std::stringstream stream{std::string{diff.begin(), diff.end()}};
+  EXPECT_OUTCOME_TRUE(roots, loadDiffCar(ipld2, stream));
+  EXPECT_THAT(roots, testing::ElementsAre(root));
+  EXPECT_OUTCOME_EQ(makeCar(ipld2, {root}), makeCar(ipld1, {root}).value());
+
+  InMemoryDatastore ipld3;
+  std::stringstream stream3{std::string{diff.begin(), diff.end()}};
+  EXPECT_OUTCOME_ERROR(CarError::MISSING_BLOCK, loadDiffCar(ipld3, stream3));
+}
+
 /**
  * Interop test with go-fil-markets/storagemarket/integration_test.go
  * @given PAYLOAD_FILE with some data, cid_root of dag and selective_car bytes
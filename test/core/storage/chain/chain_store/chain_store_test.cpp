@@ -6,6 +6,8 @@
 #include "storage/chain/impl/chain_store_impl.hpp"
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
 #include "blockchain/impl/weight_calculator_impl.hpp"
 #include "common/hexutil.hpp"
 #include "primitives/cid/cid_of_cbor.hpp"
@@ -17,6 +19,7 @@
 #include "testutil/mocks/blockchain/weight_calculator_mock.hpp"
 #include "testutil/outcome.hpp"
 
+using fc::CID;
 using fc::blockchain::block_validator::BlockValidatorMock;
 using fc::blockchain::weight::WeightCalculatorImpl;
 using fc::blockchain::weight::WeightCalculatorMock;
@@ -25,6 +28,10 @@ using fc::primitives::BigInt;
 using fc::primitives::block::BlockHeader;
 using fc::primitives::ticket::Ticket;
 using fc::storage::blockchain::ChainDataStoreImpl;
+using fc::primitives::tipset::HeadChange;
+using fc::primitives::tipset::HeadChangeType;
+using fc::primitives::tipset::TipsetKey;
+using fc::storage::blockchain::ChainStoreError;
 using fc::storage::blockchain::ChainStoreImpl;
 using fc::storage::ipfs::InMemoryDatastore;
 using fc::storage::ipfs::IpfsBlockService;
@@ -67,25 +74,85 @@ struct ChainStoreTest : public ::testing::Test {
 
   void SetUp() override {
     // create chain store
-    auto block_service = std::make_shared<IpfsBlockService>(
+    block_service = std::make_shared<IpfsBlockService>(
         std::make_shared<InMemoryDatastore>());
     auto data_store = std::make_shared<ChainDataStoreImpl>(
         std::make_shared<InMemoryDatastore>());
-    auto block_validator = std::make_shared<BlockValidatorMock>();
-    auto weight_calculator = std::make_shared<WeightCalculatorMock>();
+    block_validator = std::make_shared<BlockValidatorMock>();
+    weight_calculator = std::make_shared<WeightCalculatorMock>();
 
     EXPECT_CALL(*weight_calculator, calculateWeight(testing::_))
         .WillRepeatedly(testing::Return(1));
 
-    EXPECT_OUTCOME_TRUE(store,
-                        ChainStoreImpl::create(std::move(block_service),
-                                               std::move(block_validator),
-                                               std::move(weight_calculator)));
+    EXPECT_OUTCOME_TRUE(
+        store,
+        ChainStoreImpl::create(
+            block_service, block_validator, weight_calculator));
     chain_store = std::move(store);
 
     block = makeBlock();
   }
 
+  /**
+   * @brief makes chain of single block tipsets, heavier when higher
+   * @param parent block to build on
+   * @param heights heights of blocks to make, skipped heights are null rounds
+   * @param timestamp distinguishes blocks of different forks
+   * @return keys of added tipsets by height
+   */
+  std::map<uint64_t, TipsetKey> addChain(BlockHeader parent,
+                                         const std::vector<uint64_t> &heights,
+                                         uint64_t timestamp) {
+    std::map<uint64_t, TipsetKey> keys;
+    for (auto height : heights) {
+      auto child = makeBlock();
+      EXPECT_OUTCOME_TRUE(parent_cid, getCidOfCbor(parent));
+      child.parents = {parent_cid};
+      child.height = height;
+      child.timestamp = timestamp;
+      EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(child));
+      EXPECT_OUTCOME_TRUE(cid, getCidOfCbor(child));
+      keys.emplace(height, TipsetKey{{cid}});
+      parent = std::move(child);
+    }
+    return keys;
+  }
+
+  /// makes genesis block and chain on top of it
+  std::map<uint64_t, TipsetKey> addChain(uint64_t head_height) {
+    EXPECT_CALL(*weight_calculator, calculateWeight(testing::_))
+        .WillRepeatedly(testing::Invoke(
+            [](auto &tipset) { return BigInt{tipset.height}; }));
+    auto genesis = makeBlock();
+    genesis.parents = {};
+    genesis.height = 0;
+    EXPECT_OUTCOME_TRUE_1(chain_store->addBlock(genesis));
+    EXPECT_OUTCOME_TRUE(genesis_cid, getCidOfCbor(genesis));
+    std::vector<uint64_t> heights;
+    for (uint64_t height = 1; height <= head_height; ++height) {
+      // null rounds
+      if (height % 50 != 0) {
+        heights.push_back(height);
+      }
+    }
+    auto keys = addChain(genesis, heights, 0);
+    keys.emplace(0, TipsetKey{{genesis_cid}});
+    return keys;
+  }
+
+  /// creates another store over the same storage, as if node restarted
+  std::shared_ptr<ChainStoreImpl> reopen() {
+    EXPECT_OUTCOME_TRUE(
+        store,
+        ChainStoreImpl::create(
+            block_service, block_validator, weight_calculator));
+    EXPECT_OUTCOME_TRUE_1(store->initialize());
+    return store;
+  }
+
+  std::shared_ptr<IpfsBlockService> block_service;
+  std::shared_ptr<BlockValidatorMock> block_validator;
+  std::shared_ptr<WeightCalculatorMock> weight_calculator;
   std::shared_ptr<ChainStoreImpl> chain_store;
   BlockHeader block;
 };
@@ -106,3 +173,159 @@ TEST_F(ChainStoreTest, AddBlockSuccess) {
                       chain_store->getCbor<BlockHeader>(block_cid));
   ASSERT_EQ(block, stored_block);
 }
+
+/**
+ * @given chain with null rounds
+ * @when load tipsets by height
+ * @then heaviest chain tipset at height or the next one above is returned
+ */
+TEST_F(ChainStoreTest, LoadTipsetByHeight) {
+  auto keys = addChain(320);
+  for (auto height : {0u, 1u, 49u, 50u, 51u, 100u, 250u, 320u}) {
+    EXPECT_OUTCOME_TRUE(tipset, chain_store->loadTipsetByHeight(height));
+    EXPECT_EQ(tipset.cids, keys.lower_bound(height)->second.cids);
+  }
+  EXPECT_OUTCOME_ERROR(ChainStoreError::NO_TIPSET_AT_HEIGHT,
+                       chain_store->loadTipsetByHeight(321));
+}
+
+/**
+ * @given chain store reopened over existing chain
+ * @when load tipsets by height below head
+ * @then tipsets are found from persistent checkpoints
+ */
+TEST_F(ChainStoreTest, LoadTipsetByHeightFromCheckpoints) {
+  auto keys = addChain(320);
+  auto store = reopen();
+  for (auto height : {320u, 299u, 150u, 149u, 1u, 0u, 200u}) {
+    EXPECT_OUTCOME_TRUE(tipset, store->loadTipsetByHeight(height));
+    EXPECT_EQ(tipset.cids, keys.lower_bound(height)->second.cids);
+  }
+}
+
+/**
+ * @given chain store with head
+ * @when store is reopened
+ * @then head and its weight are restored without computing weight
+ */
+TEST_F(ChainStoreTest, InitializeRestoresHeadCheckpoint) {
+  auto keys = addChain(120);
+  EXPECT_CALL(*weight_calculator, calculateWeight(_)).Times(0);
+  auto store = reopen();
+  EXPECT_OUTCOME_TRUE(head, store->heaviestTipset());
+  EXPECT_EQ(head.cids, keys.at(120).cids);
+  EXPECT_EQ(store->getHeaviestWeight(), BigInt{120});
+}
+
+/**
+ * @given chain reorganized to heavier fork
+ * @when load tipsets by height
+ * @then tipsets of fork are returned, also after store is reopened
+ */
+TEST_F(ChainStoreTest, LoadTipsetByHeightAfterReorg) {
+  auto keys = addChain(320);
+  EXPECT_OUTCOME_TRUE(fork_base, chain_store->loadTipsetByHeight(270));
+  std::vector<uint64_t> heights;
+  for (uint64_t height = 271; height <= 330; ++height) {
+    heights.push_back(height);
+  }
+  auto fork = addChain(fork_base.blks[0], heights, 1);
+  for (auto &[height, key] : fork) {
+    keys.insert_or_assign(height, key);
+  }
+  EXPECT_OUTCOME_TRUE(head, chain_store->heaviestTipset());
+  EXPECT_EQ(head.cids, fork.at(330).cids);
+
+  auto store = reopen();
+  for (auto height : {300u, 271u, 270u, 320u}) {
+    EXPECT_OUTCOME_TRUE(tipset, chain_store->loadTipsetByHeight(height));
+    EXPECT_EQ(tipset.cids, keys.lower_bound(height)->second.cids);
+    EXPECT_OUTCOME_TRUE(reopened, store->loadTipsetByHeight(height));
+    EXPECT_EQ(reopened.cids, keys.lower_bound(height)->second.cids);
+  }
+}
+
+/**
+ * @given reopened store, whose height index has only head, and fork from
+ * height far below head
+ * @when fork becomes heavier
+ * @then head change batch reverts old chain down to fork point and applies
+ * fork in order
+ */
+TEST_F(ChainStoreTest, ReorgBelowHeightIndex) {
+  auto keys = addChain(320);
+  chain_store = reopen();
+  EXPECT_OUTCOME_TRUE(fork_base, chain_store->loadTipsetByHeight(150));
+  std::vector<uint64_t> heights;
+  for (uint64_t height = 151; height <= 321; ++height) {
+    heights.push_back(height);
+  }
+  std::vector<HeadChange> batch;
+  auto cnn = chain_store->subscribeHeadChangeBatches(
+      [&](auto &changes) { batch = changes; });
+  auto fork = addChain(fork_base.blks[0], heights, 1);
+
+  std::vector<std::vector<CID>> expected;
+  for (auto it = keys.rbegin(); it->first > 150; ++it) {
+    expected.push_back(it->second.cids);
+  }
+  for (auto &[height, key] : fork) {
+    expected.push_back(key.cids);
+  }
+  ASSERT_EQ(batch.size(), expected.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(batch[i].type,
+              i < expected.size() - fork.size() ? HeadChangeType::REVERT
+                                                : HeadChangeType::APPLY);
+    EXPECT_EQ(batch[i].value.cids, expected[i]);
+  }
+}
+
+/**
+ * @given reopened store, whose height index has only head
+ * @when load tipsets by height from several threads
+ * @then each thread gets heaviest chain tipsets while index is extended
+ */
+TEST_F(ChainStoreTest, LoadTipsetByHeightConcurrently) {
+  auto keys = addChain(320);
+  auto store = reopen();
+  std::vector<std::thread> threads;
+  for (uint64_t offset = 0; offset < 4; ++offset) {
+    threads.emplace_back([&, offset] {
+      for (uint64_t height = 320 - offset; height > 1; height -= 4) {
+        EXPECT_OUTCOME_TRUE(tipset, store->loadTipsetByHeight(height));
+        EXPECT_EQ(tipset.cids, keys.lower_bound(height)->second.cids);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * @given chain store with chain
+ * @when blocks are added while other thread reads head and tipsets by height
+ * @then reader sees consistent head, whose height tipset is loaded
+ */
+TEST_F(ChainStoreTest, ReadWhileAddingBlocks) {
+  auto keys = addChain(100);
+  std::atomic_bool done{false};
+  std::thread reader{[&] {
+    while (!done) {
+      EXPECT_OUTCOME_TRUE(head, chain_store->heaviestTipset());
+      EXPECT_OUTCOME_TRUE(tipset, chain_store->loadTipsetByHeight(head.height));
+      EXPECT_GE(tipset.height, head.height);
+    }
+  }};
+  EXPECT_OUTCOME_TRUE(base, chain_store->heaviestTipset());
+  std::vector<uint64_t> heights;
+  for (uint64_t height = 101; height <= 200; ++height) {
+    heights.push_back(height);
+  }
+  addChain(base.blks[0], heights, 0);
+  done = true;
+  reader.join();
+  EXPECT_OUTCOME_TRUE(head, chain_store->heaviestTipset());
+  EXPECT_EQ(head.height, 200u);
+}
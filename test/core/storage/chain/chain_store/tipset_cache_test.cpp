@@ -0,0 +1,89 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/impl/tipset_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/literals.hpp"
+
+using fc::storage::blockchain::Tipset;
+using fc::storage::blockchain::TipsetCache;
+using fc::storage::blockchain::TipsetCPtr;
+using fc::storage::blockchain::TipsetKey;
+
+struct TipsetCacheTest : public ::testing::Test {
+  TipsetCPtr tipset(uint64_t height) {
+    Tipset tipset;
+    tipset.height = height;
+    return std::make_shared<const Tipset>(std::move(tipset));
+  }
+
+  TipsetKey key1{{"010001020001"_cid}};
+  TipsetKey key2{{"010001020002"_cid}};
+  TipsetKey key3{{"010001020003"_cid}};
+};
+
+/**
+ * @given cache with capacity of 2 tipsets
+ * @when third tipset is put
+ * @then least recently used tipset is evicted
+ */
+TEST_F(TipsetCacheTest, EvictsLeastRecentlyUsed) {
+  TipsetCache cache{2};
+  cache.put(key1, tipset(1));
+  cache.put(key2, tipset(2));
+  EXPECT_EQ(cache.get(key1)->height, 1u);
+  cache.put(key3, tipset(3));
+
+  EXPECT_TRUE(cache.contains(key1));
+  EXPECT_FALSE(cache.contains(key2));
+  EXPECT_TRUE(cache.contains(key3));
+
+  EXPECT_FALSE(cache.get(key2));
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.entries, 2u);
+}
+
+/**
+ * @given cache with capacity of 1 tipset and pinned tipset
+ * @when other tipsets are put
+ * @then pinned tipset is kept until unpinned
+ */
+TEST_F(TipsetCacheTest, PinnedNotEvicted) {
+  TipsetCache cache{1};
+  cache.pin(key1, tipset(1));
+  cache.pin(key1, tipset(1));
+  cache.put(key2, tipset(2));
+  cache.put(key3, tipset(3));
+  EXPECT_TRUE(cache.contains(key1));
+  EXPECT_FALSE(cache.contains(key2));
+  EXPECT_EQ(cache.stats().pinned, 1u);
+
+  EXPECT_TRUE(cache.unpin(key1));
+  EXPECT_TRUE(cache.contains(key1));
+  EXPECT_TRUE(cache.unpin(key1));
+  EXPECT_FALSE(cache.unpin(key1));
+  // unpinned tipset is most recently used
+  EXPECT_TRUE(cache.contains(key1));
+  EXPECT_FALSE(cache.contains(key3));
+  EXPECT_EQ(cache.stats().pinned, 0u);
+}
+
+/**
+ * @given cached tipset
+ * @when equal tipset is put again
+ * @then cached tipset is returned and kept
+ */
+TEST_F(TipsetCacheTest, Interned) {
+  TipsetCache cache{2};
+  auto first = tipset(1);
+  EXPECT_EQ(cache.put(key1, first), first);
+  EXPECT_EQ(cache.put(key1, tipset(1)), first);
+  EXPECT_EQ(cache.get(key1), first);
+}
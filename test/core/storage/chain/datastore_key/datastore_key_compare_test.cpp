@@ -59,3 +59,22 @@ TEST_F(DatastoreKeyCompareTest, LessSuccess) {
   ASSERT_FALSE(make("/b") < make("/a/b/c/d/e/f/g/h"));
   ASSERT_FALSE(make("/a") < make("/"));
 }
+
+/**
+ * @given keys of parent, child and sibling with longer segment
+ * @when converted to binary
+ * @then binary parent is prefix of child only
+ */
+TEST_F(DatastoreKeyCompareTest, BinaryPrefix) {
+  auto parent = DatastoreKey::makeFromString("/a/b").toBinary();
+  auto child = DatastoreKey::makeFromString("/a/b/c").toBinary();
+  auto sibling = DatastoreKey::makeFromString("/a/bc").toBinary();
+  auto starts = [&](const fc::common::Buffer &key) {
+    return key.size() >= parent.size()
+           && std::equal(parent.begin(), parent.end(), key.begin());
+  };
+  EXPECT_EQ(parent, (fc::common::Buffer{1, 'a', 1, 'b'}));
+  EXPECT_TRUE(starts(child));
+  EXPECT_FALSE(starts(sibling));
+  EXPECT_TRUE(DatastoreKey::makeFromString("/").toBinary().empty());
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/head_change_dispatcher.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <future>
+
+using fc::primitives::tipset::HeadChange;
+using fc::primitives::tipset::HeadChangeType;
+using fc::storage::blockchain::HeadChangeDispatcher;
+using Changes = HeadChangeDispatcher::Changes;
+
+HeadChange change(HeadChangeType type, uint64_t height) {
+  HeadChange change{.type = type};
+  change.value.height = height;
+  return change;
+}
+
+/// Batches as (type, height) pairs, tipsets are compared by height
+using Batches = std::vector<std::vector<std::pair<HeadChangeType, uint64_t>>>;
+
+void record(Batches &batches, const Changes &changes) {
+  auto &batch{batches.emplace_back()};
+  for (auto &change : changes) {
+    batch.emplace_back(change.type, change.value.height);
+  }
+}
+
+/**
+ * @given dispatcher with published head
+ * @when subscribe on event loop and publish head switch
+ * @then current head and then whole switch are delivered on event loop
+ */
+TEST(HeadChangeDispatcher, Batches) {
+  boost::asio::io_context io;
+  HeadChangeDispatcher dispatcher{1};
+  dispatcher.publish({change(HeadChangeType::CURRENT, 1)});
+  Batches batches;
+  auto cnn{dispatcher.subscribe(
+      "test", io.get_executor(), [&](auto &changes) {
+        record(batches, changes);
+      })};
+  dispatcher.publish({change(HeadChangeType::REVERT, 1),
+                      change(HeadChangeType::APPLY, 2),
+                      change(HeadChangeType::APPLY, 3)});
+  EXPECT_TRUE(batches.empty());
+  io.run();
+  EXPECT_EQ(batches,
+            (Batches{{{HeadChangeType::CURRENT, 1}},
+                     {{HeadChangeType::REVERT, 1},
+                      {HeadChangeType::APPLY, 2},
+                      {HeadChangeType::APPLY, 3}}}));
+
+  // late subscriber starts from new head
+  Batches late;
+  auto late_cnn{dispatcher.subscribe(
+      "late", io.get_executor(), [&](auto &changes) {
+        record(late, changes);
+      })};
+  io.restart();
+  io.run();
+  EXPECT_EQ(late, (Batches{{{HeadChangeType::CURRENT, 3}}}));
+}
+
+/**
+ * @given subscriber with queued batch
+ * @when disconnect before batch is handled
+ * @then batch is dropped
+ */
+TEST(HeadChangeDispatcher, Disconnect) {
+  boost::asio::io_context io;
+  HeadChangeDispatcher dispatcher{1};
+  Batches batches;
+  auto cnn{dispatcher.subscribe(
+      "test", io.get_executor(), [&](auto &changes) {
+        record(batches, changes);
+      })};
+  dispatcher.publish({change(HeadChangeType::APPLY, 1)});
+  cnn.disconnect();
+  io.run();
+  EXPECT_TRUE(batches.empty());
+}
+
+/**
+ * @given slow subscriber blocked in handler
+ * @when publish batches
+ * @then other subscriber handles them without waiting
+ */
+TEST(HeadChangeDispatcher, SlowSubscriber) {
+  HeadChangeDispatcher dispatcher{2};
+  std::promise<void> unblock;
+  auto blocked{unblock.get_future().share()};
+  auto slow{dispatcher.subscribe("slow", [=](auto &) { blocked.wait(); })};
+  std::promise<uint64_t> fast_done;
+  auto fast{dispatcher.subscribe("fast", [&](auto &changes) {
+    if (changes.back().value.height == 2) {
+      fast_done.set_value(changes.back().value.height);
+    }
+  })};
+  dispatcher.publish({change(HeadChangeType::APPLY, 1)});
+  dispatcher.publish({change(HeadChangeType::APPLY, 2)});
+  auto done{fast_done.get_future()};
+  auto status{done.wait_for(std::chrono::seconds{10})};
+  unblock.set_value();
+  ASSERT_EQ(status, std::future_status::ready);
+  EXPECT_EQ(done.get(), 2);
+}
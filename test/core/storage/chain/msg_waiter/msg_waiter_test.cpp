@@ -0,0 +1,159 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/msg_waiter.hpp"
+
+#include <gtest/gtest.h>
+#include "adt/array.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::adt::Array;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::ticket::Ticket;
+using fc::primitives::tipset::HeadChange;
+using fc::primitives::tipset::HeadChangeType;
+using fc::primitives::tipset::Tipset;
+using fc::storage::InMemoryStorage;
+using fc::storage::blockchain::MessageReceipt;
+using fc::storage::blockchain::MsgWaiter;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::message::UnsignedMessage;
+
+class MsgWaiterTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    UnsignedMessage message;
+    message.from = Address::makeFromId(100);
+    message.to = Address::makeFromId(101);
+    EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(message));
+    message_cid = cid;
+
+    auto genesis{makeTipset({}, 0, 0, {}, {})};
+    // chain a includes message at height 1, its receipt is in a2
+    a1 = makeTipset(genesis.cids, 1, 0, {message_cid}, {});
+    a2 = makeTipset(a1.cids, 2, 0, {}, {receipt_a});
+    // fork b includes message later, at height 3
+    auto b1{makeTipset(genesis.cids, 1, 1, {}, {})};
+    auto b2{makeTipset(b1.cids, 2, 1, {}, {})};
+    b3 = makeTipset(b2.cids, 3, 1, {message_cid}, {});
+    b4 = makeTipset(b3.cids, 4, 1, {}, {receipt_b});
+  }
+
+  Tipset makeTipset(const std::vector<CID> &parents,
+                    uint64_t height,
+                    uint64_t fork,
+                    const std::vector<CID> &bls_messages,
+                    const std::vector<MessageReceipt> &parent_receipts) {
+    MsgMeta meta;
+    ipld->load(meta);
+    EXPECT_OUTCOME_TRUE_1(meta.bls_messages.assign(bls_messages));
+    Array<MessageReceipt> receipts{ipld};
+    for (auto &receipt : parent_receipts) {
+      EXPECT_OUTCOME_TRUE_1(receipts.append(receipt));
+    }
+    BlockHeader block;
+    block.ticket = Ticket{};
+    block.parents = parents;
+    block.height = height;
+    // distinguishes blocks of forks at same height
+    block.timestamp = fork;
+    block.parent_state_root = "010001020001"_cid;
+    EXPECT_OUTCOME_TRUE(receipts_root, receipts.amt.flush());
+    block.parent_message_receipts = receipts_root;
+    EXPECT_OUTCOME_TRUE(messages, ipld->setCbor(meta));
+    block.messages = messages;
+    EXPECT_OUTCOME_TRUE_1(ipld->setCbor(block));
+    EXPECT_OUTCOME_TRUE(tipset, Tipset::create({block}));
+    return tipset;
+  }
+
+  /// Waiter over same index, as after restart
+  std::shared_ptr<MsgWaiter> restart() {
+    return std::make_shared<MsgWaiter>(ipld, index);
+  }
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<InMemoryStorage> index{std::make_shared<InMemoryStorage>()};
+  MessageReceipt receipt_a{fc::vm::VMExitCode::Ok, {}, 10};
+  MessageReceipt receipt_b{fc::vm::VMExitCode::Ok, {}, 20};
+  CID message_cid;
+  Tipset a1, a2, b3, b4;
+};
+
+/**
+ * @given chain with message indexed by waiter
+ * @when waiter restarts over same index with same head
+ * @then message is found from index without backfill
+ */
+TEST_F(MsgWaiterTest, RestartFromIndex) {
+  EXPECT_OUTCOME_TRUE_1(
+      restart()->onHeadChange({HeadChangeType::CURRENT, a2}));
+
+  auto waiter{restart()};
+  EXPECT_OUTCOME_TRUE(found, waiter->find(message_cid));
+  ASSERT_TRUE(found.is_initialized());
+  EXPECT_EQ(found->first.gas_used, receipt_a.gas_used);
+  EXPECT_EQ(found->second, a2.makeKey().value());
+
+  EXPECT_OUTCOME_TRUE_1(waiter->onHeadChange({HeadChangeType::CURRENT, a2}));
+  EXPECT_OUTCOME_TRUE(refound, waiter->find(message_cid));
+  ASSERT_TRUE(refound.is_initialized());
+  EXPECT_EQ(refound->second, a2.makeKey().value());
+}
+
+/**
+ * @given message indexed on chain a
+ * @when waiter restarts with head on fork b, which includes message later
+ * @then stale tipsets of chain a are reverted, waiter on message doesn't
+ * fire until tipset with its receipt is applied
+ */
+TEST_F(MsgWaiterTest, RestartOnFork) {
+  EXPECT_OUTCOME_TRUE_1(
+      restart()->onHeadChange({HeadChangeType::CURRENT, a2}));
+
+  auto waiter{restart()};
+  EXPECT_OUTCOME_TRUE_1(waiter->onHeadChange({HeadChangeType::CURRENT, b3}));
+  EXPECT_OUTCOME_EQ(waiter->find(message_cid), boost::none);
+
+  boost::optional<MsgWaiter::Result> result;
+  waiter->wait(message_cid, [&](auto &res) { result = res; });
+  EXPECT_FALSE(result.is_initialized());
+
+  EXPECT_OUTCOME_TRUE_1(waiter->onHeadChange({HeadChangeType::APPLY, b4}));
+  ASSERT_TRUE(result.is_initialized());
+  EXPECT_EQ(result->first.gas_used, receipt_b.gas_used);
+  EXPECT_EQ(result->second, b4.makeKey().value());
+  EXPECT_OUTCOME_TRUE(found, restart()->find(message_cid));
+  ASSERT_TRUE(found.is_initialized());
+  EXPECT_EQ(found->second, b4.makeKey().value());
+}
+
+/**
+ * @given message indexed on chain a
+ * @when head switches to fork b by revert and apply changes
+ * @then message is not found and waiter doesn't fire until it is included
+ * again
+ */
+TEST_F(MsgWaiterTest, SwitchFork) {
+  auto waiter{restart()};
+  EXPECT_OUTCOME_TRUE_1(waiter->onHeadChange({HeadChangeType::CURRENT, a2}));
+  EXPECT_OUTCOME_TRUE_1(waiter->onHeadChange({HeadChangeType::REVERT, a2}));
+  EXPECT_OUTCOME_EQ(waiter->find(message_cid), boost::none);
+
+  boost::optional<MsgWaiter::Result> result;
+  waiter->wait(message_cid, [&](auto &res) { result = res; });
+  EXPECT_OUTCOME_TRUE_1(waiter->onHeadChange({HeadChangeType::APPLY, b3}));
+  EXPECT_FALSE(result.is_initialized());
+  EXPECT_OUTCOME_TRUE_1(waiter->onHeadChange({HeadChangeType::APPLY, b4}));
+  ASSERT_TRUE(result.is_initialized());
+  EXPECT_EQ(result->second, b4.makeKey().value());
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/state_indexer.hpp"
+
+#include <gtest/gtest.h>
+#include "adt/address_key.hpp"
+#include "adt/map.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::primitives::address::Address;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::ticket::Ticket;
+using fc::primitives::tipset::HeadChange;
+using fc::primitives::tipset::HeadChangeType;
+using fc::primitives::tipset::Tipset;
+using fc::storage::InMemoryStorage;
+using fc::storage::blockchain::StateIndexer;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::actor::Actor;
+using fc::vm::actor::kAccountCodeCid;
+using fc::vm::message::UnsignedMessage;
+using StateMap = fc::adt::Map<Actor, fc::adt::AddressKeyer>;
+
+class StateIndexerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    StateMap state{ipld};
+    EXPECT_OUTCOME_TRUE_1(state.set(alice, makeActor(1)));
+    EXPECT_OUTCOME_TRUE(root0, state.hamt.flush());
+    EXPECT_OUTCOME_TRUE_1(state.set(alice, makeActor(2)));
+    EXPECT_OUTCOME_TRUE_1(state.set(bob, makeActor(3)));
+    EXPECT_OUTCOME_TRUE(root1, state.hamt.flush());
+
+    UnsignedMessage message;
+    message.from = alice;
+    message.to = bob;
+    EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(message));
+    message_cid = cid;
+
+    auto genesis{makeTipset({}, 0, root0, {})};
+    auto ts1{makeTipset(genesis.cids, 1, root0, {message_cid})};
+    ts2 = makeTipset(ts1.cids, 2, root1, {});
+  }
+
+  Actor makeActor(uint64_t balance) {
+    return {kAccountCodeCid, "010001020001"_cid, 0, balance};
+  }
+
+  Tipset makeTipset(const std::vector<CID> &parents,
+                    uint64_t height,
+                    const CID &state_root,
+                    const std::vector<CID> &bls_messages) {
+    MsgMeta meta;
+    ipld->load(meta);
+    EXPECT_OUTCOME_TRUE_1(meta.bls_messages.assign(bls_messages));
+    BlockHeader block;
+    block.ticket = Ticket{};
+    block.parents = parents;
+    block.height = height;
+    block.parent_state_root = state_root;
+    block.parent_message_receipts = "010001020002"_cid;
+    EXPECT_OUTCOME_TRUE(messages, ipld->setCbor(meta));
+    block.messages = messages;
+    EXPECT_OUTCOME_TRUE_1(ipld->setCbor(block));
+    EXPECT_OUTCOME_TRUE(tipset, Tipset::create({block}));
+    return tipset;
+  }
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<StateIndexer> indexer{std::make_shared<StateIndexer>(
+      ipld, std::make_shared<InMemoryStorage>())};
+  Address alice{Address::makeFromId(100)};
+  Address bob{Address::makeFromId(101)};
+  CID message_cid;
+  Tipset ts2;
+};
+
+/**
+ * @given chain with message from alice to bob and changed state
+ * @when head is set and then its tipset is reverted
+ * @then message and actor changes are indexed by epoch, and removed on revert
+ */
+TEST_F(StateIndexerTest, ApplyRevert) {
+  EXPECT_OUTCOME_TRUE_1(
+      indexer->onHeadChange(HeadChange{HeadChangeType::CURRENT, ts2}));
+  for (auto &address : {alice, bob}) {
+    EXPECT_OUTCOME_TRUE(messages, indexer->messages(address));
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].epoch, 2);
+    EXPECT_EQ(messages[0].cid, message_cid);
+  }
+  EXPECT_OUTCOME_TRUE(changes, indexer->actorChanges(bob));
+  ASSERT_EQ(changes.size(), 1);
+  EXPECT_EQ(changes[0].epoch, 2);
+  EXPECT_EQ(changes[0].actor, makeActor(3));
+  EXPECT_OUTCOME_TRUE(alice_changes, indexer->actorChanges(alice));
+  EXPECT_EQ(alice_changes.size(), 1);
+
+  EXPECT_OUTCOME_TRUE_1(
+      indexer->onHeadChange(HeadChange{HeadChangeType::REVERT, ts2}));
+  EXPECT_OUTCOME_TRUE(reverted, indexer->messages(alice));
+  EXPECT_TRUE(reverted.empty());
+  EXPECT_OUTCOME_TRUE(reverted_changes, indexer->actorChanges(bob));
+  EXPECT_TRUE(reverted_changes.empty());
+
+  EXPECT_OUTCOME_TRUE_1(
+      indexer->onHeadChange(HeadChange{HeadChangeType::APPLY, ts2}));
+  EXPECT_OUTCOME_TRUE(applied, indexer->messages(bob));
+  EXPECT_EQ(applied.size(), 1);
+}
@@ -4,6 +4,7 @@
  */
 
 #include "storage/config/config.hpp"
+#include "storage/config/storage_profile.hpp"
 
 #include <gtest/gtest.h>
 
@@ -204,3 +205,20 @@ TEST_F(ConfigImplTest, SaveInvalidPath) {
   auto filename = "[:\\\\\\\\/*\\\"?|<>']";
   EXPECT_OUTCOME_ERROR(ConfigError::CANNOT_OPEN_FILE, config.save(filename));
 }
+
+/**
+ * @given config with some storage profile values
+ * @when load storage profile
+ * @then values are overridden, others are default
+ */
+TEST_F(ConfigImplTest, LoadStorageProfile) {
+  using fc::storage::config::StorageNamespace;
+  EXPECT_OUTCOME_TRUE_1(config.set("storage.state.block_cache_bytes", 1024));
+  EXPECT_OUTCOME_TRUE_1(config.set("storage.chain.bloom_bits_per_key", 0));
+  auto profile = fc::storage::config::loadStorageProfile(config);
+  auto defaults = fc::storage::config::defaultStorageProfile();
+  EXPECT_EQ(profile.profile(StorageNamespace::STATE).block_cache_bytes, 1024);
+  EXPECT_EQ(profile.profile(StorageNamespace::CHAIN).bloom_bits_per_key, 0);
+  EXPECT_EQ(profile.profile(StorageNamespace::CHAIN).block_cache_bytes,
+            defaults.profile(StorageNamespace::CHAIN).block_cache_bytes);
+}
@@ -0,0 +1,44 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/copy/buffer_map_copy.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::common::Buffer;
+using fc::storage::copyBufferMap;
+using fc::storage::InMemoryStorage;
+
+/**
+ * @given map with more pairs than batch size
+ * @when copy it to map with stale pair
+ * @then all pairs are copied and stale one is overwritten
+ */
+TEST(BufferMapCopy, CopiesAllPairs) {
+  InMemoryStorage from, to;
+  for (uint8_t i = 0; i < 10; ++i) {
+    EXPECT_OUTCOME_TRUE_1(from.put(Buffer{i}, Buffer{i, i}));
+  }
+  EXPECT_OUTCOME_TRUE_1(to.put(Buffer{1}, Buffer{0}));
+
+  EXPECT_OUTCOME_EQ(copyBufferMap(from, to, 3), 10);
+  for (uint8_t i = 0; i < 10; ++i) {
+    EXPECT_OUTCOME_EQ(to.get(Buffer{i}), (Buffer{i, i}));
+  }
+}
+
+/**
+ * @given empty map
+ * @when copy it
+ * @then nothing is copied
+ */
+TEST(BufferMapCopy, Empty) {
+  InMemoryStorage from, to;
+  EXPECT_OUTCOME_EQ(copyBufferMap(from, to), 0);
+  EXPECT_FALSE(to.cursor()->isValid());
+}
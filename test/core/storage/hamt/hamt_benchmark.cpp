@@ -0,0 +1,77 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "storage/hamt/hamt.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+
+using fc::storage::hamt::Hamt;
+using fc::storage::ipfs::InMemoryDatastore;
+
+namespace {
+  auto key(int64_t i) {
+    return std::to_string(i);
+  }
+
+  auto value(int64_t i) {
+    return fc::codec::cbor::encode(i).value();
+  }
+
+  /// Hamt with keys [0, n) flushed to store
+  auto makeHamt(std::shared_ptr<InMemoryDatastore> store, int64_t n) {
+    Hamt hamt{store};
+    for (int64_t i{0}; i < n; ++i) {
+      hamt.set(key(i), value(i)).value();
+    }
+    return hamt.flush().value();
+  }
+}  // namespace
+
+/// Set keys into empty hamt without flush
+void HamtSet(benchmark::State &state) {
+  auto store{std::make_shared<InMemoryDatastore>()};
+  for (auto _ : state) {
+    Hamt hamt{store};
+    for (int64_t i{0}; i < state.range(0); ++i) {
+      hamt.set(key(i), value(i)).value();
+    }
+    benchmark::DoNotOptimize(hamt);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HamtSet)->RangeMultiplier(10)->Range(1e3, 1e7);
+
+/// Get every key of flushed hamt
+void HamtGet(benchmark::State &state) {
+  auto store{std::make_shared<InMemoryDatastore>()};
+  auto root{makeHamt(store, state.range(0))};
+  for (auto _ : state) {
+    Hamt hamt{store, root};
+    for (int64_t i{0}; i < state.range(0); ++i) {
+      benchmark::DoNotOptimize(hamt.get(key(i)).value());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HamtGet)->RangeMultiplier(10)->Range(1e3, 1e7);
+
+/// Flush hamt with all nodes changed
+void HamtFlush(benchmark::State &state) {
+  auto store{std::make_shared<InMemoryDatastore>()};
+  for (auto _ : state) {
+    state.PauseTiming();
+    Hamt hamt{store};
+    for (int64_t i{0}; i < state.range(0); ++i) {
+      hamt.set(key(i), value(i)).value();
+    }
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(hamt.flush().value());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HamtFlush)->RangeMultiplier(10)->Range(1e3, 1e7);
+
+BENCHMARK_MAIN();
@@ -6,6 +6,8 @@
 #include "storage/hamt/hamt.hpp"
 
 #include <gtest/gtest.h>
+#include <mutex>
+#include <set>
 #include "codec/cbor/cbor.hpp"
 #include "common/which.hpp"
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
@@ -15,6 +17,7 @@ using fc::codec::cbor::encode;
 using fc::common::which;
 using fc::storage::hamt::Hamt;
 using fc::storage::hamt::HamtError;
+using fc::storage::hamt::HamtKey;
 using fc::storage::hamt::Node;
 
 class HamtTest : public ::testing::Test {
@@ -291,6 +294,105 @@ TEST_F(HamtTest, VisitorError) {
   EXPECT_EQ(n, 1);
 }
 
+/**
+ * @given HAMT with sharded keys
+ * @when visit pages of keys, each after last key of previous page
+ * @then pages together are same as full visit, stopped visit returns false
+ */
+TEST_F(HamtTest, VisitWhilePages) {
+  for (auto i = 0; i < 40; ++i) {
+    EXPECT_OUTCOME_TRUE_1(hamt_.set(std::to_string(i), "01"_unhex));
+  }
+  EXPECT_OUTCOME_TRUE_1(hamt_.flush());
+  std::vector<std::string> all;
+  EXPECT_OUTCOME_TRUE_1(hamt_.visit([&](auto &key, auto &) {
+    all.push_back(key);
+    return fc::outcome::success();
+  }));
+
+  std::vector<std::string> paged;
+  boost::optional<std::string> after;
+  while (true) {
+    size_t page = 0;
+    EXPECT_OUTCOME_TRUE(
+        more,
+        hamt_.visitWhile(
+            [&](auto &key, auto &) -> fc::outcome::result<bool> {
+              paged.push_back(key);
+              return ++page < 7;
+            },
+            after));
+    if (more) {
+      break;
+    }
+    after = paged.back();
+  }
+  EXPECT_EQ(paged, all);
+}
+
+/**
+ * @given flushed HAMT with sharded keys
+ * @when visit it in parallel, unordered and ordered
+ * @then same pairs are visited, ordered visit is in order of visit,
+ *       visitor error is returned
+ */
+TEST_F(HamtTest, VisitParallel) {
+  for (auto i = 0; i < 300; ++i) {
+    EXPECT_OUTCOME_TRUE_1(hamt_.set(std::to_string(i), "01"_unhex));
+  }
+  EXPECT_OUTCOME_TRUE(cid, hamt_.flush());
+  Hamt hamt{store_, cid, 8};
+  std::vector<std::string> all;
+  EXPECT_OUTCOME_TRUE_1(hamt.visit([&](auto &key, auto &) {
+    all.push_back(key);
+    return fc::outcome::success();
+  }));
+
+  std::mutex mutex;
+  std::set<std::string> unordered;
+  EXPECT_OUTCOME_TRUE_1(hamt.visitParallel([&](auto &key, auto &) {
+    std::lock_guard lock{mutex};
+    unordered.insert(key);
+    return fc::outcome::success();
+  }));
+  EXPECT_EQ(unordered, std::set<std::string>(all.begin(), all.end()));
+
+  std::vector<std::string> ordered;
+  EXPECT_OUTCOME_TRUE_1(hamt.visitParallel(
+      [&](auto &key, auto &) {
+        ordered.push_back(key);
+        return fc::outcome::success();
+      },
+      true));
+  EXPECT_EQ(ordered, all);
+
+  EXPECT_OUTCOME_ERROR(HamtError::NOT_FOUND,
+                       hamt.visitParallel([](auto &, auto &) {
+                         return HamtError::NOT_FOUND;
+                       }));
+}
+
+/**
+ * @given items with repeated key
+ * @when assign them to hamt
+ * @then root is same as after setting them one by one
+ */
+TEST_F(HamtTest, AssignSameAsSet) {
+  std::vector<std::pair<std::string, fc::storage::hamt::Value>> items;
+  for (auto i = 0; i < 100; ++i) {
+    items.emplace_back(std::to_string(i), "01"_unhex);
+    EXPECT_OUTCOME_TRUE_1(hamt_.set(std::to_string(i), "01"_unhex));
+  }
+  items.emplace_back("7", "02"_unhex);
+  EXPECT_OUTCOME_TRUE_1(hamt_.set("7", "02"_unhex));
+
+  Hamt assigned{store_, 8};
+  EXPECT_OUTCOME_TRUE_1(assigned.assign(std::move(items)));
+  EXPECT_OUTCOME_EQ(assigned.get("7"), "02"_unhex);
+  EXPECT_OUTCOME_TRUE(cid, hamt_.flush());
+  EXPECT_OUTCOME_EQ(assigned.flush(), cid);
+}
+
 /**
  * @given an empty HAMT
  * @when place an element
@@ -301,3 +403,91 @@ TEST_F(HamtTest, Contains) {
   EXPECT_OUTCOME_TRUE_1(hamt_.set("element", "01"_unhex));
   EXPECT_OUTCOME_EQ(hamt_.contains("element"), true);
 }
+
+/**
+ * @given keys updated in place with hashed keys
+ * @when updater sees current value or fails
+ * @then result is same as of set, failed update changes nothing
+ */
+TEST_F(HamtTest, Update) {
+  using fc::storage::hamt::Value;
+  Hamt expected{store_, 1};
+  Hamt hamt{store_, 1};
+  for (auto i = 0; i < 100; ++i) {
+    HamtKey key{std::to_string(i % 40)};
+    EXPECT_OUTCOME_TRUE_1(expected.set(key.key(), Value{uint8_t(i)}));
+    EXPECT_OUTCOME_TRUE_1(
+        hamt.update(key, [&](auto value) -> fc::outcome::result<Value> {
+          EXPECT_EQ(value != nullptr, i >= 40);
+          return Value{uint8_t(i)};
+        }));
+  }
+  HamtKey key{"10"};
+  EXPECT_OUTCOME_EQ(hamt.get(key), Value{uint8_t(90)});
+  EXPECT_OUTCOME_ERROR(
+      HamtError::NOT_FOUND,
+      hamt.update(key, [](auto) -> fc::outcome::result<Value> {
+        return HamtError::NOT_FOUND;
+      }));
+  EXPECT_OUTCOME_EQ(hamt.contains(HamtKey{"40"}), false);
+  EXPECT_OUTCOME_EQ(hamt.flush(), expected.flush().value());
+}
+
+/**
+ * @given flushed HAMT and another HAMT loaded from same root
+ * @when modify second HAMT
+ * @then first HAMT still reads old values from shared cached node
+ */
+TEST_F(HamtTest, NodeCacheCopyOnWrite) {
+  EXPECT_OUTCOME_TRUE_1(hamt_.set("aai", "01"_unhex));
+  EXPECT_OUTCOME_TRUE(root, hamt_.flush());
+  EXPECT_TRUE(Hamt::nodeCache().get(root));
+
+  Hamt hamt2{store_, root, 8};
+  EXPECT_OUTCOME_TRUE_1(hamt2.set("aai", "02"_unhex));
+  EXPECT_OUTCOME_TRUE_1(hamt2.set("ade", "03"_unhex));
+  EXPECT_OUTCOME_EQ(hamt_.get("aai"), "01"_unhex);
+  EXPECT_OUTCOME_EQ(hamt_.contains("ade"), false);
+  EXPECT_OUTCOME_EQ(Hamt(store_, root, 8).get("aai"), "01"_unhex);
+  EXPECT_OUTCOME_EQ(hamt2.get("aai"), "02"_unhex);
+}
+
+/**
+ * @given flushed HAMT and its copy with keys removed, changed and added
+ * @when diff copy against original
+ * @then only changed keys are visited with their values
+ */
+TEST_F(HamtTest, Diff) {
+  for (auto i = 0; i < 100; ++i) {
+    EXPECT_OUTCOME_TRUE_1(hamt_.set(std::to_string(i), "01"_unhex));
+  }
+  EXPECT_OUTCOME_TRUE(root, hamt_.flush());
+  Hamt after{store_, root, 8};
+  EXPECT_OUTCOME_TRUE_1(after.remove("3"));
+  EXPECT_OUTCOME_TRUE_1(after.set("7", "02"_unhex));
+  EXPECT_OUTCOME_TRUE_1(after.set("new", "03"_unhex));
+
+  std::set<std::string> changes;
+  EXPECT_OUTCOME_TRUE_1(after.diff(
+      hamt_,
+      [&](auto &key, auto before, auto value) -> fc::outcome::result<void> {
+        if (!value) {
+          EXPECT_EQ(*before, "01"_unhex);
+          changes.insert("-" + key);
+        } else if (!before) {
+          EXPECT_EQ(*value, "03"_unhex);
+          changes.insert("+" + key);
+        } else {
+          EXPECT_EQ(*value, "02"_unhex);
+          changes.insert("~" + key);
+        }
+        return fc::outcome::success();
+      }));
+  EXPECT_EQ(changes, (std::set<std::string>{"-3", "~7", "+new"}));
+
+  EXPECT_OUTCOME_TRUE_1(hamt_.diff(
+      hamt_, [](auto &, auto, auto) -> fc::outcome::result<void> {
+        ADD_FAILURE();
+        return fc::outcome::success();
+      }));
+}
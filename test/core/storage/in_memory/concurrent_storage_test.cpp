@@ -0,0 +1,97 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/in_memory/concurrent_storage.hpp"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "testutil/outcome.hpp"
+
+using fc::common::Buffer;
+using fc::storage::ConcurrentStorage;
+using fc::storage::ConcurrentStorageError;
+
+/**
+ * @given storage
+ * @when put, overwrite and remove keys
+ * @then get reflects writes and size is accounted
+ */
+TEST(ConcurrentStorage, PutGetRemove) {
+  ConcurrentStorage storage;
+  EXPECT_OUTCOME_ERROR(ConcurrentStorageError::NOT_FOUND,
+                       storage.get(Buffer{1}));
+  EXPECT_OUTCOME_TRUE_1(storage.put(Buffer{1}, Buffer{1, 1}));
+  EXPECT_OUTCOME_TRUE_1(storage.put(Buffer{1}, Buffer{2}));
+  EXPECT_TRUE(storage.contains(Buffer{1}));
+  EXPECT_OUTCOME_EQ(storage.get(Buffer{1}), Buffer{2});
+  EXPECT_EQ(storage.bytes(), 2);
+  EXPECT_OUTCOME_TRUE_1(storage.remove(Buffer{1}));
+  EXPECT_FALSE(storage.contains(Buffer{1}));
+  EXPECT_EQ(storage.bytes(), 0);
+}
+
+/**
+ * @given storage with memory cap
+ * @when put more than cap
+ * @then put fails and storage is unchanged
+ */
+TEST(ConcurrentStorage, MemoryCap) {
+  ConcurrentStorage storage{4};
+  EXPECT_OUTCOME_TRUE_1(storage.put(Buffer{1}, Buffer{1, 1}));
+  EXPECT_OUTCOME_ERROR(ConcurrentStorageError::MEMORY_CAP_EXCEEDED,
+                       storage.put(Buffer{2}, Buffer{2, 2}));
+  EXPECT_FALSE(storage.contains(Buffer{2}));
+  EXPECT_OUTCOME_TRUE_1(storage.put(Buffer{1}, Buffer{1, 1, 1}));
+  EXPECT_EQ(storage.bytes(), 4);
+}
+
+/**
+ * @given cursor of storage
+ * @when storage is modified after cursor is created
+ * @then cursor iterates sorted keys of snapshot
+ */
+TEST(ConcurrentStorage, SnapshotCursor) {
+  ConcurrentStorage storage;
+  for (uint8_t i : {3, 1, 2}) {
+    EXPECT_OUTCOME_TRUE_1(storage.put(Buffer{i}, Buffer{i}));
+  }
+  auto cursor = storage.cursor();
+  EXPECT_OUTCOME_TRUE_1(storage.remove(Buffer{2}));
+  EXPECT_OUTCOME_TRUE_1(storage.put(Buffer{4}, Buffer{4}));
+
+  std::vector<Buffer> keys;
+  for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
+    keys.push_back(cursor->key());
+  }
+  EXPECT_EQ(keys, (std::vector<Buffer>{Buffer{1}, Buffer{2}, Buffer{3}}));
+  cursor->seek(Buffer{2});
+  EXPECT_EQ(cursor->value(), Buffer{2});
+}
+
+/**
+ * @given storage shared by threads
+ * @when threads put and read own keys
+ * @then all writes are visible
+ */
+TEST(ConcurrentStorage, Threads) {
+  constexpr uint8_t kThreads{8};
+  constexpr uint8_t kKeys{200};
+  ConcurrentStorage storage;
+  std::vector<std::thread> threads;
+  for (uint8_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (uint8_t i = 0; i < kKeys; ++i) {
+        EXPECT_OUTCOME_TRUE_1(storage.put(Buffer{t, i}, Buffer{i}));
+        EXPECT_OUTCOME_EQ(storage.get(Buffer{t, i}), Buffer{i});
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(storage.bytes(), kThreads * kKeys * 3);
+}
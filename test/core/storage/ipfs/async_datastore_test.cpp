@@ -0,0 +1,114 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/async_datastore.hpp"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/concurrent_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::ipfs::AsyncDatastore;
+using fc::storage::ipfs::ConcurrentDatastore;
+using fc::storage::ipfs::IpfsDatastoreError;
+
+class AsyncDatastoreTest : public ::testing::Test {
+ public:
+  /// Runs event loop until callbacks of started operations are called
+  void wait() {
+    while (pending != 0) {
+      // event loop stops each time it runs out of handlers
+      io->restart();
+      io->run_one();
+    }
+  }
+
+  template <typename T>
+  AsyncDatastore::Callback<T> expect(AsyncDatastore::Callback<T> f) {
+    ++pending;
+    return [this, f, thread{std::this_thread::get_id()}](auto result) {
+      // callbacks are called on event loop thread
+      EXPECT_EQ(std::this_thread::get_id(), thread);
+      f(std::move(result));
+      --pending;
+    };
+  }
+
+  CID cid1{"010001020001"_cid};
+  CID cid2{"010001020002"_cid};
+  Buffer value1{"0123"_unhex};
+  Buffer value2{"4567"_unhex};
+
+  std::shared_ptr<ConcurrentDatastore> store{
+      std::make_shared<ConcurrentDatastore>()};
+  std::shared_ptr<boost::asio::io_context> io{
+      std::make_shared<boost::asio::io_context>()};
+  AsyncDatastore async{store, io, 2};
+  size_t pending{};
+};
+
+/**
+ * @given async datastore
+ * @when set blocks and read them back
+ * @then writes are applied in order and reads see them
+ */
+TEST_F(AsyncDatastoreTest, SetThenGet) {
+  async.set(cid1, value2, expect<void>([](auto result) {
+    EXPECT_OUTCOME_TRUE_1(result);
+  }));
+  async.setMany({{cid1, value1}, {cid2, value2}},
+                expect<void>([](auto result) {
+                  EXPECT_OUTCOME_TRUE_1(result);
+                }));
+  wait();
+
+  async.get(cid1, expect<Buffer>([&](auto result) {
+    EXPECT_OUTCOME_EQ(result, value1);
+  }));
+  async.getMany({cid1, cid2},
+                expect<std::vector<Buffer>>([&](auto result) {
+                  EXPECT_OUTCOME_EQ(result,
+                                    (std::vector<Buffer>{value1, value2}));
+                }));
+  async.contains(cid2, expect<bool>([](auto result) {
+    EXPECT_OUTCOME_EQ(result, true);
+  }));
+  wait();
+}
+
+/**
+ * @given removed block
+ * @when get it
+ * @then callback receives not found error
+ */
+TEST_F(AsyncDatastoreTest, GetMissing) {
+  EXPECT_OUTCOME_TRUE_1(store->set(cid1, value1));
+  async.remove(cid1, expect<void>([](auto result) {
+    EXPECT_OUTCOME_TRUE_1(result);
+  }));
+  wait();
+  async.get(cid1, expect<Buffer>([](auto result) {
+    EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, result);
+  }));
+  wait();
+}
+
+/**
+ * @given stored and missing blocks
+ * @when prefetch them
+ * @then futures are ready without event loop and hold results of reads
+ */
+TEST_F(AsyncDatastoreTest, Prefetch) {
+  EXPECT_OUTCOME_TRUE_1(store->set(cid1, value1));
+  auto stored{async.prefetch(cid1)};
+  auto missing{async.prefetch(cid2)};
+  EXPECT_OUTCOME_EQ(stored.get(), value1);
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, missing.get());
+}
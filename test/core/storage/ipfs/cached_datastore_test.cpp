@@ -0,0 +1,120 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/cached_datastore.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::ipfs::CachedDatastore;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::IpfsDatastoreError;
+
+/// Store failing all writes
+struct FailingDatastore : InMemoryDatastore {
+  fc::outcome::result<void> set(const CID &key, Value value) override {
+    return IpfsDatastoreError::NOT_FOUND;
+  }
+
+  fc::outcome::result<void> setMany(Blocks blocks) override {
+    return IpfsDatastoreError::NOT_FOUND;
+  }
+};
+
+class CachedDatastoreTest : public ::testing::Test {
+ public:
+  CID cid1{"010001020001"_cid};
+  CID cid2{"010001020002"_cid};
+  Buffer value1{"0123"_unhex};
+  Buffer value2{"4567"_unhex};
+
+  std::shared_ptr<InMemoryDatastore> store{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<CachedDatastore> cache{
+      std::make_shared<CachedDatastore>(store, CachedDatastore::Options{})};
+};
+
+/**
+ * @given value stored in underlying store
+ * @when get value twice through cache
+ * @then first get is a miss and second get is a hit
+ */
+TEST_F(CachedDatastoreTest, HitAfterMiss) {
+  EXPECT_OUTCOME_TRUE_1(store->set(cid1, value1));
+  EXPECT_OUTCOME_EQ(cache->get(cid1), value1);
+  EXPECT_OUTCOME_EQ(cache->get(cid1), value1);
+  auto stats = cache->stats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+  EXPECT_EQ(stats.bytes, value1.size());
+}
+
+/**
+ * @given value set through cache
+ * @when remove it
+ * @then value is neither cached nor stored
+ */
+TEST_F(CachedDatastoreTest, SetRemove) {
+  EXPECT_OUTCOME_TRUE_1(cache->set(cid1, value1));
+  EXPECT_OUTCOME_EQ(store->get(cid1), value1);
+  EXPECT_OUTCOME_TRUE_1(cache->remove(cid1));
+  EXPECT_OUTCOME_EQ(cache->contains(cid1), false);
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, cache->get(cid1));
+  EXPECT_EQ(cache->stats().entries, 0u);
+}
+
+/**
+ * @given underlying store failing writes
+ * @when set values through cache
+ * @then error is returned and values are not cached
+ */
+TEST_F(CachedDatastoreTest, FailedWriteNotCached) {
+  cache = std::make_shared<CachedDatastore>(
+      std::make_shared<FailingDatastore>(), CachedDatastore::Options{});
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, cache->set(cid1, value1));
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND,
+                       cache->setMany({{cid2, value2}}));
+  EXPECT_OUTCOME_EQ(cache->contains(cid1), false);
+  EXPECT_OUTCOME_EQ(cache->contains(cid2), false);
+  EXPECT_EQ(cache->stats().entries, 0u);
+}
+
+/**
+ * @given cache with capacity for one value
+ * @when set two values
+ * @then least recently used value is evicted but still readable from store
+ */
+TEST_F(CachedDatastoreTest, Evict) {
+  cache = std::make_shared<CachedDatastore>(
+      store, CachedDatastore::Options{value1.size(), 1});
+  EXPECT_OUTCOME_TRUE_1(cache->set(cid1, value1));
+  EXPECT_OUTCOME_TRUE_1(cache->set(cid2, value2));
+  EXPECT_EQ(cache->stats().entries, 1u);
+  EXPECT_OUTCOME_EQ(cache->get(cid1), value1);
+  EXPECT_EQ(cache->stats().misses, 1u);
+}
+
+/**
+ * @given cache with two values in one shard
+ * @when shrink by size of one value
+ * @then least recently used value is evicted
+ */
+TEST_F(CachedDatastoreTest, Shrink) {
+  cache = std::make_shared<CachedDatastore>(
+      store, CachedDatastore::Options{value1.size() * 2, 1});
+  EXPECT_OUTCOME_TRUE_1(cache->set(cid1, value1));
+  EXPECT_OUTCOME_TRUE_1(cache->set(cid2, value2));
+  EXPECT_EQ(cache->shrink(1), value1.size());
+  EXPECT_EQ(cache->stats().entries, 1u);
+  EXPECT_EQ(cache->stats().bytes, value2.size());
+  EXPECT_OUTCOME_EQ(cache->get(cid2), value2);
+  EXPECT_EQ(cache->stats().hits, 1u);
+}
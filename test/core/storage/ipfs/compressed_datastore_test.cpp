@@ -0,0 +1,108 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/compressed_datastore.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::ipfs::CompressedDatastore;
+using fc::storage::ipfs::InMemoryDatastore;
+
+class CompressedDatastoreTest : public ::testing::Test {
+ public:
+  /// Cbor-like block with repeated structure
+  static Buffer block(uint8_t seed) {
+    Buffer value;
+    for (auto i{0}; i < 64; ++i) {
+      value.put("84430102"_unhex).putUint8(seed).putUint8(i);
+    }
+    return value;
+  }
+
+  CID cid1{"010001020001"_cid};
+  CID cid2{"010001020002"_cid};
+  std::shared_ptr<InMemoryDatastore> store{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<CompressedDatastore> compressed{
+      std::make_shared<CompressedDatastore>(store,
+                                            CompressedDatastore::Options{})};
+};
+
+/**
+ * @given compressible block
+ * @when set and get through compressed datastore
+ * @then underlying store keeps smaller frame, get returns block
+ */
+TEST_F(CompressedDatastoreTest, RoundTrip) {
+  auto value{block(1)};
+  EXPECT_OUTCOME_TRUE_1(compressed->set(cid1, value));
+  EXPECT_OUTCOME_TRUE(stored, store->get(cid1));
+  EXPECT_LT(stored.size(), value.size());
+  EXPECT_OUTCOME_EQ(compressed->get(cid1), value);
+}
+
+/**
+ * @given small block, and raw block stored before compression
+ * @when get through compressed datastore
+ * @then both are returned as is
+ */
+TEST_F(CompressedDatastoreTest, Raw) {
+  Buffer small{"0123"_unhex};
+  EXPECT_OUTCOME_TRUE_1(compressed->set(cid1, small));
+  EXPECT_OUTCOME_EQ(store->get(cid1), small);
+  EXPECT_OUTCOME_EQ(compressed->get(cid1), small);
+
+  auto legacy{block(2)};
+  EXPECT_OUTCOME_TRUE_1(store->set(cid2, legacy));
+  EXPECT_OUTCOME_EQ(compressed->get(cid2), legacy);
+}
+
+/**
+ * @given raw block starting with zstd magic
+ * @when set and get through compressed datastore
+ * @then it is not mistaken for frame
+ */
+TEST_F(CompressedDatastoreTest, MagicPrefix) {
+  Buffer value{"28b52ffd00"_unhex};
+  EXPECT_OUTCOME_TRUE_1(compressed->set(cid1, value));
+  EXPECT_OUTCOME_EQ(compressed->get(cid1), value);
+}
+
+/**
+ * @given dictionary trained on similar blocks
+ * @when blocks are stored with dictionary
+ * @then they are smaller than without it and read back
+ */
+TEST_F(CompressedDatastoreTest, Dictionary) {
+  std::vector<Buffer> samples;
+  for (auto i{0}; i < 200; ++i) {
+    samples.push_back(block(i));
+  }
+  EXPECT_OUTCOME_TRUE(dictionary,
+                      CompressedDatastore::trainDictionary(samples, 4 << 10));
+  CompressedDatastore::Options options;
+  options.dictionary = dictionary;
+  auto with_dictionary{std::make_shared<CompressedDatastore>(
+      std::make_shared<InMemoryDatastore>(), options)};
+
+  auto value{block(201)};
+  EXPECT_OUTCOME_TRUE(plain, compressed->compress(value));
+  EXPECT_OUTCOME_TRUE(trained, with_dictionary->compress(value));
+  EXPECT_LE(trained.size(), plain.size());
+  EXPECT_OUTCOME_EQ(with_dictionary->decompress(trained), value);
+
+  std::vector<CompressedDatastore::Blocks::value_type> blocks{
+      {cid1, block(202)}, {cid2, block(203)}};
+  EXPECT_OUTCOME_TRUE_1(with_dictionary->setMany(blocks));
+  std::vector<CID> keys{cid1, cid2};
+  EXPECT_OUTCOME_TRUE(values, with_dictionary->getMany(keys));
+  EXPECT_EQ(values, (std::vector<Buffer>{block(202), block(203)}));
+}
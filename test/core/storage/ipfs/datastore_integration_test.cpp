@@ -149,3 +149,27 @@ TEST_F(DatastoreIntegrationTest, PersistentStorage) {
                       LeveldbDatastore::create(leveldb_path.string(), options));
   EXPECT_OUTCOME_EQ(open_again->contains(cid1), true);
 }
+
+/**
+ * @given opened datastore, 2 CID instances and a value
+ * @when put both cids with value in one batch @and get them back
+ * @then all operations succeed and values are returned in key order
+ */
+TEST_F(DatastoreIntegrationTest, SetManyGetMany) {
+  EXPECT_OUTCOME_TRUE_1(datastore->setMany({{cid1, value}, {cid2, value}}));
+  std::vector<CID> keys{cid2, cid1};
+  EXPECT_OUTCOME_EQ(datastore->getMany(keys),
+                    (std::vector<Buffer>{value, value}));
+}
+
+/**
+ * @given opened datastore and a value stored by cid1
+ * @when get values of cid1 and cid2
+ * @then NOT_FOUND error returned
+ */
+TEST_F(DatastoreIntegrationTest, GetManyNotExistingFailure) {
+  EXPECT_OUTCOME_TRUE_1(datastore->set(cid1, value));
+  std::vector<CID> keys{cid1, cid2};
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND,
+                       datastore->getMany(keys));
+}
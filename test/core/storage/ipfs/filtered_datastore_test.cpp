@@ -0,0 +1,82 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/filtered_datastore.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/impl/datastore_key.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::InMemoryStorage;
+using fc::storage::ipfs::encodeKey;
+using fc::storage::ipfs::FilteredDatastore;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::IpfsDatastoreError;
+
+class FilteredDatastoreTest : public ::testing::Test {
+ public:
+  CID cid1{"010001020001"_cid};
+  CID cid2{"010001020002"_cid};
+  Buffer value1{"0123"_unhex};
+
+  std::shared_ptr<InMemoryDatastore> store{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<FilteredDatastore> filtered{
+      std::make_shared<FilteredDatastore>(store,
+                                          FilteredDatastore::Options{})};
+  /// Keys of store as leveldb keeps them
+  InMemoryStorage keys;
+};
+
+/**
+ * @given filter without loaded keys
+ * @when lookup block stored before
+ * @then lookup goes to store
+ */
+TEST_F(FilteredDatastoreTest, NotLoaded) {
+  EXPECT_OUTCOME_TRUE_1(store->set(cid1, value1));
+  EXPECT_OUTCOME_EQ(filtered->contains(cid1), true);
+  EXPECT_OUTCOME_EQ(filtered->contains(cid2), false);
+  EXPECT_EQ(filtered->stats().negatives, 0);
+}
+
+/**
+ * @given filter loaded with keys of store
+ * @when lookup stored and missing blocks
+ * @then stored block is found, missing one is answered by filter
+ */
+TEST_F(FilteredDatastoreTest, Loaded) {
+  EXPECT_OUTCOME_TRUE_1(store->set(cid1, value1));
+  EXPECT_OUTCOME_TRUE(key, encodeKey(cid1));
+  EXPECT_OUTCOME_TRUE_1(keys.put(key, value1));
+  filtered->load(*keys.cursor());
+  EXPECT_OUTCOME_EQ(filtered->contains(cid1), true);
+  EXPECT_OUTCOME_EQ(filtered->get(cid1), value1);
+  EXPECT_OUTCOME_EQ(filtered->contains(cid2), false);
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, filtered->get(cid2));
+  EXPECT_EQ(filtered->stats().negatives, 2);
+  EXPECT_EQ(filtered->stats().keys, 1);
+}
+
+/**
+ * @given loaded filter
+ * @when block is set and removed
+ * @then block is found after set and missing after remove
+ */
+TEST_F(FilteredDatastoreTest, SetRemove) {
+  filtered->load(*keys.cursor());
+  EXPECT_OUTCOME_EQ(filtered->contains(cid2), false);
+  EXPECT_OUTCOME_TRUE_1(filtered->set(cid2, value1));
+  EXPECT_OUTCOME_EQ(filtered->contains(cid2), true);
+  EXPECT_OUTCOME_TRUE_1(filtered->remove(cid2));
+  EXPECT_OUTCOME_EQ(filtered->contains(cid2), false);
+  EXPECT_EQ(filtered->stats().false_positives, 1);
+}
@@ -0,0 +1,161 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/gc_datastore.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/ipld/node_cache.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_leveldb_test.hpp"
+
+using fc::CID;
+using fc::storage::ipfs::GcConfig;
+using fc::storage::ipfs::GcDatastore;
+using fc::storage::ipfs::GcRoots;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::IpfsDatastoreError;
+using fc::storage::ipld::NodeCache;
+
+struct GcDatastoreTest : public test::BaseLevelDB_Test {
+  GcDatastoreTest() : test::BaseLevelDB_Test("fc_gc_datastore_test") {}
+
+  auto makeStore(std::shared_ptr<InMemoryDatastore> cold) {
+    GcConfig config;
+    // few blocks per step
+    config.step_bytes = 16;
+    return std::make_shared<GcDatastore>(db_, cold, [this] { return roots; },
+                                         config);
+  }
+
+  /// Runs two cycles, so blocks written before are not protected anymore
+  void collectWritten(GcDatastore &store) {
+    collect(store);
+    collect(store);
+  }
+
+  /// Runs steps until cycle is finished
+  void collect(GcDatastore &store) {
+    while (true) {
+      EXPECT_OUTCOME_TRUE(finished, store.step());
+      if (finished) {
+        break;
+      }
+    }
+  }
+
+  GcRoots roots;
+};
+
+/**
+ * @given dag reachable from root and unreachable block
+ * @when cycles are collected without cold store
+ * @then reachable blocks are kept, unreachable block is deleted
+ */
+TEST_F(GcDatastoreTest, DeleteGarbage) {
+  auto store = makeStore(nullptr);
+  EXPECT_OUTCOME_TRUE(leaf, store->setCbor(std::string{"leaf"}));
+  EXPECT_OUTCOME_TRUE(root, store->setCbor(std::vector<CID>{leaf}));
+  EXPECT_OUTCOME_TRUE(header, store->setCbor(std::vector<CID>{root}));
+  EXPECT_OUTCOME_TRUE(garbage, store->setCbor(std::string{"garbage"}));
+  roots.recursive.push_back(root);
+  roots.direct.push_back(header);
+  collectWritten(*store);
+  EXPECT_OUTCOME_EQ(store->contains(leaf), true);
+  EXPECT_OUTCOME_EQ(store->contains(root), true);
+  EXPECT_OUTCOME_EQ(store->contains(header), true);
+  EXPECT_OUTCOME_EQ(store->contains(garbage), false);
+  auto stats = store->stats();
+  EXPECT_EQ(stats.cycles, 2u);
+  EXPECT_EQ(stats.live, 3u);
+  EXPECT_EQ(stats.deleted, 1u);
+}
+
+/**
+ * @given decoded node of unreachable block in node cache
+ * @when cycle deletes block
+ * @then node is dropped from cache
+ */
+TEST_F(GcDatastoreTest, DeleteInvalidatesNodeCache) {
+  auto store = makeStore(nullptr);
+  NodeCache<std::string> cache{1};
+  EXPECT_OUTCOME_TRUE(garbage, store->setCbor(std::string{"garbage"}));
+  cache.put(garbage, std::make_shared<const std::string>("garbage"));
+  EXPECT_TRUE(cache.get(garbage));
+  collectWritten(*store);
+  EXPECT_OUTCOME_EQ(store->contains(garbage), false);
+  EXPECT_FALSE(cache.get(garbage));
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+/**
+ * @given unreachable block in hot store
+ * @when cycle is collected with cold store
+ * @then block is moved to cold store and is still readable
+ */
+TEST_F(GcDatastoreTest, MoveGarbage) {
+  auto cold = std::make_shared<InMemoryDatastore>();
+  auto store = makeStore(cold);
+  EXPECT_OUTCOME_TRUE(garbage, store->setCbor(std::string{"garbage"}));
+  collectWritten(*store);
+  EXPECT_OUTCOME_EQ(cold->contains(garbage), true);
+  EXPECT_OUTCOME_EQ(store->getCbor<std::string>(garbage), "garbage");
+  EXPECT_EQ(store->stats().moved, 1u);
+}
+
+/**
+ * @given cycle in progress
+ * @when block is written before sweep
+ * @then written block survives cycle
+ */
+TEST_F(GcDatastoreTest, WriteDuringCycle) {
+  auto store = makeStore(nullptr);
+  EXPECT_OUTCOME_TRUE(leaf, store->setCbor(std::string{"leaf"}));
+  roots.recursive.push_back(leaf);
+  EXPECT_OUTCOME_EQ(store->step(), false);
+  EXPECT_OUTCOME_TRUE(fresh, store->setCbor(std::string{"fresh"}));
+  collect(*store);
+  EXPECT_OUTCOME_EQ(store->contains(fresh), true);
+  EXPECT_EQ(store->stats().deleted, 0u);
+}
+
+/**
+ * @given unreachable block written before cycle
+ * @when cycles are collected
+ * @then block survives first cycle and is deleted by second
+ */
+TEST_F(GcDatastoreTest, WrittenBlockSurvivesNextCycle) {
+  auto store = makeStore(nullptr);
+  EXPECT_OUTCOME_TRUE(fresh, store->setCbor(std::string{"fresh"}));
+  collect(*store);
+  EXPECT_EQ(store->stats().deleted, 0u);
+  collect(*store);
+  EXPECT_EQ(store->stats().deleted, 1u);
+  EXPECT_OUTCOME_EQ(store->contains(fresh), false);
+}
+
+/**
+ * @given garbage and root linking missing block
+ * @when cycle is collected
+ * @then mark fails and cycle is aborted without sweep
+ */
+TEST_F(GcDatastoreTest, MissingLinkFailsMark) {
+  auto store = makeStore(nullptr);
+  EXPECT_OUTCOME_TRUE(garbage, store->setCbor(std::string{"garbage"}));
+  collect(*store);
+  EXPECT_OUTCOME_TRUE(missing, store->setCbor(std::string{"missing"}));
+  EXPECT_OUTCOME_TRUE(root, store->setCbor(std::vector<CID>{missing}));
+  EXPECT_OUTCOME_TRUE_1(store->remove(missing));
+  roots.recursive.push_back(root);
+  auto finished{store->step()};
+  while (finished && !finished.value()) {
+    finished = store->step();
+  }
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, finished);
+  EXPECT_EQ(store->stats().cycles, 1u);
+  EXPECT_EQ(store->stats().deleted, 0u);
+  EXPECT_OUTCOME_EQ(store->contains(garbage), true);
+}
@@ -0,0 +1,191 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/impl/block_pipeline.hpp"
+
+#include <unordered_set>
+
+#include <gtest/gtest.h>
+#include <boost/asio/executor_work_guard.hpp>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+  using common::Buffer;
+
+  /// Counts blocks written
+  struct CountingDatastore : InMemoryDatastore {
+    outcome::result<void> set(const CID &key, Value value) override {
+      ++writes;
+      return InMemoryDatastore::set(key, std::move(value));
+    }
+
+    size_t writes{};
+  };
+
+  /// Fails every write
+  struct FailingDatastore : InMemoryDatastore {
+    outcome::result<void> setMany(Blocks blocks) override {
+      return IpfsDatastoreError::NOT_FOUND;
+    }
+  };
+
+  /// CID prefix of block, as received from network
+  CID prefixOf(const CID &cid) {
+    auto prefix{cid};
+    prefix.content_address =
+        libp2p::multi::Multihash::create(
+            cid.content_address.getType(),
+            Buffer(cid.content_address.getHash().size(), 0))
+            .value();
+    return prefix;
+  }
+
+  /**
+   * @given blocks with CID prefixes, pipeline with small batches and byte
+   * limit below total size of blocks
+   * @when blocks are pushed
+   * @then each callback is called on event loop with CID computed from
+   * data, and block is in datastore already
+   */
+  TEST(BlockPipelineTest, HashesAndStores) {
+    auto io{std::make_shared<boost::asio::io_context>()};
+    auto ipld{std::make_shared<InMemoryDatastore>()};
+    constexpr size_t kBlocks = 20;
+    BlockPipeline pipeline{io, ipld, {2, 3, 256}};
+
+    // hash threads may reorder blocks
+    std::unordered_set<CID> expected;
+    std::unordered_set<CID> received;
+    for (size_t i = 0; i < kBlocks; ++i) {
+      Buffer data(100, static_cast<uint8_t>(i));
+      auto cid{common::getCidOf(data).value()};
+      expected.insert(cid);
+      pipeline.push(prefixOf(cid),
+                    data,
+                    [&, data](outcome::result<void> stored,
+                              CID cid,
+                              Buffer bytes) {
+        EXPECT_TRUE(stored);
+        EXPECT_EQ(bytes, data);
+        EXPECT_OUTCOME_EQ(ipld->contains(cid), true);
+        received.insert(std::move(cid));
+        if (received.size() == kBlocks) {
+          io->stop();
+        }
+      });
+    }
+
+    auto work{boost::asio::make_work_guard(*io)};
+    io->run();
+
+    EXPECT_EQ(received, expected);
+  }
+
+  /**
+   * @given block stored already and block received twice, as by
+   * overlapping requests
+   * @when blocks are pushed
+   * @then every copy is reported, only new block is written once
+   */
+  TEST(BlockPipelineTest, SkipsPresentBlocks) {
+    auto io{std::make_shared<boost::asio::io_context>()};
+    auto ipld{std::make_shared<CountingDatastore>()};
+    BlockPipeline pipeline{io, ipld, {1, 8, 1024}};
+
+    Buffer stored(100, 1);
+    Buffer received(100, 2);
+    auto stored_cid{common::getCidOf(stored).value()};
+    auto received_cid{common::getCidOf(received).value()};
+    EXPECT_OUTCOME_TRUE_1(ipld->set(stored_cid, stored));
+    ipld->writes = 0;
+
+    size_t reported = 0;
+    auto callback{[&](outcome::result<void>, CID, Buffer) {
+      if (++reported == 3) {
+        io->stop();
+      }
+    }};
+    pipeline.push(prefixOf(stored_cid), stored, callback);
+    pipeline.push(prefixOf(received_cid), received, callback);
+    pipeline.push(prefixOf(received_cid), received, callback);
+
+    auto work{boost::asio::make_work_guard(*io)};
+    io->run();
+
+    EXPECT_EQ(reported, 3);
+    EXPECT_EQ(ipld->writes, 1);
+    EXPECT_OUTCOME_EQ(ipld->contains(received_cid), true);
+  }
+
+  /**
+   * @given pipeline with byte limit below size of pushed blocks
+   * @when blocks are pushed on event loop
+   * @then push returns without waiting for them to be stored, and drained
+   * callback is called after pipeline is below limit
+   */
+  TEST(BlockPipelineTest, PushDoesNotBlock) {
+    auto io{std::make_shared<boost::asio::io_context>()};
+    auto ipld{std::make_shared<InMemoryDatastore>()};
+    BlockPipeline pipeline{io, ipld, {1, 1, 100}};
+
+    EXPECT_FALSE(pipeline.whenDrained([] {}));
+    for (uint8_t i = 0; i < 5; ++i) {
+      pipeline.push(prefixOf(common::getCidOf(Buffer(100, i)).value()),
+                    Buffer(100, i),
+                    [](outcome::result<void>, CID, Buffer) {});
+    }
+    bool drained = false;
+    if (!pipeline.whenDrained([&] {
+          drained = true;
+          io->stop();
+        })) {
+      // writer was faster than pushes
+      drained = true;
+      io->stop();
+    }
+
+    auto work{boost::asio::make_work_guard(*io)};
+    io->run();
+
+    EXPECT_TRUE(drained);
+    EXPECT_FALSE(pipeline.whenDrained([] {}));
+  }
+
+  /**
+   * @given datastore failing writes
+   * @when blocks are pushed followed by barrier
+   * @then each callback and barrier get the error
+   */
+  TEST(BlockPipelineTest, ReportsStoreError) {
+    auto io{std::make_shared<boost::asio::io_context>()};
+    auto ipld{std::make_shared<FailingDatastore>()};
+    BlockPipeline pipeline{io, ipld, {1, 8, 1024}};
+
+    size_t failed = 0;
+    auto callback{[&](outcome::result<void> stored, CID, Buffer) {
+      EXPECT_FALSE(stored);
+      ++failed;
+    }};
+    Buffer data(100, 1);
+    auto prefix{prefixOf(common::getCidOf(data).value())};
+    pipeline.push(prefix, data, callback);
+    pipeline.push(prefix, data, callback);
+    bool barrier = false;
+    pipeline.after([&](outcome::result<void> stored) {
+      EXPECT_FALSE(stored);
+      EXPECT_EQ(failed, 2);
+      barrier = true;
+      io->stop();
+    });
+
+    auto work{boost::asio::make_work_guard(*io)};
+    io->run();
+
+    EXPECT_TRUE(barrier);
+    EXPECT_OUTCOME_EQ(ipld->contains(common::getCidOf(data).value()), false);
+  }
+}  // namespace fc::storage::ipfs::graphsync
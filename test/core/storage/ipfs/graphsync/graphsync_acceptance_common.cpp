@@ -11,6 +11,7 @@
 #include <libp2p/protocol/common/asio/asio_scheduler.hpp>
 
 #include "storage/ipfs/graphsync/impl/graphsync_impl.hpp"
+#include "storage/ipfs/ipfs_datastore_error.hpp"
 #include "storage/ipld/impl/ipld_node_impl.hpp"
 
 namespace fc::storage::ipfs::graphsync::test {
@@ -80,4 +81,13 @@ namespace fc::storage::ipfs::graphsync::test {
     return 0;
   }
 
+  outcome::result<common::Buffer> TestDataService::getBlock(
+      const CID &cid) const {
+    auto it = data_.find(cid);
+    if (it == data_.end()) {
+      return IpfsDatastoreError::NOT_FOUND;
+    }
+    return it->second;
+  }
+
 }  // namespace fc::storage::ipfs::graphsync::test
@@ -63,6 +63,8 @@ namespace fc::storage::ipfs::graphsync::test {
         std::function<bool(const CID &cid, const common::Buffer &data)> handler)
     const override;
 
+    outcome::result<common::Buffer> getBlock(const CID &cid) const override;
+
     Storage data_;
     Storage expected_;
     Storage received_;
@@ -0,0 +1,181 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/multi_peer_fetch.hpp"
+
+#include <gtest/gtest.h>
+#include <libp2p/protocol/common/asio/asio_scheduler.hpp>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/mocks/storage/ipfs/graphsync/graphsync_mock.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/peer_id.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+  using ::testing::_;
+
+  /// Request made through graphsync mock
+  struct Request {
+    PeerId peer;
+    CID cid;
+    Graphsync::RequestProgressCallback callback;
+  };
+
+  struct MultiPeerFetchTest : ::testing::Test {
+    void SetUp() override {
+      EXPECT_CALL(*graphsync, makeRequest(_, _, _, _, _, _))
+          .WillRepeatedly(::testing::Invoke(
+              [&](auto &peer, auto, auto &cid, auto, auto &, auto callback) {
+                requests.push_back({peer, cid, callback});
+                return Subscription{};
+              }));
+    }
+
+    /// Adds block to blocks available from peers
+    CID block(const Buffer &bytes) {
+      auto cid{common::getCidOf(bytes).value()};
+      blocks.emplace(cid, bytes);
+      return cid;
+    }
+
+    /// Finds last request of cid
+    Request &request(const CID &cid) {
+      for (auto it{requests.rbegin()}; it != requests.rend(); ++it) {
+        if (it->cid == cid) {
+          return *it;
+        }
+      }
+      throw std::logic_error{"no request"};
+    }
+
+    /// Calls callback of last request of cid, callback may make requests
+    void respond(const CID &cid, ResponseStatusCode status) {
+      auto callback{request(cid).callback};
+      callback(status, {});
+    }
+
+    std::shared_ptr<GraphsyncMock> graphsync{
+        std::make_shared<GraphsyncMock>()};
+    boost::asio::io_context io;
+    std::shared_ptr<libp2p::protocol::Scheduler> scheduler{
+        std::make_shared<libp2p::protocol::AsioScheduler>(
+            io, libp2p::protocol::SchedulerConfig{})};
+    std::shared_ptr<InMemoryDatastore> ipld{
+        std::make_shared<InMemoryDatastore>()};
+    std::map<CID, Buffer> blocks;
+    std::vector<Request> requests;
+  };
+
+  /**
+   * @given dag of root with two children and two peers
+   * @when peers send subtrees and one of them rejects request
+   * @then rejected subtree is fetched from other peer, all blocks are stored
+   */
+  TEST_F(MultiPeerFetchTest, ReassignFailed) {
+    auto child1{block(Buffer{codec::cbor::encode(std::string{"a"}).value()})};
+    auto child2{block(Buffer{codec::cbor::encode(std::string{"b"}).value()})};
+    auto root{block(Buffer{
+        codec::cbor::encode(std::vector<CID>{child1, child2}).value()})};
+    auto peer1{generatePeerId(1)}, peer2{generatePeerId(2)};
+    boost::optional<outcome::result<void>> result;
+    auto fetch{std::make_shared<MultiPeerFetch>(
+        graphsync,
+        scheduler,
+        ipld,
+        root,
+        std::vector<MultiPeerFetch::Peer>{{peer1, {}}, {peer2, {}}},
+        [&](auto res) { result = res; })};
+    fetch->start();
+
+    ASSERT_EQ(requests.size(), 1);
+    EXPECT_TRUE(fetch->onBlock(root, blocks.at(root)));
+    EXPECT_FALSE(fetch->onBlock(root, blocks.at(root)));
+    respond(root, RS_FULL_CONTENT);
+
+    // subtrees are requested from both peers
+    ASSERT_EQ(requests.size(), 3);
+    EXPECT_FALSE(request(child1).peer == request(child2).peer);
+    auto &rejected{request(child1).peer == peer2 ? child1 : child2};
+    auto &sent{rejected == child1 ? child2 : child1};
+    respond(rejected, RS_REJECTED);
+    EXPECT_EQ(requests.size(), 3);
+    EXPECT_TRUE(fetch->onBlock(sent, blocks.at(sent)));
+    respond(sent, RS_FULL_CONTENT);
+
+    ASSERT_EQ(requests.size(), 4);
+    EXPECT_EQ(request(rejected).peer, peer1);
+    EXPECT_TRUE(fetch->onBlock(rejected, blocks.at(rejected)));
+    EXPECT_FALSE(result);
+    respond(rejected, RS_FULL_CONTENT);
+
+    ASSERT_TRUE(result);
+    EXPECT_OUTCOME_TRUE_1(*result);
+    for (auto &[cid, bytes] : blocks) {
+      EXPECT_OUTCOME_EQ(ipld->get(cid), bytes);
+    }
+  }
+
+  /**
+   * @given dag of root with two children and two peers
+   * @when one peer sends its subtree and other peer sends nothing
+   * @then subtree of slow peer is moved to fast peer
+   */
+  TEST_F(MultiPeerFetchTest, MigrateStraggler) {
+    auto child1{block(Buffer{codec::cbor::encode(std::string{"a"}).value()})};
+    auto child2{block(Buffer{codec::cbor::encode(std::string{"b"}).value()})};
+    auto root{block(Buffer{
+        codec::cbor::encode(std::vector<CID>{child1, child2}).value()})};
+    auto peer1{generatePeerId(1)}, peer2{generatePeerId(2)};
+    boost::optional<outcome::result<void>> result;
+    auto fetch{std::make_shared<MultiPeerFetch>(
+        graphsync,
+        scheduler,
+        ipld,
+        root,
+        std::vector<MultiPeerFetch::Peer>{{peer1, {}}, {peer2, {}}},
+        [&](auto res) { result = res; },
+        0)};
+    fetch->start();
+    EXPECT_TRUE(fetch->onBlock(root, blocks.at(root)));
+    respond(root, RS_FULL_CONTENT);
+
+    ASSERT_EQ(requests.size(), 3);
+    auto &fast{request(child1).peer == peer1 ? child1 : child2};
+    auto &slow{fast == child1 ? child2 : child1};
+    EXPECT_TRUE(fetch->onBlock(fast, blocks.at(fast)));
+    respond(fast, RS_FULL_CONTENT);
+
+    // peer which sent root and subtree is idle, other sent nothing
+    ASSERT_EQ(requests.size(), 4);
+    EXPECT_EQ(request(slow).peer, peer1);
+    EXPECT_TRUE(fetch->onBlock(slow, blocks.at(slow)));
+    respond(slow, RS_FULL_CONTENT);
+    ASSERT_TRUE(result);
+    EXPECT_OUTCOME_TRUE_1(*result);
+  }
+
+  /**
+   * @given dag with block which peer doesn't have
+   * @when each peer fails to send it
+   * @then fetch fails
+   */
+  TEST_F(MultiPeerFetchTest, AllPeersFailed) {
+    auto root{block(Buffer{codec::cbor::encode(std::string{"a"}).value()})};
+    boost::optional<outcome::result<void>> result;
+    auto fetch{std::make_shared<MultiPeerFetch>(
+        graphsync,
+        scheduler,
+        ipld,
+        root,
+        std::vector<MultiPeerFetch::Peer>{{generatePeerId(1), {}}},
+        [&](auto res) { result = res; })};
+    fetch->start();
+
+    ASSERT_EQ(requests.size(), 1);
+    respond(root, RS_NOT_FOUND);
+    ASSERT_TRUE(result);
+    EXPECT_OUTCOME_ERROR(MultiPeerFetchError::ALL_PEERS_FAILED, *result);
+  }
+}  // namespace fc::storage::ipfs::graphsync
@@ -0,0 +1,64 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/graphsync/impl/network/network_shards.hpp"
+
+#include <numeric>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <boost/asio/executor_work_guard.hpp>
+
+#include "testutil/peer_id.hpp"
+
+namespace fc::storage::ipfs::graphsync {
+
+  /**
+   * @given shards and several peers
+   * @when messages of peers are offloaded
+   * @then peer is always on the same shard, work runs on worker thread,
+   * results of each peer come back on event loop in order of offloading
+   */
+  TEST(NetworkShardsTest, KeepsPeerOrder) {
+    auto io{std::make_shared<boost::asio::io_context>()};
+    NetworkShards shards{io, 4};
+    constexpr int kPeers = 8;
+    constexpr int kMessages = 100;
+    auto io_thread{std::this_thread::get_id()};
+
+    std::vector<std::vector<int>> received(kPeers);
+    int total{0};
+    for (int peer = 0; peer < kPeers; ++peer) {
+      auto peer_id{generatePeerId(peer)};
+      auto shard{shards.shardOf(peer_id)};
+      EXPECT_EQ(shard, shards.shardOf(generatePeerId(peer)));
+      for (int i = 0; i < kMessages; ++i) {
+        shards.offload(
+            shard,
+            [&, i] {
+              EXPECT_NE(std::this_thread::get_id(), io_thread);
+              return i;
+            },
+            [&, peer](int value) {
+              EXPECT_EQ(std::this_thread::get_id(), io_thread);
+              received[peer].push_back(value);
+              if (++total == kPeers * kMessages) {
+                io->stop();
+              }
+            });
+      }
+    }
+
+    auto work{boost::asio::make_work_guard(*io)};
+    io->run();
+
+    std::vector<int> expected(kMessages);
+    std::iota(expected.begin(), expected.end(), 0);
+    for (auto &messages : received) {
+      EXPECT_EQ(messages, expected);
+    }
+  }
+
+}  // namespace fc::storage::ipfs::graphsync
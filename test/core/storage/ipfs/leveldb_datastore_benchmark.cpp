@@ -0,0 +1,90 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "storage/ipfs/impl/datastore_leveldb.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::ipfs::LeveldbDatastore;
+
+namespace {
+  /// Datastore in temporary directory removed with it
+  struct TempDatastore {
+    TempDatastore()
+        : path{boost::filesystem::unique_path(
+            boost::filesystem::temp_directory_path()
+            / "leveldb-benchmark-%%%%-%%%%")} {
+      store = LeveldbDatastore::create(
+                  path.string(), fc::storage::config::LeveldbProfile{})
+                  .value();
+    }
+
+    ~TempDatastore() {
+      store.reset();
+      boost::filesystem::remove_all(path);
+    }
+
+    boost::filesystem::path path;
+    std::shared_ptr<LeveldbDatastore> store;
+  };
+
+  /// Blocks of ipld node size with distinct cids
+  std::vector<std::pair<CID, Buffer>> blocks(size_t n) {
+    std::vector<std::pair<CID, Buffer>> result;
+    result.reserve(n);
+    for (size_t i{0}; i < n; ++i) {
+      Buffer value(256, 0);
+      value.putUint64(i);
+      auto cid{fc::common::getCidOf(value).value()};
+      result.emplace_back(std::move(cid), std::move(value));
+    }
+    return result;
+  }
+}  // namespace
+
+void LeveldbDatastoreSet(benchmark::State &state) {
+  auto items{blocks(state.range(0))};
+  for (auto _ : state) {
+    state.PauseTiming();
+    TempDatastore temp;
+    state.ResumeTiming();
+    for (auto &[cid, value] : items) {
+      temp.store->set(cid, value).value();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(LeveldbDatastoreSet)->RangeMultiplier(10)->Range(1e3, 1e5);
+
+void LeveldbDatastoreSetMany(benchmark::State &state) {
+  auto items{blocks(state.range(0))};
+  for (auto _ : state) {
+    state.PauseTiming();
+    TempDatastore temp;
+    auto copy{items};
+    state.ResumeTiming();
+    temp.store->setMany(std::move(copy)).value();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(LeveldbDatastoreSetMany)->RangeMultiplier(10)->Range(1e3, 1e5);
+
+void LeveldbDatastoreGet(benchmark::State &state) {
+  auto items{blocks(state.range(0))};
+  TempDatastore temp;
+  temp.store->setMany(items).value();
+  for (auto _ : state) {
+    for (auto &item : items) {
+      benchmark::DoNotOptimize(temp.store->get(item.first).value());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(LeveldbDatastoreGet)->RangeMultiplier(10)->Range(1e3, 1e5);
+
+BENCHMARK_MAIN();
@@ -6,6 +6,7 @@
 #include "storage/ipfs/merkledag/impl/merkledag_service_impl.hpp"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <testutil/outcome.hpp>
 #include "core/storage/ipfs/merkledag/ipfs_merkledag_dataset.hpp"
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
@@ -194,6 +195,52 @@ TEST_P(CommonFeaturesTest, FetchGraphSuccess) {
   ASSERT_EQ(fetched_structure, data.graph_structure);
 }
 
+/**
+ * @given Pre-generated nodes structure and reference serialized structure
+ * @when Walking graph lazily, with and without depth limit
+ * @then Every node of structure is visited once, root is visited first,
+ *       depth limit and skipped children stop descending
+ */
+TEST_P(CommonFeaturesTest, WalkGraphSuccess) {
+  const auto &root = data.nodes.front();
+  auto walker = merkledag_service_->walkGraph(root->getCID());
+  size_t visited{};
+  while (true) {
+    EXPECT_OUTCOME_TRUE(more, walker.next())
+    if (!more) {
+      break;
+    }
+    if (visited == 0) {
+      EXPECT_EQ(walker.depth(), 0);
+      EXPECT_EQ(cidToString(walker.node()), cidToString(root));
+    }
+    ++visited;
+  }
+  size_t nodes = std::count(
+      data.graph_structure.begin(), data.graph_structure.end(), '{');
+  EXPECT_EQ(visited, nodes);
+
+  auto children = [&](GraphWalker walker, bool skip_root) {
+    size_t visited{};
+    EXPECT_OUTCOME_TRUE_1(walker.next())
+    if (skip_root) {
+      walker.skipChildren();
+    }
+    while (true) {
+      EXPECT_OUTCOME_TRUE(more, walker.next())
+      if (!more) {
+        break;
+      }
+      EXPECT_EQ(walker.depth(), 1);
+      ++visited;
+    }
+    return visited;
+  };
+  EXPECT_EQ(children(merkledag_service_->walkGraph(root->getCID(), 1), false),
+            root->getLinks().size());
+  EXPECT_EQ(children(merkledag_service_->walkGraph(root->getCID()), true), 0);
+}
+
 /**
  * @given Pre-generated nodes structure
  * @when Selecting nodes from DAG service
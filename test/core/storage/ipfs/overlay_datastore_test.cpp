@@ -0,0 +1,58 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::IpfsDatastoreError;
+using fc::storage::ipfs::OverlayDatastore;
+
+class OverlayDatastoreTest : public ::testing::Test {
+ public:
+  std::shared_ptr<InMemoryDatastore> base{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<OverlayDatastore> overlay{
+      std::make_shared<OverlayDatastore>(base)};
+};
+
+/**
+ * @given blocks written to overlay
+ * @when read them
+ * @then overlay sees own writes and base is unchanged
+ */
+TEST_F(OverlayDatastoreTest, ReadYourWrites) {
+  EXPECT_OUTCOME_TRUE(stored, base->setCbor(1));
+  EXPECT_OUTCOME_TRUE(buffered, overlay->setCbor(2));
+  EXPECT_OUTCOME_EQ(overlay->getCbor<int>(stored), 1);
+  EXPECT_OUTCOME_EQ(overlay->getCbor<int>(buffered), 2);
+  EXPECT_OUTCOME_EQ(base->contains(buffered), false);
+  EXPECT_EQ(overlay->size(), 1u);
+}
+
+/**
+ * @given root linking buffered and stored blocks, and unreachable block
+ * @when commit root
+ * @then only reachable buffered blocks are stored and overlay is empty
+ */
+TEST_F(OverlayDatastoreTest, CommitReachable) {
+  EXPECT_OUTCOME_TRUE(stored, base->setCbor(1));
+  EXPECT_OUTCOME_TRUE(leaf, overlay->setCbor(2));
+  EXPECT_OUTCOME_TRUE(garbage, overlay->setCbor(3));
+  EXPECT_OUTCOME_TRUE(root, overlay->setCbor(std::vector<CID>{leaf, stored}));
+
+  EXPECT_OUTCOME_EQ(overlay->commit({root}), 2);
+  EXPECT_OUTCOME_EQ(base->contains(root), true);
+  EXPECT_OUTCOME_EQ(base->contains(leaf), true);
+  EXPECT_OUTCOME_EQ(base->contains(garbage), false);
+  EXPECT_EQ(overlay->size(), 0u);
+  EXPECT_EQ(overlay->bytes(), 0u);
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, overlay->get(garbage));
+}
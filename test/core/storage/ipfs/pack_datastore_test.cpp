@@ -0,0 +1,111 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/impl/pack_datastore.hpp"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/ipfs/impl/tiered_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+using fc::CID;
+using fc::common::Buffer;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::IpfsDatastore;
+using fc::storage::ipfs::IpfsDatastoreError;
+using fc::storage::ipfs::PackDatastore;
+using fc::storage::ipfs::PackDatastoreError;
+using fc::storage::ipfs::TieredDatastore;
+
+struct PackDatastoreTest : public test::BaseFS_Test {
+  PackDatastoreTest() : test::BaseFS_Test("fc_pack_datastore_test") {}
+
+  auto open() {
+    return PackDatastore::open(base_path.string()).value();
+  }
+
+  CID cid1{"010001020001"_cid};
+  CID cid2{"010001020002"_cid};
+  CID cid3{"010001020003"_cid};
+  Buffer value1{"0123"_unhex};
+  Buffer value2{"4567"_unhex};
+  Buffer value3{"89ab"_unhex};
+};
+
+/**
+ * @given pack datastore
+ * @when blocks are appended and flushed
+ * @then blocks are found before and after flush, views point to pack bytes
+ */
+TEST_F(PackDatastoreTest, SetGet) {
+  auto pack = open();
+  EXPECT_OUTCOME_TRUE_1(pack->set(cid2, value2));
+  EXPECT_OUTCOME_EQ(pack->get(cid2), value2);
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, pack->view(cid2));
+  EXPECT_OUTCOME_TRUE_1(pack->flush());
+  EXPECT_OUTCOME_TRUE(view, pack->view(cid2));
+  EXPECT_EQ(Buffer{view}, value2);
+
+  IpfsDatastore::Blocks blocks;
+  blocks.emplace_back(cid1, value1);
+  blocks.emplace_back(cid3, value3);
+  EXPECT_OUTCOME_TRUE_1(pack->setMany(blocks));
+  EXPECT_EQ(pack->size(), 3u);
+  EXPECT_OUTCOME_EQ(pack->get(cid1), value1);
+  EXPECT_OUTCOME_EQ(pack->get(cid3), value3);
+  EXPECT_OUTCOME_EQ(pack->contains(cid2), true);
+  EXPECT_OUTCOME_ERROR(PackDatastoreError::REMOVE_NOT_SUPPORTED,
+                       pack->remove(cid1));
+}
+
+/**
+ * @given pack with flushed blocks and truncated tail
+ * @when pack is reopened
+ * @then flushed blocks are found, unindexed tail is discarded
+ */
+TEST_F(PackDatastoreTest, Reopen) {
+  {
+    auto pack = open();
+    EXPECT_OUTCOME_TRUE_1(pack->set(cid1, value1));
+    EXPECT_OUTCOME_TRUE_1(pack->flush());
+    EXPECT_OUTCOME_TRUE_1(pack->set(cid2, value2));
+  }
+  {
+    std::ofstream file{(base_path / "blocks.pack").string(),
+                       std::ios::binary | std::ios::app};
+    file << "garbage";
+  }
+  auto pack = open();
+  EXPECT_EQ(pack->size(), 2u);
+  EXPECT_OUTCOME_EQ(pack->get(cid1), value1);
+  EXPECT_OUTCOME_EQ(pack->get(cid2), value2);
+  EXPECT_OUTCOME_TRUE_1(pack->set(cid3, value3));
+  EXPECT_OUTCOME_TRUE_1(pack->flush());
+  EXPECT_OUTCOME_EQ(pack->get(cid3), value3);
+}
+
+/**
+ * @given tiered store over in memory hot store and pack cold store
+ * @when blocks are set and read
+ * @then new blocks go to hot store, reads fall back to cold store
+ */
+TEST_F(PackDatastoreTest, Tiered) {
+  auto hot = std::make_shared<InMemoryDatastore>();
+  auto cold = open();
+  TieredDatastore store{hot, cold};
+  EXPECT_OUTCOME_TRUE_1(cold->set(cid1, value1));
+  EXPECT_OUTCOME_TRUE_1(store.set(cid1, value1));
+  EXPECT_OUTCOME_TRUE_1(store.set(cid2, value2));
+  EXPECT_OUTCOME_EQ(hot->contains(cid1), false);
+  EXPECT_OUTCOME_EQ(hot->contains(cid2), true);
+  EXPECT_OUTCOME_EQ(store.get(cid1), value1);
+  EXPECT_OUTCOME_EQ(store.get(cid2), value2);
+  EXPECT_OUTCOME_ERROR(IpfsDatastoreError::NOT_FOUND, store.get(cid3));
+}
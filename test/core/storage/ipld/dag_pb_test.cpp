@@ -0,0 +1,91 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/dag_pb.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::common::Buffer;
+using namespace fc::storage::ipld::dag_pb;
+
+struct DagPbTest : testing::Test {
+  void SetUp() override {
+    PbWriter writer{node};
+    writeLink(writer, cid1, "a", 3);
+    writeLink(writer, cid2, {}, 0x1234);
+    writeData(writer, data);
+  }
+
+  Buffer cid1{"1220000000000000000000000000000000"
+              "0000000000000000000000000000000001"_unhex};
+  Buffer cid2{"015512200000000000000000000000000000"
+              "0000000000000000000000000000000002"_unhex};
+  Buffer data{"dead"_unhex};
+  Buffer node;
+};
+
+/**
+ * @given node with links and data
+ * @when decode it
+ * @then links and data are same as encoded, in encoded order,
+ *       and point into node bytes
+ */
+TEST_F(DagPbTest, RoundTrip) {
+  EXPECT_OUTCOME_TRUE(decoded, decode(node));
+  EXPECT_EQ(Buffer{decoded.data}, data);
+  EXPECT_EQ(decoded.data.data(), node.data() + node.size() - data.size());
+  ASSERT_EQ(decoded.links.size(), 2);
+  EXPECT_EQ(Buffer{decoded.links[0].cid}, cid1);
+  EXPECT_EQ(decoded.links[0].name, "a");
+  EXPECT_EQ(decoded.links[0].size, 3);
+  EXPECT_EQ(Buffer{decoded.links[1].cid}, cid2);
+  EXPECT_EQ(decoded.links[1].name, "");
+  EXPECT_EQ(decoded.links[1].size, 0x1234);
+}
+
+/**
+ * @given link with empty name
+ * @when encode it
+ * @then bytes are same as go-merkledag writes, with empty name field
+ */
+TEST_F(DagPbTest, SameBytes) {
+  Buffer encoded;
+  PbWriter writer{encoded};
+  writeLink(writer, cid1, {}, 1);
+  EXPECT_EQ(encoded,
+            Buffer{"12280a22"
+                   "1220000000000000000000000000000000000000000000000000000000"
+                   "0000000001"
+                   "12001801"_unhex});
+}
+
+/**
+ * @given truncated node
+ * @when decode it
+ * @then error
+ */
+TEST_F(DagPbTest, Truncated) {
+  auto truncated{gsl::make_span(node).first(node.size() - 1)};
+  EXPECT_OUTCOME_ERROR(DagPbError::INVALID_PB, decode(truncated));
+}
+
+/**
+ * @given message with fixed size field
+ * @when read fields
+ * @then fixed size field is skipped
+ */
+TEST_F(DagPbTest, SkipFixed) {
+  auto bytes{"0901020304050607081005"_unhex};
+  PbReader reader{bytes};
+  EXPECT_OUTCOME_TRUE(field, reader.next());
+  ASSERT_TRUE(field);
+  EXPECT_EQ(field->id, 2);
+  EXPECT_EQ(field->value, 5);
+  EXPECT_OUTCOME_TRUE(end, reader.next());
+  EXPECT_FALSE(end);
+}
@@ -0,0 +1,34 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/encode_level.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/outcome.hpp"
+
+using fc::storage::ipld::encodeLevel;
+using fc::storage::ipld::kFlushChunk;
+
+/**
+ * @given level large enough to be split between threads
+ * @when encode it with one and with many threads
+ * @then encoded bytes and cids are same and in order of nodes
+ */
+TEST(EncodeLevel, ParallelSameAsSequential) {
+  std::vector<uint64_t> values(kFlushChunk * 5 + 3);
+  std::vector<uint64_t *> nodes;
+  for (size_t i{0}; i < values.size(); ++i) {
+    values[i] = i * i;
+    nodes.push_back(&values[i]);
+  }
+  EXPECT_OUTCOME_TRUE(sequential, encodeLevel(nodes, 1));
+  EXPECT_OUTCOME_TRUE(parallel, encodeLevel(nodes, 4));
+  ASSERT_EQ(parallel.cids.size(), nodes.size());
+  EXPECT_EQ(parallel.encoded, sequential.encoded);
+  EXPECT_EQ(parallel.cids, sequential.cids);
+  EXPECT_OUTCOME_TRUE(bytes, fc::codec::cbor::encode(values.back()));
+  EXPECT_OUTCOME_EQ(fc::common::getCidOf(bytes), parallel.cids.back());
+}
@@ -0,0 +1,45 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/lazy_tuple.hpp"
+
+#include <gtest/gtest.h>
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/actor/builtin/storage_power/storage_power_actor_state.hpp"
+
+using fc::codec::cbor::CborDecodeError;
+using fc::primitives::StoragePower;
+using fc::primitives::address::Address;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipld::LazyField;
+using fc::storage::ipld::LazyTuple;
+using fc::vm::actor::builtin::storage_power::Claim;
+using fc::vm::actor::builtin::storage_power::State;
+namespace lazy = fc::vm::actor::builtin::storage_power::lazy;
+
+/**
+ * @given power actor state with claim
+ * @when load it as lazy tuple
+ * @then fields decode same as full state, adt fields are loaded with ipld
+ */
+TEST(LazyTupleTest, PowerState) {
+  auto ipld = std::make_shared<InMemoryDatastore>();
+  auto miner = Address::makeFromId(1000);
+  auto state = State::empty(ipld);
+  state.total_raw_power = 10;
+  state.total_qa_power = 20;
+  EXPECT_OUTCOME_TRUE_1(state.claims.set(miner, {10, 20}));
+  EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(state));
+
+  EXPECT_OUTCOME_TRUE(tuple, LazyTuple::load(ipld, cid));
+  EXPECT_EQ(tuple.size(), 8);
+  EXPECT_OUTCOME_EQ(tuple.get(lazy::kTotalRawPower), 10);
+  EXPECT_OUTCOME_EQ(tuple.get(lazy::kTotalQaPower), 20);
+  EXPECT_OUTCOME_TRUE(claims, tuple.get(lazy::kClaims));
+  EXPECT_OUTCOME_EQ(claims.get(miner), (Claim{10, 20}));
+  EXPECT_OUTCOME_ERROR(CborDecodeError::WRONG_SIZE,
+                       tuple.get(LazyField<StoragePower>{8}));
+}
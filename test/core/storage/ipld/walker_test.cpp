@@ -0,0 +1,99 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipld/walker.hpp"
+
+#include <gtest/gtest.h>
+
+#include "codec/cbor/cbor.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::CID;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipld::Selector;
+using fc::storage::ipld::walker::Walker;
+
+/**
+ * Dag of map root linking list node and leaf, list node links two leaves
+ */
+struct WalkerTest : public ::testing::Test {
+  void SetUp() override {
+    leaf1 = store.setCbor(std::string{"leaf1"}).value();
+    leaf2 = store.setCbor(std::string{"leaf2"}).value();
+    leaf3 = store.setCbor(std::string{"leaf3"}).value();
+    node = store.setCbor(std::vector<CID>{leaf1, leaf2}).value();
+    root = store
+               .setCbor(std::map<std::string, CID>{{"a", node}, {"b", leaf3}})
+               .value();
+  }
+
+  std::vector<CID> select(const Selector &selector,
+                          size_t prefetch_threads = 0) {
+    Walker walker{store, prefetch_threads};
+    EXPECT_OUTCOME_TRUE_1(walker.select(root, selector));
+    return walker.cids;
+  }
+
+  InMemoryDatastore store;
+  CID leaf1, leaf2, leaf3, node, root;
+};
+
+/**
+ * @given dag
+ * @when it is walked with default selector, with and without prefetch
+ * @then all blocks are walked in depth-first order
+ */
+TEST_F(WalkerTest, SelectAll) {
+  std::vector<CID> expected{root, node, leaf1, leaf2, leaf3};
+  EXPECT_EQ(select(Selector{}), expected);
+  EXPECT_EQ(select(Selector{}, 4), expected);
+
+  Walker walker{store};
+  EXPECT_OUTCOME_TRUE_1(walker.recursiveAll(root));
+  EXPECT_EQ(walker.cids, expected);
+}
+
+/**
+ * @given dag
+ * @when it is walked with field and index selectors
+ * @then only selected paths are walked
+ */
+TEST_F(WalkerTest, SelectPath) {
+  EXPECT_EQ(select(Selector::exploreFields({{"b", Selector::matcher()}})),
+            (std::vector<CID>{root, leaf3}));
+  EXPECT_EQ(select(Selector::exploreFields(
+                {{"a", Selector::exploreIndex(1, Selector::matcher())}})),
+            (std::vector<CID>{root, node, leaf2}));
+  EXPECT_EQ(select(Selector::exploreFields(
+                {{"a", Selector::exploreRange(0, 1, Selector::matcher())}})),
+            (std::vector<CID>{root, node, leaf1}));
+}
+
+/**
+ * @given dag
+ * @when it is walked with recursion limited to one edge
+ * @then blocks deeper than one link are not loaded
+ */
+TEST_F(WalkerTest, RecursionDepth) {
+  auto selector = Selector::exploreRecursive(
+      1, Selector::exploreAll(Selector::exploreRecursiveEdge()));
+  EXPECT_EQ(select(selector), (std::vector<CID>{root, node, leaf3}));
+}
+
+/**
+ * @given selector
+ * @when it is encoded and decoded
+ * @then encoding is preserved
+ */
+TEST_F(WalkerTest, SelectorCodec) {
+  auto selector = Selector::exploreUnion(
+      {Selector{},
+       Selector::exploreFields(
+           {{"a", Selector::exploreRange(1, 2, Selector::matcher())}})});
+  auto encoded = fc::codec::cbor::encode(selector).value();
+  EXPECT_OUTCOME_TRUE(decoded, fc::codec::cbor::decode<Selector>(encoded));
+  EXPECT_EQ(fc::codec::cbor::encode(decoded).value(), encoded);
+}
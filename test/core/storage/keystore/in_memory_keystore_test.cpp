@@ -6,6 +6,7 @@
 #include "storage/keystore/impl/in_memory/in_memory_keystore.hpp"
 
 #include <gtest/gtest.h>
+#include <future>
 
 #include "crypto/blake2/blake2b.h"
 #include "crypto/bls/impl/bls_provider_impl.hpp"
@@ -13,6 +14,7 @@
 #include "crypto/secp256k1/secp256k1_error.hpp"
 #include "crypto/secp256k1/secp256k1_provider.hpp"
 #include "primitives/address/address_codec.hpp"
+#include "storage/keystore/signing_service.hpp"
 #include "testutil/outcome.hpp"
 
 namespace fc::storage::keystore {
@@ -293,4 +295,48 @@ namespace fc::storage::keystore {
     ASSERT_TRUE(res);
   }
 
+  /**
+   * @given Keystore with key used for signing
+   * @when key is removed
+   * @then cached key is evicted and sign fails
+   */
+  TEST_F(InMemoryKeyStoreTest, SignAfterRemove) {
+    EXPECT_OUTCOME_TRUE_1(ks->put(bls_address_, bls_keypair_.private_key));
+    EXPECT_OUTCOME_TRUE_1(ks->sign(bls_address_, data_));
+    EXPECT_OUTCOME_TRUE_1(ks->remove(bls_address_));
+    EXPECT_OUTCOME_ERROR(KeyStoreError::NOT_FOUND,
+                         ks->sign(bls_address_, data_));
+  }
+
+  /**
+   * @given signing service of keystore with bls and secp256k1 keys
+   * @when many requests are signed at once and one asynchronously
+   * @then signatures are valid and in order of requests
+   */
+  TEST_F(InMemoryKeyStoreTest, SigningService) {
+    EXPECT_OUTCOME_TRUE_1(ks->put(bls_address_, bls_keypair_.private_key));
+    EXPECT_OUTCOME_TRUE_1(
+        ks->put(secp256k1_address_, secp256k1_keypair_.private_key));
+    SigningService service{ks, 4};
+    std::vector<SigningService::Request> requests;
+    for (uint8_t i{0}; i < 10; ++i) {
+      requests.push_back({i % 2 ? secp256k1_address_ : bls_address_,
+                          common::Buffer{std::vector<uint8_t>(8, i)}});
+    }
+    auto signatures{service.signAll(requests)};
+    ASSERT_EQ(signatures.size(), requests.size());
+    for (size_t i{0}; i < requests.size(); ++i) {
+      EXPECT_OUTCOME_TRUE(signature, signatures[i]);
+      EXPECT_OUTCOME_EQ(
+          ks->verify(requests[i].address, requests[i].data, signature), true);
+    }
+
+    std::promise<outcome::result<Signature>> signed_data;
+    service.sign(bls_address_, common::Buffer{data_}, [&](auto signature) {
+      signed_data.set_value(signature);
+    });
+    EXPECT_OUTCOME_TRUE(signature, signed_data.get_future().get());
+    EXPECT_OUTCOME_EQ(ks->verify(bls_address_, data_, signature), true);
+  }
+
 }  // namespace fc::storage::keystore
@@ -48,3 +48,26 @@ TEST_F(LevelDB_Open, OpenExistingDB) {
   boost::filesystem::path p(getPathString());
   EXPECT_TRUE(fs::exists(p));
 }
+
+/**
+ * @given storage profile
+ * @when open namespaces
+ * @then each namespace has own database in own directory, keys of one are
+ * not visible in others
+ */
+TEST_F(LevelDB_Open, CreateNamespaces) {
+  using config::StorageNamespace;
+  EXPECT_OUTCOME_TRUE(
+      dbs,
+      LevelDB::createNamespaces(getPathString() + "/db",
+                                config::defaultStorageProfile()));
+  EXPECT_EQ(dbs.size(), config::kStorageNamespaces.size());
+  for (auto ns : config::kStorageNamespaces) {
+    EXPECT_TRUE(
+        fs::exists(getPathString() + "/db/" + config::namespaceName(ns)));
+  }
+  fc::common::Buffer key{1, 2, 3};
+  EXPECT_OUTCOME_TRUE_1(dbs[StorageNamespace::STATE]->put(key, key));
+  EXPECT_TRUE(dbs[StorageNamespace::STATE]->contains(key));
+  EXPECT_FALSE(dbs[StorageNamespace::CHAIN]->contains(key));
+}
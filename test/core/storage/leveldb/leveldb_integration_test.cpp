@@ -37,6 +37,48 @@ TEST_F(LevelDB_Integration_Test, Put_Get) {
   EXPECT_EQ(val, value_);
 }
 
+/**
+ * @given key kept on stack
+ * @when put and read by borrowed key
+ * @then value is same as read by Buffer key
+ */
+TEST_F(LevelDB_Integration_Test, BorrowedKey) {
+  std::array<uint8_t, 4> key{1, 3, 3, 7};
+  EXPECT_OUTCOME_TRUE_1(db_->put(BufferView{key}, BufferView{value_}));
+  EXPECT_TRUE(db_->contains(BufferView{key}));
+  EXPECT_OUTCOME_TRUE_2(val, db_->get(key_));
+  EXPECT_EQ(val, value_);
+  EXPECT_OUTCOME_TRUE_1(db_->remove(BufferView{key}));
+  EXPECT_FALSE(db_->contains(key_));
+}
+
+/**
+ * @given keys with and around common prefix
+ * @when prefix cursor scans from first key and from suffix
+ * @then only keys with prefix are visited, in order, without prefix
+ */
+TEST_F(LevelDB_Integration_Test, PrefixCursor) {
+  Buffer prefix{1, 2};
+  for (auto &key :
+       {Buffer{1, 1, 9}, Buffer{1, 2, 1}, Buffer{1, 2, 3}, Buffer{1, 3}}) {
+    EXPECT_OUTCOME_TRUE_1(db_->put(key, value_));
+  }
+  auto cursor = db_->prefixCursor(prefix);
+  std::vector<Buffer> keys;
+  for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
+    keys.emplace_back(cursor->key());
+    EXPECT_EQ(Buffer{cursor->value()}, value_);
+  }
+  EXPECT_EQ(keys, (std::vector<Buffer>{Buffer{1}, Buffer{3}}));
+
+  std::array<uint8_t, 1> suffix{2};
+  cursor->seek(suffix);
+  ASSERT_TRUE(cursor->isValid());
+  EXPECT_EQ(Buffer{cursor->key()}, Buffer{3});
+  cursor->next();
+  EXPECT_FALSE(cursor->isValid());
+}
+
 /**
  * @given empty db
  * @when read {key}
@@ -0,0 +1,187 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/mpool/mpool.hpp"
+
+#include <gtest/gtest.h>
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/actor/actor.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
+
+using fc::CID;
+using fc::crypto::signature::Secp256k1Signature;
+using fc::primitives::block::BlockHeader;
+using fc::primitives::block::MsgMeta;
+using fc::primitives::ticket::Ticket;
+using fc::primitives::tipset::HeadChangeType;
+using fc::storage::InMemoryStorage;
+using fc::storage::blockchain::HeadChangeDispatcher;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::mpool::Address;
+using fc::storage::mpool::Mpool;
+using fc::storage::mpool::SignedMessage;
+using fc::storage::mpool::Tipset;
+using fc::vm::actor::Actor;
+using fc::vm::actor::kAccountCodeCid;
+using fc::vm::state::StateTreeImpl;
+
+class MpoolTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    StateTreeImpl tree{ipld};
+    EXPECT_OUTCOME_TRUE_1(
+        tree.set(alice, {kAccountCodeCid, "010001020001"_cid, kStateNonce, 0}));
+    EXPECT_OUTCOME_TRUE(root, tree.flush());
+    state_root = root;
+    genesis = makeTipset({}, 0, 0, {});
+  }
+
+  SignedMessage makeMessage(const Address &from, uint64_t nonce) {
+    SignedMessage message;
+    message.message.version = 0;
+    message.message.from = from;
+    message.message.to = bob;
+    message.message.nonce = nonce;
+    message.signature = Secp256k1Signature{};
+    return message;
+  }
+
+  Tipset makeTipset(const std::vector<CID> &parents,
+                    uint64_t height,
+                    uint64_t fork,
+                    const std::vector<SignedMessage> &secp_messages) {
+    MsgMeta meta;
+    ipld->load(meta);
+    for (auto &message : secp_messages) {
+      EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(message));
+      EXPECT_OUTCOME_TRUE_1(meta.secp_messages.append(cid));
+    }
+    BlockHeader block;
+    block.ticket = Ticket{};
+    block.parents = parents;
+    block.height = height;
+    // distinguishes blocks of forks at same height
+    block.timestamp = fork;
+    block.parent_state_root = state_root;
+    block.parent_message_receipts = "010001020002"_cid;
+    EXPECT_OUTCOME_TRUE(messages, ipld->setCbor(meta));
+    block.messages = messages;
+    EXPECT_OUTCOME_TRUE_1(ipld->setCbor(block));
+    EXPECT_OUTCOME_TRUE(tipset, Tipset::create({block}));
+    return tipset;
+  }
+
+  std::shared_ptr<Mpool> createMpool() {
+    return Mpool::create(
+        ipld, head_changes, io.get_executor(), nullptr, journal);
+  }
+
+  static std::vector<uint64_t> nonces(
+      const std::vector<SignedMessage> &messages) {
+    std::vector<uint64_t> result;
+    for (auto &message : messages) {
+      result.push_back(message.message.nonce);
+    }
+    return result;
+  }
+
+  /// Nonce of alice in genesis state
+  static constexpr uint64_t kStateNonce{2};
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  std::shared_ptr<InMemoryStorage> journal{
+      std::make_shared<InMemoryStorage>()};
+  boost::asio::io_context io;
+  HeadChangeDispatcher head_changes;
+  Address alice{Address::makeFromId(100)};
+  Address bob{Address::makeFromId(101)};
+  CID state_root;
+  Tipset genesis;
+};
+
+/**
+ * @given pool with journal, messages added, one included in applied tipset
+ * and one removed
+ * @when pool is created again over same journal and gets first head
+ * @then pending messages are restored, except included and removed ones and
+ * ones with nonces already used in head state, and nonce continues them
+ */
+TEST_F(MpoolTest, JournalRoundTrip) {
+  auto mpool{createMpool()};
+  EXPECT_OUTCOME_TRUE_1(
+      mpool->onHeadChanges({{HeadChangeType::CURRENT, genesis}}));
+  for (uint64_t nonce = 0; nonce < 4; ++nonce) {
+    EXPECT_OUTCOME_TRUE_1(mpool->add(makeMessage(alice, nonce)));
+  }
+  EXPECT_OUTCOME_TRUE_1(mpool->add(makeMessage(bob, 0)));
+  mpool->remove(bob, 0);
+  auto ts1{makeTipset(genesis.cids, 1, 0, {makeMessage(alice, 0)})};
+  EXPECT_OUTCOME_TRUE_1(mpool->onHeadChanges({{HeadChangeType::APPLY, ts1}}));
+  EXPECT_EQ(nonces(mpool->pending()), (std::vector<uint64_t>{1, 2, 3}));
+  mpool.reset();
+
+  auto restored{createMpool()};
+  EXPECT_EQ(nonces(restored->pending()), (std::vector<uint64_t>{1, 2, 3}));
+  // head state has used nonce 1, as after sync of tipsets with it
+  EXPECT_OUTCOME_TRUE_1(
+      restored->onHeadChanges({{HeadChangeType::CURRENT, genesis}}));
+  auto pending{restored->pending()};
+  EXPECT_EQ(nonces(pending), (std::vector<uint64_t>{2, 3}));
+  for (auto &message : pending) {
+    EXPECT_EQ(message.message.from, alice);
+  }
+  EXPECT_OUTCOME_EQ(restored->nonce(alice), 4);
+
+  // dropped messages are removed from journal too
+  EXPECT_EQ(nonces(createMpool()->pending()), (std::vector<uint64_t>{2, 3}));
+}
+
+/**
+ * @given pool with two messages included in applied tipset
+ * @when one batch reverts that tipset and applies fork tipset including one
+ * of messages again
+ * @then message included again stays out of pending, other returns, and
+ * only its update is signalled, once per batch
+ */
+TEST_F(MpoolTest, ReorgBatch) {
+  auto mpool{std::make_shared<Mpool>(ipld)};
+  EXPECT_OUTCOME_TRUE_1(
+      mpool->onHeadChanges({{HeadChangeType::CURRENT, genesis}}));
+  auto included{makeMessage(alice, 0)};
+  auto reverted{makeMessage(alice, 1)};
+  EXPECT_OUTCOME_TRUE_1(mpool->add(included));
+  EXPECT_OUTCOME_TRUE_1(mpool->add(reverted));
+  auto ts1{makeTipset(genesis.cids, 1, 0, {included, reverted})};
+  auto fork1{makeTipset(genesis.cids, 1, 1, {included})};
+  EXPECT_OUTCOME_TRUE_1(mpool->onHeadChanges({{HeadChangeType::APPLY, ts1}}));
+  EXPECT_TRUE(mpool->pending().empty());
+
+  std::vector<fc::storage::mpool::MpoolUpdate> updates;
+  std::vector<size_t> pending_sizes;
+  auto sub{mpool->subscribe([&, pool{mpool.get()}](auto &update) {
+    updates.push_back(update);
+    // signalled after batch, with pool unlocked
+    pending_sizes.push_back(pool->pending().size());
+  })};
+  EXPECT_OUTCOME_TRUE_1(mpool->onHeadChanges(
+      {{HeadChangeType::REVERT, ts1}, {HeadChangeType::APPLY, fork1}}));
+  EXPECT_EQ(nonces(mpool->pending()), std::vector<uint64_t>{1});
+  ASSERT_EQ(updates.size(), 1);
+  EXPECT_EQ(updates[0].type, fc::storage::mpool::MpoolUpdate::Type::ADD);
+  EXPECT_EQ(updates[0].message.message.nonce, 1);
+  EXPECT_EQ(pending_sizes, std::vector<size_t>{1});
+
+  // tipset messages are cached, batch back to ts1 nets same way
+  updates.clear();
+  EXPECT_OUTCOME_TRUE_1(mpool->onHeadChanges(
+      {{HeadChangeType::REVERT, fork1}, {HeadChangeType::APPLY, ts1}}));
+  EXPECT_TRUE(mpool->pending().empty());
+  ASSERT_EQ(updates.size(), 1);
+  EXPECT_EQ(updates[0].type, fc::storage::mpool::MpoolUpdate::Type::REMOVE);
+}
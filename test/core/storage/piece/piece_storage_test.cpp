@@ -61,3 +61,69 @@ TEST_F(PieceStorageTest, AddBlockLocationSuccess) {
   ASSERT_EQ(payload_location_B.parent_piece, piece_cid);
   ASSERT_EQ(payload_location_B.block_location, location_B);
 }
+
+/**
+ * @given Piece info and locations of blocks in the Piece
+ * @when Region of the blocks is requested
+ * @then Region spans the blocks and is relative to the sector begin
+ */
+TEST_F(PieceStorageTest, PayloadRegion) {
+  std::map<CID, PayloadLocation> locations{{payload_cid_A, location_A},
+                                           {payload_cid_B, location_B}};
+  EXPECT_OUTCOME_TRUE_1(piece_storage->addPieceInfo(piece_cid, piece_info))
+  EXPECT_OUTCOME_TRUE_1(
+      piece_storage->addPayloadLocations(piece_cid, locations));
+  std::vector<CID> payload{payload_cid_B};
+  EXPECT_OUTCOME_TRUE(region, payloadRegion(*piece_storage, payload));
+  EXPECT_EQ(region.piece, piece_cid);
+  EXPECT_EQ(region.sector_id, piece_info.sector_id);
+  EXPECT_EQ(region.offset, piece_info.offset + location_B.relative_offset);
+  EXPECT_EQ(region.length, location_B.block_size);
+
+  payload.push_back(payload_cid_A);
+  EXPECT_OUTCOME_TRUE(both, payloadRegion(*piece_storage, payload));
+  EXPECT_EQ(both.offset, piece_info.offset);
+  EXPECT_EQ(both.length, 150);
+}
+
+/**
+ * @given locations of piece blocks added by two calls
+ * @when location table of piece is requested
+ * @then table has all locations sorted by offset and finds block of offset
+ */
+TEST_F(PieceStorageTest, PieceLocations) {
+  PayloadLocation location_C{.relative_offset = 150, .block_size = 10};
+  EXPECT_OUTCOME_TRUE_1(piece_storage->addPayloadLocations(
+      piece_cid, {{payload_cid_B, location_B}}));
+  CID payload_cid_C{"010001020004"_cid};
+  EXPECT_OUTCOME_TRUE_1(piece_storage->addPayloadLocations(
+      piece_cid, {{payload_cid_A, location_A}, {payload_cid_C, location_C}}));
+
+  EXPECT_OUTCOME_TRUE(table, piece_storage->getPieceLocations(piece_cid));
+  EXPECT_EQ(table.locations(),
+            (std::vector<PayloadLocation>{location_A, location_B, location_C}));
+  EXPECT_EQ(table.find(120), location_B);
+  EXPECT_EQ(table.find(0), location_A);
+  EXPECT_EQ(table.find(160), boost::none);
+  EXPECT_OUTCOME_ERROR(PieceStorageError::PIECE_NOT_FOUND,
+                       piece_storage->getPieceLocations(payload_cid_A));
+}
+
+/**
+ * @given Empty piece storage
+ * @when Piece info and payload locations are added
+ * @then Generation changes after each write, so cached answers are stale
+ */
+TEST_F(PieceStorageTest, GenerationChanges) {
+  auto generation{piece_storage->generation()};
+  EXPECT_OUTCOME_TRUE_1(piece_storage->addPieceInfo(piece_cid, piece_info))
+  EXPECT_NE(piece_storage->generation(), generation);
+  generation = piece_storage->generation();
+  EXPECT_OUTCOME_TRUE_1(piece_storage->addPayloadLocations(
+      piece_cid, {{payload_cid_A, location_A}}));
+  EXPECT_NE(piece_storage->generation(), generation);
+  generation = piece_storage->generation();
+  EXPECT_OUTCOME_TRUE(info, piece_storage->getPieceInfo(piece_cid));
+  EXPECT_EQ(info, piece_info);
+  EXPECT_EQ(piece_storage->generation(), generation);
+}
@@ -5,10 +5,13 @@
 
 #include "storage/unixfs/unixfs.hpp"
 
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include "common/span.hpp"
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/ipld/walker.hpp"
 #include "testutil/outcome.hpp"
 
 using Params = std::tuple<std::string, size_t, size_t, std::string>;
@@ -24,6 +27,21 @@ TEST_P(UnixfsTest, MatchGo) {
       cid);
 }
 
+/**
+ * @given file data
+ * @when file is imported from stream with small batches
+ * @then dag matches go
+ */
+TEST_P(UnixfsTest, MatchGoStream) {
+  auto &[data, chunk_size, max_links, cid_str] = GetParam();
+  fc::storage::ipfs::InMemoryDatastore ipld;
+  EXPECT_OUTCOME_TRUE(cid, fc::CID::fromString(cid_str));
+  std::istringstream input{data};
+  EXPECT_OUTCOME_EQ(
+      fc::storage::unixfs::wrapFile(ipld, input, chunk_size, max_links, 2),
+      cid);
+}
+
 INSTANTIATE_TEST_CASE_P(
     UnixfsTestCases,
     UnixfsTest,
@@ -56,3 +74,37 @@ INSTANTIATE_TEST_CASE_P(
                5,
                3,
                "QmYb4gZGCAkRdNZbc5npDzLJA34ZzPtdVDmESb9Xk76Ws2"}));
+
+/**
+ * @given file of 5 chunks in tree of 2 links per node
+ * @when blocks of range within chunks 1..3 are selected
+ * @then only these leaves and nodes on paths to them are walked
+ */
+TEST(UnixfsRangeTest, FileRange) {
+  using fc::storage::ipld::walker::Walker;
+  fc::storage::ipfs::InMemoryDatastore ipld;
+  std::string data{"[0     10)[10    20)[20    30)[30    40)[40    50)"};
+  EXPECT_OUTCOME_TRUE(root,
+                      fc::storage::unixfs::wrapFile(
+                          ipld, fc::common::span::cbytes(data), 10, 2));
+
+  EXPECT_OUTCOME_TRUE(range,
+                      fc::storage::unixfs::fileRange(ipld, root, 15, 20));
+  ASSERT_EQ(range.leaves.size(), 3);
+  for (auto i = 0u; i < 3; ++i) {
+    auto &leaf = range.leaves[i];
+    EXPECT_EQ(leaf.offset, 10 * (i + 1));
+    EXPECT_EQ(leaf.size, 10);
+    EXPECT_OUTCOME_TRUE(bytes, ipld.get(leaf.cid));
+    EXPECT_EQ(std::string(bytes.begin(), bytes.end()),
+              data.substr(leaf.offset, leaf.size));
+  }
+
+  Walker walker{ipld};
+  EXPECT_OUTCOME_TRUE_1(walker.select(root, range.selector));
+  for (auto &leaf : range.leaves) {
+    EXPECT_EQ(walker.visited.count(leaf.cid), 1);
+  }
+  // root, node of height 2, 2 nodes of height 1, 3 leaves
+  EXPECT_EQ(walker.visited.size(), 7);
+}
@@ -43,6 +43,7 @@ using fc::vm::VMExitCode;
 using fc::vm::actor::ActorSubstateCID;
 using fc::vm::actor::kAccountCodeCid;
 using fc::vm::actor::kBurntFundsActorAddress;
+using fc::vm::actor::kCronAddress;
 using fc::vm::actor::kInitAddress;
 using fc::vm::actor::kInitCodeCid;
 using fc::vm::actor::kSendMethodNumber;
@@ -413,6 +414,46 @@ TEST_F(MarketActorTest, GCC_DISABLE(PublishStorageDeals)) {
                     deal.clientBalanceRequirement());
 }
 
+/**
+ * @given escrow of client for one deal
+ * @when two deals of client are published by one message
+ * @then second deal fails as if deals were locked one by one
+ */
+TEST_F(MarketActorTest, GCC_DISABLE(PublishStorageDealsBatchInsufficient)) {
+  auto proposal = setupPublishStorageDeals();
+
+  EXPECT_OUTCOME_ERROR(
+      VMExitCode::MARKET_ACTOR_INSUFFICIENT_FUNDS,
+      MarketActor::PublishStorageDeals::call(runtime, {{proposal, proposal}}));
+}
+
+/**
+ * @given escrow of client and provider for two deals
+ * @when both deals are published by one message
+ * @then balances of both deals are locked
+ */
+TEST_F(MarketActorTest, GCC_DISABLE(PublishStorageDealsBatch)) {
+  auto proposal = setupPublishStorageDeals();
+  auto &deal = proposal.proposal;
+  state.next_deal = deal_1_id;
+  EXPECT_OUTCOME_TRUE_1(state.escrow_table.set(
+      miner_address, deal.providerBalanceRequirement() * 2));
+  EXPECT_OUTCOME_TRUE_1(state.escrow_table.set(
+      client_address, deal.clientBalanceRequirement() * 2));
+
+  EXPECT_OUTCOME_TRUE(
+      result,
+      MarketActor::PublishStorageDeals::call(runtime, {{proposal, proposal}}));
+
+  EXPECT_THAT(result.deals, testing::ElementsAre(deal_1_id, deal_1_id + 1));
+  expectHasDeal(deal_1_id, deal, true);
+  expectHasDeal(deal_1_id + 1, deal, true);
+  EXPECT_OUTCOME_EQ(state.locked_table.get(miner_address),
+                    deal.providerBalanceRequirement() * 2);
+  EXPECT_OUTCOME_EQ(state.locked_table.get(client_address),
+                    deal.clientBalanceRequirement() * 2);
+}
+
 DealProposal MarketActorTest::setupVerifyDealsOnSectorProveCommit(
     const std::function<void(DealProposal &)> &prepare) {
   DealProposal deal;
@@ -546,3 +587,26 @@ TEST_F(MarketActorTest, GCC_DISABLE(ComputeDataCommitment)) {
                         runtime, {deal_ids, sector_type}),
                     comm_d);
 }
+
+/**
+ * @given deal sets scheduled before and after current epoch, last cron long
+ * ago
+ * @when cron tick catches up
+ * @then only due deal set is processed and removed
+ */
+TEST_F(MarketActorTest, CronTickCatchUp) {
+  state.last_cron = 0;
+  State::DealSet due{fc::IpldPtr{ipld}}, later{fc::IpldPtr{ipld}};
+  EXPECT_OUTCOME_TRUE_1(due.set(deal_1_id, {}));
+  EXPECT_OUTCOME_TRUE_1(later.set(deal_2_id, {}));
+  EXPECT_OUTCOME_TRUE_1(state.deals_by_epoch.set(100, due));
+  EXPECT_OUTCOME_TRUE_1(state.deals_by_epoch.set(epoch + 1, later));
+
+  callerIs(kCronAddress);
+  expectSendFunds(kBurntFundsActorAddress, 0);
+  EXPECT_OUTCOME_TRUE_1(MarketActor::CronTick::call(runtime, {}));
+
+  EXPECT_EQ(state.last_cron, epoch);
+  EXPECT_OUTCOME_EQ(state.deals_by_epoch.has(100), false);
+  EXPECT_OUTCOME_EQ(state.deals_by_epoch.has(epoch + 1), true);
+}
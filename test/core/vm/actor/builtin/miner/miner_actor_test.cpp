@@ -0,0 +1,131 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/actor/builtin/miner/miner_actor.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/mocks/vm/runtime/runtime_mock.hpp"
+#include "testutil/outcome.hpp"
+
+#define ON_CALL_3(a, b, c) \
+  EXPECT_CALL(a, b).Times(testing::AnyNumber()).WillRepeatedly(Return(c))
+
+namespace fc::vm::actor::builtin::miner {
+  using crypto::randomness::Randomness;
+  using primitives::sector::RegisteredProof;
+  using primitives::sector::WindowPoStVerifyInfo;
+  using runtime::MockRuntime;
+  using storage::ipfs::InMemoryDatastore;
+  using testing::_;
+  using testing::Return;
+
+  /**
+   * @given deadlines with different numbers of sectors
+   * @when first partition and sectors of deadline are requested
+   * @then partitions of preceding deadlines are counted with their own
+   * sizes
+   */
+  TEST(DeadlinesTest, Partitions) {
+    Deadlines deadlines;
+    deadlines.due = {{1, 2, 3}, {4}, {5, 6, 7, 8}, {}};
+    EXPECT_EQ(deadlines.partitions(2, 0), (std::pair<size_t, size_t>{0, 3}));
+    EXPECT_EQ(deadlines.partitions(2, 1), (std::pair<size_t, size_t>{2, 1}));
+    EXPECT_EQ(deadlines.partitions(2, 2), (std::pair<size_t, size_t>{3, 4}));
+    EXPECT_EQ(deadlines.partitions(2, 3), (std::pair<size_t, size_t>{5, 0}));
+  }
+
+  struct MinerActorTest : testing::Test {
+    void SetUp() override {
+      ON_CALL_3(runtime, getIpfsDatastore(), ipld);
+      ON_CALL_3(runtime, getCurrentEpoch(), epoch);
+      ON_CALL_3(runtime, getCurrentReceiver(), miner_address);
+      ON_CALL_3(runtime, getImmediateCaller(), worker_address);
+      ON_CALL_3(runtime, getRandomness(_, _, _), Randomness{});
+      EXPECT_CALL(runtime, resolveAddress(_))
+          .Times(testing::AnyNumber())
+          .WillRepeatedly(
+              testing::Invoke([](auto &address) { return address; }));
+
+      ipld->load(state);
+      state.info.owner = owner_address;
+      state.info.worker = worker_address;
+      state.info.seal_proof_type = RegisteredProof::StackedDRG2KiBSeal;
+      state.info.sector_size = 2048;
+      state.info.window_post_partition_sectors = 2;
+      state.proving_period_start = 0;
+      deadlines.due.resize(kWPoStPeriodDeadlines);
+
+      EXPECT_CALL(runtime, getCurrentActorState())
+          .Times(testing::AtMost(1))
+          .WillOnce(testing::Invoke([&]() {
+            EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(state));
+            return ActorSubstateCID{std::move(cid)};
+          }));
+      EXPECT_CALL(runtime, commit(_))
+          .Times(testing::AtMost(1))
+          .WillOnce(testing::Invoke([&](auto &cid) {
+            EXPECT_OUTCOME_TRUE(new_state, ipld->getCbor<State>(cid));
+            state = std::move(new_state);
+            return outcome::success();
+          }));
+    }
+
+    /// Adds proven sectors to deadline
+    void addSectors(size_t deadline, const std::vector<SectorNumber> &numbers) {
+      for (auto number : numbers) {
+        EXPECT_OUTCOME_TRUE(sealed_cid, ipld->setCbor(number));
+        SectorOnChainInfo sector;
+        sector.info.registered_proof = state.info.seal_proof_type;
+        sector.info.sector = number;
+        sector.info.sealed_cid = sealed_cid;
+        EXPECT_OUTCOME_TRUE_1(state.sectors.set(number, sector));
+        deadlines.due[deadline].insert(number);
+      }
+      EXPECT_OUTCOME_TRUE(deadlines_cid, ipld->setCbor(deadlines));
+      state.deadlines = deadlines_cid;
+    }
+
+    MockRuntime runtime;
+
+    std::shared_ptr<InMemoryDatastore> ipld{
+        std::make_shared<InMemoryDatastore>()};
+
+    ChainEpoch epoch{10};
+
+    Address miner_address{Address::makeFromId(100)};
+    Address owner_address{Address::makeFromId(101)};
+    Address worker_address{Address::makeFromId(102)};
+
+    State state;
+    Deadlines deadlines;
+  };
+
+  /**
+   * @given deadline with two partitions of two sectors each
+   * @when PoSt of both partitions is submitted
+   * @then proof is verified against every sector of partitions in order,
+   * and partitions are recorded as submitted
+   */
+  TEST_F(MinerActorTest, SubmitWindowedPoStSeveralSectors) {
+    std::vector<SectorNumber> numbers{1, 2, 3, 4};
+    addSectors(0, numbers);
+
+    EXPECT_CALL(runtime, verifyPoSt(_))
+        .WillOnce(testing::Invoke([&](const WindowPoStVerifyInfo &info) {
+          std::vector<SectorNumber> challenged;
+          for (auto &sector : info.challenged_sectors) {
+            challenged.push_back(sector.sector);
+          }
+          EXPECT_EQ(challenged, numbers);
+          return true;
+        }));
+
+    EXPECT_OUTCOME_TRUE_1(
+        SubmitWindowedPoSt::call(runtime, {0, {0, 1}, {}, {}}));
+    EXPECT_EQ(state.post_submissions, (RleBitset{0, 1}));
+  }
+}  // namespace fc::vm::actor::builtin::miner
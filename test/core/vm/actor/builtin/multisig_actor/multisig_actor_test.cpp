@@ -7,8 +7,8 @@
 
 #include <gtest/gtest.h>
 #include "primitives/address/address.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "testutil/literals.hpp"
-#include "testutil/mocks/storage/ipfs/ipfs_datastore_mock.hpp"
 #include "testutil/mocks/vm/runtime/runtime_mock.hpp"
 #include "testutil/outcome.hpp"
 #include "vm/actor/actor_method.hpp"
@@ -19,7 +19,7 @@ using fc::primitives::BigInt;
 using fc::primitives::ChainEpoch;
 using fc::primitives::EpochDuration;
 using fc::primitives::address::Address;
-using fc::storage::ipfs::MockIpfsDatastore;
+using fc::storage::ipfs::InMemoryDatastore;
 using fc::vm::VMExitCode;
 using fc::vm::actor::Actor;
 using fc::vm::actor::ActorSubstateCID;
@@ -45,23 +45,35 @@ using fc::vm::runtime::InvocationOutput;
 using fc::vm::runtime::MockRuntime;
 using ::testing::_;
 using ::testing::Eq;
+using Transactions = std::vector<MultiSignatureTransaction>;
 
 /**
- * Match encoded MultiSignatureActorState is expected one
- * Used for IpldStore set state.
+ * Match committed MultiSignatureActorState is expected one with expected
+ * pending transactions
  */
-MATCHER_P(MultiSignatureActorStateMatcher,
-          expected,
-          "Match MultisignatureActorState") {
-  MultiSignatureActorState actual =
-      fc::codec::cbor::decode<MultiSignatureActorState>(arg).value();
+MATCHER_P3(MultiSignatureActorStateMatcher,
+           ipld,
+           expected,
+           pending,
+           "Match MultisignatureActorState") {
+  auto actual = ipld->template getCbor<MultiSignatureActorState>(arg).value();
+  auto keys = actual.pending_transactions.keys().value();
+  if (keys.size() != pending.size()) {
+    return false;
+  }
+  for (auto &tx : pending) {
+    auto actual_tx =
+        actual.pending_transactions.tryGet(tx.transaction_number).value();
+    if (!actual_tx || !(*actual_tx == tx)) {
+      return false;
+    }
+  }
   return actual.signers == expected.signers
          && actual.threshold == expected.threshold
          && actual.next_transaction_id == expected.next_transaction_id
          && actual.initial_balance == expected.initial_balance
          && actual.start_epoch == expected.start_epoch
-         && actual.unlock_duration == expected.unlock_duration
-         && actual.pending_transactions == expected.pending_transactions;
+         && actual.unlock_duration == expected.unlock_duration;
 }
 
 class MultisigActorTest : public ::testing::Test {
@@ -88,8 +100,8 @@ class MultisigActorTest : public ::testing::Test {
       "3333333333333333"_blob48);
 
   MockRuntime runtime;
-  std::shared_ptr<MockIpfsDatastore> datastore =
-      std::make_shared<MockIpfsDatastore>();
+  std::shared_ptr<InMemoryDatastore> datastore =
+      std::make_shared<InMemoryDatastore>();
   MethodNumber method_number{1};
   MethodParams method_params{Buffer{"0102"_unhex}};
   size_t default_threshold{1};
@@ -97,7 +109,18 @@ class MultisigActorTest : public ::testing::Test {
   BigInt default_initial_balance{0};
   ChainEpoch default_start_epoch{0};
   EpochDuration default_unlock_duration{0};
-  std::vector<MultiSignatureTransaction> default_pending_transactions{};
+
+  /** Store state with pending transactions as actor head */
+  void setState(MultiSignatureActorState &state,
+                const Transactions &pending_transactions) {
+    state.pending_transactions = {datastore};
+    for (auto &tx : pending_transactions) {
+      EXPECT_OUTCOME_TRUE_1(
+          state.pending_transactions.set(tx.transaction_number, tx));
+    }
+    EXPECT_OUTCOME_TRUE(encoded_state, fc::Ipld::encode(state));
+    EXPECT_OUTCOME_TRUE_1(datastore->set(actor_head, encoded_state));
+  }
 };
 
 /**
@@ -140,9 +163,9 @@ TEST_F(MultisigActorTest, ConstrucCorrect) {
       .WillOnce(testing::Return(kInitAddress));
   EXPECT_CALL(runtime, getCurrentEpoch())
       .WillOnce(testing::Return(ChainEpoch{42}));
-  EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, set(_, _))
-      .WillOnce(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(runtime, getIpfsDatastore())
+      .Times(2)
+      .WillRepeatedly(testing::Return(datastore));
   EXPECT_CALL(runtime, commit(_))
       .WillOnce(testing::Return(fc::outcome::success()));
 
@@ -172,7 +195,7 @@ TEST_F(MultisigActorTest, ProposeWrongCaller) {
  */
 TEST_F(MultisigActorTest, ProposetWrongSigner) {
   MultiSignatureActorState actor_state{};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+  setState(actor_state, {pending_tx});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
@@ -184,8 +207,6 @@ TEST_F(MultisigActorTest, ProposetWrongSigner) {
       .WillOnce(::testing::Return(actor_head));
 
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(VMExitCode::MULTISIG_ACTOR_FORBIDDEN,
                        Propose::call(runtime, {}));
@@ -205,17 +226,14 @@ TEST_F(MultisigActorTest, ProposeSendInsufficientFunds) {
                                        tx_number,
                                        actor_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -247,17 +265,14 @@ TEST_F(MultisigActorTest, ProposeSendFundsLocked) {
                                        tx_number,
                                        actor_balance,
                                        start_epoch,
-                                       unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -291,17 +306,14 @@ TEST_F(MultisigActorTest, ProposeSendFundsLockedStartEpoch) {
                                        tx_number,
                                        actor_balance,
                                        start_epoch,
-                                       unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -331,17 +343,15 @@ TEST_F(MultisigActorTest, ProposeSendFundsEnough) {
                                        tx_number,
                                        actor_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   MultiSignatureActorState expected_state{std::vector{caller_address},
                                           1,
                                           tx_number + 1,
                                           actor_balance,
                                           default_start_epoch,
-                                          default_unlock_duration,
-                                          default_pending_transactions};
+                                          default_unlock_duration};
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
@@ -350,11 +360,6 @@ TEST_F(MultisigActorTest, ProposeSendFundsEnough) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -364,7 +369,9 @@ TEST_F(MultisigActorTest, ProposeSendFundsEnough) {
       .WillOnce(testing::Return(fc::outcome::success(actor_balance)));
   EXPECT_CALL(runtime, getCurrentEpoch())
       .WillOnce(testing::Return(ChainEpoch{42}));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
   EXPECT_CALL(runtime,
               send(Eq(to_address),
@@ -393,9 +400,8 @@ TEST_F(MultisigActorTest, ProposePending) {
                                        tx_number,
                                        actor_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   MultiSignatureTransaction pending_tx{tx_number,
                                        to_address,
@@ -408,8 +414,7 @@ TEST_F(MultisigActorTest, ProposePending) {
                                           tx_number + 1,
                                           actor_balance,
                                           0,
-                                          0,
-                                          std::vector{pending_tx}};
+                                          0};
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
@@ -418,11 +423,6 @@ TEST_F(MultisigActorTest, ProposePending) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -430,7 +430,9 @@ TEST_F(MultisigActorTest, ProposePending) {
       .WillOnce(testing::Return(actor_address));
   EXPECT_CALL(runtime, getBalance(Eq(actor_address)))
       .WillOnce(testing::Return(fc::outcome::success(actor_balance)));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{pending_tx})))
       .WillOnce(testing::Return(fc::outcome::success()));
 
   EXPECT_OUTCOME_EQ(
@@ -466,17 +468,14 @@ TEST_F(MultisigActorTest, ApproveWrongSigner) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -497,17 +496,14 @@ TEST_F(MultisigActorTest, ApproveWrongTxNumber) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -540,17 +536,14 @@ TEST_F(MultisigActorTest, ApproveAlreadySigned) {
                                        tx_number,
                                        actor_balance,
                                        0,
-                                       0,
-                                       std::vector{pending_tx}};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       0};
+  setState(actor_state, {pending_tx});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -583,9 +576,8 @@ TEST_F(MultisigActorTest, ApproveSunnyDay) {
                                        tx_number,
                                        actor_balance,
                                        0,
-                                       0,
-                                       std::vector{pending_tx}};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       0};
+  setState(actor_state, {pending_tx});
 
   // expected that pending tx is removed after sending
   MultiSignatureActorState expected_state{
@@ -594,8 +586,7 @@ TEST_F(MultisigActorTest, ApproveSunnyDay) {
       tx_number,
       actor_balance,
       0,
-      0,
-      std::vector<MultiSignatureTransaction>{}};
+      0};
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
@@ -604,11 +595,6 @@ TEST_F(MultisigActorTest, ApproveSunnyDay) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -618,7 +604,9 @@ TEST_F(MultisigActorTest, ApproveSunnyDay) {
       .WillOnce(testing::Return(actor_address));
   EXPECT_CALL(runtime, getBalance(Eq(actor_address)))
       .WillOnce(testing::Return(fc::outcome::success(actor_balance)));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
   EXPECT_CALL(runtime,
               send(Eq(to_address),
@@ -657,17 +645,14 @@ TEST_F(MultisigActorTest, CancelWrongSigner) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -688,17 +673,14 @@ TEST_F(MultisigActorTest, CancelWrongTxNumber) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -731,17 +713,14 @@ TEST_F(MultisigActorTest, CancelNotCreator) {
                                        tx_number,
                                        actor_balance,
                                        0,
-                                       0,
-                                       std::vector{pending_tx}};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       0};
+  setState(actor_state, {pending_tx});
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
@@ -774,9 +753,8 @@ TEST_F(MultisigActorTest, CancelSunnyDay) {
                                        tx_number,
                                        actor_balance,
                                        0,
-                                       0,
-                                       std::vector{pending_tx}};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       0};
+  setState(actor_state, {pending_tx});
 
   // expected that pending tx is removed after cancel
   MultiSignatureActorState expected_state{
@@ -785,8 +763,7 @@ TEST_F(MultisigActorTest, CancelSunnyDay) {
       tx_number,
       actor_balance,
       0,
-      0,
-      std::vector<MultiSignatureTransaction>{}};
+      0};
 
   EXPECT_CALL(runtime, getActorCodeID(caller_address))
       .WillOnce(testing::Return(fc::outcome::success(kAccountCodeCid)));
@@ -795,15 +772,12 @@ TEST_F(MultisigActorTest, CancelSunnyDay) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
   EXPECT_CALL(runtime, getImmediateCaller())
       .Times(2)
       .WillRepeatedly(testing::Return(caller_address));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
 
   EXPECT_OUTCOME_TRUE_1(Cancel::call(runtime, {pending_tx_number}));
@@ -836,9 +810,8 @@ TEST_F(MultisigActorTest, AddSignerAlreadyAdded) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -847,8 +820,6 @@ TEST_F(MultisigActorTest, AddSignerAlreadyAdded) {
   EXPECT_CALL(runtime, getCurrentReceiver())
       .WillOnce(testing::Return(caller_address));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(VMExitCode::MULTISIG_ACTOR_ILLEGAL_ARGUMENT,
                        AddSigner::call(runtime, {caller_address}));
@@ -866,9 +837,8 @@ TEST_F(MultisigActorTest, AddSignerNotChangeThreshold) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   std::vector<Address> expected_signers{kInitAddress, caller_address};
   MultiSignatureActorState expected_state{expected_signers,
@@ -876,8 +846,7 @@ TEST_F(MultisigActorTest, AddSignerNotChangeThreshold) {
                                           default_next_transaction_id,
                                           default_initial_balance,
                                           default_start_epoch,
-                                          default_unlock_duration,
-                                          default_pending_transactions};
+                                          default_unlock_duration};
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -888,12 +857,9 @@ TEST_F(MultisigActorTest, AddSignerNotChangeThreshold) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
 
   EXPECT_OUTCOME_TRUE_1(AddSigner::call(runtime, {caller_address, false}));
@@ -911,9 +877,8 @@ TEST_F(MultisigActorTest, AddSignerChangeThreshold) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   std::vector<Address> expected_signers{kInitAddress, caller_address};
   MultiSignatureActorState expected_state{expected_signers,
@@ -921,8 +886,7 @@ TEST_F(MultisigActorTest, AddSignerChangeThreshold) {
                                           default_next_transaction_id,
                                           default_initial_balance,
                                           default_start_epoch,
-                                          default_unlock_duration,
-                                          default_pending_transactions};
+                                          default_unlock_duration};
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -933,12 +897,9 @@ TEST_F(MultisigActorTest, AddSignerChangeThreshold) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
 
   EXPECT_OUTCOME_TRUE_1(AddSigner::call(runtime, {caller_address, true}));
@@ -971,9 +932,8 @@ TEST_F(MultisigActorTest, RemoveSignerNotAdded) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -982,8 +942,6 @@ TEST_F(MultisigActorTest, RemoveSignerNotAdded) {
   EXPECT_CALL(runtime, getCurrentReceiver())
       .WillOnce(testing::Return(caller_address));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(VMExitCode::MULTISIG_ACTOR_FORBIDDEN,
                        RemoveSigner::call(runtime, {caller_address}));
@@ -1001,9 +959,8 @@ TEST_F(MultisigActorTest, RemoveSignerNotChangeThreshold) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   std::vector<Address> expected_signers{kInitAddress};
   MultiSignatureActorState expected_state{expected_signers,
@@ -1011,8 +968,7 @@ TEST_F(MultisigActorTest, RemoveSignerNotChangeThreshold) {
                                           default_next_transaction_id,
                                           default_initial_balance,
                                           default_start_epoch,
-                                          default_unlock_duration,
-                                          default_pending_transactions};
+                                          default_unlock_duration};
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1023,12 +979,9 @@ TEST_F(MultisigActorTest, RemoveSignerNotChangeThreshold) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
 
   EXPECT_OUTCOME_TRUE_1(RemoveSigner::call(runtime, {caller_address, false}));
@@ -1047,9 +1000,8 @@ TEST_F(MultisigActorTest, RemoveSignerChangeThreshold) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   std::vector<Address> expected_signers{kInitAddress};
   MultiSignatureActorState expected_state{expected_signers,
@@ -1057,8 +1009,7 @@ TEST_F(MultisigActorTest, RemoveSignerChangeThreshold) {
                                           default_next_transaction_id,
                                           default_initial_balance,
                                           default_start_epoch,
-                                          default_unlock_duration,
-                                          default_pending_transactions};
+                                          default_unlock_duration};
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1069,12 +1020,9 @@ TEST_F(MultisigActorTest, RemoveSignerChangeThreshold) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
 
   EXPECT_OUTCOME_TRUE_1(RemoveSigner::call(runtime, {caller_address, true}));
@@ -1092,9 +1040,8 @@ TEST_F(MultisigActorTest, RemoveSignerChangeThresholdZero) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1103,8 +1050,6 @@ TEST_F(MultisigActorTest, RemoveSignerChangeThresholdZero) {
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(VMExitCode::MULTISIG_ACTOR_ILLEGAL_ARGUMENT,
                        RemoveSigner::call(runtime, {caller_address, true}));
@@ -1123,9 +1068,8 @@ TEST_F(MultisigActorTest, RemoveSignerChangeThresholdError) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1134,8 +1078,6 @@ TEST_F(MultisigActorTest, RemoveSignerChangeThresholdError) {
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(VMExitCode::MULTISIG_ACTOR_ILLEGAL_ARGUMENT,
                        RemoveSigner::call(runtime, {caller_address, false}));
@@ -1169,9 +1111,8 @@ TEST_F(MultisigActorTest, SwapSignerNotAdded) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1180,8 +1121,6 @@ TEST_F(MultisigActorTest, SwapSignerNotAdded) {
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(
       VMExitCode::MULTISIG_ACTOR_NOT_FOUND,
@@ -1201,9 +1140,8 @@ TEST_F(MultisigActorTest, SwapSignerAlreadyAdded) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1212,8 +1150,6 @@ TEST_F(MultisigActorTest, SwapSignerAlreadyAdded) {
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(
       VMExitCode::MULTISIG_ACTOR_ILLEGAL_ARGUMENT,
@@ -1232,9 +1168,8 @@ TEST_F(MultisigActorTest, SwapSignerSuccess) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state));
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   std::vector<Address> expected_signers{kCronAddress, kInitAddress};
   MultiSignatureActorState expected_state{expected_signers,
@@ -1242,8 +1177,7 @@ TEST_F(MultisigActorTest, SwapSignerSuccess) {
                                           default_next_transaction_id,
                                           default_initial_balance,
                                           default_start_epoch,
-                                          default_unlock_duration,
-                                          default_pending_transactions};
+                                          default_unlock_duration};
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1254,12 +1188,9 @@ TEST_F(MultisigActorTest, SwapSignerSuccess) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
 
   EXPECT_OUTCOME_TRUE_1(
@@ -1293,9 +1224,8 @@ TEST_F(MultisigActorTest, ChangeThresholdZero) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1304,8 +1234,6 @@ TEST_F(MultisigActorTest, ChangeThresholdZero) {
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(VMExitCode::MULTISIG_ACTOR_ILLEGAL_ARGUMENT,
                        ChangeThreshold::call(runtime, {0}));
@@ -1323,9 +1251,8 @@ TEST_F(MultisigActorTest, ChangeThresholdMoreThanSigners) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1334,8 +1261,6 @@ TEST_F(MultisigActorTest, ChangeThresholdMoreThanSigners) {
   EXPECT_CALL(runtime, getCurrentActorState())
       .WillOnce(::testing::Return(actor_head));
   EXPECT_CALL(runtime, getIpfsDatastore()).WillOnce(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
 
   EXPECT_OUTCOME_ERROR(VMExitCode::MULTISIG_ACTOR_ILLEGAL_ARGUMENT,
                        ChangeThreshold::call(runtime, {100500}));
@@ -1355,17 +1280,15 @@ TEST_F(MultisigActorTest, ChangeThresholdSuccess) {
                                        default_next_transaction_id,
                                        default_initial_balance,
                                        default_start_epoch,
-                                       default_unlock_duration,
-                                       default_pending_transactions};
-  EXPECT_OUTCOME_TRUE(encoded_state, fc::codec::cbor::encode(actor_state))
+                                       default_unlock_duration};
+  setState(actor_state, {});
 
   MultiSignatureActorState expected_state{signers,
                                           new_threshold,
                                           default_next_transaction_id,
                                           default_initial_balance,
                                           default_start_epoch,
-                                          default_unlock_duration,
-                                          default_pending_transactions};
+                                          default_unlock_duration};
 
   EXPECT_CALL(runtime, getImmediateCaller())
       .WillOnce(testing::Return(caller_address));
@@ -1376,12 +1299,9 @@ TEST_F(MultisigActorTest, ChangeThresholdSuccess) {
   EXPECT_CALL(runtime, getIpfsDatastore())
       .Times(2)
       .WillRepeatedly(testing::Return(datastore));
-  EXPECT_CALL(*datastore, get(_))
-      .WillOnce(testing::Return(fc::outcome::success(encoded_state)));
-  EXPECT_CALL(*datastore,
-              set(_, MultiSignatureActorStateMatcher(expected_state)))
-      .WillOnce(testing::Return(fc::outcome::success()));
-  EXPECT_CALL(runtime, commit(_))
+  EXPECT_CALL(runtime,
+              commit(MultiSignatureActorStateMatcher(
+                  datastore, expected_state, Transactions{})))
       .WillOnce(testing::Return(fc::outcome::success()));
 
   EXPECT_OUTCOME_TRUE_1(ChangeThreshold::call(runtime, {new_threshold}));
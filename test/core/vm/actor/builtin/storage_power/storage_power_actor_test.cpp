@@ -0,0 +1,137 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/actor/builtin/storage_power/storage_power_actor_export.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/mocks/vm/runtime/runtime_mock.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/actor/builtin/miner/miner_actor.hpp"
+#include "vm/actor/builtin/reward/reward_actor.hpp"
+#include "vm/actor/builtin/shared/shared.hpp"
+#include "vm/actor/builtin/storage_power/storage_power_actor_state.hpp"
+
+#define ON_CALL_3(a, b, c) \
+  EXPECT_CALL(a, b).Times(testing::AnyNumber()).WillRepeatedly(Return(c))
+
+using fc::common::Buffer;
+using fc::primitives::ChainEpoch;
+using fc::primitives::address::Address;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::actor::ActorSubstateCID;
+using fc::vm::actor::kCronAddress;
+using fc::vm::actor::kRewardAddress;
+using fc::vm::actor::MethodParams;
+using fc::vm::actor::builtin::kCronProbeEpochs;
+using fc::vm::actor::builtin::miner::OnDeferredCronEvent;
+using fc::vm::actor::builtin::reward::UpdateNetworkKPI;
+using fc::vm::actor::builtin::storage_power::OnEpochTickEnd;
+using fc::vm::actor::builtin::storage_power::State;
+using fc::vm::runtime::MockRuntime;
+using testing::_;
+using testing::Return;
+
+struct StoragePowerActorTest : testing::Test {
+  void SetUp() override {
+    ON_CALL_3(runtime, getIpfsDatastore(), ipld);
+    ON_CALL_3(runtime, getImmediateCaller(), kCronAddress);
+    state = State::empty(ipld);
+
+    EXPECT_CALL(runtime, getCurrentActorState())
+        .Times(testing::AtMost(1))
+        .WillOnce(testing::Invoke([&]() {
+          EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(state));
+          return ActorSubstateCID{std::move(cid)};
+        }));
+    EXPECT_CALL(runtime, commit(_))
+        .Times(testing::AtMost(1))
+        .WillOnce(testing::Invoke([&](auto &cid) {
+          EXPECT_OUTCOME_TRUE(new_state, ipld->getCbor<State>(cid));
+          state = std::move(new_state);
+          return fc::outcome::success();
+        }));
+    EXPECT_CALL(runtime, send(kRewardAddress, UpdateNetworkKPI::Number, _, _))
+        .WillOnce(Return(fc::outcome::success()));
+    EXPECT_CALL(runtime, send(miner, OnDeferredCronEvent::Number, _, _))
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(testing::Invoke([&](auto, auto, auto &params, auto) {
+          called.push_back(params[0]);
+          return fc::outcome::success();
+        }));
+  }
+
+  /// Enrolls event with payload of its epoch
+  void enroll(ChainEpoch epoch) {
+    EXPECT_OUTCOME_TRUE_1(state.appendCronEvent(
+        epoch, {miner, Buffer{static_cast<uint8_t>(epoch)}}));
+  }
+
+  /// Ticks from last epoch tick to now
+  void tick(ChainEpoch last, ChainEpoch now) {
+    state.last_epoch_tick = last;
+    ON_CALL_3(runtime, getCurrentEpoch(), now);
+    EXPECT_OUTCOME_TRUE_1(OnEpochTickEnd::call(runtime, {}));
+    EXPECT_EQ(state.last_epoch_tick, now);
+  }
+
+  void expectQueued(ChainEpoch epoch, bool queued) {
+    EXPECT_OUTCOME_EQ(state.cron_event_queue.has(epoch), queued);
+  }
+
+  MockRuntime runtime;
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  State state;
+  Address miner{Address::makeFromId(1000)};
+  /// Payloads of called events, in call order
+  std::vector<uint8_t> called;
+};
+
+/**
+ * @given events before, at, inside and after range of null rounds longer
+ * than probe range
+ * @when cron ticks after null rounds
+ * @then only events in (last tick, now] are called, in epoch order, and
+ * only their epochs are removed
+ */
+TEST_F(StoragePowerActorTest, CatchUpAfterNullRounds) {
+  constexpr ChainEpoch kLast{100};
+  constexpr ChainEpoch kNow{kLast + 2 * kCronProbeEpochs + 8};
+  for (auto epoch : {kNow, kLast + 20, kLast - 10, kNow + 1, kLast + 5, kLast,
+                     kNow + 50}) {
+    enroll(epoch);
+  }
+  tick(kLast, kNow);
+
+  EXPECT_EQ(called, (std::vector<uint8_t>{kLast + 5, kLast + 20, kNow}));
+  for (auto epoch : {kLast + 5, kLast + 20, kNow}) {
+    expectQueued(epoch, false);
+  }
+  for (auto epoch : {kLast - 10, kLast, kNow + 1, kNow + 50}) {
+    expectQueued(epoch, true);
+  }
+}
+
+/**
+ * @given events around short range
+ * @when cron ticks without long gap, epochs are probed
+ * @then same events are called as by catch-up
+ */
+TEST_F(StoragePowerActorTest, ProbeShortRange) {
+  constexpr ChainEpoch kLast{100};
+  constexpr ChainEpoch kNow{kLast + kCronProbeEpochs};
+  for (auto epoch : {kNow, kLast + 3, kLast, kNow + 1}) {
+    enroll(epoch);
+  }
+  tick(kLast, kNow);
+
+  EXPECT_EQ(called, (std::vector<uint8_t>{kLast + 3, kNow}));
+  expectQueued(kLast, true);
+  expectQueued(kLast + 3, false);
+  expectQueued(kNow, false);
+  expectQueued(kNow + 1, true);
+}
@@ -57,3 +57,15 @@ TEST(InvokerTest, EncodeActorParams) {
                        encodeActorParams(fc::CID()));
   EXPECT_OUTCOME_EQ(encodeActorParams(3), MethodParams{"03"_unhex});
 }
+
+/// method table is dense by method number, missing methods are null
+TEST(InvokerTest, MethodTable) {
+  using namespace fc::vm::actor;
+
+  auto table = InvokerImpl::makeMethodTable(builtin::cron::exports);
+  ASSERT_EQ(table.size(), builtin::cron::EpochTick::Number.method_number + 1);
+  EXPECT_FALSE(table[0]);
+  EXPECT_EQ(table[builtin::cron::EpochTick::Number.method_number],
+            builtin::cron::exports.at(builtin::cron::EpochTick::Number));
+  EXPECT_TRUE(InvokerImpl::makeMethodTable({}).empty());
+}
@@ -0,0 +1,130 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/interpreter/impl/interpreter_impl.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/vm/interpreter/interpreter_mock.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::primitives::tipset::Tipset;
+using fc::storage::InMemoryStorage;
+using fc::vm::interpreter::CachedInterpreter;
+using fc::vm::interpreter::InterpreterMock;
+using fc::vm::interpreter::Result;
+using testing::_;
+using testing::Return;
+
+class CachedInterpreterTest : public ::testing::Test {
+ public:
+  Tipset makeTipset(uint64_t height) {
+    Tipset tipset;
+    tipset.cids = {"010001020001"_cid, "010001020002"_cid};
+    tipset.height = height;
+    return tipset;
+  }
+
+  std::shared_ptr<InterpreterMock> mock{std::make_shared<InterpreterMock>()};
+  std::shared_ptr<InMemoryStorage> store{std::make_shared<InMemoryStorage>()};
+  Result result{"010001020003"_cid, "010001020004"_cid};
+};
+
+/**
+ * @given tipsets at different heights
+ * @when make keys
+ * @then keys are ordered by height
+ */
+TEST_F(CachedInterpreterTest, KeyOrderedByHeight) {
+  EXPECT_OUTCOME_TRUE(low, CachedInterpreter::makeKey(makeTipset(2)));
+  EXPECT_OUTCOME_TRUE(high, CachedInterpreter::makeKey(makeTipset(256)));
+  EXPECT_EQ(low.size(), 40);
+  EXPECT_LT(low, high);
+}
+
+/**
+ * @given cached interpreter without memory cache
+ * @when interpret same tipset twice
+ * @then tipset is interpreted once, second result is read from store
+ */
+TEST_F(CachedInterpreterTest, InterpretsOnce) {
+  CachedInterpreter cached{mock, store, {0, 900}};
+  auto tipset = makeTipset(1);
+  EXPECT_CALL(*mock, interpret(_, _)).WillOnce(Return(result));
+
+  EXPECT_OUTCOME_TRUE(first, cached.interpret(nullptr, tipset));
+  EXPECT_OUTCOME_TRUE(second, cached.interpret(nullptr, tipset));
+  EXPECT_EQ(first.state_root, result.state_root);
+  EXPECT_EQ(second.message_receipts, result.message_receipts);
+}
+
+/**
+ * @given cached result
+ * @when prune above its height
+ * @then result is removed from memory and store, and interpreted again
+ */
+TEST_F(CachedInterpreterTest, Prune) {
+  CachedInterpreter cached{mock, store, {8, 900}};
+  auto tipset = makeTipset(1);
+  EXPECT_CALL(*mock, interpret(_, _)).Times(2).WillRepeatedly(Return(result));
+  EXPECT_OUTCOME_TRUE_1(cached.interpret(nullptr, tipset));
+  EXPECT_OUTCOME_TRUE(key, CachedInterpreter::makeKey(tipset));
+  EXPECT_TRUE(store->contains(key));
+
+  cached.prune(2);
+  EXPECT_FALSE(store->contains(key));
+  EXPECT_OUTCOME_TRUE(loaded, cached.interpret(nullptr, tipset));
+  EXPECT_EQ(loaded.state_root, result.state_root);
+}
+
+/**
+ * @given precompute of tipset which does not finish
+ * @when result is requested with deadline
+ * @then tipset is interpreted on calling thread after deadline
+ */
+TEST_F(CachedInterpreterTest, InterpretBeforeDeadline) {
+  CachedInterpreter cached{mock, store, {8, 900}};
+  auto tipset = makeTipset(1);
+  std::promise<void> started, release;
+  auto released = release.get_future().share();
+  EXPECT_CALL(*mock, interpret(_, _))
+      .WillOnce(testing::Invoke(
+          [&](const fc::IpldPtr &,
+              const Tipset &) -> fc::outcome::result<Result> {
+            started.set_value();
+            released.wait();
+            return result;
+          }))
+      .WillOnce(Return(result));
+  cached.precompute(nullptr, tipset);
+  started.get_future().wait();
+
+  EXPECT_OUTCOME_TRUE(
+      late,
+      cached.interpretBefore(nullptr,
+                             tipset,
+                             std::chrono::steady_clock::now()
+                                 + std::chrono::milliseconds{10}));
+  EXPECT_EQ(late.state_root, result.state_root);
+  release.set_value();
+}
+
+/**
+ * @given cached interpreter without memory cache
+ * @when tipset is interpreted
+ * @then its result is reported from store as gc root
+ */
+TEST_F(CachedInterpreterTest, Results) {
+  CachedInterpreter cached{mock, store, {0, 900}};
+  EXPECT_CALL(*mock, interpret(_, _)).WillOnce(Return(result));
+  EXPECT_TRUE(cached.results().empty());
+  EXPECT_OUTCOME_TRUE_1(cached.interpret(nullptr, makeTipset(1)));
+  auto results = cached.results();
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].state_root, result.state_root);
+  EXPECT_EQ(results[0].message_receipts, result.message_receipts);
+}
@@ -0,0 +1,235 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "storage/car/car.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/ipfs/impl/overlay_datastore.hpp"
+#include "vm/interpreter/impl/interpreter_impl.hpp"
+
+using fc::CID;
+using fc::IpldPtr;
+using fc::outcome::result;
+using fc::primitives::tipset::Tipset;
+using fc::storage::car::loadCarFile;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::storage::ipfs::IpfsDatastore;
+using fc::storage::ipfs::OverlayDatastore;
+using fc::vm::interpreter::InterpreterImpl;
+
+namespace {
+  /**
+   * Counts blocks read and written through it, reads of getMany are counted
+   * per block
+   */
+  class CountingDatastore
+      : public IpfsDatastore,
+        public std::enable_shared_from_this<CountingDatastore> {
+   public:
+    explicit CountingDatastore(IpldPtr base) : base_{std::move(base)} {}
+
+    result<bool> contains(const CID &key) const override {
+      return base_->contains(key);
+    }
+
+    result<void> set(const CID &key, Value value) override {
+      ++writes;
+      return base_->set(key, std::move(value));
+    }
+
+    result<void> setMany(Blocks blocks) override {
+      writes += blocks.size();
+      return base_->setMany(std::move(blocks));
+    }
+
+    result<Value> get(const CID &key) const override {
+      ++reads;
+      return base_->get(key);
+    }
+
+    result<std::vector<Value>> getMany(
+        gsl::span<const CID> keys) const override {
+      reads += keys.size();
+      return base_->getMany(keys);
+    }
+
+    result<void> remove(const CID &key) override {
+      return base_->remove(key);
+    }
+
+    IpldPtr shared() override {
+      return shared_from_this();
+    }
+
+    mutable std::atomic_size_t reads{};
+    std::atomic_size_t writes{};
+
+   private:
+    IpldPtr base_;
+  };
+
+  /// Chain segment loaded from CAR, tipsets in ascending height
+  struct Segment {
+    std::shared_ptr<InMemoryDatastore> ipld;
+    std::vector<Tipset> tipsets;
+    /// Messages of each tipset but last, deduplicated
+    std::vector<size_t> messages;
+  };
+
+  /// CAR path and number of interpreted tipsets, set by command line
+  std::string car_path;
+  size_t tipsets_count{10};
+
+  /**
+   * Loads CAR with head tipset as roots, and walks parents of head, so all
+   * but last tipset are interpreted and checked against parent state root
+   * of next one
+   */
+  result<Segment> loadSegment() {
+    Segment segment;
+    segment.ipld = std::make_shared<InMemoryDatastore>();
+    OUTCOME_TRY(roots, loadCarFile(*segment.ipld, car_path));
+    OUTCOME_TRY(head, Tipset::load(*segment.ipld, roots));
+    segment.tipsets.push_back(std::move(head));
+    while (segment.tipsets.size() <= tipsets_count
+           && segment.tipsets.back().height != 0) {
+      OUTCOME_TRY(parent, segment.tipsets.back().loadParent(*segment.ipld));
+      segment.tipsets.push_back(std::move(parent));
+    }
+    std::reverse(segment.tipsets.begin(), segment.tipsets.end());
+    for (size_t i{0}; i + 1 < segment.tipsets.size(); ++i) {
+      size_t messages{0};
+      OUTCOME_TRY(segment.tipsets[i].visitMessages(
+          segment.ipld, [&](auto, auto, auto &) {
+            ++messages;
+            return fc::outcome::success();
+          }));
+      segment.messages.push_back(messages);
+    }
+    return segment;
+  }
+
+  /// Peak resident set size of process
+  int64_t peakRssBytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return int64_t{usage.ru_maxrss} * 1024;
+  }
+
+  /**
+   * Interprets consecutive tipsets of recorded chain segment, writes of each
+   * iteration are buffered in overlay and dropped, so iterations read same
+   * blocks
+   */
+  void interpretSegment(benchmark::State &state) {
+    if (car_path.empty()) {
+      state.SkipWithError("no chain segment, pass --car=<segment.car>");
+      return;
+    }
+    static auto segment{loadSegment()};
+    if (!segment) {
+      state.SkipWithError(("cannot load segment from \"" + car_path
+                           + "\": " + segment.error().message())
+                              .c_str());
+      return;
+    }
+    auto &tipsets{segment.value().tipsets};
+    auto &messages{segment.value().messages};
+    InterpreterImpl interpreter{static_cast<size_t>(state.range(0)),
+                                nullptr,
+                                static_cast<size_t>(state.range(1))};
+    std::vector<double> latencies;
+    size_t total_messages{0};
+    size_t reads{0};
+    size_t writes{0};
+    for (auto _ : state) {
+      auto overlay{std::make_shared<OverlayDatastore>(segment.value().ipld)};
+      auto counting{std::make_shared<CountingDatastore>(overlay)};
+      for (size_t i{0}; i + 1 < tipsets.size(); ++i) {
+        auto start{std::chrono::steady_clock::now()};
+        auto result{interpreter.interpret(counting, tipsets[i])};
+        latencies.push_back(std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start)
+                                .count());
+        if (!result) {
+          state.SkipWithError(
+              ("interpret failed at height " + std::to_string(tipsets[i].height)
+               + ": " + result.error().message())
+                  .c_str());
+          return;
+        }
+        if (result.value().state_root != tipsets[i + 1].getParentStateRoot()) {
+          state.SkipWithError(("state root mismatch at height "
+                               + std::to_string(tipsets[i].height))
+                                  .c_str());
+          return;
+        }
+        total_messages += messages[i];
+      }
+      reads += counting->reads;
+      writes += counting->writes;
+      state.PauseTiming();
+      overlay->discard();
+      state.ResumeTiming();
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile{[&](double p) {
+      if (latencies.empty()) {
+        return 0.0;
+      }
+      return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    }};
+    using benchmark::Counter;
+    state.counters["messages_per_second"] =
+        Counter(total_messages, Counter::kIsRate);
+    state.counters["tipsets"] = tipsets.size() - 1;
+    state.counters["p50_ms"] = percentile(0.5);
+    state.counters["p90_ms"] = percentile(0.9);
+    state.counters["p99_ms"] = percentile(0.99);
+    state.counters["max_ms"] = percentile(1);
+    state.counters["ipld_reads"] =
+        Counter(reads, Counter::kAvgIterations);
+    state.counters["ipld_writes"] =
+        Counter(writes, Counter::kAvgIterations);
+    state.counters["peak_rss_bytes"] = peakRssBytes();
+  }
+}  // namespace
+
+/// Arguments are prefetch threads and execution threads
+BENCHMARK(interpretSegment)
+    ->ArgNames({"prefetch", "execution"})
+    ->Args({fc::vm::interpreter::kDefaultPrefetchThreads, 1})
+    ->Args({fc::vm::interpreter::kDefaultPrefetchThreads, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/**
+ * Usage: interpreter_benchmark --car=<segment.car> [--tipsets=<count>]
+ * [benchmark flags], CAR roots are head tipset, it must contain parent
+ * state of oldest interpreted tipset
+ */
+int main(int argc, char **argv) {
+  std::vector<char *> args;
+  for (auto i{0}; i < argc; ++i) {
+    std::string arg{argv[i]};
+    if (arg.rfind("--car=", 0) == 0) {
+      car_path = arg.substr(6);
+    } else if (arg.rfind("--tipsets=", 0) == 0) {
+      tipsets_count = std::stoul(arg.substr(10));
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+  auto args_count{static_cast<int>(args.size())};
+  benchmark::Initialize(&args_count, args.data());
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/interpreter/message_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/literals.hpp"
+
+using fc::vm::interpreter::MessageCache;
+using fc::vm::interpreter::TipsetKey;
+using fc::vm::interpreter::TipsetMessages;
+
+TipsetKey makeKey(const fc::CID &cid) {
+  return TipsetKey{std::vector<fc::CID>{cid}};
+}
+
+auto makeMessages(const fc::CID &receipts_root) {
+  auto messages{std::make_shared<TipsetMessages>()};
+  messages->cids.push_back("010001020005"_cid);
+  messages->messages.emplace_back();
+  messages->receipts.emplace_back();
+  messages->receipts_root = receipts_root;
+  return messages;
+}
+
+/**
+ * @given cache with capacity of two tipsets
+ * @when insert messages of three tipsets, getting first one meanwhile
+ * @then least recently used second tipset is evicted
+ */
+TEST(MessageCacheTest, Lru) {
+  MessageCache cache{2};
+  auto key1{makeKey("010001020001"_cid)};
+  auto key2{makeKey("010001020002"_cid)};
+  auto key3{makeKey("010001020003"_cid)};
+  auto messages1{makeMessages("010001020004"_cid)};
+  EXPECT_EQ(cache.get(key1), nullptr);
+  cache.insert(key1, messages1);
+  cache.insert(key2, makeMessages("010001020004"_cid));
+  EXPECT_EQ(cache.get(key1), messages1);
+  cache.insert(key3, makeMessages("010001020004"_cid));
+  EXPECT_EQ(cache.get(key1), messages1);
+  EXPECT_EQ(cache.get(key2), nullptr);
+  EXPECT_NE(cache.get(key3), nullptr);
+}
+
+/**
+ * @given cache with messages of tipset
+ * @when insert messages of same tipset again, e.g. after proofs were
+ * verified and tipset applied again
+ * @then later messages replace earlier ones
+ */
+TEST(MessageCacheTest, Replace) {
+  MessageCache cache;
+  auto key{makeKey("010001020001"_cid)};
+  cache.insert(key, makeMessages("010001020004"_cid));
+  auto messages{makeMessages("010001020006"_cid)};
+  cache.insert(key, messages);
+  EXPECT_EQ(cache.get(key), messages);
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/message/secp_message_verifier.hpp"
+
+#include <gtest/gtest.h>
+
+#include "crypto/secp256k1/impl/secp256k1_sha256_provider_impl.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/message/message_util.hpp"
+
+using fc::crypto::secp256k1::Secp256k1Sha256ProviderImpl;
+using fc::primitives::BigInt;
+using fc::primitives::address::Address;
+using fc::vm::message::MethodNumber;
+using fc::vm::message::MethodParams;
+using fc::vm::message::SecpMessageVerifier;
+using fc::vm::message::SignedMessage;
+using fc::vm::message::UnsignedMessage;
+
+struct SecpMessageVerifierTest : public ::testing::Test {
+  SignedMessage makeMessage(uint64_t nonce) {
+    auto key_pair = provider->generate().value();
+    UnsignedMessage message{0,
+                            Address::makeFromId(1),
+                            Address::makeSecp256k1(key_pair.public_key),
+                            nonce,
+                            BigInt{1},
+                            BigInt{0},
+                            1,
+                            MethodNumber{0},
+                            MethodParams{}};
+    auto cid_bytes = fc::vm::message::cid(message).value().toBytes().value();
+    auto signature = provider->sign(cid_bytes, key_pair.private_key).value();
+    return {message, signature};
+  }
+
+  std::shared_ptr<Secp256k1Sha256ProviderImpl> provider{
+      std::make_shared<Secp256k1Sha256ProviderImpl>()};
+  SecpMessageVerifier verifier{provider, 100, 2};
+};
+
+/**
+ * @given secp256k1 signed message
+ * @when verify it twice
+ * @then signer is verified, second time from cache
+ */
+TEST_F(SecpMessageVerifierTest, VerifyCached) {
+  auto message = makeMessage(0);
+  EXPECT_OUTCOME_EQ(verifier.verify(message.message.from, message), true);
+  EXPECT_OUTCOME_EQ(verifier.verify(message.message.from, message), true);
+  EXPECT_OUTCOME_EQ(verifier.verify(makeMessage(1).message.from, message),
+                    false);
+  auto stats = verifier.stats();
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+}
+
+/**
+ * @given batch of signed messages, one of them tampered
+ * @when recover signers of batch on thread pool
+ * @then signers match senders except tampered message
+ */
+TEST_F(SecpMessageVerifierTest, RecoverBatch) {
+  std::vector<SignedMessage> messages;
+  auto count = 2 * SecpMessageVerifier::kMinParallelRecover;
+  for (uint64_t nonce = 0; nonce < count; ++nonce) {
+    messages.push_back(makeMessage(nonce));
+  }
+  messages[3].message.nonce = 100;
+  auto keys = verifier.recoverPublicKeys(messages);
+  ASSERT_EQ(keys.size(), messages.size());
+  for (size_t i = 0; i < messages.size(); ++i) {
+    auto valid =
+        keys[i] && messages[i].message.from.verifySyntax(keys[i].value());
+    EXPECT_EQ(valid, i != 3);
+  }
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/counting_datastore.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::actor::kStorageMinerCodeCid;
+using fc::vm::runtime::CountingDatastore;
+using fc::vm::runtime::IpldCounter;
+using fc::vm::runtime::Profiler;
+
+/**
+ * @given datastore counting into execution counter
+ * @when write block and read it twice
+ * @then blocks and bytes are counted, repeated reads are cache hits
+ */
+TEST(CountingDatastoreTest, Counts) {
+  auto counter = std::make_shared<IpldCounter>();
+  auto ipld = std::make_shared<CountingDatastore>(
+      std::make_shared<InMemoryDatastore>(), counter);
+  EXPECT_OUTCOME_TRUE(cid, ipld->setCbor(std::string{"abc"}));
+  EXPECT_OUTCOME_EQ(ipld->getCbor<std::string>(cid), "abc");
+  EXPECT_OUTCOME_TRUE_1(ipld->getCbor<std::string>(cid));
+
+  auto &stats = counter->stats();
+  EXPECT_EQ(stats.writes, 1);
+  EXPECT_EQ(stats.write_bytes, 4);
+  EXPECT_EQ(stats.reads, 2);
+  EXPECT_EQ(stats.read_bytes, 8);
+  EXPECT_EQ(stats.cache_hits, 2);
+  EXPECT_EQ(stats.hitRate(), 1);
+}
+
+/**
+ * @given profiled execution counter
+ * @when method reads block
+ * @then read is recorded for method too
+ */
+TEST(CountingDatastoreTest, Profiled) {
+  auto profiler = std::make_shared<Profiler>();
+  auto stack = std::make_shared<Profiler::Stack>(profiler);
+  auto store = std::make_shared<InMemoryDatastore>();
+  EXPECT_OUTCOME_TRUE(cid, store->setCbor(std::string{"abc"}));
+  auto ipld = std::make_shared<CountingDatastore>(
+      store, std::make_shared<IpldCounter>(stack));
+  {
+    Profiler::Scope miner{stack, kStorageMinerCodeCid, 5};
+    EXPECT_OUTCOME_TRUE_1(ipld->getCbor<std::string>(cid));
+  }
+
+  auto methods = profiler->methods();
+  ASSERT_EQ(methods.size(), 1);
+  EXPECT_EQ(methods[0].ipld.reads, 1);
+  EXPECT_EQ(methods[0].ipld.read_bytes, 4);
+  EXPECT_EQ(methods[0].ipld.cache_hits, 0);
+}
@@ -0,0 +1,60 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/profiler.hpp"
+
+#include <gtest/gtest.h>
+
+using fc::vm::actor::kInitCodeCid;
+using fc::vm::actor::kStorageMinerCodeCid;
+using fc::vm::runtime::Profiler;
+
+class ProfilerTest : public ::testing::Test {
+ public:
+  std::shared_ptr<Profiler> profiler{std::make_shared<Profiler>()};
+  std::shared_ptr<Profiler::Stack> stack{
+      std::make_shared<Profiler::Stack>(profiler)};
+};
+
+/**
+ * @given method sending to other method
+ * @when both methods return
+ * @then gas is attributed to method on top of stack, stacks are folded
+ */
+TEST_F(ProfilerTest, NestedCalls) {
+  stack->gas(100);
+  {
+    Profiler::Scope miner{stack, kStorageMinerCodeCid, 5};
+    stack->gas(10);
+    {
+      Profiler::Scope init{stack, kInitCodeCid, 2};
+      stack->gas(3);
+    }
+    stack->gas(20);
+  }
+
+  auto methods = profiler->methods();
+  ASSERT_EQ(methods.size(), 2);
+  for (auto &method : methods) {
+    EXPECT_EQ(method.calls, 1);
+    EXPECT_GE(method.total_time, method.self_time);
+    if (method.code == kStorageMinerCodeCid) {
+      EXPECT_EQ(method.method, 5);
+      EXPECT_EQ(method.gas, 30);
+    } else {
+      EXPECT_EQ(method.code, kInitCodeCid);
+      EXPECT_EQ(method.gas, 3);
+    }
+  }
+
+  auto folded = profiler->folded();
+  EXPECT_NE(folded.find("fil/1/storageminer:5 "), std::string::npos);
+  EXPECT_NE(folded.find("fil/1/storageminer:5;fil/1/init:2 "),
+            std::string::npos);
+
+  profiler->reset();
+  EXPECT_TRUE(profiler->methods().empty());
+  EXPECT_TRUE(profiler->folded().empty());
+}
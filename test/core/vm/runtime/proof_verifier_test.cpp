@@ -0,0 +1,119 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/proof_verifier.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/outcome.hpp"
+
+using fc::outcome::result;
+using fc::primitives::sector::SealVerifyInfo;
+using fc::primitives::sector::WindowPoStVerifyInfo;
+using fc::vm::runtime::ProofVerifier;
+
+class ProofVerifierTest : public ::testing::Test {
+ public:
+  /// Fake batch verification, seals with odd sector number are invalid
+  ProofVerifier::SealBatchFunction seals() {
+    return [this](auto infos) {
+      seal_batches.push_back(infos.size());
+      std::vector<result<bool>> results;
+      for (auto &info : infos) {
+        results.push_back(info.sector.sector % 2 == 0);
+      }
+      return results;
+    };
+  }
+
+  /// Fake batch verification, PoSts of odd prover are invalid
+  ProofVerifier::PoStBatchFunction posts() {
+    return [this](auto infos) {
+      post_batches.push_back(infos.size());
+      std::vector<result<bool>> results;
+      for (auto &info : infos) {
+        results.push_back(info.prover % 2 == 0);
+      }
+      return results;
+    };
+  }
+
+  SealVerifyInfo seal(uint64_t number) {
+    SealVerifyInfo info;
+    info.sector.miner = 1000;
+    info.sector.sector = number;
+    return info;
+  }
+
+  WindowPoStVerifyInfo post(uint64_t prover) {
+    WindowPoStVerifyInfo info{};
+    info.prover = prover;
+    return info;
+  }
+
+  std::vector<size_t> seal_batches, post_batches;
+};
+
+/**
+ * @given speculating verifier
+ * @when verify proofs, then verify recorded proofs
+ * @then proofs are assumed valid and verified in one batch per kind
+ */
+TEST_F(ProofVerifierTest, Speculate) {
+  ProofVerifier verifier{seals(), posts()};
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(0)), true);
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(2)), true);
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(2)), true);
+  EXPECT_OUTCOME_EQ(verifier.verifyPoSt(post(1000)), true);
+  EXPECT_TRUE(seal_batches.empty());
+
+  EXPECT_TRUE(verifier.verifyRecorded());
+  EXPECT_FALSE(verifier.speculating());
+  EXPECT_EQ(seal_batches, (std::vector<size_t>{2}));
+  EXPECT_EQ(post_batches, (std::vector<size_t>{1}));
+}
+
+/**
+ * @given invalid seal recorded while speculating
+ * @when verify recorded proofs
+ * @then speculation is wrong, invalid seal is known afterwards
+ */
+TEST_F(ProofVerifierTest, Mispredicted) {
+  ProofVerifier verifier{seals(), posts()};
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(0)), true);
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(1)), true);
+  EXPECT_FALSE(verifier.verifyRecorded());
+
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(0)), true);
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(1)), false);
+  EXPECT_EQ(seal_batches, (std::vector<size_t>{2}));
+}
+
+/**
+ * @given invalid window PoSt recorded while speculating
+ * @when verify recorded proofs
+ * @then speculation is wrong, memoized verdict is returned afterwards
+ */
+TEST_F(ProofVerifierTest, MispredictedPoSt) {
+  ProofVerifier verifier{seals(), posts()};
+  EXPECT_OUTCOME_EQ(verifier.verifyPoSt(post(1001)), true);
+  EXPECT_FALSE(verifier.verifyRecorded());
+
+  EXPECT_OUTCOME_EQ(verifier.verifyPoSt(post(1001)), false);
+  EXPECT_EQ(post_batches, (std::vector<size_t>{1}));
+}
+
+/**
+ * @given verifier after speculation
+ * @when verify seal not recorded while speculating
+ * @then seal is verified directly
+ */
+TEST_F(ProofVerifierTest, Unknown) {
+  ProofVerifier verifier{seals(), posts()};
+  EXPECT_TRUE(verifier.verifyRecorded());
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(3)), false);
+  EXPECT_OUTCOME_EQ(verifier.verifySeal(seal(3)), false);
+  EXPECT_EQ(seal_batches, (std::vector<size_t>{1}));
+}
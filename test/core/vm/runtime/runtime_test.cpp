@@ -148,8 +148,10 @@ TEST_F(RuntimeTest, send) {
   Actor to_actor{fc::vm::actor::kAccountCodeCid, ActorSubstateCID{}, 0, 0};
   InvocationOutput res{};
 
-  EXPECT_CALL(*state_tree_, flush())
-      .WillOnce(testing::Return("010001020001"_cid));
+  EXPECT_CALL(*state_tree_, snapshot())
+      .WillOnce(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(*state_tree_, clearSnapshot())
+      .WillOnce(testing::Return(fc::outcome::success()));
   EXPECT_CALL(*state_tree_, get(Eq(to_address)))
       .WillRepeatedly(testing::Return(fc::outcome::success(to_actor)));
   EXPECT_CALL(*state_tree_, set(Eq(to_address), _))
@@ -162,6 +164,48 @@ TEST_F(RuntimeTest, send) {
   EXPECT_OUTCOME_TRUE_1(runtime_->send(to_address, method, params, amount));
 }
 
+/**
+ * @given Env with tracing
+ * @when send() is called
+ * @then send is traced with exit code and gas
+ */
+TEST_F(RuntimeTest, sendTraced) {
+  Address to_address{fc::primitives::address::TESTNET, 345};
+  MethodNumber method{123};
+  Actor to_actor{fc::vm::actor::kAccountCodeCid, ActorSubstateCID{}, 0, 0};
+
+  auto env =
+      std::make_shared<Env>(randomness_provider_, state_tree_, invoker_, 0);
+  env->tracing = true;
+  RuntimeImpl runtime{Execution::make(env, message_),
+                      message_,
+                      message_.from,
+                      ActorSubstateCID{"010001020001"_cid}};
+
+  EXPECT_CALL(*state_tree_, snapshot())
+      .WillOnce(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(*state_tree_, clearSnapshot())
+      .WillOnce(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(*state_tree_, get(Eq(to_address)))
+      .WillRepeatedly(testing::Return(fc::outcome::success(to_actor)));
+  EXPECT_CALL(*state_tree_, set(Eq(to_address), _))
+      .WillRepeatedly(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(*state_tree_, lookupId(Eq(message_.to)))
+      .WillRepeatedly(testing::Return(fc::outcome::success(message_.to)));
+  EXPECT_CALL(*invoker_, invoke(Eq(to_actor), _, Eq(method), _))
+      .WillOnce(testing::Return(fc::outcome::success(InvocationOutput{})));
+
+  EXPECT_OUTCOME_TRUE_1(runtime.send(to_address, method, {}, 0));
+  ASSERT_EQ(env->traces.size(), 1);
+  auto &trace = env->traces[0];
+  EXPECT_EQ(trace.message.to, to_address);
+  EXPECT_EQ(trace.message.method, method);
+  EXPECT_EQ(trace.receipt.exit_code, VMExitCode::Ok);
+  EXPECT_GT(trace.receipt.gas_used, 0);
+  EXPECT_TRUE(trace.subcalls.empty());
+  EXPECT_TRUE(trace.error.empty());
+}
+
 /**
  * @given Runtime with actors and sender balance is zero
  * @when send() is called with transfer
@@ -176,9 +220,9 @@ TEST_F(RuntimeTest, sendNotEnoughFunds) {
   Actor from_actor{fc::vm::actor::kInitCodeCid, ActorSubstateCID{}, 0, 0};
   Actor to_actor{fc::vm::actor::kInitCodeCid, ActorSubstateCID{}, 0, 0};
 
-  auto snapshot = "010001020001"_cid;
-  EXPECT_CALL(*state_tree_, flush()).WillOnce(testing::Return(snapshot));
-  EXPECT_CALL(*state_tree_, revert(snapshot))
+  EXPECT_CALL(*state_tree_, snapshot())
+      .WillOnce(testing::Return(fc::outcome::success()));
+  EXPECT_CALL(*state_tree_, revertSnapshot())
       .WillOnce(testing::Return(fc::outcome::success()));
   EXPECT_CALL(*state_tree_, get(Eq(message_.to)))
       .WillOnce(testing::Return(fc::outcome::success(from_actor)));
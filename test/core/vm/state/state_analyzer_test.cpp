@@ -0,0 +1,105 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/state/state_analyzer.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/amt/amt.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/state/impl/state_tree_impl.hpp"
+
+using fc::CID;
+using fc::storage::amt::Amt;
+using fc::storage::ipfs::InMemoryDatastore;
+using fc::vm::actor::ActorSubstateCID;
+using fc::vm::actor::CodeId;
+using fc::vm::state::Actor;
+using fc::vm::state::Address;
+using fc::vm::state::DagKind;
+using fc::vm::state::StateTreeImpl;
+
+class StateAnalyzerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    Amt amt{ipld};
+    for (auto i{0}; i < 20; ++i) {
+      EXPECT_OUTCOME_TRUE_1(amt.setCbor(i, i));
+    }
+    EXPECT_OUTCOME_TRUE(amt_root, amt.flush());
+    EXPECT_OUTCOME_TRUE(head, ipld->setCbor(std::vector<CID>{amt_root}));
+    EXPECT_OUTCOME_TRUE(empty, ipld->setCbor(std::vector<CID>{}));
+    amt_head = head;
+    empty_head = empty;
+  }
+
+  /// State with actor 1 linking amt and actor 2 with given head
+  CID makeState(const CID &head2) {
+    StateTreeImpl tree{ipld};
+    EXPECT_OUTCOME_TRUE_1(tree.set(Address::makeFromId(1), actor(amt_head)));
+    EXPECT_OUTCOME_TRUE_1(tree.set(Address::makeFromId(2), actor(head2)));
+    EXPECT_OUTCOME_TRUE(root, tree.flush());
+    return root;
+  }
+
+  static Actor actor(const CID &head) {
+    return {CodeId{"010001020001"_cid}, ActorSubstateCID{head}, 0, 0};
+  }
+
+  std::shared_ptr<InMemoryDatastore> ipld{
+      std::make_shared<InMemoryDatastore>()};
+  CID amt_head, empty_head;
+};
+
+/**
+ * @given state with actor linking amt and actor with empty state
+ * @when analyze state
+ * @then actors are sorted by state size and amt is reported as embedded
+ */
+TEST_F(StateAnalyzerTest, Analyze) {
+  auto root{makeState(empty_head)};
+  EXPECT_OUTCOME_TRUE(shape, fc::vm::state::analyzeState(ipld, root));
+  EXPECT_EQ(shape.actors_hamt.kind, DagKind::HAMT);
+  EXPECT_EQ(shape.actors_hamt.blocks, 1);
+  EXPECT_EQ(shape.actors_hamt.entries, 2);
+  ASSERT_EQ(shape.actors.size(), 2);
+
+  auto &large{shape.actors[0]};
+  EXPECT_EQ(large.address, Address::makeFromId(1));
+  ASSERT_EQ(large.embedded.size(), 1);
+  auto &amt{large.embedded[0].shape};
+  EXPECT_EQ(amt.kind, DagKind::AMT);
+  EXPECT_EQ(amt.entries, 20);
+  EXPECT_EQ(amt.blocks, 4);
+  EXPECT_EQ(amt.depth, 2);
+  EXPECT_EQ(large.state.blocks, amt.blocks + 1);
+
+  auto &small{shape.actors[1]};
+  EXPECT_EQ(small.address, Address::makeFromId(2));
+  EXPECT_EQ(small.state.blocks, 1);
+  EXPECT_TRUE(small.embedded.empty());
+}
+
+/**
+ * @given two states where one actor head changes to head linking amt
+ * @when diff states
+ * @then only changed actor is reported, with its old head removed and new
+ * head and amt added
+ */
+TEST_F(StateAnalyzerTest, Diff) {
+  auto before{makeState(empty_head)};
+  auto after{makeState(amt_head)};
+  EXPECT_OUTCOME_TRUE(diff,
+                      fc::vm::state::diffStateShape(ipld, before, after));
+  EXPECT_EQ(diff.actors_added, 0);
+  EXPECT_EQ(diff.actors_removed, 0);
+  EXPECT_EQ(diff.actors_changed, 1);
+  ASSERT_EQ(diff.actors.size(), 1);
+  EXPECT_EQ(diff.actors[0].address, Address::makeFromId(2));
+  EXPECT_EQ(diff.actors[0].blocks_added, 5);
+  EXPECT_EQ(diff.actors[0].blocks_removed, 1);
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/state/impl/state_tree_overlay.hpp"
+
+#include <gtest/gtest.h>
+#include "testutil/init_actor.hpp"
+
+using fc::primitives::BigInt;
+using fc::primitives::address::Address;
+using fc::storage::hamt::HamtError;
+using fc::vm::actor::Actor;
+using fc::vm::actor::ActorSubstateCID;
+using fc::vm::actor::CodeId;
+using fc::vm::actor::kInitAddress;
+using fc::vm::state::StateTreeError;
+using fc::vm::state::StateTreeOverlay;
+
+auto kAddressId = Address::makeFromId(13);
+const Actor kActor{CodeId{"010001020001"_cid},
+                   ActorSubstateCID{"010001020002"_cid},
+                   3,
+                   BigInt(5)};
+
+class StateTreeOverlayTest : public ::testing::Test {
+ public:
+  std::shared_ptr<fc::vm::state::StateTree> base_{setupInitActor(nullptr, 13)};
+  StateTreeOverlay overlay_{base_};
+};
+
+/**
+ * @given Overlay of state tree
+ * @when Register new address, set its actor state and apply overlay
+ * @then Base tree is changed only after apply, init actor read is recorded
+ */
+TEST_F(StateTreeOverlayTest, Apply) {
+  Address address{fc::primitives::address::TESTNET,
+                  fc::primitives::address::ActorExecHash{}};
+  EXPECT_OUTCOME_EQ(overlay_.registerNewAddress(address), kAddressId);
+  EXPECT_OUTCOME_TRUE_1(overlay_.set(address, kActor));
+  EXPECT_OUTCOME_EQ(overlay_.get(address), kActor);
+  EXPECT_OUTCOME_ERROR(HamtError::NOT_FOUND, base_->get(kAddressId));
+  EXPECT_EQ(overlay_.reads().count(kInitAddress), 1);
+  EXPECT_EQ(overlay_.writes().size(), 2);
+
+  EXPECT_OUTCOME_TRUE_1(overlay_.apply(*base_));
+  EXPECT_OUTCOME_EQ(base_->lookupId(address), kAddressId);
+  EXPECT_OUTCOME_EQ(base_->get(kAddressId), kActor);
+}
+
+/**
+ * @given Overlay with changed actor and nested snapshot
+ * @when Change actor again and revert snapshot
+ * @then Overlay has first change, reads are recorded
+ */
+TEST_F(StateTreeOverlayTest, SnapshotRevert) {
+  auto actor2 = kActor;
+  actor2.nonce = 4;
+  auto address_id2 = Address::makeFromId(14);
+  EXPECT_OUTCOME_ERROR(HamtError::NOT_FOUND, overlay_.get(kAddressId));
+  EXPECT_OUTCOME_TRUE_1(overlay_.set(kAddressId, kActor));
+  EXPECT_OUTCOME_TRUE_1(overlay_.snapshot());
+  EXPECT_OUTCOME_TRUE_1(overlay_.set(kAddressId, actor2));
+  EXPECT_OUTCOME_TRUE_1(overlay_.set(address_id2, kActor));
+  EXPECT_OUTCOME_TRUE_1(overlay_.revertSnapshot());
+  EXPECT_OUTCOME_EQ(overlay_.get(kAddressId), kActor);
+  EXPECT_OUTCOME_ERROR(HamtError::NOT_FOUND, overlay_.get(address_id2));
+  EXPECT_EQ(overlay_.writes().size(), 1);
+  EXPECT_EQ(overlay_.reads().count(address_id2), 1);
+}
+
+/**
+ * @given Overlay of state tree
+ * @when Flush overlay
+ * @then Error returned, changes must be applied to other tree
+ */
+TEST_F(StateTreeOverlayTest, FlushNotSupported) {
+  EXPECT_OUTCOME_ERROR(StateTreeError::NOT_SUPPORTED, overlay_.flush());
+}
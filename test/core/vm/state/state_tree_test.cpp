@@ -16,6 +16,7 @@ using fc::storage::hamt::HamtError;
 using fc::vm::actor::Actor;
 using fc::vm::actor::ActorSubstateCID;
 using fc::vm::actor::CodeId;
+using fc::vm::state::StateTreeError;
 using fc::vm::state::StateTreeImpl;
 
 auto kAddressId = Address::makeFromId(13);
@@ -78,3 +79,84 @@ TEST_F(StateTreeTest, RegisterNewAddressLookupId) {
   EXPECT_OUTCOME_EQ(tree->registerNewAddress(address), kAddressId);
   EXPECT_OUTCOME_EQ(tree->lookupId(address), kAddressId);
 }
+
+/**
+ * @given State tree with actor state and nested snapshots
+ * @when Revert inner snapshot and clear outer one
+ * @then Only changes made in inner snapshot are undone
+ */
+TEST_F(StateTreeTest, SnapshotRevertNested) {
+  auto actor2 = kActor;
+  actor2.nonce = 4;
+  auto address_id2 = Address::makeFromId(14);
+  EXPECT_OUTCOME_TRUE_1(tree_.set(kAddressId, kActor));
+  EXPECT_OUTCOME_TRUE_1(tree_.snapshot());
+  EXPECT_OUTCOME_TRUE_1(tree_.set(kAddressId, actor2));
+  EXPECT_OUTCOME_TRUE_1(tree_.snapshot());
+  EXPECT_OUTCOME_TRUE_1(tree_.set(kAddressId, kActor));
+  EXPECT_OUTCOME_TRUE_1(tree_.set(address_id2, kActor));
+  EXPECT_OUTCOME_TRUE_1(tree_.revertSnapshot());
+  EXPECT_OUTCOME_EQ(tree_.get(kAddressId), actor2);
+  EXPECT_OUTCOME_ERROR(HamtError::NOT_FOUND, tree_.get(address_id2));
+  EXPECT_OUTCOME_TRUE_1(tree_.clearSnapshot());
+  EXPECT_OUTCOME_EQ(tree_.get(kAddressId), actor2);
+}
+
+/**
+ * @given Flushed state tree and snapshot
+ * @when Set actor states and revert snapshot
+ * @then Flushed root is same as before snapshot
+ */
+TEST_F(StateTreeTest, SnapshotRevertSameRoot) {
+  EXPECT_OUTCOME_TRUE_1(tree_.set(kAddressId, kActor));
+  EXPECT_OUTCOME_TRUE(root, tree_.flush());
+  EXPECT_OUTCOME_TRUE_1(tree_.snapshot());
+  EXPECT_OUTCOME_TRUE_1(tree_.set(Address::makeFromId(14), kActor));
+  EXPECT_OUTCOME_TRUE_1(tree_.revertSnapshot());
+  EXPECT_OUTCOME_EQ(tree_.flush(), root);
+}
+
+/**
+ * @given State tree without snapshots
+ * @when Revert or clear snapshot
+ * @then Error returned
+ */
+TEST_F(StateTreeTest, NoSnapshot) {
+  EXPECT_OUTCOME_ERROR(StateTreeError::NO_SNAPSHOT, tree_.revertSnapshot());
+  EXPECT_OUTCOME_ERROR(StateTreeError::NO_SNAPSHOT, tree_.clearSnapshot());
+}
+
+/**
+ * @given Flushed state tree with registered address
+ * @when Another tree of same root changes actor and registration is reverted
+ * @then Trees of root resolve address and read actor as in root
+ */
+TEST_F(StateTreeTest, RootCache) {
+  auto tree = setupInitActor(nullptr, 13);
+  Address address{fc::primitives::address::TESTNET,
+                  fc::primitives::address::ActorExecHash{}};
+  EXPECT_OUTCOME_TRUE_1(tree->registerNewAddress(address));
+  EXPECT_OUTCOME_TRUE_1(tree->set(address, kActor));
+  EXPECT_OUTCOME_TRUE(root, tree->flush());
+
+  auto actor2 = kActor;
+  actor2.nonce = 4;
+  StateTreeImpl tree1{tree->getStore(), root};
+  EXPECT_OUTCOME_EQ(tree1.get(address), kActor);
+  EXPECT_OUTCOME_TRUE_1(tree1.set(address, actor2));
+  EXPECT_OUTCOME_EQ(tree1.get(kAddressId), actor2);
+
+  fc::primitives::address::ActorExecHash hash2;
+  hash2[0] = 1;
+  Address address2{fc::primitives::address::TESTNET, hash2};
+  EXPECT_OUTCOME_TRUE_1(tree1.snapshot());
+  EXPECT_OUTCOME_TRUE_1(tree1.registerNewAddress(address2));
+  EXPECT_OUTCOME_TRUE_1(tree1.lookupId(address2));
+  EXPECT_OUTCOME_TRUE_1(tree1.revertSnapshot());
+  EXPECT_OUTCOME_ERROR(HamtError::NOT_FOUND, tree1.lookupId(address2));
+
+  StateTreeImpl tree2{tree->getStore(), root};
+  EXPECT_OUTCOME_EQ(tree2.lookupId(address), kAddressId);
+  EXPECT_OUTCOME_EQ(tree2.get(address), kActor);
+  EXPECT_OUTCOME_ERROR(HamtError::NOT_FOUND, tree2.lookupId(address2));
+}
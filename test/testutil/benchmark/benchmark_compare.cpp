@@ -0,0 +1,196 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "testutil/benchmark/benchmark_compare.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <set>
+
+#include <rapidjson/document.h>
+
+OUTCOME_CPP_DEFINE_CATEGORY(fc::benchmark, BenchmarkCompareError, e) {
+  using E = fc::benchmark::BenchmarkCompareError;
+  switch (e) {
+    case E::INVALID_JSON:
+      return "Invalid benchmark json";
+    case E::NO_BENCHMARKS:
+      return "No benchmarks in json";
+  }
+  return "Unknown error";
+}
+
+namespace fc::benchmark {
+  namespace {
+    double nanoseconds(const std::string &unit) {
+      if (unit == "us") {
+        return 1e3;
+      }
+      if (unit == "ms") {
+        return 1e6;
+      }
+      if (unit == "s") {
+        return 1e9;
+      }
+      return 1;
+    }
+
+    std::string string(const rapidjson::Value &object, const char *key) {
+      auto it{object.FindMember(key)};
+      if (it == object.MemberEnd() || !it->value.IsString()) {
+        return {};
+      }
+      return it->value.GetString();
+    }
+
+    boost::optional<double> number(const rapidjson::Value &object,
+                                   const char *key) {
+      auto it{object.FindMember(key)};
+      if (it == object.MemberEnd() || !it->value.IsNumber()) {
+        return boost::none;
+      }
+      return it->value.GetDouble();
+    }
+  }  // namespace
+
+  bool Report::regressed() const {
+    if (!failed.empty()) {
+      return true;
+    }
+    for (const auto &comparison : comparisons) {
+      if (comparison.regressed) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  outcome::result<Measurements> parseMeasurements(const std::string &json) {
+    rapidjson::Document document;
+    document.Parse(json.data(), json.size());
+    if (document.HasParseError() || !document.IsObject()) {
+      return BenchmarkCompareError::INVALID_JSON;
+    }
+    auto benchmarks{document.FindMember("benchmarks")};
+    if (benchmarks == document.MemberEnd() || !benchmarks->value.IsArray()) {
+      return BenchmarkCompareError::INVALID_JSON;
+    }
+    Measurements measurements;
+    // medians replace single repetitions of same benchmark
+    std::set<std::string> medians;
+    for (const auto &benchmark : benchmarks->value.GetArray()) {
+      if (!benchmark.IsObject()) {
+        return BenchmarkCompareError::INVALID_JSON;
+      }
+      auto name{string(benchmark, "name")};
+      if (string(benchmark, "run_type") == "aggregate") {
+        if (string(benchmark, "aggregate_name") != "median") {
+          continue;
+        }
+        name = string(benchmark, "run_name");
+        medians.insert(name);
+      } else if (medians.count(name) != 0) {
+        continue;
+      }
+      if (name.empty()) {
+        return BenchmarkCompareError::INVALID_JSON;
+      }
+      Measurement measurement;
+      auto error{benchmark.FindMember("error_occurred")};
+      measurement.failed = error != benchmark.MemberEnd()
+                           && error->value.IsBool() && error->value.GetBool();
+      measurement.real_time_ns = number(benchmark, "real_time").value_or(0)
+                                 * nanoseconds(string(benchmark, "time_unit"));
+      measurement.items_per_second = number(benchmark, "items_per_second");
+      measurement.bytes_per_second = number(benchmark, "bytes_per_second");
+      measurements[name] = measurement;
+    }
+    if (measurements.empty()) {
+      return BenchmarkCompareError::NO_BENCHMARKS;
+    }
+    return measurements;
+  }
+
+  Report compare(const Measurements &baseline,
+                 const Measurements &current,
+                 const Thresholds &thresholds) {
+    Report report;
+    for (const auto &[name, before] : baseline) {
+      if (current.count(name) == 0) {
+        report.missing.push_back(name);
+      }
+    }
+    for (const auto &[name, after] : current) {
+      if (after.failed) {
+        report.failed.push_back(name);
+        continue;
+      }
+      auto it{baseline.find(name)};
+      if (it == baseline.end()) {
+        report.added.push_back(name);
+        continue;
+      }
+      const auto &before{it->second};
+      if (before.real_time_ns != 0) {
+        report.comparisons.push_back(
+            {name,
+             "time",
+             before.real_time_ns,
+             after.real_time_ns,
+             after.real_time_ns
+                 > before.real_time_ns * (1 + thresholds.time)});
+      }
+      auto throughput{[&](const char *metric,
+                          const boost::optional<double> &was,
+                          const boost::optional<double> &now) {
+        if (was && now && *was != 0) {
+          report.comparisons.push_back(
+              {name,
+               metric,
+               *was,
+               *now,
+               *now < *was * (1 - thresholds.throughput)});
+        }
+      }};
+      throughput("items/s", before.items_per_second, after.items_per_second);
+      throughput("bytes/s", before.bytes_per_second, after.bytes_per_second);
+    }
+    return report;
+  }
+
+  void print(std::ostream &os, const Report &report) {
+    size_t width{4};
+    for (const auto &comparison : report.comparisons) {
+      width = std::max(width, comparison.name.size());
+    }
+    auto flags{os.flags()};
+    os << std::left << std::setw(width) << "name"
+       << "  metric   " << std::right << std::setw(14) << "baseline"
+       << std::setw(14) << "current" << std::setw(9) << "change" << std::endl;
+    for (const auto &comparison : report.comparisons) {
+      os << std::left << std::setw(width) << comparison.name << "  "
+         << std::setw(9) << comparison.metric << std::right
+         << std::setprecision(6) << std::setw(14) << comparison.baseline
+         << std::setw(14) << comparison.current << std::setw(8)
+         << std::showpos << std::fixed << std::setprecision(1)
+         << comparison.change() * 100 << "%" << std::noshowpos
+         << std::defaultfloat;
+      if (comparison.regressed) {
+        os << "  REGRESSED";
+      }
+      os << std::endl;
+    }
+    for (const auto &name : report.failed) {
+      os << "FAILED " << name << std::endl;
+    }
+    for (const auto &name : report.missing) {
+      os << "not run " << name << std::endl;
+    }
+    for (const auto &name : report.added) {
+      os << "no baseline " << name << std::endl;
+    }
+    os.flags(flags);
+  }
+}  // namespace fc::benchmark
@@ -0,0 +1,88 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_TEST_TESTUTIL_BENCHMARK_COMPARE_HPP
+#define CPP_FILECOIN_TEST_TESTUTIL_BENCHMARK_COMPARE_HPP
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "common/outcome.hpp"
+
+namespace fc::benchmark {
+  enum class BenchmarkCompareError {
+    INVALID_JSON = 1,
+    NO_BENCHMARKS,
+  };
+
+  /// Result of one benchmark from google benchmark json output
+  struct Measurement {
+    /// Wall time per iteration
+    double real_time_ns{};
+    boost::optional<double> items_per_second;
+    boost::optional<double> bytes_per_second;
+    /// Benchmark reported error, e.g. skipped with SkipWithError
+    bool failed{false};
+  };
+
+  using Measurements = std::map<std::string, Measurement>;
+
+  /// Allowed relative regressions, e.g. 0.1 is 10%
+  struct Thresholds {
+    /// Time per iteration may grow by this ratio
+    double time{0.1};
+    /// Items and bytes per second may drop by this ratio
+    double throughput{0.1};
+  };
+
+  /// Comparison of one metric of benchmark
+  struct Comparison {
+    std::string name;
+    /// "time", "items/s" or "bytes/s"
+    std::string metric;
+    double baseline{};
+    double current{};
+    bool regressed{false};
+
+    /// Relative change, positive is slower time or higher throughput
+    double change() const {
+      return baseline == 0 ? 0 : current / baseline - 1;
+    }
+  };
+
+  struct Report {
+    std::vector<Comparison> comparisons;
+    /// Benchmarks of baseline not run, e.g. filtered out
+    std::vector<std::string> missing;
+    /// Benchmarks without baseline yet
+    std::vector<std::string> added;
+    /// Benchmarks which reported error
+    std::vector<std::string> failed;
+
+    bool regressed() const;
+  };
+
+  /**
+   * Parses google benchmark json output. With repetitions only median
+   * aggregates are used, other aggregates are ignored.
+   */
+  outcome::result<Measurements> parseMeasurements(const std::string &json);
+
+  /// Compares time and throughput counters of benchmarks present in both
+  Report compare(const Measurements &baseline,
+                 const Measurements &current,
+                 const Thresholds &thresholds);
+
+  /// Writes table of comparisons, regressed rows are marked
+  void print(std::ostream &os, const Report &report);
+}  // namespace fc::benchmark
+
+OUTCOME_HPP_DECLARE_ERROR(fc::benchmark, BenchmarkCompareError);
+
+#endif  // CPP_FILECOIN_TEST_TESTUTIL_BENCHMARK_COMPARE_HPP
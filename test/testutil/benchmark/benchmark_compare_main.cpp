@@ -0,0 +1,78 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "testutil/benchmark/benchmark_compare.hpp"
+
+using fc::benchmark::compare;
+using fc::benchmark::Measurements;
+using fc::benchmark::parseMeasurements;
+using fc::benchmark::Thresholds;
+
+fc::outcome::result<Measurements> load(const std::string &path) {
+  std::ifstream file{path};
+  if (!file.good()) {
+    std::cerr << "cannot open " << path << std::endl;
+    return fc::benchmark::BenchmarkCompareError::INVALID_JSON;
+  }
+  std::stringstream json;
+  json << file.rdbuf();
+  return parseMeasurements(json.str());
+}
+
+/**
+ * Compares google benchmark json output with baseline, exits with 1 if
+ * time or throughput of any benchmark regressed beyond threshold, given in
+ * percents.
+ * Usage: benchmark_compare [--time-threshold <percent>]
+ *   [--throughput-threshold <percent>] <baseline json> <current json>
+ */
+int main(int argc, char **argv) {
+  Thresholds thresholds;
+  std::vector<std::string> paths;
+  for (auto i{1}; i < argc; ++i) {
+    std::string arg{argv[i]};
+    if ((arg == "--time-threshold" || arg == "--throughput-threshold")
+        && i + 1 < argc) {
+      auto ratio{std::stod(argv[++i]) / 100};
+      (arg == "--time-threshold" ? thresholds.time : thresholds.throughput) =
+          ratio;
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.size() != 2) {
+    std::cerr << "usage: " << argv[0]
+              << " [--time-threshold <percent>]"
+                 " [--throughput-threshold <percent>]"
+                 " <baseline json> <current json>"
+              << std::endl;
+    return 2;
+  }
+  auto baseline{load(paths[0])};
+  if (!baseline) {
+    std::cerr << "baseline " << paths[0] << ": "
+              << baseline.error().message() << std::endl;
+    return 2;
+  }
+  auto current{load(paths[1])};
+  if (!current) {
+    std::cerr << "results " << paths[1] << ": " << current.error().message()
+              << std::endl;
+    return 2;
+  }
+  auto report{compare(baseline.value(), current.value(), thresholds)};
+  fc::benchmark::print(std::cout, report);
+  if (report.regressed()) {
+    std::cout << "benchmarks regressed beyond thresholds: time +"
+              << thresholds.time * 100 << "%, throughput -"
+              << thresholds.throughput * 100 << "%" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "testutil/benchmark/benchmark_compare.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/outcome.hpp"
+
+namespace fc::benchmark {
+  /// Google benchmark json with one benchmark per entry
+  std::string json(const std::string &benchmarks) {
+    return R"({"context": {}, "benchmarks": [)" + benchmarks + "]}";
+  }
+
+  /**
+   * @given json with repetitions, aggregates and errors
+   * @when parse it
+   * @then medians replace repetitions, times are in nanoseconds
+   */
+  TEST(BenchmarkCompareTest, Parse) {
+    EXPECT_OUTCOME_TRUE(measurements, parseMeasurements(json(R"(
+      {"name": "A", "run_type": "iteration", "real_time": 3,
+       "time_unit": "us"},
+      {"name": "A", "run_type": "iteration", "real_time": 1,
+       "time_unit": "us"},
+      {"name": "A_mean", "run_name": "A", "run_type": "aggregate",
+       "aggregate_name": "mean", "real_time": 5, "time_unit": "us"},
+      {"name": "A_median", "run_name": "A", "run_type": "aggregate",
+       "aggregate_name": "median", "real_time": 2, "time_unit": "us",
+       "items_per_second": 100},
+      {"name": "B", "run_type": "iteration", "real_time": 7,
+       "time_unit": "ns", "error_occurred": true}
+    )")));
+    ASSERT_EQ(measurements.size(), 2);
+    EXPECT_EQ(measurements["A"].real_time_ns, 2000);
+    EXPECT_EQ(measurements["A"].items_per_second, 100.0);
+    EXPECT_FALSE(measurements["A"].failed);
+    EXPECT_TRUE(measurements["B"].failed);
+
+    EXPECT_OUTCOME_ERROR(BenchmarkCompareError::NO_BENCHMARKS,
+                         parseMeasurements(json("")));
+    EXPECT_OUTCOME_ERROR(BenchmarkCompareError::INVALID_JSON,
+                         parseMeasurements("{"));
+  }
+
+  /**
+   * @given baseline and current results
+   * @when compare them with thresholds
+   * @then only changes beyond thresholds are regressions, missing and new
+   * benchmarks are reported without failing
+   */
+  TEST(BenchmarkCompareTest, Compare) {
+    Measurements baseline{{"fast", {100, 1000, {}, false}},
+                          {"slow", {100, {}, {}, false}},
+                          {"gone", {100, {}, {}, false}}};
+    Measurements current{{"fast", {105, 950, {}, false}},
+                         {"slow", {120, {}, {}, false}},
+                         {"new", {100, {}, {}, false}}};
+    auto report{compare(baseline, current, {0.1, 0.1})};
+    ASSERT_EQ(report.comparisons.size(), 3);
+    for (const auto &comparison : report.comparisons) {
+      EXPECT_EQ(comparison.regressed, comparison.name == "slow")
+          << comparison.name << " " << comparison.metric;
+    }
+    EXPECT_EQ(report.missing, std::vector<std::string>{"gone"});
+    EXPECT_EQ(report.added, std::vector<std::string>{"new"});
+    EXPECT_TRUE(report.regressed());
+
+    current["slow"].real_time_ns = 100;
+    EXPECT_FALSE(compare(baseline, current, {0.1, 0.1}).regressed());
+
+    current["slow"].failed = true;
+    EXPECT_TRUE(compare(baseline, current, {0.1, 0.1}).regressed());
+  }
+}  // namespace fc::benchmark
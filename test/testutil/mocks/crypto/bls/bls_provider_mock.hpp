@@ -25,6 +25,11 @@ namespace fc::crypto::bls {
                        outcome::result<bool>(gsl::span<const uint8_t>,
                                              const Signature &,
                                              const PublicKey &));
+    MOCK_CONST_METHOD3(
+        verifyAggregateSignature,
+        outcome::result<bool>(gsl::span<const std::vector<uint8_t>>,
+                              gsl::span<const PublicKey>,
+                              const Signature &));
     MOCK_CONST_METHOD1(
         aggregateSignatures,
         outcome::result<Signature>(gsl::span<const Signature>));
@@ -48,6 +48,8 @@ namespace fc::data_transfer {
     MOCK_METHOD2(getChannelByIdAndSender,
                  boost::optional<ChannelState>(const ChannelId &channel_id,
                                                const PeerInfo &sender));
+
+    MOCK_METHOD1(onChannelResponse, void(const ChannelId &channel_id));
   };
 
 }  // namespace fc::data_transfer
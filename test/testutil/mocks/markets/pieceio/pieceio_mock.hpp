@@ -19,6 +19,12 @@ namespace fc::markets::pieceio {
                      const RegisteredProof &registered_proof,
                      const CID &payload_cid,
                      const Selector &selector));
+    MOCK_METHOD4(stagePiece,
+                 outcome::result<PieceInfo>(
+                     const CID &payload_cid,
+                     const Selector &selector,
+                     UnpaddedPieceSize piece_size,
+                     const PieceWriter &writer));
   };
 
 }  // namespace fc::markets::pieceio
@@ -22,6 +22,18 @@ namespace fc::sector_storage::stores {
     MOCK_METHOD2(storageReportHealth,
                  outcome::result<void>(const StorageID &storage_id,
                                        const HealthReport &report));
+    MOCK_METHOD2(storageReportTransfer,
+                 outcome::result<void>(const StorageID &storage_id,
+                                       const TransferProgress &progress));
+    MOCK_CONST_METHOD1(storageGetTransfers,
+                       outcome::result<std::vector<TransferProgress>>(
+                           const StorageID &storage_id));
+    MOCK_METHOD2(storageReserve,
+                 outcome::result<void>(const StorageID &storage_id,
+                                       uint64_t size));
+    MOCK_METHOD2(storageReleaseReservation,
+                 outcome::result<void>(const StorageID &storage_id,
+                                       uint64_t size));
     MOCK_METHOD3(storageDeclareSector,
                  outcome::result<void>(const StorageID &storage_id,
                                        const SectorId &sector,
@@ -32,6 +44,10 @@ namespace fc::sector_storage::stores {
                                        const SectorId &sector,
                                        const SectorFileType &file_type));
 
+    MOCK_CONST_METHOD1(storageSectors,
+                       outcome::result<std::vector<SectorDeclaration>>(
+                           const StorageID &storage_id));
+
     MOCK_METHOD3(storageFindSector,
                  outcome::result<std::vector<StorageInfo>>(
                      const SectorId &sector,
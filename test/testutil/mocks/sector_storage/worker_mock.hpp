@@ -0,0 +1,51 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_FILECOIN_TEST_TESTUTIL_MOCKS_SECTOR_STORAGE_WORKER_MOCK_HPP
+#define CPP_FILECOIN_TEST_TESTUTIL_MOCKS_SECTOR_STORAGE_WORKER_MOCK_HPP
+
+#include <gmock/gmock.h>
+
+#include "sector_storage/worker.hpp"
+
+namespace fc::sector_storage {
+  class WorkerMock : public Worker {
+   public:
+    MOCK_METHOD0(getSupportedTask, outcome::result<std::set<TaskType>>());
+
+    MOCK_METHOD0(getInfo, outcome::result<WorkerInfo>());
+
+    MOCK_METHOD3(sealPreCommit1,
+                 outcome::result<PreCommit1Output>(
+                     const SectorId &sector,
+                     const SealRandomness &ticket,
+                     gsl::span<const PieceInfo> pieces));
+
+    MOCK_METHOD2(sealPreCommit2,
+                 outcome::result<SectorCids>(const SectorId &sector,
+                                             const PreCommit1Output &pc1o));
+
+    MOCK_METHOD5(sealCommit1,
+                 outcome::result<Commit1Output>(
+                     const SectorId &sector,
+                     const SealRandomness &ticket,
+                     const InteractiveRandomness &seed,
+                     gsl::span<const PieceInfo> pieces,
+                     const SectorCids &cids));
+
+    MOCK_METHOD2(sealCommit2,
+                 outcome::result<Proof>(const SectorId &sector,
+                                        const Commit1Output &c1o));
+
+    MOCK_METHOD1(finalizeSector,
+                 outcome::result<void>(const SectorId &sector));
+
+    MOCK_METHOD2(moveStorage,
+                 outcome::result<void>(const SectorId &sector,
+                                       SectorFileType types));
+  };
+}  // namespace fc::sector_storage
+
+#endif  // CPP_FILECOIN_TEST_TESTUTIL_MOCKS_SECTOR_STORAGE_WORKER_MOCK_HPP
@@ -16,6 +16,10 @@ namespace fc::vm::interpreter {
     MOCK_CONST_METHOD2(interpret,
                        outcome::result<Result>(const IpldPtr &store,
                                                const Tipset &tipset));
+    MOCK_CONST_METHOD3(replay,
+                       outcome::result<ExecutionTrace>(const IpldPtr &store,
+                                                       const Tipset &tipset,
+                                                       const CID &message));
   };
 }  // namespace fc::vm::interpreter
 
@@ -22,6 +22,9 @@ namespace fc::vm::state {
                  outcome::result<Address>(const Address &address));
     MOCK_METHOD0(flush, outcome::result<CID>());
     MOCK_METHOD1(revert, outcome::result<void>(const CID &));
+    MOCK_METHOD0(snapshot, outcome::result<void>());
+    MOCK_METHOD0(revertSnapshot, outcome::result<void>());
+    MOCK_METHOD0(clearSnapshot, outcome::result<void>());
     MOCK_METHOD0(getStore, std::shared_ptr<IpfsDatastore>());
   };
 